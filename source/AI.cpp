@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Gamerules.h"
 #include "Government.h"
 #include "Hardpoint.h"
+#include "JobPool.h"
 #include "JumpTypes.h"
 #include "Mask.h"
 #include "Messages.h"
@@ -30,9 +31,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "pi.h"
 #include "Planet.h"
 #include "PlayerInfo.h"
+#include "Politics.h"
 #include "Point.h"
 #include "Preferences.h"
 #include "Random.h"
+#include "RoutePlanner.h"
 #include "Ship.h"
 #include "ship/ShipAICache.h"
 #include "ShipEvent.h"
@@ -190,7 +193,7 @@ namespace {
 	bool ShouldRefuel(const Ship &ship, const DistanceMap &route, double fuelCapacity = 0.)
 	{
 		if(!fuelCapacity)
-			fuelCapacity = ship.Attributes().Get("fuel capacity");
+			fuelCapacity = ship.Attributes().Get(AttributeKey::FUEL_CAPACITY);
 
 		const System *from = ship.GetSystem();
 		const bool systemHasFuel = from->HasFuelFor(ship) && fuelCapacity;
@@ -238,13 +241,18 @@ namespace {
 	}
 
 	// Set the ship's TargetStellar or TargetSystem in order to reach the
-	// next desired system. Will target a landable planet to refuel.
+	// next desired system. Will target a landable planet to refuel. Routes are
+	// found in the background, so until this ship's route is ready, it keeps
+	// whatever targets it had before.
 	void SelectRoute(Ship &ship, const System *targetSystem)
 	{
 		const System *from = ship.GetSystem();
 		if(from == targetSystem || !targetSystem)
 			return;
-		const DistanceMap route(ship, targetSystem);
+		const shared_ptr<const DistanceMap> plan = RoutePlanner::Get(ship, targetSystem);
+		if(!plan)
+			return;
+		const DistanceMap &route = *plan;
 		const bool needsRefuel = ShouldRefuel(ship, route);
 		const System *to = route.Route(from);
 		// The destination may be accessible by both jump and wormhole.
@@ -325,12 +333,140 @@ namespace {
 
 	// The minimum speed advantage a ship has to have to consider running away.
 	const double SAFETY_MULTIPLIER = 1.1;
+
+	// The grid of ships in the player's system has cells this big, and wraps
+	// around after this many cells.
+	const unsigned SHIP_GRID_CELL_SIZE = 1024;
+	const unsigned SHIP_GRID_CELL_COUNT = 32;
+	// Searches for ships within this range look in the nearby grid cells, but
+	// searches over larger ranges cover too many cells to be worth it.
+	const double MAX_GRID_RANGE = 4096.;
+	// There is no need to use the grid if there are only a few ships to check.
+	const size_t MIN_GRID_SHIPS = 32;
+	// Ships only look for flotsam within this range. The grid of flotsam has
+	// cells small enough that a search that far only covers a few of them.
+	const double MAX_FLOTSAM_RANGE = 800.;
+	const unsigned FLOTSAM_GRID_CELL_SIZE = 256;
+	const unsigned FLOTSAM_GRID_CELL_COUNT = 32;
+	const size_t MIN_GRID_FLOTSAM = 32;
+
+	// The same as AI::RendezvousTime(), for a position and velocity that are
+	// kept as separate coordinates.
+	double RendezvousTime(double px, double py, double vx, double vy, double vp)
+	{
+		double a = (vx * vx + vy * vy) - vp * vp;
+		double b = 2. * (px * vx + py * vy);
+		double c = px * px + py * py;
+		double discriminant = b * b - 4 * a * c;
+		if(discriminant < 0.)
+			return numeric_limits<double>::quiet_NaN();
+
+		discriminant = sqrt(discriminant);
+		double r1 = (-b + discriminant) / (2. * a);
+		double r2 = (-b - discriminant) / (2. * a);
+		if(r1 >= 0. && r2 >= 0.)
+			return min(r1, r2);
+		else if(r1 >= 0. || r2 >= 0.)
+			return max(r1, r2);
+		return numeric_limits<double>::quiet_NaN();
+	}
+
+
+
+	// The positions and velocities of the bodies that a ship's turrets might
+	// aim at, each coordinate in its own array, and for the turret being aimed,
+	// where it must aim to hit each body and how many steps beyond its weapon's
+	// lifetime that would take. Turrets solve for all targets in one pass over
+	// these arrays instead of reading each body again for every turret.
+	class TargetLanes {
+	public:
+		explicit TargetLanes(const vector<const Body *> &targets);
+
+		void SolveIntercepts(const Point &start, const Point &shipVelocity, double vp, double lifetime);
+
+	public:
+		size_t count;
+		vector<double> lanes;
+		double *x;
+		double *y;
+		double *vx;
+		double *vy;
+		double *aimX;
+		double *aimY;
+		double *delay;
+	};
+
+
+
+	TargetLanes::TargetLanes(const vector<const Body *> &targets)
+		: count(targets.size()), lanes(7 * count)
+	{
+		x = lanes.data();
+		y = x + count;
+		vx = y + count;
+		vy = vx + count;
+		aimX = vy + count;
+		aimY = aimX + count;
+		delay = aimY + count;
+		for(size_t i = 0; i < count; ++i)
+		{
+			x[i] = targets[i]->Position().X();
+			y[i] = targets[i]->Position().Y();
+			vx[i] = targets[i]->Velocity().X();
+			vy[i] = targets[i]->Velocity().Y();
+		}
+	}
+
+
+
+	// Find where a projectile fired from the given point must aim to hit each
+	// target, if the firing ship's velocity (which may be zero) is subtracted
+	// from the targets' velocities.
+	void TargetLanes::SolveIntercepts(const Point &start, const Point &shipVelocity, double vp, double lifetime)
+	{
+		// Beam weapons hit instantaneously if they are in range.
+		const bool isInstantaneous = (lifetime == 1.);
+		for(size_t i = 0; i < count; ++i)
+		{
+			double velocityX = vx[i] - shipVelocity.X();
+			double velocityY = vy[i] - shipVelocity.Y();
+			// By the time this action is performed, the target will have moved
+			// forward one time step.
+			double px = (x[i] - start.X()) + velocityX;
+			double py = (y[i] - start.Y()) + velocityY;
+
+			double distance = sqrt(px * px + py * py);
+			double wait = 0.;
+			if(!isInstantaneous || distance >= vp)
+			{
+				// Find out how long it would take for this projectile to reach the target.
+				double time = isInstantaneous ? numeric_limits<double>::quiet_NaN()
+					: RendezvousTime(px, py, velocityX, velocityY, vp);
+				// If there is no intersection (i.e. the turret is not facing the target),
+				// consider this target "out-of-range" but still targetable.
+				if(std::isnan(time))
+					time = max(distance / (vp ? vp : 1.), 2 * lifetime);
+
+				// Determine where the target will be at that point.
+				px += velocityX * time;
+				py += velocityY * time;
+				// All bodies within weapons range have the same basic
+				// weight. Outside that range, give them lower priority.
+				wait = max(0., time - lifetime);
+			}
+			aimX[i] = px;
+			aimY[i] = py;
+			delay[i] = wait;
+		}
+	}
 }
 
 
 
-AI::AI(const List<Ship> &ships, const List<Minable> &minables, const List<Flotsam> &flotsam)
-	: ships(ships), minables(minables), flotsam(flotsam)
+AI::AI(const vector<shared_ptr<Ship>> &ships, const ObjectPool<Minable> &minables, const ObjectPool<Flotsam> &flotsam,
+		JobPool &jobs)
+	: ships(ships), minables(minables), flotsam(flotsam), jobs(jobs),
+	shipGrid(SHIP_GRID_CELL_SIZE, SHIP_GRID_CELL_COUNT), flotsamGrid(FLOTSAM_GRID_CELL_SIZE, FLOTSAM_GRID_CELL_COUNT)
 {
 	// Allocate a starting amount of hardpoints for ships.
 	firingCommands.SetHardpoints(12);
@@ -352,13 +488,17 @@ void AI::IssueShipTarget(const PlayerInfo &player, const shared_ptr<Ship> &targe
 
 
 
-void AI::IssueAsteroidTarget(const PlayerInfo &player, const shared_ptr<Minable> &targetAsteroid)
+void AI::IssueAsteroidTarget(const PlayerInfo &player, const PoolHandle<Minable> &targetAsteroid)
 {
+	const Minable *asteroid = minables.Get(targetAsteroid);
+	if(!asteroid)
+		return;
+
 	Orders newOrders;
 	newOrders.type = Orders::MINE;
 	newOrders.targetAsteroid = targetAsteroid;
 	IssueOrders(player, newOrders,
-			"focusing fire on " + targetAsteroid->DisplayName() + " " + targetAsteroid->Noun() + ".");
+			"focusing fire on " + asteroid->DisplayName() + " " + asteroid->Noun() + ".");
 }
 
 
@@ -404,7 +544,7 @@ void AI::UpdateKeys(PlayerInfo &player, Command &activeCommands)
 	// Only toggle the "cloak" command if one of your ships has a cloaking device.
 	if(activeCommands.Has(Command::CLOAK))
 		for(const auto &it : player.Ships())
-			if(!it->IsParked() && it->Attributes().Get("cloak"))
+			if(!it->IsParked() && it->Attributes().Get(AttributeKey::CLOAK))
 			{
 				isCloaking = !isCloaking;
 				Messages::Add(isCloaking ? "Engaging cloaking device." : "Disengaging cloaking device."
@@ -417,7 +557,6 @@ void AI::UpdateKeys(PlayerInfo &player, Command &activeCommands)
 		player.SelectNextSecondary();
 
 	shared_ptr<Ship> target = flagship->GetTargetShip();
-	shared_ptr<Minable> targetAsteroid = flagship->GetTargetAsteroid();
 	Orders newOrders;
 	if(activeCommands.Has(Command::FIGHT) && target && !target->IsYours())
 	{
@@ -425,8 +564,8 @@ void AI::UpdateKeys(PlayerInfo &player, Command &activeCommands)
 		newOrders.target = target;
 		IssueOrders(player, newOrders, "focusing fire on \"" + target->Name() + "\".");
 	}
-	else if(activeCommands.Has(Command::FIGHT) && targetAsteroid)
-		IssueAsteroidTarget(player, targetAsteroid);
+	else if(activeCommands.Has(Command::FIGHT) && TargetAsteroid(*flagship))
+		IssueAsteroidTarget(player, flagship->GetTargetAsteroid());
 
 	// The commands below here only apply if you have escorts or fighters.
 	if(player.Ships().size() < 2)
@@ -451,12 +590,12 @@ void AI::UpdateKeys(PlayerInfo &player, Command &activeCommands)
 	// Get rid of any invalid orders. Carried ships will retain orders in case they are deployed.
 	for(auto it = orders.begin(); it != orders.end(); )
 	{
-		if(it->second.type == Orders::MINE && it->first->Cargo().Free() && it->second.targetAsteroid.expired())
+		if(it->second.type == Orders::MINE && it->first->Cargo().Free() && !minables.Get(it->second.targetAsteroid))
 			it->second.type = Orders::HARVEST;
 		else if(it->second.type & Orders::REQUIRES_TARGET)
 		{
 			shared_ptr<Ship> ship = it->second.target.lock();
-			shared_ptr<Minable> asteroid = it->second.targetAsteroid.lock();
+			const Minable *asteroid = minables.Get(it->second.targetAsteroid);
 			// Check if the target ship itself is targetable.
 			bool invalidTarget = !ship || !ship->IsTargetable() || (ship->IsDisabled() && it->second.type == Orders::ATTACK);
 			// Alternately, if an asteroid is targeted, then not an invalid target.
@@ -480,10 +619,18 @@ void AI::UpdateKeys(PlayerInfo &player, Command &activeCommands)
 
 
 
-void AI::UpdateEvents(const list<ShipEvent> &events)
+void AI::UpdateEvents(const vector<ShipEvent> &events)
 {
+	// In a big battle, the player may offend the same governments many times in
+	// a step, so all those offenses are committed together once every event has
+	// been recorded. Nothing in between depends on them.
+	vector<Politics::Offense> offenses;
 	for(const ShipEvent &event : events)
 	{
+		if(event.Type() & (ShipEvent::PROVOKE | ShipEvent::DISABLE | ShipEvent::CAPTURE
+				| ShipEvent::DESTROY | ShipEvent::JUMP))
+			++targetEventCount;
+
 		const auto &target = event.Target();
 		if(!target)
 			continue;
@@ -507,10 +654,11 @@ void AI::UpdateEvents(const list<ShipEvent> &events)
 				// If you provoke the same ship twice, it should have an effect both times.
 				if(event.Type() & ShipEvent::PROVOKE)
 					newActions |= ShipEvent::PROVOKE;
-				event.TargetGovernment()->Offend(newActions, target->CrewValue());
+				offenses.push_back({event.TargetGovernment(), newActions, target->CrewValue()});
 			}
 		}
 	}
+	GameData::GetPolitics().Offend(offenses);
 }
 
 
@@ -531,8 +679,11 @@ void AI::Clean()
 	miningTime.clear();
 	appeasementThreshold.clear();
 	shipStrength.clear();
+	governmentStrength.clear();
 	enemyStrength.clear();
 	allyStrength.clear();
+	talliedStrength.clear();
+	talliedIsEnemy.clear();
 }
 
 
@@ -551,9 +702,9 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 {
 	// First, figure out the comparative strengths of the present governments.
 	const System *playerSystem = player.GetSystem();
-	map<const Government *, int64_t> strength;
-	UpdateStrengths(strength, playerSystem);
+	UpdateStrengths(playerSystem);
 	CacheShipLists();
+	UpdateAllyStrengths();
 
 	// Update the counts of how long ships have been outside the "invisible fence."
 	// If a ship ceases to exist, this also ensures that it will be removed from
@@ -577,15 +728,22 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 	}
 
 	const Ship *flagship = player.Flagship();
-	step = (step + 1) & 31;
-	int targetTurn = 0;
+	retargetInterval = GameData::GetGamerules().RetargetInterval();
+	step = (step + 1) % retargetInterval;
 	int minerCount = 0;
 	const int maxMinerCount = minables.empty() ? 0 : 9;
 	bool opportunisticEscorts = !Preferences::Has("Turrets focus fire");
 	bool fightersRetreat = Preferences::Has("Damaged fighters retreat");
 	const int npcMaxMiningTime = GameData::GetGamerules().NPCMaxMiningTime();
-	for(const auto &it : ships)
+
+	// Look for new targets for all the ships that will need one, in parallel.
+	PlanTargets(flagship, playerSystem);
+
+	// The first half of each ship's decisions may change the state of other
+	// ships, so it is done one ship at a time.
+	for(ShipPlan &plan : plans)
 	{
+		const shared_ptr<Ship> &it = *plan.ship;
 		// A destroyed ship can't do anything.
 		if(it->IsDestroyed())
 			continue;
@@ -601,7 +759,6 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 			continue;
 		}
 
-		const Government *gov = it->GetGovernment();
 		const Personality &personality = it->GetPersonality();
 		double healthRemaining = it->Health();
 		bool isPresent = (it->GetSystem() == playerSystem);
@@ -670,30 +827,67 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 
 		// Pick a target and automatically fire weapons.
 		shared_ptr<Ship> target = it->GetTargetShip();
-		shared_ptr<Minable> targetAsteroid = it->GetTargetAsteroid();
-		shared_ptr<Flotsam> targetFlotsam = it->GetTargetFlotsam();
+		// A ship that was mining an asteroid that has since been destroyed
+		// forgets about it.
+		const Minable *targetAsteroid = TargetAsteroid(*it);
+		if(!targetAsteroid)
+			it->SetTargetAsteroid(PoolHandle<Minable>());
+		const Flotsam *targetFlotsam = flotsam.Get(it->GetTargetFlotsam());
 		if(isPresent && it->IsYours() && targetFlotsam && FollowOrders(*it, command))
 			continue;
 		if(isPresent && !personality.IsSwarming())
 		{
-			// Each ship only switches targets twice a second, so that it can
-			// focus on damaging one particular ship.
-			targetTurn = (targetTurn + 1) & 31;
-			if(targetTurn == step || !target || target->IsDestroyed() || (target->IsDisabled() && personality.Disables())
-					|| (target->IsFleeing() && personality.IsMerciful()) || !target->IsTargetable())
+			// Each ship only switches targets once per retarget interval (by
+			// default, about twice a second), so that it can focus on damaging
+			// one particular ship. Spreading the ships' turns over the interval
+			// also spreads out the cost of finding targets.
+			if(ShouldRetarget(*it, target.get(), plan.targetTurn))
 			{
-				target = FindTarget(*it);
+				// Use the target that was found ahead of time, unless something
+				// that choice depended on has changed since then.
+				if(plan.hasNewTarget && target == plan.oldTarget && it->GetParent() == plan.oldParent)
+					target = plan.newTarget;
+				else
+					target = FindTarget(*it);
 				it->SetTargetShip(target);
+				it->GetAICache().SetFoundNoTarget(!target, targetEventCount);
 			}
 		}
-		if(isPresent)
-		{
-			AimTurrets(*it, firingCommands, it->IsYours() ? opportunisticEscorts : personality.IsOpportunistic());
-			if(targetAsteroid)
-				AutoFire(*it, firingCommands, *targetAsteroid);
-			else
-				AutoFire(*it, firingCommands);
-		}
+		// Aiming and firing only depends on this ship's own target, so it can
+		// be done for every ship at once.
+		plan.aims = isPresent;
+		plan.opportunistic = it->IsYours() ? opportunisticEscorts : personality.IsOpportunistic();
+		plan.targetAsteroid = targetAsteroid;
+
+		// Remember the state of this ship for the rest of its decisions.
+		plan.isDone = false;
+		plan.command = command;
+		plan.parent = parent;
+		plan.target = target;
+		plan.healthRemaining = healthRemaining;
+		plan.isPresent = isPresent;
+		plan.isStranded = isStranded;
+		plan.thisIsLaunching = thisIsLaunching;
+	}
+
+	AimAndFire();
+
+	for(ShipPlan &plan : plans)
+	{
+		if(plan.isDone)
+			continue;
+
+		const shared_ptr<Ship> &it = *plan.ship;
+		const Government *gov = it->GetGovernment();
+		const Personality &personality = it->GetPersonality();
+		const double healthRemaining = plan.healthRemaining;
+		const bool isPresent = plan.isPresent;
+		bool isStranded = plan.isStranded;
+		const bool thisIsLaunching = plan.thisIsLaunching;
+		Command &command = plan.command;
+		shared_ptr<Ship> &parent = plan.parent;
+		shared_ptr<Ship> &target = plan.target;
+		swap(firingCommands, plan.firing);
 
 		// If this ship is hyperspacing, or in the act of
 		// launching or landing, it can't do anything else.
@@ -862,10 +1056,10 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 			// carry ore, and the asteroid is near enough that the parent can harvest the ore.
 			if(it->CanBeCarried() && parent && miningTime[parent.get()] < 3601)
 			{
-				const shared_ptr<Minable> &minable = parent->GetTargetAsteroid();
+				const Minable *minable = TargetAsteroid(*parent);
 				if(minable && minable->Position().Distance(parent->Position()) < 600.)
 				{
-					it->SetTargetAsteroid(minable);
+					it->SetTargetAsteroid(parent->GetTargetAsteroid());
 					MoveToAttack(*it, command, *minable);
 					AutoFire(*it, firingCommands, *minable);
 					it->SetCommands(command);
@@ -873,7 +1067,7 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 					continue;
 				}
 			}
-			it->SetTargetAsteroid(nullptr);
+			it->SetTargetAsteroid(PoolHandle<Minable>());
 		}
 
 		// Handle carried ships:
@@ -893,17 +1087,18 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 				// Find the possible parents for orphaned fighters and drones.
 				auto parentChoices = vector<shared_ptr<Ship>>{};
 				parentChoices.reserve(ships.size() * .1);
-				auto getParentFrom = [&it, &gov, &parentChoices](const list<shared_ptr<Ship>> otherShips) -> shared_ptr<Ship>
+				// Check if the given ship can be a parent right away. If it could
+				// be one later, remember it as a choice.
+				auto isParent = [&it, &gov, &parentChoices](const shared_ptr<Ship> &other) -> bool
 				{
-					for(const auto &other : otherShips)
-						if(other->GetGovernment() == gov && other->GetSystem() == it->GetSystem() && !other->CanBeCarried())
-						{
-							if(!other->IsDisabled() && other->CanCarry(*it.get()))
-								return other;
-							else
-								parentChoices.emplace_back(other);
-						}
-					return shared_ptr<Ship>();
+					if(other->GetGovernment() == gov && other->GetSystem() == it->GetSystem() && !other->CanBeCarried())
+					{
+						if(!other->IsDisabled() && other->CanCarry(*it.get()))
+							return true;
+						else
+							parentChoices.emplace_back(other);
+					}
+					return false;
 				};
 				// Mission ships should only pick amongst ships from the same mission.
 				auto missionIt = it->IsSpecial() && !it->IsYours()
@@ -920,13 +1115,23 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 						// Don't reparent to NPC ships that have not been spawned.
 						if(!npc.ShouldSpawn())
 							continue;
-						newParent = getParentFrom(npc.Ships());
+						for(const auto &other : npc.Ships())
+							if(isParent(other))
+							{
+								newParent = other;
+								break;
+							}
 						if(newParent)
 							break;
 					}
 				}
 				else
-					newParent = getParentFrom(ships);
+					for(const auto &other : ships)
+						if(isParent(other))
+						{
+							newParent = other;
+							break;
+						}
 
 				// If a new parent was found, then this carried ship should always reparent
 				// as a ship of its own government is in-system and has space to carry it.
@@ -1013,7 +1218,7 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 			MoveIndependent(*it, command);
 		else if(parent->GetSystem() != it->GetSystem())
 		{
-			if(personality.IsStaying() || !it->Attributes().Get("fuel capacity"))
+			if(personality.IsStaying() || !it->Attributes().Get(AttributeKey::FUEL_CAPACITY))
 				MoveIndependent(*it, command);
 			else
 				MoveEscort(*it, command);
@@ -1067,6 +1272,119 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 		it->SetCommands(command);
 		it->SetCommands(firingCommands);
 	}
+
+	// Don't keep any ships alive because of the plans made this step.
+	for(ShipPlan &plan : plans)
+		plan.Release();
+}
+
+
+
+// Check if the given ship should look for a new target this step.
+bool AI::ShouldRetarget(const Ship &ship, const Ship *target, int targetTurn) const
+{
+	if(targetTurn == step)
+		return true;
+	// A ship that found nothing to target does not look again until its next
+	// turn, unless something has happened that could change that.
+	if(!target)
+		return !ship.GetAICache().HasNoTarget(targetEventCount);
+
+	const Personality &personality = ship.GetPersonality();
+	return target->IsDestroyed() || (target->IsDisabled() && personality.Disables())
+		|| (target->IsFleeing() && personality.IsMerciful()) || !target->IsTargetable();
+}
+
+
+
+// Finding a target only reads the state of the ships, so the targets for every
+// ship that is likely to need one this step can be found in parallel, before
+// any of the ships make their other decisions.
+void AI::PlanTargets(const Ship *flagship, const System *playerSystem)
+{
+	plans.resize(ships.size());
+	int targetTurn = 0;
+	auto plan = plans.begin();
+	for(const auto &it : ships)
+	{
+		plan->ship = &it;
+		plan->isDone = true;
+		plan->hasNewTarget = false;
+		plan->aims = false;
+		// Spread the ships that may change targets evenly over the steps.
+		if(it->GetSystem() == playerSystem && !it->GetPersonality().IsSwarming())
+			targetTurn = (targetTurn + 1) % retargetInterval;
+		plan->targetTurn = targetTurn;
+		++plan;
+	}
+
+	jobs.ParallelFor(plans.size(), [this, flagship, playerSystem](size_t i)
+	{
+		ShipPlan &plan = plans[i];
+		const Ship &ship = **plan.ship;
+		if(&ship == flagship || ship.IsDestroyed() || ship.GetSystem() != playerSystem
+				|| ship.IsDisabled() || ship.IsOverheated() || ship.GetPersonality().IsSwarming())
+			return;
+
+		plan.oldTarget = ship.GetTargetShip();
+		plan.oldParent = ship.GetParent();
+		if(!ShouldRetarget(ship, plan.oldTarget.get(), plan.targetTurn))
+			return;
+
+		plan.newTarget = FindTarget(ship);
+		plan.hasNewTarget = true;
+	});
+}
+
+
+
+// Aim the turrets and pick which weapons to fire for every ship that got far
+// enough in its decisions to need to.
+void AI::AimAndFire()
+{
+	// Turrets that have nothing to aim at move randomly. Give each block of ships
+	// its own seed, so that the outcome does not depend on which thread aimed it.
+	static const size_t BLOCK_SIZE = 16;
+	const size_t blocks = (plans.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	fireSeeds.resize(blocks + 1);
+	for(uint64_t &seed : fireSeeds)
+		seed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+
+	jobs.ParallelFor(blocks, [this](size_t block)
+	{
+		Random::Seed(fireSeeds[block]);
+		const size_t end = min(plans.size(), (block + 1) * BLOCK_SIZE);
+		for(size_t i = block * BLOCK_SIZE; i < end; ++i)
+		{
+			ShipPlan &plan = plans[i];
+			if(plan.isDone)
+				continue;
+
+			const Ship &ship = **plan.ship;
+			plan.firing.SetHardpoints(ship.Weapons().size());
+			if(!plan.aims)
+				continue;
+
+			AimTurrets(ship, plan.firing, plan.opportunistic);
+			if(plan.targetAsteroid)
+				AutoFire(ship, plan.firing, *plan.targetAsteroid);
+			else
+				AutoFire(ship, plan.firing);
+		}
+	});
+	Random::Seed(fireSeeds.back());
+}
+
+
+
+void AI::ShipPlan::Release()
+{
+	oldTarget.reset();
+	oldParent.reset();
+	newTarget.reset();
+	targetAsteroid = nullptr;
+	parent.reset();
+	target.reset();
 }
 
 
@@ -1079,18 +1397,20 @@ void AI::SetMousePosition(Point position)
 
 
 // Get the in-system strength of each government's allies and enemies.
-int64_t AI::AllyStrength(const Government *government)
+int64_t AI::AllyStrength(const Government *government) const
 {
-	auto it = allyStrength.find(government);
-	return (it == allyStrength.end() ? 0 : it->second);
+	if(!government || government->Index() >= allyStrength.size())
+		return 0;
+	return allyStrength[government->Index()];
 }
 
 
 
-int64_t AI::EnemyStrength(const Government *government)
+int64_t AI::EnemyStrength(const Government *government) const
 {
-	auto it = enemyStrength.find(government);
-	return (it == enemyStrength.end() ? 0 : it->second);
+	if(!government || government->Index() >= enemyStrength.size())
+		return 0;
+	return enemyStrength[government->Index()];
 }
 
 
@@ -1151,7 +1471,7 @@ void AI::AskForHelp(Ship &ship, bool &isStranded, const Ship *flagship)
 			if(helper->GetShipToAssist() && helper->GetShipToAssist().get() != &ship)
 				continue;
 			// If the ship is mining or chasing flotsam, it cannot help this ship.
-			if(helper->GetTargetAsteroid() || helper->GetTargetFlotsam())
+			if(TargetAsteroid(*helper) || flotsam.Get(helper->GetTargetFlotsam()))
 				continue;
 			// Your escorts only help other escorts, and your flagship never helps.
 			if((helper->IsYours() && !ship.IsYours()) || helper.get() == flagship)
@@ -1173,7 +1493,7 @@ void AI::AskForHelp(Ship &ship, bool &isStranded, const Ship *flagship)
 				continue;
 
 			// Prefer fast ships over slow ones.
-			canHelp.insert(canHelp.end(), 1 + .3 * helper->MaxVelocity(), helper.get());
+			canHelp.insert(canHelp.end(), 1 + .3 * helper->FrameStats().maxVelocity, helper.get());
 		}
 
 		if(!hasEnemy && !canHelp.empty())
@@ -1382,8 +1702,8 @@ shared_ptr<Ship> AI::FindTarget(const Ship &ship) const
 shared_ptr<Ship> AI::FindNonHostileTarget(const Ship &ship) const
 {
 	shared_ptr<Ship> target;
-	bool cargoScan = ship.Attributes().Get("cargo scan power");
-	bool outfitScan = ship.Attributes().Get("outfit scan power");
+	bool cargoScan = ship.Attributes().Get(AttributeKey::CARGO_SCAN_POWER);
+	bool outfitScan = ship.Attributes().Get(AttributeKey::OUTFIT_SCAN_POWER);
 	if(cargoScan || outfitScan)
 	{
 		const auto allies = GetShipsList(ship, false);
@@ -1442,17 +1762,38 @@ vector<Ship *> AI::GetShipsList(const Ship &ship, bool targetEnemies, double max
 	const auto it = rosters.find(ship.GetGovernment());
 	if(it != rosters.end() && !it->second.empty())
 	{
-		targets.reserve(it->second.size());
-
 		const System *here = ship.GetSystem();
 		const Point &p = ship.Position();
-		for(const auto &target : it->second)
-			if(target->IsTargetable() && target->GetSystem() == here
-					&& !(target->IsHyperspacing() && target->Velocity().Length() > 10.)
-					&& p.Distance(target->Position()) < maxRange
-					&& (ship.IsYours() || !target->GetPersonality().IsMarked())
-					&& (target->IsYours() || !ship.GetPersonality().IsMarked()))
-				targets.emplace_back(target);
+		auto isTarget = [&ship, here, &p, maxRange](const Ship *target) -> bool
+		{
+			return target->IsTargetable() && target->GetSystem() == here
+				&& !(target->IsHyperspacing() && target->Velocity().Length() > 10.)
+				&& p.Distance(target->Position()) < maxRange
+				&& (ship.IsYours() || !target->GetPersonality().IsMarked())
+				&& (target->IsYours() || !ship.GetPersonality().IsMarked());
+		};
+
+		// If only a small area must be searched, only check the ships in it.
+		if(maxRange <= MAX_GRID_RANGE && it->second.size() >= MIN_GRID_SHIPS)
+		{
+			const size_t row = governmentIndex.at(ship.GetGovernment()) * governmentIndex.size();
+			vector<Body *> nearby;
+			shipGrid.Circle(p, maxRange, nearby);
+			for(Body *body : nearby)
+			{
+				Ship *target = reinterpret_cast<Ship *>(body);
+				const size_t column = governmentIndex.at(target->GetGovernment());
+				if(isEnemy[row + column] == targetEnemies && isTarget(target))
+					targets.emplace_back(target);
+			}
+		}
+		else
+		{
+			targets.reserve(it->second.size());
+			for(const auto &target : it->second)
+				if(isTarget(target))
+					targets.emplace_back(target);
+		}
 	}
 
 	return targets;
@@ -1479,14 +1820,15 @@ bool AI::FollowOrders(Ship &ship, Command &command) const
 			return false;
 	}
 	// Do not keep chasing flotsam because another order was given.
-	if(ship.GetTargetFlotsam() && (type != Orders::HARVEST || (ship.CanBeCarried() && !ship.HasDeployOrder())))
+	if(flotsam.Get(ship.GetTargetFlotsam())
+			&& (type != Orders::HARVEST || (ship.CanBeCarried() && !ship.HasDeployOrder())))
 	{
-		ship.SetTargetFlotsam(nullptr);
+		ship.SetTargetFlotsam(PoolHandle<Flotsam>());
 		return false;
 	}
 
 	shared_ptr<Ship> target = it->second.target.lock();
-	shared_ptr<Minable> targetAsteroid = it->second.targetAsteroid.lock();
+	const Minable *targetAsteroid = minables.Get(it->second.targetAsteroid);
 	if(type == Orders::MOVE_TO && it->second.targetSystem && ship.GetSystem() != it->second.targetSystem)
 	{
 		// The desired position is in a different system. Find the best
@@ -1511,7 +1853,7 @@ bool AI::FollowOrders(Ship &ship, Command &command) const
 	}
 	else if(type == Orders::MINE && targetAsteroid)
 	{
-		ship.SetTargetAsteroid(targetAsteroid);
+		ship.SetTargetAsteroid(it->second.targetAsteroid);
 		// Escorts should chase the player-targeted asteroid.
 		MoveToAttack(ship, command, *targetAsteroid);
 	}
@@ -1607,8 +1949,8 @@ void AI::MoveIndependent(Ship &ship, Command &command) const
 	else if(target)
 	{
 		// An AI ship that is targeting a non-hostile ship should scan it, or move on.
-		bool cargoScan = ship.Attributes().Get("cargo scan power");
-		bool outfitScan = ship.Attributes().Get("outfit scan power");
+		bool cargoScan = ship.Attributes().Get(AttributeKey::CARGO_SCAN_POWER);
+		bool outfitScan = ship.Attributes().Get(AttributeKey::OUTFIT_SCAN_POWER);
 		// De-target if the target left my system.
 		if(ship.GetSystem() != target->GetSystem())
 		{
@@ -1625,7 +1967,7 @@ void AI::MoveIndependent(Ship &ship, Command &command) const
 		// Move to (or near) the ship and scan it.
 		else
 		{
-			if(target->Velocity().Length() > ship.MaxVelocity() * 0.9)
+			if(target->Velocity().Length() > ship.FrameStats().maxVelocity * 0.9)
 				CircleAround(ship, command, *target);
 			else
 				MoveTo(ship, command, target->Position(), target->Velocity(), 1., 1.);
@@ -1737,7 +2079,7 @@ void AI::MoveIndependent(Ship &ship, Command &command) const
 	else if(ship.GetTargetStellar())
 	{
 		MoveToPlanet(ship, command);
-		if(!shouldStay && ship.Attributes().Get("fuel capacity") && ship.GetTargetStellar()->HasSprite()
+		if(!shouldStay && ship.Attributes().Get(AttributeKey::FUEL_CAPACITY) && ship.GetTargetStellar()->HasSprite()
 				&& ship.GetTargetStellar()->GetPlanet() && ship.GetTargetStellar()->GetPlanet()->CanLand(ship))
 			command |= Command::LAND;
 		else if(ship.Position().Distance(ship.GetTargetStellar()->Position()) < 100.)
@@ -1759,7 +2101,7 @@ void AI::MoveEscort(Ship &ship, Command &command) const
 {
 	const Ship &parent = *ship.GetParent();
 	const System *currentSystem = ship.GetSystem();
-	bool hasFuelCapacity = ship.Attributes().Get("fuel capacity");
+	bool hasFuelCapacity = ship.Attributes().Get(AttributeKey::FUEL_CAPACITY);
 	bool needsFuel = ship.NeedsFuel();
 	bool isStaying = ship.GetPersonality().IsStaying() || !hasFuelCapacity;
 	bool parentIsHere = (currentSystem == parent.GetSystem());
@@ -1992,9 +2334,9 @@ bool AI::ShouldDock(const Ship &ship, const Ship &parent, const System *playerSy
 
 	// If a carried ship has fuel capacity but is very low, it should return if
 	// the parent can refuel it.
-	double maxFuel = ship.Attributes().Get("fuel capacity");
+	double maxFuel = ship.Attributes().Get(AttributeKey::FUEL_CAPACITY);
 	if(maxFuel && ship.Fuel() < .005 && parent.JumpNavigation().JumpFuel() < parent.Fuel() *
-			parent.Attributes().Get("fuel capacity") - maxFuel)
+			parent.Attributes().Get(AttributeKey::FUEL_CAPACITY) - maxFuel)
 		return true;
 
 	// NPC ships should always transfer cargo. Player ships should only
@@ -2045,14 +2387,14 @@ double AI::TurnToward(const Ship &ship, const Point &vector, const double precis
 		double angle = asin(min(1., max(-1., cross / vector.Length()))) * TO_DEG;
 		// Is the angle between the facing and target direction smaller than
 		// the angle the ship can turn through in one step?
-		if(fabs(angle) < ship.TurnRate())
+		if(fabs(angle) < ship.FrameStats().turnRate)
 		{
 			// If the ship is within one step of the target direction,
 			// and the facing is already sufficiently aligned with the target direction,
 			// don't turn any further.
 			if(close)
 				return 0.;
-			return -angle / ship.TurnRate();
+			return -angle / ship.FrameStats().turnRate;
 		}
 	}
 
@@ -2126,21 +2468,22 @@ bool AI::Stop(Ship &ship, Command &command, double maxSpeed, const Point directi
 	// This is a fudge factor for how straight you must be facing: it increases
 	// from 0.8 when it will take many frames to stop, to nearly 1 when it will
 	// take less than 1 frame to stop.
-	double stopTime = speed / ship.Acceleration();
+	const ShipFrameStats &stats = ship.FrameStats();
+	double stopTime = speed / stats.acceleration;
 	double limit = .8 + .2 / (1. + stopTime * stopTime * stopTime * .001);
 
 	// If you have a reverse thruster, figure out whether using it is faster
 	// than turning around and using your main thruster.
-	if(ship.Attributes().Get("reverse thrust"))
+	if(stats.reverseAcceleration)
 	{
 		// Figure out your stopping time using your main engine:
 		double degreesToTurn = TO_DEG * acos(min(1., max(-1., -velocity.Unit().Dot(angle.Unit()))));
-		double forwardTime = degreesToTurn / ship.TurnRate();
+		double forwardTime = degreesToTurn / stats.turnRate;
 		forwardTime += stopTime;
 
 		// Figure out your reverse thruster stopping time:
-		double reverseAcceleration = ship.Attributes().Get("reverse thrust") / ship.InertialMass();
-		double reverseTime = (180. - degreesToTurn) / ship.TurnRate();
+		double reverseAcceleration = stats.reverseAcceleration / stats.inertialMass;
+		double reverseTime = (180. - degreesToTurn) / stats.turnRate;
 		reverseTime += speed / reverseAcceleration;
 
 		// If you want to end up facing a specific direction, add the extra turning time.
@@ -2148,12 +2491,12 @@ bool AI::Stop(Ship &ship, Command &command, double maxSpeed, const Point directi
 		{
 			// Time to turn from facing backwards to target:
 			double degreesFromBackwards = TO_DEG * acos(min(1., max(-1., direction.Unit().Dot(-velocity.Unit()))));
-			double turnFromBackwardsTime = degreesFromBackwards / ship.TurnRate();
+			double turnFromBackwardsTime = degreesFromBackwards / stats.turnRate;
 			forwardTime += turnFromBackwardsTime;
 
 			// Time to turn from facing forwards to target:
 			double degreesFromForward = TO_DEG * acos(min(1., max(-1., direction.Unit().Dot(angle.Unit()))));
-			double turnFromForwardTime = degreesFromForward / ship.TurnRate();
+			double turnFromForwardTime = degreesFromForward / stats.turnRate;
 			reverseTime += turnFromForwardTime;
 		}
 
@@ -2178,7 +2521,7 @@ bool AI::Stop(Ship &ship, Command &command, double maxSpeed, const Point directi
 void AI::PrepareForHyperspace(Ship &ship, Command &command)
 {
 	bool hasHyperdrive = ship.JumpNavigation().HasHyperdrive();
-	double scramThreshold = ship.Attributes().Get("scram drive");
+	double scramThreshold = ship.Attributes().Get(AttributeKey::SCRAM_DRIVE);
 	bool hasJumpDrive = ship.JumpNavigation().HasJumpDrive();
 	if(!hasHyperdrive && !hasJumpDrive)
 		return;
@@ -2213,10 +2556,10 @@ void AI::PrepareForHyperspace(Ship &ship, Command &command)
 
 				// How much correction will be applied to deviation by thrusting
 				// as I turn back toward the jump direction.
-				double turnRateRadians = ship.TurnRate() * TO_RAD;
+				double turnRateRadians = ship.FrameStats().turnRate * TO_RAD;
 				double cos = ship.Facing().Unit().Dot(direction);
 				// integral(t*sin(r*x), angle/r, 0) = t/r * (1 - cos(angle)), so:
-				double correctionWhileTurning = fabs(1 - cos) * ship.Acceleration() / turnRateRadians;
+				double correctionWhileTurning = fabs(1 - cos) * ship.FrameStats().acceleration / turnRateRadians;
 				// (Note that this will always underestimate because thrust happens before turn)
 
 				if(fabs(deviation) - correctionWhileTurning > scramThreshold)
@@ -2228,9 +2571,9 @@ void AI::PrepareForHyperspace(Ship &ship, Command &command)
 	}
 	// If we're a jump drive, just stop.
 	else if(isJump)
-		Stop(ship, command, ship.Attributes().Get("jump speed"));
+		Stop(ship, command, ship.Attributes().Get(AttributeKey::JUMP_SPEED));
 	// Else stop in the fastest way to end facing in the right direction
-	else if(Stop(ship, command, ship.Attributes().Get("jump speed"), direction))
+	else if(Stop(ship, command, ship.Attributes().Get(AttributeKey::JUMP_SPEED), direction))
 		command.SetTurn(TurnToward(ship, direction));
 }
 
@@ -2257,7 +2600,7 @@ void AI::CircleAround(Ship &ship, Command &command, const Body &target)
 void AI::Swarm(Ship &ship, Command &command, const Body &target)
 {
 	Point direction = target.Position() - ship.Position();
-	double maxSpeed = ship.MaxVelocity();
+	double maxSpeed = ship.FrameStats().maxVelocity;
 	double rendezvousTime = RendezvousTime(direction, target.Velocity(), maxSpeed);
 	if(std::isnan(rendezvousTime) || rendezvousTime > 600.)
 		rendezvousTime = 600.;
@@ -2278,10 +2621,11 @@ void AI::KeepStation(Ship &ship, Command &command, const Body &target)
 	static const double THRUST_DEADBAND = .5;
 
 	// Current properties of the two ships:
-	double maxV = ship.MaxVelocity();
-	double accel = ship.Acceleration();
-	double turn = ship.TurnRate();
-	double mass = ship.InertialMass();
+	const ShipFrameStats &stats = ship.FrameStats();
+	double maxV = stats.maxVelocity;
+	double accel = stats.acceleration;
+	double turn = stats.turnRate;
+	double mass = stats.inertialMass;
 	Point unit = ship.Facing().Unit();
 	double currentAngle = ship.Facing().Degrees();
 	// This is where we want to be relative to where we are now:
@@ -2341,12 +2685,12 @@ void AI::KeepStation(Ship &ship, Command &command, const Body &target)
 		command.SetTurn(targetAngle);
 
 	// Determine whether to apply thrust.
-	Point drag = ship.Velocity() * ship.Drag() / mass;
-	if(ship.Attributes().Get("reverse thrust"))
+	Point drag = ship.Velocity() * stats.drag / mass;
+	if(ship.Attributes().Get(AttributeKey::REVERSE_THRUST))
 	{
 		// Don't take drag into account when reverse thrusting, because this
 		// estimate of how it will be applied can be quite inaccurate.
-		Point a = (unit * (-ship.Attributes().Get("reverse thrust") / mass)).Unit();
+		Point a = (unit * (-ship.Attributes().Get(AttributeKey::REVERSE_THRUST) / mass)).Unit();
 		double direction = positionWeight * positionDelta.Dot(a) / POSITION_DEADBAND
 			+ velocityWeight * velocityDelta.Dot(a) / VELOCITY_DEADBAND;
 		if(direction > THRUST_DEADBAND)
@@ -2381,7 +2725,9 @@ void AI::Attack(Ship &ship, Command &command, const Ship &target)
 
 	// Check if this ship is fast enough to keep distance from target.
 	// Have a 10% minimum to avoid ships getting in a chase loop.
-	const bool isAbleToRun = target.MaxVelocity() * SAFETY_MULTIPLIER < ship.MaxVelocity();
+	const ShipFrameStats &stats = ship.FrameStats();
+	const double targetVelocity = target.FrameStats().maxVelocity;
+	const bool isAbleToRun = targetVelocity * SAFETY_MULTIPLIER < stats.maxVelocity;
 
 	ShipAICache &shipAICache = ship.GetAICache();
 	const bool useArtilleryAI = shipAICache.IsArtilleryAI() && isAbleToRun;
@@ -2404,11 +2750,11 @@ void AI::Attack(Ship &ship, Command &command, const Ship &target)
 		double approachSpeed = (ship.Velocity() - target.Velocity()).Dot(direction.Unit());
 		double slowdownDistance = 0.;
 		// If this ship can use reverse thrusters, consider doing so.
-		double reverseSpeed = ship.MaxReverseVelocity();
-		bool useReverse = reverseSpeed && (reverseSpeed >= min(target.MaxVelocity(), ship.MaxVelocity())
+		double reverseSpeed = stats.maxReverseVelocity;
+		bool useReverse = reverseSpeed && (reverseSpeed >= min(targetVelocity, stats.maxVelocity)
 				|| target.Velocity().Dot(-direction.Unit()) <= reverseSpeed);
 		slowdownDistance = approachSpeed * approachSpeed / (useReverse ?
-			ship.ReverseAcceleration() : (ship.Acceleration() + 160. / ship.TurnRate())) / 2.;
+			stats.reverseAcceleration : (stats.acceleration + 160. / stats.turnRate)) / 2.;
 
 		// If we're too close, run away.
 		if(direction.Length() <
@@ -2463,14 +2809,14 @@ void AI::MoveToAttack(Ship &ship, Command &command, const Body &target)
 
 	// Calculate this ship's "turning radius"; that is, the smallest circle it
 	// can make while at its current speed.
-	double stepsInFullTurn = 360. / ship.TurnRate();
+	double stepsInFullTurn = 360. / ship.FrameStats().turnRate;
 	double circumference = stepsInFullTurn * ship.Velocity().Length();
 	double diameter = max(200., circumference / PI);
 
 	const auto facing = ship.Facing().Unit().Dot(direction.Unit());
 	// If the ship has reverse thrusters and the target is behind it, we can
 	// use them to reach the target more quickly.
-	if(facing < -.75 && ship.Attributes().Get("reverse thrust"))
+	if(facing < -.75 && ship.Attributes().Get(AttributeKey::REVERSE_THRUST))
 		command |= Command::BACK;
 	// This isn't perfect, but it works well enough.
 	else if((facing >= 0. && direction.Length() > diameter)
@@ -2490,14 +2836,14 @@ void AI::PickUp(Ship &ship, Command &command, const Body &target)
 	// Figure out the target's velocity relative to the ship.
 	Point p = target.Position() - ship.Position();
 	Point v = target.Velocity() - ship.Velocity();
-	double vMax = ship.MaxVelocity();
+	double vMax = ship.FrameStats().maxVelocity;
 
 	// Estimate where the target will be by the time we reach it.
 	double time = RendezvousTime(p, v, vMax);
 	if(std::isnan(time))
 		time = p.Length() / vMax;
 	double degreesToTurn = TO_DEG * acos(min(1., max(-1., p.Unit().Dot(ship.Facing().Unit()))));
-	time += degreesToTurn / ship.TurnRate();
+	time += degreesToTurn / ship.FrameStats().turnRate;
 	p += v * time;
 
 	// Move toward the target.
@@ -2519,18 +2865,18 @@ void AI::PickUp(Ship &ship, Command &command, const Body &target)
 // energy strain, or undue thermal loads if almost overheated.
 bool AI::ShouldUseAfterburner(Ship &ship)
 {
-	if(!ship.Attributes().Get("afterburner thrust"))
+	if(!ship.Attributes().Get(AttributeKey::AFTERBURNER_THRUST))
 		return false;
 
-	double fuel = ship.Fuel() * ship.Attributes().Get("fuel capacity");
-	double neededFuel = ship.Attributes().Get("afterburner fuel");
-	double energy = ship.Energy() * ship.Attributes().Get("energy capacity");
-	double neededEnergy = ship.Attributes().Get("afterburner energy");
+	double fuel = ship.Fuel() * ship.Attributes().Get(AttributeKey::FUEL_CAPACITY);
+	double neededFuel = ship.Attributes().Get(AttributeKey::AFTERBURNER_FUEL);
+	double energy = ship.Energy() * ship.Attributes().Get(AttributeKey::ENERGY_CAPACITY);
+	double neededEnergy = ship.Attributes().Get(AttributeKey::AFTERBURNER_ENERGY);
 	if(energy == 0.)
-		energy = ship.Attributes().Get("energy generation")
-				+ 0.2 * ship.Attributes().Get("solar collection")
-				- ship.Attributes().Get("energy consumption");
-	double outputHeat = ship.Attributes().Get("afterburner heat") / (100 * ship.Mass());
+		energy = ship.Attributes().Get(AttributeKey::ENERGY_GENERATION)
+				+ 0.2 * ship.Attributes().Get(AttributeKey::SOLAR_COLLECTION)
+				- ship.Attributes().Get(AttributeKey::ENERGY_CONSUMPTION);
+	double outputHeat = ship.Attributes().Get(AttributeKey::AFTERBURNER_HEAT) / (100 * ship.Mass());
 	if((!neededFuel || fuel - neededFuel > ship.JumpNavigation().JumpFuel())
 			&& (!neededEnergy || neededEnergy / energy < 0.25)
 			&& (!outputHeat || ship.Heat() + outputHeat < .9))
@@ -2655,7 +3001,7 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 	{
 		// Approach the planet and "land" on it (i.e. scan it).
 		MoveToPlanet(ship, command);
-		double atmosphereScan = ship.Attributes().Get("atmosphere scan");
+		double atmosphereScan = ship.Attributes().Get(AttributeKey::ATMOSPHERE_SCAN);
 		double distance = ship.Position().Distance(ship.GetTargetStellar()->Position());
 		if(distance < atmosphereScan && !Random::Int(100))
 			ship.SetTargetStellar(nullptr);
@@ -2665,8 +3011,8 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 	else if(target && target->IsTargetable())
 	{
 		// Approach and scan the targeted, friendly ship's cargo or outfits.
-		bool cargoScan = ship.Attributes().Get("cargo scan power");
-		bool outfitScan = ship.Attributes().Get("outfit scan power");
+		bool cargoScan = ship.Attributes().Get(AttributeKey::CARGO_SCAN_POWER);
+		bool outfitScan = ship.Attributes().Get(AttributeKey::OUTFIT_SCAN_POWER);
 		// If the pointer to the target ship exists, it is targetable and in-system.
 		bool mustScanCargo = cargoScan && !Has(ship, target, ShipEvent::SCAN_CARGO);
 		bool mustScanOutfits = outfitScan && !Has(ship, target, ShipEvent::SCAN_OUTFITS);
@@ -2674,7 +3020,7 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 			ship.SetTargetShip(shared_ptr<Ship>());
 		else
 		{
-			if(target->Velocity().Length() > ship.MaxVelocity() * 0.9)
+			if(target->Velocity().Length() > ship.FrameStats().maxVelocity * 0.9)
 				CircleAround(ship, command, *target);
 			else
 				MoveTo(ship, command, target->Position(), target->Velocity(), 1., 1.);
@@ -2688,8 +3034,8 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 
 		// Consider scanning any non-hostile ship in this system that you haven't yet personally scanned.
 		vector<Ship *> targetShips;
-		bool cargoScan = ship.Attributes().Get("cargo scan power");
-		bool outfitScan = ship.Attributes().Get("outfit scan power");
+		bool cargoScan = ship.Attributes().Get(AttributeKey::CARGO_SCAN_POWER);
+		bool outfitScan = ship.Attributes().Get(AttributeKey::OUTFIT_SCAN_POWER);
 		if(cargoScan || outfitScan)
 			for(const auto &grit : governmentRosters)
 			{
@@ -2709,7 +3055,7 @@ void AI::DoSurveillance(Ship &ship, Command &command, shared_ptr<Ship> &target)
 
 		// Consider scanning any planetary object in the system, if able.
 		vector<const StellarObject *> targetPlanets;
-		double atmosphereScan = ship.Attributes().Get("atmosphere scan");
+		double atmosphereScan = ship.Attributes().Get(AttributeKey::ATMOSPHERE_SCAN);
 		if(atmosphereScan)
 			for(const StellarObject &object : system->Objects())
 				if(object.HasSprite() && !object.IsStar() && !object.IsStation())
@@ -2764,19 +3110,19 @@ void AI::DoMining(Ship &ship, Command &command)
 	angle += Angle::Random(1.) - Angle::Random(1.);
 	double radius = miningRadius[&ship] * pow(2., angle.Unit().X());
 
-	shared_ptr<Minable> target = ship.GetTargetAsteroid();
-	if(!target || target->Velocity().Length() > ship.MaxVelocity())
+	const Minable *target = TargetAsteroid(ship);
+	if(!target || target->Velocity().Length() > ship.FrameStats().maxVelocity)
 	{
-		for(const shared_ptr<Minable> &minable : minables)
+		for(const Minable &minable : minables)
 		{
-			Point offset = minable->Position() - ship.Position();
+			Point offset = minable.Position() - ship.Position();
 			// Target only nearby minables that are within 45deg of the current heading
 			// and not moving faster than the ship can catch.
 			if(offset.Length() < 800. && offset.Unit().Dot(ship.Facing().Unit()) > .7
-					&& minable->Velocity().Dot(offset.Unit()) < ship.MaxVelocity())
+					&& minable.Velocity().Dot(offset.Unit()) < ship.FrameStats().maxVelocity)
 			{
-				target = minable;
-				ship.SetTargetAsteroid(target);
+				target = &minable;
+				ship.SetTargetAsteroid(minables.GetHandle(minable));
 				break;
 			}
 		}
@@ -2785,7 +3131,7 @@ void AI::DoMining(Ship &ship, Command &command)
 	{
 		// If the asteroid has moved well out of reach, stop tracking it.
 		if(target->Position().Distance(ship.Position()) > 1600.)
-			ship.SetTargetAsteroid(nullptr);
+			ship.SetTargetAsteroid(PoolHandle<Minable>());
 		else
 		{
 			MoveToAttack(ship, command, *target);
@@ -2796,7 +3142,7 @@ void AI::DoMining(Ship &ship, Command &command)
 
 	Point heading = Angle(30.).Rotate(ship.Position().Unit() * radius) - ship.Position();
 	command.SetTurn(TurnToward(ship, heading));
-	if(ship.Velocity().Dot(heading.Unit()) < .7 * ship.MaxVelocity())
+	if(ship.Velocity().Dot(heading.Unit()) < .7 * ship.FrameStats().maxVelocity)
 		command |= Command::FORWARD;
 }
 
@@ -2805,11 +3151,11 @@ void AI::DoMining(Ship &ship, Command &command)
 bool AI::DoHarvesting(Ship &ship, Command &command) const
 {
 	// If the ship has no target to pick up, do nothing.
-	shared_ptr<Flotsam> target = ship.GetTargetFlotsam();
+	const Flotsam *target = flotsam.Get(ship.GetTargetFlotsam());
 	if(target && !ship.CanPickUp(*target))
 	{
-		target.reset();
-		ship.SetTargetFlotsam(target);
+		target = nullptr;
+		ship.SetTargetFlotsam(PoolHandle<Flotsam>());
 	}
 	if(!target)
 	{
@@ -2819,38 +3165,49 @@ bool AI::DoHarvesting(Ship &ship, Command &command) const
 
 		// Don't chase anything that will take more than 10 seconds to reach.
 		double bestTime = 600.;
-		for(const shared_ptr<Flotsam> &it : flotsam)
+		auto consider = [&ship, &bestTime, &target](const Flotsam &it) -> void
 		{
-			if(!ship.CanPickUp(*it))
-				continue;
+			if(!ship.CanPickUp(it))
+				return;
 			// Only pick up flotsam that is nearby and that you are facing toward. Player escorts should
 			// always attempt to pick up nearby flotsams when they are given a harvest order, and so ignore
 			// the facing angle check.
-			Point p = it->Position() - ship.Position();
+			Point p = it.Position() - ship.Position();
 			double range = p.Length();
 			// Player ships do not have a restricted field of view so that they target flotsam behind them.
-			if(range > 800. || (range > 100. && p.Unit().Dot(ship.Facing().Unit()) < .9 && !ship.IsYours()))
-				continue;
+			if(range > MAX_FLOTSAM_RANGE || (range > 100. && p.Unit().Dot(ship.Facing().Unit()) < .9 && !ship.IsYours()))
+				return;
 
 			// Estimate how long it would take to intercept this flotsam.
-			Point v = it->Velocity() - ship.Velocity();
-			double vMax = ship.MaxVelocity();
+			Point v = it.Velocity() - ship.Velocity();
+			double vMax = ship.FrameStats().maxVelocity;
 			double time = RendezvousTime(p, v, vMax);
 			if(std::isnan(time))
-				continue;
+				return;
 
 			double degreesToTurn = TO_DEG * acos(min(1., max(-1., p.Unit().Dot(ship.Facing().Unit()))));
-			time += degreesToTurn / ship.TurnRate();
+			time += degreesToTurn / ship.FrameStats().turnRate;
 			if(time < bestTime)
 			{
 				bestTime = time;
-				target = it;
+				target = &it;
 			}
+		};
+		// If there is a lot of flotsam, only check the pieces near this ship.
+		if(flotsam.size() >= MIN_GRID_FLOTSAM)
+		{
+			vector<Body *> nearby;
+			flotsamGrid.Circle(ship.Position(), MAX_FLOTSAM_RANGE, nearby);
+			for(const Body *body : nearby)
+				consider(*static_cast<const Flotsam *>(body));
 		}
+		else
+			for(const Flotsam &it : flotsam)
+				consider(it);
 		if(!target)
 			return false;
 
-		ship.SetTargetFlotsam(target);
+		ship.SetTargetFlotsam(flotsam.GetHandle(*target));
 	}
 	// Deploy any carried ships to improve maneuverability.
 	if(ship.HasBays())
@@ -2872,16 +3229,16 @@ bool AI::DoCloak(Ship &ship, Command &command)
 		return false;
 
 	const Outfit &attributes = ship.Attributes();
-	if(!attributes.Get("cloak"))
+	if(!attributes.Get(AttributeKey::CLOAK))
 		return false;
 
 	// Never cloak if it will cause you to be stranded.
-	double fuelCost = attributes.Get("cloaking fuel") + attributes.Get("fuel consumption")
-		- attributes.Get("fuel generation");
-	if(attributes.Get("cloaking fuel") && !attributes.Get("ramscoop"))
+	double fuelCost = attributes.Get(AttributeKey::CLOAKING_FUEL) + attributes.Get(AttributeKey::FUEL_CONSUMPTION)
+		- attributes.Get(AttributeKey::FUEL_GENERATION);
+	if(attributes.Get(AttributeKey::CLOAKING_FUEL) && !attributes.Get(AttributeKey::RAMSCOOP))
 	{
-		double fuel = ship.Fuel() * attributes.Get("fuel capacity");
-		int steps = ceil((1. - ship.Cloaking()) / attributes.Get("cloak"));
+		double fuel = ship.Fuel() * attributes.Get(AttributeKey::FUEL_CAPACITY);
+		int steps = ceil((1. - ship.Cloaking()) / attributes.Get(AttributeKey::CLOAK));
 		// Only cloak if you will be able to fully cloak and also maintain it
 		// for as long as it will take you to reach full cloak.
 		fuel -= fuelCost * (1 + 2 * steps);
@@ -2935,7 +3292,7 @@ bool AI::DoCloak(Ship &ship, Command &command)
 	bool cloakFreely = (fuelCost <= 0.) && !ship.GetShipToAssist();
 	// If this ship is injured / repairing, it should cloak while under threat.
 	bool cloakToRepair = (ship.Health() < RETREAT_HEALTH + hysteresis)
-			&& (attributes.Get("shield generation") || attributes.Get("hull repair rate"));
+			&& (attributes.Get(AttributeKey::SHIELD_GENERATION) || attributes.Get(AttributeKey::HULL_REPAIR_RATE));
 	if(cloakToRepair && (cloakFreely || range < 2000. * (1. + hysteresis)))
 	{
 		command |= Command::CLOAK;
@@ -2951,7 +3308,7 @@ bool AI::DoCloak(Ship &ship, Command &command)
 			else
 				safety = -ship.Position().Unit();
 
-			safety *= ship.MaxVelocity();
+			safety *= ship.FrameStats().maxVelocity;
 			MoveTo(ship, command, ship.Position() + safety, safety, 1., .8);
 			return true;
 		}
@@ -2971,8 +3328,8 @@ void AI::DoScatter(Ship &ship, Command &command)
 		return;
 
 	double flip = command.Has(Command::BACK) ? -1 : 1;
-	double turnRate = ship.TurnRate();
-	double acceleration = ship.Acceleration();
+	double turnRate = ship.FrameStats().turnRate;
+	double acceleration = ship.FrameStats().acceleration;
 	// TODO: If there are many ships, use CollisionSet::Circle or another
 	// suitable method to limit which ships are checked.
 	for(const shared_ptr<Ship> &other : ships)
@@ -2986,9 +3343,9 @@ void AI::DoScatter(Ship &ship, Command &command)
 		Point offset = other->Position() - ship.Position();
 		if(offset.LengthSquared() > 400.)
 			continue;
-		if(fabs(other->TurnRate() / turnRate - 1.) > .05)
+		if(fabs(other->FrameStats().turnRate / turnRate - 1.) > .05)
 			continue;
-		if(fabs(other->Acceleration() / acceleration - 1.) > .05)
+		if(fabs(other->FrameStats().acceleration / acceleration - 1.) > .05)
 			continue;
 
 		// We are too close to this ship. Turn away from it if we aren't already facing away.
@@ -3016,8 +3373,8 @@ bool AI::DoSecretive(Ship &ship, Command &command)
 		Point scanningPos = scanningShip->Position();
 		Point pos = ship.Position();
 
-		double cargoDistance = scanningShip->Attributes().Get("cargo scan power");
-		double outfitDistance = scanningShip->Attributes().Get("outfit scan power");
+		double cargoDistance = scanningShip->Attributes().Get(AttributeKey::CARGO_SCAN_POWER);
+		double outfitDistance = scanningShip->Attributes().Get(AttributeKey::OUTFIT_SCAN_POWER);
 
 		double maxScanRange = max(cargoDistance, outfitDistance);
 		double distance = scanningPos.DistanceSquared(pos) * .0001;
@@ -3030,7 +3387,7 @@ bool AI::DoSecretive(Ship &ship, Command &command)
 				away = pos - scanningPos;
 			else
 				away = -pos;
-			away *= ship.MaxVelocity();
+			away *= ship.FrameStats().maxVelocity;
 			MoveTo(ship, command, pos + away, away, 1., 1.);
 			return true;
 		}
@@ -3046,8 +3403,9 @@ Point AI::StoppingPoint(const Ship &ship, const Point &targetVelocity, bool &sho
 	Point position = ship.Position();
 	Point velocity = ship.Velocity() - targetVelocity;
 	Angle angle = ship.Facing();
-	double acceleration = ship.Acceleration();
-	double turnRate = ship.TurnRate();
+	const ShipFrameStats &stats = ship.FrameStats();
+	double acceleration = stats.acceleration;
+	double turnRate = stats.turnRate;
 	shouldReverse = false;
 
 	// If I were to turn around and stop now the relative movement, where would that put me?
@@ -3060,7 +3418,7 @@ Point AI::StoppingPoint(const Ship &ship, const Point &targetVelocity, bool &sho
 		if(ship.IsUsingJumpDrive() || ship.IsEnteringHyperspace())
 			return position;
 
-		double maxVelocity = ship.MaxVelocity();
+		double maxVelocity = stats.maxVelocity;
 		double jumpTime = (v - maxVelocity) / 2.;
 		position += velocity.Unit() * (jumpTime * (v + maxVelocity) * .5);
 		v = maxVelocity;
@@ -3074,10 +3432,10 @@ Point AI::StoppingPoint(const Ship &ship, const Point &targetVelocity, bool &sho
 	// The average term's value will be v / 2. So:
 	stopDistance += .5 * v * v / acceleration;
 
-	if(ship.Attributes().Get("reverse thrust"))
+	if(ship.Attributes().Get(AttributeKey::REVERSE_THRUST))
 	{
 		// Figure out your reverse thruster stopping distance:
-		double reverseAcceleration = ship.Attributes().Get("reverse thrust") / ship.InertialMass();
+		double reverseAcceleration = stats.reverseAcceleration / stats.inertialMass;
 		double reverseDistance = v * (180. - degreesToTurn) / turnRate;
 		reverseDistance += .5 * v * v / reverseAcceleration;
 
@@ -3097,13 +3455,13 @@ Point AI::StoppingPoint(const Ship &ship, const Point &targetVelocity, bool &sho
 // maximum damaged to a target at the given position with its non-turret,
 // non-homing weapons. If the ship has no non-homing weapons, this just
 // returns the direction to the target.
-Point AI::TargetAim(const Ship &ship)
+Point AI::TargetAim(const Ship &ship) const
 {
 	shared_ptr<const Ship> target = ship.GetTargetShip();
 	if(target)
 		return TargetAim(ship, *target);
 
-	shared_ptr<const Minable> targetAsteroid = ship.GetTargetAsteroid();
+	const Minable *targetAsteroid = TargetAsteroid(ship);
 	if(targetAsteroid)
 		return TargetAim(ship, *targetAsteroid);
 
@@ -3175,8 +3533,8 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic)
 	else
 		targets.push_back(currentTarget);
 	// If this ship is mining, consider aiming at its target asteroid.
-	if(ship.GetTargetAsteroid())
-		targets.push_back(ship.GetTargetAsteroid().get());
+	if(TargetAsteroid(ship))
+		targets.push_back(TargetAsteroid(ship));
 
 	// If there are no targets to aim at, opportunistic turrets should sweep
 	// back and forth at random, with the sweep centered on the "outward-facing"
@@ -3214,6 +3572,7 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic)
 		return;
 	}
 	// Each hardpoint should aim at the target that it is "closest" to hitting.
+	TargetLanes lanes(targets);
 	for(const Hardpoint &hardpoint : ship.Weapons())
 		if(hardpoint.CanAim())
 		{
@@ -3226,53 +3585,23 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic)
 			// Get this projectile's average velocity.
 			const Weapon *weapon = hardpoint.GetOutfit();
 			double vp = weapon->WeightedVelocity() + .5 * weapon->RandomVelocity();
+			// Only take the ship's velocity into account if this weapon
+			// does not have its own acceleration.
+			lanes.SolveIntercepts(start, weapon->Acceleration() ? Point() : ship.Velocity(), vp,
+				weapon->TotalLifetime());
+
 			// Loop through each body this hardpoint could shoot at. Find the
 			// one that is the "best" in terms of how many frames it will take
 			// to aim at it and for a projectile to hit it.
 			double bestScore = numeric_limits<double>::infinity();
 			double bestAngle = 0.;
-			for(const Body *target : targets)
+			for(size_t i = 0; i < lanes.count; ++i)
 			{
-				Point p = target->Position() - start;
-				Point v = target->Velocity();
-				// Only take the ship's velocity into account if this weapon
-				// does not have its own acceleration.
-				if(!weapon->Acceleration())
-					v -= ship.Velocity();
-				// By the time this action is performed, the target will
-				// have moved forward one time step.
-				p += v;
-
-				double rendezvousTime = numeric_limits<double>::quiet_NaN();
-				double distance = p.Length();
-				// Beam weapons hit instantaneously if they are in range.
-				bool isInstantaneous = weapon->TotalLifetime() == 1.;
-				if(isInstantaneous && distance < vp)
-					rendezvousTime = 0.;
-				else
-				{
-					// Find out how long it would take for this projectile to reach the target.
-					if(!isInstantaneous)
-						rendezvousTime = RendezvousTime(p, v, vp);
-
-					// If there is no intersection (i.e. the turret is not facing the target),
-					// consider this target "out-of-range" but still targetable.
-					if(std::isnan(rendezvousTime))
-						rendezvousTime = max(distance / (vp ? vp : 1.), 2 * weapon->TotalLifetime());
-
-					// Determine where the target will be at that point.
-					p += v * rendezvousTime;
-
-					// All bodies within weapons range have the same basic
-					// weight. Outside that range, give them lower priority.
-					rendezvousTime = max(0., rendezvousTime - weapon->TotalLifetime());
-				}
-
 				// Determine how much the turret must turn to face that vector.
-				double degrees = (Angle(p) - aim).Degrees();
+				double degrees = (Angle(Point(lanes.aimX[i], lanes.aimY[i])) - aim).Degrees();
 				double turnTime = fabs(degrees) / weapon->TurretTurn();
 				// Always prefer targets that you are able to hit.
-				double score = turnTime + (180. / weapon->TurretTurn()) * rendezvousTime;
+				double score = turnTime + (180. / weapon->TurretTurn()) * lanes.delay[i];
 				if(score < bestScore)
 				{
 					bestScore = score;
@@ -3305,9 +3634,7 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 		beFrugal = (ship.Health() > GameData::GetGamerules().UniversalFrugalThreshold());
 		if(beFrugal)
 		{
-			auto ait = allyStrength.find(ship.GetGovernment());
-			auto eit = enemyStrength.find(ship.GetGovernment());
-			if(ait != allyStrength.end() && eit != enemyStrength.end() && ait->second < eit->second)
+			if(AllyStrength(ship.GetGovernment()) < EnemyStrength(ship.GetGovernment()))
 				beFrugal = false;
 		}
 	}
@@ -3361,6 +3688,18 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 	if(currentTarget && currentTarget->IsTargetable()
 			&& find(enemies.cbegin(), enemies.cend(), currentTarget.get()) == enemies.cend())
 		enemies.push_back(currentTarget.get());
+	// Which enemies non-homing weapons may fire at does not depend on the weapon,
+	// so check that once for all of them.
+	enemies.erase(remove_if(enemies.begin(), enemies.end(),
+		[&](const Ship *target) -> bool
+		{
+			// NPCs shoot ships that they just plundered.
+			bool hasBoarded = !ship.IsYours() && Has(ship, target->shared_from_this(), ShipEvent::BOARD);
+			if(target->IsDisabled() && (disables || (plunders && !hasBoarded)) && !disabledOverride)
+				return true;
+			// Merciful ships let fleeing ships go.
+			return target->IsFleeing() && person.IsMerciful();
+		}), enemies.end());
 
 	int index = -1;
 	for(const Hardpoint &hardpoint : ship.Weapons())
@@ -3398,7 +3737,7 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 		// fuel that you cannot leave the system if necessary.
 		if(weapon->FiringFuel())
 		{
-			double fuel = ship.Fuel() * ship.Attributes().Get("fuel capacity");
+			double fuel = ship.Fuel() * ship.Attributes().Get(AttributeKey::FUEL_CAPACITY);
 			fuel -= weapon->FiringFuel();
 			// If the ship is not ever leaving this system, it does not need to
 			// reserve any fuel.
@@ -3449,17 +3788,10 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 			}
 			continue;
 		}
-		// For non-homing weapons:
+		// For non-homing weapons, get the vector the weapon will travel along.
+		const Point aim = (ship.Facing() + hardpoint.GetAngle()).Unit() * vp;
 		for(const auto &target : enemies)
 		{
-			// NPCs shoot ships that they just plundered.
-			bool hasBoarded = !ship.IsYours() && Has(ship, target->shared_from_this(), ShipEvent::BOARD);
-			if(target->IsDisabled() && (disables || (plunders && !hasBoarded)) && !disabledOverride)
-				continue;
-			// Merciful ships let fleeing ships go.
-			if(target->IsFleeing() && person.IsMerciful())
-				continue;
-
 			Point p = target->Position() - start;
 			Point v = target->Velocity();
 			// Only take the ship's velocity into account if this weapon
@@ -3475,12 +3807,14 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 			if(!weapon->IsSafe() && p.Length() <= (weapon->BlastRadius() + weapon->TriggerRadius()))
 				continue;
 
-			// Get the vector the weapon will travel along.
-			v = (ship.Facing() + hardpoint.GetAngle()).Unit() * vp - v;
+			// Get the vector the weapon will travel along, relative to the target.
+			v = aim - v;
 			// Extrapolate over the lifetime of the projectile.
 			v *= lifetime;
 
-			const Mask &mask = target->GetMask(step);
+			// Weapons are aimed for many ships at once, so use the target's
+			// current animation frame rather than updating it.
+			const Mask &mask = target->GetMask(-1);
 			if(mask.Collide(-p, v, target->Facing()) < 1.)
 			{
 				command.SetFire(index);
@@ -3526,7 +3860,7 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, const Body &target) co
 		// Extrapolate over the lifetime of the projectile.
 		v *= lifetime;
 
-		const Mask &mask = target.GetMask(step);
+		const Mask &mask = target.GetMask(-1);
 		if(mask.Collide(-p, v, target.Facing()) < 1.)
 			command.SetFire(index);
 	}
@@ -3576,11 +3910,11 @@ double AI::RendezvousTime(const Point &p, const Point &v, double vp)
 // on the player's preferences.
 bool AI::TargetMinable(Ship &ship) const
 {
-	double scanRangeMetric = 10000. * ship.Attributes().Get("asteroid scan power");
+	double scanRangeMetric = 10000. * ship.Attributes().Get(AttributeKey::ASTEROID_SCAN_POWER);
 	if(!scanRangeMetric)
 		return false;
 	const bool findClosest = Preferences::Has("Target asteroid based on");
-	auto bestMinable = ship.GetTargetAsteroid();
+	const Minable *bestMinable = TargetAsteroid(ship);
 	double bestScore = findClosest ? numeric_limits<double>::max() : 0.;
 	auto GetDistanceMetric = [&ship](const Minable &minable) -> double {
 		return ship.Position().DistanceSquared(minable.Position());
@@ -3593,36 +3927,46 @@ bool AI::TargetMinable(Ship &ship) const
 			bestScore = bestMinable->GetValue();
 	}
 	auto MinableStrategy = [&findClosest, &bestMinable, &bestScore, &GetDistanceMetric]()
-			-> function<void(const shared_ptr<Minable> &)>
+			-> function<void(const Minable &)>
 	{
 		if(findClosest)
 			return [&bestMinable, &bestScore, &GetDistanceMetric]
-					(const shared_ptr<Minable> &minable) -> void {
-				double newScore = GetDistanceMetric(*minable);
-				if(newScore < bestScore || (newScore == bestScore && minable->GetValue() > bestMinable->GetValue()))
+					(const Minable &minable) -> void {
+				double newScore = GetDistanceMetric(minable);
+				if(newScore < bestScore || (newScore == bestScore && minable.GetValue() > bestMinable->GetValue()))
 				{
 					bestScore = newScore;
-					bestMinable = minable;
+					bestMinable = &minable;
 				}
 			};
 		else
 			return [&bestMinable, &bestScore, &GetDistanceMetric]
-					(const shared_ptr<Minable> &minable) -> void {
-				double newScore = minable->GetValue();
+					(const Minable &minable) -> void {
+				double newScore = minable.GetValue();
 				if(newScore > bestScore || (newScore == bestScore
-						&& GetDistanceMetric(*minable) < GetDistanceMetric(*bestMinable)))
+						&& GetDistanceMetric(minable) < GetDistanceMetric(*bestMinable)))
 				{
 					bestScore = newScore;
-					bestMinable = minable;
+					bestMinable = &minable;
 				}
 			};
 	};
 	auto UpdateBestMinable = MinableStrategy();
-	for(auto &&minable : minables)
+	for(const Minable &minable : minables)
 		UpdateBestMinable(minable);
-	if(bestMinable)
-		ship.SetTargetAsteroid(bestMinable);
-	return static_cast<bool>(ship.GetTargetAsteroid());
+	if(!bestMinable)
+		return false;
+
+	ship.SetTargetAsteroid(minables.GetHandle(*bestMinable));
+	return true;
+}
+
+
+
+// Get the asteroid the given ship is mining, if it still exists.
+const Minable *AI::TargetAsteroid(const Ship &ship) const
+{
+	return minables.Get(ship.GetTargetAsteroid());
 }
 
 
@@ -4055,8 +4399,8 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, Command &activeCommand
 			auto target = ship.GetTargetShip();
 			if (target && target->GetSystem() == ship.GetSystem())
 			{
-				double cargoDistanceSquared = ship.Attributes().Get("cargo scan power");
-				double outfitDistanceSquared = ship.Attributes().Get("outfit scan power");
+				double cargoDistanceSquared = ship.Attributes().Get(AttributeKey::CARGO_SCAN_POWER);
+				double outfitDistanceSquared = ship.Attributes().Get(AttributeKey::OUTFIT_SCAN_POWER);
 				double distance = cargoDistanceSquared;
 				if(cargoDistanceSquared > 0 && outfitDistanceSquared > 0)
 					distance = min(cargoDistanceSquared, outfitDistanceSquared);
@@ -4113,7 +4457,7 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, Command &activeCommand
 			command.SetTurn(activeCommands.Has(Command::RIGHT) - activeCommands.Has(Command::LEFT));
 		if(activeCommands.Has(Command::BACK))
 		{
-			if(!activeCommands.Has(Command::FORWARD) && ship.Attributes().Get("reverse thrust"))
+			if(!activeCommands.Has(Command::FORWARD) && ship.Attributes().Get(AttributeKey::REVERSE_THRUST))
 				command |= Command::BACK;
 			else if(!activeCommands.Has(Command::RIGHT | Command::LEFT | Command::AUTOSTEER))
 				command.SetTurn(TurnBackward(ship));
@@ -4123,12 +4467,11 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, Command &activeCommand
 		{
 			bool autoFire = Preferences::GetAutoFire() != Preferences::AutoFire::OFF;
 			auto targetShip = ship.GetTargetShip();
-			auto targetAsteroid = ship.GetTargetAsteroid();
-			Body* targetBody = targetShip.get();
+			const Body* targetBody = targetShip.get();
 			const System* targetSystem = nullptr;
 			if (!targetBody)
 			{
-				targetBody = targetAsteroid.get();
+				targetBody = TargetAsteroid(ship);
 				targetSystem = ship.GetSystem();
 			}
 			else
@@ -4199,15 +4542,15 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, Command &activeCommand
 	{
 		if(target && target->GetSystem() == ship.GetSystem() && target->IsTargetable())
 			command.SetTurn(TurnToward(ship, TargetAim(ship)));
-		else if(ship.GetTargetAsteroid())
-			command.SetTurn(TurnToward(ship, TargetAim(ship, *ship.GetTargetAsteroid())));
+		else if(TargetAsteroid(ship))
+			command.SetTurn(TurnToward(ship, TargetAim(ship, *TargetAsteroid(ship))));
 		else if(ship.GetTargetStellar())
 			command.SetTurn(TurnToward(ship, ship.GetTargetStellar()->Position() - ship.Position()));
 	}
 	else if((Preferences::GetAutoAim() == Preferences::AutoAim::ALWAYS_ON
 			|| (Preferences::GetAutoAim() == Preferences::AutoAim::WHEN_FIRING && isFiring))
 			&& !command.Turn() && !ship.IsBoarding()
-			&& ((target && target->GetSystem() == ship.GetSystem() && target->IsTargetable()) || ship.GetTargetAsteroid())
+			&& ((target && target->GetSystem() == ship.GetSystem() && target->IsTargetable()) || TargetAsteroid(ship))
 			&& !autoPilot.Has(Command::LAND | Command::JUMP | Command::FLEET_JUMP | Command::BOARD))
 	{
 		// Check if this ship has any forward-facing weapons.
@@ -4220,7 +4563,7 @@ void AI::MovePlayer(Ship &ship, const PlayerInfo &player, Command &activeCommand
 	}
 	if(shouldAutoAim)
 	{
-		Point pos = (target ? target->Position() : ship.GetTargetAsteroid()->Position());
+		Point pos = (target ? target->Position() : TargetAsteroid(ship)->Position());
 		if((pos - ship.Position()).Unit().Dot(ship.Facing().Unit()) >= .8)
 			command.SetTurn(TurnToward(ship, TargetAim(ship)));
 	}
@@ -4380,39 +4723,28 @@ bool AI::Has(const Ship &ship, const Government *government, int type) const
 
 
 
-void AI::UpdateStrengths(map<const Government *, int64_t> &strength, const System *playerSystem)
+void AI::UpdateStrengths(const System *playerSystem)
 {
+	if(governmentStrength.size() != Government::IndexCount())
+	{
+		governmentStrength.assign(Government::IndexCount(), 0);
+		enemyStrength.assign(Government::IndexCount(), 0);
+		allyStrength.assign(Government::IndexCount(), 0);
+		talliedStrength.clear();
+	}
+
 	// Tally the strength of a government by the strength of its present and able ships.
+	for(const auto &it : governmentRosters)
+		governmentStrength[it.first->Index()] = 0;
 	governmentRosters.clear();
 	for(const auto &it : ships)
 		if(it->GetGovernment() && it->GetSystem() == playerSystem)
 		{
 			governmentRosters[it->GetGovernment()].emplace_back(it.get());
 			if(!it->IsDisabled())
-				strength[it->GetGovernment()] += it->Strength();
+				governmentStrength[it->GetGovernment()->Index()] += it->Strength();
 		}
 
-	// Strengths of enemies and allies are rebuilt every step.
-	enemyStrength.clear();
-	allyStrength.clear();
-	for(const auto &gov : strength)
-	{
-		set<const Government *> allies;
-		for(const auto &enemy : strength)
-			if(enemy.first->IsEnemy(gov.first))
-			{
-				// "Know your enemies."
-				enemyStrength[gov.first] += enemy.second;
-				for(const auto &ally : strength)
-					if(ally.first->IsEnemy(enemy.first) && !allies.count(ally.first))
-					{
-						// "The enemy of my enemy is my friend."
-						allyStrength[gov.first] += ally.second;
-						allies.insert(ally.first);
-					}
-			}
-	}
-
 	// Ships with nearby allies consider their allies' strength as well as their own.
 	for(const auto &it : ships)
 	{
@@ -4446,19 +4778,90 @@ void AI::CacheShipLists()
 {
 	allyLists.clear();
 	enemyLists.clear();
+	governmentIndex.clear();
+	isEnemy.clear();
+	// The grid does not know the engine step, so it must not update the
+	// ships' animation frames.
+	shipGrid.Clear(-1);
 	for(const auto &git : governmentRosters)
 	{
+		governmentIndex.emplace(git.first, governmentIndex.size());
+		for(Ship *ship : git.second)
+			shipGrid.Add(*ship);
+
 		allyLists.emplace(git.first, vector<Ship *>());
 		allyLists.at(git.first).reserve(ships.size());
 		enemyLists.emplace(git.first, vector<Ship *>());
 		enemyLists.at(git.first).reserve(ships.size());
 		for(const auto &oit : governmentRosters)
 		{
-			auto &list = git.first->IsEnemy(oit.first)
-					? enemyLists[git.first] : allyLists[git.first];
+			const bool hostile = git.first->IsEnemy(oit.first);
+			isEnemy.push_back(hostile);
+			auto &list = hostile ? enemyLists[git.first] : allyLists[git.first];
 			list.insert(list.end(), oit.second.begin(), oit.second.end());
 		}
 	}
+	shipGrid.Finish();
+
+	// The grid only holds the flotsam to read where it is, so it never
+	// modifies anything added to it.
+	flotsamGrid.Clear(-1);
+	if(flotsam.size() >= MIN_GRID_FLOTSAM)
+		for(const Flotsam &it : flotsam)
+			flotsamGrid.Add(const_cast<Flotsam &>(it));
+	flotsamGrid.Finish();
+}
+
+
+
+// Add up the strength of each present government's allies and enemies. This
+// only needs to be done when a government arrives or leaves, its strength
+// changes, or two governments make peace or go to war, which is rare compared
+// to how often the AI steps.
+void AI::UpdateAllyStrengths()
+{
+	const size_t count = governmentRosters.size();
+	bool changed = (count != talliedStrength.size() || isEnemy != talliedIsEnemy);
+	auto tit = talliedStrength.begin();
+	for(auto it = governmentRosters.begin(); !changed && it != governmentRosters.end(); ++it, ++tit)
+		changed = (tit->first != it->first || tit->second != governmentStrength[it->first->Index()]);
+	if(!changed)
+		return;
+
+	for(const auto &it : talliedStrength)
+	{
+		enemyStrength[it.first->Index()] = 0;
+		allyStrength[it.first->Index()] = 0;
+	}
+	talliedStrength.clear();
+	for(const auto &it : governmentRosters)
+		talliedStrength.emplace_back(it.first, governmentStrength[it.first->Index()]);
+	talliedIsEnemy = isEnemy;
+
+	// Only governments with able ships count as allies or enemies. The rows and
+	// columns of isEnemy are in the same order as the tallied governments.
+	vector<bool> isAlly(count);
+	for(size_t gov = 0; gov < count; ++gov)
+	{
+		if(!talliedStrength[gov].second)
+			continue;
+		int64_t &enemies = enemyStrength[talliedStrength[gov].first->Index()];
+		int64_t &allies = allyStrength[talliedStrength[gov].first->Index()];
+		isAlly.assign(count, false);
+		for(size_t enemy = 0; enemy < count; ++enemy)
+			if(talliedStrength[enemy].second && isEnemy[enemy * count + gov])
+			{
+				// "Know your enemies."
+				enemies += talliedStrength[enemy].second;
+				for(size_t ally = 0; ally < count; ++ally)
+					if(talliedStrength[ally].second && isEnemy[ally * count + enemy] && !isAlly[ally])
+					{
+						// "The enemy of my enemy is my friend."
+						allies += talliedStrength[ally].second;
+						isAlly[ally] = true;
+					}
+			}
+	}
 }
 
 
@@ -4469,7 +4872,7 @@ void AI::IssueOrders(const PlayerInfo &player, const Orders &newOrders, const st
 
 	// Find out what the target of these orders is.
 	const Ship *targetShip = newOrders.target.lock().get();
-	const Minable *targetAsteroid = newOrders.targetAsteroid.lock().get();
+	const Minable *targetAsteroid = minables.Get(newOrders.targetAsteroid);
 
 	// Figure out what ships we are giving orders to.
 	vector<const Ship *> ships;
@@ -4558,7 +4961,7 @@ void AI::IssueOrders(const PlayerInfo &player, const Orders &newOrders, const st
 
 			hasMismatch |= (existing.type != newOrders.type);
 			hasMismatch |= (existing.target.lock().get() != targetShip);
-			hasMismatch |= (existing.targetAsteroid.lock().get() != targetAsteroid);
+			hasMismatch |= (minables.Get(existing.targetAsteroid) != targetAsteroid);
 			// Skip giving any new orders if the fleet is already in harvest mode and the player has selected a new
 			// asteroid.
 			if(hasMismatch && targetAsteroid)
@@ -16,12 +16,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef ES_AI_H_
 #define ES_AI_H_
 
+#include "CollisionSet.h"
 #include "Command.h"
 #include "FireCommand.h"
 #include "Point.h"
 
 #include <cstdint>
-#include <list>
+#include "ObjectPool.h"
+
 #include <map>
 #include <memory>
 #include <vector>
@@ -31,6 +33,7 @@ class AsteroidField;
 class Body;
 class Flotsam;
 class Government;
+class JobPool;
 class Minable;
 class PlayerInfo;
 class Ship;
@@ -48,21 +51,20 @@ class System;
 // the same target over and over.
 class AI {
 public:
-	// Any object that can be a ship's target is in a list of this type:
-template <class Type>
-	using List = std::list<std::shared_ptr<Type>>;
-	// Constructor, giving the AI access to various object lists.
-	AI(const List<Ship> &ships, const List<Minable> &minables, const List<Flotsam> &flotsam);
+	// Constructor, giving the AI access to various object lists and to the
+	// threads it can spread its work over.
+	AI(const std::vector<std::shared_ptr<Ship>> &ships, const ObjectPool<Minable> &minables, const ObjectPool<Flotsam> &flotsam,
+		JobPool &jobs);
 
 	// Fleet commands from the player.
 	void IssueShipTarget(const PlayerInfo &player, const std::shared_ptr<Ship> &target);
-	void IssueAsteroidTarget(const PlayerInfo &player, const std::shared_ptr<Minable> &targetAsteroid);
+	void IssueAsteroidTarget(const PlayerInfo &player, const PoolHandle<Minable> &targetAsteroid);
 	void IssueMoveTarget(const PlayerInfo &player, const Point &target, const System *moveToSystem);
 	// Commands issued via the keyboard (mostly, to the flagship).
 	void UpdateKeys(PlayerInfo &player, Command &clickCommands);
 
 	// Allow the AI to track any events it is interested in.
-	void UpdateEvents(const std::list<ShipEvent> &events);
+	void UpdateEvents(const std::vector<ShipEvent> &events);
 	// Reset the AI's memory of events.
 	void Clean();
 	// Clear ship orders. This should be done when the player lands on a planet,
@@ -75,8 +77,8 @@ template <class Type>
 	void SetMousePosition(Point position);
 
 	// Get the in-system strength of each government's allies and enemies.
-	int64_t AllyStrength(const Government *government);
-	int64_t EnemyStrength(const Government *government);
+	int64_t AllyStrength(const Government *government) const;
+	int64_t EnemyStrength(const Government *government) const;
 
 	static bool CanBoard(const Ship &ship, const Ship &target);
 
@@ -93,6 +95,11 @@ private:
 	std::shared_ptr<Ship> FindNonHostileTarget(const Ship &ship) const;
 	// Obtain a list of ships matching the desired hostility.
 	std::vector<Ship *> GetShipsList(const Ship &ship, bool targetEnemies, double maxRange = -1.) const;
+	// Check if the given ship should pick a new target on this step.
+	bool ShouldRetarget(const Ship &ship, const Ship *target, int targetTurn) const;
+	// Find new targets and aim weapons for many ships at once.
+	void PlanTargets(const Ship *flagship, const System *playerSystem);
+	void AimAndFire();
 
 	bool FollowOrders(Ship &ship, Command &command) const;
 	void MoveIndependent(Ship &ship, Command &command) const;
@@ -137,7 +144,7 @@ private:
 	// maximum damage to a target at the given position with its non-turret,
 	// non-homing weapons. If the ship has no non-homing weapons, this just
 	// returns the direction to the target.
-	static Point TargetAim(const Ship &ship);
+	Point TargetAim(const Ship &ship) const;
 	static Point TargetAim(const Ship &ship, const Body &target);
 	// Aim the given ship's turrets.
 	void AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic = false) const;
@@ -155,6 +162,8 @@ private:
 
 	// True if found asteroid.
 	bool TargetMinable(Ship &ship) const;
+	// Get the asteroid the given ship is mining, if it still exists.
+	const Minable *TargetAsteroid(const Ship &ship) const;
 	// True if the ship performed the indicated event to the other ship.
 	bool Has(const Ship &ship, const std::weak_ptr<const Ship> &other, int type) const;
 	// True if the government performed the indicated event to the other ship.
@@ -163,8 +172,9 @@ private:
 	bool Has(const Ship &ship, const Government *government, int type) const;
 
 	// Functions to classify ships based on government and system.
-	void UpdateStrengths(std::map<const Government *, int64_t> &strength, const System *playerSystem);
+	void UpdateStrengths(const System *playerSystem);
 	void CacheShipLists();
+	void UpdateAllyStrengths();
 
 
 private:
@@ -191,12 +201,47 @@ private:
 
 		int type = 0;
 		std::weak_ptr<Ship> target;
-		std::weak_ptr<Minable> targetAsteroid;
+		PoolHandle<Minable> targetAsteroid;
 		Point point;
 		const System *targetSystem = nullptr;
 	};
 
 
+	// The decisions for one ship that are made in parallel with other ships,
+	// and the state needed to finish that ship's decisions afterwards.
+	class ShipPlan {
+	public:
+		// Drop all references to other ships once the step is over.
+		void Release();
+
+	public:
+		const std::shared_ptr<Ship> *ship = nullptr;
+		int targetTurn = 0;
+		// If set, the ship has no decisions left to make this step.
+		bool isDone = true;
+
+		// The target found ahead of time, and the state it was based on.
+		bool hasNewTarget = false;
+		std::shared_ptr<Ship> oldTarget;
+		std::shared_ptr<Ship> oldParent;
+		std::shared_ptr<Ship> newTarget;
+
+		// How this ship should aim and fire its weapons.
+		bool aims = false;
+		bool opportunistic = false;
+		const Minable *targetAsteroid = nullptr;
+		FireCommand firing;
+
+		Command command;
+		std::shared_ptr<Ship> parent;
+		std::shared_ptr<Ship> target;
+		double healthRemaining = 0.;
+		bool isPresent = false;
+		bool isStranded = false;
+		bool thisIsLaunching = false;
+	};
+
+
 private:
 	void IssueOrders(const PlayerInfo &player, const Orders &newOrders, const std::string &description);
 	// Convert order types based on fulfillment status.
@@ -205,13 +250,19 @@ private:
 
 private:
 	// Data from the game engine.
-	const List<Ship> &ships;
-	const List<Minable> &minables;
-	const List<Flotsam> &flotsam;
-
-	// The current step count for the AI, ranging from 0 to 30. Its value
-	// helps limit how often certain actions occur (such as changing targets).
+	const std::vector<std::shared_ptr<Ship>> &ships;
+	const ObjectPool<Minable> &minables;
+	const ObjectPool<Flotsam> &flotsam;
+	JobPool &jobs;
+
+	// The current step count for the AI, counting up to the retarget interval
+	// and then starting again from zero. Its value helps limit how often
+	// certain actions occur (such as changing targets).
 	int step = 0;
+	int retargetInterval = 32;
+	// The number of events that may have changed which ships are worth
+	// targeting. Ships that found no target do not look again until this changes.
+	unsigned targetEventCount = 0;
 
 	// Command applied by the player's "autopilot."
 	Command autoPilot;
@@ -221,6 +272,10 @@ private:
 	// thrashing the heap, since we can reuse the storage for
 	// each ship.
 	FireCommand firingCommands;
+	// The decisions being made for each ship on this step.
+	std::vector<ShipPlan> plans;
+	// Random seeds for each block of ships that aim their weapons together.
+	std::vector<uint64_t> fireSeeds;
 
 	bool isCloaking = false;
 
@@ -252,11 +307,27 @@ private:
 
 	std::map<const Ship *, int64_t> shipStrength;
 
-	std::map<const Government *, int64_t> enemyStrength;
-	std::map<const Government *, int64_t> allyStrength;
+	// The strength of each government's able ships in the player's system, and
+	// of its allies and enemies there, indexed by government.
+	std::vector<int64_t> governmentStrength;
+	std::vector<int64_t> enemyStrength;
+	std::vector<int64_t> allyStrength;
+	// The governments and strengths, and which were enemies, when the ally and
+	// enemy strengths were last added up. They are only added up again when
+	// one of these changes.
+	std::vector<std::pair<const Government *, int64_t>> talliedStrength;
+	std::vector<bool> talliedIsEnemy;
 	std::map<const Government *, std::vector<Ship *>> governmentRosters;
 	std::map<const Government *, std::vector<Ship *>> enemyLists;
 	std::map<const Government *, std::vector<Ship *>> allyLists;
+	// All the ships in the player's system, for finding the ones near a point.
+	CollisionSet shipGrid;
+	// All the flotsam, for finding what a harvesting ship could pick up.
+	CollisionSet flotsamGrid;
+	// The index of each government with ships in the player's system, and
+	// whether the government in each row considers each column an enemy.
+	std::map<const Government *, size_t> governmentIndex;
+	std::vector<bool> isEnemy;
 };
 
 
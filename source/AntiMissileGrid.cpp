@@ -0,0 +1,115 @@
+/* AntiMissileGrid.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "AntiMissileGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// If the ships are spread out far enough to need more cells than this
+	// along either side, the cells are made larger instead.
+	const double MAX_CELLS_PER_SIDE = 64.;
+}
+
+
+
+// Index the ships at the given positions, each of which can reach out to
+// the corresponding range.
+void AntiMissileGrid::Build(const vector<Point> &newPositions, const vector<double> &newRanges)
+{
+	indices.clear();
+	positions.clear();
+	ranges.clear();
+	firstInCell.clear();
+	columns = 0;
+	rows = 0;
+	if(newPositions.empty())
+		return;
+
+	Point topLeft = newPositions.front();
+	Point bottomRight = topLeft;
+	double longest = 1.;
+	for(size_t i = 0; i < newPositions.size(); ++i)
+	{
+		topLeft = min(topLeft, newPositions[i]);
+		bottomRight = max(bottomRight, newPositions[i]);
+		longest = max(longest, newRanges[i]);
+	}
+
+	Point size = bottomRight - topLeft;
+	origin = topLeft;
+	cellSize = max(longest, max(size.X(), size.Y()) / MAX_CELLS_PER_SIDE);
+	columns = static_cast<int>(size.X() / cellSize) + 1;
+	rows = static_cast<int>(size.Y() / cellSize) + 1;
+
+	// Sort the ships into their cells by counting how many are in each.
+	auto CellOf = [this](const Point &position) -> size_t
+	{
+		int x = min(columns - 1, static_cast<int>((position.X() - origin.X()) / cellSize));
+		int y = min(rows - 1, static_cast<int>((position.Y() - origin.Y()) / cellSize));
+		return static_cast<size_t>(y) * columns + x;
+	};
+	firstInCell.assign(static_cast<size_t>(columns) * rows + 1, 0);
+	for(const Point &position : newPositions)
+		++firstInCell[CellOf(position) + 1];
+	for(size_t i = 1; i < firstInCell.size(); ++i)
+		firstInCell[i] += firstInCell[i - 1];
+
+	vector<unsigned> next(firstInCell.begin(), firstInCell.end() - 1);
+	indices.resize(newPositions.size());
+	positions.resize(newPositions.size());
+	ranges.resize(newPositions.size());
+	for(size_t i = 0; i < newPositions.size(); ++i)
+	{
+		unsigned index = next[CellOf(newPositions[i])]++;
+		indices[index] = i;
+		positions[index] = newPositions[i];
+		ranges[index] = newRanges[i];
+	}
+}
+
+
+
+// Get the index of every ship whose range reaches the given point, in
+// increasing order, in place of the result's previous contents.
+void AntiMissileGrid::Near(const Point &point, vector<unsigned> &result) const
+{
+	result.clear();
+	if(indices.empty())
+		return;
+
+	// No ship can reach farther than one cell, so only the cells next to the
+	// point's cell need to be searched.
+	Point cell = (point - origin) / cellSize;
+	if(cell.X() < -1. || cell.Y() < -1. || cell.X() >= columns + 1. || cell.Y() >= rows + 1.)
+		return;
+	int left = max(0, static_cast<int>(floor(cell.X())) - 1);
+	int top = max(0, static_cast<int>(floor(cell.Y())) - 1);
+	int right = min(columns - 1, static_cast<int>(floor(cell.X())) + 1);
+	int bottom = min(rows - 1, static_cast<int>(floor(cell.Y())) + 1);
+
+	// The cells of each row are stored together, so each row is one range.
+	for(int y = top; y <= bottom; ++y)
+	{
+		size_t row = static_cast<size_t>(y) * columns;
+		for(unsigned i = firstInCell[row + left]; i < firstInCell[row + right + 1]; ++i)
+			if(positions[i].Distance(point) <= ranges[i])
+				result.push_back(indices[i]);
+	}
+	sort(result.begin(), result.end());
+}
@@ -0,0 +1,55 @@
+/* AntiMissileGrid.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ANTI_MISSILE_GRID_H_
+#define ANTI_MISSILE_GRID_H_
+
+#include "Point.h"
+
+#include <vector>
+
+
+
+// A uniform grid over the ships that have anti-missile systems ready to fire,
+// for finding the ones that are close enough to a missile to shoot at it. The
+// cells are as large as the longest anti-missile range, so only the cells
+// around a missile's own cell need to be searched.
+class AntiMissileGrid {
+public:
+	// Index the ships at the given positions, each of which can reach out to
+	// the corresponding range.
+	void Build(const std::vector<Point> &positions, const std::vector<double> &ranges);
+
+	// Get the index of every ship whose range reaches the given point, in
+	// increasing order, in place of the result's previous contents.
+	void Near(const Point &point, std::vector<unsigned> &result) const;
+
+
+private:
+	Point origin;
+	double cellSize = 1.;
+	int columns = 0;
+	int rows = 0;
+	// The ship indices, positions and ranges sorted by cell, along with the
+	// first entry in each cell (and one past the last cell).
+	std::vector<unsigned> indices;
+	std::vector<Point> positions;
+	std::vector<double> ranges;
+	std::vector<unsigned> firstInCell;
+};
+
+
+
+#endif
@@ -105,10 +105,17 @@ int Armament::Add(const Outfit *outfit, int count)
 		// If this weapon is streamed, create a stream counter. If it is not
 		// streamed, or if the last of this weapon has been uninstalled, erase the
 		// stream counter (if there is one).
+		auto it = find_if(streamReload.begin(), streamReload.end(),
+			[outfit](const pair<const Outfit *, int> &counter) { return counter.first == outfit; });
 		if(added > 0 && outfit->IsStreamed())
-			streamReload[outfit] = 0;
-		else
-			streamReload.erase(outfit);
+		{
+			if(it == streamReload.end())
+				streamReload.emplace_back(outfit, 0);
+			else
+				it->second = 0;
+		}
+		else if(it != streamReload.end())
+			streamReload.erase(it);
 	}
 	return added;
 }
@@ -139,8 +146,8 @@ void Armament::ReloadAll()
 
 			// If this weapon is streamed, create a stream counter.
 			const Outfit *outfit = hardpoint.GetOutfit();
-			if(outfit->IsStreamed())
-				streamReload[outfit] = 0;
+			if(outfit->IsStreamed() && !StreamReload(outfit))
+				streamReload.emplace_back(outfit, 0);
 		}
 }
 
@@ -241,14 +248,16 @@ void Armament::Fire(int index, Ship &ship, vector<Projectile> &projectiles, vect
 	// A weapon that has already started a burst ignores stream timing.
 	if(!hardpoints[index].WasFiring())
 	{
-		auto it = streamReload.find(hardpoints[index].GetOutfit());
-		if(it != streamReload.end())
+		const Outfit *outfit = hardpoints[index].GetOutfit();
+		int *counter = StreamReload(outfit);
+		if(counter)
 		{
-			if(it->second > 0)
+			if(*counter > 0)
 				return;
-			it->second += it->first->Reload() * hardpoints[index].BurstRemaining();
+			*counter += outfit->Reload() * hardpoints[index].BurstRemaining();
 		}
 	}
+	MarkActive(index);
 	if(jammed)
 		hardpoints[index].Jam();
 	else
@@ -263,6 +272,7 @@ bool Armament::FireAntiMissile(int index, Ship &ship, const Projectile &projecti
 	if(static_cast<unsigned>(index) >= hardpoints.size() || !hardpoints[index].IsReady())
 		return false;
 
+	MarkActive(index);
 	if(jammed)
 	{
 		hardpoints[index].Jam();
@@ -277,8 +287,13 @@ bool Armament::FireAntiMissile(int index, Ship &ship, const Projectile &projecti
 // Update the reload counters.
 void Armament::Step(const Ship &ship)
 {
-	for(Hardpoint &hardpoint : hardpoints)
-		hardpoint.Step();
+	// Most hardpoints are idle in any given step, so only the ones that have
+	// fired recently are visited.
+	auto out = activeHardpoints.begin();
+	for(int index : activeHardpoints)
+		if(hardpoints[index].Step())
+			*out++ = index;
+	activeHardpoints.erase(out, activeHardpoints.end());
 
 	for(auto &it : streamReload)
 	{
@@ -288,3 +303,23 @@ void Armament::Step(const Ship &ship)
 		it.second = max(it.second, 1 - count);
 	}
 }
+
+
+
+// Get the stream counter for the given weapon, or null if it is not streamed.
+int *Armament::StreamReload(const Outfit *outfit)
+{
+	for(auto &it : streamReload)
+		if(it.first == outfit)
+			return &it.second;
+	return nullptr;
+}
+
+
+
+// Remember that the given hardpoint has counters to update.
+void Armament::MarkActive(int index)
+{
+	if(find(activeHardpoints.begin(), activeHardpoints.end(), index) == activeHardpoints.end())
+		activeHardpoints.push_back(index);
+}
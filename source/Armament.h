@@ -18,8 +18,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Hardpoint.h"
 
-#include <map>
 #include <set>
+#include <utility>
 #include <vector>
 
 class FireCommand;
@@ -80,12 +80,25 @@ public:
 	void Step(const Ship &ship);
 
 
+private:
+	// Get the stream counter for the given weapon, or null if it is not streamed.
+	int *StreamReload(const Outfit *outfit);
+	// Remember that the given hardpoint has counters to update.
+	void MarkActive(int index);
+
+
 private:
 	// Note: the Armament must be copied when an instance of a Ship is made, so
 	// it should not hold any pointers specific to one ship (including to
 	// elements of this Armament itself).
-	std::map<const Outfit *, int> streamReload;
+	// Each streamed weapon's shared counter. A ship only carries a few kinds
+	// of weapon, so a flat list is faster to search than a map.
+	std::vector<std::pair<const Outfit *, int>> streamReload;
 	std::vector<Hardpoint> hardpoints;
+	// The indices of the hardpoints that have fired or jammed and are not yet
+	// idle again. The rest are fully reloaded, and stepping them would not
+	// change anything.
+	std::vector<int> activeHardpoints;
 };
 
 
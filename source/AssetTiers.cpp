@@ -0,0 +1,93 @@
+/* AssetTiers.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "AssetTiers.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	const int CATEGORY_COUNT = static_cast<int>(AssetTiers::Category::OTHER) + 1;
+
+	// The largest size of each category in each tier, from the devices with the
+	// least memory to those with the most. Planets, hazes and ships are drawn
+	// big enough on screen that they are given more room than the rest.
+	const int TIER_COUNT = 3;
+	const int TIER_SIZES[TIER_COUNT][CATEGORY_COUNT] = {
+		{512, 512, 512, 256, 256, 0},
+		{1024, 1024, 1024, 512, 512, 0},
+		{0, 0, 0, 0, 0, 0}
+	};
+	// A device needs this much memory, in MB, for each tier above the lowest.
+	// A device that reports a little less than 2 GB is in the lowest tier.
+	const int TIER_RAM[TIER_COUNT] = {0, 2500, 5000};
+	// Graphics processors that can't handle textures this big are older or
+	// low-end ones, which are never given the highest tier.
+	const int CAPABLE_TEXTURE_SIZE = 8192;
+
+	int sizes[CATEGORY_COUNT] = {};
+}
+
+
+
+// Choose the tiers for a device with the given amount of memory, in MB, and
+// the given largest texture size its graphics driver supports.
+void AssetTiers::Init(int systemRAM, int maxTextureSize)
+{
+	int tier = 0;
+	while(tier + 1 < TIER_COUNT && systemRAM >= TIER_RAM[tier + 1])
+		++tier;
+	if(maxTextureSize < CAPABLE_TEXTURE_SIZE)
+		tier = min(tier, TIER_COUNT - 2);
+
+	// No image can be bigger than the driver supports, whatever its tier.
+	for(int i = 0; i < CATEGORY_COUNT; ++i)
+	{
+		int size = TIER_SIZES[tier][i];
+		sizes[i] = (size && maxTextureSize) ? min(size, maxTextureSize) : max(size, maxTextureSize);
+	}
+}
+
+
+
+// Get the category of the sprite with the given name.
+AssetTiers::Category AssetTiers::GetCategory(const string &name)
+{
+	auto HasPrefix = [&name](const char *prefix, size_t length) -> bool
+	{
+		return !name.compare(0, length, prefix);
+	};
+	if(HasPrefix("planet/", 7) || HasPrefix("star/", 5))
+		return Category::PLANET;
+	if(HasPrefix("_menu/haze", 10))
+		return Category::HAZE;
+	if(HasPrefix("ship/", 5))
+		return Category::SHIP;
+	if(HasPrefix("effect/", 7))
+		return Category::EFFECT;
+	if(HasPrefix("thumbnail/", 10))
+		return Category::THUMBNAIL;
+	return Category::OTHER;
+}
+
+
+
+// Get the largest width or height that an image in the given category may
+// have, or 0 if there is no limit.
+int AssetTiers::MaxSize(Category category)
+{
+	return sizes[static_cast<int>(category)];
+}
@@ -0,0 +1,54 @@
+/* AssetTiers.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ASSET_TIERS_H_
+#define ASSET_TIERS_H_
+
+#include <string>
+
+
+
+// Low-end devices do not have the memory to keep every large sprite at full
+// resolution. At startup, each category of large sprite is given a maximum
+// texture size based on how much memory the device has and what class of
+// graphics processor it has, and any image bigger than that is shrunk before
+// it is uploaded. Sprites are still drawn at their full size, just blurrier.
+class AssetTiers {
+public:
+	enum class Category : int {
+		PLANET,
+		HAZE,
+		SHIP,
+		EFFECT,
+		THUMBNAIL,
+		OTHER
+	};
+
+
+public:
+	// Choose the tiers for a device with the given amount of memory, in MB, and
+	// the given largest texture size its graphics driver supports.
+	static void Init(int systemRAM, int maxTextureSize);
+
+	// Get the category of the sprite with the given name.
+	static Category GetCategory(const std::string &name);
+	// Get the largest width or height that an image in the given category may
+	// have, or 0 if there is no limit.
+	static int MaxSize(Category category);
+};
+
+
+
+#endif
@@ -17,7 +17,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DrawList.h"
 #include "Mask.h"
-#include "Minable.h"
 #include "Projectile.h"
 #include "Random.h"
 #include "Screen.h"
@@ -26,6 +25,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <iterator>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 using namespace std;
 
@@ -33,6 +39,45 @@ namespace {
 	constexpr double WRAP = 4096.;
 	constexpr unsigned CELL_SIZE = 256u;
 	constexpr unsigned CELL_COUNT = WRAP / CELL_SIZE;
+
+	// Add each change to its value, keeping the result in the range [0, limit).
+	void Advance(vector<double> &values, const vector<double> &changes, double limit)
+	{
+		double *value = values.data();
+		const double *change = changes.data();
+		const size_t count = values.size();
+		size_t i = 0;
+#if defined(__SSE2__)
+		const __m128d zero = _mm_setzero_pd();
+		const __m128d top = _mm_set1_pd(limit);
+		for( ; i + 2 <= count; i += 2)
+		{
+			__m128d v = _mm_add_pd(_mm_loadu_pd(value + i), _mm_loadu_pd(change + i));
+			v = _mm_add_pd(v, _mm_and_pd(_mm_cmplt_pd(v, zero), top));
+			v = _mm_sub_pd(v, _mm_and_pd(_mm_cmpge_pd(v, top), top));
+			_mm_storeu_pd(value + i, v);
+		}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+		const float64x2_t zero = vdupq_n_f64(0.);
+		const float64x2_t top = vdupq_n_f64(limit);
+		for( ; i + 2 <= count; i += 2)
+		{
+			float64x2_t v = vaddq_f64(vld1q_f64(value + i), vld1q_f64(change + i));
+			v = vaddq_f64(v, vbslq_f64(vcltq_f64(v, zero), top, zero));
+			v = vsubq_f64(v, vbslq_f64(vcgeq_f64(v, top), top, zero));
+			vst1q_f64(value + i, v);
+		}
+#endif
+		for( ; i < count; ++i)
+		{
+			double v = value[i] + change[i];
+			if(v < 0.)
+				v += limit;
+			if(v >= limit)
+				v -= limit;
+			value[i] = v;
+		}
+	}
 }
 
 
@@ -49,7 +94,13 @@ AsteroidField::AsteroidField()
 void AsteroidField::Clear()
 {
 	asteroids.clear();
-	minables.clear();
+	positionX.clear();
+	positionY.clear();
+	velocityX.clear();
+	velocityY.clear();
+	facing.clear();
+	spin.clear();
+	minables.Clear();
 }
 
 
@@ -57,9 +108,30 @@ void AsteroidField::Clear()
 // Add a new asteroid to the list, using the sprite with the given name.
 void AsteroidField::Add(const string &name, int count, double energy)
 {
-	const Sprite *sprite = SpriteSet::Get("asteroid/" + name + "/spin");
+	Add(SpriteSet::Get("asteroid/" + name + "/spin"), count, energy);
+}
+
+
+
+// Add asteroids that use the given sprite. Unlike looking a sprite up by name,
+// this does not modify the sprite set, so it may be done on another thread.
+void AsteroidField::Add(const Sprite *sprite, int count, double energy)
+{
 	for(int i = 0; i < count; ++i)
+	{
 		asteroids.emplace_back(sprite, energy);
+		const Asteroid &asteroid = asteroids.back();
+		positionX.push_back(asteroid.Position().X());
+		positionY.push_back(asteroid.Position().Y());
+		velocityX.push_back(asteroid.Velocity().X());
+		velocityY.push_back(asteroid.Velocity().Y());
+		// Keep the angles in the range [0, 360), like the positions. Angles are
+		// stored as multiples of 360 / 65536 degrees, which a double represents
+		// exactly, so adding them up never drifts from what Angle would do.
+		double degrees = asteroid.Facing().Degrees();
+		facing.push_back(degrees < 0. ? degrees + 360. : degrees);
+		spin.push_back(asteroid.Spin().Degrees());
+	}
 }
 
 
@@ -73,38 +145,65 @@ void AsteroidField::Add(const Minable *minable, int count, double energy, const
 	// Place copies of the given minable asteroid throughout the system.
 	for(int i = 0; i < count; ++i)
 	{
-		minables.emplace_back(new Minable(*minable));
-		minables.back()->Place(energy, belts.Get());
+		Minable copy = *minable;
+		copy.Place(energy, belts.Get());
+		minables.Add(std::move(copy));
 	}
 }
 
 
 
+void AsteroidField::Swap(AsteroidField &other)
+{
+	// The collision sets are filled anew every step, so they stay where they are.
+	asteroids.swap(other.asteroids);
+	positionX.swap(other.positionX);
+	positionY.swap(other.positionY);
+	velocityX.swap(other.velocityX);
+	velocityY.swap(other.velocityY);
+	facing.swap(other.facing);
+	spin.swap(other.spin);
+
+	// Ships may still hold handles to the minables this field had, which must
+	// not find the new ones, so the minables are moved into the existing pools
+	// instead of swapping the pools themselves.
+	vector<Minable> arriving(make_move_iterator(other.minables.begin()), make_move_iterator(other.minables.end()));
+	other.minables.Clear();
+	for(Minable &minable : minables)
+		other.minables.Add(std::move(minable));
+	minables.Clear();
+	for(Minable &minable : arriving)
+		minables.Add(std::move(minable));
+}
+
+
+
 // Move all the asteroids forward one step.
-void AsteroidField::Step(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam, int step)
+void AsteroidField::Step(vector<Visual> &visuals, vector<Flotsam> &flotsam, int step)
 {
+	// Move all the asteroids at once, keeping them within the wrap square. Then
+	// update the bodies used for collision detection and drawing.
+	Advance(positionX, velocityX, WRAP);
+	Advance(positionY, velocityY, WRAP);
+	Advance(facing, spin, 360.);
+
 	asteroidCollisions.Clear(step);
-	for(Asteroid &asteroid : asteroids)
+	for(size_t i = 0; i < asteroids.size(); ++i)
 	{
-		asteroidCollisions.Add(asteroid);
-		asteroid.Step();
+		asteroids[i].Move(Point(positionX[i], positionY[i]), facing[i]);
+		asteroidCollisions.Add(asteroids[i]);
 	}
 	asteroidCollisions.Finish();
 
 	// Step through the minables. Since they are destructible, we may need to
-	// remove them from the list.
+	// remove them from the pool. The collision set points into the pool, so it
+	// is only filled once the pool has been pruned.
+	for(Minable &minable : minables)
+		minable.Move(visuals, flotsam);
+	minables.Prune();
 	minableCollisions.Clear(step);
-	auto it = minables.begin();
-	while(it != minables.end())
-	{
-		if((*it)->Move(visuals, flotsam))
-		{
-			minableCollisions.Add(**it);
-			++it;
-		}
-		else
-			it = minables.erase(it);
-	}
+	for(Minable &minable : minables)
+		minableCollisions.Add(minable);
 	minableCollisions.Finish();
 }
 
@@ -113,10 +212,22 @@ void AsteroidField::Step(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flo
 // Draw the asteroids, centered on the given location.
 void AsteroidField::Draw(DrawList &draw, const Point &center, double zoom) const
 {
-	for(const Asteroid &asteroid : asteroids)
-		asteroid.Draw(draw, center, zoom);
-	for(const shared_ptr<Minable> &minable : minables)
-		draw.Add(*minable);
+	// Asteroids with the same sprite are drawn together. The shader takes
+	// care of drawing each copy of them that is on screen.
+	for(auto it = asteroids.begin(); it != asteroids.end(); )
+	{
+		const Sprite *sprite = it->GetSprite();
+		auto end = find_if(it, asteroids.end(),
+			[sprite](const Asteroid &asteroid) { return asteroid.GetSprite() != sprite; });
+		if(draw.AddField(*it, WRAP))
+			for( ; it != end; ++it)
+				draw.AddToField(*it);
+		else
+			for( ; it != end; ++it)
+				it->Draw(draw, center, zoom);
+	}
+	for(const Minable &minable : minables)
+		draw.Add(minable);
 }
 
 
@@ -143,20 +254,21 @@ Body *AsteroidField::Collide(const Projectile &projectile, double *closestHit)
 	// outside the square, it must be "tiled" once in that direction.
 	int tileX = 1 + (minimum.X() < grid.X());
 	int tileY = 1 + (minimum.Y() < grid.Y());
-	for(int y = 0; y < tileY; ++y)
-		for(int x = 0; x < tileX; ++x)
-		{
-			Point offset = Point(x, y) * WRAP;
-			Body *body = asteroidCollisions.Line(from + offset, to + offset, closestHit);
-			if(body)
-				hit = body;
-		}
+	if(!asteroids.empty())
+		for(int y = 0; y < tileY; ++y)
+			for(int x = 0; x < tileX; ++x)
+			{
+				Point offset = Point(x, y) * WRAP;
+				Body *body = asteroidCollisions.Line(from + offset, to + offset, closestHit);
+				if(body)
+					hit = body;
+			}
 
 	// Now, check for collisions with minable asteroids. Because this is the
 	// very last collision check to be done, if a minable asteroid is the
 	// closest hit, it really is what the projectile struck - that is, we are
 	// not going to later find a ship or something else that is closer.
-	Body *body = minableCollisions.Line(projectile, closestHit);
+	Body *body = minables.empty() ? nullptr : minableCollisions.Line(projectile, closestHit);
 	if(body)
 	{
 		hit = body;
@@ -167,8 +279,8 @@ Body *AsteroidField::Collide(const Projectile &projectile, double *closestHit)
 
 
 
-// Get the list of minable asteroids.
-const list<shared_ptr<Minable>> &AsteroidField::Minables() const
+// Get the minable asteroids. Ships refer to them by their handles in this pool.
+const ObjectPool<Minable> &AsteroidField::Minables() const
 {
 	return minables;
 }
@@ -203,22 +315,19 @@ AsteroidField::Asteroid::Asteroid(const Sprite *sprite, double energy)
 
 
 
-// Move the asteroid forward one time step.
-void AsteroidField::Asteroid::Step()
+// How fast the asteroid spins in screen coordinates.
+const Angle &AsteroidField::Asteroid::Spin() const
+{
+	return spin;
+}
+
+
+
+// Update the asteroid's position after the field has moved it.
+void AsteroidField::Asteroid::Move(const Point &position, const Angle &facing)
 {
-	angle += spin;
-	position += velocity;
-
-	// Keep the position within the wrap square.
-	if(position.X() < 0.)
-		position = Point(position.X() + WRAP, position.Y());
-	else if(position.X() >= WRAP)
-		position = Point(position.X() - WRAP, position.Y());
-
-	if(position.Y() < 0.)
-		position = Point(position.X(), position.Y() + WRAP);
-	else if(position.Y() >= WRAP)
-		position = Point(position.X(), position.Y() - WRAP);
+	this->position = position;
+	angle = facing;
 }
 
 
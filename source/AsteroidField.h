@@ -19,17 +19,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Angle.h"
 #include "Body.h"
 #include "CollisionSet.h"
+#include "Minable.h"
+#include "ObjectPool.h"
 #include "Point.h"
 #include "WeightedList.h"
 
-#include <list>
-#include <memory>
 #include <string>
 #include <vector>
 
 class DrawList;
 class Flotsam;
-class Minable;
 class Projectile;
 class Sprite;
 class Visual;
@@ -52,28 +51,34 @@ public:
 	// Reset the asteroid field (typically because you entered a new system).
 	void Clear();
 	void Add(const std::string &name, int count, double energy = 1.);
+	void Add(const Sprite *sprite, int count, double energy = 1.);
 	void Add(const Minable *minable, int count, double energy, const WeightedList<double> &belts);
+	// Exchange the asteroids of this field with those of another one, e.g. one
+	// that was filled in the background before entering a new system.
+	void Swap(AsteroidField &other);
 
 	// Move all the asteroids forward one time step, and populate the asteroid and minable collision sets.
-	void Step(std::vector<Visual> &visuals, std::list<std::shared_ptr<Flotsam>> &flotsam, int step);
+	void Step(std::vector<Visual> &visuals, std::vector<Flotsam> &flotsam, int step);
 	// Draw the asteroid field, with the field of view centered on the given point.
 	void Draw(DrawList &draw, const Point &center, double zoom) const;
 	// Check if the given projectile has hit any of the asteroids, using the information
 	// in the collision sets. If a collision occurs, returns a pointer to the hit body.
 	Body *Collide(const Projectile &projectile, double *closestHit);
 
-	// Get the list of minable asteroids.
-	const std::list<std::shared_ptr<Minable>> &Minables() const;
+	// Get the minable asteroids. Ships refer to them by their handles in this pool.
+	const ObjectPool<Minable> &Minables() const;
 
 
 private:
 	// This class represents an asteroid that cannot be destroyed or even
-	// deflected from its trajectory, and that repeats every 4096 pixels.
+	// deflected from its trajectory, and that repeats every 4096 pixels. The
+	// field steps all the asteroids at once, and then updates their bodies.
 	class Asteroid : public Body {
 	public:
 		Asteroid(const Sprite *sprite, double energy);
 
-		void Step();
+		const Angle &Spin() const;
+		void Move(const Point &position, const Angle &facing);
 		void Draw(DrawList &draw, const Point &center, double zoom) const;
 
 	private:
@@ -84,7 +89,15 @@ private:
 
 private:
 	std::vector<Asteroid> asteroids;
-	std::list<std::shared_ptr<Minable>> minables;
+	// The motion of each of the asteroids above, stored as separate arrays so
+	// that they can all be stepped together. Angles are in degrees.
+	std::vector<double> positionX;
+	std::vector<double> positionY;
+	std::vector<double> velocityX;
+	std::vector<double> velocityY;
+	std::vector<double> facing;
+	std::vector<double> spin;
+	ObjectPool<Minable> minables;
 
 	CollisionSet asteroidCollisions;
 	CollisionSet minableCollisions;
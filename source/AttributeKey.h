@@ -0,0 +1,187 @@
+/* AttributeKey.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ATTRIBUTE_KEY_H_
+#define ATTRIBUTE_KEY_H_
+
+
+
+// Attributes that ship and AI code looks up every frame. Each of these has a
+// fixed index, so that a Dictionary can find its value without searching for
+// it by name. The keys must be listed in the order that their names sort in
+// (as compared by strcmp), and the names themselves are in Dictionary.cpp.
+enum class AttributeKey : int {
+	ABSOLUTE_THRESHOLD,
+	ACTIVE_COOLING,
+	AFTERBURNER_BURN,
+	AFTERBURNER_CORROSION,
+	AFTERBURNER_DISCHARGE,
+	AFTERBURNER_DISRUPTION,
+	AFTERBURNER_ENERGY,
+	AFTERBURNER_FUEL,
+	AFTERBURNER_HEAT,
+	AFTERBURNER_HULL,
+	AFTERBURNER_ION,
+	AFTERBURNER_LEAKAGE,
+	AFTERBURNER_SCRAMBLE,
+	AFTERBURNER_SHIELDS,
+	AFTERBURNER_SLOWING,
+	AFTERBURNER_THRUST,
+	ASTEROID_SCAN_POWER,
+	ATMOSPHERE_SCAN,
+	AUTOMATON,
+	BUNKS,
+	BURN_PROTECTION,
+	BURN_RESISTANCE,
+	BURN_RESISTANCE_ENERGY,
+	BURN_RESISTANCE_FUEL,
+	BURN_RESISTANCE_HEAT,
+	CARGO_SCAN_EFFICIENCY,
+	CARGO_SCAN_POWER,
+	CARGO_SPACE,
+	CLOAK,
+	CLOAKING_ENERGY,
+	CLOAKING_FUEL,
+	CLOAKING_HEAT,
+	COOLING,
+	COOLING_ENERGY,
+	COOLING_INEFFICIENCY,
+	CORROSION_PROTECTION,
+	CORROSION_RESISTANCE,
+	CORROSION_RESISTANCE_ENERGY,
+	CORROSION_RESISTANCE_FUEL,
+	CORROSION_RESISTANCE_HEAT,
+	CREW_EQUIVALENT,
+	DEPLETED_SHIELD_DELAY,
+	DISABLED_REPAIR_DELAY,
+	DISCHARGE_PROTECTION,
+	DISCHARGE_RESISTANCE,
+	DISCHARGE_RESISTANCE_ENERGY,
+	DISCHARGE_RESISTANCE_FUEL,
+	DISCHARGE_RESISTANCE_HEAT,
+	DISRUPTION_PROTECTION,
+	DISRUPTION_RESISTANCE,
+	DISRUPTION_RESISTANCE_ENERGY,
+	DISRUPTION_RESISTANCE_FUEL,
+	DISRUPTION_RESISTANCE_HEAT,
+	DRAG,
+	DRAG_REDUCTION,
+	ENERGY_CAPACITY,
+	ENERGY_CONSUMPTION,
+	ENERGY_GENERATION,
+	ENERGY_PROTECTION,
+	FLOTSAM_CHANCE,
+	FORCE_PROTECTION,
+	FUEL_CAPACITY,
+	FUEL_CONSUMPTION,
+	FUEL_ENERGY,
+	FUEL_GENERATION,
+	FUEL_HEAT,
+	FUEL_PROTECTION,
+	HEAT_CAPACITY,
+	HEAT_DISSIPATION,
+	HEAT_GENERATION,
+	HEAT_PROTECTION,
+	HIGH_SHIELD_PERMEABILITY,
+	HULL,
+	HULL_ENERGY,
+	HULL_ENERGY_MULTIPLIER,
+	HULL_FUEL,
+	HULL_FUEL_MULTIPLIER,
+	HULL_HEAT,
+	HULL_HEAT_MULTIPLIER,
+	HULL_PROTECTION,
+	HULL_REPAIR_MULTIPLIER,
+	HULL_REPAIR_RATE,
+	HULL_THRESHOLD,
+	HYPERDRIVE,
+	INERTIA_REDUCTION,
+	INSCRUTABLE,
+	ION_PROTECTION,
+	ION_RESISTANCE,
+	ION_RESISTANCE_ENERGY,
+	ION_RESISTANCE_FUEL,
+	ION_RESISTANCE_HEAT,
+	JUMP_DRIVE,
+	JUMP_SPEED,
+	LANDING_SPEED,
+	LEAK_PROTECTION,
+	LEAK_RESISTANCE,
+	LEAK_RESISTANCE_ENERGY,
+	LEAK_RESISTANCE_FUEL,
+	LEAK_RESISTANCE_HEAT,
+	LOW_SHIELD_PERMEABILITY,
+	OUTFIT_SCAN_EFFICIENCY,
+	OUTFIT_SCAN_POWER,
+	OUTFIT_SPACE,
+	OVERHEAT_DAMAGE_RATE,
+	OVERHEAT_DAMAGE_THRESHOLD,
+	PIERCING_PROTECTION,
+	PIERCING_RESISTANCE,
+	RAMSCOOP,
+	REPAIR_DELAY,
+	REQUIRED_CREW,
+	REVERSE_THRUST,
+	SCRAM_DRIVE,
+	SCRAMBLE_PROTECTION,
+	SCRAMBLE_RESISTANCE,
+	SCRAMBLE_RESISTANCE_ENERGY,
+	SCRAMBLE_RESISTANCE_FUEL,
+	SCRAMBLE_RESISTANCE_HEAT,
+	SELF_DESTRUCT,
+	SHIELD_DELAY,
+	SHIELD_ENERGY,
+	SHIELD_ENERGY_MULTIPLIER,
+	SHIELD_FUEL,
+	SHIELD_FUEL_MULTIPLIER,
+	SHIELD_GENERATION,
+	SHIELD_GENERATION_MULTIPLIER,
+	SHIELD_HEAT,
+	SHIELD_HEAT_MULTIPLIER,
+	SHIELD_PROTECTION,
+	SHIELDS,
+	SLOWING_PROTECTION,
+	SLOWING_RESISTANCE,
+	SLOWING_RESISTANCE_ENERGY,
+	SLOWING_RESISTANCE_FUEL,
+	SLOWING_RESISTANCE_HEAT,
+	SOLAR_COLLECTION,
+	SOLAR_HEAT,
+	THRESHOLD_PERCENTAGE,
+	THRUST,
+	THRUSTING_ENERGY,
+	TURN,
+	TURNING_BURN,
+	TURNING_CORROSION,
+	TURNING_DISCHARGE,
+	TURNING_DISRUPTION,
+	TURNING_ENERGY,
+	TURNING_FUEL,
+	TURNING_HEAT,
+	TURNING_HULL,
+	TURNING_ION,
+	TURNING_LEAKAGE,
+	TURNING_SCRAMBLE,
+	TURNING_SHIELDS,
+	TURNING_SLOWING,
+	TURRET_MOUNTS,
+
+	// The number of keys. This must always be last.
+	COUNT
+};
+
+
+
+#endif
@@ -16,22 +16,31 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Audio.h"
 
 #include "Files.h"
+#include "JobPool.h"
 #include "Logger.h"
+#include "MemoryStats.h"
 #include "Music.h"
 #include "Point.h"
+#include "Preferences.h"
+#include "Profiler.h"
 #include "Random.h"
 #include "Sound.h"
+#include "ThreadPlacement.h"
 
 #include <AL/al.h>
 #include <AL/alc.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdint>
 #include <map>
 #include <mutex>
 #include <set>
 #include <stdexcept>
 #include <thread>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 using namespace std;
@@ -43,12 +52,45 @@ namespace {
 	class QueueEntry {
 	public:
 		void Add(Point position);
-		void Add(const QueueEntry &other);
 
+		const Sound *sound = nullptr;
 		Point sum;
 		double weight = 0.;
 	};
 
+	// A request to play a sound, made by a thread other than the main one.
+	class Request {
+	public:
+		const Sound *sound = nullptr;
+		Point position;
+	};
+
+	// A bounded queue that any number of threads can add requests to without
+	// taking a lock, and that only the main thread takes requests from. Each
+	// slot's sequence number tells whether it is free to be written, or ready
+	// to be read, for a given lap around the ring.
+	class RequestQueue {
+	public:
+		RequestQueue();
+
+		// Returns false if the queue is full.
+		bool Push(const Sound *sound, const Point &position);
+		bool Pop(Request &request);
+
+	private:
+		class Slot {
+		public:
+			std::atomic<size_t> sequence;
+			Request request;
+		};
+
+		static const size_t CAPACITY = 4096;
+		Slot slots[CAPACITY];
+		std::atomic<size_t> tail;
+		// Only the main thread reads the head.
+		size_t head = 0;
+	};
+
 	// OpenAL only allows a certain number of distinct sound sources. To work
 	// around that limitation, multiple instances of the same sound playing at
 	// the same time will be "coalesced" into a single source, and sources will
@@ -57,17 +99,37 @@ namespace {
 	public:
 		Source(const Sound *sound, unsigned source);
 
-		void Move(const QueueEntry &entry) const;
+		void Move(const QueueEntry &entry);
 		unsigned ID() const;
 		const Sound *GetSound() const;
+		// How audible this source was when it was last moved.
+		double Priority() const;
 
 	private:
 		const Sound *sound = nullptr;
 		unsigned source = 0;
+		double priority = 0.;
 	};
 
 	// Thread entry point for loading the sound files.
 	void Load();
+	// Get the named sound, creating it if necessary. The audio mutex must be held.
+	Sound &GetSound(const string &name);
+	// Add a sound to this frame's queue. Only the main thread may do this.
+	void Enqueue(const Sound *sound, const Point &position);
+	// Make sure the given sound's samples are decoded, and remember that it
+	// now takes up some of the sound budget.
+	bool Decode(Sound &sound);
+	bool Decode(const Sound *sound);
+	void Upload(Sound &sound, const vector<char> &samples, uint32_t frequency);
+	// Check whether more sounds may be decoded without going over the budget.
+	bool HasRoom();
+	// Free the sounds that have gone unplayed the longest, until the decoded
+	// sounds fit in the budget again. Only the main thread may do this.
+	void TrimDecoded();
+	void MarkPlayed(unsigned id);
+	uint64_t LastPlayed(unsigned id);
+	size_t DecodedBudget();
 
 
 	// Mutex to make sure different threads don't modify the audio at the same time.
@@ -79,11 +141,15 @@ namespace {
 	bool isInitialized = false;
 	double volume = .125;
 
-	// This queue keeps track of sounds that have been requested to play. Each
-	// added sound is "deferred" until the next audio position update to make
-	// sure that all sounds from a given frame start at the same time.
-	map<const Sound *, QueueEntry> queue;
-	map<const Sound *, QueueEntry> deferred;
+	// This queue keeps track of sounds that have been requested to play. It has
+	// one entry per sound ID, and a list of which IDs are in use this frame.
+	// Sounds requested by other threads are "deferred" in the request queue (or
+	// if it is ever full, the overflow list) until the next audio position
+	// update, to make sure that all sounds from a given frame start at the same time.
+	vector<QueueEntry> queue;
+	vector<unsigned> queued;
+	RequestQueue requests;
+	vector<Request> overflow;
 	thread::id mainThreadID;
 
 	// Sound resources that have been loaded from files.
@@ -92,12 +158,41 @@ namespace {
 	// of these, so they must be reused.
 	vector<Source> sources;
 	vector<unsigned> recycledSources;
-	vector<unsigned> endingSources;
+	vector<Source> endingSources;
+	// The most sources that may play at once. Mobile devices have fewer voices
+	// to spare, and mixing inaudible sounds wastes their CPU time.
+#ifdef ES_GLES
+	unsigned maxSources = 32;
+#else
 	unsigned maxSources = 255;
-
-	// Queue and thread for loading sound files in the background.
+#endif
+	// Sounds whose queue entry weight is below this (about a twentieth of the
+	// full volume, summed over every instance) are too quiet to be worth a voice.
+	const double MIN_AUDIBLE_WEIGHT = .0025;
+	// The queued sounds that are loud enough to play, loudest first.
+	vector<unsigned> audible;
+
+	// Sounds are decoded when they are first needed (or ahead of time, while
+	// there is room for them), and the ones that have gone unplayed the longest
+	// are freed again whenever the decoded sounds take more than the budget.
+	mutex decodeMutex;
+	vector<Sound *> decoded;
+	size_t decodedBytes = 0;
+	// The step in which each sound, by ID, last started or continued playing.
+	// Only the main thread uses these.
+	vector<uint64_t> lastPlayed;
+	uint64_t stepCount = 0;
+
+	// Queue and thread for loading sound files in the background, and how many
+	// of the queued sounds have been loaded so far.
 	map<string, string> loadQueue;
 	thread loadThread;
+	size_t soundsToLoad = 0;
+	size_t soundsLoaded = 0;
+	// The loading thread decodes sounds using a few workers, but leaves room
+	// for the sprites that are being loaded at the same time.
+	const unsigned MAX_LOAD_THREADS = 3;
+	const size_t LOAD_BATCH_PER_THREAD = 4;
 
 	// The current position of the "listener," i.e. the center of the screen.
 	Point listener;
@@ -168,6 +263,7 @@ void Audio::Init(const vector<string> &sources)
 		}
 	}
 	// Begin loading the files.
+	soundsToLoad = loadQueue.size();
 	if(!loadQueue.empty())
 		loadThread = thread(&Load);
 
@@ -211,9 +307,7 @@ double Audio::GetProgress()
 	if(loadQueue.empty())
 		return 1.;
 
-	double done = sounds.size();
-	double total = done + loadQueue.size();
-	return done / total;
+	return static_cast<double>(soundsLoaded) / soundsToLoad;
 }
 
 
@@ -241,7 +335,7 @@ void Audio::SetVolume(double level)
 const Sound *Audio::Get(const string &name)
 {
 	unique_lock<mutex> lock(audioMutex);
-	return &sounds[name];
+	return &GetSound(name);
 }
 
 
@@ -256,9 +350,14 @@ void Audio::Update(const Point &listenerPosition)
 
 	listener = listenerPosition;
 
-	for(const auto &it : deferred)
-		queue[it.first].Add(it.second);
-	deferred.clear();
+	Request request;
+	while(requests.Pop(request))
+		Enqueue(request.sound, request.position);
+
+	unique_lock<mutex> lock(audioMutex);
+	for(const Request &it : overflow)
+		Enqueue(it.sound, it.position);
+	overflow.clear();
 }
 
 
@@ -275,17 +374,19 @@ void Audio::Play(const Sound *sound)
 // "listener". This will make it softer and change the left / right balance.
 void Audio::Play(const Sound *sound, const Point &position)
 {
-	if(!isInitialized || !sound || !sound->Buffer() || !volume)
+	if(!isInitialized || !sound || !sound->IsLoaded() || !volume)
 		return;
 
 	// Place sounds from the main thread directly into the queue. They are from
 	// the UI, and the Engine may not be running right now to call Update().
 	if(this_thread::get_id() == mainThreadID)
-		queue[sound].Add(position - listener);
-	else
+		Enqueue(sound, position - listener);
+	else if(!requests.Push(sound, position - listener))
 	{
 		unique_lock<mutex> lock(audioMutex);
-		deferred[sound].Add(position - listener);
+		overflow.emplace_back();
+		overflow.back().sound = sound;
+		overflow.back().position = position - listener;
 	}
 }
 
@@ -318,6 +419,7 @@ void Audio::Step()
 	if(!isInitialized)
 		return;
 
+	++stepCount;
 	vector<Source> newSources;
 	// For each sound that is looping, see if it is going to continue. For other
 	// sounds, check if they are done playing.
@@ -325,17 +427,18 @@ void Audio::Step()
 	{
 		if(source.GetSound()->IsLooping())
 		{
-			auto it = queue.find(source.GetSound());
-			if(it != queue.end())
+			unsigned id = source.GetSound()->ID();
+			if(id < queue.size() && queue[id].weight >= MIN_AUDIBLE_WEIGHT)
 			{
-				source.Move(it->second);
 				newSources.push_back(source);
-				queue.erase(it);
+				newSources.back().Move(queue[id]);
+				queue[id] = QueueEntry();
+				MarkPlayed(id);
 			}
 			else
 			{
 				alSourcei(source.ID(), AL_LOOPING, false);
-				endingSources.push_back(source.ID());
+				endingSources.push_back(source);
 			}
 		}
 		else
@@ -346,7 +449,11 @@ void Audio::Step()
 			if(state == AL_PLAYING)
 				newSources.push_back(source);
 			else
+			{
+				// Let go of the buffer, so that it can be freed if need be.
+				alSourcei(source.ID(), AL_BUFFER, 0);
 				recycledSources.push_back(source.ID());
+			}
 		}
 	}
 	// These sources were looping and are now wrapping up a loop.
@@ -354,57 +461,102 @@ void Audio::Step()
 	while(it != endingSources.end())
 	{
 		ALint state;
-		alGetSourcei(*it, AL_SOURCE_STATE, &state);
+		alGetSourcei(it->ID(), AL_SOURCE_STATE, &state);
 		if(state == AL_PLAYING)
 		{
 			// Fade out the sound. This avoids a clicking or rasping sound if a
 			// sound is cut off in the middle of its loop.
 			float gain = 1.f;
-			alGetSourcef(*it, AL_GAIN, &gain);
+			alGetSourcef(it->ID(), AL_GAIN, &gain);
 			gain = max(0.f, gain - .05f);
-			alSourcef(*it, AL_GAIN, gain);
+			alSourcef(it->ID(), AL_GAIN, gain);
 			++it;
 		}
 		else
 		{
-			recycledSources.push_back(*it);
+			alSourcei(it->ID(), AL_BUFFER, 0);
+			recycledSources.push_back(it->ID());
 			it = endingSources.erase(it);
 		}
 	}
 	newSources.swap(sources);
 
 	// Now, what is left in the queue is sounds that want to play, and that do
-	// not correspond to an existing source.
-	for(const auto &it : queue)
+	// not correspond to an existing source. Skip any that are too quiet to
+	// hear, and start the loudest ones first in case there are not enough
+	// sources for all of them.
+	audible.clear();
+	int culled = 0;
+	for(unsigned id : queued)
 	{
+		if(queue[id].weight >= MIN_AUDIBLE_WEIGHT)
+			audible.push_back(id);
+		else
+			culled += static_cast<bool>(queue[id].sound);
+	}
+	sort(audible.begin(), audible.end(), [](unsigned a, unsigned b) -> bool
+		{
+			return queue[a].weight > queue[b].weight;
+		});
+	int stolen = 0;
+	for(unsigned id : audible)
+	{
+		const QueueEntry &entry = queue[id];
+		// A sound that is played for the first time, or for the first time in
+		// a long while, must be decoded before it can start.
+		if(!Decode(entry.sound))
+			continue;
+
 		// Use a recycled source if possible. Otherwise, create a new one.
 		unsigned source = 0;
-		if(recycledSources.empty())
+		if(!recycledSources.empty())
+		{
+			source = recycledSources.back();
+			recycledSources.pop_back();
+		}
+		else if(sources.size() < maxSources)
 		{
-			if(sources.size() >= maxSources)
-				break;
-
 			alGenSources(1, &source);
+			// If we just tried to generate a new source and OpenAL would
+			// not give us one, we've reached this system's limit for the
+			// number of concurrent sounds.
 			if(!source)
-			{
-				// If we just tried to generate a new source and OpenAL would
-				// not give us one, we've reached this system's limit for the
-				// number of concurrent sounds.
 				maxSources = sources.size();
-				break;
-			}
 		}
-		else
+		if(!source)
 		{
-			source = recycledSources.back();
-			recycledSources.pop_back();
+			// If every source is in use, take over the quietest sound that is
+			// not looping, if it is quieter than this one. Since the queue is
+			// sorted by loudness, none of the remaining sounds can do so either.
+			auto quietest = sources.end();
+			for(auto it = sources.begin(); it != sources.end(); ++it)
+				if(!it->GetSound()->IsLooping() && (quietest == sources.end()
+						|| it->Priority() < quietest->Priority()))
+					quietest = it;
+			if(quietest == sources.end() || quietest->Priority() >= entry.weight)
+				break;
+
+			source = quietest->ID();
+			alSourceStop(source);
+			*quietest = sources.back();
+			sources.pop_back();
+			++stolen;
 		}
 		// Begin playing this sound.
-		sources.emplace_back(it.first, source);
-		sources.back().Move(it.second);
+		sources.emplace_back(entry.sound, source);
+		sources.back().Move(entry);
 		alSourcePlay(source);
+		MarkPlayed(id);
 	}
-	queue.clear();
+	for(unsigned id : queued)
+		queue[id] = QueueEntry();
+	queued.clear();
+	TrimDecoded();
+
+	Profiler::SetCounter("Audio voices", sources.size());
+	Profiler::SetCounter("Audio voices ending", endingSources.size());
+	Profiler::SetCounter("Audio sounds culled", culled);
+	Profiler::SetCounter("Audio voices stolen", stolen);
 
 	// Queue up new buffers for the music, if necessary.
 	int buffersDone = 0;
@@ -471,9 +623,10 @@ void Audio::Quit()
 	sources.clear();
 
 	// Also clean up any sources that are fading out.
-	for(unsigned id : endingSources)
+	for(const Source &source : endingSources)
 	{
-		alSourceStop(id);
+		alSourceStop(source.ID());
+		ALuint id = source.ID();
 		alDeleteSources(1, &id);
 	}
 	endingSources.clear();
@@ -484,12 +637,11 @@ void Audio::Quit()
 	recycledSources.clear();
 
 	// Free the memory buffers for all the sound resources.
-	for(const auto &it : sounds)
-	{
-		ALuint id = it.second.Buffer();
-		alDeleteBuffers(1, &id);
-	}
+	for(auto &it : sounds)
+		it.second.Unload();
 	sounds.clear();
+	decoded.clear();
+	decodedBytes = 0;
 
 	// Clean up the music source and buffers.
 	if(isInitialized)
@@ -547,11 +699,55 @@ namespace {
 
 
 
-	// Combine two queue entries.
-	void QueueEntry::Add(const QueueEntry &other)
+	RequestQueue::RequestQueue()
+		: tail(0)
 	{
-		sum += other.sum;
-		weight += other.weight;
+		for(size_t i = 0; i < CAPACITY; ++i)
+			slots[i].sequence.store(i, memory_order_relaxed);
+	}
+
+
+
+	// Claim the next free slot and fill it in. A slot is free for the request at
+	// position "pos" once its sequence number equals that position.
+	bool RequestQueue::Push(const Sound *sound, const Point &position)
+	{
+		size_t pos = tail.load(memory_order_relaxed);
+		Slot *slot = nullptr;
+		while(true)
+		{
+			slot = &slots[pos % CAPACITY];
+			size_t sequence = slot->sequence.load(memory_order_acquire);
+			if(sequence == pos)
+			{
+				if(tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+					break;
+			}
+			else if(sequence < pos)
+				return false;
+			else
+				pos = tail.load(memory_order_relaxed);
+		}
+		slot->request.sound = sound;
+		slot->request.position = position;
+		slot->sequence.store(pos + 1, memory_order_release);
+		return true;
+	}
+
+
+
+	// Take the oldest request, if it has been completely written. Afterwards,
+	// the slot is free for the request one lap around the ring later.
+	bool RequestQueue::Pop(Request &request)
+	{
+		Slot &slot = slots[head % CAPACITY];
+		if(slot.sequence.load(memory_order_acquire) != head + 1)
+			return false;
+
+		request = slot.request;
+		slot.sequence.store(head + CAPACITY, memory_order_release);
+		++head;
+		return true;
 	}
 
 
@@ -575,8 +771,9 @@ namespace {
 
 
 	// Reposition this source based on the given entry in a sound queue.
-	void Source::Move(const QueueEntry &entry) const
+	void Source::Move(const QueueEntry &entry)
 	{
+		priority = entry.weight;
 		Point angle = entry.sum / entry.weight;
 		// The source should be along the vector (angle.X(), angle.Y(), 1).
 		// The length of the vector should be sqrt(1 / weight).
@@ -602,34 +799,231 @@ namespace {
 
 
 
-	// Thread entry point for loading sounds.
+	// Get how audible this source was when it was last moved.
+	double Source::Priority() const
+	{
+		return priority;
+	}
+
+
+
+	// Thread entry point for loading sounds. The files are read and decoded by a
+	// small pool of workers, a batch at a time, and then this thread hands the
+	// samples to OpenAL.
 	void Load()
 	{
-		string name;
-		string path;
-		Sound *sound;
+		ThreadPlacement::Assign(ThreadPlacement::Role::LOADER);
+		JobPool pool(min(JobPool::DefaultThreadCount(), MAX_LOAD_THREADS));
+		const size_t batchSize = LOAD_BATCH_PER_THREAD * pool.Concurrency();
+
+		vector<pair<string, string>> batch;
+		vector<Sound *> batchSounds;
+		vector<char> isLoaded;
+		vector<vector<char>> samples(batchSize);
+		vector<uint32_t> frequencies(batchSize);
 		while(true)
 		{
+			batch.clear();
+			batchSounds.clear();
 			{
 				unique_lock<mutex> lock(audioMutex);
-				// If this is not the first time through, remove the previous item
-				// in the queue. This is a signal that it has been loaded, so we
-				// must not remove it until after loading the file.
-				if(!path.empty() && !loadQueue.empty())
-					loadQueue.erase(loadQueue.begin());
 				if(loadQueue.empty())
 					return;
-				name = loadQueue.begin()->first;
-				path = loadQueue.begin()->second;
+				// Since we need to unlock the mutex below, create the map entries
+				// now to avoid a race condition when accessing the sounds.
+				for(auto it = loadQueue.begin(); it != loadQueue.end() && batch.size() < batchSize; ++it)
+				{
+					batch.emplace_back(it->first, it->second);
+					batchSounds.push_back(&GetSound(it->first));
+				}
+			}
 
-				// Since we need to unlock the mutex below, create the map entry to
-				// avoid a race condition when accessing sounds' size.
-				sound = &sounds[name];
+			// Unlock the mutex for the time-intensive part of the loop. Decode
+			// sounds ahead of time only while there is room for them.
+			isLoaded.assign(batch.size(), false);
+			for(size_t i = 0; i < batch.size(); ++i)
+				isLoaded[i] = batchSounds[i]->Load(batch[i].second, batch[i].first);
+			if(HasRoom())
+			{
+				pool.ParallelFor(batch.size(), [&](size_t i)
+					{
+						if(isLoaded[i])
+							isLoaded[i] = batchSounds[i]->Read(samples[i], frequencies[i]);
+					});
+				for(size_t i = 0; i < batch.size(); ++i)
+				{
+					if(isLoaded[i] && HasRoom())
+						Upload(*batchSounds[i], samples[i], frequencies[i]);
+					vector<char>().swap(samples[i]);
+				}
 			}
+			for(size_t i = 0; i < batch.size(); ++i)
+				if(!isLoaded[i])
+					Logger::LogError("Unable to load sound \"" + batch[i].first + "\" from path: " + batch[i].second);
+
+			// Removing the sounds from the queue is the signal that they have been
+			// loaded, so it must not be done until after loading the files. The
+			// queue may have been cleared in the meantime, if the game is quitting.
+			unique_lock<mutex> lock(audioMutex);
+			for(const auto &it : batch)
+				soundsLoaded += loadQueue.erase(it.first);
+		}
+	}
+
+
+
+	// Get the named sound, creating it if necessary. Sounds are never removed
+	// while the game runs, so the IDs stay dense.
+	Sound &GetSound(const string &name)
+	{
+		auto it = sounds.find(name);
+		if(it == sounds.end())
+			it = sounds.emplace(piecewise_construct, forward_as_tuple(name), forward_as_tuple(sounds.size())).first;
+		return it->second;
+	}
+
+
+
+	// Add a sound to this frame's queue, combining it with any other requests to
+	// play the same sound.
+	void Enqueue(const Sound *sound, const Point &position)
+	{
+		unsigned id = sound->ID();
+		if(id >= queue.size())
+			queue.resize(id + 1);
+		QueueEntry &entry = queue[id];
+		if(!entry.sound)
+		{
+			entry.sound = sound;
+			queued.push_back(id);
+		}
+		entry.Add(position);
+	}
+
+
 
-			// Unlock the mutex for the time-intensive part of the loop.
-			if(!sound->Load(path, name))
-				Logger::LogError("Unable to load sound \"" + name + "\" from path: " + path);
+	// The decoded sounds are only trimmed when no other thread is decoding, so
+	// this holds the lock while reading the file.
+	bool Decode(Sound &sound)
+	{
+		unique_lock<mutex> lock(decodeMutex);
+		if(sound.Buffer())
+			return true;
+		if(!sound.Decode())
+			return false;
+
+		decoded.push_back(&sound);
+		decodedBytes += sound.Bytes();
+		return true;
+	}
+
+
+
+	// Sounds are only ever queued through const pointers, so find the sound
+	// that can be decoded. This only happens the first time a sound is needed.
+	bool Decode(const Sound *sound)
+	{
+		if(sound->Buffer())
+			return true;
+
+		Sound *target = nullptr;
+		{
+			unique_lock<mutex> lock(audioMutex);
+			auto it = sounds.find(sound->Name());
+			if(it != sounds.end())
+				target = &it->second;
+		}
+		if(target && Decode(*target))
+			return true;
+
+		Logger::LogError("Unable to decode sound \"" + sound->Name() + "\".");
+		return false;
+	}
+
+
+
+	void TrimDecoded()
+	{
+		// Don't hold up the main thread while sounds are being loaded. They can
+		// be trimmed in a later step instead.
+		unique_lock<mutex> lock(decodeMutex, try_to_lock);
+		if(!lock.owns_lock())
+			return;
+
+		Profiler::SetCounter("Audio decoded sound MB", decodedBytes / 1048576.);
+		MemoryStats::SetBytes(MemoryStats::Category::SOUNDS, decodedBytes);
+		size_t budget = DecodedBudget();
+		if(decodedBytes <= budget)
+			return;
+
+		// Sounds that are still attached to a source can't be freed.
+		set<const Sound *> inUse;
+		for(const Source &source : sources)
+			inUse.insert(source.GetSound());
+		for(const Source &source : endingSources)
+			inUse.insert(source.GetSound());
+
+		// Consider the sounds that have gone unplayed the longest first. Sounds
+		// decoded ahead of time and never played yet come before all others.
+		stable_sort(decoded.begin(), decoded.end(), [](const Sound *a, const Sound *b) -> bool
+			{
+				return LastPlayed(a->ID()) < LastPlayed(b->ID());
+			});
+		auto it = decoded.begin();
+		while(it != decoded.end() && decodedBytes > budget)
+		{
+			if(inUse.count(*it))
+				++it;
+			else
+			{
+				decodedBytes -= (*it)->Bytes();
+				(*it)->Unload();
+				it = decoded.erase(it);
+			}
 		}
 	}
+
+
+
+	void MarkPlayed(unsigned id)
+	{
+		if(id >= lastPlayed.size())
+			lastPlayed.resize(id + 1);
+		lastPlayed[id] = stepCount;
+	}
+
+
+
+	uint64_t LastPlayed(unsigned id)
+	{
+		return id < lastPlayed.size() ? lastPlayed[id] : 0;
+	}
+
+
+
+	void Upload(Sound &sound, const vector<char> &samples, uint32_t frequency)
+	{
+		unique_lock<mutex> lock(decodeMutex);
+		if(sound.Buffer())
+			return;
+
+		sound.Upload(samples, frequency);
+		decoded.push_back(&sound);
+		decodedBytes += sound.Bytes();
+	}
+
+
+
+	bool HasRoom()
+	{
+		unique_lock<mutex> lock(decodeMutex);
+		return decodedBytes < DecodedBudget();
+	}
+
+
+
+	size_t DecodedBudget()
+	{
+		return static_cast<size_t>(Preferences::SoundBudget()) * 1048576;
+	}
 }
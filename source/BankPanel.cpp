@@ -65,6 +65,14 @@ void BankPanel::Step()
 
 
 
+// The bank statement only changes when the player pays something off.
+bool BankPanel::IsAnimated() const noexcept
+{
+	return false;
+}
+
+
+
 // Draw the bank information.
 void BankPanel::Draw()
 {
@@ -40,7 +40,10 @@ namespace {
 // Clear the list, also setting the global time step for animation.
 void BatchDrawList::Clear(int step, double zoom)
 {
-	data.clear();
+	// Keep each sprite's vector, so the memory it needed last frame can be reused.
+	// Sprites with nothing to draw are skipped by BatchShader::Add().
+	for(auto &it : data)
+		it.second.clear();
 	this->step = step;
 	this->zoom = zoom;
 	isHighDPI = (Screen::IsHighResolution() ? zoom > .5 : zoom > 1.);
@@ -94,22 +97,17 @@ void BatchDrawList::Draw() const
 
 
 
-bool BatchDrawList::Cull(const Body &body, const Point &position) const
+bool BatchDrawList::IsOffScreen(const Body &body, const Point &position, double zoom, double margin)
 {
-	if(!body.HasSprite() || !body.Zoom())
-		return true;
-
 	Point unit = body.Unit();
-	// Cull sprites that are completely off screen, to reduce the number of draw
-	// calls that we issue (which may be the bottleneck on some systems).
 	Point size(
 		fabs(unit.X() * body.Height()) + fabs(unit.Y() * body.Width()),
 		fabs(unit.X() * body.Width()) + fabs(unit.Y() * body.Height()));
 	Point topLeft = position - size * zoom;
 	Point bottomRight = position + size * zoom;
-	if(bottomRight.X() < Screen::Left() || bottomRight.Y() < Screen::Top())
+	if(bottomRight.X() + margin < Screen::Left() || bottomRight.Y() + margin < Screen::Top())
 		return true;
-	if(topLeft.X() > Screen::Right() || topLeft.Y() > Screen::Bottom())
+	if(topLeft.X() - margin > Screen::Right() || topLeft.Y() - margin > Screen::Bottom())
 		return true;
 
 	return false;
@@ -117,6 +115,18 @@ bool BatchDrawList::Cull(const Body &body, const Point &position) const
 
 
 
+bool BatchDrawList::Cull(const Body &body, const Point &position) const
+{
+	if(!body.HasSprite() || !body.Zoom())
+		return true;
+
+	// Cull sprites that are completely off screen, to reduce the number of draw
+	// calls that we issue (which may be the bottleneck on some systems).
+	return IsOffScreen(body, position, zoom);
+}
+
+
+
 bool BatchDrawList::Add(const Body &body, Point position, float clip)
 {
 	if(Cull(body, position))
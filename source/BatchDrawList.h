@@ -41,6 +41,11 @@ public:
 	// Draw all the items in this list.
 	void Draw() const;
 
+	// Check whether the given body is off screen when drawn at the given
+	// position, relative to the center of the screen and already zoomed. It
+	// counts as off screen only if it is more than the margin (in pixels) away.
+	static bool IsOffScreen(const Body &body, const Point &position, double zoom, double margin = 0.);
+
 
 private:
 	// Determine if the given body should be drawn at all.
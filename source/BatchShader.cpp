@@ -19,6 +19,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Shader.h"
 #include "Sprite.h"
 
+#include "opengl.h"
+
+#include <cstring>
+
 using namespace std;
 
 namespace {
@@ -26,12 +30,107 @@ namespace {
 	// Uniforms:
 	GLint scaleI;
 	GLint frameCountI;
+	GLint firstLayerI;
 	// Vertex data:
 	GLint vertI;
 	GLint texCoordI;
 
 	GLuint vao;
 	GLuint vbo;
+
+	// Rather than giving the buffer new storage for every sprite, the vertex
+	// data is streamed into one large buffer that is split into three regions.
+	// Each Bind() ... Unbind() writes into the next region, and a fence marks
+	// when the GPU is done reading it, so that it is never overwritten while a
+	// previous frame may still be drawing from it.
+	const int REGIONS = 3;
+	// The size of each region, in vertices. This grows if a frame needs more.
+	GLsizeiptr regionSize = 1 << 15;
+	const GLsizeiptr VERTEX_SIZE = 5 * sizeof(float);
+
+	bool useRing = false;
+	bool isPersistent = false;
+	// With persistent mapping, this is where the whole buffer is mapped.
+	char *mapped = nullptr;
+	GLsync fences[REGIONS] = {};
+	int region = 0;
+	// The next free vertex in the current region.
+	GLsizeiptr nextVertex = 0;
+
+
+
+	// Give the vertex buffer storage for all the regions. This must be called
+	// with the buffer bound.
+	void AllocateRing()
+	{
+		for(GLsync &fence : fences)
+			if(fence)
+			{
+				glDeleteSync(fence);
+				fence = nullptr;
+			}
+		region = 0;
+		nextVertex = 0;
+
+		GLsizeiptr bytes = REGIONS * regionSize * VERTEX_SIZE;
+#if !defined(__APPLE__) && !defined(ES_GLES)
+		if(isPersistent)
+		{
+			// Immutable storage cannot be resized, so a bigger ring needs a new buffer.
+			if(mapped)
+			{
+				glUnmapBuffer(GL_ARRAY_BUFFER);
+				glBindBuffer(GL_ARRAY_BUFFER, 0);
+				glDeleteBuffers(1, &vbo);
+				glGenBuffers(1, &vbo);
+				glBindBuffer(GL_ARRAY_BUFFER, vbo);
+				glVertexAttribPointer(vertI, 2, GL_FLOAT, GL_FALSE, VERTEX_SIZE, nullptr);
+				glVertexAttribPointer(texCoordI, 3, GL_FLOAT, GL_FALSE, VERTEX_SIZE,
+					reinterpret_cast<const GLvoid *>(2 * sizeof(float)));
+			}
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_ARRAY_BUFFER, bytes, nullptr, flags);
+			mapped = static_cast<char *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, bytes, flags));
+			return;
+		}
+#endif
+		glBufferData(GL_ARRAY_BUFFER, bytes, nullptr, GL_STREAM_DRAW);
+	}
+
+
+
+	// Copy vertices into the current region and return the index of the first one.
+	GLint Stream(const vector<float> &data)
+	{
+		GLsizeiptr count = data.size() / 5;
+		if(nextVertex + count > regionSize)
+		{
+			// Start over with a ring that is big enough. The draw calls already
+			// issued keep using the old storage until they are done with it.
+			while(regionSize < count)
+				regionSize *= 2;
+			regionSize *= 2;
+			AllocateRing();
+		}
+
+		GLsizeiptr offset = (region * regionSize + nextVertex) * VERTEX_SIZE;
+		GLsizeiptr bytes = count * VERTEX_SIZE;
+		if(isPersistent)
+			memcpy(mapped + offset, data.data(), bytes);
+		else
+		{
+			// The fence has already made sure the GPU is not using this range.
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+			void *pointer = glMapBufferRange(GL_ARRAY_BUFFER, offset, bytes, flags);
+			if(pointer)
+				memcpy(pointer, data.data(), bytes);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+		}
+
+		GLint first = region * regionSize + nextVertex;
+		nextVertex += count;
+		return first;
+	}
 }
 
 
@@ -60,6 +159,7 @@ void BatchShader::Init()
 #endif
 		"uniform sampler2DArray tex;\n"
 		"uniform float frameCount;\n"
+		"uniform float firstLayer;\n"
 
 		"in vec3 fragTexCoord;\n"
 
@@ -70,8 +170,8 @@ void BatchShader::Init()
 		"  float second = mod(ceil(fragTexCoord.z), frameCount);\n"
 		"  float fade = fragTexCoord.z - first;\n"
 		"  finalColor = mix(\n"
-		"    texture(tex, vec3(fragTexCoord.xy, first)),\n"
-		"    texture(tex, vec3(fragTexCoord.xy, second)), fade);\n"
+		"    texture(tex, vec3(fragTexCoord.xy, firstLayer + first)),\n"
+		"    texture(tex, vec3(fragTexCoord.xy, firstLayer + second)), fade);\n"
 		"}\n";
 
 	// Compile the shaders.
@@ -79,17 +179,18 @@ void BatchShader::Init()
 	// Get the indices of the uniforms and attributes.
 	scaleI = shader.Uniform("scale");
 	frameCountI = shader.Uniform("frameCount");
+	firstLayerI = shader.Uniform("firstLayer");
 	vertI = shader.Attrib("vert");
 	texCoordI = shader.Attrib("texCoord");
 
 	// Make sure we're using texture 0.
-	glUseProgram(shader.Object());
+	OpenGL::UseProgram(shader.Object());
 	glUniform1i(shader.Uniform("tex"), 0);
-	glUseProgram(0);
+	OpenGL::UseProgram(0);
 
 	// Generate the buffer for uploading the batch vertex data.
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -103,24 +204,40 @@ void BatchShader::Init()
 	glEnableVertexAttribArray(texCoordI);
 	glVertexAttribPointer(texCoordI, 3, GL_FLOAT, GL_FALSE, stride, textureOffset);
 
+	// Without fences there is no way to know when a region can be reused, so
+	// each batch gets new storage for its vertices instead.
+	useRing = OpenGL::HasFenceSupport();
+	isPersistent = useRing && OpenGL::HasBufferStorageSupport();
+	if(useRing)
+		AllocateRing();
+
 	// Unbind the buffer and the VAO, but leave the vertex attrib arrays enabled
 	// in the VAO so they will be used when it is bound.
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
 }
 
 
 
 void BatchShader::Bind()
 {
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindVertexArray(vao);
 	// Bind the vertex buffer so we can upload data to it.
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
 	// Set up the screen scale.
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
 	glUniform2fv(scaleI, 1, scale);
+
+	// Wait until the GPU is done with the last vertices written to this region.
+	// With three regions, that was two batches ago, so this rarely has to wait.
+	if(useRing && fences[region])
+	{
+		glClientWaitSync(fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+		glDeleteSync(fences[region]);
+		fences[region] = nullptr;
+	}
 }
 
 
@@ -132,23 +249,33 @@ void BatchShader::Add(const Sprite *sprite, bool isHighDPI, const vector<float>
 		return;
 
 	// First, bind the proper texture.
-	glBindTexture(GL_TEXTURE_2D_ARRAY, sprite->Texture(isHighDPI));
+	OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, sprite->Texture(isHighDPI));
 	// The shader also needs to know how many frames the texture has.
 	glUniform1f(frameCountI, sprite->Frames());
-
-	// Upload the vertex data.
-	glBufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_STREAM_DRAW);
-
-	// Draw all the vertices.
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, data.size() / 5);
+	glUniform1f(firstLayerI, sprite->FirstLayer(isHighDPI));
+
+	// Upload the vertex data, and draw all the vertices.
+	if(useRing)
+		glDrawArrays(GL_TRIANGLE_STRIP, Stream(data), data.size() / 5);
+	else
+	{
+		glBufferData(GL_ARRAY_BUFFER, sizeof(float) * data.size(), data.data(), GL_STREAM_DRAW);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, data.size() / 5);
+	}
 }
 
 
 
 void BatchShader::Unbind()
 {
+	// Mark when the GPU will be done with this region, and move on to the next.
+	if(useRing)
+	{
+		fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		region = (region + 1) % REGIONS;
+		nextVertex = 0;
+	}
+
 	// Unbind everything in reverse order.
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
-	glUseProgram(0);
 }
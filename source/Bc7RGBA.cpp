@@ -0,0 +1,186 @@
+/* Bc7RGBA.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Bc7RGBA.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace {
+	// For blocks with two subsets of pixels, which subset each pixel is in.
+	// Bit i is set if pixel i (counting across each row in turn) is in the
+	// second subset. Only mode 7 uses two subsets and also stores alpha.
+	const uint16_t PARTITIONS[64] = {
+		0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+		0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+		0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+		0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+		0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+		0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+		0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+		0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+	};
+	// The first pixel of each subset has one less bit in its index, because
+	// the encoder makes sure its high bit is zero. The first subset always
+	// starts with pixel 0; this is where the second subset starts.
+	const uint8_t ANCHORS[64] = {
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+		15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+		6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+	};
+
+	// Interpolation weights (out of 64) for 2, 3, and 4-bit indices.
+	const int WEIGHTS2[4] = {0, 21, 43, 64};
+	const int WEIGHTS3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+	const int WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+	class Block {
+	public:
+		explicit Block(const uint8_t *data)
+		{
+			// Blocks are stored little-endian, as is every platform we run on.
+			memcpy(&low, data, sizeof(low));
+			memcpy(&high, data + sizeof(low), sizeof(high));
+		}
+
+		// Get the given number of bits (at most 32), starting at the given bit.
+		uint32_t Bits(int start, int count) const
+		{
+			uint64_t value;
+			if(start >= 64)
+				value = high >> (start - 64);
+			else if(start + count <= 64)
+				value = low >> start;
+			else
+				value = (low >> start) | (high << (64 - start));
+			return static_cast<uint32_t>(value & ((uint64_t(1) << count) - 1));
+		}
+
+		// Get the index of the given pixel, from the indices that begin at the
+		// given bit. The given anchor is the first pixel of the second subset.
+		uint32_t Index(int start, int pixel, int bits, int anchor = 0) const
+		{
+			for(int i = 0; i < pixel; ++i)
+				start += bits - (!i || i == anchor);
+			return Bits(start, bits - (!pixel || pixel == anchor));
+		}
+
+	private:
+		uint64_t low;
+		uint64_t high;
+	};
+
+
+
+	// Expand an endpoint with the given number of bits to eight bits, by
+	// repeating its high bits in the low bits.
+	int Expand(uint32_t value, int bits)
+	{
+		value <<= 8 - bits;
+		return value | (value >> bits);
+	}
+
+
+
+	int Interpolate(int first, int second, uint32_t index, int bits)
+	{
+		const int *weights = (bits == 2 ? WEIGHTS2 : bits == 3 ? WEIGHTS3 : WEIGHTS4);
+		int weight = weights[index];
+		return ((64 - weight) * first + weight * second + 32) >> 6;
+	}
+
+
+
+	uint8_t DecodeAlpha(const Block &block, int pixel)
+	{
+		// The mode is given by the number of zeros before the first set bit.
+		int mode = 0;
+		while(mode < 8 && !block.Bits(mode, 1))
+			++mode;
+		// The reserved mode decodes to transparent black.
+		if(mode == 8)
+			return 0;
+		// Modes 0 through 3 store only color.
+		if(mode < 4)
+			return 255;
+
+		if(mode == 4 || mode == 5)
+		{
+			// These modes store color and alpha with separate indices, and the
+			// alpha may be swapped with one of the color channels.
+			const int rotation = block.Bits(mode + 1, 2);
+			const bool swapIndices = (mode == 4 && block.Bits(mode + 3, 1));
+			const int colorStart = 8;
+			const int colorBits = (mode == 4 ? 5 : 7);
+			const int alphaStart = colorStart + 6 * colorBits;
+			const int alphaBits = (mode == 4 ? 6 : 8);
+			// The first set of indices is always 2 bits. In mode 4, the second
+			// set is 3 bits, and which one is for alpha depends on the swap bit.
+			const int firstStart = alphaStart + 2 * alphaBits;
+			const int secondStart = firstStart + 31;
+			const int secondBits = (mode == 4 ? 3 : 2);
+			const bool alphaIsFirst = (mode == 4 && swapIndices);
+
+			// If the alpha is rotated into a color channel, what ends up in the
+			// alpha channel is that color channel, with the color indices.
+			const bool useColor = (rotation != 0);
+			const bool useFirst = (useColor != alphaIsFirst);
+			const uint32_t index = useFirst ? block.Index(firstStart, pixel, 2)
+				: block.Index(secondStart, pixel, secondBits);
+			const int indexBits = useFirst ? 2 : secondBits;
+
+			const int bits = useColor ? colorBits : alphaBits;
+			const int start = useColor ? colorStart + 2 * (rotation - 1) * colorBits : alphaStart;
+			return Interpolate(Expand(block.Bits(start, bits), bits),
+				Expand(block.Bits(start + bits, bits), bits), index, indexBits);
+		}
+		if(mode == 6)
+		{
+			// A single subset, with 7-bit RGBA endpoints that each have a
+			// separate low bit, and 4-bit indices.
+			const int first = (block.Bits(49, 7) << 1) | block.Bits(63, 1);
+			const int second = (block.Bits(56, 7) << 1) | block.Bits(64, 1);
+			return Interpolate(first, second, block.Index(65, pixel, 4), 4);
+		}
+
+		// Mode 7 has two subsets, with 5-bit RGBA endpoints that each have a
+		// separate low bit, and 2-bit indices.
+		const int partition = block.Bits(8, 6);
+		const int subset = (PARTITIONS[partition] >> pixel) & 1;
+		const int first = 2 * subset;
+		const int second = first + 1;
+		const uint32_t firstAlpha = (block.Bits(74 + 5 * first, 5) << 1) | block.Bits(94 + first, 1);
+		const uint32_t secondAlpha = (block.Bits(74 + 5 * second, 5) << 1) | block.Bits(94 + second, 1);
+		return Interpolate(Expand(firstAlpha, 6), Expand(secondAlpha, 6),
+			block.Index(98, pixel, 2, ANCHORS[partition]), 2);
+	}
+}
+
+
+
+Bc7RGBA::Bc7RGBA(const void *data, int width, int height)
+	: blockWidth((width + 3) / 4), blockHeight((height + 3) / 4), data(reinterpret_cast<const uint8_t *>(data))
+{
+}
+
+
+
+uint8_t Bc7RGBA::Alpha(int frame, int x, int y) const
+{
+	const uint8_t *block = data + 16 * (blockWidth * (blockHeight * frame + y / 4) + x / 4);
+	return DecodeAlpha(Block(block), 4 * (y & 3) + (x & 3));
+}
@@ -0,0 +1,42 @@
+/* Bc7RGBA.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BC7_RGBA_H_
+#define BC7_RGBA_H_
+
+#include <cstdint>
+
+
+
+// Reads the alpha channel of a BC7 (BPTC) compressed texture, for generating
+// collision masks. Like ETC2, BC7 stores each 4x4 block of pixels in 16 bytes,
+// but a block can use any of eight modes, and only some of them store alpha.
+class Bc7RGBA {
+public:
+	Bc7RGBA(const void *data, int width, int height);
+
+	// Get the alpha value of the given pixel of the given frame.
+	uint8_t Alpha(int frame, int x, int y) const;
+
+
+private:
+	const int blockWidth;
+	const int blockHeight;
+	const uint8_t *const data;
+};
+
+
+
+#endif
@@ -21,12 +21,42 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
+namespace {
+	// Count the set bits in the given block.
+	size_t PopCount(uint64_t block) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_popcountll(block);
+#else
+		size_t count = 0;
+		for( ; block; block &= block - 1)
+			++count;
+		return count;
+#endif
+	}
+
+
+
+	// Find the index of the lowest set bit in the given (nonzero) block.
+	size_t TrailingZeros(uint64_t block) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_ctzll(block);
+#else
+		size_t count = 0;
+		for( ; !(block & 1); block >>= 1)
+			++count;
+		return count;
+#endif
+	}
+}
+
 
 
 // Returns the number of bits this bitset can hold.
 size_t Bitset::Size() const noexcept
 {
-	return bits.size() * BITS_PER_BLOCK;
+	return blocks * BITS_PER_BLOCK;
 }
 
 
@@ -34,7 +64,7 @@ size_t Bitset::Size() const noexcept
 // Returns the number of bits this bitset has reserved.
 size_t Bitset::Capacity() const noexcept
 {
-	return bits.capacity() * BITS_PER_BLOCK;
+	return (blocks > INLINE_BLOCKS ? heapBits.capacity() : blocks) * BITS_PER_BLOCK;
 }
 
 
@@ -42,7 +72,24 @@ size_t Bitset::Capacity() const noexcept
 // Resizes the bitset to hold at least the specific amount of bits.
 void Bitset::Resize(size_t size)
 {
-	bits.resize(size / BITS_PER_BLOCK + 1);
+	const size_t count = size / BITS_PER_BLOCK + 1;
+	if(count <= INLINE_BLOCKS)
+	{
+		// If the bits were on the heap, bring the ones that are kept back inline.
+		if(blocks > INLINE_BLOCKS)
+		{
+			copy_n(heapBits.begin(), count, inlineBits);
+			heapBits.clear();
+		}
+		fill(inlineBits + count, inlineBits + INLINE_BLOCKS, uint64_t(0));
+	}
+	else
+	{
+		if(blocks <= INLINE_BLOCKS)
+			heapBits.assign(inlineBits, inlineBits + INLINE_BLOCKS);
+		heapBits.resize(count);
+	}
+	blocks = count;
 }
 
 
@@ -50,7 +97,9 @@ void Bitset::Resize(size_t size)
 // Clears the bitset. After this call this bitset is empty.
 void Bitset::Clear() noexcept
 {
-	bits.clear();
+	blocks = 0;
+	heapBits.clear();
+	fill(inlineBits, inlineBits + INLINE_BLOCKS, uint64_t(0));
 }
 
 
@@ -58,9 +107,11 @@ void Bitset::Clear() noexcept
 // Whether the given bitset has any bits that are also set in this bitset.
 bool Bitset::Intersects(const Bitset &other) const noexcept
 {
-	const auto size = min(bits.size(), other.bits.size());
+	const uint64_t *bits = Blocks();
+	const uint64_t *otherBits = other.Blocks();
+	const auto size = min(blocks, other.blocks);
 	for(size_t i = 0; i < size; ++i)
-		if(bits[i] & other.bits[i])
+		if(bits[i] & otherBits[i])
 			return true;
 	return false;
 }
@@ -72,7 +123,7 @@ bool Bitset::Test(size_t index) const noexcept
 {
 	const auto blockIndex = index / BITS_PER_BLOCK;
 	const auto pos = index % BITS_PER_BLOCK;
-	return bits[blockIndex] & (uint64_t(1) << pos);
+	return Blocks()[blockIndex] & (uint64_t(1) << pos);
 }
 
 
@@ -82,7 +133,17 @@ void Bitset::Set(size_t index) noexcept
 {
 	const auto blockIndex = index / BITS_PER_BLOCK;
 	const auto pos = index % BITS_PER_BLOCK;
-	bits[blockIndex] |= (uint64_t(1) << pos);
+	Blocks()[blockIndex] |= (uint64_t(1) << pos);
+}
+
+
+
+// Resets the bit at the specified index.
+void Bitset::Reset(size_t index) noexcept
+{
+	const auto blockIndex = index / BITS_PER_BLOCK;
+	const auto pos = index % BITS_PER_BLOCK;
+	Blocks()[blockIndex] &= ~(uint64_t(1) << pos);
 }
 
 
@@ -90,8 +151,8 @@ void Bitset::Set(size_t index) noexcept
 // Resets all bits in the bitset.
 void Bitset::Reset() noexcept
 {
-	for(auto &it : bits)
-		it = uint64_t(0);
+	uint64_t *bits = Blocks();
+	fill(bits, bits + blocks, uint64_t(0));
 }
 
 
@@ -99,8 +160,9 @@ void Bitset::Reset() noexcept
 // Whether any bits are set.
 bool Bitset::Any() const noexcept
 {
-	for(uint64_t block : bits)
-		if(block)
+	const uint64_t *bits = Blocks();
+	for(size_t i = 0; i < blocks; ++i)
+		if(bits[i])
 			return true;
 	return false;
 }
@@ -115,10 +177,94 @@ bool Bitset::None() const noexcept
 
 
 
+// Returns the number of bits that are set.
+size_t Bitset::Count() const noexcept
+{
+	const uint64_t *bits = Blocks();
+	size_t count = 0;
+	for(size_t i = 0; i < blocks; ++i)
+		count += PopCount(bits[i]);
+	return count;
+}
+
+
+
+// Returns the index of the first set bit at or after the given index.
+size_t Bitset::FindNext(size_t index) const noexcept
+{
+	if(index >= Size())
+		return Size();
+
+	const uint64_t *bits = Blocks();
+	size_t blockIndex = index / BITS_PER_BLOCK;
+	// Ignore the bits in the first block that come before the given index.
+	uint64_t block = bits[blockIndex] & (~uint64_t(0) << (index % BITS_PER_BLOCK));
+	while(!block)
+	{
+		if(++blockIndex == blocks)
+			return Size();
+		block = bits[blockIndex];
+	}
+	return blockIndex * BITS_PER_BLOCK + TrailingZeros(block);
+}
+
+
+
 // Fills the current bitset with the bits of other.
 void Bitset::UpdateWith(const Bitset &other)
 {
-	const auto size = min(bits.size(), other.bits.size());
+	const auto size = min(blocks, other.blocks);
+	copy_n(other.Blocks(), size, Blocks());
+}
+
+
+
+// Keep only the bits that are also set in other.
+void Bitset::IntersectWith(const Bitset &other) noexcept
+{
+	uint64_t *bits = Blocks();
+	const uint64_t *otherBits = other.Blocks();
+	const auto size = min(blocks, other.blocks);
+	for(size_t i = 0; i < size; ++i)
+		bits[i] &= otherBits[i];
+	// Nothing is set in other past its end.
+	fill(bits + size, bits + blocks, uint64_t(0));
+}
+
+
+
+// Set all the bits that are set in other.
+void Bitset::UnionWith(const Bitset &other) noexcept
+{
+	uint64_t *bits = Blocks();
+	const uint64_t *otherBits = other.Blocks();
+	const auto size = min(blocks, other.blocks);
 	for(size_t i = 0; i < size; ++i)
-		bits[i] = other.bits[i];
+		bits[i] |= otherBits[i];
+}
+
+
+
+// Reset all the bits that are set in other.
+void Bitset::Subtract(const Bitset &other) noexcept
+{
+	uint64_t *bits = Blocks();
+	const uint64_t *otherBits = other.Blocks();
+	const auto size = min(blocks, other.blocks);
+	for(size_t i = 0; i < size; ++i)
+		bits[i] &= ~otherBits[i];
+}
+
+
+
+uint64_t *Bitset::Blocks() noexcept
+{
+	return blocks > INLINE_BLOCKS ? heapBits.data() : inlineBits;
+}
+
+
+
+const uint64_t *Bitset::Blocks() const noexcept
+{
+	return blocks > INLINE_BLOCKS ? heapBits.data() : inlineBits;
 }
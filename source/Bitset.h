@@ -23,12 +23,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 
 
-// Class representing a bitset with a dynamic size.
+// Class representing a bitset with a dynamic size. Short bitsets, such as the
+// ones for a ship's weapons, are stored inline instead of on the heap.
 class Bitset {
 public:
 	// Returns the number of bits this bitset can hold.
 	size_t Size() const noexcept;
-	// Returns the number of bits this bitset has reserved.
+	// Returns the number of bits this bitset has reserved on the heap, or its
+	// size if its bits are stored inline.
 	size_t Capacity() const noexcept;
 
 	// Resizes the bitset to hold at least the specific amount of bits.
@@ -42,22 +44,48 @@ public:
 	bool Test(size_t index) const noexcept;
 	// Sets the bit at the specified index.
 	void Set(size_t index) noexcept;
+	// Resets the bit at the specified index.
+	void Reset(size_t index) noexcept;
 	// Resets all bits in the bitset.
 	void Reset() noexcept;
 	// Whether any bits are set.
 	bool Any() const noexcept;
 	// Whether no bits are set.
 	bool None() const noexcept;
+	// Returns the number of bits that are set.
+	size_t Count() const noexcept;
+	// Returns the index of the first set bit at or after the given index, or
+	// Size() if there is none. To visit every set bit:
+	// for(size_t i = bits.FindNext(0); i < bits.Size(); i = bits.FindNext(i + 1))
+	size_t FindNext(size_t index) const noexcept;
 
 	// Fills the current bitset with the bits of other.
 	void UpdateWith(const Bitset &other);
+	// Keep only the bits that are also set in other.
+	void IntersectWith(const Bitset &other) noexcept;
+	// Set all the bits that are set in other. Bits past the end of this bitset
+	// are ignored.
+	void UnionWith(const Bitset &other) noexcept;
+	// Reset all the bits that are set in other.
+	void Subtract(const Bitset &other) noexcept;
 
 
 private:
-	static constexpr size_t BITS_PER_BLOCK = std::numeric_limits<uint64_t>::digits;
+	uint64_t *Blocks() noexcept;
+	const uint64_t *Blocks() const noexcept;
+
 
-	// Stores the bits of the bitset.
-	std::vector<uint64_t> bits;
+private:
+	static constexpr size_t BITS_PER_BLOCK = std::numeric_limits<uint64_t>::digits;
+	// Up to this many blocks, the bits are stored inline.
+	static constexpr size_t INLINE_BLOCKS = 2;
+
+	// The number of blocks in this bitset.
+	size_t blocks = 0;
+	// Stores the bits of the bitset, in one or the other depending on its size.
+	// Any inline blocks beyond the size of the bitset are always zero.
+	uint64_t inlineBits[INLINE_BLOCKS] = {};
+	std::vector<uint64_t> heapBits;
 };
 
 
@@ -203,6 +203,7 @@ void Body::LoadSprite(const DataNode &node)
 	if(node.Size() < 2)
 		return;
 	sprite = SpriteSet::Get(node.Token(1));
+	cycleFrames = 0;
 
 	// The only time the animation does not start on a specific frame is if no
 	// start frame is specified and it repeats. Since a frame that does not
@@ -274,6 +275,7 @@ void Body::SetSprite(const Sprite *sprite)
 {
 	this->sprite = sprite;
 	currentStep = -1;
+	cycleFrames = 0;
 }
 
 
@@ -341,16 +343,23 @@ void Body::SetStep(int step) const
 	currentStep = step;
 
 	// If the sprite only has one frame, no need to animate anything.
-	float frames = sprite->Frames();
-	if(frames <= 1.f)
+	const int frameCount = sprite->Frames();
+	if(frameCount <= 1)
 	{
 		frame = 0.f;
 		return;
 	}
-	float lastFrame = frames - 1.f;
-	// This is the number of frames per full cycle. If rewinding, a full cycle
-	// includes the first and last frames once and every other frame twice.
-	float cycle = (rewind ? 2.f * lastFrame : frames) + delay;
+	// The sprite's frame count can change if it is loaded after this body
+	// first asks for a frame, so check it before reusing the cycle length.
+	if(frameCount != cycleFrames)
+	{
+		cycleFrames = frameCount;
+		lastFrame = frameCount - 1.f;
+		// This is the number of frames per full cycle. If rewinding, a full cycle
+		// includes the first and last frames once and every other frame twice.
+		cycle = (rewind ? 2.f * lastFrame : static_cast<float>(frameCount)) + delay;
+	}
+	const float frames = cycleFrames;
 
 	// If this is the very first step, fill in some values that we could not set
 	// until we knew the sprite's frame count and the starting step.
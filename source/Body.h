@@ -132,6 +132,16 @@ private:
 	// the same step over and over again.
 	mutable int currentStep = -1;
 	mutable float frame = 0.f;
+	// The cycle length only depends on the sprite's frame count and the
+	// animation parameters, so it is worked out once rather than every step.
+	// A frame count of zero means it has not been worked out yet.
+	mutable int cycleFrames = 0;
+	mutable float lastFrame = 0.f;
+	mutable float cycle = 0.f;
+
+	// Allow particles, which the sprite shader animates, to follow the same
+	// animation rules.
+	friend class Particle;
 };
 
 
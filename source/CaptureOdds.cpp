@@ -20,10 +20,42 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Ship.h"
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
 
 using namespace std;
 
+namespace {
+	// Tables with up to this many entries are solved right away, because that
+	// takes less time than a frame does.
+	const size_t SYNC_ENTRIES = 1 << 16;
+	// Until a larger table is solved, crew are counted in groups so the coarse
+	// table has at most this many rows and columns.
+	const unsigned COARSE_CREW = 64;
+	// How many solved tables to remember.
+	const size_t MAX_MEMOS = 16;
+
+	size_t Hash(const vector<double> &power)
+	{
+		size_t result = power.size();
+		for(double value : power)
+			result = result * 31 + hash<double>()(value);
+		return result;
+	}
+
+	// Sample the power table at the last crew member of each group.
+	vector<double> Sample(const vector<double> &power, unsigned stride)
+	{
+		vector<double> result;
+		for(size_t crew = stride; crew < power.size() + stride; crew += stride)
+			result.push_back(power[min(crew, power.size()) - 1]);
+		return result;
+	}
+}
+
 
 
 // Constructor.
@@ -31,7 +63,15 @@ CaptureOdds::CaptureOdds(const Ship &attacker, const Ship &defender)
 {
 	powerA = Power(attacker, false);
 	powerD = Power(defender, true);
-	Calculate();
+	solving = Solve(powerA, powerD);
+	if(solving.wait_for(chrono::seconds(0)) == future_status::ready)
+		exact = solving.get();
+	else
+	{
+		unsigned strideA = (powerA.size() + COARSE_CREW - 1) / COARSE_CREW;
+		unsigned strideD = (powerD.size() + COARSE_CREW - 1) / COARSE_CREW;
+		estimate = make_shared<Table>(Calculate(Sample(powerA, strideA), Sample(powerD, strideD), strideA, strideD));
+	}
 }
 
 
@@ -47,11 +87,12 @@ double CaptureOdds::Odds(int attackingCrew, int defendingCrew) const
 	// Make sure the input is within range, with the special constraint that the
 	// attacker can never succeed if they don't have two crew left (one to pilot
 	// each of the ships).
-	int index = Index(attackingCrew, defendingCrew);
+	const Table &table = Current();
+	int index = Index(table, attackingCrew, defendingCrew);
 	if(attackingCrew < 2 || index < 0)
 		return 0.;
 
-	return capture[index];
+	return table.capture[index];
 }
 
 
@@ -62,11 +103,12 @@ double CaptureOdds::AttackerCasualties(int attackingCrew, int defendingCrew) con
 {
 	// If the attacker has fewer than two crew, they cannot attack. If the
 	// defender has no crew, they cannot defend (so casualties will be zero).
-	int index = Index(attackingCrew, defendingCrew);
+	const Table &table = Current();
+	int index = Index(table, attackingCrew, defendingCrew);
 	if(attackingCrew < 2 || !defendingCrew || index < 0)
 		return 0.;
 
-	return casualtiesA[index];
+	return table.casualtiesA[index];
 }
 
 
@@ -77,11 +119,12 @@ double CaptureOdds::DefenderCasualties(int attackingCrew, int defendingCrew) con
 {
 	// If the attacker has fewer than two crew, they cannot attack. If the
 	// defender has no crew, they cannot defend (so casualties will be zero).
-	int index = Index(attackingCrew, defendingCrew);
+	const Table &table = Current();
+	int index = Index(table, attackingCrew, defendingCrew);
 	if(attackingCrew < 2 || !defendingCrew || index < 0)
 		return 0.;
 
-	return casualtiesD[index];
+	return table.casualtiesD[index];
 }
 
 
@@ -110,11 +153,48 @@ double CaptureOdds::DefenderPower(int defendingCrew) const
 
 
 
-// Generate the lookup tables.
-void CaptureOdds::Calculate()
+// Get the exact table if it has been solved, or the coarse one if not.
+const CaptureOdds::Table &CaptureOdds::Current() const
+{
+	if(!exact && solving.wait_for(chrono::seconds(0)) == future_status::ready)
+		exact = solving.get();
+	return exact ? *exact : *estimate;
+}
+
+
+
+// Map the given crew complements to an index in the given lookup table. There
+// is no row in the table for 0 crew on either ship.
+int CaptureOdds::Index(const Table &table, int attackingCrew, int defendingCrew) const
+{
+	if(static_cast<unsigned>(attackingCrew - 1) >= powerA.size())
+		return -1;
+	if(static_cast<unsigned>(defendingCrew - 1) >= powerD.size())
+		return -1;
+
+	return (attackingCrew - 1) / table.strideA * table.columns + (defendingCrew - 1) / table.strideD;
+}
+
+
+
+// Generate the lookup tables. Each entry of the power tables stands for the
+// given number of crew members, which are all lost together.
+CaptureOdds::Table CaptureOdds::Calculate(const vector<double> &powerA, const vector<double> &powerD,
+	unsigned strideA, unsigned strideD)
 {
+	Table table;
+	table.strideA = strideA;
+	table.strideD = strideD;
+	table.columns = powerD.size();
 	if(powerD.empty() || powerA.empty())
-		return;
+		return table;
+
+	vector<double> &capture = table.capture;
+	vector<double> &casualtiesA = table.casualtiesA;
+	vector<double> &casualtiesD = table.casualtiesD;
+	capture.reserve(powerA.size() * powerD.size());
+	casualtiesA.reserve(powerA.size() * powerD.size());
+	casualtiesD.reserve(powerA.size() * powerD.size());
 
 	// The first row represents the case where the attacker has only one crew left.
 	// In that case, the defending ship can never be successfully captured.
@@ -129,8 +209,8 @@ void CaptureOdds::Calculate()
 		// because 0 people is outside the end of the table.
 		double odds = ap / (ap + powerD[0]);
 		capture.push_back(odds + (1. - odds) * capture[up]);
-		casualtiesA.push_back((1. - odds) * (casualtiesA[up] + 1.));
-		casualtiesD.push_back(odds + (1. - odds) * casualtiesD[up]);
+		casualtiesA.push_back((1. - odds) * (casualtiesA[up] + strideA));
+		casualtiesD.push_back(odds * strideD + (1. - odds) * casualtiesD[up]);
 		++up;
 
 		// Loop through each number of crew the defender might have.
@@ -141,25 +221,59 @@ void CaptureOdds::Calculate()
 			// for the defender or the attacker depending on who wins.
 			odds = ap / (ap + powerD[d - 1]);
 			capture.push_back(odds * capture.back() + (1. - odds) * capture[up]);
-			casualtiesA.push_back(odds * casualtiesA.back() + (1. - odds) * (casualtiesA[up] + 1.));
-			casualtiesD.push_back(odds * (casualtiesD.back() + 1.) + (1. - odds) * casualtiesD[up]);
+			casualtiesA.push_back(odds * casualtiesA.back() + (1. - odds) * (casualtiesA[up] + strideA));
+			casualtiesD.push_back(odds * (casualtiesD.back() + strideD) + (1. - odds) * casualtiesD[up]);
 			++up;
 		}
 	}
+	return table;
 }
 
 
 
-// Map the given crew complements to an index in the lookup tables. There is no
-// row in the table for 0 crew on either ship.
-int CaptureOdds::Index(int attackingCrew, int defendingCrew) const
+// Get the exact table for the given power tables. Small tables are solved
+// right away, and larger ones on a worker thread.
+shared_future<shared_ptr<const CaptureOdds::Table>> CaptureOdds::Solve(const vector<double> &powerA,
+	const vector<double> &powerD)
 {
-	if(static_cast<unsigned>(attackingCrew - 1) > powerA.size())
-		return -1;
-	if(static_cast<unsigned>(defendingCrew - 1) > powerD.size())
-		return -1;
-
-	return (attackingCrew - 1) * powerD.size() + (defendingCrew - 1);
+	// Power tables that were already seen, and the tables solved for them. The
+	// hashes may collide, so the power tables are kept to compare as well.
+	struct Memo {
+		vector<double> powerA;
+		vector<double> powerD;
+		shared_future<shared_ptr<const Table>> table;
+	};
+	static mutex memoMutex;
+	static map<pair<size_t, size_t>, Memo> memos;
+
+	pair<size_t, size_t> key(Hash(powerA), Hash(powerD));
+	lock_guard<mutex> lock(memoMutex);
+	auto it = memos.find(key);
+	if(it != memos.end() && it->second.powerA == powerA && it->second.powerD == powerD)
+		return it->second.table;
+
+	shared_future<shared_ptr<const Table>> table;
+	if(powerA.size() * powerD.size() <= SYNC_ENTRIES)
+	{
+		promise<shared_ptr<const Table>> solved;
+		solved.set_value(make_shared<Table>(Calculate(powerA, powerD, 1, 1)));
+		table = solved.get_future().share();
+	}
+	else
+		table = async(launch::async, [powerA, powerD]() -> shared_ptr<const Table>
+			{
+				return make_shared<Table>(Calculate(powerA, powerD, 1, 1));
+			}).share();
+
+	// On a hash collision, keep the table that is already remembered.
+	if(it == memos.end())
+	{
+		// A table that is still in use stays alive after it is forgotten.
+		if(memos.size() >= MAX_MEMOS)
+			memos.clear();
+		memos.emplace(key, Memo{powerA, powerD, table});
+	}
+	return table;
 }
 
 
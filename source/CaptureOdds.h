@@ -16,6 +16,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef CAPTURE_ODDS_H_
 #define CAPTURE_ODDS_H_
 
+#include <future>
+#include <memory>
 #include <vector>
 
 class Ship;
@@ -30,6 +32,10 @@ class Ship;
 // combat, one ship will lose one crew member. Which ship loses depends on the
 // ratio of the strengths of the two crews (plus weapons), and whether each crew
 // is attacking or defending; defending crew get a +1 power bonus.
+// For large crews the full table is solved on a worker thread; until it is
+// ready, the odds come from a coarse table in which crew are lost in groups.
+// Solved tables are remembered, so boarding the same kind of ship again does
+// not need to solve the table a second time.
 class CaptureOdds {
 public:
 	// Calculate odds that the first given ship can capture the second, assuming
@@ -51,11 +57,34 @@ public:
 
 
 private:
-	// Generate the lookup table.
-	void Calculate();
-	// Map crew numbers into an index in the lookup table.
-	int Index(int attackingCrew, int defendingCrew) const;
+	// A lookup table of the capture odds and expected casualties. A coarse
+	// table has one row or column for each group of "stride" crew members.
+	class Table {
+	public:
+		unsigned strideA = 1;
+		unsigned strideD = 1;
+		unsigned columns = 0;
 
+		std::vector<double> capture;
+		std::vector<double> casualtiesA;
+		std::vector<double> casualtiesD;
+	};
+
+
+private:
+	// Get the exact table if it has been solved, or the coarse one if not.
+	const Table &Current() const;
+	// Map crew numbers into an index in the given lookup table.
+	int Index(const Table &table, int attackingCrew, int defendingCrew) const;
+
+	// Solve the lookup table for the given power tables, where each entry
+	// represents the given number of crew members.
+	static Table Calculate(const std::vector<double> &powerA, const std::vector<double> &powerD,
+		unsigned strideA, unsigned strideD);
+	// Get the exact table for the given power tables, either from the tables
+	// that were already solved or by starting to solve it.
+	static std::shared_future<std::shared_ptr<const Table>> Solve(const std::vector<double> &powerA,
+		const std::vector<double> &powerD);
 	// Calculate attack or defense power for each number of crew members up to
 	// the given ship's full complement.
 	static std::vector<double> Power(const Ship &ship, bool isDefender);
@@ -66,11 +95,12 @@ private:
 	std::vector<double> powerA;
 	std::vector<double> powerD;
 
-	// Capture odds lookup table.
-	std::vector<double> capture;
-	// Expected casualties lookup table.
-	std::vector<double> casualtiesA;
-	std::vector<double> casualtiesD;
+	// The capture odds and expected casualties, which may still be being
+	// solved. Once they are ready, the exact table is kept here.
+	std::shared_future<std::shared_ptr<const Table>> solving;
+	mutable std::shared_ptr<const Table> exact;
+	// The coarse table, used until the exact one is ready.
+	std::shared_ptr<const Table> estimate;
 };
 
 
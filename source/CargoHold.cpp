@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Mission.h"
 #include "Outfit.h"
 #include "System.h"
+#include "Trade.h"
 
 #include <algorithm>
 #include <cmath>
@@ -47,6 +48,92 @@ namespace {
 
 		return sortedOutfits;
 	}
+
+	// Find the index of the given commodity in GameData::Commodities(). If it is
+	// not a standard commodity, this returns the number of standard commodities.
+	size_t StandardIndex(const string &commodity)
+	{
+		const vector<Trade::Commodity> &standard = GameData::Commodities();
+		size_t index = 0;
+		while(index < standard.size() && standard[index].name != commodity)
+			++index;
+		return index;
+	}
+}
+
+
+
+CargoHold::CommodityList::iterator::iterator(const CargoHold &hold, size_t index,
+		map<string, int>::const_iterator it)
+	: hold(&hold), index(index), it(it)
+{
+	SkipEmpty();
+}
+
+
+
+pair<const string &, int> CargoHold::CommodityList::iterator::operator*() const
+{
+	if(index < hold->commodities.size())
+		return pair<const string &, int>(GameData::Commodities()[index].name, hold->commodities[index]);
+	return pair<const string &, int>(it->first, it->second);
+}
+
+
+
+CargoHold::CommodityList::iterator &CargoHold::CommodityList::iterator::operator++()
+{
+	if(index < hold->commodities.size())
+	{
+		++index;
+		SkipEmpty();
+	}
+	else
+		++it;
+	return *this;
+}
+
+
+
+bool CargoHold::CommodityList::iterator::operator==(const iterator &other) const
+{
+	return index == other.index && it == other.it;
+}
+
+
+
+bool CargoHold::CommodityList::iterator::operator!=(const iterator &other) const
+{
+	return !(*this == other);
+}
+
+
+
+void CargoHold::CommodityList::iterator::SkipEmpty()
+{
+	while(index < hold->commodities.size() && !hold->commodities[index])
+		++index;
+}
+
+
+
+CargoHold::CommodityList::CommodityList(const CargoHold &hold)
+	: hold(hold)
+{
+}
+
+
+
+CargoHold::CommodityList::iterator CargoHold::CommodityList::begin() const
+{
+	return iterator(hold, 0, hold.specialCommodities.begin());
+}
+
+
+
+CargoHold::CommodityList::iterator CargoHold::CommodityList::end() const
+{
+	return iterator(hold, hold.commodities.size(), hold.specialCommodities.end());
 }
 
 
@@ -57,6 +144,8 @@ void CargoHold::Clear()
 	size = 0;
 	bunks = 0;
 	commodities.clear();
+	specialCommodities.clear();
+	commodityTons = 0;
 	outfits.clear();
 	missionCargo.clear();
 	passengers.clear();
@@ -77,7 +166,8 @@ void CargoHold::Load(const DataNode &node)
 				if(grand.Size() >= 2)
 				{
 					int tons = grand.Value(1);
-					commodities[grand.Token(0)] += tons;
+					Tons(grand.Token(0)) += tons;
+					commodityTons += tons;
 				}
 		}
 		else if(child.Token(0) == "outfits")
@@ -97,8 +187,14 @@ void CargoHold::Load(const DataNode &node)
 // Save the cargo manifest to a file.
 void CargoHold::Save(DataWriter &out) const
 {
+	// Write the commodities in alphabetical order, whichever list they are in.
+	vector<pair<string, int>> sorted;
+	for(const auto &it : Commodities())
+		sorted.emplace_back(it.first, it.second);
+	sort(sorted.begin(), sorted.end());
+
 	bool first = true;
-	for(const auto &it : commodities)
+	for(const auto &it : sorted)
 		if(it.second)
 		{
 			// Only write a "cargo" block if it is not going to be empty.
@@ -204,10 +300,7 @@ double CargoHold::UsedPrecise() const
 // Get the total number of tons of commodities.
 int CargoHold::CommoditiesSize() const
 {
-	int size = 0;
-	for(const auto &it : commodities)
-		size += it.second;
-	return size;
+	return commodityTons;
 }
 
 
@@ -305,8 +398,19 @@ int CargoHold::Passengers() const
 // Normal cargo:
 int CargoHold::Get(const string &commodity) const
 {
-	map<string, int>::const_iterator it = commodities.find(commodity);
-	return (it == commodities.end() ? 0 : it->second);
+	size_t index = StandardIndex(commodity);
+	if(index < GameData::Commodities().size())
+		return GetCommodity(index);
+
+	map<string, int>::const_iterator it = specialCommodities.find(commodity);
+	return (it == specialCommodities.end() ? 0 : it->second);
+}
+
+
+
+int CargoHold::GetCommodity(size_t index) const
+{
+	return (index < commodities.size() ? commodities[index] : 0);
 }
 
 
@@ -338,10 +442,10 @@ int CargoHold::GetPassengers(const Mission *mission) const
 
 
 
-// Access the commodities map directly.
-const map<string, int> &CargoHold::Commodities() const
+// List the commodities in this cargo hold.
+CargoHold::CommodityList CargoHold::Commodities() const
 {
-	return commodities;
+	return CommodityList(*this);
 }
 
 
@@ -380,9 +484,28 @@ int CargoHold::Transfer(const string &commodity, int amount, CargoHold &to)
 	// them to the given cargo hold if possible. If not possible, add the
 	// remainder back to this cargo hold, even if there is not space for it.
 	// Do not invalidate existing iterators by modifying the container.
-	int removed = Remove(commodity, amount);
+	int &tons = Tons(commodity);
+	int removed = RemoveTons(tons, amount);
 	int added = to.Add(commodity, removed);
-	commodities[commodity] += removed - added;
+	tons += removed - added;
+	commodityTons += removed - added;
+
+	return added;
+}
+
+
+
+// Transfer a standard commodity from one cargo hold to another.
+int CargoHold::TransferCommodity(size_t index, int amount, CargoHold &to)
+{
+	if(!amount)
+		return 0;
+
+	int &tons = Tons(index);
+	int removed = RemoveTons(tons, amount);
+	int added = to.AddCommodity(index, removed);
+	tons += removed - added;
+	commodityTons += removed - added;
 
 	return added;
 }
@@ -479,7 +602,9 @@ void CargoHold::TransferAll(CargoHold &to, bool transferPassengers)
 	const vector<const Outfit *> outfitOrder = OrderOutfitsBySize(outfits);
 	for(const auto &outfit : outfitOrder)
 		Transfer(outfit, outfits[outfit], to);
-	for(const auto &it : commodities)
+	for(size_t i = 0; i < commodities.size(); ++i)
+		TransferCommodity(i, commodities[i], to);
+	for(const auto &it : specialCommodities)
 		Transfer(it.first, it.second, to);
 }
 
@@ -488,14 +613,14 @@ void CargoHold::TransferAll(CargoHold &to, bool transferPassengers)
 // Add the given amount of the given commodity.
 int CargoHold::Add(const string &commodity, int amount)
 {
-	if(amount < 0)
-		return -Remove(commodity, -amount);
+	return AddTons(Tons(commodity), amount);
+}
 
-	// If this cargo hold has a size limit, apply it.
-	if(size >= 0)
-		amount = max(0, min(amount, Free()));
-	commodities[commodity] += amount;
-	return amount;
+
+
+int CargoHold::AddCommodity(size_t index, int amount)
+{
+	return AddTons(Tons(index), amount);
 }
 
 
@@ -519,12 +644,14 @@ int CargoHold::Add(const Outfit *outfit, int amount)
 // Remove the given amount of the given commodity.
 int CargoHold::Remove(const string &commodity, int amount)
 {
-	if(amount < 0)
-		return Add(commodity, -amount);
+	return RemoveTons(Tons(commodity), amount);
+}
 
-	amount = min(amount, commodities[commodity]);
-	commodities[commodity] -= amount;
-	return amount;
+
+
+int CargoHold::RemoveCommodity(size_t index, int amount)
+{
+	return RemoveTons(Tons(index), amount);
 }
 
 
@@ -569,7 +696,10 @@ void CargoHold::RemoveMissionCargo(const Mission *mission)
 int64_t CargoHold::Value(const System *system) const
 {
 	int64_t value = 0;
-	for(const auto &it : commodities)
+	for(size_t i = 0; i < commodities.size(); ++i)
+		if(commodities[i])
+			value += static_cast<int64_t>(GameData::CommodityPrice(*system, i)) * commodities[i];
+	for(const auto &it : specialCommodities)
 		value += static_cast<int64_t>(system->Trade(it.first)) * it.second;
 	// For outfits, assume they're fully depreciated, since that will always be
 	// the case unless the player bought into cargo for some reason.
@@ -648,3 +778,50 @@ int CargoHold::IllegalCargoAmount() const
 
 	return count;
 }
+
+
+
+int &CargoHold::Tons(const string &commodity)
+{
+	size_t index = StandardIndex(commodity);
+	if(index < GameData::Commodities().size())
+		return Tons(index);
+	return specialCommodities[commodity];
+}
+
+
+
+int &CargoHold::Tons(size_t index)
+{
+	if(index >= commodities.size())
+		commodities.resize(max(index + 1, GameData::Commodities().size()));
+	return commodities[index];
+}
+
+
+
+int CargoHold::AddTons(int &tons, int amount)
+{
+	if(amount < 0)
+		return -RemoveTons(tons, -amount);
+
+	// If this cargo hold has a size limit, apply it.
+	if(size >= 0)
+		amount = max(0, min(amount, Free()));
+	tons += amount;
+	commodityTons += amount;
+	return amount;
+}
+
+
+
+int CargoHold::RemoveTons(int &tons, int amount)
+{
+	if(amount < 0)
+		return AddTons(tons, -amount);
+
+	amount = min(amount, tons);
+	tons -= amount;
+	commodityTons -= amount;
+	return amount;
+}
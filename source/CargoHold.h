@@ -16,9 +16,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef CARGO_HOLD_H_
 #define CARGO_HOLD_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -36,6 +39,44 @@ class System;
 // When you take off, cargo is distributed among your ships, and if some of it
 // will not fit it must be sold off.
 class CargoHold {
+public:
+	// A read-only view of the commodities in a cargo hold. It lists the standard
+	// commodities that are being carried in the order of GameData::Commodities(),
+	// followed by any special commodities in alphabetical order.
+	class CommodityList {
+	public:
+		class iterator {
+		public:
+			std::pair<const std::string &, int> operator*() const;
+			iterator &operator++();
+			bool operator==(const iterator &other) const;
+			bool operator!=(const iterator &other) const;
+
+		private:
+			friend class CommodityList;
+			iterator(const CargoHold &hold, size_t index, std::map<std::string, int>::const_iterator it);
+			// Skip over any standard commodities that are not being carried.
+			void SkipEmpty();
+
+		private:
+			const CargoHold *hold;
+			size_t index;
+			std::map<std::string, int>::const_iterator it;
+		};
+
+	public:
+		iterator begin() const;
+		iterator end() const;
+
+	private:
+		friend class CargoHold;
+		explicit CommodityList(const CargoHold &hold);
+
+	private:
+		const CargoHold &hold;
+	};
+
+
 public:
 	void Clear();
 
@@ -67,13 +108,15 @@ public:
 
 	// Normal cargo:
 	int Get(const std::string &commodity) const;
+	// Standard commodities, by their index in GameData::Commodities():
+	int GetCommodity(size_t index) const;
 	// Spare outfits:
 	int Get(const Outfit *outfit) const;
 	// Mission cargo:
 	int Get(const Mission *mission) const;
 	int GetPassengers(const Mission *mission) const;
 
-	const std::map<std::string, int> &Commodities() const;
+	CommodityList Commodities() const;
 	const std::map<const Outfit *, int> &Outfits() const;
 	// Note: some missions may have cargo that takes up 0 space, but should
 	// still show up on the cargo listing.
@@ -84,6 +127,7 @@ public:
 	// the commodity to "disappear" or, if the "amount" is negative, to have an
 	// unlimited supply. The return value is the actual number transferred.
 	int Transfer(const std::string &commodity, int amount, CargoHold &to);
+	int TransferCommodity(size_t index, int amount, CargoHold &to);
 	int Transfer(const Outfit *outfit, int amount, CargoHold &to);
 	int Transfer(const Mission *mission, int amount, CargoHold &to);
 	int TransferPassengers(const Mission *mission, int amount, CargoHold &to);
@@ -94,8 +138,10 @@ public:
 	// These functions do the same thing as Transfer() with no destination
 	// specified, but they have clearer names to make the code more readable.
 	int Add(const std::string &commodity, int amount = 1);
+	int AddCommodity(size_t index, int amount = 1);
 	int Add(const Outfit *outfit, int amount = 1);
 	int Remove(const std::string &commodity, int amount = 1);
+	int RemoveCommodity(size_t index, int amount = 1);
 	int Remove(const Outfit *outfit, int amount = 1);
 
 	// Add or remove any cargo or passengers associated with the given mission.
@@ -115,13 +161,25 @@ public:
 	int IllegalCargoAmount() const;
 
 
+private:
+	// Get the number of tons of the given commodity, creating an entry if needed.
+	int &Tons(const std::string &commodity);
+	int &Tons(size_t index);
+	int AddTons(int &tons, int amount);
+	int RemoveTons(int &tons, int amount);
+
+
 private:
 	// Use -1 to indicate unlimited capacity.
 	int size = -1;
 	int bunks = -1;
 
-	// Track how many objects of each type are being carried:
-	std::map<std::string, int> commodities;
+	// Track how many objects of each type are being carried. Standard commodities
+	// are indexed like GameData::Commodities(); any others are looked up by name.
+	std::vector<int> commodities;
+	std::map<std::string, int> specialCommodities;
+	// The total tons of every commodity, standard or special.
+	int commodityTons = 0;
 	std::map<const Outfit *, int> outfits;
 	std::map<const Mission *, int> missionCargo;
 	std::map<const Mission *, int> passengers;
@@ -29,6 +29,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <set>
 #include <string>
 
+#if defined(__SSE2__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 
 namespace {
@@ -38,6 +44,64 @@ namespace {
 	constexpr int USED_MAX_VELOCITY = MAX_VELOCITY - 1;
 	// Warn the user only once about too-large projectile velocities.
 	bool warned = false;
+	// The number of entries checked at once by a circle or ring query.
+	constexpr size_t LANES = 4;
+	// The packed positions are only used to rule out objects that are too far
+	// away; add some slack to each radius so that rounding them to floats
+	// never rules out an object that is actually in range.
+	constexpr float RADIUS_SLACK = 1.f;
+	// The most objects a leaf of the bounding volume hierarchy can hold.
+	constexpr unsigned LEAF_SIZE = 4;
+	// The deepest a bounding volume hierarchy can become. Splitting the items
+	// in half at each level means this is never reached in practice.
+	constexpr unsigned MAX_TREE_DEPTH = 64;
+	// The fewest rows and columns the grid may have.
+	constexpr unsigned MIN_CELLS = 4;
+	// The grid only shrinks once it has this many times more cells than
+	// entries, so that a set whose size changes a little from one step to the
+	// next keeps the same grid.
+	constexpr size_t SHRINK_RATIO = 16;
+
+
+	// Check which of the LANES objects starting at the given index could be
+	// touching the given ring. Bit i of the result is set if object i might be.
+	inline unsigned MayTouch(const float *x, const float *y, const float *r,
+		float centerX, float centerY, float inner, float outer)
+	{
+#if defined(__SSE2__)
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(x), _mm_set1_ps(centerX));
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(y), _mm_set1_ps(centerY));
+		const __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+		const __m128 radius = _mm_loadu_ps(r);
+		const __m128 far = _mm_add_ps(_mm_set1_ps(outer), radius);
+		const __m128 near = _mm_max_ps(_mm_sub_ps(_mm_set1_ps(inner), radius), _mm_setzero_ps());
+		const __m128 hit = _mm_and_ps(_mm_cmple_ps(d2, _mm_mul_ps(far, far)), _mm_cmpge_ps(d2, _mm_mul_ps(near, near)));
+		return _mm_movemask_ps(hit);
+#elif defined(__ARM_NEON)
+		const float32x4_t dx = vsubq_f32(vld1q_f32(x), vdupq_n_f32(centerX));
+		const float32x4_t dy = vsubq_f32(vld1q_f32(y), vdupq_n_f32(centerY));
+		const float32x4_t d2 = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+		const float32x4_t radius = vld1q_f32(r);
+		const float32x4_t far = vaddq_f32(vdupq_n_f32(outer), radius);
+		const float32x4_t near = vmaxq_f32(vsubq_f32(vdupq_n_f32(inner), radius), vdupq_n_f32(0.f));
+		const uint32x4_t hit = vandq_u32(vcleq_f32(d2, vmulq_f32(far, far)), vcgeq_f32(d2, vmulq_f32(near, near)));
+		return (vgetq_lane_u32(hit, 0) & 1u) | (vgetq_lane_u32(hit, 1) & 2u)
+			| (vgetq_lane_u32(hit, 2) & 4u) | (vgetq_lane_u32(hit, 3) & 8u);
+#else
+		unsigned hit = 0;
+		for(size_t i = 0; i < LANES; ++i)
+		{
+			const float dx = x[i] - centerX;
+			const float dy = y[i] - centerY;
+			const float d2 = dx * dx + dy * dy;
+			const float far = outer + r[i];
+			const float near = max(inner - r[i], 0.f);
+			if(d2 <= far * far && d2 >= near * near)
+				hit |= 1u << i;
+		}
+		return hit;
+#endif
+	}
 
 
 	// Keep track of the closest collision found so far. If an external "closest
@@ -66,6 +130,37 @@ namespace {
 		double closest_dist;
 		Body *closest_body;
 	};
+
+
+	// Check if the part of a line from "from" to "from + length * direction"
+	// passes through the given box.
+	bool Crosses(const Point &boxMin, const Point &boxMax, const Point &from, const Point &direction, double length)
+	{
+		double enter = 0.;
+		double exit = length;
+		const double start[2] = {from.X(), from.Y()};
+		const double step[2] = {direction.X(), direction.Y()};
+		const double low[2] = {boxMin.X(), boxMin.Y()};
+		const double high[2] = {boxMax.X(), boxMax.Y()};
+		for(int axis = 0; axis < 2; ++axis)
+		{
+			if(!step[axis])
+			{
+				if(start[axis] < low[axis] || start[axis] > high[axis])
+					return false;
+				continue;
+			}
+			double near = (low[axis] - start[axis]) / step[axis];
+			double far = (high[axis] - start[axis]) / step[axis];
+			if(near > far)
+				swap(near, far);
+			enter = max(enter, near);
+			exit = min(exit, far);
+			if(enter > exit)
+				return false;
+		}
+		return true;
+	}
 }
 
 
@@ -80,11 +175,14 @@ CollisionSet::CollisionSet(unsigned cellSize, unsigned cellCount)
 	CELL_SIZE = (1u << SHIFT);
 	CELL_MASK = CELL_SIZE - 1u;
 
-	// Number of grid rows and columns.
-	CELLS = 1u;
+	// The most grid rows and columns. The grid starts out small, and grows
+	// once objects are added to it.
+	MAX_CELLS = 1u;
 	while(cellCount >>= 1u)
-		CELLS <<= 1;
+		MAX_CELLS <<= 1;
+	CELLS = min(MIN_CELLS, MAX_CELLS);
 	WRAP_MASK = CELLS - 1u;
+	counts.resize(CELLS * CELLS + 2u, 0u);
 
 	// Just in case Clear() isn't called before objects are added:
 	Clear(0);
@@ -97,13 +195,17 @@ void CollisionSet::Clear(int step)
 {
 	this->step = step;
 
+	// Remember which entries are sorted, so that Finish() can tell which of
+	// them have moved to another cell.
+	if(isSorted)
+		previous.swap(added);
+	else
+		previous.clear();
+	isSorted = false;
 	added.clear();
-	sorted.clear();
-	counts.clear();
+	treeItems.clear();
+	tree.clear();
 	all.clear();
-	// The counts vector starts with two sentinel slots that will be used in the
-	// course of performing the radix sort.
-	counts.resize(CELLS * CELLS + 2u, 0u);
 }
 
 
@@ -124,8 +226,7 @@ void CollisionSet::Add(Body &body)
 		for(int x = minX; x <= maxX; ++x)
 		{
 			auto gx = x & WRAP_MASK;
-			added.emplace_back(&body, all.size(), x, y);
-			++counts[gy * CELLS + gx + 2];
+			added.emplace_back(&body, all.size(), added.size(), x, y, minX, minY);
 		}
 	}
 
@@ -138,28 +239,159 @@ void CollisionSet::Add(Body &body)
 // Finish adding objects (and organize them into the final lookup table).
 void CollisionSet::Finish()
 {
+	// Most objects stay in the same grid cell from one step to the next, so
+	// if the same objects were added, only the few that changed cells need to
+	// be moved. Otherwise, sort all of them again.
+	if(!Update())
+		Rebuild();
+	isSorted = true;
+
+	// Pack the position and radius of each entry, for circle and ring queries.
+	// The ring test uses the largest of the sprite and mask radii. Getting the
+	// mask also caches each object's animation frame for this step, so queries
+	// made after this only read from the objects.
+	sortedX.resize(sorted.size() + LANES - 1);
+	sortedY.resize(sorted.size() + LANES - 1);
+	sortedRadius.resize(sorted.size() + LANES - 1);
+	for(size_t i = 0; i < sorted.size(); ++i)
+	{
+		const Body &body = *sorted[i].body;
+		sortedX[i] = body.Position().X();
+		sortedY[i] = body.Position().Y();
+		sortedRadius[i] = max(body.Radius(), body.GetMask(step).Radius()) + RADIUS_SLACK;
+	}
+
+	// Initialize 'seen' with 0
+	seen.clear();
+	seen.resize(all.size());
+	seenEpoch = 0;
+}
+
+
+
+// Also organize the objects into a bounding volume hierarchy.
+void CollisionSet::BuildTree()
+{
+	treeItems.clear();
+	tree.clear();
+	if(all.empty())
+		return;
+
+	// Each object's box must contain its mask, just like its grid cells do.
+	for(Body *body : all)
+	{
+		const double radius = max(body->Radius(), body->GetMask(step).Radius());
+		const Point corner(radius, radius);
+		treeItems.push_back(TreeItem{body, body->Position() - corner, body->Position() + corner});
+	}
+	tree.reserve(2 * (all.size() / LEAF_SIZE + 1));
+	AddTreeNode(0, treeItems.size());
+}
+
+
+
+// Get the index of the grid cell that the given entry is in.
+unsigned CollisionSet::Cell(const Entry &entry) const
+{
+	return (entry.y & WRAP_MASK) * CELLS + (entry.x & WRAP_MASK);
+}
+
+
+
+// If the same objects were added as the last time, move the entries that are
+// now in a different cell, and return true. Otherwise, return false.
+bool CollisionSet::Update()
+{
+	if(added.size() != previous.size() || added.size() != sorted.size())
+		return false;
+
+	// Moving an entry to another bin takes one swap for each bin between the
+	// old one and the new one. If that adds up to more work than sorting all
+	// the entries again, just sort them.
+	const size_t limit = added.size() + CELLS * CELLS;
+	size_t cost = 0;
+	for(size_t i = 0; i < added.size(); ++i)
+	{
+		if(added[i].body != previous[i].body)
+			return false;
+		const unsigned from = Cell(previous[i]);
+		const unsigned to = Cell(added[i]);
+		cost += (from < to ? to - from : from - to);
+		if(cost > limit)
+			return false;
+	}
+
+	for(size_t i = 0; i < added.size(); ++i)
+	{
+		unsigned slot = slots[i];
+		unsigned from = Cell(previous[i]);
+		const unsigned to = Cell(added[i]);
+		// Move the entry to the end of its bin, then make that the start of the
+		// next bin, until it reaches its new bin. Moving it back works the same
+		// way, in the other direction.
+		for( ; from < to; ++from)
+		{
+			const unsigned last = --counts[from + 1];
+			Swap(slot, last);
+			slot = last;
+		}
+		for( ; from > to; --from)
+		{
+			const unsigned first = counts[from]++;
+			Swap(slot, first);
+			slot = first;
+		}
+		sorted[slot] = added[i];
+	}
+	return true;
+}
+
+
+
+// Sort all the entries into their cells, resizing the grid if needed.
+void CollisionSet::Rebuild()
+{
+	// Use about one grid cell per entry, so that a cell rarely holds objects
+	// from elsewhere that wrapped around into it, but summing the cells costs
+	// no more than sorting the entries does.
+	while(CELLS < MAX_CELLS && CELLS * CELLS < added.size())
+		CELLS <<= 1;
+	while(CELLS > MIN_CELLS && CELLS * CELLS > SHRINK_RATIO * added.size())
+		CELLS >>= 1;
+	WRAP_MASK = CELLS - 1u;
+
+	// The counts vector starts with two sentinel slots that will be used in the
+	// course of performing the radix sort.
+	counts.assign(CELLS * CELLS + 2u, 0u);
+	for(const Entry &entry : added)
+		++counts[Cell(entry) + 2];
+
 	// Perform a partial sum to convert the counts of items in each bin into the
 	// index of the output element where that bin begins.
 	partial_sum(counts.begin(), counts.end(), counts.begin());
 
 	// Allocate space for a sorted copy of the vector.
 	sorted.resize(added.size());
+	slots.resize(added.size());
 
 	// Now, perform a radix sort.
 	for(const Entry &entry : added)
 	{
-		auto gx = entry.x & WRAP_MASK;
-		auto gy = entry.y & WRAP_MASK;
-		auto index = gy * CELLS + gx + 1;
-
-		sorted[counts[index]++] = entry;
+		const unsigned slot = counts[Cell(entry) + 1]++;
+		sorted[slot] = entry;
+		slots[entry.index] = slot;
 	}
 	// Now, counts[index] is where a certain bin begins.
+}
 
-	// Initialize 'seen' with 0
-	seen.clear();
-	seen.resize(all.size());
-	seenEpoch = 0;
+
+
+// Swap two of the sorted entries.
+void CollisionSet::Swap(unsigned first, unsigned second)
+{
+	swap(sorted[first], sorted[second]);
+	slots[sorted[first].index] = first;
+	slots[sorted[second].index] = second;
 }
 
 
@@ -184,6 +416,9 @@ Body *CollisionSet::Line(const Projectile &projectile, double *closestHit) const
 Body *CollisionSet::Line(const Point &from, const Point &to, double *closestHit,
 		const Government *pGov, const Body *target) const
 {
+	if(!tree.empty())
+		return TreeLine(from, to, closestHit, pGov, target);
+
 	const int x = from.X();
 	const int y = from.Y();
 	const int endX = to.X();
@@ -342,6 +577,102 @@ Body *CollisionSet::Line(const Point &from, const Point &to, double *closestHit,
 
 
 
+// Check for collisions with a line using the bounding volume hierarchy.
+Body *CollisionSet::TreeLine(const Point &from, const Point &to, double *closestHit,
+		const Government *pGov, const Body *target) const
+{
+	Closest closer_result(closestHit ? *closestHit : 1.);
+	const Point direction = to - from;
+
+	unsigned stack[MAX_TREE_DEPTH];
+	unsigned depth = 0;
+	stack[depth++] = 0;
+	while(depth)
+	{
+		const unsigned index = stack[--depth];
+		const TreeNode &node = tree[index];
+		// Nothing farther along the line than the closest hit so far matters.
+		if(!Crosses(node.min, node.max, from, direction, closer_result.GetClosestDistance()))
+			continue;
+
+		if(!node.count)
+		{
+			stack[depth++] = node.index;
+			stack[depth++] = index + 1;
+			continue;
+		}
+
+		for(unsigned i = node.index; i < node.index + node.count; ++i)
+		{
+			const TreeItem &item = treeItems[i];
+			if(!Crosses(item.min, item.max, from, direction, closer_result.GetClosestDistance()))
+				continue;
+
+			// Check if this projectile can hit this object. If either the
+			// projectile or the object has no government, it will always hit.
+			const Government *iGov = item.body->GetGovernment();
+			if(item.body != target && iGov && pGov && !iGov->IsEnemy(pGov))
+				continue;
+
+			const Mask &mask = item.body->GetMask(step);
+			Point offset = from - item.body->Position();
+			const double range = mask.Collide(offset, direction, item.body->Facing());
+
+			closer_result.TryNearer(range, item.body);
+		}
+	}
+
+	if(closer_result.GetClosestDistance() < 1. && closestHit)
+		*closestHit = closer_result.GetClosestDistance();
+
+	return closer_result.GetClosestBody();
+}
+
+
+
+// Add the node for the given range of tree items, and return its index.
+unsigned CollisionSet::AddTreeNode(unsigned begin, unsigned end)
+{
+	const unsigned index = tree.size();
+	tree.emplace_back();
+	Point low = treeItems[begin].min;
+	Point high = treeItems[begin].max;
+	for(unsigned i = begin + 1; i < end; ++i)
+	{
+		low = min(low, treeItems[i].min);
+		high = max(high, treeItems[i].max);
+	}
+	tree[index].min = low;
+	tree[index].max = high;
+
+	if(end - begin <= LEAF_SIZE)
+	{
+		tree[index].index = begin;
+		tree[index].count = end - begin;
+		return index;
+	}
+
+	// Split the items in half along the longest side of this node's box.
+	const Point size = high - low;
+	const bool alongX = (size.X() >= size.Y());
+	const unsigned middle = begin + (end - begin) / 2;
+	nth_element(treeItems.begin() + begin, treeItems.begin() + middle, treeItems.begin() + end,
+		[alongX](const TreeItem &a, const TreeItem &b) -> bool
+		{
+			return alongX ? a.min.X() + a.max.X() < b.min.X() + b.max.X()
+				: a.min.Y() + a.max.Y() < b.min.Y() + b.max.Y();
+		});
+
+	AddTreeNode(begin, middle);
+	const unsigned second = AddTreeNode(middle, end);
+	// The vector may have been reallocated while adding the children.
+	tree[index].index = second;
+	tree[index].count = 0;
+	return index;
+}
+
+
+
 // Get all objects within the given range of the given point.
 const vector<Body *> &CollisionSet::Circle(const Point &center, double radius) const
 {
@@ -353,6 +684,25 @@ const vector<Body *> &CollisionSet::Circle(const Point &center, double radius) c
 // Get all objects touching a ring with a given inner and outer range
 // centered at the given point.
 const vector<Body *> &CollisionSet::Ring(const Point &center, double inner, double outer) const
+{
+	Ring(center, inner, outer, result);
+	return result;
+}
+
+
+
+// Get all objects within the given range of the given point, storing them in
+// the given vector.
+void CollisionSet::Circle(const Point &center, double radius, vector<Body *> &result) const
+{
+	Ring(center, 0., radius, result);
+}
+
+
+
+// Get all objects touching a ring with a given inner and outer range centered
+// at the given point, storing them in the given vector.
+void CollisionSet::Ring(const Point &center, double inner, double outer, vector<Body *> &result) const
 {
 	// Calculate the range of (x, y) grid coordinates this ring covers.
 	const int minX = static_cast<int>(center.X() - outer) >> SHIFT;
@@ -360,7 +710,10 @@ const vector<Body *> &CollisionSet::Ring(const Point &center, double inner, doub
 	const int maxX = static_cast<int>(center.X() + outer) >> SHIFT;
 	const int maxY = static_cast<int>(center.Y() + outer) >> SHIFT;
 
-	++seenEpoch;
+	const float centerX = center.X();
+	const float centerY = center.Y();
+	const float innerRange = inner;
+	const float outerRange = outer;
 
 	result.clear();
 	for(int y = minY; y <= maxY; ++y)
@@ -370,30 +723,53 @@ const vector<Body *> &CollisionSet::Ring(const Point &center, double inner, doub
 		{
 			const auto gx = x & WRAP_MASK;
 			const auto index = gy * CELLS + gx;
-			vector<Entry>::const_iterator it = sorted.begin() + counts[index];
-			vector<Entry>::const_iterator end = sorted.begin() + counts[index + 1];
+			const unsigned begin = counts[index];
+			const unsigned end = counts[index + 1];
 
-			for( ; it != end; ++it)
+			for(unsigned i = begin; i < end; i += LANES)
 			{
-				// Skip objects that were put in this same grid cell only because
-				// of the cell coordinates wrapping around.
-				if(it->x != x || it->y != y)
-					continue;
-
-				if(seen[it->seenIndex] == seenEpoch)
-					continue;
-				seen[it->seenIndex] = seenEpoch;
-
-				const Mask &mask = it->body->GetMask(step);
-				Point offset = center - it->body->Position();
-				const double length = offset.Length();
-				if((length <= outer && length >= inner)
-					|| mask.WithinRing(offset, it->body->Facing(), inner, outer))
-					result.push_back(it->body);
+				// Rule out the objects that are too far away, several at a time.
+				unsigned hit = MayTouch(&sortedX[i], &sortedY[i], &sortedRadius[i],
+					centerX, centerY, innerRange, outerRange);
+				if(end - i < LANES)
+					hit &= (1u << (end - i)) - 1u;
+
+				for(unsigned lane = 0; hit; ++lane, hit >>= 1)
+				{
+					if(!(hit & 1u))
+						continue;
+
+					// Skip objects that were put in this same grid cell only
+					// because of the cell coordinates wrapping around.
+					const Entry &entry = sorted[i + lane];
+					if(entry.x != x || entry.y != y)
+						continue;
+
+					// An object that covers several of the cells in this query
+					// should only be checked in the first one of them.
+					if(x != max(entry.minX, minX) || y != max(entry.minY, minY))
+						continue;
+
+					const Mask &mask = entry.body->GetMask(step);
+					Point offset = center - entry.body->Position();
+					const double length = offset.Length();
+					if((length <= outer && length >= inner)
+						|| mask.WithinRing(offset, entry.body->Facing(), inner, outer))
+						result.push_back(entry.body);
+				}
 			}
 		}
 	}
-	return result;
+}
+
+
+
+// Get all objects within the given range of each of the given points.
+void CollisionSet::Circles(const vector<Point> &centers, double radius, vector<vector<Body *>> &results) const
+{
+	results.resize(centers.size());
+	for(size_t i = 0; i < centers.size(); ++i)
+		Ring(centers[i], 0., radius, results[i]);
 }
 
 
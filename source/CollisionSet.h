@@ -16,10 +16,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef COLLISION_SET_H_
 #define COLLISION_SET_H_
 
+#include "Point.h"
+
 #include <vector>
 
 class Government;
-class Point;
 class Projectile;
 class Body;
 
@@ -27,11 +28,15 @@ class Body;
 
 // A CollisionSet allows efficient collision detection by splitting space up
 // into a grid and keeping track of which objects are in each grid cell. A check
-// for collisions can then only examine objects in certain cells.
+// for collisions can then only examine objects in certain cells. The grid wraps
+// around, and has about as many cells as there are objects in it. If the same
+// objects are added as on the previous step, only the ones that moved to
+// another cell are moved in the lookup table.
 class CollisionSet {
 public:
 	// Initialize a collision set. The cell size and cell count should both be
-	// powers of two; otherwise, they are rounded down to a power of two.
+	// powers of two; otherwise, they are rounded down to a power of two. The
+	// cell count is the most rows and columns the grid may have.
 	CollisionSet(unsigned cellSize, unsigned cellCount);
 
 	// Clear all objects in the set. Specify which engine step we are on, so we
@@ -41,6 +46,11 @@ public:
 	void Add(Body &body);
 	// Finish adding objects (and organize them into the final lookup table).
 	void Finish();
+	// Also organize the objects into a bounding volume hierarchy. Line queries
+	// made after this use the hierarchy instead of the grid, which is faster
+	// when a large number of lines must be checked. They also no longer modify
+	// the collision set, so they can be made from any number of threads at once.
+	void BuildTree();
 
 	// Get the first object that collides with the given projectile. If a
 	// "closest hit" value is given, update that value.
@@ -55,6 +65,14 @@ public:
 	// Get all objects touching a ring with a given inner and outer range
 	// centered at the given point.
 	const std::vector<Body *> &Ring(const Point &center, double inner, double outer) const;
+	// Versions of the above that store the objects found in the given vector
+	// instead. These do not modify the collision set, so they can be called
+	// from any number of threads at once.
+	void Circle(const Point &center, double radius, std::vector<Body *> &result) const;
+	void Ring(const Point &center, double inner, double outer, std::vector<Body *> &result) const;
+	// Get all objects within the given range of each of the given points. The
+	// objects near centers[i] are stored in results[i].
+	void Circles(const std::vector<Point> &centers, double radius, std::vector<std::vector<Body *>> &results) const;
 
 	// Get all objects within this collision set.
 	const std::vector<Body *> &All() const;
@@ -64,24 +82,71 @@ private:
 	class Entry {
 	public:
 		Entry() = default;
-		Entry(Body *body, unsigned seenIndex, int x, int y) : body(body), seenIndex(seenIndex), x(x), y(y) {}
+		Entry(Body *body, unsigned seenIndex, unsigned index, int x, int y, int minX, int minY)
+			: body(body), seenIndex(seenIndex), index(index), x(x), y(y), minX(minX), minY(minY) {}
 
 		Body *body;
 		unsigned seenIndex;
+		// The order in which this entry was added.
+		unsigned index;
+		// The grid cell this entry is in.
 		int x;
 		int y;
+		// The first grid cell the object occupies, in each direction.
+		int minX;
+		int minY;
 	};
 
 
+	// An object in the bounding volume hierarchy, and the box that contains it.
+	class TreeItem {
+	public:
+		Body *body;
+		Point min;
+		Point max;
+	};
+
+	// A node of the bounding volume hierarchy. The first child of a branch is
+	// always the node that comes right after it.
+	class TreeNode {
+	public:
+		Point min;
+		Point max;
+		// For a leaf, the first of its items. For a branch, its second child.
+		unsigned index;
+		// The number of items in a leaf, or zero for a branch.
+		unsigned count;
+	};
+
+
+private:
+	// Get the index of the grid cell that the given entry is in.
+	unsigned Cell(const Entry &entry) const;
+	// If the same objects were added as the last time, move the entries that
+	// are now in a different cell, and return true. Otherwise, return false.
+	bool Update();
+	// Sort all the entries into their cells, resizing the grid if needed.
+	void Rebuild();
+	// Swap two of the sorted entries.
+	void Swap(unsigned first, unsigned second);
+
+	// Check for collisions with a line using the bounding volume hierarchy.
+	Body *TreeLine(const Point &from, const Point &to, double *closestHit,
+		const Government *pGov, const Body *target) const;
+	// Add the node for the given range of tree items, and return its index.
+	unsigned AddTreeNode(unsigned begin, unsigned end);
+
+
 private:
 	// The size of individual cells of the grid.
 	unsigned CELL_SIZE;
 	unsigned SHIFT;
 	unsigned CELL_MASK;
 
-	// The number of grid cells.
+	// The number of grid cells in each direction, and the most there may be.
 	unsigned CELLS;
 	unsigned WRAP_MASK;
+	unsigned MAX_CELLS;
 
 	// The current game engine step.
 	int step;
@@ -90,13 +155,29 @@ private:
 	std::vector<Body *> all;
 	std::vector<Entry> added;
 	std::vector<Entry> sorted;
-	// After Finish(), counts[index] is where a certain bin begins.
+	// The entries that were added before the last Clear(), if they were sorted,
+	// and where each of them is in the sorted entries.
+	std::vector<Entry> previous;
+	std::vector<unsigned> slots;
+	bool isSorted = false;
+	// A copy of the position and radius of the object in each sorted entry,
+	// packed so that several entries can be checked at once. These vectors are
+	// padded so that a group of entries can start at any sorted index.
+	std::vector<float> sortedX;
+	std::vector<float> sortedY;
+	std::vector<float> sortedRadius;
+	// After Finish(), counts[index] is where a certain bin begins. This is kept
+	// from one Finish() to the next, so that entries can be moved between bins.
 	std::vector<unsigned> counts;
 
+	// The bounding volume hierarchy, if one has been built since the last Clear().
+	std::vector<TreeItem> treeItems;
+	std::vector<TreeNode> tree;
+
 	// Vector for returning the result of a circle query.
 	mutable std::vector<Body *> result;
 
-	// Keep track of which objects we've already considered
+	// Keep track of which objects we've already considered in Line().
 	mutable std::vector<unsigned> seen;
 	mutable unsigned seenEpoch = 0;
 };
@@ -26,6 +26,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <atomic>
 #include <cmath>
+#include <cstring>
 #include <map>
 
 using namespace std;
@@ -664,6 +665,22 @@ double Command::Turn() const
 
 
 
+uint64_t Command::Bits() const
+{
+	return state;
+}
+
+
+
+Command Command::FromBits(uint64_t bits, double turn)
+{
+	Command command(bits);
+	command.turn = turn;
+	return command;
+}
+
+
+
 // Check if any bits are set in this command (including a nonzero turn).
 Command::operator bool() const
 {
@@ -710,6 +727,36 @@ Command &Command::operator|=(const Command &command)
 
 
 
+Command::Buffer::Buffer()
+	: state(0), turn(0)
+{
+}
+
+
+
+void Command::Buffer::Add(const Command &command)
+{
+	state.fetch_or(command.state, memory_order_release);
+	if(command.turn)
+	{
+		uint64_t bits;
+		memcpy(&bits, &command.turn, sizeof(bits));
+		turn.store(bits, memory_order_release);
+	}
+}
+
+
+
+Command Command::Buffer::Take()
+{
+	Command command(state.exchange(0, memory_order_acquire));
+	uint64_t bits = turn.exchange(0, memory_order_acquire);
+	memcpy(&command.turn, &bits, sizeof(bits));
+	return command;
+}
+
+
+
 // Private constructor.
 Command::Command(uint64_t state)
 	: state(state)
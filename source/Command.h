@@ -142,6 +142,11 @@ public:
 	void SetTurn(double amount);
 	double Turn() const;
 
+	// Get the bits of the commands that are set, or make a command from them,
+	// e.g. to store the player's commands in a compact recording.
+	uint64_t Bits() const;
+	static Command FromBits(uint64_t bits, double turn = 0.);
+
 	// Check if any bits are set in this command (including a nonzero turn).
 	explicit operator bool() const;
 	bool operator!() const;
@@ -166,6 +171,25 @@ public:
 
 	static void DebugDumpGestures();
 
+public:
+	// Commands that one thread adds to while another takes them, without either
+	// one waiting for the other. Everything added before the commands are taken
+	// is combined as with operator|=, so no key press is lost.
+	class Buffer {
+	public:
+		Buffer();
+
+		// Combine the given commands with any that have not been taken yet.
+		void Add(const Command &command);
+		// Take every command added since they were last taken.
+		Command Take();
+
+	private:
+		std::atomic<uint64_t> state;
+		// The bits of the turn amount, so that it can be swapped atomically.
+		std::atomic<uint64_t> turn;
+	};
+
 private:
 	explicit Command(uint64_t state);
 	Command(uint64_t state, const std::string &text, const std::string &icon = "");
@@ -0,0 +1,96 @@
+/* Compression.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Compression.h"
+
+#include "Logger.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+namespace {
+	// Adding this to the window size makes zlib use the gzip format, which has
+	// a header that compressed data can be recognized by.
+	const int GZIP_FORMAT = 16;
+	// Decompress the data in pieces of this size.
+	const size_t CHUNK_SIZE = 1 << 16;
+}
+
+
+
+bool Compression::IsCompressed(const string &data)
+{
+	return data.size() >= 2 && static_cast<unsigned char>(data[0]) == 0x1f
+		&& static_cast<unsigned char>(data[1]) == 0x8b;
+}
+
+
+
+string Compression::Compress(const string &data)
+{
+	if(data.size() > UINT_MAX)
+		return data;
+
+	z_stream stream = {};
+	if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + GZIP_FORMAT, 8, Z_DEFAULT_STRATEGY)
+			!= Z_OK)
+		return data;
+
+	string result(deflateBound(&stream, data.size()), '\0');
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+	stream.avail_in = data.size();
+	stream.next_out = reinterpret_cast<Bytef *>(&result[0]);
+	stream.avail_out = result.size();
+	int status = deflate(&stream, Z_FINISH);
+	result.resize(stream.total_out);
+	deflateEnd(&stream);
+
+	return (status == Z_STREAM_END) ? result : data;
+}
+
+
+
+string Compression::Decompress(const string &data)
+{
+	string result;
+	z_stream stream = {};
+	if(inflateInit2(&stream, MAX_WBITS + GZIP_FORMAT) != Z_OK)
+	{
+		Logger::LogError("Unable to decompress data.");
+		return result;
+	}
+
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+	stream.avail_in = min<size_t>(data.size(), UINT_MAX);
+	int status = Z_OK;
+	while(status == Z_OK)
+	{
+		size_t size = result.size();
+		result.resize(size + CHUNK_SIZE);
+		stream.next_out = reinterpret_cast<Bytef *>(&result[size]);
+		stream.avail_out = CHUNK_SIZE;
+		status = inflate(&stream, Z_NO_FLUSH);
+		result.resize(size + CHUNK_SIZE - stream.avail_out);
+	}
+	inflateEnd(&stream);
+
+	if(status != Z_STREAM_END)
+		Logger::LogError("Compressed data is corrupt or incomplete.");
+	return result;
+}
@@ -0,0 +1,40 @@
+/* Compression.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef COMPRESSION_H_
+#define COMPRESSION_H_
+
+#include <string>
+
+
+
+// Saved games can be written compressed (in the gzip format), which makes them
+// much smaller and quicker to write out. Compressed data is recognized by the
+// bytes it starts with, so a compressed file and a plain text one can be read
+// the same way, and either can be used wherever the other is.
+class Compression {
+public:
+	// Check if the given data is compressed.
+	static bool IsCompressed(const std::string &data);
+	// Compress the given data. If that fails, it is returned as it is.
+	static std::string Compress(const std::string &data);
+	// Decompress the given data. If it is corrupt, whatever could be decompressed
+	// before the corruption is returned, and an error is logged.
+	static std::string Decompress(const std::string &data);
+};
+
+
+
+#endif
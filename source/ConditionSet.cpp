@@ -151,37 +151,6 @@ namespace {
 		return false;
 	}
 
-	// Converts the given vector of condition tokens (like "reputation: Republic",
-	// "random", or "4") into the integral values they have at runtime.
-	vector<int64_t> SubstituteValues(const vector<string> &side, const ConditionsStore &conditions,
-		const ConditionsStore &created)
-	{
-		auto result = vector<int64_t>();
-		result.reserve(side.size());
-		for(const string &str : side)
-		{
-			int64_t value = 0;
-			if(str == "random")
-				value = Random::Int(100);
-			else if(DataNode::IsNumber(str))
-				value = static_cast<int64_t>(DataNode::Value(str));
-			else
-			{
-				const auto temp = created.HasGet(str);
-				if(temp.first)
-					value = temp.second;
-				else
-				{
-					const auto perm = conditions.HasGet(str);
-					if(perm.first)
-						value = perm.second;
-				}
-			}
-			result.emplace_back(value);
-		}
-		return result;
-	}
-
 	bool UsedAll(const vector<bool> &status)
 	{
 		for(auto v : status)
@@ -247,6 +216,7 @@ ConditionSet::ConditionSet(const DataNode &node)
 void ConditionSet::Load(const DataNode &node)
 {
 	isOr = (node.Token(0) == "or");
+	cache = TestCache();
 	for(const DataNode &child : node)
 		Add(child);
 }
@@ -288,6 +258,7 @@ void ConditionSet::Add(const DataNode &node)
 	// non-simple operator (e.g. <=) and any number of simple operators.
 	static const string UNRECOGNIZED = "Warning: Unrecognized condition expression:";
 	static const string UNREPRESENTABLE = "Error: Unrepresentable condition value encountered:";
+	cache = TestCache();
 	if(node.Size() == 2)
 	{
 		if(IsUnrepresentable(node.Token(1)))
@@ -363,6 +334,7 @@ void ConditionSet::Add(const DataNode &node)
 // Add a unary operator line to the list of expressions.
 bool ConditionSet::Add(const string &firstToken, const string &secondToken)
 {
+	cache = TestCache();
 	// Each "unary" operator can be mapped to an equivalent binary expression.
 	if(firstToken == "not")
 		expressions.emplace_back(secondToken, "==", "0");
@@ -388,6 +360,7 @@ bool ConditionSet::Add(const string &firstToken, const string &secondToken)
 // Add a simple condition expression to the list of expressions.
 bool ConditionSet::Add(const string &name, const string &op, const string &value)
 {
+	cache = TestCache();
 	// If the operator is recognized, map it to a binary function.
 	BinFun fun = Op(op);
 	if(!fun)
@@ -403,6 +376,7 @@ bool ConditionSet::Add(const string &name, const string &op, const string &value
 // Add a complex condition expression to the list of expressions.
 bool ConditionSet::Add(const vector<string> &lhs, const string &op, const vector<string> &rhs)
 {
+	cache = TestCache();
 	BinFun fun = Op(op);
 	if(!fun)
 		return false;
@@ -418,13 +392,20 @@ bool ConditionSet::Add(const vector<string> &lhs, const string &op, const vector
 // on a temporary condition map, if this set mixes comparisons and modifications.
 bool ConditionSet::Test(const ConditionsStore &conditions) const
 {
+	// Nothing needs to be evaluated if none of the conditions that were read
+	// by the last test have changed since then.
+	lock_guard<mutex> lock(cache.mutex);
+	if(IsCachedResultValid(conditions))
+		return cache.result;
+
 	// If this ConditionSet contains any expressions with operators that
 	// modify the condition map, then they must be applied before testing,
 	// to generate any temporary conditions needed.
 	ConditionsStore created;
 	if(hasAssign)
 		TestApply(conditions, created);
-	return TestSet(conditions, created);
+	cache.result = TestSet(conditions, created);
+	return cache.result;
 }
 
 
@@ -501,6 +482,64 @@ void ConditionSet::TestApply(const ConditionsStore &conditions, ConditionsStore
 
 
 
+ConditionSet::TestCache &ConditionSet::TestCache::operator=(const TestCache &)
+{
+	isBuilt = false;
+	isRandom = false;
+	hasResult = false;
+	dependencies.clear();
+	versions.clear();
+	return *this;
+}
+
+
+
+void ConditionSet::AddDependencies(vector<pair<size_t, string>> &dependencies, bool &isRandom) const
+{
+	for(const Expression &expression : expressions)
+		expression.AddDependencies(dependencies, isRandom);
+	for(const ConditionSet &child : children)
+		child.AddDependencies(dependencies, isRandom);
+}
+
+
+
+bool ConditionSet::IsCachedResultValid(const ConditionsStore &conditions) const
+{
+	if(!cache.isBuilt)
+	{
+		AddDependencies(cache.dependencies, cache.isRandom);
+		sort(cache.dependencies.begin(), cache.dependencies.end());
+		cache.dependencies.erase(unique(cache.dependencies.begin(), cache.dependencies.end()),
+			cache.dependencies.end());
+		cache.versions.assign(cache.dependencies.size(), 0);
+		cache.isBuilt = true;
+	}
+	if(cache.isRandom)
+		return false;
+
+	// Every version is compared, so that all of them are up to date for the next test.
+	bool isValid = cache.hasResult;
+	cache.hasResult = true;
+	for(size_t i = 0; i < cache.dependencies.size(); ++i)
+	{
+		uint64_t version = 0;
+		if(!conditions.Version(cache.dependencies[i].first, cache.dependencies[i].second, version))
+		{
+			cache.hasResult = false;
+			return false;
+		}
+		if(version != cache.versions[i])
+		{
+			cache.versions[i] = version;
+			isValid = false;
+		}
+	}
+	return isValid;
+}
+
+
+
 // Constructor for complex expressions.
 ConditionSet::Expression::Expression(const vector<string> &left, const string &op, const vector<string> &right)
 	: op(op), fun(Op(op)), left(left), right(right)
@@ -562,6 +601,14 @@ bool ConditionSet::Expression::IsTestable() const
 
 
 
+void ConditionSet::Expression::AddDependencies(vector<pair<size_t, string>> &dependencies, bool &isRandom) const
+{
+	left.AddDependencies(dependencies, isRandom);
+	right.AddDependencies(dependencies, isRandom);
+}
+
+
+
 // Evaluate both the left- and right-hand sides of the expression, then compare the evaluated numeric values.
 bool ConditionSet::Expression::Test(const ConditionsStore &conditions, const ConditionsStore &created) const
 {
@@ -600,6 +647,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 
 	ParseSide(side);
 	GenerateSequence();
+	Compile();
 }
 
 
@@ -609,6 +657,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 ConditionSet::Expression::SubExpression::SubExpression(const string &side)
 {
 	tokens.emplace_back(side.empty() ? "'" : side);
+	Compile();
 }
 
 
@@ -668,6 +717,20 @@ bool ConditionSet::Expression::SubExpression::IsEmpty() const
 
 
 
+void ConditionSet::Expression::SubExpression::AddDependencies(vector<pair<size_t, string>> &dependencies,
+	bool &isRandom) const
+{
+	for(size_t i = 0; i < operands.size(); ++i)
+	{
+		if(operands[i].IsRandom())
+			isRandom = true;
+		else if(operands[i].IsCondition())
+			dependencies.emplace_back(operands[i].Id(), tokens[i]);
+	}
+}
+
+
+
 // Evaluate the SubExpression using the given condition maps.
 int64_t ConditionSet::Expression::SubExpression::Evaluate(const ConditionsStore &conditions,
 	const ConditionsStore &created) const
@@ -678,15 +741,17 @@ int64_t ConditionSet::Expression::SubExpression::Evaluate(const ConditionsStore
 
 	// For SubExpressions with no Operations (i.e. simple conditions), tokens will consist
 	// of only the condition or numeric value to be returned as-is after substitution.
-	auto data = SubstituteValues(tokens, conditions, created);
+	if(sequence.empty())
+		return operands.back().Value(tokens.back(), conditions, created);
 
-	if(!sequence.empty())
-	{
-		// Each Operation adds to the end of the data vector.
-		data.reserve(operatorCount + data.size());
-		for(const Operation &op : sequence)
-			data.emplace_back(op.fun(data[op.a], data[op.b]));
-	}
+	auto data = vector<int64_t>();
+	data.reserve(operands.size() + operatorCount);
+	for(size_t i = 0; i < operands.size(); ++i)
+		data.emplace_back(operands[i].Value(tokens[i], conditions, created));
+
+	// Each Operation adds to the end of the data vector.
+	for(const Operation &op : sequence)
+		data.emplace_back(op.fun(data[op.a], data[op.b]));
 
 	return data.back();
 }
@@ -737,6 +802,18 @@ void ConditionSet::Expression::SubExpression::ParseSide(const vector<string> &si
 
 
 
+// Resolve each token into an Operand. This runs after parsing, since a
+// malformed expression may have cleared its tokens.
+void ConditionSet::Expression::SubExpression::Compile()
+{
+	operands.clear();
+	operands.reserve(tokens.size());
+	for(const string &token : tokens)
+		operands.emplace_back(token);
+}
+
+
+
 // Parse the token and operators vectors to make the sequence vector.
 void ConditionSet::Expression::SubExpression::GenerateSequence()
 {
@@ -849,3 +926,60 @@ ConditionSet::Expression::SubExpression::Operation::Operation(const string &op,
 	: fun(Op(op)), a(a), b(b)
 {
 }
+
+
+
+// Numbers are parsed once, here, and condition names are interned so that
+// they can be looked up by ID.
+ConditionSet::Expression::SubExpression::Operand::Operand(const string &token)
+{
+	if(token == "random")
+		isRandom = true;
+	else if(DataNode::IsNumber(token))
+		value = static_cast<int64_t>(DataNode::Value(token));
+	else
+	{
+		isCondition = true;
+		id = ConditionsStore::Intern(token);
+	}
+}
+
+
+
+// Get the integral value this token has at runtime. Temporary conditions
+// take precedence over the given conditions.
+int64_t ConditionSet::Expression::SubExpression::Operand::Value(const string &token,
+	const ConditionsStore &conditions, const ConditionsStore &created) const
+{
+	if(isRandom)
+		return Random::Int(100);
+	if(!isCondition)
+		return value;
+
+	const auto temp = created.HasGet(id, token);
+	if(temp.first)
+		return temp.second;
+	const auto perm = conditions.HasGet(id, token);
+	return perm.first ? perm.second : 0;
+}
+
+
+
+bool ConditionSet::Expression::SubExpression::Operand::IsCondition() const
+{
+	return isCondition;
+}
+
+
+
+bool ConditionSet::Expression::SubExpression::Operand::IsRandom() const
+{
+	return isRandom;
+}
+
+
+
+size_t ConditionSet::Expression::SubExpression::Operand::Id() const
+{
+	return id;
+}
@@ -16,9 +16,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef CONDITION_SET_H_
 #define CONDITION_SET_H_
 
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 class ConditionsStore;
@@ -72,6 +75,11 @@ private:
 	bool TestSet(const ConditionsStore &conditions, const ConditionsStore &created) const;
 	// Evaluate this set's assignment expressions and store the result in "created" (for use by TestSet).
 	void TestApply(const ConditionsStore &conditions, ConditionsStore &created) const;
+	// Collect the interned IDs and names of every condition read by this set or its children.
+	void AddDependencies(std::vector<std::pair<size_t, std::string>> &dependencies, bool &isRandom) const;
+	// Check if the result of the last Test() still holds for the given conditions, and
+	// record the current versions of the conditions this set depends on if not.
+	bool IsCachedResultValid(const ConditionsStore &conditions) const;
 
 
 private:
@@ -94,6 +102,9 @@ private:
 		// True if this Expression performs a comparison and false if it performs an assignment.
 		bool IsTestable() const;
 
+		// Collect the conditions that this expression reads, and whether it uses "random".
+		void AddDependencies(std::vector<std::pair<size_t, std::string>> &dependencies, bool &isRandom) const;
+
 		// Functions to use this expression:
 		bool Test(const ConditionsStore &conditions, const ConditionsStore &created) const;
 		void Apply(ConditionsStore &conditions, ConditionsStore &created) const;
@@ -117,6 +128,8 @@ private:
 
 			bool IsEmpty() const;
 
+			void AddDependencies(std::vector<std::pair<size_t, std::string>> &dependencies, bool &isRandom) const;
+
 			// Substitute numbers for any string values and then compute the result.
 			int64_t Evaluate(const ConditionsStore &conditions, const ConditionsStore &created) const;
 
@@ -125,6 +138,8 @@ private:
 			void ParseSide(const std::vector<std::string> &side);
 			void GenerateSequence();
 			bool AddOperation(std::vector<int> &data, size_t &index, const size_t &opIndex);
+			// Resolve each token into an Operand, so nothing needs to be parsed during evaluation.
+			void Compile();
 
 
 		private:
@@ -139,6 +154,27 @@ private:
 				size_t b;
 			};
 
+			// An Operand is a token as it is evaluated: either a number, the "random"
+			// keyword, or a condition name that was interned when the token was compiled.
+			class Operand {
+			public:
+				explicit Operand(const std::string &token);
+
+				int64_t Value(const std::string &token, const ConditionsStore &conditions,
+					const ConditionsStore &created) const;
+
+				bool IsCondition() const;
+				bool IsRandom() const;
+				size_t Id() const;
+
+			private:
+				bool isCondition = false;
+				bool isRandom = false;
+				// The value of a number, or the interned ID of a condition.
+				int64_t value = 0;
+				size_t id = 0;
+			};
+
 
 		private:
 			// Iteration of the sequence vector yields the result.
@@ -146,6 +182,8 @@ private:
 			// The tokens vector converts into a data vector of numeric values during evaluation.
 			std::vector<std::string> tokens;
 			std::vector<std::string> operators;
+			// One compiled Operand for each token.
+			std::vector<Operand> operands;
 			// The number of true (non-parentheses) operators.
 			int operatorCount = 0;
 		};
@@ -164,6 +202,28 @@ private:
 	};
 
 
+	// The result of the last Test(), with the versions of the conditions that it
+	// was computed from. The result is reused until one of those versions changes.
+	class TestCache {
+	public:
+		TestCache() = default;
+		// Copies start out empty, so that each copy can have its own lock.
+		TestCache(const TestCache &) {}
+		TestCache &operator=(const TestCache &);
+
+		// A set may be tested on several threads at once.
+		std::mutex mutex;
+		// Whether the dependencies have been collected since the set last changed.
+		bool isBuilt = false;
+		// Sets that use "random", or read derived conditions, are always re-tested.
+		bool isRandom = false;
+		bool hasResult = false;
+		bool result = false;
+		std::vector<std::pair<size_t, std::string>> dependencies;
+		std::vector<uint64_t> versions;
+	};
+
+
 private:
 	// Sets of condition tests can contain nested sets of tests. Each set is
 	// either an "and" grouping (meaning every condition must be true to satisfy
@@ -176,6 +236,8 @@ private:
 	std::vector<Expression> expressions;
 	// Nested sets of conditions to be tested.
 	std::vector<ConditionSet> children;
+
+	mutable TestCache cache;
 };
 
 
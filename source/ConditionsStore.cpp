@@ -18,11 +18,36 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "DataWriter.h"
 #include "Logger.h"
+#include "MemoryStats.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <unordered_map>
 #include <utility>
 
 using namespace std;
 
+namespace {
+	// Every condition name that has been interned, mapped to its ID. Names are
+	// interned while data files load, which may happen on a worker thread.
+	mutex internMutex;
+	unordered_map<string, size_t> internedIds;
+
+	const size_t NONE = numeric_limits<size_t>::max();
+
+	// The last version given to any condition entry.
+	atomic<uint64_t> lastVersion(0);
+
+	// Each entry is one node of a store's hash table, along with its name.
+	void CountEntry(int64_t entries)
+	{
+		const int64_t BYTES = sizeof(pair<const string, ConditionsStore::ConditionEntry>) + 2 * sizeof(void *);
+		MemoryStats::Add(MemoryStats::Category::CONDITIONS, entries * BYTES);
+	}
+}
+
 
 
 // Default constructor
@@ -61,6 +86,36 @@ void ConditionsStore::DerivedProvider::SetEraseFunction(function<bool(const stri
 
 
 
+ConditionsStore::ConditionEntry::ConditionEntry()
+{
+	CountEntry(1);
+}
+
+
+
+ConditionsStore::ConditionEntry::ConditionEntry(const ConditionEntry &other)
+	: value(other.value), version(other.version), provider(other.provider), fullKey(other.fullKey)
+{
+	CountEntry(1);
+}
+
+
+
+ConditionsStore::ConditionEntry::ConditionEntry(ConditionEntry &&other) noexcept
+	: value(other.value), version(other.version), provider(other.provider), fullKey(std::move(other.fullKey))
+{
+	CountEntry(1);
+}
+
+
+
+ConditionsStore::ConditionEntry::~ConditionEntry()
+{
+	CountEntry(-1);
+}
+
+
+
 ConditionsStore::ConditionEntry::operator int64_t() const
 {
 	if(!provider)
@@ -75,7 +130,11 @@ ConditionsStore::ConditionEntry::operator int64_t() const
 ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator=(int64_t val)
 {
 	if(!provider)
+	{
+		if(value != val)
+			Touch();
 		value = val;
+	}
 	else
 	{
 		const string &key = fullKey.empty() ? provider->name : fullKey;
@@ -89,7 +148,10 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator=(int6
 ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator++()
 {
 	if(!provider)
+	{
 		++value;
+		Touch();
+	}
 	else
 	{
 		const string &key = fullKey.empty() ? provider->name : fullKey;
@@ -103,7 +165,10 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator++()
 ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator--()
 {
 	if(!provider)
+	{
 		--value;
+		Touch();
+	}
 	else
 	{
 		const string &key = fullKey.empty() ? provider->name : fullKey;
@@ -117,7 +182,10 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator--()
 ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator+=(int64_t val)
 {
 	if(!provider)
+	{
 		value += val;
+		Touch();
+	}
 	else
 	{
 		const string &key = fullKey.empty() ? provider->name : fullKey;
@@ -131,7 +199,10 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator+=(int
 ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator-=(int64_t val)
 {
 	if(!provider)
+	{
 		value -= val;
+		Touch();
+	}
 	else
 	{
 		const string &key = fullKey.empty() ? provider->name : fullKey;
@@ -142,6 +213,13 @@ ConditionsStore::ConditionEntry &ConditionsStore::ConditionEntry::operator-=(int
 
 
 
+void ConditionsStore::ConditionEntry::Touch()
+{
+	version = ++lastVersion;
+}
+
+
+
 // Constructor with loading primary conditions from datanode.
 ConditionsStore::ConditionsStore(const DataNode &node)
 {
@@ -178,16 +256,26 @@ void ConditionsStore::Load(const DataNode &node)
 
 void ConditionsStore::Save(DataWriter &out) const
 {
-	out.Write("conditions");
-	out.BeginChild();
-	for(auto it = storage.begin(); it != storage.end(); ++it)
+	// Write the primary conditions in order of their names, so that saves stay stable.
+	vector<const pair<const string, ConditionEntry> *> primaries;
+	for(const auto &it : storage)
 	{
 		// We don't need to save derived conditions that have a provider.
-		if(it->second.provider)
+		if(it.second.provider)
 			continue;
 		// If the condition's value is 0, don't write it at all.
-		if(!it->second.value)
+		if(!it.second.value)
 			continue;
+		primaries.emplace_back(&it);
+	}
+	sort(primaries.begin(), primaries.end(),
+		[](const pair<const string, ConditionEntry> *a, const pair<const string, ConditionEntry> *b)
+		{ return a->first < b->first; });
+
+	out.Write("conditions");
+	out.BeginChild();
+	for(const auto *it : primaries)
+	{
 		// If the condition's value is 1, don't bother writing the 1.
 		if(it->second.value == 1)
 			out.Write(it->first);
@@ -234,19 +322,34 @@ bool ConditionsStore::Has(const string &name) const
 // and an int64_t which contains the value if the condition was set.
 pair<bool, int64_t> ConditionsStore::HasGet(const string &name) const
 {
-	const ConditionEntry *ce = GetEntry(name);
-	if(!ce)
-		return make_pair(false, 0);
+	return EntryValue(GetEntry(name), name);
+}
 
-	if(!ce->provider)
-		return make_pair(true, ce->value);
 
-	bool has = ce->provider->hasFunction(name);
-	int64_t val = 0;
-	if(has)
-		val = ce->provider->getFunction(name);
 
-	return make_pair(has, val);
+pair<bool, int64_t> ConditionsStore::HasGet(size_t id, const string &name) const
+{
+	return EntryValue(GetEntry(id, name), name);
+}
+
+
+
+bool ConditionsStore::Version(size_t id, const string &name, uint64_t &version) const
+{
+	const ConditionEntry *ce = GetEntry(id, name);
+	if(ce && ce->provider)
+		return false;
+
+	version = ce ? ce->version : 0;
+	return true;
+}
+
+
+
+size_t ConditionsStore::Intern(const string &name)
+{
+	lock_guard<mutex> lock(internMutex);
+	return internedIds.emplace(name, internedIds.size()).first->second;
 }
 
 
@@ -269,12 +372,15 @@ bool ConditionsStore::Set(const string &name, int64_t value)
 	ConditionEntry *ce = GetEntry(name);
 	if(!ce)
 	{
-		(storage[name]).value = value;
+		ConditionEntry &entry = storage[name];
+		entry.value = value;
+		entry.Touch();
+		++revision;
 		return true;
 	}
 	if(!ce->provider)
 	{
-		ce->value = value;
+		*ce = value;
 		return true;
 	}
 	return ce->provider->setFunction(name, value);
@@ -293,6 +399,7 @@ bool ConditionsStore::Erase(const string &name)
 	if(!(ce->provider))
 	{
 		storage.erase(name);
+		++revision;
 		return true;
 	}
 	return ce->provider->eraseFunction(name);
@@ -307,11 +414,17 @@ ConditionsStore::ConditionEntry &ConditionsStore::operator[](const string &name)
 	if(it != storage.end())
 		return it->second;
 
+	// Any path below adds a new entry to the storage.
+	++revision;
 	// Check for a prefix provider.
 	ConditionEntry *ceprov = GetEntry(name);
 	// If no prefix provider is found, then just create a new value entry.
 	if(ceprov == nullptr)
-		return storage[name];
+	{
+		ConditionEntry &ce = storage[name];
+		ce.Touch();
+		return ce;
+	}
 
 	// Found a matching prefixed entry provider, but no exact match for the entry itself,
 	// let's create the exact match based on the prefix provider.
@@ -337,21 +450,25 @@ ConditionsStore::DerivedProvider &ConditionsStore::GetProviderPrefixed(const str
 	}
 	if(VerifyProviderLocation(prefix, provider))
 	{
-		storage[prefix].provider = provider;
-		// Check if any matching later entries within the prefixed range use the same provider.
-		auto checkIt = storage.find(prefix);
-		while(checkIt != storage.end() && (0 == checkIt->first.compare(0, prefix.length(), prefix)))
+		ConditionEntry &entry = storage[prefix];
+		entry.provider = provider;
+		prefixes.Insert(prefix, &entry);
+		++revision;
+		// Check if any other entries within the prefixed range use a different provider.
+		bool replaced = false;
+		for(auto &it : storage)
 		{
-			ConditionEntry &ce = checkIt->second;
-			if(ce.provider != provider)
+			ConditionEntry &ce = it.second;
+			if(ce.provider != provider && !it.first.compare(0, prefix.length(), prefix))
 			{
 				ce.provider = provider;
-				ce.fullKey = checkIt->first;
-				throw runtime_error("Replacing condition entries matching prefixed provider \""
-						+ prefix + "\".");
+				ce.fullKey = it.first;
+				replaced = true;
 			}
-			++checkIt;
 		}
+		if(replaced)
+			throw runtime_error("Replacing condition entries matching prefixed provider \""
+					+ prefix + "\".");
 	}
 	return *provider;
 }
@@ -368,7 +485,10 @@ ConditionsStore::DerivedProvider &ConditionsStore::GetProviderNamed(const string
 	if(provider->isPrefixProvider)
 		Logger::LogError("Error: Retrieving prefixed provider \"" + name + "\" as named provider.");
 	else if(VerifyProviderLocation(name, provider))
+	{
 		storage[name].provider = provider;
+		++revision;
+	}
 	return *provider;
 }
 
@@ -379,6 +499,8 @@ void ConditionsStore::Clear()
 {
 	storage.clear();
 	providers.clear();
+	prefixes.Clear();
+	++revision;
 }
 
 
@@ -409,26 +531,13 @@ ConditionsStore::ConditionEntry *ConditionsStore::GetEntry(const string &name)
 
 const ConditionsStore::ConditionEntry *ConditionsStore::GetEntry(const string &name) const
 {
-	if(storage.empty())
-		return nullptr;
-
-	// Perform a single search for values, named providers, and prefixed providers.
-	auto it = storage.upper_bound(name);
-	if(it == storage.begin())
-		return nullptr;
-
-	--it;
 	// The entry is matching if we have an exact string match.
-	if(!name.compare(it->first))
-		return &(it->second);
-
-	// The entry is also matching when we have a prefix entry and the prefix part in the provider matches.
-	DerivedProvider *provider = it->second.provider;
-	if(provider && provider->isPrefixProvider && !name.compare(0, provider->name.length(), provider->name))
+	auto it = storage.find(name);
+	if(it != storage.end())
 		return &(it->second);
 
-	// And otherwise we don't have a match.
-	return nullptr;
+	// The entry is also matching when a prefixed provider's name is a prefix of it.
+	return prefixes.Find(name);
 }
 
 
@@ -436,26 +545,148 @@ const ConditionsStore::ConditionEntry *ConditionsStore::GetEntry(const string &n
 // Helper function to check if we can safely add a provider with the given name.
 bool ConditionsStore::VerifyProviderLocation(const string &name, DerivedProvider *provider) const
 {
-	auto it = storage.upper_bound(name);
-	if(it == storage.begin())
-		return true;
+	auto it = storage.find(name);
+	if(it != storage.end())
+	{
+		const ConditionEntry &ce = it->second;
+		// If we find the provider we are trying to add, then it apparently
+		// was safe to add the entry since it was already added before.
+		if(ce.provider == provider)
+			return true;
 
-	--it;
-	const ConditionEntry &ce = it->second;
+		if(!ce.provider)
+		{
+			Logger::LogError("Error: overwriting primary condition \"" + name + "\" with derived provider.");
+			return true;
+		}
+	}
 
-	// If we find the provider we are trying to add, then it apparently
-	// was safe to add the entry since it was already added before.
-	if(ce.provider == provider)
-		return true;
+	const ConditionEntry *ce = prefixes.Find(name);
+	if(ce && ce->provider != provider)
+		throw runtime_error("Error: not adding provider for \"" + name + "\""
+				", because it is within range of prefixed derived provider \"" + ce->provider->name + "\".");
+	return true;
+}
+
+
+
+const ConditionsStore::ConditionEntry *ConditionsStore::GetEntry(size_t id, const string &name) const
+{
+	lock_guard<mutex> lock(byId.mutex);
+	if(id >= byId.slots.size())
+		byId.slots.resize(id + 1);
 
-	if(!ce.provider && it->first == name)
+	CachedEntry &slot = byId.slots[id];
+	if(slot.revision != revision)
 	{
-		Logger::LogError("Error: overwriting primary condition \"" + name + "\" with derived provider.");
-		return true;
+		slot.entry = GetEntry(name);
+		slot.revision = revision;
 	}
+	return slot.entry;
+}
 
-	if(ce.provider && ce.provider->isPrefixProvider && 0 == name.compare(0, ce.provider->name.length(), ce.provider->name))
-		throw runtime_error("Error: not adding provider for \"" + name + "\""
-				", because it is within range of prefixed derived provider \"" + ce.provider->name + "\".");
-	return true;
+
+
+// Helper function for the HasGet variants, once the entry has been looked up.
+pair<bool, int64_t> ConditionsStore::EntryValue(const ConditionEntry *ce, const string &name) const
+{
+	if(!ce)
+		return make_pair(false, 0);
+
+	if(!ce->provider)
+		return make_pair(true, ce->value);
+
+	bool has = ce->provider->hasFunction(name);
+	int64_t val = 0;
+	if(has)
+		val = ce->provider->getFunction(name);
+
+	return make_pair(has, val);
+}
+
+
+
+void ConditionsStore::PrefixTrie::Insert(const string &prefix, ConditionEntry *entry)
+{
+	if(nodes.empty())
+		nodes.emplace_back();
+
+	size_t node = 0;
+	size_t pos = 0;
+	while(pos < prefix.length())
+	{
+		size_t child = FindChild(node, prefix[pos]);
+		if(child == NONE)
+		{
+			// No existing branch shares this part of the prefix, so add a leaf for the rest of it.
+			child = nodes.size();
+			nodes.emplace_back();
+			nodes[child].label = prefix.substr(pos);
+			nodes[node].children.push_back(child);
+			node = child;
+			break;
+		}
+
+		const string label = nodes[child].label;
+		size_t common = 0;
+		while(common < label.length() && pos + common < prefix.length() && label[common] == prefix[pos + common])
+			++common;
+		if(common < label.length())
+		{
+			// Split the child's label, so that the shared part gets a node of its own.
+			size_t middle = nodes.size();
+			nodes.emplace_back();
+			nodes[middle].label = label.substr(0, common);
+			nodes[middle].children.push_back(child);
+			nodes[child].label = label.substr(common);
+			replace(nodes[node].children.begin(), nodes[node].children.end(), child, middle);
+			child = middle;
+		}
+		node = child;
+		pos += common;
+	}
+	nodes[node].entry = entry;
+}
+
+
+
+ConditionsStore::ConditionEntry *ConditionsStore::PrefixTrie::Find(const string &name) const
+{
+	if(nodes.empty())
+		return nullptr;
+
+	ConditionEntry *result = nodes.front().entry;
+	size_t node = 0;
+	size_t pos = 0;
+	while(pos < name.length())
+	{
+		node = FindChild(node, name[pos]);
+		if(node == NONE)
+			break;
+
+		const string &label = nodes[node].label;
+		if(name.compare(pos, label.length(), label))
+			break;
+		pos += label.length();
+		if(nodes[node].entry)
+			result = nodes[node].entry;
+	}
+	return result;
+}
+
+
+
+void ConditionsStore::PrefixTrie::Clear()
+{
+	nodes.clear();
+}
+
+
+
+size_t ConditionsStore::PrefixTrie::FindChild(size_t node, char c) const
+{
+	for(size_t child : nodes[node].children)
+		if(nodes[child].label[0] == c)
+			return child;
+	return NONE;
 }
@@ -19,7 +19,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <functional>
 #include <initializer_list>
 #include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -81,6 +84,14 @@ public:
 		friend ConditionsStore;
 
 	public:
+		// Each entry that exists is counted in the memory statistics.
+		ConditionEntry();
+		ConditionEntry(const ConditionEntry &other);
+		ConditionEntry(ConditionEntry &&other) noexcept;
+		ConditionEntry &operator=(const ConditionEntry &other) = default;
+		ConditionEntry &operator=(ConditionEntry &&other) = default;
+		~ConditionEntry();
+
 		// int64_t proxy helper functions. Those functions allow access to the conditions
 		// using `operator[]` on ConditionsStore.
 		operator int64_t() const;
@@ -90,8 +101,15 @@ public:
 		ConditionEntry &operator+=(int64_t val);
 		ConditionEntry &operator-=(int64_t val);
 
+	private:
+		// Record that the value of this (primary) entry has changed.
+		void Touch();
+
 	private:
 		int64_t value = 0;
+		// Changes whenever the value of a primary condition changes. No two
+		// entries, even in different stores, are ever given the same version.
+		uint64_t version = 0;
 		DerivedProvider *provider = nullptr;
 		// The full keyname for condition we want to access. This full keyname is required
 		// when accessing prefixed providers, because such providers will only know the prefix
@@ -117,6 +135,20 @@ public:
 	int64_t Get(const std::string &name) const;
 	bool Has(const std::string &name) const;
 	std::pair<bool, int64_t> HasGet(const std::string &name) const;
+	// Same as above, but for a condition name that was interned beforehand. The
+	// entry found for the given ID is remembered until this store next gains
+	// or loses an entry, so repeated lookups skip the search by name.
+	std::pair<bool, int64_t> HasGet(size_t id, const std::string &name) const;
+
+	// Get the version of an interned condition, for consumers that cache results
+	// computed from its value. The version is 0 if the condition is not set, and
+	// otherwise changes whenever it is set, changed or erased. Returns false if
+	// the value comes from a derived provider, whose changes cannot be tracked.
+	bool Version(size_t id, const std::string &name, uint64_t &version) const;
+
+	// Get the dense ID that represents the given condition name in every store.
+	// Interning the same name again returns the same ID.
+	static size_t Intern(const std::string &name);
 
 	// Add a value to a condition, set a value for a condition or erase a
 	// condition completely. Returns true on success, false on failure.
@@ -145,13 +177,72 @@ private:
 	ConditionEntry *GetEntry(const std::string &name);
 	const ConditionEntry *GetEntry(const std::string &name) const;
 	bool VerifyProviderLocation(const std::string &name, DerivedProvider *provider) const;
+	std::pair<bool, int64_t> EntryValue(const ConditionEntry *ce, const std::string &name) const;
+	// Find the entry for an interned condition, using the cached lookup if it is still valid.
+	const ConditionEntry *GetEntry(size_t id, const std::string &name) const;
+
+
+private:
+	// A radix trie over the names of the prefixed providers, mapping each of
+	// them to the storage entry that holds the provider.
+	class PrefixTrie {
+	public:
+		void Insert(const std::string &prefix, ConditionEntry *entry);
+		// Find the entry of the longest provider prefix that the given name starts with.
+		ConditionEntry *Find(const std::string &name) const;
+		void Clear();
+
+	private:
+		class Node {
+		public:
+			// The part of the prefix that this node adds to its parent.
+			std::string label;
+			std::vector<size_t> children;
+			ConditionEntry *entry = nullptr;
+		};
 
+	private:
+		// Find the child of the given node whose label starts with the given character.
+		size_t FindChild(size_t node, char c) const;
+
+	private:
+		// The first node is the root, which has an empty label.
+		std::vector<Node> nodes;
+	};
+
+	// The entry (or lack of one) that an interned ID resolved to, and the
+	// revision of the storage at the time that it was resolved.
+	class CachedEntry {
+	public:
+		const ConditionEntry *entry = nullptr;
+		uint64_t revision = 0;
+	};
+	// The cached entries point into this store's own storage, so copies of
+	// the store always start out with an empty cache. Lookups in a const store
+	// may happen on several threads at once, so the cache has its own lock.
+	class EntryCache {
+	public:
+		EntryCache() = default;
+		EntryCache(const EntryCache &) {}
+		EntryCache &operator=(const EntryCache &) { slots.clear(); return *this; }
+
+		std::mutex mutex;
+		std::vector<CachedEntry> slots;
+	};
 
 
 private:
-	// Storage for both the primary conditions as well as the providers.
-	std::map<std::string, ConditionEntry> storage;
+	// Storage for both the primary conditions as well as the providers. The
+	// entries are not kept in order; Save() sorts the ones that it writes.
+	std::unordered_map<std::string, ConditionEntry> storage;
 	std::map<std::string, DerivedProvider> providers;
+	// The prefixed providers, for looking up conditions that have no entry of their own.
+	PrefixTrie prefixes;
+
+	// Lookups by interned ID, indexed by that ID. Any entry being added to or
+	// removed from the storage bumps the revision, which invalidates them all.
+	mutable EntryCache byId;
+	uint64_t revision = 1;
 };
 
 
@@ -136,9 +136,21 @@ void ConversationPanel::Draw()
 	Point point(
 		Screen::Left() + MARGIN,
 		Screen::Top() + MARGIN + scroll);
-	// Draw all the conversation text up to this point.
+	// Draw all the conversation text up to this point. Long conversations may
+	// have far more text than fits on screen, so paragraphs that are above the
+	// screen are only stepped over, and drawing stops at the bottom.
+	const double textEnd = point.Y() + textHeight;
 	for(const Paragraph &it : text)
-		point = it.Draw(point, gray);
+	{
+		if(point.Y() > Screen::Bottom())
+			break;
+		int height = it.Height();
+		if(point.Y() + height < Screen::Top())
+			point.Y() += height;
+		else
+			point = it.Draw(point, gray);
+	}
+	point.Y() = textEnd;
 
 	// Draw whatever choices are being presented.
 	if(node < 0)
@@ -301,6 +313,7 @@ bool ConversationPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &comm
 			// Display the name the player entered.
 			string name = "\t\tName: " + firstName + " " + lastName + ".\n";
 			text.emplace_back(name);
+			textHeight += text.back().Height();
 
 			player.SetName(firstName, lastName);
 			subs["<first>"] = player.FirstName();
@@ -385,15 +398,14 @@ void ConversationPanel::Goto(int index, int selectedChoice)
 	{
 		// Add the chosen option to the text.
 		if(selectedChoice >= 0 && selectedChoice < static_cast<int>(choices.size()))
+		{
 			text.emplace_back(next(choices.begin(), selectedChoice)->first);
+			textHeight += text.back().Height();
+		}
 
 		// Scroll to the start of the new text, unless the conversation ended.
 		if(index >= 0)
-		{
-			scroll = -11;
-			for(const Paragraph &it : text)
-				scroll -= it.Height();
-		}
+			scroll = -11 - textHeight;
 	}
 
 	// We'll need to reload the choices from whatever new node we arrive at.
@@ -431,6 +443,7 @@ void ConversationPanel::Goto(int index, int selectedChoice)
 			// Perform any necessary text replacement, and add the text to the display.
 			string altered = Format::ExpandConditions(Format::Replace(conversation.Text(node), subs), getter);
 			text.emplace_back(altered, conversation.Scene(node), text.empty());
+			textHeight += text.back().Height();
 		}
 		else
 		{
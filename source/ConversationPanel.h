@@ -122,8 +122,9 @@ private:
 	// Current scroll position.
 	double scroll = 0.;
 
-	// The "history" of the conversation up to this point:
+	// The "history" of the conversation up to this point, and its total height:
 	std::list<Paragraph> text;
+	int textHeight = 0;
 	// The current choices being presented to you, and their indices:
 	std::list<std::pair<Paragraph, int>> choices;
 	int choice = 0;
@@ -14,6 +14,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 */
 #include "CrashState.h"
 #include "Files.h"
+#include "SaveQueue.h"
 #include <string>
 
 namespace CrashState
@@ -47,7 +48,9 @@ void Init(bool test)
 
 void Set(State s)
 {
-   Files::Write(Files::Config() + "/crash_state.txt", std::to_string(static_cast<int>(s)));
+   // Queue the write, so startup never waits on storage. A crash handler or
+   // the exit path flushes the queue.
+   SaveQueue::Write(Files::Config() + "/crash_state.txt", std::to_string(static_cast<int>(s)));
 }
 
 State Previous() { return g_prev_state; }
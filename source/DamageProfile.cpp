@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DamageProfile.h"
 
+#include "AttributeKey.h"
 #include "DamageDealt.h"
 #include "Mask.h"
 #include "Outfit.h"
@@ -124,16 +125,16 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 	double shields = ship.ShieldLevel();
 	if(shields > 0.)
 	{
-		double piercing = max(0., min(1., weapon.Piercing() / (1. + attributes.Get("piercing protection"))
-			- attributes.Get("piercing resistance")));
-		double highPermeability = attributes.Get("high shield permeability");
-		double lowPermeability = attributes.Get("low shield permeability");
+		double piercing = max(0., min(1., weapon.Piercing() / (1. + attributes.Get(AttributeKey::PIERCING_PROTECTION))
+			- attributes.Get(AttributeKey::PIERCING_RESISTANCE)));
+		double highPermeability = attributes.Get(AttributeKey::HIGH_SHIELD_PERMEABILITY);
+		double lowPermeability = attributes.Get(AttributeKey::LOW_SHIELD_PERMEABILITY);
 		double permeability = 0.;
 		if(highPermeability || lowPermeability)
 		{
 			// Determine what portion of its maximum shields the ship is currently at.
 			// Only do this if there is nonzero permeability involved, otherwise don't.
-			double shieldPortion = shields / attributes.Get("shields");
+			double shieldPortion = shields / attributes.Get(AttributeKey::SHIELDS);
 			permeability = max((highPermeability * shieldPortion) +
 				(lowPermeability * (1. - shieldPortion)), 0.);
 		}
@@ -141,8 +142,8 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 			(1. + ship.DisruptionLevel() * .01);
 
 		damage.shieldDamage = (weapon.ShieldDamage()
-			+ weapon.RelativeShieldDamage() * attributes.Get("shields"))
-			* ScaleType(0., 0., attributes.Get("shield protection"));
+			+ weapon.RelativeShieldDamage() * attributes.Get(AttributeKey::SHIELDS))
+			* ScaleType(0., 0., attributes.Get(AttributeKey::SHIELD_PROTECTION));
 		if(damage.shieldDamage > shields)
 			shieldFraction = min(shieldFraction, shields / damage.shieldDamage);
 	}
@@ -153,47 +154,51 @@ void DamageProfile::PopulateDamage(DamageDealt &damage, const Ship &ship) const
 	// Shield damage is blocked 0%.
 	damage.shieldDamage *= shieldFraction;
 	damage.hullDamage = (weapon.HullDamage()
-		+ weapon.RelativeHullDamage() * attributes.Get("hull"))
-		* ScaleType(1., 0., attributes.Get("hull protection"));
+		+ weapon.RelativeHullDamage() * attributes.Get(AttributeKey::HULL))
+		* ScaleType(1., 0., attributes.Get(AttributeKey::HULL_PROTECTION));
 	double hull = ship.HullUntilDisabled();
 	if(damage.hullDamage > hull)
 	{
 		double hullFraction = hull / damage.hullDamage;
 		damage.hullDamage *= hullFraction;
 		damage.hullDamage += (weapon.DisabledDamage()
-			+ weapon.RelativeDisabledDamage() * attributes.Get("hull"))
-			* ScaleType(1., 0., attributes.Get("hull protection"))
+			+ weapon.RelativeDisabledDamage() * attributes.Get(AttributeKey::HULL))
+			* ScaleType(1., 0., attributes.Get(AttributeKey::HULL_PROTECTION))
 			* (1. - hullFraction);
 	}
 	damage.energyDamage = (weapon.EnergyDamage()
-		+ weapon.RelativeEnergyDamage() * attributes.Get("energy capacity"))
-		* ScaleType(.5, 0., attributes.Get("energy protection"));
+		+ weapon.RelativeEnergyDamage() * attributes.Get(AttributeKey::ENERGY_CAPACITY))
+		* ScaleType(.5, 0., attributes.Get(AttributeKey::ENERGY_PROTECTION));
 	damage.heatDamage = (weapon.HeatDamage()
 		+ weapon.RelativeHeatDamage() * ship.MaximumHeat())
-		* ScaleType(.5, 0., attributes.Get("heat protection"));
+		* ScaleType(.5, 0., attributes.Get(AttributeKey::HEAT_PROTECTION));
 	damage.fuelDamage = (weapon.FuelDamage()
-		+ weapon.RelativeFuelDamage() * attributes.Get("fuel capacity"))
-		* ScaleType(.5, 0., attributes.Get("fuel protection"));
+		+ weapon.RelativeFuelDamage() * attributes.Get(AttributeKey::FUEL_CAPACITY))
+		* ScaleType(.5, 0., attributes.Get(AttributeKey::FUEL_PROTECTION));
 
 	// DoT damage types with an instantaneous analog.
 	// Ion and burn damage are blocked 50% by shields.
 	// Corrosion and leak damage are blocked 100%.
 	// Discharge damage is blocked 50% by the absence of shields.
-	damage.dischargeDamage = weapon.DischargeDamage() * ScaleType(0., .5, attributes.Get("discharge protection"));
-	damage.corrosionDamage = weapon.CorrosionDamage() * ScaleType(1., 0., attributes.Get("corrosion protection"));
-	damage.ionDamage = weapon.IonDamage() * ScaleType(.5, 0., attributes.Get("ion protection"));
-	damage.burnDamage = weapon.BurnDamage() * ScaleType(.5, 0., attributes.Get("burn protection"));
-	damage.leakDamage = weapon.LeakDamage() * ScaleType(1., 0., attributes.Get("leak protection"));
+	damage.dischargeDamage = weapon.DischargeDamage()
+		* ScaleType(0., .5, attributes.Get(AttributeKey::DISCHARGE_PROTECTION));
+	damage.corrosionDamage = weapon.CorrosionDamage()
+		* ScaleType(1., 0., attributes.Get(AttributeKey::CORROSION_PROTECTION));
+	damage.ionDamage = weapon.IonDamage() * ScaleType(.5, 0., attributes.Get(AttributeKey::ION_PROTECTION));
+	damage.burnDamage = weapon.BurnDamage() * ScaleType(.5, 0., attributes.Get(AttributeKey::BURN_PROTECTION));
+	damage.leakDamage = weapon.LeakDamage() * ScaleType(1., 0., attributes.Get(AttributeKey::LEAK_PROTECTION));
 
 	// Unique special damage types.
 	// Slowing and scrambling are blocked 50% by shields.
 	// Disruption is blocked 50% by the absence of shields.
-	damage.slowingDamage = weapon.SlowingDamage() * ScaleType(.5, 0., attributes.Get("slowing protection"));
-	damage.scramblingDamage = weapon.ScramblingDamage() * ScaleType(.5, 0., attributes.Get("scramble protection"));
-	damage.disruptionDamage = weapon.DisruptionDamage() * ScaleType(0., .5, attributes.Get("disruption protection"));
+	damage.slowingDamage = weapon.SlowingDamage() * ScaleType(.5, 0., attributes.Get(AttributeKey::SLOWING_PROTECTION));
+	damage.scramblingDamage = weapon.ScramblingDamage()
+		* ScaleType(.5, 0., attributes.Get(AttributeKey::SCRAMBLE_PROTECTION));
+	damage.disruptionDamage = weapon.DisruptionDamage()
+		* ScaleType(0., .5, attributes.Get(AttributeKey::DISRUPTION_PROTECTION));
 
 	// Hit force is unaffected by shields.
-	double hitForce = weapon.HitForce() * ScaleType(0., 0., attributes.Get("force protection"));
+	double hitForce = weapon.HitForce() * ScaleType(0., 0., attributes.Get(AttributeKey::FORCE_PROTECTION));
 	if(hitForce)
 	{
 		Point d = ship.Position() - position;
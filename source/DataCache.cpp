@@ -0,0 +1,174 @@
+/* DataCache.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "DataCache.h"
+
+#include "DataFile.h"
+#include "Files.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace {
+	// Every cache begins with this header. The version must be changed whenever
+	// either the cache format or the way that data files are parsed changes.
+	const string HEADER = "Endless Sky data cache";
+	const uint64_t VERSION = 1;
+
+	template <class Type>
+	void Write(string &out, Type value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+
+
+	template <class Type>
+	bool Read(const string &data, size_t &pos, Type &value)
+	{
+		if(data.size() - pos < sizeof(value))
+			return false;
+		memcpy(&value, data.data() + pos, sizeof(value));
+		pos += sizeof(value);
+		return true;
+	}
+
+
+
+	bool ReadString(const string &data, size_t &pos, string &value)
+	{
+		uint64_t length = 0;
+		if(!Read(data, pos, length) || data.size() - pos < length)
+			return false;
+		value.assign(data, pos, length);
+		pos += length;
+		return true;
+	}
+
+
+
+	void WriteString(string &out, const string &value)
+	{
+		Write<uint64_t>(out, value.size());
+		out += value;
+	}
+}
+
+
+
+// Load the cache saved at the given path.
+DataCache::DataCache(const string &path)
+	: path(path)
+{
+	string data = Files::Read(path);
+	if(data.compare(0, HEADER.size(), HEADER))
+		return;
+
+	size_t pos = HEADER.size();
+	uint64_t version = 0;
+	if(!Read(data, pos, version) || version != VERSION)
+		return;
+
+	while(pos < data.size())
+	{
+		string name;
+		Entry entry;
+		if(!ReadString(data, pos, name) || !Read(data, pos, entry.timestamp) || !Read(data, pos, entry.size)
+				|| !ReadString(data, pos, entry.data))
+		{
+			// If any part of the cache is damaged, none of it can be trusted.
+			entries.clear();
+			return;
+		}
+		entries[name] = std::move(entry);
+	}
+}
+
+
+
+// Load an up to date copy of the given data file, if there is one.
+bool DataCache::Get(const string &path, DataFile &file) const
+{
+	auto it = entries.find(path);
+	if(it == entries.end())
+		return false;
+
+	const Entry &entry = it->second;
+	if(entry.size != Files::Size(path) || entry.timestamp != static_cast<int64_t>(Files::Timestamp(path)))
+		return false;
+
+	return file.Deserialize(entry.data);
+}
+
+
+
+// Note that the cached copy of the given file is still in use.
+void DataCache::Keep(const string &path)
+{
+	auto it = entries.find(path);
+	if(it != entries.end())
+		it->second.isUsed = true;
+}
+
+
+
+// Replace the cached copy of the given file.
+void DataCache::Set(const string &path, string data)
+{
+	// Files that cannot be found directly (such as Android assets) do not have
+	// a size or modification time to check against, so they are never cached.
+	int64_t size = Files::Size(path);
+	if(size < 0)
+		return;
+
+	Entry &entry = entries[path];
+	entry.timestamp = Files::Timestamp(path);
+	entry.size = size;
+	entry.data = std::move(data);
+	entry.isUsed = true;
+	isChanged = true;
+}
+
+
+
+// Save this cache, if anything in it has changed.
+void DataCache::Save()
+{
+	for(auto it = entries.begin(); it != entries.end(); )
+	{
+		if(it->second.isUsed)
+			++it;
+		else
+		{
+			it = entries.erase(it);
+			isChanged = true;
+		}
+	}
+	if(!isChanged)
+		return;
+
+	string out = HEADER;
+	Write(out, VERSION);
+	for(const auto &it : entries)
+	{
+		WriteString(out, it.first);
+		Write(out, it.second.timestamp);
+		Write(out, it.second.size);
+		WriteString(out, it.second.data);
+	}
+	Files::Write(path, out);
+	isChanged = false;
+}
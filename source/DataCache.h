@@ -0,0 +1,69 @@
+/* DataCache.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DATA_CACHE_H_
+#define DATA_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+class DataFile;
+
+
+
+// A cache of parsed data files, saved between runs so that data files that have
+// not changed do not need to be parsed again. Each file is identified by its
+// path, and its cached copy is only used if the file still has the same size
+// and modification time as when it was cached.
+class DataCache {
+public:
+	// Load the cache saved at the given path. If there is no valid cache there,
+	// this cache starts out empty.
+	explicit DataCache(const std::string &path);
+
+	// If this cache has an up to date copy of the given data file, load it into
+	// the given DataFile. This may be called from several threads at once.
+	bool Get(const std::string &path, DataFile &file) const;
+	// Note that the cached copy of the given file was used, so it should be kept.
+	void Keep(const std::string &path);
+	// Replace the cached copy of the given file with the given data, which must
+	// come from DataFile::Serialize().
+	void Set(const std::string &path, std::string data);
+
+	// Save this cache, if anything in it has changed. Any files that were not
+	// used or set since it was loaded are dropped from it.
+	void Save();
+
+
+private:
+	class Entry {
+	public:
+		int64_t timestamp = 0;
+		int64_t size = 0;
+		std::string data;
+		bool isUsed = false;
+	};
+
+
+private:
+	std::string path;
+	std::map<std::string, Entry> entries;
+	bool isChanged = false;
+};
+
+
+
+#endif
@@ -15,11 +15,39 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DataFile.h"
 
+#include "Compression.h"
 #include "Files.h"
 #include "text/Utf8.h"
 
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <utility>
+#include <vector>
+
 using namespace std;
 
+namespace {
+	// Nodes nested deeper than this are assumed to be from corrupt data.
+	const size_t MAX_DEPTH = 256;
+
+	void Write(string &out, uint32_t value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+
+
+	bool Read(const string &data, size_t &pos, uint32_t &value)
+	{
+		if(data.size() - pos < sizeof(value))
+			return false;
+		memcpy(&value, data.data() + pos, sizeof(value));
+		pos += sizeof(value);
+		return true;
+	}
+}
+
 
 
 // Constructor, taking a file path (in UTF-8).
@@ -42,6 +70,8 @@ DataFile::DataFile(istream &in)
 void DataFile::Load(const string &path)
 {
 	string data = Files::Read(path);
+	if(Compression::IsCompressed(data))
+		data = Compression::Decompress(data);
 	if(data.empty())
 		return;
 
@@ -71,6 +101,8 @@ void DataFile::Load(istream &in)
 		in.read(&*data.begin() + currentSize, BLOCK);
 		data.resize(currentSize + in.gcount());
 	}
+	if(Compression::IsCompressed(data))
+		data = Compression::Decompress(data);
 	// As a sentinel, make sure the file always ends in a newline.
 	if(data.empty() || data.back() != '\n')
 		data.push_back('\n');
@@ -96,6 +128,106 @@ list<DataNode>::const_iterator DataFile::end() const
 
 
 
+// Convert this file's nodes to a binary form.
+string DataFile::Serialize() const
+{
+	// Tokens are often repeated, so each distinct one is only stored once, in a
+	// table at the start of the output. The nodes follow, depth first. Each is
+	// written as its line number, its token count, the index of each of its
+	// tokens in the table, and the number of children it has.
+	map<string, uint32_t> strings;
+	string nodes;
+	vector<const DataNode *> stack(1, &root);
+	while(!stack.empty())
+	{
+		const DataNode &node = *stack.back();
+		stack.pop_back();
+
+		Write(nodes, node.lineNumber);
+		Write(nodes, node.tokens.size());
+		for(const string &token : node.tokens)
+			Write(nodes, strings.emplace(token, strings.size()).first->second);
+		Write(nodes, node.children.size());
+		// Push the children in reverse, so that the first one is written next.
+		for(auto it = node.children.rbegin(); it != node.children.rend(); ++it)
+			stack.push_back(&*it);
+	}
+
+	vector<const string *> table(strings.size());
+	for(const auto &it : strings)
+		table[it.second] = &it.first;
+
+	string out;
+	Write(out, table.size());
+	for(const string *token : table)
+	{
+		Write(out, token->size());
+		out += *token;
+	}
+	out += nodes;
+	return out;
+}
+
+
+
+// Replace this file's nodes with ones from the output of Serialize().
+bool DataFile::Deserialize(const string &data)
+{
+	root = DataNode();
+
+	size_t pos = 0;
+	uint32_t count = 0;
+	if(!Read(data, pos, count) || count > data.size())
+		return false;
+	vector<string> strings;
+	strings.reserve(count);
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		uint32_t length = 0;
+		if(!Read(data, pos, length) || data.size() - pos < length)
+			return false;
+		strings.emplace_back(data, pos, length);
+		pos += length;
+	}
+
+	// Read the nodes depth first, keeping track of the nodes that have not yet
+	// had all of their children read.
+	vector<pair<DataNode *, uint32_t>> stack;
+	DataNode *node = &root;
+	while(true)
+	{
+		uint32_t line = 0;
+		uint32_t tokens = 0;
+		if(!Read(data, pos, line) || !Read(data, pos, tokens) || tokens > data.size())
+			break;
+		node->lineNumber = line;
+		node->tokens.reserve(tokens);
+		uint32_t index = 0;
+		for(uint32_t i = 0; i < tokens && Read(data, pos, index) && index < strings.size(); ++i)
+			node->tokens.push_back(strings[index]);
+		node->ParseValues();
+		uint32_t children = 0;
+		if(node->tokens.size() != tokens || !Read(data, pos, children) || stack.size() >= MAX_DEPTH)
+			break;
+		stack.emplace_back(node, children);
+
+		// Move on to the next node that still needs to be read.
+		while(!stack.empty() && !stack.back().second)
+			stack.pop_back();
+		if(stack.empty())
+			return pos == data.size();
+		--stack.back().second;
+		DataNode *parent = stack.back().first;
+		parent->children.emplace_back(parent);
+		node = &parent->children.back();
+	}
+
+	root = DataNode();
+	return false;
+}
+
+
+
 // Parse the given text.
 void DataFile::LoadData(const string &data)
 {
@@ -107,6 +239,10 @@ void DataFile::LoadData(const string &data)
 	bool fileIsTabs = false;
 	bool fileIsSpaces = false;
 	size_t lineNumber = 0;
+	// The start and length of each token in the current line. Collecting these
+	// before creating any strings means each node's token vector can be
+	// allocated once, at exactly the right size.
+	vector<pair<size_t, size_t>> tokenRanges;
 
 	size_t end = data.length();
 	for(size_t pos = 0; pos < end; )
@@ -168,6 +304,8 @@ void DataFile::LoadData(const string &data)
 		separatorStack.push_back(separators);
 
 		// Tokenize the line. Skip comments and empty lines.
+		tokenRanges.clear();
+		bool missingQuote = false;
 		while(c != '\n')
 		{
 			// Check if this token begins with a quotation mark. If so, it will
@@ -189,16 +327,10 @@ void DataFile::LoadData(const string &data)
 				c = Utf8::DecodeCodePoint(data, pos);
 			}
 
-			// It ought to be legal to construct a string from an empty iterator
-			// range, but it appears that some libraries do not handle that case
-			// correctly. So:
-			if(tokenPos == endPos)
-				node.tokens.emplace_back();
-			else
-				node.tokens.emplace_back(data, tokenPos, endPos - tokenPos);
+			tokenRanges.emplace_back(tokenPos, endPos - tokenPos);
 			// This is not a fatal error, but it may indicate a format mistake:
 			if(isQuoted && c == '\n')
-				node.PrintTrace("Warning: Closing quotation mark is missing:");
+				missingQuote = true;
 
 			if(c != '\n')
 			{
@@ -224,10 +356,23 @@ void DataFile::LoadData(const string &data)
 				}
 			}
 		}
-		// Now that we've reached the end of the line, we know no more tokens will be added to the node.
-		node.tokens.shrink_to_fit();
+		// Now that we've reached the end of the line, we know how many tokens the node has.
+		node.tokens.reserve(tokenRanges.size());
+		for(const pair<size_t, size_t> &range : tokenRanges)
+		{
+			// It ought to be legal to construct a string from an empty iterator
+			// range, but it appears that some libraries do not handle that case
+			// correctly. So:
+			if(!range.second)
+				node.tokens.emplace_back();
+			else
+				node.tokens.emplace_back(data, range.first, range.second);
+		}
+		node.ParseValues();
 
-		// Now that we've tokenized this node, print any mixed whitespace warnings.
+		// Now that we've tokenized this node, print any warnings about it.
+		if(missingQuote)
+			node.PrintTrace("Warning: Closing quotation mark is missing:");
 		if(mixedIndentation)
 			node.PrintTrace("Warning: Mixed whitespace usage at line");
 	}
@@ -44,6 +44,12 @@ public:
 	std::list<DataNode>::const_iterator begin() const;
 	std::list<DataNode>::const_iterator end() const;
 
+	// Convert this file's nodes to and from a compact binary form, so that they
+	// can be cached without needing to be parsed again. Deserialize() returns
+	// false, leaving this file empty, if the given data is not valid.
+	std::string Serialize() const;
+	bool Deserialize(const std::string &data);
+
 
 private:
 	void LoadData(const std::string &data);
@@ -16,32 +16,76 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 
 #include "Logger.h"
+#include "MemoryStats.h"
 
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <limits>
 
 using namespace std;
 
+namespace {
+	// Parse a token that is already known to be a number.
+	double Parse(const char *it)
+	{
+		// Check for leading sign.
+		double sign = (*it == '-') ? -1. : 1.;
+		it += (*it == '-' || *it == '+');
+
+		// Digits before the decimal point.
+		int64_t value = 0;
+		while(*it >= '0' && *it <= '9')
+			value = (value * 10) + (*it++ - '0');
+
+		// Digits after the decimal point (if any).
+		int64_t power = 0;
+		if(*it == '.')
+		{
+			++it;
+			while(*it >= '0' && *it <= '9')
+			{
+				value = (value * 10) + (*it++ - '0');
+				--power;
+			}
+		}
+
+		// Exponent.
+		if(*it == 'e' || *it == 'E')
+		{
+			++it;
+			int64_t sign = (*it == '-') ? -1 : 1;
+			it += (*it == '-' || *it == '+');
+
+			int64_t exponent = 0;
+			while(*it >= '0' && *it <= '9')
+				exponent = (exponent * 10) + (*it++ - '0');
+
+			power += sign * exponent;
+		}
+
+		// Compose the return value.
+		return copysign(value * pow(10., power), sign);
+	}
+}
 
 
 // Construct a DataNode and remember what its parent is.
 DataNode::DataNode(const DataNode *parent) noexcept(false)
 	: parent(parent)
 {
-	// To avoid a lot of memory reallocation, have every node start out with
-	// capacity for four tokens. This makes file loading slightly faster, at the
-	// cost of DataFiles taking up a bit more memory.
-	tokens.reserve(4);
+	// No space is reserved for tokens here, because DataFile counts the tokens
+	// on each line before adding them, and reserves exactly as many as it needs.
 }
 
 
 
 // Copy constructor.
 DataNode::DataNode(const DataNode &other)
-	: children(other.children), tokens(other.tokens), lineNumber(other.lineNumber)
+	: children(other.children), tokens(other.tokens), values(other.values), lineNumber(other.lineNumber)
 {
 	Reparent();
+	MemoryStats::Add(MemoryStats::Category::DATA_NODES, Footprint());
 }
 
 
@@ -49,17 +93,21 @@ DataNode::DataNode(const DataNode &other)
 // Copy assignment operator.
 DataNode &DataNode::operator=(const DataNode &other)
 {
+	int64_t before = Footprint();
 	children = other.children;
 	tokens = other.tokens;
+	values = other.values;
 	lineNumber = other.lineNumber;
 	Reparent();
+	MemoryStats::Add(MemoryStats::Category::DATA_NODES, Footprint() - before);
 	return *this;
 }
 
 
 
 DataNode::DataNode(DataNode &&other) noexcept
-	: children(std::move(other.children)), tokens(std::move(other.tokens)), lineNumber(std::move(other.lineNumber))
+	: children(std::move(other.children)), tokens(std::move(other.tokens)), values(std::move(other.values)),
+	lineNumber(std::move(other.lineNumber))
 {
 	Reparent();
 }
@@ -70,6 +118,7 @@ DataNode &DataNode::operator=(DataNode &&other) noexcept
 {
 	children.swap(other.children);
 	tokens.swap(other.tokens);
+	values.swap(other.values);
 	lineNumber = std::move(other.lineNumber);
 	Reparent();
 	return *this;
@@ -77,6 +126,15 @@ DataNode &DataNode::operator=(DataNode &&other) noexcept
 
 
 
+// Moving a node hands its memory over along with its tokens, so only the
+// node that ends up holding them subtracts it again.
+DataNode::~DataNode()
+{
+	MemoryStats::Add(MemoryStats::Category::DATA_NODES, -Footprint());
+}
+
+
+
 // Get the number of tokens in this line of the data file.
 int DataNode::Size() const noexcept
 {
@@ -108,10 +166,10 @@ double DataNode::Value(int index) const
 	// Check for empty strings and out-of-bounds indices.
 	if(static_cast<size_t>(index) >= tokens.size() || tokens[index].empty())
 		PrintTrace("Error: Requested token index (" + to_string(index) + ") is out of bounds:");
-	else if(!IsNumber(tokens[index]))
+	else if(!IsNumber(index))
 		PrintTrace("Error: Cannot convert value \"" + tokens[index] + "\" to a number:");
 	else
-		return Value(tokens[index]);
+		return values.empty() ? Parse(tokens[index].c_str()) : values[index];
 
 	return 0.;
 }
@@ -127,45 +185,7 @@ double DataNode::Value(const string &token)
 		Logger::LogError("Cannot convert value \"" + token + "\" to a number.");
 		return 0.;
 	}
-	const char *it = token.c_str();
-
-	// Check for leading sign.
-	double sign = (*it == '-') ? -1. : 1.;
-	it += (*it == '-' || *it == '+');
-
-	// Digits before the decimal point.
-	int64_t value = 0;
-	while(*it >= '0' && *it <= '9')
-		value = (value * 10) + (*it++ - '0');
-
-	// Digits after the decimal point (if any).
-	int64_t power = 0;
-	if(*it == '.')
-	{
-		++it;
-		while(*it >= '0' && *it <= '9')
-		{
-			value = (value * 10) + (*it++ - '0');
-			--power;
-		}
-	}
-
-	// Exponent.
-	if(*it == 'e' || *it == 'E')
-	{
-		++it;
-		int64_t sign = (*it == '-') ? -1 : 1;
-		it += (*it == '-' || *it == '+');
-
-		int64_t exponent = 0;
-		while(*it >= '0' && *it <= '9')
-			exponent = (exponent * 10) + (*it++ - '0');
-
-		power += sign * exponent;
-	}
-
-	// Compose the return value.
-	return copysign(value * pow(10., power), sign);
+	return Parse(token.c_str());
 }
 
 
@@ -178,7 +198,7 @@ bool DataNode::IsNumber(int index) const
 	if(static_cast<size_t>(index) >= tokens.size() || tokens[index].empty())
 		return false;
 
-	return IsNumber(tokens[index]);
+	return values.empty() ? IsNumber(tokens[index]) : !std::isnan(values[index]);
 }
 
 
@@ -330,9 +350,39 @@ int DataNode::PrintTrace(const string &message) const
 // Adjust the parent pointers when a copy is made of a DataNode.
 void DataNode::Reparent() noexcept
 {
+	// Only the direct children need updating. When a node is copied, each of
+	// its children is copied too and has already fixed its own children, and
+	// moving the list of children does not move the nodes themselves.
 	for(DataNode &child : children)
-	{
 		child.parent = this;
-		child.Reparent();
-	}
+}
+
+
+
+void DataNode::ParseValues()
+{
+	int64_t before = Footprint();
+	values.clear();
+	values.reserve(tokens.size());
+	for(const string &token : tokens)
+		values.push_back((token.empty() || !IsNumber(token))
+			? numeric_limits<double>::quiet_NaN() : Parse(token.c_str()));
+	MemoryStats::Add(MemoryStats::Category::DATA_NODES, Footprint() - before);
+}
+
+
+
+int64_t DataNode::Footprint() const noexcept
+{
+	if(values.empty())
+		return 0;
+
+	// Each node is allocated as one element of its parent's list.
+	size_t bytes = sizeof(DataNode) + 2 * sizeof(void *);
+	bytes += tokens.capacity() * sizeof(string) + values.capacity() * sizeof(double);
+	// Short strings are usually stored inside the string object itself.
+	for(const string &token : tokens)
+		if(token.capacity() >= sizeof(string))
+			bytes += token.capacity() + 1;
+	return bytes;
 }
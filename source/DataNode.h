@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef DATA_NODE_H_
 #define DATA_NODE_H_
 
+#include <cstdint>
 #include <list>
 #include <string>
 #include <vector>
@@ -38,6 +39,7 @@ public:
 	DataNode &operator=(const DataNode &other);
 	DataNode(DataNode &&) noexcept;
 	DataNode &operator=(DataNode &&) noexcept;
+	~DataNode();
 
 	// Get the number of tokens in this node.
 	int Size() const noexcept;
@@ -76,6 +78,12 @@ public:
 private:
 	// Adjust the parent pointers when a copy is made of a DataNode.
 	void Reparent() noexcept;
+	// Convert every token that is a number, so that Value() does not have to
+	// parse the same token again each time it is called.
+	void ParseValues();
+	// Estimate the memory this node uses, not counting its children. Only nodes
+	// whose values have been parsed are counted in the memory statistics.
+	int64_t Footprint() const noexcept;
 
 
 private:
@@ -83,6 +91,9 @@ private:
 	std::list<DataNode> children;
 	// These are the tokens found in this particular line of the data file.
 	std::vector<std::string> tokens;
+	// The numeric value of each token, or NaN if it is not a number. This is
+	// either empty or the same size as the tokens.
+	std::vector<double> values;
 	// The parent pointer is used only for printing stack traces.
 	const DataNode *parent = nullptr;
 	// The line number in the given file that produced this node.
@@ -18,8 +18,40 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "Files.h"
 
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
 using namespace std;
 
+namespace {
+	// How a character affects the quoting of a token that contains it.
+	enum CharacterClass : char {PLAIN, SPACE, QUOTE};
+
+	// Classify every character once, rather than each time a token is written.
+	// The spaces are the characters isspace() matches in the "C" locale.
+	class CharacterClasses {
+	public:
+		CharacterClasses()
+		{
+			for(char c : {' ', '\t', '\n', '\v', '\f', '\r'})
+				classes[static_cast<unsigned char>(c)] = SPACE;
+			classes[static_cast<unsigned char>('"')] = QUOTE;
+		}
+
+		CharacterClass operator[](char c) const { return classes[static_cast<unsigned char>(c)]; }
+
+	private:
+		CharacterClass classes[256] = {};
+	};
+
+	const CharacterClasses CHARACTER_CLASSES;
+
+	// Doubles that hold whole numbers with at most this many digits are the
+	// same when printed as integers as they would be with a precision of 8.
+	const double EXACT_INTEGER_LIMIT = 1e8;
+}
+
 
 
 // This string constant is just used for remembering what string needs to be
@@ -41,7 +73,6 @@ DataWriter::DataWriter(const string &path)
 DataWriter::DataWriter()
 	: before(&indent)
 {
-	out.precision(8);
 }
 
 
@@ -58,7 +89,15 @@ DataWriter::~DataWriter()
 // Save the contents to a file.
 void DataWriter::SaveToPath(const std::string &filepath)
 {
-	Files::Write(filepath, out.str());
+	Files::Write(filepath, out);
+}
+
+
+
+// Get the contents written so far.
+string DataWriter::Contents() const
+{
+	return out;
 }
 
 
@@ -68,7 +107,7 @@ void DataWriter::Write(const DataNode &node)
 {
 	// Write all this node's tokens.
 	for(int i = 0; i < node.Size(); ++i)
-		WriteToken(node.Token(i).c_str());
+		WriteToken(node.Token(i));
 	Write();
 
 	// If this node has any children, call this function recursively on them.
@@ -88,7 +127,7 @@ void DataWriter::Write(const DataNode &node)
 // Begin a new line of the file.
 void DataWriter::Write()
 {
-	out << '\n';
+	out += '\n';
 	before = &indent;
 }
 
@@ -113,7 +152,17 @@ void DataWriter::EndChild()
 // Write a comment line, at the current indentation level.
 void DataWriter::WriteComment(const string &str)
 {
-	out << indent << "# " << str << '\n';
+	out += indent;
+	out += "# ";
+	out += str;
+	out += '\n';
+}
+
+
+
+void DataWriter::Append(const string &contents)
+{
+	out += contents;
 }
 
 
@@ -121,27 +170,126 @@ void DataWriter::WriteComment(const string &str)
 // Write a token, given as a character string.
 void DataWriter::WriteToken(const char *a)
 {
-	WriteToken(string(a));
+	WriteToken(a, strlen(a));
 }
 
 
 
 // Write a token, given as a string object.
 void DataWriter::WriteToken(const string &a)
+{
+	WriteToken(a.data(), a.size());
+}
+
+
+
+void DataWriter::WriteToken(const char *a, size_t size)
 {
 	// Figure out what kind of quotation marks need to be used for this string.
-	bool hasSpace = any_of(a.begin(), a.end(), [](char c) { return isspace(c); });
-	bool hasQuote = any_of(a.begin(), a.end(), [](char c) { return (c == '"'); });
+	bool hasSpace = false;
+	bool hasQuote = false;
+	for(const char *it = a; it != a + size; ++it)
+	{
+		CharacterClass type = CHARACTER_CLASSES[*it];
+		hasSpace |= (type == SPACE);
+		hasQuote |= (type == QUOTE);
+	}
 	// Write the token, enclosed in quotes if necessary.
-	out << *before;
+	out += *before;
 	if(hasQuote)
-		out << '`' << a << '`';
+		out += '`';
 	else if(hasSpace)
-		out << '"' << a << '"';
-	else
-		out << a;
+		out += '"';
+	out.append(a, size);
+	if(hasQuote)
+		out += '`';
+	else if(hasSpace)
+		out += '"';
 
 	// The next token written will not be the first one on this line, so it only
 	// needs to have a single space before it.
 	before = &space;
 }
+
+
+
+void DataWriter::WriteNumber(bool value)
+{
+	out += (value ? '1' : '0');
+}
+
+
+
+// Characters are written as they are, not as numbers.
+void DataWriter::WriteNumber(char value)
+{
+	out += value;
+}
+
+
+
+void DataWriter::WriteNumber(signed char value)
+{
+	out += static_cast<char>(value);
+}
+
+
+
+void DataWriter::WriteNumber(unsigned char value)
+{
+	out += static_cast<char>(value);
+}
+
+
+
+void DataWriter::WriteNumber(long long value)
+{
+	if(value < 0)
+	{
+		out += '-';
+		WriteNumber(0ull - static_cast<unsigned long long>(value));
+	}
+	else
+		WriteNumber(static_cast<unsigned long long>(value));
+}
+
+
+
+void DataWriter::WriteNumber(unsigned long long value)
+{
+	char buffer[24];
+	char *end = buffer + sizeof(buffer);
+	char *it = end;
+	do {
+		*--it = static_cast<char>('0' + value % 10);
+		value /= 10;
+	} while(value);
+	out.append(it, end);
+}
+
+
+
+void DataWriter::WriteNumber(double value)
+{
+	// Most numbers in the game's data are whole, and those can be written
+	// without going through printf.
+	if(value < EXACT_INTEGER_LIMIT && value > -EXACT_INTEGER_LIMIT && value == trunc(value)
+			&& (value || !signbit(value)))
+	{
+		WriteNumber(static_cast<long long>(value));
+		return;
+	}
+
+	char buffer[32];
+	int length = snprintf(buffer, sizeof(buffer), "%.8g", value);
+	out.append(buffer, max(0, length));
+}
+
+
+
+void DataWriter::WriteNumber(long double value)
+{
+	char buffer[64];
+	int length = snprintf(buffer, sizeof(buffer), "%.8Lg", value);
+	out.append(buffer, max(0, length));
+}
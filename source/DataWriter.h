@@ -18,8 +18,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <map>
-#include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 class DataNode;
@@ -47,6 +47,8 @@ public:
 
 	// Save the contents to a file.
 	void SaveToPath(const std::string &path);
+	// Get everything that has been written so far.
+	std::string Contents() const;
 
 	// The Write() function can take any number of arguments. Each argument is
 	// converted to a token. Arguments may be strings or numeric values.
@@ -67,6 +69,10 @@ public:
 	// Write a comment. It will be at the current indentation level, and will
 	// have "# " inserted before it.
 	void WriteComment(const std::string &str);
+	// Write text that another DataWriter composed, e.g. to reuse it instead of
+	// writing the same data again. The text is not indented any further, so
+	// this writer must be at the start of a top-level line.
+	void Append(const std::string &contents);
 
 	// Write a token, without writing a whole line. Use this very carefully.
 	void WriteToken(const char *a);
@@ -76,6 +82,23 @@ public:
 	void WriteToken(const A &a);
 
 
+private:
+	// Write a token that may need to be quoted.
+	void WriteToken(const char *a, size_t size);
+	// Format numbers the same way that a stream with a precision of 8 would.
+	void WriteNumber(bool value);
+	void WriteNumber(char value);
+	void WriteNumber(signed char value);
+	void WriteNumber(unsigned char value);
+	void WriteNumber(long long value);
+	void WriteNumber(unsigned long long value);
+	void WriteNumber(double value);
+	void WriteNumber(long double value);
+	// Other integers are written as the widest integer of the same signedness.
+	template <class A>
+	void WriteNumber(A value);
+
+
 private:
 	// Save path (in UTF-8). Empty string for in-memory DataWriter.
 	std::string path;
@@ -88,7 +111,7 @@ private:
 	// "indent" for the first token in a line and "space" for subsequent tokens.
 	const std::string *before;
 	// Compose the output in memory before writing it to file.
-	std::ostringstream out;
+	std::string out;
 };
 
 
@@ -111,12 +134,26 @@ void DataWriter::WriteToken(const A &a)
 	static_assert(std::is_arithmetic<A>::value,
 		"DataWriter cannot output anything but strings and arithmetic types.");
 
-	out << *before << a;
+	out += *before;
+	WriteNumber(a);
 	before = &space;
 }
 
 
 
+template <class A>
+void DataWriter::WriteNumber(A value)
+{
+	if(std::is_floating_point<A>::value)
+		WriteNumber(static_cast<double>(value));
+	else if(std::is_signed<A>::value)
+		WriteNumber(static_cast<long long>(value));
+	else
+		WriteNumber(static_cast<unsigned long long>(value));
+}
+
+
+
 // Encapsulate the logic for writing the contents of a collection in a sorted manner. The caller
 // should provide a sorting method; it will be called with pointers to the type of the container.
 // The provided write method will be called for each element of the container.
@@ -34,6 +34,29 @@ namespace {
 	constexpr double DAILY_DEPRECIATION = 0.997;
 	constexpr int GRACE_PERIOD = 7;
 	constexpr int MAX_AGE = 1000 + GRACE_PERIOD;
+
+	// The value fraction of an item of each age from 0 to MAX_AGE. These only
+	// depend on the age, so they are calculated once.
+	const vector<double> &AgeTable()
+	{
+		static const vector<double> table = []()
+		{
+			vector<double> result(MAX_AGE + 1, FULL_DEPRECIATION);
+			for(int age = 0; age < MAX_AGE; ++age)
+			{
+				if(age <= GRACE_PERIOD)
+					result[age] = 1.;
+				else
+				{
+					double daily = pow(DAILY_DEPRECIATION, age - GRACE_PERIOD);
+					double linear = static_cast<double>(MAX_AGE - age) / (MAX_AGE - GRACE_PERIOD);
+					result[age] = FULL_DEPRECIATION + (1. - FULL_DEPRECIATION) * daily * linear;
+				}
+			}
+			return result;
+		}();
+		return table;
+	}
 }
 
 
@@ -52,6 +75,7 @@ void Depreciation::Load(const DataNode &node)
 	// Check if this is fleet or stock depreciation.
 	isStock = (node.Token(0) == NAME[1]);
 	isLoaded = true;
+	ForgetValues();
 
 	for(const DataNode &child : node)
 	{
@@ -133,6 +157,7 @@ void Depreciation::Init(const vector<shared_ptr<Ship>> &fleet, int day)
 {
 	// If this is called, this is a player's fleet, not a planet's stock.
 	isStock = false;
+	ForgetValues();
 	// Every ship and outfit in the given fleet starts out with no depreciation.
 	for(const shared_ptr<Ship> &ship : fleet)
 	{
@@ -176,6 +201,7 @@ void Depreciation::Buy(const Ship &ship, int day, Depreciation *source)
 
 	// Increment our count for this ship on this day.
 	++ships[base][day];
+	ForgetValues();
 }
 
 
@@ -206,6 +232,7 @@ void Depreciation::Buy(const Outfit *outfit, int day, Depreciation *source)
 
 	// Increment our count for this outfit on this day.
 	++outfits[outfit][day];
+	ForgetValues();
 }
 
 
@@ -252,11 +279,17 @@ int64_t Depreciation::Value(const Ship *ship, int day, int count) const
 	// Check whether a record exists for this ship. If not, its value is full
 	// if this is  planet's stock, or fully depreciated if this is the player.
 	ship = GameData::Ships().Get(ship->ModelName());
+	CheckDay(day);
+	auto valueIt = shipValues.emplace(make_pair(ship, count), 0);
+	if(!valueIt.second)
+		return valueIt.first->second;
+
 	auto recordIt = ships.find(ship);
 	if(recordIt == ships.end() || recordIt->second.empty())
-		return DefaultDepreciation() * count * ship->ChassisCost();
-
-	return Depreciate(recordIt->second, day, count) * ship->ChassisCost();
+		valueIt.first->second = DefaultDepreciation() * count * ship->ChassisCost();
+	else
+		valueIt.first->second = Depreciate(recordIt->second, day, count) * ship->ChassisCost();
+	return valueIt.first->second;
 }
 
 
@@ -269,11 +302,17 @@ int64_t Depreciation::Value(const Outfit *outfit, int day, int count) const
 
 	// Check whether a record exists for this outfit. If not, its value is full
 	// if this is  planet's stock, or fully depreciated if this is the player.
+	CheckDay(day);
+	auto valueIt = outfitValues.emplace(make_pair(outfit, count), 0);
+	if(!valueIt.second)
+		return valueIt.first->second;
+
 	auto recordIt = outfits.find(outfit);
 	if(recordIt == outfits.end() || recordIt->second.empty())
-		return DefaultDepreciation() * count * outfit->Cost();
-
-	return Depreciate(recordIt->second, day, count) * outfit->Cost();
+		valueIt.first->second = DefaultDepreciation() * count * outfit->Cost();
+	else
+		valueIt.first->second = Depreciate(recordIt->second, day, count) * outfit->Cost();
+	return valueIt.first->second;
 }
 
 
@@ -288,6 +327,7 @@ int Depreciation::Sell(map<int, int> &record)
 
 	// Remove one record from the source. If necessary, delete this
 	// record line or the entire record for this outfit.
+	ForgetValues();
 	--it->second;
 	if(!it->second)
 		record.erase(it);
@@ -348,9 +388,7 @@ double Depreciation::Depreciate(int age) const
 	if(age >= MAX_AGE)
 		return FULL_DEPRECIATION;
 
-	double daily = pow(DAILY_DEPRECIATION, age - GRACE_PERIOD);
-	double linear = static_cast<double>(MAX_AGE - age) / (MAX_AGE - GRACE_PERIOD);
-	return FULL_DEPRECIATION + (1. - FULL_DEPRECIATION) * daily * linear;
+	return AgeTable()[age];
 }
 
 
@@ -361,3 +399,24 @@ double Depreciation::DefaultDepreciation() const
 {
 	return (isStock ? 1. : FULL_DEPRECIATION);
 }
+
+
+
+// Forget the remembered values, because the records have changed.
+void Depreciation::ForgetValues() const
+{
+	shipValues.clear();
+	outfitValues.clear();
+}
+
+
+
+// Forget the remembered values if they were for a different day.
+void Depreciation::CheckDay(int day) const
+{
+	if(day == valueDay)
+		return;
+
+	ForgetValues();
+	valueDay = day;
+}
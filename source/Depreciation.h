@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 class DataNode;
@@ -73,6 +74,10 @@ private:
 	// Depreciation of an item for which no record exists. If buying, items
 	// default to no depreciation. When selling, they default to full.
 	double DefaultDepreciation() const;
+	// Forget the remembered values, because the records changed, or because
+	// they were for a different day than the given one.
+	void ForgetValues() const;
+	void CheckDay(int day) const;
 
 
 private:
@@ -86,6 +91,12 @@ private:
 
 	std::map<const Ship *, std::map<int, int>> ships;
 	std::map<const Outfit *, std::map<int, int>> outfits;
+
+	// Shops ask for the same values every frame, so remember the value of each
+	// number of each item for the day they were calculated for.
+	mutable int valueDay = 0;
+	mutable std::map<std::pair<const Ship *, int>, int64_t> shipValues;
+	mutable std::map<std::pair<const Outfit *, int>, int64_t> outfitValues;
 };
 
 
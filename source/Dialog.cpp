@@ -112,6 +112,14 @@ Dialog::Dialog(const string &text, PlayerInfo &player, const System *system, Tru
 
 
 
+// A dialog only changes when the player types or clicks on it.
+bool Dialog::IsAnimated() const noexcept
+{
+	return false;
+}
+
+
+
 // Draw this panel.
 void Dialog::Draw()
 {
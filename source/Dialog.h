@@ -75,6 +75,7 @@ public:
 
 	// Draw this panel.
 	virtual void Draw() override;
+	virtual bool IsAnimated() const noexcept override;
 
 	// Static method used to convert a DataNode into formatted Dialog text.
 	static void ParseTextNode(const DataNode &node, size_t startingIndex, std::string &text);
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Dictionary.h"
 
+#include <algorithm>
 #include <cstring>
 #include <mutex>
 #include <set>
@@ -23,6 +24,170 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
+	// The names of the attribute keys, in the same order as the enum.
+	const char *const KEY_NAMES[] = {
+		"absolute threshold",
+		"active cooling",
+		"afterburner burn",
+		"afterburner corrosion",
+		"afterburner discharge",
+		"afterburner disruption",
+		"afterburner energy",
+		"afterburner fuel",
+		"afterburner heat",
+		"afterburner hull",
+		"afterburner ion",
+		"afterburner leakage",
+		"afterburner scramble",
+		"afterburner shields",
+		"afterburner slowing",
+		"afterburner thrust",
+		"asteroid scan power",
+		"atmosphere scan",
+		"automaton",
+		"bunks",
+		"burn protection",
+		"burn resistance",
+		"burn resistance energy",
+		"burn resistance fuel",
+		"burn resistance heat",
+		"cargo scan efficiency",
+		"cargo scan power",
+		"cargo space",
+		"cloak",
+		"cloaking energy",
+		"cloaking fuel",
+		"cloaking heat",
+		"cooling",
+		"cooling energy",
+		"cooling inefficiency",
+		"corrosion protection",
+		"corrosion resistance",
+		"corrosion resistance energy",
+		"corrosion resistance fuel",
+		"corrosion resistance heat",
+		"crew equivalent",
+		"depleted shield delay",
+		"disabled repair delay",
+		"discharge protection",
+		"discharge resistance",
+		"discharge resistance energy",
+		"discharge resistance fuel",
+		"discharge resistance heat",
+		"disruption protection",
+		"disruption resistance",
+		"disruption resistance energy",
+		"disruption resistance fuel",
+		"disruption resistance heat",
+		"drag",
+		"drag reduction",
+		"energy capacity",
+		"energy consumption",
+		"energy generation",
+		"energy protection",
+		"flotsam chance",
+		"force protection",
+		"fuel capacity",
+		"fuel consumption",
+		"fuel energy",
+		"fuel generation",
+		"fuel heat",
+		"fuel protection",
+		"heat capacity",
+		"heat dissipation",
+		"heat generation",
+		"heat protection",
+		"high shield permeability",
+		"hull",
+		"hull energy",
+		"hull energy multiplier",
+		"hull fuel",
+		"hull fuel multiplier",
+		"hull heat",
+		"hull heat multiplier",
+		"hull protection",
+		"hull repair multiplier",
+		"hull repair rate",
+		"hull threshold",
+		"hyperdrive",
+		"inertia reduction",
+		"inscrutable",
+		"ion protection",
+		"ion resistance",
+		"ion resistance energy",
+		"ion resistance fuel",
+		"ion resistance heat",
+		"jump drive",
+		"jump speed",
+		"landing speed",
+		"leak protection",
+		"leak resistance",
+		"leak resistance energy",
+		"leak resistance fuel",
+		"leak resistance heat",
+		"low shield permeability",
+		"outfit scan efficiency",
+		"outfit scan power",
+		"outfit space",
+		"overheat damage rate",
+		"overheat damage threshold",
+		"piercing protection",
+		"piercing resistance",
+		"ramscoop",
+		"repair delay",
+		"required crew",
+		"reverse thrust",
+		"scram drive",
+		"scramble protection",
+		"scramble resistance",
+		"scramble resistance energy",
+		"scramble resistance fuel",
+		"scramble resistance heat",
+		"self destruct",
+		"shield delay",
+		"shield energy",
+		"shield energy multiplier",
+		"shield fuel",
+		"shield fuel multiplier",
+		"shield generation",
+		"shield generation multiplier",
+		"shield heat",
+		"shield heat multiplier",
+		"shield protection",
+		"shields",
+		"slowing protection",
+		"slowing resistance",
+		"slowing resistance energy",
+		"slowing resistance fuel",
+		"slowing resistance heat",
+		"solar collection",
+		"solar heat",
+		"threshold percentage",
+		"thrust",
+		"thrusting energy",
+		"turn",
+		"turning burn",
+		"turning corrosion",
+		"turning discharge",
+		"turning disruption",
+		"turning energy",
+		"turning fuel",
+		"turning heat",
+		"turning hull",
+		"turning ion",
+		"turning leakage",
+		"turning scramble",
+		"turning shields",
+		"turning slowing",
+		"turret mounts",
+	};
+	static_assert(sizeof(KEY_NAMES) / sizeof(KEY_NAMES[0]) == static_cast<size_t>(AttributeKey::COUNT),
+		"Every attribute key must have a name.");
+
+	const char *const *const KEY_NAMES_END = KEY_NAMES + static_cast<size_t>(AttributeKey::COUNT);
+
+
+
 	// Perform a binary search on a sorted vector. Return the key's location (or
 	// proper insertion spot) in the first element of the pair, and "true" in
 	// the second element if the key is already in the vector.
@@ -62,12 +227,28 @@ namespace {
 
 
 
+Dictionary::Dictionary()
+{
+	keyIndex.fill(-1);
+}
+
+
+
 double &Dictionary::operator[](const char *key)
 {
 	pair<size_t, bool> pos = Search(key, *this);
 	if(pos.second)
 		return data()[pos.first].second;
 
+	// Every key after the new one is about to move over by one.
+	for(int16_t &index : keyIndex)
+		if(index >= static_cast<int>(pos.first))
+			++index;
+	auto it = lower_bound(KEY_NAMES, KEY_NAMES_END, key,
+		[](const char *a, const char *b) -> bool { return strcmp(a, b) < 0; });
+	if(it != KEY_NAMES_END && !strcmp(*it, key))
+		keyIndex[it - KEY_NAMES] = static_cast<int16_t>(pos.first);
+
 	return insert(begin() + pos.first, make_pair(Intern(key), 0.))->second;
 }
 
@@ -92,3 +273,18 @@ double Dictionary::Get(const string &key) const
 {
 	return Get(key.c_str());
 }
+
+
+
+double Dictionary::Get(AttributeKey key) const
+{
+	int index = keyIndex[static_cast<size_t>(key)];
+	return (index < 0 ? 0. : data()[index].second);
+}
+
+
+
+const char *Dictionary::Name(AttributeKey key)
+{
+	return KEY_NAMES[static_cast<size_t>(key)];
+}
@@ -16,6 +16,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef DICTIONARY_H_
 #define DICTIONARY_H_
 
+#include "AttributeKey.h"
+
+#include <array>
+#include <cstdint>
 #include <string>
 #include <utility>
 #include <vector>
@@ -25,20 +29,33 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // This class stores a mapping from character string keys to values, in a way
 // that prioritizes fast lookup time at the expense of longer construction time
 // compared to an STL map. That makes it suitable for ship attributes, which are
-// changed much less frequently than they are queried.
+// changed much less frequently than they are queried. The most common keys
+// can also be looked up by their AttributeKey, which takes constant time.
 class Dictionary : private std::vector<std::pair<const char *, double>> {
 public:
+	Dictionary();
+
 	// Access a key for modifying it:
 	double &operator[](const char *key);
 	double &operator[](const std::string &key);
 	// Get the value of a key, or 0 if it does not exist:
 	double Get(const char *key) const;
 	double Get(const std::string &key) const;
+	double Get(AttributeKey key) const;
+
+	// Get the name of the given attribute key.
+	static const char *Name(AttributeKey key);
 
 	// Expose certain functions from the underlying vector:
 	using std::vector<std::pair<const char *, double>>::empty;
 	using std::vector<std::pair<const char *, double>>::begin;
 	using std::vector<std::pair<const char *, double>>::end;
+
+
+private:
+	// The index of each of the attribute keys in the vector, or -1 if that key
+	// is not in this dictionary.
+	std::array<int16_t, static_cast<size_t>(AttributeKey::COUNT)> keyIndex;
 };
 
 
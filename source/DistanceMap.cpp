@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DistanceMap.h"
 
+#include "GameData.h"
 #include "Planet.h"
 #include "PlayerInfo.h"
 #include "Ship.h"
@@ -23,10 +24,159 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "System.h"
 #include "Wormhole.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
 using namespace std;
 
 
 
+// The best paths found so far, in arrays indexed by System::Index(), and the
+// heap of paths still to be explored. Searches on the same thread reuse these
+// buffers, so that they do not need to allocate anything once they are warm.
+class DistanceMap::Scratch {
+public:
+	// Prepare for a new search.
+	void Start();
+	// Get the best path found so far to the given system, or null.
+	Edge *Find(const System &system);
+	// Record a better path to the given system.
+	void Set(const System &system, const Edge &edge);
+
+
+public:
+	// Whether a search is currently using these buffers.
+	bool inUse = false;
+	// The systems to which a path has been found, in the order they were reached.
+	vector<const System *> reached;
+	// Paths to explore, as a max-heap (see Edge::operator<).
+	vector<Edge> heap;
+
+
+private:
+	// A system's entry in "best" is only valid if its stamp is this search's.
+	vector<Edge> best;
+	vector<uint32_t> stamp;
+	uint32_t generation = 0;
+};
+
+
+
+// The longest hyperspace link and system jump range in the universe, and where
+// the wormholes are and lead, as of one revision of the universe.
+class DistanceMap::Reach {
+public:
+	// One way through a wormhole from the system it is seen in.
+	class WormholeLink {
+	public:
+		const Planet *planet;
+		// Where the wormhole leads from this system, and the system that it
+		// leads here from (for searches that travel in reverse).
+		const System *to;
+		const System *from;
+		bool isUnrestricted;
+	};
+
+
+public:
+	uint64_t revision = 0;
+	double linkLength = 0.;
+	double jumpRange = 0.;
+	// Wormholes can take ships anywhere for free, so a route may cost no more
+	// fuel than it takes to reach the nearest of them.
+	vector<Point> wormholes;
+	// The wormholes in each system, indexed by System::Index(), so that
+	// searches do not need to look through every system's objects.
+	vector<vector<WormholeLink>> wormholeLinks;
+};
+
+
+
+namespace {
+	// Right now thread_local storage is only supported under Linux, so
+	// elsewhere each search allocates its own buffers.
+	template <class T>
+	T *SharedScratch()
+	{
+#ifdef __linux__
+		thread_local T scratch;
+		return &scratch;
+#else
+		return nullptr;
+#endif
+	}
+
+	// Get how far a single step may reach in the universe in its current state.
+	template <class T>
+	shared_ptr<const T> CurrentReach()
+	{
+		static mutex reachMutex;
+		static shared_ptr<const T> current;
+		lock_guard<mutex> lock(reachMutex);
+
+		uint64_t revision = GameData::UniverseRevision();
+		if(current && current->revision == revision)
+			return current;
+
+		auto reach = make_shared<T>();
+		reach->revision = revision;
+		reach->wormholeLinks.resize(System::IndexCount());
+		for(const auto &it : GameData::Systems())
+		{
+			const System &system = it.second;
+			for(const System *link : system.Links())
+				reach->linkLength = max(reach->linkLength, system.Position().Distance(link->Position()));
+			reach->jumpRange = max(reach->jumpRange, system.JumpRange());
+			bool hasWormhole = false;
+			for(const StellarObject &object : system.Objects())
+				if(object.HasValidPlanet() && object.GetPlanet()->IsWormhole())
+				{
+					const Planet *planet = object.GetPlanet();
+					if(!hasWormhole)
+						reach->wormholes.push_back(system.Position());
+					hasWormhole = true;
+					if(object.HasSprite() && system.Index() < reach->wormholeLinks.size())
+						reach->wormholeLinks[system.Index()].push_back({planet,
+							&planet->GetWormhole()->WormholeDestination(system),
+							&planet->GetWormhole()->WormholeSource(system),
+							planet->IsUnrestricted()});
+				}
+		}
+		current = std::move(reach);
+		return current;
+	}
+}
+
+
+
+// Copy what the given ship is capable of when it travels.
+DistanceMap::Traveler::Traveler(const Ship &ship)
+	: system(ship.GetSystem()), hyperspaceFuel(ship.JumpNavigation().HyperdriveFuel()),
+	jumpFuel(ship.JumpNavigation().JumpDriveFuel()), jumpRange(ship.JumpNavigation().JumpRange())
+{
+	for(const auto &it : GameData::Wormholes())
+	{
+		const Planet *planet = it.second.GetPlanet();
+		if(planet && !planet->IsAccessible(&ship))
+			inaccessibleWormholes.push_back(planet);
+	}
+	sort(inaccessibleWormholes.begin(), inaccessibleWormholes.end());
+}
+
+
+
+bool DistanceMap::Traveler::operator<(const Traveler &other) const
+{
+	return tie(system, hyperspaceFuel, jumpFuel, jumpRange, inaccessibleWormholes)
+		< tie(other.system, other.hyperspaceFuel, other.jumpFuel, other.jumpRange, other.inaccessibleWormholes);
+}
+
+
+
 // Find paths to the given system. If the given maximum count is above zero,
 // it is a limit on how many systems should be returned. If it is below zero
 // it specifies the maximum distance away that paths should be found.
@@ -70,7 +220,8 @@ DistanceMap::DistanceMap(const PlayerInfo &player, const System *center)
 	else
 		this->center = center;
 
-	Init(player.Flagship());
+	const Traveler traveler(*player.Flagship());
+	Init(&traveler);
 }
 
 
@@ -84,7 +235,20 @@ DistanceMap::DistanceMap(const Ship &ship, const System *destination)
 	if(!source || !destination)
 		return;
 
-	Init(&ship);
+	const Traveler traveler(ship);
+	Init(&traveler);
+}
+
+
+
+// Calculate the same path for a ship with the given capabilities.
+DistanceMap::DistanceMap(const Traveler &traveler, const System *destination)
+	: source(traveler.system), center(destination)
+{
+	if(!source || !destination)
+		return;
+
+	Init(&traveler);
 }
 
 
@@ -92,7 +256,7 @@ DistanceMap::DistanceMap(const Ship &ship, const System *destination)
 // Find out if the given system is reachable.
 bool DistanceMap::HasRoute(const System *system) const
 {
-	return route.count(system);
+	return Find(system);
 }
 
 
@@ -100,8 +264,8 @@ bool DistanceMap::HasRoute(const System *system) const
 // Find out how many days away the given system is.
 int DistanceMap::Days(const System *system) const
 {
-	auto it = route.find(system);
-	return (it == route.end() ? -1 : it->second.days);
+	const Edge *edge = Find(system);
+	return (edge ? edge->days : -1);
 }
 
 
@@ -109,8 +273,8 @@ int DistanceMap::Days(const System *system) const
 // Starting in the given system, what is the next system along the route?
 const System *DistanceMap::Route(const System *system) const
 {
-	auto it = route.find(system);
-	return (it == route.end() ? nullptr : it->second.next);
+	const Edge *edge = Find(system);
+	return (edge ? edge->next : nullptr);
 }
 
 
@@ -120,12 +284,19 @@ set<const System *> DistanceMap::Systems() const
 {
 	set<const System *> systems;
 	for(const auto &it : route)
-		systems.insert(it.first);
+		systems.insert(systems.end(), it.first);
 	return systems;
 }
 
 
 
+size_t DistanceMap::Size() const
+{
+	return route.size();
+}
+
+
+
 // Return the destination system - the 'center' system.
 const System *DistanceMap::End() const
 {
@@ -136,11 +307,11 @@ const System *DistanceMap::End() const
 
 int DistanceMap::RequiredFuel(const System *system1, const System *system2) const
 {
-	auto it1 = route.find(system1);
-	auto it2 = route.find(system2);
-	if(it1 == route.end() || it2 == route.end())
+	const Edge *edge1 = Find(system1);
+	const Edge *edge2 = Find(system2);
+	if(!edge1 || !edge2)
 		return -1;
-	return abs(it1->second.fuel - it2->second.fuel);
+	return abs(edge1->fuel - edge2->fuel);
 }
 
 
@@ -168,25 +339,93 @@ bool DistanceMap::Edge::operator<(const Edge &other) const
 
 
 
+void DistanceMap::Scratch::Start()
+{
+	size_t count = System::IndexCount();
+	if(stamp.size() < count)
+	{
+		stamp.resize(count);
+		best.resize(count);
+	}
+	// Once the generation wraps around, old stamps could match it again.
+	if(!++generation)
+	{
+		fill(stamp.begin(), stamp.end(), 0);
+		generation = 1;
+	}
+	reached.clear();
+	heap.clear();
+}
+
+
+
+DistanceMap::Edge *DistanceMap::Scratch::Find(const System &system)
+{
+	size_t index = system.Index();
+	return (index < stamp.size() && stamp[index] == generation) ? &best[index] : nullptr;
+}
+
+
+
+void DistanceMap::Scratch::Set(const System &system, const Edge &edge)
+{
+	size_t index = system.Index();
+	if(index >= stamp.size())
+	{
+		stamp.resize(index + 1);
+		best.resize(index + 1);
+	}
+	if(stamp[index] != generation)
+	{
+		stamp[index] = generation;
+		reached.push_back(&system);
+	}
+	best[index] = edge;
+}
+
+
+
+// Get the best path found to the given system, or null if there is none.
+const DistanceMap::Edge *DistanceMap::Find(const System *system) const
+{
+	auto it = lower_bound(route.begin(), route.end(), system,
+		[](const pair<const System *, Edge> &entry, const System *system) noexcept -> bool
+		{
+			return less<const System *>()(entry.first, system);
+		});
+	return (it != route.end() && it->first == system) ? &it->second : nullptr;
+}
+
+
+
+bool DistanceMap::ExploreLater(const Edge &a, const Edge &b)
+{
+	if(a.minimumFuel != b.minimumFuel)
+		return (a.minimumFuel > b.minimumFuel);
+	return a < b;
+}
+
+
+
 // Depending on the capabilities of the given ship, use hyperspace paths,
 // jump drive paths, or both to find the shortest route. Bail out if the
 // source system or the maximum count is reached.
-void DistanceMap::Init(const Ship *ship)
+void DistanceMap::Init(const Traveler *traveler)
 {
 	if(!center)
 		return;
 
-	route[center] = Edge();
+	route.emplace_back(center, Edge());
 	if(!maxDistance)
 		return;
 
 	// Check what travel capabilities this ship has. If no ship is given, assume
 	// hyperdrive capability and no jump drive.
-	if(ship)
+	if(traveler)
 	{
-		hyperspaceFuel = ship->JumpNavigation().HyperdriveFuel();
-		jumpFuel = ship->JumpNavigation().JumpDriveFuel();
-		jumpRange = ship->JumpNavigation().JumpRange();
+		hyperspaceFuel = traveler->hyperspaceFuel;
+		jumpFuel = traveler->jumpFuel;
+		jumpRange = traveler->jumpRange;
 		// If hyperjumps and non-hyper jumps cost the same amount, or non-hyper jumps are always cheaper,
 		// there is no need to check hyperjump paths at all.
 		if(jumpFuel && hyperspaceFuel >= jumpFuel)
@@ -197,7 +436,7 @@ void DistanceMap::Init(const Ship *ship)
 		if(!jumpFuel && !hyperspaceFuel)
 		{
 			bool hasWormhole = false;
-			for(const StellarObject &object : ship->GetSystem()->Objects())
+			for(const StellarObject &object : traveler->system->Objects())
 				if(object.HasSprite() && object.HasValidPlanet() && object.GetPlanet()->IsWormhole())
 				{
 					hasWormhole = true;
@@ -209,15 +448,48 @@ void DistanceMap::Init(const Ship *ship)
 		}
 	}
 
+	// If this is a search for the route from a source system, steer it toward
+	// that system. Every step costs at least the cheaper of the two kinds of
+	// fuel, and any step can be as long as the longest hyperspace link (which
+	// jump drives can also follow) or, for a jump drive, its jump range.
+	if(source && (hyperspaceFuel || jumpFuel))
+	{
+		reach = CurrentReach<Reach>();
+		stepFuel = (hyperspaceFuel && jumpFuel) ? min(hyperspaceFuel, jumpFuel) : max(hyperspaceFuel, jumpFuel);
+		stepLength = reach->linkLength;
+		if(jumpFuel)
+			stepLength = max(stepLength, max(jumpRange, reach->jumpRange));
+		// Leave some slack, so that rounding errors never overestimate the
+		// number of steps that are needed.
+		stepLength = stepLength * 1.000001 + 1.;
+	}
+	// Where the wormholes lead is recorded along with the step lengths.
+	if(wormholeStrategy != WormholeStrategy::NONE && !reach)
+		reach = CurrentReach<Reach>();
+
+	// Searches on this thread share their buffers, unless one is in progress.
+	unique_ptr<Scratch> ownScratch;
+	scratch = SharedScratch<Scratch>();
+	if(!scratch || scratch->inUse)
+	{
+		ownScratch.reset(new Scratch);
+		scratch = ownScratch.get();
+	}
+	scratch->inUse = true;
+	scratch->Start();
+	scratch->Set(*center, Edge());
+
 	// Find the route with lowest fuel use. If multiple routes use the same fuel,
 	// choose the one with the fewest jumps (i.e. using jump drive rather than
 	// hyperdrive). If multiple routes have the same fuel and the same number of
 	// jumps, break the tie by using how "dangerous" the route is.
-	edges.emplace(center);
+	vector<Edge> &edges = scratch->heap;
+	edges.emplace_back(center);
 	while(maxCount && !edges.empty())
 	{
-		Edge top = edges.top();
-		edges.pop();
+		pop_heap(edges.begin(), edges.end(), ExploreLater);
+		Edge top = edges.back();
+		edges.pop_back();
 
 		// Source is only defined when given a ship and a destination system.
 		// Once we have a route between them, stop searching for more routes.
@@ -231,16 +503,13 @@ void DistanceMap::Init(const Ship *ship)
 
 		// Check for wormholes (which cost zero fuel). Wormhole travel should
 		// not be included in Local Maps or mission itineraries.
-		if(wormholeStrategy != WormholeStrategy::NONE)
-			for(const StellarObject &object : top.next->Objects())
-				if(object.HasSprite() && object.HasValidPlanet() && object.GetPlanet()->IsWormhole()
-					&& (object.GetPlanet()->IsUnrestricted() || wormholeStrategy == WormholeStrategy::ALL))
+		if(wormholeStrategy != WormholeStrategy::NONE && top.next->Index() < reach->wormholeLinks.size())
+			for(const Reach::WormholeLink &wormhole : reach->wormholeLinks[top.next->Index()])
+				if(wormhole.isUnrestricted || wormholeStrategy == WormholeStrategy::ALL)
 				{
 					// If we're seeking a path toward a "source," travel through
 					// wormholes in the reverse of the normal direction.
-					const System &link = source ?
-						object.GetPlanet()->GetWormhole()->WormholeSource(*top.next) :
-						object.GetPlanet()->GetWormhole()->WormholeDestination(*top.next);
+					const System &link = source ? *wormhole.from : *wormhole.to;
 					if(HasBetter(link, top))
 						continue;
 
@@ -249,9 +518,10 @@ void DistanceMap::Init(const Ship *ship)
 					// the wormhole and both endpoint systems. (If this is a
 					// multi-stop wormhole, you may know about some paths that
 					// it takes but not others.)
-					if(ship && !object.GetPlanet()->IsAccessible(ship))
+					if(traveler && binary_search(traveler->inaccessibleWormholes.begin(),
+							traveler->inaccessibleWormholes.end(), wormhole.planet))
 						continue;
-					if(player && !player->HasVisited(*object.GetPlanet()))
+					if(player && !player->HasVisited(*wormhole.planet))
 						continue;
 					if(player && !(player->HasVisited(*top.next) && player->HasVisited(link)))
 						continue;
@@ -265,6 +535,21 @@ void DistanceMap::Init(const Ship *ship)
 		if(jumpFuel && !Propagate(top, true))
 			break;
 	}
+
+	// Keep only the best paths, sorted so they can be looked up.
+	route.clear();
+	route.reserve(scratch->reached.size());
+	for(const System *system : scratch->reached)
+		route.emplace_back(system, *scratch->Find(*system));
+	sort(route.begin(), route.end(),
+		[](const pair<const System *, Edge> &a, const pair<const System *, Edge> &b) noexcept -> bool
+		{
+			return less<const System *>()(a.first, b.first);
+		});
+
+	scratch->inUse = false;
+	scratch = nullptr;
+	reach.reset();
 }
 
 
@@ -293,8 +578,8 @@ bool DistanceMap::Propagate(Edge edge, bool useJump)
 // Check if we already have a better path to the given system.
 bool DistanceMap::HasBetter(const System &to, const Edge &edge)
 {
-	auto it = route.find(&to);
-	return (it != route.end() && !(it->second < edge));
+	const Edge *best = scratch->Find(to);
+	return (best && !(*best < edge));
 }
 
 
@@ -304,10 +589,14 @@ void DistanceMap::Add(const System &to, Edge edge)
 {
 	// This is the best path we have found so far to this system, but it is
 	// conceivable that a better one will be found.
-	route[&to] = edge;
+	scratch->Set(to, edge);
 	edge.next = &to;
 	if(maxDistance < 0 || edge.days < maxDistance)
-		edges.emplace(edge);
+	{
+		edge.minimumFuel = edge.fuel + MinimumFuel(to);
+		scratch->heap.push_back(edge);
+		push_heap(scratch->heap.begin(), scratch->heap.end(), ExploreLater);
+	}
 }
 
 
@@ -334,3 +623,22 @@ bool DistanceMap::CheckLink(const System &from, const System &to, bool useJump)
 
 	return (player->HasVisited(from) || player->HasVisited(to));
 }
+
+
+
+// Get a lower bound on the fuel it takes to reach the source from the given
+// system. Since each step changes the distance to the source (or to the
+// nearest wormhole) by at most the step length, this bound never decreases by
+// more than one step's fuel over a single step, so the search still finds the
+// best route, exactly as it would without this guidance.
+int DistanceMap::MinimumFuel(const System &system) const
+{
+	if(!stepLength)
+		return 0;
+
+	double distance = system.Position().Distance(source->Position());
+	if(wormholeStrategy != WormholeStrategy::NONE)
+		for(const Point &wormhole : reach->wormholes)
+			distance = min(distance, system.Position().Distance(wormhole));
+	return stepFuel * static_cast<int>(ceil(distance / stepLength));
+}
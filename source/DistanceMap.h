@@ -18,11 +18,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "WormholeStrategy.h"
 
-#include <map>
-#include <queue>
+#include <cstddef>
+#include <memory>
 #include <set>
 #include <utility>
+#include <vector>
 
+class Planet;
 class PlayerInfo;
 class Ship;
 class System;
@@ -35,6 +37,27 @@ class System;
 // but can also travel to any of a system's "neighbors." A distance map can also
 // be used to calculate the shortest route between two systems.
 class DistanceMap {
+public:
+	// What a ship is capable of when it travels, copied from the ship so that
+	// its route can be found on another thread while the ship keeps moving.
+	class Traveler {
+	public:
+		Traveler() = default;
+		explicit Traveler(const Ship &ship);
+
+		// Travelers are ordered so that routes for them can be looked up.
+		bool operator<(const Traveler &other) const;
+
+	public:
+		const System *system = nullptr;
+		int hyperspaceFuel = 0;
+		int jumpFuel = 0;
+		double jumpRange = 0.;
+		// The wormholes this ship may not travel through, sorted.
+		std::vector<const Planet *> inaccessibleWormholes;
+	};
+
+
 public:
 	// Find paths to the given system. The optional arguments put a limit on how
 	// many systems will be returned and how far away they are allowed to be.
@@ -51,6 +74,8 @@ public:
 	// ship will use a jump drive or hyperdrive depending on what it has. The
 	// pathfinding will stop once a path to the destination is found.
 	DistanceMap(const Ship &ship, const System *destination);
+	// Calculate the same path for a ship with the given capabilities.
+	DistanceMap(const Traveler &traveler, const System *destination);
 
 	// Find out if the given system is reachable.
 	bool HasRoute(const System *system) const;
@@ -61,6 +86,8 @@ public:
 
 	// Get a set containing all the systems.
 	std::set<const System *> Systems() const;
+	// Get the number of systems that have a route.
+	size_t Size() const;
 	// Get the end of the route.
 	const System *End() const;
 
@@ -84,20 +111,36 @@ private:
 		int fuel = 0;
 		int days = 0;
 		double danger = 0.;
+		// A lower bound on the fuel that this route will need once it has
+		// been extended all the way to the source system.
+		int minimumFuel = 0;
 	};
 
+	// Buffers that are only used while searching for routes.
+	class Scratch;
+	// How far apart the systems that a single step can connect may be.
+	class Reach;
+
 
 private:
+	// Get the best path found to the given system, or null if there is none.
+	const Edge *Find(const System *system) const;
+	// The order in which to explore edges: by the least fuel their routes
+	// could need in total, and otherwise in the order of their priority.
+	static bool ExploreLater(const Edge &a, const Edge &b);
 	// Depending on the capabilities of the given ship, use hyperspace paths,
 	// jump drive paths, or both to find the shortest route. Bail out if the
 	// source system or the maximum count is reached.
-	void Init(const Ship *ship = nullptr);
+	void Init(const Traveler *traveler = nullptr);
 	// Add the given links to the map. Return false if an end condition is hit.
 	bool Propagate(Edge edge, bool useJump);
 	// Check if we already have a better path to the given system.
 	bool HasBetter(const System &to, const Edge &edge);
 	// Add the given path to the record.
 	void Add(const System &to, Edge edge);
+	// Get a lower bound on the fuel it takes to reach the source from the
+	// given system, or 0 if no source was given.
+	int MinimumFuel(const System &system) const;
 	// Check whether the given link is travelable. If no player was given in the
 	// constructor then this is always true; otherwise, the player must know
 	// that the given link exists.
@@ -105,10 +148,11 @@ private:
 
 
 private:
-	std::map<const System *, Edge> route;
+	// The best path to each reachable system, sorted by system.
+	std::vector<std::pair<const System *, Edge>> route;
 
 	// Variables only used during construction:
-	std::priority_queue<Edge> edges;
+	Scratch *scratch = nullptr;
 	const PlayerInfo *player = nullptr;
 	const System *source = nullptr;
 	const System *center = nullptr;
@@ -120,6 +164,13 @@ private:
 	int hyperspaceFuel = 100;
 	int jumpFuel = 0;
 	double jumpRange = 0.;
+	// When searching for a route from a source system, the longest step that
+	// can be taken and the least fuel it can cost let the search head toward
+	// the source rather than expanding equally in every direction. The reach
+	// also lists where each system's wormholes lead.
+	std::shared_ptr<const Reach> reach;
+	double stepLength = 0.;
+	int stepFuel = 0;
 };
 
 
@@ -22,16 +22,70 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SpriteSet.h"
 #include "SpriteShader.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace std;
 
+namespace {
+	// Each key holds, from the highest bits to the lowest, the layer, the
+	// texture and swizzle, and the index of the item. Textures whose names
+	// don't fit are only grouped less well, but there can't be more items
+	// than there are indices.
+	const int TEXTURE_SHIFT = 32;
+	const int SWIZZLE_SHIFT = 24;
+	const int LAYER_SHIFT = 56;
+	const uint64_t INDEX_MASK = (uint64_t(1) << SWIZZLE_SHIFT) - 1;
+	const uint64_t SWIZZLE_MASK = 0xFF;
+	const uint64_t TEXTURE_MASK = 0xFFFFFF;
+	const uint64_t MAX_LAYER = 0xFF;
+
+	// Sort the given keys with a radix sort, a byte at a time, starting with
+	// the lowest. Bytes that every key shares, like the upper bytes of the
+	// texture names, are skipped.
+	void RadixSort(vector<uint64_t> &keys, vector<uint64_t> &scratch)
+	{
+		if(keys.empty())
+			return;
+
+		scratch.resize(keys.size());
+		for(int shift = 0; shift < 64; shift += 8)
+		{
+			size_t counts[256] = {};
+			for(uint64_t key : keys)
+				++counts[(key >> shift) & 0xFF];
+			if(counts[(keys.front() >> shift) & 0xFF] == keys.size())
+				continue;
+
+			size_t offset = 0;
+			for(size_t &count : counts)
+			{
+				size_t start = offset;
+				offset += count;
+				count = start;
+			}
+			for(uint64_t key : keys)
+				scratch[counts[(key >> shift) & 0xFF]++] = key;
+			keys.swap(scratch);
+		}
+	}
+}
+
 
 
 // Clear the list.
 void DrawList::Clear(int step, double zoom)
 {
 	items.clear();
+	fields.clear();
+	fieldItems.clear();
+	particles.clear();
+	particleItems.clear();
+	keys.clear();
+	fieldKeys.clear();
+	layer = 0;
+	isGrouped = false;
+	hasGroups = false;
 	this->step = step;
 	this->zoom = zoom;
 	isHighDPI = (Screen::IsHighResolution() ? zoom > .5 : zoom > 1.);
@@ -47,6 +101,51 @@ void DrawList::SetCenter(const Point &center, const Point &centerVelocity)
 
 
 
+// Begin a new layer, whose items are all drawn after those of the earlier
+// layers. Within a layer, items are drawn in the order they were added,
+// unless the layer is grouped.
+void DrawList::BeginLayer(bool isGrouped)
+{
+	layer = min(layer + 1, MAX_LAYER);
+	this->isGrouped = isGrouped;
+	hasGroups |= isGrouped;
+}
+
+
+
+// Once every item has been added, put them in the order they are to be
+// drawn in.
+void DrawList::Finish()
+{
+	// If no layer is grouped, the items were added in the order they are drawn.
+	if(!hasGroups)
+		return;
+
+	RadixSort(keys, sortedKeys);
+	sortedItems.resize(items.size());
+	for(size_t i = 0; i < keys.size(); ++i)
+		sortedItems[i] = items[keys[i] & INDEX_MASK];
+	items.swap(sortedItems);
+
+	// Each field is drawn before the first item that sorts after it. A field
+	// sorts just before the next item in its layer that has the same key.
+	vector<pair<uint64_t, size_t>> order;
+	order.reserve(fields.size());
+	for(size_t i = 0; i < fields.size(); ++i)
+		order.emplace_back(fieldKeys[i], i);
+	sort(order.begin(), order.end());
+	vector<pair<size_t, SpriteShader::Field>> sortedFields;
+	sortedFields.reserve(fields.size());
+	for(const auto &it : order)
+	{
+		size_t index = lower_bound(keys.begin(), keys.end(), it.first) - keys.begin();
+		sortedFields.emplace_back(index, fields[it.second].second);
+	}
+	fields.swap(sortedFields);
+}
+
+
+
 // Add an object based on the Body class.
 bool DrawList::Add(const Body &body, double cloak)
 {
@@ -94,14 +193,121 @@ bool DrawList::AddSwizzled(const Body &body, int swizzle)
 
 
 
+bool DrawList::AddField(const Body &body, double wrap)
+{
+	if(!SpriteShader::CanDrawFields() || !body.HasSprite() || !body.Zoom())
+		return false;
+
+	const Sprite *sprite = body.GetSprite();
+	SpriteShader::Field field;
+	field.texture = sprite->Texture(isHighDPI);
+	field.frameCount = sprite->Frames();
+	field.firstLayer = sprite->FirstLayer(isHighDPI);
+	field.size[0] = body.Width();
+	field.size[1] = body.Height();
+	field.zoom = zoom;
+	field.wrap = wrap;
+
+	// Any copy of an object within its radius of the screen may be visible.
+	Point margin = Point(1., 1.) * body.Radius();
+	Point topLeft = center + Screen::TopLeft() / zoom - margin;
+	Point limit = Screen::Dimensions() / zoom + 2. * margin;
+	double startX = fmod(topLeft.X(), wrap);
+	double startY = fmod(topLeft.Y(), wrap);
+	field.start[0] = startX + wrap * (startX < 0.);
+	field.start[1] = startY + wrap * (startY < 0.);
+	field.origin[0] = (topLeft.X() - center.X()) * zoom;
+	field.origin[1] = (topLeft.Y() - center.Y()) * zoom;
+	field.limit[0] = limit.X();
+	field.limit[1] = limit.Y();
+	field.copiesX = static_cast<int>(limit.X() / wrap) + 1;
+	field.copiesY = static_cast<int>(limit.Y() / wrap) + 1;
+	field.centerVelocity[0] = centerVelocity.X();
+	field.centerVelocity[1] = centerVelocity.Y();
+	field.first = fieldItems.size();
+
+	fieldKeys.push_back(Key(field.texture, 0));
+	fields.emplace_back(items.size(), field);
+	return true;
+}
+
+
+
+void DrawList::AddToField(const Body &body)
+{
+	SpriteShader::FieldItem item;
+	item.position[0] = body.Position().X();
+	item.position[1] = body.Position().Y();
+	item.velocity[0] = body.Velocity().X();
+	item.velocity[1] = body.Velocity().Y();
+	Point unit = body.Facing().Unit();
+	item.unit[0] = unit.X();
+	item.unit[1] = unit.Y();
+	item.frame = body.GetFrame(step);
+
+	fieldItems.push_back(item);
+	++fields.back().second.count;
+}
+
+
+
+bool DrawList::AddParticles(const Sprite *sprite, SpriteShader::Particles particles,
+	const vector<SpriteShader::ParticleItem> &items)
+{
+	if(!SpriteShader::CanDrawFields())
+		return false;
+	if(!sprite || !sprite->Frames() || items.empty())
+		return true;
+
+	particles.texture = sprite->Texture(isHighDPI);
+	particles.frameCount = sprite->Frames();
+	particles.firstLayer = sprite->FirstLayer(isHighDPI);
+	particles.zoom = zoom;
+	particles.center[0] = center.X();
+	particles.center[1] = center.Y();
+	particles.first = particleItems.size();
+	particles.count = items.size();
+
+	particleItems.insert(particleItems.end(), items.begin(), items.end());
+	this->particles.push_back(particles);
+	return true;
+}
+
+
+
 // Draw all the items in this list.
+bool DrawList::InView(const Body &body, double radius) const
+{
+	Point position = body.Position() - center;
+	Point blur = body.Velocity() - centerVelocity;
+	Point size(radius + .5 * fabs(blur.X()), radius + .5 * fabs(blur.Y()));
+	Point topLeft = (position - size) * zoom;
+	Point bottomRight = (position + size) * zoom;
+	if(bottomRight.X() < Screen::Left() || bottomRight.Y() < Screen::Top())
+		return false;
+	if(topLeft.X() > Screen::Right() || topLeft.Y() > Screen::Bottom())
+		return false;
+
+	return true;
+}
+
+
+
 void DrawList::Draw() const
 {
 	SpriteShader::Bind();
 
 	bool withBlur = Preferences::Has("Render motion blur");
-	for(const SpriteShader::Item &item : items)
-		SpriteShader::Add(item, withBlur);
+	size_t first = 0;
+	for(const auto &it : fields)
+	{
+		SpriteShader::Add(items, first, it.first, withBlur);
+		SpriteShader::Add(it.second, fieldItems, withBlur);
+		first = it.first;
+	}
+	SpriteShader::Add(items, first, items.size(), withBlur);
+	for(const SpriteShader::Particles &it : particles)
+		SpriteShader::Add(it, particleItems);
 
 	SpriteShader::Unbind();
 }
@@ -138,6 +344,7 @@ void DrawList::Push(const Body &body, Point pos, Point blur, double cloak, int s
 	item.texture = body.GetSprite()->Texture(isHighDPI);
 	item.frame = body.GetFrame(step);
 	item.frameCount = body.GetSprite()->Frames();
+	item.firstLayer = body.GetSprite()->FirstLayer(isHighDPI);
 
 	item.position[0] = static_cast<float>(pos.X() * zoom);
 	item.position[1] = static_cast<float>(pos.Y() * zoom);
@@ -166,5 +373,18 @@ void DrawList::Push(const Body &body, Point pos, Point blur, double cloak, int s
 	item.swizzle = swizzle;
 	item.clip = 1.;
 
+	keys.push_back(Key(item.texture, item.swizzle));
 	items.push_back(item);
 }
+
+
+
+// Get the key that an item with the given texture and swizzle, added to the
+// current layer, is sorted by.
+uint64_t DrawList::Key(uint32_t texture, uint32_t swizzle) const
+{
+	uint64_t key = (layer << LAYER_SHIFT) | (items.size() & INDEX_MASK);
+	if(isGrouped)
+		key |= ((texture & TEXTURE_MASK) << TEXTURE_SHIFT) | ((swizzle & SWIZZLE_MASK) << SWIZZLE_SHIFT);
+	return key;
+}
@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SpriteShader.h"
 
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 class Body;
@@ -38,6 +39,17 @@ public:
 	void Clear(int step = 0, double zoom = 1.);
 	void SetCenter(const Point &center, const Point &centerVelocity = Point());
 
+	// Begin a new layer, whose items are all drawn after those of the earlier
+	// layers. Within a layer, items are drawn in the order they were added,
+	// unless the layer is "grouped," meaning that it does not matter which of
+	// its items are drawn on top of each other. Then the items that use the
+	// same texture and swizzle are drawn together, so that fewer draw calls
+	// are needed. Until a layer is begun, items are added to an ordered one.
+	void BeginLayer(bool isGrouped);
+	// Once every item has been added, put them in the order they are to be
+	// drawn in. Grouped layers are not grouped if this is not done.
+	void Finish();
+
 	// Add an object based on the Body class.
 	bool Add(const Body &body, double cloak = 0.);
 	// Add an object at the given position (rather than its own).
@@ -48,6 +60,27 @@ public:
 	// Add an object using a specific swizzle (rather than its own).
 	bool AddSwizzled(const Body &body, int swizzle);
 
+	// Begin a field of objects that share the given object's sprite and that
+	// repeat every "wrap" pixels, so that every visible copy of all of them can
+	// be drawn at once. The objects are then added with AddToField(). If this
+	// returns false, fields can't be drawn, and each copy of an object must be
+	// added on its own instead.
+	bool AddField(const Body &body, double wrap);
+	void AddToField(const Body &body);
+
+	// Add the particles of one effect, which uses the given sprite. The view
+	// settings are filled in here, and the rest by the caller. Particles are
+	// drawn after everything else in the list. If this returns false,
+	// particles can't be drawn at all.
+	bool AddParticles(const Sprite *sprite, SpriteShader::Particles particles,
+		const std::vector<SpriteShader::ParticleItem> &items);
+
+	// Check whether any part of the given object could be on screen if it were
+	// the given radius across, allowing for motion blur. This is a looser, cheaper
+	// test than the one each sprite gets when it is added, for skipping the work
+	// of building an object that is made up of many sprites.
+	bool InView(const Body &body, double radius) const;
+
 	// Draw all the items in this list.
 	void Draw() const;
 
@@ -57,6 +90,9 @@ private:
 	bool Cull(const Body &body, const Point &position, const Point &blur) const;
 
 	void Push(const Body &body, Point pos, Point blur, double cloak, int swizzle);
+	// Get the key that an item with the given texture and swizzle, added to
+	// the current layer, is sorted by.
+	uint64_t Key(uint32_t texture, uint32_t swizzle) const;
 
 
 private:
@@ -64,6 +100,23 @@ private:
 	double zoom = 1.;
 	bool isHighDPI = false;
 	std::vector<SpriteShader::Item> items;
+	// Each field is drawn just before the item with the given index.
+	std::vector<std::pair<size_t, SpriteShader::Field>> fields;
+	// The keys that the items and the fields are sorted by: the layer, then
+	// the texture and swizzle if the layer is grouped, then the order in
+	// which they were added.
+	std::vector<uint64_t> keys;
+	std::vector<uint64_t> fieldKeys;
+	uint64_t layer = 0;
+	bool isGrouped = false;
+	bool hasGroups = false;
+	// Buffers that are kept from one step to the next, so that sorting does
+	// not need to allocate any memory.
+	std::vector<uint64_t> sortedKeys;
+	std::vector<SpriteShader::Item> sortedItems;
+	std::vector<SpriteShader::FieldItem> fieldItems;
+	std::vector<SpriteShader::Particles> particles;
+	std::vector<SpriteShader::ParticleItem> particleItems;
 
 	Point center;
 	Point centerVelocity;
@@ -0,0 +1,218 @@
+/* DynamicResolution.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "DynamicResolution.h"
+
+#include "PowerGovernor.h"
+#include "Preferences.h"
+#include "Profiler.h"
+
+#include "opengl.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+	// The scale never goes below this, since the scene becomes too blurry.
+	const double MIN_SCALE = .5;
+	// How much to lower the scale by when the graphics card is falling behind,
+	// and how much to raise it by once it has been keeping up.
+	const double STEP_DOWN = .1;
+	const double STEP_UP = .05;
+	// How many frames in a row it must fall behind, or keep up, before the scale
+	// is changed. Raising the scale is slower, so it does not flip back and forth.
+	const int SLOW_FRAMES = 10;
+	const int FAST_FRAMES = 120;
+}
+
+
+
+DynamicResolution::~DynamicResolution()
+{
+	Release();
+}
+
+
+
+// Start drawing the scene. If it should be drawn at a reduced resolution,
+// this redirects drawing to the offscreen image and returns true.
+bool DynamicResolution::Begin()
+{
+	isScaled = false;
+	if(!IsEnabled())
+	{
+		Release();
+		return false;
+	}
+
+	UpdateScale();
+	double drawScale = min(scale, PowerGovernor::MaxSceneScale());
+	Profiler::SetCounter("Scene resolution scale", drawScale);
+	if(drawScale >= 1.)
+		return false;
+
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	screenWidth = viewport[2];
+	screenHeight = viewport[3];
+	int newWidth = max(1, static_cast<int>(lround(screenWidth * drawScale)));
+	int newHeight = max(1, static_cast<int>(lround(screenHeight * drawScale)));
+	if(newWidth != width || newHeight != height)
+	{
+		if(framebuffer)
+			glDeleteFramebuffers(1, &framebuffer);
+		if(texture)
+			OpenGL::DeleteTextures(1, &texture);
+		framebuffer = 0;
+		texture = 0;
+	}
+
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &screen);
+	if(!framebuffer)
+	{
+		width = newWidth;
+		height = newHeight;
+
+		glGenTextures(1, &texture);
+		OpenGL::BindTexture(GL_TEXTURE_2D, texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		OpenGL::BindTexture(GL_TEXTURE_2D, 0);
+
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+		if(glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, screen);
+			glDeleteFramebuffers(1, &framebuffer);
+			OpenGL::DeleteTextures(1, &texture);
+			framebuffer = 0;
+			texture = 0;
+			width = 0;
+			height = 0;
+			return false;
+		}
+	}
+	else
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+
+	// Every shader positions its output relative to the viewport, so shrinking
+	// it is all that is needed to draw the scene at the lower resolution.
+	glViewport(0, 0, width, height);
+	glClear(GL_COLOR_BUFFER_BIT);
+	isScaled = true;
+	return true;
+}
+
+
+
+// Finish drawing the scene, scaling it up to the screen if need be.
+void DynamicResolution::End()
+{
+	if(isScaled)
+	{
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, screen);
+		glViewport(0, 0, screenWidth, screenHeight);
+
+		GLint previous = 0;
+		glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+		glBlitFramebuffer(0, 0, width, height, 0, 0, screenWidth, screenHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, previous);
+		isScaled = false;
+	}
+
+	// Mark where this frame's scene ends, to check if it finished in time.
+	if(IsEnabled() && !fence)
+		fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+
+
+// The fraction of the screen's resolution the scene is drawn at, before any
+// limit set to save power.
+double DynamicResolution::Scale() const
+{
+	return scale;
+}
+
+
+
+// Free the graphics memory used by the offscreen image.
+void DynamicResolution::Release()
+{
+	if(framebuffer)
+		glDeleteFramebuffers(1, &framebuffer);
+	if(texture)
+		OpenGL::DeleteTextures(1, &texture);
+	if(fence)
+		glDeleteSync(static_cast<GLsync>(fence));
+	framebuffer = 0;
+	texture = 0;
+	width = 0;
+	height = 0;
+	fence = nullptr;
+	scale = 1.;
+	slowFrames = 0;
+	fastFrames = 0;
+}
+
+
+
+// Whether the scene may be drawn at a reduced resolution at all, either because
+// the player chose it or to save power.
+bool DynamicResolution::IsEnabled()
+{
+	return Preferences::Has("Dynamic resolution") || PowerGovernor::ForceDynamicResolution();
+}
+
+
+
+// Check whether the graphics card finished the last frame in time, and
+// adjust the scale accordingly.
+void DynamicResolution::UpdateScale()
+{
+	if(!fence)
+		return;
+
+	// A frame later, the last frame's scene should long since have been drawn.
+	// If it is still being drawn, the graphics card is the bottleneck.
+	GLenum status = glClientWaitSync(static_cast<GLsync>(fence), 0, 0);
+	glDeleteSync(static_cast<GLsync>(fence));
+	fence = nullptr;
+	if(status == GL_TIMEOUT_EXPIRED)
+	{
+		fastFrames = 0;
+		if(++slowFrames >= SLOW_FRAMES)
+		{
+			scale = max(MIN_SCALE, scale - STEP_DOWN);
+			slowFrames = 0;
+		}
+	}
+	else
+	{
+		slowFrames = 0;
+		if(scale < 1. && ++fastFrames >= FAST_FRAMES)
+		{
+			// Snap to exactly 1 so the offscreen image is no longer used at all.
+			scale = (scale + STEP_UP > .999 ? 1. : scale + STEP_UP);
+			fastFrames = 0;
+		}
+	}
+}
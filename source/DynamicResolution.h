@@ -0,0 +1,79 @@
+/* DynamicResolution.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DYNAMIC_RESOLUTION_H_
+#define DYNAMIC_RESOLUTION_H_
+
+
+
+// An offscreen image that the in-flight scene can be drawn into at less than
+// the screen's resolution, and then scaled up to fill the screen. This saves
+// fill rate when the graphics card cannot keep up. The scale is chosen from
+// whether the graphics card has finished drawing the previous frame by the
+// time the next one starts: if it keeps falling behind, the scale goes down,
+// and once it has kept up for a while, the scale goes back up.
+class DynamicResolution {
+public:
+	DynamicResolution() noexcept = default;
+	~DynamicResolution();
+
+	DynamicResolution(const DynamicResolution &) = delete;
+	DynamicResolution &operator=(const DynamicResolution &) = delete;
+
+	// Start drawing the scene. If it should be drawn at a reduced resolution,
+	// this redirects drawing to the offscreen image and returns true.
+	bool Begin();
+	// Finish drawing the scene, scaling it up to the screen if need be.
+	void End();
+
+	// The fraction of the screen's resolution the scene is drawn at, before any
+	// limit set to save power.
+	double Scale() const;
+
+	// Free the graphics memory used by the offscreen image.
+	void Release();
+
+
+private:
+	// Whether the scene may be drawn at a reduced resolution at all, either because
+	// the player chose it or to save power.
+	static bool IsEnabled();
+	// Check whether the graphics card finished the last frame in time, and
+	// adjust the scale accordingly.
+	void UpdateScale();
+
+
+private:
+	unsigned framebuffer = 0;
+	unsigned texture = 0;
+	// The framebuffer that was bound when Begin() was called, and the size of
+	// the screen and the offscreen image.
+	int screen = 0;
+	int screenWidth = 0;
+	int screenHeight = 0;
+	int width = 0;
+	int height = 0;
+	bool isScaled = false;
+
+	// A fence marking the end of the last frame's scene.
+	void *fence = nullptr;
+	double scale = 1.;
+	int slowFrames = 0;
+	int fastFrames = 0;
+};
+
+
+
+#endif
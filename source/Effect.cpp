@@ -51,6 +51,8 @@ void Effect::Load(const DataNode &node)
 			lifetime = child.Value(1);
 		else if(child.Token(0) == "random lifetime" && child.Size() >= 2)
 			randomLifetime = child.Value(1);
+		else if(child.Token(0) == "priority" && child.Size() >= 2)
+			priority = child.Value(1);
 		else if(child.Token(0) == "velocity scale" && child.Size() >= 2)
 			velocityScale = child.Value(1);
 		else if(child.Token(0) == "random velocity" && child.Size() >= 2)
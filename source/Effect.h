@@ -68,9 +68,13 @@ private:
 
 	int lifetime = 0;
 	int randomLifetime = 0;
+	// When there are too many new visuals to show them all, those of effects
+	// with a higher priority are kept first.
+	int priority = 0;
 
-	// Allow the Visual class to access all these private members.
+	// Allow the Visual and Particle classes to access all these private members.
 	friend class Visual;
+	friend class Particle;
 };
 
 
@@ -35,11 +35,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GamePad.h"
 #include "Gamerules.h"
 #include "Government.h"
+#include "GpuProfiler.h"
 #include "Hazard.h"
 #include "Interface.h"
 #include "Logger.h"
 #include "MapPanel.h"
 #include "Mask.h"
+#include "MemoryStats.h"
 #include "Messages.h"
 #include "Minable.h"
 #include "Mission.h"
@@ -48,14 +50,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Person.h"
 #include "pi.h"
 #include "Planet.h"
+#include "Particle.h"
 #include "PlanetLabel.h"
 #include "PlayerInfo.h"
 #include "PointerShader.h"
 #include "Politics.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Projectile.h"
 #include "Random.h"
 #include "RingShader.h"
+#include "RoutePlanner.h"
 #include "Screen.h"
 #include "Ship.h"
 #include "ShipEvent.h"
@@ -69,6 +74,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SystemEntry.h"
 #include "Test.h"
 #include "TestContext.h"
+#include "ThreadPlacement.h"
 #include "Visual.h"
 #include "Weather.h"
 #include "Wormhole.h"
@@ -77,11 +83,49 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <future>
+#include <map>
+#include <numeric>
 #include <string>
+#include <unordered_map>
 
 using namespace std;
 
 namespace {
+	// The information shown on the HUD, by the keys that its interface looks it up with.
+	const Information::Key INFO_CREDITS("credits");
+	const Information::Key INFO_DATE("date");
+	const Information::Key INFO_DESTINATION("destination");
+	const Information::Key INFO_DISABLED_HULL("disabled hull");
+	const Information::Key INFO_ENERGY("energy");
+	const Information::Key INFO_FUEL("fuel");
+	const Information::Key INFO_HEAT("heat");
+	const Information::Key INFO_HULL("hull");
+	const Information::Key INFO_LOCATION("location");
+	const Information::Key INFO_MISSION_TARGET("mission target");
+	const Information::Key INFO_NAVIGATION_MODE("navigation mode");
+	const Information::Key INFO_OVERHEAT("overheat");
+	const Information::Key INFO_OVERHEAT_BLINK("overheat blink");
+	const Information::Key INFO_PLAYER_SPRITE("player sprite");
+	const Information::Key INFO_RANGE_DISPLAY("range display");
+	const Information::Key INFO_RED_ALERT("red alert");
+	const Information::Key INFO_SHIELDS("shields");
+	const Information::Key INFO_TACTICAL_DISPLAY("tactical display");
+	const Information::Key INFO_TARGET_CREW("target crew");
+	const Information::Key INFO_TARGET_DISABLED_HULL("target disabled hull");
+	const Information::Key INFO_TARGET_ENERGY("target energy");
+	const Information::Key INFO_TARGET_FUEL("target fuel");
+	const Information::Key INFO_TARGET_GOVERNMENT("target government");
+	const Information::Key INFO_TARGET_HEAT("target heat");
+	const Information::Key INFO_TARGET_HULL("target hull");
+	const Information::Key INFO_TARGET_NAME("target name");
+	const Information::Key INFO_TARGET_RANGE("target range");
+	const Information::Key INFO_TARGET_SHIELDS("target shields");
+	const Information::Key INFO_TARGET_SPRITE("target sprite");
+	const Information::Key INFO_TARGET_TYPE("target type");
+
+
+
 	int RadarType(const Ship &ship, int step)
 	{
 		if(ship.GetPersonality().IsTarget() && !ship.IsDestroyed())
@@ -134,6 +178,13 @@ namespace {
 		}
 	}
 
+	template <class Type>
+	void Prune(vector<shared_ptr<Type>> &objects)
+	{
+		objects.erase(remove_if(objects.begin(), objects.end(),
+			[](const shared_ptr<Type> &object) -> bool { return object->ShouldBeRemoved(); }), objects.end());
+	}
+
 	template <class Type>
 	void Append(vector<Type> &objects, vector<Type> &added)
 	{
@@ -141,6 +192,81 @@ namespace {
 		added.clear();
 	}
 
+	template <class Type>
+	void Append(vector<shared_ptr<Type>> &objects, list<shared_ptr<Type>> &added)
+	{
+		objects.insert(objects.end(), make_move_iterator(added.begin()), make_move_iterator(added.end()));
+		added.clear();
+	}
+
+
+	// Only Linux builds keep a separate random number generator for each thread.
+	// Elsewhere the generator is shared, so moving ships on several threads at
+	// once would make the sequence of random numbers depend on timing.
+	unsigned ParallelThreadCount()
+	{
+#ifdef __linux__
+		return JobPool::DefaultThreadCount();
+#else
+		return 0;
+#endif
+	}
+
+	// Look up the root of the given index's group, flattening the path to it.
+	size_t FindGroup(vector<size_t> &root, size_t index)
+	{
+		while(root[index] != index)
+		{
+			root[index] = root[root[index]];
+			index = root[index];
+		}
+		return index;
+	}
+
+	// Look up the sprites of the given system's ordinary asteroids, in the order
+	// they are listed in. The minable ones have sprites of their own.
+	vector<const Sprite *> AsteroidSprites(const System &system)
+	{
+		vector<const Sprite *> sprites;
+		for(const System::Asteroid &a : system.Asteroids())
+			sprites.push_back(a.Type() ? nullptr : SpriteSet::Get("asteroid/" + a.Name() + "/spin"));
+		return sprites;
+	}
+
+	// Fill the given field with the given system's asteroids. This does not
+	// modify the sprite set, so it may be done on another thread.
+	void FillAsteroids(AsteroidField &field, const System &system, const vector<const Sprite *> &sprites)
+	{
+		field.Clear();
+		for(size_t i = 0; i < sprites.size(); ++i)
+		{
+			const System::Asteroid &a = system.Asteroids()[i];
+			// Check whether this is a minable or an ordinary asteroid.
+			if(a.Type())
+				field.Add(a.Type(), a.Count(), a.Energy(), system.AsteroidBelts());
+			else
+				field.Add(sprites[i], a.Count(), a.Energy());
+		}
+	}
+
+	// With at least this many projectiles in flight, find which ships they hit
+	// all at once, using a bounding volume hierarchy instead of the grid.
+	const size_t BATCH_COLLISION_COUNT = 128;
+	// The number of projectiles each job checks for ship hits.
+	const size_t COLLISION_BLOCK_SIZE = 32;
+	// With at least this many blasts on one step, the ships in their radii are
+	// found in parallel.
+	const size_t BATCH_BLAST_COUNT = 16;
+	// With at least this many pieces of flotsam, the ships close enough to
+	// collect them are found in parallel, this many pieces per job.
+	const size_t BATCH_FLOTSAM_COUNT = 128;
+	const size_t FLOTSAM_BLOCK_SIZE = 32;
+	// With at least this many ships ready to fire anti-missiles, they are
+	// indexed by where they are.
+	const size_t ANTI_MISSILE_GRID_COUNT = 8;
+	// A ship's hardpoints, engine flares and carried fighters are all drawn
+	// within this many times its own radius of its center.
+	const double SHIP_VIEW_MARGIN = 2.;
 
 	// Author the given message from the given ship.
 	void SendMessage(const shared_ptr<const Ship> &ship, const string &message)
@@ -240,12 +366,45 @@ namespace {
 
 	const double RADAR_SCALE = .025;
 	const double MAX_FUEL_DISPLAY = 5000.;
+
+	// A hazard that deals its damage this step, with the strength of every
+	// active weather event of that hazard at the same origin added together.
+	class HazardStrike {
+	public:
+		const Hazard *hazard;
+		Point origin;
+		double scale;
+		// The strike whose ship query this strike shares.
+		size_t query;
+	};
+
+	// Whether two strikes affect exactly the same ships.
+	bool SameArea(const HazardStrike &a, const HazardStrike &b)
+	{
+		if(a.hazard->SystemWide() || b.hazard->SystemWide())
+			return a.hazard->SystemWide() == b.hazard->SystemWide();
+		return a.origin.X() == b.origin.X() && a.origin.Y() == b.origin.Y()
+			&& a.hazard->MinRange() == b.hazard->MinRange() && a.hazard->MaxRange() == b.hazard->MaxRange();
+	}
+
+	// Whether a hazard deals the same damage to a ship wherever its origin is.
+	bool IgnoresOrigin(const Hazard &hazard)
+	{
+		return !(hazard.BlastRadius() > 0. && hazard.IsDamageScaled()) && !hazard.HasDamageDropoff();
+	}
+
+	// The memory reserved by a vector for its elements.
+	template <class Type>
+	int64_t VectorBytes(const vector<Type> &objects)
+	{
+		return objects.capacity() * sizeof(Type);
+	}
 }
 
 
 
 Engine::Engine(PlayerInfo &player)
-	: player(player), ai(ships, asteroids.Minables(), flotsam),
+	: player(player), jobs(ParallelThreadCount()), ai(ships, asteroids.Minables(), flotsam, jobs),
 	ammoDisplay(player), shipCollisions(256u, 32u)
 {
 	zoom = Preferences::ViewZoom();
@@ -297,6 +456,8 @@ Engine::Engine(PlayerInfo &player)
 
 Engine::~Engine()
 {
+	// If the game is quit in flight, save the flight that was being recorded.
+	Replay::FinishRecording();
 	{
 		unique_lock<mutex> lock(swapMutex);
 		terminate = true;
@@ -313,6 +474,14 @@ void Engine::Place()
 	ai.ClearOrders();
 
 	player.SetSystemEntry(SystemEntry::TAKE_OFF);
+	// A replayed flight must begin in the same state as the recorded one did.
+	calcSeed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+	hasCalcSeed = true;
+	Replay::Cursor *replay = testContext ? testContext->CurrentReplay() : nullptr;
+	if(replay)
+		step = replay->Get()->FirstStep();
+	else if(Replay::Recording())
+		Replay::Recording()->SetFirstStep(step);
 	EnterSystem();
 
 	// Add the player's flagship and escorts to the list of ships. The TakeOff()
@@ -390,7 +559,7 @@ void Engine::Place()
 	}
 	// Move any ships that were randomly spawned into the main list, now
 	// that all special ships have been repositioned.
-	ships.splice(ships.end(), newShips);
+	Append(ships, newShips);
 
 	player.SetPlanet(nullptr);
 }
@@ -403,74 +572,78 @@ void Engine::Place()
 void Engine::Place(const list<NPC> &npcs, shared_ptr<Ship> flagship)
 {
 	for(const NPC &npc : npcs)
+		if(npc.ShouldSpawn())
+			PlaceNPCShips(npc.Ships(), flagship);
+}
+
+
+
+// Add the ships of one NPC block to the known ships.
+void Engine::PlaceNPCShips(const list<shared_ptr<Ship>> &npcShips, const shared_ptr<Ship> &flagship)
+{
+	map<string, map<Ship *, int>> carriers;
+	for(const shared_ptr<Ship> &ship : npcShips)
 	{
-		if(!npc.ShouldSpawn())
+		// Skip ships that have been destroyed.
+		if(ship->IsDestroyed() || ship->IsDisabled())
 			continue;
 
-		map<string, map<Ship *, int>> carriers;
-		for(const shared_ptr<Ship> &ship : npc.Ships())
+		// Redo the loading up of fighters.
+		if(ship->HasBays())
 		{
-			// Skip ships that have been destroyed.
-			if(ship->IsDestroyed() || ship->IsDisabled())
-				continue;
-
-			// Redo the loading up of fighters.
-			if(ship->HasBays())
+			ship->UnloadBays();
+			for(const auto &cat : GameData::GetCategory(CategoryType::BAY))
 			{
-				ship->UnloadBays();
-				for(const auto &cat : GameData::GetCategory(CategoryType::BAY))
-				{
-					const string &bayType = cat.Name();
-					int baysTotal = ship->BaysTotal(bayType);
-					if(baysTotal)
-						carriers[bayType][&*ship] = baysTotal;
-				}
+				const string &bayType = cat.Name();
+				int baysTotal = ship->BaysTotal(bayType);
+				if(baysTotal)
+					carriers[bayType][&*ship] = baysTotal;
 			}
 		}
+	}
+
+	shared_ptr<Ship> npcFlagship;
+	for(const shared_ptr<Ship> &ship : npcShips)
+	{
+		// Skip ships that have been destroyed.
+		if(ship->IsDestroyed())
+			continue;
 
-		shared_ptr<Ship> npcFlagship;
-		for(const shared_ptr<Ship> &ship : npc.Ships())
+		// Avoid the exploit where the player can wear down an NPC's
+		// crew by attrition over the course of many days.
+		ship->AddCrew(max(0, ship->RequiredCrew() - ship->Crew()));
+		if(!ship->IsDisabled())
+			ship->Recharge();
+
+		if(ship->CanBeCarried())
 		{
-			// Skip ships that have been destroyed.
-			if(ship->IsDestroyed())
+			bool docked = false;
+			const string &bayType = ship->Attributes().Category();
+			for(auto &it : carriers[bayType])
+				if(it.second && it.first->Carry(ship))
+				{
+					--it.second;
+					docked = true;
+					break;
+				}
+			if(docked)
 				continue;
+		}
 
-			// Avoid the exploit where the player can wear down an NPC's
-			// crew by attrition over the course of many days.
-			ship->AddCrew(max(0, ship->RequiredCrew() - ship->Crew()));
-			if(!ship->IsDisabled())
-				ship->Recharge();
-
-			if(ship->CanBeCarried())
-			{
-				bool docked = false;
-				const string &bayType = ship->Attributes().Category();
-				for(auto &it : carriers[bayType])
-					if(it.second && it.first->Carry(ship))
-					{
-						--it.second;
-						docked = true;
-						break;
-					}
-				if(docked)
-					continue;
-			}
+		ships.push_back(ship);
+		// The first (alive) ship in an NPC block
+		// serves as the flagship of the group.
+		if(!npcFlagship)
+			npcFlagship = ship;
 
-			ships.push_back(ship);
-			// The first (alive) ship in an NPC block
-			// serves as the flagship of the group.
-			if(!npcFlagship)
-				npcFlagship = ship;
-
-			// Only the flagship of an NPC considers the
-			// player: the rest of the NPC track it.
-			if(npcFlagship && ship != npcFlagship)
-				ship->SetParent(npcFlagship);
-			else if(!ship->GetPersonality().IsUninterested())
-				ship->SetParent(flagship);
-			else
-				ship->SetParent(nullptr);
-		}
+		// Only the flagship of an NPC considers the
+		// player: the rest of the NPC track it.
+		if(npcFlagship && ship != npcFlagship)
+			ship->SetParent(npcFlagship);
+		else if(!ship->GetPersonality().IsUninterested())
+			ship->SetParent(flagship);
+		else
+			ship->SetParent(nullptr);
 	}
 }
 
@@ -482,6 +655,21 @@ void Engine::Wait()
 	unique_lock<mutex> lock(swapMutex);
 	condition.wait(lock, [this] { return hasFinishedCalculating; });
 	drawTickTock = calcTickTock;
+	CountFrame(false);
+}
+
+
+
+// Check if the previous calculations are done, without waiting for them.
+bool Engine::TryWait()
+{
+	unique_lock<mutex> lock(swapMutex);
+	CountFrame(!hasFinishedCalculating);
+	if(!hasFinishedCalculating)
+		return false;
+
+	drawTickTock = calcTickTock;
+	return true;
 }
 
 
@@ -492,6 +680,16 @@ void Engine::Step(bool isActive)
 	events.swap(eventQueue);
 	eventQueue.clear();
 
+	// Refresh the summary of the profiler's timings once per second.
+	if(Profiler::IsEnabled() && !profileCount)
+	{
+		MemoryStats::SetBytes(MemoryStats::Category::ENGINE_OBJECTS, ObjectBytes());
+		MemoryStats::UpdateCounters();
+		profile = Profiler::Summarize();
+		profileCounters = Profiler::Counters();
+	}
+	profileCount = (profileCount + 1) % 60;
+
 	// The calculation thread was paused by MainPanel before calling this function, so it is safe to access things.
 	const shared_ptr<Ship> flagship = player.FlagshipPtr();
 	const StellarObject *object = player.GetStellarObject();
@@ -527,11 +725,15 @@ void Engine::Step(bool isActive)
 	ai.UpdateEvents(events);
 	if(isActive)
 	{
+		activeCommands |= clickCommands.Take();
 		HandleKeyboardInputs();
 		// Ignore any inputs given when first becoming active, since those inputs
 		// were issued when some other panel (e.g. planet, hail) was displayed.
 		if(!wasActive)
+		{
 			activeCommands.Clear();
+			playerCommands.Take();
+		}
 		else
 		{
 			// Do a testing step if we got an active testContext from main.cpp.
@@ -542,13 +744,28 @@ void Engine::Step(bool isActive)
 				const Test *runningTest = testContext->CurrentTest();
 				if(runningTest)
 					runningTest->Step(*testContext, player, activeCommands);
+				// A replay gives exactly the commands and clicks that were recorded.
+				Replay::Cursor *replay = testContext->CurrentReplay();
+				replayInputs.clear();
+				if(replay && replay->Next(activeCommands, replayInputs))
+					for(const Replay::Input &input : replayInputs)
+						ApplyInput(input);
 			}
+			if(Replay::Recording())
+				Replay::Recording()->SetCommand(activeCommands);
 			ai.UpdateKeys(player, activeCommands);
 		}
+		// The calculation thread takes these commands whenever it next steps.
+		playerCommands.Add(activeCommands);
+		activeCommands.Clear();
 	}
 	// Clear the testContext every step. Main.cpp will provide the context before
 	// every step where it expects the Engine to handle testing.
 	testContext = nullptr;
+	// A recording only covers uninterrupted flight, so it ends as soon as any
+	// other panel is shown.
+	if(!isActive)
+		Replay::FinishRecording();
 
 	wasActive = isActive;
 	Audio::Update(center);
@@ -580,16 +797,6 @@ void Engine::Step(bool isActive)
 		}
 	}
 
-	// Draw a highlight to distinguish the flagship from other ships.
-	if(flagship && !flagship->IsDestroyed() && Preferences::Has("Highlight player's flagship"))
-	{
-		highlightSprite = flagship->GetSprite();
-		highlightUnit = flagship->Unit() * zoom;
-		highlightFrame = flagship->GetFrame();
-	}
-	else
-		highlightSprite = nullptr;
-
 	// Any of the player's ships that are in system are assumed to have
 	// landed along with the player.
 	if(flagship && flagship->GetPlanet() && isActive)
@@ -607,399 +814,152 @@ void Engine::Step(bool isActive)
 	else if(flash)
 		flash = max(0., flash * .99 - .002);
 
-	targets.clear();
-
 	// Update the player's ammo amounts.
 	if(flagship)
 		ammoDisplay.Update(*flagship.get());
 
+	if(flagship && flagship->IsOverheated())
+		Messages::Add("Your ship has overheated.", Messages::Importance::Highest);
 
-	// Display escort information for all ships of the "Escort" government,
-	// and all ships with the "escort" personality, except for fighters that
-	// are not owned by the player.
-	escorts.Clear();
-	bool fleetIsJumping = (flagship && flagship->Commands().Has(Command::JUMP));
-	for(const auto &it : ships)
-		if(it->GetGovernment()->IsPlayer() || it->GetPersonality().IsEscort())
-			if(!it->IsYours() && !it->CanBeCarried())
-			{
-				bool isSelected = (flagship && flagship->GetTargetShip() == it);
-				escorts.Add(*it, it->GetSystem() == currentSystem, fleetIsJumping, isSelected);
-			}
-	for(const shared_ptr<Ship> &escort : player.Ships())
-		if(!escort->IsParked() && escort != flagship && !escort->IsDestroyed())
-		{
-			// Check if this escort is selected.
-			bool isSelected = false;
-			for(const weak_ptr<Ship> &ptr : player.SelectedShips())
-				if(ptr.lock() == escort)
-				{
-					isSelected = true;
-					break;
-				}
-			escorts.Add(*escort, escort->GetSystem() == currentSystem, fleetIsJumping, isSelected);
-		}
+	// Record that the player knows the targeted asteroid's type is available
+	// here. If that asteroid has been destroyed, it is no longer the target.
+	const Minable *targetAsteroid = flagship ? asteroids.Minables().Get(flagship->GetTargetAsteroid()) : nullptr;
+	if(targetAsteroid)
+		for(const auto &it : targetAsteroid->Payload())
+			player.Harvest(it.first);
+	else if(flagship)
+		flagship->SetTargetAsteroid(PoolHandle<Minable>());
 
-	// Create the status overlays.
-	statuses.clear();
-	if(isActive)
-		CreateStatusOverlays();
+	// Handle any events that change the selected ships.
+	if(groupSelect >= 0)
+	{
+		// This has to be done in Step() to avoid race conditions.
+		if(hasControl)
+			player.SetGroup(groupSelect);
+		else
+			player.SelectGroup(groupSelect, hasShift);
+		groupSelect = -1;
+	}
+	if(doClickNextStep)
+	{
+		// If a click command is issued, always wait until the next step to act
+		// on it, to avoid race conditions.
+		doClick = true;
+		doClickNextStep = false;
+	}
+	else
+		doClick = false;
 
-	// Create missile overlays.
-	missileLabels.clear();
-	if(Preferences::Has("Show missile overlays"))
-		for(const Projectile &projectile : projectiles)
+	if(doClick && !isRightClick)
+	{
+		if(uiClickBox.Dimensions())
+			doClick = !ammoDisplay.Click(uiClickBox);
+		else
+			doClick = !ammoDisplay.Click(clickPoint, hasControl);
+		if(doClick && clickBox.Dimensions())
 		{
-			Point pos = projectile.Position() - center;
-			if(projectile.MissileStrength() && projectile.GetGovernment()->IsEnemy()
-					&& (pos.Length() < max(Screen::Width(), Screen::Height()) * .5 / zoom))
-				missileLabels.emplace_back(AlertLabel(pos, projectile, flagship, zoom));
+			doClick = !player.SelectShips(clickBox, hasShift);
+		}
+		if(doClick)
+		{
+			const vector<const Ship *> &stack = snapshots[drawTickTock].escorts.Click(clickPoint);
+			if(!stack.empty())
+				doClick = !player.SelectShips(stack, hasShift);
+			else
+				clickPoint /= isRadarClick ? RADAR_SCALE : zoom;
 		}
+	}
 
-	// Create the planet labels.
-	labels.clear();
-	if(currentSystem && Preferences::Has("Show planet labels"))
+	// Decide whether or not to catalog asteroids. This results in cataloging
+	// in-range asteroids roughly 3 times a second.
+	bool shouldCatalogAsteroids = (!isAsteroidCatalogComplete && !Random::Int(20));
+	double scanRangeMetric = flagship ? 10000. * flagship->Attributes().Get("asteroid scan power") : 0.;
+	if(shouldCatalogAsteroids && scanRangeMetric && !flagship->IsHyperspacing())
 	{
-		for(const StellarObject &object : currentSystem->Objects())
+		bool scanComplete = true;
+		for(const Minable &minable : asteroids.Minables())
 		{
-			if(!object.HasSprite() || !object.HasValidPlanet() || !object.GetPlanet()->IsAccessible(flagship.get()))
+			if(asteroidsScanned.count(minable.DisplayName()))
 				continue;
 
-			Point pos = object.Position() - center;
-			if(pos.Length() - object.Radius() < 600. / zoom)
-				labels.emplace_back(pos, object, currentSystem, zoom);
+			// Autocatalog asteroid: Record that the player knows this type of asteroid is available here.
+			scanComplete = false;
+			// Use the squared length, as we used the squared scan range.
+			bool inRange = (minable.Position() - center).LengthSquared() <= scanRangeMetric;
+			if(!Random::Int(10) && inRange)
+			{
+				asteroidsScanned.insert(minable.DisplayName());
+				for(const auto &it : minable.Payload())
+					player.Harvest(it.first);
+			}
 		}
+		if(scanComplete)
+			isAsteroidCatalogComplete = true;
 	}
+}
 
-	if(flagship && flagship->IsOverheated())
-		Messages::Add("Your ship has overheated.", Messages::Importance::Highest);
 
-	// Clear the HUD information from the previous frame.
-	info = Information();
-	if(flagship && flagship->Hull())
-	{
-		Point shipFacingUnit(0., -1.);
-		if(Preferences::Has("Rotate flagship in HUD"))
-			shipFacingUnit = flagship->Facing().Unit();
 
-		info.SetSprite("player sprite", flagship->GetSprite(), shipFacingUnit, flagship->GetFrame(step));
+// Begin the next step of calculations.
+void Engine::Go()
+{
+	{
+		unique_lock<mutex> lock(swapMutex);
+		++step;
+		calcTickTock = !calcTickTock;
+		hasFinishedCalculating = false;
 	}
-	if(currentSystem)
-		info.SetString("location", currentSystem->Name());
-	info.SetString("date", player.GetDate().ToString());
-	if(flagship)
+	condition.notify_all();
+
+	if(Replay::Recording())
+		Replay::Recording()->EndStep();
+}
+
+
+
+// Pass the list of game events to MainPanel for handling by the player, and any
+// UI element generation.
+vector<ShipEvent> &Engine::Events()
+{
+	return events;
+}
+
+
+
+// Draw a frame.
+void Engine::Draw() const
+{
+	const Snapshot &snapshot = snapshots[drawTickTock];
+	// Anything not timed by one of the nested zones below counts as the HUD.
+	GpuProfiler::Zone hudZone("GPU: HUD");
+
+	// The background, planet labels and everything in the draw lists make up
+	// the scene, which is drawn at a reduced resolution if the graphics card is
+	// falling behind. The overlays and HUD drawn after it stay sharp.
+	sceneResolution.Begin();
 	{
-		// Have an alarm label flash up when enemy ships are in the system
-		if(alarmTime && step / 20 % 2 && Preferences::DisplayVisualAlert())
-			info.SetCondition("red alert");
-		double fuelCap = flagship->Attributes().Get("fuel capacity");
-		// If the flagship has a large amount of fuel, display a solid bar.
-		// Otherwise, display a segment for every 100 units of fuel.
-		if(fuelCap <= MAX_FUEL_DISPLAY)
-			info.SetBar("fuel", flagship->Fuel(), fuelCap * .01);
-		else
-			info.SetBar("fuel", flagship->Fuel());
-		info.SetBar("energy", flagship->Energy());
-		double heat = flagship->Heat();
-		info.SetBar("heat", min(1., heat));
-		// If heat is above 100%, draw a second overlaid bar to indicate the
-		// total heat level.
-		if(heat > 1.)
-			info.SetBar("overheat", min(1., heat - 1.));
-		if(flagship->IsOverheated() && (step / 20) % 2)
-			info.SetBar("overheat blink", min(1., heat));
-		info.SetBar("shields", flagship->Shields());
-		info.SetBar("hull", flagship->Hull(), 20.);
-		info.SetBar("disabled hull", min(flagship->Hull(), flagship->DisabledHull()), 20.);
+		GpuProfiler::Zone zone("GPU: background");
+		GameData::Background().Draw(center, centerVelocity, zoom, (player.Flagship() ?
+			player.Flagship()->GetSystem() : player.GetSystem()));
 	}
-	info.SetString("credits",
-		Format::CreditString(player.Accounts().Credits()));
-	bool isJumping = flagship && (flagship->Commands().Has(Command::JUMP) || flagship->IsEnteringHyperspace());
-	if(flagship && flagship->GetTargetStellar() && !isJumping)
+	static const Set<Color> &colors = GameData::Colors();
+	const Interface *hud = GameData::Interfaces().Get("hud");
+
 	{
-		const StellarObject *object = flagship->GetTargetStellar();
-		string navigationMode = flagship->Commands().Has(Command::LAND) ? "Landing on:" :
-			object->GetPlanet() && object->GetPlanet()->CanLand(*flagship) ? "Can land on:" :
-			"Cannot land on:";
-		info.SetString("navigation mode", navigationMode);
-		const string &name = object->Name();
-		info.SetString("destination", name);
+		GpuProfiler::Zone zone("GPU: sprites");
+		// Draw any active planet labels.
+		for(const PlanetLabel &label : snapshot.labels)
+			label.Draw();
 
-		targets.push_back({
-			object->Position() - center,
-			object->Facing(),
-			object->Radius(),
-			GetPlanetTargetPointerColor(*object->GetPlanet()),
-			5});
+		draw[drawTickTock].Draw();
 	}
-	else if(flagship && flagship->GetTargetSystem())
 	{
-		info.SetString("navigation mode", "Hyperspace:");
-		if(player.HasVisited(*flagship->GetTargetSystem()))
-			info.SetString("destination", flagship->GetTargetSystem()->Name());
-		else
-			info.SetString("destination", "unexplored system");
+		GpuProfiler::Zone zone("GPU: effects");
+		batchDraw[drawTickTock].Draw();
 	}
-	else
-	{
-		info.SetString("navigation mode", "Navigation:");
-		info.SetString("destination", "no destination");
-	}
-	// Use the radar that was just populated. (The draw tick-tock has not
-	// yet been toggled, but it will be at the end of this function.)
-	shared_ptr<const Ship> target;
-	shared_ptr<const Minable> targetAsteroid;
-	targetVector = Point();
-	if(flagship)
-	{
-		target = flagship->GetTargetShip();
-		targetAsteroid = flagship->GetTargetAsteroid();
-		// Record that the player knows this type of asteroid is available here.
-		if(targetAsteroid)
-			for(const auto &it : targetAsteroid->Payload())
-				player.Harvest(it.first);
-	}
-	if(!target)
-		targetSwizzle = -1;
-	if(!target && !targetAsteroid)
-		info.SetString("target name", "no target");
-	else if(!target)
-	{
-		info.SetSprite("target sprite",
-			targetAsteroid->GetSprite(),
-			targetAsteroid->Facing().Unit(),
-			targetAsteroid->GetFrame(step));
-		info.SetString("target name", targetAsteroid->DisplayName() + " " + targetAsteroid->Noun());
-
-		targetVector = targetAsteroid->Position() - center;
-
-		if(flagship->Attributes().Get("tactical scan power"))
-		{
-			info.SetCondition("range display");
-			info.SetBar("target hull", targetAsteroid->Hull(), 20.);
-			int targetRange = round(targetAsteroid->Position().Distance(flagship->Position()));
-			info.SetString("target range", to_string(targetRange));
-		}
-	}
-	else
-	{
-		if(target->GetSystem() == player.GetSystem() && target->Cloaking() < 1.)
-			targetUnit = target->Facing().Unit();
-		info.SetSprite("target sprite", target->GetSprite(), targetUnit, target->GetFrame(step));
-		info.SetString("target name", target->Name());
-		info.SetString("target type", target->ModelName());
-		if(!target->GetGovernment())
-			info.SetString("target government", "No Government");
-		else
-			info.SetString("target government", target->GetGovernment()->GetName());
-		targetSwizzle = target->GetSwizzle();
-		info.SetString("mission target", target->GetPersonality().IsTarget() ? "(mission target)" : "");
-
-		int targetType = RadarType(*target, step);
-		info.SetOutlineColor(GetTargetOutlineColor(targetType));
-		if(target->GetSystem() == player.GetSystem() && target->IsTargetable())
-		{
-			info.SetBar("target shields", target->Shields());
-			info.SetBar("target hull", target->Hull(), 20.);
-			info.SetBar("target disabled hull", min(target->Hull(), target->DisabledHull()), 20.);
-
-			// The target area will be a square, with sides proportional to the average
-			// of the width and the height of the sprite.
-			double size = (target->Width() + target->Height()) * .35;
-			targets.push_back({
-				target->Position() - center,
-				Angle(45.) + target->Facing(),
-				size,
-				GetShipTargetPointerColor(targetType),
-				4});
-
-			targetVector = target->Position() - center;
-
-			// Check if the target is close enough to show tactical information.
-			double tacticalRange = 100. * sqrt(flagship->Attributes().Get("tactical scan power"));
-			double targetRange = target->Position().Distance(flagship->Position());
-			if(tacticalRange)
-			{
-				info.SetCondition("range display");
-				info.SetString("target range", to_string(static_cast<int>(round(targetRange))));
-			}
-			// Actual tactical information requires a scrutable
-			// target that is within the tactical scanner range.
-			if((targetRange <= tacticalRange && !target->Attributes().Get("inscrutable"))
-					|| (tacticalRange && target->IsYours()))
-			{
-				info.SetCondition("tactical display");
-				info.SetString("target crew", to_string(target->Crew()));
-				int fuel = round(target->Fuel() * target->Attributes().Get("fuel capacity"));
-				info.SetString("target fuel", to_string(fuel));
-				int energy = round(target->Energy() * target->Attributes().Get("energy capacity"));
-				info.SetString("target energy", to_string(energy));
-				int heat = round(100. * target->Heat());
-				info.SetString("target heat", to_string(heat) + "%");
-			}
-		}
-	}
-	if(target && target->IsTargetable() && target->GetSystem() == currentSystem
-		&& (flagship->CargoScanFraction() || flagship->OutfitScanFraction()))
-	{
-		double width = max(target->Width(), target->Height());
-		Point pos = target->Position() - center;
-		statuses.emplace_back(pos, flagship->OutfitScanFraction(), flagship->CargoScanFraction(),
-			0, 10. + max(20., width * .5), 2, Angle(pos).Degrees() + 180.);
-	}
-	// Handle any events that change the selected ships.
-	if(groupSelect >= 0)
-	{
-		// This has to be done in Step() to avoid race conditions.
-		if(hasControl)
-			player.SetGroup(groupSelect);
-		else
-			player.SelectGroup(groupSelect, hasShift);
-		groupSelect = -1;
-	}
-	if(doClickNextStep)
-	{
-		// If a click command is issued, always wait until the next step to act
-		// on it, to avoid race conditions.
-		doClick = true;
-		doClickNextStep = false;
-	}
-	else
-		doClick = false;
-
-	if(doClick && !isRightClick)
-	{
-		if(uiClickBox.Dimensions())
-			doClick = !ammoDisplay.Click(uiClickBox);
-		else
-			doClick = !ammoDisplay.Click(clickPoint, hasControl);
-		if(doClick && clickBox.Dimensions())
-		{
-			doClick = !player.SelectShips(clickBox, hasShift);
-		}
-		if(doClick)
-		{
-			const vector<const Ship *> &stack = escorts.Click(clickPoint);
-			if(!stack.empty())
-				doClick = !player.SelectShips(stack, hasShift);
-			else
-				clickPoint /= isRadarClick ? RADAR_SCALE : zoom;
-		}
-	}
-
-	// Draw crosshairs on all the selected ships.
-	for(const weak_ptr<Ship> &selected : player.SelectedShips())
-	{
-		shared_ptr<Ship> ship = selected.lock();
-		if(ship && ship != target && !ship->IsParked() && ship->GetSystem() == player.GetSystem()
-				&& !ship->IsDestroyed() && ship->Zoom() > 0.)
-		{
-			double size = (ship->Width() + ship->Height()) * .35;
-			targets.push_back({
-				ship->Position() - center,
-				Angle(45.) + ship->Facing(),
-				size,
-				*GameData::Colors().Get("ship target pointer player"),
-				4});
-		}
-	}
-
-	// Draw crosshairs on any minables in range of the flagship's scanners.
-	bool shouldShowAsteroidOverlay = Preferences::Has("Show asteroid scanner overlay");
-	// Decide before looping whether or not to catalog asteroids. This
-	// results in cataloging in-range asteroids roughly 3 times a second.
-	bool shouldCatalogAsteroids = (!isAsteroidCatalogComplete && !Random::Int(20));
-	if(shouldShowAsteroidOverlay || shouldCatalogAsteroids)
-	{
-		double scanRangeMetric = flagship ? 10000. * flagship->Attributes().Get("asteroid scan power") : 0.;
-		if(flagship && scanRangeMetric && !flagship->IsHyperspacing())
-		{
-			bool scanComplete = true;
-			for(const shared_ptr<Minable> &minable : asteroids.Minables())
-			{
-				Point offset = minable->Position() - center;
-				// Use the squared length, as we used the squared scan range.
-				bool inRange = offset.LengthSquared() <= scanRangeMetric;
-
-				// Autocatalog asteroid: Record that the player knows this type of asteroid is available here.
-				if(shouldCatalogAsteroids && !asteroidsScanned.count(minable->DisplayName()))
-				{
-					scanComplete = false;
-					if(!Random::Int(10) && inRange)
-					{
-						asteroidsScanned.insert(minable->DisplayName());
-						for(const auto &it : minable->Payload())
-							player.Harvest(it.first);
-					}
-				}
-
-				if(!shouldShowAsteroidOverlay || !inRange || flagship->GetTargetAsteroid() == minable)
-					continue;
-
-				targets.push_back({
-					offset,
-					minable->Facing(),
-					.8 * minable->Radius(),
-					GetMinablePointerColor(false),
-					3
-				});
-			}
-			if(shouldCatalogAsteroids && scanComplete)
-				isAsteroidCatalogComplete = true;
-		}
-	}
-	const auto targetAsteroidPtr = flagship ? flagship->GetTargetAsteroid() : nullptr;
-	if(targetAsteroidPtr && !flagship->IsHyperspacing())
-		targets.push_back({
-			targetAsteroidPtr->Position() - center,
-			targetAsteroidPtr->Facing(),
-			.8 * targetAsteroidPtr->Radius(),
-			GetMinablePointerColor(true),
-			3
-		});
-}
-
-
-
-// Begin the next step of calculations.
-void Engine::Go()
-{
-	{
-		unique_lock<mutex> lock(swapMutex);
-		++step;
-		calcTickTock = !calcTickTock;
-		hasFinishedCalculating = false;
-	}
-	condition.notify_all();
-}
-
-
-
-// Pass the list of game events to MainPanel for handling by the player, and any
-// UI element generation.
-list<ShipEvent> &Engine::Events()
-{
-	return events;
-}
-
-
-
-// Draw a frame.
-void Engine::Draw() const
-{
-	GameData::Background().Draw(center, centerVelocity, zoom, (player.Flagship() ?
-		player.Flagship()->GetSystem() : player.GetSystem()));
-	static const Set<Color> &colors = GameData::Colors();
-	const Interface *hud = GameData::Interfaces().Get("hud");
-
-	// Draw any active planet labels.
-	for(const PlanetLabel &label : labels)
-		label.Draw();
-
-	draw[drawTickTock].Draw();
-	batchDraw[drawTickTock].Draw();
-
-	for(const auto &it : statuses)
+	sceneResolution.End();
+
+	for(const auto &it : snapshot.statuses)
 	{
 		static const Color color[11] = {
 			*colors.Get("overlay friendly shields"),
@@ -1026,16 +986,17 @@ void Engine::Draw() const
 	}
 
 	// Draw labels on missiles
-	for(const AlertLabel &label : missileLabels)
+	for(const AlertLabel &label : snapshot.missileLabels)
 		label.Draw();
 
 	// Draw the flagship highlight, if any.
-	if(highlightSprite)
+	if(snapshot.highlightSprite)
 	{
-		Point size(highlightSprite->Width(), highlightSprite->Height());
+		Point size(snapshot.highlightSprite->Width(), snapshot.highlightSprite->Height());
 		const Color &color = *colors.Get("flagship highlight");
 		// The flagship is always in the dead center of the screen.
-		OutlineShader::Draw(highlightSprite, Point(), size, color, highlightUnit, highlightFrame);
+		OutlineShader::Draw(snapshot.highlightSprite, Point(), size, color,
+			snapshot.highlightUnit, snapshot.highlightFrame);
 	}
 
 	if(flash)
@@ -1076,7 +1037,7 @@ void Engine::Draw() const
 	}
 
 	// Draw crosshairs around anything that is targeted.
-	for(const Target &target : targets)
+	for(const Target &target : snapshot.targets)
 	{
 		Angle a = target.angle;
 		Angle da(360. / target.count);
@@ -1091,33 +1052,34 @@ void Engine::Draw() const
 	}
 
 	// Draw the heads-up display.
-	hud->Draw(info);
+	hud->Draw(snapshot.info);
 	if(hud->HasPoint("radar"))
 	{
+		GpuProfiler::Zone zone("GPU: radar");
 		radar[drawTickTock].Draw(
 			hud->GetPoint("radar"),
 			RADAR_SCALE,
 			hud->GetValue("radar radius"),
 			hud->GetValue("radar pointer radius"));
 	}
-	if(hud->HasPoint("target") && targetVector.Length() > 20.)
+	if(hud->HasPoint("target") && snapshot.targetVector.Length() > 20.)
 	{
 		Point center = hud->GetPoint("target");
 		double radius = hud->GetValue("target radius");
-		PointerShader::Draw(center, targetVector.Unit(), 10.f, 10.f, radius, Color(1.f));
+		PointerShader::Draw(center, snapshot.targetVector.Unit(), 10.f, 10.f, radius, Color(1.f));
 	}
 
 	// Draw the faction markers.
-	if(targetSwizzle >= 0 && hud->HasPoint("faction markers"))
+	if(snapshot.targetSwizzle >= 0 && hud->HasPoint("faction markers"))
 	{
-		int width = font.Width(info.GetString("target government"));
+		int width = font.Width(snapshot.info.GetString(INFO_TARGET_GOVERNMENT));
 		Point center = hud->GetPoint("faction markers");
 
 		const Sprite *mark[2] = {SpriteSet::Get("ui/faction left"), SpriteSet::Get("ui/faction right")};
 		// Round the x offsets to whole numbers so the icons are sharp.
 		double dx[2] = {(width + mark[0]->Width() + 1) / -2, (width + mark[1]->Width() + 1) / 2};
 		for(int i = 0; i < 2; ++i)
-			SpriteShader::Draw(mark[i], center + Point(dx[i], 0.), 1., targetSwizzle);
+			SpriteShader::Draw(mark[i], center + Point(dx[i], 0.), 1., snapshot.targetSwizzle);
 	}
 	if(jumpCount && Preferences::Has("Show mini-map"))
 		MapPanel::DrawMiniMap(player, .5f * min(1.f, jumpCount / 30.f), jumpInProgress, step);
@@ -1132,11 +1094,7 @@ void Engine::Draw() const
 	}
 
 	// Draw escort status.
-	escorts.Draw(hud->GetBox("escorts"));
-
-	// Upload any preloaded sprites that are now available. This is to avoid
-	// filling the entire backlog of sprites before landing on a planet.
-	GameData::ProcessSprites();
+	snapshot.escorts.Draw(hud->GetBox("escorts"));
 
 	// Draw a onscreen joystick in the bottom left corner, if enabled
 	if(Preferences::Has("Onscreen Joystick"))
@@ -1160,9 +1118,31 @@ void Engine::Draw() const
 	if(Preferences::Has("Show CPU / GPU load"))
 	{
 		string loadString = to_string(lround(load * 100.)) + "% CPU";
+		if(repeatedFrames)
+			loadString = to_string(repeatedFrames) + " repeated frames, " + loadString;
 		Color color = *colors.Get("medium");
 		font.Draw(loadString,
 			Point(-10 - font.Width(loadString), Screen::Height() * -.5 + 5.), color);
+
+		// If the profiler is running, show how long each part of a step takes.
+		if(Profiler::IsEnabled())
+		{
+			// Each line lists the median, 95th percentile, and worst time.
+			Point pos(-10., Screen::Height() * -.5 + 25.);
+			for(const Profiler::Summary &zone : profile)
+			{
+				string line = string(zone.name) + ": " + Format::Decimal(zone.median, 2) + " / "
+					+ Format::Decimal(zone.p95, 2) + " / " + Format::Decimal(zone.max, 2) + " ms";
+				font.Draw(line, pos - Point(font.Width(line), 0.), color);
+				pos.Y() += 20.;
+			}
+			for(const Profiler::Counter &counter : profileCounters)
+			{
+				string line = string(counter.name) + ": " + Format::Decimal(counter.value, 1);
+				font.Draw(line, pos - Point(font.Width(line), 0.), color);
+				pos.Y() += 20.;
+			}
+		}
 	}
 }
 
@@ -1178,6 +1158,15 @@ void Engine::SetTestContext(TestContext &newTestContext)
 
 // Select the object the player clicked on.
 void Engine::Click(const Point &from, const Point &to, bool hasShift, bool hasControl)
+{
+	if(Replay::Recording())
+		Replay::Recording()->AddInput(Replay::Input(Replay::InputType::CLICK, from, to, 0, hasShift, hasControl));
+	QueueClick(from, to, hasShift, hasControl);
+}
+
+
+
+void Engine::QueueClick(const Point &from, const Point &to, bool hasShift, bool hasControl)
 {
 	// First, see if this is a click on an escort icon.
 	doClickNextStep = true;
@@ -1208,6 +1197,8 @@ void Engine::Click(const Point &from, const Point &to, bool hasShift, bool hasCo
 
 void Engine::RClick(const Point &point)
 {
+	if(Replay::Recording())
+		Replay::Recording()->AddInput(Replay::Input(Replay::InputType::RIGHT_CLICK, point));
 	doClickNextStep = true;
 	hasShift = false;
 	isRightClick = true;
@@ -1226,6 +1217,9 @@ void Engine::RClick(const Point &point)
 
 void Engine::SelectGroup(int group, bool hasShift, bool hasControl)
 {
+	if(Replay::Recording())
+		Replay::Recording()->AddInput(Replay::Input(Replay::InputType::GROUP, Point(), Point(), group,
+			hasShift, hasControl));
 	groupSelect = group;
 	this->hasShift = hasShift;
 	this->hasControl = hasControl;
@@ -1245,7 +1239,13 @@ bool Engine::FingerDown(const Point &p, int fid)
 			isDoubleTap = true;
 		}
 		last_tap_stamp = now;
-		Click(p, p, false, false);
+		if(Replay::Recording())
+		{
+			Replay::Input input(Replay::InputType::FINGER_DOWN, p, Point(), fid);
+			input.isDoubleTap = isDoubleTap;
+			Replay::Recording()->AddInput(input);
+		}
+		QueueClick(p, p, false, false);
 	}
 
 	// Returning true here means don't convert this to a normal mouse click
@@ -1259,6 +1259,8 @@ bool Engine::FingerUp(const Point &p, int fid)
 {
 	if(fid == isFingerDown)
 	{
+		if(Replay::Recording())
+			Replay::Recording()->AddInput(Replay::Input(Replay::InputType::FINGER_UP, p, Point(), fid));
 		isTouch = true;
 		isFingerDown = -1;
 		isDoubleTap = false;
@@ -1291,6 +1293,8 @@ bool Engine::FingerMove(const Point &p, int fid)
 {
 	if(fid == isFingerDown)
 	{
+		if(Replay::Recording())
+			Replay::Recording()->AddInput(Replay::Input(Replay::InputType::FINGER_MOVE, p, Point(), fid));
 		isTouch = true;
 
 		// Determine if the left-click was within the radar display.
@@ -1317,6 +1321,13 @@ bool Engine::FingerMove(const Point &p, int fid)
 
 
 
+int Engine::TouchFinger() const
+{
+	return isFingerDown;
+}
+
+
+
 // Break targeting on all projectiles between the player and the given
 // government; gov projectiles stop targeting the player and player's
 // projectiles stop targeting gov.
@@ -1355,8 +1366,9 @@ void Engine::EnterSystem()
 		+ today.ToString() + (system->IsInhabited(flagship) ?
 			"." : ". No inhabited planets detected."), Messages::Importance::High);
 
-	// Preload landscapes and determine if the player used a wormhole.
-	// (It is allowed for a wormhole's exit point to have no sprite.)
+	// Preload landscapes, unless that was done during the jump, and determine if
+	// the player used a wormhole. (It is allowed for a wormhole's exit point to
+	// have no sprite.)
 	const StellarObject *usedWormhole = nullptr;
 	for(const StellarObject &object : system->Objects())
 		if(object.HasValidPlanet())
@@ -1397,15 +1409,20 @@ void Engine::EnterSystem()
 		}
 	}
 
-	asteroids.Clear();
-	for(const System::Asteroid &a : system->Asteroids())
-	{
-		// Check whether this is a minable or an ordinary asteroid.
-		if(a.Type())
-			asteroids.Add(a.Type(), a.Count(), a.Energy(), system->AsteroidBelts());
-		else
-			asteroids.Add(a.Name(), a.Count(), a.Energy());
-	}
+	// Start copying the ships that are likely to enter this system later on,
+	// unless that was already started when the jump began.
+	spawnPool.Prepare(*system);
+
+	// Swap in the asteroid field that was filled during the jump, if there is one.
+	const bool isPrepared = (arrivalSystem == system && arrivalBuild.valid());
+	if(arrivalBuild.valid())
+		arrivalBuild.get();
+	if(isPrepared)
+		asteroids.Swap(arrivalAsteroids);
+	else
+		FillAsteroids(asteroids, *system, AsteroidSprites(*system));
+	arrivalSystem = nullptr;
+	arrivalAsteroids.Clear();
 	asteroidsScanned.clear();
 	isAsteroidCatalogComplete = false;
 
@@ -1418,7 +1435,7 @@ void Engine::EnterSystem()
 	{
 		for(const auto &fleet : system->Fleets())
 			if(fleet.Get()->GetGovernment() && Random::Int(fleet.Period()) < 60)
-				fleet.Get()->Place(*system, newShips);
+				fleet.Get()->Place(*system, newShips, true, true, &spawnPool);
 
 		auto CreateWeather = [this](const RandomEvent<Hazard> &hazard, Point origin)
 		{
@@ -1445,7 +1462,7 @@ void Engine::EnterSystem()
 			for(int i = 0; i < 10; ++i)
 				if(Random::Real() < attraction)
 				{
-					raidFleet.GetFleet()->Place(*system, newShips);
+					raidFleet.GetFleet()->Place(*system, newShips, true, true, &spawnPool);
 					Messages::Add("Your fleet has attracted the interest of a "
 							+ raidFleet.GetFleet()->GetGovernment()->GetName() + " raiding party.",
 							Messages::Importance::Highest);
@@ -1456,10 +1473,12 @@ void Engine::EnterSystem()
 
 	projectiles.clear();
 	visuals.clear();
-	flotsam.clear();
+	particles.Clear();
+	flotsam.Clear();
 	// Cancel any projectiles, visuals, or flotsam created by ships this step.
 	newProjectiles.clear();
 	newVisuals.clear();
+	newParticles.clear();
 	newFlotsam.clear();
 
 	// Help message for new players. Show this message for the first four days,
@@ -1473,9 +1492,75 @@ void Engine::EnterSystem()
 
 
 
+// The jump animation lasts long enough to load most of what the destination
+// needs, so instead of doing it all on arrival, begin as soon as the jump does.
+void Engine::PrepareArrival(const System &system)
+{
+	if(arrivalSystem == &system)
+		return;
+	if(arrivalBuild.valid())
+		arrivalBuild.get();
+	arrivalSystem = &system;
+
+	GameData::PreloadSystem(system);
+	spawnPool.Prepare(system);
+
+	// The asteroid field draws random numbers as it is filled, so it can only be
+	// filled on another thread if that thread has a generator of its own. It
+	// draws from a stream seeded by the main generator, so the same seed still
+	// gives the same asteroids.
+	if(!Random::IsThreadLocal())
+		return;
+	const uint64_t seed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+	vector<const Sprite *> sprites = AsteroidSprites(system);
+	arrivalBuild = async(launch::async, [this, &system, sprites, seed]() -> void
+		{
+			Random::Stream stream(seed);
+			FillAsteroids(arrivalAsteroids, system, sprites);
+		});
+}
+
+
+
+// Keep track of how many frames had to be drawn without a new step.
+void Engine::CountFrame(bool isRepeated)
+{
+	repeatedSum += isRepeated;
+	if(++frameCount == 60)
+	{
+		repeatedFrames = repeatedSum;
+		repeatedSum = 0;
+		frameCount = 0;
+	}
+}
+
+
+
+int64_t Engine::ObjectBytes() const
+{
+	int64_t bytes = VectorBytes(ships) + VectorBytes(projectiles) + VectorBytes(activeWeather)
+		+ VectorBytes(visuals) + VectorBytes(newProjectiles) + VectorBytes(newFlotsam) + VectorBytes(newVisuals)
+		+ VectorBytes(newParticles) + VectorBytes(hasAntiMissile) + VectorBytes(flotsamPositions) + VectorBytes(shipHits)
+		+ VectorBytes(nearbyShips) + VectorBytes(groupedShips) + VectorBytes(groupStart) + VectorBytes(groupSeeds)
+		+ VectorBytes(stepBuffers) + VectorBytes(flotsamCollectors) + VectorBytes(weatherHits);
+	bytes += flotsam.size() * sizeof(Flotsam);
+	for(const vector<Body *> &collectors : flotsamCollectors)
+		bytes += VectorBytes(collectors);
+	for(const vector<Body *> &hits : weatherHits)
+		bytes += VectorBytes(hits);
+	for(const StepBuffer &buffer : stepBuffers)
+		bytes += VectorBytes(buffer.projectiles) + VectorBytes(buffer.flotsam) + VectorBytes(buffer.visuals)
+			+ VectorBytes(buffer.particles) + VectorBytes(buffer.antiMissile);
+	return bytes;
+}
+
+
+
 // Thread entry point.
 void Engine::ThreadEntryPoint()
 {
+	ThreadPlacement::Assign(ThreadPlacement::Role::SIMULATION);
+
 	while(true)
 	{
 		{
@@ -1502,12 +1587,19 @@ void Engine::ThreadEntryPoint()
 void Engine::CalculateStep()
 {
 	FrameTimer loadTimer;
+	Profiler::Zone stepZone("Engine::CalculateStep");
 
 	// If there is a pending zoom update then use it
 	// because the zoom will get updated in the main thread
 	// as soon as the calculation thread is finished.
 	const double zoom = nextZoom ? nextZoom : this->zoom;
 
+	if(hasCalcSeed)
+	{
+		Random::Seed(calcSeed);
+		hasCalcSeed = false;
+	}
+
 	// Clear the list of objects to draw.
 	draw[calcTickTock].Clear(step, zoom);
 	batchDraw[calcTickTock].Clear(step, zoom);
@@ -1516,15 +1608,17 @@ void Engine::CalculateStep()
 	if(!player.GetSystem())
 		return;
 
+	// Take the commands the player has given since the last step.
+	Command commands = playerCommands.Take();
 	// Handle the mouse input of the mouse navigation
-	HandleMouseInput(activeCommands);
+	HandleMouseInput(commands);
 	// Handle gamepad input
-	HandleGamepadInput(activeCommands);
+	HandleGamepadInput(commands);
 	// Now, all the ships must decide what they are doing next.
-	ai.Step(player, activeCommands);
-
-	// Clear the active players commands, they are all processed at this point.
-	activeCommands.Clear();
+	{
+		Profiler::Zone zone("AI");
+		ai.Step(player, commands);
+	}
 
 	// Perform actions for all the game objects. In general this is ordered from
 	// bottom to top of the draw stack, but in some cases one object type must
@@ -1540,8 +1634,10 @@ void Engine::CalculateStep()
 	const Ship *flagship = player.Flagship();
 	bool wasHyperspacing = (flagship && flagship->IsEnteringHyperspace());
 	// Move all the ships.
-	for(const shared_ptr<Ship> &it : ships)
-		MoveShip(it);
+	{
+		Profiler::Zone zone("Move ships");
+		MoveShips(flagship);
+	}
 	// If the flagship just began jumping, play the appropriate sound.
 	if(!wasHyperspacing && flagship && flagship->IsEnteringHyperspace())
 	{
@@ -1553,6 +1649,9 @@ void Engine::CalculateStep()
 		else
 			for(const auto &sound : jumpSounds)
 				Audio::Play(sound.first);
+
+		if(flagship->GetTargetSystem())
+			PrepareArrival(*flagship->GetTargetSystem());
 	}
 	// Check if the flagship just entered a new system.
 	if(flagship && playerSystem != flagship->GetSystem())
@@ -1574,194 +1673,717 @@ void Engine::CalculateStep()
 		doFlash = Preferences::Has("Show hyperspace flash");
 		playerSystem = flagship->GetSystem();
 		player.SetSystem(*playerSystem);
+		// A new day may bring events that change the universe, so no routes may
+		// be in the middle of being found.
+		RoutePlanner::Wait();
 		EnterSystem();
+
+		// Mission NPCs that were waiting for the player to arrive here are
+		// created and placed now.
+		for(const list<shared_ptr<Ship>> &npcShips : player.MaterializeMissionNPCs())
+			PlaceNPCShips(npcShips, player.FlagshipPtr());
 	}
 	Prune(ships);
 
 	// Move the asteroids. This must be done before collision detection. Minables
 	// may create visuals or flotsam.
-	asteroids.Step(newVisuals, newFlotsam, step);
+	{
+		Profiler::Zone zone("Asteroids");
+		asteroids.Step(newVisuals, newFlotsam, step);
+	}
 
 	// Move the flotsam. This must happen after the ships move, because flotsam
 	// checks if any ship has picked it up.
-	for(const shared_ptr<Flotsam> &it : flotsam)
-		it->Move(newVisuals);
-	Prune(flotsam);
+	for(Flotsam &it : flotsam)
+		it.Move(newVisuals);
+	flotsam.Prune();
 
 	// Move the projectiles.
-	for(Projectile &projectile : projectiles)
-		projectile.Move(newVisuals, newProjectiles);
-	Prune(projectiles);
+	{
+		Profiler::Zone zone("Projectiles");
+		for(Projectile &projectile : projectiles)
+			projectile.Move(newVisuals, newProjectiles);
+		Prune(projectiles);
+	}
 
 	// Step the weather.
-	for(Weather &weather : activeWeather)
-		weather.Step(newVisuals, flagship ? flagship->Position() : center);
-	Prune(activeWeather);
+	{
+		Profiler::Zone zone("Weather");
+		for(Weather &weather : activeWeather)
+			weather.Step(newVisuals, flagship ? flagship->Position() : center);
+		Prune(activeWeather);
+	}
 
-	// Move the visuals.
-	for(Visual &visual : visuals)
-		visual.Move();
-	Prune(visuals);
+	// Move the visuals. Any that are too far away to ever be seen are removed.
+	visualBudget.SetView(center, centerVelocity, zoom);
+	visualBudget.Step(visuals);
+	particles.Step(step);
+	const size_t oldVisuals = visuals.size();
 
 	// Perform various minor actions.
 	SpawnFleets();
 	SpawnPersons();
 	GenerateWeather();
 	SendHails();
-	HandleMouseClicks();
-	HandleTouchEvents();
+	Command clicks;
+	HandleMouseClicks(clicks);
+	HandleTouchEvents(clicks);
+	clickCommands.Add(clicks);
+
+	// Now, take the new objects that were generated this step and splice them
+	// on to the ends of the respective lists of objects. These new objects will
+	// be drawn this step (and the projectiles will participate in collision
+	// detection) but they should not be moved, which is why we put off adding
+	// them to the lists until now.
+	Append(ships, newShips);
+	Append(projectiles, newProjectiles);
+	flotsam.Append(newFlotsam);
+	Append(visuals, newVisuals);
+
+	// Decrement the count of how long it's been since a ship last asked for help.
+	if(grudgeTime)
+		--grudgeTime;
+
+	{
+		Profiler::Zone zone("Collisions");
+		// Populate the collision detection lookup sets.
+		FillCollisionSets();
+
+		// Perform collision detection.
+		if(hasAntiMissile.size() >= ANTI_MISSILE_GRID_COUNT)
+		{
+			antiMissilePositions.clear();
+			antiMissileRanges.clear();
+			for(const Ship *ship : hasAntiMissile)
+			{
+				antiMissilePositions.push_back(ship->Position());
+				antiMissileRanges.push_back(ship->AntiMissileRange());
+			}
+			antiMissileGrid.Build(antiMissilePositions, antiMissileRanges);
+		}
+		FindShipHits();
+		// Set off every explosion first, so that the ships caught in all the
+		// blasts can be found at once. The damage is still dealt one projectile
+		// at a time, in order, since each hit depends on the ship's state after
+		// the hits before it.
+		blastCount = 0;
+		for(size_t i = 0; i < projectiles.size(); ++i)
+			if(ResolveHit(projectiles[i], shipHits[i]) && projectiles[i].GetWeapon().BlastRadius())
+			{
+				if(blastCount == blasts.size())
+					blasts.emplace_back();
+				Blast &blast = blasts[blastCount++];
+				blast.projectile = i;
+				blast.position = projectiles[i].Position() + shipHits[i].distance * projectiles[i].Velocity();
+				blast.radius = projectiles[i].GetWeapon().BlastRadius();
+			}
+		FindBlastShips();
+
+		size_t nextBlast = 0;
+		for(size_t i = 0; i < projectiles.size(); ++i)
+		{
+			bool isBlast = (nextBlast < blastCount && blasts[nextBlast].projectile == i);
+			DoCollisions(projectiles[i], shipHits[i], isBlast ? &blasts[nextBlast++].ships : nullptr);
+		}
+	}
+	// Now that collision detection is done, clear the cache of ships with anti-
+	// missile systems ready to fire.
+	hasAntiMissile.clear();
+
+	// Damage ships from any active weather events.
+	DoWeather();
+
+	// Check for flotsam collection (collisions with ships). Which ships are
+	// close enough to each piece of flotsam can be found all at once.
+	flotsamPositions.clear();
+	for(const Flotsam &it : flotsam)
+		flotsamPositions.push_back(it.Position());
+	if(flotsamPositions.size() < BATCH_FLOTSAM_COUNT)
+		shipCollisions.Circles(flotsamPositions, 5., flotsamCollectors);
+	else
+	{
+		flotsamCollectors.resize(flotsamPositions.size());
+		const size_t blocks = (flotsamPositions.size() + FLOTSAM_BLOCK_SIZE - 1) / FLOTSAM_BLOCK_SIZE;
+		jobs.ParallelFor(blocks, [this](size_t block)
+		{
+			const size_t end = min(flotsamPositions.size(), (block + 1) * FLOTSAM_BLOCK_SIZE);
+			for(size_t i = block * FLOTSAM_BLOCK_SIZE; i < end; ++i)
+				shipCollisions.Circle(flotsamPositions[i], 5., flotsamCollectors[i]);
+		});
+	}
+	auto collectors = flotsamCollectors.begin();
+	for(Flotsam &it : flotsam)
+		DoCollection(it, *collectors++);
+
+	// Check for ship scanning.
+	for(const shared_ptr<Ship> &it : ships)
+		DoScanning(it);
+
+	// Add the particles created this step, by ships or by collisions.
+	particles.Append(newParticles, step, visuals);
+
+	// Draw the objects. Start by figuring out where the view should be centered:
+	Profiler::Zone drawZone("Draw list");
+	Point newCenter = center;
+	Point newCenterVelocity;
+	if(flagship)
+	{
+		newCenter = flagship->Position();
+		newCenterVelocity = flagship->Velocity();
+	}
+	draw[calcTickTock].SetCenter(newCenter, newCenterVelocity);
+	batchDraw[calcTickTock].SetCenter(newCenter);
+	radar[calcTickTock].SetCenter(newCenter);
+
+	// Populate the radar.
+	FillRadar();
+
+	// Draw the planets.
+	for(const StellarObject &object : playerSystem->Objects())
+		if(object.HasSprite())
+		{
+			// Don't apply motion blur to very large planets and stars.
+			if(object.Width() >= 280.)
+				draw[calcTickTock].AddUnblurred(object);
+			else
+				draw[calcTickTock].Add(object);
+		}
+	// Draw the asteroids and minables. It does not matter which asteroid is
+	// drawn on top of which, so they are grouped by texture instead, and so is
+	// the flotsam.
+	draw[calcTickTock].BeginLayer(true);
+	asteroids.Draw(draw[calcTickTock], newCenter, zoom);
+	// Draw the flotsam.
+	draw[calcTickTock].BeginLayer(true);
+	for(const Flotsam &it : flotsam)
+		draw[calcTickTock].Add(it);
+	// Draw the ships. Skip the flagship, then draw it on top of all the others.
+	// Each ship's sprites must be drawn in order, so this layer is not grouped.
+	draw[calcTickTock].BeginLayer(false);
+	bool showFlagship = false;
+	for(const shared_ptr<Ship> &ship : ships)
+		if(ship->GetSystem() == playerSystem && ship->HasSprite())
+		{
+			if(ship.get() != flagship)
+			{
+				// Only build the sprites of ships that could be on screen. The
+				// sounds of ones that are off screen can still be heard.
+				if(draw[calcTickTock].InView(*ship, SHIP_VIEW_MARGIN * ship->Radius()))
+					AddSprites(*ship);
+				if(ship->IsThrusting() && !ship->EnginePoints().empty())
+				{
+					for(const auto &it : ship->Attributes().FlareSounds())
+						Audio::Play(it.first, ship->Position());
+				}
+				else if(ship->IsReversing() && !ship->ReverseEnginePoints().empty())
+				{
+					for(const auto &it : ship->Attributes().ReverseFlareSounds())
+						Audio::Play(it.first, ship->Position());
+				}
+				if(ship->IsSteering() && !ship->SteeringEnginePoints().empty())
+				{
+					for(const auto &it : ship->Attributes().SteeringFlareSounds())
+						Audio::Play(it.first, ship->Position());
+				}
+			}
+			else
+				showFlagship = true;
+		}
+
+	if(flagship && showFlagship)
+	{
+		AddSprites(*flagship);
+		if(flagship->IsThrusting() && !flagship->EnginePoints().empty())
+		{
+			for(const auto &it : flagship->Attributes().FlareSounds())
+				Audio::Play(it.first);
+		}
+		else if(flagship->IsReversing() && !flagship->ReverseEnginePoints().empty())
+		{
+			for(const auto &it : flagship->Attributes().ReverseFlareSounds())
+				Audio::Play(it.first);
+		}
+		if(flagship->IsSteering() && !flagship->SteeringEnginePoints().empty())
+		{
+			for(const auto &it : flagship->Attributes().SteeringFlareSounds())
+				Audio::Play(it.first);
+		}
+	}
+	// Draw the particles on top of the ships.
+	particles.Draw(draw[calcTickTock], step);
+	draw[calcTickTock].Finish();
+	// Draw the projectiles.
+	for(const Projectile &projectile : projectiles)
+		batchDraw[calcTickTock].Add(projectile, projectile.Clip());
+	// Draw the visuals, but only as many new ones as the budget allows.
+	visualBudget.Limit(visuals, oldVisuals);
+	for(const Visual &visual : visuals)
+		batchDraw[calcTickTock].AddVisual(visual);
+
+	// Gather what the HUD shows about this step.
+	BuildSnapshot(snapshots[calcTickTock], zoom);
+
+	// The routes that ships asked for this step are found while the step runs,
+	// and must be done before the universe can change between steps.
+	RoutePlanner::Wait();
+
+	// Keep track of how much of the CPU time we are using.
+	const double stepTime = loadTimer.Time();
+	visualBudget.Tune(stepTime);
+	loadSum += stepTime;
+	if(++loadCount == 60)
+	{
+		load = loadSum;
+		loadSum = 0.;
+		loadCount = 0;
+	}
+}
+
+
+
+// Gather everything the HUD shows about the step that was just calculated.
+// This is done here, rather than in Step(), so that the main thread only has
+// to read it once the step is done.
+void Engine::BuildSnapshot(Snapshot &snapshot, double zoom)
+{
+	Profiler::Zone zone("HUD snapshot");
+	const shared_ptr<Ship> flagship = player.FlagshipPtr();
+	const System *currentSystem = player.GetSystem();
+	// Everything is placed relative to where the view will be centered when
+	// this step is drawn, which Step() decides in the same way.
+	const StellarObject *object = player.GetStellarObject();
+	const Point center = object ? object->Position() : flagship ? flagship->Position() : this->center;
+
+	Information &info = snapshot.info;
+	vector<Target> &targets = snapshot.targets;
+	Point &targetVector = snapshot.targetVector;
+	int &targetSwizzle = snapshot.targetSwizzle;
+	EscortDisplay &escorts = snapshot.escorts;
+	vector<Status> &statuses = snapshot.statuses;
+	vector<PlanetLabel> &labels = snapshot.labels;
+	vector<AlertLabel> &missileLabels = snapshot.missileLabels;
+	const Sprite *&highlightSprite = snapshot.highlightSprite;
+	Point &highlightUnit = snapshot.highlightUnit;
+	float &highlightFrame = snapshot.highlightFrame;
+
+	// Draw a highlight to distinguish the flagship from other ships.
+	if(flagship && !flagship->IsDestroyed() && Preferences::Has("Highlight player's flagship"))
+	{
+		highlightSprite = flagship->GetSprite();
+		highlightUnit = flagship->Unit() * zoom;
+		highlightFrame = flagship->GetFrame();
+	}
+	else
+		highlightSprite = nullptr;
+
+	targets.clear();
+
+	// Display escort information for all ships of the "Escort" government,
+	// and all ships with the "escort" personality, except for fighters that
+	// are not owned by the player.
+	escorts.Clear();
+	bool fleetIsJumping = (flagship && flagship->Commands().Has(Command::JUMP));
+	for(const auto &it : ships)
+		if(it->GetGovernment()->IsPlayer() || it->GetPersonality().IsEscort())
+			if(!it->IsYours() && !it->CanBeCarried())
+			{
+				bool isSelected = (flagship && flagship->GetTargetShip() == it);
+				escorts.Add(*it, it->GetSystem() == currentSystem, fleetIsJumping, isSelected);
+			}
+	for(const shared_ptr<Ship> &escort : player.Ships())
+		if(!escort->IsParked() && escort != flagship && !escort->IsDestroyed())
+		{
+			// Check if this escort is selected.
+			bool isSelected = false;
+			for(const weak_ptr<Ship> &ptr : player.SelectedShips())
+				if(ptr.lock() == escort)
+				{
+					isSelected = true;
+					break;
+				}
+			escorts.Add(*escort, escort->GetSystem() == currentSystem, fleetIsJumping, isSelected);
+		}
+
+	// Create the status overlays.
+	statuses.clear();
+	if(wasActive)
+		CreateStatusOverlays(statuses, center);
+
+	// Create missile overlays.
+	missileLabels.clear();
+	if(Preferences::Has("Show missile overlays"))
+		for(const Projectile &projectile : projectiles)
+		{
+			Point pos = projectile.Position() - center;
+			if(projectile.MissileStrength() && projectile.GetGovernment()->IsEnemy()
+					&& (pos.Length() < max(Screen::Width(), Screen::Height()) * .5 / zoom))
+				missileLabels.emplace_back(AlertLabel(pos, projectile, flagship, zoom));
+		}
+
+	// Create the planet labels.
+	labels.clear();
+	if(currentSystem && Preferences::Has("Show planet labels"))
+	{
+		labelLayout.Update(*currentSystem, zoom);
+		for(const StellarObject &object : currentSystem->Objects())
+		{
+			if(!object.HasSprite() || !object.HasValidPlanet() || !object.GetPlanet()->IsAccessible(flagship.get()))
+				continue;
+
+			Point pos = object.Position() - center;
+			if(pos.Length() - object.Radius() < 600. / zoom)
+				labels.emplace_back(pos, object, currentSystem, zoom, &labelLayout);
+		}
+	}
+
+	// Clear the HUD information from the previous frame.
+	info = Information();
+	if(flagship && flagship->Hull())
+	{
+		Point shipFacingUnit(0., -1.);
+		if(Preferences::Has("Rotate flagship in HUD"))
+			shipFacingUnit = flagship->Facing().Unit();
+
+		info.SetSprite(INFO_PLAYER_SPRITE, flagship->GetSprite(), shipFacingUnit, flagship->GetFrame(step));
+	}
+	if(currentSystem)
+		info.SetString(INFO_LOCATION, currentSystem->Name());
+	info.SetString(INFO_DATE, player.GetDate().ToString());
+	if(flagship)
+	{
+		// Have an alarm label flash up when enemy ships are in the system
+		if(alarmTime && step / 20 % 2 && Preferences::DisplayVisualAlert())
+			info.SetCondition(INFO_RED_ALERT);
+		double fuelCap = flagship->Attributes().Get("fuel capacity");
+		// If the flagship has a large amount of fuel, display a solid bar.
+		// Otherwise, display a segment for every 100 units of fuel.
+		if(fuelCap <= MAX_FUEL_DISPLAY)
+			info.SetBar(INFO_FUEL, flagship->Fuel(), fuelCap * .01);
+		else
+			info.SetBar(INFO_FUEL, flagship->Fuel());
+		info.SetBar(INFO_ENERGY, flagship->Energy());
+		double heat = flagship->Heat();
+		info.SetBar(INFO_HEAT, min(1., heat));
+		// If heat is above 100%, draw a second overlaid bar to indicate the
+		// total heat level.
+		if(heat > 1.)
+			info.SetBar(INFO_OVERHEAT, min(1., heat - 1.));
+		if(flagship->IsOverheated() && (step / 20) % 2)
+			info.SetBar(INFO_OVERHEAT_BLINK, min(1., heat));
+		info.SetBar(INFO_SHIELDS, flagship->Shields());
+		info.SetBar(INFO_HULL, flagship->Hull(), 20.);
+		info.SetBar(INFO_DISABLED_HULL, min(flagship->Hull(), flagship->DisabledHull()), 20.);
+	}
+	info.SetString(INFO_CREDITS,
+		Format::CreditString(player.Accounts().Credits()));
+	bool isJumping = flagship && (flagship->Commands().Has(Command::JUMP) || flagship->IsEnteringHyperspace());
+	if(flagship && flagship->GetTargetStellar() && !isJumping)
+	{
+		const StellarObject *object = flagship->GetTargetStellar();
+		string navigationMode = flagship->Commands().Has(Command::LAND) ? "Landing on:" :
+			object->GetPlanet() && object->GetPlanet()->CanLand(*flagship) ? "Can land on:" :
+			"Cannot land on:";
+		info.SetString(INFO_NAVIGATION_MODE, navigationMode);
+		const string &name = object->Name();
+		info.SetString(INFO_DESTINATION, name);
+
+		targets.push_back({
+			object->Position() - center,
+			object->Facing(),
+			object->Radius(),
+			GetPlanetTargetPointerColor(*object->GetPlanet()),
+			5});
+	}
+	else if(flagship && flagship->GetTargetSystem())
+	{
+		info.SetString(INFO_NAVIGATION_MODE, "Hyperspace:");
+		if(player.HasVisited(*flagship->GetTargetSystem()))
+			info.SetString(INFO_DESTINATION, flagship->GetTargetSystem()->Name());
+		else
+			info.SetString(INFO_DESTINATION, "unexplored system");
+	}
+	else
+	{
+		info.SetString(INFO_NAVIGATION_MODE, "Navigation:");
+		info.SetString(INFO_DESTINATION, "no destination");
+	}
+	shared_ptr<const Ship> target;
+	const Minable *targetAsteroid = nullptr;
+	targetVector = Point();
+	if(flagship)
+	{
+		target = flagship->GetTargetShip();
+		targetAsteroid = asteroids.Minables().Get(flagship->GetTargetAsteroid());
+	}
+	if(!target)
+		targetSwizzle = -1;
+	if(!target && !targetAsteroid)
+		info.SetString(INFO_TARGET_NAME, "no target");
+	else if(!target)
+	{
+		info.SetSprite(INFO_TARGET_SPRITE,
+			targetAsteroid->GetSprite(),
+			targetAsteroid->Facing().Unit(),
+			targetAsteroid->GetFrame(step));
+		info.SetString(INFO_TARGET_NAME, targetAsteroid->DisplayName() + " " + targetAsteroid->Noun());
+
+		targetVector = targetAsteroid->Position() - center;
+
+		if(flagship->Attributes().Get("tactical scan power"))
+		{
+			info.SetCondition(INFO_RANGE_DISPLAY);
+			info.SetBar(INFO_TARGET_HULL, targetAsteroid->Hull(), 20.);
+			int targetRange = round(targetAsteroid->Position().Distance(flagship->Position()));
+			info.SetString(INFO_TARGET_RANGE, to_string(targetRange));
+		}
+	}
+	else
+	{
+		if(target->GetSystem() == player.GetSystem() && target->Cloaking() < 1.)
+			targetUnit = target->Facing().Unit();
+		info.SetSprite(INFO_TARGET_SPRITE, target->GetSprite(), targetUnit, target->GetFrame(step));
+		info.SetString(INFO_TARGET_NAME, target->Name());
+		info.SetString(INFO_TARGET_TYPE, target->ModelName());
+		if(!target->GetGovernment())
+			info.SetString(INFO_TARGET_GOVERNMENT, "No Government");
+		else
+			info.SetString(INFO_TARGET_GOVERNMENT, target->GetGovernment()->GetName());
+		targetSwizzle = target->GetSwizzle();
+		info.SetString(INFO_MISSION_TARGET, target->GetPersonality().IsTarget() ? "(mission target)" : "");
+
+		int targetType = RadarType(*target, step);
+		info.SetOutlineColor(GetTargetOutlineColor(targetType));
+		if(target->GetSystem() == player.GetSystem() && target->IsTargetable())
+		{
+			info.SetBar(INFO_TARGET_SHIELDS, target->Shields());
+			info.SetBar(INFO_TARGET_HULL, target->Hull(), 20.);
+			info.SetBar(INFO_TARGET_DISABLED_HULL, min(target->Hull(), target->DisabledHull()), 20.);
+
+			// The target area will be a square, with sides proportional to the average
+			// of the width and the height of the sprite.
+			double size = (target->Width() + target->Height()) * .35;
+			targets.push_back({
+				target->Position() - center,
+				Angle(45.) + target->Facing(),
+				size,
+				GetShipTargetPointerColor(targetType),
+				4});
+
+			targetVector = target->Position() - center;
+
+			// Check if the target is close enough to show tactical information.
+			double tacticalRange = 100. * sqrt(flagship->Attributes().Get("tactical scan power"));
+			double targetRange = target->Position().Distance(flagship->Position());
+			if(tacticalRange)
+			{
+				info.SetCondition(INFO_RANGE_DISPLAY);
+				info.SetString(INFO_TARGET_RANGE, to_string(static_cast<int>(round(targetRange))));
+			}
+			// Actual tactical information requires a scrutable
+			// target that is within the tactical scanner range.
+			if((targetRange <= tacticalRange && !target->Attributes().Get("inscrutable"))
+					|| (tacticalRange && target->IsYours()))
+			{
+				info.SetCondition(INFO_TACTICAL_DISPLAY);
+				info.SetString(INFO_TARGET_CREW, to_string(target->Crew()));
+				int fuel = round(target->Fuel() * target->Attributes().Get("fuel capacity"));
+				info.SetString(INFO_TARGET_FUEL, to_string(fuel));
+				int energy = round(target->Energy() * target->Attributes().Get("energy capacity"));
+				info.SetString(INFO_TARGET_ENERGY, to_string(energy));
+				int heat = round(100. * target->Heat());
+				info.SetString(INFO_TARGET_HEAT, to_string(heat) + "%");
+			}
+		}
+	}
+	if(target && target->IsTargetable() && target->GetSystem() == currentSystem
+		&& (flagship->CargoScanFraction() || flagship->OutfitScanFraction()))
+	{
+		double width = max(target->Width(), target->Height());
+		Point pos = target->Position() - center;
+		statuses.emplace_back(pos, flagship->OutfitScanFraction(), flagship->CargoScanFraction(),
+			0, 10. + max(20., width * .5), 2, Angle(pos).Degrees() + 180.);
+	}
 
-	// Now, take the new objects that were generated this step and splice them
-	// on to the ends of the respective lists of objects. These new objects will
-	// be drawn this step (and the projectiles will participate in collision
-	// detection) but they should not be moved, which is why we put off adding
-	// them to the lists until now.
-	ships.splice(ships.end(), newShips);
-	Append(projectiles, newProjectiles);
-	flotsam.splice(flotsam.end(), newFlotsam);
-	Append(visuals, newVisuals);
+	// Draw crosshairs on all the selected ships.
+	for(const weak_ptr<Ship> &selected : player.SelectedShips())
+	{
+		shared_ptr<Ship> ship = selected.lock();
+		if(ship && ship != target && !ship->IsParked() && ship->GetSystem() == player.GetSystem()
+				&& !ship->IsDestroyed() && ship->Zoom() > 0.)
+		{
+			double size = (ship->Width() + ship->Height()) * .35;
+			targets.push_back({
+				ship->Position() - center,
+				Angle(45.) + ship->Facing(),
+				size,
+				*GameData::Colors().Get("ship target pointer player"),
+				4});
+		}
+	}
 
-	// Decrement the count of how long it's been since a ship last asked for help.
-	if(grudgeTime)
-		--grudgeTime;
+	// Draw crosshairs on any minables in range of the flagship's scanners.
+	double scanRangeMetric = flagship ? 10000. * flagship->Attributes().Get("asteroid scan power") : 0.;
+	if(Preferences::Has("Show asteroid scanner overlay") && scanRangeMetric && !flagship->IsHyperspacing())
+		for(const Minable &minable : asteroids.Minables())
+		{
+			Point offset = minable.Position() - center;
+			// Use the squared length, as we used the squared scan range.
+			if(offset.LengthSquared() > scanRangeMetric
+					|| flagship->GetTargetAsteroid() == asteroids.Minables().GetHandle(minable))
+				continue;
 
-	// Populate the collision detection lookup sets.
-	FillCollisionSets();
+			targets.push_back({
+				offset,
+				minable.Facing(),
+				.8 * minable.Radius(),
+				GetMinablePointerColor(false),
+				3
+			});
+		}
+	const Minable *targetAsteroidPtr = flagship ? asteroids.Minables().Get(flagship->GetTargetAsteroid()) : nullptr;
+	if(targetAsteroidPtr && !flagship->IsHyperspacing())
+		targets.push_back({
+			targetAsteroidPtr->Position() - center,
+			targetAsteroidPtr->Facing(),
+			.8 * targetAsteroidPtr->Radius(),
+			GetMinablePointerColor(true),
+			3
+		});
+}
 
-	// Perform collision detection.
-	for(Projectile &projectile : projectiles)
-		DoCollisions(projectile);
-	// Now that collision detection is done, clear the cache of ships with anti-
-	// missile systems ready to fire.
-	hasAntiMissile.clear();
 
-	// Damage ships from any active weather events.
-	for(Weather &weather : activeWeather)
-		DoWeather(weather);
 
-	// Check for flotsam collection (collisions with ships).
-	for(const shared_ptr<Flotsam> &it : flotsam)
-		DoCollection(*it);
+// Move a ship. Also determine if the ship should generate hyperspace sounds or
+// boarding events, fire weapons, and launch fighters.
+// Ships only ever change the state of their parent, the ships they are carrying,
+// and the ship they are boarding while they move. Place every ship in the same
+// group as any other ship it might change or read from, so that each group can
+// be moved on its own thread with the same result as moving them in order.
+void Engine::GroupShips()
+{
+	groupedShips.clear();
+	groupStart.clear();
 
-	// Check for ship scanning.
-	for(const shared_ptr<Ship> &it : ships)
-		DoScanning(it);
+	unordered_map<const Ship *, size_t> index;
+	index.reserve(ships.size());
+	for(const shared_ptr<Ship> &ship : ships)
+		index.emplace(ship.get(), index.size());
 
-	// Draw the objects. Start by figuring out where the view should be centered:
-	Point newCenter = center;
-	Point newCenterVelocity;
-	if(flagship)
+	vector<size_t> root(ships.size());
+	iota(root.begin(), root.end(), 0);
+	auto join = [&root, &index](size_t first, const Ship *other)
 	{
-		newCenter = flagship->Position();
-		newCenterVelocity = flagship->Velocity();
-	}
-	draw[calcTickTock].SetCenter(newCenter, newCenterVelocity);
-	batchDraw[calcTickTock].SetCenter(newCenter);
-	radar[calcTickTock].SetCenter(newCenter);
-
-	// Populate the radar.
-	FillRadar();
-
-	// Draw the planets.
-	for(const StellarObject &object : playerSystem->Objects())
-		if(object.HasSprite())
-		{
-			// Don't apply motion blur to very large planets and stars.
-			if(object.Width() >= 280.)
-				draw[calcTickTock].AddUnblurred(object);
-			else
-				draw[calcTickTock].Add(object);
-		}
-	// Draw the asteroids and minables.
-	asteroids.Draw(draw[calcTickTock], newCenter, zoom);
-	// Draw the flotsam.
-	for(const shared_ptr<Flotsam> &it : flotsam)
-		draw[calcTickTock].Add(*it);
-	// Draw the ships. Skip the flagship, then draw it on top of all the others.
-	bool showFlagship = false;
+		auto it = index.find(other);
+		if(it == index.end())
+			return;
+		size_t a = FindGroup(root, first);
+		size_t b = FindGroup(root, it->second);
+		// Always keep the earliest ship as the root, so the group order
+		// matches the order the ships are in.
+		if(a < b)
+			root[b] = a;
+		else
+			root[a] = b;
+	};
+	size_t i = 0;
 	for(const shared_ptr<Ship> &ship : ships)
-		if(ship->GetSystem() == playerSystem && ship->HasSprite())
-		{
-			if(ship.get() != flagship)
-			{
-				AddSprites(*ship);
-				if(ship->IsThrusting() && !ship->EnginePoints().empty())
-				{
-					for(const auto &it : ship->Attributes().FlareSounds())
-						Audio::Play(it.first, ship->Position());
-				}
-				else if(ship->IsReversing() && !ship->ReverseEnginePoints().empty())
-				{
-					for(const auto &it : ship->Attributes().ReverseFlareSounds())
-						Audio::Play(it.first, ship->Position());
-				}
-				if(ship->IsSteering() && !ship->SteeringEnginePoints().empty())
-				{
-					for(const auto &it : ship->Attributes().SteeringFlareSounds())
-						Audio::Play(it.first, ship->Position());
-				}
-			}
-			else
-				showFlagship = true;
-		}
+	{
+		shared_ptr<const Ship> parent = ship->GetParent();
+		if(parent)
+			join(i, parent.get());
+		// A ship only touches its target if it is trying to board it, or to
+		// clear its target once the target has finished exploding.
+		shared_ptr<const Ship> target = ship->GetTargetShip();
+		if(target && (ship->Commands().Has(Command::BOARD) || target->IsDestroyed()))
+			join(i, target.get());
+		++i;
+	}
 
-	if(flagship && showFlagship)
+	// Number the groups in the order of their first ship, then sort the ships
+	// into their groups without changing their relative order.
+	vector<size_t> group(ships.size());
+	vector<size_t> count;
+	for(i = 0; i < root.size(); ++i)
 	{
-		AddSprites(*flagship);
-		if(flagship->IsThrusting() && !flagship->EnginePoints().empty())
-		{
-			for(const auto &it : flagship->Attributes().FlareSounds())
-				Audio::Play(it.first);
-		}
-		else if(flagship->IsReversing() && !flagship->ReverseEnginePoints().empty())
-		{
-			for(const auto &it : flagship->Attributes().ReverseFlareSounds())
-				Audio::Play(it.first);
-		}
-		if(flagship->IsSteering() && !flagship->SteeringEnginePoints().empty())
+		size_t first = FindGroup(root, i);
+		if(first == i)
 		{
-			for(const auto &it : flagship->Attributes().SteeringFlareSounds())
-				Audio::Play(it.first);
+			group[i] = count.size();
+			count.push_back(0);
 		}
+		else
+			group[i] = group[first];
+		++count[group[i]];
 	}
-	// Draw the projectiles.
-	for(const Projectile &projectile : projectiles)
-		batchDraw[calcTickTock].Add(projectile, projectile.Clip());
-	// Draw the visuals.
-	for(const Visual &visual : visuals)
-		batchDraw[calcTickTock].AddVisual(visual);
+	groupStart.resize(count.size() + 1, 0);
+	for(i = 0; i < count.size(); ++i)
+		groupStart[i + 1] = groupStart[i] + count[i];
 
-	// Keep track of how much of the CPU time we are using.
-	loadSum += loadTimer.Time();
-	if(++loadCount == 60)
-	{
-		load = loadSum;
-		loadSum = 0.;
-		loadCount = 0;
-	}
+	groupedShips.resize(ships.size());
+	vector<size_t> next(groupStart.begin(), groupStart.end() - 1);
+	i = 0;
+	for(const shared_ptr<Ship> &ship : ships)
+		groupedShips[next[group[i++]]++] = ship;
 }
 
 
 
-// Move a ship. Also determine if the ship should generate hyperspace sounds or
-// boarding events, fire weapons, and launch fighters.
-void Engine::MoveShip(const shared_ptr<Ship> &ship)
+// Move every ship, with independent groups of ships processed in parallel.
+void Engine::MoveShips(const Ship *flagship)
+{
+	GroupShips();
+	const size_t groups = groupStart.size() - 1;
+	if(stepBuffers.size() < groups)
+		stepBuffers.resize(groups);
+
+	// Ship movement involves random numbers, so give each group its own seed.
+	// That way, the same ships make the same choices regardless of how many
+	// threads there are or the order in which the groups are processed.
+	groupSeeds.resize(groups + 1);
+	for(uint64_t &seed : groupSeeds)
+		seed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+
+	jobs.ParallelFor(groups, [this, flagship](size_t group)
+	{
+		Random::Seed(groupSeeds[group]);
+		for(size_t i = groupStart[group]; i < groupStart[group + 1]; ++i)
+			MoveShip(groupedShips[i], flagship, stepBuffers[group]);
+	});
+	Random::Seed(groupSeeds.back());
+
+	// Gather the objects created by each group in order.
+	for(size_t i = 0; i < groups; ++i)
+	{
+		StepBuffer &buffer = stepBuffers[i];
+		newShips.splice(newShips.end(), buffer.ships);
+		Append(newProjectiles, buffer.projectiles);
+		Append(newFlotsam, buffer.flotsam);
+		Append(newVisuals, buffer.visuals);
+		Append(newParticles, buffer.particles);
+		Append(eventQueue, buffer.events);
+		hasAntiMissile.insert(hasAntiMissile.end(), buffer.antiMissile.begin(), buffer.antiMissile.end());
+		buffer.antiMissile.clear();
+	}
+	groupedShips.clear();
+}
+
+
+
+void Engine::MoveShip(const shared_ptr<Ship> &ship, const Ship *flagship, StepBuffer &buffer)
 {
 	// Various actions a ship could have taken last frame may have impacted the accuracy of cached values.
 	// Therefore, determine with any information needs recalculated and cache it.
 	ship->UpdateCaches();
 
-	const Ship *flagship = player.Flagship();
-
 	bool isJump = ship->IsUsingJumpDrive();
 	bool wasHere = (flagship && ship->GetSystem() == flagship->GetSystem());
 	bool wasHyperspacing = ship->IsHyperspacing();
 	bool wasDisabled = ship->IsDisabled();
 	// Give the ship the list of visuals so that it can draw explosions,
 	// ion sparks, jump drive flashes, etc.
-	ship->Move(newVisuals, newFlotsam);
+	ship->Move(buffer.visuals, buffer.particles, buffer.flotsam);
 	if(ship->IsDisabled() && !wasDisabled)
-		eventQueue.emplace_back(nullptr, ship, ShipEvent::DISABLE);
+		buffer.events.emplace_back(nullptr, ship, ShipEvent::DISABLE);
 	// Bail out if the ship just died.
 	if(ship->ShouldBeRemoved())
 	{
@@ -1769,11 +2391,11 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 		// self-destruct.
 		if(ship->IsDestroyed())
 		{
-			eventQueue.emplace_back(nullptr, ship, ShipEvent::DESTROY);
+			buffer.events.emplace_back(nullptr, ship, ShipEvent::DESTROY);
 			// Any still-docked ships' destruction must be recorded as well.
 			for(const auto &bay : ship->Bays())
 				if(bay.ship)
-					eventQueue.emplace_back(nullptr, bay.ship, ShipEvent::DESTROY);
+					buffer.events.emplace_back(nullptr, bay.ship, ShipEvent::DESTROY);
 		}
 		return;
 	}
@@ -1815,7 +2437,7 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 	bool nonDocker = ship.get() == flagship;
 	shared_ptr<Ship> victim = ship->Board(autoPlunder, nonDocker);
 	if(victim)
-		eventQueue.emplace_back(ship, victim,
+		buffer.events.emplace_back(ship, victim,
 			ship->GetGovernment()->IsEnemy(victim->GetGovernment()) ?
 				ShipEvent::BOARD : ShipEvent::ASSIST);
 
@@ -1824,12 +2446,12 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 		return;
 
 	// Launch fighters.
-	ship->Launch(newShips, newVisuals);
+	ship->Launch(buffer.ships, buffer.visuals);
 
 	// Fire weapons. If this returns true the ship has at least one anti-missile
 	// system ready to fire.
-	if(ship->Fire(newProjectiles, newVisuals))
-		hasAntiMissile.push_back(ship.get());
+	if(ship->Fire(buffer.projectiles, buffer.visuals))
+		buffer.antiMissile.push_back(ship.get());
 }
 
 
@@ -1875,8 +2497,9 @@ void Engine::SpawnFleets()
 			if(enemyStrength && ai.AllyStrength(gov) > 2 * enemyStrength)
 				continue;
 
-			fleet.Get()->Enter(*player.GetSystem(), newShips);
+			fleet.Get()->Enter(*player.GetSystem(), newShips, nullptr, &spawnPool);
 		}
+	spawnPool.Refill();
 }
 
 
@@ -1887,11 +2510,28 @@ void Engine::SpawnPersons()
 	if(Random::Int(GameData::GetGamerules().PersonSpawnPeriod()) || player.GetSystem()->Links().empty())
 		return;
 
-	// Loop through all persons once to see if there are any who can enter
+	// Only the persons whose location includes this system can enter it. Which
+	// ones those are only changes when the universe does.
+	if(personsRevision != GameData::UniverseRevision())
+	{
+		personsRevision = GameData::UniverseRevision();
+		personsBySystem.clear();
+	}
+	const System *system = player.GetSystem();
+	auto candidates = personsBySystem.find(system);
+	if(candidates == personsBySystem.end())
+	{
+		candidates = personsBySystem.emplace(system, vector<const pair<const string, Person> *>()).first;
+		for(const auto &it : GameData::Persons())
+			if(it.second.CanAppearIn(system))
+				candidates->second.push_back(&it);
+	}
+
+	// Loop through those persons once to see if there are any who can enter
 	// this system.
 	int sum = 0;
-	for(const auto &it : GameData::Persons())
-		sum += it.second.Frequency(player.GetSystem());
+	for(const auto *it : candidates->second)
+		sum += it->second.Frequency(system);
 	// Bail out if there are no eligible persons.
 	if(!sum)
 		return;
@@ -1899,10 +2539,10 @@ void Engine::SpawnPersons()
 	// Although an attempt to spawn a person is made every 10 minutes on average,
 	// that attempt can still fail due to an added weight for no person to spawn.
 	sum = Random::Int(sum + GameData::GetGamerules().NoPersonSpawnWeight());
-	for(const auto &it : GameData::Persons())
+	for(const auto *it : candidates->second)
 	{
-		const Person &person = it.second;
-		sum -= person.Frequency(player.GetSystem());
+		const Person &person = it->second;
+		sum -= person.Frequency(system);
 		if(sum < 0)
 		{
 			const System *source = nullptr;
@@ -1911,7 +2551,7 @@ void Engine::SpawnPersons()
 			{
 				ship->Recharge();
 				if(ship->Name().empty())
-					ship->SetName(it.first);
+					ship->SetName(it->first);
 				ship->SetGovernment(person.GetGovernment());
 				ship->SetPersonality(person.GetPersonality());
 				ship->SetHailPhrase(person.GetHail());
@@ -1921,7 +2561,7 @@ void Engine::SpawnPersons()
 					ship->SetParent(parent);
 				// Make sure all ships in a "person" definition enter from the
 				// same source system.
-				source = Fleet::Enter(*player.GetSystem(), *ship, source);
+				source = Fleet::Enter(*system, *ship, source);
 				newShips.push_back(ship);
 			}
 
@@ -2055,9 +2695,39 @@ void Engine::HandleKeyboardInputs()
 
 
 
+void Engine::ApplyInput(const Replay::Input &input)
+{
+	switch(input.type)
+	{
+		case Replay::InputType::CLICK:
+			Click(input.from, input.to, input.hasShift, input.hasControl);
+			break;
+		case Replay::InputType::RIGHT_CLICK:
+			RClick(input.from);
+			break;
+		case Replay::InputType::GROUP:
+			SelectGroup(input.value, input.hasShift, input.hasControl);
+			break;
+		case Replay::InputType::FINGER_DOWN:
+			// Whether this was a double tap depended on the time between the
+			// touches, which is not the same when replaying.
+			FingerDown(input.from, input.value);
+			isDoubleTap = input.isDoubleTap;
+			break;
+		case Replay::InputType::FINGER_MOVE:
+			FingerMove(input.from, input.value);
+			break;
+		case Replay::InputType::FINGER_UP:
+			FingerUp(input.from, input.value);
+			break;
+	}
+}
+
+
+
 // Handle any mouse clicks. This is done in the calculation thread rather than
 // in the main UI thread to avoid race conditions.
-void Engine::HandleMouseClicks()
+void Engine::HandleMouseClicks(Command &commands)
 {
 	// Mouse clicks can't be issued if your flagship is dead.
 	Ship *flagship = player.Flagship();
@@ -2097,7 +2767,7 @@ void Engine::HandleMouseClicks()
 									+ " refuse to let you land.", Messages::Importance::High);
 						else
 						{
-							activeCommands |= Command::LAND;
+							commands |= Command::LAND;
 							Messages::Add("Landing on " + planet->Name() + ".", Messages::Importance::High);
 						}
 					}
@@ -2150,7 +2820,7 @@ void Engine::HandleMouseClicks()
 			if(clickTarget == flagship->GetTargetShip())
 			{
 				if(AI::CanBoard(*flagship, *clickTarget))
-					activeCommands |= Command::BOARD;
+					commands |= Command::BOARD;
 				else
 				{
 					// if this is the only selected ship, then deselect it
@@ -2174,20 +2844,20 @@ void Engine::HandleMouseClicks()
 	{
 		// If the click was not on any ship, check if it was on a minable.
 		double scanRange = 100. * sqrt(flagship->Attributes().Get("asteroid scan power"));
-		for(const shared_ptr<Minable> &minable : asteroids.Minables())
+		for(const Minable &minable : asteroids.Minables())
 		{
-			Point position = minable->Position() - flagship->Position();
+			Point position = minable.Position() - flagship->Position();
 			if(position.Length() > scanRange)
 				continue;
 
-			double range = clickPoint.Distance(position) - minable->Radius();
+			double range = clickPoint.Distance(position) - minable.Radius();
 			if(range <= clickRange)
 			{
 				clickedAsteroid = true;
 				clickRange = range;
-				flagship->SetTargetAsteroid(minable);
+				flagship->SetTargetAsteroid(asteroids.Minables().GetHandle(minable));
 				if(isRightClick)
-					ai.IssueAsteroidTarget(player, minable);
+					ai.IssueAsteroidTarget(player, flagship->GetTargetAsteroid());
 			}
 		}
 	}
@@ -2223,7 +2893,7 @@ void Engine::HandleMouseClicks()
 
 
 
-void Engine::HandleTouchEvents()
+void Engine::HandleTouchEvents(Command &commands)
 {
 	if(Preferences::Has("Onscreen Joystick"))
 	{
@@ -2245,11 +2915,11 @@ void Engine::HandleTouchEvents()
 			{
 				touchMoveVector = jspos / radius;
 				touchMoveActive = true;
-				HandleJoystickMovement(touchMoveVector * 32767);
+				HandleJoystickMovement(touchMoveVector * 32767, commands);
 
 				// If we are outside the ring bounds, activate the afterburner
 				if(touchMoveVector.LengthSquared() > 1)
-					activeCommands |= Command::AFTERBURNER;
+					commands |= Command::AFTERBURNER;
 
 				break; // only consider the first point we find
 			}
@@ -2262,8 +2932,8 @@ void Engine::HandleTouchEvents()
 		else if(touchMoveActive)
 		{
 			if(isDoubleTap)
-				activeCommands |= Command::AFTERBURNER;
-			HandleJoystickMovement(clickPoint.Unit() * 32767);
+				commands |= Command::AFTERBURNER;
+			HandleJoystickMovement(clickPoint.Unit() * 32767, commands);
 		}
 	}
 }
@@ -2302,13 +2972,13 @@ void Engine::HandleMouseInput(Command &activeCommands)
 void Engine::HandleGamepadInput(Command& activeCommands)
 {
 	Point p = GamePad::LeftStick();
-	HandleJoystickMovement(p);
+	HandleJoystickMovement(p, activeCommands);
 }
 
 
 
 // Convert a joystick movement vector into actual flagship commands
-void Engine::HandleJoystickMovement(const Point& p)
+void Engine::HandleJoystickMovement(const Point& p, Command &commands)
 {
 	Ship* flagship = player.Flagship();
 	if(flagship && p)
@@ -2326,38 +2996,61 @@ void Engine::HandleJoystickMovement(const Point& p)
 			// reverse command. If we don't have reverse engines, then it will
 			// start flipping our ship around, which is what we would want
 			// anyways.
-			activeCommands.Set(Command::BACK);
+			commands.Set(Command::BACK);
 		}
 		else if(degrees < -2.0)
-			activeCommands.Set(Command::RIGHT);
+			commands.Set(Command::RIGHT);
 		else if(degrees > 2.0)
-			activeCommands.Set(Command::LEFT);
+			commands.Set(Command::LEFT);
 
 		// If we are pointing in roughly the correct direction, go ahead and
 		// fire the engines if they are past the trigger threshold.
 		if(triggered && -25.0 < degrees && degrees < 25.0)
-			activeCommands.Set(Command::FORWARD);
+			commands.Set(Command::FORWARD);
 	}
 }
 
 
 
-// Perform collision detection. Note that unlike the preceding functions, this
-// one adds any visuals that are created directly to the main visuals list. If
-// this is multi-threaded in the future, that will need to change.
-void Engine::DoCollisions(Projectile &projectile)
+// If there are many projectiles, find the first ship each of them hits ahead of
+// time. Which ship a projectile hits does not depend on any of the other
+// projectiles, so this can be done for all of them at once.
+void Engine::FindShipHits()
 {
-	// The asteroids can collide with projectiles, the same as any other
-	// object. If the asteroid turns out to be closer than the ship, it
-	// shields the ship (unless the projectile has a blast radius).
-	Point hitVelocity;
-	double closestHit = 1.;
-	shared_ptr<Ship> hit;
+	shipHits.assign(projectiles.size(), ShipHit());
+	if(projectiles.size() < BATCH_COLLISION_COUNT)
+		return;
+
+	shipCollisions.BuildTree();
+	const size_t blocks = (projectiles.size() + COLLISION_BLOCK_SIZE - 1) / COLLISION_BLOCK_SIZE;
+	jobs.ParallelFor(blocks, [this](size_t block)
+	{
+		vector<Body *> nearby;
+		const size_t end = min(projectiles.size(), (block + 1) * COLLISION_BLOCK_SIZE);
+		for(size_t i = block * COLLISION_BLOCK_SIZE; i < end; ++i)
+		{
+			// Checking a phasing projectile's target may update the target's
+			// animation, so leave those for when the hits are applied.
+			const Projectile &projectile = projectiles[i];
+			if(projectile.GetGovernment() && projectile.GetWeapon().IsPhasing() && projectile.Target())
+				continue;
+			shipHits[i] = FindShipHit(projectile, nearby);
+		}
+	});
+}
+
+
+
+// Find the first ship that the given projectile hits.
+Engine::ShipHit Engine::FindShipHit(const Projectile &projectile, vector<Body *> &nearby) const
+{
+	ShipHit result;
+	result.isKnown = true;
 	const Government *gov = projectile.GetGovernment();
 
 	// If this "projectile" is a ship explosion, it always explodes.
 	if(!gov)
-		closestHit = 0.;
+		result.distance = 0.;
 	else if(projectile.GetWeapon().IsPhasing() && projectile.Target())
 	{
 		// "Phasing" projectiles that have a target will never hit any other ship.
@@ -2368,8 +3061,8 @@ void Engine::DoCollisions(Projectile &projectile)
 			double range = target->GetMask(step).Collide(offset, projectile.Velocity(), target->Facing());
 			if(range < 1.)
 			{
-				closestHit = range;
-				hit = target;
+				result.distance = range;
+				result.ship = target.get();
 			}
 		}
 	}
@@ -2378,57 +3071,104 @@ void Engine::DoCollisions(Projectile &projectile)
 		// For weapons with a trigger radius, check if any detectable object will set it off.
 		double triggerRadius = projectile.GetWeapon().TriggerRadius();
 		if(triggerRadius)
-			for(const Body *body : shipCollisions.Circle(projectile.Position(), triggerRadius))
+		{
+			shipCollisions.Circle(projectile.Position(), triggerRadius, nearby);
+			for(const Body *body : nearby)
 				if(body == projectile.Target() || (gov->IsEnemy(body->GetGovernment())
 						&& reinterpret_cast<const Ship *>(body)->Cloaking() < 1.))
 				{
-					closestHit = 0.;
+					result.distance = 0.;
 					break;
 				}
+		}
 
 		// If nothing triggered the projectile, check for collisions with ships.
-		if(closestHit > 0.)
+		if(result.distance > 0.)
 		{
-			Ship *ship = reinterpret_cast<Ship *>(shipCollisions.Line(projectile, &closestHit));
+			Ship *ship = reinterpret_cast<Ship *>(shipCollisions.Line(projectile, &result.distance));
 			if(ship)
 			{
-				hit = ship->shared_from_this();
-				hitVelocity = ship->Velocity();
+				result.ship = ship;
+				result.velocity = ship->Velocity();
 			}
 		}
-		// "Phasing" projectiles can pass through asteroids. For all other
-		// projectiles, check if they've hit an asteroid that is closer than any
-		// ship that they have hit.
-		if(!projectile.GetWeapon().IsPhasing())
+	}
+	return result;
+}
+
+
+
+// Perform collision detection. Note that unlike the preceding functions, this
+// one adds any visuals that are created directly to the main visuals list. If
+// this is multi-threaded in the future, that will need to change.
+bool Engine::ResolveHit(Projectile &projectile, ShipHit &shipHit)
+{
+	if(!shipHit.isKnown)
+		shipHit = FindShipHit(projectile, nearbyShips);
+
+	// The asteroids can collide with projectiles, the same as any other
+	// object. If the asteroid turns out to be closer than the ship, it
+	// shields the ship (unless the projectile has a blast radius).
+	// "Phasing" projectiles can pass through asteroids. For all other
+	// projectiles, check if they've hit an asteroid that is closer than any
+	// ship that they have hit.
+	if(projectile.GetGovernment() && !projectile.GetWeapon().IsPhasing())
+	{
+		Body *asteroid = asteroids.Collide(projectile, &shipHit.distance);
+		if(asteroid)
 		{
-			Body *asteroid = asteroids.Collide(projectile, &closestHit);
-			if(asteroid)
-			{
-				hitVelocity = asteroid->Velocity();
-				hit.reset();
-			}
+			shipHit.velocity = asteroid->Velocity();
+			shipHit.ship = nullptr;
 		}
 	}
 
-	// Check if the projectile hit something.
-	if(closestHit < 1.)
+	// Create the explosion the given distance along the projectile's motion
+	// path for this step.
+	if(shipHit.distance >= 1.)
+		return false;
+	projectile.Explode(visuals, shipHit.distance, shipHit.velocity);
+	return true;
+}
+
+
+
+void Engine::FindBlastShips()
+{
+	if(blastCount < BATCH_BLAST_COUNT)
+	{
+		for(size_t i = 0; i < blastCount; ++i)
+			shipCollisions.Circle(blasts[i].position, blasts[i].radius, blasts[i].ships);
+		return;
+	}
+
+	// Each blast's ships are stored in its own list, so the results are the
+	// same whichever thread finds them.
+	jobs.ParallelFor(blastCount, [this](size_t i)
 	{
-		// Create the explosion the given distance along the projectile's
-		// motion path for this step.
-		projectile.Explode(visuals, closestHit, hitVelocity);
+		shipCollisions.Circle(blasts[i].position, blasts[i].radius, blasts[i].ships);
+	});
+}
+
+
+
+void Engine::DoCollisions(Projectile &projectile, const ShipHit &shipHit, const vector<Body *> *blastShips)
+{
+	shared_ptr<Ship> hit = shipHit.ship ? shipHit.ship->shared_from_this() : nullptr;
+	const Government *gov = projectile.GetGovernment();
 
+	// Check if the projectile hit something.
+	if(shipHit.distance < 1.)
+	{
 		const DamageProfile damage(projectile.GetInfo());
 
-		// If this projectile has a blast radius, find all ships within its
-		// radius. Otherwise, only one is damaged.
-		double blastRadius = projectile.GetWeapon().BlastRadius();
+		// If this projectile has a blast radius, all ships within its radius
+		// are damaged. Otherwise, only one is.
 		bool isSafe = projectile.GetWeapon().IsSafe();
-		if(blastRadius)
+		if(blastShips)
 		{
 			// Even friendly ships can be hit by the blast, unless it is a
 			// "safe" weapon.
-			Point hitPos = projectile.Position() + closestHit * projectile.Velocity();
-			for(Body *body : shipCollisions.Circle(hitPos, blastRadius))
+			for(Body *body : *blastShips)
 			{
 				Ship *ship = reinterpret_cast<Ship *>(body);
 				bool targeted = (projectile.Target() == ship);
@@ -2436,7 +3176,7 @@ void Engine::DoCollisions(Projectile &projectile)
 					continue;
 
 				// Only directly targeted ships get provoked by blast weapons.
-				int eventType = ship->TakeDamage(visuals, damage.CalculateDamage(*ship, ship == hit.get()),
+				int eventType = ship->TakeDamage(newParticles, damage.CalculateDamage(*ship, ship == hit.get()),
 					targeted ? gov : nullptr);
 				if(eventType)
 					eventQueue.emplace_back(gov, ship->shared_from_this(), eventType);
@@ -2444,7 +3184,7 @@ void Engine::DoCollisions(Projectile &projectile)
 		}
 		else if(hit)
 		{
-			int eventType = hit->TakeDamage(visuals, damage.CalculateDamage(*hit), gov);
+			int eventType = hit->TakeDamage(newParticles, damage.CalculateDamage(*hit), gov);
 			if(eventType)
 				eventQueue.emplace_back(gov, hit, eventType);
 		}
@@ -2455,14 +3195,32 @@ void Engine::DoCollisions(Projectile &projectile)
 	else if(projectile.MissileStrength())
 	{
 		// If the projectile did not hit anything, give the anti-missile systems
-		// a chance to shoot it down.
-		for(Ship *ship : hasAntiMissile)
-			if(ship == projectile.Target() || gov->IsEnemy(ship->GetGovernment()))
-				if(ship->FireAntiMissile(projectile, visuals))
+		// a chance to shoot it down. The ships are always tried in the same
+		// order, whether or not only the nearby ones are looked at.
+		auto ShootDown = [this, &projectile, gov](Ship *ship) -> bool
+		{
+			return (ship == projectile.Target() || gov->IsEnemy(ship->GetGovernment()))
+				&& ship->FireAntiMissile(projectile, visuals);
+		};
+		if(hasAntiMissile.size() < ANTI_MISSILE_GRID_COUNT)
+		{
+			for(Ship *ship : hasAntiMissile)
+				if(ShootDown(ship))
+				{
+					projectile.Kill();
+					break;
+				}
+		}
+		else
+		{
+			antiMissileGrid.Near(projectile.Position(), antiMissileNear);
+			for(unsigned i : antiMissileNear)
+				if(ShootDown(hasAntiMissile[i]))
 				{
 					projectile.Kill();
 					break;
 				}
+		}
 	}
 }
 
@@ -2471,34 +3229,85 @@ void Engine::DoCollisions(Projectile &projectile)
 // Determine whether any active weather events have impacted the ships within
 // the system. As with DoCollisions, this function adds visuals directly to
 // the main visuals list.
-void Engine::DoWeather(Weather &weather)
+void Engine::DoWeather()
 {
-	weather.CalculateStrength();
-	if(weather.HasWeapon() && !Random::Int(weather.Period()))
+	// Find which weather events deal damage this step. Events of the same hazard
+	// at the same origin are combined, since they hit exactly the same ships.
+	vector<HazardStrike> strikes;
+	for(Weather &weather : activeWeather)
 	{
-		const Hazard *hazard = weather.GetHazard();
-		const DamageProfile damage(weather.GetInfo());
+		weather.CalculateStrength();
+		if(!weather.HasWeapon() || Random::Int(weather.Period()))
+			continue;
 
-		// Get all ship bodies that are touching a ring defined by the hazard's min
-		// and max ranges at the hazard's origin. Any ship touching this ring takes
-		// hazard damage.
-		for(Body *body : (hazard->SystemWide() ? shipCollisions.All()
-			: shipCollisions.Ring(weather.Origin(), hazard->MinRange(), hazard->MaxRange())))
+		const Weather::ImpactInfo info = weather.GetInfo();
+		HazardStrike strike{weather.GetHazard(), info.position, info.scale, strikes.size()};
+		auto it = find_if(strikes.begin(), strikes.end(), [&strike](const HazardStrike &other)
+			{ return other.hazard == strike.hazard && SameArea(other, strike); });
+		if(it != strikes.end())
+			it->scale += strike.scale;
+		else
+			strikes.push_back(strike);
+	}
+	if(strikes.empty())
+		return;
+
+	// Get all ship bodies that are touching a ring defined by each hazard's min
+	// and max ranges at the hazard's origin. Any ship touching this ring takes
+	// hazard damage. Hazards that cover the same area share a single query.
+	weatherHits.resize(strikes.size());
+	for(size_t i = 0; i < strikes.size(); ++i)
+	{
+		HazardStrike &strike = strikes[i];
+		for(size_t j = 0; j < i && strike.query == i; ++j)
+			if(SameArea(strikes[j], strike))
+				strike.query = j;
+		if(strike.query != i)
+			continue;
+
+		const Hazard &hazard = *strike.hazard;
+		if(hazard.SystemWide())
+			weatherHits[i] = shipCollisions.All();
+		else
+			shipCollisions.Ring(strike.origin, hazard.MinRange(), hazard.MaxRange(), weatherHits[i]);
+	}
+
+	// Each ship is damaged once by each hazard. If the damage does not depend on
+	// where the hazard is, strikes of that hazard from several origins are added up.
+	vector<pair<Ship *, HazardStrike>> damage;
+	map<pair<const Ship *, const Hazard *>, size_t> merged;
+	for(const HazardStrike &strike : strikes)
+		for(Body *body : weatherHits[strike.query])
 		{
 			Ship *hit = reinterpret_cast<Ship *>(body);
-			hit->TakeDamage(visuals, damage.CalculateDamage(*hit), nullptr);
+			if(IgnoresOrigin(*strike.hazard))
+			{
+				auto it = merged.emplace(make_pair(hit, strike.hazard), damage.size());
+				if(!it.second)
+				{
+					damage[it.first->second].second.scale += strike.scale;
+					continue;
+				}
+			}
+			damage.emplace_back(hit, strike);
 		}
+
+	for(const auto &it : damage)
+	{
+		const HazardStrike &strike = it.second;
+		const DamageProfile profile(Weather::ImpactInfo(*strike.hazard, strike.origin, strike.scale));
+		it.first->TakeDamage(newParticles, profile.CalculateDamage(*it.first), nullptr);
 	}
 }
 
 
 
-// Check if any ship collected the given flotsam.
-void Engine::DoCollection(Flotsam &flotsam)
+// Check if any of the nearby ships collected the given flotsam.
+void Engine::DoCollection(Flotsam &flotsam, const vector<Body *> &nearby)
 {
 	// Check if any ship can pick up this flotsam. Cloaked ships cannot act.
 	Ship *collector = nullptr;
-	for(Body *body : shipCollisions.Circle(flotsam.Position(), 5.))
+	for(Body *body : nearby)
 	{
 		Ship *ship = reinterpret_cast<Ship *>(body);
 		if(!ship->CannotAct() && ship->CanPickUp(flotsam))
@@ -2815,7 +3624,7 @@ void Engine::DoGrudge(const shared_ptr<Ship> &target, const Government *attacker
 
 
 
-void Engine::CreateStatusOverlays()
+void Engine::CreateStatusOverlays(vector<Status> &statuses, const Point &center)
 {
 	const auto overlayAllSetting = Preferences::StatusOverlaysState(Preferences::OverlayType::ALL);
 
@@ -2846,19 +3655,20 @@ void Engine::CreateStatusOverlays()
 			continue;
 
 		if(it == flagship)
-			EmplaceStatusOverlay(it, overlaySettings[Preferences::OverlayType::FLAGSHIP], 0);
+			EmplaceStatusOverlay(statuses, center, it, overlaySettings[Preferences::OverlayType::FLAGSHIP], 0);
 		else if(it->GetGovernment()->IsEnemy())
-			EmplaceStatusOverlay(it, overlaySettings[Preferences::OverlayType::ENEMY], 1);
+			EmplaceStatusOverlay(statuses, center, it, overlaySettings[Preferences::OverlayType::ENEMY], 1);
 		else if(it->IsYours() || it->GetPersonality().IsEscort())
-			EmplaceStatusOverlay(it, overlaySettings[Preferences::OverlayType::ESCORT], 0);
+			EmplaceStatusOverlay(statuses, center, it, overlaySettings[Preferences::OverlayType::ESCORT], 0);
 		else
-			EmplaceStatusOverlay(it, overlaySettings[Preferences::OverlayType::NEUTRAL], 2);
+			EmplaceStatusOverlay(statuses, center, it, overlaySettings[Preferences::OverlayType::NEUTRAL], 2);
 	}
 }
 
 
 
-void Engine::EmplaceStatusOverlay(const shared_ptr<Ship> &it, Preferences::OverlayState overlaySetting, int type)
+void Engine::EmplaceStatusOverlay(vector<Status> &statuses, const Point &center, const shared_ptr<Ship> &it,
+	Preferences::OverlayState overlaySetting, int type)
 {
 	if(overlaySetting == Preferences::OverlayState::OFF)
 		return;
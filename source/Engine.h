@@ -17,34 +17,49 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #define ENGINE_H_
 
 #include "AI.h"
+#include "AntiMissileGrid.h"
 #include "AmmoDisplay.h"
 #include "AsteroidField.h"
 #include "BatchDrawList.h"
 #include "CollisionSet.h"
 #include "Command.h"
 #include "DrawList.h"
+#include "DynamicResolution.h"
 #include "EscortDisplay.h"
+#include "Flotsam.h"
 #include "Information.h"
+#include "JobPool.h"
+#include "ObjectPool.h"
+#include "ParticleSystem.h"
+#include "PlanetLabel.h"
 #include "Point.h"
 #include "Preferences.h"
+#include "Profiler.h"
 #include "Radar.h"
 #include "Rectangle.h"
+#include "Replay.h"
+#include "SpawnPool.h"
+#include "VisualBudget.h"
 
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <future>
 #include <list>
 #include <map>
 #include <memory>
+#include <set>
 #include <thread>
 #include <utility>
 #include <vector>
 
 class AlertLabel;
-class Flotsam;
+class Body;
 class Government;
 class NPC;
 class Outfit;
-class PlanetLabel;
+class Particle;
+class Person;
 class PlayerInfo;
 class Projectile;
 class Ship;
@@ -72,9 +87,14 @@ public:
 	void Place();
 	// Place NPCs spawned by a mission that offers when the player is not landed.
 	void Place(const std::list<NPC> &npcs, std::shared_ptr<Ship> flagship = nullptr);
+	void PlaceNPCShips(const std::list<std::shared_ptr<Ship>> &npcShips, const std::shared_ptr<Ship> &flagship);
 
 	// Wait for the previous calculations (if any) to be done.
 	void Wait();
+	// If the previous calculations are done, get ready to draw them and return
+	// true. Otherwise, return false right away, so that the last frame that was
+	// calculated can be drawn again instead of waiting.
+	bool TryWait();
 	// Perform all the work that can only be done while the calculation thread
 	// is paused (for thread safety reasons).
 	void Step(bool isActive);
@@ -83,7 +103,7 @@ public:
 
 	// Get any special events that happened in this step.
 	// MainPanel::Step will clear this list.
-	std::list<ShipEvent> &Events();
+	std::vector<ShipEvent> &Events();
 
 	// Draw a frame.
 	void Draw() const;
@@ -100,6 +120,8 @@ public:
 	bool FingerDown(const Point &p, int fid);
 	bool FingerUp(const Point &p, int fid);
 	bool FingerMove(const Point &p, int fid);
+	// The finger that is steering the flagship, or -1 if there is none.
+	int TouchFinger() const;
 
 	// Break targeting on all projectiles between the player and the given
 	// government; gov projectiles stop targeting the player and player's
@@ -133,30 +155,112 @@ private:
 		double angle;
 	};
 
+	// Objects created by one group of ships while the ships are being moved in
+	// parallel. Each group of ships has its own buffer, and the buffers are
+	// merged into the lists of new objects in group order, so the result does
+	// not depend on which thread moved which group.
+	class StepBuffer {
+	public:
+		std::list<std::shared_ptr<Ship>> ships;
+		std::vector<Projectile> projectiles;
+		std::vector<Flotsam> flotsam;
+		std::vector<Visual> visuals;
+		std::vector<Particle> particles;
+		std::vector<ShipEvent> events;
+		std::vector<Ship *> antiMissile;
+	};
+
+	// The first ship a projectile hits on this step.
+	class ShipHit {
+	public:
+		// How far along the projectile's motion for this step the hit is.
+		double distance = 1.;
+		Ship *ship = nullptr;
+		Point velocity;
+		// Whether the hit has been found yet.
+		bool isKnown = false;
+	};
+
+	// A projectile with a blast radius that exploded on this step, and the
+	// ships within its radius.
+	class Blast {
+	public:
+		size_t projectile = 0;
+		Point position;
+		double radius = 0.;
+		std::vector<Body *> ships;
+	};
+
+	// Everything the HUD shows about one step. The calculation thread builds it
+	// once the step is done, so drawing it never has to look at the ships, and
+	// the main thread only reads the one for the step being drawn.
+	class Snapshot {
+	public:
+		Information info;
+		std::vector<Target> targets;
+		Point targetVector;
+		int targetSwizzle = -1;
+		EscortDisplay escorts;
+		std::vector<Status> statuses;
+		std::vector<PlanetLabel> labels;
+		std::vector<AlertLabel> missileLabels;
+		const Sprite *highlightSprite = nullptr;
+		Point highlightUnit;
+		float highlightFrame = 0.f;
+	};
+
 
 private:
 	void EnterSystem();
+	// Start loading the system that the flagship is jumping to, so that less
+	// has to be done all at once when it arrives.
+	void PrepareArrival(const System &system);
+	// Keep track of how many frames had to be drawn without a new step.
+	void CountFrame(bool isRepeated);
+	// Get the memory held by the lists of objects in flight, not counting the
+	// ships themselves.
+	int64_t ObjectBytes() const;
 
 	void ThreadEntryPoint();
 	void CalculateStep();
+	void BuildSnapshot(Snapshot &snapshot, double zoom);
 
-	void MoveShip(const std::shared_ptr<Ship> &ship);
+	// Sort the ships into groups that can be moved independently of each other.
+	void GroupShips();
+	void MoveShips(const Ship *flagship);
+	void MoveShip(const std::shared_ptr<Ship> &ship, const Ship *flagship, StepBuffer &buffer);
 
 	void SpawnFleets();
 	void SpawnPersons();
 	void GenerateWeather();
 	void SendHails();
 	void HandleKeyboardInputs();
-	void HandleMouseClicks();
-	void HandleTouchEvents();
+	// Give an input from a replay as if the player had just given it.
+	void ApplyInput(const Replay::Input &input);
+	// Set up a click at the given points, which may be the ends of a drag.
+	void QueueClick(const Point &from, const Point &to, bool hasShift, bool hasControl);
+	void HandleMouseClicks(Command &commands);
+	void HandleTouchEvents(Command &commands);
 	void HandleMouseInput(Command &activeCommands);
 	void HandleGamepadInput(Command &activeCommands);
 
 	void FillCollisionSets();
 
-	void DoCollisions(Projectile &projectile);
-	void DoWeather(Weather &weather);
-	void DoCollection(Flotsam &flotsam);
+	// Find which ships the projectiles hit ahead of time, if there are many.
+	void FindShipHits();
+	ShipHit FindShipHit(const Projectile &projectile, std::vector<Body *> &nearby) const;
+	// Find out whether the projectile hits anything, including asteroids, and
+	// if so make it explode. The ship hit is updated to the actual hit.
+	bool ResolveHit(Projectile &projectile, ShipHit &shipHit);
+	// Find the ships within the radius of each blast, in parallel if there
+	// are enough of them.
+	void FindBlastShips();
+	// Damage whatever the projectile hit, or give anti-missiles a chance to
+	// shoot it down if it hit nothing. If it exploded with a blast radius,
+	// the ships within that radius are given.
+	void DoCollisions(Projectile &projectile, const ShipHit &shipHit, const std::vector<Body *> *blastShips);
+	void DoWeather();
+	void DoCollection(Flotsam &flotsam, const std::vector<Body *> &nearby);
 	void DoScanning(const std::shared_ptr<Ship> &ship);
 
 	void FillRadar();
@@ -165,31 +269,78 @@ private:
 
 	void DoGrudge(const std::shared_ptr<Ship> &target, const Government *attacker);
 
-	void CreateStatusOverlays();
-	void EmplaceStatusOverlay(const std::shared_ptr<Ship> &ship, Preferences::OverlayState overlaySetting, int value);
+	void CreateStatusOverlays(std::vector<Status> &statuses, const Point &center);
+	void EmplaceStatusOverlay(std::vector<Status> &statuses, const Point &center, const std::shared_ptr<Ship> &ship,
+		Preferences::OverlayState overlaySetting, int value);
 
-	void HandleJoystickMovement(const Point& p);
+	void HandleJoystickMovement(const Point& p, Command &commands);
 
 private:
 	PlayerInfo &player;
 
-	std::list<std::shared_ptr<Ship>> ships;
+	std::vector<std::shared_ptr<Ship>> ships;
 	std::vector<Projectile> projectiles;
 	std::vector<Weather> activeWeather;
-	std::list<std::shared_ptr<Flotsam>> flotsam;
+	ObjectPool<Flotsam> flotsam;
 	std::vector<Visual> visuals;
+	ParticleSystem particles;
 	AsteroidField asteroids;
 
+	// The persons whose location allows them to appear in each system, as of
+	// the given universe revision. Each system's list is made when first needed.
+	std::map<const System *, std::vector<const std::pair<const std::string, Person> *>> personsBySystem;
+	uint64_t personsRevision = 0;
+
 	// New objects created within the latest step:
 	std::list<std::shared_ptr<Ship>> newShips;
 	std::vector<Projectile> newProjectiles;
-	std::list<std::shared_ptr<Flotsam>> newFlotsam;
+	std::vector<Flotsam> newFlotsam;
 	std::vector<Visual> newVisuals;
+	std::vector<Particle> newParticles;
+	// Keeps the number of visuals down when too many are being created.
+	VisualBudget visualBudget;
+	// Remembers which way each planet's label points.
+	PlanetLabel::Layout labelLayout;
 
 	// Track which ships currently have anti-missiles ready to fire.
 	std::vector<Ship *> hasAntiMissile;
-
+	// If there are many of those ships, they are indexed by position, so each
+	// missile only has to check the ones that are close to it.
+	AntiMissileGrid antiMissileGrid;
+	std::vector<Point> antiMissilePositions;
+	std::vector<double> antiMissileRanges;
+	std::vector<unsigned> antiMissileNear;
+	// The ships that are close enough to each flotsam to collect it.
+	std::vector<Point> flotsamPositions;
+	std::vector<std::vector<Body *>> flotsamCollectors;
+	// The ships touched by each hazard that deals damage this step.
+	std::vector<std::vector<Body *>> weatherHits;
+	// The first ship each projectile hits, when found ahead of time.
+	std::vector<ShipHit> shipHits;
+	// The blasts on this step, in the order of their projectiles. Only the
+	// first blastCount are in use, so that their lists keep their memory.
+	std::vector<Blast> blasts;
+	size_t blastCount = 0;
+	std::vector<Body *> nearbyShips;
+
+	// Worker threads that the calculation thread hands parallel work to.
+	JobPool jobs;
 	AI ai;
+	// Copies of the ships that are likely to spawn in the current system.
+	SpawnPool spawnPool;
+	// The system the flagship is jumping to, and its asteroid field, which is
+	// filled on a background thread while the jump plays out.
+	const System *arrivalSystem = nullptr;
+	AsteroidField arrivalAsteroids;
+	std::future<void> arrivalBuild;
+
+	// The ships, sorted by group. Ships that may change each other while moving
+	// (escorts and their parents, ships boarding each other) are in the same
+	// group and are always moved in order by a single thread.
+	std::vector<std::shared_ptr<Ship>> groupedShips;
+	std::vector<size_t> groupStart;
+	std::vector<uint64_t> groupSeeds;
+	std::vector<StepBuffer> stepBuffers;
 
 	std::thread calcThread;
 	std::condition_variable condition;
@@ -205,31 +356,28 @@ private:
 	DrawList draw[2];
 	BatchDrawList batchDraw[2];
 	Radar radar[2];
+	// The scene may be drawn at a lower resolution than the HUD. Which one is
+	// chosen depends on the previous frames, so it changes as Draw() is called.
+	mutable DynamicResolution sceneResolution;
 	// Viewport position and velocity.
 	Point center;
 	Point centerVelocity;
-	// Other information to display.
-	Information info;
-	std::vector<Target> targets;
-	Point targetVector;
+	// Other information to display. The HUD is built for each step as part of
+	// the calculations, like the draw lists.
+	Snapshot snapshots[2];
+	// The target's facing, which stays the same while it is cloaked.
 	Point targetUnit;
-	int targetSwizzle = -1;
-	EscortDisplay escorts;
 	AmmoDisplay ammoDisplay;
-	std::vector<Status> statuses;
-	std::vector<PlanetLabel> labels;
-	std::vector<AlertLabel> missileLabels;
 	std::vector<std::pair<const Outfit *, int>> ammo;
 	int jumpCount = 0;
 	const System *jumpInProgress[2] = {nullptr, nullptr};
-	const Sprite *highlightSprite = nullptr;
-	Point highlightUnit;
-	float highlightFrame = 0.f;
 
 	int step = 0;
 
-	std::list<ShipEvent> eventQueue;
-	std::list<ShipEvent> events;
+	// The events of the step being calculated, and of the last step. These are
+	// swapped each step, so once they have grown they are never reallocated.
+	std::vector<ShipEvent> eventQueue;
+	std::vector<ShipEvent> events;
 	// Keep track of who has asked for help in fighting whom.
 	std::map<const Government *, std::weak_ptr<const Ship>> grudge;
 	int grudgeTime = 0;
@@ -245,6 +393,12 @@ private:
 	// Commands that are currently active (and not yet handled). This is a combination
 	// of keyboard and mouse commands (and any other available input device).
 	Command activeCommands;
+	// The player's commands are built in the main thread and handed to the
+	// calculation thread through this buffer. Commands that come from clicks
+	// or touches, which are handled in the calculation thread, are handed back
+	// in the other buffer so the main thread sees them in the next step.
+	Command::Buffer playerCommands;
+	Command::Buffer clickCommands;
 	// Keyboard commands that were active in the previous step.
 	Command keyHeld;
 	// Pressing "land" or "board" rapidly toggles targets; pressing it once re-engages landing or boarding.
@@ -274,6 +428,13 @@ private:
 
 	// Input, Output and State handling for automated tests.
 	TestContext *testContext = nullptr;
+	// The clicks and touches of the step being replayed.
+	std::vector<Replay::Input> replayInputs;
+	// At takeoff, the calculation thread's random number generator is seeded
+	// from the main thread's, so that the flight only depends on the seed the
+	// main thread had then.
+	uint64_t calcSeed = 0;
+	bool hasCalcSeed = false;
 
 	double zoom = 1.;
 	// Tracks the next zoom change so that objects aren't drawn at different zooms in a single frame.
@@ -282,6 +443,15 @@ private:
 	double load = 0.;
 	int loadCount = 0;
 	double loadSum = 0.;
+	// How many of the last 60 frames drew the same step as the frame before.
+	int repeatedFrames = 0;
+	int frameCount = 0;
+	int repeatedSum = 0;
+	// The recent timing of each profiler zone, and the latest value of each
+	// counter, refreshed about once per second.
+	std::vector<Profiler::Summary> profile;
+	std::vector<Profiler::Counter> profileCounters;
+	int profileCount = 0;
 };
 
 
@@ -31,7 +31,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "System.h"
 
 #include <algorithm>
-#include <set>
+#include <map>
 
 using namespace std;
 
@@ -50,6 +50,7 @@ namespace {
 void EscortDisplay::Clear()
 {
 	icons.clear();
+	isStacked = false;
 }
 
 
@@ -57,6 +58,7 @@ void EscortDisplay::Clear()
 void EscortDisplay::Add(const Ship &ship, bool isHere, bool fleetIsJumping, bool isSelected)
 {
 	icons.emplace_back(ship, isHere, fleetIsJumping, isSelected);
+	isStacked = false;
 }
 
 
@@ -66,8 +68,7 @@ void EscortDisplay::Draw(const Rectangle &bounds) const
 {
 	// Figure out how much space there is for the icons.
 	int maxColumns = max(1., bounds.Width() / WIDTH);
-	MergeStacks(maxColumns, bounds.Height());
-	icons.sort();
+	Stack(maxColumns, bounds.Height());
 	stacks.clear();
 	zones.clear();
 	static const Set<Color> &colors = GameData::Colors();
@@ -85,7 +86,7 @@ void EscortDisplay::Draw(const Rectangle &bounds) const
 	const Color &hostileColor = *colors.Get("escort hostile");
 
 	int maxNumberWidth = 0;
-	for(const Icon &escort : icons)
+	for(const Icon &escort : stacked)
 	{
 		if(escort.ships.size())
 		{
@@ -95,7 +96,7 @@ void EscortDisplay::Draw(const Rectangle &bounds) const
 		}
 	}
 
-	for(const Icon &escort : icons)
+	for(const Icon &escort : stacked)
 	{
 		if(!escort.sprite)
 			continue;
@@ -261,7 +262,73 @@ void EscortDisplay::Icon::Merge(const Icon &other)
 
 
 
-void EscortDisplay::MergeStacks(int columns, int maxHeight) const
+EscortDisplay::StackKey::StackKey(const Icon &icon)
+	: sprite(icon.sprite), isHere(icon.isHere), isHostile(icon.isHostile),
+	hasSystem(!icon.system.empty()), cost(icon.cost)
+{
+}
+
+
+
+bool EscortDisplay::StackKey::operator==(const StackKey &other) const
+{
+	return sprite == other.sprite && isHere == other.isHere && isHostile == other.isHostile
+		&& hasSystem == other.hasSystem && cost == other.cost;
+}
+
+
+
+void EscortDisplay::Stack(int columns, int maxHeight) const
+{
+	if(isStacked && columns == stackColumns && maxHeight == stackHeight)
+		return;
+	isStacked = true;
+
+	bool isSame = (columns == stackColumns && maxHeight == stackHeight && stackKeys.size() == icons.size());
+	for(unsigned i = 0; isSame && i < icons.size(); ++i)
+		isSame = (stackKeys[i] == StackKey(icons[i]));
+	// If none of the escorts would be stacked any differently, merge the same
+	// icons as last time, in the same order, so that they show the new status.
+	if(isSame)
+	{
+		stacked.clear();
+		for(const vector<unsigned> &members : stackMembers)
+		{
+			stacked.push_back(icons[members.front()]);
+			for(unsigned i = 1; i < members.size(); ++i)
+				stacked.back().Merge(icons[members[i]]);
+		}
+		return;
+	}
+
+	stackColumns = columns;
+	stackHeight = maxHeight;
+	stackKeys.clear();
+	for(const Icon &icon : icons)
+		stackKeys.emplace_back(icon);
+
+	list<Icon> merged(icons.begin(), icons.end());
+	MergeStacks(merged, columns, maxHeight);
+	merged.sort();
+	stacked.assign(merged.begin(), merged.end());
+
+	// Each escort starts out with an icon of its own, so the ships in each
+	// stack tell which escorts were merged into it.
+	map<const Ship *, unsigned> index;
+	for(unsigned i = 0; i < icons.size(); ++i)
+		index.emplace(icons[i].ships.front(), i);
+	stackMembers.clear();
+	for(const Icon &icon : stacked)
+	{
+		stackMembers.emplace_back();
+		for(const Ship *ship : icon.ships)
+			stackMembers.back().push_back(index[ship]);
+	}
+}
+
+
+
+void EscortDisplay::MergeStacks(list<Icon> &icons, int columns, int maxHeight)
 {
 	if(icons.empty())
 		return;
@@ -69,13 +69,40 @@ private:
 		std::vector<const Ship *> ships;
 	};
 
+	// Everything about an escort that decides how its icon is stacked.
+	class StackKey {
+	public:
+		explicit StackKey(const Icon &icon);
+
+		bool operator==(const StackKey &other) const;
+
+		const Sprite *sprite;
+		bool isHere;
+		bool isHostile;
+		bool hasSystem;
+		int64_t cost;
+	};
+
 
 private:
-	void MergeStacks(int columns, int maxHeight) const;
+	// Stack the icons to fit in the given space, unless the last stacking can
+	// be reused with the escorts' current status filled in.
+	void Stack(int columns, int maxHeight) const;
+	static void MergeStacks(std::list<Icon> &icons, int columns, int maxHeight);
 
 
 private:
-	mutable std::list<Icon> icons;
+	std::vector<Icon> icons;
+	// The icons as they are drawn, after stacking. Which escorts go in which
+	// stack is only worked out again if the escorts, their stack keys, or the
+	// space to draw them in have changed.
+	mutable std::vector<Icon> stacked;
+	mutable std::vector<std::vector<unsigned>> stackMembers;
+	mutable std::vector<StackKey> stackKeys;
+	mutable int stackColumns = 0;
+	mutable int stackHeight = 0;
+	mutable bool isStacked = false;
+
 	mutable std::vector<std::vector<const Ship *>> stacks;
 	mutable std::vector<Rectangle> zones;
 };
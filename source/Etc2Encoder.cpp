@@ -0,0 +1,316 @@
+/* Etc2Encoder.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Etc2Encoder.h"
+
+#include "ImageBuffer.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+	// The alpha modifier tables. A pixel's alpha is the block's base value plus
+	// one of the modifiers in its table, times the block's multiplier.
+	const int ALPHA_MODIFIERS[16][8] = {
+		{-3, -6, -9, -15, 2, 5, 8, 14},
+		{-3, -7, -10, -13, 2, 6, 9, 12},
+		{-2, -5, -8, -13, 1, 4, 7, 12},
+		{-2, -4, -6, -13, 1, 3, 5, 12},
+		{-3, -6, -8, -12, 2, 5, 7, 11},
+		{-3, -7, -9, -11, 2, 6, 8, 10},
+		{-4, -7, -8, -11, 3, 6, 7, 10},
+		{-3, -5, -8, -11, 2, 4, 7, 10},
+		{-2, -6, -8, -10, 1, 5, 7, 9},
+		{-2, -5, -8, -10, 1, 4, 7, 9},
+		{-2, -4, -8, -10, 1, 3, 7, 9},
+		{-2, -5, -7, -10, 1, 4, 6, 9},
+		{-3, -4, -7, -10, 2, 3, 6, 9},
+		{-1, -2, -3, -10, 0, 1, 2, 9},
+		{-4, -6, -8, -9, 3, 5, 7, 8},
+		{-3, -5, -7, -9, 2, 4, 6, 8}
+	};
+	// The color modifier tables. Each pixel adds one of these to every channel
+	// of its half of the block's base color, either positive or negative.
+	const int COLOR_MODIFIERS[8][2] = {
+		{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+	};
+
+	int Clamp(int value)
+	{
+		return max(0, min(255, value));
+	}
+
+	// Blocks store their pixels column by column, so the pixel at (x, y) is
+	// number x * 4 + y. A block is split into two halves, either side by side
+	// or, if it is "flipped," one above the other.
+	int Half(int i, bool flip)
+	{
+		return flip ? ((i & 3) >= 2) : (i >= 8);
+	}
+
+	void WriteBlock(uint64_t block, uint8_t *out)
+	{
+		for(int i = 0; i < 8; ++i)
+			out[i] = block >> (56 - 8 * i);
+	}
+
+
+
+	uint64_t EncodeAlpha(const int alpha[16])
+	{
+		int low = 255;
+		int high = 0;
+		for(int i = 0; i < 16; ++i)
+		{
+			low = min(low, alpha[i]);
+			high = max(high, alpha[i]);
+		}
+		// A block with only one alpha value can be stored exactly, because one
+		// of the modifiers in table 13 is zero. Most blocks of a sprite are
+		// either fully opaque or fully transparent, so this is the usual case.
+		if(low == high)
+			return static_cast<uint64_t>(low) << 56 | 1ull << 52 | 13ull << 48 | 0x924924924924ull;
+
+		uint64_t best = 0;
+		int bestError = INT_MAX;
+		for(int table = 0; table < 16 && bestError; ++table)
+		{
+			const int *modifiers = ALPHA_MODIFIERS[table];
+			// Find the multiplier that makes this table span the block's range of
+			// values, and try the ones on either side of it too.
+			int span = modifiers[7] - modifiers[3];
+			int ideal = (high - low + span - 1) / span;
+			for(int multiplier = max(1, ideal - 1); multiplier <= min(15, ideal + 1); ++multiplier)
+			{
+				int base = Clamp((low + high - (modifiers[3] + modifiers[7]) * multiplier + 1) / 2);
+				int values[8];
+				for(int j = 0; j < 8; ++j)
+					values[j] = Clamp(base + modifiers[j] * multiplier);
+
+				int error = 0;
+				uint64_t indices = 0;
+				for(int i = 0; i < 16 && error < bestError; ++i)
+				{
+					int bestIndex = 0;
+					int bestDistance = INT_MAX;
+					for(int j = 0; j < 8; ++j)
+					{
+						int distance = abs(values[j] - alpha[i]);
+						if(distance < bestDistance)
+						{
+							bestIndex = j;
+							bestDistance = distance;
+						}
+					}
+					error += bestDistance * bestDistance;
+					indices |= static_cast<uint64_t>(bestIndex) << (45 - 3 * i);
+				}
+				if(error < bestError)
+				{
+					bestError = error;
+					best = static_cast<uint64_t>(base) << 56 | static_cast<uint64_t>(multiplier) << 52
+						| static_cast<uint64_t>(table) << 48 | indices;
+				}
+			}
+		}
+		return best;
+	}
+
+
+
+	// Choose the modifier table and each pixel's modifier for one half of a color
+	// block with the given base color. Return the squared error of the result.
+	int FitHalf(const int color[16][3], bool flip, int half, const int base[3], int &table, uint64_t &bits)
+	{
+		int bestError = INT_MAX;
+		for(int t = 0; t < 8; ++t)
+		{
+			// Pixel indices 0 through 3 select the small and large modifiers,
+			// then the negatives of them.
+			const int modifiers[4] = {COLOR_MODIFIERS[t][0], COLOR_MODIFIERS[t][1],
+				-COLOR_MODIFIERS[t][0], -COLOR_MODIFIERS[t][1]};
+			int values[4][3];
+			for(int j = 0; j < 4; ++j)
+				for(int c = 0; c < 3; ++c)
+					values[j][c] = Clamp(base[c] + modifiers[j]);
+
+			int error = 0;
+			uint64_t tableBits = 0;
+			for(int i = 0; i < 16 && error < bestError; ++i)
+			{
+				if(Half(i, flip) != half)
+					continue;
+
+				int bestIndex = 0;
+				int bestDistance = INT_MAX;
+				for(int j = 0; j < 4; ++j)
+				{
+					int distance = 0;
+					for(int c = 0; c < 3; ++c)
+						distance += (values[j][c] - color[i][c]) * (values[j][c] - color[i][c]);
+					if(distance < bestDistance)
+					{
+						bestIndex = j;
+						bestDistance = distance;
+					}
+				}
+				error += bestDistance;
+				// The high bit of each pixel's index is stored in the upper half
+				// of the block's index bits, and the low bit in the lower half.
+				tableBits |= static_cast<uint64_t>(bestIndex >> 1) << (16 + i) | static_cast<uint64_t>(bestIndex & 1) << i;
+			}
+			if(error < bestError)
+			{
+				bestError = error;
+				table = t;
+				bits = tableBits;
+			}
+		}
+		return bestError;
+	}
+
+
+
+	uint64_t EncodeColor(const int color[16][3])
+	{
+		uint64_t best = 0;
+		int bestError = INT_MAX;
+		for(int flip = 0; flip < 2; ++flip)
+		{
+			// Each half's base color is its average color, stored either with four
+			// bits per channel ("individual" mode) or with five bits for the first
+			// half and a three-bit difference for the second ("differential" mode).
+			int sum[2][3] = {};
+			for(int i = 0; i < 16; ++i)
+				for(int c = 0; c < 3; ++c)
+					sum[Half(i, flip)][c] += color[i][c];
+
+			int individual[2][3];
+			int differential[2][3];
+			bool canDiffer = true;
+			for(int c = 0; c < 3; ++c)
+			{
+				for(int half = 0; half < 2; ++half)
+				{
+					individual[half][c] = (sum[half][c] * 15 + 255 * 4) / (255 * 8);
+					differential[half][c] = (sum[half][c] * 31 + 255 * 4) / (255 * 8);
+				}
+				int difference = differential[1][c] - differential[0][c];
+				canDiffer &= (difference >= -4 && difference <= 3);
+			}
+
+			for(int isDifferential = 0; isDifferential < 2; ++isDifferential)
+			{
+				if(isDifferential && !canDiffer)
+					continue;
+
+				uint64_t block = static_cast<uint64_t>(isDifferential) << 33 | static_cast<uint64_t>(flip) << 32;
+				int base[2][3];
+				for(int c = 0; c < 3; ++c)
+				{
+					if(isDifferential)
+					{
+						for(int half = 0; half < 2; ++half)
+							base[half][c] = differential[half][c] << 3 | differential[half][c] >> 2;
+						block |= static_cast<uint64_t>(differential[0][c]) << (59 - 8 * c)
+							| static_cast<uint64_t>((differential[1][c] - differential[0][c]) & 7) << (56 - 8 * c);
+					}
+					else
+					{
+						for(int half = 0; half < 2; ++half)
+							base[half][c] = individual[half][c] * 17;
+						block |= static_cast<uint64_t>(individual[0][c]) << (60 - 8 * c)
+							| static_cast<uint64_t>(individual[1][c]) << (56 - 8 * c);
+					}
+				}
+
+				int error = 0;
+				for(int half = 0; half < 2; ++half)
+				{
+					int table = 0;
+					uint64_t bits = 0;
+					error += FitHalf(color, flip, half, base[half], table, bits);
+					block |= bits | static_cast<uint64_t>(table) << (half ? 34 : 37);
+				}
+				if(error < bestError)
+				{
+					bestError = error;
+					best = block;
+				}
+			}
+		}
+		return best;
+	}
+}
+
+
+
+// Encode every frame of the given uncompressed image, one after another.
+string Etc2Encoder::Encode(const ImageBuffer &image)
+{
+	const int width = image.Width();
+	const int height = image.Height();
+	const int blockWidth = (width + 3) / 4;
+	const int blockHeight = (height + 3) / 4;
+	string result(static_cast<size_t>(blockWidth) * blockHeight * image.Frames() * 16, '\0');
+
+	uint8_t *out = reinterpret_cast<uint8_t *>(&result[0]);
+	uint32_t pixels[16];
+	for(int frame = 0; frame < image.Frames(); ++frame)
+		for(int blockY = 0; blockY < blockHeight; ++blockY)
+			for(int blockX = 0; blockX < blockWidth; ++blockX, out += 16)
+			{
+				// Blocks on the right and bottom edges may be partly outside the
+				// image. Fill in the rest by repeating the last row and column.
+				for(int y = 0; y < 4; ++y)
+				{
+					const uint32_t *row = image.Begin(min(blockY * 4 + y, height - 1), frame);
+					for(int x = 0; x < 4; ++x)
+						pixels[y * 4 + x] = row[min(blockX * 4 + x, width - 1)];
+				}
+				EncodeBlock(pixels, out);
+			}
+	return result;
+}
+
+
+
+// Encode a single block of 16 pixels, given row by row, into 16 bytes.
+void Etc2Encoder::EncodeBlock(const uint32_t *pixels, uint8_t *out)
+{
+	// Fully transparent blocks are by far the most common kind in a sprite, and
+	// in premultiplied alpha their color is always black.
+	static const uint64_t CLEAR_COLOR = [] {
+		int black[16][3] = {};
+		return EncodeColor(black);
+	}();
+
+	int alpha[16];
+	int color[16][3];
+	bool isClear = true;
+	for(int i = 0; i < 16; ++i)
+	{
+		uint32_t value = pixels[(i & 3) * 4 + (i >> 2)];
+		for(int c = 0; c < 3; ++c)
+			color[i][c] = (value >> (8 * c)) & 0xFF;
+		alpha[i] = value >> 24;
+		isClear &= !value;
+	}
+	WriteBlock(EncodeAlpha(alpha), out);
+	WriteBlock(isClear ? CLEAR_COLOR : EncodeColor(color), out + 8);
+}
@@ -0,0 +1,46 @@
+/* Etc2Encoder.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ETC2_ENCODER_H_
+#define ETC2_ENCODER_H_
+
+#include <cstdint>
+#include <string>
+
+class ImageBuffer;
+
+
+
+// Compresses images into the ETC2 RGBA format, which every OpenGL ES 3 driver
+// can use. Each 4x4 block of pixels becomes 8 bytes of alpha followed by 8 bytes
+// of color, in the layout that Etc2RGBA reads. This is a quick encoder meant to
+// run while the game is loading, so it only uses the ETC1 color modes and
+// picks each block's settings with a short search rather than an exhaustive one.
+class Etc2Encoder {
+public:
+	// The OpenGL internal format of the encoded data, GL_COMPRESSED_RGBA8_ETC2_EAC.
+	static const uint32_t FORMAT = 0x9278;
+
+
+public:
+	// Encode every frame of the given uncompressed image, one after another.
+	static std::string Encode(const ImageBuffer &image);
+	// Encode a single block of 16 pixels, given row by row, into 16 bytes.
+	static void EncodeBlock(const uint32_t *pixels, uint8_t *out);
+};
+
+
+
+#endif
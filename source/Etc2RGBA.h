@@ -17,36 +17,32 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <cstdint>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#ifdef __SSSE3__
+#include <tmmintrin.h>
+#endif
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 class Etc2RGBA
 {
 public:
    Etc2RGBA(const void* data, int width, int height):
+      m_width(width), m_height(height),
       m_block_width((width+3)/4), m_block_height((height+3)/4),
       m_data(reinterpret_cast<const uint64_t*>(data)) {}
 
    // TODO: do we need the ability to read the color? the alpha is encoded separately
 
-   uint8_t Alpha(int frame, int x, int y)
+   uint8_t Alpha(int frame, int x, int y) const
    {
       // NOTE: this is the same as the R11 format used for red-only textures
 
       // pixels are encoded in 4x4 blocks, 8 bytes for alpha, followed by 8
       // bytes for rgba. Retrieve the alpha block.
-      uint64_t alpha = *(m_data + (m_block_width * m_block_height * 2 * frame) +
-                                  (m_block_width * 2 * (y/4)) + (x/4) * 2);
-
-      // in big endian format, need to byteswap
-      // TODO: is this defined anywhere for us? as-is, this gets converted by
-      // gcc into a bswap on x86, and a rev on arm64
-      alpha = (alpha & 0xff00000000000000) >> 56
-            | (alpha & 0x00ff000000000000) >> 40
-            | (alpha & 0x0000ff0000000000) >> 24
-            | (alpha & 0x000000ff00000000) >>  8
-            | (alpha & 0x00000000ff000000) <<  8
-            | (alpha & 0x0000000000ff0000) << 24
-            | (alpha & 0x000000000000ff00) << 40
-            | (alpha & 0x00000000000000ff) << 56;
-
+      uint64_t alpha = ReadBlock(frame, x/4, y/4);
 
       // alpha represents a 4x4 block of pixels. Get the one we actually want
       int idx = ((x & 3) << 2) | (y & 3);
@@ -59,7 +55,108 @@ public:
       int value_index = (alpha >> ((15 - idx) * 3)) & 7;
 
       // now we can compute the actual pixel
-      static const int modifier_table[][8] = {
+      int value = base_codeword + Modifiers(table_idx)[value_index] * multiplier;
+      if (value < 0) value = 0;
+      else if (value > 255) value = 255;
+      return value;
+   }
+
+   // Decode the alpha of a whole 4x4 block, row by row, into the given 16
+   // bytes. The block is only read once, and the 8 alpha values it can have
+   // are computed all at once, so this is much faster than calling Alpha()
+   // for each pixel.
+   void AlphaBlock(int frame, int block_x, int block_y, uint8_t* out) const
+   {
+      uint64_t alpha = ReadBlock(frame, block_x, block_y);
+      int16_t base_codeword = alpha >> 56;
+      int16_t multiplier = (alpha >> 52) & 0xf;
+      const int16_t* modifiers = Modifiers((alpha >> 48) & 0xf);
+
+      // Get each pixel's index into the palette, in row order. The indices
+      // are stored in column order.
+      alignas(16) uint8_t indices[16];
+      for (int i = 0; i < 16; ++i)
+      {
+         int idx = ((i & 3) << 2) | (i >> 2);
+         indices[i] = (alpha >> ((15 - idx) * 3)) & 7;
+      }
+
+#if defined(__SSE2__)
+      // the saturating pack clamps the values to [0, 255]
+      __m128i values = _mm_add_epi16(_mm_set1_epi16(base_codeword),
+         _mm_mullo_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(modifiers)),
+            _mm_set1_epi16(multiplier)));
+      __m128i palette = _mm_packus_epi16(values, values);
+#ifdef __SSSE3__
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+         _mm_shuffle_epi8(palette, _mm_load_si128(reinterpret_cast<const __m128i*>(indices))));
+#else
+      alignas(16) uint8_t lookup[16];
+      _mm_store_si128(reinterpret_cast<__m128i*>(lookup), palette);
+      for (int i = 0; i < 16; ++i)
+         out[i] = lookup[indices[i]];
+#endif
+#elif defined(__ARM_NEON)
+      // the saturating narrow clamps the values to [0, 255]
+      uint8x8_t palette = vqmovun_s16(vmlaq_s16(vdupq_n_s16(base_codeword),
+         vld1q_s16(modifiers), vdupq_n_s16(multiplier)));
+      vst1q_u8(out, vcombine_u8(vtbl1_u8(palette, vld1_u8(indices)), vtbl1_u8(palette, vld1_u8(indices + 8))));
+#else
+      uint8_t palette[8];
+      for (int i = 0; i < 8; ++i)
+      {
+         int value = base_codeword + modifiers[i] * multiplier;
+         palette[i] = value < 0 ? 0 : value > 255 ? 255 : value;
+      }
+      for (int i = 0; i < 16; ++i)
+         out[i] = palette[indices[i]];
+#endif
+   }
+
+   // Decode the alpha of a whole frame into the given plane, which must have
+   // room for one byte per pixel, row by row.
+   void AlphaFrame(int frame, uint8_t* plane) const
+   {
+      uint8_t block[16];
+      for (int block_y = 0; block_y < m_block_height; ++block_y)
+         for (int block_x = 0; block_x < m_block_width; ++block_x)
+         {
+            AlphaBlock(frame, block_x, block_y, block);
+
+            // blocks on the right and bottom edges may be partly outside the image
+            int columns = m_width - block_x * 4 < 4 ? m_width - block_x * 4 : 4;
+            int rows = m_height - block_y * 4 < 4 ? m_height - block_y * 4 : 4;
+            for (int y = 0; y < rows; ++y)
+               for (int x = 0; x < columns; ++x)
+                  plane[(block_y * 4 + y) * m_width + block_x * 4 + x] = block[y * 4 + x];
+         }
+   }
+
+private:
+   // Get the given block's alpha data.
+   uint64_t ReadBlock(int frame, int block_x, int block_y) const
+   {
+      // Each block is 8 bytes of alpha followed by 8 bytes of color.
+      uint64_t alpha = *(m_data + (m_block_width * m_block_height * 2 * frame) +
+                                  (m_block_width * 2 * block_y) + block_x * 2);
+
+      // in big endian format, need to byteswap
+      // TODO: is this defined anywhere for us? as-is, this gets converted by
+      // gcc into a bswap on x86, and a rev on arm64
+      return (alpha & 0xff00000000000000) >> 56
+           | (alpha & 0x00ff000000000000) >> 40
+           | (alpha & 0x0000ff0000000000) >> 24
+           | (alpha & 0x000000ff00000000) >>  8
+           | (alpha & 0x00000000ff000000) <<  8
+           | (alpha & 0x0000000000ff0000) << 24
+           | (alpha & 0x000000000000ff00) << 40
+           | (alpha & 0x00000000000000ff) << 56;
+   }
+
+   // Get the given row of the table of alpha modifiers.
+   static const int16_t* Modifiers(int table_idx)
+   {
+      alignas(16) static const int16_t modifier_table[][8] = {
          { -3,  -6,  -9, -15,  2,  5,  8, 14 },
          { -3,  -7, -10, -13,  2,  6,  9, 12 },
          { -2,  -5,  -8, -13,  1,  4,  7, 12 },
@@ -77,16 +174,15 @@ public:
          { -4,  -6,  -8,  -9,  3,  5,  7,  8 },
          { -3,  -5,  -7,  -9,  2,  4,  6,  8 },
       };
-      int value = base_codeword + modifier_table[table_idx][value_index] * multiplier;
-      if (value < 0) value = 0;
-      else if (value > 255) value = 255;
-      return value;
+      return modifier_table[table_idx];
    }
 
 private:
+   const int m_width;
+   const int m_height;
    const int m_block_width;
    const int m_block_height;
    const uint64_t* const m_data;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "File.h"
 #include "Logger.h"
+#include "PluginArchive.h"
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_rwops.h>
@@ -85,6 +86,73 @@ namespace {
 		Logger::LogError("Warning: No handler found to open \"" + path + "\" in a new window.");
 #endif
 	}
+
+	// A read-only SDL_RWops over data that it owns, for files in plugin archives
+	// that had to be decompressed in order to be read.
+	class Buffer {
+	public:
+		string data;
+		size_t position = 0;
+	};
+
+	Buffer &GetBuffer(SDL_RWops *ops)
+	{
+		return *static_cast<Buffer *>(ops->hidden.unknown.data1);
+	}
+
+	Sint64 BufferSize(SDL_RWops *ops)
+	{
+		return GetBuffer(ops).data.size();
+	}
+
+	Sint64 BufferSeek(SDL_RWops *ops, Sint64 offset, int whence)
+	{
+		Buffer &buffer = GetBuffer(ops);
+		Sint64 origin = (whence == RW_SEEK_SET ? 0 : whence == RW_SEEK_CUR ? buffer.position : buffer.data.size());
+		Sint64 position = max<Sint64>(0, min<Sint64>(origin + offset, buffer.data.size()));
+		buffer.position = position;
+		return position;
+	}
+
+	size_t BufferRead(SDL_RWops *ops, void *ptr, size_t size, size_t maxnum)
+	{
+		Buffer &buffer = GetBuffer(ops);
+		if(!size)
+			return 0;
+		size_t count = min(maxnum, (buffer.data.size() - buffer.position) / size);
+		copy_n(buffer.data.data() + buffer.position, count * size, static_cast<char *>(ptr));
+		buffer.position += count * size;
+		return count;
+	}
+
+	size_t BufferWrite(SDL_RWops *, const void *, size_t, size_t)
+	{
+		return 0;
+	}
+
+	int BufferClose(SDL_RWops *ops)
+	{
+		delete &GetBuffer(ops);
+		SDL_FreeRW(ops);
+		return 0;
+	}
+
+	SDL_RWops *OpenBuffer(string &&data)
+	{
+		SDL_RWops *ops = SDL_AllocRW();
+		if(!ops)
+			return nullptr;
+		ops->size = BufferSize;
+		ops->seek = BufferSeek;
+		ops->read = BufferRead;
+		ops->write = BufferWrite;
+		ops->close = BufferClose;
+		ops->type = SDL_RWOPS_UNKNOWN;
+		Buffer *buffer = new Buffer;
+		buffer->data = std::move(data);
+		ops->hidden.unknown.data1 = buffer;
+		return ops;
+	}
 }
 
 
@@ -246,6 +314,10 @@ vector<string> Files::List(string directory)
 	if(directory.empty() || directory.back() != '/')
 		directory += '/';
 
+	string name;
+	if(const PluginArchive *archive = PluginArchive::Find(directory, name))
+		return archive->List(name);
+
 	vector<string> list;
 
 #if defined _WIN32
@@ -320,6 +392,10 @@ vector<string> Files::ListDirectories(string directory)
 	if(directory.empty() || directory.back() != '/')
 		directory += '/';
 
+	string name;
+	if(const PluginArchive *archive = PluginArchive::Find(directory, name))
+		return archive->ListDirectories(name);
+
 	vector<string> list;
 
 #if defined _WIN32
@@ -407,6 +483,14 @@ void Files::RecursiveList(string directory, vector<string> *list)
 	if(directory.empty() || directory.back() != '/')
 		directory += '/';
 
+	string name;
+	if(const PluginArchive *archive = PluginArchive::Find(directory, name))
+	{
+		vector<string> files = archive->RecursiveList(name);
+		list->insert(list->end(), files.begin(), files.end());
+		return;
+	}
+
 #if defined _WIN32
 	WIN32_FIND_DATAW ffd;
 	HANDLE hFind = FindFirstFileW(Utf8::ToUTF16(directory + '*').c_str(), &ffd);
@@ -489,6 +573,10 @@ void Files::RecursiveList(string directory, vector<string> *list)
 
 bool Files::Exists(const string &filePath)
 {
+	string name;
+	if(const PluginArchive *archive = PluginArchive::Find(filePath, name))
+		return archive->Exists(name);
+
 #if defined _WIN32
 	struct _stat buf;
 	return !_wstat(Utf8::ToUTF16(filePath).c_str(), &buf);
@@ -519,6 +607,10 @@ bool Files::Exists(const string &filePath)
 
 time_t Files::Timestamp(const string &filePath)
 {
+	string name;
+	if(const PluginArchive *archive = PluginArchive::Find(filePath, name))
+		return archive->Timestamp();
+
 #if defined _WIN32
 	struct _stat buf;
 	_wstat(Utf8::ToUTF16(filePath).c_str(), &buf);
@@ -531,6 +623,26 @@ time_t Files::Timestamp(const string &filePath)
 
 
 
+int64_t Files::Size(const string &filePath)
+{
+	string name;
+	if(const PluginArchive *archive = PluginArchive::Find(filePath, name))
+		return archive->Size(name);
+
+#if defined _WIN32
+	struct _stat buf;
+	if(_wstat(Utf8::ToUTF16(filePath).c_str(), &buf))
+		return -1;
+#else
+	struct stat buf;
+	if(stat(filePath.c_str(), &buf))
+		return -1;
+#endif
+	return buf.st_size;
+}
+
+
+
 void Files::Copy(const string &from, const string &to)
 {
 #if defined _WIN32
@@ -588,6 +700,21 @@ string Files::Name(const string &path)
 
 struct SDL_RWops *Files::Open(const string &path, bool write)
 {
+	// Files in plugin archives are read-only. Those that are stored uncompressed
+	// can be read straight from the archive's mapping, which lasts as long as
+	// the game does.
+	string name;
+	const PluginArchive *archive = PluginArchive::Find(path, name);
+	if(archive && !write)
+	{
+		size_t size = 0;
+		if(const char *data = archive->Data(name, size))
+			return SDL_RWFromConstMem(data, static_cast<int>(size));
+		return archive->Size(name) >= 0 ? OpenBuffer(archive->Read(name)) : nullptr;
+	}
+	else if(archive)
+		return nullptr;
+
 	return SDL_RWFromFile(path.c_str(), write ? "wb" : "rb");
 }
 
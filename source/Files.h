@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef ES_FILES_H_
 #define ES_FILES_H_
 
+#include <cstdint>
 #include <cstdio>
 #include <ctime>
 #include <string>
@@ -55,6 +56,9 @@ public:
 
 	static bool Exists(const std::string &filePath);
 	static std::time_t Timestamp(const std::string &filePath);
+	// Get the size of the given file in bytes, or -1 if it cannot be found
+	// (e.g. because it is inside an Android asset bundle).
+	static int64_t Size(const std::string &filePath);
 	static void Copy(const std::string &from, const std::string &to);
 	static void Move(const std::string &from, const std::string &to);
 	static void Delete(const std::string &filePath);
@@ -31,6 +31,10 @@ namespace {
 
 	GLuint vao;
 	GLuint vbo;
+
+	// The program keeps its uniform values between draws, so the scale only
+	// has to be set again when the screen size changes.
+	GLfloat lastScale[2] = {0.f, 0.f};
 }
 
 
@@ -62,13 +66,14 @@ void FillShader::Init()
 
 	shader = Shader(vertexCode, fragmentCode);
 	scaleI = shader.Uniform("scale");
+	lastScale[0] = lastScale[1] = 0.f;
 	centerI = shader.Uniform("center");
 	sizeI = shader.Uniform("size");
 	colorI = shader.Uniform("color");
 
 	// Generate the vertex data for drawing sprites.
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -86,7 +91,7 @@ void FillShader::Init()
 
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
 }
 
 
@@ -96,11 +101,16 @@ void FillShader::Fill(const Point &center, const Point &size, const Color &color
 	if(!shader.Object())
 		throw std::runtime_error("FillShader: Draw() called before Init().");
 
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindVertexArray(vao);
 
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	if(scale[0] != lastScale[0] || scale[1] != lastScale[1])
+	{
+		glUniform2fv(scaleI, 1, scale);
+		lastScale[0] = scale[0];
+		lastScale[1] = scale[1];
+	}
 
 	GLfloat centerV[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
 	glUniform2fv(centerI, 1, centerV);
@@ -111,7 +121,4 @@ void FillShader::Fill(const Point &center, const Point &size, const Color &color
 	glUniform4fv(colorI, 1, color.Get());
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-	glBindVertexArray(0);
-	glUseProgram(0);
 }
@@ -25,6 +25,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Random.h"
 #include "Ship.h"
 #include "ShipJumpNavigation.h"
+#include "SpawnPool.h"
 #include "StellarObject.h"
 #include "System.h"
 
@@ -148,16 +149,24 @@ bool Fleet::IsValid(bool requireGovernment) const
 
 
 
-void Fleet::RemoveInvalidVariants()
+string Fleet::RemoveInvalidVariants()
 {
 	int total = variants.TotalWeight();
 	int count = erase_if(variants, [](const Variant &v) noexcept -> bool { return !v.IsValid(); });
 	if(!count)
-		return;
+		return string();
 
-	Logger::LogError("Warning: " + (fleetName.empty() ? "unnamed fleet" : "fleet \"" + fleetName + "\"")
+	return (fleetName.empty() ? "unnamed fleet" : "fleet \"" + fleetName + "\"")
 		+ ": Removing " + to_string(count) + " invalid " + (count > 1 ? "variants" : "variant")
-		+ " (" + to_string(total - variants.TotalWeight()) + " of " + to_string(total) + " weight)");
+		+ " (" + to_string(total - variants.TotalWeight()) + " of " + to_string(total) + " weight)";
+}
+
+
+
+// Get the name this fleet was defined with, if any.
+const string &Fleet::Name() const
+{
+	return fleetName;
 }
 
 
@@ -170,8 +179,15 @@ const Government *Fleet::GetGovernment() const
 
 
 
+const WeightedList<Variant> &Fleet::Variants() const
+{
+	return variants;
+}
+
+
+
 // Choose a fleet to be created during flight, and have it enter the system via jump or planetary departure.
-void Fleet::Enter(const System &system, list<shared_ptr<Ship>> &ships, const Planet *planet) const
+void Fleet::Enter(const System &system, list<shared_ptr<Ship>> &ships, const Planet *planet, SpawnPool *pool) const
 {
 	if(variants.empty() || personality.IsDerelict())
 		return;
@@ -266,7 +282,7 @@ void Fleet::Enter(const System &system, list<shared_ptr<Ship>> &ships, const Pla
 			source = linkVector[choice];
 	}
 
-	auto placed = Instantiate(variantShips);
+	auto placed = Instantiate(variantShips, pool);
 	// Carry all ships that can be carried, as they don't need to be positioned
 	// or checked to see if they can access a particular planet.
 	for(auto &ship : placed)
@@ -340,7 +356,8 @@ void Fleet::Enter(const System &system, list<shared_ptr<Ship>> &ships, const Pla
 
 // Place one of the variants in the given system, already "in action." If the carried flag is set,
 // only uncarried ships will be added to the list (as any carriables will be stored in bays).
-void Fleet::Place(const System &system, list<shared_ptr<Ship>> &ships, bool carried, bool addCargo) const
+void Fleet::Place(const System &system, list<shared_ptr<Ship>> &ships, bool carried, bool addCargo,
+		SpawnPool *pool) const
 {
 	if(variants.empty())
 		return;
@@ -355,7 +372,7 @@ void Fleet::Place(const System &system, list<shared_ptr<Ship>> &ships, bool carr
 
 	// Place all the ships in the chosen fleet variant.
 	shared_ptr<Ship> flagship;
-	vector<shared_ptr<Ship>> placed = Instantiate(variantShips);
+	vector<shared_ptr<Ship>> placed = Instantiate(variantShips, pool);
 	for(shared_ptr<Ship> &ship : placed)
 	{
 		// If this is a fighter and someone can carry it, no need to position it.
@@ -453,7 +470,7 @@ pair<Point, double> Fleet::ChooseCenter(const System &system)
 
 
 
-vector<shared_ptr<Ship>> Fleet::Instantiate(const vector<const Ship *> &ships) const
+vector<shared_ptr<Ship>> Fleet::Instantiate(const vector<const Ship *> &ships, SpawnPool *pool) const
 {
 	vector<shared_ptr<Ship>> placed;
 	for(const Ship *model : ships)
@@ -466,8 +483,10 @@ vector<shared_ptr<Ship>> Fleet::Instantiate(const vector<const Ship *> &ships) c
 			continue;
 		}
 
-		// Copy the model instance into a new instance.
-		auto ship = make_shared<Ship>(*model);
+		// Copy the model instance into a new instance, unless a copy was made ahead of time.
+		shared_ptr<Ship> ship = pool ? pool->Take(model) : nullptr;
+		if(!ship)
+			ship = make_shared<Ship>(*model);
 
 		const Phrase *phrase = ((ship->CanBeCarried() && fighterNames) ? fighterNames : names);
 		if(phrase)
@@ -35,6 +35,7 @@ class Outfit;
 class Phrase;
 class Planet;
 class Ship;
+class SpawnPool;
 class System;
 
 
@@ -56,17 +57,25 @@ public:
 	// Determine if this fleet template uses well-defined data.
 	bool IsValid(bool requireGovernment = true) const;
 	// Ensure any variant selected during gameplay will have at least one ship to spawn.
-	void RemoveInvalidVariants();
+	// If any variants are removed, this returns a warning saying so.
+	std::string RemoveInvalidVariants();
 
+	// Get the name this fleet was defined with, if any.
+	const std::string &Name() const;
 	// Get the government of this fleet.
 	const Government *GetGovernment() const;
+	// Get the variants this fleet chooses from, weighted by how often each is chosen.
+	const WeightedList<Variant> &Variants() const;
 
 	// Choose a fleet to be created during flight, and have it enter the system via jump or planetary departure.
-	void Enter(const System &system, std::list<std::shared_ptr<Ship>> &ships, const Planet *planet = nullptr) const;
+	// If a spawn pool is given, any ready copies of the chosen ships are taken from it.
+	void Enter(const System &system, std::list<std::shared_ptr<Ship>> &ships, const Planet *planet = nullptr,
+			SpawnPool *pool = nullptr) const;
 	// Place a fleet in the given system, already "in action." If the carried flag is set, only
 	// uncarried ships will be added to the list (as any carriables will be stored in bays).
+	// As with Enter(), ready copies of the chosen ships are taken from the spawn pool, if any.
 	void Place(const System &system, std::list<std::shared_ptr<Ship>> &ships,
-			bool carried = true, bool addCargo = true) const;
+			bool carried = true, bool addCargo = true, SpawnPool *pool = nullptr) const;
 
 	// Do the randomization to make a ship enter or be in the given system.
 	// Return the system that was chosen for the ship to enter from.
@@ -78,7 +87,8 @@ public:
 
 private:
 	static std::pair<Point, double> ChooseCenter(const System &system);
-	std::vector<std::shared_ptr<Ship>> Instantiate(const std::vector<const Ship *> &ships) const;
+	std::vector<std::shared_ptr<Ship>> Instantiate(const std::vector<const Ship *> &ships,
+			SpawnPool *pool = nullptr) const;
 	bool PlaceFighter(std::shared_ptr<Ship> fighter, std::vector<std::shared_ptr<Ship>> &placed) const;
 
 
@@ -26,6 +26,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cmath>
+#include <cstdlib>
+#include <map>
 #include <vector>
 
 using namespace std;
@@ -38,9 +40,12 @@ namespace {
 	const int DIAG = 7;
 	// Limit distances to the size of an unsigned char.
 	const int LIMIT = 255;
-	// Pad beyond the screen enough to include any system that might "cast light"
-	// on the on-screen view.
+	// How many cells away a system can "cast light."
 	const int PAD = LIMIT / ORTH;
+	// The distance field is stored in square tiles of this many cells (a power
+	// of two), so only the parts of the map near a visited system are kept.
+	const int TILE_SHIFT = 6;
+	const int TILE = 1 << TILE_SHIFT;
 
 	// OpenGL objects:
 	Shader shader;
@@ -50,14 +55,121 @@ namespace {
 	GLuint vbo;
 	GLuint texture = 0;
 
-	// Keep track of the previous frame's view so that if it is unchanged we can
-	// skip regenerating the mask.
-	double previousZoom = 0.;
-	double previousLeft = 0.;
-	double previousTop = 0.;
+	class Tile {
+	public:
+		Tile() { fill(distance, distance + TILE * TILE, LIMIT); }
+
+		unsigned char distance[TILE * TILE];
+	};
+	// The distance from each cell of the map to the nearest visited system. Any
+	// cell that is not in a tile is too far from every system to be lit.
+	map<pair<int, int>, Tile> tiles;
+	// Each system that has been added to the distance field, and where it was.
+	map<const System *, Point> lit;
+	// Whether the player may have visited more systems since the field was updated.
+	bool shouldUpdate = true;
+	// Whether the field changed since the mask was last made from it.
+	bool fieldChanged = true;
+
+	// Keep track of which cells the previous frame's mask covered, so that if
+	// it is unchanged we can skip regenerating the mask.
+	int previousX = 0;
+	int previousY = 0;
 	int previousColumns = 0;
 	int previousRows = 0;
-	Point previousCenter;
+
+
+	// Find the distance from a system to every cell within range of it. This is
+	// the same as what a distance transform of the whole map would give, since
+	// each cell is lit by whichever system is closest to it.
+	void Light(const Point &position)
+	{
+		const int centerX = lround(position.X() / GRID);
+		const int centerY = lround(position.Y() / GRID);
+		for(int tileY = (centerY - PAD) >> TILE_SHIFT; tileY <= (centerY + PAD) >> TILE_SHIFT; ++tileY)
+			for(int tileX = (centerX - PAD) >> TILE_SHIFT; tileX <= (centerX + PAD) >> TILE_SHIFT; ++tileX)
+			{
+				unsigned char *distance = tiles[make_pair(tileX, tileY)].distance;
+				const int minX = max(tileX * TILE, centerX - PAD);
+				const int maxX = min(tileX * TILE + TILE - 1, centerX + PAD);
+				const int minY = max(tileY * TILE, centerY - PAD);
+				const int maxY = min(tileY * TILE + TILE - 1, centerY + PAD);
+				for(int y = minY; y <= maxY; ++y)
+					for(int x = minX; x <= maxX; ++x)
+					{
+						const int dx = abs(x - centerX);
+						const int dy = abs(y - centerY);
+						const int steps = DIAG * min(dx, dy) + ORTH * abs(dx - dy);
+						unsigned char &value = distance[(x - tileX * TILE) + (y - tileY * TILE) * TILE];
+						value = min<int>(value, steps);
+					}
+			}
+	}
+
+
+
+	// Add any newly visited systems to the distance field. Returns true if the
+	// field changed.
+	bool UpdateField(const PlayerInfo &player)
+	{
+		vector<const System *> added;
+		size_t visited = 0;
+		bool moved = false;
+		for(const auto &it : GameData::Systems())
+		{
+			const System &system = it.second;
+			if(!system.IsValid() || !player.HasVisited(system))
+				continue;
+
+			++visited;
+			auto found = lit.find(&system);
+			if(found == lit.end())
+				added.push_back(&system);
+			else if(found->second.X() != system.Position().X() || found->second.Y() != system.Position().Y())
+				moved = true;
+		}
+
+		// If a system moved or is no longer visited, some cells may be farther
+		// from the nearest system than they were, so the field must be rebuilt.
+		if(moved || visited != lit.size() + added.size())
+		{
+			tiles.clear();
+			lit.clear();
+			UpdateField(player);
+			return true;
+		}
+
+		for(const System *system : added)
+		{
+			lit[system] = system->Position();
+			Light(system->Position());
+		}
+		return !added.empty();
+	}
+
+
+
+	// Copy one row of the distance field into the mask, stretching the distance
+	// values so there is no shading up to about 200 pixels away, then it
+	// transitions somewhat quickly.
+	void FillRow(unsigned char *row, int left, int columns, int y)
+	{
+		for(int x = left; x < left + columns; )
+		{
+			const int tileX = x >> TILE_SHIFT;
+			const int end = min(left + columns, (tileX + 1) * TILE);
+			auto it = tiles.find(make_pair(tileX, y >> TILE_SHIFT));
+			if(it == tiles.end())
+				fill(row + (x - left), row + (end - left), LIMIT);
+			else
+			{
+				const unsigned char *distance = it->second.distance + (y - (y >> TILE_SHIFT) * TILE) * TILE;
+				for(int i = x; i < end; ++i)
+					row[i - left] = max(0, min(LIMIT, (distance[i - tileX * TILE] - 60) * 4));
+			}
+			x = end;
+		}
+	}
 }
 
 
@@ -97,13 +209,13 @@ void FogShader::Init()
 	cornerI = shader.Uniform("corner");
 	dimensionsI = shader.Uniform("dimensions");
 
-	glUseProgram(shader.Object());
+	OpenGL::UseProgram(shader.Object());
 	glUniform1i(shader.Uniform("tex"), 0);
-	glUseProgram(0);
+	OpenGL::UseProgram(0);
 
 	// Generate the vertex data for drawing sprites.
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -123,85 +235,56 @@ void FogShader::Init()
 
 	// Unbind the VBO and VAO.
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
 }
 
 
 
 void FogShader::Redraw()
 {
-	previousZoom = 0.;
+	shouldUpdate = true;
 }
 
 
 
 void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 {
-	// Generate a scaled-down mask image that represents the entire screen plus
-	// enough pixels beyond the screen to include any systems that may be off
-	// screen but close enough to "illuminate" part of the on-screen map.
-	double left = Screen::Left() - GRID * PAD * zoom + fmod(center.X(), GRID) * zoom;
-	double top = Screen::Top() - GRID * PAD * zoom + fmod(center.Y(), GRID) * zoom;
-	int columns = ceil(Screen::Width() / (GRID * zoom)) + 1 + 2 * PAD;
-	int rows = ceil(Screen::Height() / (GRID * zoom)) + 1 + 2 * PAD;
+	// Only the systems the player has visited since the field was last updated
+	// need to be added to it, which is much faster than recalculating it all.
+	if(shouldUpdate)
+	{
+		shouldUpdate = false;
+		fieldChanged |= UpdateField(player);
+	}
+
+	// Generate a scaled-down mask image that represents the entire screen. Each
+	// cell of the mask is one cell of the distance field.
+	const int left = floor((Screen::Left() / zoom - center.X()) / GRID);
+	const int top = floor((Screen::Top() / zoom - center.Y()) / GRID);
+	int columns = ceil(Screen::Width() / (GRID * zoom)) + 2;
+	const int rows = ceil(Screen::Height() / (GRID * zoom)) + 2;
 	// Round up to a multiple of 4 so the rows will be 32-bit aligned.
 	columns = (columns + 3) & ~3;
 
-	// To avoid extra work, don't regenerate the mask buffer if the view has not
-	// moved. This might cause an inaccurate mask if you explore more systems,
-	// come back to the original, and view the map again without viewing it in
-	// between. But, that's an unlikely situation.
-	bool shouldRegenerate = (
-		zoom != previousZoom || center.X() != previousCenter.X() || center.Y() != previousCenter.Y() ||
-		left != previousLeft || top != previousTop || columns != previousColumns || rows != previousRows);
+	// To avoid extra work, don't regenerate the mask buffer if it would cover
+	// the same cells of an unchanged distance field.
+	bool shouldRegenerate = (fieldChanged ||
+		left != previousX || top != previousY || columns != previousColumns || rows != previousRows);
 	if(shouldRegenerate)
 	{
 		bool sizeChanged = (!texture || columns != previousColumns || rows != previousRows);
 
 		// Remember the current viewport attributes.
-		previousZoom = zoom;
-		previousCenter = center;
-		previousLeft = left;
-		previousTop = top;
+		fieldChanged = false;
+		previousX = left;
+		previousY = top;
 		previousColumns = columns;
 		previousRows = rows;
 
 		// This buffer will hold the mask image.
-		auto buffer = vector<unsigned char>(static_cast<size_t>(rows) * columns, LIMIT);
-
-		// For each system the player knows about, its "distance" pixel in the
-		// buffer should be set to 0.
-		for(const auto &it : GameData::Systems())
-		{
-			const System &system = it.second;
-			if(!system.IsValid() || !player.HasVisited(system))
-				continue;
-			Point pos = zoom * (system.Position() + center);
-
-			int x = round((pos.X() - left) / (GRID * zoom));
-			int y = round((pos.Y() - top) / (GRID * zoom));
-			if(x >= 0 && y >= 0 && x < columns && y < rows)
-				buffer[x + y * columns] = 0;
-		}
-
-		// Distance transformation: make two passes through the buffer. In the first
-		// pass, propagate down and to the right. In the second, propagate in the
-		// opposite direction. Once these two passes are done, each value is equal
-		for(int y = 1; y < rows; ++y)
-			for(int x = 1; x < columns; ++x)
-				buffer[x + y * columns] = min<int>(buffer[x + y * columns], min(
-					ORTH + min(buffer[(x - 1) + y * columns], buffer[x + (y - 1) * columns]),
-					DIAG + min(buffer[(x - 1) + (y - 1) * columns], buffer[(x + 1) + (y - 1) * columns])));
-		for(int y = rows - 2; y >= 0; --y)
-			for(int x = columns - 2; x >= 0; --x)
-				buffer[x + y * columns] = min<int>(buffer[x + y * columns], min(
-					ORTH + min(buffer[(x + 1) + y * columns], buffer[x + (y + 1) * columns]),
-					DIAG + min(buffer[(x - 1) + (y + 1) * columns], buffer[(x + 1) + (y + 1) * columns])));
-
-		// Stretch the distance values so there is no shading up to about 200 pixels
-		// away, then it transitions somewhat quickly.
-		for(unsigned char &value : buffer)
-			value = max(0, min(LIMIT, (value - 60) * 4));
+		auto buffer = vector<unsigned char>(static_cast<size_t>(rows) * columns);
+		for(int y = 0; y < rows; ++y)
+			FillRow(&buffer[static_cast<size_t>(y) * columns], left, columns, top + y);
 		const void *data = &buffer.front();
 
 		// Set up the OpenGL texture if it doesn't exist yet.
@@ -209,10 +292,10 @@ void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 		{
 			// If the texture size changed, it must be reallocated.
 			if(texture)
-				glDeleteTextures(1, &texture);
+				OpenGL::DeleteTextures(1, &texture);
 
 			glGenTextures(1, &texture);
-			glBindTexture(GL_TEXTURE_2D, texture);
+			OpenGL::BindTexture(GL_TEXTURE_2D, texture);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -223,31 +306,27 @@ void FogShader::Draw(const Point &center, double zoom, const PlayerInfo &player)
 		}
 		else
 		{
-			glBindTexture(GL_TEXTURE_2D, texture);
+			OpenGL::BindTexture(GL_TEXTURE_2D, texture);
 			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, columns, rows, GL_RED, GL_UNSIGNED_BYTE, data);
 		}
 	}
 	else
-		glBindTexture(GL_TEXTURE_2D, texture);
+		OpenGL::BindTexture(GL_TEXTURE_2D, texture);
 
 	// Set up to draw the image.
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindVertexArray(vao);
 
+	// The center of each pixel of the image is at the center of its cell.
 	GLfloat corner[2] = {
-		static_cast<float>(left - .5 * GRID * zoom) / (.5f * Screen::Width()),
-		static_cast<float>(top - .5 * GRID * zoom) / (-.5f * Screen::Height())};
+		static_cast<float>(zoom * (GRID * (left - .5) + center.X()) / (.5 * Screen::Width())),
+		static_cast<float>(zoom * (GRID * (top - .5) + center.Y()) / (-.5 * Screen::Height()))};
 	glUniform2fv(cornerI, 1, corner);
 	GLfloat dimensions[2] = {
-		GRID * static_cast<float>(zoom) * (columns + 1.f) / (.5f * Screen::Width()),
-		GRID * static_cast<float>(zoom) * (rows + 1.f) / (-.5f * Screen::Height())};
+		GRID * static_cast<float>(zoom) * columns / (.5f * Screen::Width()),
+		GRID * static_cast<float>(zoom) * rows / (-.5f * Screen::Height())};
 	glUniform2fv(dimensionsI, 1, dimensions);
 
 	// Call the shader program to draw the image.
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-	// Clean up.
-	glBindVertexArray(0);
-	glUseProgram(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
 }
@@ -0,0 +1,166 @@
+/* FormationPositioner.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "FormationPositioner.h"
+
+#include "FormationPattern.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+using namespace std;
+
+namespace {
+	// Find the assignment of rows to columns of a square cost matrix with the
+	// smallest total cost, using the Hungarian algorithm. Returns the column
+	// given to each row.
+	vector<size_t> Assign(const vector<vector<double>> &cost)
+	{
+		const size_t n = cost.size();
+		const double INF = numeric_limits<double>::infinity();
+		// The rows and columns are counted from 1 here, and row 0 and column 0
+		// are used as placeholders while augmenting.
+		vector<double> u(n + 1, 0.);
+		vector<double> v(n + 1, 0.);
+		vector<size_t> rowOf(n + 1, 0);
+		vector<size_t> way(n + 1, 0);
+		for(size_t row = 1; row <= n; ++row)
+		{
+			rowOf[0] = row;
+			size_t column = 0;
+			vector<double> minimum(n + 1, INF);
+			vector<bool> used(n + 1, false);
+			do {
+				used[column] = true;
+				size_t current = rowOf[column];
+				double delta = INF;
+				size_t next = 0;
+				for(size_t j = 1; j <= n; ++j)
+					if(!used[j])
+					{
+						double reduced = cost[current - 1][j - 1] - u[current] - v[j];
+						if(reduced < minimum[j])
+						{
+							minimum[j] = reduced;
+							way[j] = column;
+						}
+						if(minimum[j] < delta)
+						{
+							delta = minimum[j];
+							next = j;
+						}
+					}
+				for(size_t j = 0; j <= n; ++j)
+				{
+					if(used[j])
+					{
+						u[rowOf[j]] += delta;
+						v[j] -= delta;
+					}
+					else
+						minimum[j] -= delta;
+				}
+				column = next;
+			} while(rowOf[column]);
+
+			do {
+				size_t previous = way[column];
+				rowOf[column] = rowOf[previous];
+				column = previous;
+			} while(column);
+		}
+
+		vector<size_t> result(n, 0);
+		for(size_t j = 1; j <= n; ++j)
+			result[rowOf[j] - 1] = j - 1;
+		return result;
+	}
+}
+
+
+
+void FormationPositioner::SetPattern(const FormationPattern *pattern)
+{
+	isChanged |= (pattern != this->pattern);
+	this->pattern = pattern;
+}
+
+
+
+void FormationPositioner::Update(const vector<const Body *> &ships, const vector<Point> &offsets)
+{
+	sorted = ships;
+	sort(sorted.begin(), sorted.end());
+	if(isChanged || sorted != this->ships)
+		Solve(ships, offsets);
+}
+
+
+
+const Point *FormationPositioner::Position(const Body *ship) const
+{
+	auto it = lower_bound(ships.begin(), ships.end(), ship);
+	if(it == ships.end() || *it != ship)
+		return nullptr;
+	return &positions[it - ships.begin()];
+}
+
+
+
+int FormationPositioner::Solves() const
+{
+	return solves;
+}
+
+
+
+void FormationPositioner::Solve(const vector<const Body *> &ships, const vector<Point> &offsets)
+{
+	++solves;
+	isChanged = false;
+	const size_t count = ships.size();
+
+	// Each ship can take any of the first positions in the pattern.
+	vector<Point> slots;
+	slots.reserve(count);
+	if(pattern)
+	{
+		FormationPattern::PositionIterator it = pattern->begin();
+		for(size_t i = 0; i < count; ++i, ++it)
+			slots.push_back(*it);
+	}
+	else
+		slots.resize(count);
+
+	vector<vector<double>> cost(count, vector<double>(count));
+	for(size_t i = 0; i < count; ++i)
+		for(size_t j = 0; j < count; ++j)
+			cost[i][j] = offsets[i].Distance(slots[j]);
+	vector<size_t> slot = Assign(cost);
+
+	// Store the ships sorted by address, so that each one's position can be
+	// found quickly.
+	vector<size_t> order(count);
+	iota(order.begin(), order.end(), 0);
+	sort(order.begin(), order.end(), [&ships](size_t a, size_t b) { return ships[a] < ships[b]; });
+	this->ships.clear();
+	positions.clear();
+	for(size_t i : order)
+	{
+		this->ships.push_back(ships[i]);
+		positions.push_back(slots[slot[i]]);
+	}
+}
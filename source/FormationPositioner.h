@@ -0,0 +1,69 @@
+/* FormationPositioner.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef FORMATION_POSITIONER_H_
+#define FORMATION_POSITIONER_H_
+
+#include "Point.h"
+
+#include <vector>
+
+class Body;
+class FormationPattern;
+
+
+
+// Assigns the ships flying in formation around one leader to the positions of
+// its formation pattern. Finding the best assignment takes time that grows
+// with the cube of the number of ships, so it is only done again when ships
+// join or leave the formation or the pattern changes. In between, each ship
+// keeps its position, so ships never swap back and forth between positions
+// that are about equally close to them.
+class FormationPositioner {
+public:
+	// Use a different pattern. The ships are assigned again on the next update.
+	void SetPattern(const FormationPattern *pattern);
+
+	// Give the ships that are in the formation, and where each of them is
+	// relative to the leader, in the pattern's coordinates.
+	void Update(const std::vector<const Body *> &ships, const std::vector<Point> &offsets);
+	// Get the position in the pattern that the given ship is assigned to, or
+	// null if it is not in the formation.
+	const Point *Position(const Body *ship) const;
+
+	// The number of times the ships have been assigned, for testing.
+	int Solves() const;
+
+
+private:
+	// Assign each ship to the position that makes the total distance that all
+	// the ships must move as small as possible.
+	void Solve(const std::vector<const Body *> &ships, const std::vector<Point> &offsets);
+
+
+private:
+	const FormationPattern *pattern = nullptr;
+	bool isChanged = true;
+	// The ships, sorted by address, and each one's position.
+	std::vector<const Body *> ships;
+	std::vector<Point> positions;
+	// The ships given to the latest update, sorted, to compare against.
+	std::vector<const Body *> sorted;
+	int solves = 0;
+};
+
+
+
+#endif
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "GameData.h"
 
+#include "AssetTiers.h"
 #include "Audio.h"
 #include "BatchShader.h"
 #include "CategoryList.h"
@@ -26,6 +27,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataFile.h"
 #include "DataNode.h"
 #include "DataWriter.h"
+#include "DistanceMap.h"
 #include "Effect.h"
 #include "Files.h"
 #include "FillShader.h"
@@ -38,8 +40,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameEvent.h"
 #include "Government.h"
 #include "Hazard.h"
+#include "ImageIndex.h"
 #include "ImageSet.h"
 #include "Interface.h"
+#include "JobPool.h"
+#include "KtxFile.h"
 #include "LineShader.h"
 #include "MaskManager.h"
 #include "Minable.h"
@@ -51,11 +56,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Person.h"
 #include "Phrase.h"
 #include "Planet.h"
+#include "PlayerInfo.h"
+#include "PluginArchive.h"
 #include "Plugins.h"
 #include "PointerShader.h"
 #include "Politics.h"
+#include "Preferences.h"
+#include "Profiler.h"
 #include "Random.h"
 #include "RingShader.h"
+#include "Shader.h"
+#include "ShaderCache.h"
 #include "Ship.h"
 #include "Sprite.h"
 #include "SpriteQueue.h"
@@ -63,14 +74,22 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SpriteShader.h"
 #include "StarField.h"
 #include "StartConditions.h"
+#include "StellarObject.h"
 #include "System.h"
+#include "SystemGrid.h"
 #include "Test.h"
 #include "TestData.h"
+#include "TextureBudget.h"
 #include "UniverseObjects.h"
 #include "UiRectShader.h"
 
+#include "opengl.h"
+#include <SDL2/SDL.h>
+
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -82,6 +101,8 @@ namespace {
 	Set<Government> defaultGovernments;
 	Set<Planet> defaultPlanets;
 	Set<System> defaultSystems;
+	// How many neighbor distances the default systems have neighbor lists for.
+	size_t defaultDistances = 0;
 	Set<Galaxy> defaultGalaxies;
 	Set<Sale<Ship>> defaultShipSales;
 	Set<Sale<Outfit>> defaultOutfitSales;
@@ -89,18 +110,121 @@ namespace {
 	TextReplacements defaultSubstitutions;
 
 	Politics politics;
+	// Trading is split across threads once there are more links than this,
+	// counting each link once for every commodity.
+	const size_t PARALLEL_TRADE_LINKS = 1 << 16;
+
+	// Bumped whenever the systems or planets may have changed.
+	atomic<uint64_t> universeRevision(1);
+
+	// The price of every commodity in every system, indexed by System::Index()
+	// and then by the commodity's place in Commodities(). It is rebuilt after
+	// each change to the economy, and is not used while a system may have
+	// changed without it being rebuilt.
+	vector<int> prices;
+	size_t pricesStride = 0;
+	bool pricesAreCurrent = false;
 
 	StarField background;
 
 	SpriteQueue spriteQueue;
+	// Sprites that have images in formats only some graphics drivers support
+	// can't be loaded until the driver's capabilities are known.
+	vector<shared_ptr<ImageSet>> awaitingDriver;
 
 	vector<string> sources;
 	map<const Sprite *, shared_ptr<ImageSet>> deferred;
-	map<const Sprite *, int> preloaded;
+	// The deferred sprites that are loaded, and how much memory they may use.
+	TextureBudget preloaded;
+	// The sprites that are held back at startup, to be streamed in once it is
+	// known which of them are needed first.
+	map<const Sprite *, shared_ptr<ImageSet>> streamed;
+	const vector<string> STREAMED_PREFIXES = {"asteroid/", "effect/", "outfit/", "planet/",
+		"portrait/", "projectile/", "scene/", "ship/", "star/", "thumbnail/"};
+
+	bool IsStreamed(const string &name)
+	{
+		for(const string &prefix : STREAMED_PREFIXES)
+			if(!name.compare(0, prefix.length(), prefix))
+				return true;
+		return false;
+	}
+
+	// Begin loading the given sprite, if it is being held back.
+	void Stream(const Sprite *sprite)
+	{
+		auto it = streamed.find(sprite);
+		if(!sprite || it == streamed.end())
+			return;
+		spriteQueue.Add(it->second);
+		streamed.erase(it);
+	}
+
+	void StreamBody(const Body &body)
+	{
+		Stream(body.GetSprite());
+	}
+
+	void StreamShip(const Ship &ship)
+	{
+		StreamBody(ship);
+		Stream(ship.Thumbnail());
+		for(const auto &it : ship.Outfits())
+		{
+			const Outfit &outfit = *it.first;
+			Stream(outfit.Thumbnail());
+			StreamBody(outfit.WeaponSprite());
+			StreamBody(outfit.HardpointSprite());
+			for(const auto &flare : outfit.FlareSprites())
+				StreamBody(flare.first);
+			for(const auto &flare : outfit.ReverseFlareSprites())
+				StreamBody(flare.first);
+			for(const auto &flare : outfit.SteeringFlareSprites())
+				StreamBody(flare.first);
+		}
+	}
+
+	// The sprites of a system's stellar objects and asteroids, and of the ships
+	// that may appear there.
+	void StreamSystem(const System &system)
+	{
+		for(const StellarObject &object : system.Objects())
+			StreamBody(object);
+		for(const System::Asteroid &asteroid : system.Asteroids())
+		{
+			if(asteroid.Type())
+				StreamBody(*asteroid.Type());
+			else
+				Stream(SpriteSet::Get("asteroid/" + asteroid.Name() + "/spin"));
+		}
+		for(const auto &event : system.Fleets())
+			for(const Variant &variant : event.Get()->Variants())
+				for(const Ship *ship : variant.Ships())
+					StreamShip(*ship);
+	}
+
+	// Copy the reloaded objects into the state that the universe reverts to.
+	template <class Type>
+	void UpdateDefaults(Set<Type> &defaults, const Set<Type> &objects, const set<string> &names)
+	{
+		for(const string &name : names)
+			*defaults.Get(name) = *objects.Get(name);
+	}
 
 	MaskManager maskManager;
 
 	const Government *playerGovernment = nullptr;
+
+	void UpdatePrices()
+	{
+		const vector<Trade::Commodity> &commodities = GameData::Commodities();
+		pricesStride = commodities.size();
+		prices.assign(System::IndexCount() * pricesStride, 0);
+		for(const auto &it : GameData::Systems())
+			for(size_t i = 0; i < commodities.size(); ++i)
+				prices[it.second.Index() * pricesStride + i] = it.second.Trade(commodities[i].name);
+		pricesAreCurrent = true;
+	}
 	map<const System *, map<string, int>> purchases;
 
 	ConditionsStore globalConditions;
@@ -131,6 +255,24 @@ namespace {
 			spriteQueue.Add(icon);
 		}
 	}
+
+	// Load all the plugins in the given directory, both those that are folders
+	// and those that are zip archives.
+	void LoadPlugins(const string &directory)
+	{
+		vector<string> paths = Files::ListDirectories(directory);
+		for(const string &file : Files::List(directory))
+		{
+			string root = PluginArchive::Mount(file);
+			if(!root.empty())
+				paths.push_back(root);
+		}
+		sort(paths.begin(), paths.end());
+
+		for(const string &path : paths)
+			if(Plugins::IsPlugin(path))
+				LoadPlugin(path);
+	}
 }
 
 
@@ -146,6 +288,13 @@ future<void> GameData::BeginLoad(bool onlyLoadData, bool debugMode)
 		// name, only remember one instance, letting things on the higher priority
 		// paths override the default images.
 		map<string, shared_ptr<ImageSet>> images = FindImages();
+#ifdef ES_GLES
+		// On mobile devices, reading every sprite is most of the time it takes
+		// to reach the main menu, and many of them won't be needed for a while.
+		const bool isProgressive = !debugMode;
+#else
+		const bool isProgressive = false;
+#endif
 
 		// From the name, strip out any frame number, plus the extension.
 		for(const auto &it : images)
@@ -159,6 +308,10 @@ future<void> GameData::BeginLoad(bool onlyLoadData, bool debugMode)
 			// For landscapes, remember all the source files but don't load them yet.
 			if(ImageSet::IsDeferred(it.first))
 				deferred[SpriteSet::Get(it.first)] = it.second;
+			else if(isProgressive && IsStreamed(it.first))
+				streamed[SpriteSet::Get(it.first)] = it.second;
+			else if(it.second->NeedsDriverSupport())
+				awaitingDriver.push_back(it.second);
 			else
 				spriteQueue.Add(it.second);
 		}
@@ -167,7 +320,9 @@ future<void> GameData::BeginLoad(bool onlyLoadData, bool debugMode)
 		Music::Init(sources);
 	}
 
-	return objects.Load(sources, debugMode);
+	// Parsing warnings are only printed when a file is actually parsed, so the
+	// cache of parsed files is not used when checking data files for mistakes.
+	return objects.Load(sources, debugMode, !onlyLoadData && !debugMode);
 }
 
 
@@ -179,12 +334,15 @@ void GameData::FinishLoading()
 	defaultGovernments = objects.governments;
 	defaultPlanets = objects.planets;
 	defaultSystems = objects.systems;
+	defaultDistances = objects.updatedDistances;
 	defaultGalaxies = objects.galaxies;
 	defaultShipSales = objects.shipSales;
 	defaultOutfitSales = objects.outfitSales;
 	defaultSubstitutions = objects.substitutions;
 	defaultWormholes = objects.wormholes;
 	playerGovernment = objects.governments.Get("Escort");
+	++universeRevision;
+	UpdatePrices();
 
 	politics.Reset();
 }
@@ -198,8 +356,65 @@ void GameData::CheckReferences()
 
 
 
+bool GameData::CanReload()
+{
+	return objects.CanReload();
+}
+
+
+
+int GameData::Reload()
+{
+	map<string, set<string>> reloaded = objects.Reload();
+	UpdateDefaults(defaultFleets, objects.fleets, reloaded["fleet"]);
+	UpdateDefaults(defaultGovernments, objects.governments, reloaded["government"]);
+	UpdateDefaults(defaultPlanets, objects.planets, reloaded["planet"]);
+	UpdateDefaults(defaultSystems, objects.systems, reloaded["system"]);
+	UpdateDefaults(defaultGalaxies, objects.galaxies, reloaded["galaxy"]);
+	UpdateDefaults(defaultShipSales, objects.shipSales, reloaded["shipyard"]);
+	UpdateDefaults(defaultOutfitSales, objects.outfitSales, reloaded["outfitter"]);
+	UpdateDefaults(defaultWormholes, objects.wormholes, reloaded["wormhole"]);
+	++universeRevision;
+	UpdatePrices();
+
+	int count = 0;
+	for(const auto &it : reloaded)
+		count += it.second.size();
+	return count;
+}
+
+
+
 void GameData::LoadShaders(bool useShaderSwizzle)
 {
+	// Now that the graphics driver is known, the sprites that may use its
+	// optional compressed texture formats can be loaded.
+	KtxFile::SetSupportedFormats(OpenGL::HasAstcSupport(), OpenGL::HasBptcSupport());
+	// The driver also tells what class of graphics processor this device has,
+	// which together with its memory decides how big its images can be.
+	GLint maxTextureSize = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+	AssetTiers::Init(SDL_GetSystemRAM(), maxTextureSize);
+	for(const shared_ptr<ImageSet> &set : awaitingDriver)
+		spriteQueue.Add(set);
+	awaitingDriver.clear();
+
+	// Programs that were linked by the same driver in an earlier run can be
+	// loaded as they are, instead of being compiled again.
+	unique_ptr<ShaderCache> shaderCache;
+	if(OpenGL::HasProgramBinarySupport())
+	{
+		string driver;
+		for(GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+		{
+			const GLubyte *text = glGetString(name);
+			driver += text ? reinterpret_cast<const char *>(text) : "";
+			driver += '\n';
+		}
+		shaderCache.reset(new ShaderCache(Files::Config() + "shader cache.bin", driver));
+		Shader::SetCache(shaderCache.get());
+	}
+
 	FontSet::Add(Files::Images() + "font/ubuntu14r", 14); // extension auto-detected
 	FontSet::Add(Files::Images() + "font/ubuntu18r", 18); // extension auto-detected
 
@@ -251,6 +466,15 @@ void GameData::LoadShaders(bool useShaderSwizzle)
 	GamePad::Init();
 
 	background.Init(16384, 4096);
+
+	// Get every program ready to draw now, while the game is still loading.
+	Shader::WarmUp();
+
+	if(shaderCache)
+	{
+		Shader::SetCache(nullptr);
+		shaderCache->Save();
+	}
 }
 
 
@@ -264,6 +488,9 @@ double GameData::GetProgress()
 		return 1.;
 
 	double val = min(min(spriteQueue.GetProgress(), Audio::GetProgress()), objects.GetProgress());
+	// Some sprites may not have been queued yet.
+	if(!awaitingDriver.empty())
+		val = min(val, .99);
 	if(val >= 1.)
 		initiallyLoaded = true;
 	return val;
@@ -278,10 +505,28 @@ bool GameData::IsLoaded()
 
 
 
+bool GameData::IsDataLoaded()
+{
+	return objects.GetProgress() == 1.;
+}
+
+
+
+bool GameData::AreSpritesLoaded()
+{
+	return awaitingDriver.empty() && spriteQueue.GetProgress() == 1.;
+}
+
+
+
 // Begin loading a sprite that was previously deferred. Currently this is
 // done with all landscapes to speed up the program's startup.
 void GameData::Preload(const Sprite *sprite)
 {
+	// A sprite that is held back until it is streamed in can be loaded early
+	// if something needs it, e.g. a thumbnail scrolled into view in a shop.
+	Stream(sprite);
+
 	// Make sure this sprite actually is one that uses deferred loading.
 	auto dit = deferred.find(sprite);
 	if(!sprite || dit == deferred.end())
@@ -290,37 +535,81 @@ void GameData::Preload(const Sprite *sprite)
 	// If this sprite is one of the currently loaded ones, there is no need to
 	// load it again. But, make note of the fact that it is the most recently
 	// asked-for sprite.
-	map<const Sprite *, int>::iterator pit = preloaded.find(sprite);
-	if(pit != preloaded.end())
-	{
-		for(pair<const Sprite * const, int> &it : preloaded)
-			if(it.second < pit->second)
-				++it.second;
+	preloaded.SetLimit(static_cast<size_t>(Preferences::TextureBudget()) << 20);
+	if(!preloaded.Use(sprite))
+		return;
+
+	// Unload the least recently used sprites if they take up too much memory.
+	// The size of this one is not known until it is loaded, so that will be
+	// accounted for the next time a sprite is asked for.
+	for(const Sprite *old : preloaded.Evict())
+		spriteQueue.Unload(old->Name());
+
+	// Now, load all the files for this sprite.
+	spriteQueue.Add(dit->second);
+
+	Profiler::SetCounter("Preloaded sprites", preloaded.Count());
+	Profiler::SetCounter("Preloaded sprite MB", preloaded.Bytes() / 1048576.);
+}
+
+
+
+void GameData::PreloadSystem(const System &system)
+{
+	StreamSystem(system);
+	Stream(system.Haze());
+	for(const StellarObject &object : system.Objects())
+		if(object.HasValidPlanet())
+			Preload(object.GetPlanet()->Landscape());
+}
+
+
+
+void GameData::PrioritizeSprites(const PlayerInfo &player)
+{
+	if(streamed.empty())
+		return;
+
+	for(const shared_ptr<Ship> &ship : player.Ships())
+		StreamShip(*ship);
+	if(player.GetSystem())
+		StreamSystem(*player.GetSystem());
+}
 
-		pit->second = 0;
+
+
+void GameData::StreamSprites(const PlayerInfo &player)
+{
+	if(streamed.empty())
 		return;
-	}
 
-	// This sprite is not currently preloaded. Check to see whether we already
-	// have the maximum number of sprites loaded, in which case the oldest one
-	// must be unloaded to make room for this one.
-	const string &name = sprite->Name();
-	pit = preloaded.begin();
-	while(pit != preloaded.end())
+	// Systems the player could jump to soon come first.
+	if(player.GetSystem())
 	{
-		++pit->second;
-		if(pit->second >= 20)
-		{
-			spriteQueue.Unload(name);
-			pit = preloaded.erase(pit);
-		}
-		else
-			++pit;
+		DistanceMap distance(player.GetSystem());
+		set<const System *> systems = distance.Systems();
+		vector<const System *> nearest(systems.begin(), systems.end());
+		stable_sort(nearest.begin(), nearest.end(), [&distance](const System *a, const System *b) -> bool
+			{
+				return distance.Days(a) < distance.Days(b);
+			});
+		for(const System *system : nearest)
+			StreamSystem(*system);
 	}
 
-	// Now, load all the files for this sprite.
-	preloaded[sprite] = 0;
-	spriteQueue.Add(dit->second);
+	// Then everything else, in order by name so that the order does not depend
+	// on where in memory each sprite is.
+	vector<pair<string, shared_ptr<ImageSet>>> rest;
+	for(const auto &it : streamed)
+		rest.emplace_back(it.first->Name(), it.second);
+	streamed.clear();
+	sort(rest.begin(), rest.end(),
+		[](const pair<string, shared_ptr<ImageSet>> &a, const pair<string, shared_ptr<ImageSet>> &b) -> bool
+		{
+			return a.first < b.first;
+		});
+	for(const auto &it : rest)
+		spriteQueue.Add(it.second);
 }
 
 
@@ -368,8 +657,21 @@ void GameData::Revert()
 	objects.outfitSales.Revert(defaultOutfitSales);
 	objects.substitutions.Revert(defaultSubstitutions);
 	objects.wormholes.Revert(defaultWormholes);
+	// The systems are back where they started, so they must be indexed again.
+	// If any jump ranges were added since then, the next update is a full one.
+	objects.BuildSystemGrid();
+	objects.changedSystems.clear();
+	objects.formerLinks.clear();
+	objects.updatedDistances = defaultDistances;
 	for(auto &it : objects.persons)
 		it.second.Restore();
+	// Planets that were not modified are not copied, so their defense fleets
+	// (which are not part of their definitions) must be cleared separately.
+	const Set<Planet> &planets = objects.planets;
+	for(const auto &it : planets)
+		it.second.ResetDefense();
+	++universeRevision;
+	UpdatePrices();
 
 	politics.Reset();
 	purchases.clear();
@@ -415,6 +717,7 @@ void GameData::ReadEconomy(const DataNode &node)
 				system.SetSupply(commodity, child.Value(++index));
 		}
 	}
+	UpdatePrices();
 }
 
 
@@ -482,23 +785,54 @@ void GameData::StepEconomy()
 
 	// Finally, send out the trade goods. This has to be done in a separate step
 	// because otherwise whichever systems trade last would already have gotten
-	// supplied by the other systems.
+	// supplied by the other systems. Each system's supply and exports are
+	// copied into one array per commodity, indexed by System::Index(), along
+	// with a flat list of the links of every system that trades, so that the
+	// commodities can be traded independently of each other.
+	vector<string> names;
+	for(const Trade::Commodity &commodity : Commodities())
+		names.push_back(commodity.name);
+	const size_t stride = System::IndexCount();
+	vector<double> supply(names.size() * stride);
+	vector<double> exports(names.size() * stride);
+	vector<double> scale(stride);
+	vector<System *> traders;
+	vector<size_t> linkBegin;
+	vector<size_t> links;
 	for(auto &it : objects.systems)
 	{
 		System &system = it.second;
-		if(!system.Links().empty())
-			for(const Trade::Commodity &commodity : Commodities())
-			{
-				double supply = system.Supply(commodity.name);
-				for(const System *neighbor : system.Links())
-				{
-					double scale = neighbor->Links().size();
-					if(scale)
-						supply += neighbor->Exports(commodity.name) / scale;
-				}
-				system.SetSupply(commodity.name, supply);
-			}
+		system.GetTrade(names, &supply[system.Index()], &exports[system.Index()], stride);
+		scale[system.Index()] = system.Links().size();
+		if(system.Links().empty())
+			continue;
+
+		traders.push_back(&system);
+		linkBegin.push_back(links.size());
+		for(const System *neighbor : system.Links())
+			links.push_back(neighbor->Index());
 	}
+	linkBegin.push_back(links.size());
+
+	// Only big economies are worth splitting across threads.
+	JobPool pool(names.size() * links.size() > PARALLEL_TRADE_LINKS ? JobPool::DefaultThreadCount() : 0);
+	pool.ParallelFor(names.size(), [&](size_t commodity) -> void
+	{
+		double *commoditySupply = &supply[commodity * stride];
+		const double *commodityExports = &exports[commodity * stride];
+		for(size_t i = 0; i < traders.size(); ++i)
+		{
+			// Each system's supply is only read and written by its own entry,
+			// and exports are not changed, so this can be done in place.
+			double &tons = commoditySupply[traders[i]->Index()];
+			for(size_t link = linkBegin[i]; link < linkBegin[i + 1]; ++link)
+				if(scale[links[link]])
+					tons += commodityExports[links[link]] / scale[links[link]];
+		}
+	});
+	for(System *system : traders)
+		system->SetSupply(names, &supply[system->Index()], stride);
+	UpdatePrices();
 }
 
 
@@ -515,15 +849,29 @@ void GameData::AddPurchase(const System &system, const string &commodity, int to
 void GameData::Change(const DataNode &node)
 {
 	objects.Change(node);
+	++universeRevision;
+	// Systems' prices may have changed, so they must be looked up directly until
+	// the systems are updated.
+	pricesAreCurrent &= (node.Token(0) != "system");
 }
 
 
 
-// Update the neighbor lists and other information for all the systems.
-// This must be done any time that a change creates or moves a system.
+// Update the neighbor lists and other information for the systems that were
+// changed, and the systems near them. This must be done any time that a change
+// creates or moves a system.
 void GameData::UpdateSystems()
 {
-	objects.UpdateSystems();
+	objects.UpdateChangedSystems();
+	++universeRevision;
+	UpdatePrices();
+}
+
+
+
+uint64_t GameData::UniverseRevision()
+{
+	return universeRevision;
 }
 
 
@@ -638,6 +986,14 @@ const Set<Mission> &GameData::Missions()
 
 
 
+const MissionIndex &GameData::MissionOffers()
+{
+	objects.missionIndex.Update(objects.missions);
+	return objects.missionIndex;
+}
+
+
+
 const Set<News> &GameData::SpaceportNews()
 {
 	return objects.news;
@@ -722,6 +1078,13 @@ const Set<System> &GameData::Systems()
 
 
 
+const SystemGrid &GameData::GetSystemGrid()
+{
+	return objects.systemGrid;
+}
+
+
+
 const Set<Wormhole> &GameData::Wormholes()
 {
 	return objects.wormholes;
@@ -757,6 +1120,19 @@ const vector<Trade::Commodity> &GameData::Commodities()
 
 
 
+// Get the price of the commodity with the given index in Commodities() in the
+// given system, or 0 if it cannot be traded there.
+int GameData::CommodityPrice(const System &system, size_t commodity)
+{
+	size_t index = system.Index() * pricesStride + commodity;
+	if(pricesAreCurrent && commodity < pricesStride && index < prices.size())
+		return prices[index];
+	const vector<Trade::Commodity> &commodities = Commodities();
+	return commodity < commodities.size() ? system.Trade(commodities[commodity].name) : 0;
+}
+
+
+
 const vector<Trade::Commodity> &GameData::SpecialCommodities()
 {
 	return objects.trade.SpecialCommodities();
@@ -891,15 +1267,8 @@ void GameData::LoadSources()
 	sources.clear();
 	sources.push_back(Files::Resources());
 
-	vector<string> globalPlugins = Files::ListDirectories(Files::Resources() + "plugins/");
-	for(const string &path : globalPlugins)
-		if(Plugins::IsPlugin(path))
-			LoadPlugin(path);
-
-	vector<string> localPlugins = Files::ListDirectories(Files::Config() + "plugins/");
-	for(const string &path : localPlugins)
-		if(Plugins::IsPlugin(path))
-			LoadPlugin(path);
+	LoadPlugins(Files::Resources() + "plugins/");
+	LoadPlugins(Files::Config() + "plugins/");
 }
 
 
@@ -907,25 +1276,19 @@ void GameData::LoadSources()
 map<string, shared_ptr<ImageSet>> GameData::FindImages()
 {
 	map<string, shared_ptr<ImageSet>> images;
+	// The index remembers which image files are in each directory, and what
+	// sprite each of them is a part of, so that the directories are only
+	// walked again if something in them was added or removed.
+	ImageIndex index(Files::Config() + "image index.bin");
 	for(const string &source : sources)
-	{
-		// All names will only include the portion of the path that comes after
-		// this directory prefix.
-		string directoryPath = source + "images/";
-		size_t start = directoryPath.size();
-
-		vector<string> imageFiles = Files::RecursiveList(directoryPath);
-		for(string &path : imageFiles)
-			if(ImageSet::IsImage(path))
-			{
-				string name = ImageSet::Name(path.substr(start));
-
-				shared_ptr<ImageSet> &imageSet = images[name];
-				if(!imageSet)
-					imageSet.reset(new ImageSet(name));
-				imageSet->Add(std::move(path));
-			}
-	}
+		for(const auto &it : index.List(source + "images/"))
+		{
+			shared_ptr<ImageSet> &imageSet = images[it.second];
+			if(!imageSet)
+				imageSet.reset(new ImageSet(it.second));
+			imageSet->Add(it.first);
+		}
+	index.Save();
 	return images;
 }
 
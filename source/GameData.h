@@ -21,8 +21,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Set.h"
 #include "Trade.h"
 
+#include <cstdint>
 #include <future>
 #include <map>
+#include <set>
 #include <memory>
 #include <string>
 #include <vector>
@@ -47,18 +49,21 @@ class Interface;
 class MaskManager;
 class Minable;
 class Mission;
+class MissionIndex;
 class News;
 class Outfit;
 class Panel;
 class Person;
 class Phrase;
 class Planet;
+class PlayerInfo;
 class Politics;
 class Ship;
 class Sprite;
 class StarField;
 class StartConditions;
 class System;
+class SystemGrid;
 class Test;
 class TestData;
 class TextReplacements;
@@ -79,13 +84,32 @@ public:
 	static void FinishLoading();
 	// Check for objects that are referred to but never defined.
 	static void CheckReferences();
+	// In debug mode, data files that have changed since they were loaded can be
+	// reloaded while the game is running. Returns the number of objects reloaded.
+	static bool CanReload();
+	static int Reload();
 	static void LoadShaders(bool useShaderSwizzle);
 	static double GetProgress();
 	// Whether initial game loading is complete (data, sprites and audio are loaded).
 	static bool IsLoaded();
+	// Whether the data files have all been parsed, and whether all the sprites
+	// that are not deferred have been loaded.
+	static bool IsDataLoaded();
+	static bool AreSpritesLoaded();
 	// Begin loading a sprite that was previously deferred. Currently this is
-	// done with all landscapes to speed up the program's startup.
+	// done with all landscapes to speed up the program's startup. Sprites that
+	// are held back to be streamed in are also loaded right away.
 	static void Preload(const Sprite *sprite);
+	// Begin loading everything that will be drawn on arriving in the given
+	// system: its stellar objects, asteroids and haze, the ships its fleets may
+	// spawn, and the landscapes of its planets.
+	static void PreloadSystem(const System &system);
+	// On mobile devices, the sprites for ships, outfits, planets and effects are
+	// held back at startup. Once the player's save is loaded, the ones that the
+	// player needs right away can be loaded before leaving the loading screen,
+	// and then the rest are streamed in, closest systems first.
+	static void PrioritizeSprites(const PlayerInfo &player);
+	static void StreamSprites(const PlayerInfo &player);
 	static void ProcessSprites();
 	// Wait until all pending sprite uploads are completed.
 	static void FinishLoadingSprites();
@@ -106,9 +130,13 @@ public:
 	static void AddPurchase(const System &system, const std::string &commodity, int tons);
 	// Apply the given change to the universe.
 	static void Change(const DataNode &node);
-	// Update the neighbor lists and other information for all the systems.
-	// This must be done any time that a change creates or moves a system.
+	// Update the neighbor lists and other information for the systems that were
+	// changed, and the systems near them. This must be done any time that a
+	// change creates or moves a system.
 	static void UpdateSystems();
+	// A number that changes every time the systems or planets may have been
+	// changed, so that anything derived from them knows to recompute itself.
+	static uint64_t UniverseRevision();
 	static void AddJumpRange(double neighborDistance);
 
 	// Re-activate any special persons that were created previously but that are
@@ -129,6 +157,8 @@ public:
 	static const Set<Interface> &Interfaces();
 	static const Set<Minable> &Minables();
 	static const Set<Mission> &Missions();
+	// An index of where each mission might be offered.
+	static const MissionIndex &MissionOffers();
 	static const Set<News> &SpaceportNews();
 	static const Set<Outfit> &Outfits();
 	static const Set<Sale<Outfit>> &Outfitters();
@@ -138,6 +168,8 @@ public:
 	static const Set<Ship> &Ships();
 	static const Set<Sale<Ship>> &Shipyards();
 	static const Set<System> &Systems();
+	// The positions of the named, accessible systems, for finding nearby ones.
+	static const SystemGrid &GetSystemGrid();
 	static const Set<Test> &Tests();
 	static const Set<TestData> &TestDataSets();
 	static const Set<Wormhole> &Wormholes();
@@ -149,6 +181,9 @@ public:
 	static const std::vector<StartConditions> &StartOptions();
 
 	static const std::vector<Trade::Commodity> &Commodities();
+	// Get the price of the commodity with the given index in Commodities() in the
+	// given system, or 0 if it cannot be traded there.
+	static int CommodityPrice(const System &system, size_t commodity);
 	static const std::vector<Trade::Commodity> &SpecialCommodities();
 
 	// Custom messages to be shown when trying to land on certain stellar objects.
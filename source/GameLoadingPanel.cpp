@@ -38,37 +38,93 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "opengl.h"
 
+#include <algorithm>
+#include <iostream>
+
+using namespace std;
+
+namespace {
+	// The most time each step may spend on startup tasks, so that the loading
+	// circle keeps turning smoothly.
+	const double STEP_SECONDS = .008;
+}
+
 
 
 GameLoadingPanel::GameLoadingPanel(PlayerInfo &player, const Conversation &conversation,
-	UI &gamePanels, bool &finishedLoading)
+	UI &gamePanels, bool &finishedLoading, bool debugMode)
 	: player(player), conversation(conversation), gamePanels(gamePanels),
-		finishedLoading(finishedLoading), ANGLE_OFFSET(360. / MAX_TICKS)
+		finishedLoading(finishedLoading), debugMode(debugMode), ANGLE_OFFSET(360. / MAX_TICKS)
 {
 	SetIsFullScreen(true);
+
+	// The data files, sprites and sounds are all loaded in the background. While
+	// sprites are loading, they must be uploaded to the GPU here.
+	size_t data = startup.Add("data parse", &GameData::IsDataLoaded);
+	size_t sprites = startup.Add("sprite decode", []() -> bool
+		{
+			GameData::ProcessSprites();
+			return GameData::AreSpritesLoaded();
+		});
+	size_t sounds = startup.Add("sound decode", []() -> bool
+		{
+			return Audio::GetProgress() == 1.;
+		});
+	// All sprites with collision masks should also have their 1x scaled versions, so create
+	// any additional scaled masks from the default one.
+	size_t masks = startup.Add("mask build", []() -> bool
+		{
+			GameData::GetMaskManager().ScaleMasks();
+			return true;
+		}, {sprites});
+	// Now that we have finished loading all the basic sprites and sounds, we can look for invalid file paths,
+	// e.g. due to capitalization errors or other typos.
+	startup.Add("reference check", []() -> bool
+		{
+			SpriteSet::CheckReferences();
+			Audio::CheckReferences();
+			return true;
+		}, {data, sprites, sounds});
+	// Set the game's initial internal state. This does not need the sounds, so
+	// it can go ahead while they are still being decoded.
+	size_t universe = startup.Add("universe setup", []() -> bool
+		{
+			GameData::FinishLoading();
+			return true;
+		}, {data, masks});
+	size_t save = startup.Add("save scan", [&player]() -> bool
+		{
+			player.LoadRecent();
+			return true;
+		}, {universe});
+	// If some sprites were held back, load the ones the player will see first
+	// before showing the menu.
+	size_t priorities = startup.Add("sprite priorities", [&player]() -> bool
+		{
+			GameData::PrioritizeSprites(player);
+			return true;
+		}, {save});
+	startup.Add("priority sprite decode", []() -> bool
+		{
+			GameData::ProcessSprites();
+			return GameData::AreSpritesLoaded();
+		}, {priorities});
 }
 
 
 
 void GameLoadingPanel::Step()
 {
-	progress = static_cast<int>(GameData::GetProgress() * MAX_TICKS);
+	// Tracing a sprite's masks adds work as it is loaded, so the fraction that
+	// is done can drop slightly. Don't let the progress bar move backwards.
+	progress = max(progress, static_cast<int>(GameData::GetProgress() * MAX_TICKS));
 
-	// While the game is loading, upload sprites to the GPU.
-	GameData::ProcessSprites();
-	if(GameData::IsLoaded())
+	if(startup.Step(STEP_SECONDS) && GameData::IsLoaded())
 	{
-		// Now that we have finished loading all the basic sprites and sounds, we can look for invalid file paths,
-		// e.g. due to capitalization errors or other typos.
-		SpriteSet::CheckReferences();
-		Audio::CheckReferences();
-		// All sprites with collision masks should also have their 1x scaled versions, so create
-		// any additional scaled masks from the default one.
-		GameData::GetMaskManager().ScaleMasks();
-		// Set the game's initial internal state.
-		GameData::FinishLoading();
-
-		player.LoadRecent();
+		if(debugMode)
+			cout << startup.Report() << flush;
+		// Any sprites that are still held back can now be loaded in the background.
+		GameData::StreamSprites(player);
 
 		GetUI()->Pop(this);
 		if(conversation.IsEmpty())
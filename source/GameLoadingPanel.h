@@ -18,6 +18,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Panel.h"
 
+#include "StartupGraph.h"
+
 #include <string>
 #include <vector>
 
@@ -31,7 +33,8 @@ class UI;
 // (like game data and save files).
 class GameLoadingPanel final : public Panel {
 public:
-	GameLoadingPanel(PlayerInfo &player, const Conversation &conversation, UI &gamePanels, bool &finishedLoading);
+	GameLoadingPanel(PlayerInfo &player, const Conversation &conversation, UI &gamePanels, bool &finishedLoading,
+		bool debugMode = false);
 
 	void Step() final;
 	void Draw() final;
@@ -42,6 +45,10 @@ private:
 	const Conversation &conversation;
 	UI &gamePanels;
 	bool &finishedLoading;
+	bool debugMode;
+
+	// Everything that must be done before the main menu can be shown.
+	StartupGraph startup;
 
 	// The circular loading indicator shows 60 tick marks when all game data is loaded.
 	const int MAX_TICKS = 60;
@@ -14,6 +14,7 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 #include "GamePad.h"
 
 #include "Files.h"
+#include "SaveQueue.h"
 
 #include <cmath>
 #include <map>
@@ -286,7 +287,9 @@ void GamePad::SaveMapping()
 		char guidstr[64];
 		SDL_JoystickGetGUIDString(g_guid, guidstr, sizeof(guidstr));
 
-		// Load the existing entries into memory
+		// Load the existing entries into memory, once any earlier changes to
+		// them have been written.
+		SaveQueue::Wait();
 		std::vector<char> existing_entries;
 		std::shared_ptr<SDL_RWops> in(SDL_RWFromFile(MAPPING_FILE_PATH.c_str(), "rb"), [](SDL_RWops* p) { if(p) SDL_RWclose(p); });
 		if(in)
@@ -298,7 +301,7 @@ void GamePad::SaveMapping()
 		}
 		in.reset();
 
-		std::shared_ptr<SDL_RWops> out(SDL_RWFromFile(MAPPING_FILE_PATH.c_str(), "wb"), [](SDL_RWops* p) { if(p) SDL_RWclose(p); });
+		std::string out;
 		// write any existing entries back to the file
 		if(!existing_entries.empty())
 		{
@@ -310,16 +313,17 @@ void GamePad::SaveMapping()
 				// if this has the same guid we are updating, then drop this line
 				if(s.compare(0, guidlen, guidstr) == 0)
 					continue;
-				SDL_RWwrite(out.get(), s.data(), 1, s.size());
-				SDL_RWwrite(out.get(), "\n", 1, 1);
+				out += s;
+				out += '\n';
 			}
 		}
 		if(!g_mapping.empty())
 		{
 			std::shared_ptr<char> current_mapping(SDL_GameControllerMapping(g_gc), SDL_free);
-			SDL_RWwrite(out.get(), current_mapping.get(), 1, strlen(current_mapping.get()));
-			SDL_RWwrite(out.get(), ",", 1, 1);
+			out += current_mapping.get();
+			out += ',';
 		}
+		SaveQueue::Write(MAPPING_FILE_PATH, std::move(out));
 	}
 }
 
@@ -328,16 +332,11 @@ void GamePad::SaveMapping()
 void GamePad::SaveConfig()
 {
 	const std::string CONFIG_FILE_PATH = Files::Config() + CONFIG_FILE;
-	std::shared_ptr<SDL_RWops> out(SDL_RWFromFile(CONFIG_FILE_PATH.c_str(), "wb"), [](SDL_RWops* p) { if(p) SDL_RWclose(p); });
-
-	if(out)
-	{
-		std::string config =
-			"dead_zone " + std::to_string(g_DeadZone) + "\n" +
-			"trigger_threshold " + std::to_string(g_AxisIsButtonThreshold) + "\n"
-		;
-		SDL_RWwrite(out.get(), config.data(), 1, config.size());
-	}
+	std::string config =
+		"dead_zone " + std::to_string(g_DeadZone) + "\n" +
+		"trigger_threshold " + std::to_string(g_AxisIsButtonThreshold) + "\n"
+	;
+	SaveQueue::Write(CONFIG_FILE_PATH, std::move(config));
 }
 
 
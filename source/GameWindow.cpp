@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Files.h"
 #include "ImageBuffer.h"
 #include "Logger.h"
+#include "SaveQueue.h"
 #include "Screen.h"
 
 #include "opengl.h"
@@ -212,7 +213,7 @@ bool GameWindow::Init()
 	glClearColor(0.f, 0.f, 0.0f, 1.f);
 	glEnable(GL_BLEND);
 	glDisable(GL_DEPTH_TEST);
-	glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+	OpenGL::BlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
 
 #ifndef NDEBUG
 #ifndef ES_GLES
@@ -273,6 +274,7 @@ void GameWindow::Quit()
 void GameWindow::Step()
 {
 	SDL_GL_SwapWindow(mainWindow);
+	OpenGL::ReportFrame();
 }
 
 
@@ -434,6 +436,9 @@ void GameWindow::ExitWithError(const string &message, bool doPopUp)
 	// Print the error message in the terminal and the error file.
 	Logger::LogError(message);
 	checkSDLerror();
+	// Finish writing anything that was saved before the error, including the
+	// crash state, in case the game is killed while the message is showing.
+	SaveQueue::Wait();
 
 	// Show the error message in a message box.
 	if(doPopUp)
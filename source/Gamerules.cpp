@@ -44,6 +44,8 @@ void Gamerules::Load(const DataNode &node)
 			noPersonSpawnWeight = max<int>(0, child.Value(1));
 		else if(key == "npc max mining time")
 			npcMaxMiningTime = max<int>(0, child.Value(1));
+		else if(key == "retarget interval")
+			retargetInterval = max<int>(1, child.Value(1));
 		else if(key == "universal frugal threshold")
 			universalFrugalThreshold = min<double>(1., max<double>(0., child.Value(1)));
 		else
@@ -81,6 +83,13 @@ int Gamerules::NPCMaxMiningTime() const
 
 
 
+int Gamerules::RetargetInterval() const
+{
+	return retargetInterval;
+}
+
+
+
 double Gamerules::UniversalFrugalThreshold() const
 {
 	return universalFrugalThreshold;
@@ -436,6 +436,20 @@ const string &Government::GetTrueName() const
 
 
 
+size_t Government::Index() const
+{
+	return id;
+}
+
+
+
+size_t Government::IndexCount()
+{
+	return nextID;
+}
+
+
+
 // Get the color swizzle to use for ships of this government.
 int Government::GetSwizzle() const
 {
@@ -70,6 +70,10 @@ public:
 
 	// Get the display name of this government.
 	const std::string &GetName() const;
+	// Get the dense index of this government, for tables indexed by government,
+	// and the number of indices given out so far.
+	size_t Index() const;
+	static size_t IndexCount();
 	// Set / Get the name used for this government in the data files.
 	void SetName(const std::string &trueName);
 	const std::string &GetTrueName() const;
@@ -0,0 +1,193 @@
+/* GpuProfiler.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "GpuProfiler.h"
+
+#include "opengl.h"
+#include "Profiler.h"
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+using namespace std;
+
+namespace {
+// OpenGL ES only has timer queries through an extension, which uses the same
+// values as desktop OpenGL.
+#ifndef GL_TIME_ELAPSED
+	const GLenum GL_TIME_ELAPSED = 0x88BF;
+#endif
+#ifdef ES_GLES
+	const GLenum GL_GPU_DISJOINT = 0x8FBB;
+#endif
+	// If this many queries are waiting for their results, the driver is not
+	// making them available, so stop issuing more until it does.
+	const size_t MAX_PENDING = 512;
+
+	// A query that has been issued, and the zone and frame it belongs to.
+	class Query {
+	public:
+		GLuint id;
+		const char *name;
+		int64_t start;
+		uint64_t frame;
+	};
+
+	// The total time spent in one zone during a frame.
+	class Total {
+	public:
+		const char *name;
+		int64_t start;
+		uint64_t nanoseconds;
+	};
+
+	// Whether timer queries are supported. This is not known until there is an
+	// OpenGL context, so it is checked the first time a zone is created.
+	int isSupported = -1;
+	uint64_t frame = 0;
+	// The names of the zones that have begun but not ended, innermost last, and
+	// the query timing the innermost one.
+	vector<const char *> zones;
+	Query current;
+	// Queries that have ended, oldest first, and ones that can be reused.
+	deque<Query> pending;
+	vector<GLuint> unused;
+
+
+	void BeginQuery(const char *name)
+	{
+		if(unused.empty())
+		{
+			unused.push_back(0);
+			glGenQueries(1, &unused.back());
+		}
+		current.id = unused.back();
+		unused.pop_back();
+		current.name = name;
+		current.start = Profiler::Now();
+		current.frame = frame;
+		glBeginQuery(GL_TIME_ELAPSED, current.id);
+	}
+
+
+
+	void EndQuery()
+	{
+		glEndQuery(GL_TIME_ELAPSED);
+		pending.push_back(current);
+	}
+
+
+
+	// Record the total time spent in each zone during the oldest pending frame,
+	// if all its results are available.
+	bool RecordFrame()
+	{
+		uint64_t oldest = pending.front().frame;
+		if(oldest == frame)
+			return false;
+		size_t count = 0;
+		for( ; count < pending.size() && pending[count].frame == oldest; ++count)
+		{
+			GLuint isAvailable = GL_FALSE;
+			glGetQueryObjectuiv(pending[count].id, GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+			if(!isAvailable)
+				return false;
+		}
+
+#ifdef ES_GLES
+		// If something like a change in clock speed happened while these queries
+		// were running, their results cannot be trusted.
+		GLint isDisjoint = GL_FALSE;
+		glGetIntegerv(GL_GPU_DISJOINT, &isDisjoint);
+#else
+		const GLint isDisjoint = GL_FALSE;
+#endif
+
+		// A zone that was paused for a nested one has more than one query.
+		vector<Total> totals;
+		for(size_t i = 0; i < count; ++i)
+		{
+			const Query &query = pending[i];
+			GLuint elapsed = 0;
+			glGetQueryObjectuiv(query.id, GL_QUERY_RESULT, &elapsed);
+			unused.push_back(query.id);
+
+			auto it = totals.begin();
+			while(it != totals.end() && strcmp(it->name, query.name))
+				++it;
+			if(it == totals.end())
+			{
+				totals.push_back(Total());
+				it = --totals.end();
+				it->name = query.name;
+				it->start = query.start;
+				it->nanoseconds = 0;
+			}
+			it->nanoseconds += elapsed;
+		}
+		pending.erase(pending.begin(), pending.begin() + count);
+
+		// The profiler records times in microseconds.
+		if(!isDisjoint)
+			for(const Total &total : totals)
+				Profiler::AddEvent(total.name, total.start, total.nanoseconds / 1000, Profiler::GPU_THREAD);
+		return true;
+	}
+}
+
+
+
+GpuProfiler::Zone::Zone(const char *name)
+	: isActive(Profiler::IsEnabled() && pending.size() < MAX_PENDING)
+{
+	if(!isActive)
+		return;
+	if(isSupported < 0)
+		isSupported = OpenGL::HasTimerQuerySupport();
+	isActive = isSupported;
+	if(!isActive)
+		return;
+
+	if(!zones.empty())
+		EndQuery();
+	zones.push_back(name);
+	BeginQuery(name);
+}
+
+
+
+GpuProfiler::Zone::~Zone()
+{
+	if(!isActive)
+		return;
+
+	EndQuery();
+	zones.pop_back();
+	if(!zones.empty())
+		BeginQuery(zones.back());
+}
+
+
+
+void GpuProfiler::EndFrame()
+{
+	++frame;
+	while(!pending.empty())
+		if(!RecordFrame())
+			break;
+}
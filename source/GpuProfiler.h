@@ -0,0 +1,54 @@
+/* GpuProfiler.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef GPU_PROFILER_H_
+#define GPU_PROFILER_H_
+
+
+
+// Times how long the graphics card spends on each stage of drawing a frame,
+// using timer queries, and records the results in the Profiler alongside the
+// zones timed on the CPU. The results are only read once the graphics card has
+// made them available, a frame or two later, so the CPU never waits for them.
+// Timer queries cannot overlap, so when one zone begins inside another the outer
+// one is paused until the inner one ends; each zone's time therefore excludes
+// any zones nested inside it. All of this must happen on the drawing thread.
+class GpuProfiler {
+public:
+	// Time the drawing commands issued from this object's creation until its
+	// destruction, if profiling is enabled and timer queries are supported.
+	class Zone {
+	public:
+		// The name must be a string literal, or otherwise live as long as the program.
+		explicit Zone(const char *name);
+		~Zone();
+
+		Zone(const Zone &other) = delete;
+		Zone &operator=(const Zone &other) = delete;
+
+	private:
+		bool isActive;
+	};
+
+
+public:
+	// Mark the end of a frame, and record the time of every earlier frame whose
+	// results are now available. This should be called once the frame is drawn.
+	static void EndFrame();
+};
+
+
+
+#endif
@@ -175,11 +175,13 @@ int Hardpoint::BurstRemaining() const
 
 
 
-// Perform one step (i.e. decrement the reload count).
-void Hardpoint::Step()
+// Perform one step (i.e. decrement the reload count). Returns false once
+// this weapon is fully reloaded and idle, so that stepping it again would
+// not change anything until it fires.
+bool Hardpoint::Step()
 {
 	if(!outfit)
-		return;
+		return false;
 
 	wasFiring = isFiring;
 	if(reload > 0.)
@@ -193,6 +195,8 @@ void Hardpoint::Step()
 	// continuously if it is not fired this frame.
 	if(burstReload <= 0.)
 		isFiring = false;
+
+	return wasFiring || isFiring || reload > 0. || burstReload > 0.;
 }
 
 
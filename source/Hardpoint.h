@@ -62,8 +62,10 @@ public:
 	bool WasFiring() const;
 	// If this is a burst weapon, get the number of shots left in the burst.
 	int BurstRemaining() const;
-	// Perform one step (i.e. decrement the reload count).
-	void Step();
+	// Perform one step (i.e. decrement the reload count). Returns false once
+	// this weapon is fully reloaded and idle, so that stepping it again would
+	// not change anything until it fires.
+	bool Step();
 
 	// Adjust this weapon's aim by the given amount, relative to its maximum
 	// "turret turn" rate.
@@ -43,6 +43,14 @@ void HiringPanel::Step()
 
 
 
+// The crew numbers only change when the player hires or fires someone.
+bool HiringPanel::IsAnimated() const noexcept
+{
+	return false;
+}
+
+
+
 void HiringPanel::Draw()
 {
 	if(!player.Flagship())
@@ -15,11 +15,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "ImageBuffer.h"
 
+#include "Bc7RGBA.h"
 #include "Etc2RGBA.h"
-#include "File.h"
-#include "Files.h"
 #include "KtxFile.h"
 #include "Logger.h"
+#include "MappedFile.h"
+#include "MemoryStats.h"
 
 #include <cassert>
 #include <jpeglib.h>
@@ -58,8 +59,15 @@ ImageBuffer::~ImageBuffer()
 // Set the number of frames. This must be called before allocating.
 void ImageBuffer::Clear(int frames)
 {
+	if(pixels)
+		MemoryStats::Add(MemoryStats::Category::IMAGE_BUFFERS,
+			-static_cast<int64_t>(sizeof(uint32_t)) * width * height * this->frames);
 	delete [] pixels;
 	pixels = nullptr;
+	compressed = nullptr;
+	compressed_format = 0;
+	compressed_size = 0;
+	file.reset();
 	this->frames = frames;
 }
 
@@ -71,23 +79,25 @@ void ImageBuffer::Allocate(int width, int height)
 {
 	// Do nothing if the buffer is already allocated or if any of the dimensions
 	// is set to zero.
-	if(pixels || !width || !height || !frames)
+	if(Data() || !width || !height || !frames)
 		return;
 
 	pixels = new uint32_t[width * height * frames];
+	MemoryStats::Add(MemoryStats::Category::IMAGE_BUFFERS, static_cast<int64_t>(sizeof(uint32_t)) * width * height * frames);
 	this->display_width = this->width = width;
 	this->display_height = this->height = height;
 }
 
 
 
-void ImageBuffer::Assign(const void* data, size_t size, int width, int height, uint32_t compressed_format)
+void ImageBuffer::Assign(unique_ptr<MappedFile> file, const void* data, size_t size, int width, int height,
+	uint32_t compressed_format)
 {
-	if(pixels || !size || !width || !height || !frames)
+	if(Data() || !size || !width || !height || !frames)
 		return;
 
-	pixels = new uint32_t[(size + 3) / 4 * 4];
-	memcpy(pixels, data, size);
+	this->file = std::move(file);
+	compressed = data;
 	this->compressed_format = compressed_format;
 	this->compressed_size = size;
 	this->display_width = this->width = width;
@@ -152,6 +162,13 @@ uint32_t *ImageBuffer::Pixels()
 
 
 
+const void *ImageBuffer::Data() const
+{
+	return compressed ? compressed : pixels;
+}
+
+
+
 const uint32_t *ImageBuffer::Begin(int y, int frame) const
 {
 	assert(!compressed_format);
@@ -178,18 +195,42 @@ uint8_t ImageBuffer::GetAlpha(int frame, int x, int y) const
 	else if (compressed_format == 0x9278    // ETC2 RGBA
 	      || compressed_format == 0x9279)   // ETC2 SRGBA
 	{
-		Etc2RGBA etc(pixels, width, height);
+		Etc2RGBA etc(compressed, width, height);
 		return etc.Alpha(frame, x, y);
 	}
+	else if (KtxFile::IsBc7(compressed_format))
+		return Bc7RGBA(compressed, width, height).Alpha(frame, x, y);
 	else
 	{
-		// Assume compressed texture without alpha channel
+		// Assume compressed texture without alpha channel. ASTC is not decoded
+		// here, so ImageSet never picks it for sprites that need masks.
 		return 255;
 	}
 }
 
 
 
+void ImageBuffer::GetAlphaPlane(int frame, vector<uint8_t> &plane) const
+{
+	plane.resize(width * height);
+	if(compressed_format == 0)
+	{
+		const uint32_t *it = Begin(0, frame);
+		for(uint8_t &alpha : plane)
+			alpha = *it++ >> 24;
+	}
+	else if(compressed_format == 0x9278 || compressed_format == 0x9279)
+		Etc2RGBA(compressed, width, height).AlphaFrame(frame, plane.data());
+	else
+	{
+		for(int y = 0; y < height; ++y)
+			for(int x = 0; x < width; ++x)
+				plane[y * width + x] = GetAlpha(frame, x, y);
+	}
+}
+
+
+
 void ImageBuffer::ShrinkToHalfSize()
 {
 	assert(!compressed_format);
@@ -266,7 +307,7 @@ namespace {
 	bool ReadPNG(const string &path, ImageBuffer &buffer, int frame)
 	{
 		// Open the file, and make sure it really is a PNG.
-		File file(path);
+		MappedFile file(path);
 		if(!file)
 			return false;
 
@@ -292,20 +333,23 @@ namespace {
 		// contiguous memory layout requirements. Investigate using an iterative loading scheme for large images.
 
 		// Not using SDLRW_ops directly here, because of preprocessor conflicts with libjpeg on windows.
+		// The file is read straight from where it is mapped into memory.
 		struct MemBuffer {
-			std::string data;
+			const char *data;
+			size_t size;
 			size_t pos;
 		} pngData {
-			Files::Read(file),
+			file.Data(),
+			file.Size(),
 			0
 		};
 		png_set_read_fn(png, &pngData, [](png_struct* png, png_bytep data, size_t length) {
          MemBuffer* p = reinterpret_cast<MemBuffer*>(png_get_io_ptr(png));
-			if (length + p->pos > p->data.size())
+			if (length + p->pos > p->size)
          {
             png_error(png, "EOF hit when reading bytes from png file");
          }
-			memcpy(data, p->data.data() + p->pos, length);
+			memcpy(data, p->data + p->pos, length);
 			p->pos += length;
       });
 		png_set_sig_bytes(png, 0);
@@ -382,7 +426,7 @@ namespace {
 
 	bool ReadJPG(const string &path, ImageBuffer &buffer, int frame)
 	{
-		File file(path);
+		MappedFile file(path);
 		if(!file)
 			return false;
 
@@ -394,8 +438,9 @@ namespace {
 		jpeg_create_decompress(&cinfo);
 #pragma GCC diagnostic pop
 
-		std::string jpg_data = Files::Read(file);
-		jpeg_mem_src(&cinfo, reinterpret_cast<unsigned char*>(&jpg_data[0]), jpg_data.size());
+		// Older versions of libjpeg do not take a const buffer, but it is only read.
+		jpeg_mem_src(&cinfo, const_cast<unsigned char *>(reinterpret_cast<const unsigned char *>(file.Data())),
+			file.Size());
 		jpeg_read_header(&cinfo, true);
 		cinfo.out_color_space = JCS_EXT_RGBA;
 
@@ -445,19 +490,18 @@ namespace {
 
 	bool ReadKTX(const string &path, ImageBuffer &buffer)
 	{
-		File file(path);
-		if(!file)
+		unique_ptr<MappedFile> file(new MappedFile(path));
+		if(!*file)
 			return false;
 
-		std::string ktx_data = Files::Read(file);
-
-		KtxFile ktx(ktx_data);
+		KtxFile ktx(file->Data(), file->Size());
 		if (!ktx.Valid())
 			return false;
 
-		// frames are stored in ktx file together.
+		// frames are stored in ktx file together. The buffer keeps the file
+		// open so that they can be uploaded without copying them first.
 		buffer.Clear(ktx.Frames());
-		buffer.Assign(ktx.Data(), ktx.Size(), ktx.Width(), ktx.Height(), ktx.InternalFormat());
+		buffer.Assign(std::move(file), ktx.Data(), ktx.Size(), ktx.Width(), ktx.Height(), ktx.InternalFormat());
 		buffer.SetDisplaySize(ktx.OriginalWidth(), ktx.OriginalHeight());
 		return true;
 	}
@@ -17,7 +17,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #define IMAGE_BUFFER_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
+
+class MappedFile;
 
 
 
@@ -43,8 +47,11 @@ public:
 	// image buffer; subsequent calls will be ignored.
 	void Allocate(int width, int height);
 
-	// Assign the internal buffer all at once
-	void Assign(const void* data, size_t size, int width, int height, uint32_t compressed_format);
+	// Use compressed image data that is part of the given file. Instead of being
+	// copied, the data is used in place, and the file stays open until the
+	// buffer is cleared.
+	void Assign(std::unique_ptr<MappedFile> file, const void* data, size_t size, int width, int height,
+		uint32_t compressed_format);
 	void SetDisplaySize(int dw, int dh);
 
 	int Width() const;
@@ -53,14 +60,20 @@ public:
 	int DisplayHeight() const;
 	int Frames() const;
 
+	// The uncompressed pixels, or null if the image is compressed.
 	const uint32_t *Pixels() const;
 	uint32_t *Pixels();
+	// The image data in whatever format it is stored in, or null if there is none.
+	const void *Data() const;
 
 	const uint32_t *Begin(int y, int frame = 0) const;
 	uint32_t *Begin(int y, int frame = 0);
 
 	// get the alpha component without making assumptions about the buffer format
 	uint8_t GetAlpha(int frame, int x, int y) const;
+	// get the alpha component of every pixel in a frame, one byte per pixel,
+	// row by row. This is much faster than calling GetAlpha() for each pixel.
+	void GetAlphaPlane(int frame, std::vector<uint8_t> &plane) const;
 
 	void ShrinkToHalfSize();
 
@@ -82,6 +95,8 @@ private:
 
 	uint32_t compressed_format = 0;
 	uint32_t compressed_size = 0;
+	const void *compressed = nullptr;
+	std::unique_ptr<MappedFile> file;
 };
 
 
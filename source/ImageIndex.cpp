@@ -0,0 +1,207 @@
+/* ImageIndex.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ImageIndex.h"
+
+#include "Files.h"
+#include "ImageSet.h"
+#include "PluginArchive.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+	// Every index begins with this header. The version must be changed whenever
+	// either the index format or the way that image names are parsed changes.
+	const string HEADER = "Endless Sky image index";
+	const uint64_t VERSION = 1;
+
+	template <class Type>
+	void Write(string &out, Type value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+
+
+	template <class Type>
+	bool Read(const string &data, size_t &pos, Type &value)
+	{
+		if(data.size() - pos < sizeof(value))
+			return false;
+		memcpy(&value, data.data() + pos, sizeof(value));
+		pos += sizeof(value);
+		return true;
+	}
+
+
+
+	bool ReadString(const string &data, size_t &pos, string &value)
+	{
+		uint64_t length = 0;
+		if(!Read(data, pos, length) || data.size() - pos < length)
+			return false;
+		value.assign(data, pos, length);
+		pos += length;
+		return true;
+	}
+
+
+
+	void WriteString(string &out, const string &value)
+	{
+		Write<uint64_t>(out, value.size());
+		out += value;
+	}
+}
+
+
+
+// Load the index saved at the given path.
+ImageIndex::ImageIndex(const string &path)
+	: path(path)
+{
+	string data = Files::Read(path);
+	if(data.compare(0, HEADER.size(), HEADER))
+		return;
+
+	size_t pos = HEADER.size();
+	uint64_t version = 0;
+	if(!Read(data, pos, version) || version != VERSION)
+		return;
+
+	while(pos < data.size())
+	{
+		string root;
+		Entry entry;
+		uint64_t directories = 0;
+		uint64_t images = 0;
+		bool isValid = ReadString(data, pos, root) && Read(data, pos, directories);
+		for(uint64_t i = 0; isValid && i < directories; ++i)
+		{
+			entry.directories.emplace_back();
+			isValid = ReadString(data, pos, entry.directories.back().first)
+				&& Read(data, pos, entry.directories.back().second);
+		}
+		isValid = isValid && Read(data, pos, images);
+		for(uint64_t i = 0; isValid && i < images; ++i)
+		{
+			entry.images.emplace_back();
+			isValid = ReadString(data, pos, entry.images.back().first)
+				&& ReadString(data, pos, entry.images.back().second);
+		}
+		if(!isValid)
+		{
+			// If any part of the index is damaged, none of it can be trusted.
+			entries.clear();
+			return;
+		}
+		entries[root] = std::move(entry);
+	}
+}
+
+
+
+// Get all the image files in the given directory tree.
+const ImageIndex::Images &ImageIndex::List(const string &directory)
+{
+	Entry &entry = entries[directory];
+	entry.isUsed = true;
+	if(!entry.isCacheable || entry.directories.empty() || !IsCurrent(entry))
+	{
+		entry = Entry();
+		entry.isUsed = true;
+		Scan(directory, directory.length(), entry);
+		sort(entry.images.begin(), entry.images.end());
+		isChanged |= entry.isCacheable;
+	}
+	return entry.images;
+}
+
+
+
+// Save this index, if anything in it has changed.
+void ImageIndex::Save()
+{
+	for(auto it = entries.begin(); it != entries.end(); )
+	{
+		// Directories that cannot be cached were never saved in the first place.
+		if(it->second.isUsed && it->second.isCacheable)
+			++it;
+		else
+		{
+			isChanged |= !it->second.isUsed;
+			it = entries.erase(it);
+		}
+	}
+	if(!isChanged)
+		return;
+
+	string out = HEADER;
+	Write(out, VERSION);
+	for(const auto &it : entries)
+	{
+		WriteString(out, it.first);
+		Write<uint64_t>(out, it.second.directories.size());
+		for(const auto &directory : it.second.directories)
+		{
+			WriteString(out, directory.first);
+			Write(out, directory.second);
+		}
+		Write<uint64_t>(out, it.second.images.size());
+		for(const auto &image : it.second.images)
+		{
+			WriteString(out, image.first);
+			WriteString(out, image.second);
+		}
+	}
+	Files::Write(path, out);
+	isChanged = false;
+}
+
+
+
+// Check whether none of the directories in the given entry have changed.
+bool ImageIndex::IsCurrent(const Entry &entry)
+{
+	for(const auto &directory : entry.directories)
+		if(static_cast<int64_t>(Files::Timestamp(directory.first)) != directory.second)
+			return false;
+	return true;
+}
+
+
+
+// Find all the images in the given directory, and all the directories in it.
+void ImageIndex::Scan(const string &directory, size_t start, Entry &entry)
+{
+	// Only directories on the file system itself have a modification time.
+	string entryName;
+	if(Files::Size(directory) < 0 || PluginArchive::Find(directory, entryName))
+		entry.isCacheable = false;
+	else
+		entry.directories.emplace_back(directory, Files::Timestamp(directory));
+
+	for(string &file : Files::List(directory))
+		if(ImageSet::IsImage(file))
+		{
+			string name = ImageSet::Name(file.substr(start));
+			entry.images.emplace_back(std::move(file), std::move(name));
+		}
+	for(const string &subdirectory : Files::ListDirectories(directory))
+		Scan(subdirectory, start, entry);
+}
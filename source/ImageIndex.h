@@ -0,0 +1,80 @@
+/* ImageIndex.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef IMAGE_INDEX_H_
+#define IMAGE_INDEX_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+// An index of the image files in each "images" directory, saved between runs so
+// that finding every sprite does not require walking every directory. Adding or
+// removing a file changes the modification time of the directory it is in, so
+// the index for a directory tree is only used if none of the directories in it
+// have changed since it was made. Directories whose times cannot be checked,
+// such as those in the Android asset bundle or in plugin archives, are always
+// listed again instead.
+class ImageIndex {
+public:
+	// Each image file is listed along with the name of the sprite it belongs to.
+	using Images = std::vector<std::pair<std::string, std::string>>;
+
+
+public:
+	// Load the index saved at the given path. If there is no valid index there,
+	// this index starts out empty.
+	explicit ImageIndex(const std::string &path);
+
+	// Get all the image files in the given directory, or in any directory it
+	// contains, sorted by path.
+	const Images &List(const std::string &directory);
+
+	// Save this index, if anything in it has changed. Any directories that were
+	// not listed since it was loaded are dropped from it.
+	void Save();
+
+
+private:
+	class Entry {
+	public:
+		// Every directory in this tree, and when it was last modified.
+		std::vector<std::pair<std::string, int64_t>> directories;
+		Images images;
+		bool isCacheable = true;
+		bool isUsed = false;
+	};
+
+
+private:
+	// Check whether none of the directories in the given entry have changed.
+	static bool IsCurrent(const Entry &entry);
+	// Find all the images in the given directory, and all the directories in it.
+	static void Scan(const std::string &directory, size_t start, Entry &entry);
+
+
+private:
+	std::string path;
+	std::map<std::string, Entry> entries;
+	bool isChanged = false;
+};
+
+
+
+#endif
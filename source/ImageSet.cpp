@@ -16,11 +16,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ImageSet.h"
 
 #include "GameData.h"
+#include "KtxFile.h"
 #include "Logger.h"
 #include "Mask.h"
 #include "MaskManager.h"
 #include "Sprite.h"
+#include "SpriteAtlas.h"
+#include "SpriteUpload.h"
 #include "Preferences.h"
+#include "TextureCache.h"
 
 #include <algorithm>
 #include <cassert>
@@ -29,13 +33,55 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
+	// The file formats an image may be provided in, in order of preference.
+	// Files in the driver-specific formats are tagged with the format's name,
+	// e.g. "ship/shuttle.astc.ktx"; an untagged KTX file is in ETC2 format.
+	enum Format {ASTC, BC7, ETC2, UNCOMPRESSED};
+
+	// Get the length of the given path's extension, including any format tag.
+	size_t ExtensionLength(const string &path)
+	{
+		auto HasSuffix = [&path](const char *suffix, size_t length) -> bool
+		{
+			return path.length() >= length && !path.compare(path.length() - length, length, suffix);
+		};
+		if(HasSuffix(".astc.ktx", 9) || HasSuffix(".ASTC.KTX", 9))
+			return 9;
+		if(HasSuffix(".bc7.ktx", 8) || HasSuffix(".BC7.KTX", 8))
+			return 8;
+		return 4;
+	}
+
+	Format FileFormat(const string &path)
+	{
+		size_t length = ExtensionLength(path);
+		if(length == 9)
+			return ASTC;
+		if(length == 8)
+			return BC7;
+		char last = path.back();
+		return (last == 'x' || last == 'X') ? ETC2 : UNCOMPRESSED;
+	}
+
+	// Check whether images in the given format can be used. ASTC images can't be
+	// used if a collision mask is needed, because their alpha is not decoded.
+	bool IsUsable(int format, bool makeMasks)
+	{
+		if(format == ASTC)
+			return !makeMasks && KtxFile::HasAstcSupport();
+		if(format == BC7)
+			return KtxFile::HasBc7Support();
+		return true;
+	}
+
 	// Determine whether the given path is to an @2x image.
 	bool Is2x(const string &path)
 	{
-		if(path.length() < 7)
+		size_t extension = ExtensionLength(path);
+		if(path.length() < extension + 3)
 			return false;
 
-		size_t pos = path.length() - 7;
+		size_t pos = path.length() - extension - 3;
 		return (path[pos] == '@' && path[pos + 1] == '2' && path[pos + 2] == 'x');
 	}
 
@@ -60,9 +106,10 @@ namespace {
 	// Get the character index where the sprite name in the given path ends.
 	size_t NameEnd(const string &path)
 	{
-		// The path always ends in a three-letter extension, ".png" or ".jpg".
-		// In addition, 3 more characters may be taken up by an @2x label.
-		size_t end = path.length() - (Is2x(path) ? 7 : 4);
+		// The path always ends in a three-letter extension, ".png" or ".jpg",
+		// perhaps with a format tag before it. In addition, 3 more characters
+		// may be taken up by an @2x label.
+		size_t end = path.length() - ExtensionLength(path) - (Is2x(path) ? 3 : 0);
 		// This should never happen, but just in case:
 		if(!end)
 			return 0;
@@ -99,6 +146,25 @@ namespace {
 		return frame;
 	}
 
+	// Uncompressed plugin images are cached in a compressed format, which loads
+	// much faster and takes less video memory. Get the path of the given frames'
+	// cached copy, if they should have one, and read it into the given buffer if
+	// it is up to date.
+	bool ReadCached(const vector<string> &sequence, size_t frames, ImageBuffer &buffer, string &cachePath)
+	{
+		cachePath.clear();
+		if(sequence.size() != frames)
+			return false;
+		cachePath = TextureCache::Path(sequence);
+		if(cachePath.empty() || !TextureCache::IsCurrent(cachePath, sequence))
+			return false;
+		if(buffer.Read(cachePath) && buffer.Frames() == static_cast<int>(frames))
+			return true;
+
+		buffer.Clear(frames);
+		return false;
+	}
+
 	// Add consecutive frames from the given map to the given vector. Issue warnings for missing or mislabeled frames.
 	void AddValid(const map<size_t, string> &frameData, vector<string> &sequence, const string &prefix, bool is2x)
 		noexcept(false)
@@ -190,7 +256,11 @@ const string &ImageSet::Name() const
 // Whether this image set is empty, i.e. has no images.
 bool ImageSet::IsEmpty() const
 {
-	return framePaths[0].empty() && framePaths[1].empty();
+	for(const auto &paths : framePaths)
+		for(const auto &formatPaths : paths)
+			if(!formatPaths.empty())
+				return false;
+	return true;
 }
 
 
@@ -202,8 +272,19 @@ void ImageSet::Add(string path)
 	// Determine which frame of the sprite this image will be.
 	bool is2x = Is2x(path);
 	size_t frame = FrameIndex(path);
+	Format format = FileFormat(path);
+	// The versions of a frame in different formats must all be in the same
+	// directory. An image in another directory is from a higher priority
+	// source, so it replaces any versions of that frame that came before it.
+	const string directory = path.substr(0, path.rfind('/') + 1);
+	for(int i = 0; i < FORMAT_COUNT; ++i)
+	{
+		auto it = framePaths[is2x][i].find(frame);
+		if(i != format && it != framePaths[is2x][i].end() && it->second.compare(0, it->second.rfind('/') + 1, directory))
+			framePaths[is2x][i].erase(it);
+	}
 	// Store the requested path.
-	framePaths[is2x][frame].swap(path);
+	framePaths[is2x][format][frame].swap(path);
 }
 
 
@@ -212,71 +293,120 @@ void ImageSet::Add(string path)
 void ImageSet::ValidateFrames() noexcept(false)
 {
 	string prefix = "Sprite \"" + name + "\": ";
-	AddValid(framePaths[0], paths[0], prefix, false);
-	AddValid(framePaths[1], paths[1], prefix, true);
-	framePaths[0].clear();
-	framePaths[1].clear();
-
-	// Drop any @2x paths that will not be used.
-	if(paths[1].size() > paths[0].size())
+	for(int i = 0; i < FORMAT_COUNT; ++i)
 	{
-		Logger::LogError(prefix + to_string(paths[1].size() - paths[0].size())
-				+ " extra frames for the @2x sprite will be ignored.");
-		paths[1].resize(paths[0].size());
+		AddValid(framePaths[0][i], paths[0][i], prefix, false);
+		AddValid(framePaths[1][i], paths[1][i], prefix, true);
+		framePaths[0][i].clear();
+		framePaths[1][i].clear();
+
+		// Drop any @2x paths that will not be used.
+		if(paths[1][i].size() > paths[0][i].size() && !paths[0][i].empty())
+		{
+			Logger::LogError(prefix + to_string(paths[1][i].size() - paths[0][i].size())
+					+ " extra frames for the @2x sprite will be ignored.");
+			paths[1][i].resize(paths[0][i].size());
+		}
 	}
 }
 
 
 
 // Load all the frames. This should be called in one of the image-loading
-// worker threads. This also generates collision masks if needed.
+// worker threads. If this sprite needs collision masks, they must be traced
+// with TraceMask() afterwards.
 void ImageSet::Load() noexcept(false)
 {
-	assert(framePaths[0].empty() && "should call ValidateFrames before calling Load");
-
-	if (Preferences::Has("Reduced graphics") && paths[0].size() > 10)
-	{
-		// remove every other frame
-		for (ssize_t i = paths[0].size() - 1; i >= 0; i -= 2)
-		{
-			paths[0].erase(paths[0].begin() + i);
-		}
-	}
-
-	// Determine how many frames there will be, total. The image buffers will
-	// not actually be allocated until the first image is loaded (at which point
-	// the sprite's dimensions will be known).
-	size_t frames = paths[0].size();
-	buffer[0].Clear(frames);
-	buffer[1].Clear(frames);
+	assert(IsEmpty() && "should call ValidateFrames before calling Load");
 
 	// Check whether we need to generate collision masks.
 	bool makeMasks = IsMasked(name);
-	if(makeMasks)
-		masks.resize(frames);
+
+	// Find the formats the images can be loaded in, in order of preference.
+	vector<int> formats[2];
+	for(int is2x = 0; is2x < 2; ++is2x)
+		for(int format = 0; format < FORMAT_COUNT; ++format)
+			if(!paths[is2x][format].empty() && IsUsable(format, makeMasks))
+				formats[is2x].push_back(format);
 
 	// Load the 1x sprites first, then the 2x sprites, because they are likely
-	// to be in separate locations on the disk. Create masks if needed.
-	for(size_t i = 0; i < frames; ++i)
+	// to be in separate locations on the disk. If an image can't be read, fall
+	// back to the next format, if there is one.
+	size_t frames = 0;
+	for(size_t f = 0; f < formats[0].size(); ++f)
 	{
-		if(!buffer[0].Read(paths[0][i], i))
-			Logger::LogError("Failed to read image data for \"" + name + "\" frame #" + to_string(i));
-		else if(makeMasks)
+		vector<string> &sequence = paths[0][formats[0][f]];
+		const bool isLast = (f + 1 == formats[0].size());
+		if (Preferences::Has("Reduced graphics") && sequence.size() > 10)
+		{
+			// remove every other frame
+			for (ssize_t i = sequence.size() - 1; i >= 0; i -= 2)
+			{
+				sequence.erase(sequence.begin() + i);
+			}
+		}
+
+		// Determine how many frames there will be, total. The image buffers will
+		// not actually be allocated until the first image is loaded (at which point
+		// the sprite's dimensions will be known).
+		frames = sequence.size();
+		buffer[0].Clear(frames);
+		string cachePath;
+		if(formats[0][f] == UNCOMPRESSED && ReadCached(sequence, frames, buffer[0], cachePath))
+			break;
+
+		bool isRead = true;
+		for(size_t i = 0; i < frames; ++i)
+		{
+			if(!buffer[0].Read(sequence[i], i))
+			{
+				Logger::LogError("Failed to read image data for \"" + name + "\" frame #" + to_string(i));
+				isRead = false;
+				if(!isLast)
+					break;
+			}
+		}
+		if(isRead)
 		{
-			masks[i].Create(buffer[0], i);
-			if(!masks[i].IsLoaded())
-				Logger::LogError("Failed to create collision mask for \"" + name + "\" frame #" + to_string(i));
+			if(!cachePath.empty())
+				TextureCache::Save(cachePath, buffer[0]);
+			break;
 		}
 	}
+	// Make room for the masks. A KTX file holds every frame, so count the
+	// frames that were actually loaded rather than the paths.
+	masks.clear();
+	if(makeMasks && buffer[0].Data())
+		masks.resize(buffer[0].Frames());
+
 	// Now, load the 2x sprites, if they exist. Because the number of 1x frames
 	// is definitive, don't load any frames beyond the size of the 1x list.
-	for(size_t i = 0; i < frames && i < paths[1].size(); ++i)
-		if(!buffer[1].Read(paths[1][i], i))
+	buffer[1].Clear(frames);
+	for(size_t f = 0; f < formats[1].size(); ++f)
+	{
+		const vector<string> &sequence = paths[1][formats[1][f]];
+		string cachePath;
+		if(formats[1][f] == UNCOMPRESSED && ReadCached(sequence, frames, buffer[1], cachePath))
+			break;
+
+		bool isRead = true;
+		for(size_t i = 0; i < frames && i < sequence.size() && isRead; ++i)
+			isRead = buffer[1].Read(sequence[i], i);
+		if(isRead)
+		{
+			if(!cachePath.empty())
+				TextureCache::Save(cachePath, buffer[1]);
+			break;
+		}
+
+		if(f + 1 < formats[1].size())
+			buffer[1].Clear(frames);
+		else
 		{
 			Logger::LogError("Removing @2x frames for \"" + name + "\" due to read error");
 			buffer[1].Clear();
-			break;
 		}
+	}
 
 	// Warn about a "high-profile" image that will be blurry due to rendering at 50% scale.
 	bool willBlur = (buffer[0].Width() & 1) || (buffer[0].Height() & 1);
@@ -291,6 +421,38 @@ void ImageSet::Load() noexcept(false)
 
 
 
+// Get the number of collision masks that need to be traced, once the frames
+// have been loaded.
+size_t ImageSet::MasksToTrace() const
+{
+	return masks.size();
+}
+
+
+
+// Trace the collision mask for the given frame. This may be called from
+// several threads at once, as long as each is tracing a different frame.
+void ImageSet::TraceMask(size_t frame)
+{
+	masks[frame].Create(buffer[0], frame);
+	if(!masks[frame].IsLoaded())
+		Logger::LogError("Failed to create collision mask for \"" + name + "\" frame #" + to_string(frame));
+}
+
+
+
+// Whether any of the images are in a format that only some graphics drivers
+// support, so that this should not be loaded until the driver is known.
+bool ImageSet::NeedsDriverSupport() const
+{
+	for(int is2x = 0; is2x < 2; ++is2x)
+		if(!paths[is2x][ASTC].empty() || !paths[is2x][BC7].empty())
+			return true;
+	return false;
+}
+
+
+
 // Create the sprite and upload the image data to the GPU. After this is
 // called, the internal image buffers and mask vector will be cleared, but
 // the paths are saved in case the sprite needs to be loaded again.
@@ -302,3 +464,22 @@ void ImageSet::Upload(Sprite *sprite)
 	GameData::GetMaskManager().SetMasks(sprite, std::move(masks));
 	masks.clear();
 }
+
+
+
+bool ImageSet::Upload(Sprite *sprite, SpriteAtlas &atlas, vector<SpriteUpload> &uploads)
+{
+	bool isKept = false;
+	for(int i = 0; i < 2; ++i)
+	{
+		if(!buffer[i].Data())
+			continue;
+		if(atlas.Add(sprite, buffer[i], i))
+			isKept = true;
+		else
+			uploads.emplace_back(sprite, buffer[i], i);
+	}
+	GameData::GetMaskManager().SetMasks(sprite, std::move(masks));
+	masks.clear();
+	return isKept;
+}
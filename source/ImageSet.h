@@ -25,6 +25,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 class Mask;
 class Sprite;
+class SpriteAtlas;
+class SpriteUpload;
 
 
 
@@ -57,22 +59,41 @@ public:
 	void Add(std::string path);
 	// Reduce all given paths to frame images into a sequence of consecutive frames.
 	void ValidateFrames() noexcept(false);
+	// Whether any of the images are in a format that only some graphics drivers
+	// support, so that this should not be loaded until the driver is known.
+	bool NeedsDriverSupport() const;
 	// Load all the frames. This should be called in one of the image-loading
-	// worker threads. This also generates collision masks if needed.
+	// worker threads. If this sprite needs collision masks, they must be traced
+	// with TraceMask() afterwards.
 	void Load() noexcept(false);
+	// Get the number of collision masks that need to be traced, once the frames
+	// have been loaded.
+	std::size_t MasksToTrace() const;
+	// Trace the collision mask for the given frame. This may be called from
+	// several threads at once, as long as each is tracing a different frame.
+	void TraceMask(std::size_t frame);
 	// Create the sprite and upload the image data to the GPU. After this is
 	// called, the internal image buffers and mask vector will be cleared, but
 	// the paths are saved in case the sprite needs to be loaded again.
 	void Upload(Sprite *sprite);
+	// Like Upload(), but let the given atlas pack small frames together with
+	// those of other sprites, and add any others to the given list of uploads
+	// to be done a frame at a time. Return true if the atlas kept any of them.
+	// Either way, this image set must not be destroyed until the atlas has
+	// been packed and the uploads are done.
+	bool Upload(Sprite *sprite, SpriteAtlas &atlas, std::vector<SpriteUpload> &uploads);
 
 
 private:
 	// Name of the sprite that will be initialized with these images.
 	std::string name;
+	// Each image may be provided in several file formats, of which the most
+	// efficient one that the graphics driver supports is loaded.
+	static const int FORMAT_COUNT = 4;
 	// Paths to all the images that were discovered during loading.
-	std::map<std::size_t, std::string> framePaths[2];
+	std::map<std::size_t, std::string> framePaths[2][FORMAT_COUNT];
 	// Paths that comprise a valid animation sequence of 1 or more frames.
-	std::vector<std::string> paths[2];
+	std::vector<std::string> paths[2][FORMAT_COUNT];
 	// Data loaded from the images:
 	ImageBuffer buffer[2];
 	std::vector<Mask> masks;
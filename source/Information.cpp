@@ -17,93 +17,225 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Sprite.h"
 
+#include <mutex>
+#include <unordered_map>
+
 using namespace std;
 
 
 
+namespace {
+	// Every name that has been given a key. Keys may be made by any thread.
+	mutex registryMutex;
+
+	unordered_map<string, int> &Registry()
+	{
+		static unordered_map<string, int> registry;
+		return registry;
+	}
+
+	// Get the slot for the given key, growing the list to hold it if needed.
+	template <class Type>
+	typename vector<Type>::reference Slot(vector<Type> &slots, size_t index)
+	{
+		if(slots.size() <= index)
+			slots.resize(index + 1);
+		return slots[index];
+	}
+}
+
+
+
+Information::Key::Key(const string &name)
+{
+	if(name.empty())
+		return;
+
+	lock_guard<mutex> lock(registryMutex);
+	unordered_map<string, int> &registry = Registry();
+	index = registry.emplace(name, registry.size()).first->second;
+}
+
+
+
+void Information::SetSprite(Key key, const Sprite *sprite, const Point &unit, float frame)
+{
+	if(key.IsEmpty())
+		return;
+
+	SpriteSlot &slot = Slot(sprites, key.index);
+	slot.sprite = sprite;
+	slot.unit = unit;
+	slot.frame = frame;
+	slot.isSet = true;
+}
+
+
+
 void Information::SetSprite(const string &name, const Sprite *sprite, const Point &unit, float frame)
 {
-	sprites[name] = sprite;
-	spriteUnits[name] = unit;
-	spriteFrames[name] = frame;
+	SetSprite(Key(name), sprite, unit, frame);
 }
 
 
 
-const Sprite *Information::GetSprite(const string &name) const
+const Sprite *Information::GetSprite(Key key) const
 {
 	static const Sprite empty;
 
-	auto it = sprites.find(name);
-	return (it == sprites.end()) ? &empty : it->second;
+	if(key.IsEmpty() || static_cast<size_t>(key.index) >= sprites.size() || !sprites[key.index].isSet)
+		return &empty;
+	return sprites[key.index].sprite;
 }
 
 
 
-const Point &Information::GetSpriteUnit(const string &name) const
+const Sprite *Information::GetSprite(const string &name) const
+{
+	return GetSprite(Key(name));
+}
+
+
+
+const Point &Information::GetSpriteUnit(Key key) const
 {
 	static const Point up(0., -1.);
 
-	auto it = spriteUnits.find(name);
-	return (it == spriteUnits.end()) ? up : it->second;
+	if(key.IsEmpty() || static_cast<size_t>(key.index) >= sprites.size())
+		return up;
+	return sprites[key.index].unit;
+}
+
+
+
+const Point &Information::GetSpriteUnit(const string &name) const
+{
+	return GetSpriteUnit(Key(name));
+}
+
+
+
+float Information::GetSpriteFrame(Key key) const
+{
+	if(key.IsEmpty() || static_cast<size_t>(key.index) >= sprites.size())
+		return 0.f;
+	return sprites[key.index].frame;
 }
 
 
 
 float Information::GetSpriteFrame(const string &name) const
 {
-	auto it = spriteFrames.find(name);
-	return (it == spriteFrames.end()) ? 0.f : it->second;
+	return GetSpriteFrame(Key(name));
+}
+
+
+
+void Information::SetString(Key key, const string &value)
+{
+	if(!key.IsEmpty())
+		Slot(strings, key.index) = value;
 }
 
 
 
 void Information::SetString(const string &name, const string &value)
 {
-	strings[name] = value;
+	SetString(Key(name), value);
 }
 
 
 
-const string &Information::GetString(const string &name) const
+const string &Information::GetString(Key key) const
 {
 	static const string empty;
 
-	auto it = strings.find(name);
-	return (it == strings.end()) ? empty : it->second;
+	if(key.IsEmpty() || static_cast<size_t>(key.index) >= strings.size())
+		return empty;
+	return strings[key.index];
+}
+
+
+
+const string &Information::GetString(const string &name) const
+{
+	return GetString(Key(name));
+}
+
+
+
+void Information::SetBar(Key key, double value, double segments)
+{
+	if(key.IsEmpty())
+		return;
+
+	BarSlot &slot = Slot(bars, key.index);
+	slot.value = value;
+	slot.segments = segments;
 }
 
 
 
 void Information::SetBar(const string &name, double value, double segments)
 {
-	bars[name] = value;
-	barSegments[name] = segments;
+	SetBar(Key(name), value, segments);
+}
+
+
+
+double Information::BarValue(Key key) const
+{
+	if(key.IsEmpty() || static_cast<size_t>(key.index) >= bars.size())
+		return 0.;
+	return bars[key.index].value;
 }
 
 
 
 double Information::BarValue(const string &name) const
 {
-	auto it = bars.find(name);
+	return BarValue(Key(name));
+}
+
 
-	return (it == bars.end()) ? 0. : it->second;
+
+double Information::BarSegments(Key key) const
+{
+	if(key.IsEmpty() || static_cast<size_t>(key.index) >= bars.size())
+		return 1.;
+	return bars[key.index].segments;
 }
 
 
 
 double Information::BarSegments(const string &name) const
 {
-	auto it = barSegments.find(name);
+	return BarSegments(Key(name));
+}
+
 
-	return (it == barSegments.end()) ? 1. : it->second;
+
+void Information::SetCondition(Key key)
+{
+	if(!key.IsEmpty())
+		Slot(conditions, key.index) = true;
 }
 
 
 
 void Information::SetCondition(const string &condition)
 {
-	conditions.insert(condition);
+	SetCondition(Key(condition));
+}
+
+
+
+bool Information::HasCondition(Key key) const
+{
+	if(key.IsEmpty())
+		return true;
+
+	return static_cast<size_t>(key.index) < conditions.size() && conditions[key.index];
 }
 
 
@@ -116,7 +248,7 @@ bool Information::HasCondition(const string &condition) const
 	if(condition.front() == '!')
 		return !HasCondition(condition.substr(1));
 
-	return conditions.count(condition);
+	return HasCondition(Key(condition));
 }
 
 
@@ -19,31 +19,61 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Color.h"
 #include "Point.h"
 
-#include <map>
-#include <set>
 #include <string>
+#include <vector>
 
 class Sprite;
 
 
 
 // Class representing information to be displayed in a user interface, independent
-// of how that information is laid out or shown.
+// of how that information is laid out or shown. Each piece of information is
+// named by a Key, which turns a name into an index once so that the values can
+// be kept in flat arrays; the versions of each function that take a string
+// look up the key for that name each time.
 class Information {
 public:
+	class Key {
+	public:
+		// An empty key names nothing, and is a condition that is always met.
+		Key() noexcept = default;
+		explicit Key(const std::string &name);
+
+		bool IsEmpty() const noexcept { return index < 0; }
+
+	private:
+		int index = -1;
+
+		friend class Information;
+	};
+
+
+public:
+	void SetSprite(Key key, const Sprite *sprite, const Point &unit = Point(0., -1.), float frame = 0.f);
 	void SetSprite(const std::string &name, const Sprite *sprite, const Point &unit = Point(0., -1.), float frame = 0.f);
+	const Sprite *GetSprite(Key key) const;
 	const Sprite *GetSprite(const std::string &name) const;
+	const Point &GetSpriteUnit(Key key) const;
 	const Point &GetSpriteUnit(const std::string &name) const;
+	float GetSpriteFrame(Key key) const;
 	float GetSpriteFrame(const std::string &name) const;
 
+	void SetString(Key key, const std::string &value);
 	void SetString(const std::string &name, const std::string &value);
+	const std::string &GetString(Key key) const;
 	const std::string &GetString(const std::string &name) const;
 
+	void SetBar(Key key, double value, double segments = 0.);
 	void SetBar(const std::string &name, double value, double segments = 0.);
+	double BarValue(Key key) const;
 	double BarValue(const std::string &name) const;
+	double BarSegments(Key key) const;
 	double BarSegments(const std::string &name) const;
 
+	void SetCondition(Key key);
 	void SetCondition(const std::string &condition);
+	bool HasCondition(Key key) const;
+	// A condition given by name may start with "!" to check that it is not set.
 	bool HasCondition(const std::string &condition) const;
 
 	void SetOutlineColor(const Color &color);
@@ -51,14 +81,28 @@ public:
 
 
 private:
-	std::map<std::string, const Sprite *> sprites;
-	std::map<std::string, Point> spriteUnits;
-	std::map<std::string, float> spriteFrames;
-	std::map<std::string, std::string> strings;
-	std::map<std::string, double> bars;
-	std::map<std::string, double> barSegments;
-
-	std::set<std::string> conditions;
+	class SpriteSlot {
+	public:
+		const Sprite *sprite = nullptr;
+		Point unit = Point(0., -1.);
+		float frame = 0.f;
+		bool isSet = false;
+	};
+
+	class BarSlot {
+	public:
+		double value = 0.;
+		double segments = 1.;
+	};
+
+
+private:
+	// Each of these is indexed by key, and only grows as far as the highest key
+	// that has been set. Anything past the end has its default value.
+	std::vector<SpriteSlot> sprites;
+	std::vector<std::string> strings;
+	std::vector<BarSlot> bars;
+	std::vector<bool> conditions;
 
 	Color outlineColor;
 };
@@ -0,0 +1,129 @@
+/* InputQueue.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "InputQueue.h"
+
+#include "GamePad.h"
+
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+	bool IsMotion(const SDL_Event &event)
+	{
+		return event.type == SDL_MOUSEMOTION || event.type == SDL_FINGERMOTION
+			|| event.type == SDL_CONTROLLERAXISMOTION;
+	}
+
+
+
+	// Whether both events are motion of the same finger, mouse or axis.
+	bool IsSameSource(const SDL_Event &first, const SDL_Event &second)
+	{
+		if(first.type != second.type)
+			return false;
+		if(first.type == SDL_MOUSEMOTION)
+			return first.motion.which == second.motion.which;
+		if(first.type == SDL_FINGERMOTION)
+			return first.tfinger.touchId == second.tfinger.touchId
+				&& first.tfinger.fingerId == second.tfinger.fingerId;
+		if(first.type == SDL_CONTROLLERAXISMOTION)
+			return first.caxis.which == second.caxis.which && first.caxis.axis == second.caxis.axis;
+		return false;
+	}
+
+
+
+	// Which range a game controller axis is in: resting, partly moved, or far
+	// enough to count as a button press.
+	int AxisRange(int value)
+	{
+		value = abs(value);
+		if(value < GamePad::DeadZone())
+			return 0;
+		return value > GamePad::AxisIsButtonPressThreshold() ? 2 : 1;
+	}
+}
+
+
+
+void InputQueue::Add(const SDL_Event &event)
+{
+	// A motion event may be merged into the last one for the same finger, mouse
+	// or axis, as long as only other motion events came between them.
+	if(IsMotion(event))
+		for(auto it = events.rbegin(); it != events.rend() && IsMotion(*it); ++it)
+			if(IsSameSource(*it, event))
+			{
+				if(Merge(*it, event))
+					return;
+				break;
+			}
+
+	events.push_back(event);
+}
+
+
+
+void InputQueue::Clear()
+{
+	events.clear();
+}
+
+
+
+const vector<SDL_Event> &InputQueue::Events() const
+{
+	return events;
+}
+
+
+
+bool InputQueue::Merge(SDL_Event &first, const SDL_Event &second)
+{
+	if(!IsSameSource(first, second))
+		return false;
+
+	if(first.type == SDL_MOUSEMOTION)
+	{
+		// Moving the mouse is different from dragging with it.
+		if(first.motion.state != second.motion.state)
+			return false;
+		int xrel = first.motion.xrel + second.motion.xrel;
+		int yrel = first.motion.yrel + second.motion.yrel;
+		first = second;
+		first.motion.xrel = xrel;
+		first.motion.yrel = yrel;
+		return true;
+	}
+	if(first.type == SDL_FINGERMOTION)
+	{
+		float dx = first.tfinger.dx + second.tfinger.dx;
+		float dy = first.tfinger.dy + second.tfinger.dy;
+		first = second;
+		first.tfinger.dx = dx;
+		first.tfinger.dy = dy;
+		return true;
+	}
+	if(first.type == SDL_CONTROLLERAXISMOTION)
+	{
+		if(AxisRange(first.caxis.value) != AxisRange(second.caxis.value))
+			return false;
+		first = second;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,53 @@
+/* InputQueue.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef INPUT_QUEUE_H_
+#define INPUT_QUEUE_H_
+
+#include <SDL2/SDL_events.h>
+
+#include <vector>
+
+
+
+// The input events received during one frame, in the order they arrived. When
+// a finger, the mouse or a game controller axis moves quickly, it may produce
+// dozens of motion events per frame, and each one would be handed to every
+// panel in turn. Only where it ended up matters, so motion events that follow
+// one another for the same finger, mouse or axis are merged as they are added.
+class InputQueue {
+public:
+	// Add an event, merging it into an earlier one if it only continues the
+	// same motion.
+	void Add(const SDL_Event &event);
+	void Clear();
+
+	const std::vector<SDL_Event> &Events() const;
+
+	// If the second event continues the motion of the first, merge it into the
+	// first and return true. Relative motion is added up, and everything else
+	// is taken from the second event. Game controller axes are only merged if
+	// they do not cross the thresholds where they start or stop acting as a
+	// button press.
+	static bool Merge(SDL_Event &first, const SDL_Event &second);
+
+
+private:
+	std::vector<SDL_Event> events;
+};
+
+
+
+#endif
@@ -62,6 +62,17 @@ namespace {
 		}
 		return alignment;
 	}
+
+	// Split off any leading "!" from a condition, returning whether the result
+	// should be negated.
+	bool BindCondition(const string &condition, Information::Key &key)
+	{
+		size_t start = condition.find_first_not_of('!');
+		if(start == string::npos)
+			start = condition.length();
+		key = Information::Key(condition.substr(start));
+		return start % 2;
+	}
 }
 
 
@@ -322,13 +333,13 @@ void Interface::Element::Load(const DataNode &node, const Point &globalAnchor)
 // button, it will add a clickable zone to the given panel.
 void Interface::Element::Draw(const Information &info, Panel *panel) const
 {
-	if(!info.HasCondition(visibleIf))
+	if(info.HasCondition(visibleIf) == visibleIfNot)
 		return;
 
 	// Get the bounding box of this element, relative to the anchor point.
 	Rectangle box = Bounds();
 	// Check if this element is active.
-	int state = info.HasCondition(activeIf);
+	int state = (info.HasCondition(activeIf) != activeIfNot);
 	// Check if the mouse is hovering over this element.
 	state += (state && box.Contains(UI::GetMouse()));
 	// Place buttons even if they are inactive, in case the UI wants to show a
@@ -350,8 +361,8 @@ void Interface::Element::Draw(const Information &info, Panel *panel) const
 // An empty string means it is always visible or active.
 void Interface::Element::SetConditions(const string &visible, const string &active)
 {
-	visibleIf = visible;
-	activeIf = active;
+	visibleIfNot = BindCondition(visible, visibleIf);
+	activeIfNot = BindCondition(active, activeIf);
 }
 
 
@@ -411,7 +422,7 @@ Interface::ImageElement::ImageElement(const DataNode &node, const Point &globalA
 	if(node.Token(0) == "sprite")
 		sprite[Element::ACTIVE] = SpriteSet::Get(node.Token(1));
 	else
-		name = node.Token(1);
+		name = Information::Key(node.Token(1));
 
 	// This function will call ParseLine() for any line it does not recognize.
 	Load(node, globalAnchor);
@@ -434,9 +445,9 @@ bool Interface::ImageElement::ParseLine(const DataNode &node)
 {
 	// The "inactive" and "hover" sprite only applies to non-dynamic images.
 	// The "colored" tag only applies to outlines.
-	if(node.Token(0) == "inactive" && node.Size() >= 2 && name.empty())
+	if(node.Token(0) == "inactive" && node.Size() >= 2 && name.IsEmpty())
 		sprite[Element::INACTIVE] = SpriteSet::Get(node.Token(1));
-	else if(node.Token(0) == "hover" && node.Size() >= 2 && name.empty())
+	else if(node.Token(0) == "hover" && node.Size() >= 2 && name.IsEmpty())
 		sprite[Element::HOVER] = SpriteSet::Get(node.Token(1));
 	else if(isOutline && node.Token(0) == "colored")
 		isColored = true;
@@ -481,7 +492,7 @@ void Interface::ImageElement::Draw(const Rectangle &rect, const Information &inf
 	{
 		Color color = (isColored ? info.GetOutlineColor() : Color(1.f, 1.f));
 		Point unit = info.GetSpriteUnit(name);
-		OutlineShader::Draw(sprite, rect.Center(), rect.Dimensions(), color, unit, frame);
+		OutlineShader::DrawCached(sprite, rect.Center(), rect.Dimensions(), color, unit, frame);
 	}
 	else
 		SpriteShader::Draw(sprite, rect.Center(), rect.Width() / sprite->Width(), 0, frame);
@@ -491,7 +502,7 @@ void Interface::ImageElement::Draw(const Rectangle &rect, const Information &inf
 
 const Sprite *Interface::ImageElement::GetSprite(const Information &info, int state) const
 {
-	return name.empty() ? sprite[state] : info.GetSprite(name);
+	return name.IsEmpty() ? sprite[state] : info.GetSprite(name);
 }
 
 
@@ -523,6 +534,8 @@ Interface::TextElement::TextElement(const DataNode &node, const Point &globalAnc
 	}
 	else
 		str = node.Token(1);
+	if(isDynamic)
+		key = Information::Key(str);
 
 	// This function will call ParseLine() for any line it does not recognize.
 	Load(node, globalAnchor);
@@ -645,7 +658,7 @@ void Interface::TextElement::Place(const Rectangle &bounds, Panel *panel) const
 
 string Interface::TextElement::GetString(const Information &info) const
 {
-	return isDynamic ? info.GetString(str) : str;
+	return isDynamic ? info.GetString(key) : str;
 }
 
 
@@ -659,7 +672,7 @@ Interface::BarElement::BarElement(const DataNode &node, const Point &globalAncho
 		return;
 
 	// Get the name of the element and find out what type it is (bar or ring).
-	name = node.Token(1);
+	name = Information::Key(node.Token(1));
 	isRing = (node.Token(0) == "ring");
 
 	// This function will call ParseLine() for any line it does not recognize.
@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Color.h"
 #include "Command.h"
+#include "Information.h"
 #include "Point.h"
 #include "Rectangle.h"
 #include "text/truncate.hpp"
@@ -27,7 +28,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <vector>
 
 class DataNode;
-class Information;
 class Panel;
 class Sprite;
 
@@ -105,6 +105,8 @@ private:
 			padding = o.padding;
 			visibleIf = o.visibleIf;
 			activeIf = o.activeIf;
+			visibleIfNot = o.visibleIfNot;
+			activeIfNot = o.activeIfNot;
 		}
 
 	protected:
@@ -124,8 +126,12 @@ private:
 		AnchoredPoint to;
 		Point alignment;
 		Point padding;
-		std::string visibleIf;
-		std::string activeIf;
+		// The conditions are stored without any leading "!", which is instead
+		// recorded in these flags, so drawing does not have to strip it.
+		Information::Key visibleIf;
+		Information::Key activeIf;
+		bool visibleIfNot = false;
+		bool activeIfNot = false;
 		float radius = 0;
 	};
 
@@ -148,7 +154,7 @@ private:
 
 	private:
 		// If a name is given, look up the sprite with that name and draw it.
-		std::string name;
+		Information::Key name;
 		// Otherwise, draw a sprite. Which sprite is drawn depends on the current
 		// state of this element: inactive, active, or hover.
 		const Sprite *sprite[3] = {nullptr, nullptr, nullptr};
@@ -182,6 +188,7 @@ private:
 	private:
 		// The string may either be a name of a dynamic string, or static text.
 		std::string str;
+		Information::Key key;
 		// Color for inactive, active, and hover states.
 		const Color *color[3] = {nullptr, nullptr, nullptr};
 		int fontSize = 14;
@@ -204,7 +211,7 @@ private:
 		virtual void Draw(const Rectangle &rect, const Information &info, int state) const override;
 
 	private:
-		std::string name;
+		Information::Key name;
 		const Color *color = nullptr;
 		float width = 2.f;
 		bool isRing = false;
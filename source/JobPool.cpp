@@ -0,0 +1,172 @@
+/* JobPool.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "JobPool.h"
+
+#include "ThreadPlacement.h"
+
+using namespace std;
+
+
+
+JobPool::JobPool(unsigned threadCount)
+{
+	for(unsigned i = 0; i <= threadCount; ++i)
+		slices.emplace_back(new Slice);
+	for(unsigned i = 0; i < threadCount; ++i)
+		threads.emplace_back(&JobPool::ThreadEntryPoint, this, i + 1);
+}
+
+
+
+JobPool::~JobPool()
+{
+	{
+		lock_guard<mutex> lock(wakeMutex);
+		terminate = true;
+	}
+	wakeCondition.notify_all();
+	for(thread &t : threads)
+		t.join();
+}
+
+
+
+unsigned JobPool::Concurrency() const
+{
+	return threads.size() + 1;
+}
+
+
+
+void JobPool::ParallelFor(size_t count, const function<void(size_t)> &job)
+{
+	// Small batches are not worth waking up the other threads for.
+	if(threads.empty() || count < 2)
+	{
+		for(size_t i = 0; i < count; ++i)
+			job(i);
+		return;
+	}
+
+	// Give each worker an equal, contiguous share of the jobs.
+	const size_t workers = slices.size();
+	for(size_t i = 0; i < workers; ++i)
+	{
+		lock_guard<mutex> lock(slices[i]->mutex);
+		slices[i]->begin = (count * i) / workers;
+		slices[i]->end = (count * (i + 1)) / workers;
+	}
+
+	{
+		lock_guard<mutex> lock(wakeMutex);
+		current = &job;
+		busy = threads.size();
+		++generation;
+	}
+	wakeCondition.notify_all();
+
+	Work(0);
+
+	unique_lock<mutex> lock(wakeMutex);
+	doneCondition.wait(lock, [this]{ return !busy; });
+	current = nullptr;
+}
+
+
+
+unsigned JobPool::DefaultThreadCount()
+{
+	return ThreadPlacement::WorkerCount();
+}
+
+
+
+void JobPool::ThreadEntryPoint(unsigned index)
+{
+	ThreadPlacement::Assign(ThreadPlacement::Role::WORKER);
+
+	unsigned seen = 0;
+	unique_lock<mutex> lock(wakeMutex);
+	while(true)
+	{
+		wakeCondition.wait(lock, [this, seen]{ return terminate || generation != seen; });
+		if(terminate)
+			break;
+		seen = generation;
+
+		lock.unlock();
+		Work(index);
+		lock.lock();
+
+		if(!--busy)
+			doneCondition.notify_one();
+	}
+}
+
+
+
+void JobPool::Work(unsigned index)
+{
+	size_t job = 0;
+	while(Take(index, job) || Steal(index, job))
+		(*current)(job);
+}
+
+
+
+// Take the next job from the front of this worker's own slice.
+bool JobPool::Take(unsigned index, size_t &job)
+{
+	Slice &slice = *slices[index];
+	lock_guard<mutex> lock(slice.mutex);
+	if(slice.begin == slice.end)
+		return false;
+
+	job = slice.begin++;
+	return true;
+}
+
+
+
+// Take the back half of some other worker's slice, keeping the first of the
+// stolen jobs to run now and adding the rest to this worker's own slice.
+bool JobPool::Steal(unsigned index, size_t &job)
+{
+	const size_t workers = slices.size();
+	for(size_t offset = 1; offset < workers; ++offset)
+	{
+		size_t begin = 0;
+		size_t end = 0;
+		{
+			Slice &victim = *slices[(index + offset) % workers];
+			lock_guard<mutex> lock(victim.mutex);
+			if(victim.begin == victim.end)
+				continue;
+
+			end = victim.end;
+			begin = end - (end - victim.begin + 1) / 2;
+			victim.end = begin;
+		}
+
+		job = begin;
+		Slice &slice = *slices[index];
+		lock_guard<mutex> lock(slice.mutex);
+		slice.begin = begin + 1;
+		slice.end = end;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,99 @@
+/* JobPool.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOB_POOL_H_
+#define JOB_POOL_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+// A small pool of persistent worker threads used to split per-frame work (such
+// as stepping every ship) across all available cores. Each call to ParallelFor()
+// hands every worker a contiguous slice of the job indices; a worker that runs
+// out of work steals half of the remaining slice of another worker, so uneven
+// jobs still keep all the cores busy. The calling thread takes part in the work
+// and ParallelFor() does not return until every job has finished.
+class JobPool {
+public:
+	// Create a pool with the given number of background threads. With zero
+	// threads, every job runs on the calling thread.
+	explicit JobPool(unsigned threadCount);
+	~JobPool();
+
+	// No moving or copying this class.
+	JobPool(const JobPool &other) = delete;
+	JobPool(JobPool &&other) = delete;
+	JobPool &operator=(const JobPool &other) = delete;
+	JobPool &operator=(JobPool &&other) = delete;
+
+	// The number of threads that can run jobs at once, including the caller.
+	unsigned Concurrency() const;
+	// Call the given function once for each index in [0, count). Jobs may run
+	// in any order and on any thread, so any output they produce must be kept
+	// separate per index if the result needs to be deterministic.
+	void ParallelFor(size_t count, const std::function<void(size_t)> &job);
+
+	// The default number of background threads: one for each core that is not
+	// already occupied by the main thread or the thread calling ParallelFor(),
+	// not counting the efficiency cores that are left for loading.
+	static unsigned DefaultThreadCount();
+
+
+private:
+	// The range of job indices a single worker has left to do.
+	class Slice {
+	public:
+		std::mutex mutex;
+		size_t begin = 0;
+		size_t end = 0;
+	};
+
+
+private:
+	void ThreadEntryPoint(unsigned index);
+	// Run jobs from this worker's own slice, then steal from the others.
+	void Work(unsigned index);
+	bool Take(unsigned index, size_t &job);
+	bool Steal(unsigned index, size_t &job);
+
+
+private:
+	std::vector<std::thread> threads;
+	// One slice per worker; the calling thread always uses slice 0.
+	std::vector<std::unique_ptr<Slice>> slices;
+
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+	std::condition_variable doneCondition;
+	// Incremented each time a new batch of jobs is started.
+	unsigned generation = 0;
+	// The number of background threads still working on the current batch.
+	unsigned busy = 0;
+	bool terminate = false;
+
+	// The jobs being run by the current batch.
+	const std::function<void(size_t)> *current = nullptr;
+};
+
+
+
+#endif
@@ -2,9 +2,25 @@
 
 #include "opengl.h"
 
+#include <atomic>
 #include <cstdint>
 #include <cstring>
 
+namespace
+{
+	// These are not defined by every version of the OpenGL headers.
+	const uint32_t COMPRESSED_RGBA_BPTC_UNORM = 0x8E8C;
+	const uint32_t COMPRESSED_SRGB_ALPHA_BPTC_UNORM = 0x8E8D;
+	// The ASTC formats are numbered consecutively by block size, from 4x4 to 12x12.
+	const uint32_t COMPRESSED_RGBA_ASTC_4x4 = 0x93B0;
+	const uint32_t COMPRESSED_RGBA_ASTC_12x12 = 0x93BD;
+	const uint32_t COMPRESSED_SRGB8_ALPHA8_ASTC_4x4 = 0x93D0;
+	const uint32_t COMPRESSED_SRGB8_ALPHA8_ASTC_12x12 = 0x93DD;
+
+	std::atomic<bool> hasAstc(false);
+	std::atomic<bool> hasBc7(false);
+}
+
 struct ktx_header
 {
 	uint8_t     magic[12];
@@ -23,12 +39,12 @@ struct ktx_header
 	uint32_t    key_value_data;
 };
 
-KtxFile::KtxFile(const std::string& data)
+KtxFile::KtxFile(const char* data, size_t size)
 {
-	if (data.size() < sizeof(ktx_header))
+	if (size < sizeof(ktx_header))
 		return;
 
-	const ktx_header* header = reinterpret_cast<const ktx_header*>(data.data());
+	const ktx_header* header = reinterpret_cast<const ktx_header*>(data);
 
 	static const uint8_t ktx_identifier[] = {
 		0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
@@ -46,15 +62,9 @@ KtxFile::KtxFile(const std::string& data)
 	if (header->format != 0) return;
 
 	// internal format is the argument passed to glCompressedTexImage. Only
-	// allow ETC2 compression here (its support is required by gles 3)
-	switch(header->internal_format)
-	{
-	case GL_COMPRESSED_RGB8_ETC2:
-	case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
-	case GL_COMPRESSED_RGBA8_ETC2_EAC:
-		break;
-	default: return;
-	}
+	// allow formats that the graphics driver can use.
+	if (!IsSupported(header->internal_format))
+		return;
 
 	// only allow RGB/RGBA here
 	switch (header->base_internal_format)
@@ -73,9 +83,9 @@ KtxFile::KtxFile(const std::string& data)
 	// Do support arrays, as this is how we handle animation frames.
 
 	// Validate that we have as much data as it claims we do.
-	ssize_t remaining_size = data.size() - sizeof(ktx_header) - header->key_value_data;
+	ssize_t remaining_size = size - sizeof(ktx_header) - header->key_value_data;
 	if (remaining_size < static_cast<ssize_t>(sizeof(uint32_t))) return;
-	uint32_t image_size = *reinterpret_cast<const uint32_t*>(data.data() + sizeof(ktx_header) + header->key_value_data);
+	uint32_t image_size = *reinterpret_cast<const uint32_t*>(data + sizeof(ktx_header) + header->key_value_data);
 	if (remaining_size - image_size < 0) return;
 
 	// Default original_width/original_height, which may be overridden by the
@@ -84,7 +94,7 @@ KtxFile::KtxFile(const std::string& data)
 	original_height = header->height;
 
 	// process key/value pairs
-	const char* p = data.data() + sizeof(ktx_header);
+	const char* p = data + sizeof(ktx_header);
 	const char* pend = p + header->key_value_data;
 	while (p + sizeof(uint32_t) < pend)
 	{
@@ -167,4 +177,47 @@ const void* KtxFile::Data() const
 	p += header->key_value_data;
 	p += sizeof(uint32_t);
 	return p;
-}
\ No newline at end of file
+}
+
+
+
+void KtxFile::SetSupportedFormats(bool astc, bool bc7)
+{
+	hasAstc = astc;
+	hasBc7 = bc7;
+}
+
+bool KtxFile::HasAstcSupport()
+{
+	return hasAstc;
+}
+
+bool KtxFile::HasBc7Support()
+{
+	return hasBc7;
+}
+
+bool KtxFile::IsSupported(uint32_t internal_format)
+{
+	switch(internal_format)
+	{
+	case GL_COMPRESSED_RGB8_ETC2:
+	case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+	case GL_COMPRESSED_RGBA8_ETC2_EAC:
+		return true;
+	default:
+		return (IsAstc(internal_format) && hasAstc) || (IsBc7(internal_format) && hasBc7);
+	}
+}
+
+bool KtxFile::IsAstc(uint32_t internal_format)
+{
+	return (internal_format >= COMPRESSED_RGBA_ASTC_4x4 && internal_format <= COMPRESSED_RGBA_ASTC_12x12)
+		|| (internal_format >= COMPRESSED_SRGB8_ALPHA8_ASTC_4x4
+			&& internal_format <= COMPRESSED_SRGB8_ALPHA8_ASTC_12x12);
+}
+
+bool KtxFile::IsBc7(uint32_t internal_format)
+{
+	return internal_format == COMPRESSED_RGBA_BPTC_UNORM || internal_format == COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+}
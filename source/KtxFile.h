@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 /**
@@ -7,7 +9,9 @@
 class KtxFile
 {
 public:
-	KtxFile(const std::string& src_data);
+	// The file's contents must stay valid for as long as this object is used,
+	// because the image data is not copied.
+	KtxFile(const char* src_data, size_t src_size);
 
 	bool Valid() const { return header != nullptr; }
 
@@ -21,6 +25,16 @@ public:
 
 	const void* Data() const;
 
+	// ETC2 is always accepted, because OpenGL ES 3 requires it. ASTC and BC7
+	// files are only accepted once the graphics driver has been found to
+	// support them; until then, and on drivers that don't, they are rejected.
+	static void SetSupportedFormats(bool astc, bool bc7);
+	static bool HasAstcSupport();
+	static bool HasBc7Support();
+	static bool IsSupported(uint32_t internal_format);
+	static bool IsAstc(uint32_t internal_format);
+	static bool IsBc7(uint32_t internal_format);
+
 private:
 	const struct ktx_header* header = nullptr;
 	uint32_t original_width = 0;
@@ -20,7 +20,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Screen.h"
 #include "Shader.h"
 
+#include "opengl.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 
 using namespace std;
 
@@ -34,6 +40,71 @@ namespace {
 
 	GLuint vao;
 	GLuint vbo;
+
+	// When it is available, a batch of lines is drawn with a single instanced
+	// draw call, reading the values above from a buffer with one Item per line.
+	bool useInstancing = false;
+	Shader instancedShader;
+	GLint instancedScaleI;
+	GLint instancedOffsetI;
+	GLuint instancedVao;
+	GLuint instanceVbo;
+
+
+	// Generate the code for the fragment shader.
+	string FragmentCode(bool isInstanced)
+	{
+		ostringstream fragmentCodeStream;
+		fragmentCodeStream <<
+			"// fragment line shader\n"
+			"precision mediump float;\n"
+			<< (isInstanced ? "flat in " : "uniform ") << "vec4 color;\n"
+
+			"in vec2 tpos;\n"
+			"in float tscale;\n"
+			"out vec4 finalColor;\n"
+
+			"void main() {\n"
+			"  float alpha = min(tscale - abs(tpos.x * (2.f * tscale) - tscale), 1.f - abs(tpos.y));\n"
+			"  finalColor = color * alpha;\n"
+			"}\n";
+		return fragmentCodeStream.str();
+	}
+
+
+
+	// Draw one line with the non-instanced shader, which must be bound.
+	void DrawItem(const LineShader::Item &item)
+	{
+		glUniform2fv(startI, 1, item.start);
+		glUniform2fv(lengthI, 1, item.length);
+		glUniform2fv(widthI, 1, item.width);
+		glUniform4fv(colorI, 1, item.color);
+
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+
+
+
+	void Bind()
+	{
+		if(!shader.Object())
+			throw runtime_error("LineShader: Draw() called before Init().");
+
+		OpenGL::UseProgram(shader.Object());
+		OpenGL::BindVertexArray(vao);
+
+		GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+		glUniform2fv(scaleI, 1, scale);
+	}
+
+
+
+	void Unbind()
+	{
+		// The program and vertex array are left bound, so that drawing with
+		// this shader again does not need to bind them again.
+	}
 }
 
 
@@ -57,21 +128,7 @@ void LineShader::Init()
 		"  gl_Position = vec4((start + vert.x * len + vert.y * width) * scale, 0, 1);\n"
 		"}\n";
 
-	static const char *fragmentCode =
-		"// fragment line shader\n"
-		"precision mediump float;\n"
-		"uniform vec4 color;\n"
-
-		"in vec2 tpos;\n"
-		"in float tscale;\n"
-		"out vec4 finalColor;\n"
-
-		"void main() {\n"
-		"  float alpha = min(tscale - abs(tpos.x * (2.f * tscale) - tscale), 1.f - abs(tpos.y));\n"
-		"  finalColor = color * alpha;\n"
-		"}\n";
-
-	shader = Shader(vertexCode, fragmentCode);
+	shader = Shader(vertexCode, FragmentCode(false).c_str());
 	scaleI = shader.Uniform("scale");
 	startI = shader.Uniform("start");
 	lengthI = shader.Uniform("len");
@@ -80,7 +137,7 @@ void LineShader::Init()
 
 	// Generate the vertex data for drawing sprites.
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -98,37 +155,131 @@ void LineShader::Init()
 
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
+
+	useInstancing = OpenGL::HasInstancingSupport();
+	if(!useInstancing)
+		return;
+
+	static const char *instancedVertexCode =
+		"// vertex instanced line shader\n"
+		"uniform vec2 scale;\n"
+		"uniform vec2 offset;\n"
+
+		"in vec2 vert;\n"
+		"in vec2 instanceStart;\n"
+		"in vec2 instanceLength;\n"
+		"in vec2 instanceWidth;\n"
+		"in vec4 instanceColor;\n"
+		"out vec2 tpos;\n"
+		"out float tscale;\n"
+		"flat out vec4 color;\n"
+
+		"void main() {\n"
+		"  tpos = vert;\n"
+		"  tscale = length(instanceLength);\n"
+		"  color = instanceColor;\n"
+		"  vec2 position = offset + instanceStart + vert.x * instanceLength + vert.y * instanceWidth;\n"
+		"  gl_Position = vec4(position * scale, 0, 1);\n"
+		"}\n";
+
+	instancedShader = Shader(instancedVertexCode, FragmentCode(true).c_str());
+	instancedScaleI = instancedShader.Uniform("scale");
+	instancedOffsetI = instancedShader.Uniform("offset");
+
+	glGenVertexArrays(1, &instancedVao);
+	OpenGL::BindVertexArray(instancedVao);
+
+	// The corners of each line come from the same buffer as above.
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glEnableVertexAttribArray(instancedShader.Attrib("vert"));
+	glVertexAttribPointer(instancedShader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+	// Everything else comes from the instance buffer.
+	glGenBuffers(1, &instanceVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	auto Attribute = [](const char *name, GLint size, size_t offset)
+	{
+		GLuint attribute = instancedShader.Attrib(name);
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribPointer(attribute, size, GL_FLOAT, GL_FALSE, sizeof(LineShader::Item),
+			reinterpret_cast<const GLvoid *>(offset));
+		glVertexAttribDivisor(attribute, 1);
+	};
+	Attribute("instanceStart", 2, offsetof(Item, start));
+	Attribute("instanceLength", 2, offsetof(Item, length));
+	Attribute("instanceWidth", 2, offsetof(Item, width));
+	Attribute("instanceColor", 4, offsetof(Item, color));
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	OpenGL::BindVertexArray(0);
 }
 
 
 
 void LineShader::Draw(const Point &from, const Point &to, float width, const Color &color)
 {
-	if(!shader.Object())
-		throw runtime_error("LineShader: Draw() called before Init().");
+	Bind();
+	DrawItem(MakeItem(from, to, width, color));
+	Unbind();
+}
 
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
 
-	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
 
-	GLfloat start[2] = {static_cast<float>(from.X()), static_cast<float>(from.Y())};
-	glUniform2fv(startI, 1, start);
+LineShader::Item LineShader::MakeItem(const Point &from, const Point &to, float width, const Color &color)
+{
+	Item item;
+	item.start[0] = from.X();
+	item.start[1] = from.Y();
 
 	Point v = to - from;
 	Point u = v.Unit() * width;
-	GLfloat length[2] = {static_cast<float>(v.X()), static_cast<float>(v.Y())};
-	glUniform2fv(lengthI, 1, length);
+	item.length[0] = v.X();
+	item.length[1] = v.Y();
+	item.width[0] = u.Y();
+	item.width[1] = -u.X();
+
+	const float *rgba = color.Get();
+	copy(rgba, rgba + 4, item.color);
+	return item;
+}
 
-	GLfloat w[2] = {static_cast<float>(u.Y()), static_cast<float>(-u.X())};
-	glUniform2fv(widthI, 1, w);
 
-	glUniform4fv(colorI, 1, color.Get());
 
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+void LineShader::Draw(const vector<Item> &items)
+{
+	Draw(items, Point());
+}
+
+
+
+void LineShader::Draw(const vector<Item> &items, const Point &offset)
+{
+	if(items.empty())
+		return;
+	if(!useInstancing)
+	{
+		Bind();
+		for(Item item : items)
+		{
+			item.start[0] += offset.X();
+			item.start[1] += offset.Y();
+			DrawItem(item);
+		}
+		Unbind();
+		return;
+	}
+
+	OpenGL::UseProgram(instancedShader.Object());
+	OpenGL::BindVertexArray(instancedVao);
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(instancedScaleI, 1, scale);
+	GLfloat shift[2] = {static_cast<float>(offset.X()), static_cast<float>(offset.Y())};
+	glUniform2fv(instancedOffsetI, 1, shift);
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, items.size() * sizeof(Item), items.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-	glBindVertexArray(0);
-	glUseProgram(0);
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, items.size());
 }
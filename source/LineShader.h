@@ -16,6 +16,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef LINE_SHADER_H_
 #define LINE_SHADER_H_
 
+#include <vector>
+
 class Color;
 class Point;
 
@@ -24,9 +26,29 @@ class Point;
 // Class to be used for drawing lines. The sides of a line are anti-aliased, but
 // the start and end of the line are not.
 class LineShader {
+public:
+	// One line to be drawn as part of a batch.
+	class Item {
+	public:
+		float start[2];
+		// The vector from the start to the end of the line, and the vector from
+		// its center to one side.
+		float length[2];
+		float width[2];
+		float color[4];
+	};
+
+
 public:
 	static void Init();
 	static void Draw(const Point &from, const Point &to, float width, const Color &color);
+
+	// Make an item that draws what the Draw() function above would.
+	static Item MakeItem(const Point &from, const Point &to, float width, const Color &color);
+	// Draw all the given lines, moved by the given offset. If instancing is
+	// available, this takes only a single draw call.
+	static void Draw(const std::vector<Item> &items);
+	static void Draw(const std::vector<Item> &items, const Point &offset);
 };
 
 
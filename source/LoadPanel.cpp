@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Color.h"
 #include "Command.h"
+#include "Compression.h"
 #include "ConversationPanel.h"
 #include "DataFile.h"
 #include "Dialog.h"
@@ -35,6 +36,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PlayerInfo.h"
 #include "Preferences.h"
 #include "Rectangle.h"
+#include "SaveQueue.h"
 #include "ShipyardPanel.h"
 #include "StarField.h"
 #include "StartConditionsPanel.h"
@@ -274,6 +276,9 @@ bool LoadPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 		SDL_Log("Export");
 		std::string path = Files::Saves() + selectedFile;
 		std::string data = Files::Read(path);
+		// Exported pilots are always plain text, so that they can be edited.
+		if(Compression::IsCompressed(data))
+			data = Compression::Decompress(data);
 
 		AndroidFile f;
 		f.SaveFile(selectedPilot + "_exported.txt", data);
@@ -477,6 +482,8 @@ bool LoadPanel::Scroll(double dx, double dy)
 
 void LoadPanel::UpdateLists()
 {
+	// Make sure that every saved game has been completely written.
+	SaveQueue::Wait();
 	files.clear();
 
 	vector<string> fileList = Files::List(Files::Saves());
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "LocationFilter.h"
 
+#include "Bitset.h"
 #include "CategoryList.h"
 #include "CategoryTypes.h"
 #include "DataNode.h"
@@ -24,12 +25,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Government.h"
 #include "Planet.h"
 #include "Random.h"
+#include "RouteCache.h"
 #include "Ship.h"
 #include "StellarObject.h"
 #include "System.h"
 
 #include <algorithm>
 #include <mutex>
+#include <unordered_map>
 
 using namespace std;
 
@@ -73,37 +76,10 @@ namespace {
 	// Check if the given system is within the given distance of the center.
 	int Distance(const System *center, const System *system, int maximum, DistanceCalculationSettings distanceSettings)
 	{
-		// This function should only ever be called from the main thread, but
-		// just to be sure, use mutex protection on the static locals.
-		static mutex distanceMutex;
-		lock_guard<mutex> lock(distanceMutex);
-
-		static const System *previousCenter = center;
-		static DistanceMap distance(
-			center,
-			distanceSettings.WormholeStrat(),
-			distanceSettings.AssumesJumpDrive(),
-			-1,
-			maximum
-		);
-		static int previousMaximum = maximum;
-		static DistanceCalculationSettings previousDistanceSettings = distanceSettings;
-
-		if(center != previousCenter || maximum > previousMaximum || distanceSettings != previousDistanceSettings)
-		{
-			previousCenter = center;
-			previousMaximum = maximum;
-			previousDistanceSettings = distanceSettings;
-			distance = DistanceMap(
-				center,
-				distanceSettings.WormholeStrat(),
-				distanceSettings.AssumesJumpDrive(),
-				-1,
-				maximum
-			);
-		}
+		shared_ptr<const DistanceMap> distance = RouteCache::Get(center, distanceSettings.WormholeStrat(),
+			distanceSettings.AssumesJumpDrive(), -1, maximum);
 		// If the distance is greater than the maximum, this is not a match.
-		int d = distance.Days(system);
+		int d = distance->Days(system);
 		return (d > maximum) ? -1 : d;
 	}
 
@@ -156,10 +132,66 @@ namespace {
 
 		return false;
 	}
+
+	// The systems and planets of the universe as of one revision, numbered in
+	// the order that GameData iterates over them.
+	struct UniverseIndex {
+		uint64_t revision = 0;
+		vector<const System *> systems;
+		unordered_map<const System *, size_t> systemIndex;
+		vector<const Planet *> planets;
+		unordered_map<const Planet *, size_t> planetIndex;
+	};
+
+	// Get the index of the universe in its current state.
+	shared_ptr<const UniverseIndex> CurrentIndex()
+	{
+		static mutex indexMutex;
+		static shared_ptr<const UniverseIndex> current;
+		lock_guard<mutex> lock(indexMutex);
+
+		uint64_t revision = GameData::UniverseRevision();
+		if(current && current->revision == revision)
+			return current;
+
+		auto index = make_shared<UniverseIndex>();
+		index->revision = revision;
+		for(const auto &it : GameData::Systems())
+		{
+			index->systemIndex.emplace(&it.second, index->systems.size());
+			index->systems.push_back(&it.second);
+		}
+		for(const auto &it : GameData::Planets())
+		{
+			index->planetIndex.emplace(&it.second, index->planets.size());
+			index->planets.push_back(&it.second);
+		}
+		current = std::move(index);
+		return current;
+	}
 }
 
 
 
+// Which systems and planets of an indexed universe a filter matches.
+class LocationFilter::CachedMatches {
+public:
+	shared_ptr<const UniverseIndex> index;
+	Bitset systems;
+	Bitset planets;
+};
+
+
+
+// The most recently recorded matches of a filter, shared by its copies.
+class LocationFilter::MatchCache {
+public:
+	mutex matchesMutex;
+	shared_ptr<const CachedMatches> matches;
+};
+
+
+
 // Construct and Load() at the same time.
 LocationFilter::LocationFilter(const DataNode &node)
 {
@@ -192,6 +224,10 @@ void LocationFilter::Load(const DataNode &node)
 	isEmpty = planets.empty() && attributes.empty() && systems.empty() && governments.empty()
 		&& !center && originMaxDistance < 0 && notFilters.empty() && neighborFilters.empty()
 		&& outfits.empty() && shipCategory.empty();
+
+	// Anything recorded before this filter changed no longer applies.
+	subFiltersUseOrigin = SubFiltersUseOrigin();
+	cache = make_shared<MatchCache>();
 }
 
 
@@ -289,6 +325,20 @@ bool LocationFilter::IsEmpty() const
 // Check if all of this filter's named content is invalid (e.g. its known members only
 // match to content that is currently unavailable). If at least one valid parameter
 // from every restriction is valid, then this filter is valid.
+const set<const Planet *> &LocationFilter::Planets() const
+{
+	return planets;
+}
+
+
+
+const set<const System *> &LocationFilter::Systems() const
+{
+	return systems;
+}
+
+
+
 bool LocationFilter::IsValid() const
 {
 	if(IsEmpty())
@@ -335,32 +385,14 @@ bool LocationFilter::IsValid() const
 // If the player is in the given system, does this filter match?
 bool LocationFilter::Matches(const Planet *planet, const System *origin) const
 {
-	if(!planet || !planet->IsValid())
-		return false;
-
-	// If a ship class was given, do not match planets.
-	if(!shipCategory.empty())
-		return false;
-
-	if(!governments.empty() && !governments.count(planet->GetGovernment()))
-		return false;
-
-	if(!planets.empty() && !planets.count(planet))
-		return false;
-	for(const set<string> &attr : attributes)
-		if(!SetsIntersect(attr, planet->Attributes()))
-			return false;
-
-	for(const LocationFilter &filter : notFilters)
-		if(filter.Matches(planet, origin))
-			return false;
-
-	// If outfits are specified, make sure they can be bought here.
-	for(const set<const Outfit *> &outfitList : outfits)
-		if(!SetsIntersect(outfitList, planet->Outfitter()))
-			return false;
-
-	return Matches(planet->GetSystem(), origin, true);
+	shared_ptr<const CachedMatches> matches = GetMatches(origin, false);
+	if(matches)
+	{
+		auto it = matches->index->planetIndex.find(planet);
+		if(it != matches->index->planetIndex.end())
+			return matches->planets.Test(it->second) && IsNearOrigin(planet->GetSystem(), origin);
+	}
+	return MatchesPlanet(planet, origin);
 }
 
 
@@ -371,6 +403,13 @@ bool LocationFilter::Matches(const System *system, const System *origin) const
 	if(!shipCategory.empty())
 		return false;
 
+	shared_ptr<const CachedMatches> matches = GetMatches(origin, false);
+	if(matches)
+	{
+		auto it = matches->index->systemIndex.find(system);
+		if(it != matches->index->systemIndex.end())
+			return matches->systems.Test(it->second) && IsNearOrigin(system, origin);
+	}
 	return Matches(system, origin, false);
 }
 
@@ -456,6 +495,8 @@ LocationFilter LocationFilter::SetOrigin(const System *origin) const
 	result.originMinDistance = 0;
 	result.originMaxDistance = -1;
 	result.originDistanceOptions = DistanceCalculationSettings{};
+	// The converted filter matches a different set of systems.
+	result.cache = make_shared<MatchCache>();
 
 	return result;
 }
@@ -467,14 +508,27 @@ const System *LocationFilter::PickSystem(const System *origin) const
 {
 	// Find a planet that satisfies the filter.
 	vector<const System *> options;
-	for(const auto &it : GameData::Systems())
+	shared_ptr<const CachedMatches> matches = GetMatches(origin, true);
+	if(matches)
+	{
+		// Only the "distance" from the origin remains to be checked.
+		const vector<const System *> &systems = matches->index->systems;
+		const Bitset &found = matches->systems;
+		for(size_t i = found.FindNext(0); i < systems.size(); i = found.FindNext(i + 1))
+			if(!systems[i]->Inaccessible() && IsNearOrigin(systems[i], origin))
+				options.push_back(systems[i]);
+	}
+	else
 	{
-		const System &system = it.second;
-		// Skip systems with incomplete data or that are inaccessible.
-		if(!system.IsValid() || system.Inaccessible())
-			continue;
-		if(Matches(&system, origin))
-			options.push_back(&system);
+		for(const auto &it : GameData::Systems())
+		{
+			const System &system = it.second;
+			// Skip systems with incomplete data or that are inaccessible.
+			if(!system.IsValid() || system.Inaccessible())
+				continue;
+			if(Matches(&system, origin))
+				options.push_back(&system);
+		}
 	}
 	return options.empty() ? nullptr : options[Random::Int(options.size())];
 }
@@ -486,18 +540,38 @@ const Planet *LocationFilter::PickPlanet(const System *origin, bool hasClearance
 {
 	// Find a planet that satisfies the filter.
 	vector<const Planet *> options;
-	for(const auto &it : GameData::Planets())
+	shared_ptr<const CachedMatches> matches = GetMatches(origin, true);
+	if(matches)
 	{
-		const Planet &planet = it.second;
-		// Skip planets with incomplete data or which are from inaccessible systems.
-		if(!planet.IsValid() || (planet.GetSystem() && planet.GetSystem()->Inaccessible()))
-			continue;
-		// Skip planets that do not offer special jobs or missions, unless they were explicitly listed as options.
-		if(planet.IsWormhole() || (requireSpaceport && !planet.HasSpaceport()) || (!hasClearance && !planet.CanLand()))
-			if(planets.empty() || !planets.count(&planet))
+		const vector<const Planet *> &candidates = matches->index->planets;
+		const Bitset &found = matches->planets;
+		for(size_t i = found.FindNext(0); i < candidates.size(); i = found.FindNext(i + 1))
+		{
+			const Planet &planet = *candidates[i];
+			if(planet.GetSystem() && planet.GetSystem()->Inaccessible())
 				continue;
-		if(Matches(&planet, origin))
-			options.push_back(&planet);
+			if(planet.IsWormhole() || (requireSpaceport && !planet.HasSpaceport()) || (!hasClearance && !planet.CanLand()))
+				if(planets.empty() || !planets.count(&planet))
+					continue;
+			if(IsNearOrigin(planet.GetSystem(), origin))
+				options.push_back(&planet);
+		}
+	}
+	else
+	{
+		for(const auto &it : GameData::Planets())
+		{
+			const Planet &planet = it.second;
+			// Skip planets with incomplete data or which are from inaccessible systems.
+			if(!planet.IsValid() || (planet.GetSystem() && planet.GetSystem()->Inaccessible()))
+				continue;
+			// Skip planets that do not offer special jobs or missions, unless they were explicitly listed as options.
+			if(planet.IsWormhole() || (requireSpaceport && !planet.HasSpaceport()) || (!hasClearance && !planet.CanLand()))
+				if(planets.empty() || !planets.count(&planet))
+					continue;
+			if(Matches(&planet, origin))
+				options.push_back(&planet);
+		}
 	}
 	return options.empty() ? nullptr : options[Random::Int(options.size())];
 }
@@ -644,9 +718,90 @@ bool LocationFilter::Matches(const System *system, const System *origin, bool di
 	// Check this system's distance from the desired reference system.
 	if(center && Distance(center, system, centerMaxDistance, centerDistanceOptions) < centerMinDistance)
 		return false;
-	if(origin && originMaxDistance >= 0
-			&& Distance(origin, system, originMaxDistance, originDistanceOptions) < originMinDistance)
+
+	return IsNearOrigin(system, origin);
+}
+
+
+
+bool LocationFilter::SubFiltersUseOrigin() const
+{
+	for(const list<LocationFilter> *filters : {&notFilters, &neighborFilters})
+		for(const LocationFilter &filter : *filters)
+			if(filter.originMaxDistance >= 0 || filter.SubFiltersUseOrigin())
+				return true;
+	return false;
+}
+
+
+
+shared_ptr<const LocationFilter::CachedMatches> LocationFilter::GetMatches(const System *origin, bool compile) const
+{
+	// Filters that were never loaded are not worth recording, and a "distance"
+	// inside a "not" or "neighbor" filter cannot be checked after the fact.
+	if(!cache || (origin && subFiltersUseOrigin))
+		return nullptr;
+
+	lock_guard<mutex> lock(cache->matchesMutex);
+	if(cache->matches && cache->matches->index->revision == GameData::UniverseRevision())
+		return cache->matches;
+	if(!compile)
+		return nullptr;
+
+	auto matches = make_shared<CachedMatches>();
+	matches->index = CurrentIndex();
+	const UniverseIndex &index = *matches->index;
+	matches->systems.Resize(index.systems.size());
+	if(shipCategory.empty())
+		for(size_t i = 0; i < index.systems.size(); ++i)
+			if(Matches(index.systems[i], nullptr, false))
+				matches->systems.Set(i);
+	matches->planets.Resize(index.planets.size());
+	for(size_t i = 0; i < index.planets.size(); ++i)
+		if(MatchesPlanet(index.planets[i], nullptr))
+			matches->planets.Set(i);
+
+	cache->matches = matches;
+	return matches;
+}
+
+
+
+bool LocationFilter::MatchesPlanet(const Planet *planet, const System *origin) const
+{
+	if(!planet || !planet->IsValid())
+
+		return false;
+
+	// If a ship class was given, do not match planets.
+	if(!shipCategory.empty())
 		return false;
 
-	return true;
+	if(!governments.empty() && !governments.count(planet->GetGovernment()))
+		return false;
+
+	if(!planets.empty() && !planets.count(planet))
+		return false;
+	for(const set<string> &attr : attributes)
+		if(!SetsIntersect(attr, planet->Attributes()))
+			return false;
+
+	for(const LocationFilter &filter : notFilters)
+		if(filter.Matches(planet, origin))
+			return false;
+
+	// If outfits are specified, make sure they can be bought here.
+	for(const set<const Outfit *> &outfitList : outfits)
+		if(!SetsIntersect(outfitList, planet->Outfitter()))
+			return false;
+
+	return Matches(planet->GetSystem(), origin, true);
+}
+
+
+
+bool LocationFilter::IsNearOrigin(const System *system, const System *origin) const
+{
+	return !origin || originMaxDistance < 0
+		|| Distance(origin, system, originMaxDistance, originDistanceOptions) >= originMinDistance;
 }
@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DistanceCalculationSettings.h"
 
 #include <list>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -51,6 +52,10 @@ public:
 	// Check if this filter contains any specifications.
 	bool IsEmpty() const;
 	bool IsValid() const;
+	// The planets or systems that anything this filter matches must be among.
+	// If either set is empty, the filter does not limit those.
+	const std::set<const Planet *> &Planets() const;
+	const std::set<const System *> &Systems() const;
 
 	// If the player is in the given system, does this filter match?
 	bool Matches(const Planet *planet, const System *origin = nullptr) const;
@@ -63,14 +68,33 @@ public:
 	// into "near" references, relative to the given system.
 	LocationFilter SetOrigin(const System *origin) const;
 	// Generic find system / find planet methods, based on the given origin
-	// system (e.g. the player's current system) and ability to land.
+	// system (e.g. the player's current system) and ability to land. These
+	// also record which systems and planets this filter matches, so that
+	// later checks can reuse them until the universe changes.
 	const System *PickSystem(const System *origin) const;
 	const Planet *PickPlanet(const System *origin, bool hasClearance = false, bool requireSpaceport = true) const;
 
 
+private:
+	// The systems and planets of the universe that this filter matches,
+	// ignoring any "distance" from the origin.
+	class CachedMatches;
+	class MatchCache;
+
+
 private:
 	// Load one particular line of conditions.
 	void LoadChild(const DataNode &child);
+	// Check whether any "not" or "neighbor" filter depends on the origin.
+	bool SubFiltersUseOrigin() const;
+	// Get the recorded matches, if they can be used with the given origin.
+	// If "compile" is set, they are recomputed if the universe has changed;
+	// otherwise, null is returned unless they are still current.
+	std::shared_ptr<const CachedMatches> GetMatches(const System *origin, bool compile) const;
+	// Check the given planet or system without using the recorded matches.
+	bool MatchesPlanet(const Planet *planet, const System *origin) const;
+	// Check if the given system is within this filter's "distance" of the origin.
+	bool IsNearOrigin(const System *system, const System *origin) const;
 	// Check if the filter matches the given system. If it did not, return true
 	// only if the filter wasn't looking for planet characteristics or if the
 	// didPlanet argument is set (meaning we already checked those).
@@ -108,6 +132,12 @@ private:
 	std::list<LocationFilter> notFilters;
 	// These filters store all the things the planet or system must border.
 	std::list<LocationFilter> neighborFilters;
+
+	// Whether the "not" or "neighbor" filters contain a "distance" filter, in
+	// which case the recorded matches are only valid without an origin.
+	bool subFiltersUseOrigin = false;
+	// Copies of a filter share the matches that it recorded.
+	std::shared_ptr<MatchCache> cache;
 };
 
 
@@ -0,0 +1,89 @@
+/* LogbookEntries.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "LogbookEntries.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	int32_t Pack(const Date &date)
+	{
+		return date.Day() + (date.Month() << 5) + (date.Year() << 9);
+	}
+}
+
+
+
+void LogbookEntries::Add(const Date &date, const string &text)
+{
+	Entry entry;
+	entry.date = Pack(date);
+	entry.offset = this->text.size();
+	entry.length = text.size();
+	this->text += text;
+
+	// Entries are nearly always added in order, so this is usually the end.
+	auto it = upper_bound(entries.begin(), entries.end(), entry.date,
+		[](int32_t date, const Entry &other) noexcept -> bool
+		{
+			return date < other.date;
+		});
+	entries.insert(it, entry);
+}
+
+
+
+bool LogbookEntries::IsEmpty() const
+{
+	return entries.empty();
+}
+
+
+
+size_t LogbookEntries::Size() const
+{
+	return entries.size();
+}
+
+
+
+size_t LogbookEntries::LowerBound(const Date &date) const
+{
+	auto it = lower_bound(entries.begin(), entries.end(), Pack(date),
+		[](const Entry &entry, int32_t date) noexcept -> bool
+		{
+			return entry.date < date;
+		});
+	return it - entries.begin();
+}
+
+
+
+Date LogbookEntries::GetDate(size_t index) const
+{
+	int32_t date = entries[index].date;
+	return Date(date & 31, (date >> 5) & 15, date >> 9);
+}
+
+
+
+string LogbookEntries::Text(size_t index) const
+{
+	const Entry &entry = entries[index];
+	return text.substr(entry.offset, entry.length);
+}
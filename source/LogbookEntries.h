@@ -0,0 +1,66 @@
+/* LogbookEntries.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef LOGBOOK_ENTRIES_H_
+#define LOGBOOK_ENTRIES_H_
+
+#include "Date.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+// Class holding the player's dated log entries, in order of their dates. The
+// text of all the entries is kept in a single buffer, so each entry only adds
+// a few bytes of bookkeeping and no allocation of its own. The text of an
+// entry is only copied out when it is actually needed, e.g. to display it.
+class LogbookEntries {
+public:
+	// Add an entry with the given text, in which paragraphs are separated by
+	// "\n\t". Entries with the same date stay in the order they were added.
+	void Add(const Date &date, const std::string &text);
+
+	bool IsEmpty() const;
+	size_t Size() const;
+	// Get the index of the first entry whose date is not before the given one.
+	size_t LowerBound(const Date &date) const;
+
+	// Get the date or the text of the entry with the given index.
+	Date GetDate(size_t index) const;
+	std::string Text(size_t index) const;
+
+
+private:
+	class Entry {
+	public:
+		// The date, packed so that entries compare in date order.
+		int32_t date;
+		uint32_t offset;
+		uint32_t length;
+	};
+
+
+private:
+	std::string text;
+	std::vector<Entry> entries;
+};
+
+
+
+#endif
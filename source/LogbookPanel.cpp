@@ -59,9 +59,9 @@ LogbookPanel::LogbookPanel(PlayerInfo &player)
 	: player(player)
 {
 	SetInterruptible(false);
-	if(!player.Logbook().empty())
+	if(!player.Logbook().IsEmpty())
 	{
-		selectedDate = (--player.Logbook().end())->first;
+		selectedDate = player.Logbook().GetDate(player.Logbook().Size() - 1);
 		selectedName = MONTH[selectedDate.Month() - 1];
 	}
 	Update();
@@ -144,13 +144,14 @@ void LogbookPanel::Draw()
 	if(selectedDate && begin != end)
 	{
 		const auto layout = Layout(static_cast<int>(TEXT_WIDTH - 2. * PAD), Alignment::RIGHT);
-		for(auto it = begin; it != end; ++it)
+		for(size_t i = begin; i < end; ++i)
 		{
-			string date = it->first.ToString();
+			string date = player.Logbook().GetDate(i).ToString();
 			font.Draw({date, layout}, pos + Point(0., textOffset.Y()), dim);
 			pos.Y() += LINE_HEIGHT;
 
-			wrap.Wrap(it->second);
+			// Only the entries of the selected month are copied out of the logbook.
+			wrap.Wrap(player.Logbook().Text(i));
 			wrap.Draw(pos, medium);
 			pos.Y() += wrap.Height() + GAP;
 		}
@@ -312,20 +313,20 @@ void LogbookPanel::Update(bool selectLast)
 		dates.emplace_back();
 	}
 	// The logbook should never be opened if it has no entries, but just in case:
-	if(player.Logbook().empty())
-	{
-		begin = end = player.Logbook().end();
+	const LogbookEntries &logbook = player.Logbook();
+	begin = end = 0;
+	if(logbook.IsEmpty())
 		return;
-	}
 
 	// Check what years and months have entries for them.
 	set<int> years;
 	set<int> months;
-	for(const auto &it : player.Logbook())
+	for(size_t i = 0; i < logbook.Size(); ++i)
 	{
-		years.insert(it.first.Year());
-		if(it.first.Year() == selectedDate.Year() && it.first.Month() >= 1 && it.first.Month() <= 12)
-			months.insert(it.first.Month());
+		Date date = logbook.GetDate(i);
+		years.insert(date.Year());
+		if(date.Year() == selectedDate.Year() && date.Month() >= 1 && date.Month() <= 12)
+			months.insert(date.Month());
 	}
 
 	// Generate the table of contents.
@@ -342,10 +343,7 @@ void LogbookPanel::Update(bool selectLast)
 	}
 	// If a special category is selected, bail out here.
 	if(!selectedDate)
-	{
-		begin = end = player.Logbook().end();
 		return;
-	}
 
 	// Make sure a month is selected, within the current year.
 	if(!selectedDate.Month())
@@ -354,6 +352,6 @@ void LogbookPanel::Update(bool selectLast)
 		selectedName = MONTH[selectedDate.Month() - 1];
 	}
 	// Get the range of entries that include the selected month.
-	begin = player.Logbook().lower_bound(Date(0, selectedDate.Month(), selectedDate.Year()));
-	end = player.Logbook().lower_bound(Date(32, selectedDate.Month(), selectedDate.Year()));
+	begin = logbook.LowerBound(Date(0, selectedDate.Month(), selectedDate.Year()));
+	end = logbook.LowerBound(Date(32, selectedDate.Month(), selectedDate.Year()));
 }
@@ -20,7 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Date.h"
 
-#include <map>
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -59,8 +59,9 @@ private:
 	// Current month being displayed:
 	Date selectedDate;
 	std::string selectedName;
-	std::multimap<Date, std::string>::const_iterator begin;
-	std::multimap<Date, std::string>::const_iterator end;
+	// The range of logbook entries in that month.
+	size_t begin = 0;
+	size_t end = 0;
 	// Other months available for display:
 	std::vector<std::string> contents;
 	std::vector<Date> dates;
@@ -15,20 +15,164 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Logger.h"
 
+#include <condition_variable>
 #include <iostream>
 #include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
 namespace {
+	// Writes the logged messages out on a thread of its own.
+	class Writer {
+	public:
+		~Writer();
+
+		void Add(const string &message);
+		void Flush();
+
+
+	private:
+		void Run();
+		// Queue a count of how many times the last message was repeated, if it was.
+		void QueueRepeats();
+
+
+	private:
+		// Guards everything below, except for the thread itself.
+		mutex queueMutex;
+		condition_variable condition;
+		vector<string> queue;
+		bool isWriting = false;
+		bool isDone = false;
+		// The last message that was logged, and how many more times it has been
+		// logged since then.
+		string lastMessage;
+		int repeats = 0;
+
+		thread writerThread;
+	};
+
 	function<void(const string &message)> logErrorCallback = nullptr;
-	mutex logErrorMutex;
+	// Guards the callback, and makes sure that only one batch of messages is
+	// written out at once.
+	mutex writeMutex;
+
+	Writer &GetWriter()
+	{
+		static Writer writer;
+		return writer;
+	}
+
+
+
+	// Perform additional logging through the callback, if any is registered.
+	void Write(const vector<string> &messages)
+	{
+		lock_guard<mutex> lock(writeMutex);
+		if(logErrorCallback)
+			for(const string &message : messages)
+				logErrorCallback(message);
+	}
+
+
+
+	Writer::~Writer()
+	{
+		{
+			lock_guard<mutex> lock(queueMutex);
+			QueueRepeats();
+			isDone = true;
+		}
+		condition.notify_all();
+		if(writerThread.joinable())
+			writerThread.join();
+	}
+
+
+
+	void Writer::Add(const string &message)
+	{
+		unique_lock<mutex> lock(queueMutex);
+		// Log by default to stderr. This is done right away and in full, since
+		// it is cheap and is what anyone watching the program's output sees.
+		cerr << message << endl;
+
+		if(message == lastMessage)
+		{
+			++repeats;
+			return;
+		}
+		QueueRepeats();
+		lastMessage = message;
+
+		// Anything logged while the program is exiting is written right away.
+		queue.push_back(message);
+		if(isDone)
+		{
+			vector<string> batch;
+			batch.swap(queue);
+			lock.unlock();
+			Write(batch);
+			return;
+		}
+		if(!writerThread.joinable())
+			writerThread = thread(&Writer::Run, this);
+		condition.notify_all();
+	}
+
+
+
+	void Writer::Flush()
+	{
+		unique_lock<mutex> lock(queueMutex);
+		QueueRepeats();
+		lastMessage.clear();
+		condition.notify_all();
+		condition.wait(lock, [this]() -> bool { return queue.empty() && !isWriting; });
+	}
+
+
+
+	void Writer::Run()
+	{
+		unique_lock<mutex> lock(queueMutex);
+		while(true)
+		{
+			condition.wait(lock, [this]() -> bool { return !queue.empty() || isDone; });
+			if(queue.empty())
+				return;
+
+			vector<string> batch;
+			batch.swap(queue);
+			isWriting = true;
+			lock.unlock();
+			Write(batch);
+			lock.lock();
+			isWriting = false;
+			condition.notify_all();
+		}
+	}
+
+
+
+	void Writer::QueueRepeats()
+	{
+		if(!repeats)
+			return;
+
+		queue.push_back("(The previous message was repeated " + to_string(repeats)
+			+ (repeats == 1 ? " more time.)" : " more times.)"));
+		repeats = 0;
+	}
 }
 
 
 
 void Logger::SetLogErrorCallback(function<void(const string &message)> callback)
 {
+	lock_guard<mutex> lock(writeMutex);
 	logErrorCallback = std::move(callback);
 }
 
@@ -36,10 +180,24 @@ void Logger::SetLogErrorCallback(function<void(const string &message)> callback)
 
 void Logger::LogError(const string &message)
 {
-	lock_guard<mutex> lock(logErrorMutex);
-	// Log by default to stderr.
-	cerr << message << endl;
-	// Perform additional logging through callback if any is registered.
-	if(logErrorCallback)
-		logErrorCallback(message);
+	Log(message, Level::SEVERE);
+}
+
+
+
+void Logger::Log(const string &message, Level level)
+{
+	if(level == Level::INFO)
+		GetWriter().Add("Info: " + message);
+	else if(level == Level::WARNING)
+		GetWriter().Add("Warning: " + message);
+	else
+		GetWriter().Add(message);
+}
+
+
+
+void Logger::Flush()
+{
+	GetWriter().Flush();
 }
@@ -24,10 +24,29 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // Default static logging facility, different programs might have different
 // conventions and requirements on how they handle logging, so the running
 // program should register its preferred logging facility when starting up.
+// Messages are printed to stderr right away, but are handed to the registered
+// facility by a background thread, so that writing many of them out does not
+// hold up the thread that logs them. A message that is logged several times in
+// a row is only handed over once, followed by a count of how many more times it
+// was repeated.
 class Logger {
+public:
+	// How serious a logged message is. Messages that are not errors are marked
+	// as such when they are written.
+	enum class Level : int {
+		INFO,
+		WARNING,
+		SEVERE
+	};
+
+
 public:
 	static void SetLogErrorCallback(std::function<void(const std::string &message)> callback);
 	static void LogError(const std::string &message);
+	static void Log(const std::string &message, Level level);
+
+	// Wait until every message logged so far has been written out.
+	static void Flush();
 };
 
 
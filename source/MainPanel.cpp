@@ -48,12 +48,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SpriteSet.h"
 #include "StellarObject.h"
 #include "System.h"
+#include "TouchScreen.h"
 #include "UI.h"
 
 #include "opengl.h"
 
 #include <SDL2/SDL.h>
 #include <cmath>
+#include <iterator>
 #include <sstream>
 #include <string>
 
@@ -71,7 +73,21 @@ MainPanel::MainPanel(PlayerInfo &player)
 
 void MainPanel::Step()
 {
-	engine.Wait();
+	// If the last step is taking too long to calculate, either wait for it, or
+	// draw the last finished step again and check back on the next frame.
+	if(!Preferences::Has("Pipelined rendering"))
+		engine.Wait();
+	else if(!engine.TryWait())
+		return;
+
+	// The engine is not running now, so it is safe to change the game data.
+	if(reload)
+	{
+		reload = false;
+		int count = GameData::Reload();
+		Messages::Add("Reloaded " + to_string(count) + (count == 1 ? " object" : " objects")
+			+ " from changed data files.", Messages::Importance::High);
+	}
 
 	// Depending on what UI element is on top, the game is "paused." This
 	// checks only already-drawn panels.
@@ -98,8 +114,10 @@ void MainPanel::Step()
 	{
 		GetUI()->Push(new PlanetPanel(player, bind(&MainPanel::OnCallback, this)));
 		player.Land(GetUI());
-		// Save on landing, in case the app is killed uncleanly
-		player.Save();
+		// Save on landing, in case the app is killed uncleanly. (A replay is
+		// flown from a copy of a saved game, which must not be saved over.)
+		if(GetUI()->CanSave())
+			player.Save();
 		isActive = false;
 	}
 
@@ -157,15 +175,27 @@ void MainPanel::Step()
 
 	engine.Step(isActive);
 
-	// Splice new events onto the eventQueue for (eventual) handling. No
+	// Move new events onto the eventQueue for (eventual) handling. No
 	// other classes use Engine::Events() after Engine::Step() completes.
-	eventQueue.splice(eventQueue.end(), engine.Events());
+	vector<ShipEvent> &newEvents = engine.Events();
+	eventQueue.insert(eventQueue.end(), make_move_iterator(newEvents.begin()), make_move_iterator(newEvents.end()));
+	newEvents.clear();
 	// Handle as many ShipEvents as possible (stopping if no longer active
 	// and updating the isActive flag).
 	StepEvents(isActive);
 
 	if(isActive)
+	{
+		// Sample the finger steering the flagship as late as possible, so that
+		// the step about to begin uses where it is now rather than where it was
+		// when this frame's events were handled.
+		TouchScreen::Latch();
+		Point latest;
+		int finger = engine.TouchFinger();
+		if(finger != -1 && TouchScreen::Position(finger, latest))
+			FingerMove(latest.X(), latest.Y(), finger);
 		engine.Go();
+	}
 	else
 		canDrag = false;
 	canClick = isActive;
@@ -264,7 +294,7 @@ void MainPanel::Draw()
 					info.SetCondition("can attack");
 				}
 			}
-			else if (player.Flagship()->GetTargetAsteroid())
+			else if (player.Flagship()->GetTargetAsteroid() != PoolHandle<Minable>())
 			{
 				info.SetCondition("targeting asteroid");
 			}
@@ -362,6 +392,8 @@ bool MainPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 		Preferences::ZoomViewOut();
 	else if((key == SDLK_PLUS || key == SDLK_KP_PLUS || key == SDLK_EQUALS) && !command)
 		Preferences::ZoomViewIn();
+	else if(key == SDLK_F5 && !command && GameData::CanReload())
+		reload = true;
 	else if(key >= '0' && key <= '9' && !command)
 		engine.SelectGroup(key - '0', mod & KMOD_SHIFT, mod & (KMOD_CTRL | KMOD_GUI));
 	else if(key == 0 && !(command == Command()) && !(command == Command::FASTFORWARD))
@@ -766,9 +798,9 @@ bool MainPanel::ShowHailPanel()
 // oldest and then process events until any create a new UI element.
 void MainPanel::StepEvents(bool &isActive)
 {
-	while(isActive && !eventQueue.empty())
+	while(isActive && nextEvent < eventQueue.size())
 	{
-		const ShipEvent &event = eventQueue.front();
+		const ShipEvent &event = eventQueue[nextEvent];
 		const Government *actor = event.ActorGovernment();
 
 		// Pass this event to the player, to update conditions and make
@@ -847,8 +879,13 @@ void MainPanel::StepEvents(bool &isActive)
 			}
 		}
 
-		// Remove the fully-handled event.
-		eventQueue.pop_front();
+		// Move past the fully-handled event.
+		++nextEvent;
 		handledFront = false;
 	}
+	if(nextEvent == eventQueue.size())
+	{
+		eventQueue.clear();
+		nextEvent = 0;
+	}
 }
@@ -23,7 +23,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ZoomGesture.h"
 
 #include <SDL2/SDL.h>
-#include <list>
+#include <cstddef>
+#include <vector>
 
 class PlayerInfo;
 class ShipEvent;
@@ -79,11 +80,16 @@ private:
 
 	Engine engine;
 
-	// These are the pending ShipEvents that have yet to be processed.
-	std::list<ShipEvent> eventQueue;
+	// These are the pending ShipEvents that have yet to be processed, starting
+	// with the one at the given index. The queue is emptied (but keeps its
+	// memory) once all of them have been handled.
+	std::vector<ShipEvent> eventQueue;
+	size_t nextEvent = 0;
 	bool handledFront = false;
 
 	Command show;
+	// Whether to reload any data files that have changed before the next step.
+	bool reload = false;
 
 	// For displaying the GPU load.
 	double load = 0.;
@@ -766,11 +766,11 @@ void MapDetailPanel::DrawInfo()
 	// Adapt the coordinates for the text (the sprite is drawn from a center coordinate).
 	uiPoint.X() -= (tradeSprite->Width() / 2. - textMargin);
 	uiPoint.Y() -= (tradeSprite->Height() / 2. - textMargin);
-	for(const Trade::Commodity &commodity : GameData::Commodities())
+	const vector<Trade::Commodity> &commodities = GameData::Commodities();
+	for(size_t i = 0; i < commodities.size(); ++i)
 	{
-		bool isSelected = false;
-		if(static_cast<unsigned>(this->commodity) < GameData::Commodities().size())
-			isSelected = (&commodity == &GameData::Commodities()[this->commodity]);
+		const Trade::Commodity &commodity = commodities[i];
+		bool isSelected = (static_cast<unsigned>(this->commodity) == i);
 		const Color &color = isSelected ? medium : dim;
 
 		font.Draw(commodity.name, uiPoint, color);
@@ -780,8 +780,8 @@ void MapDetailPanel::DrawInfo()
 		bool hasVisited = player.HasVisited(*selectedSystem);
 		if(hasVisited && selectedSystem->IsInhabited(player.Flagship()))
 		{
-			int value = selectedSystem->Trade(commodity.name);
-			int localValue = (player.GetSystem() ? player.GetSystem()->Trade(commodity.name) : 0);
+			int value = GameData::CommodityPrice(*selectedSystem, i);
+			int localValue = (player.GetSystem() ? GameData::CommodityPrice(*player.GetSystem(), i) : 0);
 			// Don't "compare" prices if the current system is uninhabited and
 			// thus has no prices to compare to.
 			bool noCompare = (!player.GetSystem() || !player.GetSystem()->IsInhabited(player.Flagship()));
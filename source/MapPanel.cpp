@@ -43,6 +43,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "PointerShader.h"
 #include "Politics.h"
 #include "Preferences.h"
+#include "Rectangle.h"
 #include "RingShader.h"
 #include "Screen.h"
 #include "Ship.h"
@@ -50,6 +51,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SpriteShader.h"
 #include "StellarObject.h"
 #include "System.h"
+#include "SystemGrid.h"
 #include "Trade.h"
 #include "text/truncate.hpp"
 #include "UI.h"
@@ -557,18 +559,17 @@ bool MapPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool
 
 bool MapPanel::Click(int x, int y, int clicks)
 {
-	// Figure out if a system was clicked on.
+	// Figure out if a system was clicked on, choosing the closest one if several are.
 	Point click = Point(x, y) / Zoom() - center;
-	for(const auto &it : GameData::Systems())
-	{
-		const System &system = it.second;
-		if(system.IsValid() && !system.Inaccessible() && click.Distance(system.Position()) < 10.
-				&& (player.HasSeen(system) || &system == specialSystem))
-		{
-			Select(&system);
-			break;
-		}
-	}
+	vector<const System *> nearby;
+	GameData::GetSystemGrid().Near(click, 10., nearby);
+	const System *clicked = nullptr;
+	for(const System *system : nearby)
+		if(system->IsValid() && (player.HasSeen(*system) || system == specialSystem)
+				&& (!clicked || click.Distance(system->Position()) < click.Distance(clicked->Position())))
+			clicked = system;
+	if(clicked)
+		Select(clicked);
 
 	return true;
 }
@@ -1004,6 +1005,8 @@ void MapPanel::UpdateCache()
 	// Remember which commodity the cached systems are colored by.
 	cachedCommodity = commodity;
 	nodes.clear();
+	linkItemsZoom = 0.;
+	systemItemsZoom = 0.;
 
 	// Draw the circles for the systems, colored based on the selected criterion,
 	// which may be government, services, or commodity prices.
@@ -1031,7 +1034,7 @@ void MapPanel::UpdateCache()
 				if(commodity >= 0)
 				{
 					const Trade::Commodity &com = GameData::Commodities()[commodity];
-					double price = system.Trade(com.name);
+					double price = GameData::CommodityPrice(system, commodity);
 					if(!price)
 						value = numeric_limits<double>::quiet_NaN();
 					else
@@ -1337,16 +1340,19 @@ void MapPanel::DrawWormholes()
 void MapPanel::DrawLinks()
 {
 	double zoom = Zoom();
-	for(const Link &link : links)
+	if(zoom != linkItemsZoom)
 	{
-		Point from = zoom * (link.start + center);
-		Point to = zoom * (link.end + center);
-		Point unit = (from - to).Unit() * LINK_OFFSET;
-		from -= unit;
-		to += unit;
-
-		LineShader::Draw(from, to, LINK_WIDTH, link.color);
+		linkItemsZoom = zoom;
+		linkItems.clear();
+		for(const Link &link : links)
+		{
+			Point from = zoom * link.start;
+			Point to = zoom * link.end;
+			Point unit = (from - to).Unit() * LINK_OFFSET;
+			linkItems.push_back(LineShader::MakeItem(from - unit, to + unit, LINK_WIDTH, link.color));
+		}
 	}
+	LineShader::Draw(linkItems, zoom * center);
 }
 
 
@@ -1364,24 +1370,29 @@ void MapPanel::DrawSystems()
 
 	// Draw the circles for the systems.
 	double zoom = Zoom();
-	for(const Node &node : nodes)
+	if(zoom != systemItemsZoom)
 	{
-		Point pos = zoom * (node.position + center);
-		RingShader::Draw(pos, OUTER, INNER, node.color);
-
-		if(commodity == SHOW_GOVERNMENT && node.government && node.government->GetName() != "Uninhabited")
-		{
-			// For every government that is drawn, keep track of how close it
-			// is to the center of the view. The four closest governments
-			// will be displayed in the key.
-			double distance = pos.Length();
-			auto it = closeGovernments.find(node.government);
-			if(it == closeGovernments.end())
-				closeGovernments[node.government] = distance;
-			else
-				it->second = min(it->second, distance);
-		}
+		systemItemsZoom = zoom;
+		systemItems.clear();
+		for(const Node &node : nodes)
+			systemItems.push_back(RingShader::MakeItem(zoom * node.position, OUTER, INNER, node.color));
 	}
+	RingShader::Draw(systemItems, zoom * center);
+
+	if(commodity == SHOW_GOVERNMENT)
+		for(const Node &node : nodes)
+			if(node.government && node.government->GetName() != "Uninhabited")
+			{
+				// For every government that is drawn, keep track of how close it
+				// is to the center of the view. The four closest governments
+				// will be displayed in the key.
+				double distance = (zoom * (node.position + center)).Length();
+				auto it = closeGovernments.find(node.government);
+				if(it == closeGovernments.end())
+					closeGovernments[node.government] = distance;
+				else
+					it->second = min(it->second, distance);
+			}
 }
 
 
@@ -1397,8 +1408,17 @@ void MapPanel::DrawNames()
 	bool useBigFont = (zoom > 2.);
 	const Font &font = FontSet::Get(useBigFont ? 18 : 14);
 	Point offset(useBigFont ? 8. : 6., -.5 * font.Height());
+	// Skip the names that would start outside the screen. They are short, so
+	// a margin of four hundred pixels on the left is enough to include any
+	// name that would still be partly visible.
+	Rectangle visible = Rectangle::WithCorners(Screen::TopLeft() - Point(400., font.Height()),
+		Screen::BottomRight() + Point(0., font.Height()));
 	for(const Node &node : nodes)
-		font.Draw(node.name, zoom * (node.position + center) + offset, node.nameColor);
+	{
+		Point position = zoom * (node.position + center) + offset;
+		if(visible.Contains(position))
+			font.Draw(node.name, position, node.nameColor);
+	}
 }
 
 
@@ -20,7 +20,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Color.h"
 #include "DistanceMap.h"
+#include "LineShader.h"
 #include "Point.h"
+#include "RingShader.h"
 #include "ZoomGesture.h"
 #include "text/WrappedText.h"
 
@@ -211,6 +213,14 @@ private:
 	};
 	std::vector<Link> links;
 
+	// The links and system rings, ready to be drawn at the zoom they were made
+	// for, so that panning the map only has to move them. A zoom of zero means
+	// they must be remade.
+	std::vector<LineShader::Item> linkItems;
+	double linkItemsZoom = 0.;
+	std::vector<RingShader::Item> systemItems;
+	double systemItemsZoom = 0.;
+
 	double mapZoom = 1.0;
 	Animate<double> mapZoomAnimate;
 	ZoomGesture zoomGesture;
@@ -0,0 +1,134 @@
+/* MappedFile.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "MappedFile.h"
+
+#include "Files.h"
+#include "PluginArchive.h"
+
+#include <SDL2/SDL_rwops.h>
+
+#ifdef __ANDROID__
+#include <android/asset_manager.h>
+#endif
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+
+MappedFile::MappedFile(const string &path)
+{
+	// Files inside of plugin archives are used in place if they are stored
+	// uncompressed, and otherwise inflated straight into memory.
+	string name;
+	if(const PluginArchive *archive = PluginArchive::Find(path, name))
+	{
+		data = archive->Data(name, size);
+		if(!data)
+		{
+			copy = archive->Read(name);
+			data = copy.data();
+			size = copy.size();
+		}
+		return;
+	}
+
+#ifndef _WIN32
+	// Files that are on the file system, rather than in an asset bundle, can be
+	// mapped directly.
+	int descriptor = open(path.c_str(), O_RDONLY);
+	if(descriptor >= 0)
+	{
+		struct stat status;
+		if(!fstat(descriptor, &status) && status.st_size > 0)
+		{
+			void *view = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+			if(view != MAP_FAILED)
+			{
+				mapping = view;
+				data = static_cast<const char *>(view);
+				size = status.st_size;
+			}
+		}
+		close(descriptor);
+		if(data)
+			return;
+	}
+#endif
+
+	SDL_RWops *file = Files::Open(path);
+	if(!file)
+		return;
+#ifdef __ANDROID__
+	// SDL opens asset bundle entries as Android assets. Their contents can be
+	// used in place for as long as the asset stays open.
+	if(file->type == SDL_RWOPS_JNIFILE && file->hidden.androidio.asset)
+	{
+		AAsset *entry = static_cast<AAsset *>(file->hidden.androidio.asset);
+		const void *buffer = AAsset_getBuffer(entry);
+		if(buffer)
+		{
+			asset = file;
+			data = static_cast<const char *>(buffer);
+			size = AAsset_getLength64(entry);
+			return;
+		}
+	}
+#endif
+	copy = Files::Read(file);
+	Files::Close(file);
+	data = copy.data();
+	size = copy.size();
+}
+
+
+
+MappedFile::~MappedFile() noexcept
+{
+#ifndef _WIN32
+	if(mapping)
+		munmap(mapping, size);
+#endif
+	if(asset)
+		Files::Close(asset);
+}
+
+
+
+MappedFile::operator bool() const
+{
+	return size;
+}
+
+
+
+const char *MappedFile::Data() const
+{
+	return data;
+}
+
+
+
+size_t MappedFile::Size() const
+{
+	return size;
+}
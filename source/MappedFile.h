@@ -0,0 +1,60 @@
+/* MappedFile.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+
+
+// A read-only view of a whole file's contents, for code that would otherwise
+// read the file into a string just to parse it. Where possible, the file is
+// mapped into memory instead of being copied: ordinary files with mmap(), and
+// files in the Android asset bundle with AAsset_getBuffer(), which maps entries
+// that are stored uncompressed. Files in plugin archives are used in place in
+// the archive's own mapping. Otherwise, the file is read into memory.
+class MappedFile {
+public:
+	MappedFile() noexcept = default;
+	explicit MappedFile(const std::string &path);
+	~MappedFile() noexcept;
+
+	// No moving or copying this class.
+	MappedFile(const MappedFile &other) = delete;
+	MappedFile(MappedFile &&other) = delete;
+	MappedFile &operator=(const MappedFile &other) = delete;
+	MappedFile &operator=(MappedFile &&other) = delete;
+
+	// Check whether the file was found. Empty files count as not found.
+	explicit operator bool() const;
+	const char *Data() const;
+	size_t Size() const;
+
+
+private:
+	const char *data = nullptr;
+	size_t size = 0;
+
+	// What is keeping the data available, depending on how it was read.
+	void *mapping = nullptr;
+	struct SDL_RWops *asset = nullptr;
+	std::string copy;
+};
+
+
+
+#endif
@@ -22,9 +22,90 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <cmath>
 #include <limits>
 
+#if defined(__SSE2__)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 
 namespace {
+	// The number of edge groups (of four edges each) in each span.
+	const size_t SPAN_GROUPS = 4;
+
+	// Find the fraction of the way along the segment from (sx, sy), with the
+	// vector (vx, vy), where it first enters any of the given four edges. Return
+	// 1 if it doesn't enter any of them.
+	float FirstEntry(const float *x, const float *y, const float *dx, const float *dy,
+		float sx, float sy, float vx, float vy)
+	{
+		// This is the same test as in Mask::Intersection(), for four edges at once.
+#if defined(__SSE2__)
+		const __m128 edgeX = _mm_loadu_ps(dx);
+		const __m128 edgeY = _mm_loadu_ps(dy);
+		const __m128 cross = _mm_sub_ps(_mm_mul_ps(edgeX, _mm_set1_ps(vy)), _mm_mul_ps(edgeY, _mm_set1_ps(vx)));
+		const __m128 offsetX = _mm_sub_ps(_mm_loadu_ps(x), _mm_set1_ps(sx));
+		const __m128 offsetY = _mm_sub_ps(_mm_loadu_ps(y), _mm_set1_ps(sy));
+		const __m128 uB = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(vx), offsetY), _mm_mul_ps(_mm_set1_ps(vy), offsetX));
+		const __m128 uA = _mm_sub_ps(_mm_mul_ps(edgeX, offsetY), _mm_mul_ps(edgeY, offsetX));
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(cross, zero), _mm_cmpge_ps(uB, zero)),
+			_mm_and_ps(_mm_cmplt_ps(uB, cross), _mm_cmpge_ps(uA, zero)));
+		if(!_mm_movemask_ps(hit))
+			return 1.f;
+		const __m128 one = _mm_set1_ps(1.f);
+		// Edges that aren't hit have a cross of zero or less, so make sure not to divide by it.
+		const __m128 fraction = _mm_div_ps(uA, _mm_or_ps(_mm_and_ps(hit, cross), _mm_andnot_ps(hit, one)));
+		__m128 closest = _mm_or_ps(_mm_and_ps(hit, fraction), _mm_andnot_ps(hit, one));
+		closest = _mm_min_ps(closest, _mm_movehl_ps(closest, closest));
+		closest = _mm_min_ss(closest, _mm_shuffle_ps(closest, closest, 1));
+		return _mm_cvtss_f32(closest);
+#elif defined(__ARM_NEON)
+		const float32x4_t edgeX = vld1q_f32(dx);
+		const float32x4_t edgeY = vld1q_f32(dy);
+		const float32x4_t cross = vsubq_f32(vmulq_n_f32(edgeX, vy), vmulq_n_f32(edgeY, vx));
+		const float32x4_t offsetX = vsubq_f32(vld1q_f32(x), vdupq_n_f32(sx));
+		const float32x4_t offsetY = vsubq_f32(vld1q_f32(y), vdupq_n_f32(sy));
+		const float32x4_t uB = vsubq_f32(vmulq_n_f32(offsetY, vx), vmulq_n_f32(offsetX, vy));
+		const float32x4_t uA = vsubq_f32(vmulq_f32(edgeX, offsetY), vmulq_f32(edgeY, offsetX));
+		const float32x4_t zero = vdupq_n_f32(0.f);
+		const uint32x4_t hit = vandq_u32(vandq_u32(vcgtq_f32(cross, zero), vcgeq_f32(uB, zero)),
+			vandq_u32(vcltq_f32(uB, cross), vcgeq_f32(uA, zero)));
+		if(!(vgetq_lane_u32(hit, 0) | vgetq_lane_u32(hit, 1) | vgetq_lane_u32(hit, 2) | vgetq_lane_u32(hit, 3)))
+			return 1.f;
+		float fraction[4];
+		float divisor[4];
+		uint32_t isHit[4];
+		vst1q_f32(fraction, uA);
+		vst1q_f32(divisor, cross);
+		vst1q_u32(isHit, hit);
+		float closest = 1.f;
+		for(int i = 0; i < 4; ++i)
+			if(isHit[i])
+				closest = min(closest, fraction[i] / divisor[i]);
+		return closest;
+#else
+		float closest = 1.f;
+		for(int i = 0; i < 4; ++i)
+		{
+			float cross = dx[i] * vy - dy[i] * vx;
+			if(cross > 0.f)
+			{
+				float offsetX = x[i] - sx;
+				float offsetY = y[i] - sy;
+				float uB = vx * offsetY - vy * offsetX;
+				float uA = dx[i] * offsetY - dy[i] * offsetX;
+				if((uB >= 0.f) & (uB < cross) & (uA >= 0.f))
+					closest = min(closest, uA / cross);
+			}
+		}
+		return closest;
+#endif
+	}
+
+
+
 	// Trace out outlines from an image frame.
 	void Trace(const ImageBuffer &image, int frame, vector<vector<Point>> &raw)
 	{
@@ -38,6 +119,10 @@ namespace {
 		};
 		raw.clear();
 
+		// Decode the frame's alpha all at once, rather than pixel by pixel.
+		vector<uint8_t> alpha;
+		image.GetAlphaPlane(frame, alpha);
+
 		auto hasOutline = vector<bool>(numPixels, false);
 		vector<int> directions;
 		vector<Point> points;
@@ -50,7 +135,7 @@ namespace {
 			// Find a pixel with some renderable color data (i.e. a non-zero alpha component).
 			for( ; start < numPixels; ++start)
 			{
-				if(image.GetAlpha(0, start % width, start / width))
+				if(alpha[start])
 				{
 					// If this pixel is not part of an existing outline, trace it.
 					if(!hasOutline[start])
@@ -58,7 +143,7 @@ namespace {
 					// Otherwise, advance to the next transparent pixel.
 					// (any non-transparent pixels will belong to the existing outline).
 					for(++start; start < numPixels; ++start)
-						if(!(image.GetAlpha(0, start % width, start / width)))
+						if(!alpha[start])
 							break;
 				}
 			}
@@ -101,7 +186,7 @@ namespace {
 					// First, ensure an offset in this direction would access a valid pixel index.
 					if(next[0] >= 0 && next[0] < width && next[1] >= 0 && next[1] < height)
 						// If that pixel has color data, then add it to the outline.
-						if(image.GetAlpha(0, next[0], next[1]))
+						if(alpha[next[1] * width + next[0]])
 							break;
 
 					// Otherwise, advance to the next direction.
@@ -154,7 +239,7 @@ namespace {
 				Point shift = Point(
 					step[out0][0] * scale[out0 & 1] + step[out1][0] * scale[out1 & 1],
 					step[out0][1] * scale[out0 & 1] + step[out1][1] * scale[out1 & 1]).Unit();
-				shift *= image.GetAlpha(0, p[0], p[1]) * (1. / 255.) - .5;
+				shift *= alpha[pos] * (1. / 255.) - .5;
 				points.push_back(shift + Point(p[0], p[1]));
 
 				p[0] += step[next][0];
@@ -283,14 +368,16 @@ namespace {
 // Construct a mask from the alpha channel of an RGBA-formatted image.
 void Mask::Create(const ImageBuffer &image, int frame)
 {
-	outlines.clear();
-	radius = 0.;
+	shape.reset();
+	scale = 1.;
 
 	vector<vector<Point>> raw;
 	Trace(image, frame, raw);
 	if(raw.empty())
 		return;
 
+	auto created = make_shared<Shape>();
+	vector<vector<Point>> &outlines = created->outlines;
 	outlines.reserve(raw.size());
 	for(auto &edge : raw)
 	{
@@ -301,11 +388,16 @@ void Mask::Create(const ImageBuffer &image, int frame)
 		if(outline.size() <= 2)
 			continue;
 
-		radius = max(radius, ComputeRadius(outline));
+		created->radius = max(created->radius, ComputeRadius(outline));
 		outlines.push_back(std::move(outline));
 		outlines.back().shrink_to_fit();
 	}
 	outlines.shrink_to_fit();
+	if(outlines.empty())
+		return;
+
+	created->BuildEdges();
+	shape = std::move(created);
 }
 
 
@@ -313,7 +405,7 @@ void Mask::Create(const ImageBuffer &image, int frame)
 // Check whether a mask was successfully generated from the image.
 bool Mask::IsLoaded() const
 {
-	return !outlines.empty();
+	return shape != nullptr;
 }
 
 
@@ -327,6 +419,7 @@ double Mask::Collide(Point sA, Point vA, Angle facing) const
 {
 	// Bail out if we're too far away to possibly be touching.
 	double distance = sA.Length();
+	double radius = Radius();
 	if(!IsLoaded() || distance > radius + vA.Length())
 		return 1.;
 
@@ -334,9 +427,10 @@ double Mask::Collide(Point sA, Point vA, Angle facing) const
 	if(DistanceSquared(Point(), sA, sA + vA) > (radius * radius))
 		return 1.;
 
-	// Rotate into the mask's frame of reference.
-	sA = (-facing).Rotate(sA);
-	vA = (-facing).Rotate(vA);
+	// Rotate into the mask's frame of reference. Scaling the segment down to
+	// the outlines' size does not change how far along it they are hit.
+	sA = (-facing).Rotate(sA) / scale;
+	vA = (-facing).Rotate(vA) / scale;
 
 	// If this point is contained within the mask, a ray drawn out from it will
 	// intersect the mask an even number of times. If that ray coincides with an
@@ -345,10 +439,10 @@ double Mask::Collide(Point sA, Point vA, Angle facing) const
 
 	// For simplicity, use a ray pointing straight downwards. A segment then
 	// intersects only if its x coordinates span the point's coordinates.
-	if(distance <= radius && Contains(sA))
+	if(distance <= radius && shape->Contains(sA))
 		return 0.;
 
-	return Intersection(sA, vA);
+	return shape->Intersection(sA, vA);
 }
 
 
@@ -356,11 +450,11 @@ double Mask::Collide(Point sA, Point vA, Angle facing) const
 // Check whether the mask contains the given point.
 bool Mask::Contains(Point point, Angle facing) const
 {
-	if(!IsLoaded() || point.Length() > radius)
+	if(!IsLoaded() || point.Length() > Radius())
 		return false;
 
 	// Rotate into the mask's frame of reference.
-	return Contains((-facing).Rotate(point));
+	return shape->Contains((-facing).Rotate(point) / scale);
 }
 
 
@@ -370,16 +464,18 @@ bool Mask::Contains(Point point, Angle facing) const
 bool Mask::WithinRing(Point point, Angle facing, double inner, double outer) const
 {
 	// Bail out if the object is too far away to possibly be touched.
-	if(!IsLoaded() || inner > point.Length() + radius || outer < point.Length() - radius)
+	if(!IsLoaded() || inner > point.Length() + Radius() || outer < point.Length() - Radius())
 		return false;
 
 	// Rotate into the mask's frame of reference.
-	point = (-facing).Rotate(point);
+	point = (-facing).Rotate(point) / scale;
 	// For efficiency, compare to range^2 instead of range.
+	inner /= scale;
+	outer /= scale;
 	inner *= inner;
 	outer *= outer;
 
-	for(auto &&outline : outlines)
+	for(auto &&outline : shape->outlines)
 		for(auto &&p : outline)
 		{
 			double pSquared = p.DistanceSquared(point);
@@ -400,41 +496,62 @@ double Mask::Range(Point point, Angle facing) const
 		return range;
 
 	// Rotate into the mask's frame of reference.
-	point = (-facing).Rotate(point);
-	if(Contains(point))
+	point = (-facing).Rotate(point) / scale;
+	if(shape->Contains(point))
 		return 0.;
 
-	for(auto &&outline : outlines)
+	for(auto &&outline : shape->outlines)
 		for(auto &&p : outline)
 			range = min(range, p.Distance(point));
 
-	return range;
+	return range * scale;
 }
 
 
 
 double Mask::Radius() const
 {
-	return radius;
+	return shape ? shape->radius * scale : 0.;
 }
 
 
 
-// Get the individual outlines that comprise this mask.
+// Get the individual outlines that comprise this mask, at 1x scale.
 const vector<vector<Point>> &Mask::Outlines() const
 {
-	return outlines;
+	static const vector<vector<Point>> EMPTY;
+	return shape ? shape->outlines : EMPTY;
 }
 
 
 
+// Get the scale that this mask's outlines are applied at.
+double Mask::Scale() const
+{
+	return scale;
+}
+
+
+
+size_t Mask::ShapeBytes() const
+{
+	if(!shape)
+		return 0;
+
+	size_t bytes = sizeof(Shape) + shape->outlines.capacity() * sizeof(vector<Point>)
+		+ shape->edges.capacity() * sizeof(EdgeGroup) + shape->spans.capacity() * sizeof(EdgeSpan);
+	for(const vector<Point> &outline : shape->outlines)
+		bytes += outline.capacity() * sizeof(Point);
+	return bytes;
+}
+
+
+
+// Scale the mask. The scaled mask shares the outlines of this one.
 Mask Mask::operator*(double scale) const
 {
 	Mask newMask = *this;
-	for(auto &outline : newMask.outlines)
-		for(Point &p : outline)
-			p *= scale;
-	newMask.radius *= scale;
+	newMask.scale *= scale;
 	return newMask;
 }
 
@@ -447,34 +564,73 @@ Mask operator*(double scale, const Mask &mask)
 
 
 
-double Mask::Intersection(Point sA, Point vA) const
+void Mask::Shape::BuildEdges()
 {
-	// Keep track of the closest intersection point found.
-	double closest = 1.;
-
-	for(auto &&outline : outlines)
+	edges.clear();
+	spans.clear();
+	for(size_t i = 0; i < outlines.size(); ++i)
 	{
-		Point prev = outline.back();
-		for(auto &&next : outline)
+		const vector<Point> &outline = outlines[i];
+		// Edge j goes from point j - 1 to point j. The last group of each span
+		// is padded with empty edges, which never intersect anything.
+		for(size_t first = 0; first < outline.size(); first += 4 * SPAN_GROUPS)
 		{
-			// Check if there is an intersection. (If not, the cross would be 0.) If
-			// there is, handle it only if it is a point where the segment is
-			// entering the polygon rather than exiting it (i.e. cross > 0).
-			Point vB = next - prev;
-			double cross = vB.Cross(vA);
-			if(cross > 0.)
+			EdgeSpan span;
+			span.min = span.max = outline[first ? first - 1 : outline.size() - 1];
+			span.outline = i;
+			span.first = first;
+			span.firstGroup = edges.size();
+
+			const size_t end = min(outline.size(), first + 4 * SPAN_GROUPS);
+			for(size_t j = first; j < end; ++j)
 			{
-				Point vS = prev - sA;
-				double uB = vA.Cross(vS);
-				double uA = vB.Cross(vS);
-				// If the intersection occurs somewhere within this segment of the
-				// outline, find out how far along the query vector it occurs and
-				// remember it if it is the closest so far.
-				if((uB >= 0.) & (uB < cross) & (uA >= 0.))
-					closest = min(closest, uA / cross);
+				if((j - first) % 4 == 0)
+					edges.push_back(EdgeGroup{});
+				const Point &prev = outline[j ? j - 1 : outline.size() - 1];
+				const Point &next = outline[j];
+				EdgeGroup &group = edges.back();
+				const size_t k = (j - first) % 4;
+				group.x[k] = prev.X();
+				group.y[k] = prev.Y();
+				group.dx[k] = next.X() - prev.X();
+				group.dy[k] = next.Y() - prev.Y();
+				span.min = Point(min(span.min.X(), next.X()), min(span.min.Y(), next.Y()));
+				span.max = Point(max(span.max.X(), next.X()), max(span.max.Y(), next.Y()));
 			}
+			span.endGroup = edges.size();
+			spans.push_back(span);
+		}
+	}
+	edges.shrink_to_fit();
+	spans.shrink_to_fit();
+}
+
+
+
+double Mask::Shape::Intersection(Point sA, Point vA) const
+{
+	// Only the edges near the segment need to be checked.
+	const Point end = sA + vA;
+	const Point low(min(sA.X(), end.X()), min(sA.Y(), end.Y()));
+	const Point high(max(sA.X(), end.X()), max(sA.Y(), end.Y()));
+
+	// Keep track of the closest intersection point found.
+	float closest = 1.f;
+	const float sx = sA.X();
+	const float sy = sA.Y();
+	const float vx = vA.X();
+	const float vy = vA.Y();
+	for(const EdgeSpan &span : spans)
+	{
+		if(span.max.X() < low.X() || span.min.X() > high.X() || span.max.Y() < low.Y() || span.min.Y() > high.Y())
+			continue;
 
-			prev = next;
+		// Check if there is an intersection, and handle it only if it is a point
+		// where the segment is entering the polygon rather than exiting it.
+		for(size_t i = span.firstGroup; i < span.endGroup; ++i)
+		{
+			const EdgeGroup &group = edges[i];
+			closest = min(closest, FirstEntry(group.x, group.y, group.dx, group.dy, sx, sy, vx, vy));
 		}
 	}
 	return closest;
@@ -482,11 +638,8 @@ double Mask::Intersection(Point sA, Point vA) const
 
 
 
-bool Mask::Contains(Point point) const
+bool Mask::Shape::Contains(Point point) const
 {
-	if(!IsLoaded())
-		return false;
-
 	// If this point is contained within the mask, a ray drawn out from it will
 	// intersect the mask an odd number of times. If that ray coincides with an
 	// edge, ignore that edge, and count all segments as closed at the start and
@@ -497,11 +650,19 @@ bool Mask::Contains(Point point) const
 	// Compute the number of intersections across all outlines, not just one, as the
 	// outlines may be nested (i.e. holes) or discontinuous (multiple separate shapes).
 	int intersections = 0;
-	for(auto &&outline : outlines)
+	for(const EdgeSpan &span : spans)
 	{
-		Point prev = outline.back();
-		for(auto &&next : outline)
+		// The ray can't cross any of the span's edges if it starts below them
+		// or is off to one side.
+		if(point.X() < span.min.X() || point.X() > span.max.X() || point.Y() > span.max.Y())
+			continue;
+
+		const vector<Point> &outline = outlines[span.outline];
+		const size_t end = min(outline.size(), span.first + 4 * SPAN_GROUPS);
+		for(size_t i = span.first; i < end; ++i)
 		{
+			const Point &prev = outline[i ? i - 1 : outline.size() - 1];
+			const Point &next = outline[i];
 			if(prev.X() != next.X())
 				if((prev.X() <= point.X()) == (point.X() < next.X()))
 				{
@@ -509,7 +670,6 @@ bool Mask::Contains(Point point) const
 						(point.X() - prev.X()) / (next.X() - prev.X());
 					intersections += (y >= point.Y());
 				}
-			prev = next;
 		}
 	}
 	// If the number of intersections is odd, the point is within the mask.
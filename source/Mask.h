@@ -19,6 +19,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Angle.h"
 #include "Point.h"
 
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 class ImageBuffer;
@@ -58,22 +60,65 @@ public:
 	// Get the maximum distance from the center of this mask.
 	double Radius() const;
 
-	// Get the individual outlines that comprise this mask.
+	// Get the individual outlines that comprise this mask, at 1x scale.
 	const std::vector<std::vector<Point>> &Outlines() const;
-
-	// Scale all the points in the mask.
+	// Get the scale that this mask's outlines are applied at.
+	double Scale() const;
+	// Get the memory used by this mask's outlines and edges, in bytes. Scaled
+	// copies of a mask share these with it.
+	size_t ShapeBytes() const;
+
+	// Scale the mask. The scaled mask shares the outlines of this one, so
+	// masks can be made at many scales without copying them.
 	Mask operator*(double scale) const;
 	friend Mask operator*(double scale, const Mask &mask);
 
 
 private:
-	double Intersection(Point sA, Point vA) const;
-	bool Contains(Point point) const;
+	// Four consecutive outline edges, stored so they can be tested together.
+	class EdgeGroup {
+	public:
+		float x[4];
+		float y[4];
+		float dx[4];
+		float dy[4];
+	};
+
+	// The bounding box of a run of consecutive edges of one outline. Queries
+	// skip every run whose box they do not touch.
+	class EdgeSpan {
+	public:
+		Point min;
+		Point max;
+		// The outline, its first edge, and the edge groups for this run.
+		std::size_t outline;
+		std::size_t first;
+		std::size_t firstGroup;
+		std::size_t endGroup;
+	};
+
+
+	// The outlines at 1x scale, and everything derived from them. All the
+	// query functions work in this frame of reference.
+	class Shape {
+	public:
+		// Build the edge groups and spans from the outlines.
+		void BuildEdges();
+		double Intersection(Point sA, Point vA) const;
+		bool Contains(Point point) const;
+
+	public:
+		std::vector<std::vector<Point>> outlines;
+		double radius = 0.;
+
+		std::vector<EdgeGroup> edges;
+		std::vector<EdgeSpan> spans;
+	};
 
 
 private:
-	std::vector<std::vector<Point>> outlines;
-	double radius = 0.;
+	std::shared_ptr<const Shape> shape;
+	double scale = 1.;
 };
 
 
@@ -16,18 +16,30 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "MaskManager.h"
 
 #include "Logger.h"
+#include "MemoryStats.h"
 #include "Sprite.h"
 
+#include <algorithm>
+#include <set>
+
 using namespace std;
 
 namespace {
-	constexpr double DEFAULT = 1.;
-	map<const Sprite *, bool> warned;
+	// The sprites that have already been warned about, since the warnings may
+	// come from any of the threads that check collisions.
+	mutex warnedMutex;
+	set<const Sprite *> warned;
 
 	string PrintScale(double s)
 	{
 		return to_string(100. * s) + "%";
 	}
+
+	bool ShouldWarn(const Sprite *sprite)
+	{
+		lock_guard<mutex> lock(warnedMutex);
+		return warned.insert(sprite).second;
+	}
 }
 
 
@@ -36,12 +48,16 @@ namespace {
 void MaskManager::SetMasks(const Sprite *sprite, vector<Mask> &&masks)
 {
 	lock_guard<mutex> lock(spriteMutex);
-	auto &scales = spriteMasks[sprite];
-	auto it = scales.find(DEFAULT);
-	if(it != scales.end())
-		it->second.swap(masks);
-	else
-		scales.emplace(DEFAULT, std::move(masks));
+	SpriteMasks &entry = Entry(sprite);
+	entry.base.swap(masks);
+	int64_t bytes = 0;
+	for(const Mask &mask : entry.base)
+		bytes += sizeof(Mask) + mask.ShapeBytes();
+	for(const Mask &mask : masks)
+		bytes -= sizeof(Mask) + mask.ShapeBytes();
+	MemoryStats::Add(MemoryStats::Category::MASKS, bytes);
+	if(isScaled)
+		Scale(entry);
 }
 
 
@@ -49,12 +65,18 @@ void MaskManager::SetMasks(const Sprite *sprite, vector<Mask> &&masks)
 // Add a scale that the given sprite needs to have a mask for.
 void MaskManager::RegisterScale(const Sprite *sprite, double scale)
 {
+	if(scale == 1.)
+		return;
+
 	lock_guard<mutex> lock(spriteMutex);
-	auto &scales = spriteMasks[sprite];
-	auto lb = scales.lower_bound(scale);
-	if(lb == scales.end() || lb->first != scale)
-		scales.emplace_hint(lb, scale, vector<Mask>{});
-	else if(!lb->second.empty())
+	SpriteMasks &entry = Entry(sprite);
+	auto it = find(entry.scales.begin(), entry.scales.end(), scale);
+	if(it == entry.scales.end())
+	{
+		entry.scales.push_back(scale);
+		entry.scaled.emplace_back();
+	}
+	else if(!entry.scaled[it - entry.scales.begin()].empty())
 		Logger::LogError("Collision mask for sprite \"" + sprite->Name() + "\" at scale "
 			+ PrintScale(scale) + " was already generated.");
 }
@@ -64,29 +86,10 @@ void MaskManager::RegisterScale(const Sprite *sprite, double scale)
 // Create the scaled versions of all masks from the 1x versions.
 void MaskManager::ScaleMasks()
 {
-	for(auto &spriteScales : spriteMasks)
-	{
-		auto &scales = spriteScales.second;
-		auto baseIt = scales.find(DEFAULT);
-		if(baseIt == scales.end() || baseIt->second.empty())
-			continue;
-
-		const auto &baseMasks = baseIt->second;
-		for(auto it = scales.begin(); it != baseIt; ++it)
-		{
-			auto &masks = it->second;
-			masks.reserve(baseMasks.size());
-			for(auto &&mask : baseMasks)
-				masks.push_back(mask * it->first);
-		}
-		for(auto it = next(baseIt); it != scales.end(); ++it)
-		{
-			auto &masks = it->second;
-			masks.reserve(baseMasks.size());
-			for(auto &&mask : baseMasks)
-				masks.push_back(mask * it->first);
-		}
-	}
+	lock_guard<mutex> lock(spriteMutex);
+	for(SpriteMasks &entry : spriteMasks)
+		Scale(entry);
+	isScaled = true;
 }
 
 
@@ -96,32 +99,69 @@ void MaskManager::ScaleMasks()
 const std::vector<Mask> &MaskManager::GetMasks(const Sprite *sprite, double scale) const
 {
 	static const vector<Mask> EMPTY;
-	const auto scalesIt = spriteMasks.find(sprite);
-	if(scalesIt == spriteMasks.end())
+	if(sprite->maskIndex < 0)
 	{
-		if(warned.insert(make_pair(sprite, true)).second)
+		if(ShouldWarn(sprite))
 			Logger::LogError("Warning: sprite \"" + sprite->Name() + "\": no collision masks found.");
 		return EMPTY;
 	}
 
-	const auto &scales = scalesIt->second;
-	const auto maskIt = scales.find(scale);
-	if(maskIt != scales.end() && !maskIt->second.empty())
-		return maskIt->second;
+	// Most sprites are only used at 1x scale, and the others at only a few.
+	const SpriteMasks &entry = spriteMasks[sprite->maskIndex];
+	auto it = find(entry.scales.begin(), entry.scales.end(), scale);
+	const vector<Mask> *masks = (scale == 1.) ? &entry.base
+		: (it != entry.scales.end()) ? &entry.scaled[it - entry.scales.begin()] : nullptr;
+	if(masks && !masks->empty())
+		return *masks;
 
 	// Shouldn't happen, but just in case, print some details about the scales for this sprite (once).
-	if(warned.insert(make_pair(sprite, true)).second)
+	if(ShouldWarn(sprite))
 	{
 		string warning = "Warning: sprite \"" + sprite->Name() + "\": collision mask not found.";
-		if(scales.empty()) warning += " (No scaled masks.)";
-		else if(maskIt != scales.end()) warning += " (No masks for scale " + PrintScale(scale) + ".)";
+		if(entry.base.empty()) warning += " (No scaled masks.)";
+		else if(masks) warning += " (No masks for scale " + PrintScale(scale) + ".)";
 		else
 		{
 			warning += "\n\t" + PrintScale(scale) + " not found in known scales:";
-			for(auto &&s : scales)
-				warning += "\n\t\t" + PrintScale(s.first);
+			warning += "\n\t\t" + PrintScale(1.);
+			for(double s : entry.scales)
+				warning += "\n\t\t" + PrintScale(s);
 		}
 		Logger::LogError(warning);
 	}
 	return EMPTY;
 }
+
+
+
+MaskManager::SpriteMasks &MaskManager::Entry(const Sprite *sprite)
+{
+	if(sprite->maskIndex < 0)
+	{
+		sprite->maskIndex = spriteMasks.size();
+		spriteMasks.push_back(SpriteMasks{sprite, {}, {}, {}});
+	}
+	return spriteMasks[sprite->maskIndex];
+}
+
+
+
+void MaskManager::Scale(SpriteMasks &entry)
+{
+	if(entry.base.empty())
+		return;
+
+	// The scaled masks share the base masks' outlines, so this is cheap. Each
+	// set is finished before it is swapped in, since the game may be running.
+	for(size_t i = 0; i < entry.scales.size(); ++i)
+	{
+		if(!entry.scaled[i].empty())
+			continue;
+		vector<Mask> masks;
+		masks.reserve(entry.base.size());
+		for(auto &&mask : entry.base)
+			masks.push_back(mask * entry.scales[i]);
+		entry.scaled[i].swap(masks);
+		MemoryStats::Add(MemoryStats::Category::MASKS, entry.scaled[i].size() * sizeof(Mask));
+	}
+}
@@ -18,7 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Mask.h"
 
-#include <map>
+#include <deque>
 #include <mutex>
 #include <vector>
 
@@ -28,7 +28,11 @@ class Sprite;
 
 
 // Class that stores the masks for sprites that have them, and provides the correct
-// mask for the scale that the sprite requests.
+// mask for the scale that the sprite requests. Each sprite's outlines are only
+// stored once; the masks at other scales share them. Masks are added while the
+// game data is loading, after which they can be read from any thread without
+// locking. Sprites that are streamed in after startup get their masks, at every
+// scale, when they finish loading; until then they have none.
 class MaskManager {
 public:
 	// Move the given masks at 1x scale into the manager's storage.
@@ -37,7 +41,8 @@ public:
 	// Add a scale that the given sprite needs to have a mask for.
 	void RegisterScale(const Sprite *sprite, double scale);
 
-	// Create the scaled versions of all masks from the 1x versions.
+	// Create the scaled versions of all masks from the 1x versions. After this,
+	// any masks that are added are scaled right away.
 	void ScaleMasks();
 
 	// Get the masks for the given sprite at the given scale. If a
@@ -46,10 +51,32 @@ public:
 
 
 private:
-	std::map<const Sprite *, std::map<double, std::vector<Mask>>> spriteMasks;
+	// The masks for one sprite, at each of the scales it is used at.
+	class SpriteMasks {
+	public:
+		const Sprite *sprite;
+		std::vector<Mask> base;
+		std::vector<double> scales;
+		std::vector<std::vector<Mask>> scaled;
+	};
+
+
+private:
+	// Get the masks for the given sprite, adding them if need be. The mutex
+	// must be locked when calling this.
+	SpriteMasks &Entry(const Sprite *sprite);
+	// Create any scaled masks this sprite is missing. The mutex must be locked.
+	static void Scale(SpriteMasks &entry);
+
+
+private:
+	// Indexed by each sprite's maskIndex. A deque never moves its elements,
+	// so adding a sprite doesn't disturb anyone reading another one.
+	std::deque<SpriteMasks> spriteMasks;
 
 	// Mutex to make sure different threads don't modify the masks at the same time.
 	std::mutex spriteMutex;
+	bool isScaled = false;
 };
 
 
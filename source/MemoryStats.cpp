@@ -0,0 +1,126 @@
+/* MemoryStats.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "MemoryStats.h"
+
+#include "Profiler.h"
+
+#include <atomic>
+#include <fstream>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+	const int COUNT = static_cast<int>(MemoryStats::Category::COUNT);
+
+	// The names used in reports, and the names of the profiler's counters,
+	// which are grouped together because they all begin the same way.
+	const char *const NAMES[COUNT] = {
+		"data nodes",
+		"object sets",
+		"image buffers",
+		"GPU textures",
+		"collision masks",
+		"decoded sounds",
+		"conditions",
+		"engine objects"
+	};
+	const char *const COUNTER_NAMES[COUNT] = {
+		"Memory: data nodes MB",
+		"Memory: object sets MB",
+		"Memory: image buffers MB",
+		"Memory: GPU textures MB",
+		"Memory: collision masks MB",
+		"Memory: decoded sounds MB",
+		"Memory: conditions MB",
+		"Memory: engine objects MB"
+	};
+
+	atomic<int64_t> totals[COUNT];
+}
+
+
+
+void MemoryStats::Add(Category category, int64_t bytes)
+{
+	totals[static_cast<int>(category)].fetch_add(bytes, memory_order_relaxed);
+}
+
+
+
+void MemoryStats::SetBytes(Category category, int64_t bytes)
+{
+	totals[static_cast<int>(category)].store(bytes, memory_order_relaxed);
+}
+
+
+
+int64_t MemoryStats::Bytes(Category category)
+{
+	return totals[static_cast<int>(category)].load(memory_order_relaxed);
+}
+
+
+
+const char *MemoryStats::Name(Category category)
+{
+	return NAMES[static_cast<int>(category)];
+}
+
+
+
+int64_t MemoryStats::ResidentBytes()
+{
+#ifdef __linux__
+	// The second number in this file is the number of resident pages.
+	ifstream statm("/proc/self/statm");
+	int64_t size = 0;
+	int64_t resident = 0;
+	if(statm >> size >> resident)
+		return resident * sysconf(_SC_PAGESIZE);
+#endif
+	return -1;
+}
+
+
+
+void MemoryStats::UpdateCounters()
+{
+	if(!Profiler::IsEnabled())
+		return;
+
+	for(int i = 0; i < COUNT; ++i)
+		Profiler::SetCounter(COUNTER_NAMES[i], totals[i].load(memory_order_relaxed) / 1048576.);
+	int64_t resident = ResidentBytes();
+	if(resident >= 0)
+		Profiler::SetCounter("Memory: resident MB", resident / 1048576.);
+}
+
+
+
+string MemoryStats::Report()
+{
+	string report = "subsystem,bytes\n";
+	for(int i = 0; i < COUNT; ++i)
+		report += string(NAMES[i]) + ',' + to_string(totals[i].load(memory_order_relaxed)) + '\n';
+	int64_t resident = ResidentBytes();
+	if(resident >= 0)
+		report += "resident," + to_string(resident) + '\n';
+	return report;
+}
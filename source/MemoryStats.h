@@ -0,0 +1,67 @@
+/* MemoryStats.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef MEMORY_STATS_H_
+#define MEMORY_STATS_H_
+
+#include <cstdint>
+#include <string>
+
+
+
+// Keeps a running total of the memory used by each of the game's larger
+// subsystems, so that it is possible to tell which of them is responsible when
+// the game uses too much. Each subsystem reports what it allocates and frees,
+// or, if that is easier, sets its total directly. The totals are estimates of
+// the objects' own storage: memory that they point to elsewhere is counted by
+// whichever subsystem owns it, or not at all. Updating a total is a single
+// relaxed atomic operation, so it is safe and cheap to do from any thread.
+class MemoryStats {
+public:
+	enum class Category : int {
+		DATA_NODES,
+		OBJECT_SETS,
+		IMAGE_BUFFERS,
+		TEXTURES,
+		MASKS,
+		SOUNDS,
+		CONDITIONS,
+		ENGINE_OBJECTS,
+		COUNT
+	};
+
+
+public:
+	// Add the given number of bytes to a category's total. A negative number
+	// records that memory was freed.
+	static void Add(Category category, int64_t bytes);
+	// Replace a category's total.
+	static void SetBytes(Category category, int64_t bytes);
+	static int64_t Bytes(Category category);
+	static const char *Name(Category category);
+
+	// Get how much of the process's memory is actually in RAM, in bytes, or -1
+	// if that is not known on this platform.
+	static int64_t ResidentBytes();
+
+	// Copy each total into the profiler's counters, in megabytes.
+	static void UpdateCounters();
+	// Get a table of every total, in bytes, as comma-separated values.
+	static std::string Report();
+};
+
+
+
+#endif
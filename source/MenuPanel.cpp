@@ -116,8 +116,22 @@ void MenuPanel::Step()
 
 void MenuPanel::Draw()
 {
-	glClear(GL_COLOR_BUFFER_BIT);
-	GameData::Background().Draw(Point(), Point());
+	// Panels on top of this one may change the preferences that the starfield
+	// depends on, so it is only reused while this panel is on top.
+	if(!GetUI()->IsTop(this))
+		background.Invalidate();
+	else if(!background.IsValid() && background.Begin())
+	{
+		GameData::Background().Draw(Point(), Point());
+		background.End();
+	}
+	if(background.IsValid())
+		background.Draw();
+	else
+	{
+		glClear(GL_COLOR_BUFFER_BIT);
+		GameData::Background().Draw(Point(), Point());
+	}
 
 	Information info;
 	if(player.IsLoaded() && !player.IsDead())
@@ -166,6 +180,14 @@ void MenuPanel::Draw()
 
 
 
+// Only the credits move, and only while this panel is on top.
+bool MenuPanel::IsAnimated() const noexcept
+{
+	return !credits.empty() && !scrollingPaused && GetUI()->IsTop(this);
+}
+
+
+
 bool MenuPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool isNewPress)
 {
 	if(player.IsLoaded() && (key == 'e' || command.Has(Command::MENU) || key == SDLK_AC_BACK))
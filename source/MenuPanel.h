@@ -18,6 +18,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Panel.h"
 
+#include "PanelCache.h"
+
 #include <string>
 #include <vector>
 
@@ -36,6 +38,7 @@ public:
 
 	virtual void Step() override;
 	virtual void Draw() override;
+	virtual bool IsAnimated() const noexcept override;
 
 
 protected:
@@ -53,6 +56,9 @@ private:
 	UI &gamePanels;
 
 	const Interface *mainMenuUi;
+	// The starfield behind the menu does not move, so while this panel is on
+	// top it is drawn once and then copied to the screen each frame.
+	PanelCache background;
 
 	std::vector<std::string> credits;
 	long long int scroll = 0;
@@ -169,8 +169,8 @@ void Minable::Place(double energy, double beltRadius)
 
 // Move the object forward one step. If it has been reduced to zero hull, it
 // will "explode" instead of moving, creating flotsam and explosion effects.
-// In that case it will return false, meaning it should be deleted.
-bool Minable::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
+// In that case it marks itself for removal.
+void Minable::Move(vector<Visual> &visuals, vector<Flotsam> &flotsam)
 {
 	if(hull < 0)
 	{
@@ -195,11 +195,12 @@ bool Minable::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 			// a distribution with occasional very good payoffs.
 			for(int amount = Random::Binomial(it.second, .25); amount > 0; amount -= Flotsam::TONS_PER_BOX)
 			{
-				flotsam.emplace_back(new Flotsam(it.first, min(amount, Flotsam::TONS_PER_BOX)));
-				flotsam.back()->Place(*this);
+				flotsam.emplace_back(it.first, min(amount, Flotsam::TONS_PER_BOX));
+				flotsam.back().Place(*this);
 			}
 		}
-		return false;
+		MarkForRemoval();
+		return;
 	}
 
 	// Spin the object.
@@ -215,8 +216,6 @@ bool Minable::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 	// will be rendered correctly.
 	velocity = newPosition - position;
 	position = newPosition;
-
-	return true;
 }
 
 
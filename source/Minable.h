@@ -20,7 +20,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Angle.h"
 
-#include <list>
 #include <map>
 #include <memory>
 #include <string>
@@ -61,8 +60,8 @@ public:
 
 	// Move the object forward one step. If it has been reduced to zero hull, it
 	// will "explode" instead of moving, creating flotsam and explosion effects.
-	// In that case it will return false, meaning it should be deleted.
-	bool Move(std::vector<Visual> &visuals, std::list<std::shared_ptr<Flotsam>> &flotsam);
+	// In that case it marks itself for removal.
+	void Move(std::vector<Visual> &visuals, std::vector<Flotsam> &flotsam);
 
 	// Damage this object (because a projectile collided with it).
 	void TakeDamage(const Projectile &projectile);
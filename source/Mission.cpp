@@ -27,6 +27,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Planet.h"
 #include "PlayerInfo.h"
 #include "Random.h"
+#include "RouteCache.h"
 #include "Ship.h"
 #include "ShipEvent.h"
 #include "System.h"
@@ -45,11 +46,11 @@ namespace {
 	{
 		vector<int> weight;
 		int total = 0;
-		for(const Trade::Commodity &commodity : GameData::Commodities())
+		for(size_t i = 0; i < GameData::Commodities().size(); ++i)
 		{
 			// For every 100 credits in profit you can make, double the chance
 			// of this commodity being chosen.
-			double profit = to.Trade(commodity.name) - from.Trade(commodity.name);
+			double profit = GameData::CommodityPrice(to, i) - GameData::CommodityPrice(from, i);
 			int w = max<int>(1, 100. * pow(2., profit * .01));
 			weight.push_back(w);
 			total += w;
@@ -579,6 +580,20 @@ bool Mission::IsAtLocation(Location location) const
 
 
 
+// Find which planets this mission can be offered on, if it is offered on
+// landing, or which systems a ship must be in to offer it, if it is offered
+// by boarding or assisting. An empty set means it could be offered anywhere.
+set<const void *> Mission::OfferPlaces() const
+{
+	if(location == BOARDING || location == ASSISTING)
+		return set<const void *>(sourceFilter.Systems().begin(), sourceFilter.Systems().end());
+	if(source)
+		return set<const void *>{source};
+	return set<const void *>(sourceFilter.Planets().begin(), sourceFilter.Planets().end());
+}
+
+
+
 // Information about what you are doing.
 const Ship *Mission::SourceShip() const
 {
@@ -1104,6 +1119,21 @@ void Mission::UpdateNPCs(const PlayerInfo &player)
 
 
 
+// Create the NPC ships that were waiting for the player to visit the given
+// system. The ships that should be placed right away are added to the list,
+// grouped by the NPC they belong to.
+void Mission::MaterializeNPCs(const System *playerSystem, list<list<shared_ptr<Ship>>> &created)
+{
+	for(auto &npc : npcs)
+	{
+		list<shared_ptr<Ship>> ships = npc.Materialize(playerSystem);
+		if(!ships.empty() && npc.ShouldSpawn())
+			created.push_back(std::move(ships));
+	}
+}
+
+
+
 // Checks if the given ship belongs to one of the mission's NPCs.
 bool Mission::HasShip(const shared_ptr<Ship> &ship) const
 {
@@ -1488,17 +1518,17 @@ int Mission::CalculateJumps(const System *sourceSystem)
 	while(!destinations.empty())
 	{
 		// Find the closest destination to this location.
-		DistanceMap distance(sourceSystem,
+		shared_ptr<const DistanceMap> distance = RouteCache::Get(sourceSystem,
 				distanceCalcSettings.WormholeStrat(),
 				distanceCalcSettings.AssumesJumpDrive());
 		auto it = destinations.begin();
 		auto bestIt = it;
-		int bestDays = distance.Days(*bestIt);
+		int bestDays = distance->Days(*bestIt);
 		if(bestDays < 0)
 			bestDays = numeric_limits<int>::max();
 		for(++it; it != destinations.end(); ++it)
 		{
-			int days = distance.Days(*it);
+			int days = distance->Days(*it);
 			if(days >= 0 && days < bestDays)
 			{
 				bestIt = it;
@@ -1511,11 +1541,11 @@ int Mission::CalculateJumps(const System *sourceSystem)
 		expectedJumps += bestDays == numeric_limits<int>::max() ? -1 : bestDays;
 		destinations.erase(bestIt);
 	}
-	DistanceMap distance(sourceSystem,
+	shared_ptr<const DistanceMap> distance = RouteCache::Get(sourceSystem,
 			distanceCalcSettings.WormholeStrat(),
 			distanceCalcSettings.AssumesJumpDrive());
 	// If currently unreachable, this system adds -1 to the deadline, to match previous behavior.
-	expectedJumps += distance.Days(destination->GetSystem());
+	expectedJumps += distance->Days(destination->GetSystem());
 
 	return expectedJumps;
 }
@@ -89,6 +89,10 @@ public:
 	// Find out where this mission is offered.
 	enum Location {SPACEPORT, LANDING, JOB, ASSISTING, BOARDING, SHIPYARD, OUTFITTER};
 	bool IsAtLocation(Location location) const;
+	// Find which planets this mission can be offered on, if it is offered on
+	// landing, or which systems a ship must be in to offer it, if it is offered
+	// by boarding or assisting. An empty set means it could be offered anywhere.
+	std::set<const void *> OfferPlaces() const;
 
 	// Information about what you are doing.
 	const Ship *SourceShip() const;
@@ -162,6 +166,10 @@ public:
 	const std::list<NPC> &NPCs() const;
 	// Update which NPCs are active based on their spawn and despawn conditions.
 	void UpdateNPCs(const PlayerInfo &player);
+	// Create the NPC ships that were waiting for the player to visit the given
+	// system. The ships that should be placed right away are added to the list,
+	// grouped by the NPC they belong to.
+	void MaterializeNPCs(const System *playerSystem, std::list<std::list<std::shared_ptr<Ship>>> &created);
 	// Checks if the given ship belongs to one of the mission's NPCs.
 	bool HasShip(const std::shared_ptr<Ship> &ship) const;
 	// If any event occurs between two ships, check to see if this mission cares
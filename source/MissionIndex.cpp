@@ -0,0 +1,96 @@
+/* MissionIndex.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "MissionIndex.h"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace std;
+
+
+
+// Forget the index, so that it is built again the next time it is used.
+void MissionIndex::Clear()
+{
+	isBuilt = false;
+	missions.clear();
+	landing = Bucket();
+	boarding = Bucket();
+	assisting = Bucket();
+}
+
+
+
+// Build the index for the given missions, unless it is already built.
+void MissionIndex::Update(const Set<Mission> &missions)
+{
+	// Looking up a mission by name may add an empty one, which must be indexed
+	// too, since every mission must be checked just as if there were no index.
+	if(isBuilt && this->missions.size() == static_cast<size_t>(missions.size()))
+		return;
+
+	Clear();
+	isBuilt = true;
+	for(const auto &it : missions)
+	{
+		const Mission &mission = it.second;
+		const size_t position = this->missions.size();
+		this->missions.push_back(&mission);
+
+		Bucket &bucket = mission.IsAtLocation(Mission::BOARDING) ? boarding
+			: mission.IsAtLocation(Mission::ASSISTING) ? assisting : landing;
+		const set<const void *> places = mission.OfferPlaces();
+		if(places.empty())
+			bucket.anywhere.push_back(position);
+		for(const void *place : places)
+			bucket.byPlace[place].push_back(position);
+	}
+}
+
+
+
+// Get every mission that might be offered when landing on the given planet.
+void MissionIndex::Landing(const Planet *planet, vector<const Mission *> &result) const
+{
+	Find(landing, planet, result);
+}
+
+
+
+// Get every mission of the given location (boarding or assisting) that might
+// be offered by a ship in the given system.
+void MissionIndex::Boarding(Mission::Location location, const System *system, vector<const Mission *> &result) const
+{
+	Find(location == Mission::BOARDING ? boarding : assisting, system, result);
+}
+
+
+
+void MissionIndex::Find(const Bucket &bucket, const void *place, vector<const Mission *> &result) const
+{
+	result.clear();
+	static const vector<size_t> NONE;
+	auto it = bucket.byPlace.find(place);
+	const vector<size_t> &here = (it == bucket.byPlace.end() ? NONE : it->second);
+
+	// Both lists are in order, so merging them keeps the missions in order.
+	vector<size_t> positions;
+	positions.reserve(here.size() + bucket.anywhere.size());
+	merge(here.begin(), here.end(), bucket.anywhere.begin(), bucket.anywhere.end(), back_inserter(positions));
+	result.reserve(positions.size());
+	for(size_t position : positions)
+		result.push_back(missions[position]);
+}
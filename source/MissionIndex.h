@@ -0,0 +1,70 @@
+/* MissionIndex.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef MISSION_INDEX_H_
+#define MISSION_INDEX_H_
+
+#include "Mission.h"
+#include "Set.h"
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+
+
+// An index of where each mission might be offered, so that landing on a planet
+// or boarding a ship only needs to check the missions that could be offered
+// there instead of every mission in the game. The missions are always given in
+// the same order as when iterating over all of them.
+class MissionIndex {
+public:
+	// Forget the index, so that it is built again the next time it is used.
+	void Clear();
+	// Build the index for the given missions, unless it is already built.
+	void Update(const Set<Mission> &missions);
+
+	// Get every mission that might be offered when landing on the given planet.
+	void Landing(const Planet *planet, std::vector<const Mission *> &result) const;
+	// Get every mission of the given location (boarding or assisting) that might
+	// be offered by a ship in the given system.
+	void Boarding(Mission::Location location, const System *system, std::vector<const Mission *> &result) const;
+
+
+private:
+	// The missions offered in one kind of place. Each is stored as its position
+	// in the list of all missions.
+	class Bucket {
+	public:
+		// Missions that are only offered in particular planets or systems.
+		std::map<const void *, std::vector<size_t>> byPlace;
+		// Missions that could be offered anywhere.
+		std::vector<size_t> anywhere;
+	};
+
+	void Find(const Bucket &bucket, const void *place, std::vector<const Mission *> &result) const;
+
+
+private:
+	bool isBuilt = false;
+	std::vector<const Mission *> missions;
+	Bucket landing;
+	Bucket boarding;
+	Bucket assisting;
+};
+
+
+
+#endif
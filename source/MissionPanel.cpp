@@ -979,9 +979,10 @@ Point MissionPanel::DrawList(const list<Mission> &list, Point pos, const std::li
 			continue;
 
 		pos.Y() += 20.;
+		bool canAccept = (&list == &available ? it->CanAccept(player) : IsSatisfied(*it));
 		if(separateDeadlineOrPossible && !separated
 				&& ((player.ShouldSortSeparateDeadline() && it->Deadline())
-						|| (player.ShouldSortSeparatePossible() && !it->CanAccept(player))))
+						|| (player.ShouldSortSeparatePossible() && !canAccept)))
 		{
 			pos.Y() += 8.;
 			separated = true;
@@ -1004,7 +1005,6 @@ Point MissionPanel::DrawList(const list<Mission> &list, Point pos, const std::li
 		if(it->Deadline())
 			SpriteShader::Draw(fast, pos + Point(-4., 8.));
 
-		bool canAccept = (&list == &available ? it->CanAccept(player) : IsSatisfied(*it));
 		font.Draw({it->Name(), {SIDE_WIDTH - 11, Truncate::BACK}},
 			pos, (!canAccept ? dim : isSelected ? selected : unselected));
 	}
@@ -16,11 +16,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Music.h"
 
 #include "Files.h"
+#include "ThreadPlacement.h"
 
 #include <SDL2/SDL_rwops.h>
 #include <mad.h>
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <map>
 
@@ -32,6 +34,9 @@ namespace {
 	// How many samples to put in each output block. Because the output is in
 	// stereo, the duration of the sample is half this amount:
 	const size_t OUTPUT_CHUNK = 32768;
+	// How many blocks the ring holds: one being played, up to two more that
+	// are ready, and one being decoded.
+	const size_t SLOTS = 4;
 
 	map<string, string> paths;
 }
@@ -66,8 +71,11 @@ void Music::Init(const vector<string> &sources)
 // Music constructor, which starts the decoding thread. Initially, the thread
 // has no file to read, so it will sleep until a file is specified.
 Music::Music()
-	: silence(OUTPUT_CHUNK, 0)
+	: silence(OUTPUT_CHUNK, 0), slots(SLOTS), filled(0), freed(0), generation(0), hasNewFile(false), done(false)
 {
+	for(Slot &slot : slots)
+		slot.samples.resize(OUTPUT_CHUNK);
+
 	// Don't start the thread until this object is fully constructed.
 	thread = std::thread(&Music::Decode, this);
 }
@@ -113,9 +121,8 @@ void Music::SetSource(const string &name)
 	else
 		nextFile = Files::Open(path);
 	hasNewFile = true;
-
-	// Also clear any decoded data left over from the previous file.
-	next.clear();
+	// Any decoded data left over from the previous file will be skipped.
+	++generation;
 
 	// Notify the decoding thread that it can start.
 	lock.unlock();
@@ -135,25 +142,30 @@ const string &Music::GetSource() const
 // Get the next audio buffer to play.
 const vector<int16_t> &Music::NextChunk()
 {
-	// Check whether the "next" buffer is ready.
-	unique_lock<mutex> lock(decodeMutex);
-	if(next.size() < OUTPUT_CHUNK)
-		return silence;
-
-	// If the next buffer is ready, move a chunk of data into the output buffer.
-	// All output buffers need to be the same size so that we can fade between
-	// two different sources.
-	current.clear();
-	current.insert(current.begin(), next.begin(), next.begin() + OUTPUT_CHUNK);
-	next.erase(next.begin(), next.begin() + OUTPUT_CHUNK);
-
-	// Once the lock is unlocked, notify the decoding thread to continue.
-	lock.unlock();
-	condition.notify_all();
-
-	// Return the buffer.
-	return current;
+	// The block that was returned last time has been played, so the decoding
+	// thread may reuse its slot.
+	if(isHolding)
+	{
+		freed.fetch_add(1, memory_order_release);
+		isHolding = false;
+		condition.notify_all();
+	}
 
+	// Return the next finished block, skipping any from an earlier source. All
+	// blocks are the same size so that we can fade between two different sources.
+	unsigned current = generation.load(memory_order_relaxed);
+	while(freed.load(memory_order_relaxed) != filled.load(memory_order_acquire))
+	{
+		const Slot &slot = slots[freed.load(memory_order_relaxed) % SLOTS];
+		if(slot.generation == current)
+		{
+			isHolding = true;
+			return slot.samples;
+		}
+		freed.fetch_add(1, memory_order_release);
+		condition.notify_all();
+	}
+	return silence;
 }
 
 
@@ -161,6 +173,8 @@ const vector<int16_t> &Music::NextChunk()
 // Entry point for the decoding thread.
 void Music::Decode()
 {
+	ThreadPlacement::Assign(ThreadPlacement::Role::AUDIO);
+
 	// This vector will store the input from the file.
 	vector<unsigned char> input(INPUT_CHUNK, 0);
 	// Objects for MP3 decoding:
@@ -172,6 +186,7 @@ void Music::Decode()
 	{
 		// First, wait until a new file has been specified or we're done.
 		SDL_RWops *file = nullptr;
+		unsigned fileGeneration = 0;
 		while(!file)
 		{
 			unique_lock<mutex> lock(decodeMutex);
@@ -186,6 +201,7 @@ void Music::Decode()
 			file = nextFile;
 			nextFile = nullptr;
 			hasNewFile = false;
+			fileGeneration = generation;
 		}
 
 		// Now, we have a file to read. Initialize the decoder.
@@ -193,22 +209,17 @@ void Music::Decode()
 		mad_frame_init(&frame);
 		mad_synth_init(&synth);
 
+		// The slot being decoded into, and how many samples it has so far.
+		Slot *slot = nullptr;
+		size_t fill = 0;
 		// Loop until we are asked to switch files.
-		while(true)
+		bool stop = false;
+		while(!stop)
 		{
-			// If the "next" buffer has filled up, wait until it is retrieved.
-			// Generally try to queue up two chunks worth of samples in it, just
-			// in case NextChunk() gets called twice in rapid succession.
-			unique_lock<mutex> lock(decodeMutex);
-			while(!done && next.size() >= 2 * OUTPUT_CHUNK)
-				condition.wait(lock);
 			// Check if we're done or if we need to switch files.
 			if(done || hasNewFile)
 				break;
 
-			// The lock can be freed until we start filling the output buffer.
-			lock.unlock();
-
 			// See if any input data is left undecoded in the stream. Typically
 			// this is because the last block of input contained a fraction of a
 			// full MP3 frame.
@@ -252,15 +263,21 @@ void Music::Decode()
 					synth.pcm.samples[synth.pcm.channels > 1]
 				};
 
-				// For this part, we need access to the output buffer.
-				lock.lock();
-				if(done || hasNewFile)
-					break;
-
 				// We'll alternate what channel we read from each time through the loop.
 				bool channel = false;
 				for(unsigned i = 0; i < 2 * synth.pcm.length; ++i)
 				{
+					// Decode straight into the next free slot of the ring. Generally
+					// try to queue up two blocks, just in case NextChunk() gets
+					// called twice in rapid succession.
+					if(!slot)
+					{
+						stop = !WaitForSlot();
+						if(stop)
+							break;
+						slot = &slots[filled.load(memory_order_relaxed) % SLOTS];
+					}
+
 					// Read the next sample from the next channel.
 					mad_fixed_t sample = *channels[channel]++;
 					channel = !channel;
@@ -271,12 +288,19 @@ void Music::Decode()
 #pragma GCC diagnostic ignored "-Wold-style-cast"
 					sample = max(-MAD_F_ONE, min(MAD_F_ONE - 1, sample));
 #pragma GCC diagnostic pop
-					next.push_back(sample >> (MAD_F_FRACBITS + 1 - 16));
+					slot->samples[fill++] = sample >> (MAD_F_FRACBITS + 1 - 16);
+
+					// Once the slot is full, hand it over to NextChunk().
+					if(fill == OUTPUT_CHUNK)
+					{
+						slot->generation = fileGeneration;
+						filled.fetch_add(1, memory_order_release);
+						slot = nullptr;
+						fill = 0;
+					}
 				}
-				// Now, the "next" buffer can be used by others. In theory, the
-				// NextChunk() function could take what's in that buffer while
-				// we are right in the middle of this decoding cycle.
-				lock.unlock();
+				if(stop)
+					break;
 			}
 		}
 
@@ -287,3 +311,22 @@ void Music::Decode()
 		SDL_RWclose(file);
 	}
 }
+
+
+
+// Wait until the slot after the last filled one is no longer in use by the
+// main thread. Return false if decoding should stop instead.
+bool Music::WaitForSlot()
+{
+	unique_lock<mutex> lock(decodeMutex);
+	while(true)
+	{
+		if(done || hasNewFile)
+			return false;
+		if(filled.load(memory_order_relaxed) - freed.load(memory_order_acquire) < SLOTS)
+			return true;
+		// NextChunk() signals without taking the lock, so a signal may be
+		// missed. Check again after a short while in that case.
+		condition.wait_for(lock, chrono::milliseconds(10));
+	}
+}
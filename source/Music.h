@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef MUSIC_H_
 #define MUSIC_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <cstdio>
@@ -48,17 +49,39 @@ public:
 	const std::vector<int16_t> &NextChunk();
 
 
+private:
+	// One block of decoded audio, and which source it was decoded from.
+	class Slot {
+	public:
+		std::vector<int16_t> samples;
+		unsigned generation = 0;
+	};
+
+
 private:
 	// This is the entry point for the decoding thread.
 	void Decode();
+	// Wait until the decoding thread may write into the next slot. This returns
+	// false if it should stop decoding the current file instead.
+	bool WaitForSlot();
 
 
 private:
-	// Buffers for storing the decoded audio sample. The "silence" buffer holds
-	// a block of silence to be returned if nothing was read from the file.
+	// The "silence" buffer holds a block of silence to be returned if nothing
+	// was read from the file.
 	std::vector<int16_t> silence;
-	std::vector<int16_t> next;
-	std::vector<int16_t> current;
+	// The decoding thread writes blocks straight into this ring of slots, and
+	// NextChunk() hands them out. "Filled" counts the blocks the decoding
+	// thread has finished, and "freed" the ones the main thread is done with,
+	// so neither thread has to lock the other out to pass a block along. The
+	// block returned by the last NextChunk() is only freed on the next call.
+	std::vector<Slot> slots;
+	std::atomic<size_t> filled;
+	std::atomic<size_t> freed;
+	bool isHolding = false;
+	// This increases each time the source changes, so blocks that were decoded
+	// from an earlier source can be skipped.
+	std::atomic<unsigned> generation;
 
 	std::string currentSource;
 	std::string previousPath;
@@ -66,8 +89,8 @@ private:
 	// thread. When the decode thread takes possession of it, it sets this
 	// pointer to null.
 	struct SDL_RWops *nextFile = nullptr;
-	bool hasNewFile = false;
-	bool done = false;
+	std::atomic<bool> hasNewFile;
+	std::atomic<bool> done;
 
 	std::thread thread;
 	std::mutex decodeMutex;
@@ -14,11 +14,12 @@ PARTICULAR PURPOSE.  See the GNU General Public License for more details.
 
 void Music::Init(const std::vector<std::string> &sources) {}
 
-Music::Music() {}
+Music::Music()
+	: silence(32768, 0), filled(0), freed(0), generation(0), hasNewFile(false), done(false) {}
 Music::~Music() {}
 
 void Music::SetSource(const std::string &name) {}
-const std::vector<int16_t> &Music::NextChunk() { return next; }
+const std::vector<int16_t> &Music::NextChunk() { return silence; }
 
 void Music::Decode() {}
 
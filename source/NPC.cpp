@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "DataWriter.h"
 #include "Dialog.h"
+#include "Fleet.h"
 #include "text/Format.h"
 #include "GameData.h"
 #include "Government.h"
@@ -230,6 +231,15 @@ void NPC::Load(const DataNode &node, const string &missionName)
 				child.PrintTrace(message);
 			}
 		}
+		else if(child.Token(0) == "deferred" && child.Size() >= 3)
+		{
+			// Loading fleets from a save file that have not been turned into ships yet.
+			deferredSystem = GameData::Systems().Get(child.Token(1));
+			deferredSeed = child.Value(2);
+			for(const DataNode &grand : child)
+				if(grand.Token(0) == "fleet" && grand.Size() >= 2)
+					deferredFleets.push_back(GameData::Fleets().Get(grand.Token(1)));
+		}
 		else if(child.Token(0) == "fleet")
 		{
 			if(child.HasChildren())
@@ -353,6 +363,16 @@ void NPC::Save(DataWriter &out) const
 				out.EndChild();
 			}
 		}
+		if(!deferredFleets.empty())
+		{
+			out.Write("deferred", deferredSystem->Name(), deferredSeed);
+			out.BeginChild();
+			{
+				for(const Fleet *fleet : deferredFleets)
+					out.Write("fleet", fleet->Name());
+			}
+			out.EndChild();
+		}
 	}
 	out.EndChild();
 }
@@ -429,6 +449,10 @@ void NPC::UpdateSpawning(const PlayerInfo &player)
 	// conditions. (Any such NPC will never be spawned in-game.)
 	if(passedSpawnConditions && !toDespawn.IsEmpty() && !passedDespawnConditions)
 		passedDespawnConditions = toDespawn.Test(player.Conditions());
+
+	// If the player is taking off in the system where the deferred fleets start
+	// out, they must be created now so that they can be placed.
+	Materialize(player.GetSystem());
 }
 
 
@@ -449,6 +473,41 @@ const list<shared_ptr<Ship>> NPC::Ships() const
 
 
 
+// Create the ships of any fleets that were waiting for the player to visit
+// the given system, and return the ships that were created.
+list<shared_ptr<Ship>> NPC::Materialize(const System *playerSystem)
+{
+	list<shared_ptr<Ship>> created;
+	if(deferredFleets.empty() || !deferredSystem || playerSystem != deferredSystem)
+		return created;
+
+	// Each fleet draws from its own random stream, so the ships do not depend
+	// on what else happened before the player arrived.
+	for(size_t i = 0; i < deferredFleets.size(); ++i)
+	{
+		Random::Stream stream(deferredSeed, i);
+		list<shared_ptr<Ship>> fleetShips;
+		deferredFleets[i]->Place(*deferredSystem, fleetShips, false);
+		for(const shared_ptr<Ship> &ship : fleetShips)
+		{
+			ship->SetGovernment(government);
+			ship->SetIsSpecial();
+			ship->SetPersonality(personality);
+			if(personality.IsDerelict())
+				ship->Disable();
+			Fleet::Place(*deferredSystem, *ship);
+		}
+		created.splice(created.end(), fleetShips);
+	}
+	deferredFleets.clear();
+	deferredSystem = nullptr;
+
+	ships.insert(ships.end(), created.begin(), created.end());
+	return created;
+}
+
+
+
 // Handle the given ShipEvent.
 void NPC::Do(const ShipEvent &event, PlayerInfo &player, UI *ui, bool isVisible)
 {
@@ -535,6 +594,10 @@ bool NPC::HasSucceeded(const System *playerSystem, bool ignoreIfDespawnable) con
 
 	if(HasFailed())
 		return false;
+	// Ships that have not been created yet are somewhere other than where the
+	// player is, and nothing can have been done to them.
+	if(!deferredFleets.empty() && (succeedIf || mustAccompany))
+		return false;
 
 	// Evaluate the status of each ship in this NPC block. If it has `accompany`
 	// and is alive then it cannot be disabled and must be in the player's system.
@@ -591,6 +654,8 @@ bool NPC::IsLeftBehind(const System *playerSystem) const
 		return true;
 	if(!mustAccompany)
 		return false;
+	if(!deferredFleets.empty())
+		return true;
 
 	for(const shared_ptr<Ship> &ship : ships)
 		if(ship->IsDisabled() || ship->GetSystem() != playerSystem)
@@ -685,8 +750,23 @@ NPC NPC::Instantiate(map<string, string> &subs, const System *origin, const Syst
 		result.ships.push_back(make_shared<Ship>(**shipIt));
 		result.ships.back()->SetName(*nameIt);
 	}
+	// Stock fleets that start out away from the player do not need their ships
+	// until the player gets there. At least one ship is always created, so that
+	// it can be named in the mission text.
+	bool canDefer = !overrideFleetCargo && !personality.IsEntering() && !result.planet
+		&& result.system != origin;
 	for(const ExclusiveItem<Fleet> &fleet : fleets)
-		fleet->Place(*result.system, result.ships, false, !overrideFleetCargo);
+	{
+		if(canDefer && fleet.IsStock() && !result.ships.empty())
+			result.deferredFleets.push_back(&*fleet);
+		else
+			fleet->Place(*result.system, result.ships, false, !overrideFleetCargo);
+	}
+	if(!result.deferredFleets.empty())
+	{
+		result.deferredSystem = result.system;
+		result.deferredSeed = Random::Int();
+	}
 	// Ships should either "enter" the system or start out there.
 	for(const shared_ptr<Ship> &ship : result.ships)
 	{
@@ -26,10 +26,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Personality.h"
 #include "Phrase.h"
 
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 class DataNode;
 class DataWriter;
@@ -77,6 +79,9 @@ public:
 
 	// Get the ships associated with this set of NPCs.
 	const std::list<std::shared_ptr<Ship>> Ships() const;
+	// Create the ships of any fleets that were waiting for the player to visit
+	// the given system, and return the ships that were created.
+	std::list<std::shared_ptr<Ship>> Materialize(const System *playerSystem);
 
 	// Handle the given ShipEvent.
 	enum Trigger {KILL, BOARD, ASSIST, DISABLE, SCAN_CARGO, SCAN_OUTFITS, CAPTURE, PROVOKE};
@@ -143,6 +148,12 @@ private:
 	std::list<const Ship *> stockShips;
 	std::list<std::string> shipNames;
 	std::list<ExclusiveItem<Fleet>> fleets;
+	// Stock fleets that start out away from the player are only turned into
+	// ships once the player visits the system they start out in. The seed
+	// makes sure that the same ships are created no matter when that happens.
+	std::vector<const Fleet *> deferredFleets;
+	const System *deferredSystem = nullptr;
+	uint32_t deferredSeed = 0;
 
 	// This must be done to each ship in this set to complete the mission:
 	int succeedIf = 0;
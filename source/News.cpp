@@ -108,14 +108,23 @@ bool News::IsEmpty() const
 
 
 
-// Check if this news item is available given the player's planet and conditions.
-bool News::Matches(const Planet *planet, const ConditionsStore &conditions) const
+// Check if this news item's location includes the given planet, regardless
+// of the player's conditions.
+bool News::MatchesLocation(const Planet *planet) const
 {
 	// If no location filter is specified, it should never match. This can be
 	// used to create news items that are never shown until an event "activates"
 	// them by specifying their location.
 	// Similarly, by updating a news item with "remove location", it can be deactivated.
-	return location.IsEmpty() ? false : (location.Matches(planet) && toShow.Test(conditions));
+	return !location.IsEmpty() && location.Matches(planet);
+}
+
+
+
+// Check if this news item is available given the player's planet and conditions.
+bool News::Matches(const Planet *planet, const ConditionsStore &conditions) const
+{
+	return MatchesLocation(planet) && toShow.Test(conditions);
 }
 
 
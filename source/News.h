@@ -37,6 +37,9 @@ public:
 
 	// Check whether this news item has anything to say.
 	bool IsEmpty() const;
+	// Check if this news item's location includes the given planet, regardless
+	// of the player's conditions.
+	bool MatchesLocation(const Planet *planet) const;
 	// Check if this news item is available given the player's planet and conditions.
 	bool Matches(const Planet *planet, const ConditionsStore &conditions) const;
 
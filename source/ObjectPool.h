@@ -0,0 +1,298 @@
+/* ObjectPool.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OBJECT_POOL_H_
+#define OBJECT_POOL_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+template <class Type>
+class ObjectPool;
+
+
+
+// A reference to an object in an ObjectPool. Unlike a pointer, a handle stays
+// valid while other objects are added to or removed from the pool, and once
+// its own object has been removed, the pool no longer finds anything for it.
+// A default constructed handle does not refer to anything.
+template <class Type>
+class PoolHandle {
+public:
+	PoolHandle() = default;
+
+	bool operator==(const PoolHandle &other) const;
+	bool operator!=(const PoolHandle &other) const;
+
+
+private:
+	PoolHandle(uint32_t slot, uint32_t generation);
+
+
+private:
+	uint32_t slot = 0;
+	// No slot is ever in generation zero.
+	uint32_t generation = 0;
+
+	friend class ObjectPool<Type>;
+};
+
+
+
+// A pool of objects that are stored next to each other in memory, in the order
+// they were added, and that are referred to by handles rather than by shared
+// pointers. Removing objects keeps the pool's memory so that it can be reused
+// for new objects, which means that once the pool has grown large enough,
+// adding and removing objects does not allocate anything.
+template <class Type>
+class ObjectPool {
+public:
+	using Handle = PoolHandle<Type>;
+	using iterator = typename std::vector<Type>::iterator;
+	using const_iterator = typename std::vector<Type>::const_iterator;
+
+
+public:
+	// Add an object to the end of the pool.
+	Handle Add(Type object);
+	// Add each of the given objects, and clear that list.
+	void Append(std::vector<Type> &added);
+
+	// Get the object the given handle refers to, or null if it has been removed.
+	Type *Get(const Handle &handle);
+	const Type *Get(const Handle &handle) const;
+	// Get a handle for an object that is in this pool.
+	Handle GetHandle(const Type &object) const;
+
+	// Remove all the objects that should be removed, keeping the rest in order.
+	void Prune();
+	void Clear();
+
+	bool empty() const noexcept;
+	std::size_t size() const noexcept;
+
+	iterator begin() noexcept;
+	const_iterator begin() const noexcept;
+	iterator end() noexcept;
+	const_iterator end() const noexcept;
+
+
+private:
+	// Forget about the object in the given slot, and let the slot be reused.
+	void Release(uint32_t slot);
+
+
+private:
+	// Handles refer to slots, which keep track of where each object is.
+	class Slot {
+	public:
+		uint32_t index = 0;
+		uint32_t generation = 1;
+	};
+
+	std::vector<Type> objects;
+	// The slot that belongs to each of the objects.
+	std::vector<uint32_t> objectSlots;
+	std::vector<Slot> slots;
+	std::vector<uint32_t> freeSlots;
+};
+
+
+
+template <class Type>
+PoolHandle<Type>::PoolHandle(uint32_t slot, uint32_t generation)
+	: slot(slot), generation(generation)
+{
+}
+
+
+
+template <class Type>
+bool PoolHandle<Type>::operator==(const PoolHandle &other) const
+{
+	return slot == other.slot && generation == other.generation;
+}
+
+
+
+template <class Type>
+bool PoolHandle<Type>::operator!=(const PoolHandle &other) const
+{
+	return !(*this == other);
+}
+
+
+
+template <class Type>
+typename ObjectPool<Type>::Handle ObjectPool<Type>::Add(Type object)
+{
+	uint32_t slot;
+	if(freeSlots.empty())
+	{
+		slot = slots.size();
+		slots.emplace_back();
+	}
+	else
+	{
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	slots[slot].index = objects.size();
+	objects.push_back(std::move(object));
+	objectSlots.push_back(slot);
+
+	return Handle(slot, slots[slot].generation);
+}
+
+
+
+template <class Type>
+void ObjectPool<Type>::Append(std::vector<Type> &added)
+{
+	for(Type &object : added)
+		Add(std::move(object));
+	added.clear();
+}
+
+
+
+template <class Type>
+Type *ObjectPool<Type>::Get(const Handle &handle)
+{
+	if(handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation)
+		return nullptr;
+	return &objects[slots[handle.slot].index];
+}
+
+
+
+template <class Type>
+const Type *ObjectPool<Type>::Get(const Handle &handle) const
+{
+	if(handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation)
+		return nullptr;
+	return &objects[slots[handle.slot].index];
+}
+
+
+
+template <class Type>
+typename ObjectPool<Type>::Handle ObjectPool<Type>::GetHandle(const Type &object) const
+{
+	uint32_t slot = objectSlots[&object - objects.data()];
+	return Handle(slot, slots[slot].generation);
+}
+
+
+
+template <class Type>
+void ObjectPool<Type>::Prune()
+{
+	std::size_t out = 0;
+	for(std::size_t in = 0; in < objects.size(); ++in)
+	{
+		uint32_t slot = objectSlots[in];
+		if(objects[in].ShouldBeRemoved())
+		{
+			Release(slot);
+			continue;
+		}
+		if(out != in)
+		{
+			objects[out] = std::move(objects[in]);
+			objectSlots[out] = slot;
+		}
+		slots[slot].index = out;
+		++out;
+	}
+	objects.erase(objects.begin() + out, objects.end());
+	objectSlots.resize(out);
+}
+
+
+
+template <class Type>
+void ObjectPool<Type>::Clear()
+{
+	for(uint32_t slot : objectSlots)
+		Release(slot);
+	objects.clear();
+	objectSlots.clear();
+}
+
+
+
+template <class Type>
+bool ObjectPool<Type>::empty() const noexcept
+{
+	return objects.empty();
+}
+
+
+
+template <class Type>
+std::size_t ObjectPool<Type>::size() const noexcept
+{
+	return objects.size();
+}
+
+
+
+template <class Type>
+typename ObjectPool<Type>::iterator ObjectPool<Type>::begin() noexcept
+{
+	return objects.begin();
+}
+
+
+
+template <class Type>
+typename ObjectPool<Type>::const_iterator ObjectPool<Type>::begin() const noexcept
+{
+	return objects.begin();
+}
+
+
+
+template <class Type>
+typename ObjectPool<Type>::iterator ObjectPool<Type>::end() noexcept
+{
+	return objects.end();
+}
+
+
+
+template <class Type>
+typename ObjectPool<Type>::const_iterator ObjectPool<Type>::end() const noexcept
+{
+	return objects.end();
+}
+
+
+
+template <class Type>
+void ObjectPool<Type>::Release(uint32_t slot)
+{
+	// Old handles to this slot must never match whatever is put in it next.
+	if(!++slots[slot].generation)
+		slots[slot].generation = 1;
+	freeSlots.push_back(slot);
+}
+
+
+
+#endif
@@ -465,6 +465,13 @@ double Outfit::Get(const string &attribute) const
 
 
 
+double Outfit::Get(AttributeKey attribute) const
+{
+	return attributes.Get(attribute);
+}
+
+
+
 const Dictionary &Outfit::Attributes() const
 {
 	return attributes;
@@ -67,6 +67,7 @@ public:
 
 	double Get(const char *attribute) const;
 	double Get(const std::string &attribute) const;
+	double Get(AttributeKey attribute) const;
 	const Dictionary &Attributes() const;
 
 	// Determine whether the given number of instances of the given outfit can
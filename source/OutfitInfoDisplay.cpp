@@ -231,9 +231,16 @@ OutfitInfoDisplay::OutfitInfoDisplay(const Outfit &outfit, const PlayerInfo &pla
 // Call this every time the ship changes.
 void OutfitInfoDisplay::Update(const Outfit &outfit, const PlayerInfo &player, bool canSell, bool descriptionCollapsed)
 {
-	UpdateDescription(outfit.Description(), outfit.Licenses(), false);
+	// What the player needs to buy or install the outfit can change at any
+	// time, but the rest only changes if the game data is reloaded.
+	if(&outfit != madeFrom || GameData::UniverseRevision() != madeFromRevision)
+	{
+		madeFrom = &outfit;
+		madeFromRevision = GameData::UniverseRevision();
+		UpdateDescription(outfit.Description(), outfit.Licenses(), false);
+		UpdateAttributes(outfit);
+	}
 	UpdateRequirements(outfit, player, canSell, descriptionCollapsed);
-	UpdateAttributes(outfit);
 
 	maximumHeight = max(descriptionHeight, max(requirementsHeight, attributesHeight));
 }
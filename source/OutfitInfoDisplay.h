@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "ItemInfoDisplay.h"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -62,6 +63,12 @@ private:
 	std::vector<std::string> requirementLabels;
 	std::vector<std::string> requirementValues;
 	int requirementsHeight = 0;
+
+	// The outfit that the description and attributes were made for, and the
+	// revision of the game data at the time. Those only depend on the outfit,
+	// so they are not made again while it stays the same.
+	const Outfit *madeFrom = nullptr;
+	uint64_t madeFromRevision = 0;
 };
 
 
@@ -72,6 +72,28 @@ namespace {
 		}
 		return toRefill;
 	}
+
+
+
+	// Group all the outfit changes made to the given ships while this is in
+	// scope, so that each ship only recalculates its loadout once.
+	class LoadoutChange {
+	public:
+		explicit LoadoutChange(const set<Ship *> &ships)
+			: ships(ships)
+		{
+			for(Ship *ship : ships)
+				ship->BeginLoadoutChange();
+		}
+		~LoadoutChange()
+		{
+			for(Ship *ship : ships)
+				ship->FinishLoadoutChange();
+		}
+
+	private:
+		const set<Ship *> ships;
+	};
 }
 
 
@@ -157,10 +179,6 @@ bool OutfitterPanel::HasItem(const string &name) const
 void OutfitterPanel::DrawItem(const string &name, const Point &point, int scrollY)
 {
 	const Outfit *outfit = GameData::Outfits().Get(name);
-	zones.emplace_back(point, Point(OUTFIT_SIZE, OUTFIT_SIZE), outfit, scrollY);
-	if(point.Y() + OUTFIT_SIZE / 2 < Screen::Top() || point.Y() - OUTFIT_SIZE / 2 > Screen::Bottom())
-		return;
-
 	bool isSelected = (outfit == selectedOutfit);
 	bool isOwned = playerShip && playerShip->OutfitCount(outfit);
 	DrawOutfit(*outfit, point, isSelected, isOwned);
@@ -514,6 +532,7 @@ void OutfitterPanel::Buy(bool onlyOwned)
 	}
 
 	int modifier = stoi(selected_quantity.GetSelected());
+	LoadoutChange loadoutChange(playerShips);
 	for(int i = 0; i < modifier && CanBuy(onlyOwned); ++i)
 	{
 		// Buying into cargo, either from storage or from stock/supply.
@@ -621,6 +640,7 @@ void OutfitterPanel::Sell(bool toStorage)
 
 	if(shipsToOutfit.size() > 0)
 	{
+		LoadoutChange loadoutChange(playerShips);
 		for(Ship *ship : shipsToOutfit)
 		{
 			ship->AddOutfit(selectedOutfit, -1);
@@ -960,6 +980,7 @@ void OutfitterPanel::Refill()
 			continue;
 
 		auto toRefill = GetRefillableAmmunition(*ship);
+		LoadoutChange loadoutChange({ship.get()});
 		for(const Outfit *outfit : toRefill)
 		{
 			int neededAmmo = ship->Attributes().CanAdd(*outfit, numeric_limits<int>::max());
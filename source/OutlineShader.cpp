@@ -21,6 +21,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Shader.h"
 #include "Sprite.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <utility>
+
 using namespace std;
 
 namespace {
@@ -31,10 +37,178 @@ namespace {
 	GLint positionI;
 	GLint frameI;
 	GLint frameCountI;
+	GLint firstLayerI;
 	GLint colorI;
 
 	GLuint vao;
 	GLuint vbo;
+
+	// A second program copies outlines that were already drawn into the atlas.
+	Shader cachedShader;
+	GLint cachedScaleI;
+	GLint cachedTransformI;
+	GLint cachedPositionI;
+	GLint cornerI;
+	GLint extentI;
+	GLint cachedColorI;
+
+	GLuint cachedVao;
+
+	// Outlines that are drawn at a fixed size, like the thumbnails in the shops,
+	// are only filtered once and then copied out of this texture.
+	constexpr int ATLAS_SIZE = 2048;
+	// Larger outlines are not worth keeping, since few of them would fit.
+	constexpr int MAX_CACHED_SIZE = 512;
+	// The outlines are stored at a quarter of their brightness, so that edges
+	// brighter than an 8-bit texture can hold are not clipped. The cached
+	// outline shader multiplies them by the same amount.
+	constexpr float CACHED_SCALE = 4.f;
+	GLuint atlas = 0;
+	GLuint atlasFramebuffer = 0;
+	// The atlas is filled in rows. When it is full, it is emptied and refilled.
+	int rowX = 0;
+	int rowY = 0;
+	int rowHeight = 0;
+	// Where in the atlas the outline of each sprite, texture, frame and size is.
+	map<tuple<const Sprite *, GLuint, float, int, int>, pair<int, int>> cached;
+
+
+	// Set where a quad is drawn, given the scale from drawing coordinates to
+	// the area being drawn in.
+	void Place(GLint scale, GLint transform, GLint position, const Point &pos, const Point &size,
+		const Point &unit, float scaleX, float scaleY)
+	{
+		GLfloat scaleValue[2] = {scaleX, scaleY};
+		glUniform2fv(scale, 1, scaleValue);
+
+		Point uw = unit * size.X();
+		Point uh = unit * size.Y();
+		GLfloat transformValue[4] = {
+			static_cast<float>(-uw.Y()),
+			static_cast<float>(uw.X()),
+			static_cast<float>(-uh.X()),
+			static_cast<float>(-uh.Y())
+		};
+		glUniformMatrix2fv(transform, 1, false, transformValue);
+
+		GLfloat positionValue[2] = {
+			static_cast<float>(pos.X()), static_cast<float>(pos.Y())};
+		glUniform2fv(position, 1, positionValue);
+	}
+
+
+
+	// Set up the outline program to filter the given sprite.
+	void Prepare(const Sprite *sprite, const Point &size, const Color &color, float frame, bool isHighDPI)
+	{
+		OpenGL::UseProgram(shader.Object());
+		OpenGL::BindVertexArray(vao);
+
+		GLfloat off[2] = {
+			static_cast<float>(.5 / size.X()),
+			static_cast<float>(.5 / size.Y())};
+		glUniform2fv(offI, 1, off);
+
+		glUniform1f(frameI, frame);
+		glUniform1f(frameCountI, sprite->Frames());
+		glUniform4fv(colorI, 1, color.Get());
+
+		glUniform1f(firstLayerI, sprite->FirstLayer(isHighDPI));
+		OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, sprite->Texture(isHighDPI));
+	}
+
+
+
+	// Find room in the atlas for an outline of the given size. If there is no
+	// room left, everything in the atlas is forgotten to make room.
+	pair<int, int> Allocate(int width, int height)
+	{
+		if(rowX + width > ATLAS_SIZE)
+		{
+			rowX = 0;
+			rowY += rowHeight + 1;
+			rowHeight = 0;
+		}
+		if(rowY + height > ATLAS_SIZE)
+		{
+			cached.clear();
+			rowX = 0;
+			rowY = 0;
+			rowHeight = 0;
+		}
+		pair<int, int> corner(rowX, rowY);
+		rowX += width + 1;
+		rowHeight = max(rowHeight, height);
+		return corner;
+	}
+
+
+
+	// Create the atlas, if it does not exist yet. Returns false if it cannot be used.
+	bool CreateAtlas()
+	{
+		if(atlasFramebuffer)
+			return true;
+
+		glGenTextures(1, &atlas);
+		OpenGL::BindTexture(GL_TEXTURE_2D, atlas);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		GLint screen = 0;
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &screen);
+		glGenFramebuffers(1, &atlasFramebuffer);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, atlasFramebuffer);
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, atlas, 0);
+		bool isComplete = (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+		if(isComplete)
+		{
+			// The space between outlines must be blank, so that filtering does
+			// not bleed one outline into the next.
+			glClearColor(0.f, 0.f, 0.f, 0.f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			glClearColor(0.f, 0.f, 0.f, 1.f);
+		}
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, screen);
+		if(!isComplete)
+		{
+			glDeleteFramebuffers(1, &atlasFramebuffer);
+			OpenGL::DeleteTextures(1, &atlas);
+			atlasFramebuffer = 0;
+			atlas = 0;
+		}
+		return isComplete;
+	}
+
+
+
+	// Draw the outline of the given sprite into the atlas at the given corner.
+	void Render(const Sprite *sprite, const Point &size, float frame, bool isHighDPI,
+		const pair<int, int> &corner, int width, int height)
+	{
+		GLint screen = 0;
+		glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &screen);
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, atlasFramebuffer);
+		glViewport(0, 0, ATLAS_SIZE, ATLAS_SIZE);
+		// Each outline replaces whatever was in its part of the atlas before.
+		glDisable(GL_BLEND);
+
+		Prepare(sprite, size, Color(1.f / CACHED_SCALE, 1.f / CACHED_SCALE), frame, isHighDPI);
+		// Draw in atlas pixels, with the origin in the atlas's center.
+		Point center(corner.first + .5 * (width - ATLAS_SIZE), corner.second + .5 * (height - ATLAS_SIZE));
+		Place(scaleI, transformI, positionI, center, Point(width, height), Point(0., -1.),
+			2.f / ATLAS_SIZE, 2.f / ATLAS_SIZE);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+		glEnable(GL_BLEND);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, screen);
+	}
 }
 
 
@@ -76,6 +250,7 @@ void OutlineShader::Init()
 		"uniform sampler2DArray tex;\n"
 		"uniform float frame;\n"
 		"uniform float frameCount;\n"
+		"uniform float firstLayer;\n"
 		"uniform vec4 color;\n"
 		"uniform vec2 off;\n"
 		"const vec4 weight = vec4(.4, .4, .4, 1.);\n"
@@ -111,7 +286,7 @@ void OutlineShader::Init()
 		"  float first = floor(frame);\n"
 		"  float second = mod(ceil(frame), frameCount);\n"
 		"  float fade = frame - first;\n"
-		"  float sum = mix(Sobel(first), Sobel(second), fade);\n"
+		"  float sum = mix(Sobel(firstLayer + first), Sobel(firstLayer + second), fade);\n"
 		"  finalColor = color * sqrt(sum / 180.f);\n"
 		"}\n";
 
@@ -122,15 +297,16 @@ void OutlineShader::Init()
 	positionI = shader.Uniform("position");
 	frameI = shader.Uniform("frame");
 	frameCountI = shader.Uniform("frameCount");
+	firstLayerI = shader.Uniform("firstLayer");
 	colorI = shader.Uniform("color");
 
-	glUseProgram(shader.Object());
+	OpenGL::UseProgram(shader.Object());
 	glUniform1i(shader.Uniform("tex"), 0);
-	glUseProgram(0);
+	OpenGL::UseProgram(0);
 
 	// Generate the vertex data for drawing sprites.
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -153,7 +329,74 @@ void OutlineShader::Init()
 
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
+
+	static const char *cachedVertexCode =
+		"// vertex cached outline shader\n"
+		"uniform vec2 scale;\n"
+		"uniform vec2 position;\n"
+		"uniform mat2 transform;\n"
+		"uniform vec2 corner;\n"
+		"uniform vec2 extent;\n"
+
+		"in vec2 vert;\n"
+		"in vec2 vertTexCoord;\n"
+
+		"out vec2 fragTexCoord;\n"
+
+		"void main() {\n"
+		"  fragTexCoord = corner + vertTexCoord * extent;\n"
+		"  gl_Position = vec4((transform * vert + position) * scale, 0, 1);\n"
+		"}\n";
+
+	static const char *cachedFragmentCode =
+		"// fragment cached outline shader\n"
+		"precision mediump float;\n"
+		"uniform sampler2D tex;\n"
+		"uniform vec4 color;\n"
+
+		"in vec2 fragTexCoord;\n"
+
+		"out vec4 finalColor;\n"
+
+		"void main() {\n"
+		"  finalColor = color * (4.f * texture(tex, fragTexCoord).a);\n"
+		"}\n";
+
+	cachedShader = Shader(cachedVertexCode, cachedFragmentCode);
+	cachedScaleI = cachedShader.Uniform("scale");
+	cachedTransformI = cachedShader.Uniform("transform");
+	cachedPositionI = cachedShader.Uniform("position");
+	cornerI = cachedShader.Uniform("corner");
+	extentI = cachedShader.Uniform("extent");
+	cachedColorI = cachedShader.Uniform("color");
+
+	OpenGL::UseProgram(cachedShader.Object());
+	glUniform1i(cachedShader.Uniform("tex"), 0);
+	OpenGL::UseProgram(0);
+
+	// The cached outlines are drawn with the same quad.
+	glGenVertexArrays(1, &cachedVao);
+	OpenGL::BindVertexArray(cachedVao);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+	glEnableVertexAttribArray(cachedShader.Attrib("vert"));
+	glVertexAttribPointer(cachedShader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, stride, nullptr);
+
+	glEnableVertexAttribArray(cachedShader.Attrib("vertTexCoord"));
+	glVertexAttribPointer(cachedShader.Attrib("vertTexCoord"), 2, GL_FLOAT, GL_TRUE,
+		stride, reinterpret_cast<const GLvoid*>(2 * sizeof(GLfloat)));
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	OpenGL::BindVertexArray(0);
+
+	// If the shaders are being made again, any atlas made before is no longer valid.
+	atlas = 0;
+	atlasFramebuffer = 0;
+	rowX = 0;
+	rowY = 0;
+	rowHeight = 0;
+	cached.clear();
 }
 
 
@@ -161,40 +404,67 @@ void OutlineShader::Init()
 void OutlineShader::Draw(const Sprite *sprite, const Point &pos, const Point &size,
 	const Color &color, const Point &unit, float frame)
 {
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
-
-	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
-
-	GLfloat off[2] = {
-		static_cast<float>(.5 / size.X()),
-		static_cast<float>(.5 / size.Y())};
-	glUniform2fv(offI, 1, off);
-
-	glUniform1f(frameI, frame);
-	glUniform1f(frameCountI, sprite->Frames());
-
-	Point uw = unit * size.X();
-	Point uh = unit * size.Y();
-	GLfloat transform[4] = {
-		static_cast<float>(-uw.Y()),
-		static_cast<float>(uw.X()),
-		static_cast<float>(-uh.X()),
-		static_cast<float>(-uh.Y())
-	};
-	glUniformMatrix2fv(transformI, 1, false, transform);
+	const bool isHighDPI = unit.Length() * Screen::Zoom() > 50.;
+	Prepare(sprite, size, color, frame, isHighDPI);
+	Place(scaleI, transformI, positionI, pos, size, unit, 2.f / Screen::Width(), -2.f / Screen::Height());
 
-	GLfloat position[2] = {
-		static_cast<float>(pos.X()), static_cast<float>(pos.Y())};
-	glUniform2fv(positionI, 1, position);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+}
 
-	glUniform4fv(colorI, 1, color.Get());
 
-	glBindTexture(GL_TEXTURE_2D_ARRAY, sprite->Texture(unit.Length() * Screen::Zoom() > 50.));
 
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+// Draw an outline that is likely to be drawn again at the same size, such as
+// a thumbnail in a list, using the copy in the atlas if there is one.
+void OutlineShader::DrawCached(const Sprite *sprite, const Point &pos, const Point &size,
+	const Color &color, const Point &unit, float frame)
+{
+	// The outline is stored at the size it covers on the screen, in pixels.
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	const double length = unit.Length();
+	const double pixelsX = size.X() * length * viewport[2] / Screen::Width();
+	const double pixelsY = size.Y() * length * viewport[3] / Screen::Height();
+	const int width = ceil(pixelsX);
+	const int height = ceil(pixelsY);
+
+	// Frames between two others are blended, so they are not worth storing.
+	const bool isHighDPI = length * Screen::Zoom() > 50.;
+	const GLuint texture = sprite->Texture(isHighDPI);
+	if(!texture || frame != floor(frame) || width <= 0 || height <= 0
+			|| width > MAX_CACHED_SIZE || height > MAX_CACHED_SIZE || !CreateAtlas())
+	{
+		Draw(sprite, pos, size, color, unit, frame);
+		return;
+	}
+
+	auto key = make_tuple(sprite, texture, frame, width, height);
+	auto it = cached.find(key);
+	if(it == cached.end())
+	{
+		pair<int, int> corner = Allocate(width, height);
+		Render(sprite, size, frame, isHighDPI, corner, width, height);
+		it = cached.emplace(key, corner).first;
+	}
+
+	OpenGL::UseProgram(cachedShader.Object());
+	OpenGL::BindVertexArray(cachedVao);
+	OpenGL::BindTexture(GL_TEXTURE_2D, atlas);
+
+	GLfloat corner[2] = {
+		static_cast<float>(it->second.first) / ATLAS_SIZE,
+		static_cast<float>(it->second.second) / ATLAS_SIZE};
+	glUniform2fv(cornerI, 1, corner);
+	GLfloat extent[2] = {
+		static_cast<float>(width) / ATLAS_SIZE,
+		static_cast<float>(height) / ATLAS_SIZE};
+	glUniform2fv(extentI, 1, extent);
+	glUniform4fv(cachedColorI, 1, color.Get());
+
+	// The stored outline has the size of the whole pixels it covers, which may
+	// be slightly larger than the outline itself.
+	Point cachedSize(size.X() * width / pixelsX, size.Y() * height / pixelsY);
+	Place(cachedScaleI, cachedTransformI, cachedPositionI, pos, cachedSize, unit,
+		2.f / Screen::Width(), -2.f / Screen::Height());
 
-	glBindVertexArray(0);
-	glUseProgram(0);
+	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 }
@@ -31,6 +31,10 @@ public:
 
 	static void Draw(const Sprite *sprite, const Point &pos, const Point &size,
 		const Color &color, const Point &unit = Point(0., -1.), float frame = 0.f);
+	// Draw an outline that is likely to be drawn again at the same size, such as
+	// a thumbnail in a list. Its filtered image is kept and reused.
+	static void DrawCached(const Sprite *sprite, const Point &pos, const Point &size,
+		const Color &color, const Point &unit = Point(0., -1.), float frame = 0.f);
 };
 
 
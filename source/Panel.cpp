@@ -192,6 +192,15 @@ bool Panel::AllowsFastForward() const noexcept
 
 
 
+// Panels are by default redrawn every frame. The ones that only change in
+// response to events will override this (virtual) function and return false.
+bool Panel::IsAnimated() const noexcept
+{
+	return true;
+}
+
+
+
 // Only override the ones you need; the default action is to return false.
 bool Panel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool isNewPress)
 {
@@ -80,6 +80,12 @@ public:
 	// Is fast-forward allowed to be on when this panel is on top of the GUI stack?
 	virtual bool AllowsFastForward() const noexcept;
 
+	// Check if this panel may look different from one frame to the next even
+	// when it has not received any events, e.g. because it is animated. Panels
+	// that are not animated are only drawn again when they receive an event or
+	// the panels on the stack change. By default, all panels are animated.
+	virtual bool IsAnimated() const noexcept;
+
 	// Return UI associated with this panel
 	UI *GetUI() const noexcept;
 
@@ -186,6 +192,8 @@ private:
 	bool isFullScreen = false;
 	bool trapAllEvents = true;
 	bool isInterruptible = true;
+	// Whether this panel has received events since it was last drawn.
+	bool isDirty = true;
 
 	std::list<Zone> zones;
 
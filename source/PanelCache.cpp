@@ -0,0 +1,142 @@
+/* PanelCache.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "PanelCache.h"
+
+#include "opengl.h"
+
+using namespace std;
+
+namespace {
+	// Get the size of the area being drawn to, in pixels.
+	void ViewportSize(int &width, int &height)
+	{
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		width = viewport[2];
+		height = viewport[3];
+	}
+}
+
+
+
+PanelCache::~PanelCache()
+{
+	Release();
+}
+
+
+
+// Check whether the cache holds an image drawn at the current screen size.
+bool PanelCache::IsValid() const
+{
+	if(!isValid)
+		return false;
+
+	int currentWidth = 0;
+	int currentHeight = 0;
+	ViewportSize(currentWidth, currentHeight);
+	return (currentWidth == width && currentHeight == height);
+}
+
+
+
+// Start drawing into the cache instead of the screen. If the cache cannot
+// be created, this returns false and drawing still goes to the screen.
+bool PanelCache::Begin()
+{
+	isValid = false;
+	int newWidth = 0;
+	int newHeight = 0;
+	ViewportSize(newWidth, newHeight);
+	if(!newWidth || !newHeight)
+		return false;
+	if(newWidth != width || newHeight != height)
+		Release();
+
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &screen);
+	if(!framebuffer)
+	{
+		width = newWidth;
+		height = newHeight;
+
+		glGenTextures(1, &texture);
+		OpenGL::BindTexture(GL_TEXTURE_2D, texture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		OpenGL::BindTexture(GL_TEXTURE_2D, 0);
+
+		glGenFramebuffers(1, &framebuffer);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+		if(glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			glBindFramebuffer(GL_DRAW_FRAMEBUFFER, screen);
+			Release();
+			return false;
+		}
+	}
+	else
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+
+	glClear(GL_COLOR_BUFFER_BIT);
+	return true;
+}
+
+
+
+// Go back to drawing to the screen.
+void PanelCache::End()
+{
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, screen);
+	isValid = true;
+}
+
+
+
+// Copy the cached image to the screen.
+void PanelCache::Draw() const
+{
+	GLint previous = 0;
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, previous);
+}
+
+
+
+// Mark the cached image as out of date.
+void PanelCache::Invalidate()
+{
+	isValid = false;
+}
+
+
+
+// Free the graphics memory used by the cache.
+void PanelCache::Release()
+{
+	if(framebuffer)
+		glDeleteFramebuffers(1, &framebuffer);
+	if(texture)
+		OpenGL::DeleteTextures(1, &texture);
+	framebuffer = 0;
+	texture = 0;
+	width = 0;
+	height = 0;
+	isValid = false;
+}
@@ -0,0 +1,60 @@
+/* PanelCache.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PANEL_CACHE_H_
+#define PANEL_CACHE_H_
+
+
+
+// An offscreen image of part of the panel stack. When the panels under the top
+// one are not changing, the UI draws them into this cache once and then copies
+// it to the screen each frame, instead of drawing each of them again.
+class PanelCache {
+public:
+	PanelCache() noexcept = default;
+	~PanelCache();
+
+	PanelCache(const PanelCache &) = delete;
+	PanelCache &operator=(const PanelCache &) = delete;
+
+	// Check whether the cache holds an image drawn at the current screen size.
+	bool IsValid() const;
+	// Start drawing into the cache instead of the screen. If the cache cannot
+	// be created, this returns false and drawing still goes to the screen.
+	bool Begin();
+	// Go back to drawing to the screen.
+	void End();
+	// Copy the cached image to the screen.
+	void Draw() const;
+
+	// Mark the cached image as out of date.
+	void Invalidate();
+	// Free the graphics memory used by the cache.
+	void Release();
+
+
+private:
+	unsigned framebuffer = 0;
+	unsigned texture = 0;
+	// The framebuffer that was bound when Begin() was called.
+	int screen = 0;
+	int width = 0;
+	int height = 0;
+	bool isValid = false;
+};
+
+
+
+#endif
@@ -0,0 +1,107 @@
+/* Particle.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Particle.h"
+
+#include "Audio.h"
+#include "Effect.h"
+#include "Random.h"
+#include "Sprite.h"
+
+using namespace std;
+
+
+
+// Pick the random values of the given effect.
+Particle::Particle(const Effect &effect, Point pos, Point vel, Angle facing, Point hitVelocity)
+	: effect(&effect), position(pos), velocity(vel),
+	angle(effect.hasAbsoluteAngle ? effect.absoluteAngle : facing), lifetime(effect.lifetime)
+{
+	if(effect.randomLifetime > 0)
+		lifetime += Random::Int(effect.randomLifetime + 1);
+
+	angle += Angle::Random(effect.randomAngle) - Angle::Random(effect.randomAngle);
+	spin = Angle::Random(effect.randomSpin) - Angle::Random(effect.randomSpin);
+
+	if(effect.hasAbsoluteVelocity)
+		velocity = angle.Unit() * effect.absoluteVelocity;
+	else
+	{
+		velocity *= effect.velocityScale;
+		velocity += hitVelocity * (1. - effect.velocityScale);
+	}
+
+	if(effect.randomVelocity)
+		velocity += angle.Unit() * Random::Real() * effect.randomVelocity;
+
+	if(effect.sound)
+		Audio::Play(effect.sound, position);
+
+	if(effect.randomFrameRate)
+		addedFrameRate = effect.randomFrameRate * Random::Real();
+}
+
+
+
+const Effect &Particle::GetEffect() const
+{
+	return *effect;
+}
+
+
+
+// Get the record of this particle that the sprite shader draws, given the
+// step it was created on.
+SpriteShader::ParticleItem Particle::Item(float birth) const
+{
+	SpriteShader::ParticleItem item;
+	item.position[0] = position.X();
+	item.position[1] = position.Y();
+	item.velocity[0] = velocity.X();
+	item.velocity[1] = velocity.Y();
+	item.angle = angle.Degrees();
+	item.spin = spin.Degrees();
+	item.birth = birth;
+	item.lifetime = lifetime;
+
+	// This follows what Body::SetStep() does the first time a Visual is drawn.
+	item.frameRate = effect->frameRate + addedFrameRate / 60.f;
+	item.frameOffset = effect->frameOffset;
+	item.phase = 0.f;
+	if(effect->randomize)
+		item.phase = Random::Real();
+	else if(!effect->startAtZero)
+	{
+		// The animation is in step with every other copy of the effect, rather
+		// than starting when the particle does.
+		item.frameOffset += item.frameRate * birth;
+	}
+	return item;
+}
+
+
+
+// Fill in the size and animation that every particle of the given effect
+// shares.
+void Particle::Animate(const Effect &effect, SpriteShader::Particles &particles)
+{
+	// Visuals are always drawn at the effect's scale, with no zoom.
+	const Sprite *sprite = effect.GetSprite();
+	particles.size[0] = .5f * effect.scale * sprite->Width();
+	particles.size[1] = .5f * effect.scale * sprite->Height();
+	particles.delay = effect.delay;
+	particles.repeat = effect.repeat;
+	particles.rewind = effect.rewind;
+}
@@ -0,0 +1,63 @@
+/* Particle.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PARTICLE_H_
+#define PARTICLE_H_
+
+#include "Angle.h"
+#include "Point.h"
+#include "SpriteShader.h"
+
+class Effect;
+
+
+
+// A Particle is a record of a visual effect that nothing else in the game ever
+// interacts with, like a spark or a puff of afterburner exhaust, as it is when
+// it is created. Unlike a Visual, it is never moved: its position, facing, and
+// animation frame at any later step follow from these starting values, so the
+// sprite shader works them out instead. Creating a Particle picks the random
+// values of the effect just like creating a Visual does.
+class Particle {
+public:
+	Particle(const Effect &effect, Point pos, Point vel, Angle facing, Point hitVelocity = Point());
+
+	const Effect &GetEffect() const;
+
+	// Get the record of this particle that the sprite shader draws, given the
+	// step it was created on.
+	SpriteShader::ParticleItem Item(float birth) const;
+	// Fill in the size and animation that every particle of the given effect
+	// shares.
+	static void Animate(const Effect &effect, SpriteShader::Particles &particles);
+
+
+private:
+	const Effect *effect = nullptr;
+	Point position;
+	Point velocity;
+	Angle angle;
+	Angle spin;
+	int lifetime = 0;
+	// How much faster than the effect's own animation this one runs.
+	float addedFrameRate = 0.f;
+
+	// Allow a Visual to be made from a particle, when particles can't be drawn.
+	friend class Visual;
+};
+
+
+
+#endif
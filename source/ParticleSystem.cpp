@@ -0,0 +1,143 @@
+/* ParticleSystem.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ParticleSystem.h"
+
+#include "DrawList.h"
+#include "Effect.h"
+#include "Particle.h"
+#include "Visual.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	// Beyond this many particles, any new ones are dropped.
+	const size_t MAX_PARTICLES = 1 << 16;
+	// Once this many steps have passed, the epoch is moved up to the current
+	// step. Particles never last nearly this long.
+	const int EPOCH_STEPS = 1 << 16;
+}
+
+
+
+// Remove all the particles.
+void ParticleSystem::Clear()
+{
+	// Keep each effect's vector, so its memory can be reused.
+	for(Group &group : groups)
+		group.items.clear();
+	count = 0;
+}
+
+
+
+// Remove the particles that have ended by the given step.
+void ParticleSystem::Step(int step)
+{
+	if(!count)
+		return;
+
+	const float now = step - epoch;
+	count = 0;
+	for(Group &group : groups)
+	{
+		group.items.erase(remove_if(group.items.begin(), group.items.end(),
+			[now](const SpriteShader::ParticleItem &item) -> bool { return now - item.birth > item.lifetime; }),
+			group.items.end());
+		count += group.items.size();
+	}
+
+	if(step - epoch >= EPOCH_STEPS)
+	{
+		// Moving the epoch does not change any particle's age, so its position
+		// and animation frame stay the same.
+		const float shift = step - epoch;
+		for(Group &group : groups)
+			for(SpriteShader::ParticleItem &item : group.items)
+				item.birth -= shift;
+		epoch = step;
+	}
+}
+
+
+
+// Add the given particles, created on the given step, and clear that list.
+// If particles can't be drawn, they are added to the given list of visuals
+// instead.
+void ParticleSystem::Append(vector<Particle> &added, int step, vector<Visual> &visuals)
+{
+	if(!SpriteShader::CanDrawFields())
+	{
+		for(const Particle &particle : added)
+			visuals.emplace_back(particle);
+		added.clear();
+		return;
+	}
+
+	if(!count)
+		epoch = step;
+	const float birth = step - epoch;
+	// Consecutive particles are usually of the same effect.
+	Group *group = nullptr;
+	for(const Particle &particle : added)
+	{
+		if(count >= MAX_PARTICLES)
+			break;
+
+		const Effect *effect = &particle.GetEffect();
+		if(!group || group->effect != effect)
+		{
+			auto it = find_if(groups.begin(), groups.end(),
+				[effect](const Group &group) -> bool { return group.effect == effect; });
+			if(it == groups.end())
+			{
+				groups.push_back(Group{effect, {}});
+				it = groups.end() - 1;
+			}
+			group = &*it;
+		}
+		group->items.push_back(particle.Item(birth));
+		++count;
+	}
+	added.clear();
+}
+
+
+
+// Add every particle to the given draw list, as of the given step.
+void ParticleSystem::Draw(DrawList &draw, int step) const
+{
+	for(const Group &group : groups)
+	{
+		if(group.items.empty() || !group.effect->HasSprite())
+			continue;
+
+		SpriteShader::Particles particles;
+		Particle::Animate(*group.effect, particles);
+		particles.now = step - epoch;
+		if(!draw.AddParticles(group.effect->GetSprite(), particles, group.items))
+			return;
+	}
+}
+
+
+
+// Get the number of particles.
+size_t ParticleSystem::Size() const
+{
+	return count;
+}
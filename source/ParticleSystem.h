@@ -0,0 +1,73 @@
+/* ParticleSystem.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PARTICLE_SYSTEM_H_
+#define PARTICLE_SYSTEM_H_
+
+#include "SpriteShader.h"
+
+#include <cstddef>
+#include <vector>
+
+class DrawList;
+class Effect;
+class Particle;
+class Visual;
+
+
+
+// Class holding the particles of the effects that ships create every step, like
+// sparks, afterburner exhaust, and hull leaks. A particle is stored as it was
+// when it was created and is never stepped; the sprite shader works out where
+// it is and what it looks like each time it is drawn, and the particles of each
+// effect are drawn together. Other effects, whose timing matters to the rest of
+// the game, are still Visuals.
+class ParticleSystem {
+public:
+	// Remove all the particles.
+	void Clear();
+	// Remove the particles that have ended by the given step.
+	void Step(int step);
+	// Add the given particles, created on the given step, and clear that list.
+	// If particles can't be drawn, they are added to the given list of visuals
+	// instead.
+	void Append(std::vector<Particle> &added, int step, std::vector<Visual> &visuals);
+
+	// Add every particle to the given draw list, as of the given step.
+	void Draw(DrawList &draw, int step) const;
+
+	// Get the number of particles.
+	size_t Size() const;
+
+
+private:
+	class Group {
+	public:
+		const Effect *effect;
+		std::vector<SpriteShader::ParticleItem> items;
+	};
+
+
+private:
+	std::vector<Group> groups;
+	size_t count = 0;
+	// Each particle's birth is stored relative to this step, so that it stays
+	// small enough to be exact as a float.
+	int epoch = 0;
+};
+
+
+
+#endif
@@ -72,16 +72,28 @@ void Person::NeverSpawn()
 
 
 
+// Check whether this person's location allows it to appear in the given
+// system, regardless of whether it is alive or already active.
+bool Person::CanAppearIn(const System *system) const
+{
+	// Because persons always enter a system via one of the regular hyperspace
+	// links, don't create them in systems with no links.
+	if(!system || system->Links().empty())
+		return false;
+
+	return location.IsEmpty() || location.Matches(system);
+}
+
+
+
 // Find out how often this person should appear in the given system. If this
 // person is dead or already active, this will return zero.
 int Person::Frequency(const System *system) const
 {
-	// Because persons always enter a system via one of the regular hyperspace
-	// links, don't create them in systems with no links.
-	if(!system || IsDestroyed() || IsPlaced() || system->Links().empty())
+	if(IsDestroyed() || IsPlaced() || !CanAppearIn(system))
 		return 0;
 
-	return (location.IsEmpty() || location.Matches(system)) ? frequency : 0;
+	return frequency;
 }
 
 
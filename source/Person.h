@@ -39,6 +39,9 @@ public:
 	// Prevent this person from being spawned in any system.
 	void NeverSpawn();
 
+	// Check whether this person's location allows it to appear in the given
+	// system, regardless of whether it is alive or already active.
+	bool CanAppearIn(const System *system) const;
 	// Find out how often this person should appear in the given system. If this
 	// person is dead or already active, this will return zero.
 	int Frequency(const System *system) const;
@@ -21,6 +21,24 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
+namespace {
+	// Replace text only in the part of the given string after the start, which
+	// holds the text of the phrase the replacements belong to.
+	void ReplaceAfter(string &text, size_t start, const string &target, const string &replacement)
+	{
+		if(!start)
+		{
+			Format::ReplaceAll(text, target, replacement);
+			return;
+		}
+		string tail(text, start);
+		Format::ReplaceAll(tail, target, replacement);
+		text.replace(start, string::npos, tail);
+	}
+}
+
+atomic<unsigned> Phrase::generation{1};
+
 
 
 // Replace all occurrences ${phrase name} with the expanded phrase from GameData::Phrases()
@@ -41,7 +59,10 @@ std::string Phrase::ExpandPhrases(const std::string &source)
 		++next;
 		string phraseName = string{source, var + 2, next - var - 3};
 		const Phrase *phrase = GameData::Phrases().Find(phraseName);
-		result.append(phrase ? phrase->Get() : phraseName);
+		if(phrase)
+			phrase->AppendTo(result);
+		else
+			result.append(phraseName);
 	}
 	// Optimization for most common case: no phrase in string:
 	if(!next)
@@ -78,6 +99,7 @@ void Phrase::Load(const DataNode &node)
 		sentences.pop_back();
 		node.PrintTrace("Error: Unable to parse node:");
 	}
+	generation.fetch_add(1, memory_order_relaxed);
 }
 
 
@@ -102,23 +124,22 @@ const string &Phrase::Name() const
 string Phrase::Get() const
 {
 	string result;
-	if(sentences.empty())
-		return result;
+	AppendTo(result);
+	return result;
+}
 
-	for(const auto &part : sentences[Random::Int(sentences.size())])
-	{
-		if(!part.choices.empty())
-		{
-			const auto &choice = part.choices.Get();
-			for(const auto &element : choice)
-				result += element.second ? element.second->Get() : element.first;
-		}
-		else if(!part.replacements.empty())
-			for(const auto &pair : part.replacements)
-				Format::ReplaceAll(result, pair.first, pair.second);
-	}
 
-	return result;
+
+void Phrase::AppendTo(string &result) const
+{
+	if(sentences.empty())
+		return;
+
+	shared_ptr<const Memo> current = GetMemo();
+	if(current->isFixed)
+		result += current->text;
+	else
+		Expand(result);
 }
 
 
@@ -142,6 +163,68 @@ bool Phrase::ReferencesPhrase(const Phrase *other) const
 
 
 
+// Get this phrase's memo, first building it again if any phrase has been
+// loaded since it was last built.
+shared_ptr<const Phrase::Memo> Phrase::GetMemo() const
+{
+	const unsigned current = generation.load(memory_order_relaxed);
+	shared_ptr<const Memo> result = atomic_load(&memo);
+	if(result && result->generation == current)
+		return result;
+
+	auto built = make_shared<Memo>();
+	built->generation = current;
+	// A phrase is fixed if it has only one sentence and every part of it has
+	// only one choice, which only refers to other fixed phrases.
+	built->isFixed = sentences.size() <= 1;
+	for(const auto &sentence : sentences)
+		for(const auto &part : sentence)
+		{
+			if(part.choices.size() > 1)
+				built->isFixed = false;
+			for(const auto &choice : part.choices)
+				for(const auto &element : choice)
+					if(element.second && !element.second->GetMemo()->isFixed)
+						built->isFixed = false;
+		}
+	if(built->isFixed)
+		Expand(built->text);
+
+	atomic_store(&memo, shared_ptr<const Memo>(built));
+	return built;
+}
+
+
+
+// Add the text of a random sentence to the given string, expanding each of
+// the phrases it refers to in place.
+void Phrase::Expand(string &result) const
+{
+	if(sentences.empty())
+		return;
+
+	const size_t start = result.length();
+	for(const auto &part : sentences[Random::Int(sentences.size())])
+	{
+		if(!part.choices.empty())
+		{
+			const auto &choice = part.choices.Get();
+			for(const auto &element : choice)
+			{
+				if(element.second)
+					element.second->AppendTo(result);
+				else
+					result += element.first;
+			}
+		}
+		else if(!part.replacements.empty())
+			for(const auto &pair : part.replacements)
+				ReplaceAfter(result, start, pair.first, pair.second);
+	}
+}
+
+
+
 Phrase::Choice::Choice(const DataNode &node, bool isPhraseName)
 {
 	// The given datanode should not have any children.
@@ -18,7 +18,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "WeightedList.h"
 
+#include <atomic>
 #include <functional>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -46,10 +48,26 @@ public:
 
 	const std::string &Name() const;
 	std::string Get() const;
+	// Add a random sentence's text to the end of the given string, so that
+	// callers building up longer text can reuse a single buffer.
+	void AppendTo(std::string &result) const;
+
+
+private:
+	// Phrases that can only ever produce one string remember it the first time
+	// they are used, instead of expanding it again each time.
+	class Memo {
+	public:
+		unsigned generation = 0;
+		bool isFixed = false;
+		std::string text;
+	};
 
 
 private:
 	bool ReferencesPhrase(const Phrase *phrase) const;
+	std::shared_ptr<const Memo> GetMemo() const;
+	void Expand(std::string &result) const;
 
 
 private:
@@ -96,6 +114,11 @@ private:
 	std::string name;
 	// Each time this phrase is defined, a new sentence is created.
 	std::vector<Sentence> sentences;
+	// The memo may be built by several threads at once, so it is accessed
+	// atomically. Loading any phrase makes every memo out of date, because a
+	// phrase that could not vary may now refer to one that does.
+	mutable std::shared_ptr<const Memo> memo;
+	static std::atomic<unsigned> generation;
 };
 
 
@@ -254,10 +254,11 @@ void Planet::FinishLoading(Set<Wormhole> &wormholes)
 		wormhole->LoadFromPlanet(*this);
 		Logger::LogError("Warning: deprecated automatic generation of wormhole \"" + name + "\" from a multi-system planet.");
 	}
-	// If the wormhole was autogenerated we need to update it to
-	// match the planet's state.
+	// If the wormhole was autogenerated we need to update it to match the
+	// planet's state. It is modified through the set, so that the set knows
+	// to revert it.
 	else if(wormhole && wormhole->IsAutogenerated())
-		wormhole->LoadFromPlanet(*this);
+		wormholes.Get(TrueName())->LoadFromPlanet(*this);
 }
 
 
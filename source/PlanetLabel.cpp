@@ -41,6 +41,8 @@ namespace {
 	const double LINE_GAP = 1.7;
 	const double GAP = 6.;
 	const double MIN_DISTANCE = 30.;
+	// Label directions are chosen again once any object moves this far.
+	const double LAYOUT_DRIFT = 5.;
 
 	// Check if the given label for the given stellar object and direction overlaps
 	// with any other stellar object in the system.
@@ -77,11 +79,63 @@ namespace {
 
 		return false;
 	}
+
+
+
+	// Pick the direction for the given object's label to point in.
+	int ChooseDirection(const System &system, const StellarObject &object, double zoom, double width,
+		bool &dependsOnZoom)
+	{
+		// Try to find a label direction that not overlapping under any zoom.
+		for(int d = 0; d < 4; ++d)
+			if(!Overlaps(system, object, Preferences::MinViewZoom(), width, d)
+					&& !Overlaps(system, object, Preferences::MaxViewZoom(), width, d))
+				return d;
+
+		// If we can't find a suitable direction, then try to find a direction under the current
+		// zoom that is not overlapping.
+		dependsOnZoom = true;
+		for(int d = 0; d < 4; ++d)
+			if(!Overlaps(system, object, zoom, width, d))
+				return d;
+
+		return 0;
+	}
 }
 
 
 
-PlanetLabel::PlanetLabel(const Point &position, const StellarObject &object, const System *system, double zoom)
+void PlanetLabel::Layout::Update(const System &system, double zoom)
+{
+	const vector<StellarObject> &objects = system.Objects();
+	bool hasMoved = (&system != this->system || objects.size() != positions.size());
+	for(unsigned i = 0; !hasMoved && i < objects.size(); ++i)
+		hasMoved = (objects[i].Position().DistanceSquared(positions[i]) > LAYOUT_DRIFT * LAYOUT_DRIFT);
+	if(hasMoved)
+	{
+		this->system = &system;
+		positions.clear();
+		for(const StellarObject &object : objects)
+			positions.push_back(object.Position());
+		entries.clear();
+	}
+	else if(zoom != this->zoom)
+	{
+		for(auto it = entries.begin(); it != entries.end(); )
+		{
+			if(it->second.dependsOnZoom)
+				it = entries.erase(it);
+			else
+				++it;
+		}
+	}
+	this->zoom = zoom;
+}
+
+
+
+PlanetLabel::PlanetLabel(const Point &position, const StellarObject &object, const System *system, double zoom,
+		Layout *layout)
 	: position(position * zoom), radius(object.Radius() * zoom)
 {
 	const Planet &planet = *object.GetPlanet();
@@ -107,26 +161,32 @@ PlanetLabel::PlanetLabel(const Point &position, const StellarObject &object, con
 	if(!system)
 		return;
 
-	// Figure out how big the label has to be.
-	double width = max(FontSet::Get(18).Width(name), FontSet::Get(14).Width(government)) + 8.;
-
-	// Try to find a label direction that not overlapping under any zoom.
-	for(int d = 0; d < 4; ++d)
-		if(!Overlaps(*system, object, Preferences::MinViewZoom(), width, d)
-				&& !Overlaps(*system, object, Preferences::MaxViewZoom(), width, d))
+	// Reuse the direction chosen for this object before, unless its label has changed.
+	if(layout && layout->system != system)
+		layout = nullptr;
+	if(layout)
+	{
+		auto it = layout->entries.find(&object);
+		if(it != layout->entries.end() && it->second.name == name && it->second.government == government)
 		{
-			direction = d;
+			direction = it->second.direction;
 			return;
 		}
+	}
 
-	// If we can't find a suitable direction, then try to find a direction under the current
-	// zoom that is not overlapping.
-	for(int d = 0; d < 4; ++d)
-		if(!Overlaps(*system, object, zoom, width, d))
-		{
-			direction = d;
-			return;
-		}
+	// Figure out how big the label has to be.
+	double width = max(FontSet::Get(18).Width(name), FontSet::Get(14).Width(government)) + 8.;
+
+	bool dependsOnZoom = false;
+	direction = ChooseDirection(*system, object, zoom, width, dependsOnZoom);
+	if(layout)
+	{
+		Layout::Entry &entry = layout->entries[&object];
+		entry.name = name;
+		entry.government = government;
+		entry.direction = direction;
+		entry.dependsOnZoom = dependsOnZoom;
+	}
 }
 
 
@@ -19,7 +19,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Color.h"
 #include "Point.h"
 
+#include <map>
 #include <string>
+#include <vector>
 
 class StellarObject;
 class System;
@@ -28,7 +30,39 @@ class System;
 
 class PlanetLabel {
 public:
-	PlanetLabel(const Point &position, const StellarObject &object, const System *system, double zoom);
+	// Choosing which way a label points means checking it against every other
+	// stellar object in the system, so the choices made for each object are
+	// remembered until the objects move too far or the view zooms.
+	class Layout {
+	public:
+		// Forget the remembered directions that may no longer be right.
+		void Update(const System &system, double zoom);
+
+	private:
+		class Entry {
+		public:
+			std::string name;
+			std::string government;
+			int direction = 0;
+			// Whether no direction was clear at every zoom level, so this
+			// one was only chosen for the current zoom.
+			bool dependsOnZoom = false;
+		};
+
+	private:
+		const System *system = nullptr;
+		double zoom = 0.;
+		// Where each of the system's objects was when the directions were chosen.
+		std::vector<Point> positions;
+		std::map<const StellarObject *, Entry> entries;
+
+		friend class PlanetLabel;
+	};
+
+
+public:
+	PlanetLabel(const Point &position, const StellarObject &object, const System *system, double zoom,
+		Layout *layout = nullptr);
 
 	void Draw() const;
 
@@ -33,6 +33,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Planet.h"
 #include "PlayerInfo.h"
 #include "PlayerInfoPanel.h"
+#include "Preferences.h"
+#include "Replay.h"
 #include "Ship.h"
 #include "ShipyardPanel.h"
 #include "SpaceportPanel.h"
@@ -94,6 +96,14 @@ void PlanetPanel::Step()
 
 
 
+// The landscape and the description only change in response to the player.
+bool PlanetPanel::IsAnimated() const noexcept
+{
+	return false;
+}
+
+
+
 void PlanetPanel::Draw()
 {
 	if(player.IsDead())
@@ -393,6 +403,9 @@ void PlanetPanel::TakeOff()
 {
 	flightChecks.clear();
 	player.Save();
+	// Record the flight that is about to begin, if the player asked for that.
+	if(Preferences::Has("Record flight replays"))
+		Replay::StartRecording(player);
 	if(player.TakeOff(GetUI()))
 	{
 		if(callback)
@@ -41,6 +41,7 @@ public:
 
 	virtual void Step() override;
 	virtual void Draw() override;
+	virtual bool IsAnimated() const noexcept override;
 
 
 protected:
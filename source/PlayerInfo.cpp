@@ -26,8 +26,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameData.h"
 #include "Government.h"
 #include "Hardpoint.h"
+#include "JobPool.h"
 #include "Logger.h"
 #include "Messages.h"
+#include "MissionIndex.h"
 #include "Outfit.h"
 #include "Person.h"
 #include "Planet.h"
@@ -35,7 +37,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Politics.h"
 #include "Preferences.h"
 #include "Random.h"
+#include "RouteCache.h"
 #include "SavedGame.h"
+#include "SaveQueue.h"
 #include "Ship.h"
 #include "ShipEvent.h"
 #include "ShipJumpNavigation.h"
@@ -57,6 +61,32 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
+	// Only check this many ships' flight readiness on the calling thread.
+	const size_t PARALLEL_FLIGHT_CHECKS = 16;
+
+	// Set or check a system's entry in a list indexed by System::Index().
+	void SetFlag(vector<bool> &flags, const System &system, bool value)
+	{
+		if(system.Index() >= flags.size())
+		{
+			if(!value)
+				return;
+			flags.resize(System::IndexCount());
+		}
+		flags[system.Index()] = value;
+	}
+
+	bool HasFlag(const vector<bool> &flags, const System &system)
+	{
+		return system.Index() < flags.size() && flags[system.Index()];
+	}
+
+	// Order the entries of the deadline heap so that the earliest one is at the front.
+	bool LaterDeadline(const pair<Date, const Mission *> &a, const pair<Date, const Mission *> &b)
+	{
+		return b.first < a.first;
+	}
+
 	// Move the flagship to the start of your list of ships. It does not make sense
 	// that the flagship would change if you are reunited with a different ship that
 	// was higher up the list.
@@ -179,8 +209,10 @@ void PlayerInfo::New(const StartConditions &start)
 // Load player information from a saved game file.
 void PlayerInfo::Load(const string &path)
 {
-	// Make sure any previously loaded data is cleared.
+	// Make sure any previously loaded data is cleared, and that the file has
+	// been completely written if it was just saved.
 	Clear();
+	SaveQueue::Wait();
 
 	// A listing of missions and the ships where their cargo or passengers were when the game was saved.
 	// Missions and ships are referred to by string UUIDs.
@@ -308,6 +340,7 @@ void PlayerInfo::Load(const string &path)
 		{
 			missions.emplace_back(child);
 			cargo.AddMissionCargo(&missions.back());
+			ScheduleDeadline(missions.back());
 		}
 		else if((child.Token(0) == "mission cargo" || child.Token(0) == "mission passengers") && child.HasChildren())
 		{
@@ -337,7 +370,11 @@ void PlayerInfo::Load(const string &path)
 		else if(child.Token(0) == "conditions")
 			conditions.Load(child);
 		else if(child.Token(0) == "event")
-			gameEvents.emplace_back(child);
+		{
+			GameEvent event(child);
+			Date eventDate = event.GetDate();
+			gameEvents.emplace(eventDate, std::move(event));
+		}
 		else if(child.Token(0) == "changes")
 		{
 			for(const DataNode &grand : child)
@@ -375,7 +412,7 @@ void PlayerInfo::Load(const string &path)
 							text += "\n\t";
 						text += great.Token(0);
 					}
-					logbook.emplace(date, text);
+					logbook.Add(date, text);
 				}
 				else if(grand.Size() >= 2)
 				{
@@ -446,6 +483,7 @@ void PlayerInfo::Load(const string &path)
 // Load the most recently saved player (if any). Returns false when no save was loaded.
 bool PlayerInfo::LoadRecent()
 {
+	SaveQueue::Wait();
 	string recentPath = Files::Read(Files::Config() + "recent.txt");
 	// Trim trailing whitespace (including newlines) from the path.
 	while(!recentPath.empty() && recentPath.back() <= ' ')
@@ -470,8 +508,11 @@ void PlayerInfo::Save() const
 	if(!CanBeSaved())
 		return;
 
+	// The previous save must be fully written before the backups are rotated.
+	SaveQueue::Wait();
+
 	// Remember that this was the most recently saved player.
-	Files::Write(Files::Config() + "recent.txt", filePath + '\n');
+	SaveQueue::Write(Files::Config() + "recent.txt", filePath + '\n');
 
 	if(filePath.rfind(".txt") == filePath.length() - 4)
 	{
@@ -498,8 +539,9 @@ void PlayerInfo::Save() const
 	Save(filePath);
 
 	// Save global conditions:
-	DataWriter globalConditions(Files::Config() + "global conditions.txt");
+	DataWriter globalConditions;
 	GameData::GlobalConditions().Save(globalConditions);
+	SaveQueue::Write(Files::Config() + "global conditions.txt", globalConditions.Contents());
 }
 
 
@@ -515,6 +557,15 @@ string PlayerInfo::Identifier() const
 
 
 
+string PlayerInfo::SaveToString() const
+{
+	DataWriter out;
+	Save(out);
+	return out.Contents();
+}
+
+
+
 void PlayerInfo::StartTransaction()
 {
 	assert(!transactionSnapshot && "Starting PlayerInfo transaction while one is already active");
@@ -546,19 +597,10 @@ void PlayerInfo::AddChanges(list<DataNode> &changes)
 		changedSystems |= (change.Token(0) == "unlink");
 		GameData::Change(change);
 	}
-	if(changedSystems)
-	{
-		// Recalculate what systems have been seen.
-		GameData::UpdateSystems();
-		seen.clear();
-		for(const System *system : visitedSystems)
-		{
-			seen.insert(system);
-			for(const System *neighbor : system->VisibleNeighbors())
-				if(!neighbor->Hidden() || system->Links().count(neighbor))
-					seen.insert(neighbor);
-		}
-	}
+	if(changedSystems && isBatchingChanges)
+		hasChangedSystems = true;
+	else if(changedSystems)
+		UpdateChangedSystems();
 
 	// Only move the changes into my list if they are not already there.
 	if(&changes != &dataChanges)
@@ -570,8 +612,7 @@ void PlayerInfo::AddChanges(list<DataNode> &changes)
 // Add an event that will happen at the given date.
 void PlayerInfo::AddEvent(const GameEvent &event, const Date &date)
 {
-	gameEvents.push_back(event);
-	gameEvents.back().SetDate(date);
+	gameEvents.emplace(date, event)->second.SetDate(date);
 }
 
 
@@ -689,24 +730,38 @@ void PlayerInfo::IncrementDate()
 {
 	++date;
 
-	// Check if any special events should happen today.
-	auto it = gameEvents.begin();
-	while(it != gameEvents.end())
+	// Check if any special events should happen today. Applying an event may
+	// schedule others, including ones that should happen today as well. Large
+	// storylines may change many systems at once, so the systems are only
+	// updated once all of today's events have been applied.
+	isBatchingChanges = true;
+	while(!gameEvents.empty() && !(date < gameEvents.begin()->first))
 	{
-		if(date < it->GetDate())
-			++it;
-		else
-		{
-			it->Apply(*this);
-			it = gameEvents.erase(it);
-		}
+		auto it = gameEvents.begin();
+		it->second.Apply(*this);
+		gameEvents.erase(it);
+	}
+	isBatchingChanges = false;
+	if(hasChangedSystems)
+	{
+		hasChangedSystems = false;
+		UpdateChangedSystems();
 	}
 
-	// Check if any missions have failed because of deadlines and
-	// do any daily mission actions for those that have not failed.
+	// Find the missions whose deadlines have now passed.
+	set<const Mission *> due;
+	while(!deadlines.empty() && deadlines.front().first < date)
+	{
+		pop_heap(deadlines.begin(), deadlines.end(), LaterDeadline);
+		due.insert(deadlines.back().second);
+		deadlines.pop_back();
+	}
+
+	// Fail those missions and do any daily mission actions for those that
+	// have not failed.
 	for(Mission &mission : missions)
 	{
-		if(mission.CheckDeadline(date) && mission.IsVisible())
+		if(!due.empty() && due.count(&mission) && mission.CheckDeadline(date) && mission.IsVisible())
 			Messages::Add("You failed to meet the deadline for the mission \"" + mission.Name() + "\".",
 				Messages::Importance::Highest);
 		if(!mission.IsFailed())
@@ -1050,11 +1105,23 @@ map<const shared_ptr<Ship>, vector<string>> PlayerInfo::FlightCheck() const
 	// Classification of the present ships by category. Parked ships are ignored.
 	auto categoryCount = map<string, vector<shared_ptr<Ship>>>{};
 
+	// Ships remember their flight checks, so only those whose loadout or cargo
+	// changed need to be checked again. If many did, check them in parallel.
+	vector<const Ship *> unchecked;
+	for(const auto &ship : ships)
+		if(ship->GetSystem() && !ship->IsDisabled() && !ship->IsParked() && !ship->HasCurrentFlightCheck())
+			unchecked.push_back(ship.get());
+	JobPool pool(unchecked.size() > PARALLEL_FLIGHT_CHECKS ? JobPool::DefaultThreadCount() : 0);
+	pool.ParallelFor(unchecked.size(), [&unchecked](size_t i) -> void
+		{
+			unchecked[i]->FlightCheck();
+		});
+
 	auto flightChecks = map<const shared_ptr<Ship>, vector<string>>{};
 	for(const auto &ship : ships)
 		if(ship->GetSystem() && !ship->IsDisabled() && !ship->IsParked())
 		{
-			auto checks = ship->FlightCheck();
+			const auto &checks = ship->FlightCheck();
 			if(!checks.empty())
 				flightChecks.emplace(ship, checks);
 
@@ -1538,7 +1605,9 @@ bool PlayerInfo::TakeOff(UI *ui)
 	GameData::ResetPersons();
 
 	// Store the total cargo counts in case we need to adjust cost bases below.
-	map<string, int> originalTotals = cargo.Commodities();
+	map<string, int> originalTotals;
+	for(const auto &it : cargo.Commodities())
+		originalTotals[it.first] = it.second;
 
 	// Move the flagship to the start of the list of ships and ensure that all
 	// escorts know which ship is acting as flagship.
@@ -1756,7 +1825,7 @@ double PlayerInfo::GetPlayTime() const noexcept
 
 
 // Get the player's logbook.
-const multimap<Date, string> &PlayerInfo::Logbook() const
+const LogbookEntries &PlayerInfo::Logbook() const
 {
 	return logbook;
 }
@@ -1765,7 +1834,8 @@ const multimap<Date, string> &PlayerInfo::Logbook() const
 
 void PlayerInfo::AddLogEntry(const string &text)
 {
-	logbook.emplace(date, text);
+	logbook.Add(date, text);
+	knowledgeChanged = true;
 }
 
 
@@ -1783,13 +1853,14 @@ void PlayerInfo::AddSpecialLog(const string &type, const string &name, const str
 	if(!entry.empty())
 		entry += "\n\t";
 	entry += text;
+	knowledgeChanged = true;
 }
 
 
 
 bool PlayerInfo::HasLogs() const
 {
-	return !logbook.empty() || !specialLogs.empty();
+	return !logbook.IsEmpty() || !specialLogs.empty();
 }
 
 
@@ -1855,7 +1926,13 @@ const bool PlayerInfo::ShouldSortAscending() const
 void PlayerInfo::ToggleSortAscending()
 {
 	availableSortAsc = !availableSortAsc;
-	SortAvailable();
+	// The sort order is total, so unless the jobs are being separated into groups
+	// (which keep their places whichever direction the sort is in), reversing the
+	// list gives the same result as sorting it again.
+	if(sortSeparateDeadline || sortSeparatePossible)
+		SortAvailable();
+	else
+		availableJobs.reverse();
 }
 
 
@@ -1907,6 +1984,18 @@ void PlayerInfo::UpdateMissionNPCs()
 
 
 
+// Create the mission NPC ships that were waiting for the player to enter the
+// current system, grouped by the NPC they belong to.
+list<list<shared_ptr<Ship>>> PlayerInfo::MaterializeMissionNPCs()
+{
+	list<list<shared_ptr<Ship>>> created;
+	for(Mission &mission : missions)
+		mission.MaterializeNPCs(system, created);
+	return created;
+}
+
+
+
 // Accept the given job.
 void PlayerInfo::AcceptJob(const Mission &mission, UI *ui)
 {
@@ -1918,6 +2007,8 @@ void PlayerInfo::AcceptJob(const Mission &mission, UI *ui)
 			it->Do(Mission::ACCEPT, *this, ui);
 			auto spliceIt = it->IsUnique() ? missions.begin() : missions.end();
 			missions.splice(spliceIt, availableJobs, it);
+			missionShips.clear();
+			ScheduleDeadline(mission);
 			SortAvailable(); // Might not have cargo anymore, so some jobs can be sorted to end
 			break;
 		}
@@ -1963,10 +2054,12 @@ Mission *PlayerInfo::BoardingMission(const shared_ptr<Ship> &ship)
 			? Mission::BOARDING : Mission::ASSISTING);
 
 	// Check for available boarding or assisting missions.
-	for(const auto &it : GameData::Missions())
-		if(it.second.IsAtLocation(location) && it.second.CanOffer(*this, ship))
+	vector<const Mission *> candidates;
+	GameData::MissionOffers().Boarding(location, ship->GetSystem(), candidates);
+	for(const Mission *mission : candidates)
+		if(mission->CanOffer(*this, ship))
 		{
-			boardingMissions.push_back(it.second.Instantiate(*this, ship));
+			boardingMissions.push_back(mission->Instantiate(*this, ship));
 			if(boardingMissions.back().HasFailed(*this))
 				boardingMissions.pop_back();
 			else
@@ -2059,6 +2152,8 @@ void PlayerInfo::MissionCallback(int response)
 		// to the front, so they appear at the top of the list if viewed.
 		auto spliceIt = mission.IsUnique() ? missions.begin() : missions.end();
 		missions.splice(spliceIt, missionList, missionList.begin());
+		missionShips.clear();
+		ScheduleDeadline(mission);
 		mission.Do(Mission::ACCEPT, *this);
 		if(shouldAutosave)
 			Autosave();
@@ -2140,8 +2235,22 @@ void PlayerInfo::HandleEvent(const ShipEvent &event, UI *ui)
 			rating = min(maxRating, rating + (event.Target()->Cost() + 250000) / 500000);
 		}
 
-	for(Mission &mission : missions)
-		mission.Do(event, *this, ui);
+	// Any mission may care about jumps and about what happens to the player's
+	// ships. Other ships only matter to the missions whose NPCs they are in,
+	// and those ships are always "special."
+	if((event.Type() & ShipEvent::JUMP) || event.TargetGovernment()->IsPlayer())
+	{
+		for(Mission &mission : missions)
+			mission.Do(event, *this, ui);
+	}
+	else if(event.Target() && event.Target()->IsSpecial())
+	{
+		const vector<const Mission *> &owners = MissionsWithShip(event.Target());
+		if(!owners.empty())
+			for(Mission &mission : missions)
+				if(find(owners.begin(), owners.end(), &mission) != owners.end())
+					mission.Do(event, *this, ui);
+	}
 
 	// If the player's flagship was destroyed, the player is dead.
 	if((event.Type() & ShipEvent::DESTROY) && !ships.empty() && event.Target().get() == Flagship())
@@ -2243,7 +2352,7 @@ int64_t PlayerInfo::GetTributeTotal() const
 // they have actually visited it).
 bool PlayerInfo::HasSeen(const System &system) const
 {
-	if(seen.count(&system))
+	if(HasFlag(isSeen, system))
 		return true;
 
 	auto usesSystem = [&system](const Mission &m) noexcept -> bool
@@ -2270,7 +2379,7 @@ bool PlayerInfo::HasSeen(const System &system) const
 // Check if the player has visited the given system.
 bool PlayerInfo::HasVisited(const System &system) const
 {
-	return visitedSystems.count(&system);
+	return HasFlag(isVisited, system);
 }
 
 
@@ -2305,11 +2414,10 @@ bool PlayerInfo::KnowsName(const System &system) const
 // Mark the given system as visited, and mark all its neighbors as seen.
 void PlayerInfo::Visit(const System &system)
 {
-	visitedSystems.insert(&system);
-	seen.insert(&system);
-	for(const System *neighbor : system.VisibleNeighbors())
-		if(!neighbor->Hidden() || system.Links().count(neighbor))
-			seen.insert(neighbor);
+	if(visitedSystems.insert(&system).second)
+		knowledgeChanged = true;
+	SetFlag(isVisited, system, true);
+	See(system);
 }
 
 
@@ -2317,7 +2425,8 @@ void PlayerInfo::Visit(const System &system)
 // Mark the given planet as visited.
 void PlayerInfo::Visit(const Planet &planet)
 {
-	visitedPlanets.insert(&planet);
+	if(visitedPlanets.insert(&planet).second)
+		knowledgeChanged = true;
 }
 
 
@@ -2325,7 +2434,9 @@ void PlayerInfo::Visit(const Planet &planet)
 // Mark a system as unvisited, even if visited previously.
 void PlayerInfo::Unvisit(const System &system)
 {
-	visitedSystems.erase(&system);
+	if(visitedSystems.erase(&system))
+		knowledgeChanged = true;
+	SetFlag(isVisited, system, false);
 	for(const StellarObject &object : system.Objects())
 		if(object.GetPlanet())
 			Unvisit(*object.GetPlanet());
@@ -2335,7 +2446,8 @@ void PlayerInfo::Unvisit(const System &system)
 
 void PlayerInfo::Unvisit(const Planet &planet)
 {
-	visitedPlanets.erase(&planet);
+	if(visitedPlanets.erase(&planet))
+		knowledgeChanged = true;
 }
 
 
@@ -2718,8 +2830,8 @@ const Depreciation &PlayerInfo::StockDepreciation() const
 
 void PlayerInfo::Harvest(const Outfit *type)
 {
-	if(type && system)
-		harvested.insert(make_pair(system, type));
+	if(type && system && harvested.insert(make_pair(system, type)).second)
+		knowledgeChanged = true;
 }
 
 
@@ -2844,6 +2956,66 @@ void PlayerInfo::ApplyChanges()
 
 
 
+// Update the systems after changes to them, and work out again which ones
+// the player has seen, since their neighbors may be different now.
+void PlayerInfo::UpdateChangedSystems()
+{
+	GameData::UpdateSystems();
+	seen.clear();
+	isSeen.clear();
+	for(const System *system : visitedSystems)
+		See(*system);
+}
+
+
+
+// Get the accepted missions that have the given ship among their NPCs.
+const vector<const Mission *> &PlayerInfo::MissionsWithShip(const shared_ptr<Ship> &ship)
+{
+	auto it = missionShips.find(ship.get());
+	if(it != missionShips.end() && it->second.ship.lock() == ship)
+		return it->second.missions;
+
+	// NPCs can gain ships after they are accepted, and ships that are gone may
+	// be replaced by new ones at the same address, so look through them all.
+	missionShips.clear();
+	for(const Mission &mission : missions)
+		for(const NPC &npc : mission.NPCs())
+			for(const shared_ptr<Ship> &npcShip : npc.Ships())
+			{
+				MissionShips &entry = missionShips[npcShip.get()];
+				entry.ship = npcShip;
+				if(entry.missions.empty() || entry.missions.back() != &mission)
+					entry.missions.push_back(&mission);
+			}
+
+	// Remember ships that are in no mission, too, so they are not looked for again.
+	it = missionShips.find(ship.get());
+	if(it == missionShips.end())
+	{
+		it = missionShips.emplace(ship.get(), MissionShips()).first;
+		it->second.ship = ship;
+	}
+	return it->second.missions;
+}
+
+
+
+// Mark the given visited system and its neighbors as seen.
+void PlayerInfo::See(const System &system)
+{
+	seen.insert(&system);
+	SetFlag(isSeen, system, true);
+	for(const System *neighbor : system.VisibleNeighbors())
+		if(!neighbor->Hidden() || system.Links().count(neighbor))
+		{
+			seen.insert(neighbor);
+			SetFlag(isSeen, *neighbor, true);
+		}
+}
+
+
+
 // Make change's to the player's planet, system, & ship locations as needed, to ensure the player and
 // their ships are in valid locations, even if the player did something drastic, such as remove a mod.
 void PlayerInfo::ValidateLoad()
@@ -3588,10 +3760,10 @@ void PlayerInfo::RegisterDerivedConditions()
 		if(!origin)
 			return -1;
 
-		auto distanceMap = DistanceMap(origin);
-		if(!distanceMap.HasRoute(destination))
+		shared_ptr<const DistanceMap> distanceMap = RouteCache::Get(origin);
+		if(!distanceMap->HasRoute(destination))
 			return -1;
-		return distanceMap.Days(destination);
+		return distanceMap->Days(destination);
 	};
 
 	auto &&hyperjumpsToSystemProvider = conditions.GetProviderPrefixed("hyperjumps to system: ");
@@ -3691,24 +3863,44 @@ void PlayerInfo::CreateMissions()
 	// Check for available missions.
 	bool skipJobs = planet && !planet->IsInhabited();
 	bool hasPriorityMissions = false;
-	for(const auto &it : GameData::Missions())
+	// Only the missions that might be offered on this planet need to be checked.
+	vector<const Mission *> candidates;
+	GameData::MissionOffers().Landing(planet, candidates);
+	vector<const Mission *> offers;
+	for(const Mission *mission : candidates)
 	{
-		if(it.second.IsAtLocation(Mission::BOARDING) || it.second.IsAtLocation(Mission::ASSISTING))
-			continue;
-		if(skipJobs && it.second.IsAtLocation(Mission::JOB))
+		if(skipJobs && mission->IsAtLocation(Mission::JOB))
 			continue;
 
-		if(it.second.CanOffer(*this))
+		if(mission->CanOffer(*this))
+			offers.push_back(mission);
+	}
+
+	// Instantiating a mission only reads the player and the game data, so all
+	// the offers can be instantiated in parallel. Each one draws from its own
+	// random stream, seeded from the main generator, so the same seed still
+	// produces the same offers no matter which thread instantiated them.
+	vector<Mission> instances(offers.size());
+	const uint64_t seed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+	const bool isParallel = Random::IsThreadLocal() && offers.size() > 1;
+	JobPool pool(isParallel ? JobPool::DefaultThreadCount() : 0);
+	pool.ParallelFor(offers.size(), [this, &offers, &instances, seed](size_t i) -> void
 		{
-			list<Mission> &missions =
-				it.second.IsAtLocation(Mission::JOB) ? availableJobs : availableMissions;
-
-			missions.push_back(it.second.Instantiate(*this));
-			if(missions.back().HasFailed(*this))
-				missions.pop_back();
-			else if(!it.second.IsAtLocation(Mission::JOB))
-				hasPriorityMissions |= missions.back().HasPriority();
-		}
+			Random::Stream stream(seed, i);
+			instances[i] = offers[i]->Instantiate(*this);
+		});
+
+	// Add the instances in the order that the missions were checked in.
+	for(size_t i = 0; i < offers.size(); ++i)
+	{
+		if(instances[i].HasFailed(*this))
+			continue;
+
+		const bool isJob = offers[i]->IsAtLocation(Mission::JOB);
+		list<Mission> &missions = isJob ? availableJobs : availableMissions;
+		missions.push_back(std::move(instances[i]));
+		if(!isJob)
+			hasPriorityMissions |= missions.back().HasPriority();
 	}
 
 	// If any of the available missions are "priority" missions, no other
@@ -3773,6 +3965,12 @@ void PlayerInfo::SortAvailable()
 			}
 		}
 	}
+	// Checking whether a job can be accepted means testing its conditions and
+	// actions, so only do that once per job instead of on every comparison.
+	map<const Mission *, bool> canAccept;
+	if(sortSeparatePossible)
+		for(const Mission &mission : availableJobs)
+			canAccept[&mission] = mission.CanAccept(*this);
 	availableJobs.sort([&](const Mission &lhs, const Mission &rhs) {
 		// First, separate rush orders with deadlines, if wanted
 		if(sortSeparateDeadline)
@@ -3786,9 +3984,11 @@ void PlayerInfo::SortAvailable()
 		// Then, separate greyed-out jobs you can't accept
 		if(sortSeparatePossible)
 		{
-			if(lhs.CanAccept(*this) && !rhs.CanAccept(*this))
+			const bool lCanAccept = canAccept.at(&lhs);
+			const bool rCanAccept = canAccept.at(&rhs);
+			if(lCanAccept && !rCanAccept)
 				return availableSortAsc;
-			if(!lhs.CanAccept(*this) && rhs.CanAccept(*this))
+			if(!lCanAccept && rCanAccept)
 				return !availableSortAsc;
 		}
 		// Sort by desired type:
@@ -3964,6 +4164,18 @@ void PlayerInfo::StepMissions(UI *ui)
 
 
 
+void PlayerInfo::ScheduleDeadline(const Mission &mission)
+{
+	if(!mission.Deadline())
+		return;
+
+	// A mission fails on the first day after its deadline.
+	deadlines.emplace_back(mission.Deadline(), &mission);
+	push_heap(deadlines.begin(), deadlines.end(), LaterDeadline);
+}
+
+
+
 void PlayerInfo::Autosave() const
 {
 	if(!CanBeSaved() || filePath.length() < 4)
@@ -3977,12 +4189,16 @@ void PlayerInfo::Autosave() const
 
 void PlayerInfo::Save(const string &filePath) const
 {
+	// Only composing the save needs the player's state, so writing it out to
+	// the file (and compressing it, if asked to) is left to the background thread.
+	bool compress = Preferences::Has("Compress saved games");
 	if(transactionSnapshot)
-		transactionSnapshot->SaveToPath(filePath);
+		SaveQueue::Write(filePath, transactionSnapshot->Contents(), compress);
 	else
 	{
-		DataWriter out(filePath);
+		DataWriter out;
 		Save(out);
+		SaveQueue::Write(filePath, out.Contents(), compress);
 	}
 }
 
@@ -4202,8 +4418,8 @@ void PlayerInfo::Save(DataWriter &out) const
 	conditions.Save(out);
 
 	// Save pending events, and changes that have happened due to past events.
-	for(const GameEvent &event : gameEvents)
-		event.Save(out);
+	for(const auto &it : gameEvents)
+		it.second.Save(out);
 	if(!dataChanges.empty())
 	{
 		out.Write("changes");
@@ -4226,6 +4442,41 @@ void PlayerInfo::Save(DataWriter &out) const
 	out.Write();
 	out.WriteComment("What you know:");
 
+	// This part only changes when something is visited, harvested, or logged,
+	// so the text composed for the previous save can usually be reused.
+	if(knowledgeChanged)
+	{
+		DataWriter knowledge;
+		SaveKnowledge(knowledge);
+		knowledgeText = knowledge.Contents();
+		knowledgeChanged = false;
+	}
+	out.Append(knowledgeText);
+
+	out.Write();
+	out.WriteComment("How you began:");
+	startData.Save(out);
+
+	// Write plugins to player's save file for debugging.
+	out.Write();
+	out.WriteComment("Installed plugins:");
+	out.Write("plugins");
+	out.BeginChild();
+	for(const auto &it : Plugins::Get())
+	{
+		const auto &plugin = it.second;
+		if(plugin.IsValid() && plugin.enabled)
+			out.Write(plugin.name);
+	}
+	out.EndChild();
+}
+
+
+
+// Save the systems and planets the player has visited, what they have
+// harvested, and their logbook.
+void PlayerInfo::SaveKnowledge(DataWriter &out) const
+{
 	// Save a list of systems the player has visited.
 	WriteSorted(visitedSystems,
 		[](const System *const *lhs, const System *const *rhs)
@@ -4270,13 +4521,14 @@ void PlayerInfo::Save(DataWriter &out) const
 	out.Write("logbook");
 	out.BeginChild();
 	{
-		for(auto &&it : logbook)
+		for(size_t i = 0; i < logbook.Size(); ++i)
 		{
-			out.Write(it.first.Day(), it.first.Month(), it.first.Year());
+			Date entryDate = logbook.GetDate(i);
+			out.Write(entryDate.Day(), entryDate.Month(), entryDate.Year());
 			out.BeginChild();
 			{
 				// Break the text up into paragraphs.
-				for(const string &line : Format::Split(it.second, "\n\t"))
+				for(const string &line : Format::Split(logbook.Text(i), "\n\t"))
 					out.Write(line);
 			}
 			out.EndChild();
@@ -4295,23 +4547,6 @@ void PlayerInfo::Save(DataWriter &out) const
 			}
 	}
 	out.EndChild();
-
-	out.Write();
-	out.WriteComment("How you began:");
-	startData.Save(out);
-
-	// Write plugins to player's save file for debugging.
-	out.Write();
-	out.WriteComment("Installed plugins:");
-	out.Write("plugins");
-	out.BeginChild();
-	for(const auto &it : Plugins::Get())
-	{
-		const auto &plugin = it.second;
-		if(plugin.IsValid() && plugin.enabled)
-			out.Write(plugin.name);
-	}
-	out.EndChild();
 }
 
 
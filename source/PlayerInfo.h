@@ -25,6 +25,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Depreciation.h"
 #include "GameEvent.h"
 #include "Government.h"
+#include "LogbookEntries.h"
 #include "Mission.h"
 #include "SystemEntry.h"
 
@@ -85,6 +86,8 @@ public:
 	bool LoadRecent();
 	// Save this player (using the Identifier() as the file name).
 	void Save() const;
+	// Get what would be written to this player's saved game file right now.
+	std::string SaveToString() const;
 
 	// Get the root filename used for this player's saved game files. (If there
 	// are multiple pilots with the same name it may have a digit appended.)
@@ -196,7 +199,7 @@ public:
 	void AddPlayTime(std::chrono::nanoseconds timeVal);
 
 	// Get the player's logbook.
-	const std::multimap<Date, std::string> &Logbook() const;
+	const LogbookEntries &Logbook() const;
 	void AddLogEntry(const std::string &text);
 	const std::map<std::string, std::map<std::string, std::string>> &SpecialLogs() const;
 	void AddSpecialLog(const std::string &type, const std::string &name, const std::string &text);
@@ -219,6 +222,9 @@ public:
 
 	const Mission *ActiveBoardingMission() const;
 	void UpdateMissionNPCs();
+	// Create the mission NPC ships that were waiting for the player to enter the
+	// current system, grouped by the NPC they belong to.
+	std::list<std::list<std::shared_ptr<Ship>>> MaterializeMissionNPCs();
 	void AcceptJob(const Mission &mission, UI *ui);
 	// Check to see if there is any mission to offer right now.
 	Mission *MissionToOffer(Mission::Location location);
@@ -329,6 +335,13 @@ public:
 private:
 	// Apply any "changes" saved in this player info to the global game state.
 	void ApplyChanges();
+	// Update the systems after changes to them, and work out again which ones
+	// the player has seen.
+	void UpdateChangedSystems();
+	// Mark the given visited system and its neighbors as seen.
+	void See(const System &system);
+	// Get the accepted missions that have the given ship among their NPCs.
+	const std::vector<const Mission *> &MissionsWithShip(const std::shared_ptr<Ship> &ship);
 	// After loading & applying changes, make sure the player & ship locations are sensible.
 	void ValidateLoad();
 	// Helper to register derived conditions.
@@ -337,9 +350,12 @@ private:
 	// New missions are generated each time you land on a planet.
 	void CreateMissions();
 	void StepMissions(UI *ui);
+	// Remember when an accepted mission's deadline passes, if it has one.
+	void ScheduleDeadline(const Mission &mission);
 	void Autosave() const;
 	void Save(const std::string &path) const;
 	void Save(DataWriter &out) const;
+	void SaveKnowledge(DataWriter &out) const;
 
 	// Check for and apply any punitive actions from planetary security.
 	void Fine(UI *ui);
@@ -383,11 +399,25 @@ private:
 	std::map<const Planet *, CargoHold> planetaryStorage;
 	std::map<std::string, int64_t> costBasis;
 
-	std::multimap<Date, std::string> logbook;
+	LogbookEntries logbook;
 	std::map<std::string, std::map<std::string, std::string>> specialLogs;
 
 	// A list of the player's active, accepted missions.
 	std::list<Mission> missions;
+	// A min-heap of the deadlines of the accepted missions, so that each day only
+	// the missions whose deadlines have passed need to be checked. Entries for
+	// missions that have since been removed are skipped when they come due.
+	std::vector<std::pair<Date, const Mission *>> deadlines;
+	// Which accepted missions have each special ship among their NPCs, so that
+	// an event involving that ship only goes to those missions. This is made
+	// again whenever a ship is not in it, or is a different ship than when it
+	// was added, and is forgotten whenever a mission is accepted.
+	class MissionShips {
+	public:
+		std::weak_ptr<const Ship> ship;
+		std::vector<const Mission *> missions;
+	};
+	std::map<const Ship *, MissionShips> missionShips;
 	// These lists are populated when you land on a planet, and saved so that
 	// they will not change if you reload the game.
 	std::list<Mission> availableJobs;
@@ -412,7 +442,15 @@ private:
 
 	std::set<const System *> seen;
 	std::set<const System *> visitedSystems;
+	// The same systems, indexed by System::Index(), so that route searches
+	// can check them without looking them up in the sets.
+	std::vector<bool> isSeen;
+	std::vector<bool> isVisited;
 	std::set<const Planet *> visitedPlanets;
+	// The saved text of what the player has visited, harvested, and logged,
+	// which is only composed again after one of them changes.
+	mutable std::string knowledgeText;
+	mutable bool knowledgeChanged = true;
 	std::vector<const System *> travelPlan;
 	const Planet *travelDestination = nullptr;
 
@@ -430,8 +468,13 @@ private:
 	DataNode economy;
 	// Persons that have been killed in this player's universe:
 	std::vector<std::string> destroyedPersons;
-	// Events that are going to happen some time in the future:
-	std::list<GameEvent> gameEvents;
+	// Events that are going to happen some time in the future, by date. Events
+	// that happen on the same day are kept in the order they were added.
+	std::multimap<Date, GameEvent> gameEvents;
+	// While a day's events are applied, any changes to the systems are only
+	// recorded, so that the systems are updated once after all of them.
+	bool isBatchingChanges = false;
+	bool hasChangedSystems = false;
 
 	// The system and position therein to which the "orbits" system UI issued a move order.
 	std::pair<const System *, Point> interstellarEscortDestination;
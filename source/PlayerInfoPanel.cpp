@@ -120,8 +120,8 @@ namespace {
 
 	bool CompareFuel(const shared_ptr<Ship> &lhs, const shared_ptr<Ship> &rhs)
 	{
-		return lhs->Attributes().Get("fuel capacity") * lhs->Fuel() <
-			rhs->Attributes().Get("fuel capacity") * rhs->Fuel();
+		return lhs->Attributes().Get(AttributeKey::FUEL_CAPACITY) * lhs->Fuel() <
+			rhs->Attributes().Get(AttributeKey::FUEL_CAPACITY) * rhs->Fuel();
 	}
 
 	bool CompareRequiredCrew(const shared_ptr<Ship> &lhs, const shared_ptr<Ship> &rhs)
@@ -796,7 +796,7 @@ void PlayerInfoPanel::DrawFleet(const Rectangle &bounds)
 		table.Draw(hull);
 
 		string fuel = to_string(static_cast<int>(
-			ship.Attributes().Get("fuel capacity") * ship.Fuel()));
+			ship.Attributes().Get(AttributeKey::FUEL_CAPACITY) * ship.Fuel()));
 		table.Draw(fuel);
 
 		// If this isn't the flagship, we'll remember how many crew it has, but
@@ -835,13 +835,13 @@ void PlayerInfoPanel::SortShips(InfoPanelState::ShipComparator *shipComparator)
 		shipComparator = GetReverseCompareFrom(*shipComparator);
 
 	// Save selected ships to preserve selection after sort.
-	multiset<shared_ptr<Ship>, InfoPanelState::ShipComparator *> selectedShips(shipComparator);
-	shared_ptr<Ship> lastSelected = panelState.SelectedIndex() == -1
+	set<const Ship *> selectedShips;
+	const Ship *lastSelected = panelState.SelectedIndex() == -1
 		? nullptr
-		: panelState.Ships()[panelState.SelectedIndex()];
+		: panelState.Ships()[panelState.SelectedIndex()].get();
 
 	for(int i : panelState.AllSelected())
-		selectedShips.insert(panelState.Ships()[i]);
+		selectedShips.insert(panelState.Ships()[i].get());
 	panelState.DeselectAll();
 
 	// Move flagship to first position
@@ -858,19 +858,20 @@ void PlayerInfoPanel::SortShips(InfoPanelState::ShipComparator *shipComparator)
 		shipComparator
 	);
 
-	// Load the same selected ships from before the sort.
-	auto it = selectedShips.begin();
-	for(size_t i = 0; i < panelState.Ships().size(); ++i)
-		if(panelState.Ships()[i] == *it)
+	// Load the same selected ships from before the sort. Their new positions
+	// are found by identity, so this does not depend on the flagship having
+	// been moved to the front or on ships that compare equal.
+	if(!selectedShips.empty())
+		for(size_t i = 0; i < panelState.Ships().size(); ++i)
 		{
-			if(lastSelected == *it)
+			const Ship *ship = panelState.Ships()[i].get();
+			if(!selectedShips.count(ship))
+				continue;
+
+			if(ship == lastSelected)
 				panelState.SetSelectedIndex(i);
 			else
 				panelState.Select(i);
-
-			++it;
-			if(it == selectedShips.end())
-				break;
 		}
 
 	// Ships are now sorted.
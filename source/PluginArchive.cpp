@@ -0,0 +1,340 @@
+/* PluginArchive.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "PluginArchive.h"
+
+#include "Files.h"
+#include "Logger.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+
+using namespace std;
+
+namespace {
+	// The signatures that begin each record in a zip archive.
+	const uint32_t LOCAL_HEADER = 0x04034b50;
+	const uint32_t CENTRAL_HEADER = 0x02014b50;
+	const uint32_t END_OF_DIRECTORY = 0x06054b50;
+	// Fixed sizes of those records, not counting any names or comments.
+	const size_t LOCAL_HEADER_SIZE = 30;
+	const size_t CENTRAL_HEADER_SIZE = 46;
+	const size_t END_OF_DIRECTORY_SIZE = 22;
+	// The end of directory record may be followed by a comment this long.
+	const size_t MAX_COMMENT_SIZE = 0xFFFF;
+
+	// Compression methods that can be read.
+	const uint16_t STORED = 0;
+	const uint16_t DEFLATED = 8;
+	// Entries with this flag set are encrypted.
+	const uint16_t ENCRYPTED = 1;
+
+	vector<unique_ptr<PluginArchive>> archives;
+
+	// All numbers in a zip archive are little-endian.
+	uint16_t Read2(const char *data)
+	{
+		const auto *bytes = reinterpret_cast<const unsigned char *>(data);
+		return bytes[0] | (bytes[1] << 8);
+	}
+
+	uint32_t Read4(const char *data)
+	{
+		return Read2(data) | (static_cast<uint32_t>(Read2(data + 2)) << 16);
+	}
+
+	// Check whether the given path has the extension of a zip archive.
+	bool IsZip(const string &path)
+	{
+		if(path.length() < 4)
+			return false;
+		string extension = path.substr(path.length() - 4);
+		transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+		return extension == ".zip";
+	}
+
+	// Check whether the given string begins with the given prefix.
+	bool StartsWith(const string &value, const string &prefix)
+	{
+		return !value.compare(0, prefix.length(), prefix);
+	}
+}
+
+
+
+string PluginArchive::Mount(const string &path)
+{
+	if(!IsZip(path))
+		return string();
+
+	for(const auto &archive : archives)
+		if(archive->root == path + '/')
+			return archive->root;
+
+	unique_ptr<PluginArchive> archive(new PluginArchive(path));
+	if(!archive->IsValid())
+		return string();
+
+	archives.push_back(std::move(archive));
+	return archives.back()->root;
+}
+
+
+
+const PluginArchive *PluginArchive::Find(const string &path, string &name)
+{
+	for(const auto &archive : archives)
+	{
+		const string &root = archive->root;
+		if(StartsWith(path, root))
+		{
+			name = path.substr(root.length());
+			return archive.get();
+		}
+		// The archive's folder can also be named without the trailing slash.
+		if(path.length() + 1 == root.length() && StartsWith(root, path))
+		{
+			name.clear();
+			return archive.get();
+		}
+	}
+	return nullptr;
+}
+
+
+
+PluginArchive::PluginArchive(const string &path)
+	: root(path + '/'), timestamp(Files::Timestamp(path)), file(path)
+{
+	if(!file)
+		return;
+
+	const char *begin = file.Data();
+	const size_t size = file.Size();
+	if(size < END_OF_DIRECTORY_SIZE)
+	{
+		Logger::LogError("Error: \"" + path + "\" is not a zip archive.");
+		return;
+	}
+
+	// The end of directory record is the last thing in the archive, except for
+	// a comment that might follow it, so search backwards for its signature.
+	size_t end = size - END_OF_DIRECTORY_SIZE;
+	const size_t limit = end > MAX_COMMENT_SIZE ? end - MAX_COMMENT_SIZE : 0;
+	while(Read4(begin + end) != END_OF_DIRECTORY)
+	{
+		if(end == limit)
+		{
+			Logger::LogError("Error: \"" + path + "\" is not a zip archive.");
+			return;
+		}
+		--end;
+	}
+	const size_t count = Read2(begin + end + 10);
+	size_t pos = Read4(begin + end + 16);
+
+	map<string, Entry> index;
+	for(size_t i = 0; i < count; ++i)
+	{
+		if(pos + CENTRAL_HEADER_SIZE > end || Read4(begin + pos) != CENTRAL_HEADER)
+		{
+			Logger::LogError("Error: the index of \"" + path + "\" is corrupt.");
+			return;
+		}
+		const char *header = begin + pos;
+		const uint16_t flags = Read2(header + 8);
+		const uint16_t method = Read2(header + 10);
+		const size_t nameLength = Read2(header + 28);
+		const size_t next = pos + CENTRAL_HEADER_SIZE + nameLength + Read2(header + 30) + Read2(header + 32);
+		if(next > end)
+		{
+			Logger::LogError("Error: the index of \"" + path + "\" is corrupt.");
+			return;
+		}
+		string name(header + CENTRAL_HEADER_SIZE, nameLength);
+		replace(name.begin(), name.end(), '\\', '/');
+		pos = next;
+
+		// Directories may or may not have entries of their own, so they are
+		// found from the names of the files inside of them instead.
+		for(size_t slash = name.find('/'); slash != string::npos; slash = name.find('/', slash + 1))
+			directories.insert(name.substr(0, slash + 1));
+		if(name.empty() || name.back() == '/')
+			continue;
+		if((flags & ENCRYPTED) || (method != STORED && method != DEFLATED))
+		{
+			Logger::LogError("Warning: skipping \"" + root + name
+				+ "\" because it is encrypted or uses an unsupported kind of compression.");
+			continue;
+		}
+
+		Entry &entry = index[name];
+		entry.offset = Read4(header + 42);
+		entry.compressedSize = Read4(header + 20);
+		entry.size = Read4(header + 24);
+		entry.isCompressed = (method == DEFLATED);
+	}
+	entries.swap(index);
+}
+
+
+
+bool PluginArchive::IsValid() const
+{
+	return !entries.empty();
+}
+
+
+
+const string &PluginArchive::Root() const
+{
+	return root;
+}
+
+
+
+bool PluginArchive::Exists(const string &name) const
+{
+	if(name.empty() || entries.count(name))
+		return true;
+	return directories.count(name.back() == '/' ? name : name + '/');
+}
+
+
+
+int64_t PluginArchive::Size(const string &name) const
+{
+	auto it = entries.find(name);
+	return it == entries.end() ? -1 : it->second.size;
+}
+
+
+
+time_t PluginArchive::Timestamp() const
+{
+	return timestamp;
+}
+
+
+
+string PluginArchive::Read(const string &name) const
+{
+	string result;
+	auto it = entries.find(name);
+	if(it == entries.end())
+		return result;
+
+	const Entry &entry = it->second;
+	const char *data = EntryData(entry);
+	if(!data)
+	{
+		Logger::LogError("Error: \"" + root + name + "\" is corrupt.");
+		return result;
+	}
+	if(!entry.isCompressed)
+		return string(data, entry.size);
+
+	// Each entry is compressed as a raw deflate stream, with no header.
+	z_stream stream = {};
+	if(inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+		return result;
+	result.resize(entry.size);
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+	stream.avail_in = entry.compressedSize;
+	stream.next_out = reinterpret_cast<Bytef *>(&result[0]);
+	stream.avail_out = result.size();
+	int status = inflate(&stream, Z_FINISH);
+	result.resize(stream.total_out);
+	inflateEnd(&stream);
+
+	if(status != Z_STREAM_END)
+		Logger::LogError("Error: \"" + root + name + "\" is corrupt.");
+	return result;
+}
+
+
+
+const char *PluginArchive::Data(const string &name, size_t &size) const
+{
+	auto it = entries.find(name);
+	if(it == entries.end() || it->second.isCompressed)
+		return nullptr;
+
+	size = it->second.size;
+	return EntryData(it->second);
+}
+
+
+
+vector<string> PluginArchive::List(string directory) const
+{
+	if(!directory.empty() && directory.back() != '/')
+		directory += '/';
+
+	vector<string> list;
+	for(auto it = entries.lower_bound(directory); it != entries.end() && StartsWith(it->first, directory); ++it)
+		if(it->first.find('/', directory.length()) == string::npos)
+			list.push_back(root + it->first);
+	return list;
+}
+
+
+
+vector<string> PluginArchive::ListDirectories(string directory) const
+{
+	if(!directory.empty() && directory.back() != '/')
+		directory += '/';
+
+	vector<string> list;
+	for(auto it = directories.upper_bound(directory); it != directories.end() && StartsWith(*it, directory); ++it)
+		if(it->find('/', directory.length()) + 1 == it->length())
+			list.push_back(root + *it);
+	return list;
+}
+
+
+
+vector<string> PluginArchive::RecursiveList(string directory) const
+{
+	if(!directory.empty() && directory.back() != '/')
+		directory += '/';
+
+	vector<string> list;
+	for(auto it = entries.lower_bound(directory); it != entries.end() && StartsWith(it->first, directory); ++it)
+		list.push_back(root + it->first);
+	return list;
+}
+
+
+
+const char *PluginArchive::EntryData(const Entry &entry) const
+{
+	// The local header repeats the entry's name, but its "extra" field may not
+	// be the same length as the one in the central directory.
+	const size_t size = file.Size();
+	if(entry.offset + LOCAL_HEADER_SIZE > size)
+		return nullptr;
+	const char *header = file.Data() + entry.offset;
+	if(Read4(header) != LOCAL_HEADER)
+		return nullptr;
+
+	const size_t start = entry.offset + LOCAL_HEADER_SIZE + Read2(header + 26) + Read2(header + 28);
+	if(start + entry.compressedSize > size || (!entry.isCompressed && entry.compressedSize != entry.size))
+		return nullptr;
+	return file.Data() + start;
+}
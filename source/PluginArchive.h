@@ -0,0 +1,113 @@
+/* PluginArchive.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PLUGIN_ARCHIVE_H_
+#define PLUGIN_ARCHIVE_H_
+
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+
+
+// A plugin can be distributed as a single zip archive instead of a folder. When
+// the archive is mounted, its index (the "central directory" at the end of the
+// file) is read once, and from then on its contents appear to the rest of the
+// game as a read-only folder named after the archive, e.g. "example.zip/data/".
+// The archive itself is mapped into memory, so entries that are stored
+// uncompressed are used in place, and compressed (deflated) entries are only
+// inflated when they are read. Nothing is ever extracted to the disk.
+class PluginArchive {
+public:
+	// Mount the zip archive at the given path. Returns the path of the folder
+	// that its contents will appear in, or an empty string if this is not a
+	// valid archive. Archives should be mounted before any loading begins,
+	// because the list of mounted archives is not guarded by a lock.
+	static std::string Mount(const std::string &path);
+	// Find the mounted archive that the given path is inside of, if any, and
+	// get the name of the entry within it that the path refers to.
+	static const PluginArchive *Find(const std::string &path, std::string &name);
+
+	explicit PluginArchive(const std::string &path);
+
+	// No moving or copying this class.
+	PluginArchive(const PluginArchive &other) = delete;
+	PluginArchive &operator=(const PluginArchive &other) = delete;
+
+	// Check if the archive was read successfully.
+	bool IsValid() const;
+	// The folder that this archive's contents appear in, ending in a '/'.
+	const std::string &Root() const;
+
+	// Check whether the given file or directory is in this archive. Directories
+	// may be named with or without a trailing '/'.
+	bool Exists(const std::string &name) const;
+	// Get the uncompressed size of the given file, or -1 if it is not found.
+	int64_t Size(const std::string &name) const;
+	// All entries share the modification time of the archive itself.
+	std::time_t Timestamp() const;
+
+	// Get the contents of the given file, inflating it if it is compressed.
+	std::string Read(const std::string &name) const;
+	// Get a pointer to the contents of the given file inside the mapped archive,
+	// if it is stored uncompressed. Otherwise, this returns a null pointer.
+	const char *Data(const std::string &name, size_t &size) const;
+
+	// Get the full paths of the files in the given directory, of the directories
+	// in it, or of all the files in it or any directory that it contains. These
+	// work the same way as the corresponding functions in Files.
+	std::vector<std::string> List(std::string directory) const;
+	std::vector<std::string> ListDirectories(std::string directory) const;
+	std::vector<std::string> RecursiveList(std::string directory) const;
+
+
+private:
+	class Entry {
+	public:
+		// Where this entry's local header is in the archive.
+		size_t offset = 0;
+		size_t compressedSize = 0;
+		size_t size = 0;
+		bool isCompressed = false;
+	};
+
+
+private:
+	// Find where the given entry's data begins, or return a null pointer if the
+	// entry lies outside of the archive.
+	const char *EntryData(const Entry &entry) const;
+
+
+private:
+	std::string root;
+	std::time_t timestamp = 0;
+	MappedFile file;
+
+	// The entries are kept sorted by name, so that the contents of any
+	// directory are next to each other.
+	std::map<std::string, Entry> entries;
+	// Every directory that contains an entry, ending in a '/'.
+	std::set<std::string> directories;
+};
+
+
+
+#endif
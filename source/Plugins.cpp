@@ -20,6 +20,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "DataWriter.h"
 #include "Files.h"
+#include "PluginArchive.h"
+#include "SaveQueue.h"
 
 #include <algorithm>
 #include <cassert>
@@ -68,6 +70,10 @@ const Plugin *Plugins::Load(const string &path)
 	// Get the name of the folder containing the plugin.
 	size_t pos = path.rfind('/', path.length() - 2) + 1;
 	string name = path.substr(pos, path.length() - 1 - pos);
+	// Plugins in zip archives are named after the archive, without its extension.
+	string entry;
+	if(PluginArchive::Find(path, entry) && entry.empty())
+		name = name.substr(0, name.rfind('.'));
 
 	auto *plugin = plugins.Get(name);
 	plugin->name = std::move(name);
@@ -93,7 +99,7 @@ void Plugins::Save()
 {
 	if(plugins.empty())
 		return;
-	DataWriter out(Files::Config() + "plugins.txt");
+	DataWriter out;
 
 	out.Write("state");
 	out.BeginChild();
@@ -102,6 +108,8 @@ void Plugins::Save()
 			out.Write(it.first, it.second.currentState);
 	}
 	out.EndChild();
+
+	SaveQueue::Write(Files::Config() + "plugins.txt", out.Contents());
 }
 
 
@@ -15,7 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Point.h"
 
-#ifndef __SSE3__
+#ifndef ES_POINT_SSE3
 #include <algorithm>
 #include <cmath>
 using namespace std;
@@ -24,7 +24,7 @@ using namespace std;
 
 
 Point::Point() noexcept
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	: v(_mm_setzero_pd())
 #else
 	: x(0.), y(0.)
@@ -35,7 +35,7 @@ Point::Point() noexcept
 
 
 Point::Point(double x, double y) noexcept
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	: v(_mm_set_pd(y, x))
 #else
 	: x(x), y(y)
@@ -55,7 +55,7 @@ Point::operator bool() const noexcept
 
 bool Point::operator!() const noexcept
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return (!val.x & !val.y);
 #else
 	return (!x & !y);
@@ -66,7 +66,7 @@ bool Point::operator!() const noexcept
 
 Point Point::operator+(const Point &point) const
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return Point(v + point.v);
 #else
 	return Point(x + point.x, y + point.y);
@@ -77,7 +77,7 @@ Point Point::operator+(const Point &point) const
 
 Point &Point::operator+=(const Point &point)
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	v += point.v;
 #else
 	x += point.x;
@@ -90,7 +90,7 @@ Point &Point::operator+=(const Point &point)
 
 Point Point::operator-(const Point &point) const
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return Point(v - point.v);
 #else
 	return Point(x - point.x, y - point.y);
@@ -101,7 +101,7 @@ Point Point::operator-(const Point &point) const
 
 Point &Point::operator-=(const Point &point)
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	v -= point.v;
 #else
 	x -= point.x;
@@ -121,7 +121,7 @@ Point Point::operator-() const
 
 Point Point::operator*(double scalar) const
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return Point(v * _mm_loaddup_pd(&scalar));
 #else
 	return Point(x * scalar, y * scalar);
@@ -132,7 +132,7 @@ Point Point::operator*(double scalar) const
 
 Point operator*(double scalar, const Point &point)
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return Point(point.v * _mm_loaddup_pd(&scalar));
 #else
 	return Point(point.x * scalar, point.y * scalar);
@@ -143,7 +143,7 @@ Point operator*(double scalar, const Point &point)
 
 Point &Point::operator*=(double scalar)
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	v *= _mm_loaddup_pd(&scalar);
 #else
 	x *= scalar;
@@ -156,7 +156,7 @@ Point &Point::operator*=(double scalar)
 
 Point Point::operator*(const Point &other) const
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	Point result;
 	result.v = v * other.v;
 	return result;
@@ -169,7 +169,7 @@ Point Point::operator*(const Point &other) const
 
 Point &Point::operator*=(const Point &other)
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	v *= other.v;
 #else
 	x *= other.x;
@@ -182,7 +182,7 @@ Point &Point::operator*=(const Point &other)
 
 Point Point::operator/(double scalar) const
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return Point(v / _mm_loaddup_pd(&scalar));
 #else
 	return Point(x / scalar, y / scalar);
@@ -193,7 +193,7 @@ Point Point::operator/(double scalar) const
 
 Point &Point::operator/=(double scalar)
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	v /= _mm_loaddup_pd(&scalar);
 #else
 	x /= scalar;
@@ -206,7 +206,7 @@ Point &Point::operator/=(double scalar)
 
 void Point::Set(double x, double y)
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	v = _mm_set_pd(y, x);
 #else
 	this->x = x;
@@ -219,7 +219,7 @@ void Point::Set(double x, double y)
 // Operations that treat this point as a vector from (0, 0):
 double Point::Dot(const Point &point) const
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	__m128d b = v * point.v;
 	b = _mm_hadd_pd(b, b);
 	return reinterpret_cast<double &>(b);
@@ -232,7 +232,7 @@ double Point::Dot(const Point &point) const
 
 double Point::Cross(const Point &point) const
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	__m128d b = _mm_shuffle_pd(point.v, point.v, 0x01);
 	b *= v;
 	b = _mm_hsub_pd(b, b);
@@ -246,7 +246,7 @@ double Point::Cross(const Point &point) const
 
 double Point::Length() const
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	__m128d b = v * v;
 	b = _mm_hadd_pd(b, b);
 	b = _mm_sqrt_pd(b);
@@ -267,7 +267,7 @@ double Point::LengthSquared() const
 
 Point Point::Unit() const
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	__m128d b = v * v;
 	b = _mm_hadd_pd(b, b);
 	if(!_mm_cvtsd_f64(b))
@@ -302,7 +302,7 @@ double Point::DistanceSquared(const Point &point) const
 // Absolute value of both coordinates.
 Point abs(const Point &p)
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	// Absolute value for doubles just involves clearing the sign bit.
 	static const __m128d sign_mask = _mm_set1_pd(-0.);
 	return Point(_mm_andnot_pd(sign_mask, p.v));
@@ -316,7 +316,7 @@ Point abs(const Point &p)
 // Take the min of the x and y coordinates.
 Point min(const Point &p, const Point &q)
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return Point(_mm_min_pd(p.v, q.v));
 #else
 	return Point(min(p.x, q.x), min(p.y, q.y));
@@ -328,7 +328,7 @@ Point min(const Point &p, const Point &q)
 // Take the max of the x and y coordinates.
 Point max(const Point &p, const Point &q)
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return Point(_mm_max_pd(p.v, q.v));
 #else
 	return Point(max(p.x, q.x), max(p.y, q.y));
@@ -337,7 +337,7 @@ Point max(const Point &p, const Point &q)
 
 
 
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 // Private constructor, using a vector.
 inline Point::Point(const __m128d &v)
 	: v(v)
@@ -16,7 +16,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef POINT_H_
 #define POINT_H_
 
-#ifdef __SSE3__
+// Points store their coordinates as doubles unless ES_FLOAT_POINT is defined,
+// in which case they use floats. That halves their size, at the cost of precision
+// far from the center of a system. Only double precision uses the SSE3 code.
+#if defined(__SSE3__) && !defined(ES_FLOAT_POINT)
+#define ES_POINT_SSE3
 #include <pmmintrin.h>
 #endif
 
@@ -29,6 +33,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // Internally the coordinates are stored in a SSE vector and the processor's vector
 // extensions are used to optimize all operations.
 class Point {
+public:
+	// The type each coordinate is stored as.
+#ifdef ES_FLOAT_POINT
+	using Scalar = float;
+#else
+	using Scalar = double;
+#endif
+
+
 public:
 	Point() noexcept;
 	Point(double x, double y) noexcept;
@@ -57,10 +70,10 @@ public:
 	Point operator*(const Point &other) const;
 	Point &operator*=(const Point &other);
 
-	double &X();
-	const double &X() const noexcept;
-	double &Y();
-	const double &Y() const noexcept;
+	Scalar &X();
+	const Scalar &X() const noexcept;
+	Scalar &Y();
+	const Scalar &Y() const noexcept;
 
 	void Set(double x, double y);
 
@@ -84,7 +97,7 @@ public:
 
 
 private:
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	// Private constructor, using a vector.
 	explicit Point(const __m128d &v);
 
@@ -99,17 +112,17 @@ private:
 		PointInternal val;
 	};
 #else
-	double x;
-	double y;
+	Scalar x;
+	Scalar y;
 #endif
 };
 
 
 
 // Inline accessor functions, for speed:
-inline double &Point::X()
+inline Point::Scalar &Point::X()
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return val.x;
 #else
 	return x;
@@ -118,9 +131,9 @@ inline double &Point::X()
 
 
 
-inline const double &Point::X() const noexcept
+inline const Point::Scalar &Point::X() const noexcept
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return val.x;
 #else
 	return x;
@@ -129,9 +142,9 @@ inline const double &Point::X() const noexcept
 
 
 
-inline double &Point::Y()
+inline Point::Scalar &Point::Y()
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return val.y;
 #else
 	return y;
@@ -140,9 +153,9 @@ inline double &Point::Y()
 
 
 
-inline const double &Point::Y() const noexcept
+inline const Point::Scalar &Point::Y() const noexcept
 {
-#ifdef __SSE3__
+#ifdef ES_POINT_SSE3
 	return val.y;
 #else
 	return y;
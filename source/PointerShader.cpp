@@ -20,7 +20,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Screen.h"
 #include "Shader.h"
 
+#include "opengl.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 
 using namespace std;
 
@@ -35,6 +41,56 @@ namespace {
 
 	GLuint vao;
 	GLuint vbo;
+
+	// When it is available, a batch of pointers is drawn with a single
+	// instanced draw call. This shader reads the values that the one above
+	// takes as uniforms from a buffer with one Item per pointer.
+	bool useInstancing = false;
+	Shader instancedShader;
+	GLint instancedScaleI;
+	GLuint instancedVao;
+	GLuint instanceVbo;
+
+
+	// Generate the code for the fragment shader.
+	string FragmentCode(bool isInstanced)
+	{
+		// The instanced shader gets these values from the vertex shader instead.
+		const char *input = isInstanced ? "flat in " : "uniform ";
+		ostringstream fragmentCodeStream;
+		fragmentCodeStream <<
+			"// fragment pointer shader\n"
+			"precision mediump float;\n"
+			<< input << "vec4 color;\n"
+			<< input << "vec2 size;\n"
+
+			"in vec2 coord;\n"
+			"out vec4 finalColor;\n"
+
+			"void main() {\n"
+			"  float height = (coord.x + coord.y) / size.x;\n"
+			"  float taper = height * height * height;\n"
+			"  taper *= taper * .5 * size.x;\n"
+			"  float alpha = clamp(.8 * min(coord.x, coord.y) - taper, 0.f, 1.f);\n"
+			"  alpha *= clamp(1.8 * (1. - height), 0.f, 1.f);\n"
+			"  finalColor = color * alpha;\n"
+			"}\n";
+		return fragmentCodeStream.str();
+	}
+
+
+
+	// Draw one pointer with the non-instanced shader, which must be bound.
+	void DrawItem(const PointerShader::Item &item)
+	{
+		glUniform2fv(centerI, 1, item.center);
+		glUniform2fv(angleI, 1, item.angle);
+		glUniform2fv(sizeI, 1, item.size);
+		glUniform1f(offsetI, item.offset);
+		glUniform4fv(colorI, 1, item.color);
+
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
 }
 
 
@@ -60,25 +116,8 @@ void PointerShader::Init()
 		"  gl_Position = vec4((base + wing) * scale, 0, 1);\n"
 		"}\n";
 
-	static const char *fragmentCode =
-		"// fragment pointer shader\n"
-		"precision mediump float;\n"
-		"uniform vec4 color;\n"
-		"uniform vec2 size;\n"
-
-		"in vec2 coord;\n"
-		"out vec4 finalColor;\n"
-
-		"void main() {\n"
-		"  float height = (coord.x + coord.y) / size.x;\n"
-		"  float taper = height * height * height;\n"
-		"  taper *= taper * .5 * size.x;\n"
-		"  float alpha = clamp(.8 * min(coord.x, coord.y) - taper, 0.f, 1.f);\n"
-		"  alpha *= clamp(1.8 * (1. - height), 0.f, 1.f);\n"
-		"  finalColor = color * alpha;\n"
-		"}\n";
-
-	shader = Shader(vertexCode, fragmentCode);
+	static const string fragmentCode = FragmentCode(false);
+	shader = Shader(vertexCode, fragmentCode.c_str());
 	scaleI = shader.Uniform("scale");
 	centerI = shader.Uniform("center");
 	angleI = shader.Uniform("angle");
@@ -88,7 +127,7 @@ void PointerShader::Init()
 
 	// Generate the vertex data for drawing sprites.
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -105,7 +144,66 @@ void PointerShader::Init()
 
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
+
+	useInstancing = OpenGL::HasInstancingSupport();
+	if(!useInstancing)
+		return;
+
+	static const char *instancedVertexCode =
+		"// vertex instanced pointer shader\n"
+		"precision mediump float;\n"
+		"uniform vec2 scale;\n"
+
+		"in vec2 vert;\n"
+		"in vec2 instanceCenter;\n"
+		"in vec2 instanceAngle;\n"
+		"in vec3 instanceSize;\n"
+		"in vec4 instanceColor;\n"
+		"out vec2 coord;\n"
+		"flat out vec4 color;\n"
+		"flat out vec2 size;\n"
+
+		"void main() {\n"
+		"  size = instanceSize.xy;\n"
+		"  color = instanceColor;\n"
+		"  coord = vert * size.x;\n"
+		"  vec2 base = instanceCenter + instanceAngle * (instanceSize.z - size.y * (vert.x + vert.y));\n"
+		"  vec2 wing = vec2(instanceAngle.y, -instanceAngle.x) * (size.x * .5 * (vert.x - vert.y));\n"
+		"  gl_Position = vec4((base + wing) * scale, 0, 1);\n"
+		"}\n";
+
+	static const string instancedFragmentCode = FragmentCode(true);
+	instancedShader = Shader(instancedVertexCode, instancedFragmentCode.c_str());
+	instancedScaleI = instancedShader.Uniform("scale");
+
+	glGenVertexArrays(1, &instancedVao);
+	OpenGL::BindVertexArray(instancedVao);
+
+	// The corners of each pointer come from the same buffer as above.
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glEnableVertexAttribArray(instancedShader.Attrib("vert"));
+	glVertexAttribPointer(instancedShader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+	// Everything else comes from the instance buffer. The size and offset are
+	// next to each other, so they are read as a single attribute.
+	glGenBuffers(1, &instanceVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	auto Attribute = [](const char *name, GLint size, size_t offset)
+	{
+		GLuint attribute = instancedShader.Attrib(name);
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribPointer(attribute, size, GL_FLOAT, GL_FALSE, sizeof(PointerShader::Item),
+			reinterpret_cast<const GLvoid *>(offset));
+		glVertexAttribDivisor(attribute, 1);
+	};
+	Attribute("instanceCenter", 2, offsetof(Item, center));
+	Attribute("instanceAngle", 2, offsetof(Item, angle));
+	Attribute("instanceSize", 3, offsetof(Item, size));
+	Attribute("instanceColor", 4, offsetof(Item, color));
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	OpenGL::BindVertexArray(0);
 }
 
 
@@ -127,8 +225,8 @@ void PointerShader::Bind()
 	if(!shader.Object())
 		throw runtime_error("PointerShader: Bind() called before Init().");
 
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindVertexArray(vao);
 
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
 	glUniform2fv(scaleI, 1, scale);
@@ -139,26 +237,58 @@ void PointerShader::Bind()
 void PointerShader::Add(const Point &center, const Point &angle,
 	float width, float height, float offset, const Color &color)
 {
-	GLfloat c[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
-	glUniform2fv(centerI, 1, c);
+	DrawItem(MakeItem(center, angle, width, height, offset, color));
+}
+
 
-	GLfloat a[2] = {static_cast<float>(angle.X()), static_cast<float>(angle.Y())};
-	glUniform2fv(angleI, 1, a);
 
-	GLfloat size[2] = {width, height};
-	glUniform2fv(sizeI, 1, size);
+void PointerShader::Unbind()
+{
+	// The program and vertex array are left bound, so that drawing with
+	// this shader again does not need to bind them again.
+}
 
-	glUniform1f(offsetI, offset);
 
-	glUniform4fv(colorI, 1, color.Get());
 
-	glDrawArrays(GL_TRIANGLES, 0, 3);
+PointerShader::Item PointerShader::MakeItem(const Point &center, const Point &angle,
+	float width, float height, float offset, const Color &color)
+{
+	Item item;
+	item.center[0] = center.X();
+	item.center[1] = center.Y();
+	item.angle[0] = angle.X();
+	item.angle[1] = angle.Y();
+	item.size[0] = width;
+	item.size[1] = height;
+	item.offset = offset;
+	const float *rgba = color.Get();
+	copy(rgba, rgba + 4, item.color);
+	return item;
 }
 
 
 
-void PointerShader::Unbind()
+void PointerShader::Draw(const vector<Item> &items)
 {
-	glBindVertexArray(0);
-	glUseProgram(0);
+	if(items.empty())
+		return;
+	if(!useInstancing)
+	{
+		Bind();
+		for(const Item &item : items)
+			DrawItem(item);
+		Unbind();
+		return;
+	}
+
+	OpenGL::UseProgram(instancedShader.Object());
+	OpenGL::BindVertexArray(instancedVao);
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(instancedScaleI, 1, scale);
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, items.size() * sizeof(Item), items.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glDrawArraysInstanced(GL_TRIANGLES, 0, 3, items.size());
 }
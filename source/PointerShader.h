@@ -16,6 +16,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef POINTER_SHADER_H_
 #define POINTER_SHADER_H_
 
+#include <vector>
+
 class Color;
 class Point;
 
@@ -23,6 +25,18 @@ class Point;
 
 // Functions for drawing triangular "pointers," e.g. for target crosshairs.
 class PointerShader {
+public:
+	// One pointer to be drawn as part of a batch.
+	class Item {
+	public:
+		float center[2];
+		float angle[2];
+		float size[2];
+		float offset;
+		float color[4];
+	};
+
+
 public:
 	static void Init();
 
@@ -31,6 +45,13 @@ public:
 	static void Bind();
 	static void Add(const Point &center, const Point &angle, float width, float height, float offset, const Color &color);
 	static void Unbind();
+
+	// Make an item that draws what Add() would.
+	static Item MakeItem(const Point &center, const Point &angle, float width, float height, float offset,
+		const Color &color);
+	// Draw all the given pointers. If instancing is available, this takes only
+	// a single draw call. This does not need to be inside a Bind() / Unbind().
+	static void Draw(const std::vector<Item> &items);
 };
 
 
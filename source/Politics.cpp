@@ -71,6 +71,7 @@ void Politics::Reset()
 	// were already checked for when you first landed).
 	for(const auto &it : GameData::Governments())
 		fined.insert(&it.second);
+	UpdatePlayerEnemies();
 }
 
 
@@ -86,6 +87,8 @@ bool Politics::IsEnemy(const Government *first, const Government *second) const
 		swap(first, second);
 	if(first->IsPlayer())
 	{
+		if(second->Index() < playerEnemies.Size())
+			return playerEnemies.Test(second->Index());
 		if(bribed.count(second))
 			return false;
 		if(provoked.count(second))
@@ -97,6 +100,12 @@ bool Politics::IsEnemy(const Government *first, const Government *second) const
 
 	// Neither government is the player, so the question of enemies depends only
 	// on the attitude matrix.
+	if(enemiesRevision.load(memory_order_acquire) != GameData::UniverseRevision())
+		UpdateEnemies();
+	size_t row = first->Index();
+	size_t column = second->Index();
+	if(row < enemiesStride && column < enemiesStride)
+		return enemies.Test(row * enemiesStride + column);
 	return (first->AttitudeToward(second) < 0. || second->AttitudeToward(first) < 0.);
 }
 
@@ -111,36 +120,25 @@ void Politics::Offend(const Government *gov, int eventType, int count)
 	if(gov->IsPlayer())
 		return;
 
-	for(const auto &it : GameData::Governments())
-	{
-		const Government *other = &it.second;
-		double weight = other->AttitudeToward(gov);
+	if(enemiesRevision.load(memory_order_acquire) != GameData::UniverseRevision())
+		UpdateEnemies();
+	ApplyOffense(gov, eventType, count);
+}
 
-		// You can provoke a government even by attacking an empty ship, such as
-		// a drone (count = 0, because count = crew).
-		if(eventType & ShipEvent::PROVOKE)
-		{
-			if(weight > 0.)
-			{
-				// If you bribe a government but then attack it, the effect of
-				// your bribe is canceled out.
-				bribed.erase(other);
-				provoked.insert(other);
-			}
-		}
-		if(count && abs(weight) >= .05)
-		{
-			// Weights less than 5% should never cause permanent reputation
-			// changes. This is to allow two governments to be hostile or
-			// friendly without the player's behavior toward one of them
-			// influencing their reputation with the other.
-			double penalty = (count * weight) * other->PenaltyFor(eventType, gov);
-			if(eventType & ShipEvent::ATROCITY && weight > 0)
-				Politics::SetReputation(other, min(0., reputationWith[other]));
-
-			Politics::AddReputation(other, -penalty);
-		}
-	}
+
+
+// Commit all the given offenses, in order. Offenses that happen many times
+// in a step, like each shot at a ship, are gathered and committed at once.
+void Politics::Offend(const vector<Offense> &offenses)
+{
+	if(offenses.empty())
+		return;
+
+	if(enemiesRevision.load(memory_order_acquire) != GameData::UniverseRevision())
+		UpdateEnemies();
+	for(const Offense &offense : offenses)
+		if(!offense.gov->IsPlayer())
+			ApplyOffense(offense.gov, offense.eventType, offense.count);
 }
 
 
@@ -151,6 +149,7 @@ void Politics::Bribe(const Government *gov)
 	bribed.insert(gov);
 	provoked.erase(gov);
 	fined.insert(gov);
+	UpdatePlayerEnemy(gov);
 }
 
 
@@ -344,6 +343,7 @@ void Politics::SetReputation(const Government *gov, double value)
 	value = min(value, gov->ReputationMax());
 	value = max(value, gov->ReputationMin());
 	reputationWith[gov] = value;
+	UpdatePlayerEnemy(gov);
 }
 
 
@@ -355,4 +355,117 @@ void Politics::ResetDaily()
 	bribed.clear();
 	bribedPlanets.clear();
 	fined.clear();
+	UpdatePlayerEnemies();
+}
+
+
+
+void Politics::UpdatePlayerEnemy(const Government *gov)
+{
+	size_t index = gov->Index();
+	if(index >= playerEnemies.Size())
+		playerEnemies.Resize(max(index + 1, Government::IndexCount()));
+
+	if(!bribed.count(gov) && (provoked.count(gov) || Reputation(gov) < 0.))
+		playerEnemies.Set(index);
+	else
+		playerEnemies.Reset(index);
+}
+
+
+
+// Apply one offense, once the attitude matrices are up to date.
+void Politics::ApplyOffense(const Government *gov, int eventType, int count)
+{
+	// A government that is not part of the game data has no row of its own.
+	// Each government's attitude toward it has to be looked up instead.
+	const size_t row = gov->Index();
+	if(row >= enemiesStride)
+	{
+		for(const auto &it : GameData::Governments())
+			ApplyOffense(gov, &it.second, it.second.AttitudeToward(gov), eventType, count);
+		return;
+	}
+
+	const double *weights = attitudes.data() + row * enemiesStride;
+	for(size_t column = 0; column < enemiesStride; ++column)
+		if(weights[column] && governments[column])
+			ApplyOffense(gov, governments[column], weights[column], eventType, count);
+}
+
+
+
+// Apply an offense against the given government to your reputation with
+// another government that has the given attitude toward it.
+void Politics::ApplyOffense(const Government *gov, const Government *other, double weight, int eventType, int count)
+{
+	// You can provoke a government even by attacking an empty ship, such as
+	// a drone (count = 0, because count = crew).
+	if(eventType & ShipEvent::PROVOKE)
+	{
+		if(weight > 0.)
+		{
+			// If you bribe a government but then attack it, the effect of
+			// your bribe is canceled out.
+			bribed.erase(other);
+			provoked.insert(other);
+			UpdatePlayerEnemy(other);
+		}
+	}
+	if(count && abs(weight) >= .05)
+	{
+		// Weights less than 5% should never cause permanent reputation
+		// changes. This is to allow two governments to be hostile or
+		// friendly without the player's behavior toward one of them
+		// influencing their reputation with the other.
+		double penalty = (count * weight) * other->PenaltyFor(eventType, gov);
+		if(eventType & ShipEvent::ATROCITY && weight > 0)
+			Politics::SetReputation(other, min(0., reputationWith[other]));
+
+		Politics::AddReputation(other, -penalty);
+	}
+}
+
+
+
+void Politics::UpdatePlayerEnemies()
+{
+	playerEnemies.Clear();
+	playerEnemies.Resize(Government::IndexCount());
+	for(const auto &it : reputationWith)
+		UpdatePlayerEnemy(it.first);
+	for(const Government *gov : provoked)
+		UpdatePlayerEnemy(gov);
+}
+
+
+
+void Politics::UpdateEnemies() const
+{
+	lock_guard<mutex> lock(enemiesMutex);
+	uint64_t revision = GameData::UniverseRevision();
+	if(enemiesRevision.load(memory_order_relaxed) == revision)
+		return;
+
+	// Governments that are not part of the game data, such as the placeholder for
+	// systems without one, cannot be named in any attitude, so they are never enemies.
+	enemiesStride = Government::IndexCount();
+	enemies.Clear();
+	enemies.Resize(enemiesStride * enemiesStride);
+	attitudes.assign(enemiesStride * enemiesStride, 0.);
+	governments.assign(enemiesStride, nullptr);
+	for(const auto &first : GameData::Governments())
+	{
+		const Government *a = &first.second;
+		governments[a->Index()] = a;
+		for(const auto &second : GameData::Governments())
+		{
+			const Government *b = &second.second;
+			// A government's own attitude toward itself is always 1.
+			attitudes[b->Index() * enemiesStride + a->Index()] = a->AttitudeToward(b);
+			if(a != b && (a->AttitudeToward(b) < 0. || b->AttitudeToward(a) < 0.))
+				enemies.Set(a->Index() * enemiesStride + b->Index());
+		}
+	}
+	enemiesRevision.store(revision, memory_order_release);
 }
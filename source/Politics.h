@@ -16,9 +16,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef POLITICS_H_
 #define POLITICS_H_
 
+#include "Bitset.h"
+
+#include <atomic>
+#include <cstdint>
 #include <map>
+#include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 
 class Government;
 class Planet;
@@ -32,6 +38,16 @@ class Ship;
 // player. The player has a reputation with each government, which is affected
 // by what they do for a government or its allies or enemies.
 class Politics {
+public:
+	// An offense against a government, as given to Offend().
+	class Offense {
+	public:
+		const Government *gov;
+		int eventType;
+		int count;
+	};
+
+
 public:
 	// Reset to the initial political state defined in the game data.
 	void Reset();
@@ -43,6 +59,9 @@ public:
 	// hostilities (if the event type is PROVOKE), or a permanent change to your
 	// reputation.
 	void Offend(const Government *gov, int eventType, int count = 1);
+	// Commit all the given offenses, in order. Offenses that happen many times
+	// in a step, like each shot at a ship, are gathered and committed at once.
+	void Offend(const std::vector<Offense> &offenses);
 	// Bribe the given government to be friendly to you for one day.
 	void Bribe(const Government *gov);
 
@@ -69,6 +88,20 @@ public:
 	void ResetDaily();
 
 
+private:
+	// Recalculate whether the player is an enemy of the given government, or of all governments.
+	void UpdatePlayerEnemy(const Government *gov);
+	void UpdatePlayerEnemies();
+	// Apply one offense, once the attitude matrices are up to date.
+	void ApplyOffense(const Government *gov, int eventType, int count);
+	// Apply an offense against the given government to your reputation with
+	// another government that has the given attitude toward it.
+	void ApplyOffense(const Government *gov, const Government *other, double weight, int eventType, int count);
+	// Rebuild the matrices of the governments' attitudes toward each other, if
+	// the governments have changed since they were last built.
+	void UpdateEnemies() const;
+
+
 private:
 	// attitude[target][other] stores how much an action toward the given target
 	// government will affect your reputation with the given other government.
@@ -81,6 +114,22 @@ private:
 	std::map<const Planet *, bool> bribedPlanets;
 	std::set<const Planet *> dominatedPlanets;
 	std::set<const Government *> fined;
+
+	// Whether the player is an enemy of each government, by government index.
+	Bitset playerEnemies;
+	// Whether each pair of governments are enemies according to their attitudes,
+	// stored as a square matrix of government indices. It is only valid while
+	// the universe revision it was built for is current.
+	mutable std::mutex enemiesMutex;
+	mutable std::atomic<uint64_t> enemiesRevision{0};
+	mutable Bitset enemies;
+	mutable size_t enemiesStride = 0;
+	// The attitude of each government toward each other one, with a row for
+	// each government that may be offended, so that an offense only has to go
+	// over a single row. Rows and columns are the same as in the enemies matrix.
+	mutable std::vector<double> attitudes;
+	// The government with each index, if it is part of the game data.
+	mutable std::vector<const Government *> governments;
 };
 
 
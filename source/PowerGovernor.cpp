@@ -0,0 +1,188 @@
+/* PowerGovernor.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "PowerGovernor.h"
+
+#include "Preferences.h"
+#include "Profiler.h"
+
+#include <SDL2/SDL_power.h>
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef __ANDROID__
+#include <dlfcn.h>
+#endif
+
+using namespace std;
+
+namespace {
+	// How often to check the state of the device, in seconds. Checking it is a
+	// system call, so it is not done every frame.
+	const double POLL_INTERVAL = 5.;
+	// How long a lower level must be possible before it is used, in seconds.
+	const double RECOVERY_TIME = 60.;
+	// The battery levels at which to start saving power, or saving more of it.
+	const int SAVING_BATTERY = 20;
+	const int THROTTLED_BATTERY = 10;
+
+	PowerGovernor governor;
+	double lastPoll = -POLL_INTERVAL;
+	const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+
+	// The thermal status of the device, if it can be found.
+	int ReadThermalStatus()
+	{
+#ifdef __ANDROID__
+		// The thermal API is only available from Android 11 on, so look it up at
+		// runtime instead of linking to it.
+		typedef void *(*AcquireManager)();
+		typedef int (*GetStatus)(void *);
+		static bool isLoaded = false;
+		static void *manager = nullptr;
+		static GetStatus getStatus = nullptr;
+		if(!isLoaded)
+		{
+			isLoaded = true;
+			void *library = dlopen("libandroid.so", RTLD_NOW);
+			if(library)
+			{
+				auto acquire = reinterpret_cast<AcquireManager>(dlsym(library, "AThermal_acquireManager"));
+				getStatus = reinterpret_cast<GetStatus>(dlsym(library, "AThermal_getCurrentThermalStatus"));
+				if(acquire && getStatus)
+					manager = acquire();
+			}
+		}
+		if(manager && getStatus)
+			return max(0, getStatus(manager));
+#endif
+		return PowerGovernor::THERMAL_NONE;
+	}
+
+
+
+	// The level that the given state of the device calls for, ignoring how long
+	// it has been in that state.
+	PowerGovernor::Level Target(int batteryPercent, bool isCharging, int thermalStatus)
+	{
+		bool isLow = (!isCharging && batteryPercent >= 0);
+		if(thermalStatus >= PowerGovernor::THERMAL_SEVERE || (isLow && batteryPercent <= THROTTLED_BATTERY))
+			return PowerGovernor::Level::THROTTLED;
+		if(thermalStatus >= PowerGovernor::THERMAL_MODERATE || (isLow && batteryPercent <= SAVING_BATTERY))
+			return PowerGovernor::Level::SAVING;
+		return PowerGovernor::Level::NORMAL;
+	}
+}
+
+
+
+// Check the state of the device, if it has been long enough since it was last
+// checked, and update the game's level. This should be called once per frame.
+void PowerGovernor::Step()
+{
+	if(!Preferences::Has("Adaptive power saving"))
+	{
+		governor = PowerGovernor();
+		lastPoll = -POLL_INTERVAL;
+		return;
+	}
+
+	double now = chrono::duration<double>(chrono::steady_clock::now() - epoch).count();
+	if(now - lastPoll < POLL_INTERVAL)
+		return;
+	lastPoll = now;
+
+	int percent = -1;
+	SDL_PowerState state = SDL_GetPowerInfo(nullptr, &percent);
+	bool isCharging = (state != SDL_POWERSTATE_ON_BATTERY);
+	int thermalStatus = ReadThermalStatus();
+	governor.Update(percent, isCharging, thermalStatus, now);
+
+	Profiler::SetCounter("Power saving level", static_cast<double>(governor.GetLevel()));
+	Profiler::SetCounter("Thermal status", thermalStatus);
+}
+
+
+
+// Get the game's current level. This is always NORMAL unless the "Adaptive
+// power saving" preference is set.
+PowerGovernor::Level PowerGovernor::Current()
+{
+	return governor.GetLevel();
+}
+
+
+
+// Whether flight should only be drawn at half the usual frame rate.
+bool PowerGovernor::HalveFrameRate()
+{
+	return Current() >= Level::SAVING;
+}
+
+
+
+// The largest fraction of the screen's resolution the scene may be drawn at.
+double PowerGovernor::MaxSceneScale()
+{
+	return Current() >= Level::THROTTLED ? .75 : 1.;
+}
+
+
+
+// Whether the scene must be allowed to go lower than full resolution.
+bool PowerGovernor::ForceDynamicResolution()
+{
+	return Current() >= Level::THROTTLED;
+}
+
+
+
+// The fraction of the automatic visual effects budget to allow.
+double PowerGovernor::EffectScale()
+{
+	return Current() >= Level::THROTTLED ? .5 : 1.;
+}
+
+
+
+// Choose the level for the given state of the device, at the given time in
+// seconds. A negative battery percentage means it is unknown.
+PowerGovernor::Level PowerGovernor::Update(int batteryPercent, bool isCharging, int thermalStatus, double time)
+{
+	Level target = Target(batteryPercent, isCharging, thermalStatus);
+	if(target >= level)
+	{
+		level = target;
+		lowerSince = -1.;
+	}
+	else if(lowerSince < 0.)
+		lowerSince = time;
+	else if(time - lowerSince >= RECOVERY_TIME)
+	{
+		// Only come down one level at a time.
+		level = static_cast<Level>(static_cast<int>(level) - 1);
+		lowerSince = (target < level ? time : -1.);
+	}
+	return level;
+}
+
+
+
+PowerGovernor::Level PowerGovernor::GetLevel() const
+{
+	return level;
+}
@@ -0,0 +1,79 @@
+/* PowerGovernor.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef POWER_GOVERNOR_H_
+#define POWER_GOVERNOR_H_
+
+#include <cstdint>
+
+
+
+// Class that decides how much the game should hold back to save power, based on
+// the battery level and, on Android, how hot the device is. At each level the
+// game draws flight less often, draws the scene at a lower resolution, and keeps
+// fewer visual effects. The frame cost itself is already measured by the dynamic
+// resolution and the visual budget, which adapt within the limits set here. The
+// level goes up as soon as it is needed, but only comes back down once it has
+// not been needed for a while, so the quality does not flip back and forth.
+class PowerGovernor {
+public:
+	enum class Level : int_fast8_t {
+		NORMAL = 0,
+		SAVING,
+		THROTTLED
+	};
+
+	// The thermal status of the device, matching Android's values.
+	enum ThermalStatus : int {
+		THERMAL_NONE = 0,
+		THERMAL_LIGHT = 1,
+		THERMAL_MODERATE = 2,
+		THERMAL_SEVERE = 3
+	};
+
+
+public:
+	// Check the state of the device, if it has been long enough since it was last
+	// checked, and update the game's level. This should be called once per frame.
+	static void Step();
+	// Get the game's current level. This is always NORMAL unless the "Adaptive
+	// power saving" preference is set.
+	static Level Current();
+
+	// Whether flight should only be drawn at half the usual frame rate.
+	static bool HalveFrameRate();
+	// The largest fraction of the screen's resolution the scene may be drawn at,
+	// and whether it must be allowed to go lower than full resolution at all.
+	static double MaxSceneScale();
+	static bool ForceDynamicResolution();
+	// The fraction of the automatic visual effects budget to allow.
+	static double EffectScale();
+
+	// Choose the level for the given state of the device, at the given time in
+	// seconds. A negative battery percentage means it is unknown.
+	Level Update(int batteryPercent, bool isCharging, int thermalStatus, double time);
+	Level GetLevel() const;
+
+
+private:
+	Level level = Level::NORMAL;
+	// When the state of the device first allowed a lower level than the current
+	// one, or a negative value if it does not.
+	double lowerSince = -1.;
+};
+
+
+
+#endif
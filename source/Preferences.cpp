@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Files.h"
 #include "GameWindow.h"
 #include "Logger.h"
+#include "SaveQueue.h"
 #include "Screen.h"
 #include <SDL2/SDL_log.h>
 
@@ -38,6 +39,20 @@ using namespace std;
 namespace {
 	map<string, bool> settings;
 	int scrollSpeed = 60;
+	// The most texture memory, in megabytes, to use for sprites that can be
+	// unloaded and loaded again when needed (at the moment, landscapes).
+	int textureBudget = 128;
+	// The most visual effects that may be created in one step, or zero to
+	// adjust that limit automatically depending on how long steps take.
+	int visualBudget = 0;
+	// The most memory, in megabytes, to use for remembering routes between systems.
+	int routeCacheBudget = 16;
+	// The most memory, in megabytes, to use for decoded sound effects.
+#ifdef ES_GLES
+	int soundBudget = 16;
+#else
+	int soundBudget = 64;
+#endif
 
 	// Strings for ammo expenditure:
 	const string EXPEND_AMMO = "Escorts expend ammo";
@@ -193,6 +208,14 @@ void Preferences::Load()
 			Audio::SetVolume(node.Value(1) * VOLUME_SCALE);
 		else if(node.Token(0) == "scroll speed" && node.Size() >= 2)
 			scrollSpeed = node.Value(1);
+		else if(node.Token(0) == "texture budget" && node.Size() >= 2)
+			textureBudget = max<int>(1, node.Value(1));
+		else if(node.Token(0) == "visual budget" && node.Size() >= 2)
+			visualBudget = max<int>(0, node.Value(1));
+		else if(node.Token(0) == "route cache budget" && node.Size() >= 2)
+			routeCacheBudget = max<int>(1, node.Value(1));
+		else if(node.Token(0) == "sound budget" && node.Size() >= 2)
+			soundBudget = max<int>(1, node.Value(1));
 		else if(node.Token(0) == "boarding target")
 			boardingIndex = max<int>(0, min<int>(node.Value(1), BOARDING_SETTINGS.size() - 1));
 		else if(node.Token(0) == "view zoom")
@@ -260,12 +283,16 @@ void Preferences::Load()
 
 void Preferences::Save()
 {
-	DataWriter out(Files::Config() + "preferences.txt");
+	DataWriter out;
 
 	out.Write("volume", Audio::Volume() / VOLUME_SCALE);
 	out.Write("window size", Screen::RawWidth(), Screen::RawHeight());
 	out.Write("zoom", Screen::UserZoom());
 	out.Write("scroll speed", scrollSpeed);
+	out.Write("texture budget", textureBudget);
+	out.Write("visual budget", visualBudget);
+	out.Write("route cache budget", routeCacheBudget);
+	out.Write("sound budget", soundBudget);
 	out.Write("boarding target", boardingIndex);
 	out.Write("view zoom", viewZoom);
 	out.Write("vsync", vsyncIndex);
@@ -282,6 +309,8 @@ void Preferences::Save()
 
 	for(const auto &it : settings)
 		out.Write(it.first, it.second);
+
+	SaveQueue::Write(Files::Config() + "preferences.txt", out.Contents());
 }
 
 
@@ -335,6 +364,34 @@ void Preferences::SetScrollSpeed(int speed)
 
 
 
+int Preferences::TextureBudget()
+{
+	return textureBudget;
+}
+
+
+
+int Preferences::VisualBudget()
+{
+	return visualBudget;
+}
+
+
+
+int Preferences::RouteCacheBudget()
+{
+	return routeCacheBudget;
+}
+
+
+
+int Preferences::SoundBudget()
+{
+	return soundBudget;
+}
+
+
+
 // View zoom.
 double Preferences::ViewZoom()
 {
@@ -93,6 +93,16 @@ public:
 	static int ScrollSpeed();
 	static void SetScrollSpeed(int speed);
 
+	// The texture memory budget for sprites that can be reloaded, in megabytes.
+	static int TextureBudget();
+	// The most visual effects to create in each step, or zero if the game
+	// should decide that based on how long each step takes.
+	static int VisualBudget();
+	// The memory budget for remembering routes between systems, in megabytes.
+	static int RouteCacheBudget();
+	// The memory budget for decoded sound effects, in megabytes.
+	static int SoundBudget();
+
 	// View zoom.
 	static double ViewZoom();
 	static bool ZoomViewIn();
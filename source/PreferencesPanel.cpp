@@ -706,6 +706,10 @@ void PreferencesPanel::DrawSettings()
 		"",
 		"Performance",
 		"Show CPU / GPU load",
+		"Pipelined rendering",
+		"Battery saver",
+		"Dynamic resolution",
+		"Adaptive power saving",
 		"Render motion blur",
 		"Reduced graphics",
 		"Draw background haze",
@@ -756,6 +760,8 @@ void PreferencesPanel::DrawSettings()
 		"Always underline shortcuts",
 		REACTIVATE_HELP,
 		"Interrupt fast-forward",
+		"Record flight replays",
+		"Compress saved games",
 		SCROLL_SPEED
 	};
 
@@ -19,19 +19,26 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "GameData.h"
 #include "GameEvent.h"
+#include "JobPool.h"
 #include "LocationFilter.h"
 #include "Outfit.h"
 #include "Planet.h"
 #include "Ship.h"
 #include "System.h"
 
+#include <fstream>
 #include <iostream>
 #include <map>
 #include <set>
+#include <vector>
 
 using namespace std;
 
 namespace {
+	// With more systems and planets than this, they are matched against a
+	// location filter on several threads at once.
+	const size_t PARALLEL_MATCHES = 256;
+
 	// For getting the name of a ship model or outfit.
 	// The relevant method for each class has a different signature,
 	// so use template specialisation to select the appropriate version of the method.
@@ -666,14 +673,32 @@ namespace {
 			}
 		}
 
-		cout << "Systems matching provided location filter:\n";
+		// Check every system and planet at once, then print the matches in order.
+		vector<const pair<const string, System> *> systems;
 		for(const auto &it : GameData::Systems())
-			if(filter.Matches(&it.second))
-				cout << it.first << '\n';
-		cout << "Planets matching provided location filter:\n";
+			systems.push_back(&it);
+		vector<const pair<const string, Planet> *> planets;
 		for(const auto &it : GameData::Planets())
-			if(filter.Matches(&it.second))
-				cout << it.first << '\n';
+			planets.push_back(&it);
+		// Each job writes its own entry, so this can't be a vector<bool>.
+		vector<char> matches(systems.size() + planets.size());
+		JobPool pool(matches.size() > PARALLEL_MATCHES ? JobPool::DefaultThreadCount() : 0);
+		pool.ParallelFor(matches.size(), [&](size_t i) -> void
+		{
+			if(i < systems.size())
+				matches[i] = filter.Matches(&systems[i]->second);
+			else
+				matches[i] = filter.Matches(&planets[i - systems.size()]->second);
+		});
+
+		cout << "Systems matching provided location filter:\n";
+		for(size_t i = 0; i < systems.size(); ++i)
+			if(matches[i])
+				cout << systems[i]->first << '\n';
+		cout << "Planets matching provided location filter:\n";
+		for(size_t i = 0; i < planets.size(); ++i)
+			if(matches[systems.size() + i])
+				cout << planets[i]->first << '\n';
 	}
 
 
@@ -714,6 +739,23 @@ bool PrintData::IsPrintDataArgument(const char *const *argv)
 
 void PrintData::Print(const char *const *argv)
 {
+	// If asked to, write everything to a file instead of the standard output.
+	// The file is buffered as a whole rather than being flushed line by line.
+	ofstream file;
+	streambuf *standardOutput = cout.rdbuf();
+	for(const char *const *it = argv + 1; *it; ++it)
+		if(string(*it) == "--output" && *++it)
+		{
+			file.open(*it);
+			if(!file)
+			{
+				cerr << "Unable to write to \"" << *it << "\"." << endl;
+				return;
+			}
+			cout.rdbuf(file.rdbuf());
+			break;
+		}
+
 	for(const char *const *it = argv + 1; *it; ++it)
 	{
 		string arg = *it;
@@ -740,6 +782,7 @@ void PrintData::Print(const char *const *argv)
 			LocationFilterMatches(argv);
 	}
 	cout.flush();
+	cout.rdbuf(standardOutput);
 }
 
 
@@ -775,4 +818,6 @@ void PrintData::Help()
 	cerr << "    --matches: prints a list of all planets and systems matching a location filter passed in STDIN."
 			<< endl;
 	cerr << "        The first node of the location filter should be `location`." << endl;
+	cerr << "    Use the modifier `--output <file>` with any of the above commands to write the results to a file"
+			" instead." << endl;
 }
@@ -0,0 +1,327 @@
+/* Profiler.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Profiler.h"
+
+#include "Files.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+namespace {
+	// The number of events to remember. This must be a power of two. At 60 FPS
+	// with a few dozen zones per frame, this holds the last half a minute or so.
+	const uint64_t RING_SIZE = 1 << 16;
+	// Only events that started within this many microseconds are summarized.
+	const int64_t SUMMARY_WINDOW = 2000000;
+
+	// One recorded zone. Each field is atomic so that a reader never sees a torn
+	// value; the sequence number tells whether the fields belong together. While
+	// an event is being written its sequence is odd, and once it is complete it is
+	// 2 * (index + 1), where index is the event's position in the overall stream.
+	class Event {
+	public:
+		atomic<uint64_t> sequence;
+		atomic<const char *> name;
+		atomic<int64_t> start;
+		atomic<int64_t> duration;
+		atomic<uint32_t> thread;
+	};
+
+	// A copy of an event that is known to be complete.
+	class Record {
+	public:
+		const char *name;
+		int64_t start;
+		int64_t duration;
+		uint32_t thread;
+	};
+
+	Event ring[RING_SIZE];
+	atomic<uint64_t> cursor(0);
+	// Events before this index have been cleared.
+	atomic<uint64_t> firstIndex(0);
+	atomic<bool> enabled(false);
+
+	const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+	// Counters are set rarely enough that they can simply be kept in a map. They
+	// are sorted by the contents of the name, not its address.
+	bool CompareNames(const char *a, const char *b)
+	{
+		return strcmp(a, b) < 0;
+	}
+	mutex counterMutex;
+	map<const char *, double, bool (*)(const char *, const char *)> counters(CompareNames);
+
+	// A small identifier for the calling thread.
+	uint32_t ThreadID()
+	{
+		return static_cast<uint32_t>(hash<thread::id>()(this_thread::get_id()) & 0x7FFFFFFF);
+	}
+
+
+
+	void Push(const char *name, int64_t start, int64_t duration, uint32_t thread)
+	{
+		uint64_t index = cursor.fetch_add(1, memory_order_relaxed);
+		Event &event = ring[index & (RING_SIZE - 1)];
+
+		event.sequence.store(2 * index + 1, memory_order_relaxed);
+		atomic_thread_fence(memory_order_release);
+		event.name.store(name, memory_order_relaxed);
+		event.start.store(start, memory_order_relaxed);
+		event.duration.store(duration, memory_order_relaxed);
+		event.thread.store(thread, memory_order_relaxed);
+		event.sequence.store(2 * (index + 1), memory_order_release);
+	}
+
+
+
+	// Copy out every complete event still in the ring, oldest first. Events that
+	// are being written while this runs are skipped.
+	vector<Record> Snapshot()
+	{
+		vector<Record> records;
+		uint64_t first = firstIndex.load(memory_order_relaxed);
+		uint64_t end = cursor.load(memory_order_acquire);
+		if(end - first > RING_SIZE)
+			first = end - RING_SIZE;
+		records.reserve(end - first);
+
+		for(uint64_t index = first; index < end; ++index)
+		{
+			const Event &event = ring[index & (RING_SIZE - 1)];
+			uint64_t sequence = event.sequence.load(memory_order_acquire);
+			if(sequence != 2 * (index + 1))
+				continue;
+
+			Record record;
+			record.name = event.name.load(memory_order_relaxed);
+			record.start = event.start.load(memory_order_relaxed);
+			record.duration = event.duration.load(memory_order_relaxed);
+			record.thread = event.thread.load(memory_order_relaxed);
+			atomic_thread_fence(memory_order_acquire);
+			if(event.sequence.load(memory_order_relaxed) == sequence)
+				records.push_back(record);
+		}
+		return records;
+	}
+
+
+
+	// Summarize the events that started at or after the given time.
+	vector<Profiler::Summary> Summarize(const vector<Record> &records, int64_t since)
+	{
+		// Zone names are usually string literals, so the same name may be stored at
+		// more than one address. Group them by their contents instead.
+		map<const char *, vector<int64_t>, bool (*)(const char *, const char *)> durations(CompareNames);
+		for(const Record &record : records)
+			if(record.start >= since)
+				durations[record.name].push_back(record.duration);
+
+		vector<Profiler::Summary> result;
+		result.reserve(durations.size());
+		for(auto &it : durations)
+		{
+			vector<int64_t> &times = it.second;
+			sort(times.begin(), times.end());
+
+			Profiler::Summary summary;
+			summary.name = it.first;
+			summary.count = times.size();
+			summary.median = times[times.size() / 2] * .001;
+			summary.p95 = times[times.size() * 95 / 100] * .001;
+			summary.max = times.back() * .001;
+			result.push_back(summary);
+		}
+		return result;
+	}
+}
+
+
+
+const uint32_t Profiler::GPU_THREAD;
+
+
+
+Profiler::Zone::Zone(const char *name)
+	: name(name), start(enabled.load(memory_order_relaxed) ? Now() : -1)
+{
+}
+
+
+
+Profiler::Zone::~Zone()
+{
+	if(start >= 0)
+		Push(name, start, Now() - start, ThreadID());
+}
+
+
+
+void Profiler::SetEnabled(bool enable)
+{
+	enabled.store(enable, memory_order_relaxed);
+}
+
+
+
+bool Profiler::IsEnabled()
+{
+	return enabled.load(memory_order_relaxed);
+}
+
+
+
+vector<Profiler::Summary> Profiler::Summarize()
+{
+	return ::Summarize(Snapshot(), Now() - SUMMARY_WINDOW);
+}
+
+
+
+vector<Profiler::Summary> Profiler::SummarizeAll()
+{
+	return ::Summarize(Snapshot(), 0);
+}
+
+
+
+string Profiler::SummaryJSON()
+{
+	// The times are all in milliseconds.
+	string json = "{\"zones\":[\n";
+	bool isFirst = true;
+	for(const Summary &summary : SummarizeAll())
+	{
+		if(!isFirst)
+			json += ",\n";
+		isFirst = false;
+
+		json += "{\"name\":\"";
+		json += summary.name;
+		json += "\",\"count\":" + to_string(summary.count);
+		json += ",\"median\":" + to_string(summary.median);
+		json += ",\"p95\":" + to_string(summary.p95);
+		json += ",\"max\":" + to_string(summary.max) + "}";
+	}
+	json += "\n],\"counters\":[\n";
+	isFirst = true;
+	for(const Counter &counter : Counters())
+	{
+		if(!isFirst)
+			json += ",\n";
+		isFirst = false;
+
+		json += "{\"name\":\"";
+		json += counter.name;
+		json += "\",\"value\":" + to_string(counter.value) + "}";
+	}
+	json += "\n]}\n";
+	return json;
+}
+
+
+
+void Profiler::WriteTrace(const string &path)
+{
+	vector<Record> records = Snapshot();
+
+	string trace = "{\"traceEvents\":[\n";
+	bool isFirst = true;
+	for(const Record &record : records)
+	{
+		if(!isFirst)
+			trace += ",\n";
+		isFirst = false;
+
+		trace += "{\"name\":\"";
+		trace += record.name;
+		trace += "\",\"ph\":\"X\",\"ts\":" + to_string(record.start);
+		trace += ",\"dur\":" + to_string(record.duration);
+		trace += ",\"pid\":0,\"tid\":" + to_string(record.thread) + "}";
+	}
+	// Counters only have their latest value, so they show up at the end.
+	const string now = to_string(Now());
+	for(const Counter &counter : Counters())
+	{
+		if(!isFirst)
+			trace += ",\n";
+		isFirst = false;
+
+		trace += "{\"name\":\"";
+		trace += counter.name;
+		trace += "\",\"ph\":\"C\",\"ts\":" + now + ",\"pid\":0,\"args\":{\"value\":"
+			+ to_string(counter.value) + "}}";
+	}
+	trace += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	Files::Write(path, trace);
+}
+
+
+
+void Profiler::Clear()
+{
+	firstIndex.store(cursor.load(memory_order_relaxed), memory_order_relaxed);
+}
+
+
+
+// The current time, in microseconds since the program started.
+int64_t Profiler::Now()
+{
+	return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - epoch).count();
+}
+
+
+
+void Profiler::AddEvent(const char *name, int64_t start, int64_t duration, uint32_t thread)
+{
+	if(enabled.load(memory_order_relaxed))
+		Push(name, start, duration, thread);
+}
+
+
+
+void Profiler::SetCounter(const char *name, double value)
+{
+	if(!enabled.load(memory_order_relaxed))
+		return;
+
+	lock_guard<mutex> lock(counterMutex);
+	counters[name] = value;
+}
+
+
+
+vector<Profiler::Counter> Profiler::Counters()
+{
+	lock_guard<mutex> lock(counterMutex);
+	vector<Counter> result;
+	result.reserve(counters.size());
+	for(const auto &it : counters)
+		result.push_back({it.first, it.second});
+	return result;
+}
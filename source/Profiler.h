@@ -0,0 +1,105 @@
+/* Profiler.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+// A low-overhead profiler for finding out where the time in each frame goes.
+// Code to be measured is wrapped in a Profiler::Zone, which records how long it
+// took into a fixed-size ring buffer shared by all threads when it goes out of
+// scope. Recording never takes a lock, and if profiling is not enabled a zone
+// costs only a single atomic load. The most recent events can be summarized for
+// display in game, or saved as a Chrome trace (for chrome://tracing or Perfetto).
+// The profiler also keeps the latest value of a few counters, such as how much
+// texture memory is in use, which are updated far less often than zones.
+class Profiler {
+public:
+	// The thread that events timed on the graphics card are recorded under. No
+	// real thread is given this ID.
+	static const uint32_t GPU_THREAD = 0x80000000;
+
+	// Measure the time from this object's creation until its destruction.
+	class Zone {
+	public:
+		// The name must be a string literal, or otherwise live as long as the program.
+		explicit Zone(const char *name);
+		~Zone();
+
+		Zone(const Zone &other) = delete;
+		Zone &operator=(const Zone &other) = delete;
+
+	private:
+		const char *name;
+		int64_t start;
+	};
+
+	// The recent timing of one zone, in milliseconds.
+	class Summary {
+	public:
+		const char *name;
+		size_t count;
+		double median;
+		double p95;
+		double max;
+	};
+
+	// The latest value of a counter.
+	class Counter {
+	public:
+		const char *name;
+		double value;
+	};
+
+
+public:
+	// Start or stop recording zones.
+	static void SetEnabled(bool enabled);
+	static bool IsEnabled();
+
+	// Summarize the timing of each zone over the last couple of seconds,
+	// sorted by zone name.
+	static std::vector<Summary> Summarize();
+	// Summarize every recorded event still in the ring buffer in the same way.
+	static std::vector<Summary> SummarizeAll();
+	// Get the summary of every recorded event, and the value of each counter,
+	// as a JSON object that other tools can compare between runs.
+	static std::string SummaryJSON();
+	// Save every recorded event still in the ring buffer as a Chrome trace.
+	static void WriteTrace(const std::string &path);
+	// Discard all recorded events.
+	static void Clear();
+
+	// The current time in microseconds, on the same clock that zones use.
+	static int64_t Now();
+	// Record an event that was timed some other way, such as on the graphics
+	// card, if profiling is enabled. The name must live as long as the program.
+	static void AddEvent(const char *name, int64_t start, int64_t duration, uint32_t thread);
+
+	// Set the value of a counter, if profiling is enabled. Like a zone's name,
+	// the counter's name must live as long as the program.
+	static void SetCounter(const char *name, double value);
+	// Get the value of every counter, sorted by name.
+	static std::vector<Counter> Counters();
+};
+
+
+
+#endif
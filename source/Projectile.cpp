@@ -67,6 +67,8 @@ Projectile::Projectile(const Ship &parent, Point position, Angle angle, const We
 	// If a random lifetime is specified, add a random amount up to that amount.
 	if(weapon->RandomLifetime())
 		lifetime += Random::Int(weapon->RandomLifetime() + 1);
+
+	CheckBallistic();
 }
 
 
@@ -91,6 +93,8 @@ Projectile::Projectile(const Projectile &parent, const Point &offset, const Angl
 	// If a random lifetime is specified, add a random amount up to that amount.
 	if(weapon->RandomLifetime())
 		lifetime += Random::Int(weapon->RandomLifetime() + 1);
+
+	CheckBallistic();
 }
 
 
@@ -107,6 +111,16 @@ Projectile::Projectile(Point position, const Weapon *weapon)
 // This returns false if it is time to delete this projectile.
 void Projectile::Move(vector<Visual> &visuals, vector<Projectile> &projectiles)
 {
+	// Most projectiles just fly in a straight line until they expire, so there
+	// is no need to look up their weapon or target on each step.
+	if(isBallistic && !cachedTarget && lifetime > 1)
+	{
+		--lifetime;
+		position += velocity;
+		distanceTraveled += ballisticSpeed;
+		return;
+	}
+
 	if(--lifetime <= 0)
 	{
 		if(lifetime > -100)
@@ -135,11 +149,13 @@ void Projectile::Move(vector<Visual> &visuals, vector<Projectile> &projectiles)
 
 	// If the target has left the system, stop following it. Also stop if the
 	// target has been captured by a different government.
+	// Ships are only released between steps, so a target that still exists
+	// now stays alive until this step is over, and can be used through the
+	// cached pointer without touching its reference count.
 	const Ship *target = cachedTarget;
 	if(target)
 	{
-		target = TargetPtr().get();
-		if(!target || !target->IsTargetable() || target->GetGovernment() != targetGovernment)
+		if(targetShip.expired() || !target->IsTargetable() || target->GetGovernment() != targetGovernment)
 		{
 			targetShip.reset();
 			cachedTarget = nullptr;
@@ -370,6 +386,17 @@ void Projectile::BreakTarget()
 // and their brightness could could cause IR missiles to lose their locks more
 // often, and dense asteroid fields could do the same for radar and optically
 // guided missiles.
+// Check if this projectile will always move the same way on each step, as long
+// as it has no target.
+void Projectile::CheckBallistic()
+{
+	isBallistic = !weapon->Acceleration() && (!weapon->Turn() || weapon->Homing()) && weapon->LiveEffects().empty();
+	if(isBallistic)
+		ballisticSpeed = dV.Length();
+}
+
+
+
 void Projectile::CheckLock(const Ship &target)
 {
 	double base = hasLock ? 1. : .15;
@@ -98,6 +98,7 @@ public:
 
 
 private:
+	void CheckBallistic();
 	void CheckLock(const Ship &target);
 
 
@@ -105,6 +106,8 @@ private:
 	const Weapon *weapon = nullptr;
 
 	std::weak_ptr<Ship> targetShip;
+	// The target ship, which is only dereferenced once each step has checked
+	// that the weak pointer has not expired.
 	const Ship *cachedTarget = nullptr;
 	const Government *targetGovernment = nullptr;
 
@@ -115,6 +118,10 @@ private:
 	int lifetime = 0;
 	double distanceTraveled = 0;
 	bool hasLock = true;
+	// A projectile with no acceleration, turning, or live effects moves the same
+	// way on every step until it expires, unless it has a target to follow.
+	bool isBallistic = false;
+	double ballisticSpeed = 0.;
 };
 
 
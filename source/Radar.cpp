@@ -17,13 +17,18 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "GameData.h"
 #include "LineShader.h"
-#include "PointerShader.h"
-#include "RingShader.h"
 
 #include <cmath>
 
 using namespace std;
 
+namespace {
+	// The objects and pointers being drawn. These are kept to avoid
+	// reallocating them each frame.
+	vector<RingShader::Item> rings;
+	vector<PointerShader::Item> arrows;
+}
+
 const int Radar::PLAYER = 0;
 const int Radar::FRIENDLY = 1;
 const int Radar::UNFRIENDLY = 2;
@@ -57,7 +62,7 @@ void Radar::SetCenter(const Point &center)
 // given position should be in world units (not shrunk to radar units).
 void Radar::Add(int type, Point position, double outer, double inner)
 {
-	objects.emplace_back(GetColor(type).Opaque(), position - center, outer, inner);
+	objects.push_back(RingShader::MakeItem(position - center, outer, inner, GetColor(type).Opaque()));
 }
 
 
@@ -65,7 +70,7 @@ void Radar::Add(int type, Point position, double outer, double inner)
 // Add a pointer, pointing in the direction of the given vector.
 void Radar::AddPointer(int type, const Point &position)
 {
-	pointers.emplace_back(GetColor(type), position.Unit());
+	pointers.push_back(PointerShader::MakeItem(Point(), position.Unit(), 10.f, 10.f, 0.f, GetColor(type)));
 }
 
 
@@ -112,24 +117,29 @@ void Radar::Draw(const Point &center, double scale, double radius, double pointe
 	}
 
 	// Draw StellarObjects and ships.
-	RingShader::Bind();
-	for(const Object &object : objects)
+	rings = objects;
+	for(RingShader::Item &ring : rings)
 	{
-		Point position = object.position * scale;
+		Point position = Point(ring.position[0], ring.position[1]) * scale;
 		double length = position.Length();
 		if(length > radius)
 			position *= radius / length;
 		position += center;
 
-		RingShader::Add(position, object.outer, object.inner, object.color);
+		ring.position[0] = position.X();
+		ring.position[1] = position.Y();
 	}
-	RingShader::Unbind();
+	RingShader::Draw(rings);
 
 	// Draw neighboring system indicators.
-	PointerShader::Bind();
-	for(const Pointer &pointer : pointers)
-		PointerShader::Add(center, pointer.unit, 10.f, 10.f, pointerRadius, pointer.color);
-	PointerShader::Unbind();
+	arrows = pointers;
+	for(PointerShader::Item &arrow : arrows)
+	{
+		arrow.center[0] = center.X();
+		arrow.center[1] = center.Y();
+		arrow.offset = pointerRadius;
+	}
+	PointerShader::Draw(arrows);
 }
 
 
@@ -157,20 +167,6 @@ const Color &Radar::GetColor(int type)
 
 
 
-Radar::Object::Object(const Color &color, const Point &pos, double out, double in)
-	: color(color), position(pos), outer(out), inner(in)
-{
-}
-
-
-
-Radar::Pointer::Pointer(const Color &color, const Point &unit)
-	: color(color), unit(unit)
-{
-}
-
-
-
 // Create a line starting from "base" with length and angle described by "vector."
 Radar::Line::Line(const Color &color, const Point &base, const Point &vector)
 	: color(color), base(base), vector(vector)
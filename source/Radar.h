@@ -18,6 +18,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Color.h"
 #include "Point.h"
+#include "PointerShader.h"
+#include "RingShader.h"
 
 #include <vector>
 
@@ -60,24 +62,6 @@ public:
 
 
 private:
-	class Object {
-	public:
-		Object(const Color &color, const Point &pos, double out, double in);
-
-		Color color;
-		Point position;
-		double outer;
-		double inner;
-	};
-
-	class Pointer {
-	public:
-		Pointer(const Color &color, const Point &unit);
-
-		Color color;
-		Point unit;
-	};
-
 	class Line {
 	public:
 		Line(const Color &color, const Point &base, const Point &vector);
@@ -89,8 +73,10 @@ private:
 
 private:
 	Point center;
-	std::vector<Object> objects;
-	std::vector<Pointer> pointers;
+	// Objects and pointers are stored ready to be drawn, except that each
+	// object's position is in world units and each pointer's center is unset.
+	std::vector<RingShader::Item> objects;
+	std::vector<PointerShader::Item> pointers;
 	std::vector<Line> lines;
 };
 
@@ -23,19 +23,136 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
-// Right now thread_local storage is only supported under Linux.
 namespace {
-#ifndef __linux__
-	mutex workaroundMutex;
-	mt19937_64 gen;
+	// Advance the given SplitMix64 state and return its next output. Nearby
+	// inputs give unrelated outputs, so this is used to turn seeds and keys
+	// into generator states.
+	uint64_t SplitMix(uint64_t &state)
+	{
+		uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+
+
+	// The xoshiro256** generator. It has only 32 bytes of state, so it is cheap
+	// to seed for every task, and it is faster than std::mt19937_64.
+	class Xoshiro {
+	public:
+		using result_type = uint64_t;
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return UINT64_MAX; }
+
+		Xoshiro() { seed(5489); }
+
+		void seed(uint64_t value)
+		{
+			for(uint64_t &word : state)
+				word = SplitMix(value);
+		}
+
+		result_type operator()()
+		{
+			const uint64_t result = Rotate(state[1] * 5, 7) * 9;
+			const uint64_t t = state[1] << 17;
+			state[2] ^= state[0];
+			state[3] ^= state[1];
+			state[1] ^= state[2];
+			state[0] ^= state[3];
+			state[2] ^= t;
+			state[3] = Rotate(state[3], 45);
+			return result;
+		}
+
+	private:
+		static uint64_t Rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+	private:
+		uint64_t state[4];
+	};
+}
+
+
+
+// Each generator keeps its own distributions, since some of them (like the
+// normal distribution) remember values between calls.
+class Random::Generator {
+public:
+	Xoshiro gen;
 	uniform_int_distribution<uint32_t> uniform;
 	uniform_real_distribution<double> real;
 	normal_distribution<double> normal;
+};
+
+
+
+// Right now thread_local storage is only supported under Linux.
+namespace {
+#ifndef __linux__
+	mutex workaroundMutex;
+	Random::Generator shared;
+	Random::Generator *stream = nullptr;
+#else
+	thread_local Random::Generator shared;
+	thread_local Random::Generator *stream = nullptr;
+#endif
+
+	// Get the generator that the calling thread should use.
+	Random::Generator &Current()
+	{
+		return stream ? *stream : shared;
+	}
+}
+
+
+
+Random::Stream::Stream(uint64_t seed, uint64_t key)
+	: Stream(StreamSeed(seed, key))
+{
+}
+
+
+
+Random::Stream::Stream(uint64_t seed)
+	: generator(new Generator)
+{
+	generator->gen.seed(seed);
+#ifndef __linux__
+	lock_guard<mutex> lock(workaroundMutex);
+#endif
+	previous = stream;
+	stream = generator.get();
+}
+
+
+
+Random::Stream::~Stream()
+{
+#ifndef __linux__
+	lock_guard<mutex> lock(workaroundMutex);
+#endif
+	stream = previous;
+}
+
+
+
+// Derive the seed of an independent stream from a base seed and a stable key.
+uint64_t Random::StreamSeed(uint64_t seed, uint64_t key)
+{
+	uint64_t state = seed + key * 0x9E3779B97F4A7C15ull;
+	return SplitMix(state);
+}
+
+
+
+bool Random::IsThreadLocal()
+{
+#ifndef __linux__
+	return false;
 #else
-	thread_local mt19937_64 gen;
-	thread_local uniform_int_distribution<uint32_t> uniform;
-	thread_local uniform_real_distribution<double> real;
-	thread_local normal_distribution<double> normal;
+	return true;
 #endif
 }
 
@@ -48,7 +165,7 @@ void Random::Seed(uint64_t seed)
 #ifndef __linux__
 	lock_guard<mutex> lock(workaroundMutex);
 #endif
-	gen.seed(seed);
+	Current().gen.seed(seed);
 }
 
 
@@ -58,7 +175,8 @@ uint32_t Random::Int()
 #ifndef __linux__
 	lock_guard<mutex> lock(workaroundMutex);
 #endif
-	return uniform(gen);
+	Generator &current = Current();
+	return current.uniform(current.gen);
 }
 
 
@@ -68,7 +186,8 @@ uint32_t Random::Int(uint32_t upper_bound)
 #ifndef __linux__
 	lock_guard<mutex> lock(workaroundMutex);
 #endif
-	const uint32_t x = uniform(gen);
+	Generator &current = Current();
+	const uint32_t x = current.uniform(current.gen);
 	return (static_cast<uint64_t>(x) * static_cast<uint64_t>(upper_bound)) >> 32;
 }
 
@@ -79,7 +198,8 @@ double Random::Real()
 #ifndef __linux__
 	lock_guard<mutex> lock(workaroundMutex);
 #endif
-	return real(gen);
+	Generator &current = Current();
+	return current.real(current.gen);
 }
 
 
@@ -92,7 +212,7 @@ uint32_t Random::Polya(uint32_t k, double p)
 #ifndef __linux__
 	lock_guard<mutex> lock(workaroundMutex);
 #endif
-	return polya(gen);
+	return polya(Current().gen);
 }
 
 
@@ -104,7 +224,7 @@ uint32_t Random::Binomial(uint32_t t, double p)
 #ifndef __linux__
 	lock_guard<mutex> lock(workaroundMutex);
 #endif
-	return binomial(gen);
+	return binomial(Current().gen);
 }
 
 
@@ -115,5 +235,6 @@ double Random::Normal(double mean, double sigma)
 #ifndef __linux__
 	lock_guard<mutex> lock(workaroundMutex);
 #endif
-	return sigma * normal(gen) + mean;
+	Generator &current = Current();
+	return sigma * current.normal(current.gen) + mean;
 }
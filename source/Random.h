@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #define RANDOM_H_
 
 #include <cstdint>
+#include <memory>
 
 
 
@@ -25,9 +26,41 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // random number generation is not thread-safe.)
 class Random {
 public:
+	// The state of one generator. This is defined in Random.cpp.
+	class Generator;
+
+	// While a Stream exists, the thread that created it draws its random numbers
+	// from a generator of its own, seeded with the given value. Work that is split
+	// across threads can use one Stream per task, so that its results do not
+	// depend on which thread ran each task. A stream can also be derived from
+	// a base seed (drawn once for all the tasks) and a key that identifies the
+	// task or entity, such as its index.
+	class Stream {
+	public:
+		explicit Stream(uint64_t seed);
+		Stream(uint64_t seed, uint64_t key);
+		~Stream();
+
+		Stream(const Stream &) = delete;
+		Stream &operator=(const Stream &) = delete;
+
+	private:
+		std::unique_ptr<Generator> generator;
+		Generator *previous = nullptr;
+	};
+
+
+public:
+	// Whether each thread has a generator of its own. If not, Streams must only
+	// be used while no other thread is drawing random numbers.
+	static bool IsThreadLocal();
+
 	// Seed the generator (e.g. to make it produce exactly the same random
 	// numbers it produced previously).
 	static void Seed(uint64_t seed);
+	// Derive the seed of an independent stream from a base seed and a stable
+	// key. Different keys give unrelated streams even if they are adjacent.
+	static uint64_t StreamSeed(uint64_t seed, uint64_t key);
 
 	static uint32_t Int();
 	static uint32_t Int(uint32_t modulus);
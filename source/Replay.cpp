@@ -0,0 +1,433 @@
+/* Replay.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Replay.h"
+
+#include "Files.h"
+#include "PlayerInfo.h"
+#include "Random.h"
+#include "SaveQueue.h"
+
+#include <SDL2/SDL.h>
+
+#include <cstring>
+#include <memory>
+
+using namespace std;
+
+namespace {
+	// Every replay file begins with this, followed by the format version.
+	const string MAGIC = "ESREPLAY";
+	const uint8_t VERSION = 1;
+
+	// The flags stored with each run of steps and with each input.
+	const uint8_t HAS_TURN = 1;
+	const uint8_t HAS_SHIFT = 1;
+	const uint8_t HAS_CONTROL = 2;
+	const uint8_t IS_DOUBLE_TAP = 4;
+
+	// The flight that is being recorded, if any.
+	unique_ptr<Replay> recording;
+
+	// Store unsigned numbers seven bits at a time, so that small ones take one byte.
+	void WriteNumber(string &out, uint64_t value)
+	{
+		while(value >= 0x80)
+		{
+			out += static_cast<char>((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		out += static_cast<char>(value);
+	}
+
+	// Positions and turn amounts are stored exactly, since any rounding could
+	// change the outcome of the flight.
+	void WriteDouble(string &out, double value)
+	{
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		for(int i = 0; i < 8; ++i)
+			out += static_cast<char>((bits >> (8 * i)) & 0xFF);
+	}
+
+	// Read the binary form back in, failing if it runs past the end.
+	class Reader {
+	public:
+		explicit Reader(const string &data) : data(data) {}
+
+		bool Byte(uint8_t &value)
+		{
+			if(position >= data.size())
+				return false;
+			value = static_cast<uint8_t>(data[position++]);
+			return true;
+		}
+
+		bool Number(uint64_t &value)
+		{
+			value = 0;
+			for(int shift = 0; shift < 64; shift += 7)
+			{
+				uint8_t byte;
+				if(!Byte(byte))
+					return false;
+				value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+				if(!(byte & 0x80))
+					return true;
+			}
+			return false;
+		}
+
+		bool Double(double &value)
+		{
+			uint64_t bits = 0;
+			for(int i = 0; i < 8; ++i)
+			{
+				uint8_t byte;
+				if(!Byte(byte))
+					return false;
+				bits |= static_cast<uint64_t>(byte) << (8 * i);
+			}
+			memcpy(&value, &bits, sizeof(value));
+			return true;
+		}
+
+		bool Text(string &value, size_t length)
+		{
+			if(length > data.size() - position)
+				return false;
+			value = data.substr(position, length);
+			position += length;
+			return true;
+		}
+
+		bool IsDone() const
+		{
+			return position == data.size();
+		}
+
+	private:
+		const string &data;
+		size_t position = 0;
+	};
+
+	// Group selections and finger IDs may be negative, so they are stored in
+	// zigzag form: 0, -1, 1, -2, 2 and so on.
+	uint64_t ZigZag(int value)
+	{
+		return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(-static_cast<int64_t>(value < 0));
+	}
+
+	int UnZigZag(uint64_t value)
+	{
+		return static_cast<int>(static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1));
+	}
+
+	bool SendQuitEvent()
+	{
+		SDL_Event event;
+		event.type = SDL_QUIT;
+		return SDL_PushEvent(&event);
+	}
+}
+
+
+
+Replay::Input::Input(InputType type, const Point &from, const Point &to, int value, bool hasShift, bool hasControl)
+	: type(type), from(from), to(to), value(value), hasShift(hasShift), hasControl(hasControl)
+{
+}
+
+
+
+bool Replay::Input::operator==(const Input &other) const
+{
+	return type == other.type && from.X() == other.from.X() && from.Y() == other.from.Y()
+		&& to.X() == other.to.X() && to.Y() == other.to.Y() && value == other.value
+		&& hasShift == other.hasShift && hasControl == other.hasControl && isDoubleTap == other.isDoubleTap;
+}
+
+
+
+Replay::Cursor::Cursor(const Replay *replay)
+	: replay(replay)
+{
+}
+
+
+
+const Replay *Replay::Cursor::Get() const
+{
+	return replay;
+}
+
+
+
+bool Replay::Cursor::Next(Command &command, vector<Input> &inputs)
+{
+	if(!replay || index >= replay->steps.size())
+		return false;
+
+	const Step &step = replay->steps[index];
+	command = step.command;
+	if(!repeat)
+		inputs.insert(inputs.end(), step.inputs.begin(), step.inputs.end());
+	if(++repeat == step.count)
+	{
+		++index;
+		repeat = 0;
+	}
+
+	// Like a test, a replay quits the game when it is done.
+	if(index == replay->steps.size())
+		SendQuitEvent();
+	return true;
+}
+
+
+
+void Replay::StartRecording(const PlayerInfo &player)
+{
+	const uint64_t seed = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+	Random::Seed(seed);
+	recording.reset(new Replay(seed, player.SaveToString()));
+}
+
+
+
+Replay *Replay::Recording()
+{
+	return recording.get();
+}
+
+
+
+void Replay::FinishRecording()
+{
+	// If the player did not actually take off, there is nothing to save.
+	if(recording && recording->Steps())
+		SaveQueue::Write(RecordingPath(), recording->Encode());
+	recording.reset();
+}
+
+
+
+string Replay::RecordingPath()
+{
+	return Files::Config() + "last flight.replay";
+}
+
+
+
+Replay::Replay(uint64_t seed, const string &savedGame)
+	: seed(seed), savedGame(savedGame)
+{
+}
+
+
+
+uint64_t Replay::Seed() const
+{
+	return seed;
+}
+
+
+
+const string &Replay::SavedGame() const
+{
+	return savedGame;
+}
+
+
+
+int Replay::FirstStep() const
+{
+	return firstStep;
+}
+
+
+
+void Replay::SetFirstStep(int step)
+{
+	firstStep = step;
+}
+
+
+
+size_t Replay::Steps() const
+{
+	return stepCount;
+}
+
+
+
+void Replay::AddInput(const Input &input)
+{
+	pendingInputs.push_back(input);
+}
+
+
+
+void Replay::SetCommand(const Command &command)
+{
+	pendingCommand = command;
+	hasPendingCommand = true;
+}
+
+
+
+void Replay::EndStep()
+{
+	if(!hasPendingCommand)
+		return;
+
+	// If nothing new was clicked and the commands have not changed, this step
+	// just extends the last run.
+	if(!steps.empty() && pendingInputs.empty() && steps.back().command == pendingCommand
+			&& steps.back().count < UINT32_MAX)
+		++steps.back().count;
+	else
+	{
+		steps.emplace_back();
+		steps.back().command = pendingCommand;
+		steps.back().inputs.swap(pendingInputs);
+	}
+	++stepCount;
+	pendingInputs.clear();
+	pendingCommand.Clear();
+	hasPendingCommand = false;
+}
+
+
+
+string Replay::Encode() const
+{
+	string out = MAGIC;
+	out += static_cast<char>(VERSION);
+	WriteNumber(out, seed);
+	WriteNumber(out, savedGame.size());
+	out += savedGame;
+	WriteNumber(out, ZigZag(firstStep));
+
+	WriteNumber(out, steps.size());
+	for(const Step &step : steps)
+	{
+		WriteNumber(out, step.count);
+		WriteNumber(out, step.command.Bits());
+		const double turn = step.command.Turn();
+		out += static_cast<char>(turn ? HAS_TURN : 0);
+		if(turn)
+			WriteDouble(out, turn);
+
+		WriteNumber(out, step.inputs.size());
+		for(const Input &input : step.inputs)
+		{
+			out += static_cast<char>(input.type);
+			out += static_cast<char>((input.hasShift ? HAS_SHIFT : 0) | (input.hasControl ? HAS_CONTROL : 0)
+				| (input.isDoubleTap ? IS_DOUBLE_TAP : 0));
+			WriteNumber(out, ZigZag(input.value));
+			WriteDouble(out, input.from.X());
+			WriteDouble(out, input.from.Y());
+			// Only a click (which may be a drag) has a second point.
+			if(input.type == InputType::CLICK)
+			{
+				WriteDouble(out, input.to.X());
+				WriteDouble(out, input.to.Y());
+			}
+		}
+	}
+	return out;
+}
+
+
+
+bool Replay::Decode(const string &data)
+{
+	*this = Replay();
+
+	Replay result;
+	Reader in(data);
+	string magic;
+	uint8_t version = 0;
+	uint64_t length = 0;
+	if(!in.Text(magic, MAGIC.size()) || magic != MAGIC || !in.Byte(version) || version != VERSION
+			|| !in.Number(result.seed) || !in.Number(length) || !in.Text(result.savedGame, length)
+			|| !in.Number(length))
+		return false;
+	result.firstStep = UnZigZag(length);
+	if(!in.Number(length))
+		return false;
+
+	for(uint64_t i = 0; i < length; ++i)
+	{
+		Step step;
+		uint64_t count = 0;
+		uint64_t bits = 0;
+		uint8_t flags = 0;
+		double turn = 0.;
+		uint64_t inputs = 0;
+		if(!in.Number(count) || !count || count > UINT32_MAX || !in.Number(bits) || !in.Byte(flags)
+				|| ((flags & HAS_TURN) && !in.Double(turn)) || !in.Number(inputs))
+			return false;
+		step.count = count;
+		step.command = Command::FromBits(bits, turn);
+
+		for(uint64_t j = 0; j < inputs; ++j)
+		{
+			Input input;
+			uint8_t type = 0;
+			uint64_t value = 0;
+			double x = 0.;
+			double y = 0.;
+			if(!in.Byte(type) || type > static_cast<uint8_t>(InputType::FINGER_UP) || !in.Byte(flags)
+					|| !in.Number(value) || !in.Double(x) || !in.Double(y))
+				return false;
+			input.type = static_cast<InputType>(type);
+			input.hasShift = flags & HAS_SHIFT;
+			input.hasControl = flags & HAS_CONTROL;
+			input.isDoubleTap = flags & IS_DOUBLE_TAP;
+			input.value = UnZigZag(value);
+			input.from = Point(x, y);
+			if(input.type == InputType::CLICK)
+			{
+				if(!in.Double(x) || !in.Double(y))
+					return false;
+				input.to = Point(x, y);
+			}
+			step.inputs.push_back(input);
+		}
+		result.stepCount += step.count;
+		result.steps.push_back(std::move(step));
+	}
+	if(!in.IsDone())
+		return false;
+
+	*this = std::move(result);
+	return true;
+}
+
+
+
+void Replay::Save(const string &path) const
+{
+	Files::Write(path, Encode());
+}
+
+
+
+bool Replay::Load(const string &path)
+{
+	return Decode(Files::Read(path));
+}
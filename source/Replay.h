@@ -0,0 +1,152 @@
+/* Replay.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include "Command.h"
+#include "Point.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class PlayerInfo;
+
+
+
+// A recording of one flight: the random seed and the player's saved game as of
+// takeoff, followed by the commands and clicks the player gave in every step.
+// Loading the same saved game with the same seed and giving the same inputs
+// re-simulates the flight, so a slow battle that a player reports can be run
+// again with the profiler as often as needed. The recording is stored in a
+// compact binary form, in which a run of steps with the same input takes only
+// a few bytes.
+class Replay {
+public:
+	// The kinds of input the player can give between steps, besides commands.
+	enum class InputType : uint8_t {CLICK, RIGHT_CLICK, GROUP, FINGER_DOWN, FINGER_MOVE, FINGER_UP};
+
+	// One click, touch, or group selection.
+	class Input {
+	public:
+		Input() = default;
+		Input(InputType type, const Point &from, const Point &to = Point(), int value = 0,
+			bool hasShift = false, bool hasControl = false);
+
+		bool operator==(const Input &other) const;
+
+	public:
+		InputType type = InputType::CLICK;
+		Point from;
+		Point to;
+		// The group that was selected, or the finger that touched the screen.
+		int value = 0;
+		bool hasShift = false;
+		bool hasControl = false;
+		// Whether a touch came soon enough after the last one to be a double tap.
+		bool isDoubleTap = false;
+	};
+
+	// The position of playback within a replay.
+	class Cursor {
+	public:
+		Cursor() = default;
+		explicit Cursor(const Replay *replay);
+
+		const Replay *Get() const;
+		// Get the input of the next step. If this is the last step, the game is
+		// told to quit once it is done; if there are no steps left, this returns
+		// false and changes nothing.
+		bool Next(Command &command, std::vector<Input> &inputs);
+
+	private:
+		const Replay *replay = nullptr;
+		size_t index = 0;
+		uint32_t repeat = 0;
+	};
+
+
+public:
+	// Begin recording the flight that the given player is about to take off on,
+	// replacing any earlier recording. This seeds the random number generator,
+	// so that the flight can be re-simulated from the seed and saved game.
+	static void StartRecording(const PlayerInfo &player);
+	// Get the recording in progress, or null if nothing is being recorded.
+	static Replay *Recording();
+	// Stop recording, and save the recording to the replay file.
+	static void FinishRecording();
+	// Where the most recent recording is saved.
+	static std::string RecordingPath();
+
+
+public:
+	Replay() = default;
+	Replay(uint64_t seed, const std::string &savedGame);
+
+	uint64_t Seed() const;
+	const std::string &SavedGame() const;
+	// Get or set the Engine's step count when the flight began. Some things,
+	// like which frame of a ship's animation its collision mask comes from,
+	// depend on it.
+	int FirstStep() const;
+	void SetFirstStep(int step);
+	// Get the number of steps that were recorded.
+	size_t Steps() const;
+
+	// Record an input given before the current step begins.
+	void AddInput(const Input &input);
+	// Record the player's commands in the current step.
+	void SetCommand(const Command &command);
+	// Finish recording the current step. Steps whose commands were never set
+	// (e.g. the step in which the player took off) are not recorded, and their
+	// inputs are kept for the next step.
+	void EndStep();
+
+	// Convert to or from the binary form. If decoding fails, the replay is left empty.
+	std::string Encode() const;
+	bool Decode(const std::string &data);
+	void Save(const std::string &path) const;
+	bool Load(const std::string &path);
+
+
+private:
+	// A run of consecutive steps that all had the same input.
+	class Step {
+	public:
+		Command command;
+		uint32_t count = 1;
+		// Inputs are only given in the first step of a run, so steps with
+		// inputs are never merged with the steps that follow them.
+		std::vector<Input> inputs;
+	};
+
+
+private:
+	uint64_t seed = 0;
+	std::string savedGame;
+	int firstStep = 0;
+	std::vector<Step> steps;
+	size_t stepCount = 0;
+
+	// The current step, while recording.
+	std::vector<Input> pendingInputs;
+	Command pendingCommand;
+	bool hasPendingCommand = false;
+};
+
+
+
+#endif
@@ -21,6 +21,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Screen.h"
 #include "Shader.h"
 
+#include "opengl.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 
@@ -39,6 +44,104 @@ namespace {
 
 	GLuint vao;
 	GLuint vbo;
+
+	// When it is available, a batch of rings is drawn with a single instanced
+	// draw call. This shader reads the values that the one above takes as
+	// uniforms from a buffer with one Item per ring.
+	bool useInstancing = false;
+	Shader instancedShader;
+	GLint instancedScaleI;
+	GLint instancedOffsetI;
+	GLuint instancedVao;
+	GLuint instanceVbo;
+
+
+	// Generate the code for the fragment shader.
+	string FragmentCode(bool isInstanced)
+	{
+		// The instanced shader gets these values from the vertex shader instead.
+		const char *input = isInstanced ? "flat in " : "uniform ";
+		ostringstream fragmentCodeStream;
+		fragmentCodeStream <<
+			"// fragment ring shader\n"
+			"precision mediump float;\n"
+			<< input << "vec4 color;\n"
+			<< input << "float radius;\n"
+			<< input << "float width;\n"
+			<< input << "float angle;\n"
+			<< input << "float startAngle;\n"
+			<< input << "float dash;\n"
+			"const float pi = 3.1415926535897932384626433832795;\n"
+
+			"in vec2 coord;\n"
+			"out vec4 finalColor;\n"
+
+			"void main() {\n"
+			"  float arc = mod(atan(coord.x, coord.y) + pi + startAngle, 2.f * pi);\n"
+			"  float arcFalloff = 1.f - min(2.f * pi - arc, arc - angle) * radius;\n"
+			"  if(dash != 0.f)\n"
+			"  {\n"
+			"    arc = mod(arc, dash);\n"
+			"    arcFalloff = min(arcFalloff, min(arc, dash - arc) * radius);\n"
+			"  }\n"
+			"  float len = length(coord);\n"
+			"  float lenFalloff = width - abs(len - radius);\n"
+			"  float alpha = clamp(min(arcFalloff, lenFalloff), 0.f, 1.f);\n"
+			"  finalColor = color * alpha;\n"
+			"}\n";
+		return fragmentCodeStream.str();
+	}
+
+
+
+	void Replace(string &s, const string &a, const string &b)
+	{
+		size_t pos = s.find(a);
+		while(pos != string::npos)
+		{
+			s.replace(pos, a.size(), b);
+			pos = s.find(a);
+		}
+	}
+
+
+
+	// Draw one ring with the non-instanced shader, which must be bound.
+	void DrawItem(const RingShader::Item &item)
+	{
+		glUniform2fv(positionI, 1, item.position);
+
+		glUniform1f(radiusI, item.radius);
+		glUniform1f(widthI, item.width);
+		glUniform1f(angleI, item.angle);
+		glUniform1f(startAngleI, item.startAngle);
+		glUniform1f(dashI, item.dash);
+
+		glUniform4fv(colorI, 1, item.color);
+
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+	}
+
+
+
+	// Default mediump code has some visual glitches for large rings. See if a
+	// highp variant will compile first.
+	Shader Compile(const string &vertexCode, const string &fragmentCode)
+	{
+		try
+		{
+			string vertexHighpCode(vertexCode);
+			string fragmentHighpCode(fragmentCode);
+			Replace(vertexHighpCode, " mediump ", " highp ");
+			Replace(fragmentHighpCode, " mediump ", " highp ");
+			return Shader(vertexHighpCode.c_str(), fragmentHighpCode.c_str());
+		}
+		catch(const runtime_error &)
+		{
+			// Fall back to the default mediump code.
+			return Shader(vertexCode.c_str(), fragmentCode.c_str());
+		}
+	}
 }
 
 
@@ -61,59 +164,7 @@ void RingShader::Init()
 		"  gl_Position = vec4((coord + position) * scale, 0.f, 1.f);\n"
 		"}\n";
 
-	static const char *fragmentCode =
-		"// fragment ring shader\n"
-		"precision mediump float;\n"
-		"uniform vec4 color;\n"
-		"uniform float radius;\n"
-		"uniform float width;\n"
-		"uniform float angle;\n"
-		"uniform float startAngle;\n"
-		"uniform float dash;\n"
-		"const float pi = 3.1415926535897932384626433832795;\n"
-
-		"in vec2 coord;\n"
-		"out vec4 finalColor;\n"
-
-		"void main() {\n"
-		"  float arc = mod(atan(coord.x, coord.y) + pi + startAngle, 2.f * pi);\n"
-		"  float arcFalloff = 1.f - min(2.f * pi - arc, arc - angle) * radius;\n"
-		"  if(dash != 0.f)\n"
-		"  {\n"
-		"    arc = mod(arc, dash);\n"
-		"    arcFalloff = min(arcFalloff, min(arc, dash - arc) * radius);\n"
-		"  }\n"
-		"  float len = length(coord);\n"
-		"  float lenFalloff = width - abs(len - radius);\n"
-		"  float alpha = clamp(min(arcFalloff, lenFalloff), 0.f, 1.f);\n"
-		"  finalColor = color * alpha;\n"
-		"}\n";
-
-	auto replace = [](std::string& s, const std::string& a, const std::string& b)
-	{
-		size_t pos = s.find(a);
-		while(pos != std::string::npos)
-		{
-			s.replace(pos, a.size(), b);
-			pos = s.find(a);
-		}
-	};
-	
-	try
-	{
-		// default mediump code has some visual glitches for large rings. See if
-		// a highp variant will compile first.
-		std::string vertexHighpCode(vertexCode);
-		std::string fragmentHighpCode(fragmentCode);
-		replace(vertexHighpCode, " mediump ", " highp ");
-		replace(fragmentHighpCode, " mediump ", " highp ");
-		shader = Shader(vertexHighpCode.c_str(), fragmentHighpCode.c_str());
-	}
-	catch (const std::runtime_error&)
-	{
-		// fallback to default mediump code
-		shader = Shader(vertexCode, fragmentCode);
-	}
+	shader = Compile(vertexCode, FragmentCode(false));
 	scaleI = shader.Uniform("scale");
 	positionI = shader.Uniform("position");
 	radiusI = shader.Uniform("radius");
@@ -125,7 +176,7 @@ void RingShader::Init()
 
 	// Generate the vertex data for drawing sprites.
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -143,7 +194,72 @@ void RingShader::Init()
 
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
+
+	useInstancing = OpenGL::HasInstancingSupport();
+	if(!useInstancing)
+		return;
+
+	static const char *instancedVertexCode =
+		"// vertex instanced ring shader\n"
+		"precision mediump float;\n"
+		"uniform vec2 scale;\n"
+		"uniform vec2 offset;\n"
+
+		"in vec2 vert;\n"
+		"in vec2 instancePosition;\n"
+		"in vec2 instanceSize;\n"
+		"in vec3 instanceArc;\n"
+		"in vec4 instanceColor;\n"
+		"out vec2 coord;\n"
+		"flat out vec4 color;\n"
+		"flat out float radius;\n"
+		"flat out float width;\n"
+		"flat out float angle;\n"
+		"flat out float startAngle;\n"
+		"flat out float dash;\n"
+
+		"void main() {\n"
+		"  radius = instanceSize.x;\n"
+		"  width = instanceSize.y;\n"
+		"  angle = instanceArc.x;\n"
+		"  startAngle = instanceArc.y;\n"
+		"  dash = instanceArc.z;\n"
+		"  color = instanceColor;\n"
+		"  coord = (radius + width) * vert;\n"
+		"  gl_Position = vec4((coord + instancePosition + offset) * scale, 0.f, 1.f);\n"
+		"}\n";
+
+	instancedShader = Compile(instancedVertexCode, FragmentCode(true));
+	instancedScaleI = instancedShader.Uniform("scale");
+	instancedOffsetI = instancedShader.Uniform("offset");
+
+	glGenVertexArrays(1, &instancedVao);
+	OpenGL::BindVertexArray(instancedVao);
+
+	// The corners of each ring come from the same buffer as above.
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glEnableVertexAttribArray(instancedShader.Attrib("vert"));
+	glVertexAttribPointer(instancedShader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+	// Everything else comes from the instance buffer.
+	glGenBuffers(1, &instanceVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	auto Attribute = [](const char *name, GLint size, size_t offset)
+	{
+		GLuint attribute = instancedShader.Attrib(name);
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribPointer(attribute, size, GL_FLOAT, GL_FALSE, sizeof(RingShader::Item),
+			reinterpret_cast<const GLvoid *>(offset));
+		glVertexAttribDivisor(attribute, 1);
+	};
+	Attribute("instancePosition", 2, offsetof(Item, position));
+	Attribute("instanceSize", 2, offsetof(Item, radius));
+	Attribute("instanceArc", 3, offsetof(Item, angle));
+	Attribute("instanceColor", 4, offsetof(Item, color));
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	OpenGL::BindVertexArray(0);
 }
 
 
@@ -173,8 +289,8 @@ void RingShader::Bind()
 	if(!shader.Object())
 		throw runtime_error("RingShader: Bind() called before Init().");
 
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindVertexArray(vao);
 
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
 	glUniform2fv(scaleI, 1, scale);
@@ -193,24 +309,79 @@ void RingShader::Add(const Point &pos, float out, float in, const Color &color)
 void RingShader::Add(const Point &pos, float radius, float width, float fraction,
 	const Color &color, float dash, float startAngle)
 {
-	GLfloat position[2] = {static_cast<float>(pos.X()), static_cast<float>(pos.Y())};
-	glUniform2fv(positionI, 1, position);
+	DrawItem(MakeItem(pos, radius, width, fraction, color, dash, startAngle));
+}
 
-	glUniform1f(radiusI, radius);
-	glUniform1f(widthI, width);
-	glUniform1f(angleI, fraction * 2. * PI);
-	glUniform1f(startAngleI, startAngle * TO_RAD);
-	glUniform1f(dashI, dash ? 2. * PI / dash : 0.);
 
-	glUniform4fv(colorI, 1, color.Get());
 
-	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+void RingShader::Unbind()
+{
+	// The program and vertex array are left bound, so that drawing with
+	// this shader again does not need to bind them again.
 }
 
 
 
-void RingShader::Unbind()
+RingShader::Item RingShader::MakeItem(const Point &pos, float out, float in, const Color &color)
 {
-	glBindVertexArray(0);
-	glUseProgram(0);
+	float width = .5f * (1.f + out - in) ;
+	return MakeItem(pos, out - width, width, 1.f, color);
+}
+
+
+
+RingShader::Item RingShader::MakeItem(const Point &pos, float radius, float width, float fraction,
+	const Color &color, float dash, float startAngle)
+{
+	Item item;
+	item.position[0] = pos.X();
+	item.position[1] = pos.Y();
+	item.radius = radius;
+	item.width = width;
+	item.angle = fraction * 2. * PI;
+	item.startAngle = startAngle * TO_RAD;
+	item.dash = dash ? 2. * PI / dash : 0.;
+	const float *rgba = color.Get();
+	copy(rgba, rgba + 4, item.color);
+	return item;
+}
+
+
+
+void RingShader::Draw(const vector<Item> &items)
+{
+	Draw(items, Point());
+}
+
+
+
+void RingShader::Draw(const vector<Item> &items, const Point &offset)
+{
+	if(items.empty())
+		return;
+	if(!useInstancing)
+	{
+		Bind();
+		for(Item item : items)
+		{
+			item.position[0] += offset.X();
+			item.position[1] += offset.Y();
+			DrawItem(item);
+		}
+		Unbind();
+		return;
+	}
+
+	OpenGL::UseProgram(instancedShader.Object());
+	OpenGL::BindVertexArray(instancedVao);
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(instancedScaleI, 1, scale);
+	GLfloat shift[2] = {static_cast<float>(offset.X()), static_cast<float>(offset.Y())};
+	glUniform2fv(instancedOffsetI, 1, shift);
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, items.size() * sizeof(Item), items.data(), GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, items.size());
 }
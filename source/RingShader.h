@@ -16,6 +16,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef RING_SHADER_H_
 #define RING_SHADER_H_
 
+#include <vector>
+
 class Color;
 class Point;
 
@@ -24,6 +26,22 @@ class Point;
 // Class representing a shader that draws round "dots," either filled in or with
 // transparent centers (i.e. circles or rings).
 class RingShader {
+public:
+	// One ring to be drawn as part of a batch.
+	class Item {
+	public:
+		float position[2];
+		float radius;
+		float width;
+		// The arc that is drawn and the angle it starts at, in radians, and
+		// the number of radians between the starts of each dash (or 0).
+		float angle;
+		float startAngle;
+		float dash;
+		float color[4];
+	};
+
+
 public:
 	static void Init();
 
@@ -36,6 +54,16 @@ public:
 	static void Add(const Point &pos, float radius, float width, float fraction,
 		const Color &color, float dash = 0.f, float startAngle = 0.f);
 	static void Unbind();
+
+	// Make an item that draws what the Add() functions above would.
+	static Item MakeItem(const Point &pos, float out, float in, const Color &color);
+	static Item MakeItem(const Point &pos, float radius, float width, float fraction,
+		const Color &color, float dash = 0.f, float startAngle = 0.f);
+	// Draw all the given rings, optionally moved by the given offset. If instancing
+	// is available, this takes only a single draw call. This does not need to be
+	// inside a Bind() / Unbind().
+	static void Draw(const std::vector<Item> &items);
+	static void Draw(const std::vector<Item> &items, const Point &offset);
 };
 
 
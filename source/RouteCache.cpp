@@ -0,0 +1,155 @@
+/* RouteCache.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "RouteCache.h"
+
+#include "DistanceMap.h"
+#include "GameData.h"
+#include "Preferences.h"
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+using namespace std;
+
+namespace {
+	// The parameters that a DistanceMap was constructed with.
+	class Key {
+	public:
+		bool operator<(const Key &other) const
+		{
+			return tie(center, wormholeStrategy, useJumpDrive, maxCount, maxDistance, traveler)
+				< tie(other.center, other.wormholeStrategy, other.useJumpDrive, other.maxCount, other.maxDistance,
+					other.traveler);
+		}
+
+		const System *center;
+		WormholeStrategy wormholeStrategy;
+		bool useJumpDrive;
+		int maxCount;
+		int maxDistance;
+		// For a ship's route to the center, what that ship is capable of.
+		DistanceMap::Traveler traveler;
+	};
+
+	class Entry {
+	public:
+		Key key;
+		shared_ptr<const DistanceMap> map;
+		size_t bytes;
+	};
+
+	// A rough estimate of the memory used by each route in a map.
+	const size_t BYTES_PER_ROUTE = 40;
+
+	mutex cacheMutex;
+	// The cached maps, from the most to the least recently used.
+	list<Entry> entries;
+	map<Key, list<Entry>::iterator> byKey;
+	size_t totalBytes = 0;
+	// The state of the universe that the cached maps were calculated for.
+	uint64_t revision = 0;
+
+
+
+	// Get the cached map with the given key, or null if there is none.
+	shared_ptr<const DistanceMap> Lookup(const Key &key)
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		if(revision != GameData::UniverseRevision())
+		{
+			entries.clear();
+			byKey.clear();
+			totalBytes = 0;
+			revision = GameData::UniverseRevision();
+		}
+
+		auto it = byKey.find(key);
+		if(it == byKey.end())
+			return nullptr;
+		entries.splice(entries.begin(), entries, it->second);
+		return it->second->map;
+	}
+
+
+
+	// Add a map that was calculated for the given revision of the universe.
+	void Store(const Key &key, const shared_ptr<const DistanceMap> &map, uint64_t calculatedRevision)
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		// Another thread may have calculated the same map, or the universe may
+		// have changed since this one was calculated.
+		if(revision != calculatedRevision || byKey.count(key))
+			return;
+
+		entries.push_front(Entry{key, map, sizeof(DistanceMap) + map->Size() * BYTES_PER_ROUTE});
+		byKey.emplace(key, entries.begin());
+		totalBytes += entries.front().bytes;
+
+		// Forget the least recently used maps until the cache fits in its budget,
+		// but always keep the one that was just added.
+		const size_t budget = static_cast<size_t>(Preferences::RouteCacheBudget()) << 20;
+		while(totalBytes > budget && entries.size() > 1)
+		{
+			totalBytes -= entries.back().bytes;
+			byKey.erase(entries.back().key);
+			entries.pop_back();
+		}
+	}
+}
+
+
+
+shared_ptr<const DistanceMap> RouteCache::Get(const System *center, WormholeStrategy wormholeStrategy,
+	bool useJumpDrive, int maxCount, int maxDistance)
+{
+	Key key{center, wormholeStrategy, useJumpDrive, maxCount, maxDistance, DistanceMap::Traveler()};
+	shared_ptr<const DistanceMap> map = Lookup(key);
+	if(map)
+		return map;
+
+	// Calculate the map without holding the lock, so that other threads can
+	// use the cache in the meantime.
+	uint64_t calculatedRevision = GameData::UniverseRevision();
+	map = make_shared<DistanceMap>(center, wormholeStrategy, useJumpDrive, maxCount, maxDistance);
+	Store(key, map, calculatedRevision);
+	return map;
+}
+
+
+
+shared_ptr<const DistanceMap> RouteCache::Get(const DistanceMap::Traveler &traveler, const System *destination)
+{
+	Key key{destination, WormholeStrategy::ALL, false, -1, -1, traveler};
+	shared_ptr<const DistanceMap> map = Lookup(key);
+	if(map)
+		return map;
+
+	uint64_t calculatedRevision = GameData::UniverseRevision();
+	map = make_shared<DistanceMap>(traveler, destination);
+	Store(key, map, calculatedRevision);
+	return map;
+}
+
+
+
+shared_ptr<const DistanceMap> RouteCache::Find(const DistanceMap::Traveler &traveler, const System *destination)
+{
+	return Lookup(Key{destination, WormholeStrategy::ALL, false, -1, -1, traveler});
+}
@@ -0,0 +1,50 @@
+/* RouteCache.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef ROUTE_CACHE_H_
+#define ROUTE_CACHE_H_
+
+#include "DistanceMap.h"
+#include "WormholeStrategy.h"
+
+#include <memory>
+
+class System;
+
+
+
+// Class remembering the DistanceMaps that are calculated over and over with
+// the same center system and travel settings, e.g. to check how many jumps
+// separate two systems, or to find the route that ships with the same
+// capabilities take from one system to another. The least recently used maps are forgotten once they
+// take up more memory than Preferences::RouteCacheBudget() allows, and all of
+// them are forgotten when a change to the universe may have moved a link.
+class RouteCache {
+public:
+	// Get the map that DistanceMap(center, wormholeStrategy, useJumpDrive,
+	// maxCount, maxDistance) would construct.
+	static std::shared_ptr<const DistanceMap> Get(const System *center,
+		WormholeStrategy wormholeStrategy = WormholeStrategy::NONE, bool useJumpDrive = false,
+		int maxCount = -1, int maxDistance = -1);
+	// Get the route that DistanceMap(traveler, destination) would construct.
+	static std::shared_ptr<const DistanceMap> Get(const DistanceMap::Traveler &traveler, const System *destination);
+	// Get that route only if it has already been calculated, or null if not.
+	static std::shared_ptr<const DistanceMap> Find(const DistanceMap::Traveler &traveler, const System *destination);
+};
+
+
+
+#endif
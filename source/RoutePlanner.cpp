@@ -0,0 +1,184 @@
+/* RoutePlanner.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "RoutePlanner.h"
+
+#include "DistanceMap.h"
+#include "GameData.h"
+#include "RouteCache.h"
+#include "ThreadPlacement.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+using namespace std;
+
+namespace {
+	// A route that a ship has asked for.
+	class Request {
+	public:
+		bool operator<(const Request &other) const
+		{
+			return tie(destination, traveler) < tie(other.destination, other.traveler);
+		}
+
+		DistanceMap::Traveler traveler;
+		const System *destination;
+	};
+
+	// Finds the routes that have been asked for on a thread of its own.
+	class Planner {
+	public:
+		~Planner();
+
+		shared_ptr<const DistanceMap> Get(const Ship &ship, const System *destination);
+		void Wait();
+
+
+	private:
+		void Run();
+
+
+	private:
+		// Guards everything below, except for the thread itself.
+		mutex plannerMutex;
+		condition_variable condition;
+		// The routes that have been asked for but not started, in the order
+		// they were asked for.
+		deque<Request> queue;
+		// The number of routes being found right now.
+		int busy = 0;
+		bool isDone = false;
+		// Every route asked for since the last Wait(). Those that have been found
+		// have a map.
+		map<Request, shared_ptr<const DistanceMap>> requested;
+		// The routes that were found before the last Wait(). These are kept until
+		// the next one, even if the cache has to forget them, so that every ship
+		// that asked for a route gets it.
+		map<Request, shared_ptr<const DistanceMap>> found;
+		uint64_t foundRevision = 0;
+
+		thread plannerThread;
+	};
+
+	Planner &GetPlanner()
+	{
+		static Planner planner;
+		return planner;
+	}
+
+
+
+	Planner::~Planner()
+	{
+		{
+			lock_guard<mutex> lock(plannerMutex);
+			isDone = true;
+		}
+		condition.notify_all();
+		if(plannerThread.joinable())
+			plannerThread.join();
+	}
+
+
+
+	shared_ptr<const DistanceMap> Planner::Get(const Ship &ship, const System *destination)
+	{
+		Request request{DistanceMap::Traveler(ship), destination};
+		shared_ptr<const DistanceMap> route = RouteCache::Find(request.traveler, destination);
+		if(route)
+			return route;
+
+		lock_guard<mutex> lock(plannerMutex);
+		// Routes found for an older state of the universe are no use.
+		if(foundRevision != GameData::UniverseRevision())
+			found.clear();
+		auto it = found.find(request);
+		if(it != found.end())
+			return it->second;
+
+		// Ask for each route only once, no matter how many ships need it.
+		if(requested.emplace(request, nullptr).second)
+		{
+			queue.push_back(std::move(request));
+			if(!plannerThread.joinable())
+				plannerThread = thread(&Planner::Run, this);
+			condition.notify_all();
+		}
+		return nullptr;
+	}
+
+
+
+	void Planner::Wait()
+	{
+		unique_lock<mutex> lock(plannerMutex);
+		condition.wait(lock, [this]() -> bool { return queue.empty() && !busy; });
+
+		found.swap(requested);
+		requested.clear();
+		foundRevision = GameData::UniverseRevision();
+	}
+
+
+
+	void Planner::Run()
+	{
+		ThreadPlacement::Assign(ThreadPlacement::Role::WORKER);
+
+		unique_lock<mutex> lock(plannerMutex);
+		while(true)
+		{
+			condition.wait(lock, [this]() -> bool { return !queue.empty() || isDone; });
+			if(isDone)
+				return;
+
+			Request request = std::move(queue.front());
+			queue.pop_front();
+			++busy;
+			lock.unlock();
+
+			shared_ptr<const DistanceMap> route = RouteCache::Get(request.traveler, request.destination);
+
+			lock.lock();
+			requested[request] = std::move(route);
+			--busy;
+			condition.notify_all();
+		}
+	}
+}
+
+
+
+// Get the route the given ship should take to the given system, if it has
+// been found. Otherwise, start finding it and return null.
+shared_ptr<const DistanceMap> RoutePlanner::Get(const Ship &ship, const System *destination)
+{
+	return GetPlanner().Get(ship, destination);
+}
+
+
+
+// Wait until every route that has been asked for has been found. This must
+// be done before anything that may change the universe.
+void RoutePlanner::Wait()
+{
+	GetPlanner().Wait();
+}
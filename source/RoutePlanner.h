@@ -0,0 +1,46 @@
+/* RoutePlanner.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROUTE_PLANNER_H_
+#define ROUTE_PLANNER_H_
+
+#include <memory>
+
+class DistanceMap;
+class Ship;
+class System;
+
+
+
+// Class that finds the routes AI ships take to other systems on a thread of
+// its own, so that many ships deciding to travel at once do not hold up the
+// step they do it in. A ship asks for its route and, until it is found, keeps
+// to whatever it was doing before. Every route asked for during a step is
+// found by the end of that step, so a ship always gets its route on the next
+// step, no matter how busy the planning thread was. The routes are kept in
+// the RouteCache, where ships with the same capabilities share them.
+class RoutePlanner {
+public:
+	// Get the route the given ship should take to the given system, if it has
+	// been found. Otherwise, start finding it and return null.
+	static std::shared_ptr<const DistanceMap> Get(const Ship &ship, const System *destination);
+	// Wait until every route that has been asked for has been found. This must
+	// be done before anything that may change the universe.
+	static void Wait();
+};
+
+
+
+#endif
@@ -0,0 +1,187 @@
+/* SaveIndex.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SaveIndex.h"
+
+#include "DataFile.h"
+#include "DataNode.h"
+#include "DataWriter.h"
+#include "Files.h"
+#include "SavedGame.h"
+#include "SaveQueue.h"
+
+#include <cstdint>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+	// Increase this whenever the format of the index changes.
+	const int VERSION = 1;
+
+	class Entry {
+	public:
+		int64_t size = 0;
+		time_t timestamp = 0;
+		SavedGame game;
+	};
+
+	mutex indexMutex;
+	bool isLoaded = false;
+	// The entries, by file name.
+	map<string, Entry> entries;
+
+	string IndexPath()
+	{
+		return Files::Saves() + "index.dat";
+	}
+
+
+
+	bool IsSavedGame(const string &path)
+	{
+		const string &saves = Files::Saves();
+		return path.length() > saves.length() + 4 && !path.compare(0, saves.length(), saves)
+			&& !path.compare(path.length() - 4, 4, ".txt") && path.find('/', saves.length()) == string::npos;
+	}
+}
+
+
+
+bool SaveIndex::Get(const string &path, SavedGame &game)
+{
+	if(!IsSavedGame(path))
+		return false;
+
+	lock_guard<mutex> lock(indexMutex);
+	Load();
+	auto it = entries.find(Files::Name(path));
+	if(it == entries.end() || it->second.size != Files::Size(path) || it->second.timestamp != Files::Timestamp(path))
+		return false;
+
+	game = it->second.game;
+	game.path = path;
+	return true;
+}
+
+
+
+void SaveIndex::Set(const string &path, const SavedGame &game)
+{
+	if(!IsSavedGame(path))
+		return;
+
+	lock_guard<mutex> lock(indexMutex);
+	Load();
+	Entry &entry = entries[Files::Name(path)];
+	entry.size = Files::Size(path);
+	entry.timestamp = Files::Timestamp(path);
+	entry.game = game;
+	entry.game.shipSprite = nullptr;
+	Save();
+}
+
+
+
+void SaveIndex::Update(const string &path, const string &data)
+{
+	if(!IsSavedGame(path))
+		return;
+
+	istringstream in(data);
+	SavedGame game;
+	game.LoadData(DataFile(in));
+	Set(path, game);
+}
+
+
+
+void SaveIndex::Load()
+{
+	if(isLoaded)
+		return;
+	isLoaded = true;
+
+	const string path = IndexPath();
+	if(!Files::Exists(path))
+		return;
+	DataFile file(path);
+	if(file.begin() == file.end() || file.begin()->Token(0) != "version" || file.begin()->Size() < 2
+			|| file.begin()->Value(1) != VERSION)
+		return;
+
+	for(const DataNode &node : file)
+	{
+		// Skip any saves that have since been deleted.
+		if(node.Token(0) != "save" || node.Size() < 4 || !Files::Exists(Files::Saves() + node.Token(1)))
+			continue;
+
+		Entry &entry = entries[node.Token(1)];
+		entry.size = node.Value(2);
+		entry.timestamp = node.Value(3);
+		SavedGame &game = entry.game;
+		for(const DataNode &child : node)
+		{
+			const string &key = child.Token(0);
+			if(child.Size() < 2)
+				continue;
+			if(key == "pilot")
+				game.name = child.Token(1);
+			else if(key == "credits")
+				game.credits = child.Token(1);
+			else if(key == "date")
+				game.date = child.Token(1);
+			else if(key == "system")
+				game.system = child.Token(1);
+			else if(key == "planet")
+				game.planet = child.Token(1);
+			else if(key == "playtime")
+				game.playTime = child.Token(1);
+			else if(key == "ship" && child.Size() >= 3)
+			{
+				game.shipName = child.Token(1);
+				game.shipSpriteName = child.Token(2);
+			}
+		}
+	}
+}
+
+
+
+void SaveIndex::Save()
+{
+	DataWriter out;
+	out.Write("version", VERSION);
+	for(const auto &it : entries)
+	{
+		const SavedGame &game = it.second.game;
+		out.Write("save", it.first, it.second.size, static_cast<int64_t>(it.second.timestamp));
+		out.BeginChild();
+		{
+			out.Write("pilot", game.name);
+			out.Write("credits", game.credits);
+			out.Write("date", game.date);
+			out.Write("system", game.system);
+			out.Write("planet", game.planet);
+			out.Write("playtime", game.playTime);
+			out.Write("ship", game.shipName, game.shipSpriteName);
+		}
+		out.EndChild();
+	}
+	SaveQueue::Write(IndexPath(), out.Contents());
+}
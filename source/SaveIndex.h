@@ -0,0 +1,50 @@
+/* SaveIndex.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SAVE_INDEX_H_
+#define SAVE_INDEX_H_
+
+#include <string>
+
+class SavedGame;
+
+
+
+// The "Load Game" panel shows a few details about each saved game, but reading
+// them means parsing the whole file, which may be several megabytes. So they
+// are kept in an index file in the saves folder instead, which is updated every
+// time a game is saved. Each entry remembers the size and modification time of
+// its file, and is ignored if the file has been changed since then.
+class SaveIndex {
+public:
+	// If the index has up to date details of the given saved game, fill them in.
+	static bool Get(const std::string &path, SavedGame &game);
+	// Remember the details of the given saved game, which were read from the file.
+	static void Set(const std::string &path, const SavedGame &game);
+	// Update the details of a file that was just written with the given contents.
+	// Files outside the saves folder are ignored.
+	static void Update(const std::string &path, const std::string &data);
+
+
+private:
+	// Read the index file, if that has not been done yet.
+	static void Load();
+	// Queue the index file to be written.
+	static void Save();
+};
+
+
+
+#endif
@@ -0,0 +1,183 @@
+/* SaveQueue.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SaveQueue.h"
+
+#include "Compression.h"
+#include "File.h"
+#include "Files.h"
+#include "SaveIndex.h"
+
+#include <SDL2/SDL_rwops.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+namespace {
+	// Write each file in pieces of at most this size.
+	const size_t CHUNK_SIZE = 1 << 16;
+
+	// A file waiting to be written.
+	class Job {
+	public:
+		Job(const string &path, string &&data, bool compress);
+
+		string path;
+		string data;
+		bool compress;
+	};
+
+	// The background thread, which is started the first time a file is saved.
+	class Worker {
+	public:
+		~Worker();
+
+		void Add(const string &path, string &&data, bool compress);
+		void Wait();
+
+
+	private:
+		void Run();
+
+
+	private:
+		mutex queueMutex;
+		condition_variable addCondition;
+		condition_variable doneCondition;
+		deque<Job> queue;
+		// Whether the first file in the queue is still being written.
+		bool isWriting = false;
+		bool terminate = false;
+		thread worker;
+	};
+
+	Worker worker;
+
+
+
+	Job::Job(const string &path, string &&data, bool compress)
+		: path(path), data(std::move(data)), compress(compress)
+	{
+	}
+
+
+
+	Worker::~Worker()
+	{
+		{
+			lock_guard<mutex> lock(queueMutex);
+			terminate = true;
+		}
+		addCondition.notify_all();
+		if(worker.joinable())
+			worker.join();
+	}
+
+
+
+	void Worker::Add(const string &path, string &&data, bool compress)
+	{
+		{
+			lock_guard<mutex> lock(queueMutex);
+			if(!worker.joinable())
+				worker = thread(&Worker::Run, this);
+			// If this file is already waiting to be written, only the newest
+			// contents need to be. They take the place of the older ones at the
+			// back of the queue, so no file is written before one queued earlier.
+			auto it = find_if(queue.begin(), queue.end(),
+				[&path](const Job &job) -> bool { return job.path == path; });
+			if(it != queue.end())
+				queue.erase(it);
+			queue.emplace_back(path, std::move(data), compress);
+		}
+		addCondition.notify_one();
+	}
+
+
+
+	void Worker::Wait()
+	{
+		unique_lock<mutex> lock(queueMutex);
+		while(!queue.empty() || isWriting)
+			doneCondition.wait(lock);
+	}
+
+
+
+	void Worker::Run()
+	{
+		unique_lock<mutex> lock(queueMutex);
+		while(true)
+		{
+			// Any files still queued are written before the thread quits.
+			while(queue.empty() && !terminate)
+				addCondition.wait(lock);
+			if(queue.empty())
+				return;
+
+			Job file = std::move(queue.front());
+			queue.pop_front();
+			isWriting = true;
+			lock.unlock();
+
+			// Write to a temporary file first, so that if the game is killed
+			// partway through, the previous version of the file is kept.
+			const string &path = file.path;
+			string compressed;
+			if(file.compress)
+				compressed = Compression::Compress(file.data);
+			const string &data = file.compress ? compressed : file.data;
+			bool isWritten = false;
+			{
+				File out(path + ".tmp", true);
+				isWritten = out;
+				for(size_t pos = 0; isWritten && pos < data.size(); pos += CHUNK_SIZE)
+				{
+					size_t size = min(CHUNK_SIZE, data.size() - pos);
+					isWritten = (SDL_RWwrite(out, data.data() + pos, 1, size) == size);
+				}
+			}
+			if(isWritten)
+			{
+				Files::Move(path + ".tmp", path);
+				SaveIndex::Update(path, file.data);
+			}
+
+			lock.lock();
+			isWriting = false;
+			doneCondition.notify_all();
+		}
+	}
+}
+
+
+
+void SaveQueue::Write(const string &path, string &&data, bool compress)
+{
+	worker.Add(path, std::move(data), compress);
+}
+
+
+
+void SaveQueue::Wait()
+{
+	worker.Wait();
+}
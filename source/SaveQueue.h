@@ -0,0 +1,44 @@
+/* SaveQueue.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SAVE_QUEUE_H_
+#define SAVE_QUEUE_H_
+
+#include <string>
+
+
+
+// Writing out a saved game can take long enough to cause a visible hitch, so
+// the game writes save files from a background thread instead. The same goes
+// for smaller files like the preferences, since even a small write can take a
+// while on some phones' storage. The contents of each file are composed on the
+// calling thread, so the background thread never touches any game state. Files
+// are written in the order they were queued, and anything that reads or moves
+// a saved game should wait for the queue to be empty first. If a file is queued
+// again before it has been written, only the newest contents are written. Each
+// file is written under a temporary name and then renamed, so an interrupted
+// save never replaces the previous one. Files can also be compressed before
+// they are written, which is done on the background thread as well.
+class SaveQueue {
+public:
+	// Queue the given contents to be written to the given file.
+	static void Write(const std::string &path, std::string &&data, bool compress = false);
+	// Wait until every file queued so far has been written.
+	static void Wait();
+};
+
+
+
+#endif
@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "Date.h"
 #include "text/Format.h"
+#include "SaveIndex.h"
 #include "SpriteSet.h"
 
 using namespace std;
@@ -35,47 +36,20 @@ SavedGame::SavedGame(const string &path)
 void SavedGame::Load(const string &path)
 {
 	Clear();
-	DataFile file(path);
-	if(file.begin() != file.end())
-		this->path = path;
-
-	int flagshipIterator = -1;
-	int flagshipTarget = 0;
-
-	for(const DataNode &node : file)
+	// Reading a whole saved game just for these details is slow, so they are
+	// usually already known from the index.
+	if(!SaveIndex::Get(path, *this))
 	{
-		if(node.Token(0) == "pilot" && node.Size() >= 3)
-			name = node.Token(1) + " " + node.Token(2);
-		else if(node.Token(0) == "date" && node.Size() >= 4)
-			date = Date(node.Value(1), node.Value(2), node.Value(3)).ToString();
-		else if(node.Token(0) == "system" && node.Size() >= 2)
-			system = node.Token(1);
-		else if(node.Token(0) == "planet" && node.Size() >= 2)
-			planet = node.Token(1);
-		else if(node.Token(0) == "playtime" && node.Size() >= 2)
-			playTime = Format::PlayTime(node.Value(1));
-		else if(node.Token(0) == "flagship index" && node.Size() >= 2)
-			flagshipTarget = node.Value(1);
-		else if(node.Token(0) == "account")
+		DataFile file(path);
+		if(file.begin() != file.end())
 		{
-			for(const DataNode &child : node)
-				if(child.Token(0) == "credits" && child.Size() >= 2)
-				{
-					credits = Format::Credits(child.Value(1));
-					break;
-				}
-		}
-		else if(node.Token(0) == "ship" && ++flagshipIterator == flagshipTarget)
-		{
-			for(const DataNode &child : node)
-			{
-				if(child.Token(0) == "name" && child.Size() >= 2)
-					shipName = child.Token(1);
-				else if(child.Token(0) == "sprite" && child.Size() >= 2)
-					shipSprite = SpriteSet::Get(child.Token(1));
-			}
+			LoadData(file);
+			this->path = path;
+			SaveIndex::Set(path, *this);
 		}
 	}
+	if(!shipSpriteName.empty())
+		shipSprite = SpriteSet::Get(shipSpriteName);
 }
 
 
@@ -107,6 +81,7 @@ void SavedGame::Clear()
 	playTime = "0s";
 
 	shipSprite = nullptr;
+	shipSpriteName.clear();
 	shipName.clear();
 }
 
@@ -165,3 +140,46 @@ const string &SavedGame::ShipName() const
 {
 	return shipName;
 }
+
+
+
+void SavedGame::LoadData(const DataFile &file)
+{
+	int flagshipIterator = -1;
+	int flagshipTarget = 0;
+
+	for(const DataNode &node : file)
+	{
+		if(node.Token(0) == "pilot" && node.Size() >= 3)
+			name = node.Token(1) + " " + node.Token(2);
+		else if(node.Token(0) == "date" && node.Size() >= 4)
+			date = Date(node.Value(1), node.Value(2), node.Value(3)).ToString();
+		else if(node.Token(0) == "system" && node.Size() >= 2)
+			system = node.Token(1);
+		else if(node.Token(0) == "planet" && node.Size() >= 2)
+			planet = node.Token(1);
+		else if(node.Token(0) == "playtime" && node.Size() >= 2)
+			playTime = Format::PlayTime(node.Value(1));
+		else if(node.Token(0) == "flagship index" && node.Size() >= 2)
+			flagshipTarget = node.Value(1);
+		else if(node.Token(0) == "account")
+		{
+			for(const DataNode &child : node)
+				if(child.Token(0) == "credits" && child.Size() >= 2)
+				{
+					credits = Format::Credits(child.Value(1));
+					break;
+				}
+		}
+		else if(node.Token(0) == "ship" && ++flagshipIterator == flagshipTarget)
+		{
+			for(const DataNode &child : node)
+			{
+				if(child.Token(0) == "name" && child.Size() >= 2)
+					shipName = child.Token(1);
+				else if(child.Token(0) == "sprite" && child.Size() >= 2)
+					shipSpriteName = child.Token(1);
+			}
+		}
+	}
+}
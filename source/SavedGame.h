@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <string>
 
+class DataFile;
 class Sprite;
 
 
@@ -49,6 +50,11 @@ public:
 	const std::string &ShipName() const;
 
 
+private:
+	// Read the details from the given file, without looking up the ship sprite.
+	void LoadData(const DataFile &file);
+
+
 private:
 	std::string path;
 
@@ -61,7 +67,11 @@ private:
 	std::string playTime;
 
 	const Sprite *shipSprite = nullptr;
+	std::string shipSpriteName;
 	std::string shipName;
+
+	// The index of saved games stores these details directly.
+	friend class SaveIndex;
 };
 
 
@@ -16,51 +16,283 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef SET_H_
 #define SET_H_
 
+#include "DataNode.h"
+#include "MemoryStats.h"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 
 
 // Template representing a set of named objects of a given type, where you can
 // query it for a pointer to any object and it will return one, whether or not that
-// object has been loaded yet. (This allows cyclic pointers.)
+// object has been loaded yet. (This allows cyclic pointers.) The objects are
+// kept in a map, so they stay sorted by name and never move, but looking them up
+// by name goes through a hash table of pointers into that map. A set can also
+// be made lazy, so that it keeps the data file definitions of each object and
+// only loads them when that object is first used. A set remembers which objects
+// were handed out for modification, so that reverting it only copies those.
 template<class Type>
 class Set {
 public:
+	Set() = default;
+	// Copying a set requires building a new index for the copied objects. Any
+	// objects that have not been loaded yet are loaded first.
+	Set(const Set &other);
+	Set &operator=(const Set &other);
+	Set(Set &&other) = default;
+	Set &operator=(Set &&other);
+	~Set() { Account(-static_cast<int64_t>(data.size())); }
+
+	// Get the hash of the given name. Code that looks up the same name often can
+	// compute this once and use the versions of the functions below that take it.
+	static size_t Hash(const std::string &name) { return std::hash<std::string>()(name); }
+
 	// Allow non-const access to the owner of this set; it can hand off only
-	// const references to avoid anyone else modifying the objects.
-	Type *Get(const std::string &name) { return &data[name]; }
-	const Type *Get(const std::string &name) const { return &data[name]; }
+	// const references to avoid anyone else modifying the objects. Any object
+	// returned by the non-const functions is assumed to be modified.
+	Type *Get(const std::string &name) { return Get(name, Hash(name)); }
+	Type *Get(const std::string &name, size_t hash);
+	const Type *Get(const std::string &name) const { return Get(name, Hash(name)); }
+	const Type *Get(const std::string &name, size_t hash) const;
 	// If an item already exists in this set, get it. Otherwise, return a null
 	// pointer rather than creating the item.
-	const Type *Find(const std::string &name) const;
+	const Type *Find(const std::string &name) const { return Find(name, Hash(name)); }
+	const Type *Find(const std::string &name, size_t hash) const;
+
+	bool Has(const std::string &name) const { return Find(name); }
 
-	bool Has(const std::string &name) const { return data.count(name); }
+	// Set the function that loads one definition of an object. If the set is
+	// lazy, the definitions given to Load() are kept until each object is used.
+	void SetLoader(std::function<void(Type &, const DataNode &)> loader, bool isLazy);
+	// Load a definition of the named object, now or when it is first used.
+	void Load(const std::string &name, const DataNode &node);
+	// Load every object that is still waiting to be loaded.
+	void LoadAll() const;
 
-	typename std::map<std::string, Type>::iterator begin() { return data.begin(); }
-	typename std::map<std::string, Type>::const_iterator begin() const { return data.begin(); }
-	typename std::map<std::string, Type>::const_iterator find(const std::string &key) const { return data.find(key); }
+	// Iterating over the set loads all the objects in it.
+	typename std::map<std::string, Type>::iterator begin() { LoadAll(); allChanged = true; return data.begin(); }
+	typename std::map<std::string, Type>::const_iterator begin() const { LoadAll(); return data.begin(); }
+	typename std::map<std::string, Type>::const_iterator find(const std::string &key) const;
 	typename std::map<std::string, Type>::iterator end() { return data.end(); }
 	typename std::map<std::string, Type>::const_iterator end() const { return data.end(); }
 
 	int size() const { return data.size(); }
 	bool empty() const { return data.empty(); }
 	// Remove any objects in this set that are not in the given set, and for
-	// those that are in the given set, revert to their contents.
+	// those that are in the given set, revert to their contents. Only the objects
+	// that may have been modified since the last revert need to be copied.
 	void Revert(const Set<Type> &other);
 
 
+private:
+	// One entry in the hash table. Empty slots have no entry.
+	class Slot {
+	public:
+		size_t hash = 0;
+		std::pair<const std::string, Type> *entry = nullptr;
+	};
+
+
+	// The definitions of a lazy set that have not been loaded yet.
+	class Pending {
+	public:
+		std::function<void(Type &, const DataNode &)> loader;
+		bool isLazy = false;
+		// Whichever thread uses an object first loads it, so the definitions
+		// are guarded by a mutex. Loading one object may also use others.
+		std::recursive_mutex mutex;
+		std::map<std::string, std::vector<DataNode>> definitions;
+		// The number of objects with definitions, so that the mutex is only
+		// needed while some objects are not loaded yet.
+		std::atomic<size_t> count;
+	};
+
+
+private:
+	// If the given object has any definitions that are not loaded, load them.
+	void LoadPending(std::pair<const std::string, Type> &entry) const;
+	// Find the object with the given name and hash, or return null if there
+	// is no such object.
+	std::pair<const std::string, Type> *Lookup(const std::string &name, size_t hash) const;
+	// Add a new, default object with the given name.
+	std::pair<const std::string, Type> &Insert(const std::string &name, size_t hash) const;
+	// Add an object that was just inserted into the map to the index.
+	void Index(std::pair<const std::string, Type> &entry, size_t hash) const;
+	// Build the index from scratch, with space for all the current objects.
+	void Reindex() const;
+	// Record that the given number of objects were added to or removed from a
+	// set. Only the map entries and index slots are counted, not any memory the
+	// objects themselves point to.
+	static void Account(int64_t objects);
+
+
 private:
 	mutable std::map<std::string, Type> data;
+	// An open addressing hash table, with linear probing, whose size is always
+	// zero or a power of two and is kept over twice the number of objects.
+	mutable std::vector<Slot> index;
+	// This is only allocated once a loader has been given.
+	std::unique_ptr<Pending> pending;
+	// The objects that were handed out for modification since the last revert.
+	// Every object counts as modified until the first revert, or after the set
+	// has been iterated over with non-const access.
+	std::unordered_set<const Type *> changed;
+	bool allChanged = true;
 };
 
 
 
 template <class Type>
-const Type *Set<Type>::Find(const std::string &name) const
+Set<Type>::Set(const Set &other)
+{
+	other.LoadAll();
+	data = other.data;
+	Account(data.size());
+	Reindex();
+}
+
+
+
+template <class Type>
+Set<Type> &Set<Type>::operator=(const Set &other)
+{
+	other.LoadAll();
+	LoadAll();
+	int64_t before = data.size();
+	data = other.data;
+	Account(data.size() - before);
+	Reindex();
+	changed.clear();
+	allChanged = true;
+	return *this;
+}
+
+
+
+template <class Type>
+Set<Type> &Set<Type>::operator=(Set &&other)
+{
+	// The objects this set held before are freed, and the other set's are
+	// already counted.
+	Account(-static_cast<int64_t>(data.size()));
+	data = std::move(other.data);
+	other.data.clear();
+	index = std::move(other.index);
+	pending = std::move(other.pending);
+	changed = std::move(other.changed);
+	allChanged = other.allChanged;
+	return *this;
+}
+
+
+
+template <class Type>
+Type *Set<Type>::Get(const std::string &name, size_t hash)
+{
+	Type *result = const_cast<Type *>(static_cast<const Set<Type> &>(*this).Get(name, hash));
+	if(!allChanged)
+		changed.insert(result);
+	return result;
+}
+
+
+
+template <class Type>
+const Type *Set<Type>::Get(const std::string &name, size_t hash) const
+{
+	std::pair<const std::string, Type> *entry = Lookup(name, hash);
+	if(!entry)
+		return &Insert(name, hash).second;
+	LoadPending(*entry);
+	return &entry->second;
+}
+
+
+
+template <class Type>
+const Type *Set<Type>::Find(const std::string &name, size_t hash) const
+{
+	std::pair<const std::string, Type> *entry = Lookup(name, hash);
+	if(!entry)
+		return nullptr;
+	LoadPending(*entry);
+	return &entry->second;
+}
+
+
+
+template <class Type>
+void Set<Type>::SetLoader(std::function<void(Type &, const DataNode &)> loader, bool isLazy)
+{
+	LoadAll();
+	if(!pending)
+	{
+		pending.reset(new Pending);
+		pending->count = 0;
+	}
+	pending->loader = std::move(loader);
+	pending->isLazy = isLazy;
+}
+
+
+
+template <class Type>
+void Set<Type>::Load(const std::string &name, const DataNode &node)
+{
+	if(!pending->isLazy)
+	{
+		pending->loader(*Get(name), node);
+		return;
+	}
+
+	// Make sure the object exists, so that it can be found without loading it.
+	size_t hash = Hash(name);
+	if(!Lookup(name, hash))
+		Insert(name, hash);
+
+	std::lock_guard<std::recursive_mutex> lock(pending->mutex);
+	std::vector<DataNode> &definitions = pending->definitions[name];
+	if(definitions.empty())
+		++pending->count;
+	definitions.push_back(node);
+}
+
+
+
+template <class Type>
+void Set<Type>::LoadAll() const
+{
+	if(!pending || !pending->count.load(std::memory_order_acquire))
+		return;
+
+	std::lock_guard<std::recursive_mutex> lock(pending->mutex);
+	while(!pending->definitions.empty())
+	{
+		std::pair<const std::string, Type> *entry = Lookup(pending->definitions.begin()->first,
+			Hash(pending->definitions.begin()->first));
+		LoadPending(*entry);
+	}
+}
+
+
+
+template <class Type>
+typename std::map<std::string, Type>::const_iterator Set<Type>::find(const std::string &key) const
 {
-	auto it = data.find(name);
-	return (it == data.end() ? nullptr : &it->second);
+	auto it = data.find(key);
+	if(it != data.end())
+		LoadPending(*it);
+	return it;
 }
 
 
@@ -68,6 +300,9 @@ const Type *Set<Type>::Find(const std::string &name) const
 template <class Type>
 void Set<Type>::Revert(const Set<Type> &other)
 {
+	LoadAll();
+	other.LoadAll();
+	int64_t before = data.size();
 	auto it = data.begin();
 	auto oit = other.data.begin();
 
@@ -78,8 +313,9 @@ void Set<Type>::Revert(const Set<Type> &other)
 		else if(it->first == oit->first)
 		{
 			// If this is an entry that is in the set we are reverting to, copy
-			// the state we are reverting to.
-			it->second = oit->second;
+			// the state we are reverting to, unless it cannot have changed.
+			if(allChanged || changed.count(&it->second))
+				it->second = oit->second;
 			++it;
 			++oit;
 		}
@@ -87,6 +323,116 @@ void Set<Type>::Revert(const Set<Type> &other)
 		// There should never be a case when an entry in the set we are
 		// reverting to has a name that is not also in this set.
 	}
+	Account(data.size() - before);
+	// Removing items from an open addressing table would need tombstones, and
+	// reverting is rare, so the index is just built again.
+	Reindex();
+	changed.clear();
+	allChanged = false;
+}
+
+
+
+template <class Type>
+void Set<Type>::LoadPending(std::pair<const std::string, Type> &entry) const
+{
+	if(!pending || !pending->count.load(std::memory_order_acquire))
+		return;
+
+	// The definitions are removed before they are loaded, in case loading them
+	// refers back to this same object. The count is only reduced afterwards,
+	// so no other thread can use the object while it is still being loaded.
+	std::lock_guard<std::recursive_mutex> lock(pending->mutex);
+	auto it = pending->definitions.find(entry.first);
+	if(it == pending->definitions.end())
+		return;
+	std::vector<DataNode> definitions;
+	definitions.swap(it->second);
+	pending->definitions.erase(it);
+
+	for(const DataNode &node : definitions)
+		pending->loader(entry.second, node);
+	--pending->count;
+}
+
+
+
+template <class Type>
+std::pair<const std::string, Type> *Set<Type>::Lookup(const std::string &name, size_t hash) const
+{
+	if(index.empty())
+		return nullptr;
+
+	const size_t mask = index.size() - 1;
+	for(size_t i = hash & mask; index[i].entry; i = (i + 1) & mask)
+		if(index[i].hash == hash && index[i].entry->first == name)
+			return index[i].entry;
+	return nullptr;
+}
+
+
+
+template <class Type>
+std::pair<const std::string, Type> &Set<Type>::Insert(const std::string &name, size_t hash) const
+{
+	auto result = data.emplace(std::piecewise_construct, std::forward_as_tuple(name), std::forward_as_tuple());
+	auto &entry = *result.first;
+	Account(result.second);
+	Index(entry, hash);
+	return entry;
+}
+
+
+
+template <class Type>
+void Set<Type>::Index(std::pair<const std::string, Type> &entry, size_t hash) const
+{
+	// The map already holds the new entry, so this also covers reindexing it.
+	if(index.size() < 2 * data.size())
+	{
+		Reindex();
+		return;
+	}
+
+	const size_t mask = index.size() - 1;
+	size_t i = hash & mask;
+	while(index[i].entry)
+		i = (i + 1) & mask;
+	index[i].hash = hash;
+	index[i].entry = &entry;
+}
+
+
+
+template <class Type>
+void Set<Type>::Reindex() const
+{
+	size_t size = 16;
+	while(size < 2 * data.size())
+		size *= 2;
+	index.assign(data.empty() ? 0 : size, Slot());
+
+	const size_t mask = size - 1;
+	for(auto &it : data)
+	{
+		size_t hash = Hash(it.first);
+		size_t i = hash & mask;
+		while(index[i].entry)
+			i = (i + 1) & mask;
+		index[i].hash = hash;
+		index[i].entry = &it;
+	}
+}
+
+
+
+template <class Type>
+void Set<Type>::Account(int64_t objects)
+{
+	// Each object is one node of the map, and the index has about two slots
+	// for it.
+	const int64_t BYTES = sizeof(std::pair<const std::string, Type>) + 4 * sizeof(void *) + 2 * sizeof(Slot);
+	MemoryStats::Add(MemoryStats::Category::OBJECT_SETS, objects * BYTES);
 }
 
 
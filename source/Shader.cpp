@@ -16,7 +16,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Shader.h"
 
 #include "Logger.h"
+#include "ShaderCache.h"
 
+#include <algorithm>
 #include <cctype>
 #include <cstring>
 #include <stdexcept>
@@ -25,17 +27,72 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
+namespace {
+	ShaderCache *cache = nullptr;
+	// Every program that has been made, so that they can all be warmed up.
+	vector<GLuint> programs;
+
+	// Get the "#version" line that must begin each shader's source.
+	const string &Version()
+	{
+		static string version;
+		if(version.empty())
+		{
+			version = "#version ";
+			string glsl = reinterpret_cast<const char *>(glGetString(GL_SHADING_LANGUAGE_VERSION));
+			bool found = false;
+			for(char c : glsl)
+			{
+				if(!found && !isdigit(c))
+				{
+					continue;
+				}
+				if(isspace(c))
+					break;
+				if(isdigit(c))
+				{
+					found = true;
+					version += c;
+				}
+			}
+			if(glsl.find("GLSL ES") != std::string::npos)
+			{
+				version += " es";
+			}
+			version += '\n';
+		}
+		return version;
+	}
+}
+
 
 
 Shader::Shader(const char *vertex, const char *fragment)
 {
-	GLuint vertexShader = Compile(vertex, GL_VERTEX_SHADER);
-	GLuint fragmentShader = Compile(fragment, GL_FRAGMENT_SHADER);
+	string vertexText = Version() + vertex;
+	string fragmentText = Version() + fragment;
 
 	program = glCreateProgram();
 	if(!program)
 		throw runtime_error("Creating OpenGL shader program failed.");
 
+	// A cached program is identified by all of its source code.
+	string source;
+	if(cache)
+	{
+		source = vertexText + '\0' + fragmentText;
+		if(LoadBinary(source))
+		{
+			FindLocations();
+			programs.push_back(program);
+			return;
+		}
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
+	GLuint vertexShader = Compile(vertexText, GL_VERTEX_SHADER);
+	GLuint fragmentShader = Compile(fragmentText, GL_FRAGMENT_SHADER);
+
 	glAttachShader(program, vertexShader);
 	glAttachShader(program, fragmentShader);
 
@@ -57,6 +114,11 @@ Shader::Shader(const char *vertex, const char *fragment)
 
 		throw runtime_error("Linking OpenGL shader program failed.");
 	}
+
+	if(cache)
+		SaveBinary(source);
+	FindLocations();
+	programs.push_back(program);
 }
 
 
@@ -70,65 +132,66 @@ GLuint Shader::Object() const noexcept
 
 GLint Shader::Attrib(const char *name) const
 {
-	GLint attrib = glGetAttribLocation(program, name);
-	if(attrib == -1)
+	auto it = attribs.find(name);
+	if(it == attribs.end())
 		throw runtime_error("Attribute \"" + string(name) + "\" not found.");
 
-	return attrib;
+	return it->second;
 }
 
 
 
 GLint Shader::Uniform(const char *name) const
 {
-	GLint uniform = glGetUniformLocation(program, name);
-	if(uniform == -1)
+	auto it = uniforms.find(name);
+	if(it == uniforms.end())
 		throw runtime_error("Uniform \"" + string(name) + "\" not found.");
 
-	return uniform;
+	return it->second;
 }
 
 
 
-GLuint Shader::Compile(const char *str, GLenum type)
+void Shader::SetCache(ShaderCache *shaderCache)
 {
-	GLuint object = glCreateShader(type);
-	if(!object)
-		throw runtime_error("Shader creation failed.");
+	cache = shaderCache;
+}
+
+
 
-	static string version;
-	if(version.empty())
+// Draw once with every program made so far, without changing any pixels.
+// Some drivers put off finishing a program until it is first used, which
+// would otherwise happen in the middle of the game.
+void Shader::WarmUp()
+{
+	// With no attributes enabled, every vertex gets the same default values,
+	// and the scissor box leaves nothing to draw, so no program needs any of
+	// its inputs set. The driver must still get each program ready to run.
+	GLuint vao = 0;
+	glGenVertexArrays(1, &vao);
+	OpenGL::BindVertexArray(vao);
+	glEnable(GL_SCISSOR_TEST);
+	glScissor(0, 0, 0, 0);
+	for(GLuint program : programs)
 	{
-		version = "#version ";
-		string glsl = reinterpret_cast<const char *>(glGetString(GL_SHADING_LANGUAGE_VERSION));
-		bool found = false;
-		for(char c : glsl)
-		{
-			if(!found && !isdigit(c))
-			{
-				continue;
-			}
-			if(isspace(c))
-				break;
-			if(isdigit(c))
-			{
-				found = true;
-				version += c;
-			}
-		}
-		if(glsl.find("GLSL ES") != std::string::npos)
-		{
-			version += " es";
-		}
-		version += '\n';
+		OpenGL::UseProgram(program);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
 	}
-	size_t length = strlen(str);
-	vector<GLchar> text(version.length() + length + 1);
-	memcpy(&text.front(), version.data(), version.length());
-	memcpy(&text.front() + version.length(), str, length);
-	text[version.length() + length] = '\0';
+	glDisable(GL_SCISSOR_TEST);
+	OpenGL::UseProgram(0);
+	OpenGL::BindVertexArray(0);
+	glDeleteVertexArrays(1, &vao);
+}
+
+
+
+GLuint Shader::Compile(const string &text, GLenum type)
+{
+	GLuint object = glCreateShader(type);
+	if(!object)
+		throw runtime_error("Shader creation failed.");
 
-	const GLchar *cText = &text.front();
+	const GLchar *cText = text.c_str();
 	glShaderSource(object, 1, &cText, nullptr);
 	glCompileShader(object);
 
@@ -136,8 +199,7 @@ GLuint Shader::Compile(const char *str, GLenum type)
 	glGetShaderiv(object, GL_COMPILE_STATUS, &status);
 	if(status == GL_FALSE)
 	{
-		string error = version;
-		error += string(str, length);
+		string error = text;
 
 		static const int SIZE = 4096;
 		GLchar message[SIZE];
@@ -151,3 +213,74 @@ GLuint Shader::Compile(const char *str, GLenum type)
 
 	return object;
 }
+
+
+
+// Load this program from the cache. If the driver rejects the binary, the
+// program must be compiled from source instead.
+bool Shader::LoadBinary(const string &source)
+{
+	uint32_t format = 0;
+	string binary;
+	if(!cache->Get(source, format, binary) || binary.empty())
+		return false;
+
+	glProgramBinary(program, format, binary.data(), binary.size());
+	GLint status = GL_FALSE;
+	glGetProgramiv(program, GL_LINK_STATUS, &status);
+	return status == GL_TRUE;
+}
+
+
+
+void Shader::SaveBinary(const string &source)
+{
+	GLint length = 0;
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if(length <= 0)
+		return;
+
+	string binary(length, '\0');
+	GLenum format = 0;
+	glGetProgramBinary(program, length, &length, &format, &binary[0]);
+	binary.resize(length);
+	cache->Set(source, format, std::move(binary));
+}
+
+
+
+void Shader::FindLocations()
+{
+	GLint length = 0;
+	GLint count = 0;
+	glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &length);
+	glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+	vector<GLchar> name(max(length, 1));
+	for(GLint i = 0; i < count; ++i)
+	{
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveAttrib(program, i, name.size(), nullptr, &size, &type, name.data());
+		GLint location = glGetAttribLocation(program, name.data());
+		if(location != -1)
+			attribs[name.data()] = location;
+	}
+
+	glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &length);
+	glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+	name.resize(max(length, 1));
+	for(GLint i = 0; i < count; ++i)
+	{
+		GLint size = 0;
+		GLenum type = 0;
+		glGetActiveUniform(program, i, name.size(), nullptr, &size, &type, name.data());
+		GLint location = glGetUniformLocation(program, name.data());
+		if(location == -1)
+			continue;
+		// Arrays are listed by their first element, but are looked up by name.
+		string key = name.data();
+		if(key.size() > 3 && !key.compare(key.size() - 3, 3, "[0]"))
+			key.resize(key.size() - 3);
+		uniforms[key] = location;
+	}
+}
@@ -18,6 +18,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "opengl.h"
 
+#include <map>
+#include <string>
+
+class ShaderCache;
+
 
 
 // Class representing a shader, i.e. a compiled GLSL program that the GPU uses
@@ -33,13 +38,29 @@ public:
 	GLint Attrib(const char *name) const;
 	GLint Uniform(const char *name) const;
 
+	// While a cache is set, programs are loaded from it if possible, and any
+	// that must be compiled are added to it.
+	static void SetCache(ShaderCache *cache);
+	// Draw once with every program made so far, without changing any pixels.
+	// Some drivers put off finishing a program until it is first used, which
+	// would otherwise happen in the middle of the game.
+	static void WarmUp();
+
 
 private:
-	GLuint Compile(const char *str, GLenum type);
+	GLuint Compile(const std::string &text, GLenum type);
+	// Try to load this program from the cache, or add it to the cache.
+	bool LoadBinary(const std::string &source);
+	void SaveBinary(const std::string &source);
+	// Look up the location of every active attribute and uniform, so that
+	// finding them later does not need to ask the driver.
+	void FindLocations();
 
 
 private:
 	GLuint program;
+	std::map<std::string, GLint> attribs;
+	std::map<std::string, GLint> uniforms;
 };
 
 
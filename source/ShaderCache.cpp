@@ -0,0 +1,169 @@
+/* ShaderCache.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ShaderCache.h"
+
+#include "Files.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace {
+	// Every cache begins with this header. The version must be changed whenever
+	// the cache format changes.
+	const string HEADER = "Endless Sky shader cache";
+	const uint64_t VERSION = 1;
+
+	template <class Type>
+	void Write(string &out, Type value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+
+
+	template <class Type>
+	bool Read(const string &data, size_t &pos, Type &value)
+	{
+		if(data.size() - pos < sizeof(value))
+			return false;
+		memcpy(&value, data.data() + pos, sizeof(value));
+		pos += sizeof(value);
+		return true;
+	}
+
+
+
+	bool ReadString(const string &data, size_t &pos, string &value)
+	{
+		uint64_t length = 0;
+		if(!Read(data, pos, length) || data.size() - pos < length)
+			return false;
+		value.assign(data, pos, length);
+		pos += length;
+		return true;
+	}
+
+
+
+	void WriteString(string &out, const string &value)
+	{
+		Write<uint64_t>(out, value.size());
+		out += value;
+	}
+
+
+
+	// The 64-bit FNV-1a hash of the given text.
+	uint64_t Hash(const string &text)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for(char c : text)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+}
+
+
+
+// Load the cache saved at the given path.
+ShaderCache::ShaderCache(const string &path, const string &driver)
+	: path(path), driver(driver)
+{
+	string data = Files::Read(path);
+	if(data.compare(0, HEADER.size(), HEADER))
+		return;
+
+	size_t pos = HEADER.size();
+	uint64_t version = 0;
+	string savedDriver;
+	if(!Read(data, pos, version) || version != VERSION || !ReadString(data, pos, savedDriver) || savedDriver != driver)
+		return;
+
+	while(pos < data.size())
+	{
+		uint64_t key = 0;
+		Entry entry;
+		if(!Read(data, pos, key) || !Read(data, pos, entry.format) || !ReadString(data, pos, entry.binary))
+		{
+			// If any part of the cache is damaged, none of it can be trusted.
+			entries.clear();
+			return;
+		}
+		entries[key] = std::move(entry);
+	}
+}
+
+
+
+// Get the binary for the program with the given source.
+bool ShaderCache::Get(const string &source, uint32_t &format, string &binary)
+{
+	auto it = entries.find(Hash(source));
+	if(it == entries.end())
+		return false;
+
+	it->second.isUsed = true;
+	format = it->second.format;
+	binary = it->second.binary;
+	return true;
+}
+
+
+
+// Replace the binary for the program with the given source.
+void ShaderCache::Set(const string &source, uint32_t format, string binary)
+{
+	Entry &entry = entries[Hash(source)];
+	entry.format = format;
+	entry.binary = std::move(binary);
+	entry.isUsed = true;
+	isChanged = true;
+}
+
+
+
+// Save this cache, if anything in it has changed.
+void ShaderCache::Save()
+{
+	for(auto it = entries.begin(); it != entries.end(); )
+	{
+		if(it->second.isUsed)
+			++it;
+		else
+		{
+			it = entries.erase(it);
+			isChanged = true;
+		}
+	}
+	if(!isChanged)
+		return;
+
+	string out = HEADER;
+	Write(out, VERSION);
+	WriteString(out, driver);
+	for(const auto &it : entries)
+	{
+		Write(out, it.first);
+		Write(out, it.second.format);
+		WriteString(out, it.second.binary);
+	}
+	Files::Write(path, out);
+	isChanged = false;
+}
@@ -0,0 +1,65 @@
+/* ShaderCache.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SHADER_CACHE_H_
+#define SHADER_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+
+
+// A cache of linked shader programs, in the graphics driver's own binary format,
+// saved between runs so that the shaders do not need to be compiled again. The
+// binaries are only valid for the driver that made them, so the whole cache is
+// thrown out if the driver's vendor, renderer or version change. Each program
+// is identified by a hash of its full source code.
+class ShaderCache {
+public:
+	// Load the cache saved at the given path, if it was saved by the driver with
+	// the given description. Otherwise, this cache starts out empty.
+	ShaderCache(const std::string &path, const std::string &driver);
+
+	// Get the binary for the program with the given source code, if there is one.
+	// Getting a program's binary notes that it should be kept in the cache.
+	bool Get(const std::string &source, uint32_t &format, std::string &binary);
+	// Set the binary for the program with the given source code.
+	void Set(const std::string &source, uint32_t format, std::string binary);
+
+	// Save this cache, if anything in it has changed. Any programs that were not
+	// used or set since it was loaded are dropped from it.
+	void Save();
+
+
+private:
+	class Entry {
+	public:
+		uint32_t format = 0;
+		std::string binary;
+		bool isUsed = false;
+	};
+
+
+private:
+	std::string path;
+	std::string driver;
+	std::map<uint64_t, Entry> entries;
+	bool isChanged = false;
+};
+
+
+
+#endif
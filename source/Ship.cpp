@@ -30,6 +30,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Logger.h"
 #include "Mask.h"
 #include "Messages.h"
+#include "Particle.h"
 #include "Phrase.h"
 #include "Planet.h"
 #include "PlayerInfo.h"
@@ -215,6 +216,7 @@ void Ship::Load(const DataNode &node)
 	isDefined = true;
 
 	government = GameData::PlayerGovernment();
+	Chassis &edit = EditChassis();
 
 	// Note: I do not clear the attributes list here so that it is permissible
 	// to override one ship definition with another.
@@ -253,7 +255,7 @@ void Ship::Load(const DataNode &node)
 		else if(key == "attributes" || add)
 		{
 			if(!add)
-				baseAttributes.Load(child);
+				edit.baseAttributes.Load(child);
 			else
 			{
 				addAttributes = true;
@@ -264,16 +266,16 @@ void Ship::Load(const DataNode &node)
 		{
 			if(!hasEngine)
 			{
-				enginePoints.clear();
-				reverseEnginePoints.clear();
-				steeringEnginePoints.clear();
+				edit.enginePoints.clear();
+				edit.reverseEnginePoints.clear();
+				edit.steeringEnginePoints.clear();
 				hasEngine = true;
 			}
 			bool reverse = (key == "reverse engine");
 			bool steering = (key == "steering engine");
 
-			vector<EnginePoint> &editPoints = (!steering && !reverse) ? enginePoints :
-				(reverse ? reverseEnginePoints : steeringEnginePoints);
+			vector<EnginePoint> &editPoints = (!steering && !reverse) ? edit.enginePoints :
+				(reverse ? edit.reverseEnginePoints : edit.steeringEnginePoints);
 			editPoints.emplace_back(0.5 * child.Value(1), 0.5 * child.Value(2),
 				(child.Size() > 3 ? child.Value(3) : 1.));
 			EnginePoint &engine = editPoints.back();
@@ -413,7 +415,7 @@ void Ship::Load(const DataNode &node)
 		{
 			if(!hasLeak)
 			{
-				leaks.clear();
+				edit.leaks.clear();
 				hasLeak = true;
 			}
 			Leak leak(GameData::Effects().Get(child.Token(1)));
@@ -421,29 +423,29 @@ void Ship::Load(const DataNode &node)
 				leak.openPeriod = child.Value(2);
 			if(child.Size() >= 4)
 				leak.closePeriod = child.Value(3);
-			leaks.push_back(leak);
+			edit.leaks.push_back(leak);
 		}
 		else if(key == "explode" && child.Size() >= 2)
 		{
 			if(!hasExplode)
 			{
-				explosionEffects.clear();
-				explosionTotal = 0;
+				edit.explosionEffects.clear();
+				edit.explosionTotal = 0;
 				hasExplode = true;
 			}
 			int count = (child.Size() >= 3) ? child.Value(2) : 1;
-			explosionEffects[GameData::Effects().Get(child.Token(1))] += count;
-			explosionTotal += count;
+			edit.explosionEffects[GameData::Effects().Get(child.Token(1))] += count;
+			edit.explosionTotal += count;
 		}
 		else if(key == "final explode" && child.Size() >= 2)
 		{
 			if(!hasFinalExplode)
 			{
-				finalExplosions.clear();
+				edit.finalExplosions.clear();
 				hasFinalExplode = true;
 			}
 			int count = (child.Size() >= 3) ? child.Value(2) : 1;
-			finalExplosions[GameData::Effects().Get(child.Token(1))] += count;
+			edit.finalExplosions[GameData::Effects().Get(child.Token(1))] += count;
 		}
 		else if(key == "outfits")
 		{
@@ -501,11 +503,11 @@ void Ship::Load(const DataNode &node)
 		{
 			if(!hasDescription)
 			{
-				description.clear();
+				edit.description.clear();
 				hasDescription = true;
 			}
-			description += child.Token(1);
-			description += '\n';
+			edit.description += child.Token(1);
+			edit.description += '\n';
 		}
 		else if(key == "remove" && child.Size() >= 2)
 		{
@@ -560,27 +562,29 @@ void Ship::FinishLoading(bool isNewInstance)
 			reinterpret_cast<Body &>(*this) = *base;
 		if(customSwizzle == -1)
 			customSwizzle = base->CustomSwizzle();
-		if(baseAttributes.Attributes().empty())
-			baseAttributes = base->baseAttributes;
+		const Chassis &baseChassis = *base->chassis;
+		if(chassis->baseAttributes.Attributes().empty())
+			EditChassis().baseAttributes = baseChassis.baseAttributes;
 		if(bays.empty() && !base->bays.empty() && !removeBays)
 			bays = base->bays;
-		if(enginePoints.empty())
-			enginePoints = base->enginePoints;
-		if(reverseEnginePoints.empty())
-			reverseEnginePoints = base->reverseEnginePoints;
-		if(steeringEnginePoints.empty())
-			steeringEnginePoints = base->steeringEnginePoints;
-		if(explosionEffects.empty())
+		if(chassis->enginePoints.empty())
+			EditChassis().enginePoints = baseChassis.enginePoints;
+		if(chassis->reverseEnginePoints.empty())
+			EditChassis().reverseEnginePoints = baseChassis.reverseEnginePoints;
+		if(chassis->steeringEnginePoints.empty())
+			EditChassis().steeringEnginePoints = baseChassis.steeringEnginePoints;
+		if(chassis->explosionEffects.empty())
 		{
-			explosionEffects = base->explosionEffects;
-			explosionTotal = base->explosionTotal;
+			Chassis &edit = EditChassis();
+			edit.explosionEffects = baseChassis.explosionEffects;
+			edit.explosionTotal = baseChassis.explosionTotal;
 		}
-		if(finalExplosions.empty())
-			finalExplosions = base->finalExplosions;
+		if(chassis->finalExplosions.empty())
+			EditChassis().finalExplosions = baseChassis.finalExplosions;
 		if(outfits.empty())
 			outfits = base->outfits;
-		if(description.empty())
-			description = base->description;
+		if(chassis->description.empty())
+			EditChassis().description = baseChassis.description;
 
 		bool hasHardpoints = false;
 		for(const Hardpoint &hardpoint : armament.Get())
@@ -651,21 +655,25 @@ void Ship::FinishLoading(bool isNewInstance)
 
 	// Mark any drone that has no "automaton" value as an automaton, to
 	// grandfather in the drones from before that attribute existed.
-	if(baseAttributes.Category() == "Drone" && !baseAttributes.Get("automaton"))
-		baseAttributes.Set("automaton", 1.);
+	if(chassis->baseAttributes.Category() == "Drone" && !chassis->baseAttributes.Get(AttributeKey::AUTOMATON))
+		EditChassis().baseAttributes.Set("automaton", 1.);
 
-	baseAttributes.Set("gun ports", armament.GunCount());
-	baseAttributes.Set("turret mounts", armament.TurretCount());
+	// Only modify the chassis if these counts actually change, so that a copy of
+	// a ship that is finished loading keeps sharing it with its model.
+	if(chassis->baseAttributes.Get("gun ports") != armament.GunCount())
+		EditChassis().baseAttributes.Set("gun ports", armament.GunCount());
+	if(chassis->baseAttributes.Get(AttributeKey::TURRET_MOUNTS) != armament.TurretCount())
+		EditChassis().baseAttributes.Set("turret mounts", armament.TurretCount());
 
 	if(addAttributes)
 	{
 		// Store attributes from an "add attributes" node in the ship's
 		// baseAttributes so they can be written to the save file.
-		baseAttributes.Add(attributes);
+		EditChassis().baseAttributes.Add(attributes);
 		addAttributes = false;
 	}
 	// Add the attributes of all your outfits to the ship's base attributes.
-	attributes = baseAttributes;
+	attributes = chassis->baseAttributes;
 	vector<string> undefinedOutfits;
 	for(const auto &it : outfits)
 	{
@@ -724,7 +732,7 @@ void Ship::FinishLoading(bool isNewInstance)
 	{
 		const Outfit *outfit = hardpoint.GetOutfit();
 		if(outfit && outfit->IsDefined()
-				&& (hardpoint.IsTurret() != (outfit->Get("turret mounts") != 0.)))
+				&& (hardpoint.IsTurret() != (outfit->Get(AttributeKey::TURRET_MOUNTS) != 0.)))
 		{
 			string warning = (!isYours && !variantName.empty()) ? "variant \"" + variantName + "\"" : modelName;
 			if(!name.empty())
@@ -736,7 +744,7 @@ void Ship::FinishLoading(bool isNewInstance)
 			Logger::LogError(warning);
 		}
 	}
-	cargo.SetSize(attributes.Get("cargo space"));
+	cargo.SetSize(attributes.Get(AttributeKey::CARGO_SPACE));
 	armament.FinishLoading();
 
 	// Figure out how far from center the farthest hardpoint is.
@@ -773,6 +781,7 @@ void Ship::FinishLoading(bool isNewInstance)
 	}
 
 	canBeCarried = bayCategories.Contains(attributes.Category());
+	CountBays();
 
 	// Issue warnings if this ship has is misconfigured, e.g. is missing required values
 	// or has negative outfit, cargo, weapon, or engine capacity.
@@ -782,9 +791,10 @@ void Ship::FinishLoading(bool isNewInstance)
 		if(val < 0)
 			warning += attr + ": " + Format::Number(val) + "\n";
 	}
-	if(attributes.Get("drag") <= 0.)
+	if(attributes.Get(AttributeKey::DRAG) <= 0.)
 	{
-		warning += "Defaulting " + string(attributes.Get("drag") ? "invalid" : "missing") + " \"drag\" attribute to 100.0\n";
+		warning += "Defaulting " + string(attributes.Get(AttributeKey::DRAG) ? "invalid" : "missing")
+			+ " \"drag\" attribute to 100.0\n";
 		attributes.Set("drag", 100.);
 	}
 
@@ -812,6 +822,8 @@ void Ship::FinishLoading(bool isNewInstance)
 	// Calculate this ship's jump information, e.g. how much it costs to jump, how far it can jump, how it can jump.
 	navigation.Calibrate(*this);
 	aiCache.Calibrate(*this);
+	UpdateFrameStats();
+	++loadoutVersion;
 
 	// A saved ship may have an invalid target system. Since all game data is loaded and all player events are
 	// applied at this point, any target system that is not accessible should be cleared. Note: this does not
@@ -875,52 +887,52 @@ void Ship::Save(DataWriter &out) const
 		out.Write("attributes");
 		out.BeginChild();
 		{
-			out.Write("category", baseAttributes.Category());
-			out.Write("cost", baseAttributes.Cost());
-			out.Write("mass", baseAttributes.Mass());
-			for(const auto &it : baseAttributes.FlareSprites())
+			out.Write("category", chassis->baseAttributes.Category());
+			out.Write("cost", chassis->baseAttributes.Cost());
+			out.Write("mass", chassis->baseAttributes.Mass());
+			for(const auto &it : chassis->baseAttributes.FlareSprites())
 				for(int i = 0; i < it.second; ++i)
 					it.first.SaveSprite(out, "flare sprite");
-			for(const auto &it : baseAttributes.FlareSounds())
+			for(const auto &it : chassis->baseAttributes.FlareSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("flare sound", it.first->Name());
-			for(const auto &it : baseAttributes.ReverseFlareSprites())
+			for(const auto &it : chassis->baseAttributes.ReverseFlareSprites())
 				for(int i = 0; i < it.second; ++i)
 					it.first.SaveSprite(out, "reverse flare sprite");
-			for(const auto &it : baseAttributes.ReverseFlareSounds())
+			for(const auto &it : chassis->baseAttributes.ReverseFlareSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("reverse flare sound", it.first->Name());
-			for(const auto &it : baseAttributes.SteeringFlareSprites())
+			for(const auto &it : chassis->baseAttributes.SteeringFlareSprites())
 				for(int i = 0; i < it.second; ++i)
 					it.first.SaveSprite(out, "steering flare sprite");
-			for(const auto &it : baseAttributes.SteeringFlareSounds())
+			for(const auto &it : chassis->baseAttributes.SteeringFlareSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("steering flare sound", it.first->Name());
-			for(const auto &it : baseAttributes.AfterburnerEffects())
+			for(const auto &it : chassis->baseAttributes.AfterburnerEffects())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("afterburner effect", it.first->Name());
-			for(const auto &it : baseAttributes.JumpEffects())
+			for(const auto &it : chassis->baseAttributes.JumpEffects())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump effect", it.first->Name());
-			for(const auto &it : baseAttributes.JumpSounds())
+			for(const auto &it : chassis->baseAttributes.JumpSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump sound", it.first->Name());
-			for(const auto &it : baseAttributes.JumpInSounds())
+			for(const auto &it : chassis->baseAttributes.JumpInSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump in sound", it.first->Name());
-			for(const auto &it : baseAttributes.JumpOutSounds())
+			for(const auto &it : chassis->baseAttributes.JumpOutSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("jump out sound", it.first->Name());
-			for(const auto &it : baseAttributes.HyperSounds())
+			for(const auto &it : chassis->baseAttributes.HyperSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("hyperdrive sound", it.first->Name());
-			for(const auto &it : baseAttributes.HyperInSounds())
+			for(const auto &it : chassis->baseAttributes.HyperInSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("hyperdrive in sound", it.first->Name());
-			for(const auto &it : baseAttributes.HyperOutSounds())
+			for(const auto &it : chassis->baseAttributes.HyperOutSounds())
 				for(int i = 0; i < it.second; ++i)
 					out.Write("hyperdrive out sound", it.first->Name());
-			for(const auto &it : baseAttributes.Attributes())
+			for(const auto &it : chassis->baseAttributes.Attributes())
 				if(it.second)
 					out.Write(it.first, it.second);
 		}
@@ -950,7 +962,7 @@ void Ship::Save(DataWriter &out) const
 		out.Write("hull", hull);
 		out.Write("position", position.X(), position.Y());
 
-		for(const EnginePoint &point : enginePoints)
+		for(const EnginePoint &point : chassis->enginePoints)
 		{
 			out.Write("engine", 2. * point.X(), 2. * point.Y());
 			out.BeginChild();
@@ -960,7 +972,7 @@ void Ship::Save(DataWriter &out) const
 			out.EndChild();
 
 		}
-		for(const EnginePoint &point : reverseEnginePoints)
+		for(const EnginePoint &point : chassis->reverseEnginePoints)
 		{
 			out.Write("reverse engine", 2. * point.X(), 2. * point.Y());
 			out.BeginChild();
@@ -969,7 +981,7 @@ void Ship::Save(DataWriter &out) const
 			out.Write(ENGINE_SIDE[point.side]);
 			out.EndChild();
 		}
-		for(const EnginePoint &point : steeringEnginePoints)
+		for(const EnginePoint &point : chassis->steeringEnginePoints)
 		{
 			out.Write("steering engine", 2. * point.X(), 2. * point.Y());
 			out.BeginChild();
@@ -1022,18 +1034,18 @@ void Ship::Save(DataWriter &out) const
 				out.EndChild();
 			}
 		}
-		for(const Leak &leak : leaks)
+		for(const Leak &leak : chassis->leaks)
 			out.Write("leak", leak.effect->Name(), leak.openPeriod, leak.closePeriod);
 
 		using EffectElement = pair<const Effect *const, int>;
 		auto effectSort = [](const EffectElement *lhs, const EffectElement *rhs)
 			{ return lhs->first->Name() < rhs->first->Name(); };
-		WriteSorted(explosionEffects, effectSort, [&out](const EffectElement &it)
+		WriteSorted(chassis->explosionEffects, effectSort, [&out](const EffectElement &it)
 		{
 			if(it.second)
 				out.Write("explode", it.first->Name(), it.second);
 		});
-		WriteSorted(finalExplosions, effectSort, [&out](const EffectElement &it)
+		WriteSorted(chassis->finalExplosions, effectSort, [&out](const EffectElement &it)
 		{
 			if(it.second)
 				out.Write("final explode", it.first->Name(), it.second);
@@ -1123,7 +1135,7 @@ const string &Ship::Noun() const
 // Get this ship's description.
 const string &Ship::Description() const
 {
-	return description;
+	return chassis->description;
 }
 
 
@@ -1147,7 +1159,7 @@ int64_t Ship::Cost() const
 // Get the cost of this ship's chassis, with no outfits installed.
 int64_t Ship::ChassisCost() const
 {
-	return baseAttributes.Cost();
+	return chassis->baseAttributes.Cost();
 }
 
 
@@ -1175,24 +1187,54 @@ double Ship::Deterrence() const
 
 // Check if this ship is configured in such a way that it would be difficult
 // or impossible to fly.
-vector<string> Ship::FlightCheck() const
+const vector<string> &Ship::FlightCheck() const
+{
+	if(!HasCurrentFlightCheck())
+	{
+		flightCheck = CalculateFlightCheck();
+		flightCheckVersion = loadoutVersion;
+		flightCheckCargo = cargo.Used();
+		flightCheckJumpFuel = navigation.JumpFuel();
+	}
+	return flightCheck;
+}
+
+
+
+bool Ship::HasCurrentFlightCheck() const
+{
+	return flightCheckVersion == loadoutVersion && flightCheckCargo == cargo.Used()
+		&& flightCheckJumpFuel == navigation.JumpFuel();
+}
+
+
+
+int Ship::LoadoutVersion() const
+{
+	return loadoutVersion;
+}
+
+
+
+vector<string> Ship::CalculateFlightCheck() const
 {
 	auto checks = vector<string>{};
 
-	double generation = attributes.Get("energy generation") - attributes.Get("energy consumption");
-	double consuming = attributes.Get("fuel energy");
-	double solar = attributes.Get("solar collection");
-	double battery = attributes.Get("energy capacity");
+	double generation = attributes.Get(AttributeKey::ENERGY_GENERATION)
+		- attributes.Get(AttributeKey::ENERGY_CONSUMPTION);
+	double consuming = attributes.Get(AttributeKey::FUEL_ENERGY);
+	double solar = attributes.Get(AttributeKey::SOLAR_COLLECTION);
+	double battery = attributes.Get(AttributeKey::ENERGY_CAPACITY);
 	double energy = generation + consuming + solar + battery;
-	double fuelChange = attributes.Get("fuel generation") - attributes.Get("fuel consumption");
-	double fuelCapacity = attributes.Get("fuel capacity");
+	double fuelChange = attributes.Get(AttributeKey::FUEL_GENERATION) - attributes.Get(AttributeKey::FUEL_CONSUMPTION);
+	double fuelCapacity = attributes.Get(AttributeKey::FUEL_CAPACITY);
 	double fuel = fuelCapacity + fuelChange;
-	double thrust = attributes.Get("thrust");
-	double reverseThrust = attributes.Get("reverse thrust");
-	double afterburner = attributes.Get("afterburner thrust");
-	double thrustEnergy = attributes.Get("thrusting energy");
-	double turn = attributes.Get("turn");
-	double turnEnergy = attributes.Get("turning energy");
+	double thrust = attributes.Get(AttributeKey::THRUST);
+	double reverseThrust = attributes.Get(AttributeKey::REVERSE_THRUST);
+	double afterburner = attributes.Get(AttributeKey::AFTERBURNER_THRUST);
+	double thrustEnergy = attributes.Get(AttributeKey::THRUSTING_ENERGY);
+	double turn = attributes.Get(AttributeKey::TURN);
+	double turnEnergy = attributes.Get(AttributeKey::TURNING_ENERGY);
 	double hyperDrive = navigation.HasHyperdrive();
 	double jumpDrive = navigation.HasJumpDrive();
 
@@ -1207,7 +1249,7 @@ vector<string> Ship::FlightCheck() const
 		checks.emplace_back("no thruster!");
 	else if(!turn)
 		checks.emplace_back("no steering!");
-	else if(RequiredCrew() > attributes.Get("bunks"))
+	else if(RequiredCrew() > attributes.Get(AttributeKey::BUNKS))
 		checks.emplace_back("insufficient bunks!");
 
 	// If no errors were found, check all warning conditions:
@@ -1305,6 +1347,7 @@ void Ship::Place(Point position, Point velocity, Angle angle, bool isDeparting)
 				bay.ship->SetSwizzle(bay.ship->customSwizzle >= 0 ? bay.ship->customSwizzle : swizzle);
 		}
 	}
+	UpdateFrameStats();
 }
 
 
@@ -1447,10 +1490,25 @@ ShipAICache &Ship::GetAICache()
 
 
 
+const ShipAICache &Ship::GetAICache() const
+{
+	return aiCache;
+}
+
+
+
 void Ship::UpdateCaches()
 {
 	aiCache.Recalibrate(*this);
 	navigation.Recalibrate(*this);
+	UpdateFrameStats();
+}
+
+
+
+const ShipFrameStats &Ship::FrameStats() const
+{
+	return frameStats;
 }
 
 
@@ -1518,14 +1576,14 @@ const FireCommand &Ship::FiringCommands() const noexcept
 // Move this ship. A ship may create effects as it moves, in particular if
 // it is in the process of blowing up. If this returns false, the ship
 // should be deleted.
-void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
+void Ship::Move(vector<Visual> &visuals, vector<Particle> &particles, vector<Flotsam> &flotsam)
 {
 	// Do nothing with ships that are being forgotten.
 	if(StepFlags())
 		return;
 
 	// We're done if the ship was destroyed.
-	const int destroyResult = StepDestroyed(visuals, flotsam);
+	const int destroyResult = StepDestroyed(visuals, particles, flotsam);
 	if(destroyResult > 0)
 		return;
 
@@ -1535,9 +1593,10 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 	if(!isBeingDestroyed)
 		DoGeneration();
 
-	DoPassiveEffects(visuals, flotsam);
+	DoPassiveEffects(particles, flotsam);
 	DoJettison(flotsam);
 	DoCloakDecision();
+	UpdateFrameStats();
 
 	bool isUsingAfterburner = false;
 
@@ -1546,7 +1605,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 	{
 		// See if the ship is entering hyperspace.
 		// If it is, nothing more needs to be done here.
-		if(DoHyperspaceLogic(visuals))
+		if(DoHyperspaceLogic(particles))
 			return;
 
 		// Check if we're trying to land.
@@ -1569,7 +1628,7 @@ void Ship::Move(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
 
 	// Show afterburner flares unless the ship is being destroyed.
 	if(!isBeingDestroyed)
-		DoEngineVisuals(visuals, isUsingAfterburner);
+		DoEngineVisuals(particles, isUsingAfterburner);
 }
 
 
@@ -1583,10 +1642,17 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships, vector<Visual> &visuals)
 	bool ejecting = IsDestroyed();
 	if(!ejecting && (!commands.Has(Command::DEPLOY) || zoom != 1.f || hyperspaceCount || cloak))
 		return;
+	// There is nothing to do if every bay is empty.
+	bool isCarrying = false;
+	for(const BayCount &count : bayCounts)
+		isCarrying |= (count.free < count.total);
+	if(!isCarrying)
+		return;
 
 	for(Bay &bay : bays)
 		if(bay.ship
-			&& ((bay.ship->Commands().Has(Command::DEPLOY) && !Random::Int(40 + 20 * !bay.ship->attributes.Get("automaton")))
+			&& ((bay.ship->Commands().Has(Command::DEPLOY)
+				&& !Random::Int(40 + 20 * !bay.ship->attributes.Get(AttributeKey::AUTOMATON)))
 			|| (ejecting && !Random::Int(6))))
 		{
 			// Resupply any ships launching of their own accord.
@@ -1612,7 +1678,7 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships, vector<Visual> &visuals)
 
 				// This ship will refuel naturally based on the carrier's fuel
 				// collection, but the carrier may have some reserves to spare.
-				double maxFuel = bay.ship->attributes.Get("fuel capacity");
+				double maxFuel = bay.ship->attributes.Get(AttributeKey::FUEL_CAPACITY);
 				if(maxFuel)
 				{
 					double spareFuel = fuel - navigation.JumpFuel();
@@ -1648,6 +1714,7 @@ void Ship::Launch(list<shared_ptr<Ship>> &ships, vector<Visual> &visuals)
 				visuals.emplace_back(*effect, exitPoint, velocity, launchAngle);
 
 			bay.ship.reset();
+			++GetBayCount(bay.category)->free;
 		}
 }
 
@@ -1680,7 +1747,7 @@ shared_ptr<Ship> Ship::Board(bool autoPlunder, bool nonDocking)
 		SetShipToAssist(shared_ptr<Ship>());
 		SetTargetShip(shared_ptr<Ship>());
 		bool helped = victim->isDisabled;
-		victim->hull = min(max(victim->hull, victim->MinimumHull() * 1.5), victim->attributes.Get("hull"));
+		victim->hull = min(max(victim->hull, victim->MinimumHull() * 1.5), victim->attributes.Get(AttributeKey::HULL));
 		victim->isDisabled = false;
 		// Transfer some fuel if needed.
 		if(victim->NeedsFuel() && CanRefuel(*victim))
@@ -1731,18 +1798,18 @@ int Ship::Scan(const PlayerInfo &player)
 
 	// The range of a scanner is proportional to the square root of its power.
 	// Because of Pythagoras, if we use square-distance, we can skip this square root.
-	double cargoDistanceSquared = attributes.Get("cargo scan power");
-	double outfitDistanceSquared = attributes.Get("outfit scan power");
+	double cargoDistanceSquared = attributes.Get(AttributeKey::CARGO_SCAN_POWER);
+	double outfitDistanceSquared = attributes.Get(AttributeKey::OUTFIT_SCAN_POWER);
 
 	// Bail out if this ship has no scanners.
 	if(!cargoDistanceSquared && !outfitDistanceSquared)
 		return 0;
 
-	double cargoSpeed = attributes.Get("cargo scan efficiency");
+	double cargoSpeed = attributes.Get(AttributeKey::CARGO_SCAN_EFFICIENCY);
 	if(!cargoSpeed)
 		cargoSpeed = cargoDistanceSquared;
 
-	double outfitSpeed = attributes.Get("outfit scan efficiency");
+	double outfitSpeed = attributes.Get(AttributeKey::OUTFIT_SCAN_EFFICIENCY);
 	if(!outfitSpeed)
 		outfitSpeed = outfitDistanceSquared;
 
@@ -1750,6 +1817,10 @@ int Ship::Scan(const PlayerInfo &player)
 	// To normalize 1 "scan power" to reach 100 pixels, divide this square distance by 100^2, or multiply by 0.0001.
 	// Because this uses distance squared, to reach 200 pixels away you need 4 "scan power".
 	double distanceSquared = target->position.DistanceSquared(position) * .0001;
+	// A target out of range of both scanners cannot be scanned at all. The only
+	// thing left to do in that case is play the scanning sound for the player.
+	if(!isYours && distanceSquared >= max(cargoDistanceSquared, outfitDistanceSquared))
+		return 0;
 
 	// Check the target's outfit and cargo space. A larger ship takes longer to scan.
 	// Normalized around 200 tons of cargo/outfit space.
@@ -1757,8 +1828,8 @@ int Ship::Scan(const PlayerInfo &player)
 	// scan as one with 10 tons. This avoids small sizes being scanned instantly, or
 	// causing a divide by zero error at sizes of 0.
 	// If instantly scanning very small ships is desirable, this can be removed.
-	double outfits = max(10., target->baseAttributes.Get("outfit space")) * .005;
-	double cargo = max(10., target->attributes.Get("cargo space")) * .005;
+	double outfits = max(10., target->chassis->baseAttributes.Get(AttributeKey::OUTFIT_SPACE)) * .005;
+	double cargo = max(10., target->attributes.Get(AttributeKey::CARGO_SPACE)) * .005;
 
 	// Check if either scanner has finished scanning.
 	bool startedScanning = false;
@@ -1842,7 +1913,7 @@ int Ship::Scan(const PlayerInfo &player)
 		if(result & ShipEvent::SCAN_OUTFITS)
 			Messages::Add("The " + government->GetName() + " " + Noun() + " \""
 					+ Name() + "\" completed its outfit scan of your ship \"" + target->Name()
-					+ (target->Attributes().Get("inscrutable") > 0. ? "\" with no useful results." : "\"."),
+					+ (target->Attributes().Get(AttributeKey::INSCRUTABLE) > 0. ? "\" with no useful results." : "\"."),
 					Messages::Importance::High);
 	}
 
@@ -1883,7 +1954,7 @@ bool Ship::Fire(vector<Projectile> &projectiles, vector<Visual> &visuals)
 
 	// A ship that is about to die creates a special single-turn "projectile"
 	// representing its death explosion.
-	if(IsDestroyed() && explosionCount == explosionTotal && explosionWeapon)
+	if(IsDestroyed() && explosionCount == chassis->explosionTotal && explosionWeapon)
 		projectiles.emplace_back(position, explosionWeapon);
 
 	if(CannotAct())
@@ -1913,6 +1984,13 @@ bool Ship::Fire(vector<Projectile> &projectiles, vector<Visual> &visuals)
 
 
 
+double Ship::AntiMissileRange() const
+{
+	return antiMissileRange;
+}
+
+
+
 // Fire an anti-missile.
 bool Ship::FireAntiMissile(const Projectile &projectile, vector<Visual> &visuals)
 {
@@ -2083,7 +2161,7 @@ bool Ship::IsReadyToJump(bool waitingIsReady) const
 
 	Point direction = targetSystem->Position() - currentSystem->Position();
 	bool isJump = (jumpUsed.first == JumpType::JUMP_DRIVE);
-	double scramThreshold = attributes.Get("scram drive");
+	double scramThreshold = attributes.Get(AttributeKey::SCRAM_DRIVE);
 
 	// If the system has a departure distance the ship is only allowed to leave the system
 	// if it is beyond this distance.
@@ -2102,7 +2180,7 @@ bool Ship::IsReadyToJump(bool waitingIsReady) const
 		if(deviation > scramThreshold)
 			return false;
 	}
-	else if(velocity.Length() > attributes.Get("jump speed"))
+	else if(velocity.Length() > attributes.Get(AttributeKey::JUMP_SPEED))
 		return false;
 
 	if(!isJump)
@@ -2160,21 +2238,21 @@ double Ship::SteeringDirection() const
 // Get the points from which engine flares should be drawn.
 const vector<Ship::EnginePoint> &Ship::EnginePoints() const
 {
-	return enginePoints;
+	return chassis->enginePoints;
 }
 
 
 
 const vector<Ship::EnginePoint> &Ship::ReverseEnginePoints() const
 {
-	return reverseEnginePoints;
+	return chassis->reverseEnginePoints;
 }
 
 
 
 const vector<Ship::EnginePoint> &Ship::SteeringEnginePoints() const
 {
-	return steeringEnginePoints;
+	return chassis->steeringEnginePoints;
 }
 
 
@@ -2221,7 +2299,7 @@ void Ship::Restore()
 bool Ship::IsDamaged() const
 {
 	// Account for ships with no shields when determining if they're damaged.
-	return (attributes.Get("shields") != 0 && Shields() != 1.) || Hull() != 1.;
+	return (attributes.Get(AttributeKey::SHIELDS) != 0 && Shields() != 1.) || Hull() != 1.;
 }
 
 
@@ -2241,18 +2319,18 @@ void Ship::Recharge(bool atSpaceport)
 		return;
 
 	if(atSpaceport)
-		crew = min<int>(max(crew, RequiredCrew()), attributes.Get("bunks"));
+		crew = min<int>(max(crew, RequiredCrew()), attributes.Get(AttributeKey::BUNKS));
 	pilotError = 0;
 	pilotOkay = 0;
 
-	if(atSpaceport || attributes.Get("shield generation"))
-		shields = attributes.Get("shields");
-	if(atSpaceport || attributes.Get("hull repair rate"))
-		hull = attributes.Get("hull");
-	if(atSpaceport || attributes.Get("energy generation"))
-		energy = attributes.Get("energy capacity");
-	if(atSpaceport || attributes.Get("fuel generation"))
-		fuel = attributes.Get("fuel capacity");
+	if(atSpaceport || attributes.Get(AttributeKey::SHIELD_GENERATION))
+		shields = attributes.Get(AttributeKey::SHIELDS);
+	if(atSpaceport || attributes.Get(AttributeKey::HULL_REPAIR_RATE))
+		hull = attributes.Get(AttributeKey::HULL);
+	if(atSpaceport || attributes.Get(AttributeKey::ENERGY_GENERATION))
+		energy = attributes.Get(AttributeKey::ENERGY_CAPACITY);
+	if(atSpaceport || attributes.Get(AttributeKey::FUEL_GENERATION))
+		fuel = attributes.Get(AttributeKey::FUEL_CAPACITY);
 
 	heat = IdleHeat();
 	ionization = 0.;
@@ -2278,10 +2356,10 @@ bool Ship::CanRefuel(const Ship &other) const
 
 double Ship::TransferFuel(double amount, Ship *to)
 {
-	amount = max(fuel - attributes.Get("fuel capacity"), amount);
+	amount = max(fuel - attributes.Get(AttributeKey::FUEL_CAPACITY), amount);
 	if(to)
 	{
-		amount = min(to->attributes.Get("fuel capacity") - to->fuel, amount);
+		amount = min(to->attributes.Get(AttributeKey::FUEL_CAPACITY) - to->fuel, amount);
 		to->fuel += amount;
 	}
 	fuel -= amount;
@@ -2296,7 +2374,7 @@ double Ship::TransferFuel(double amount, Ship *to)
 int Ship::WasCaptured(const shared_ptr<Ship> &capturer)
 {
 	// Repair up to the point where this ship is just barely not disabled.
-	hull = min(max(hull, MinimumHull() * 1.5), attributes.Get("hull"));
+	hull = min(max(hull, MinimumHull() * 1.5), attributes.Get(AttributeKey::HULL));
 	isDisabled = false;
 
 	// Set the new government.
@@ -2353,8 +2431,8 @@ void Ship::ClearTargetsAndOrders()
 	SetTargetStellar(nullptr);
 	SetTargetSystem(nullptr);
 	shipToAssist.reset();
-	targetAsteroid.reset();
-	targetFlotsam.reset();
+	targetAsteroid = PoolHandle<Minable>();
+	targetFlotsam = PoolHandle<Flotsam>();
 	hyperspaceSystem = nullptr;
 	landingPlanet = nullptr;
 }
@@ -2364,7 +2442,7 @@ void Ship::ClearTargetsAndOrders()
 // Get characteristics of this ship, as a fraction between 0 and 1.
 double Ship::Shields() const
 {
-	double maximum = attributes.Get("shields");
+	double maximum = attributes.Get(AttributeKey::SHIELDS);
 	return maximum ? min(1., shields / maximum) : 0.;
 }
 
@@ -2372,7 +2450,7 @@ double Ship::Shields() const
 
 double Ship::Hull() const
 {
-	double maximum = attributes.Get("hull");
+	double maximum = attributes.Get(AttributeKey::HULL);
 	return maximum ? min(1., hull / maximum) : 1.;
 }
 
@@ -2380,7 +2458,7 @@ double Ship::Hull() const
 
 double Ship::Fuel() const
 {
-	double maximum = attributes.Get("fuel capacity");
+	double maximum = attributes.Get(AttributeKey::FUEL_CAPACITY);
 	return maximum ? min(1., fuel / maximum) : 0.;
 }
 
@@ -2388,7 +2466,7 @@ double Ship::Fuel() const
 
 double Ship::Energy() const
 {
-	double maximum = attributes.Get("energy capacity");
+	double maximum = attributes.Get(AttributeKey::ENERGY_CAPACITY);
 	return maximum ? min(1., energy / maximum) : (hull > 0.) ? 1. : 0.;
 }
 
@@ -2408,8 +2486,8 @@ double Ship::Heat() const
 double Ship::Health() const
 {
 	double minimumHull = MinimumHull();
-	double hullDivisor = attributes.Get("hull") - minimumHull;
-	double divisor = attributes.Get("shields") + hullDivisor;
+	double hullDivisor = attributes.Get(AttributeKey::HULL) - minimumHull;
+	double divisor = attributes.Get(AttributeKey::SHIELDS) + hullDivisor;
 	// This should not happen, but just in case.
 	if(divisor <= 0. || hullDivisor <= 0.)
 		return 0.;
@@ -2424,7 +2502,7 @@ double Ship::Health() const
 // Get the hull fraction at which this ship is disabled.
 double Ship::DisabledHull() const
 {
-	double hull = attributes.Get("hull");
+	double hull = attributes.Get(AttributeKey::HULL);
 	double minimumHull = MinimumHull();
 
 	return (hull > 0. ? minimumHull / hull : 0.);
@@ -2501,7 +2579,7 @@ bool Ship::NeedsFuel(bool followParent) const
 	}
 	if(!jumpFuel)
 		jumpFuel = navigation.JumpFuel(targetSystem);
-	return (fuel < jumpFuel) && (attributes.Get("fuel capacity") >= jumpFuel);
+	return (fuel < jumpFuel) && (attributes.Get(AttributeKey::FUEL_CAPACITY) >= jumpFuel);
 }
 
 
@@ -2511,7 +2589,7 @@ double Ship::JumpFuelMissing() const
 	// Used for smart refueling: transfer only as much as really needed
 	// includes checking if fuel cap is high enough at all
 	double jumpFuel = navigation.JumpFuel(targetSystem);
-	if(!jumpFuel || fuel > jumpFuel || jumpFuel > attributes.Get("fuel capacity"))
+	if(!jumpFuel || fuel > jumpFuel || jumpFuel > attributes.Get(AttributeKey::FUEL_CAPACITY))
 		return 0.;
 
 	return jumpFuel - fuel;
@@ -2524,14 +2602,14 @@ double Ship::IdleHeat() const
 {
 	// This ship's cooling ability:
 	double coolingEfficiency = CoolingEfficiency();
-	double cooling = coolingEfficiency * attributes.Get("cooling");
-	double activeCooling = coolingEfficiency * attributes.Get("active cooling");
+	double cooling = coolingEfficiency * attributes.Get(AttributeKey::COOLING);
+	double activeCooling = coolingEfficiency * attributes.Get(AttributeKey::ACTIVE_COOLING);
 
 	// Idle heat is the heat level where:
 	// heat = heat * diss + heatGen - cool - activeCool * heat / (100 * mass)
 	// heat = heat * (diss - activeCool / (100 * mass)) + (heatGen - cool)
 	// heat * (1 - diss + activeCool / (100 * mass)) = (heatGen - cool)
-	double production = max(0., attributes.Get("heat generation") - cooling);
+	double production = max(0., attributes.Get(AttributeKey::HEAT_GENERATION) - cooling);
 	double dissipation = HeatDissipation() + activeCooling / MaximumHeat();
 	if(!dissipation) return production ? numeric_limits<double>::max() : 0;
 	return production / dissipation;
@@ -2542,7 +2620,7 @@ double Ship::IdleHeat() const
 // Get the heat dissipation, in heat units per heat unit per frame.
 double Ship::HeatDissipation() const
 {
-	return .001 * attributes.Get("heat dissipation");
+	return .001 * attributes.Get(AttributeKey::HEAT_DISSIPATION);
 }
 
 
@@ -2550,7 +2628,7 @@ double Ship::HeatDissipation() const
 // Get the maximum heat level, in heat units (not temperature).
 double Ship::MaximumHeat() const
 {
-	return MAXIMUM_TEMPERATURE * (cargo.Used() + attributes.Mass() + attributes.Get("heat capacity"));
+	return MAXIMUM_TEMPERATURE * (cargo.Used() + attributes.Mass() + attributes.Get(AttributeKey::HEAT_CAPACITY));
 }
 
 
@@ -2561,7 +2639,7 @@ double Ship::CoolingEfficiency() const
 	// This is an S-curve where the efficiency is 100% if you have no outfits
 	// that create "cooling inefficiency", and as that value increases the
 	// efficiency stays high for a while, then drops off, then approaches 0.
-	double x = attributes.Get("cooling inefficiency");
+	double x = attributes.Get(AttributeKey::COOLING_INEFFICIENCY);
 	return 2. + 2. / (1. + exp(x / -2.)) - 4. / (1. + exp(x / -4.));
 }
 
@@ -2577,32 +2655,32 @@ int Ship::Crew() const
 // Calculate drag, accounting for drag reduction.
 double Ship::Drag() const
 {
-	return attributes.Get("drag") / (1. + attributes.Get("drag reduction"));
+	return attributes.Get(AttributeKey::DRAG) / (1. + attributes.Get(AttributeKey::DRAG_REDUCTION));
 }
 
 
 
 int Ship::RequiredCrew() const
 {
-	if(attributes.Get("automaton"))
+	if(attributes.Get(AttributeKey::AUTOMATON))
 		return 0;
 
 	// Drones do not need crew, but all other ships need at least one.
-	return max<int>(1, attributes.Get("required crew"));
+	return max<int>(1, attributes.Get(AttributeKey::REQUIRED_CREW));
 }
 
 
 
 int Ship::CrewValue() const
 {
-	return max(Crew(), RequiredCrew()) + attributes.Get("crew equivalent");
+	return max(Crew(), RequiredCrew()) + attributes.Get(AttributeKey::CREW_EQUIVALENT);
 }
 
 
 
 void Ship::AddCrew(int count)
 {
-	crew = min<int>(crew + count, attributes.Get("bunks"));
+	crew = min<int>(crew + count, attributes.Get(AttributeKey::BUNKS));
 }
 
 
@@ -2625,22 +2703,22 @@ double Ship::Mass() const
 // Account for inertia reduction, which affects movement but has no effect on the ship's heat capacity.
 double Ship::InertialMass() const
 {
-	return Mass() / (1. + attributes.Get("inertia reduction"));
+	return Mass() / (1. + attributes.Get(AttributeKey::INERTIA_REDUCTION));
 }
 
 
 
 double Ship::TurnRate() const
 {
-	return attributes.Get("turn") / InertialMass();
+	return attributes.Get(AttributeKey::TURN) / InertialMass();
 }
 
 
 
 double Ship::Acceleration() const
 {
-	double thrust = attributes.Get("thrust");
-	return (thrust ? thrust : attributes.Get("afterburner thrust")) / InertialMass();
+	double thrust = attributes.Get(AttributeKey::THRUST);
+	return (thrust ? thrust : attributes.Get(AttributeKey::AFTERBURNER_THRUST)) / InertialMass();
 }
 
 
@@ -2650,22 +2728,22 @@ double Ship::MaxVelocity() const
 	// v * drag / mass == thrust / mass
 	// v * drag == thrust
 	// v = thrust / drag
-	double thrust = attributes.Get("thrust");
-	return (thrust ? thrust : attributes.Get("afterburner thrust")) / Drag();
+	double thrust = attributes.Get(AttributeKey::THRUST);
+	return (thrust ? thrust : attributes.Get(AttributeKey::AFTERBURNER_THRUST)) / Drag();
 }
 
 
 
 double Ship::ReverseAcceleration() const
 {
-	return attributes.Get("reverse thrust");
+	return attributes.Get(AttributeKey::REVERSE_THRUST);
 }
 
 
 
 double Ship::MaxReverseVelocity() const
 {
-	return attributes.Get("reverse thrust") / Drag();
+	return attributes.Get(AttributeKey::REVERSE_THRUST) / Drag();
 }
 
 
@@ -2674,7 +2752,7 @@ double Ship::MaxReverseVelocity() const
 // DamageDealt from that weapon. The return value is a ShipEvent type,
 // which may be a combination of PROVOKED, DISABLED, and DESTROYED.
 // Create any target effects as sparks.
-int Ship::TakeDamage(vector<Visual> &visuals, const DamageDealt &damage, const Government *sourceGovernment)
+int Ship::TakeDamage(vector<Particle> &particles, const DamageDealt &damage, const Government *sourceGovernment)
 {
 	bool wasDisabled = IsDisabled();
 	bool wasDestroyed = IsDestroyed();
@@ -2682,13 +2760,13 @@ int Ship::TakeDamage(vector<Visual> &visuals, const DamageDealt &damage, const G
 	shields -= damage.Shield();
 	if(damage.Shield() && !isDisabled)
 	{
-		int disabledDelay = attributes.Get("depleted shield delay");
+		int disabledDelay = attributes.Get(AttributeKey::DEPLETED_SHIELD_DELAY);
 		shieldDelay = max<int>(shieldDelay, (shields <= 0. && disabledDelay)
-			? disabledDelay : attributes.Get("shield delay"));
+			? disabledDelay : attributes.Get(AttributeKey::SHIELD_DELAY));
 	}
 	hull -= damage.Hull();
 	if(damage.Hull() && !isDisabled)
-		hullDelay = max(hullDelay, static_cast<int>(attributes.Get("repair delay")));
+		hullDelay = max(hullDelay, static_cast<int>(attributes.Get(AttributeKey::REPAIR_DELAY)));
 
 	energy -= damage.Energy();
 	heat += damage.Heat();
@@ -2708,8 +2786,8 @@ int Ship::TakeDamage(vector<Visual> &visuals, const DamageDealt &damage, const G
 		ApplyForce(damage.HitForce(), damage.GetWeapon().IsGravitational());
 
 	// Prevent various stats from reaching unallowable values.
-	hull = min(hull, attributes.Get("hull"));
-	shields = min(shields, attributes.Get("shields"));
+	hull = min(hull, attributes.Get(AttributeKey::HULL));
+	shields = min(shields, attributes.Get(AttributeKey::SHIELDS));
 	// Weapons are allowed to overcharge a ship's energy or fuel, but code in Ship::DoGeneration()
 	// will clamp it to a maximum value at the beginning of the next frame.
 	energy = max(0., energy);
@@ -2725,7 +2803,7 @@ int Ship::TakeDamage(vector<Visual> &visuals, const DamageDealt &damage, const G
 	if(!wasDisabled && isDisabled)
 	{
 		type |= ShipEvent::DISABLE;
-		hullDelay = max(hullDelay, static_cast<int>(attributes.Get("disabled repair delay")));
+		hullDelay = max(hullDelay, static_cast<int>(attributes.Get(AttributeKey::DISABLED_REPAIR_DELAY)));
 	}
 	if(!wasDestroyed && IsDestroyed())
 		type |= ShipEvent::DESTROY;
@@ -2755,7 +2833,7 @@ int Ship::TakeDamage(vector<Visual> &visuals, const DamageDealt &damage, const G
 
 	// Create target effect visuals, if there are any.
 	for(const auto &effect : damage.GetWeapon().TargetEffects())
-		CreateSparks(visuals, effect.first, effect.second * damage.Scaling());
+		CreateSparks(particles, effect.first, effect.second * damage.Scaling());
 
 	return type;
 }
@@ -2795,10 +2873,8 @@ bool Ship::HasBays() const
 // one of your escorts plans to use that bay.
 int Ship::BaysFree(const string &category) const
 {
-	int count = 0;
-	for(const Bay &bay : bays)
-		count += (bay.category == category) && !bay.ship;
-	return count;
+	const BayCount *count = GetBayCount(category);
+	return count ? count->free : 0;
 }
 
 
@@ -2806,10 +2882,8 @@ int Ship::BaysFree(const string &category) const
 // Check how many bays this ship has of a given category.
 int Ship::BaysTotal(const string &category) const
 {
-	int count = 0;
-	for(const Bay &bay : bays)
-		count += (bay.category == category);
-	return count;
+	const BayCount *count = GetBayCount(category);
+	return count ? count->total : 0;
 }
 
 
@@ -2899,6 +2973,7 @@ bool Ship::Carry(const shared_ptr<Ship> &ship)
 
 			// Update the cached mass of the mothership.
 			carriedMass += ship->Mass();
+			--GetBayCount(category)->free;
 			return true;
 		}
 	return false;
@@ -2917,6 +2992,7 @@ void Ship::UnloadBays()
 			bay.ship->UnmarkForRemoval();
 			bay.ship.reset();
 		}
+	CountBays();
 }
 
 
@@ -2979,8 +3055,8 @@ void Ship::Jettison(const string &commodity, int tons, bool wasAppeasing)
 	const Government *notForGov = wasAppeasing ? GetGovernment() : nullptr;
 
 	for( ; tons > 0; tons -= Flotsam::TONS_PER_BOX)
-		jettisoned.emplace_back(new Flotsam(commodity, (Flotsam::TONS_PER_BOX < tons)
-			? Flotsam::TONS_PER_BOX : tons, notForGov));
+		jettisoned.emplace_back(commodity, (Flotsam::TONS_PER_BOX < tons)
+			? Flotsam::TONS_PER_BOX : tons, notForGov);
 }
 
 
@@ -3009,8 +3085,8 @@ void Ship::Jettison(const Outfit *outfit, int count, bool wasAppeasing)
 		? 1 : static_cast<int>(Flotsam::TONS_PER_BOX / mass);
 	while(count > 0)
 	{
-		jettisoned.emplace_back(new Flotsam(outfit, (perBox < count)
-			? perBox : count, notForGov));
+		jettisoned.emplace_back(outfit, (perBox < count)
+			? perBox : count, notForGov);
 		count -= perBox;
 	}
 }
@@ -3026,7 +3102,7 @@ const Outfit &Ship::Attributes() const
 
 const Outfit &Ship::BaseAttributes() const
 {
-	return baseAttributes;
+	return chassis->baseAttributes;
 }
 
 
@@ -3064,38 +3140,73 @@ void Ship::AddOutfit(const Outfit *outfit, int count)
 		}
 		int after = outfits.count(outfit);
 		attributes.Add(*outfit, count);
+		++loadoutVersion;
 		if(outfit->IsWeapon())
 		{
 			armament.Add(outfit, count);
 			// Only the player's ships make use of attraction and deterrence.
-			if(isYours)
-				deterrence = CalculateDeterrence();
+			staleDeterrence |= isYours;
 		}
 
-		if(outfit->Get("cargo space"))
+		if(outfit->Get(AttributeKey::CARGO_SPACE))
 		{
-			cargo.SetSize(attributes.Get("cargo space"));
+			cargo.SetSize(attributes.Get(AttributeKey::CARGO_SPACE));
 			// Only the player's ships make use of attraction and deterrence.
-			if(isYours)
-				attraction = CalculateAttraction();
+			staleAttraction |= isYours;
 		}
-		if(outfit->Get("hull"))
-			hull += outfit->Get("hull") * count;
+		if(outfit->Get(AttributeKey::HULL))
+			hull += outfit->Get(AttributeKey::HULL) * count;
 		// If the added or removed outfit is a hyperdrive or jump drive, recalculate this
 		// ship's jump navigation. Hyperdrives and jump drives of the same type don't stack,
 		// so only do this if the outfit is either completely new or has been completely removed.
-		if((outfit->Get("hyperdrive") || outfit->Get("jump drive")) && (!before || !after))
-			navigation.Calibrate(*this);
+		if((outfit->Get(AttributeKey::HYPERDRIVE) || outfit->Get(AttributeKey::JUMP_DRIVE)) && (!before || !after))
+			staleDrives = true;
 		// Navigation may still need to be recalibrated depending on the drives a ship has.
 		// Only do this for player ships as to display correct information on the map.
 		// Non-player ships will recalibrate before they jump.
-		else if(isYours)
-			navigation.Recalibrate(*this);
+		else
+			staleNavigation |= isYours;
+
+		// Outside of a group of changes, bring the derived values up to date right away.
+		if(!loadoutChanges)
+		{
+			++loadoutChanges;
+			FinishLoadoutChange();
+		}
 	}
 }
 
 
 
+void Ship::BeginLoadoutChange()
+{
+	++loadoutChanges;
+}
+
+
+
+void Ship::FinishLoadoutChange()
+{
+	if(!loadoutChanges || --loadoutChanges)
+		return;
+
+	if(staleDeterrence)
+		deterrence = CalculateDeterrence();
+	if(staleAttraction)
+		attraction = CalculateAttraction();
+	if(staleDrives)
+		navigation.Calibrate(*this);
+	else if(staleNavigation)
+		navigation.Recalibrate(*this);
+	staleAttraction = false;
+	staleDeterrence = false;
+	staleNavigation = false;
+	staleDrives = false;
+	++loadoutVersion;
+}
+
+
+
 // Get the list of weapons.
 Armament &Ship::GetArmament()
 {
@@ -3125,13 +3236,13 @@ bool Ship::CanFire(const Weapon *weapon) const
 			return false;
 	}
 
-	if(energy < weapon->FiringEnergy() + weapon->RelativeFiringEnergy() * attributes.Get("energy capacity"))
+	if(energy < weapon->FiringEnergy() + weapon->RelativeFiringEnergy() * attributes.Get(AttributeKey::ENERGY_CAPACITY))
 		return false;
-	if(fuel < weapon->FiringFuel() + weapon->RelativeFiringFuel() * attributes.Get("fuel capacity"))
+	if(fuel < weapon->FiringFuel() + weapon->RelativeFiringFuel() * attributes.Get(AttributeKey::FUEL_CAPACITY))
 		return false;
 	// We do check hull, but we don't check shields. Ships can survive with all shields depleted.
 	// Ships should not disable themselves, so we check if we stay above minimumHull.
-	if(hull - MinimumHull() < weapon->FiringHull() + weapon->RelativeFiringHull() * attributes.Get("hull"))
+	if(hull - MinimumHull() < weapon->FiringHull() + weapon->RelativeFiringHull() * attributes.Get(AttributeKey::HULL))
 		return false;
 
 	// If a weapon requires heat to fire, (rather than generating heat), we must
@@ -3159,11 +3270,11 @@ void Ship::ExpendAmmo(const Weapon &weapon)
 {
 	// Compute this ship's initial capacities, in case the consumption of the ammunition outfit(s)
 	// modifies them, so that relative costs are calculated based on the pre-firing state of the ship.
-	const double relativeEnergyChange = weapon.RelativeFiringEnergy() * attributes.Get("energy capacity");
-	const double relativeFuelChange = weapon.RelativeFiringFuel() * attributes.Get("fuel capacity");
+	const double relativeEnergyChange = weapon.RelativeFiringEnergy() * attributes.Get(AttributeKey::ENERGY_CAPACITY);
+	const double relativeFuelChange = weapon.RelativeFiringFuel() * attributes.Get(AttributeKey::FUEL_CAPACITY);
 	const double relativeHeatChange = !weapon.RelativeFiringHeat() ? 0. : weapon.RelativeFiringHeat() * MaximumHeat();
-	const double relativeHullChange = weapon.RelativeFiringHull() * attributes.Get("hull");
-	const double relativeShieldChange = weapon.RelativeFiringShields() * attributes.Get("shields");
+	const double relativeHullChange = weapon.RelativeFiringHull() * attributes.Get(AttributeKey::HULL);
+	const double relativeShieldChange = weapon.RelativeFiringShields() * attributes.Get(AttributeKey::SHIELDS);
 
 	if(const Outfit *ammo = weapon.Ammo())
 	{
@@ -3230,16 +3341,16 @@ const System *Ship::GetTargetSystem() const
 
 
 // Mining target.
-shared_ptr<Minable> Ship::GetTargetAsteroid() const
+PoolHandle<Minable> Ship::GetTargetAsteroid() const
 {
-	return targetAsteroid.lock();
+	return targetAsteroid;
 }
 
 
 
-shared_ptr<Flotsam> Ship::GetTargetFlotsam() const
+PoolHandle<Flotsam> Ship::GetTargetFlotsam() const
 {
-	return targetFlotsam.lock();
+	return targetFlotsam;
 }
 
 
@@ -3261,7 +3372,7 @@ void Ship::SetTargetShip(const shared_ptr<Ship> &ship)
 		cargoScan = 0.;
 		outfitScan = 0.;
 	}
-	targetAsteroid.reset();
+	targetAsteroid = PoolHandle<Minable>();
 }
 
 
@@ -3288,7 +3399,7 @@ void Ship::SetTargetSystem(const System *system)
 
 
 // Mining target.
-void Ship::SetTargetAsteroid(const shared_ptr<Minable> &asteroid)
+void Ship::SetTargetAsteroid(const PoolHandle<Minable> &asteroid)
 {
 	targetAsteroid = asteroid;
 	targetShip.reset();
@@ -3296,7 +3407,7 @@ void Ship::SetTargetAsteroid(const shared_ptr<Minable> &asteroid)
 
 
 
-void Ship::SetTargetFlotsam(const shared_ptr<Flotsam> &flotsam)
+void Ship::SetTargetFlotsam(const PoolHandle<Flotsam> &flotsam)
 {
 	targetFlotsam = flotsam;
 }
@@ -3381,7 +3492,7 @@ bool Ship::StepFlags()
 
 // Step ship destruction logic. Returns 1 if the ship has been destroyed, -1 if it is being
 // destroyed, or 0 otherwise.
-int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
+int Ship::StepDestroyed(vector<Visual> &visuals, vector<Particle> &particles, vector<Flotsam> &flotsam)
 {
 	if(!IsDestroyed())
 		return 0;
@@ -3390,7 +3501,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 	shields = 0.;
 
 	// Once we've created enough little explosions, die.
-	if(explosionCount == explosionTotal || forget)
+	if(explosionCount == chassis->explosionTotal || forget)
 	{
 		if(IsYours() && Preferences::Has("Extra fleet status messages"))
 			Messages::Add("Your ship \"" + Name() + "\" has been destroyed.", Messages::Importance::Highest);
@@ -3404,7 +3515,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 			int debrisCount = attributes.Mass() * .07;
 
 			// Estimate how many new visuals will be added during destruction.
-			visuals.reserve(visuals.size() + debrisCount + explosionTotal + finalExplosions.size());
+			visuals.reserve(visuals.size() + debrisCount + chassis->explosionTotal + chassis->finalExplosions.size());
 
 			for(int i = 0; i < debrisCount; ++i)
 			{
@@ -3415,9 +3526,9 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 				visuals.emplace_back(*effect, std::move(effectPosition), std::move(effectVelocity), std::move(angle));
 			}
 
-			for(unsigned i = 0; i < explosionTotal / 2; ++i)
+			for(unsigned i = 0; i < chassis->explosionTotal / 2; ++i)
 				CreateExplosion(visuals, true);
-			for(const auto &it : finalExplosions)
+			for(const auto &it : chassis->finalExplosions)
 				visuals.emplace_back(*it.first, position, velocity, angle);
 			// For everything in this ship's cargo hold there is a 25% chance
 			// that it will survive as flotsam.
@@ -3428,7 +3539,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 			// Ammunition has a default 5% chance to survive as flotsam.
 			for(const auto &it : outfits)
 			{
-				double flotsamChance = it.first->Get("flotsam chance");
+				double flotsamChance = it.first->Get(AttributeKey::FLOTSAM_CHANCE);
 				if(flotsamChance > 0.)
 					Jettison(it.first, Random::Binomial(it.second, flotsamChance));
 				// 0 valued 'flotsamChance' means default, which is 5% for ammunition.
@@ -3438,9 +3549,12 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 				else if(it.first->Category() == "Ammunition" && !flotsamChance)
 					Jettison(it.first, Random::Binomial(it.second, .05));
 			}
-			for(shared_ptr<Flotsam> &it : jettisoned)
-				it->Place(*this);
-			flotsam.splice(flotsam.end(), jettisoned);
+			for(Flotsam &it : jettisoned)
+			{
+				it.Place(*this);
+				flotsam.push_back(std::move(it));
+			}
+			jettisoned.clear();
 
 			// Any ships that failed to launch from this ship are destroyed.
 			for(Bay &bay : bays)
@@ -3464,7 +3578,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 		CreateExplosion(visuals);
 
 	// Handle hull "leaks."
-	for(const Leak &leak : leaks)
+	for(const Leak &leak : chassis->leaks)
 		if(GetMask().IsLoaded() && leak.openPeriod > 0 && !Random::Int(leak.openPeriod))
 		{
 			activeLeaks.push_back(leak);
@@ -3473,7 +3587,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 			int i = Random::Int(outline.size() - 1);
 
 			// Position the leak along the outline of the ship, facing "outward."
-			activeLeaks.back().location = (outline[i] + outline[i + 1]) * .5;
+			activeLeaks.back().location = (outline[i] + outline[i + 1]) * (.5 * GetMask().Scale());
 			activeLeaks.back().angle = Angle(outline[i] - outline[i + 1]) + Angle(90.);
 		}
 	for(Leak &leak : activeLeaks)
@@ -3481,7 +3595,7 @@ int Ship::StepDestroyed(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flot
 		{
 			// Leaks always "flicker" every other frame.
 			if(Random::Int(2))
-				visuals.emplace_back(*leak.effect,
+				particles.emplace_back(*leak.effect,
 					angle.Rotate(leak.location) + position,
 					velocity,
 					leak.angle + angle);
@@ -3513,29 +3627,30 @@ void Ship::DoGeneration()
 		// 4. Shields of carried fighters
 		// 5. Transfer of excess energy and fuel to carried fighters.
 
-		const double hullAvailable = attributes.Get("hull repair rate")
-			* (1. + attributes.Get("hull repair multiplier"));
-		const double hullEnergy = (attributes.Get("hull energy")
-			* (1. + attributes.Get("hull energy multiplier"))) / hullAvailable;
-		const double hullFuel = (attributes.Get("hull fuel")
-			* (1. + attributes.Get("hull fuel multiplier"))) / hullAvailable;
-		const double hullHeat = (attributes.Get("hull heat")
-			* (1. + attributes.Get("hull heat multiplier"))) / hullAvailable;
+		const double hullAvailable = attributes.Get(AttributeKey::HULL_REPAIR_RATE)
+			* (1. + attributes.Get(AttributeKey::HULL_REPAIR_MULTIPLIER));
+		const double hullEnergy = (attributes.Get(AttributeKey::HULL_ENERGY)
+			* (1. + attributes.Get(AttributeKey::HULL_ENERGY_MULTIPLIER))) / hullAvailable;
+		const double hullFuel = (attributes.Get(AttributeKey::HULL_FUEL)
+			* (1. + attributes.Get(AttributeKey::HULL_FUEL_MULTIPLIER))) / hullAvailable;
+		const double hullHeat = (attributes.Get(AttributeKey::HULL_HEAT)
+			* (1. + attributes.Get(AttributeKey::HULL_HEAT_MULTIPLIER))) / hullAvailable;
 		double hullRemaining = hullAvailable;
 		if(!hullDelay)
-			DoRepair(hull, hullRemaining, attributes.Get("hull"), energy, hullEnergy, fuel, hullFuel, heat, hullHeat);
-
-		const double shieldsAvailable = attributes.Get("shield generation")
-			* (1. + attributes.Get("shield generation multiplier"));
-		const double shieldsEnergy = (attributes.Get("shield energy")
-			* (1. + attributes.Get("shield energy multiplier"))) / shieldsAvailable;
-		const double shieldsFuel = (attributes.Get("shield fuel")
-			* (1. + attributes.Get("shield fuel multiplier"))) / shieldsAvailable;
-		const double shieldsHeat = (attributes.Get("shield heat")
-			* (1. + attributes.Get("shield heat multiplier"))) / shieldsAvailable;
+			DoRepair(hull, hullRemaining, attributes.Get(AttributeKey::HULL),
+				energy, hullEnergy, fuel, hullFuel, heat, hullHeat);
+
+		const double shieldsAvailable = attributes.Get(AttributeKey::SHIELD_GENERATION)
+			* (1. + attributes.Get(AttributeKey::SHIELD_GENERATION_MULTIPLIER));
+		const double shieldsEnergy = (attributes.Get(AttributeKey::SHIELD_ENERGY)
+			* (1. + attributes.Get(AttributeKey::SHIELD_ENERGY_MULTIPLIER))) / shieldsAvailable;
+		const double shieldsFuel = (attributes.Get(AttributeKey::SHIELD_FUEL)
+			* (1. + attributes.Get(AttributeKey::SHIELD_FUEL_MULTIPLIER))) / shieldsAvailable;
+		const double shieldsHeat = (attributes.Get(AttributeKey::SHIELD_HEAT)
+			* (1. + attributes.Get(AttributeKey::SHIELD_HEAT_MULTIPLIER))) / shieldsAvailable;
 		double shieldsRemaining = shieldsAvailable;
 		if(!shieldDelay)
-			DoRepair(shields, shieldsRemaining, attributes.Get("shields"),
+			DoRepair(shields, shieldsRemaining, attributes.Get(AttributeKey::SHIELDS),
 				energy, shieldsEnergy, fuel, shieldsFuel, heat, shieldsHeat);
 
 		if(!bays.empty())
@@ -3560,24 +3675,24 @@ void Ship::DoGeneration()
 			{
 				Ship &ship = *it.second;
 				if(!hullDelay)
-					DoRepair(ship.hull, hullRemaining, ship.attributes.Get("hull"),
+					DoRepair(ship.hull, hullRemaining, ship.attributes.Get(AttributeKey::HULL),
 						energy, hullEnergy, heat, hullHeat, fuel, hullFuel);
 				if(!shieldDelay)
-					DoRepair(ship.shields, shieldsRemaining, ship.attributes.Get("shields"),
+					DoRepair(ship.shields, shieldsRemaining, ship.attributes.Get(AttributeKey::SHIELDS),
 						energy, shieldsEnergy, heat, shieldsHeat, fuel, shieldsFuel);
 			}
 
 			// Now that there is no more need to use energy for hull and shield
 			// repair, if there is still excess energy, transfer it.
-			double energyRemaining = energy - attributes.Get("energy capacity");
-			double fuelRemaining = fuel - attributes.Get("fuel capacity");
+			double energyRemaining = energy - attributes.Get(AttributeKey::ENERGY_CAPACITY);
+			double fuelRemaining = fuel - attributes.Get(AttributeKey::FUEL_CAPACITY);
 			for(const pair<double, Ship *> &it : carried)
 			{
 				Ship &ship = *it.second;
 				if(energyRemaining > 0.)
-					DoRepair(ship.energy, energyRemaining, ship.attributes.Get("energy capacity"));
+					DoRepair(ship.energy, energyRemaining, ship.attributes.Get(AttributeKey::ENERGY_CAPACITY));
 				if(fuelRemaining > 0.)
-					DoRepair(ship.fuel, fuelRemaining, ship.attributes.Get("fuel capacity"));
+					DoRepair(ship.fuel, fuelRemaining, ship.attributes.Get(AttributeKey::FUEL_CAPACITY));
 			}
 		}
 		// Decrease the shield and hull delays by 1 now that shield generation
@@ -3595,80 +3710,80 @@ void Ship::DoGeneration()
 	// TODO: Mothership gives status resistance to carried ships?
 	if(ionization)
 	{
-		double ionResistance = attributes.Get("ion resistance");
-		double ionEnergy = attributes.Get("ion resistance energy") / ionResistance;
-		double ionFuel = attributes.Get("ion resistance fuel") / ionResistance;
-		double ionHeat = attributes.Get("ion resistance heat") / ionResistance;
+		double ionResistance = attributes.Get(AttributeKey::ION_RESISTANCE);
+		double ionEnergy = attributes.Get(AttributeKey::ION_RESISTANCE_ENERGY) / ionResistance;
+		double ionFuel = attributes.Get(AttributeKey::ION_RESISTANCE_FUEL) / ionResistance;
+		double ionHeat = attributes.Get(AttributeKey::ION_RESISTANCE_HEAT) / ionResistance;
 		DoStatusEffect(isDisabled, ionization, ionResistance,
 			energy, ionEnergy, fuel, ionFuel, heat, ionHeat);
 	}
 
 	if(scrambling)
 	{
-		double scramblingResistance = attributes.Get("scramble resistance");
-		double scramblingEnergy = attributes.Get("scramble resistance energy") / scramblingResistance;
-		double scramblingFuel = attributes.Get("scramble resistance fuel") / scramblingResistance;
-		double scramblingHeat = attributes.Get("scramble resistance heat") / scramblingResistance;
+		double scramblingResistance = attributes.Get(AttributeKey::SCRAMBLE_RESISTANCE);
+		double scramblingEnergy = attributes.Get(AttributeKey::SCRAMBLE_RESISTANCE_ENERGY) / scramblingResistance;
+		double scramblingFuel = attributes.Get(AttributeKey::SCRAMBLE_RESISTANCE_FUEL) / scramblingResistance;
+		double scramblingHeat = attributes.Get(AttributeKey::SCRAMBLE_RESISTANCE_HEAT) / scramblingResistance;
 		DoStatusEffect(isDisabled, scrambling, scramblingResistance,
 			energy, scramblingEnergy, fuel, scramblingFuel, heat, scramblingHeat);
 	}
 
 	if(disruption)
 	{
-		double disruptionResistance = attributes.Get("disruption resistance");
-		double disruptionEnergy = attributes.Get("disruption resistance energy") / disruptionResistance;
-		double disruptionFuel = attributes.Get("disruption resistance fuel") / disruptionResistance;
-		double disruptionHeat = attributes.Get("disruption resistance heat") / disruptionResistance;
+		double disruptionResistance = attributes.Get(AttributeKey::DISRUPTION_RESISTANCE);
+		double disruptionEnergy = attributes.Get(AttributeKey::DISRUPTION_RESISTANCE_ENERGY) / disruptionResistance;
+		double disruptionFuel = attributes.Get(AttributeKey::DISRUPTION_RESISTANCE_FUEL) / disruptionResistance;
+		double disruptionHeat = attributes.Get(AttributeKey::DISRUPTION_RESISTANCE_HEAT) / disruptionResistance;
 		DoStatusEffect(isDisabled, disruption, disruptionResistance,
 			energy, disruptionEnergy, fuel, disruptionFuel, heat, disruptionHeat);
 	}
 
 	if(slowness)
 	{
-		double slowingResistance = attributes.Get("slowing resistance");
-		double slowingEnergy = attributes.Get("slowing resistance energy") / slowingResistance;
-		double slowingFuel = attributes.Get("slowing resistance fuel") / slowingResistance;
-		double slowingHeat = attributes.Get("slowing resistance heat") / slowingResistance;
+		double slowingResistance = attributes.Get(AttributeKey::SLOWING_RESISTANCE);
+		double slowingEnergy = attributes.Get(AttributeKey::SLOWING_RESISTANCE_ENERGY) / slowingResistance;
+		double slowingFuel = attributes.Get(AttributeKey::SLOWING_RESISTANCE_FUEL) / slowingResistance;
+		double slowingHeat = attributes.Get(AttributeKey::SLOWING_RESISTANCE_HEAT) / slowingResistance;
 		DoStatusEffect(isDisabled, slowness, slowingResistance,
 			energy, slowingEnergy, fuel, slowingFuel, heat, slowingHeat);
 	}
 
 	if(discharge)
 	{
-		double dischargeResistance = attributes.Get("discharge resistance");
-		double dischargeEnergy = attributes.Get("discharge resistance energy") / dischargeResistance;
-		double dischargeFuel = attributes.Get("discharge resistance fuel") / dischargeResistance;
-		double dischargeHeat = attributes.Get("discharge resistance heat") / dischargeResistance;
+		double dischargeResistance = attributes.Get(AttributeKey::DISCHARGE_RESISTANCE);
+		double dischargeEnergy = attributes.Get(AttributeKey::DISCHARGE_RESISTANCE_ENERGY) / dischargeResistance;
+		double dischargeFuel = attributes.Get(AttributeKey::DISCHARGE_RESISTANCE_FUEL) / dischargeResistance;
+		double dischargeHeat = attributes.Get(AttributeKey::DISCHARGE_RESISTANCE_HEAT) / dischargeResistance;
 		DoStatusEffect(isDisabled, discharge, dischargeResistance,
 			energy, dischargeEnergy, fuel, dischargeFuel, heat, dischargeHeat);
 	}
 
 	if(corrosion)
 	{
-		double corrosionResistance = attributes.Get("corrosion resistance");
-		double corrosionEnergy = attributes.Get("corrosion resistance energy") / corrosionResistance;
-		double corrosionFuel = attributes.Get("corrosion resistance fuel") / corrosionResistance;
-		double corrosionHeat = attributes.Get("corrosion resistance heat") / corrosionResistance;
+		double corrosionResistance = attributes.Get(AttributeKey::CORROSION_RESISTANCE);
+		double corrosionEnergy = attributes.Get(AttributeKey::CORROSION_RESISTANCE_ENERGY) / corrosionResistance;
+		double corrosionFuel = attributes.Get(AttributeKey::CORROSION_RESISTANCE_FUEL) / corrosionResistance;
+		double corrosionHeat = attributes.Get(AttributeKey::CORROSION_RESISTANCE_HEAT) / corrosionResistance;
 		DoStatusEffect(isDisabled, corrosion, corrosionResistance,
 			energy, corrosionEnergy, fuel, corrosionFuel, heat, corrosionHeat);
 	}
 
 	if(leakage)
 	{
-		double leakResistance = attributes.Get("leak resistance");
-		double leakEnergy = attributes.Get("leak resistance energy") / leakResistance;
-		double leakFuel = attributes.Get("leak resistance fuel") / leakResistance;
-		double leakHeat = attributes.Get("leak resistance heat") / leakResistance;
+		double leakResistance = attributes.Get(AttributeKey::LEAK_RESISTANCE);
+		double leakEnergy = attributes.Get(AttributeKey::LEAK_RESISTANCE_ENERGY) / leakResistance;
+		double leakFuel = attributes.Get(AttributeKey::LEAK_RESISTANCE_FUEL) / leakResistance;
+		double leakHeat = attributes.Get(AttributeKey::LEAK_RESISTANCE_HEAT) / leakResistance;
 		DoStatusEffect(isDisabled, leakage, leakResistance,
 			energy, leakEnergy, fuel, leakFuel, heat, leakHeat);
 	}
 
 	if(burning)
 	{
-		double burnResistance = attributes.Get("burn resistance");
-		double burnEnergy = attributes.Get("burn resistance energy") / burnResistance;
-		double burnFuel = attributes.Get("burn resistance fuel") / burnResistance;
-		double burnHeat = attributes.Get("burn resistance heat") / burnResistance;
+		double burnResistance = attributes.Get(AttributeKey::BURN_RESISTANCE);
+		double burnEnergy = attributes.Get(AttributeKey::BURN_RESISTANCE_ENERGY) / burnResistance;
+		double burnFuel = attributes.Get(AttributeKey::BURN_RESISTANCE_FUEL) / burnResistance;
+		double burnHeat = attributes.Get(AttributeKey::BURN_RESISTANCE_HEAT) / burnResistance;
 		DoStatusEffect(isDisabled, burning, burnResistance,
 			energy, burnEnergy, fuel, burnFuel, heat, burnHeat);
 	}
@@ -3677,23 +3792,23 @@ void Ship::DoGeneration()
 	// maximum capacity for the rest of the turn, but must be clamped to the
 	// maximum here before they gain more. This is so that, for example, a ship
 	// with no batteries but a good generator can still move.
-	energy = min(energy, attributes.Get("energy capacity"));
-	fuel = min(fuel, attributes.Get("fuel capacity"));
+	energy = min(energy, attributes.Get(AttributeKey::ENERGY_CAPACITY));
+	fuel = min(fuel, attributes.Get(AttributeKey::FUEL_CAPACITY));
 
 	heat -= heat * HeatDissipation();
 	if(heat > MaximumHeat())
 	{
 		isOverheated = true;
-		double heatRatio = Heat() / (1. + attributes.Get("overheat damage threshold"));
+		double heatRatio = Heat() / (1. + attributes.Get(AttributeKey::OVERHEAT_DAMAGE_THRESHOLD));
 		if(heatRatio > 1.)
-			hull -= attributes.Get("overheat damage rate") * heatRatio;
+			hull -= attributes.Get(AttributeKey::OVERHEAT_DAMAGE_RATE) * heatRatio;
 	}
 	else if(heat < .9 * MaximumHeat())
 		isOverheated = false;
 
-	double maxShields = attributes.Get("shields");
+	double maxShields = attributes.Get(AttributeKey::SHIELDS);
 	shields = min(shields, maxShields);
-	double maxHull = attributes.Get("hull");
+	double maxHull = attributes.Get(AttributeKey::HULL);
 	hull = min(hull, maxHull);
 
 	isDisabled = isOverheated || hull < MinimumHull() || (!crew && RequiredCrew());
@@ -3708,35 +3823,35 @@ void Ship::DoGeneration()
 		if(currentSystem)
 		{
 			double scale = .2 + 1.8 / (.001 * position.Length() + 1);
-			fuel += currentSystem->RamscoopFuel(attributes.Get("ramscoop"), scale);
+			fuel += currentSystem->RamscoopFuel(attributes.Get(AttributeKey::RAMSCOOP), scale);
 
 			double solarScaling = currentSystem->SolarPower() * scale;
-			energy += solarScaling * attributes.Get("solar collection");
-			heat += solarScaling * attributes.Get("solar heat");
+			energy += solarScaling * attributes.Get(AttributeKey::SOLAR_COLLECTION);
+			heat += solarScaling * attributes.Get(AttributeKey::SOLAR_HEAT);
 		}
 
 		double coolingEfficiency = CoolingEfficiency();
-		energy += attributes.Get("energy generation") - attributes.Get("energy consumption");
-		fuel += attributes.Get("fuel generation");
-		heat += attributes.Get("heat generation");
-		heat -= coolingEfficiency * attributes.Get("cooling");
+		energy += attributes.Get(AttributeKey::ENERGY_GENERATION) - attributes.Get(AttributeKey::ENERGY_CONSUMPTION);
+		fuel += attributes.Get(AttributeKey::FUEL_GENERATION);
+		heat += attributes.Get(AttributeKey::HEAT_GENERATION);
+		heat -= coolingEfficiency * attributes.Get(AttributeKey::COOLING);
 
 		// Convert fuel into energy and heat only when the required amount of fuel is available.
-		if(attributes.Get("fuel consumption") <= fuel)
+		if(attributes.Get(AttributeKey::FUEL_CONSUMPTION) <= fuel)
 		{
-			fuel -= attributes.Get("fuel consumption");
-			energy += attributes.Get("fuel energy");
-			heat += attributes.Get("fuel heat");
+			fuel -= attributes.Get(AttributeKey::FUEL_CONSUMPTION);
+			energy += attributes.Get(AttributeKey::FUEL_ENERGY);
+			heat += attributes.Get(AttributeKey::FUEL_HEAT);
 		}
 
 		// Apply active cooling. The fraction of full cooling to apply equals
 		// your ship's current fraction of its maximum temperature.
-		double activeCooling = coolingEfficiency * attributes.Get("active cooling");
+		double activeCooling = coolingEfficiency * attributes.Get(AttributeKey::ACTIVE_COOLING);
 		if(activeCooling > 0. && heat > 0. && energy >= 0.)
 		{
 			// Handle the case where "active cooling"
 			// does not require any energy.
-			double coolingEnergy = attributes.Get("cooling energy");
+			double coolingEnergy = attributes.Get(AttributeKey::COOLING_ENERGY);
 			if(coolingEnergy)
 			{
 				double spentEnergy = min(energy, coolingEnergy * min(1., Heat()));
@@ -3757,39 +3872,40 @@ void Ship::DoGeneration()
 
 
 
-void Ship::DoPassiveEffects(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam)
+void Ship::DoPassiveEffects(vector<Particle> &particles, vector<Flotsam> &flotsam)
 {
 	// Adjust the error in the pilot's targeting.
 	personality.UpdateConfusion(firingCommands.IsFiring());
 
 	// Handle ionization effects, etc.
 	if(ionization)
-		CreateSparks(visuals, "ion spark", ionization * .05);
+		CreateSparks(particles, "ion spark", ionization * .05);
 	if(scrambling)
-		CreateSparks(visuals, "scramble spark", scrambling * .05);
+		CreateSparks(particles, "scramble spark", scrambling * .05);
 	if(disruption)
-		CreateSparks(visuals, "disruption spark", disruption * .1);
+		CreateSparks(particles, "disruption spark", disruption * .1);
 	if(slowness)
-		CreateSparks(visuals, "slowing spark", slowness * .1);
+		CreateSparks(particles, "slowing spark", slowness * .1);
 	if(discharge)
-		CreateSparks(visuals, "discharge spark", discharge * .1);
+		CreateSparks(particles, "discharge spark", discharge * .1);
 	if(corrosion)
-		CreateSparks(visuals, "corrosion spark", corrosion * .1);
+		CreateSparks(particles, "corrosion spark", corrosion * .1);
 	if(leakage)
-		CreateSparks(visuals, "leakage spark", leakage * .1);
+		CreateSparks(particles, "leakage spark", leakage * .1);
 	if(burning)
-		CreateSparks(visuals, "burning spark", burning * .1);
+		CreateSparks(particles, "burning spark", burning * .1);
 }
 
 
 
-void Ship::DoJettison(list<shared_ptr<Flotsam>> &flotsam)
+void Ship::DoJettison(vector<Flotsam> &flotsam)
 {
 	// Jettisoned cargo effects (only for ships in the current system).
 	if(!jettisoned.empty() && !forget)
 	{
-		jettisoned.front()->Place(*this);
-		flotsam.splice(flotsam.end(), jettisoned, jettisoned.begin());
+		jettisoned.front().Place(*this);
+		flotsam.push_back(std::move(jettisoned.front()));
+		jettisoned.pop_front();
 	}
 }
 
@@ -3805,17 +3921,17 @@ void Ship::DoCloakDecision()
 	if(!cloak)
 		cloakDisruption = max(0., cloakDisruption - 1.);
 
-	double cloakingSpeed = attributes.Get("cloak");
+	double cloakingSpeed = attributes.Get(AttributeKey::CLOAK);
 	bool canCloak = (!isDisabled && cloakingSpeed > 0. && !cloakDisruption
-		&& fuel >= attributes.Get("cloaking fuel")
-		&& energy >= attributes.Get("cloaking energy"));
+		&& fuel >= attributes.Get(AttributeKey::CLOAKING_FUEL)
+		&& energy >= attributes.Get(AttributeKey::CLOAKING_ENERGY));
 
 	if(commands.Has(Command::CLOAK) && canCloak)
 	{
 		cloak = min(1., cloak + cloakingSpeed);
-		fuel -= attributes.Get("cloaking fuel");
-		energy -= attributes.Get("cloaking energy");
-		heat += attributes.Get("cloaking heat");
+		fuel -= attributes.Get(AttributeKey::CLOAKING_FUEL);
+		energy -= attributes.Get(AttributeKey::CLOAKING_ENERGY);
+		heat += attributes.Get(AttributeKey::CLOAKING_HEAT);
 	}
 	else if(cloakingSpeed)
 	{
@@ -3832,7 +3948,21 @@ void Ship::DoCloakDecision()
 
 
 
-bool Ship::DoHyperspaceLogic(vector<Visual> &visuals)
+void Ship::UpdateFrameStats()
+{
+	frameStats.inertialMass = InertialMass();
+	frameStats.drag = Drag();
+	frameStats.turnRate = TurnRate();
+	frameStats.acceleration = Acceleration();
+	frameStats.maxVelocity = MaxVelocity();
+	frameStats.reverseAcceleration = ReverseAcceleration();
+	frameStats.maxReverseVelocity = MaxReverseVelocity();
+	frameStats.slowMultiplier = 1. / (1. + slowness * .05);
+}
+
+
+
+bool Ship::DoHyperspaceLogic(vector<Particle> &particles)
 {
 	if(!hyperspaceSystem && !hyperspaceCount)
 		return false;
@@ -3858,13 +3988,13 @@ bool Ship::DoHyperspaceLogic(vector<Visual> &visuals)
 		double sparkAmount = hyperspaceCount * Width() * Height() * .000006;
 		const map<const Effect *, int> &jumpEffects = attributes.JumpEffects();
 		if(jumpEffects.empty())
-			CreateSparks(visuals, "jump drive", sparkAmount);
+			CreateSparks(particles, "jump drive", sparkAmount);
 		else
 		{
 			// Spread the amount of particle effects created among all jump effects.
 			sparkAmount /= jumpEffects.size();
 			for(const auto &effect : jumpEffects)
-				CreateSparks(visuals, effect.first, sparkAmount);
+				CreateSparks(particles, effect.first, sparkAmount);
 		}
 	}
 
@@ -3943,9 +4073,9 @@ bool Ship::DoHyperspaceLogic(vector<Visual> &visuals)
 			// is, about acos(.8) from the proper angle). So:
 			// Stopping distance = .5*a*(v/a)^2 + (150/turn)*v.
 			// Exit distance = HYPER_D + .25 * v^2 = stopping distance.
-			double exitV = max(HYPER_A, MaxVelocity());
-			double a = (.5 / Acceleration() - .25);
-			double b = 150. / TurnRate();
+			double exitV = max(HYPER_A, frameStats.maxVelocity);
+			double a = (.5 / frameStats.acceleration - .25);
+			double b = 150. / frameStats.turnRate;
 			double discriminant = b * b - 4. * a * -HYPER_D;
 			if(discriminant > 0.)
 			{
@@ -3990,7 +4120,7 @@ bool Ship::DoLandingLogic()
 	if(isDisabled)
 		landingPlanet = nullptr;
 
-	float landingSpeed = attributes.Get("landing speed");
+	float landingSpeed = attributes.Get(AttributeKey::LANDING_SPEED);
 	landingSpeed = landingSpeed > 0 ? landingSpeed : .02f;
 	// Special ships do not disappear forever when they land; they
 	// just slowly refuel.
@@ -4025,7 +4155,7 @@ bool Ship::DoLandingLogic()
 		}
 	}
 	// Only refuel if this planet has a spaceport.
-	else if(fuel >= attributes.Get("fuel capacity")
+	else if(fuel >= attributes.Get(AttributeKey::FUEL_CAPACITY)
 			|| !landingPlanet || !landingPlanet->HasSpaceport())
 	{
 		zoom = min(1.f, zoom + landingSpeed);
@@ -4033,7 +4163,7 @@ bool Ship::DoLandingLogic()
 		landingPlanet = nullptr;
 	}
 	else
-		fuel = min(fuel + 1., attributes.Get("fuel capacity"));
+		fuel = min(fuel + 1., attributes.Get(AttributeKey::FUEL_CAPACITY));
 
 	// Move the ship at the velocity it had when it began landing, but
 	// scaled based on how small it is now.
@@ -4101,33 +4231,33 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 {
 	isUsingAfterburner = false;
 
-	double mass = InertialMass();
-	double slowMultiplier = 1. / (1. + slowness * .05);
+	double mass = frameStats.inertialMass;
+	double slowMultiplier = frameStats.slowMultiplier;
 
 	if(isDisabled)
-		velocity *= 1. - Drag() / mass;
+		velocity *= 1. - frameStats.drag / mass;
 	else if(!pilotError)
 	{
 		if(commands.Turn())
 		{
 			// Check if we are able to turn.
-			double cost = attributes.Get("turning energy");
+			double cost = attributes.Get(AttributeKey::TURNING_ENERGY);
 			if(cost > 0. && energy < cost * fabs(commands.Turn()))
 				commands.SetTurn(commands.Turn() * energy / (cost * fabs(commands.Turn())));
 
-			cost = attributes.Get("turning shields");
+			cost = attributes.Get(AttributeKey::TURNING_SHIELDS);
 			if(cost > 0. && shields < cost * fabs(commands.Turn()))
 				commands.SetTurn(commands.Turn() * shields / (cost * fabs(commands.Turn())));
 
-			cost = attributes.Get("turning hull");
+			cost = attributes.Get(AttributeKey::TURNING_HULL);
 			if(cost > 0. && hull < cost * fabs(commands.Turn()))
 				commands.SetTurn(commands.Turn() * hull / (cost * fabs(commands.Turn())));
 
-			cost = attributes.Get("turning fuel");
+			cost = attributes.Get(AttributeKey::TURNING_FUEL);
 			if(cost > 0. && fuel < cost * fabs(commands.Turn()))
 				commands.SetTurn(commands.Turn() * fuel / (cost * fabs(commands.Turn())));
 
-			cost = -attributes.Get("turning heat");
+			cost = -attributes.Get(AttributeKey::TURNING_HEAT);
 			if(cost > 0. && heat < cost * fabs(commands.Turn()))
 				commands.SetTurn(commands.Turn() * heat / (cost * fabs(commands.Turn())));
 
@@ -4140,21 +4270,21 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				// of the turning energy and produce a fraction of the heat.
 				double scale = fabs(commands.Turn());
 
-				shields -= scale * attributes.Get("turning shields");
-				hull -= scale * attributes.Get("turning hull");
-				energy -= scale * attributes.Get("turning energy");
-				fuel -= scale * attributes.Get("turning fuel");
-				heat += scale * attributes.Get("turning heat");
-				discharge += scale * attributes.Get("turning discharge");
-				corrosion += scale * attributes.Get("turning corrosion");
-				ionization += scale * attributes.Get("turning ion");
-				scrambling += scale * attributes.Get("turning scramble");
-				leakage += scale * attributes.Get("turning leakage");
-				burning += scale * attributes.Get("turning burn");
-				slowness += scale * attributes.Get("turning slowing");
-				disruption += scale * attributes.Get("turning disruption");
-
-				angle += commands.Turn() * TurnRate() * slowMultiplier;
+				shields -= scale * attributes.Get(AttributeKey::TURNING_SHIELDS);
+				hull -= scale * attributes.Get(AttributeKey::TURNING_HULL);
+				energy -= scale * attributes.Get(AttributeKey::TURNING_ENERGY);
+				fuel -= scale * attributes.Get(AttributeKey::TURNING_FUEL);
+				heat += scale * attributes.Get(AttributeKey::TURNING_HEAT);
+				discharge += scale * attributes.Get(AttributeKey::TURNING_DISCHARGE);
+				corrosion += scale * attributes.Get(AttributeKey::TURNING_CORROSION);
+				ionization += scale * attributes.Get(AttributeKey::TURNING_ION);
+				scrambling += scale * attributes.Get(AttributeKey::TURNING_SCRAMBLE);
+				leakage += scale * attributes.Get(AttributeKey::TURNING_LEAKAGE);
+				burning += scale * attributes.Get(AttributeKey::TURNING_BURN);
+				slowness += scale * attributes.Get(AttributeKey::TURNING_SLOWING);
+				disruption += scale * attributes.Get(AttributeKey::TURNING_DISRUPTION);
+
+				angle += commands.Turn() * frameStats.turnRate * slowMultiplier;
 			}
 		}
 		double thrustCommand = commands.Has(Command::FORWARD) - commands.Has(Command::BACK);
@@ -4192,7 +4322,7 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				// If a reverse thrust is commanded and the capability does not
 				// exist, ignore it (do not even slow under drag).
 				isThrusting = (thrustCommand > 0.);
-				isReversing = !isThrusting && attributes.Get("reverse thrust");
+				isReversing = !isThrusting && attributes.Get(AttributeKey::REVERSE_THRUST);
 				thrust = attributes.Get(isThrusting ? "thrust" : "reverse thrust");
 				if(thrust)
 				{
@@ -4221,22 +4351,22 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 				&& !CannotAct();
 		if(applyAfterburner)
 		{
-			thrust = attributes.Get("afterburner thrust");
-			double shieldCost = attributes.Get("afterburner shields");
-			double hullCost = attributes.Get("afterburner hull");
-			double energyCost = attributes.Get("afterburner energy");
-			double fuelCost = attributes.Get("afterburner fuel");
-			double heatCost = -attributes.Get("afterburner heat");
-
-			double dischargeCost = attributes.Get("afterburner discharge");
-			double corrosionCost = attributes.Get("afterburner corrosion");
-			double ionCost = attributes.Get("afterburner ion");
-			double scramblingCost = attributes.Get("afterburner scramble");
-			double leakageCost = attributes.Get("afterburner leakage");
-			double burningCost = attributes.Get("afterburner burn");
-
-			double slownessCost = attributes.Get("afterburner slowing");
-			double disruptionCost = attributes.Get("afterburner disruption");
+			thrust = attributes.Get(AttributeKey::AFTERBURNER_THRUST);
+			double shieldCost = attributes.Get(AttributeKey::AFTERBURNER_SHIELDS);
+			double hullCost = attributes.Get(AttributeKey::AFTERBURNER_HULL);
+			double energyCost = attributes.Get(AttributeKey::AFTERBURNER_ENERGY);
+			double fuelCost = attributes.Get(AttributeKey::AFTERBURNER_FUEL);
+			double heatCost = -attributes.Get(AttributeKey::AFTERBURNER_HEAT);
+
+			double dischargeCost = attributes.Get(AttributeKey::AFTERBURNER_DISCHARGE);
+			double corrosionCost = attributes.Get(AttributeKey::AFTERBURNER_CORROSION);
+			double ionCost = attributes.Get(AttributeKey::AFTERBURNER_ION);
+			double scramblingCost = attributes.Get(AttributeKey::AFTERBURNER_SCRAMBLE);
+			double leakageCost = attributes.Get(AttributeKey::AFTERBURNER_LEAKAGE);
+			double burningCost = attributes.Get(AttributeKey::AFTERBURNER_BURN);
+
+			double slownessCost = attributes.Get(AttributeKey::AFTERBURNER_SLOWING);
+			double disruptionCost = attributes.Get(AttributeKey::AFTERBURNER_DISRUPTION);
 
 			if(thrust && shields >= shieldCost && hull >= hullCost
 				&& energy >= energyCost && fuel >= fuelCost && heat >= heatCost)
@@ -4267,7 +4397,7 @@ void Ship::DoMovement(bool &isUsingAfterburner)
 	if(acceleration)
 	{
 		acceleration *= slowMultiplier;
-		Point dragAcceleration = acceleration - velocity * (Drag() / mass);
+		Point dragAcceleration = acceleration - velocity * (frameStats.drag / mass);
 		// Make sure dragAcceleration has nonzero length, to avoid divide by zero.
 		if(dragAcceleration)
 		{
@@ -4307,7 +4437,11 @@ void Ship::StepTargeting()
 	// moment, its boarding target should be its parent ship.
 	if(CanBeCarried() && !(target && target == GetShipToAssist()))
 		target = GetParent();
-	if(target && !isDisabled)
+	// Ships that are not trying to board do not need to look at their target at
+	// all, which also allows them to be moved independently of it.
+	if(target && !isDisabled && !commands.Has(Command::BOARD))
+		isBoarding = false;
+	else if(target && !isDisabled)
 	{
 		Point dp = (target->position - position);
 		double distance = dp.Length();
@@ -4330,11 +4464,11 @@ void Ship::StepTargeting()
 
 			// Check if the ship will still be pointing to the same side of the target
 			// angle if it turns by this amount.
-			facing += TurnRate() * turn;
+			facing += frameStats.turnRate * turn;
 			bool stillLeft = target->Unit().Cross(facing.Unit()) < 0.;
 			if(left != stillLeft)
 				turn = 0.;
-			angle += TurnRate() * turn;
+			angle += frameStats.turnRate * turn;
 
 			velocity += dv.Unit() * .1;
 			position += dp.Unit() * .5;
@@ -4353,7 +4487,7 @@ void Ship::StepTargeting()
 				{
 					isBoarding = false;
 					bool isEnemy = government->IsEnemy(target->government);
-					if(isEnemy && Random::Real() < target->Attributes().Get("self destruct"))
+					if(isEnemy && Random::Real() < target->Attributes().Get(AttributeKey::SELF_DESTRUCT))
 					{
 						Messages::Add("The " + target->ModelName() + " \"" + target->Name()
 							+ "\" has activated its self-destruct mechanism.", Messages::Importance::High);
@@ -4369,24 +4503,24 @@ void Ship::StepTargeting()
 	// Clear your target if it is destroyed. This is only important for NPCs,
 	// because ordinary ships cease to exist once they are destroyed.
 	target = GetTargetShip();
-	if(target && target->IsDestroyed() && target->explosionCount >= target->explosionTotal)
+	if(target && target->IsDestroyed() && target->explosionCount >= target->chassis->explosionTotal)
 		targetShip.reset();
 }
 
 
 
 // Finally, move the ship and create any movement visuals.
-void Ship::DoEngineVisuals(vector<Visual> &visuals, bool isUsingAfterburner)
+void Ship::DoEngineVisuals(vector<Particle> &particles, bool isUsingAfterburner)
 {
 	if(isUsingAfterburner && !Attributes().AfterburnerEffects().empty())
-		for(const EnginePoint &point : enginePoints)
+		for(const EnginePoint &point : chassis->enginePoints)
 		{
 			Point pos = angle.Rotate(point) * Zoom() + position;
 			// Stream the afterburner effects outward in the direction the engines are facing.
 			Point effectVelocity = velocity - 6. * angle.Unit();
 			for(auto &&it : Attributes().AfterburnerEffects())
 				for(int i = 0; i < it.second; ++i)
-					visuals.emplace_back(*it.first, pos, effectVelocity, angle);
+					particles.emplace_back(*it.first, pos, effectVelocity, angle);
 		}
 }
 
@@ -4419,24 +4553,24 @@ double Ship::MinimumHull() const
 	if(neverDisabled)
 		return 0.;
 
-	double maximumHull = attributes.Get("hull");
-	double absoluteThreshold = attributes.Get("absolute threshold");
+	double maximumHull = attributes.Get(AttributeKey::HULL);
+	double absoluteThreshold = attributes.Get(AttributeKey::ABSOLUTE_THRESHOLD);
 	if(absoluteThreshold > 0.)
 		return absoluteThreshold;
 
-	double thresholdPercent = attributes.Get("threshold percentage");
+	double thresholdPercent = attributes.Get(AttributeKey::THRESHOLD_PERCENTAGE);
 	double transition = 1 / (1 + 0.0005 * maximumHull);
 	double minimumHull = maximumHull * (thresholdPercent > 0.
 		? min(thresholdPercent, 1.) : 0.1 * (1. - transition) + 0.5 * transition);
 
-	return max(0., floor(minimumHull + attributes.Get("hull threshold")));
+	return max(0., floor(minimumHull + attributes.Get(AttributeKey::HULL_THRESHOLD)));
 }
 
 
 
 void Ship::CreateExplosion(vector<Visual> &visuals, bool spread)
 {
-	if(!HasSprite() || !GetMask().IsLoaded() || explosionEffects.empty())
+	if(!HasSprite() || !GetMask().IsLoaded() || chassis->explosionEffects.empty())
 		return;
 
 	// Bail out if this loops enough times, just in case.
@@ -4447,9 +4581,9 @@ void Ship::CreateExplosion(vector<Visual> &visuals, bool spread)
 		if(GetMask().Contains(point, Angle()))
 		{
 			// Pick an explosion.
-			int type = Random::Int(explosionTotal);
-			auto it = explosionEffects.begin();
-			for( ; it != explosionEffects.end(); ++it)
+			int type = Random::Int(chassis->explosionTotal);
+			auto it = chassis->explosionEffects.begin();
+			for( ; it != chassis->explosionEffects.end(); ++it)
 			{
 				type -= it->second;
 				if(type < 0)
@@ -4471,14 +4605,14 @@ void Ship::CreateExplosion(vector<Visual> &visuals, bool spread)
 
 
 // Place a "spark" effect, like ionization or disruption.
-void Ship::CreateSparks(vector<Visual> &visuals, const string &name, double amount)
+void Ship::CreateSparks(vector<Particle> &particles, const string &name, double amount)
 {
-	CreateSparks(visuals, GameData::Effects().Get(name), amount);
+	CreateSparks(particles, GameData::Effects().Get(name), amount);
 }
 
 
 
-void Ship::CreateSparks(vector<Visual> &visuals, const Effect *effect, double amount)
+void Ship::CreateSparks(vector<Particle> &particles, const Effect *effect, double amount)
 {
 	if(forget)
 		return;
@@ -4486,7 +4620,7 @@ void Ship::CreateSparks(vector<Visual> &visuals, const Effect *effect, double am
 	// Limit the number of sparks, depending on the size of the sprite.
 	amount = min(amount, Width() * Height() * .0006);
 	// Preallocate capacity, in case we're adding a non-trivial number of sparks.
-	visuals.reserve(visuals.size() + static_cast<int>(amount));
+	particles.reserve(particles.size() + static_cast<int>(amount));
 
 	while(true)
 	{
@@ -4497,7 +4631,7 @@ void Ship::CreateSparks(vector<Visual> &visuals, const Effect *effect, double am
 		Point point((Random::Real() - .5) * Width(),
 			(Random::Real() - .5) * Height());
 		if(GetMask().Contains(point, Angle()))
-			visuals.emplace_back(*effect, angle.Rotate(point) + position, velocity, angle);
+			particles.emplace_back(*effect, angle.Rotate(point) + position, velocity, angle);
 	}
 }
 
@@ -4505,7 +4639,7 @@ void Ship::CreateSparks(vector<Visual> &visuals, const Effect *effect, double am
 
 double Ship::CalculateAttraction() const
 {
-	return max(0., .4 * sqrt(attributes.Get("cargo space")) - 1.8);
+	return max(0., .4 * sqrt(attributes.Get(AttributeKey::CARGO_SPACE)) - 1.8);
 }
 
 
@@ -4520,9 +4654,55 @@ double Ship::CalculateDeterrence() const
 			if(weapon->Ammo() && weapon->AmmoUsage() && !OutfitCount(weapon->Ammo()))
 				continue;
 			double strength = weapon->ShieldDamage() + weapon->HullDamage()
-				+ (weapon->RelativeShieldDamage() * attributes.Get("shields"))
-				+ (weapon->RelativeHullDamage() * attributes.Get("hull"));
+				+ (weapon->RelativeShieldDamage() * attributes.Get(AttributeKey::SHIELDS))
+				+ (weapon->RelativeHullDamage() * attributes.Get(AttributeKey::HULL));
 			tempDeterrence += .12 * strength / weapon->Reload();
 		}
 	return tempDeterrence;
 }
+
+
+
+Ship::Chassis &Ship::EditChassis()
+{
+	if(chassis.use_count() > 1)
+		chassis = make_shared<Chassis>(*chassis);
+	return *chassis;
+}
+
+
+
+// Count how many bays of each category this ship has, and how many are free.
+void Ship::CountBays()
+{
+	bayCounts.clear();
+	for(const Bay &bay : bays)
+	{
+		BayCount *count = GetBayCount(bay.category);
+		if(!count)
+		{
+			bayCounts.emplace_back(bay.category);
+			count = &bayCounts.back();
+		}
+		++count->total;
+		count->free += !bay.ship;
+	}
+}
+
+
+
+const Ship::BayCount *Ship::GetBayCount(const string &category) const
+{
+	// Ships rarely have bays of more than one or two categories.
+	for(const BayCount &count : bayCounts)
+		if(count.category == category)
+			return &count;
+	return nullptr;
+}
+
+
+
+Ship::BayCount *Ship::GetBayCount(const string &category)
+{
+	return const_cast<BayCount *>(static_cast<const Ship *>(this)->GetBayCount(category));
+}
@@ -24,12 +24,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Command.h"
 #include "EsUuid.h"
 #include "FireCommand.h"
+#include "Flotsam.h"
+#include "ObjectPool.h"
 #include "Outfit.h"
 #include "Personality.h"
 #include "Point.h"
 #include "ship/ShipAICache.h"
+#include "ship/ShipFrameStats.h"
 #include "ShipJumpNavigation.h"
 
+#include <deque>
 #include <list>
 #include <map>
 #include <memory>
@@ -41,9 +45,9 @@ class DamageDealt;
 class DataNode;
 class DataWriter;
 class Effect;
-class Flotsam;
 class Government;
 class Minable;
+class Particle;
 class Phrase;
 class Planet;
 class PlayerInfo;
@@ -166,8 +170,12 @@ public:
 	double Deterrence() const;
 
 	// Check if this ship is configured in such a way that it would be difficult
-	// or impossible to fly.
-	std::vector<std::string> FlightCheck() const;
+	// or impossible to fly. The result is remembered until the loadout, cargo,
+	// or jump fuel of the ship changes.
+	const std::vector<std::string> &FlightCheck() const;
+	bool HasCurrentFlightCheck() const;
+	// Get a number that changes whenever the ship's outfits or attributes do.
+	int LoadoutVersion() const;
 
 	void SetPosition(Point position);
 	// When creating a new ship, you must set the following:
@@ -201,7 +209,10 @@ public:
 
 	// Access the ship's AI cache, containing the range and expected AI behavior for this ship.
 	ShipAICache &GetAICache();
+	const ShipAICache &GetAICache() const;
 	void UpdateCaches();
+	// Get the movement stats this ship derived for the current step.
+	const ShipFrameStats &FrameStats() const;
 
 	// Set the commands for this ship to follow this timestep.
 	void SetCommands(const Command &command);
@@ -209,8 +220,9 @@ public:
 	const Command &Commands() const;
 	const FireCommand &FiringCommands() const noexcept;
 	// Move this ship. A ship may create effects as it moves, in particular if
-	// it is in the process of blowing up.
-	void Move(std::vector<Visual> &visuals, std::list<std::shared_ptr<Flotsam>> &flotsam);
+	// it is in the process of blowing up. Sparks, afterburner exhaust, and
+	// leaks are created as particles rather than visuals.
+	void Move(std::vector<Visual> &visuals, std::vector<Particle> &particles, std::vector<Flotsam> &flotsam);
 
 	// Launch any ships that are ready to launch.
 	void Launch(std::list<std::shared_ptr<Ship>> &ships, std::vector<Visual> &visuals);
@@ -231,6 +243,9 @@ public:
 	bool Fire(std::vector<Projectile> &projectiles, std::vector<Visual> &visuals);
 	// Fire an anti-missile. Returns true if the missile was killed.
 	bool FireAntiMissile(const Projectile &projectile, std::vector<Visual> &visuals);
+	// The farthest that this ship's ready anti-missiles could reach on this
+	// step, as found by the latest call to Fire().
+	double AntiMissileRange() const;
 
 	// Get the system this ship is in. Set to nullptr if the ship is being carried.
 	const System *GetSystem() const;
@@ -363,7 +378,7 @@ public:
 	// DamageDealt from that weapon. The return value is a ShipEvent type,
 	// which may be a combination of PROVOKED, DISABLED, and DESTROYED.
 	// Create any target effects as sparks.
-	int TakeDamage(std::vector<Visual> &visuals, const DamageDealt &damage, const Government *sourceGovernment);
+	int TakeDamage(std::vector<Particle> &particles, const DamageDealt &damage, const Government *sourceGovernment);
 	// Apply a force to this ship, accelerating it. This might be from a weapon
 	// impact, or from firing a weapon, for example.
 	void ApplyForce(const Point &force, bool gravitational = false);
@@ -409,6 +424,11 @@ public:
 	int OutfitCount(const Outfit *outfit) const;
 	// Add or remove outfits. (To remove, pass a negative number.)
 	void AddOutfit(const Outfit *outfit, int count);
+	// Group a series of outfit changes, so that the values that depend on the
+	// loadout as a whole are only recalculated once, when the outermost group
+	// is finished. Every call to Begin must be matched by a call to Finish.
+	void BeginLoadoutChange();
+	void FinishLoadoutChange();
 
 	// Get the list of weapons.
 	Armament &GetArmament();
@@ -428,8 +448,8 @@ public:
 	// Get ship's target system (it should always be one jump / wormhole pass away).
 	const System *GetTargetSystem() const;
 	// Mining target.
-	std::shared_ptr<Minable> GetTargetAsteroid() const;
-	std::shared_ptr<Flotsam> GetTargetFlotsam() const;
+	PoolHandle<Minable> GetTargetAsteroid() const;
+	PoolHandle<Flotsam> GetTargetFlotsam() const;
 
 	// Mark this ship as fleeing.
 	void SetFleeing(bool fleeing = true);
@@ -441,8 +461,8 @@ public:
 	// Set ship's target system (it should always be one jump / wormhole pass away).
 	void SetTargetSystem(const System *system);
 	// Mining target.
-	void SetTargetAsteroid(const std::shared_ptr<Minable> &asteroid);
-	void SetTargetFlotsam(const std::shared_ptr<Flotsam> &flotsam);
+	void SetTargetAsteroid(const PoolHandle<Minable> &asteroid);
+	void SetTargetFlotsam(const PoolHandle<Flotsam> &flotsam);
 
 	bool CanPickUp(const Flotsam &flotsam) const;
 
@@ -473,20 +493,22 @@ private:
 	bool StepFlags();
 	// Step ship destruction logic. Returns 1 if the ship has been destroyed, -1 if it is being
 	// destroyed, or 0 otherwise.
-	int StepDestroyed(std::vector<Visual> &visuals, std::list<std::shared_ptr<Flotsam>> &flotsam);
+	int StepDestroyed(std::vector<Visual> &visuals, std::vector<Particle> &particles, std::vector<Flotsam> &flotsam);
 	void DoGeneration();
-	void DoPassiveEffects(std::vector<Visual> &visuals, std::list<std::shared_ptr<Flotsam>> &flotsam);
-	void DoJettison(std::list<std::shared_ptr<Flotsam>> &flotsam);
+	void DoPassiveEffects(std::vector<Particle> &particles, std::vector<Flotsam> &flotsam);
+	void DoJettison(std::vector<Flotsam> &flotsam);
 	void DoCloakDecision();
+	// Derive the movement stats that are used many times during a step.
+	void UpdateFrameStats();
 	// Step hyperspace enter/exit logic. Returns true if ship is hyperspacing in or out.
-	bool DoHyperspaceLogic(std::vector<Visual> &visuals);
+	bool DoHyperspaceLogic(std::vector<Particle> &particles);
 	// Step landing logic. Returns true if the ship is landing or departing.
 	bool DoLandingLogic();
 	void DoInitializeMovement();
 	void StepPilot();
 	void DoMovement(bool &isUsingAfterburner);
 	void StepTargeting();
-	void DoEngineVisuals(std::vector<Visual> &visuals, bool isUsingAfterburner);
+	void DoEngineVisuals(std::vector<Particle> &particles, bool isUsingAfterburner);
 
 
 	// Add or remove a ship from this ship's list of escorts.
@@ -498,13 +520,42 @@ private:
 	// either stay over the ship, or spread out if this is the final explosion.
 	void CreateExplosion(std::vector<Visual> &visuals, bool spread = false);
 	// Place a "spark" effect, like ionization or disruption.
-	void CreateSparks(std::vector<Visual> &visuals, const std::string &name, double amount);
-	void CreateSparks(std::vector<Visual> &visuals, const Effect *effect, double amount);
+	void CreateSparks(std::vector<Particle> &particles, const std::string &name, double amount);
+	void CreateSparks(std::vector<Particle> &particles, const Effect *effect, double amount);
 
 	// Calculate the attraction and deterrance of this ship, for pirate raids.
 	// This is only useful for the player's ships.
 	double CalculateAttraction() const;
 	double CalculateDeterrence() const;
+	std::vector<std::string> CalculateFlightCheck() const;
+	// Get a version of the chassis that this ship does not share with any
+	// other ship, so that it can be modified.
+	class Chassis;
+	Chassis &EditChassis();
+	// Count how many bays of each category this ship has, and how many of them
+	// are free. Carried ships check these every step, so the counts are kept
+	// up to date whenever a ship enters or leaves a bay.
+	void CountBays();
+	class BayCount;
+	const BayCount *GetBayCount(const std::string &category) const;
+	BayCount *GetBayCount(const std::string &category);
+
+
+private:
+	class BayCount {
+	public:
+		explicit BayCount(const std::string &category) : category(category) {}
+		BayCount(BayCount &&) = default;
+		BayCount &operator=(BayCount &&) = default;
+
+		// Like bays, copies of a bay count do not include the ships inside them.
+		BayCount(const BayCount &other) : category(other.category), total(other.total), free(other.total) {}
+		BayCount &operator=(const BayCount &other) { return *this = BayCount(other); }
+
+		std::string category;
+		int total = 0;
+		int free = 0;
+	};
 
 
 private:
@@ -516,20 +567,45 @@ private:
 	// int swizzle;
 	// const Government *government;
 
-	// Characteristics of the chassis:
-	bool isDefined = false;
-	const Ship *base = nullptr;
-	std::string modelName;
-	std::string pluralModelName;
-	std::string variantName;
-	std::string noun;
-	std::string description;
-	const Sprite *thumbnail = nullptr;
-	// Characteristics of this particular ship:
-	EsUuid uuid;
-	std::string name;
-	bool canBeCarried = false;
+	// The hull may spring a "leak" (venting atmosphere, flames, blood, etc.)
+	// when the ship is dying.
+	class Leak {
+	public:
+		Leak(const Effect *effect = nullptr) : effect(effect) {}
 
+		const Effect *effect = nullptr;
+		Point location;
+		Angle angle;
+		int openPeriod = 60;
+		int closePeriod = 60;
+	};
+
+	// The parts of the ship's definition that do not change once it has been
+	// loaded. Every copy of a ship shares them with the ship it was copied from,
+	// so they must only be modified through EditChassis().
+	class Chassis {
+	public:
+		std::string description;
+		Outfit baseAttributes;
+
+		std::vector<EnginePoint> enginePoints;
+		std::vector<EnginePoint> reverseEnginePoints;
+		std::vector<EnginePoint> steeringEnginePoints;
+
+		std::vector<Leak> leaks;
+		std::map<const Effect *, int> explosionEffects;
+		unsigned explosionTotal = 0;
+		std::map<const Effect *, int> finalExplosions;
+	};
+
+	// The state that is read or changed every step comes first, right after
+	// the Body's position and velocity, so that the loops over every ship in
+	// the engine and the AI touch as few cache lines of each ship as they can.
+	// Names, outfits, cargo, bays and the like, which are only needed now and
+	// then, come after it.
+
+	// Current status of this particular ship:
+	const System *currentSystem = nullptr;
 	int forget = 0;
 	bool isInSystem = true;
 	// "Special" ships cannot be forgotten, and if they land on a planet, they
@@ -537,7 +613,6 @@ private:
 	bool isSpecial = false;
 	bool isYours = false;
 	bool isParked = false;
-	bool shouldDeploy = false;
 	bool isOverheated = false;
 	bool isDisabled = false;
 	bool isBoarding = false;
@@ -546,50 +621,14 @@ private:
 	bool isThrusting = false;
 	bool isReversing = false;
 	bool isSteering = false;
-	double steeringDirection = 0.;
 	bool neverDisabled = false;
 	bool isCapturable = true;
 	bool isInvisible = false;
+	bool isUsingJumpDrive = false;
+	double steeringDirection = 0.;
 	int customSwizzle = -1;
 	double cloak = 0.;
 	double cloakDisruption = 0.;
-	// Cached values for figuring out when anti-missile is in range.
-	double antiMissileRange = 0.;
-	double weaponRadius = 0.;
-	// Cargo and outfit scanning takes time.
-	double cargoScan = 0.;
-	double outfitScan = 0.;
-
-	double attraction = 0.;
-	double deterrence = 0.;
-
-	// Number of AI steps this ship has spent lingering
-	int lingerSteps = 0;
-
-	Command commands;
-	FireCommand firingCommands;
-
-	Personality personality;
-	const Phrase *hail = nullptr;
-	ShipAICache aiCache;
-
-	// Installed outfits, cargo, etc.:
-	Outfit attributes;
-	Outfit baseAttributes;
-	bool addAttributes = false;
-	const Outfit *explosionWeapon = nullptr;
-	std::map<const Outfit *, int> outfits;
-	CargoHold cargo;
-	std::list<std::shared_ptr<Flotsam>> jettisoned;
-
-	std::vector<Bay> bays;
-	// Cache the mass of carried ships to avoid repeatedly recomputing it.
-	double carriedMass = 0.;
-
-	std::vector<EnginePoint> enginePoints;
-	std::vector<EnginePoint> reverseEnginePoints;
-	std::vector<EnginePoint> steeringEnginePoints;
-	Armament armament;
 
 	// Various energy levels:
 	double shields = 0.;
@@ -619,59 +658,101 @@ private:
 	// Acceleration can be created by engines, firing weapons, or weapon impacts.
 	Point acceleration;
 
-	int crew = 0;
-	int pilotError = 0;
-	int pilotOkay = 0;
+	Command commands;
+	FireCommand firingCommands;
+	ShipFrameStats frameStats;
+	// Cached values for figuring out when anti-missile is in range.
+	double antiMissileRange = 0.;
+	double weaponRadius = 0.;
+	// Cache the mass of carried ships to avoid repeatedly recomputing it.
+	double carriedMass = 0.;
 
-	// Current status of this particular ship:
-	const System *currentSystem = nullptr;
 	// A Ship can be locked into one of three special states: landing,
 	// hyperspacing, and exploding. Each one must track some special counters:
 	const Planet *landingPlanet = nullptr;
-
-	ShipJumpNavigation navigation;
 	int hyperspaceCount = 0;
 	const System *hyperspaceSystem = nullptr;
-	bool isUsingJumpDrive = false;
 	double hyperspaceFuelCost = 0.;
 	Point hyperspaceOffset;
-
-	// The hull may spring a "leak" (venting atmosphere, flames, blood, etc.)
-	// when the ship is dying.
-	class Leak {
-	public:
-		Leak(const Effect *effect = nullptr) : effect(effect) {}
-
-		const Effect *effect = nullptr;
-		Point location;
-		Angle angle;
-		int openPeriod = 60;
-		int closePeriod = 60;
-	};
-	std::vector<Leak> leaks;
-	std::vector<Leak> activeLeaks;
-
 	// Explosions that happen when the ship is dying:
-	std::map<const Effect *, int> explosionEffects;
 	unsigned explosionRate = 0;
 	unsigned explosionCount = 0;
-	unsigned explosionTotal = 0;
-	std::map<const Effect *, int> finalExplosions;
 
 	// Target ships, planets, systems, etc.
 	std::weak_ptr<Ship> targetShip;
 	std::weak_ptr<Ship> shipToAssist;
 	const StellarObject *targetPlanet = nullptr;
 	const System *targetSystem = nullptr;
-	std::weak_ptr<Minable> targetAsteroid;
-	std::weak_ptr<Flotsam> targetFlotsam;
-
-	// Links between escorts and parents.
-	std::vector<std::weak_ptr<Ship>> escorts;
+	PoolHandle<Minable> targetAsteroid;
+	PoolHandle<Flotsam> targetFlotsam;
 	std::weak_ptr<Ship> parent;
 
+	int crew = 0;
+	int pilotError = 0;
+	int pilotOkay = 0;
+	// Number of AI steps this ship has spent lingering
+	int lingerSteps = 0;
+	// Cargo and outfit scanning takes time.
+	double cargoScan = 0.;
+	double outfitScan = 0.;
+	Personality personality;
+	ShipAICache aiCache;
+
+	Armament armament;
+	std::shared_ptr<Chassis> chassis = std::make_shared<Chassis>();
+
+	// Characteristics of the chassis:
+	bool isDefined = false;
+	const Ship *base = nullptr;
+	std::string modelName;
+	std::string pluralModelName;
+	std::string variantName;
+	std::string noun;
+	const Sprite *thumbnail = nullptr;
+	// Characteristics of this particular ship:
+	EsUuid uuid;
+	std::string name;
+	bool canBeCarried = false;
+	bool shouldDeploy = false;
+
+	double attraction = 0.;
+	double deterrence = 0.;
+
+	const Phrase *hail = nullptr;
+
+	// Installed outfits, cargo, etc.:
+	Outfit attributes;
+	bool addAttributes = false;
+	const Outfit *explosionWeapon = nullptr;
+	std::map<const Outfit *, int> outfits;
+	CargoHold cargo;
+	std::deque<Flotsam> jettisoned;
+
+	std::vector<Bay> bays;
+	std::vector<BayCount> bayCounts;
 	bool removeBays = false;
 
+	ShipJumpNavigation navigation;
+	// The number of open loadout change groups, and which of the values derived
+	// from the loadout became stale while they were open.
+	int loadoutChanges = 0;
+	bool staleAttraction = false;
+	bool staleDeterrence = false;
+	bool staleNavigation = false;
+	bool staleDrives = false;
+	// This increases whenever the outfits or attributes change, and is used to
+	// tell whether the remembered flight check is out of date.
+	int loadoutVersion = 0;
+	mutable std::vector<std::string> flightCheck;
+	mutable int flightCheckVersion = -1;
+	mutable int flightCheckCargo = 0;
+	mutable double flightCheckJumpFuel = 0.;
+
+	std::vector<Leak> activeLeaks;
+
+	// The ships escorting this one. Its parent is kept with its targets.
+	std::vector<std::weak_ptr<Ship>> escorts;
+
 	// Angle from target location where a ship should jump to
 	Angle jumpDriveTargetAngle;
 };
@@ -47,9 +47,21 @@ ShipInfoDisplay::ShipInfoDisplay(const Ship &ship, const PlayerInfo &player, boo
 // Call this every time the ship changes.
 void ShipInfoDisplay::Update(const Ship &ship, const PlayerInfo &player, bool descriptionCollapsed)
 {
+	const Depreciation &depreciation = ship.IsYours() ? player.FleetDepreciation() : player.StockDepreciation();
+	int day = player.GetDate().DaysSinceEpoch();
+	vector<bool> licenses;
+	for(const string &license : ship.Attributes().Licenses())
+		licenses.push_back(player.HasLicense(license));
+	auto inputs = make_tuple(&ship, ship.ModelName(), ship.LoadoutVersion(), ship.Cargo().Used(), ship.Fuel(),
+		ship.Name().empty() || ship.GetPlanet(), ship.IsYours(), depreciation.Value(ship, day),
+		depreciation.Value(GameData::Ships().Get(ship.ModelName()), day), std::move(licenses),
+		descriptionCollapsed, GameData::UniverseRevision());
+	if(inputs == madeFrom)
+		return;
+	madeFrom = std::move(inputs);
+
 	UpdateDescription(ship.Description(), ship.Attributes().Licenses(), true);
 	UpdateAttributes(ship, player, descriptionCollapsed);
-	const Depreciation &depreciation = ship.IsYours() ? player.FleetDepreciation() : player.StockDepreciation();
 	UpdateOutfits(ship, player, depreciation);
 
 	maximumHeight = max(descriptionHeight, max(attributesHeight, outfitsHeight));
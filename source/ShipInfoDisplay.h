@@ -18,7 +18,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "ItemInfoDisplay.h"
 
+#include <cstdint>
 #include <string>
+#include <tuple>
 #include <vector>
 
 class Depreciation;
@@ -75,6 +77,15 @@ private:
 	std::vector<std::string> saleLabels;
 	std::vector<std::string> saleValues;
 	int saleHeight = 0;
+
+	// Everything the tables above were made from. Formatting them is slow, and
+	// the shops update this every frame, so they are only made again if one of
+	// these has changed: the ship, its model and loadout, its cargo and fuel,
+	// whether it is a generic or a player's ship, its value and the value of
+	// its hull, which licenses the player has, whether the description is
+	// collapsed, and the revision of the game data.
+	std::tuple<const Ship *, std::string, int, int, double, bool, bool, int64_t, int64_t, std::vector<bool>, bool,
+		uint64_t> madeFrom;
 };
 
 
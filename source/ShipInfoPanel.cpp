@@ -441,7 +441,7 @@ void ShipInfoPanel::DrawWeapons(const Rectangle &bounds)
 	if(sprite)
 	{
 		SpriteShader::Draw(sprite, bounds.Center(), scale, 28);
-		OutlineShader::Draw(sprite, bounds.Center(), scale * Point(sprite->Width(), sprite->Height()), Color(.5f));
+		OutlineShader::DrawCached(sprite, bounds.Center(), scale * Point(sprite->Width(), sprite->Height()), Color(.5f));
 	}
 
 	// Figure out how tall each part of the weapon listing will be.
@@ -21,10 +21,29 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <algorithm>
 #include <cassert>
-#include <iterator>
 
 using namespace std;
 
+namespace {
+	// Find the index of the first of the sorted values that is not less than
+	// the given one, without any branches that depend on the values.
+	size_t LowerBound(const vector<double> &values, double value)
+	{
+		if(values.empty())
+			return 0;
+
+		const double *base = values.data();
+		size_t size = values.size();
+		while(size > 1)
+		{
+			size_t half = size / 2;
+			base = (base[half - 1] < value) ? base + half : base;
+			size -= half;
+		}
+		return (base - values.data()) + (*base < value);
+	}
+}
+
 const double ShipJumpNavigation::DEFAULT_HYPERDRIVE_COST = 100.;
 const double ShipJumpNavigation::DEFAULT_SCRAM_DRIVE_COST = 150.;
 const double ShipJumpNavigation::DEFAULT_JUMP_DRIVE_COST = 200.;
@@ -43,6 +62,7 @@ void ShipJumpNavigation::Calibrate(const Ship &ship)
 	hasJumpDrive = attributes.Get("jump drive");
 	hasJumpMassCost = attributes.Get("jump mass cost");
 
+	jumpDriveRanges.clear();
 	jumpDriveCosts.clear();
 	hyperdriveCost = 0.;
 	maxJumpRange = 0.;
@@ -115,8 +135,8 @@ double ShipJumpNavigation::JumpDriveFuel(double distance) const
 	if(!hasJumpDrive)
 		return 0.;
 	// Otherwise, find the first jump range that covers the distance.
-	auto it = jumpDriveCosts.lower_bound(distance);
-	return (it == jumpDriveCosts.end()) ? 0. : it->second;
+	size_t index = LowerBound(jumpDriveRanges, distance);
+	return (index == jumpDriveRanges.size()) ? 0. : jumpDriveCosts[index];
 }
 
 
@@ -221,31 +241,35 @@ void ShipJumpNavigation::UpdateJumpDriveCosts(double distance, double cost)
 		maxJumpRange = distance;
 	// If a jump drive range isn't already accounted for or the existing cost
 	// for this range is more expensive, use the given cost.
-	auto oit = jumpDriveCosts.find(distance);
-	if(oit == jumpDriveCosts.end() || !oit->second || oit->second > cost)
+	size_t index = LowerBound(jumpDriveRanges, distance);
+	bool isNew = (index == jumpDriveRanges.size() || jumpDriveRanges[index] != distance);
+	if(isNew || !jumpDriveCosts[index] || jumpDriveCosts[index] > cost)
 	{
-		jumpDriveCosts[distance] = cost;
+		if(isNew)
+		{
+			jumpDriveRanges.insert(jumpDriveRanges.begin() + index, distance);
+			jumpDriveCosts.insert(jumpDriveCosts.begin() + index, cost);
+		}
+		else
+			jumpDriveCosts[index] = cost;
 
 		// If a cost was updated then we need to reassess other costs. The goal is to have
 		// the cost for each distance be the cheapest possible fuel cost needed to jump to
-		// a system that is that distance away. The keys of the map are the distances and
-		// will be strictly increasing, while the values of the map are the fuel costs and
-		// will be weakly increasing.
-		auto it = jumpDriveCosts.find(distance);
+		// a system that is that distance away. The ranges are strictly increasing, while
+		// the costs will be weakly increasing.
 		// If the jump range a step above this distance is cheaper, then the
 		// cheaper jump cost already covers this range. We don't need to check
-		// any other distances in this case because the rest of the map will
+		// any other distances in this case because the rest of the costs will
 		// already be properly sorted.
-		auto nit = std::next(it);
-		if(nit != jumpDriveCosts.end() && it->second > nit->second)
-			it->second = nit->second;
+		if(index + 1 < jumpDriveCosts.size() && jumpDriveCosts[index] > jumpDriveCosts[index + 1])
+			jumpDriveCosts[index] = jumpDriveCosts[index + 1];
 		else
 		{
 			// If any jump range below this one is more expensive, then use
 			// this new, cheaper cost.
-			for(auto sit = jumpDriveCosts.begin(); sit != it; ++sit)
-				if(!sit->second || sit->second > it->second)
-					sit->second = it->second;
+			for(size_t i = 0; i < index; ++i)
+				if(!jumpDriveCosts[i] || jumpDriveCosts[i] > jumpDriveCosts[index])
+					jumpDriveCosts[i] = jumpDriveCosts[index];
 		}
 	}
 }
@@ -18,7 +18,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "JumpTypes.h"
 
-#include <map>
+#include <utility>
+#include <vector>
 
 class Outfit;
 class Ship;
@@ -83,8 +84,10 @@ private:
 
 	// Cached jump navigation information.
 	double hyperdriveCost = 0.;
-	// Map allowable jump ranges to the fuel required to jump at that range.
-	std::map<double, double> jumpDriveCosts;
+	// The allowable jump ranges in increasing order, and the fuel required to
+	// jump at each of those ranges.
+	std::vector<double> jumpDriveRanges;
+	std::vector<double> jumpDriveCosts;
 	double maxJumpRange = 0.;
 
 	// What drive types and characteristics the ship has.
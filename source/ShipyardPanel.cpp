@@ -139,10 +139,6 @@ bool ShipyardPanel::HasItem(const string &name) const
 void ShipyardPanel::DrawItem(const string &name, const Point &point, int scrollY)
 {
 	const Ship *ship = GameData::Ships().Get(name);
-	zones.emplace_back(point, Point(SHIP_SIZE, SHIP_SIZE), ship, scrollY);
-	if(point.Y() + SHIP_SIZE / 2 < Screen::Top() || point.Y() - SHIP_SIZE / 2 > Screen::Bottom())
-		return;
-
 	DrawShip(*ship, point, ship == selectedShip);
 }
 
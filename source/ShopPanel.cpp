@@ -30,6 +30,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameData.h"
 #include "Government.h"
 #include "Mission.h"
+#include "Outfit.h"
 #include "OutlineShader.h"
 #include "Planet.h"
 #include "PlayerInfo.h"
@@ -76,7 +77,7 @@ ShopPanel::ShopPanel(PlayerInfo &player, bool isOutfitter)
 	: player(player), day(player.GetDate().DaysSinceEpoch()),
 	planet(player.GetPlanet()), playerShip(player.Flagship()),
 	categories(GameData::GetCategory(isOutfitter ? CategoryType::OUTFIT : CategoryType::SHIP)),
-	collapsed(player.Collapsed(isOutfitter ? "outfitter" : "shipyard"))
+	collapsed(player.Collapsed(isOutfitter ? "outfitter" : "shipyard")), isOutfitter(isOutfitter)
 {
 	if(playerShip)
 		playerShips.insert(playerShip);
@@ -107,6 +108,10 @@ ShopPanel::ShopPanel(PlayerInfo &player, bool isOutfitter)
 
 void ShopPanel::Step()
 {
+	// Anything may change while another panel is on top, e.g. a dialog asking
+	// how many of an item to buy.
+	if(!GetUI()->IsTop(this))
+		isShownCurrent = false;
 	// If the player has acquired a second ship for the first time, explain to
 	// them how to reorder the ships in their fleet.
 	if(player.Ships().size() > 1)
@@ -178,7 +183,7 @@ void ShopPanel::Draw()
 		{
 			static const Color selected(.8f, 1.f);
 			Point size(sprite->Width() * scale, sprite->Height() * scale);
-			OutlineShader::Draw(sprite, dragPoint, size, selected);
+			OutlineShader::DrawCached(sprite, dragPoint, size, selected);
 		}
 		else
 		{
@@ -276,7 +281,7 @@ void ShopPanel::DrawShipsSidebar()
 			if(Preferences::Has(SHIP_OUTLINES))
 			{
 				Point size(sprite->Width() * scale, sprite->Height() * scale);
-				OutlineShader::Draw(sprite, point, size, isSelected ? selected : unselected);
+				OutlineShader::DrawCached(sprite, point, size, isSelected ? selected : unselected);
 			}
 			else
 			{
@@ -528,6 +533,8 @@ void ShopPanel::DrawMain()
 	mainScrollAnimate.Step(mainScroll);
 
 
+	UpdateShown();
+
 	const Point begin(
 		(Screen::Width() - columnWidth) / -2,
 		(Screen::Height() - TILE_SIZE) / -2 - mainScrollAnimate);
@@ -535,39 +542,39 @@ void ShopPanel::DrawMain()
 	const float endX = Screen::Right() - (SIDE_WIDTH + 1);
 	double nextY = begin.Y() + TILE_SIZE;
 	int scrollY = 0;
-	for(const auto &cat : categories)
+	for(const auto &it : shown)
 	{
-		const string &category = cat.Name();
-		map<string, vector<string>>::const_iterator it = catalog.find(category);
-		if(it == catalog.end())
-			continue;
-
-		// This should never happen, but bail out if we don't know what planet
-		// we are on (meaning there's no way to know what items are for sale).
-		if(!planet)
-			break;
+		const string &category = it.first;
 
 		Point side(Screen::Left() + 5., point.Y() - TILE_SIZE / 2 + 10);
 		point.Y() += bigFont.Height() + 20;
 		nextY += bigFont.Height() + 20;
 
 		bool isCollapsed = collapsed.count(category);
-		bool isEmpty = true;
-		for(const string &name : it->second)
+		bool isEmpty = it.second.empty();
+		for(const ShownItem &item : it.second)
 		{
-			bool isSelected = (selectedShip && GameData::Ships().Get(name) == selectedShip)
-				|| (selectedOutfit && GameData::Outfits().Get(name) == selectedOutfit);
+			if(isCollapsed)
+				break;
 
+			bool isSelected = (selectedShip && item.ship == selectedShip)
+				|| (selectedOutfit && item.outfit == selectedOutfit);
 			if(isSelected)
 				selectedTopY = point.Y() - TILE_SIZE / 2;
 
-			if(!HasItem(name))
-				continue;
-			isEmpty = false;
-			if(isCollapsed)
-				break;
-
-			DrawItem(name, point, scrollY);
+			// Every item needs a zone, for moving the selection with the keyboard
+			// or a controller, but only the ones that are on screen are drawn.
+			if(item.ship)
+				zones.emplace_back(point, Point(TILE_SIZE, TILE_SIZE), item.ship, scrollY);
+			else
+				zones.emplace_back(point, Point(TILE_SIZE, TILE_SIZE), item.outfit, scrollY);
+			// Thumbnails that are not loaded yet are asked for a screen ahead.
+			double top = point.Y() - TILE_SIZE / 2;
+			double bottom = point.Y() + TILE_SIZE / 2;
+			if(bottom >= Screen::Top() - Screen::Height() && top <= Screen::Bottom() + Screen::Height())
+				GameData::Preload(item.ship ? item.ship->Thumbnail() : item.outfit->Thumbnail());
+			if(bottom >= Screen::Top() && top <= Screen::Bottom())
+				DrawItem(*item.name, point, scrollY);
 
 			point.X() += columnWidth;
 			if(point.X() >= endX)
@@ -731,6 +738,7 @@ void ShopPanel::ToggleCargo()
 // Only override the ones you need; the default action is to return false.
 bool ShopPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, bool isNewPress)
 {
+	isShownCurrent = false;
 	scrollDetailsIntoView = false;
 	bool toStorage = selectedOutfit && (key == 'r' || key == 'u');
 	if(key == 'l' || key == 'd' || key == SDLK_ESCAPE || key == SDLK_AC_BACK
@@ -859,6 +867,7 @@ bool ShopPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command, boo
 
 bool ShopPanel::ControllerTriggerPressed(SDL_GameControllerAxis axis, bool positive)
 {
+	isShownCurrent = false;
 	// treat left joystick like arrow keys, right joystick like navigation keys.
 	// Fallback to the default zone-navigation behavior on the side pane.
 	if(activePane == ShopPane::Main)
@@ -937,6 +946,7 @@ bool ShopPanel::ControllerTriggerPressed(SDL_GameControllerAxis axis, bool posit
 
 bool ShopPanel::ControllerButtonDown(SDL_GameControllerButton button)
 {
+	isShownCurrent = false;
 	if(button == SDL_CONTROLLER_BUTTON_GUIDE)
 		return KeyDown(SDLK_ESCAPE, 0, Command(), true);
 	if(activePane == ShopPane::Main)
@@ -1008,6 +1018,7 @@ bool ShopPanel::ControllerButtonDown(SDL_GameControllerButton button)
 
 bool ShopPanel::Click(int x, int y, int clicks)
 {
+	isShownCurrent = false;
 	dragShip = nullptr;
 	char button = CheckButton(x, y);
 	if(button)
@@ -1187,6 +1198,7 @@ bool ShopPanel::Drag(double dx, double dy)
 
 bool ShopPanel::Release(int x, int y)
 {
+	isShownCurrent = false;
 	if (isDraggingShip)
 	{
 		dragShip = nullptr;
@@ -1659,6 +1671,40 @@ vector<ShopPanel::Zone>::const_iterator ShopPanel::MainStart() const
 
 
 
+// Update the lists of items that are shown in each category.
+void ShopPanel::UpdateShown()
+{
+	if(isShownCurrent)
+		return;
+	isShownCurrent = true;
+
+	shown.clear();
+	// This should never happen, but show nothing if we don't know what planet
+	// we are on (meaning there's no way to know what items are for sale).
+	if(!planet)
+		return;
+
+	for(const auto &cat : categories)
+	{
+		map<string, vector<string>>::const_iterator it = catalog.find(cat.Name());
+		if(it == catalog.end())
+			continue;
+
+		shown.emplace_back(cat.Name(), vector<ShownItem>());
+		for(const string &name : it->second)
+			if(HasItem(name))
+			{
+				ShownItem item;
+				item.name = &name;
+				item.ship = isOutfitter ? nullptr : GameData::Ships().Get(name);
+				item.outfit = isOutfitter ? GameData::Outfits().Get(name) : nullptr;
+				shown.back().second.push_back(item);
+			}
+	}
+}
+
+
+
 // Check if the given point is within the button zone, and if so return the
 // letter of the button (or ' ' if it's not on a button).
 char ShopPanel::CheckButton(int x, int y)
@@ -87,6 +87,7 @@ protected:
 	virtual int VisibilityCheckboxesSize() const;
 	virtual int DrawPlayerShipInfo(const Point &point) = 0;
 	virtual bool HasItem(const std::string &name) const = 0;
+	// Draw the given item. This is only called for items that are on screen.
 	virtual void DrawItem(const std::string &name, const Point &point, int scrollY) = 0;
 	virtual int DividerOffset() const = 0;
 	virtual int DetailWidth() const = 0;
@@ -222,11 +223,32 @@ private:
 	void MainDown();
 	std::vector<Zone>::const_iterator Selected() const;
 	std::vector<Zone>::const_iterator MainStart() const;
+	// Update the lists of items that are shown in each category.
+	void UpdateShown();
 	// Check if the given point is within the button zone, and if so return the
 	// letter of the button (or ' ' if it's not on a button).
 	char CheckButton(int x, int y);
 
 	void DispositionChanged(const std::string& value);
+
+
+private:
+	class ShownItem {
+	public:
+		const std::string *name;
+		const Ship *ship;
+		const Outfit *outfit;
+	};
+
+
+private:
+	bool isOutfitter;
+	// The items that are shown in each category, in the order they are drawn.
+	// Finding out whether an item should be shown may mean looking through all
+	// the player's ships, so this is only done after an event that may have
+	// changed it, rather than for every item on every frame.
+	std::vector<std::pair<std::string, std::vector<ShownItem>>> shown;
+	bool isShownCurrent = false;
 };
 
 
@@ -15,10 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Sound.h"
 
-#include "File.h"
-#include "Files.h"
-
-#include <SDL2/SDL_rwops.h>
+#include "MappedFile.h"
 
 #include <AL/al.h>
 
@@ -44,12 +41,23 @@ namespace {
 	// Read a WAV header, and return the size of the data, in bytes. If the file
 	// is an unsupported format (anything but little-endian 16-bit PCM at 44100 HZ),
 	// this will return 0.
-	uint32_t ReadHeader(File &in, uint32_t &frequency);
-	uint32_t Read4(File &in);
-	uint16_t Read2(File &in);
+	// Reading starts at the given position, which is left at the start of the data.
+	uint32_t ReadHeader(const MappedFile &in, size_t &pos, uint32_t &frequency);
+	uint32_t Read4(const MappedFile &in, size_t &pos);
+	uint16_t Read2(const MappedFile &in, size_t &pos);
 
 	// Read an mp3 file
-	bool ReadMP3(File& in, vector<char>& data, uint32_t &frequency);
+	bool ReadMP3(const MappedFile &in, vector<char>& data, uint32_t &frequency);
+
+	// Read the samples from a WAV or mp3 file.
+	bool ReadSamples(const string &path, vector<char> &data, uint32_t &frequency);
+}
+
+
+
+Sound::Sound(unsigned id)
+	: id(id)
+{
 }
 
 
@@ -58,45 +66,66 @@ bool Sound::Load(const string &path, const string &name)
 {
 	if(path.length() < 5)
 		return false;
+	if(path.compare(path.length() - 4, 4, ".wav") && path.compare(path.length() - 4, 4, ".mp3"))
+		return false;
 	this->name = name;
+	this->path = path;
 
 	isLooped = path[path.length() - 5] == '~';
+	isLoaded = true;
+	return true;
+}
+
+
+
+bool Sound::Decode()
+{
+	if(buffer)
+		return true;
 
 	uint32_t frequency = 0;
 	vector<char> data;
+	if(!Read(data, frequency))
+		return false;
 
-	if(path.compare(path.length() - 4, 4, ".wav") == 0)
-	{
-		File in(path);
-		if(!in)
-			return false;
-		uint32_t bytes = ReadHeader(in, frequency);
-		if(!bytes)
-			return false;
+	Upload(data, frequency);
+	return true;
+}
 
-		data.resize(bytes);
-		vector<char> data(bytes);
-		if(SDL_RWread(in, &data[0], 1, bytes) != bytes)
-			return false;
-	}
-	else if(path.compare(path.length() - 4, 4, ".mp3") == 0)
-	{
-		File in(path);
-		if(!in)
-			return false;
-		if(!ReadMP3(in, data, frequency))
-			return false;
-	}
-	else
+
+
+bool Sound::Read(vector<char> &samples, uint32_t &frequency)
+{
+	if(!isLoaded)
+		return false;
+
+	samples.clear();
+	if(!ReadSamples(path, samples, frequency))
 	{
+		isLoaded = false;
 		return false;
 	}
+	return true;
+}
+
+
 
+void Sound::Upload(const vector<char> &samples, uint32_t frequency)
+{
 	if(!buffer)
 		alGenBuffers(1, &buffer);
-	alBufferData(buffer, AL_FORMAT_MONO16, &data.front(), data.size(), frequency);
+	alBufferData(buffer, AL_FORMAT_MONO16, &samples.front(), samples.size(), frequency);
+	bytes = samples.size();
+}
 
-	return true;
+
+
+void Sound::Unload()
+{
+	if(buffer)
+		alDeleteBuffers(1, &buffer);
+	buffer = 0;
+	bytes = 0;
 }
 
 
@@ -108,6 +137,20 @@ const string &Sound::Name() const
 
 
 
+unsigned Sound::ID() const
+{
+	return id;
+}
+
+
+
+bool Sound::IsLoaded() const
+{
+	return isLoaded;
+}
+
+
+
 unsigned Sound::Buffer() const
 {
 	return buffer;
@@ -115,6 +158,13 @@ unsigned Sound::Buffer() const
 
 
 
+size_t Sound::Bytes() const
+{
+	return bytes;
+}
+
+
+
 bool Sound::IsLooping() const
 {
 	return isLooped;
@@ -126,23 +176,23 @@ namespace {
 	// Read a WAV header, and return the size of the data, in bytes. If the file
 	// is an unsupported format (anything but little-endian 16-bit PCM at 44100 HZ),
 	// this will return 0.
-	uint32_t ReadHeader(File &in, uint32_t &frequency)
+	uint32_t ReadHeader(const MappedFile &in, size_t &pos, uint32_t &frequency)
 	{
-		uint32_t chunkID = Read4(in);
+		uint32_t chunkID = Read4(in, pos);
 		if(chunkID != 0x46464952) // "RIFF" in big endian.
 			return 0;
 
 		// Ignore the "chunk size".
-		Read4(in);
-		uint32_t format = Read4(in);
+		Read4(in, pos);
+		uint32_t format = Read4(in, pos);
 		if(format != 0x45564157) // "WAVE"
 			return 0;
 
 		bool foundHeader = false;
-		while(true)
+		while(pos < in.Size())
 		{
-			uint32_t subchunkID = Read4(in);
-			uint32_t subchunkSize = Read4(in);
+			uint32_t subchunkID = Read4(in, pos);
+			uint32_t subchunkSize = Read4(in, pos);
 
 			if(subchunkID == 0x20746d66) // "fmt "
 			{
@@ -150,16 +200,16 @@ namespace {
 				if(subchunkSize < 16)
 					return 0;
 
-				uint16_t audioFormat = Read2(in);
-				uint16_t numChannels = Read2(in);
-				frequency = Read4(in);
-				uint32_t byteRate = Read4(in);
-				uint32_t blockAlign = Read2(in);
-				uint32_t bitsPerSample = Read2(in);
+				uint16_t audioFormat = Read2(in, pos);
+				uint16_t numChannels = Read2(in, pos);
+				frequency = Read4(in, pos);
+				uint32_t byteRate = Read4(in, pos);
+				uint32_t blockAlign = Read2(in, pos);
+				uint32_t bitsPerSample = Read2(in, pos);
 
 				// Skip any further bytes in this chunk.
 				if(subchunkSize > 16)
-					SDL_RWseek(in, subchunkSize - 16, RW_SEEK_CUR);
+					pos += subchunkSize - 16;
 
 				if(audioFormat != 1)
 					return 0;
@@ -179,17 +229,22 @@ namespace {
 				return subchunkSize;
 			}
 			else
-				SDL_RWseek(in, subchunkSize, RW_SEEK_CUR);
+				pos += subchunkSize;
 		}
+		return 0;
 	}
 
 
 
-	uint32_t Read4(File &in)
+	uint32_t Read4(const MappedFile &in, size_t &pos)
 	{
-		unsigned char data[4];
-		if(SDL_RWread(in, data, 1, 4) != 4)
+		if(pos + 4 > in.Size())
+		{
+			pos = in.Size();
 			return 0;
+		}
+		const unsigned char *data = reinterpret_cast<const unsigned char *>(in.Data() + pos);
+		pos += 4;
 		uint32_t result = 0;
 		for(int i = 0; i < 4; ++i)
 			result |= static_cast<uint32_t>(data[i]) << (i * 8);
@@ -198,11 +253,15 @@ namespace {
 
 
 
-	uint16_t Read2(File &in)
+	uint16_t Read2(const MappedFile &in, size_t &pos)
 	{
-		unsigned char data[2];
-		if(SDL_RWread(in, data, 1, 2) != 2)
+		if(pos + 2 > in.Size())
+		{
+			pos = in.Size();
 			return 0;
+		}
+		const unsigned char *data = reinterpret_cast<const unsigned char *>(in.Data() + pos);
+		pos += 2;
 		uint16_t result = 0;
 		for(int i = 0; i < 2; ++i)
 			result |= static_cast<uint16_t>(data[i]) << (i * 8);
@@ -211,14 +270,14 @@ namespace {
 
 
 
-	bool ReadMP3(File& in, vector<char>& data, uint32_t& frequency)
+	bool ReadMP3(const MappedFile &in, vector<char>& data, uint32_t& frequency)
 	{
 		mp3dec_t mp3d;
 		mp3dec_init(&mp3d);
 
-		auto raw_data = Files::Read(in);
-		const uint8_t* p = reinterpret_cast<const uint8_t*>(raw_data.data());
-		const uint8_t* pend = p + raw_data.size();
+		// Decode straight from the mapped file instead of copying it first.
+		const uint8_t* p = reinterpret_cast<const uint8_t*>(in.Data());
+		const uint8_t* pend = p + in.Size();
 
 		size_t size = 0;
 		frequency = 0;
@@ -242,4 +301,27 @@ namespace {
 		data.resize(size);
 		return !data.empty();
 	}
+
+
+
+	bool ReadSamples(const string &path, vector<char> &data, uint32_t &frequency)
+	{
+		MappedFile in(path);
+		if(!in)
+			return false;
+
+		if(path.compare(path.length() - 4, 4, ".wav") == 0)
+		{
+			size_t pos = 0;
+			uint32_t size = ReadHeader(in, pos, frequency);
+			if(!size || pos > in.Size() || size > in.Size() - pos)
+				return false;
+
+			data.assign(in.Data() + pos, in.Data() + pos + size);
+			return true;
+		}
+		if(path.compare(path.length() - 4, 4, ".mp3") == 0)
+			return ReadMP3(in, data, frequency);
+		return false;
+	}
 }
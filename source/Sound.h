@@ -16,7 +16,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef SOUND_H_
 #define SOUND_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 
 
@@ -24,17 +27,45 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // whether it is looping (ends in '~') or not.
 class Sound {
 public:
+	Sound() = default;
+	// Each sound is given a small, unique ID when it is first referred to, so
+	// that the audio queue can be indexed by sound.
+	explicit Sound(unsigned id);
+
+	// Remember which file holds this sound. The file is not read until the
+	// sound is decoded, so that sounds that are never played take no memory.
 	bool Load(const std::string &path, const std::string &name);
+	// Read the file and upload its samples to an OpenAL buffer, unless that
+	// has already been done. If the file cannot be read, the sound is marked
+	// as not loaded, so that no one tries to play it again.
+	bool Decode();
+	// The two halves of decoding, for when the file is read on another thread.
+	// Reading does not touch OpenAL, so any thread may do it, but uploading
+	// must be done by the thread that owns the sounds.
+	bool Read(std::vector<char> &samples, uint32_t &frequency);
+	void Upload(const std::vector<char> &samples, uint32_t frequency);
+	// Free the decoded samples. The sound can be decoded again later.
+	void Unload();
 
 	const std::string &Name() const;
+	unsigned ID() const;
+	// Check whether this sound has a file that it can be decoded from.
+	bool IsLoaded() const;
 
+	// The OpenAL buffer, or 0 if the sound is not decoded right now.
 	unsigned Buffer() const;
+	// The memory used by the decoded samples, in bytes.
+	size_t Bytes() const;
 	bool IsLooping() const;
 
 
 private:
 	std::string name;
+	std::string path;
+	unsigned id = 0;
 	unsigned buffer = 0;
+	size_t bytes = 0;
+	bool isLoaded = false;
 	bool isLooped = false;
 };
 
@@ -89,6 +89,14 @@ void SpaceportPanel::Step()
 
 
 
+// The spaceport news is chosen once, when the player lands.
+bool SpaceportPanel::IsAnimated() const noexcept
+{
+	return false;
+}
+
+
+
 void SpaceportPanel::Draw()
 {
 	if(player.IsDead())
@@ -112,14 +120,23 @@ void SpaceportPanel::Draw()
 
 // Pick a random news object that applies to the player's planets and conditions.
 // If there is no applicable news, this returns null.
-const News *SpaceportPanel::PickNews() const
+const News *SpaceportPanel::PickNews()
 {
-	vector<const News *> matches;
 	const Planet *planet = player.GetPlanet();
+	if(localNewsRevision != GameData::UniverseRevision())
+	{
+		localNewsRevision = GameData::UniverseRevision();
+		localNews.clear();
+		for(const auto &it : GameData::SpaceportNews())
+			if(!it.second.IsEmpty() && it.second.MatchesLocation(planet))
+				localNews.push_back(&it.second);
+	}
+
+	vector<const News *> matches;
 	const auto &conditions = player.Conditions();
-	for(const auto &it : GameData::SpaceportNews())
-		if(!it.second.IsEmpty() && it.second.Matches(planet, conditions))
-			matches.push_back(&it.second);
+	for(const News *news : localNews)
+		if(news->Matches(planet, conditions))
+			matches.push_back(news);
 
 	return matches.empty() ? nullptr : matches[Random::Int(matches.size())];
 }
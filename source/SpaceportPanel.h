@@ -21,6 +21,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Information.h"
 #include "text/WrappedText.h"
 
+#include <cstdint>
+#include <vector>
+
 class News;
 class PlayerInfo;
 class Interface;
@@ -37,10 +40,11 @@ public:
 
 	virtual void Step() override;
 	virtual void Draw() override;
+	virtual bool IsAnimated() const noexcept override;
 
 
 private:
-	const News *PickNews() const;
+	const News *PickNews();
 
 
 private:
@@ -48,6 +52,11 @@ private:
 	WrappedText text;
 	const Interface &ui;
 
+	// The news items whose location includes this planet, as of the given
+	// universe revision, so that the other news items need not be checked.
+	std::vector<const News *> localNews;
+	uint64_t localNewsRevision = 0;
+
 	// Current news item (if any):
 	bool hasNews = false;
 	bool hasPortrait = false;
@@ -0,0 +1,152 @@
+/* SpawnPool.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SpawnPool.h"
+
+#include "Fleet.h"
+#include "Ship.h"
+#include "System.h"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+using namespace std;
+
+namespace {
+	// The most ship copies to keep ready at once.
+	const int MAX_READY = 32;
+}
+
+
+
+SpawnPool::~SpawnPool()
+{
+	Wait();
+}
+
+
+
+void SpawnPool::Prepare(const System &system)
+{
+	if(preparedFor == &system)
+		return;
+
+	Wait();
+	preparedFor = &system;
+	wanted.clear();
+	taken.clear();
+	{
+		lock_guard<mutex> lock(readyMutex);
+		ready.clear();
+	}
+
+	// Rank every variant of every fleet by how often it is expected to enter
+	// the system, which is the fleet's spawn rate times the variant's share.
+	vector<pair<double, const Variant *>> likely;
+	for(const auto &fleet : system.Fleets())
+	{
+		const Fleet &it = *fleet.Get();
+		if(!it.GetGovernment() || !fleet.Period())
+			continue;
+		double total = it.Variants().TotalWeight();
+		for(const Variant &variant : it.Variants())
+			likely.emplace_back(variant.Weight() / (total * fleet.Period()), &variant);
+	}
+	stable_sort(likely.begin(), likely.end(),
+		[](const pair<double, const Variant *> &a, const pair<double, const Variant *> &b) -> bool
+		{
+			return a.first > b.first;
+		});
+
+	// Keep enough copies of each model to spawn the likeliest variants in full.
+	int count = 0;
+	for(const auto &it : likely)
+	{
+		map<const Ship *, int> needed;
+		for(const Ship *model : it.second->Ships())
+			if(model->IsValid())
+				++needed[model];
+		for(const auto &need : needed)
+		{
+			int &want = wanted[need.first];
+			if(want < need.second)
+			{
+				count += need.second - want;
+				want = need.second;
+			}
+		}
+		if(count >= MAX_READY)
+			break;
+	}
+
+	vector<const Ship *> models;
+	for(const auto &it : wanted)
+		models.insert(models.end(), it.second, it.first);
+	if(!models.empty())
+		building = async(launch::async, [this, models]() { Build(models); });
+}
+
+
+
+shared_ptr<Ship> SpawnPool::Take(const Ship *model)
+{
+	if(!wanted.count(model))
+		return nullptr;
+
+	lock_guard<mutex> lock(readyMutex);
+	vector<shared_ptr<Ship>> &copies = ready[model];
+	if(copies.empty())
+		return nullptr;
+
+	shared_ptr<Ship> ship = std::move(copies.back());
+	copies.pop_back();
+	taken.push_back(model);
+	return ship;
+}
+
+
+
+void SpawnPool::Refill()
+{
+	if(taken.empty())
+		return;
+	if(building.valid() && building.wait_for(chrono::seconds(0)) != future_status::ready)
+		return;
+
+	vector<const Ship *> models;
+	models.swap(taken);
+	building = async(launch::async, [this, models]() { Build(models); });
+}
+
+
+
+void SpawnPool::Wait()
+{
+	if(building.valid())
+		building.wait();
+}
+
+
+
+void SpawnPool::Build(const vector<const Ship *> &models)
+{
+	for(const Ship *model : models)
+	{
+		auto ship = make_shared<Ship>(*model);
+		lock_guard<mutex> lock(readyMutex);
+		ready[model].push_back(std::move(ship));
+	}
+}
@@ -0,0 +1,82 @@
+/* SpawnPool.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPAWN_POOL_H_
+#define SPAWN_POOL_H_
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class Ship;
+class System;
+
+
+
+// Copies of the ship models that the fleets of the current system are most
+// likely to spawn, made ahead of time on a background thread. Copying a ship
+// model (its outfits, hardpoints, and cached values) is the costly part of
+// spawning a fleet, so taking a ready copy avoids a hitch when a large fleet
+// arrives. Models do not change while in flight, so a ready copy is identical
+// to one that would have been made on demand.
+class SpawnPool {
+public:
+	SpawnPool() = default;
+	~SpawnPool();
+
+	// No moving or copying this class.
+	SpawnPool(const SpawnPool &other) = delete;
+	SpawnPool(SpawnPool &&other) = delete;
+	SpawnPool &operator=(const SpawnPool &other) = delete;
+	SpawnPool &operator=(SpawnPool &&other) = delete;
+
+	// Discard all ready copies and start preparing copies of the ships that
+	// the given system's fleets are most likely to spawn. If the copies are
+	// already being prepared for that system (e.g. because it was prepared
+	// while the player was jumping to it), this does nothing.
+	void Prepare(const System &system);
+	// Take a ready copy of the given model. If there is none, this returns
+	// null and the caller must copy the model itself.
+	std::shared_ptr<Ship> Take(const Ship *model);
+	// Start replacing the copies that were taken since the last refill, unless
+	// the background thread is still busy.
+	void Refill();
+
+
+private:
+	// Wait for the background thread to finish the copies it is making.
+	void Wait();
+	void Build(const std::vector<const Ship *> &models);
+
+
+private:
+	// The system that the copies are being prepared for.
+	const System *preparedFor = nullptr;
+	// The models that are kept ready, and how many copies of each are wanted.
+	std::map<const Ship *, int> wanted;
+	// The models of copies that were taken and have not been replaced yet.
+	std::vector<const Ship *> taken;
+	std::future<void> building;
+
+	// The ready copies are shared with the background thread.
+	std::mutex readyMutex;
+	std::map<const Ship *, std::vector<std::shared_ptr<Ship>>> ready;
+};
+
+
+
+#endif
@@ -15,7 +15,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Sprite.h"
 
+#include "AssetTiers.h"
 #include "ImageBuffer.h"
+#include "MemoryStats.h"
 #include "Preferences.h"
 #include "Screen.h"
 
@@ -26,6 +28,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 using namespace std;
 
+namespace {
+	// The texture memory of a sprite's frames is counted for as long as the
+	// sprite has a texture to draw them from.
+	void CountTexture(uint32_t before, uint32_t after, size_t bytes)
+	{
+		if(!before != !after)
+			MemoryStats::Add(MemoryStats::Category::TEXTURES,
+				after ? static_cast<int64_t>(bytes) : -static_cast<int64_t>(bytes));
+	}
+}
+
 
 
 Sprite::Sprite(const string &name)
@@ -46,61 +59,11 @@ const string &Sprite::Name() const
 void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
 {
 	// Do nothing if the buffer is empty.
-	if(!buffer.Pixels())
+	if(!buffer.Data())
 		return;
 
-	// If this is the 1x image, its dimensions determine the sprite's size.
-	if(!is2x)
-	{
-		width = buffer.DisplayWidth();
-		height = buffer.DisplayHeight();
-		frames = buffer.Frames();
-	}
-
-	if (!buffer.CompressedFormat())
-	{
-		// Reduce the size of the textures (and the GPU memory load) if we are in
-		// "Reduced graphics" mode.
-		if(Preferences::Has("Reduced graphics") && name.substr(0, 3) != "ui/")
-		{
-			do
-			{
-				buffer.ShrinkToHalfSize();
-			}
-			while (buffer.Width() * buffer.Height() >= 250000);
-		}
-	} // else can't edit pre-compressed data like this
-
-	// Upload the images as a single array texture.
-	glGenTextures(1, &texture[is2x]);
-	glBindTexture(GL_TEXTURE_2D_ARRAY, texture[is2x]);
-
-	// Use linear interpolation and no wrapping.
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-
-	if (!buffer.CompressedFormat())
-	{
-		// Upload the image data.
-		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, // target, mipmap level, internal format,
-			buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
-			0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
-	}
-	else
-	{
-		// Upload the image data.
-		glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, buffer.CompressedFormat(), // target, mipmap level, internal format,
-			buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
-			0, buffer.CompressedSize(), buffer.Pixels()); // border, input format, data type, data.
-	}
-
-	// Unbind the texture.
-	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
-
-	// Free the ImageBuffer memory.
-	buffer.Clear();
+	PrepareFrames(buffer, is2x);
+	UploadFrames(buffer, is2x);
 }
 
 
@@ -108,8 +71,16 @@ void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
 // Free up all textures loaded for this sprite.
 void Sprite::Unload()
 {
-	glDeleteTextures(2, texture);
-	texture[0] = texture[1] = 0;
+	for(int i = 0; i < 2; ++i)
+	{
+		if(!isShared[i])
+			OpenGL::DeleteTextures(1, &texture[i]);
+		CountTexture(texture[i], 0, bytes[i]);
+		texture[i] = 0;
+		firstLayer[i] = 0;
+		isShared[i] = false;
+		bytes[i] = 0;
+	}
 
 	width = 0.f;
 	height = 0.f;
@@ -164,3 +135,121 @@ uint32_t Sprite::Texture(bool isHighDPI) const
 {
 	return (isHighDPI && texture[1]) ? texture[1] : texture[0];
 }
+
+
+
+// Get the layer of the texture that holds the first frame.
+int Sprite::FirstLayer() const
+{
+	return FirstLayer(Screen::IsHighResolution());
+}
+
+
+
+int Sprite::FirstLayer(bool isHighDPI) const
+{
+	return (isHighDPI && texture[1]) ? firstLayer[1] : firstLayer[0];
+}
+
+
+
+size_t Sprite::Bytes() const
+{
+	return bytes[0] + bytes[1];
+}
+
+
+
+void Sprite::PrepareFrames(ImageBuffer &buffer, bool is2x)
+{
+	// If this is the 1x image, its dimensions determine the sprite's size.
+	if(!is2x)
+	{
+		width = buffer.DisplayWidth();
+		height = buffer.DisplayHeight();
+		frames = buffer.Frames();
+	}
+
+	if (!buffer.CompressedFormat())
+	{
+		// Reduce the size of the textures (and the GPU memory load) if we are in
+		// "Reduced graphics" mode.
+		if(Preferences::Has("Reduced graphics") && name.substr(0, 3) != "ui/")
+		{
+			do
+			{
+				buffer.ShrinkToHalfSize();
+			}
+			while (buffer.Width() * buffer.Height() >= 250000);
+		}
+		// Large images are also kept within the size this device's tier allows.
+		const int maxSize = AssetTiers::MaxSize(AssetTiers::GetCategory(name));
+		while(maxSize && max(buffer.Width(), buffer.Height()) > maxSize)
+			buffer.ShrinkToHalfSize();
+	} // else can't edit pre-compressed data like this
+
+	CountTexture(texture[is2x], 0, bytes[is2x]);
+	bytes[is2x] = buffer.CompressedFormat() ? buffer.CompressedSize()
+		: sizeof(uint32_t) * buffer.Width() * buffer.Height() * buffer.Frames();
+	CountTexture(0, texture[is2x], bytes[is2x]);
+}
+
+
+
+void Sprite::UploadFrames(ImageBuffer &buffer, bool is2x)
+{
+	// Upload the images as a single array texture.
+	uint32_t before = texture[is2x];
+	glGenTextures(1, &texture[is2x]);
+	CountTexture(before, texture[is2x], bytes[is2x]);
+	OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, texture[is2x]);
+
+	// Use linear interpolation and no wrapping.
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	if (!buffer.CompressedFormat())
+	{
+		// Upload the image data.
+		glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, // target, mipmap level, internal format,
+			buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
+			0, GL_RGBA, GL_UNSIGNED_BYTE, buffer.Pixels()); // border, input format, data type, data.
+	}
+	else
+	{
+		// Upload the image data.
+		glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, buffer.CompressedFormat(), // target, mipmap level, internal format,
+			buffer.Width(), buffer.Height(), buffer.Frames(), // width, height, depth,
+			0, buffer.CompressedSize(), buffer.Data()); // border, input format, data type, data.
+	}
+
+	// Unbind the texture.
+	OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	// Free the ImageBuffer memory.
+	buffer.Clear();
+}
+
+
+
+void Sprite::SetSharedTexture(bool is2x, uint32_t texture, int firstLayer)
+{
+	CountTexture(this->texture[is2x], texture, bytes[is2x]);
+	this->texture[is2x] = texture;
+	this->firstLayer[is2x] = firstLayer;
+	isShared[is2x] = true;
+}
+
+
+
+void Sprite::SetTexture(bool is2x, uint32_t texture)
+{
+	if(!isShared[is2x])
+		OpenGL::DeleteTextures(1, &this->texture[is2x]);
+	CountTexture(this->texture[is2x], texture, bytes[is2x]);
+	this->texture[is2x] = texture;
+	firstLayer[is2x] = 0;
+	isShared[is2x] = false;
+}
@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Point.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -26,9 +27,10 @@ class ImageBuffer;
 
 
 // Class representing a drawable sprite. A sprite can have multiple frames, for
-// animation. Each frame is stored in a separate OpenGL texture object. This may
-// not be as efficient as sprite sheets, but with modern graphics cards it will
-// not matter much and it makes working with the graphics a lot simpler.
+// animation. The frames are stored as consecutive layers of an OpenGL array
+// texture. Small sprites may share their texture with others of the same size
+// (see SpriteAtlas), so that they can be drawn together; in that case the
+// sprite's first frame is not the first layer of the texture.
 class Sprite {
 public:
 	explicit Sprite(const std::string &name = "");
@@ -55,16 +57,46 @@ public:
 	// setting or specifying it manually.
 	uint32_t Texture() const;
 	uint32_t Texture(bool isHighDPI) const;
+	// Get the layer of that texture that holds this sprite's first frame.
+	int FirstLayer() const;
+	int FirstLayer(bool isHighDPI) const;
+
+	// Get the amount of texture memory used by this sprite's frames, including
+	// the high DPI ones, in bytes. This counts the frames once they have been
+	// prepared for uploading, even if the upload has not finished yet.
+	size_t Bytes() const;
+
+
+private:
+	// Set this sprite's size from the given frames, and reduce their resolution
+	// if the preferences call for it. The frames are not uploaded.
+	void PrepareFrames(ImageBuffer &buffer, bool is2x);
+	void UploadFrames(ImageBuffer &buffer, bool is2x);
+	// Use frames that have already been uploaded to a texture shared with other sprites.
+	void SetSharedTexture(bool is2x, uint32_t texture, int firstLayer);
+	// Use a texture of its own that was uploaded elsewhere, freeing any previous one.
+	void SetTexture(bool is2x, uint32_t texture);
 
 
 private:
 	std::string name;
 
 	uint32_t texture[2] = {0, 0};
+	int firstLayer[2] = {0, 0};
+	// Shared textures belong to the atlas, and must not be freed by the sprite.
+	bool isShared[2] = {false, false};
+	size_t bytes[2] = {0, 0};
 
 	float width = 0.f;
 	float height = 0.f;
 	int frames = 0;
+
+	// Where the MaskManager keeps this sprite's collision masks, if it has any.
+	mutable int maskIndex = -1;
+
+	friend class MaskManager;
+	friend class SpriteAtlas;
+	friend class SpriteUpload;
 };
 
 
@@ -0,0 +1,139 @@
+/* SpriteAtlas.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SpriteAtlas.h"
+
+#include "ImageBuffer.h"
+#include "Sprite.h"
+
+#include "opengl.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	// Only frames this size or smaller are packed together. Larger images gain
+	// little from it, since there are fewer of them and they are rarely drawn
+	// many times in a row.
+	const int MAX_SIZE = 256;
+	// Sprites with more frames than this keep a texture of their own.
+	const int MAX_FRAMES = 64;
+	// The most layers to put in one shared texture. OpenGL ES 3.0 guarantees
+	// that at least 256 are supported.
+	const int MAX_LAYERS = 256;
+}
+
+
+
+bool SpriteAtlas::Add(Sprite *sprite, ImageBuffer &buffer, bool is2x)
+{
+	if(!buffer.Data())
+		return false;
+
+	// The size is only known for certain once the frames are prepared, since
+	// they may be reduced to half size.
+	sprite->PrepareFrames(buffer, is2x);
+	// Interface images are drawn while the rest are still loading.
+	if(!sprite->Name().compare(0, 3, "ui/"))
+		return false;
+	if(buffer.Width() > MAX_SIZE || buffer.Height() > MAX_SIZE || buffer.Frames() > MAX_FRAMES)
+		return false;
+
+	entries[make_tuple(buffer.Width(), buffer.Height(), buffer.CompressedFormat())].push_back({sprite, &buffer, is2x});
+	return true;
+}
+
+
+
+bool SpriteAtlas::IsEmpty() const
+{
+	return entries.empty();
+}
+
+
+
+void SpriteAtlas::Pack()
+{
+	GLint maxLayers = 0;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+	maxLayers = max(MAX_FRAMES, min(MAX_LAYERS, maxLayers));
+
+	vector<char> data;
+	for(auto &it : entries)
+	{
+		const int width = get<0>(it.first);
+		const int height = get<1>(it.first);
+		const uint32_t format = get<2>(it.first);
+		vector<Entry> &group = it.second;
+
+		// Each texture holds as many consecutive entries as will fit in it.
+		for(size_t begin = 0; begin < group.size(); )
+		{
+			size_t end = begin;
+			int layers = 0;
+			while(end < group.size() && layers + group[end].buffer->Frames() <= maxLayers)
+				layers += group[end++].buffer->Frames();
+
+			// There is nothing to gain from sharing a texture with no other sprites.
+			if(end - begin == 1)
+			{
+				group[begin].sprite->UploadFrames(*group[begin].buffer, group[begin].is2x);
+				begin = end;
+				continue;
+			}
+
+			data.clear();
+			for(size_t i = begin; i < end; ++i)
+			{
+				const ImageBuffer &buffer = *group[i].buffer;
+				const char *pixels = reinterpret_cast<const char *>(buffer.Data());
+				size_t size = format ? buffer.CompressedSize()
+					: sizeof(uint32_t) * buffer.Width() * buffer.Height() * buffer.Frames();
+				data.insert(data.end(), pixels, pixels + size);
+			}
+
+			GLuint texture = 0;
+			glGenTextures(1, &texture);
+			OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, texture);
+
+			// Use linear interpolation and no wrapping.
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+			if(!format)
+				glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layers,
+					0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+			else
+				glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, format, width, height, layers,
+					0, data.size(), data.data());
+
+			OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+			int layer = 0;
+			for(size_t i = begin; i < end; ++i)
+			{
+				Entry &entry = group[i];
+				entry.sprite->SetSharedTexture(entry.is2x, texture, layer);
+				layer += entry.buffer->Frames();
+				entry.buffer->Clear();
+			}
+			begin = end;
+		}
+	}
+	entries.clear();
+}
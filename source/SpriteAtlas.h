@@ -0,0 +1,65 @@
+/* SpriteAtlas.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPRITE_ATLAS_H_
+#define SPRITE_ATLAS_H_
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <vector>
+
+class ImageBuffer;
+class Sprite;
+
+
+
+// Every sprite normally has an array texture of its own, so drawing two
+// different sprites always means binding a new texture, and they cannot be
+// drawn with the same call. The atlas collects the frames of small sprites
+// while they are being loaded, then packs all the frames that have the same
+// size and format into the layers of a single shared array texture. Each
+// sprite then knows which layer its first frame is in.
+class SpriteAtlas {
+public:
+	// Prepare the given frames for the sprite, and if they are small enough to
+	// share a texture, keep them to be packed later. Return true if they were
+	// kept, in which case the buffer must stay valid until Pack() is called.
+	// Otherwise, the caller must upload them (see SpriteUpload).
+	bool Add(Sprite *sprite, ImageBuffer &buffer, bool is2x);
+	// Check whether any frames are waiting to be packed.
+	bool IsEmpty() const;
+	// Upload all the frames that were added, and clear their buffers.
+	void Pack();
+
+
+private:
+	class Entry {
+	public:
+		Sprite *sprite;
+		ImageBuffer *buffer;
+		bool is2x;
+	};
+
+
+private:
+	// The frames that still need to be uploaded, grouped by their width,
+	// height, and compression format.
+	std::map<std::tuple<int, int, uint32_t>, std::vector<Entry>> entries;
+};
+
+
+
+#endif
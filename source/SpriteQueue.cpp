@@ -18,20 +18,28 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "ImageBuffer.h"
 #include "ImageSet.h"
 #include "Mask.h"
+#include "Profiler.h"
 #include "Sprite.h"
 #include "SpriteSet.h"
+#include "ThreadPlacement.h"
 
 #include <algorithm>
+#include <chrono>
 #include <functional>
 
 using namespace std;
 
+namespace {
+	// The most time UploadSprites() may spend in one frame.
+	const chrono::milliseconds UPLOAD_BUDGET(4);
+}
+
 
 
 // Constructor, which allocates worker threads.
 SpriteQueue::SpriteQueue()
 {
-	threads.resize(max(4u, thread::hardware_concurrency()));
+	threads.resize(ThreadPlacement::LoaderCount());
 	for(thread &t : threads)
 		t = thread(ref(*this));
 }
@@ -78,7 +86,8 @@ void SpriteQueue::Unload(const string &name)
 
 
 
-// Determine the fraction of sprites uploaded to the GPU.
+// Determine the fraction of sprites uploaded to the GPU, counting each of
+// their collision masks as well.
 double SpriteQueue::GetProgress() const
 {
 	// Wait until we have completed loading of as many sprites as we have added.
@@ -87,15 +96,16 @@ double SpriteQueue::GetProgress() const
 	// Special cases: we're bailing out, or we are done.
 	if(added <= 0 || added == completed)
 		return 1.;
-	return static_cast<double>(completed) / static_cast<double>(added);
+	return static_cast<double>(completed + masksDone) / static_cast<double>(added + masksAdded);
 }
 
 
 
 void SpriteQueue::UploadSprites()
 {
+	Profiler::Zone zone("Upload sprites");
 	unique_lock<mutex> lock(loadMutex);
-	DoLoad(lock);
+	DoLoad(lock, true);
 }
 
 
@@ -109,7 +119,7 @@ void SpriteQueue::Finish()
 		unique_lock<mutex> lock(loadMutex);
 
 		// Load whatever is already queued up for loading.
-		DoLoad(lock);
+		DoLoad(lock, false);
 		if(GetProgress() == 1.)
 			break;
 
@@ -124,6 +134,8 @@ void SpriteQueue::Finish()
 // Thread entry point.
 void SpriteQueue::operator()()
 {
+	ThreadPlacement::Assign(ThreadPlacement::Role::LOADER);
+
 	while(true)
 	{
 		unique_lock<mutex> lock(readMutex);
@@ -133,6 +145,24 @@ void SpriteQueue::operator()()
 			// "added" to -1.
 			if(added < 0)
 				return;
+			// Trace the masks of sprites that have already been read before
+			// reading any more, so fewer images are held in memory at once.
+			if(!toMask.empty())
+			{
+				MaskTask task = toMask.front();
+				toMask.pop();
+				lock.unlock();
+
+				// Each task writes only its own frame's mask, so the last one
+				// to finish is the only one that needs to hand off the set.
+				task.images->TraceMask(task.frame);
+				if(--*task.remaining == 0)
+					Loaded(task.images);
+
+				lock.lock();
+				++masksDone;
+				continue;
+			}
 			if(toRead.empty())
 				break;
 
@@ -148,14 +178,20 @@ void SpriteQueue::operator()()
 			// the UI thread to display a message prior to terminating the process.
 			imageSet->Load();
 
+			const size_t masks = imageSet->MasksToTrace();
+			if(!masks)
 			{
-				// The texture must be uploaded to OpenGL in the main thread.
-				unique_lock<mutex> lock(loadMutex);
-				toLoad.push(imageSet);
+				Loaded(imageSet);
+				lock.lock();
+				continue;
 			}
-			loadCondition.notify_one();
 
+			auto remaining = make_shared<atomic<size_t>>(masks);
 			lock.lock();
+			for(size_t i = 0; i < masks; ++i)
+				toMask.push(MaskTask{imageSet, i, remaining});
+			masksAdded += masks;
+			readCondition.notify_all();
 		}
 
 		readCondition.wait(lock);
@@ -164,7 +200,20 @@ void SpriteQueue::operator()()
 
 
 
-void SpriteQueue::DoLoad(unique_lock<mutex> &lock)
+// Hand off an image set that is ready to be uploaded.
+void SpriteQueue::Loaded(const shared_ptr<ImageSet> &images)
+{
+	{
+		// The texture must be uploaded to OpenGL in the main thread.
+		unique_lock<mutex> lock(loadMutex);
+		toLoad.push(images);
+	}
+	loadCondition.notify_one();
+}
+
+
+
+void SpriteQueue::DoLoad(unique_lock<mutex> &lock, bool isLimited)
 {
 	while(!toUnload.empty())
 	{
@@ -176,18 +225,57 @@ void SpriteQueue::DoLoad(unique_lock<mutex> &lock)
 		lock.lock();
 	}
 
-	for(int i = 0; !toLoad.empty() && i < 100; ++i)
+	const auto start = chrono::steady_clock::now();
+	while(!uploads.empty() || !toLoad.empty())
 	{
-		// Extract the one item we should work on uploading right now.
-		shared_ptr<ImageSet> imageSet = toLoad.front();
-		toLoad.pop();
+		if(uploads.empty())
+		{
+			// Extract the one item we should work on uploading right now.
+			uploading = toLoad.front();
+			toLoad.pop();
 
-		// It's now safe to modify the lists.
-		lock.unlock();
+			// It's now safe to modify the lists.
+			lock.unlock();
+			isUploadingKept = uploading->Upload(SpriteSet::Modify(uploading->Name()), atlas, uploads);
+			lock.lock();
+		}
+		else
+		{
+			lock.unlock();
+			bool isDone = uploads.back().Step();
+			lock.lock();
+			if(isDone)
+				uploads.pop_back();
+		}
+		if(uploads.empty())
+			FinishUpload();
 
-		imageSet->Upload(SpriteSet::Modify(imageSet->Name()));
+		if(isLimited && chrono::steady_clock::now() - start >= UPLOAD_BUDGET)
+			return;
+	}
 
-		lock.lock();
-		++completed;
+	// Once every other sprite has been uploaded, pack the small ones together.
+	if(toPack.empty())
+		return;
+	{
+		lock_guard<mutex> readLock(readMutex);
+		if(completed + static_cast<int>(toPack.size()) != added)
+			return;
 	}
+	lock.unlock();
+	atlas.Pack();
+	lock.lock();
+	completed += toPack.size();
+	toPack.clear();
+}
+
+
+
+void SpriteQueue::FinishUpload()
+{
+	if(isUploadingKept)
+		toPack.push_back(uploading);
+	else
+		++completed;
+	uploading.reset();
 }
@@ -16,7 +16,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef SPRITE_QUEUE_H_
 #define SPRITE_QUEUE_H_
 
+#include "SpriteAtlas.h"
+#include "SpriteUpload.h"
+
+#include <atomic>
 #include <condition_variable>
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -49,9 +54,11 @@ public:
 	void Add(const std::shared_ptr<ImageSet> &images);
 	// Unload the texture for the given sprite (to free up memory).
 	void Unload(const std::string &name);
-	// Determine the fraction of sprites uploaded to the GPU.
+	// Determine the fraction of sprites uploaded to the GPU, counting each of
+	// their collision masks as well.
 	double GetProgress() const;
-	// Uploads any available sprites to the GPU.
+	// Uploads available sprites to the GPU, for at most a few milliseconds so
+	// that this can be called every frame without making the game stutter.
 	void UploadSprites();
 	// Finish loading.
 	void Finish();
@@ -61,7 +68,24 @@ public:
 
 
 private:
-	void DoLoad(std::unique_lock<std::mutex> &lock);
+	// Tracing one frame's collision mask. The image set isn't uploaded until
+	// all of its masks are done.
+	class MaskTask {
+	public:
+		std::shared_ptr<ImageSet> images;
+		std::size_t frame;
+		std::shared_ptr<std::atomic<std::size_t>> remaining;
+	};
+
+
+private:
+	// Hand off an image set that is ready to be uploaded.
+	void Loaded(const std::shared_ptr<ImageSet> &images);
+	// Upload sprites until there are none left or, if limited, until the time
+	// budget for this frame is used up.
+	void DoLoad(std::unique_lock<std::mutex> &lock, bool isLimited);
+	// Record that the image set being uploaded is done.
+	void FinishUpload();
 
 
 private:
@@ -71,6 +95,13 @@ private:
 	std::condition_variable readCondition;
 	int added = 0;
 
+	// Collision masks for the image sets that have been read. Each frame is
+	// traced separately, so that the frames of one big sprite are spread
+	// across all the worker threads. These are also protected by readMutex.
+	std::queue<MaskTask> toMask;
+	int masksAdded = 0;
+	int masksDone = 0;
+
 	// These image sets have been loaded from disk but have not been uploaded.
 	std::queue<std::shared_ptr<ImageSet>> toLoad;
 	std::mutex loadMutex;
@@ -80,6 +111,17 @@ private:
 	// These sprites must be unloaded to reclaim GPU memory.
 	std::queue<std::string> toUnload;
 
+	// Small frames are packed together once everything else has been uploaded.
+	// Until then, the image sets they came from must be kept, and they do not
+	// count as completed.
+	SpriteAtlas atlas;
+	std::vector<std::shared_ptr<ImageSet>> toPack;
+
+	// The image set whose frames are being uploaded, and the uploads left to do.
+	std::shared_ptr<ImageSet> uploading;
+	bool isUploadingKept = false;
+	std::vector<SpriteUpload> uploads;
+
 	// Worker threads for loading sprites from disk.
 	std::vector<std::thread> threads;
 };
@@ -18,13 +18,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Logger.h"
 #include "Sprite.h"
 
-#include <map>
+#include <algorithm>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 using namespace std;
 
 namespace {
-	map<string, Sprite> sprites;
+	// Sprites are looked up far more often than they are listed, so they are
+	// kept in a hash table. Its elements do not move when it grows.
+	unordered_map<string, Sprite> sprites;
 
 	mutex modifyMutex;
 }
@@ -40,14 +44,19 @@ const Sprite *SpriteSet::Get(const string &name)
 
 void SpriteSet::CheckReferences()
 {
+	vector<string> empty;
 	for(const auto &pair : sprites)
 	{
 		const Sprite &sprite = pair.second;
 		if(sprite.Height() == 0 && sprite.Width() == 0)
 			// Landscapes are allowed to still be empty.
 			if(pair.first.compare(0, 5, "land/") != 0)
-				Logger::LogError("Warning: image \"" + pair.first + "\" is referred to, but has no pixels.");
+				empty.push_back(pair.first);
 	}
+	// Report the missing images in a consistent order.
+	sort(empty.begin(), empty.end());
+	for(const string &name : empty)
+		Logger::LogError("Warning: image \"" + name + "\" is referred to, but has no pixels.");
 }
 
 
@@ -20,6 +20,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Shader.h"
 #include "Sprite.h"
 
+#include "opengl.h"
+
+#include <algorithm>
+#include <cstddef>
 #include <sstream>
 #include <vector>
 
@@ -36,6 +40,7 @@ namespace {
 	GLint scaleI;
 	GLint frameI;
 	GLint frameCountI;
+	GLint firstLayerI;
 	GLint positionI;
 	GLint transformI;
 	GLint blurI;
@@ -46,6 +51,73 @@ namespace {
 	GLuint vao;
 	GLuint vbo;
 
+	// When it is available, runs of sprites that share a texture are drawn with
+	// a single instanced draw call instead. This shader reads the values that
+	// the one above takes as uniforms from a buffer with one entry per sprite.
+	bool useInstancing = false;
+	Shader instancedShader;
+	GLint instancedScaleI;
+	GLint instancePositionI;
+	GLint instanceTransformI;
+	GLint instanceBlurI;
+	GLint instanceFrameI;
+	GLint instanceFirstLayerI;
+	GLint instanceSwizzleI;
+	GLuint instancedVao;
+	GLuint instanceVbo;
+
+	class Instance {
+	public:
+		float position[2];
+		float transform[4];
+		float blur[2];
+		// The frame, frame count, clip, and alpha.
+		float frame[4];
+		float firstLayer;
+		float swizzle;
+	};
+	// The instances being drawn. This is kept to avoid reallocating it each frame.
+	vector<Instance> instances;
+
+	// Fields of sprites that repeat every few thousand pixels are drawn by a
+	// third shader, which works out where each copy of a sprite should be.
+	Shader fieldShader;
+	GLint fieldScaleI;
+	GLint fieldSizeI;
+	GLint fieldZoomI;
+	GLint fieldWrapI;
+	GLint fieldStartI;
+	GLint fieldOriginI;
+	GLint fieldLimitI;
+	GLint fieldCopiesXI;
+	GLint fieldCopiesI;
+	GLint fieldCenterVelocityI;
+	GLint fieldBlurI;
+	GLint fieldFrameCountI;
+	GLint fieldFirstLayerI;
+	GLint fieldPositionI;
+	GLint fieldVelocityI;
+	GLint fieldUnitI;
+	GLint fieldFrameI;
+	GLuint fieldVao;
+	GLuint fieldVbo;
+
+	// Particles are drawn by a fourth shader, which moves and animates each one
+	// from the values it had when it was created.
+	Shader particleShader;
+	GLint particleScaleI;
+	GLint particleSizeI;
+	GLint particleZoomI;
+	GLint particleCenterI;
+	GLint particleNowI;
+	GLint particleFrameCountI;
+	GLint particleFirstLayerI;
+	GLint particleDelayI;
+	GLint particleRepeatI;
+	GLint particleRewindI;
+	GLuint particleVao;
+	GLuint particleVbo;
+
 	const vector<vector<GLint>> SWIZZLE = {
 		{GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA}, // 0 red + yellow markings (republic)
 		{GL_RED, GL_BLUE, GL_GREEN, GL_ALPHA}, // 1 red + magenta markings
@@ -77,6 +149,170 @@ namespace {
 		{GL_BLUE, GL_ZERO, GL_ZERO, GL_ALPHA}, // 27 red only (cloaked)
 		{GL_ZERO, GL_ZERO, GL_ZERO, GL_ALPHA} // 28 black only (outline)
 	};
+
+
+
+	// Generate the code for the fragment shader.
+	string FragmentCode(bool useShaderSwizzle, bool isInstanced)
+	{
+		ostringstream fragmentCodeStream;
+		// The instanced shader gets these values from the vertex shader instead.
+		const char *input = isInstanced ? "in " : "uniform ";
+		fragmentCodeStream <<
+			"// fragment sprite shader\n"
+			"precision mediump float;\n"
+#ifdef ES_GLES
+			"precision mediump sampler2DArray;\n"
+#endif
+			"uniform sampler2DArray tex;\n"
+			<< input << "float frame;\n"
+			<< input << "float frameCount;\n"
+			<< input << "float firstLayer;\n"
+			<< input << "vec2 blur;\n";
+		if(useShaderSwizzle) fragmentCodeStream
+			<< (isInstanced ? "flat in " : "uniform ") << "int swizzler;\n";
+		fragmentCodeStream
+			<< input << "float alpha;\n"
+			"const int range = 5;\n"
+
+			"in vec2 fragTexCoord;\n"
+
+			"out vec4 finalColor;\n"
+
+			"void main() {\n"
+			"  float first = floor(frame);\n"
+			"  float second = mod(ceil(frame), frameCount);\n"
+			"  float fade = frame - first;\n"
+			// The sprite's frames may not start at the first layer of the texture.
+			"  first += firstLayer;\n"
+			"  second += firstLayer;\n"
+			"  vec4 color;\n"
+			"  if(blur.x == 0.f && blur.y == 0.f)\n"
+			"  {\n"
+			"    if(fade != 0.f)\n"
+			"      color = mix(\n"
+			"        texture(tex, vec3(fragTexCoord, first)),\n"
+			"        texture(tex, vec3(fragTexCoord, second)), fade);\n"
+			"    else\n"
+			"      color = texture(tex, vec3(fragTexCoord, first));\n"
+			"  }\n"
+			"  else\n"
+			"  {\n"
+			"    color = vec4(0., 0., 0., 0.);\n"
+			"    const float divisor = float(range * (range + 2) + 1);\n"
+			"    for(int i = -range; i <= range; ++i)\n"
+			"    {\n"
+			"      float scale = float(range + 1 - abs(i)) / divisor;\n"
+			"      vec2 coord = fragTexCoord + (blur * float(i)) / float(range);\n"
+			"      if(fade != 0.f)\n"
+			"        color += scale * mix(\n"
+			"          texture(tex, vec3(coord, first)),\n"
+			"          texture(tex, vec3(coord, second)), fade);\n"
+			"      else\n"
+			"        color += scale * texture(tex, vec3(coord, first));\n"
+			"    }\n"
+			"  }\n";
+
+		// Only included when hardware swizzle not supported, GL <3.3 and GLES
+		if(useShaderSwizzle)
+		{
+			fragmentCodeStream <<
+			"  switch (swizzler) {\n"
+			"    case 0:\n"
+			"      color = color.rgba;\n"
+			"      break;\n"
+			"    case 1:\n"
+			"      color = color.rbga;\n"
+			"      break;\n"
+			"    case 2:\n"
+			"      color = color.grba;\n"
+			"      break;\n"
+			"    case 3:\n"
+			"      color = color.brga;\n"
+			"      break;\n"
+			"    case 4:\n"
+			"      color = color.gbra;\n"
+			"      break;\n"
+			"    case 5:\n"
+			"      color = color.bgra;\n"
+			"      break;\n"
+			"    case 6:\n"
+			"      color = color.gbba;\n"
+			"      break;\n"
+			"    case 7:\n"
+			"      color = color.rbba;\n"
+			"      break;\n"
+			"    case 8:\n"
+			"      color = color.rgga;\n"
+			"      break;\n"
+			"    case 9:\n"
+			"      color = color.bbba;\n"
+			"      break;\n"
+			"    case 10:\n"
+			"      color = color.ggga;\n"
+			"      break;\n"
+			"    case 11:\n"
+			"      color = color.rrra;\n"
+			"      break;\n"
+			"    case 12:\n"
+			"      color = color.bbga;\n"
+			"      break;\n"
+			"    case 13:\n"
+			"      color = color.bbra;\n"
+			"      break;\n"
+			"    case 14:\n"
+			"      color = color.ggra;\n"
+			"      break;\n"
+			"    case 15:\n"
+			"      color = color.bgga;\n"
+			"      break;\n"
+			"    case 16:\n"
+			"      color = color.brra;\n"
+			"      break;\n"
+			"    case 17:\n"
+			"      color = color.grra;\n"
+			"      break;\n"
+			"    case 18:\n"
+			"      color = color.bgba;\n"
+			"      break;\n"
+			"    case 19:\n"
+			"      color = color.brba;\n"
+			"      break;\n"
+			"    case 20:\n"
+			"      color = color.grga;\n"
+			"      break;\n"
+			"    case 21:\n"
+			"      color = color.ggba;\n"
+			"      break;\n"
+			"    case 22:\n"
+			"      color = color.rrba;\n"
+			"      break;\n"
+			"    case 23:\n"
+			"      color = color.rrga;\n"
+			"      break;\n"
+			"    case 24:\n"
+			"      color = color.gbga;\n"
+			"      break;\n"
+			"    case 25:\n"
+			"      color = color.rbra;\n"
+			"      break;\n"
+			"    case 26:\n"
+			"      color = color.rgra;\n"
+			"      break;\n"
+			"    case 27:\n"
+			"      color = vec4(color.b, 0.f, 0.f, color.a);\n"
+			"      break;\n"
+			"    case 28:\n"
+			"      color = vec4(0.f, 0.f, 0.f, color.a);\n"
+			"      break;\n"
+			"  }\n";
+		}
+		fragmentCodeStream <<
+			"  finalColor = color * alpha;\n"
+			"}\n";
+
+		return fragmentCodeStream.str();
+	}
 }
 
 bool SpriteShader::useShaderSwizzle = false;
@@ -105,163 +341,14 @@ void SpriteShader::Init(bool useShaderSwizzle)
 		"  fragTexCoord = vec2(texCoord.x, min(clip, texCoord.y)) + blurOff;\n"
 		"}\n";
 
-	ostringstream fragmentCodeStream;
-	fragmentCodeStream <<
-		"// fragment sprite shader\n"
-		"precision mediump float;\n"
-#ifdef ES_GLES
-		"precision mediump sampler2DArray;\n"
-#endif
-		"uniform sampler2DArray tex;\n"
-		"uniform float frame;\n"
-		"uniform float frameCount;\n"
-		"uniform vec2 blur;\n";
-	if(useShaderSwizzle) fragmentCodeStream <<
-		"uniform int swizzler;\n";
-	fragmentCodeStream <<
-		"uniform float alpha;\n"
-		"const int range = 5;\n"
-
-		"in vec2 fragTexCoord;\n"
-
-		"out vec4 finalColor;\n"
-
-		"void main() {\n"
-		"  float first = floor(frame);\n"
-		"  float second = mod(ceil(frame), frameCount);\n"
-		"  float fade = frame - first;\n"
-		"  vec4 color;\n"
-		"  if(blur.x == 0.f && blur.y == 0.f)\n"
-		"  {\n"
-		"    if(fade != 0.f)\n"
-		"      color = mix(\n"
-		"        texture(tex, vec3(fragTexCoord, first)),\n"
-		"        texture(tex, vec3(fragTexCoord, second)), fade);\n"
-		"    else\n"
-		"      color = texture(tex, vec3(fragTexCoord, first));\n"
-		"  }\n"
-		"  else\n"
-		"  {\n"
-		"    color = vec4(0., 0., 0., 0.);\n"
-		"    const float divisor = float(range * (range + 2) + 1);\n"
-		"    for(int i = -range; i <= range; ++i)\n"
-		"    {\n"
-		"      float scale = float(range + 1 - abs(i)) / divisor;\n"
-		"      vec2 coord = fragTexCoord + (blur * float(i)) / float(range);\n"
-		"      if(fade != 0.f)\n"
-		"        color += scale * mix(\n"
-		"          texture(tex, vec3(coord, first)),\n"
-		"          texture(tex, vec3(coord, second)), fade);\n"
-		"      else\n"
-		"        color += scale * texture(tex, vec3(coord, first));\n"
-		"    }\n"
-		"  }\n";
-
-	// Only included when hardware swizzle not supported, GL <3.3 and GLES
-	if(useShaderSwizzle)
-	{
-		fragmentCodeStream <<
-		"  switch (swizzler) {\n"
-		"    case 0:\n"
-		"      color = color.rgba;\n"
-		"      break;\n"
-		"    case 1:\n"
-		"      color = color.rbga;\n"
-		"      break;\n"
-		"    case 2:\n"
-		"      color = color.grba;\n"
-		"      break;\n"
-		"    case 3:\n"
-		"      color = color.brga;\n"
-		"      break;\n"
-		"    case 4:\n"
-		"      color = color.gbra;\n"
-		"      break;\n"
-		"    case 5:\n"
-		"      color = color.bgra;\n"
-		"      break;\n"
-		"    case 6:\n"
-		"      color = color.gbba;\n"
-		"      break;\n"
-		"    case 7:\n"
-		"      color = color.rbba;\n"
-		"      break;\n"
-		"    case 8:\n"
-		"      color = color.rgga;\n"
-		"      break;\n"
-		"    case 9:\n"
-		"      color = color.bbba;\n"
-		"      break;\n"
-		"    case 10:\n"
-		"      color = color.ggga;\n"
-		"      break;\n"
-		"    case 11:\n"
-		"      color = color.rrra;\n"
-		"      break;\n"
-		"    case 12:\n"
-		"      color = color.bbga;\n"
-		"      break;\n"
-		"    case 13:\n"
-		"      color = color.bbra;\n"
-		"      break;\n"
-		"    case 14:\n"
-		"      color = color.ggra;\n"
-		"      break;\n"
-		"    case 15:\n"
-		"      color = color.bgga;\n"
-		"      break;\n"
-		"    case 16:\n"
-		"      color = color.brra;\n"
-		"      break;\n"
-		"    case 17:\n"
-		"      color = color.grra;\n"
-		"      break;\n"
-		"    case 18:\n"
-		"      color = color.bgba;\n"
-		"      break;\n"
-		"    case 19:\n"
-		"      color = color.brba;\n"
-		"      break;\n"
-		"    case 20:\n"
-		"      color = color.grga;\n"
-		"      break;\n"
-		"    case 21:\n"
-		"      color = color.ggba;\n"
-		"      break;\n"
-		"    case 22:\n"
-		"      color = color.rrba;\n"
-		"      break;\n"
-		"    case 23:\n"
-		"      color = color.rrga;\n"
-		"      break;\n"
-		"    case 24:\n"
-		"      color = color.gbga;\n"
-		"      break;\n"
-		"    case 25:\n"
-		"      color = color.rbra;\n"
-		"      break;\n"
-		"    case 26:\n"
-		"      color = color.rgra;\n"
-		"      break;\n"
-		"    case 27:\n"
-		"      color = vec4(color.b, 0.f, 0.f, color.a);\n"
-		"      break;\n"
-		"    case 28:\n"
-		"      color = vec4(0.f, 0.f, 0.f, color.a);\n"
-		"      break;\n"
-		"  }\n";
-	}
-	fragmentCodeStream <<
-		"  finalColor = color * alpha;\n"
-		"}\n";
-
-	static const string fragmentCodeString = fragmentCodeStream.str();
+	static const string fragmentCodeString = FragmentCode(useShaderSwizzle, false);
 	static const char *fragmentCode = fragmentCodeString.c_str();
 
 	shader = Shader(vertexCode, fragmentCode);
 	scaleI = shader.Uniform("scale");
 	frameI = shader.Uniform("frame");
 	frameCountI = shader.Uniform("frameCount");
+	firstLayerI = shader.Uniform("firstLayer");
 	positionI = shader.Uniform("position");
 	transformI = shader.Uniform("transform");
 	blurI = shader.Uniform("blur");
@@ -270,13 +357,13 @@ void SpriteShader::Init(bool useShaderSwizzle)
 	if(useShaderSwizzle)
 		swizzlerI = shader.Uniform("swizzler");
 
-	glUseProgram(shader.Object());
+	OpenGL::UseProgram(shader.Object());
 	glUniform1i(shader.Uniform("tex"), 0);
-	glUseProgram(0);
+	OpenGL::UseProgram(0);
 
 	// Generate the vertex data for drawing sprites.
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -294,7 +381,336 @@ void SpriteShader::Init(bool useShaderSwizzle)
 
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
+
+	useInstancing = OpenGL::HasInstancingSupport();
+	if(!useInstancing)
+		return;
+
+	ostringstream instancedVertexCode;
+	instancedVertexCode <<
+		"// vertex instanced sprite shader\n"
+		"precision mediump float;\n"
+		"uniform vec2 scale;\n"
+
+		"in vec2 vert;\n"
+		"in vec2 instancePosition;\n"
+		"in vec4 instanceTransform;\n"
+		"in vec2 instanceBlur;\n"
+		"in vec4 instanceFrame;\n"
+		"in float instanceFirstLayer;\n";
+	if(useShaderSwizzle) instancedVertexCode <<
+		"in float instanceSwizzle;\n"
+		"flat out int swizzler;\n";
+	instancedVertexCode <<
+		"out vec2 fragTexCoord;\n"
+		"out float frame;\n"
+		"out float frameCount;\n"
+		"out float firstLayer;\n"
+		"out vec2 blur;\n"
+		"out float alpha;\n"
+
+		"void main() {\n"
+		"  mat2 transform = mat2(instanceTransform.xy, instanceTransform.zw);\n"
+		"  vec2 blurOff = 2.f * vec2(vert.x * abs(instanceBlur.x), vert.y * abs(instanceBlur.y));\n"
+		"  gl_Position = vec4((transform * (vert + blurOff) + instancePosition) * scale, 0, 1);\n"
+		"  vec2 texCoord = vert + vec2(.5, .5);\n"
+		"  fragTexCoord = vec2(texCoord.x, min(instanceFrame.z, texCoord.y)) + blurOff;\n"
+		"  frame = instanceFrame.x;\n"
+		"  frameCount = instanceFrame.y;\n"
+		"  firstLayer = instanceFirstLayer;\n"
+		"  blur = instanceBlur;\n"
+		"  alpha = instanceFrame.w;\n";
+	if(useShaderSwizzle) instancedVertexCode <<
+		"  swizzler = int(instanceSwizzle);\n";
+	instancedVertexCode <<
+		"}\n";
+
+	static const string instancedVertexString = instancedVertexCode.str();
+	static const string instancedFragmentString = FragmentCode(useShaderSwizzle, true);
+	instancedShader = Shader(instancedVertexString.c_str(), instancedFragmentString.c_str());
+	instancedScaleI = instancedShader.Uniform("scale");
+
+	OpenGL::UseProgram(instancedShader.Object());
+	glUniform1i(instancedShader.Uniform("tex"), 0);
+	OpenGL::UseProgram(0);
+
+	glGenVertexArrays(1, &instancedVao);
+	OpenGL::BindVertexArray(instancedVao);
+
+	// The corners of each sprite come from the same buffer as above.
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glEnableVertexAttribArray(instancedShader.Attrib("vert"));
+	glVertexAttribPointer(instancedShader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+	// Everything else comes from the instance buffer, which is filled in and
+	// pointed to each time a batch is drawn.
+	glGenBuffers(1, &instanceVbo);
+	instancePositionI = instancedShader.Attrib("instancePosition");
+	instanceTransformI = instancedShader.Attrib("instanceTransform");
+	instanceBlurI = instancedShader.Attrib("instanceBlur");
+	instanceFrameI = instancedShader.Attrib("instanceFrame");
+	instanceFirstLayerI = instancedShader.Attrib("instanceFirstLayer");
+	vector<GLint> attributes = {instancePositionI, instanceTransformI, instanceBlurI, instanceFrameI,
+		instanceFirstLayerI};
+	if(useShaderSwizzle)
+	{
+		instanceSwizzleI = instancedShader.Attrib("instanceSwizzle");
+		attributes.push_back(instanceSwizzleI);
+	}
+	for(GLint attribute : attributes)
+	{
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	OpenGL::BindVertexArray(0);
+
+	ostringstream fieldVertexCode;
+	fieldVertexCode <<
+		"// vertex field sprite shader\n"
+		// World coordinates need more precision than the other sprite shaders use.
+		"precision highp float;\n"
+		"uniform vec2 scale;\n"
+		"uniform vec2 size;\n"
+		"uniform float zoom;\n"
+		"uniform float wrap;\n"
+		"uniform vec2 start;\n"
+		"uniform vec2 origin;\n"
+		"uniform vec2 limit;\n"
+		"uniform int copiesX;\n"
+		"uniform int copies;\n"
+		"uniform vec2 centerVelocity;\n"
+		"uniform float blurScale;\n"
+		"uniform float fieldFrameCount;\n"
+		"uniform float fieldFirstLayer;\n"
+
+		"in vec2 vert;\n"
+		"in vec2 fieldPosition;\n"
+		"in vec2 fieldVelocity;\n"
+		"in vec2 fieldUnit;\n"
+		"in float fieldFrame;\n";
+	if(useShaderSwizzle) fieldVertexCode <<
+		"flat out int swizzler;\n";
+	fieldVertexCode <<
+		"out vec2 fragTexCoord;\n"
+		"out float frame;\n"
+		"out float frameCount;\n"
+		"out float firstLayer;\n"
+		"out vec2 blur;\n"
+		"out float alpha;\n"
+
+		"void main() {\n"
+		// Each sprite is drawn once for each copy of the field, at the position
+		// of that copy relative to the top left corner of the visible area.
+		"  int copy = gl_InstanceID % copies;\n"
+		"  vec2 local = mod(fieldPosition - start, wrap) + wrap * vec2(copy % copiesX, copy / copiesX);\n"
+		"  frame = fieldFrame;\n"
+		"  frameCount = fieldFrameCount;\n"
+		"  firstLayer = fieldFirstLayer;\n"
+		"  alpha = 1.;\n";
+	if(useShaderSwizzle) fieldVertexCode <<
+		"  swizzler = 0;\n";
+	fieldVertexCode <<
+		"  if(local.x > limit.x || local.y > limit.y)\n"
+		"  {\n"
+		// Move this copy outside the clip volume, so it is not drawn at all.
+		"    fragTexCoord = vec2(0., 0.);\n"
+		"    blur = vec2(0., 0.);\n"
+		"    gl_Position = vec4(0., 0., 2., 1.);\n"
+		"    return;\n"
+		"  }\n"
+		// This is the same transform that DrawList calculates for other sprites.
+		"  vec2 uw = fieldUnit * (size.x * zoom);\n"
+		"  vec2 uh = fieldUnit * (size.y * zoom);\n"
+		"  mat2 transform = mat2(-uw.y, uw.x, -uh.x, -uh.y);\n"
+		"  vec2 relative = (fieldVelocity - centerVelocity) * (zoom * blurScale);\n"
+		"  blur = vec2(fieldUnit.x * relative.y - fieldUnit.y * relative.x, -dot(fieldUnit, relative)) / (4. * size);\n"
+		"  vec2 blurOff = 2. * vec2(vert.x * abs(blur.x), vert.y * abs(blur.y));\n"
+		"  gl_Position = vec4((transform * (vert + blurOff) + local * zoom + origin) * scale, 0, 1);\n"
+		"  fragTexCoord = vert + vec2(.5, .5) + blurOff;\n"
+		"}\n";
+
+	static const string fieldVertexString = fieldVertexCode.str();
+	fieldShader = Shader(fieldVertexString.c_str(), instancedFragmentString.c_str());
+	fieldScaleI = fieldShader.Uniform("scale");
+	fieldSizeI = fieldShader.Uniform("size");
+	fieldZoomI = fieldShader.Uniform("zoom");
+	fieldWrapI = fieldShader.Uniform("wrap");
+	fieldStartI = fieldShader.Uniform("start");
+	fieldOriginI = fieldShader.Uniform("origin");
+	fieldLimitI = fieldShader.Uniform("limit");
+	fieldCopiesXI = fieldShader.Uniform("copiesX");
+	fieldCopiesI = fieldShader.Uniform("copies");
+	fieldCenterVelocityI = fieldShader.Uniform("centerVelocity");
+	fieldBlurI = fieldShader.Uniform("blurScale");
+	fieldFrameCountI = fieldShader.Uniform("fieldFrameCount");
+	fieldFirstLayerI = fieldShader.Uniform("fieldFirstLayer");
+
+	OpenGL::UseProgram(fieldShader.Object());
+	glUniform1i(fieldShader.Uniform("tex"), 0);
+	OpenGL::UseProgram(0);
+
+	glGenVertexArrays(1, &fieldVao);
+	OpenGL::BindVertexArray(fieldVao);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glEnableVertexAttribArray(fieldShader.Attrib("vert"));
+	glVertexAttribPointer(fieldShader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+	// The sprites of a field are uploaded each time it is drawn. Their divisor
+	// depends on how many copies of the field are visible.
+	glGenBuffers(1, &fieldVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, fieldVbo);
+	fieldPositionI = fieldShader.Attrib("fieldPosition");
+	fieldVelocityI = fieldShader.Attrib("fieldVelocity");
+	fieldUnitI = fieldShader.Attrib("fieldUnit");
+	fieldFrameI = fieldShader.Attrib("fieldFrame");
+	for(GLint attribute : {fieldPositionI, fieldVelocityI, fieldUnitI, fieldFrameI})
+		glEnableVertexAttribArray(attribute);
+	glVertexAttribPointer(fieldPositionI, 2, GL_FLOAT, GL_FALSE, sizeof(FieldItem),
+		reinterpret_cast<const void *>(offsetof(FieldItem, position)));
+	glVertexAttribPointer(fieldVelocityI, 2, GL_FLOAT, GL_FALSE, sizeof(FieldItem),
+		reinterpret_cast<const void *>(offsetof(FieldItem, velocity)));
+	glVertexAttribPointer(fieldUnitI, 2, GL_FLOAT, GL_FALSE, sizeof(FieldItem),
+		reinterpret_cast<const void *>(offsetof(FieldItem, unit)));
+	glVertexAttribPointer(fieldFrameI, 1, GL_FLOAT, GL_FALSE, sizeof(FieldItem),
+		reinterpret_cast<const void *>(offsetof(FieldItem, frame)));
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	OpenGL::BindVertexArray(0);
+
+	ostringstream particleVertexCode;
+	particleVertexCode <<
+		"// vertex particle sprite shader\n"
+		// World coordinates need more precision than the other sprite shaders use.
+		"precision highp float;\n"
+		"uniform vec2 scale;\n"
+		"uniform vec2 size;\n"
+		"uniform float zoom;\n"
+		"uniform vec2 center;\n"
+		"uniform float now;\n"
+		"uniform float particleFrameCount;\n"
+		"uniform float particleFirstLayer;\n"
+		"uniform float delay;\n"
+		"uniform int repeat;\n"
+		"uniform int rewind;\n"
+
+		"in vec2 vert;\n"
+		"in vec2 particlePosition;\n"
+		"in vec2 particleVelocity;\n"
+		// The angle and spin, in degrees.
+		"in vec2 particleAngle;\n"
+		// The birth and lifetime, in steps.
+		"in vec2 particleTime;\n"
+		// The frame rate, frame offset, and starting phase.
+		"in vec3 particleFrame;\n";
+	if(useShaderSwizzle) particleVertexCode <<
+		"flat out int swizzler;\n";
+	particleVertexCode <<
+		"out vec2 fragTexCoord;\n"
+		"out float frame;\n"
+		"out float frameCount;\n"
+		"out float firstLayer;\n"
+		"out vec2 blur;\n"
+		"out float alpha;\n"
+
+		"void main() {\n"
+		"  float age = now - particleTime.x;\n"
+		"  frameCount = particleFrameCount;\n"
+		"  firstLayer = particleFirstLayer;\n"
+		"  blur = vec2(0., 0.);\n"
+		"  alpha = 1.;\n";
+	if(useShaderSwizzle) particleVertexCode <<
+		"  swizzler = 0;\n";
+	particleVertexCode <<
+		"  if(age < 0. || age > particleTime.y)\n"
+		"  {\n"
+		// Move this particle outside the clip volume, so it is not drawn at all.
+		"    fragTexCoord = vec2(0., 0.);\n"
+		"    frame = 0.;\n"
+		"    gl_Position = vec4(0., 0., 2., 1.);\n"
+		"    return;\n"
+		"  }\n"
+		// Pick the frame the same way that Body::SetStep() does.
+		"  float last = particleFrameCount - 1.;\n"
+		"  float cycle = (rewind != 0 ? 2. * last : particleFrameCount) + delay;\n"
+		"  float f = max(0., particleFrame.x * age + particleFrame.y + particleFrame.z * cycle);\n"
+		"  if(last <= 0.)\n"
+		"    f = 0.;\n"
+		"  else\n"
+		"  {\n"
+		"    if(repeat != 0)\n"
+		"      f = mod(f, cycle);\n"
+		"    if(rewind == 0)\n"
+		"      f = (repeat == 0) ? min(f, last) : (f >= particleFrameCount ? 0. : f);\n"
+		"    else if(f >= last)\n"
+		"      f = max(0., 2. * last - f);\n"
+		"  }\n"
+		"  frame = f;\n"
+		// This is the same transform that DrawList calculates for other sprites.
+		"  float rotation = radians(particleAngle.x + particleAngle.y * age);\n"
+		"  vec2 unit = vec2(sin(rotation), -cos(rotation));\n"
+		"  vec2 uw = unit * (size.x * zoom);\n"
+		"  vec2 uh = unit * (size.y * zoom);\n"
+		"  mat2 transform = mat2(-uw.y, uw.x, -uh.x, -uh.y);\n"
+		"  vec2 position = (particlePosition + particleVelocity * age - center) * zoom;\n"
+		"  gl_Position = vec4((transform * vert + position) * scale, 0, 1);\n"
+		"  fragTexCoord = vert + vec2(.5, .5);\n"
+		"}\n";
+
+	static const string particleVertexString = particleVertexCode.str();
+	particleShader = Shader(particleVertexString.c_str(), instancedFragmentString.c_str());
+	particleScaleI = particleShader.Uniform("scale");
+	particleSizeI = particleShader.Uniform("size");
+	particleZoomI = particleShader.Uniform("zoom");
+	particleCenterI = particleShader.Uniform("center");
+	particleNowI = particleShader.Uniform("now");
+	particleFrameCountI = particleShader.Uniform("particleFrameCount");
+	particleFirstLayerI = particleShader.Uniform("particleFirstLayer");
+	particleDelayI = particleShader.Uniform("delay");
+	particleRepeatI = particleShader.Uniform("repeat");
+	particleRewindI = particleShader.Uniform("rewind");
+
+	OpenGL::UseProgram(particleShader.Object());
+	glUniform1i(particleShader.Uniform("tex"), 0);
+	OpenGL::UseProgram(0);
+
+	glGenVertexArrays(1, &particleVao);
+	OpenGL::BindVertexArray(particleVao);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glEnableVertexAttribArray(particleShader.Attrib("vert"));
+	glVertexAttribPointer(particleShader.Attrib("vert"), 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), nullptr);
+
+	// The particles of each effect are uploaded each time they are drawn, with
+	// one instance per particle.
+	glGenBuffers(1, &particleVbo);
+	glBindBuffer(GL_ARRAY_BUFFER, particleVbo);
+	const GLint particlePositionI = particleShader.Attrib("particlePosition");
+	const GLint particleVelocityI = particleShader.Attrib("particleVelocity");
+	const GLint particleAngleI = particleShader.Attrib("particleAngle");
+	const GLint particleTimeI = particleShader.Attrib("particleTime");
+	const GLint particleFrameI = particleShader.Attrib("particleFrame");
+	for(GLint attribute : {particlePositionI, particleVelocityI, particleAngleI, particleTimeI, particleFrameI})
+	{
+		glEnableVertexAttribArray(attribute);
+		glVertexAttribDivisor(attribute, 1);
+	}
+	glVertexAttribPointer(particlePositionI, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleItem),
+		reinterpret_cast<const void *>(offsetof(ParticleItem, position)));
+	glVertexAttribPointer(particleVelocityI, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleItem),
+		reinterpret_cast<const void *>(offsetof(ParticleItem, velocity)));
+	glVertexAttribPointer(particleAngleI, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleItem),
+		reinterpret_cast<const void *>(offsetof(ParticleItem, angle)));
+	glVertexAttribPointer(particleTimeI, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleItem),
+		reinterpret_cast<const void *>(offsetof(ParticleItem, birth)));
+	glVertexAttribPointer(particleFrameI, 3, GL_FLOAT, GL_FALSE, sizeof(ParticleItem),
+		reinterpret_cast<const void *>(offsetof(ParticleItem, frameRate)));
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	OpenGL::BindVertexArray(0);
 }
 
 
@@ -321,6 +737,7 @@ SpriteShader::Item SpriteShader::Prepare(const Sprite *sprite, const Point &posi
 	item.texture = sprite->Texture();
 	item.frame = frame;
 	item.frameCount = sprite->Frames();
+	item.firstLayer = sprite->FirstLayer();
 	// Position.
 	item.position[0] = static_cast<float>(position.X());
 	item.position[1] = static_cast<float>(position.Y());
@@ -337,8 +754,8 @@ SpriteShader::Item SpriteShader::Prepare(const Sprite *sprite, const Point &posi
 
 void SpriteShader::Bind()
 {
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindVertexArray(vao);
 
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
 	glUniform2fv(scaleI, 1, scale);
@@ -348,10 +765,11 @@ void SpriteShader::Bind()
 
 void SpriteShader::Add(const Item &item, bool withBlur)
 {
-	glBindTexture(GL_TEXTURE_2D_ARRAY, item.texture);
+	OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, item.texture);
 
 	glUniform1f(frameI, item.frame);
 	glUniform1f(frameCountI, item.frameCount);
+	glUniform1f(firstLayerI, item.firstLayer);
 	glUniform2fv(positionI, 1, item.position);
 	glUniformMatrix2fv(transformI, 1, false, item.transform);
 	// Special case: check if the blur should be applied or not.
@@ -373,6 +791,181 @@ void SpriteShader::Add(const Item &item, bool withBlur)
 
 
 
+void SpriteShader::Add(const vector<Item> &items, bool withBlur)
+{
+	Add(items, 0, items.size(), withBlur);
+}
+
+
+
+void SpriteShader::Add(const vector<Item> &items, size_t first, size_t end, bool withBlur)
+{
+	if(!useInstancing)
+	{
+		for(size_t i = first; i < end; ++i)
+			Add(items[i], withBlur);
+		return;
+	}
+	if(first >= end)
+		return;
+
+	instances.resize(end - first);
+	for(size_t i = 0; i < instances.size(); ++i)
+	{
+		const Item &item = items[first + i];
+		Instance &instance = instances[i];
+		copy(item.position, item.position + 2, instance.position);
+		copy(item.transform, item.transform + 4, instance.transform);
+		instance.blur[0] = withBlur ? item.blur[0] : 0.f;
+		instance.blur[1] = withBlur ? item.blur[1] : 0.f;
+		instance.frame[0] = item.frame;
+		instance.frame[1] = item.frameCount;
+		instance.frame[2] = item.clip;
+		instance.frame[3] = item.alpha;
+		instance.firstLayer = item.firstLayer;
+		// Bounds check for the swizzle value:
+		instance.swizzle = (static_cast<size_t>(item.swizzle) >= SWIZZLE.size() ? 0 : item.swizzle);
+	}
+
+	OpenGL::UseProgram(instancedShader.Object());
+	OpenGL::BindVertexArray(instancedVao);
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(instancedScaleI, 1, scale);
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(Instance), instances.data(), GL_STREAM_DRAW);
+
+	// Sprites must still be drawn in order, so only consecutive ones that use
+	// the same texture (and the same swizzle, if that is set on the texture)
+	// can be drawn together.
+	for(size_t run = 0; run < instances.size(); )
+	{
+		size_t runEnd = run + 1;
+		while(runEnd < instances.size() && items[first + runEnd].texture == items[first + run].texture
+				&& (useShaderSwizzle || instances[runEnd].swizzle == instances[run].swizzle))
+			++runEnd;
+
+		OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, items[first + run].texture);
+		if(!useShaderSwizzle)
+			glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA,
+				SWIZZLE[static_cast<size_t>(instances[run].swizzle)].data());
+
+		// Point the attributes at the first instance in this batch.
+		const char *offset = reinterpret_cast<const char *>(run * sizeof(Instance));
+		glVertexAttribPointer(instancePositionI, 2, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			offset + offsetof(Instance, position));
+		glVertexAttribPointer(instanceTransformI, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			offset + offsetof(Instance, transform));
+		glVertexAttribPointer(instanceBlurI, 2, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			offset + offsetof(Instance, blur));
+		glVertexAttribPointer(instanceFrameI, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			offset + offsetof(Instance, frame));
+		glVertexAttribPointer(instanceFirstLayerI, 1, GL_FLOAT, GL_FALSE, sizeof(Instance),
+			offset + offsetof(Instance, firstLayer));
+		if(useShaderSwizzle)
+			glVertexAttribPointer(instanceSwizzleI, 1, GL_FLOAT, GL_FALSE, sizeof(Instance),
+				offset + offsetof(Instance, swizzle));
+
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, runEnd - run);
+		run = runEnd;
+	}
+
+	// Restore the state that Bind() set up.
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindVertexArray(vao);
+}
+
+
+
+bool SpriteShader::CanDrawFields()
+{
+	return useInstancing;
+}
+
+
+
+void SpriteShader::Add(const Field &field, const vector<FieldItem> &items, bool withBlur)
+{
+	if(!useInstancing || !field.count)
+		return;
+
+	OpenGL::UseProgram(fieldShader.Object());
+	OpenGL::BindVertexArray(fieldVao);
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(fieldScaleI, 1, scale);
+	glUniform2fv(fieldSizeI, 1, field.size);
+	glUniform1f(fieldZoomI, field.zoom);
+	glUniform1f(fieldWrapI, field.wrap);
+	glUniform2fv(fieldStartI, 1, field.start);
+	glUniform2fv(fieldOriginI, 1, field.origin);
+	glUniform2fv(fieldLimitI, 1, field.limit);
+	const int copies = field.copiesX * field.copiesY;
+	glUniform1i(fieldCopiesXI, field.copiesX);
+	glUniform1i(fieldCopiesI, copies);
+	glUniform2fv(fieldCenterVelocityI, 1, field.centerVelocity);
+	glUniform1f(fieldBlurI, withBlur ? 1.f : 0.f);
+	glUniform1f(fieldFrameCountI, field.frameCount);
+	glUniform1f(fieldFirstLayerI, field.firstLayer);
+
+	OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, field.texture);
+	if(!useShaderSwizzle)
+		glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[0].data());
+
+	glBindBuffer(GL_ARRAY_BUFFER, fieldVbo);
+	glBufferData(GL_ARRAY_BUFFER, field.count * sizeof(FieldItem), items.data() + field.first, GL_STREAM_DRAW);
+	// Each sprite is repeated for every copy of the field before moving on to
+	// the next one.
+	for(GLint attribute : {fieldPositionI, fieldVelocityI, fieldUnitI, fieldFrameI})
+		glVertexAttribDivisor(attribute, copies);
+
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, field.count * copies);
+
+	// Restore the state that Bind() set up.
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindVertexArray(vao);
+}
+
+
+
+void SpriteShader::Add(const Particles &particles, const vector<ParticleItem> &items)
+{
+	if(!useInstancing || !particles.count)
+		return;
+
+	OpenGL::UseProgram(particleShader.Object());
+	OpenGL::BindVertexArray(particleVao);
+	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
+	glUniform2fv(particleScaleI, 1, scale);
+	glUniform2fv(particleSizeI, 1, particles.size);
+	glUniform1f(particleZoomI, particles.zoom);
+	glUniform2fv(particleCenterI, 1, particles.center);
+	glUniform1f(particleNowI, particles.now);
+	glUniform1f(particleFrameCountI, particles.frameCount);
+	glUniform1f(particleFirstLayerI, particles.firstLayer);
+	glUniform1f(particleDelayI, particles.delay);
+	glUniform1i(particleRepeatI, particles.repeat);
+	glUniform1i(particleRewindI, particles.rewind);
+
+	OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, particles.texture);
+	if(!useShaderSwizzle)
+		glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[0].data());
+
+	glBindBuffer(GL_ARRAY_BUFFER, particleVbo);
+	glBufferData(GL_ARRAY_BUFFER, particles.count * sizeof(ParticleItem), items.data() + particles.first,
+		GL_STREAM_DRAW);
+
+	glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, particles.count);
+
+	// Restore the state that Bind() set up.
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindVertexArray(vao);
+}
+
+
+
 void SpriteShader::Unbind()
 {
 	// Reset the swizzle.
@@ -380,7 +973,4 @@ void SpriteShader::Unbind()
 		glUniform1i(swizzlerI, 0);
 	else
 		glTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SWIZZLE_RGBA, SWIZZLE[0].data());
-
-	glBindVertexArray(0);
-	glUseProgram(0);
 }
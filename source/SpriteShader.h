@@ -19,7 +19,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 class Sprite;
 class Point;
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 
 
@@ -36,6 +38,8 @@ public:
 		uint32_t swizzle = 0;
 		float frame = 0.f;
 		float frameCount = 1.f;
+		// The layer of the texture that holds the sprite's first frame.
+		float firstLayer = 0.f;
 		float position[2] = {0.f, 0.f};
 		float transform[4] = {0.f, 0.f, 0.f, 0.f};
 		float blur[2] = {0.f, 0.f};
@@ -43,6 +47,82 @@ public:
 		float alpha = 1.f;
 	};
 
+	// A group of copies of one sprite that repeats every "wrap" pixels in both
+	// directions, like the asteroids in a system. The vertex shader wraps each
+	// sprite into view, so every visible copy of it is drawn by a single
+	// instanced draw call.
+	class Field {
+	public:
+		uint32_t texture = 0;
+		float frameCount = 1.f;
+		float firstLayer = 0.f;
+		// The sprite's width and height, before zooming.
+		float size[2] = {0.f, 0.f};
+		float zoom = 1.f;
+		float wrap = 1.f;
+		// The top left corner of the area in which sprites may be visible, in
+		// world coordinates modulo the wrap, and in screen coordinates.
+		float start[2] = {0.f, 0.f};
+		float origin[2] = {0.f, 0.f};
+		// The size of that area, in world coordinates, and the number of copies
+		// of the field needed to cover it.
+		float limit[2] = {0.f, 0.f};
+		int copiesX = 1;
+		int copiesY = 1;
+		float centerVelocity[2] = {0.f, 0.f};
+		// The range of FieldItems that belong to this field.
+		size_t first = 0;
+		size_t count = 0;
+	};
+	// One sprite in a field. Its position is within the wrapped square.
+	class FieldItem {
+	public:
+		float position[2];
+		float velocity[2];
+		float unit[2];
+		float frame;
+	};
+
+	// All the particles of one effect. Each particle is uploaded as it was when
+	// it was created, and the vertex shader works out where it is now, which
+	// way it faces, and which frame of its animation it shows, so all of them
+	// are drawn by a single instanced draw call.
+	class Particles {
+	public:
+		uint32_t texture = 0;
+		float frameCount = 1.f;
+		float firstLayer = 0.f;
+		// The sprite's width and height, before zooming.
+		float size[2] = {0.f, 0.f};
+		float zoom = 1.f;
+		// The center of the view, in world coordinates, and the current step.
+		float center[2] = {0.f, 0.f};
+		float now = 0.f;
+		// The effect's animation settings, as in the Body class.
+		float delay = 0.f;
+		bool repeat = true;
+		bool rewind = false;
+		// The range of ParticleItems that belong to this effect.
+		size_t first = 0;
+		size_t count = 0;
+	};
+	// One particle, as it was on the step it was created.
+	class ParticleItem {
+	public:
+		float position[2];
+		float velocity[2];
+		// The facing and the spin per step, in degrees.
+		float angle;
+		float spin;
+		float birth;
+		float lifetime;
+		float frameRate;
+		float frameOffset;
+		// How far into its animation cycle the particle starts, if its effect
+		// starts at a random frame.
+		float phase;
+	};
+
 
 public:
 	// Initialize the shaders.
@@ -54,6 +134,19 @@ public:
 
 	static void Bind();
 	static void Add(const Item &item, bool withBlur = false);
+	// Draw the given items in order. Where possible, consecutive items with the
+	// same texture are drawn together, with a single instanced draw call.
+	static void Add(const std::vector<Item> &items, bool withBlur = false);
+	// Draw only the items in the range [first, end).
+	static void Add(const std::vector<Item> &items, size_t first, size_t end, bool withBlur = false);
+	// Check whether fields can be drawn. If not, each sprite in them must be
+	// drawn as its own item instead.
+	static bool CanDrawFields();
+	// Draw a field, using the given list of items.
+	static void Add(const Field &field, const std::vector<FieldItem> &items, bool withBlur = false);
+	// Draw the particles of one effect, using the given list of items. This
+	// can be done wherever fields can be drawn.
+	static void Add(const Particles &particles, const std::vector<ParticleItem> &items);
 	static void Unbind();
 
 
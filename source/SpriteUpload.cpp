@@ -0,0 +1,97 @@
+/* SpriteUpload.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SpriteUpload.h"
+
+#include "ImageBuffer.h"
+#include "Sprite.h"
+
+#include "opengl.h"
+
+using namespace std;
+
+namespace {
+	// The buffer that the frames are staged in. It is given new storage for
+	// each frame, so the driver never has to wait for the previous copy.
+	GLuint pixelBuffer = 0;
+}
+
+
+
+SpriteUpload::SpriteUpload(Sprite *sprite, ImageBuffer &buffer, bool is2x)
+	: sprite(sprite), buffer(&buffer), is2x(is2x)
+{
+}
+
+
+
+bool SpriteUpload::Step()
+{
+	if(!pixelBuffer)
+		glGenBuffers(1, &pixelBuffer);
+
+	const uint32_t format = buffer->CompressedFormat();
+	if(!texture)
+	{
+		glGenTextures(1, &texture);
+		OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, texture);
+
+		// Use linear interpolation and no wrapping.
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		// Compressed images are a fraction of the size, so they are uploaded
+		// all at once, when the texture is created, straight from the file they
+		// were read from rather than through the pixel buffer.
+		if(format)
+		{
+			glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, 0, format, buffer->Width(), buffer->Height(),
+				buffer->Frames(), 0, buffer->CompressedSize(), buffer->Data());
+			frame = buffer->Frames();
+		}
+		else
+		{
+			glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, buffer->Width(), buffer->Height(), buffer->Frames(),
+				0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		}
+	}
+	else
+	{
+		OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, texture);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixelBuffer);
+	}
+
+	if(frame < buffer->Frames())
+	{
+		GLsizeiptr size = sizeof(uint32_t) * buffer->Width() * buffer->Height();
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, size, buffer->Begin(0, frame), GL_STREAM_DRAW);
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, frame, buffer->Width(), buffer->Height(), 1,
+			GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		++frame;
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	OpenGL::BindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	if(frame < buffer->Frames())
+		return false;
+
+	sprite->SetTexture(is2x, texture);
+	buffer->Clear();
+	return true;
+}
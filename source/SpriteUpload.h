@@ -0,0 +1,54 @@
+/* SpriteUpload.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SPRITE_UPLOAD_H_
+#define SPRITE_UPLOAD_H_
+
+#include <cstdint>
+
+class ImageBuffer;
+class Sprite;
+
+
+
+// Uploading all the frames of a large sprite at once can take long enough to
+// make the game stutter, which matters when sprites are loaded while the game
+// is running (for example, when new ships are preloaded on entering a system).
+// This uploads the frames one at a time instead, through a pixel buffer object
+// so that the driver can copy them to the GPU asynchronously. The sprite keeps
+// its previous texture (if any) until every frame has been uploaded.
+class SpriteUpload {
+public:
+	// The frames must already have been prepared for the sprite (see
+	// SpriteAtlas::Add()), and the buffer must stay valid until this is done.
+	SpriteUpload(Sprite *sprite, ImageBuffer &buffer, bool is2x);
+
+	// Upload the next frame. Return true once every frame has been uploaded,
+	// at which point the sprite uses the new texture and the buffer is cleared.
+	bool Step();
+
+
+private:
+	Sprite *sprite;
+	ImageBuffer *buffer;
+	bool is2x;
+
+	uint32_t texture = 0;
+	int frame = 0;
+};
+
+
+
+#endif
@@ -28,9 +28,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SpriteSet.h"
 #include "System.h"
 
+#include "opengl.h"
+
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <string>
 
 using namespace std;
 
@@ -50,6 +53,8 @@ namespace {
 	// An additional zoom factor applied to stars/haze on top of the base zoom, to simulate parallax.
 	const double STAR_ZOOM = 0.70;
 	const double HAZE_ZOOM = 0.90;
+	// The most parallax layers of stars that are drawn.
+	const int MAX_PASSES = 3;
 
 	void AddHaze(DrawList &drawList, const std::vector<Body> &haze,
 		const Point &topLeft, const Point &bottomRight, double transparency)
@@ -141,9 +146,21 @@ void StarField::Draw(const Point &pos, const Point &vel, double zoom, const Syst
 	// Draw the starfield unless it is disabled in the preferences.
 	if(Preferences::Has("Draw starfield") && density > 0.)
 	{
-		glUseProgram(shader.Object());
-		glBindVertexArray(vao);
-
+		// Each pass draws a layer of stars, at a different zoom if there is
+		// parallax. Within a pass, enough copies of the whole repeating field
+		// are drawn to cover the screen, and the shader wraps each star's
+		// position into the visible area and skips any that fall outside it.
+		GLfloat scale[2 * MAX_PASSES] = {};
+		GLfloat rotate[4 * MAX_PASSES] = {};
+		GLfloat elongation[MAX_PASSES] = {};
+		GLfloat brightness[MAX_PASSES] = {};
+		GLfloat fraction[MAX_PASSES] = {};
+		GLfloat start[2 * MAX_PASSES] = {};
+		GLfloat translate[2 * MAX_PASSES] = {};
+		GLfloat limit[2 * MAX_PASSES] = {};
+		const int width = widthMod + 1;
+		int copiesX = 1;
+		int copiesY = 1;
 		for(int pass = 1; pass <= layers; pass++)
 		{
 			// Modify zoom for the first parallax layer.
@@ -156,51 +173,70 @@ void StarField::Draw(const Point &pos, const Point &vel, double zoom, const Syst
 			// farthest out zoom they are too small to draw well.
 			unit /= pow(zoom, .75);
 
-			float baseZoom = static_cast<float>(2. * zoom);
-			GLfloat scale[2] = {baseZoom / Screen::Width(), -baseZoom / Screen::Height()};
-			glUniform2fv(scaleI, 1, scale);
+			const int i = pass - 1;
+			float passZoom = static_cast<float>(2. * zoom);
+			scale[2 * i] = passZoom / Screen::Width();
+			scale[2 * i + 1] = -passZoom / Screen::Height();
 
-			GLfloat rotate[4] = {
-				static_cast<float>(unit.Y()), static_cast<float>(-unit.X()),
-				static_cast<float>(unit.X()), static_cast<float>(unit.Y())};
-			glUniformMatrix2fv(rotateI, pass, false, rotate);
+			rotate[4 * i] = unit.Y();
+			rotate[4 * i + 1] = -unit.X();
+			rotate[4 * i + 2] = unit.X();
+			rotate[4 * i + 3] = unit.Y();
 
-			glUniform1f(elongationI, length * zoom);
-			glUniform1f(brightnessI, min(1., pow(zoom, .5)));
+			elongation[i] = length * zoom;
+			brightness[i] = min(1., pow(zoom, .5));
+			// Denser star fields show more of the stars in each layer.
+			fraction[i] = density / (pass * layers);
 
 			// Stars this far beyond the border may still overlap the screen.
 			double borderX = fabs(vel.X()) + 1.;
 			double borderY = fabs(vel.Y()) + 1.;
 			// Find the absolute bounds of the star field we must draw.
-			int minX = pos.X() + (Screen::Left() - borderX) / zoom;
-			int minY = pos.Y() + (Screen::Top() - borderY) / zoom;
-			int maxX = pos.X() + (Screen::Right() + borderX) / zoom;
-			int maxY = pos.Y() + (Screen::Bottom() + borderY) / zoom;
-			// Round down to the start of the nearest tile.
-			minX &= ~(TILE_SIZE - 1l);
-			minY &= ~(TILE_SIZE - 1l);
-
-			for(int gy = minY; gy < maxY; gy += TILE_SIZE)
+			int minX = floor(pos.X() + (Screen::Left() - borderX) / zoom);
+			int minY = floor(pos.Y() + (Screen::Top() - borderY) / zoom);
+			int maxX = ceil(pos.X() + (Screen::Right() + borderX) / zoom);
+			int maxY = ceil(pos.Y() + (Screen::Bottom() + borderY) / zoom);
+
+			// Where the visible area begins within the repeating pattern.
+			start[2 * i] = minX & widthMod;
+			start[2 * i + 1] = minY & widthMod;
+			float shove = pow(-5., pass);
+			translate[2 * i] = minX - pos.X() + shove;
+			translate[2 * i + 1] = minY - pos.Y() + shove;
+			limit[2 * i] = maxX - minX;
+			limit[2 * i + 1] = maxY - minY;
+			copiesX = max(copiesX, (maxX - minX) / width + 1);
+			copiesY = max(copiesY, (maxY - minY) / width + 1);
+		}
+
+		OpenGL::UseProgram(shader.Object());
+		OpenGL::BindVertexArray(vao);
+
+		glUniform2fv(scaleI, MAX_PASSES, scale);
+		glUniformMatrix2fv(rotateI, MAX_PASSES, false, rotate);
+		glUniform1fv(elongationI, MAX_PASSES, elongation);
+		glUniform1fv(brightnessI, MAX_PASSES, brightness);
+		glUniform1fv(fractionI, MAX_PASSES, fraction);
+		glUniform2fv(startI, MAX_PASSES, start);
+		glUniform2fv(translateI, MAX_PASSES, translate);
+		glUniform2fv(limitI, MAX_PASSES, limit);
+		glUniform1f(widthI, width);
+		glUniform1i(copiesXI, copiesX);
+		glUniform1i(copiesI, copiesX * copiesY);
+
+		int instances = layers * copiesX * copiesY;
+		if(useInstancing)
+		{
+			glUniform1i(firstInstanceI, 0);
+			glDrawArraysInstanced(GL_TRIANGLES, 0, vertices, instances);
+		}
+		else
+			for(int instance = 0; instance < instances; ++instance)
 			{
-				float shove = pow(-5., pass);
-				for(int gx = minX; gx < maxX; gx += TILE_SIZE)
-				{
-					Point off = Point(gx + shove, gy + shove) - pos;
-					GLfloat translate[2] = {
-						static_cast<float>(off.X()),
-						static_cast<float>(off.Y())
-					};
-					glUniform2fv(translateI, 1, translate);
-
-					int index = (gx & widthMod) / TILE_SIZE + ((gy & widthMod) / TILE_SIZE) * tileCols;
-					int first = 6 * tileIndex[index];
-					int count = 6 * tileIndex[index + 1] - first;
-					glDrawArrays(GL_TRIANGLES, first, density * count / (pass * layers));
-				}
+				glUniform1i(firstInstanceI, instance);
+				glDrawArrays(GL_TRIANGLES, 0, vertices);
 			}
-		}
-		glBindVertexArray(0);
-		glUseProgram(0);
+
 	}
 
 	// Draw the background haze unless it is disabled in the preferences.
@@ -239,25 +275,49 @@ void StarField::Draw(const Point &pos, const Point &vel, double zoom, const Syst
 
 void StarField::SetUpGraphics()
 {
-	static const char *vertexCode =
+	// Without instancing, each copy of the star field is a separate draw call
+	// that says which copy it is.
+	useInstancing = OpenGL::HasInstancingSupport();
+	static const string vertexCode = string(
 		"// vertex starfield shader\n"
-		"uniform mat2 rotate;\n"
-		"uniform vec2 translate;\n"
-		"uniform vec2 scale;\n"
-		"uniform float elongation;\n"
-		"uniform float brightness;\n"
+		"uniform mat2 rotate[3];\n"
+		"uniform vec2 translate[3];\n"
+		"uniform vec2 scale[3];\n"
+		"uniform float elongation[3];\n"
+		"uniform float brightness[3];\n"
+		"uniform float fraction[3];\n"
+		"uniform vec2 start[3];\n"
+		"uniform vec2 limit[3];\n"
+		"uniform float width;\n"
+		"uniform int copiesX;\n"
+		"uniform int copies;\n"
+		"uniform int firstInstance;\n"
 
 		"in vec2 offset;\n"
 		"in float size;\n"
 		"in float corner;\n"
+		"in float rank;\n"
 		"out float fragmentAlpha;\n"
 		"out vec2 coord;\n"
 
 		"void main() {\n"
-		"  fragmentAlpha = brightness * (4. / (4. + elongation)) * size * .2 + .05;\n"
+		"  int instance = firstInstance") + (useInstancing ? " + gl_InstanceID" : "") + ";\n"
+		"  int pass = instance / copies;\n"
+		"  int copy = instance - pass * copies;\n"
+		// Wrap the star's position in the repeating pattern into the visible area.
+		"  vec2 local = mod(offset - start[pass], width) + width * vec2(copy % copiesX, copy / copiesX);\n"
+		"  if(rank > fraction[pass] || local.x > limit[pass].x || local.y > limit[pass].y)\n"
+		"  {\n"
+		// Skip this star by putting it outside of the clip volume.
+		"    fragmentAlpha = 0.;\n"
+		"    coord = vec2(0., 0.);\n"
+		"    gl_Position = vec4(0., 0., 2., 1.);\n"
+		"    return;\n"
+		"  }\n"
+		"  fragmentAlpha = brightness[pass] * (4. / (4. + elongation[pass])) * size * .2 + .05;\n"
 		"  coord = vec2(sin(corner), cos(corner));\n"
-		"  vec2 elongated = vec2(coord.x * size, coord.y * (size + elongation));\n"
-		"  gl_Position = vec4((rotate * elongated + translate + offset) * scale, 0, 1);\n"
+		"  vec2 elongated = vec2(coord.x * size, coord.y * (size + elongation[pass]));\n"
+		"  gl_Position = vec4((rotate[pass] * elongated + translate[pass] + local) * scale[pass], 0, 1);\n"
 		"}\n";
 
 	static const char *fragmentCode =
@@ -272,11 +332,11 @@ void StarField::SetUpGraphics()
 		"  finalColor = vec4(1, 1, 1, 1) * alpha;\n"
 		"}\n";
 
-	shader = Shader(vertexCode, fragmentCode);
+	shader = Shader(vertexCode.c_str(), fragmentCode);
 
 	// make and bind the VAO
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	// make and bind the VBO
 	glGenBuffers(1, &vbo);
@@ -285,12 +345,20 @@ void StarField::SetUpGraphics()
 	offsetI = shader.Attrib("offset");
 	sizeI = shader.Attrib("size");
 	cornerI = shader.Attrib("corner");
+	rankI = shader.Attrib("rank");
 
 	scaleI = shader.Uniform("scale");
 	rotateI = shader.Uniform("rotate");
 	elongationI = shader.Uniform("elongation");
 	translateI = shader.Uniform("translate");
 	brightnessI = shader.Uniform("brightness");
+	fractionI = shader.Uniform("fraction");
+	startI = shader.Uniform("start");
+	limitI = shader.Uniform("limit");
+	copiesXI = shader.Uniform("copiesX");
+	copiesI = shader.Uniform("copies");
+	firstInstanceI = shader.Uniform("firstInstance");
+	widthI = shader.Uniform("width");
 }
 
 
@@ -303,9 +371,11 @@ void StarField::MakeStars(int stars, int width)
 
 	widthMod = width - 1;
 
-	tileCols = (width / TILE_SIZE);
-	tileIndex.clear();
-	tileIndex.resize(static_cast<size_t>(tileCols) * tileCols, 0);
+	// The stars are divided into tiles. Within each tile they are given a rank
+	// in the order they were generated, so that sparser star fields can draw
+	// only some of the stars from each tile while keeping the same pattern.
+	const int tileCols = (width / TILE_SIZE);
+	vector<int> tileIndex(static_cast<size_t>(tileCols) * tileCols, 0);
 
 	vector<int> off;
 	static const int MAX_OFF = 50;
@@ -351,9 +421,10 @@ void StarField::MakeStars(int stars, int width)
 	tileIndex.insert(tileIndex.begin(), 0);
 	tileIndex.pop_back();
 	partial_sum(tileIndex.begin(), tileIndex.end(), tileIndex.begin());
+	const vector<int> tileStart = tileIndex;
 
-	// Each star consists of five vertices, each with four data elements.
-	vector<GLfloat> data(6 * 4 * stars, 0.f);
+	// Each star consists of six vertices, each with five data elements.
+	vector<GLfloat> data(6 * 5 * stars, 0.f);
 	for(auto it = temp.begin(); it != temp.end(); )
 	{
 		// Figure out what tile this star is in.
@@ -363,12 +434,17 @@ void StarField::MakeStars(int stars, int width)
 
 		// Randomize its sub-pixel position and its size / brightness.
 		int random = Random::Int(4096);
-		float fx = (x & (TILE_SIZE - 1)) + (random & 15) * 0.0625f;
-		float fy = (y & (TILE_SIZE - 1)) + (random >> 8) * 0.0625f;
+		float fx = x + (random & 15) * 0.0625f;
+		float fy = y + (random >> 8) * 0.0625f;
 		float size = (((random >> 4) & 15) + 20) * 0.0625f;
 
+		// This star is drawn if at least this fraction of its tile is.
+		int tileCount = (index + 1 < static_cast<int>(tileStart.size()) ? tileStart[index + 1] : stars)
+			- tileStart[index];
+		float rank = static_cast<float>(tileIndex[index] - tileStart[index] + 1) / tileCount;
+
 		// Fill in the data array.
-		auto dataIt = data.begin() + 6 * 4 * tileIndex[index]++;
+		auto dataIt = data.begin() + 6 * 5 * tileIndex[index]++;
 		const float CORNER[6] = {
 			static_cast<float>(0. * PI),
 			static_cast<float>(.5 * PI),
@@ -383,15 +459,15 @@ void StarField::MakeStars(int stars, int width)
 			*dataIt++ = fy;
 			*dataIt++ = size;
 			*dataIt++ = corner;
+			*dataIt++ = rank;
 		}
 	}
-	// Adjust the tile indices so that tileIndex[i] is the start of tile i.
-	tileIndex.insert(tileIndex.begin(), 0);
+	vertices = 6 * stars;
 
 	glBufferData(GL_ARRAY_BUFFER, sizeof(data.front()) * data.size(), data.data(), GL_STATIC_DRAW);
 
 	// Connect the xy to the "vert" attribute of the vertex shader.
-	constexpr auto stride = 4 * sizeof(GLfloat);
+	constexpr auto stride = 5 * sizeof(GLfloat);
 	glEnableVertexAttribArray(offsetI);
 	glVertexAttribPointer(offsetI, 2, GL_FLOAT, GL_FALSE,
 		stride, nullptr);
@@ -404,7 +480,11 @@ void StarField::MakeStars(int stars, int width)
 	glVertexAttribPointer(cornerI, 1, GL_FLOAT, GL_FALSE,
 		stride, reinterpret_cast<const GLvoid *>(3 * sizeof(GLfloat)));
 
+	glEnableVertexAttribArray(rankI);
+	glVertexAttribPointer(rankI, 1, GL_FLOAT, GL_FALSE,
+		stride, reinterpret_cast<const GLvoid *>(4 * sizeof(GLfloat)));
+
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
 }
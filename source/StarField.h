@@ -50,8 +50,8 @@ private:
 
 private:
 	int widthMod;
-	int tileCols;
-	std::vector<int> tileIndex;
+	// The number of vertices in the star field, six for each star.
+	int vertices = 0;
 
 	// Track the haze sprite, so we can animate the transition between different hazes.
 	const Sprite *lastSprite;
@@ -61,16 +61,27 @@ private:
 	Shader shader;
 	GLuint vao;
 	GLuint vbo;
+	bool useInstancing = false;
 
 	GLuint offsetI;
 	GLuint sizeI;
 	GLuint cornerI;
+	GLuint rankI;
 
+	// Each of these holds one value for each parallax layer.
 	GLuint scaleI;
 	GLuint rotateI;
 	GLuint elongationI;
 	GLuint translateI;
 	GLuint brightnessI;
+	GLuint fractionI;
+	GLuint startI;
+	GLuint limitI;
+
+	GLuint widthI;
+	GLuint copiesXI;
+	GLuint copiesI;
+	GLuint firstInstanceI;
 };
 
 
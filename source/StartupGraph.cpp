@@ -0,0 +1,130 @@
+/* StartupGraph.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "StartupGraph.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+
+
+size_t StartupGraph::Add(const string &name, Task task, const vector<size_t> &dependencies)
+{
+	nodes.emplace_back();
+	Node &node = nodes.back();
+	node.name = name;
+	node.task = std::move(task);
+	node.dependencies = dependencies;
+	return nodes.size() - 1;
+}
+
+
+
+bool StartupGraph::Step(double seconds)
+{
+	if(!hasBegun)
+	{
+		hasBegun = true;
+		begin = chrono::steady_clock::now();
+	}
+	double stop = Elapsed() + seconds;
+
+	// Poll every task at most once. A task that is done may let the ones that
+	// come after it start in the same step.
+	for(size_t count = 0; count < nodes.size() && !IsDone(); ++count)
+	{
+		Node &node = nodes[next];
+		next = (next + 1) % nodes.size();
+		if(node.isDone || !IsReady(node))
+			continue;
+
+		if(!node.isStarted)
+		{
+			node.isStarted = true;
+			node.start = Elapsed();
+		}
+		if(node.task())
+		{
+			node.isDone = true;
+			node.end = Elapsed();
+			node.order = done++;
+		}
+		if(Elapsed() >= stop)
+			break;
+	}
+	return IsDone();
+}
+
+
+
+bool StartupGraph::IsDone() const
+{
+	return done == nodes.size();
+}
+
+
+
+string StartupGraph::Report() const
+{
+	ostringstream out;
+	out << fixed << setprecision(0);
+
+	// Work backwards from the task that was done last. Each task on the path had
+	// to wait for whichever of its dependencies was done last.
+	vector<const Node *> path;
+	const Node *last = nullptr;
+	for(const Node &node : nodes)
+		if(node.isDone && (!last || node.order > last->order))
+			last = &node;
+	while(last)
+	{
+		path.push_back(last);
+		const Node *previous = nullptr;
+		for(size_t index : last->dependencies)
+			if(index < nodes.size() && (!previous || nodes[index].order > previous->order))
+				previous = &nodes[index];
+		last = previous;
+	}
+
+	out << "Startup took " << (path.empty() ? 0. : path.front()->end * 1000.) << " ms." << endl;
+	out << "Critical path:" << endl;
+	for(auto it = path.rbegin(); it != path.rend(); ++it)
+		out << "  " << (*it)->name << ": " << (*it)->start * 1000. << " to " << (*it)->end * 1000. << " ms" << endl;
+	out << "Other tasks:" << endl;
+	for(const Node &node : nodes)
+		if(find(path.begin(), path.end(), &node) == path.end())
+			out << "  " << node.name << ": " << node.start * 1000. << " to " << node.end * 1000. << " ms" << endl;
+	return out.str();
+}
+
+
+
+bool StartupGraph::IsReady(const Node &node) const
+{
+	for(size_t index : node.dependencies)
+		if(index < nodes.size() && !nodes[index].isDone)
+			return false;
+	return true;
+}
+
+
+
+double StartupGraph::Elapsed() const
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+}
@@ -0,0 +1,90 @@
+/* StartupGraph.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef STARTUP_GRAPH_H_
+#define STARTUP_GRAPH_H_
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+
+// The tasks that must be done before the game can show its main menu, and which
+// other tasks each of them has to wait for. Each task is polled on the main
+// thread, once all of its dependencies are done, until it reports that it is
+// done too. A task can either do a slice of its work each time it is polled,
+// or start some work in the background and then check whether it has finished.
+// The time that each step may spend polling tasks is limited, so the loading
+// screen stays responsive. Once everything is done, the graph can report which
+// chain of tasks took the longest, since that is what delayed the main menu.
+class StartupGraph {
+public:
+	// A task returns true once it is done.
+	using Task = std::function<bool()>;
+
+
+public:
+	// Add a task that can't start until the given tasks (by the indices that
+	// were returned when they were added) are done. Returns the task's index.
+	size_t Add(const std::string &name, Task task, const std::vector<size_t> &dependencies = {});
+
+	// Poll each task that is ready, spending no more than about the given number
+	// of seconds. Returns true if all the tasks are done.
+	bool Step(double seconds);
+	bool IsDone() const;
+
+	// Describe how long each task took, and which of them were on the path that
+	// determined how long the whole startup took.
+	std::string Report() const;
+
+
+private:
+	class Node {
+	public:
+		std::string name;
+		Task task;
+		std::vector<size_t> dependencies;
+		bool isStarted = false;
+		bool isDone = false;
+		// When the task was first polled, and when it was done, in seconds
+		// since the first step.
+		double start = 0.;
+		double end = 0.;
+		// The order in which the tasks were done.
+		size_t order = 0;
+	};
+
+
+private:
+	bool IsReady(const Node &node) const;
+	double Elapsed() const;
+
+
+private:
+	std::vector<Node> nodes;
+	size_t done = 0;
+	// Steps start polling where the previous one left off, so a task that does
+	// its work in slices can't keep the ones after it from being polled.
+	size_t next = 0;
+	bool hasBegun = false;
+	std::chrono::steady_clock::time_point begin;
+};
+
+
+
+#endif
@@ -27,8 +27,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Planet.h"
 #include "Random.h"
 #include "SpriteSet.h"
+#include "SystemGrid.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 
 using namespace std;
@@ -42,6 +44,9 @@ namespace {
 	const double VOLUME = 2000.;
 	// Above this supply amount, price differences taper off:
 	const double LIMIT = 20000.;
+
+	// The number of system indices handed out so far.
+	atomic<size_t> indexCount(0);
 }
 
 const double System::DEFAULT_NEIGHBOR_DISTANCE = 100.;
@@ -97,6 +102,8 @@ void System::Load(const DataNode &node, Set<Planet> &planets)
 		return;
 	name = node.Token(1);
 	isDefined = true;
+	// Any objects that are added or changed must be moved to the current date.
+	hasPositions = false;
 
 	// For the following keys, if this data node defines a new value for that
 	// key, the old values should be cleared (unless using the "add" keyword).
@@ -465,7 +472,7 @@ void System::Load(const DataNode &node, Set<Planet> &planets)
 // Update any information about the system that may have changed due to events,
 // or because the game was started, e.g. neighbors, solar wind and power, or
 // if the system is inhabited.
-void System::UpdateSystem(const Set<System> &systems, const set<double> &neighborDistances)
+void System::UpdateSystem(const SystemGrid &systems, const set<double> &neighborDistances)
 {
 	accessibleLinks.clear();
 	neighbors.clear();
@@ -694,7 +701,18 @@ const set<const System *> &System::VisibleNeighbors() const
 // Move the stellar objects to their positions on the given date.
 void System::SetDate(const Date &date)
 {
-	double now = date.DaysSinceEpoch();
+	const int day = date.DaysSinceEpoch();
+	if(hasPositions && day == positionDay)
+	{
+		// The orbits are unchanged, but defenses still reset whenever the date is set.
+		for(StellarObject &object : objects)
+			if(object.planet)
+				object.planet->ResetDefense();
+		return;
+	}
+	hasPositions = true;
+	positionDay = day;
+	double now = day;
 
 	for(StellarObject &object : objects)
 	{
@@ -927,6 +945,33 @@ double System::Exports(const string &commodity) const
 
 
 
+void System::GetTrade(const vector<string> &commodities, double *supply, double *exports, size_t stride) const
+{
+	for(size_t i = 0; i < commodities.size(); ++i)
+	{
+		auto it = trade.find(commodities[i]);
+		supply[i * stride] = (it == trade.end()) ? 0. : it->second.supply;
+		exports[i * stride] = (it == trade.end()) ? 0. : it->second.exports;
+	}
+}
+
+
+
+void System::SetSupply(const vector<string> &commodities, const double *supply, size_t stride)
+{
+	for(size_t i = 0; i < commodities.size(); ++i)
+	{
+		auto it = trade.find(commodities[i]);
+		if(it == trade.end())
+			continue;
+
+		it->second.supply = supply[i * stride];
+		it->second.Update();
+	}
+}
+
+
+
 // Get the probabilities of various fleets entering this system.
 const vector<RandomEvent<Fleet>> &System::Fleets() const
 {
@@ -966,6 +1011,27 @@ int System::MinimumFleetPeriod() const
 
 
 
+size_t System::Index() const
+{
+	return index;
+}
+
+
+
+size_t System::IndexCount()
+{
+	return indexCount;
+}
+
+
+
+size_t System::NextIndex()
+{
+	return indexCount++;
+}
+
+
+
 void System::LoadObject(const DataNode &node, Set<Planet> &planets, int parent)
 {
 	int index = objects.size();
@@ -1027,7 +1093,7 @@ void System::LoadObjectHelper(const DataNode &node, StellarObject &object, bool
 // Once the star map is fully loaded or an event has changed systems
 // or links, figure out which stars are "neighbors" of this one, i.e.
 // close enough to see or to reach via jump drive.
-void System::UpdateNeighbors(const Set<System> &systems, double distance)
+void System::UpdateNeighbors(const SystemGrid &systems, double distance)
 {
 	set<const System *> &neighborSet = neighbors[distance];
 
@@ -1037,17 +1103,12 @@ void System::UpdateNeighbors(const Set<System> &systems, double distance)
 		neighborSet.insert(system);
 
 	// Any other star system that is within the neighbor distance is also a
-	// neighbor.
-	for(const auto &it : systems)
-	{
-		const System &other = it.second;
-		// Skip systems that have no name or that are inaccessible.
-		if(it.first.empty() || other.Name().empty() || other.Inaccessible())
-			continue;
-
-		if(&other != this && other.Position().Distance(position) <= distance)
-			neighborSet.insert(&other);
-	}
+	// neighbor. Only systems that have a name and are accessible are indexed.
+	vector<const System *> nearby;
+	systems.Near(position, distance, nearby);
+	for(const System *other : nearby)
+		if(other != this)
+			neighborSet.insert(other);
 }
 
 
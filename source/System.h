@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "StellarObject.h"
 #include "WeightedList.h"
 
+#include <cstddef>
 #include <set>
 #include <string>
 #include <vector>
@@ -35,6 +36,7 @@ class Minable;
 class Planet;
 class Ship;
 class Sprite;
+class SystemGrid;
 
 
 
@@ -70,7 +72,7 @@ public:
 	void Load(const DataNode &node, Set<Planet> &planets);
 	// Update any information about the system that may have changed due to events,
 	// e.g. neighbors, solar wind and power, or if the system is inhabited.
-	void UpdateSystem(const Set<System> &systems, const std::set<double> &neighborDistances);
+	void UpdateSystem(const SystemGrid &systems, const std::set<double> &neighborDistances);
 
 	// Modify a system's links.
 	void Link(System *other);
@@ -161,6 +163,13 @@ public:
 	void SetSupply(const std::string &commodity, double tons);
 	double Supply(const std::string &commodity) const;
 	double Exports(const std::string &commodity) const;
+	// Copy the supply and exports of the given commodities into the given
+	// arrays, the entry for each commodity being "stride" elements after the
+	// previous one. Commodities that are not traded here get zero. The supply
+	// can be set in the same way, which ignores commodities not traded here.
+	void GetTrade(const std::vector<std::string> &commodities, double *supply, double *exports,
+		size_t stride) const;
+	void SetSupply(const std::vector<std::string> &commodities, const double *supply, size_t stride);
 
 	// Get the probabilities of various fleets entering this system.
 	const std::vector<RandomEvent<Fleet>> &Fleets() const;
@@ -173,6 +182,12 @@ public:
 	// The smallest arrival period of a fleet (or 0 if no fleets arrive)
 	int MinimumFleetPeriod() const;
 
+	// A number identifying this system among all the systems created so far,
+	// for indexing arrays of per-system data. Copies share the same index.
+	size_t Index() const;
+	// The number of indices handed out, i.e. the size such an array needs.
+	static size_t IndexCount();
+
 
 private:
 	void LoadObject(const DataNode &node, Set<Planet> &planets, int parent = -1);
@@ -180,7 +195,9 @@ private:
 	// Once the star map is fully loaded or an event has changed systems
 	// or links, figure out which stars are "neighbors" of this one, i.e.
 	// close enough to see or to reach via jump drive.
-	void UpdateNeighbors(const Set<System> &systems, double distance);
+	void UpdateNeighbors(const SystemGrid &systems, double distance);
+	// Hand out the index for a newly created system.
+	static size_t NextIndex();
 
 
 private:
@@ -197,6 +214,7 @@ private:
 
 
 private:
+	size_t index = NextIndex();
 	bool isDefined = false;
 	bool hasPosition = false;
 	// Name and position (within the star map) of this system.
@@ -230,6 +248,10 @@ private:
 	// order, updating positions, an object's parents will already be at the
 	// proper position before that object is updated).
 	std::vector<StellarObject> objects;
+	// The day the objects were last moved to, so that setting the same date
+	// again does not need to recompute their orbits.
+	int positionDay = 0;
+	bool hasPositions = false;
 	std::vector<Asteroid> asteroids;
 	const Sprite *haze = nullptr;
 	std::vector<RandomEvent<Fleet>> fleets;
@@ -0,0 +1,133 @@
+/* SystemGrid.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SystemGrid.h"
+
+#include "Rectangle.h"
+#include "System.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+
+
+// Index the given systems. Their positions are read now, so the grid must
+// be built again if any of them might have moved.
+void SystemGrid::Build(const vector<const System *> &list)
+{
+	systems.clear();
+	positions.clear();
+	firstInCell.clear();
+	columns = 0;
+	rows = 0;
+	if(list.empty())
+		return;
+
+	Point topLeft = list.front()->Position();
+	Point bottomRight = topLeft;
+	for(const System *system : list)
+	{
+		topLeft = min(topLeft, system->Position());
+		bottomRight = max(bottomRight, system->Position());
+	}
+
+	// Split the longer side of the bounds into about the square root of the
+	// number of systems, so that there is roughly one system per cell.
+	Point size = bottomRight - topLeft;
+	origin = topLeft;
+	cellSize = max(1., max(size.X(), size.Y()) / ceil(sqrt(list.size())));
+	columns = static_cast<int>(size.X() / cellSize) + 1;
+	rows = static_cast<int>(size.Y() / cellSize) + 1;
+
+	// Sort the systems into their cells by counting how many are in each.
+	auto CellOf = [this](const Point &position) -> size_t
+	{
+		int x = min(columns - 1, static_cast<int>((position.X() - origin.X()) / cellSize));
+		int y = min(rows - 1, static_cast<int>((position.Y() - origin.Y()) / cellSize));
+		return static_cast<size_t>(y) * columns + x;
+	};
+	firstInCell.assign(static_cast<size_t>(columns) * rows + 1, 0);
+	for(const System *system : list)
+		++firstInCell[CellOf(system->Position()) + 1];
+	for(size_t i = 1; i < firstInCell.size(); ++i)
+		firstInCell[i] += firstInCell[i - 1];
+
+	vector<unsigned> next(firstInCell.begin(), firstInCell.end() - 1);
+	systems.resize(list.size());
+	positions.resize(list.size());
+	for(const System *system : list)
+	{
+		unsigned index = next[CellOf(system->Position())]++;
+		systems[index] = system;
+		positions[index] = system->Position();
+	}
+}
+
+
+
+// Add every indexed system that is within the given distance of the given
+// point, or inside the given rectangle, to the result, in no particular order.
+void SystemGrid::Near(const Point &center, double radius, vector<const System *> &result) const
+{
+	Point corner(radius, radius);
+	ForEachIn(center - corner, center + corner, [this, &center, radius, &result](unsigned i) -> void
+	{
+		if(positions[i].Distance(center) <= radius)
+			result.push_back(systems[i]);
+	});
+}
+
+
+
+void SystemGrid::Inside(const Rectangle &area, vector<const System *> &result) const
+{
+	ForEachIn(area.TopLeft(), area.BottomRight(), [this, &area, &result](unsigned i) -> void
+	{
+		if(area.Contains(positions[i]))
+			result.push_back(systems[i]);
+	});
+}
+
+
+
+// Call the given function with the index of every system in the cells that
+// overlap the given corners.
+template <class Function>
+void SystemGrid::ForEachIn(const Point &topLeft, const Point &bottomRight, Function &&function) const
+{
+	if(systems.empty())
+		return;
+
+	// Clamp the corners to the grid before converting them to cells, so that
+	// far away searches cannot overflow the conversion.
+	Point low = (topLeft - origin) / cellSize;
+	Point high = (bottomRight - origin) / cellSize;
+	if(high.X() < 0. || high.Y() < 0. || low.X() >= columns || low.Y() >= rows)
+		return;
+	int left = static_cast<int>(max(0., low.X()));
+	int top = static_cast<int>(max(0., low.Y()));
+	int right = static_cast<int>(min(columns - 1., high.X()));
+	int bottom = static_cast<int>(min(rows - 1., high.Y()));
+
+	// The cells of each row are stored together, so each row is one range.
+	for(int y = top; y <= bottom; ++y)
+	{
+		size_t row = static_cast<size_t>(y) * columns;
+		for(unsigned i = firstInCell[row + left]; i < firstInCell[row + right + 1]; ++i)
+			function(i);
+	}
+}
@@ -0,0 +1,64 @@
+/* SystemGrid.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SYSTEM_GRID_H_
+#define SYSTEM_GRID_H_
+
+#include "Point.h"
+
+#include <vector>
+
+class Rectangle;
+class System;
+
+
+
+// A uniform grid over the positions of a collection of star systems. It finds
+// the systems near a point or inside a rectangle while only looking at the
+// systems in the grid cells that overlap the area being searched.
+class SystemGrid {
+public:
+	// Index the given systems. Their positions are read now, so the grid must
+	// be built again if any of them might have moved.
+	void Build(const std::vector<const System *> &systems);
+
+	// Add every indexed system that is within the given distance of the given
+	// point, or inside the given rectangle, to the result, in no particular order.
+	void Near(const Point &center, double radius, std::vector<const System *> &result) const;
+	void Inside(const Rectangle &area, std::vector<const System *> &result) const;
+
+
+private:
+	// Call the given function with the index of every system in the cells that
+	// overlap the given corners.
+	template <class Function>
+	void ForEachIn(const Point &topLeft, const Point &bottomRight, Function &&function) const;
+
+
+private:
+	Point origin;
+	double cellSize = 1.;
+	int columns = 0;
+	int rows = 0;
+	// The systems and their positions, sorted by cell, along with the index of
+	// the first system in each cell (and one past the last cell).
+	std::vector<const System *> systems;
+	std::vector<Point> positions;
+	std::vector<unsigned> firstInCell;
+};
+
+
+
+#endif
@@ -26,6 +26,12 @@ TestContext::TestContext(const Test *toRun) : callstack({{toRun, 0}})
 
 
 
+TestContext::TestContext(const Replay *toReplay) : replay(toReplay)
+{
+}
+
+
+
 const Test *TestContext::CurrentTest() const noexcept
 {
 	return callstack.empty() ? nullptr : callstack.back().test;
@@ -33,6 +39,13 @@ const Test *TestContext::CurrentTest() const noexcept
 
 
 
+Replay::Cursor *TestContext::CurrentReplay() noexcept
+{
+	return replay.Get() ? &replay : nullptr;
+}
+
+
+
 bool TestContext::ActiveTestStep::operator==(const ActiveTestStep &rhs) const
 {
 	return test == rhs.test && step == rhs.step;
@@ -16,6 +16,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef ENDLESS_SKY_AC_TESTCONTEXT_H_
 #define ENDLESS_SKY_AC_TESTCONTEXT_H_
 
+#include "Replay.h"
+
 #include <set>
 #include <vector>
 
@@ -27,7 +29,11 @@ friend class Test;
 public:
 	TestContext() = default;
 	TestContext(const Test *toRun);
+	// Constructor to be used when re-simulating a recorded flight.
+	explicit TestContext(const Replay *toReplay);
 	const Test *CurrentTest() const noexcept;
+	// Get the position in the replay being played, or null if there is none.
+	Replay::Cursor *CurrentReplay() noexcept;
 
 
 private:
@@ -51,6 +57,8 @@ private:
 	// Teststep to run.
 	unsigned int watchdog = 0;
 	std::set<ActiveTestStep> branchesSinceGameStep;
+
+	Replay::Cursor replay;
 };
 
 #endif
@@ -0,0 +1,89 @@
+/* TextureBudget.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "TextureBudget.h"
+
+#include "Sprite.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+
+void TextureBudget::SetLimit(size_t bytes)
+{
+	limit = bytes;
+}
+
+
+
+bool TextureBudget::Use(const Sprite *sprite)
+{
+	auto it = find(recent.begin(), recent.end(), sprite);
+	if(it != recent.end())
+	{
+		recent.splice(recent.begin(), recent, it);
+		return false;
+	}
+
+	recent.push_front(sprite);
+	return true;
+}
+
+
+
+vector<const Sprite *> TextureBudget::Evict()
+{
+	vector<const Sprite *> evicted;
+	size_t bytes = Bytes();
+	if(bytes <= limit || recent.empty())
+		return evicted;
+
+	// Start with the least recently used sprite, but never evict the most recent.
+	auto it = recent.end();
+	--it;
+	while(bytes > limit && it != recent.begin())
+	{
+		const Sprite *sprite = *it;
+		bool isLoading = !sprite->Bytes();
+		auto previous = prev(it);
+		if(!isLoading)
+		{
+			bytes -= sprite->Bytes();
+			evicted.push_back(sprite);
+			recent.erase(it);
+		}
+		it = previous;
+	}
+	return evicted;
+}
+
+
+
+size_t TextureBudget::Bytes() const
+{
+	size_t bytes = 0;
+	for(const Sprite *sprite : recent)
+		bytes += sprite->Bytes();
+	return bytes;
+}
+
+
+
+size_t TextureBudget::Count() const
+{
+	return recent.size();
+}
@@ -0,0 +1,58 @@
+/* TextureBudget.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEXTURE_BUDGET_H_
+#define TEXTURE_BUDGET_H_
+
+#include <cstddef>
+#include <list>
+#include <vector>
+
+class Sprite;
+
+
+
+// Keeps track of the sprites that can be unloaded and loaded again when they
+// are next needed, in the order they were last used. Once the texture memory
+// they use goes over the budget, the least recently used ones are chosen to be
+// unloaded. The most recently used sprite is always kept, even if it alone is
+// over the budget.
+class TextureBudget {
+public:
+	// Set the budget, in bytes.
+	void SetLimit(size_t bytes);
+
+	// Record that the given sprite is about to be drawn. Return true if it is
+	// not already loaded, meaning that it must be loaded now.
+	bool Use(const Sprite *sprite);
+	// Get the sprites that must be unloaded to get back within the budget, and
+	// forget about them. Sprites that are still loading are never included.
+	std::vector<const Sprite *> Evict();
+
+	// The texture memory used by the tracked sprites, in bytes.
+	size_t Bytes() const;
+	// The number of sprites that are loaded or being loaded.
+	size_t Count() const;
+
+
+private:
+	size_t limit = 0;
+	// The most recently used sprite is first.
+	std::list<const Sprite *> recent;
+};
+
+
+
+#endif
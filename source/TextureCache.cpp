@@ -0,0 +1,132 @@
+/* TextureCache.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "TextureCache.h"
+
+#include "Etc2Encoder.h"
+#include "Files.h"
+#include "ImageBuffer.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+
+using namespace std;
+
+namespace {
+	const uint8_t KTX_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x31, 0x31, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+	const uint32_t GL_RGBA_FORMAT = 0x1908;
+
+	void Write(string &out, uint32_t value)
+	{
+		out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+	}
+
+
+
+	// Add the given text to a 64-bit FNV-1a hash.
+	uint64_t Hash(uint64_t hash, const string &text)
+	{
+		for(char c : text)
+		{
+			hash ^= static_cast<unsigned char>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+}
+
+
+
+// Get the path where a compressed copy of the given sequence of frames would
+// be cached, or an empty string if they should not be cached.
+string TextureCache::Path(const vector<string> &frames)
+{
+#ifndef ES_GLES
+	// Only OpenGL ES drivers are sure to support ETC2 in hardware. Desktop
+	// drivers may decompress it in software, which would gain nothing.
+	return string();
+#else
+	if(frames.empty())
+		return string();
+	// The base game's images are already provided in compressed formats.
+	const string &first = frames.front();
+	if(!first.compare(0, Files::Images().length(), Files::Images()))
+		return string();
+	size_t images = first.rfind("/images/");
+	if(images == string::npos)
+		return string();
+
+	// Each sprite's frames are cached in one file, named for their paths, in a
+	// directory named for the plugin they came from.
+	uint64_t hash = 14695981039346656037ull;
+	for(const string &frame : frames)
+		hash = Hash(hash, frame + '\n');
+	char name[24];
+	snprintf(name, sizeof(name), "%016llx.ktx", static_cast<unsigned long long>(hash));
+
+	return Files::Config() + "texture cache/" + Files::Name(first.substr(0, images)) + "/" + name;
+#endif
+}
+
+
+
+// Check whether the cached copy at the given path is newer than all the
+// frames it was made from.
+bool TextureCache::IsCurrent(const string &path, const vector<string> &frames)
+{
+	if(!Files::Exists(path))
+		return false;
+
+	// An image that changed in the same second the cache was written may have
+	// changed after it, so it must be cached again.
+	time_t cached = Files::Timestamp(path);
+	for(const string &frame : frames)
+		if(Files::Timestamp(frame) >= cached)
+			return false;
+	return true;
+}
+
+
+
+// Compress the given premultiplied image and save it at the given path.
+void TextureCache::Save(const string &path, const ImageBuffer &image)
+{
+	string data = Etc2Encoder::Encode(image);
+
+	// Write a KTX header that KtxFile will accept: a compressed array texture
+	// with one layer per frame, no mipmaps, and no key / value data.
+	string out(reinterpret_cast<const char *>(KTX_IDENTIFIER), sizeof(KTX_IDENTIFIER));
+	Write(out, 0x04030201);
+	Write(out, 0);
+	Write(out, 1);
+	Write(out, 0);
+	Write(out, Etc2Encoder::FORMAT);
+	Write(out, GL_RGBA_FORMAT);
+	Write(out, image.Width());
+	Write(out, image.Height());
+	Write(out, 0);
+	Write(out, image.Frames() > 1 ? image.Frames() : 0);
+	Write(out, 1);
+	Write(out, 1);
+	Write(out, 0);
+	Write(out, data.size());
+	out += data;
+
+	// If the write is cut short, the file will fail to load next time, and the
+	// images will be compressed again.
+	Files::MakeDir(path.substr(0, path.rfind('/')));
+	Files::Write(path, out);
+}
@@ -0,0 +1,46 @@
+/* TextureCache.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TEXTURE_CACHE_H_
+#define TEXTURE_CACHE_H_
+
+#include <string>
+#include <vector>
+
+class ImageBuffer;
+
+
+
+// Many plugins only provide their images as PNG or JPG files, which are much
+// slower to load than compressed ones and take four times the video memory. The
+// first time such images are loaded, they are compressed into the ETC2 format
+// and saved as a KTX file in the config directory, with a separate directory
+// for each plugin, so that later runs can load the compressed copy instead. A
+// cached copy is only used if it is newer than every image it was made from.
+class TextureCache {
+public:
+	// Get the path where a compressed copy of the given sequence of frames would
+	// be cached, or an empty string if they should not be cached.
+	static std::string Path(const std::vector<std::string> &frames);
+	// Check whether the cached copy at the given path is newer than all the
+	// frames it was made from.
+	static bool IsCurrent(const std::string &path, const std::vector<std::string> &frames);
+	// Compress the given premultiplied image and save it at the given path.
+	static void Save(const std::string &path, const ImageBuffer &image);
+};
+
+
+
+#endif
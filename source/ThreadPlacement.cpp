@@ -0,0 +1,200 @@
+/* ThreadPlacement.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "ThreadPlacement.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace {
+	// Threads that load data are given this much less priority than the others.
+	const int LOADER_NICENESS = 5;
+
+	class Topology {
+	public:
+		// Whether each core is a performance core.
+		vector<bool> isPerformance;
+		unsigned performance = 0;
+		unsigned efficiency = 0;
+	};
+
+
+
+	// Read a single number from the given file, or return 0 if it can't be read.
+	int64_t ReadNumber(const string &path)
+	{
+		ifstream in(path);
+		int64_t value = 0;
+		if(in >> value)
+			return value;
+		return 0;
+	}
+
+
+
+	Topology Detect()
+	{
+		const unsigned cores = max(1u, thread::hardware_concurrency());
+		vector<int64_t> capacities(cores);
+#ifdef __linux__
+		// The scheduler's own rating of each core is the best guide, where the
+		// kernel provides it. Otherwise, faster cores are the bigger ones.
+		for(unsigned i = 0; i < cores; ++i)
+		{
+			const string cpu = "/sys/devices/system/cpu/cpu" + to_string(i) + "/";
+			capacities[i] = ReadNumber(cpu + "cpu_capacity");
+			if(!capacities[i])
+				capacities[i] = ReadNumber(cpu + "cpufreq/cpuinfo_max_freq");
+		}
+#endif
+		Topology topology;
+		topology.isPerformance = ThreadPlacement::Classify(capacities);
+		topology.performance = count(topology.isPerformance.begin(), topology.isPerformance.end(), true);
+		topology.efficiency = cores - topology.performance;
+		return topology;
+	}
+
+
+
+	const Topology &GetTopology()
+	{
+		static const Topology topology = Detect();
+		return topology;
+	}
+
+
+
+#ifdef __linux__
+	// Keep the calling thread on the cores of the given class.
+	void Pin(const Topology &topology, bool performance)
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for(size_t i = 0; i < topology.isPerformance.size(); ++i)
+			if(topology.isPerformance[i] == performance)
+				CPU_SET(i, &set);
+		// This may fail if the system keeps the game to certain cores, in which
+		// case the thread is simply left where it is.
+		sched_setaffinity(0, sizeof(set), &set);
+	}
+#endif
+}
+
+
+
+// Keep the calling thread on the cores that suit the given role.
+void ThreadPlacement::Assign(Role role)
+{
+#ifdef __linux__
+	if(role == Role::LOADER)
+		setpriority(PRIO_PROCESS, syscall(SYS_gettid), LOADER_NICENESS);
+
+	const Topology &topology = GetTopology();
+	if(!topology.efficiency)
+		return;
+
+	if(role == Role::SIMULATION || role == Role::RENDER)
+		Pin(topology, true);
+	else if(role == Role::LOADER || role == Role::AUDIO)
+		Pin(topology, false);
+	else
+	{
+		// Workers may run anywhere, even if the thread that made them may not.
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for(size_t i = 0; i < topology.isPerformance.size(); ++i)
+			CPU_SET(i, &set);
+		sched_setaffinity(0, sizeof(set), &set);
+	}
+#endif
+}
+
+
+
+// Get the number of cores of each class. If the cores are all alike, they
+// are all counted as performance cores.
+unsigned ThreadPlacement::PerformanceCores()
+{
+	return GetTopology().performance;
+}
+
+
+
+unsigned ThreadPlacement::EfficiencyCores()
+{
+	return GetTopology().efficiency;
+}
+
+
+
+// Get how many background threads the JobPool and the SpriteQueue should
+// have by default.
+unsigned ThreadPlacement::WorkerCount()
+{
+	// Leave one core for the main thread and one for the thread calling
+	// ParallelFor(). On a device with two classes of cores, those two are
+	// performance cores, and half the efficiency cores are left to the loaders.
+	const Topology &topology = GetTopology();
+	const unsigned performance = topology.performance > 2 ? topology.performance - 2 : 0;
+	if(!topology.efficiency)
+		return performance;
+	return performance + topology.efficiency / 2;
+}
+
+
+
+unsigned ThreadPlacement::LoaderCount()
+{
+	const Topology &topology = GetTopology();
+	if(!topology.efficiency)
+		return max(4u, topology.performance);
+	return max(2u, topology.efficiency);
+}
+
+
+
+// Sort cores with the given relative capacities into classes, returning
+// true for each performance core. A capacity of zero means it is unknown.
+vector<bool> ThreadPlacement::Classify(const vector<int64_t> &capacities)
+{
+	vector<bool> isPerformance(capacities.size(), true);
+	if(capacities.empty() || count(capacities.begin(), capacities.end(), 0))
+		return isPerformance;
+
+	// Cores that differ by only a little, like the "favored" cores of some
+	// desktop processors, are treated as all alike.
+	const auto range = minmax_element(capacities.begin(), capacities.end());
+	if(*range.first * 4 >= *range.second * 3)
+		return isPerformance;
+
+	// Some devices have three sizes of cores. The middle ones are still much
+	// closer to the biggest ones than to the smallest, so the cores are split
+	// halfway between the two.
+	const int64_t threshold = (*range.first + *range.second) / 2;
+	for(size_t i = 0; i < capacities.size(); ++i)
+		isPerformance[i] = (capacities[i] > threshold);
+	return isPerformance;
+}
@@ -0,0 +1,64 @@
+/* ThreadPlacement.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef THREAD_PLACEMENT_H_
+#define THREAD_PLACEMENT_H_
+
+#include <cstdint>
+#include <vector>
+
+
+
+// Many phones have some fast "performance" cores and some slower "efficiency"
+// cores. Left to itself, the scheduler may run the simulation on a slow core
+// while sprites are being decoded on the fast ones. Each of the game's threads
+// says what role it has when it starts, and is then kept on the cores that suit
+// that role: the simulation and the rendering threads on the performance cores,
+// and the threads that load or decode data on the efficiency cores, at a lower
+// priority. Which cores are which is read from /sys the first time it is
+// needed. On devices whose cores are all alike, and on other platforms, threads
+// are left wherever the scheduler puts them.
+class ThreadPlacement {
+public:
+	enum class Role : int {
+		SIMULATION,
+		RENDER,
+		WORKER,
+		LOADER,
+		AUDIO
+	};
+
+
+public:
+	// Keep the calling thread on the cores that suit the given role.
+	static void Assign(Role role);
+
+	// Get the number of cores of each class. If the cores are all alike, they
+	// are all counted as performance cores.
+	static unsigned PerformanceCores();
+	static unsigned EfficiencyCores();
+	// Get how many background threads the JobPool and the SpriteQueue should
+	// have by default.
+	static unsigned WorkerCount();
+	static unsigned LoaderCount();
+
+	// Sort cores with the given relative capacities into classes, returning
+	// true for each performance core. A capacity of zero means it is unknown.
+	static std::vector<bool> Classify(const std::vector<int64_t> &capacities);
+};
+
+
+
+#endif
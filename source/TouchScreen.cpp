@@ -33,6 +33,18 @@ namespace
 			(f.y - .5) * Screen::Height()
 		);
 	}
+
+
+	void UpdatePoints()
+	{
+		static std::vector<Point> s_points;
+		s_points.clear();
+		for(auto& kv: g_fingers)
+			s_points.push_back(kv.second);
+
+		std::lock_guard<std::mutex> lock(g_finger_points_mutex);
+		g_finger_points.swap(s_points);
+	}
 }
 
 
@@ -61,13 +73,33 @@ void TouchScreen::Handle(const SDL_Event &event)
 	default:
 		return;
 	}
-	static std::vector<Point> s_points;
-	s_points.clear();
-	for(auto& kv: g_fingers)
-		s_points.push_back(kv.second);
+	UpdatePoints();
+}
 
-	std::lock_guard<std::mutex> lock(g_finger_points_mutex);
-	g_finger_points.swap(s_points);
+
+
+void TouchScreen::Latch()
+{
+	if(g_fingers.empty())
+		return;
+
+	// Only the motion events are looked at, and they are left in the queue so
+	// that they are still handled as usual in the next frame.
+	SDL_PumpEvents();
+	SDL_Event events[64];
+	int count = SDL_PeepEvents(events, 64, SDL_PEEKEVENT, SDL_FINGERMOTION, SDL_FINGERMOTION);
+	bool changed = false;
+	for(int i = 0; i < count; ++i)
+	{
+		auto it = g_fingers.find(events[i].tfinger.fingerId);
+		if(it != g_fingers.end())
+		{
+			it->second = ToScreenCoordinates(events[i].tfinger);
+			changed = true;
+		}
+	}
+	if(changed)
+		UpdatePoints();
 }
 
 
@@ -100,4 +132,15 @@ std::vector<Point> TouchScreen::Points()
 	//	}
 	//}
 	//return ret;
+}
+
+
+
+bool TouchScreen::Position(SDL_FingerID finger, Point &position)
+{
+	auto it = g_fingers.find(finger);
+	if(it == g_fingers.end())
+		return false;
+	position = it->second;
+	return true;
 }
\ No newline at end of file
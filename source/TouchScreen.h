@@ -24,8 +24,15 @@ class TouchScreen
 {
 public:
    static void Handle(const SDL_Event& event);
+   // Update the position of each finger from any motion events that have
+   // arrived since this frame's events were handled, without removing them
+   // from the queue. Call this just before the positions are used, so that
+   // they are as recent as possible.
+   static void Latch();
 
    static std::vector<Point> Points();
+   // Get the latest position of the given finger, if it is touching the screen.
+   static bool Position(SDL_FingerID finger, Point &position);
 };
 
 
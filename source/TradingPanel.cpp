@@ -98,6 +98,14 @@ void TradingPanel::Step()
 
 
 
+// Prices and cargo only change when the player buys or sells something.
+bool TradingPanel::IsAnimated() const noexcept
+{
+	return false;
+}
+
+
+
 void TradingPanel::Draw()
 {
 	const Interface *tradeUi = GameData::Interfaces().Get("trade");
@@ -187,8 +195,8 @@ void TradingPanel::Draw()
 	for(const Trade::Commodity &commodity : GameData::Commodities())
 	{
 		y += 20;
-		int price = system.Trade(commodity.name);
-		int hold = player.Cargo().Get(commodity.name);
+		int price = GameData::CommodityPrice(system, i);
+		int hold = player.Cargo().GetCommodity(i);
 
 		bool isSelected = (i++ == selectedRow);
 		const Color &color = (isSelected ? selected : unselected);
@@ -267,10 +275,12 @@ bool TradingPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command,
 		Buy(1000000000);
 	else if(key == 'S' || (key == 's' && (mod & KMOD_SHIFT)))
 	{
-		for(const auto &it : GameData::Commodities())
+		const vector<Trade::Commodity> &commodities = GameData::Commodities();
+		for(size_t i = 0; i < commodities.size(); ++i)
 		{
-			int64_t amount = player.Cargo().Get(it.name);
-			int64_t price = system.Trade(it.name);
+			const Trade::Commodity &it = commodities[i];
+			int64_t amount = player.Cargo().GetCommodity(i);
+			int64_t price = GameData::CommodityPrice(system, i);
 			if(!price || !amount)
 				continue;
 
@@ -279,7 +289,7 @@ bool TradingPanel::KeyDown(SDL_Keycode key, Uint16 mod, const Command &command,
 			profit += amount * price + basis;
 			tonsSold += amount;
 
-			player.Cargo().Remove(it.name, amount);
+			player.Cargo().RemoveCommodity(i, amount);
 			player.Accounts().AddCredits(amount * price);
 			GameData::AddPurchase(system, it.name, -amount);
 		}
@@ -364,7 +374,7 @@ void TradingPanel::Buy(int64_t amount)
 	else
 		amount *= std::stoi(sellMultiplier.GetSelected().substr(2));
 	const string &type = GameData::Commodities()[selectedRow].name;
-	int64_t price = system.Trade(type);
+	int64_t price = GameData::CommodityPrice(system, selectedRow);
 	if(!price)
 		return;
 
@@ -376,14 +386,14 @@ void TradingPanel::Buy(int64_t amount)
 	else
 	{
 		// Selling cargo:
-		amount = max<int64_t>(amount, -player.Cargo().Get(type));
+		amount = max<int64_t>(amount, -player.Cargo().GetCommodity(selectedRow));
 
 		int64_t basis = player.GetBasis(type, amount);
 		player.AdjustBasis(type, basis);
 		profit += -amount * price + basis;
 		tonsSold += -amount;
 	}
-	amount = player.Cargo().Add(type, amount);
+	amount = player.Cargo().AddCommodity(selectedRow, amount);
 	player.Accounts().AddCredits(-amount * price);
 	GameData::AddPurchase(system, type, amount);
 }
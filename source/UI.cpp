@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GamePad.h"
 #include "GamepadCursor.h"
 #include "Gesture.h"
+#include "GpuProfiler.h"
 #include "LineShader.h"
 #include "Panel.h"
 #include "PointerShader.h"
@@ -58,6 +59,8 @@ bool UI::Handle(const SDL_Event &event)
 		// Panels that are about to be popped cannot handle any other events.
 		if(count(toPop.begin(), toPop.end(), it->get()))
 			continue;
+		// Any panel that sees this event may change how it looks.
+		(*it)->isDirty = true;
 
 		if(event.type == SDL_MOUSEMOTION)
 		{
@@ -295,19 +298,57 @@ void UI::StepAll()
 // Draw all the panels.
 void UI::DrawAll()
 {
-	// First, clear all the clickable zones. New ones will be added in the
-	// course of drawing the screen.
-	for(const shared_ptr<Panel> &it : stack)
-		it->ClearZones();
+	// The engine times its own drawing, which is not counted here.
+	GpuProfiler::Zone zone("GPU: panels");
 
 	// Find the topmost full-screen panel. Nothing below that needs to be drawn.
 	vector<shared_ptr<Panel>>::const_iterator it = stack.end();
 	while(it != stack.begin())
 		if((*--it)->IsFullScreen())
 			break;
+	for(auto hidden = stack.cbegin(); hidden != it; ++hidden)
+		(*hidden)->ClearZones();
+
+	// If there are panels visible under the top one, and none of them are
+	// animated, they can be drawn once into the cache and then reused until
+	// one of them receives an event or the stack changes.
+	vector<shared_ptr<Panel>>::const_iterator top = stack.end();
+	bool useCache = (it != top && it != --top);
+	bool isCurrent = useCache && cache.IsValid();
+	for(auto cit = it; useCache && cit != top; ++cit)
+	{
+		useCache &= !(*cit)->IsAnimated();
+		isCurrent &= !(*cit)->isDirty;
+	}
+	if(!useCache)
+		cache.Release();
+	else if(isCurrent)
+		it = top;
+	else
+	{
+		// Draw the panels under the top one into the cache. If that fails,
+		// they are drawn to the screen directly, as usual.
+		bool isCached = cache.Begin();
+		for( ; it != top; ++it)
+		{
+			(*it)->ClearZones();
+			(*it)->Draw();
+			(*it)->isDirty = false;
+		}
+		if(isCached)
+			cache.End();
+	}
+	if(useCache && cache.IsValid())
+		cache.Draw();
 
+	// Clear the clickable zones of any panel that is being drawn. New ones
+	// will be added in the course of drawing the screen. Cached panels keep
+	// the zones they had when they were drawn.
 	for( ; it != stack.end(); ++it)
+	{
+		(*it)->ClearZones();
 		(*it)->Draw();
+	}
 
 	// If the panel has a valid ui element selected, draw a rotating indicator
 	// around it
@@ -316,6 +357,25 @@ void UI::DrawAll()
 
 
 
+// Check if anything that is drawn may change even if no events happen.
+bool UI::IsAnimated() const
+{
+	if(GamepadCursor::Enabled())
+		return true;
+
+	vector<shared_ptr<Panel>>::const_iterator it = stack.end();
+	while(it != stack.begin())
+	{
+		if((*--it)->IsAnimated())
+			return true;
+		if((*it)->IsFullScreen())
+			break;
+	}
+	return false;
+}
+
+
+
 // Add the given panel to the stack. UI is responsible for deleting it.
 void UI::Push(Panel *panel)
 {
@@ -386,6 +446,7 @@ void UI::Reset()
 	stack.clear();
 	toPush.clear();
 	toPop.clear();
+	cache.Invalidate();
 	isDone = false;
 }
 
@@ -515,7 +576,10 @@ void UI::PushOrPop()
 {
 	// If panel state is changing, reset the controller cursor state
 	if(!toPush.empty() || !toPop.empty())
+	{
 		GamepadCursor::SetEnabled(false);
+		cache.Invalidate();
+	}
 
 	// Handle any panels that should be added.
 	for(shared_ptr<Panel> &panel : toPush)
@@ -17,6 +17,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #define UI_H_
 
 #include "Panel.h"
+#include "PanelCache.h"
 #include "Point.h"
 
 #include <memory>
@@ -43,6 +44,8 @@ public:
 	void StepAll();
 	// Draw all the panels.
 	void DrawAll();
+	// Check if anything that is drawn may change even if no events happen.
+	bool IsAnimated() const;
 
 	// Add the given panel to the stack. If you do not want a panel to be
 	// deleted when it is popped, save a copy of its shared pointer elsewhere.
@@ -103,6 +106,9 @@ private:
 	std::vector<std::shared_ptr<Panel>> toPush;
 	std::vector<const Panel *> toPop;
 
+	// An image of the panels under the top one, if none of them are animated.
+	PanelCache cache;
+
 	uint32_t lastTap = 0;
 	// Track which finger was used for zone/panels, so we send followup motion/
 	// finger controls to the correct one.
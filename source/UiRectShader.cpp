@@ -32,6 +32,10 @@ namespace {
 
 	GLuint vao;
 	GLuint vbo;
+
+	// The program keeps its uniform values between draws, so the scale only
+	// has to be set again when the screen size changes.
+	GLfloat lastScale[2] = {0.f, 0.f};
 }
 
 
@@ -89,13 +93,14 @@ void UiRectShader::Init(const Color& border1, const Color& border2, const Color&
 
 	shader = Shader(vertexCode, fragmentCode.c_str());
 	scaleI = shader.Uniform("scale");
+	lastScale[0] = lastScale[1] = 0.f;
 	centerI = shader.Uniform("center");
 	sizeI = shader.Uniform("size");
 	colorI = shader.Uniform("color");
 
 	// Generate the vertex data for drawing sprites.
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -113,7 +118,7 @@ void UiRectShader::Init(const Color& border1, const Color& border2, const Color&
 
 	// unbind the VBO and VAO
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
 }
 
 
@@ -123,11 +128,16 @@ void UiRectShader::Fill(const Point &center, const Point &size, const Color &col
 	if(!shader.Object())
 		throw std::runtime_error("UiRectShader: Draw() called before Init().");
 
-	glUseProgram(shader.Object());
-	glBindVertexArray(vao);
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindVertexArray(vao);
 
 	GLfloat scale[2] = {2.f / Screen::Width(), -2.f / Screen::Height()};
-	glUniform2fv(scaleI, 1, scale);
+	if(scale[0] != lastScale[0] || scale[1] != lastScale[1])
+	{
+		glUniform2fv(scaleI, 1, scale);
+		lastScale[0] = scale[0];
+		lastScale[1] = scale[1];
+	}
 
 	GLfloat centerV[2] = {static_cast<float>(center.X()), static_cast<float>(center.Y())};
 	glUniform2fv(centerI, 1, centerV);
@@ -138,7 +148,4 @@ void UiRectShader::Fill(const Point &center, const Point &size, const Color &col
 	glUniform4fv(colorI, 1, color.Get());
 
 	glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-	glBindVertexArray(0);
-	glUseProgram(0);
 }
@@ -15,12 +15,14 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "UniverseObjects.h"
 
+#include "DataCache.h"
 #include "DataFile.h"
 #include "DataNode.h"
 #include "Files.h"
 #include "text/FontSet.h"
 #include "ImageSet.h"
 #include "Information.h"
+#include "JobPool.h"
 #include "Logger.h"
 #include "MaskManager.h"
 #include "Music.h"
@@ -33,8 +35,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "StarField.h"
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <utility>
 #include <vector>
@@ -44,11 +48,43 @@ using namespace std;
 
 
 namespace {
+	// Check whether the given path is a data file, rather than e.g. an image.
+	bool IsDataFile(const string &path)
+	{
+		return path.length() >= 4 && !path.compare(path.length() - 4, 4, ".txt");
+	}
+
+	// Get the type and name of the object that the given root node of a data
+	// file defines. Only objects that are kept in a Set can be reloaded; for any
+	// other node, this returns empty strings.
+	pair<string, string> Definition(const DataNode &node)
+	{
+		static const set<string> RELOADABLE = {
+			"color", "conversation", "effect", "event", "fleet", "formation", "galaxy",
+			"government", "hazard", "interface", "minable", "mission", "news", "outfit",
+			"outfitter", "person", "phrase", "planet", "ship", "shipyard", "system",
+			"test", "test-data", "wormhole"
+		};
+		const string &key = node.Token(0);
+		if(node.Size() < (key == "color" ? 5 : 2) || !RELOADABLE.count(key))
+			return pair<string, string>();
+		// Ship variants are stored under the variant's name.
+		return make_pair(key, node.Token((key == "ship" && node.Size() > 2) ? 2 : 1));
+	}
+
+	// Replace the named object in the given set with a default one, without
+	// changing its address.
+	template <class Type>
+	void ResetObject(Set<Type> &objects, const string &name)
+	{
+		*objects.Get(name) = Type();
+	}
+
 	// TODO (C++14): make these 3 methods generic lambdas visible only to the CheckReferences method.
-	// Log a warning for an "undefined" class object that was never loaded from disk.
-	void Warn(const string &noun, const string &name)
+	// Record a warning for an "undefined" class object that was never loaded from disk.
+	void Warn(vector<string> &warnings, const string &noun, const string &name)
 	{
-		Logger::LogError("Warning: " + noun + " \"" + name + "\" is referred to, but not fully defined.");
+		warnings.push_back(noun + " \"" + name + "\" is referred to, but not fully defined.");
 	}
 	// Class objects with a deferred definition should still get named when content is loaded.
 	template <class Type>
@@ -63,47 +99,94 @@ namespace {
 	}
 	// Set the name of an "undefined" class object, so that it can be written to the player's save.
 	template <class Type>
-	void NameAndWarn(const string &noun, pair<const string, Type> &it)
+	void NameAndWarn(vector<string> &warnings, const string &noun, pair<const string, Type> &it)
 	{
 		it.second.SetName(it.first);
-		Warn(noun, it.first);
+		Warn(warnings, noun, it.first);
 	}
 }
 
 
 
-future<void> UniverseObjects::Load(const vector<string> &sources, bool debugMode)
+future<void> UniverseObjects::Load(const vector<string> &sources, bool debugMode, bool useCache)
 {
 	progress = 0.;
 
+	// Many of these objects are never used in a given session, so they are only
+	// loaded when first needed. In debug mode, everything is loaded right away so
+	// that any problems with the data are reported while the game is loading.
+	conversations.SetLoader([](Conversation &conversation, const DataNode &node) -> void
+		{ conversation.Load(node); }, !debugMode);
+	missions.SetLoader([](Mission &mission, const DataNode &node) -> void { mission.Load(node); }, !debugMode);
+	news.SetLoader([](News &news, const DataNode &node) -> void { news.Load(node); }, !debugMode);
+	phrases.SetLoader([](Phrase &phrase, const DataNode &node) -> void { phrase.Load(node); }, !debugMode);
+
 	// We need to copy any variables used for loading to avoid a race condition.
 	// 'this' is not copied, so 'this' shouldn't be accessed after calling this
 	// function (except for calling GetProgress which is safe due to the atomic).
-	return async(launch::async, [this, sources, debugMode]() noexcept -> void
+	return async(launch::async, [this, sources, debugMode, useCache]() noexcept -> void
 		{
-			vector<string> files;
-			for(const string &source : sources)
-			{
-				// Iterate through the paths starting with the last directory given. That
-				// is, things in folders near the start of the path have the ability to
-				// override things in folders later in the path.
-				auto list = Files::RecursiveList(source + "data/");
-				files.reserve(files.size() + list.size());
-				files.insert(files.end(),
-						make_move_iterator(list.begin()),
-						make_move_iterator(list.end()));
-			}
-
+			vector<string> files = ListFiles(sources);
+			if(debugMode)
+				this->sources = sources;
+
+			// Parsing each file is independent of every other file, so that can be
+			// done in parallel. The definitions must be added in the original order,
+			// though, so that later files can override earlier ones. To limit how
+			// much memory this uses, only a few files are parsed ahead at a time.
+			JobPool pool(JobPool::DefaultThreadCount());
+			const size_t batchSize = 8 * pool.Concurrency();
+			vector<DataFile> parsed;
+			// Files that had to be parsed are added to the cache, if one is used.
+			unique_ptr<DataCache> cache(useCache ? new DataCache(Files::Config() + "data cache.bin") : nullptr);
+			vector<string> serialized;
+
+			// Parsing a file counts as half of the progress for it, and adding its
+			// definitions as the other half.
 			const double step = 1. / (static_cast<int>(files.size()) + 1);
-			for(const auto &path : files)
+			auto addProgress = [this](double amount) noexcept -> void
 			{
-				LoadFile(path, debugMode);
-
-				// Increment the atomic progress by one step.
+				// Increment the atomic progress by the given amount.
 				// We use acquire + release to prevent any reordering.
 				auto val = progress.load(memory_order_acquire);
-				progress.store(val + step, memory_order_release);
+				progress.store(val + amount, memory_order_release);
+			};
+
+			for(size_t first = 0; first < files.size(); first += batchSize)
+			{
+				const size_t count = min(batchSize, files.size() - first);
+				parsed.clear();
+				parsed.resize(count);
+				serialized.clear();
+				serialized.resize(count);
+				pool.ParallelFor(count, [&files, &parsed, &serialized, &cache, first](size_t i) -> void
+					{
+						const string &path = files[first + i];
+						if(!IsDataFile(path) || (cache && cache->Get(path, parsed[i])))
+							return;
+						parsed[i].Load(path);
+						if(cache)
+							serialized[i] = parsed[i].Serialize();
+					});
+				addProgress(.5 * step * count);
+
+				for(size_t i = 0; i < count; ++i)
+				{
+					LoadFile(files[first + i], parsed[i], debugMode);
+					addProgress(.5 * step);
+					if(debugMode && IsDataFile(files[first + i]))
+						sourceFiles.push_back(Record(files[first + i], parsed[i]));
+
+					if(!cache || !IsDataFile(files[first + i]))
+						continue;
+					if(serialized[i].empty())
+						cache->Keep(files[first + i]);
+					else
+						cache->Set(files[first + i], std::move(serialized[i]));
+				}
 			}
+			if(cache)
+				cache->Save();
 			FinishLoading();
 			progress = 1.;
 		});
@@ -182,17 +265,36 @@ void UniverseObjects::Change(const DataNode &node)
 	else if(node.Token(0) == "outfitter" && node.Size() >= 2)
 		outfitSales.Get(node.Token(1))->Load(node, outfits);
 	else if(node.Token(0) == "planet" && node.Size() >= 2)
-		planets.Get(node.Token(1))->Load(node, wormholes);
+	{
+		// A planet's systems might be inhabited or not depending on it.
+		Planet *planet = planets.Get(node.Token(1));
+		for(const System *system : planet->Systems())
+			MarkChanged(system);
+		planet->Load(node, wormholes);
+		for(const System *system : planet->Systems())
+			MarkChanged(system);
+	}
 	else if(node.Token(0) == "shipyard" && node.Size() >= 2)
 		shipSales.Get(node.Token(1))->Load(node, ships);
 	else if(node.Token(0) == "system" && node.Size() >= 2)
-		systems.Get(node.Token(1))->Load(node, planets);
+	{
+		System *system = systems.Get(node.Token(1));
+		MarkChanged(system);
+		system->Load(node, planets);
+	}
 	else if(node.Token(0) == "news" && node.Size() >= 2)
 		news.Get(node.Token(1))->Load(node);
-	else if(node.Token(0) == "link" && node.Size() >= 3)
-		systems.Get(node.Token(1))->Link(systems.Get(node.Token(2)));
-	else if(node.Token(0) == "unlink" && node.Size() >= 3)
-		systems.Get(node.Token(1))->Unlink(systems.Get(node.Token(2)));
+	else if((node.Token(0) == "link" || node.Token(0) == "unlink") && node.Size() >= 3)
+	{
+		System *first = systems.Get(node.Token(1));
+		System *second = systems.Get(node.Token(2));
+		MarkChanged(first);
+		MarkChanged(second);
+		if(node.Token(0) == "link")
+			first->Link(second);
+		else
+			first->Unlink(second);
+	}
 	else if(node.Token(0) == "substitutions" && node.HasChildren())
 		substitutions.Load(node);
 	else if(node.Token(0) == "wormhole" && node.Size() >= 2)
@@ -207,12 +309,19 @@ void UniverseObjects::Change(const DataNode &node)
 // (This must be done any time a GameEvent creates or moves a system.)
 void UniverseObjects::UpdateSystems()
 {
+	// Index the systems that can be neighbors, so that each system only has to
+	// check the ones that are close to it.
+	BuildSystemGrid();
+	changedSystems.clear();
+	formerLinks.clear();
+	updatedDistances = neighborDistances.size();
+
 	for(auto &it : systems)
 	{
 		// Skip systems that have no name.
 		if(it.first.empty() || it.second.Name().empty())
 			continue;
-		it.second.UpdateSystem(systems, neighborDistances);
+		it.second.UpdateSystem(systemGrid, neighborDistances);
 
 		// If there were changes to a system there might have been a change to a legacy
 		// wormhole which we must handle.
@@ -224,6 +333,60 @@ void UniverseObjects::UpdateSystems()
 
 
 
+// Update only the systems that were changed since the last update, and the
+// systems close enough to them that their neighbor lists might be affected.
+void UniverseObjects::UpdateChangedSystems()
+{
+	// If a jump range was added, every system needs a new list of neighbors.
+	if(neighborDistances.size() != updatedDistances)
+	{
+		UpdateSystems();
+		return;
+	}
+	if(changedSystems.empty())
+		return;
+
+	// A system's neighbors can only change if a changed system was, or now is,
+	// within the longest distance that any system looks for neighbors in.
+	double range = System::DEFAULT_NEIGHBOR_DISTANCE;
+	if(!neighborDistances.empty())
+		range = max(range, *neighborDistances.rbegin());
+	for(const auto &it : systems)
+		range = max(range, it.second.JumpRange());
+
+	vector<const System *> affected(formerLinks.begin(), formerLinks.end());
+	for(const auto &it : changedSystems)
+	{
+		affected.push_back(it.first);
+		systemGrid.Near(it.second, range, affected);
+	}
+	BuildSystemGrid();
+	for(const auto &it : changedSystems)
+	{
+		systemGrid.Near(it.first->Position(), range, affected);
+		// Linked systems only list this one as an accessible link if it is accessible.
+		affected.insert(affected.end(), it.first->Links().begin(), it.first->Links().end());
+	}
+	changedSystems.clear();
+	formerLinks.clear();
+
+	sort(affected.begin(), affected.end());
+	affected.erase(unique(affected.begin(), affected.end()), affected.end());
+	for(const System *system : affected)
+	{
+		// Skip systems that have no name.
+		if(system->Name().empty())
+			continue;
+		systems.Get(system->Name())->UpdateSystem(systemGrid, neighborDistances);
+
+		for(const auto &object : system->Objects())
+			if(object.GetPlanet())
+				planets.Get(object.GetPlanet()->TrueName())->FinishLoading(wormholes);
+	}
+}
+
+
+
 // Check for objects that are referred to but never defined. Some elements, like
 // fleets, don't need to be given a name if undefined. Others (like outfits and
 // planets) are written to the player's save and need a name to prevent data loss.
@@ -231,11 +394,12 @@ void UniverseObjects::CheckReferences()
 {
 	// Parse all GameEvents for object definitions.
 	auto deferred = map<string, set<string>>{};
+	vector<string> eventWarnings;
 	for(auto &&it : events)
 	{
 		// Stock GameEvents are serialized in MissionActions by name.
 		if(it.second.Name().empty())
-			NameAndWarn("event", it);
+			NameAndWarn(eventWarnings, "event", it);
 		else
 		{
 			// Any already-named event (i.e. loaded) may alter the universe.
@@ -244,273 +408,599 @@ void UniverseObjects::CheckReferences()
 				deferred[type.first].insert(type.second.begin(), type.second.end());
 		}
 	}
+	// Look up each type of deferred definition now, so that the checks below
+	// only ever read from the map.
+	const set<string> &deferredFleets = deferred["fleet"];
+	const set<string> &deferredGovernments = deferred["government"];
+	const set<string> &deferredOutfitters = deferred["outfitter"];
+	const set<string> &deferredPlanets = deferred["planet"];
+	const set<string> &deferredShipyards = deferred["shipyard"];
+	const set<string> &deferredSystems = deferred["system"];
 
-	// Stock conversations are never serialized.
-	for(const auto &it : conversations)
-		if(it.second.IsEmpty())
-			Warn("conversation", it.first);
 	// The "default intro" conversation must invoke the prompt to set the player's name.
 	if(!conversations.Get("default intro")->IsValidIntro())
 		Logger::LogError("Error: the \"default intro\" conversation must contain a \"name\" node.");
-	// Effects are serialized as a part of ships.
-	for(auto &&it : effects)
-		if(it.second.Name().empty())
-			NameAndWarn("effect", it);
-	// Fleets are not serialized. Any changes via events are written as DataNodes and thus self-define.
-	for(auto &&it : fleets)
+	// Loading an object may look up objects of other types, so every object
+	// must be loaded before the sets are checked in parallel. After that, each
+	// check only uses the objects of its own type, or reads ones that no other
+	// check modifies.
+	conversations.LoadAll();
+	missions.LoadAll();
+	news.LoadAll();
+	phrases.LoadAll();
+
+	// Each type of object is checked on its own, and any warnings are kept
+	// separate until all the checks are done.
+	const vector<function<void(vector<string> &)>> checks = {
+		// Stock conversations are never serialized.
+		[this](vector<string> &warnings) -> void
+		{
+			for(const auto &it : conversations)
+				if(it.second.IsEmpty())
+					Warn(warnings, "conversation", it.first);
+		},
+		// Effects are serialized as a part of ships.
+		[this](vector<string> &warnings) -> void
+		{
+			for(auto &&it : effects)
+				if(it.second.Name().empty())
+					NameAndWarn(warnings, "effect", it);
+		},
+		// Fleets are not serialized. Any changes via events are written as DataNodes and thus self-define.
+		[this, &deferredFleets](vector<string> &warnings) -> void
+		{
+			for(auto &&it : fleets)
+			{
+				// Plugins may alter stock fleets with new variants that exclusively use plugin ships.
+				// Rather than disable the whole fleet due to these non-instantiable variants, remove them.
+				string removed = it.second.RemoveInvalidVariants();
+				if(!removed.empty())
+					warnings.push_back(std::move(removed));
+				if(!it.second.IsValid() && !deferredFleets.count(it.first))
+					Warn(warnings, "fleet", it.first);
+			}
+		},
+		// Government names are used in mission NPC blocks and LocationFilters.
+		[this, &deferredGovernments](vector<string> &warnings) -> void
+		{
+			for(auto &&it : governments)
+				if(it.second.GetTrueName().empty() && !NameIfDeferred(deferredGovernments, it))
+					NameAndWarn(warnings, "government", it);
+		},
+		// Minables are not serialized.
+		[this](vector<string> &warnings) -> void
+		{
+			for(const auto &it : minables)
+				if(it.second.TrueName().empty())
+					Warn(warnings, "minable", it.first);
+		},
+		// Stock missions are never serialized, and an accepted mission is
+		// always fully defined (though possibly not "valid").
+		[this](vector<string> &warnings) -> void
+		{
+			for(const auto &it : missions)
+				if(it.second.Name().empty())
+					Warn(warnings, "mission", it.first);
+		},
+
+		// News are never serialized or named, except by events (which would then define them).
+
+		// Outfit names are used by a number of classes.
+		[this](vector<string> &warnings) -> void
+		{
+			for(auto &&it : outfits)
+				if(it.second.TrueName().empty())
+					NameAndWarn(warnings, "outfit", it);
+		},
+		// Outfitters are never serialized.
+		[this, &deferredOutfitters](vector<string> &warnings) -> void
+		{
+			for(const auto &it : outfitSales)
+				if(it.second.empty() && !deferredOutfitters.count(it.first))
+					warnings.push_back("outfitter \"" + it.first + "\" is referred to, but has no outfits.");
+		},
+		// Phrases are never serialized.
+		[this](vector<string> &warnings) -> void
+		{
+			for(const auto &it : phrases)
+				if(it.second.Name().empty())
+					Warn(warnings, "phrase", it.first);
+		},
+		// Planet names are used by a number of classes.
+		[this, &deferredPlanets](vector<string> &warnings) -> void
+		{
+			for(auto &&it : planets)
+				if(it.second.TrueName().empty() && !NameIfDeferred(deferredPlanets, it))
+					NameAndWarn(warnings, "planet", it);
+		},
+		// Ship model names are used by missions and depreciation.
+		[this](vector<string> &warnings) -> void
+		{
+			for(auto &&it : ships)
+				if(it.second.ModelName().empty())
+				{
+					it.second.SetModelName(it.first);
+					Warn(warnings, "ship", it.first);
+				}
+		},
+		// Shipyards are never serialized.
+		[this, &deferredShipyards](vector<string> &warnings) -> void
+		{
+			for(const auto &it : shipSales)
+				if(it.second.empty() && !deferredShipyards.count(it.first))
+					warnings.push_back("shipyard \"" + it.first + "\" is referred to, but has no ships.");
+		},
+		// System names are used by a number of classes.
+		[this, &deferredSystems](vector<string> &warnings) -> void
+		{
+			for(auto &&it : systems)
+				if(it.second.Name().empty() && !NameIfDeferred(deferredSystems, it))
+					NameAndWarn(warnings, "system", it);
+		},
+		// Hazards are never serialized.
+		[this](vector<string> &warnings) -> void
+		{
+			for(const auto &it : hazards)
+				if(!it.second.IsValid())
+					Warn(warnings, "hazard", it.first);
+		},
+		// Wormholes are never serialized.
+		[this](vector<string> &warnings) -> void
+		{
+			for(const auto &it : wormholes)
+				if(it.second.Name().empty())
+					Warn(warnings, "wormhole", it.first);
+		},
+
+		// Formation patterns are not serialized, but their usage is.
+		[this](vector<string> &warnings) -> void
+		{
+			for(auto &&it : formations)
+				if(it.second.Name().empty())
+					NameAndWarn(warnings, "formation", it);
+		},
+		// Any stock colors should have been loaded from game data files.
+		[this](vector<string> &warnings) -> void
+		{
+			for(const auto &it : colors)
+				if(!it.second.IsLoaded())
+					Warn(warnings, "color", it.first);
+		}
+	};
+	vector<vector<string>> results(checks.size());
 	{
-		// Plugins may alter stock fleets with new variants that exclusively use plugin ships.
-		// Rather than disable the whole fleet due to these non-instantiable variants, remove them.
-		it.second.RemoveInvalidVariants();
-		if(!it.second.IsValid() && !deferred["fleet"].count(it.first))
-			Warn("fleet", it.first);
+		JobPool pool(min<unsigned>(JobPool::DefaultThreadCount(), checks.size() - 1));
+		pool.ParallelFor(checks.size(), [&checks, &results](size_t i) -> void { checks[i](results[i]); });
 	}
-	// Government names are used in mission NPC blocks and LocationFilters.
-	for(auto &&it : governments)
-		if(it.second.GetTrueName().empty() && !NameIfDeferred(deferred["government"], it))
-			NameAndWarn("government", it);
-	// Minables are not serialized.
-	for(const auto &it : minables)
-		if(it.second.TrueName().empty())
-			Warn("minable", it.first);
-	// Stock missions are never serialized, and an accepted mission is
-	// always fully defined (though possibly not "valid").
-	for(const auto &it : missions)
-		if(it.second.Name().empty())
-			Warn("mission", it.first);
-
-	// News are never serialized or named, except by events (which would then define them).
-
-	// Outfit names are used by a number of classes.
-	for(auto &&it : outfits)
-		if(it.second.TrueName().empty())
-			NameAndWarn("outfit", it);
-	// Outfitters are never serialized.
-	for(const auto &it : outfitSales)
-		if(it.second.empty() && !deferred["outfitter"].count(it.first))
-			Logger::LogError("Warning: outfitter \"" + it.first + "\" is referred to, but has no outfits.");
-	// Phrases are never serialized.
-	for(const auto &it : phrases)
-		if(it.second.Name().empty())
-			Warn("phrase", it.first);
-	// Planet names are used by a number of classes.
-	for(auto &&it : planets)
-		if(it.second.TrueName().empty() && !NameIfDeferred(deferred["planet"], it))
-			NameAndWarn("planet", it);
-	// Ship model names are used by missions and depreciation.
-	for(auto &&it : ships)
-		if(it.second.ModelName().empty())
+
+	// Report the warnings in a consistent order, no matter which check found
+	// them first, and only report each one once.
+	vector<string> warnings = std::move(eventWarnings);
+	for(vector<string> &result : results)
+		warnings.insert(warnings.end(), make_move_iterator(result.begin()), make_move_iterator(result.end()));
+	sort(warnings.begin(), warnings.end());
+	warnings.erase(unique(warnings.begin(), warnings.end()), warnings.end());
+	for(const string &warning : warnings)
+		Logger::Log(warning, Logger::Level::WARNING);
+}
+
+
+
+bool UniverseObjects::CanReload() const
+{
+	return !sources.empty();
+}
+
+
+
+// Reload every object defined by a data file that has changed.
+map<string, set<string>> UniverseObjects::Reload()
+{
+	map<string, set<string>> reloaded;
+	if(!CanReload())
+		return reloaded;
+
+	map<string, const SourceFile *> previous;
+	for(const SourceFile &file : sourceFiles)
+		previous[file.path] = &file;
+
+	// Parse every file that is new or has changed, and find all the objects that
+	// either the old or the new version of it defines.
+	vector<string> paths = ListFiles(sources);
+	paths.erase(remove_if(paths.begin(), paths.end(),
+		[](const string &path) noexcept -> bool { return !IsDataFile(path); }), paths.end());
+	vector<SourceFile> files;
+	vector<DataFile> parsed(paths.size());
+	set<pair<string, string>> touched;
+	for(size_t i = 0; i < paths.size(); ++i)
+	{
+		const string &path = paths[i];
+		auto it = previous.find(path);
+		if(it != previous.end() && it->second->timestamp == Files::Timestamp(path)
+				&& it->second->size == Files::Size(path))
 		{
-			it.second.SetModelName(it.first);
-			Warn("ship", it.first);
+			files.push_back(*it->second);
+			previous.erase(it);
+			continue;
+		}
+		if(it != previous.end())
+		{
+			touched.insert(it->second->definitions.begin(), it->second->definitions.end());
+			previous.erase(it);
 		}
-	// Shipyards are never serialized.
-	for(const auto &it : shipSales)
-		if(it.second.empty() && !deferred["shipyard"].count(it.first))
-			Logger::LogError("Warning: shipyard \"" + it.first + "\" is referred to, but has no ships.");
-	// System names are used by a number of classes.
-	for(auto &&it : systems)
-		if(it.second.Name().empty() && !NameIfDeferred(deferred["system"], it))
-			NameAndWarn("system", it);
-	// Hazards are never serialized.
-	for(const auto &it : hazards)
-		if(!it.second.IsValid())
-			Warn("hazard", it.first);
-	// Wormholes are never serialized.
-	for(const auto &it : wormholes)
-		if(it.second.Name().empty())
-			Warn("wormhole", it.first);
 
-	// Formation patterns are not serialized, but their usage is.
-	for(auto &&it : formations)
-		if(it.second.Name().empty())
-			NameAndWarn("formation", it);
-	// Any stock colors should have been loaded from game data files.
-	for(const auto &it : colors)
-		if(!it.second.IsLoaded())
-			Warn("color", it.first);
+		parsed[i].Load(path);
+		files.push_back(Record(path, parsed[i]));
+		touched.insert(files.back().definitions.begin(), files.back().definitions.end());
+		for(const DataNode &node : parsed[i])
+			if(Definition(node).first.empty())
+				node.PrintTrace("Warning: This cannot be reloaded without restarting the game:");
+	}
+	// Anything that was in a file that no longer exists must also be reloaded.
+	for(const auto &it : previous)
+		touched.insert(it.second->definitions.begin(), it.second->definitions.end());
+
+	// Reset all the affected objects, then load them again from every file that
+	// defines them, including the files that did not change.
+	for(const auto &definition : touched)
+	{
+		Reset(definition);
+		reloaded[definition.first].insert(definition.second);
+	}
+	for(size_t i = 0; i < paths.size(); ++i)
+	{
+		const auto &definitions = files[i].definitions;
+		if(none_of(definitions.begin(), definitions.end(),
+				[&touched](const pair<string, string> &it) -> bool { return touched.count(it); }))
+			continue;
+
+		if(parsed[i].begin() == parsed[i].end())
+			parsed[i].Load(paths[i]);
+		for(const DataNode &node : parsed[i])
+		{
+			pair<string, string> definition = Definition(node);
+			if(!definition.first.empty() && touched.count(definition))
+				LoadNode(node, paths[i]);
+		}
+	}
+	sourceFiles.swap(files);
+
+	// Redo whichever parts of FinishLoading() the reloaded objects need.
+	if(reloaded.count("planet") || reloaded.count("system") || reloaded.count("wormhole"))
+		UpdateSystems();
+	for(const string &name : reloaded["planet"])
+		planets.Get(name)->FinishLoading(wormholes);
+	// Ship models depend on the outfits they contain.
+	if(reloaded.count("ship") || reloaded.count("outfit"))
+		for(auto &&it : ships)
+			it.second.FinishLoading(true);
+	for(const string &name : reloaded["person"])
+		persons.Get(name)->FinishLoading();
+	for(const string &name : reloaded["minable"])
+		minables.Get(name)->FinishLoading();
+	for(const string &name : reloaded["mission"])
+		if(disabled["mission"].count(name))
+			missions.Get(name)->NeverOffer();
+	if(reloaded.count("mission"))
+		missionIndex.Clear();
+	for(const string &name : reloaded["event"])
+		if(disabled["event"].count(name))
+			events.Get(name)->Disable();
+	for(const string &name : reloaded["person"])
+		if(disabled["person"].count(name))
+			persons.Get(name)->NeverSpawn();
+
+	// Looking up names above may have added empty entries; drop those.
+	for(auto it = reloaded.begin(); it != reloaded.end(); )
+		it = (it->second.empty() ? reloaded.erase(it) : next(it));
+
+	CheckReferences();
+	return reloaded;
+}
+
+
+
+
+// Get the data files in the given source directories, in the order they are loaded.
+vector<string> UniverseObjects::ListFiles(const vector<string> &sources)
+{
+	vector<string> files;
+	for(const string &source : sources)
+	{
+		// Iterate through the paths starting with the last directory given. That
+		// is, things in folders near the start of the path have the ability to
+		// override things in folders later in the path.
+		auto list = Files::RecursiveList(source + "data/");
+		files.reserve(files.size() + list.size());
+		files.insert(files.end(),
+				make_move_iterator(list.begin()),
+				make_move_iterator(list.end()));
+	}
+	return files;
+}
+
+
+
+// Remember when the given file was loaded, and what it defined.
+UniverseObjects::SourceFile UniverseObjects::Record(const string &path, const DataFile &data)
+{
+	SourceFile file;
+	file.path = path;
+	file.timestamp = Files::Timestamp(path);
+	file.size = Files::Size(path);
+	for(const DataNode &node : data)
+	{
+		pair<string, string> definition = Definition(node);
+		if(!definition.first.empty())
+			file.definitions.insert(std::move(definition));
+	}
+	return file;
 }
 
 
 
-void UniverseObjects::LoadFile(const string &path, bool debugMode)
+void UniverseObjects::LoadFile(const string &path, const DataFile &data, bool debugMode)
 {
 	// This is an ordinary file. Check to see if it is an image.
-	if(path.length() < 4 || path.compare(path.length() - 4, 4, ".txt"))
+	if(!IsDataFile(path))
 		return;
 
-	DataFile data(path);
 	if(debugMode)
 		Logger::LogError("Parsing: " + path);
 
 	for(const DataNode &node : data)
+		LoadNode(node, path);
+}
+
+
+
+// Add the definition in the given root node of a data file.
+void UniverseObjects::LoadNode(const DataNode &node, const string &path)
+{
+	const string &key = node.Token(0);
+	if(key == "color" && node.Size() >= 5)
+		colors.Get(node.Token(1))->Load(
+			node.Value(2), node.Value(3), node.Value(4), node.Size() >= 6 ? node.Value(5) : 1.);
+	else if(key == "conversation" && node.Size() >= 2)
+		conversations.Load(node.Token(1), node);
+	else if(key == "effect" && node.Size() >= 2)
+		effects.Get(node.Token(1))->Load(node);
+	else if(key == "event" && node.Size() >= 2)
+		events.Get(node.Token(1))->Load(node);
+	else if(key == "fleet" && node.Size() >= 2)
+		fleets.Get(node.Token(1))->Load(node);
+	else if(key == "formation" && node.Size() >= 2)
+		formations.Get(node.Token(1))->Load(node);
+	else if(key == "galaxy" && node.Size() >= 2)
+		galaxies.Get(node.Token(1))->Load(node);
+	else if(key == "government" && node.Size() >= 2)
+		governments.Get(node.Token(1))->Load(node);
+	else if(key == "hazard" && node.Size() >= 2)
+		hazards.Get(node.Token(1))->Load(node);
+	else if(key == "interface" && node.Size() >= 2)
 	{
-		const string &key = node.Token(0);
-		if(key == "color" && node.Size() >= 5)
-			colors.Get(node.Token(1))->Load(
-				node.Value(2), node.Value(3), node.Value(4), node.Size() >= 6 ? node.Value(5) : 1.);
-		else if(key == "conversation" && node.Size() >= 2)
-			conversations.Get(node.Token(1))->Load(node);
-		else if(key == "effect" && node.Size() >= 2)
-			effects.Get(node.Token(1))->Load(node);
-		else if(key == "event" && node.Size() >= 2)
-			events.Get(node.Token(1))->Load(node);
-		else if(key == "fleet" && node.Size() >= 2)
-			fleets.Get(node.Token(1))->Load(node);
-		else if(key == "formation" && node.Size() >= 2)
-			formations.Get(node.Token(1))->Load(node);
-		else if(key == "galaxy" && node.Size() >= 2)
-			galaxies.Get(node.Token(1))->Load(node);
-		else if(key == "government" && node.Size() >= 2)
-			governments.Get(node.Token(1))->Load(node);
-		else if(key == "hazard" && node.Size() >= 2)
-			hazards.Get(node.Token(1))->Load(node);
-		else if(key == "interface" && node.Size() >= 2)
-		{
-			interfaces.Get(node.Token(1))->Load(node);
+		interfaces.Get(node.Token(1))->Load(node);
 
-			// If we modified the "menu background" interface, then
-			// we also update our cache of it.
-			if(node.Token(1) == "menu background")
-			{
-				lock_guard<mutex> lock(menuBackgroundMutex);
-				menuBackgroundCache.Load(node);
-			}
-		}
-		else if(key == "minable" && node.Size() >= 2)
-			minables.Get(node.Token(1))->Load(node);
-		else if(key == "mission" && node.Size() >= 2)
-			missions.Get(node.Token(1))->Load(node);
-		else if(key == "outfit" && node.Size() >= 2)
-			outfits.Get(node.Token(1))->Load(node);
-		else if(key == "outfitter" && node.Size() >= 2)
-			outfitSales.Get(node.Token(1))->Load(node, outfits);
-		else if(key == "person" && node.Size() >= 2)
-			persons.Get(node.Token(1))->Load(node);
-		else if(key == "phrase" && node.Size() >= 2)
-			phrases.Get(node.Token(1))->Load(node);
-		else if(key == "planet" && node.Size() >= 2)
-			planets.Get(node.Token(1))->Load(node, wormholes);
-		else if(key == "ship" && node.Size() >= 2)
+		// If we modified the "menu background" interface, then
+		// we also update our cache of it.
+		if(node.Token(1) == "menu background")
 		{
-			// Allow multiple named variants of the same ship model.
-			const string &name = node.Token((node.Size() > 2) ? 2 : 1);
-			ships.Get(name)->Load(node);
+			lock_guard<mutex> lock(menuBackgroundMutex);
+			menuBackgroundCache.Load(node);
 		}
-		else if(key == "shipyard" && node.Size() >= 2)
-			shipSales.Get(node.Token(1))->Load(node, ships);
-		else if(key == "start" && node.HasChildren())
+	}
+	else if(key == "minable" && node.Size() >= 2)
+		minables.Get(node.Token(1))->Load(node);
+	else if(key == "mission" && node.Size() >= 2)
+		missions.Load(node.Token(1), node);
+	else if(key == "outfit" && node.Size() >= 2)
+		outfits.Get(node.Token(1))->Load(node);
+	else if(key == "outfitter" && node.Size() >= 2)
+		outfitSales.Get(node.Token(1))->Load(node, outfits);
+	else if(key == "person" && node.Size() >= 2)
+		persons.Get(node.Token(1))->Load(node);
+	else if(key == "phrase" && node.Size() >= 2)
+		phrases.Load(node.Token(1), node);
+	else if(key == "planet" && node.Size() >= 2)
+		planets.Get(node.Token(1))->Load(node, wormholes);
+	else if(key == "ship" && node.Size() >= 2)
+	{
+		// Allow multiple named variants of the same ship model.
+		const string &name = node.Token((node.Size() > 2) ? 2 : 1);
+		ships.Get(name)->Load(node);
+	}
+	else if(key == "shipyard" && node.Size() >= 2)
+		shipSales.Get(node.Token(1))->Load(node, ships);
+	else if(key == "start" && node.HasChildren())
+	{
+		// This node may either declare an immutable starting scenario, or one that is open to extension
+		// by other nodes (e.g. plugins may customize the basic start, rather than provide a unique start).
+		if(node.Size() == 1)
+			startConditions.emplace_back(node);
+		else
 		{
-			// This node may either declare an immutable starting scenario, or one that is open to extension
-			// by other nodes (e.g. plugins may customize the basic start, rather than provide a unique start).
-			if(node.Size() == 1)
-				startConditions.emplace_back(node);
+			const string &identifier = node.Token(1);
+			auto existingStart = find_if(startConditions.begin(), startConditions.end(),
+				[&identifier](const StartConditions &it) noexcept -> bool { return it.Identifier() == identifier; });
+			if(existingStart != startConditions.end())
+				existingStart->Load(node);
 			else
-			{
-				const string &identifier = node.Token(1);
-				auto existingStart = find_if(startConditions.begin(), startConditions.end(),
-					[&identifier](const StartConditions &it) noexcept -> bool { return it.Identifier() == identifier; });
-				if(existingStart != startConditions.end())
-					existingStart->Load(node);
-				else
-					startConditions.emplace_back(node);
-			}
-		}
-		else if(key == "system" && node.Size() >= 2)
-			systems.Get(node.Token(1))->Load(node, planets);
-		else if((key == "test") && node.Size() >= 2)
-			tests.Get(node.Token(1))->Load(node);
-		else if((key == "test-data") && node.Size() >= 2)
-			testDataSets.Get(node.Token(1))->Load(node, path);
-		else if(key == "trade")
-			trade.Load(node);
-		else if(key == "landing message" && node.Size() >= 2)
-		{
-			for(const DataNode &child : node)
-				landingMessages[SpriteSet::Get(child.Token(0))] = node.Token(1);
+				startConditions.emplace_back(node);
 		}
-		else if(key == "star" && node.Size() >= 2)
+	}
+	else if(key == "system" && node.Size() >= 2)
+		systems.Get(node.Token(1))->Load(node, planets);
+	else if((key == "test") && node.Size() >= 2)
+		tests.Get(node.Token(1))->Load(node);
+	else if((key == "test-data") && node.Size() >= 2)
+		testDataSets.Get(node.Token(1))->Load(node, path);
+	else if(key == "trade")
+		trade.Load(node);
+	else if(key == "landing message" && node.Size() >= 2)
+	{
+		for(const DataNode &child : node)
+			landingMessages[SpriteSet::Get(child.Token(0))] = node.Token(1);
+	}
+	else if(key == "star" && node.Size() >= 2)
+	{
+		const Sprite *sprite = SpriteSet::Get(node.Token(1));
+		for(const DataNode &child : node)
 		{
-			const Sprite *sprite = SpriteSet::Get(node.Token(1));
-			for(const DataNode &child : node)
-			{
-				if(child.Token(0) == "power" && child.Size() >= 2)
-					solarPower[sprite] = child.Value(1);
-				else if(child.Token(0) == "wind" && child.Size() >= 2)
-					solarWind[sprite] = child.Value(1);
-				else
-					child.PrintTrace("Skipping unrecognized attribute:");
-			}
+			if(child.Token(0) == "power" && child.Size() >= 2)
+				solarPower[sprite] = child.Value(1);
+			else if(child.Token(0) == "wind" && child.Size() >= 2)
+				solarWind[sprite] = child.Value(1);
+			else
+				child.PrintTrace("Skipping unrecognized attribute:");
 		}
-		else if(key == "news" && node.Size() >= 2)
-			news.Get(node.Token(1))->Load(node);
-		else if(key == "rating" && node.Size() >= 2)
+	}
+	else if(key == "news" && node.Size() >= 2)
+		news.Load(node.Token(1), node);
+	else if(key == "rating" && node.Size() >= 2)
+	{
+		vector<string> &list = ratings[node.Token(1)];
+		list.clear();
+		for(const DataNode &child : node)
+			list.push_back(child.Token(0));
+	}
+	else if(key == "category" && node.Size() >= 2)
+	{
+		static const map<string, CategoryType> category = {
+			{"ship", CategoryType::SHIP},
+			{"bay type", CategoryType::BAY},
+			{"outfit", CategoryType::OUTFIT},
+			{"series", CategoryType::SERIES}
+		};
+		auto it = category.find(node.Token(1));
+		if(it == category.end())
 		{
-			vector<string> &list = ratings[node.Token(1)];
-			list.clear();
-			for(const DataNode &child : node)
-				list.push_back(child.Token(0));
+			node.PrintTrace("Skipping unrecognized category type:");
+			return;
 		}
-		else if(key == "category" && node.Size() >= 2)
+		categories[it->second].Load(node);
+	}
+	else if((key == "tip" || key == "help") && node.Size() >= 2)
+	{
+		string &text = (key == "tip" ? tooltips : helpMessages)[node.Token(1)];
+		text.clear();
+		for(const DataNode &child : node)
 		{
-			static const map<string, CategoryType> category = {
-				{"ship", CategoryType::SHIP},
-				{"bay type", CategoryType::BAY},
-				{"outfit", CategoryType::OUTFIT},
-				{"series", CategoryType::SERIES}
-			};
-			auto it = category.find(node.Token(1));
-			if(it == category.end())
+			if(!text.empty())
 			{
-				node.PrintTrace("Skipping unrecognized category type:");
-				continue;
+				text += '\n';
+				if(child.Token(0)[0] != '\t')
+					text += '\t';
 			}
-			categories[it->second].Load(node);
+			text += child.Token(0);
 		}
-		else if((key == "tip" || key == "help") && node.Size() >= 2)
-		{
-			string &text = (key == "tip" ? tooltips : helpMessages)[node.Token(1)];
-			text.clear();
-			for(const DataNode &child : node)
-			{
-				if(!text.empty())
-				{
-					text += '\n';
-					if(child.Token(0)[0] != '\t')
-						text += '\t';
-				}
-				text += child.Token(0);
-			}
-		}
-		else if(key == "substitutions" && node.HasChildren())
-			substitutions.Load(node);
-		else if(key == "wormhole" && node.Size() >= 2)
-			wormholes.Get(node.Token(1))->Load(node);
-		else if(key == "gamerules" && node.HasChildren())
-			gamerules.Load(node);
-		else if(key == "disable" && node.Size() >= 2)
+	}
+	else if(key == "substitutions" && node.HasChildren())
+		substitutions.Load(node);
+	else if(key == "wormhole" && node.Size() >= 2)
+		wormholes.Get(node.Token(1))->Load(node);
+	else if(key == "gamerules" && node.HasChildren())
+		gamerules.Load(node);
+	else if(key == "disable" && node.Size() >= 2)
+	{
+		static const set<string> canDisable = {"mission", "event", "person"};
+		const string &category = node.Token(1);
+		if(canDisable.count(category))
 		{
-			static const set<string> canDisable = {"mission", "event", "person"};
-			const string &category = node.Token(1);
-			if(canDisable.count(category))
-			{
-				if(node.HasChildren())
-					for(const DataNode &child : node)
-						disabled[category].emplace(child.Token(0));
-				if(node.Size() >= 3)
-					for(int index = 2; index < node.Size(); ++index)
-						disabled[category].emplace(node.Token(index));
-			}
-			else
-				node.PrintTrace("Invalid use of keyword \"disable\" for class \"" + category + "\"");
+			if(node.HasChildren())
+				for(const DataNode &child : node)
+					disabled[category].emplace(child.Token(0));
+			if(node.Size() >= 3)
+				for(int index = 2; index < node.Size(); ++index)
+					disabled[category].emplace(node.Token(index));
 		}
 		else
-			node.PrintTrace("Skipping unrecognized root object:");
+			node.PrintTrace("Invalid use of keyword \"disable\" for class \"" + category + "\"");
 	}
+	else
+		node.PrintTrace("Skipping unrecognized root object:");
+}
+
+
+// Replace the object with the given type and name with a default one.
+void UniverseObjects::Reset(const pair<string, string> &definition)
+{
+	const string &key = definition.first;
+	const string &name = definition.second;
+	if(key == "color")
+		ResetObject(colors, name);
+	else if(key == "conversation")
+		ResetObject(conversations, name);
+	else if(key == "effect")
+		ResetObject(effects, name);
+	else if(key == "event")
+		ResetObject(events, name);
+	else if(key == "fleet")
+		ResetObject(fleets, name);
+	else if(key == "formation")
+		ResetObject(formations, name);
+	else if(key == "galaxy")
+		ResetObject(galaxies, name);
+	else if(key == "government")
+		ResetObject(governments, name);
+	else if(key == "hazard")
+		ResetObject(hazards, name);
+	else if(key == "interface")
+		ResetObject(interfaces, name);
+	else if(key == "minable")
+		ResetObject(minables, name);
+	else if(key == "mission")
+		ResetObject(missions, name);
+	else if(key == "news")
+		ResetObject(news, name);
+	else if(key == "outfit")
+		ResetObject(outfits, name);
+	else if(key == "outfitter")
+		ResetObject(outfitSales, name);
+	else if(key == "person")
+		ResetObject(persons, name);
+	else if(key == "phrase")
+		ResetObject(phrases, name);
+	else if(key == "planet")
+		ResetObject(planets, name);
+	else if(key == "ship")
+		ResetObject(ships, name);
+	else if(key == "shipyard")
+		ResetObject(shipSales, name);
+	else if(key == "system")
+		ResetObject(systems, name);
+	else if(key == "test")
+		ResetObject(tests, name);
+	else if(key == "test-data")
+		ResetObject(testDataSets, name);
+	else if(key == "wormhole")
+		ResetObject(wormholes, name);
+}
+
+
+
+// Remember that the given system is about to be changed, along with where
+// it was and which systems it was linked to before the change.
+void UniverseObjects::MarkChanged(const System *system)
+{
+	changedSystems.emplace(system, system->Position());
+	formerLinks.insert(system->Links().begin(), system->Links().end());
 }
 
 
 
+// Index the positions of all named, accessible systems.
+void UniverseObjects::BuildSystemGrid()
+{
+	vector<const System *> accessible;
+	for(const auto &it : systems)
+		if(!it.first.empty() && !it.second.Name().empty() && !it.second.Inaccessible())
+			accessible.push_back(&it.second);
+	systemGrid.Build(accessible);
+}
+
+
+
+
 void UniverseObjects::DrawMenuBackground(Panel *panel) const
 {
 	lock_guard<mutex> lock(menuBackgroundMutex);
@@ -34,6 +34,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Interface.h"
 #include "Minable.h"
 #include "Mission.h"
+#include "MissionIndex.h"
 #include "News.h"
 #include "Outfit.h"
 #include "Person.h"
@@ -42,19 +43,24 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Ship.h"
 #include "StartConditions.h"
 #include "System.h"
+#include "SystemGrid.h"
 #include "Test.h"
 #include "TestData.h"
 #include "TextReplacements.h"
 #include "Trade.h"
 #include "Wormhole.h"
 
+#include <cstdint>
+#include <ctime>
 #include <future>
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 
+class DataFile;
 class Panel;
 class Sprite;
 
@@ -67,8 +73,10 @@ class UniverseObjects {
 	friend class GameData;
 	friend class TestData;
 public:
-	// Load game objects from the given directories of definitions.
-	std::future<void> Load(const std::vector<std::string> &sources, bool debugMode = false);
+	// Load game objects from the given directories of definitions. If a cache
+	// of parsed data files is used, any files that have not changed since the
+	// cache was saved are loaded from it instead of being parsed again.
+	std::future<void> Load(const std::vector<std::string> &sources, bool debugMode = false, bool useCache = false);
 	// Determine the fraction of data files read from disk.
 	double GetProgress() const;
 	// Resolve every game object dependency.
@@ -79,17 +87,53 @@ public:
 	// Update the neighbor lists and other information for all the systems.
 	// (This must be done any time a GameEvent creates or moves a system.)
 	void UpdateSystems();
+	// Update only the systems that were changed since the last update, and the
+	// systems close enough to them that their neighbor lists might be affected.
+	void UpdateChangedSystems();
 
 	// Check for objects that are referred to but never defined.
 	void CheckReferences();
 
+	// Check whether the data was loaded in a way that allows reloading it.
+	bool CanReload() const;
+	// Find the data files that have changed since they were loaded, and reload
+	// every object that any of them defines (or used to define), applying each
+	// file that defines one of those objects in the original order. Returns the
+	// names of the objects that were reloaded, grouped by type.
+	std::map<std::string, std::set<std::string>> Reload();
+
 	// Draws the current menu background. Unlike accessing the menu background
 	// through GameData, this function is thread-safe.
 	void DrawMenuBackground(Panel *panel) const;
 
 
 private:
-	void LoadFile(const std::string &path, bool debugMode = false);
+	// A data file that was loaded, and what it defined, for use when reloading.
+	class SourceFile {
+	public:
+		std::string path;
+		std::time_t timestamp = 0;
+		int64_t size = 0;
+		// The type and name of each object this file defines.
+		std::set<std::pair<std::string, std::string>> definitions;
+	};
+
+
+private:
+	// Get the files in the given source directories, in the order they are loaded.
+	static std::vector<std::string> ListFiles(const std::vector<std::string> &sources);
+	// Remember the given file, so that it can be reloaded if it changes.
+	static SourceFile Record(const std::string &path, const DataFile &data);
+	// Add the definitions in the given file, which has already been parsed.
+	void LoadFile(const std::string &path, const DataFile &data, bool debugMode = false);
+	void LoadNode(const DataNode &node, const std::string &path);
+	// Replace the object with the given type and name with a default one.
+	void Reset(const std::pair<std::string, std::string> &definition);
+	// Remember that the given system is about to be changed, along with where
+	// it was and which systems it was linked to before the change.
+	void MarkChanged(const System *system);
+	// Index the positions of all named, accessible systems.
+	void BuildSystemGrid();
 
 
 private:
@@ -110,6 +154,8 @@ private:
 	Set<Interface> interfaces;
 	Set<Minable> minables;
 	Set<Mission> missions;
+	// Where each mission might be offered. This is built when first needed.
+	MissionIndex missionIndex;
 	Set<News> news;
 	Set<Outfit> outfits;
 	Set<Person> persons;
@@ -123,6 +169,15 @@ private:
 	Set<Sale<Outfit>> outfitSales;
 	Set<Wormhole> wormholes;
 	std::set<double> neighborDistances;
+	// The positions of all named, accessible systems, as of the last UpdateSystems().
+	SystemGrid systemGrid;
+	// The systems that have been changed since the last update, and the position
+	// each one had before it was changed.
+	std::map<const System *, Point> changedSystems;
+	// The systems that were linked to any of them before they were changed.
+	std::set<const System *> formerLinks;
+	// How many neighbor distances there were when all the systems were last updated.
+	size_t updatedDistances = 0;
 
 	Gamerules gamerules;
 	TextReplacements substitutions;
@@ -138,6 +193,11 @@ private:
 	std::map<std::string, std::string> helpMessages;
 	std::map<std::string, std::set<std::string>> disabled;
 
+	// The data files that were loaded, in order. These are only recorded in
+	// debug mode, which is the only time the data can be reloaded.
+	std::vector<std::string> sources;
+	std::vector<SourceFile> sourceFiles;
+
 	// A local cache of the menu background interface for thread-safe access.
 	mutable std::mutex menuBackgroundMutex;
 	Interface menuBackgroundCache;
@@ -15,9 +15,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Visual.h"
 
-#include "Audio.h"
 #include "Effect.h"
-#include "Random.h"
+#include "Particle.h"
 
 using namespace std;
 
@@ -25,31 +24,20 @@ using namespace std;
 
 // Generate a visual based on the given Effect.
 Visual::Visual(const Effect &effect, Point pos, Point vel, Angle facing, Point hitVelocity)
-	: Body(effect, pos, vel, effect.hasAbsoluteAngle ? effect.absoluteAngle : facing),
-	lifetime(effect.lifetime)
+	: Visual(Particle(effect, pos, vel, facing, hitVelocity))
 {
-	if(effect.randomLifetime > 0)
-		lifetime += Random::Int(effect.randomLifetime + 1);
-
-	angle += Angle::Random(effect.randomAngle) - Angle::Random(effect.randomAngle);
-	spin = Angle::Random(effect.randomSpin) - Angle::Random(effect.randomSpin);
-
-	if(effect.hasAbsoluteVelocity)
-		velocity = angle.Unit() * effect.absoluteVelocity;
-	else
-	{
-		velocity *= effect.velocityScale;
-		velocity += hitVelocity * (1. - effect.velocityScale);
-	}
+}
 
-	if(effect.randomVelocity)
-		velocity += angle.Unit() * Random::Real() * effect.randomVelocity;
 
-	if(effect.sound)
-		Audio::Play(effect.sound, position);
 
-	if(effect.randomFrameRate)
-		AddFrameRate(effect.randomFrameRate * Random::Real());
+// Make a visual that shows the given particle, for when particles can't be
+// drawn by the sprite shader.
+Visual::Visual(const Particle &particle)
+	: Body(*particle.effect, particle.position, particle.velocity, particle.angle),
+	spin(particle.spin), lifetime(particle.lifetime), priority(particle.effect->priority)
+{
+	if(particle.addedFrameRate)
+		AddFrameRate(particle.addedFrameRate);
 }
 
 
@@ -65,3 +53,19 @@ void Visual::Move()
 		angle += spin;
 	}
 }
+
+
+
+// The number of steps until this visual disappears.
+int Visual::Lifetime() const
+{
+	return lifetime;
+}
+
+
+
+// The priority of the effect this visual came from.
+int Visual::Priority() const
+{
+	return priority;
+}
@@ -22,6 +22,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Point.h"
 
 class Effect;
+class Particle;
 
 
 
@@ -31,6 +32,9 @@ class Visual : public Body {
 public:
 	Visual() = default;
 	Visual(const Effect &effect, Point pos, Point vel, Angle facing, Point hitVelocity = Point());
+	// Make a visual that shows the given particle, for when particles can't be
+	// drawn by the sprite shader.
+	explicit Visual(const Particle &particle);
 
 	// Functions provided by the Body base class:
 	// Frame GetFrame(int step = -1) const;
@@ -43,10 +47,16 @@ public:
 	// Step the effect forward.
 	void Move();
 
+	// The number of steps until this visual disappears.
+	int Lifetime() const;
+	// The priority of the effect this visual came from.
+	int Priority() const;
+
 
 private:
 	Angle spin;
 	int lifetime = 0;
+	int priority = 0;
 };
 
 
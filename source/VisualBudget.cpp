@@ -0,0 +1,145 @@
+/* VisualBudget.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "VisualBudget.h"
+
+#include "BatchDrawList.h"
+#include "PowerGovernor.h"
+#include "Preferences.h"
+#include "Profiler.h"
+#include "Visual.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace {
+	// The limits of the automatic budget.
+	const double MIN_BUDGET = 100.;
+	const double MAX_BUDGET = 4000.;
+	// If steps take longer than this (in seconds), there are fewer new visuals
+	// each step. This leaves time for drawing, at 60 frames per second.
+	const double TARGET_TIME = .008;
+}
+
+
+
+// Set the part of the system that is in view.
+void VisualBudget::SetView(const Point &center, const Point &centerVelocity, double zoom)
+{
+	this->center = center;
+	this->centerVelocity = centerVelocity;
+	this->zoom = zoom;
+}
+
+
+
+// Move the visuals forward one step, and remove any that have ended or that
+// can never be seen.
+void VisualBudget::Step(vector<Visual> &visuals) const
+{
+	const double viewSpeed = centerVelocity.Length();
+	auto out = visuals.begin();
+	for(auto it = visuals.begin(); it != visuals.end(); ++it)
+	{
+		// In the time a visual has left, it and the view can only move so far
+		// relative to each other, unless the view speeds up a lot. Anything
+		// further off screen than that will never be seen.
+		double reach = it->Lifetime() * ((it->Velocity() - centerVelocity).Length() + viewSpeed);
+		if(BatchDrawList::IsOffScreen(*it, (it->Position() - center) * zoom, zoom, reach * zoom))
+			continue;
+
+		it->Move();
+		if(it->ShouldBeRemoved())
+			continue;
+		if(out != it)
+			*out = std::move(*it);
+		++out;
+	}
+	visuals.erase(out, visuals.end());
+}
+
+
+
+// Remove new visuals, starting at the given index, until there are no more
+// of them than the budget allows.
+void VisualBudget::Limit(vector<Visual> &visuals, size_t first)
+{
+	const size_t added = visuals.size() > first ? visuals.size() - first : 0;
+	const size_t limit = Budget();
+	Profiler::SetCounter("Visuals", visuals.size());
+	if(added <= limit)
+	{
+		Profiler::SetCounter("Visuals dropped", 0.);
+		return;
+	}
+
+	ranks.clear();
+	for(size_t i = first; i < visuals.size(); ++i)
+	{
+		const Visual &visual = visuals[i];
+		Point offset = visual.Position() - center;
+		ranks.push_back({BatchDrawList::IsOffScreen(visual, offset * zoom, zoom), visual.Priority(),
+			offset.LengthSquared(), i - first});
+	}
+	nth_element(ranks.begin(), ranks.begin() + limit, ranks.end(),
+		[](const Rank &a, const Rank &b) -> bool
+		{
+			if(a.isOffScreen != b.isOffScreen)
+				return b.isOffScreen;
+			if(a.priority != b.priority)
+				return a.priority > b.priority;
+			return a.distance < b.distance;
+		});
+
+	keep.assign(added, false);
+	for(size_t i = 0; i < limit; ++i)
+		keep[ranks[i].index] = true;
+
+	// Keep the visuals that are left in the order they were created.
+	size_t out = first;
+	for(size_t i = 0; i < added; ++i)
+		if(keep[i])
+		{
+			if(out != first + i)
+				visuals[out] = std::move(visuals[first + i]);
+			++out;
+		}
+	visuals.erase(visuals.begin() + out, visuals.end());
+	Profiler::SetCounter("Visuals dropped", added - limit);
+}
+
+
+
+// Adjust the automatic budget, given how long the latest step took.
+void VisualBudget::Tune(double seconds)
+{
+	// Smooth out the step times, so one slow step does not cut the budget.
+	stepTime += .1 * (seconds - stepTime);
+	if(stepTime > TARGET_TIME)
+		budget = max(MIN_BUDGET, budget * .95);
+	else if(stepTime < .5 * TARGET_TIME)
+		budget = min(MAX_BUDGET, budget + 10.);
+	Profiler::SetCounter("Visual budget", Budget());
+}
+
+
+
+// Get the most visuals that may be added in one step.
+size_t VisualBudget::Budget() const
+{
+	int preference = Preferences::VisualBudget();
+	return preference > 0 ? preference : static_cast<size_t>(budget * PowerGovernor::EffectScale());
+}
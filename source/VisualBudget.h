@@ -0,0 +1,81 @@
+/* VisualBudget.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef VISUAL_BUDGET_H_
+#define VISUAL_BUDGET_H_
+
+#include "Point.h"
+
+#include <cstddef>
+#include <vector>
+
+class Visual;
+
+
+
+// Class that keeps the number of visual effects in check when a lot is going
+// on at once, for example when dozens of ships explode in the same battle. Each
+// step, only so many new visuals are kept: first those on screen, then those of
+// effects with a higher priority, then those closest to the view. Visuals that
+// are so far off screen that they will be gone before they could come into view
+// are not moved at all, but removed. The budget can be set by the "visual
+// budget" preference. Otherwise, it shrinks when steps take too long, and grows
+// again once they are quick.
+class VisualBudget {
+public:
+	// Set the part of the system that is in view.
+	void SetView(const Point &center, const Point &centerVelocity, double zoom);
+
+	// Move the visuals forward one step, and remove any that have ended or that
+	// can never be seen.
+	void Step(std::vector<Visual> &visuals) const;
+	// Remove new visuals, starting at the given index, until there are no more
+	// of them than the budget allows.
+	void Limit(std::vector<Visual> &visuals, size_t first);
+
+	// Adjust the automatic budget, given how long the latest step took.
+	void Tune(double seconds);
+	// Get the most visuals that may be added in one step.
+	size_t Budget() const;
+
+
+private:
+	// How one new visual compares to the others, when deciding which to keep.
+	class Rank {
+	public:
+		bool isOffScreen;
+		int priority;
+		double distance;
+		size_t index;
+	};
+
+
+private:
+	Point center;
+	Point centerVelocity;
+	double zoom = 1.;
+
+	// The automatic budget, and the average time each step took.
+	double budget = 2000.;
+	double stepTime = 0.;
+
+	// These are kept to avoid reallocating them each step.
+	std::vector<Rank> ranks;
+	std::vector<bool> keep;
+};
+
+
+
+#endif
@@ -28,13 +28,21 @@ using namespace std;
 
 
 
+Weapon::Weapon()
+	: data(EmptyData())
+{
+}
+
+
+
 // Load from a "weapon" node, either in an outfit or in a ship (explosion).
 void Weapon::LoadWeapon(const DataNode &node)
 {
-	isWeapon = true;
+	Data &d = EditData();
+	d.isWeapon = true;
 	bool isClustered = false;
-	calculatedDamage = false;
-	doesDamage = false;
+	d.calculatedDamage = false;
+	d.doesDamage = false;
 	bool safeRangeOverriden = false;
 	bool disabledDamageSet = false;
 	bool minableDamageSet = false;
@@ -45,77 +53,77 @@ void Weapon::LoadWeapon(const DataNode &node)
 	{
 		const string &key = child.Token(0);
 		if(key == "stream")
-			isStreamed = true;
+			d.isStreamed = true;
 		else if(key == "cluster")
 			isClustered = true;
 		else if(key == "safe")
-			isSafe = true;
+			d.isSafe = true;
 		else if(key == "phasing")
-			isPhasing = true;
+			d.isPhasing = true;
 		else if(key == "no damage scaling")
-			isDamageScaled = false;
+			d.isDamageScaled = false;
 		else if(key == "parallel")
-			isParallel = true;
+			d.isParallel = true;
 		else if(key == "gravitational")
-			isGravitational = true;
+			d.isGravitational = true;
 		else if(child.Size() < 2)
 			child.PrintTrace("Skipping weapon attribute with no value specified:");
 		else if(key == "sprite")
-			sprite.LoadSprite(child);
+			d.sprite.LoadSprite(child);
 		else if(key == "hardpoint sprite")
-			hardpointSprite.LoadSprite(child);
+			d.hardpointSprite.LoadSprite(child);
 		else if(key == "sound")
-			sound = Audio::Get(child.Token(1));
+			d.sound = Audio::Get(child.Token(1));
 		else if(key == "ammo")
 		{
 			int usage = (child.Size() >= 3) ? child.Value(2) : 1;
 			ammo = make_pair(GameData::Outfits().Get(child.Token(1)), max(0, usage));
 		}
 		else if(key == "icon")
-			icon = SpriteSet::Get(child.Token(1));
+			d.icon = SpriteSet::Get(child.Token(1));
 		else if(key == "fire effect")
 		{
 			int count = (child.Size() >= 3) ? child.Value(2) : 1;
-			fireEffects[GameData::Effects().Get(child.Token(1))] += count;
+			d.fireEffects[GameData::Effects().Get(child.Token(1))] += count;
 		}
 		else if(key == "live effect")
 		{
 			int count = (child.Size() >= 3) ? child.Value(2) : 1;
-			liveEffects[GameData::Effects().Get(child.Token(1))] += count;
+			d.liveEffects[GameData::Effects().Get(child.Token(1))] += count;
 		}
 		else if(key == "hit effect")
 		{
 			int count = (child.Size() >= 3) ? child.Value(2) : 1;
-			hitEffects[GameData::Effects().Get(child.Token(1))] += count;
+			d.hitEffects[GameData::Effects().Get(child.Token(1))] += count;
 		}
 		else if(key == "target effect")
 		{
 			int count = (child.Size() >= 3) ? child.Value(2) : 1;
-			targetEffects[GameData::Effects().Get(child.Token(1))] += count;
+			d.targetEffects[GameData::Effects().Get(child.Token(1))] += count;
 		}
 		else if(key == "die effect")
 		{
 			int count = (child.Size() >= 3) ? child.Value(2) : 1;
-			dieEffects[GameData::Effects().Get(child.Token(1))] += count;
+			d.dieEffects[GameData::Effects().Get(child.Token(1))] += count;
 		}
 		else if(key == "submunition")
 		{
-			submunitions.emplace_back(
+			d.submunitions.emplace_back(
 				GameData::Outfits().Get(child.Token(1)),
 				(child.Size() >= 3) ? child.Value(2) : 1);
 			for(const DataNode &grand : child)
 			{
 				if((grand.Size() >= 2) && (grand.Token(0) == "facing"))
-					submunitions.back().facing = Angle(grand.Value(1));
+					d.submunitions.back().facing = Angle(grand.Value(1));
 				else if((grand.Size() >= 3) && (grand.Token(0) == "offset"))
-					submunitions.back().offset = Point(grand.Value(1), grand.Value(2));
+					d.submunitions.back().offset = Point(grand.Value(1), grand.Value(2));
 				else
 					child.PrintTrace("Skipping unknown or incomplete submunition attribute:");
 			}
 		}
 		else if(key == "inaccuracy")
 		{
-			inaccuracy = child.Value(1);
+			d.inaccuracy = child.Value(1);
 			for(const DataNode &grand : child)
 			{
 				for(int j = 0; j < grand.Size(); ++j)
@@ -123,17 +131,17 @@ void Weapon::LoadWeapon(const DataNode &node)
 					const string &token = grand.Token(j);
 
 					if(token == "inverted")
-						inaccuracyDistribution.second = true;
+						d.inaccuracyDistribution.second = true;
 					else if(token == "triangular")
-						inaccuracyDistribution.first = Distribution::Type::Triangular;
+						d.inaccuracyDistribution.first = Distribution::Type::Triangular;
 					else if(token == "uniform")
-						inaccuracyDistribution.first = Distribution::Type::Uniform;
+						d.inaccuracyDistribution.first = Distribution::Type::Uniform;
 					else if(token == "narrow")
-						inaccuracyDistribution.first = Distribution::Type::Narrow;
+						d.inaccuracyDistribution.first = Distribution::Type::Narrow;
 					else if(token == "medium")
-						inaccuracyDistribution.first = Distribution::Type::Medium;
+						d.inaccuracyDistribution.first = Distribution::Type::Medium;
 					else if(token == "wide")
-						inaccuracyDistribution.first = Distribution::Type::Wide;
+						d.inaccuracyDistribution.first = Distribution::Type::Wide;
 					else
 						grand.PrintTrace("Skipping unknown distribution attribute:");
 				}
@@ -143,29 +151,29 @@ void Weapon::LoadWeapon(const DataNode &node)
 		{
 			double value = child.Value(1);
 			if(key == "lifetime")
-				lifetime = max(0., value);
+				d.lifetime = max(0., value);
 			else if(key == "random lifetime")
-				randomLifetime = max(0., value);
+				d.randomLifetime = max(0., value);
 			else if(key == "reload")
-				reload = max(1., value);
+				d.reload = max(1., value);
 			else if(key == "burst reload")
-				burstReload = max(1., value);
+				d.burstReload = max(1., value);
 			else if(key == "burst count")
-				burstCount = max(1., value);
+				d.burstCount = max(1., value);
 			else if(key == "homing")
-				homing = value;
+				d.homing = value;
 			else if(key == "missile strength")
-				missileStrength = max(0., value);
+				d.missileStrength = max(0., value);
 			else if(key == "anti-missile")
-				antiMissile = max(0., value);
+				d.antiMissile = max(0., value);
 			else if(key == "velocity")
-				velocity = value;
+				d.velocity = value;
 			else if(key == "random velocity")
-				randomVelocity = value;
+				d.randomVelocity = value;
 			else if(key == "acceleration")
-				acceleration = value;
+				d.acceleration = value;
 			else if(key == "drag")
-				drag = value;
+				d.drag = value;
 			else if(key == "hardpoint offset")
 			{
 				// A single value specifies the y-offset, while two values
@@ -173,205 +181,205 @@ void Weapon::LoadWeapon(const DataNode &node)
 				// The point is specified in traditional XY orientation, but must
 				// be inverted along the y-dimension for internal use.
 				if(child.Size() == 2)
-					hardpointOffset = Point(0., -value);
+					d.hardpointOffset = Point(0., -value);
 				else if(child.Size() == 3)
-					hardpointOffset = Point(value, -child.Value(2));
+					d.hardpointOffset = Point(value, -child.Value(2));
 				else
 					child.PrintTrace("Unsupported \"" + key + "\" specification:");
 			}
 			else if(key == "turn")
-				turn = value;
+				d.turn = value;
 			else if(key == "turret turn")
-				turretTurn = value;
+				d.turretTurn = value;
 			else if(key == "tracking")
-				tracking = max(0., min(1., value));
+				d.tracking = max(0., min(1., value));
 			else if(key == "optical tracking")
-				opticalTracking = max(0., min(1., value));
+				d.opticalTracking = max(0., min(1., value));
 			else if(key == "infrared tracking")
-				infraredTracking = max(0., min(1., value));
+				d.infraredTracking = max(0., min(1., value));
 			else if(key == "radar tracking")
-				radarTracking = max(0., min(1., value));
+				d.radarTracking = max(0., min(1., value));
 			else if(key == "firing energy")
-				firingEnergy = value;
+				d.firingEnergy = value;
 			else if(key == "firing force")
-				firingForce = value;
+				d.firingForce = value;
 			else if(key == "firing fuel")
-				firingFuel = value;
+				d.firingFuel = value;
 			else if(key == "firing heat")
-				firingHeat = value;
+				d.firingHeat = value;
 			else if(key == "firing hull")
-				firingHull = value;
+				d.firingHull = value;
 			else if(key == "firing shields")
-				firingShields = value;
+				d.firingShields = value;
 			else if(key == "firing ion")
-				firingIon = value;
+				d.firingIon = value;
 			else if(key == "firing scramble")
-				firingScramble = value;
+				d.firingScramble = value;
 			else if(key == "firing slowing")
-				firingSlowing = value;
+				d.firingSlowing = value;
 			else if(key == "firing disruption")
-				firingDisruption = value;
+				d.firingDisruption = value;
 			else if(key == "firing discharge")
-				firingDischarge = value;
+				d.firingDischarge = value;
 			else if(key == "firing corrosion")
-				firingCorrosion = value;
+				d.firingCorrosion = value;
 			else if(key == "firing leak")
-				firingLeak = value;
+				d.firingLeak = value;
 			else if(key == "firing burn")
-				firingBurn = value;
+				d.firingBurn = value;
 			else if(key == "relative firing energy")
-				relativeFiringEnergy = value;
+				d.relativeFiringEnergy = value;
 			else if(key == "relative firing heat")
-				relativeFiringHeat = value;
+				d.relativeFiringHeat = value;
 			else if(key == "relative firing fuel")
-				relativeFiringFuel = value;
+				d.relativeFiringFuel = value;
 			else if(key == "relative firing hull")
-				relativeFiringHull = value;
+				d.relativeFiringHull = value;
 			else if(key == "relative firing shields")
-				relativeFiringShields = value;
+				d.relativeFiringShields = value;
 			else if(key == "split range")
-				splitRange = max(0., value);
+				d.splitRange = max(0., value);
 			else if(key == "trigger radius")
-				triggerRadius = max(0., value);
+				d.triggerRadius = max(0., value);
 			else if(key == "blast radius")
-				blastRadius = max(0., value);
+				d.blastRadius = max(0., value);
 			else if(key == "safe range override")
 			{
-				safeRange = max(0., value);
+				d.safeRange = max(0., value);
 				safeRangeOverriden = true;
 			}
 			else if(key == "shield damage")
-				damage[SHIELD_DAMAGE] = value;
+				d.damage[SHIELD_DAMAGE] = value;
 			else if(key == "hull damage")
-				damage[HULL_DAMAGE] = value;
+				d.damage[HULL_DAMAGE] = value;
 			else if(key == "disabled damage")
 			{
-				damage[DISABLED_DAMAGE] = value;
+				d.damage[DISABLED_DAMAGE] = value;
 				disabledDamageSet = true;
 			}
 			else if(key == "minable damage")
 			{
-				damage[MINABLE_DAMAGE] = value;
+				d.damage[MINABLE_DAMAGE] = value;
 				minableDamageSet = true;
 			}
 			else if(key == "fuel damage")
-				damage[FUEL_DAMAGE] = value;
+				d.damage[FUEL_DAMAGE] = value;
 			else if(key == "heat damage")
-				damage[HEAT_DAMAGE] = value;
+				d.damage[HEAT_DAMAGE] = value;
 			else if(key == "energy damage")
-				damage[ENERGY_DAMAGE] = value;
+				d.damage[ENERGY_DAMAGE] = value;
 			else if(key == "ion damage")
-				damage[ION_DAMAGE] = value;
+				d.damage[ION_DAMAGE] = value;
 			else if(key == "scrambling damage")
-				damage[WEAPON_JAMMING_DAMAGE] = value;
+				d.damage[WEAPON_JAMMING_DAMAGE] = value;
 			else if(key == "disruption damage")
-				damage[DISRUPTION_DAMAGE] = value;
+				d.damage[DISRUPTION_DAMAGE] = value;
 			else if(key == "slowing damage")
-				damage[SLOWING_DAMAGE] = value;
+				d.damage[SLOWING_DAMAGE] = value;
 			else if(key == "discharge damage")
-				damage[DISCHARGE_DAMAGE] = value;
+				d.damage[DISCHARGE_DAMAGE] = value;
 			else if(key == "corrosion damage")
-				damage[CORROSION_DAMAGE] = value;
+				d.damage[CORROSION_DAMAGE] = value;
 			else if(key == "leak damage")
-				damage[LEAK_DAMAGE] = value;
+				d.damage[LEAK_DAMAGE] = value;
 			else if(key == "burn damage")
-				damage[BURN_DAMAGE] = value;
+				d.damage[BURN_DAMAGE] = value;
 			else if(key == "relative shield damage")
-				damage[RELATIVE_SHIELD_DAMAGE] = value;
+				d.damage[RELATIVE_SHIELD_DAMAGE] = value;
 			else if(key == "relative hull damage")
-				damage[RELATIVE_HULL_DAMAGE] = value;
+				d.damage[RELATIVE_HULL_DAMAGE] = value;
 			else if(key == "relative disabled damage")
 			{
-				damage[RELATIVE_DISABLED_DAMAGE] = value;
+				d.damage[RELATIVE_DISABLED_DAMAGE] = value;
 				relativeDisabledDamageSet = true;
 			}
 			else if(key == "relative minable damage")
 			{
-				damage[RELATIVE_MINABLE_DAMAGE] = value;
+				d.damage[RELATIVE_MINABLE_DAMAGE] = value;
 				relativeMinableDamageSet = true;
 			}
 			else if(key == "relative fuel damage")
-				damage[RELATIVE_FUEL_DAMAGE] = value;
+				d.damage[RELATIVE_FUEL_DAMAGE] = value;
 			else if(key == "relative heat damage")
-				damage[RELATIVE_HEAT_DAMAGE] = value;
+				d.damage[RELATIVE_HEAT_DAMAGE] = value;
 			else if(key == "relative energy damage")
-				damage[RELATIVE_ENERGY_DAMAGE] = value;
+				d.damage[RELATIVE_ENERGY_DAMAGE] = value;
 			else if(key == "hit force")
-				damage[HIT_FORCE] = value;
+				d.damage[HIT_FORCE] = value;
 			else if(key == "piercing")
-				piercing = max(0., value);
+				d.piercing = max(0., value);
 			else if(key == "range override")
-				rangeOverride = max(0., value);
+				d.rangeOverride = max(0., value);
 			else if(key == "velocity override")
-				velocityOverride = max(0., value);
+				d.velocityOverride = max(0., value);
 			else if(key == "damage dropoff")
 			{
-				hasDamageDropoff = true;
+				d.hasDamageDropoff = true;
 				double maxDropoff = (child.Size() >= 3) ? child.Value(2) : 0.;
-				damageDropoffRange = make_pair(max(0., value), maxDropoff);
+				d.damageDropoffRange = make_pair(max(0., value), maxDropoff);
 			}
 			else if(key == "dropoff modifier")
-				damageDropoffModifier = max(0., value);
+				d.damageDropoffModifier = max(0., value);
 			else
 				child.PrintTrace("Unrecognized weapon attribute: \"" + key + "\":");
 		}
 	}
 	// Disabled damage defaults to hull damage instead of 0.
 	if(!disabledDamageSet)
-		damage[DISABLED_DAMAGE] = damage[HULL_DAMAGE];
+		d.damage[DISABLED_DAMAGE] = d.damage[HULL_DAMAGE];
 	if(!relativeDisabledDamageSet)
-		damage[RELATIVE_DISABLED_DAMAGE] = damage[RELATIVE_HULL_DAMAGE];
+		d.damage[RELATIVE_DISABLED_DAMAGE] = d.damage[RELATIVE_HULL_DAMAGE];
 	// Minable damage defaults to hull damage instead of 0.
 	if(!minableDamageSet)
-		damage[MINABLE_DAMAGE] = damage[HULL_DAMAGE];
+		d.damage[MINABLE_DAMAGE] = d.damage[HULL_DAMAGE];
 	if(!relativeMinableDamageSet)
-		damage[RELATIVE_MINABLE_DAMAGE] = damage[RELATIVE_HULL_DAMAGE];
+		d.damage[RELATIVE_MINABLE_DAMAGE] = d.damage[RELATIVE_HULL_DAMAGE];
 
 	// Sanity checks:
-	if(burstReload > reload)
-		burstReload = reload;
-	if(damageDropoffRange.first > damageDropoffRange.second)
-		damageDropoffRange.second = Range();
+	if(d.burstReload > d.reload)
+		d.burstReload = d.reload;
+	if(d.damageDropoffRange.first > d.damageDropoffRange.second)
+		d.damageDropoffRange.second = Range();
 
 	// Weapons of the same type will alternate firing (streaming) rather than
 	// firing all at once (clustering) if the weapon is not an anti-missile and
 	// is not vulnerable to anti-missile, or has the "stream" attribute.
-	isStreamed |= !(MissileStrength() || AntiMissile());
-	isStreamed &= !isClustered;
+	d.isStreamed |= !(MissileStrength() || AntiMissile());
+	d.isStreamed &= !isClustered;
 
 	// Support legacy missiles with no tracking type defined:
-	if(homing && !tracking && !opticalTracking && !infraredTracking && !radarTracking)
+	if(d.homing && !d.tracking && !d.opticalTracking && !d.infraredTracking && !d.radarTracking)
 	{
-		tracking = 1.;
+		d.tracking = 1.;
 		node.PrintTrace("Warning: Deprecated use of \"homing\" without use of \"[optical|infrared|radar] tracking.\"");
 	}
 
 	// Convert the "live effect" counts from occurrences per projectile lifetime
 	// into chance of occurring per frame.
-	if(lifetime <= 0)
-		liveEffects.clear();
-	for(auto it = liveEffects.begin(); it != liveEffects.end(); )
+	if(d.lifetime <= 0)
+		d.liveEffects.clear();
+	for(auto it = d.liveEffects.begin(); it != d.liveEffects.end(); )
 	{
 		if(!it->second)
-			it = liveEffects.erase(it);
+			it = d.liveEffects.erase(it);
 		else
 		{
-			it->second = max(1, lifetime / it->second);
+			it->second = max(1, d.lifetime / it->second);
 			++it;
 		}
 	}
 
 	// Only when the weapon is not safe and has a blast radius is safeRange needed,
 	// except if it is already overridden.
-	if(!isSafe && blastRadius > 0 && !safeRangeOverriden)
-		safeRange = (blastRadius + triggerRadius);
+	if(!d.isSafe && d.blastRadius > 0 && !safeRangeOverriden)
+		d.safeRange = (d.blastRadius + d.triggerRadius);
 }
 
 
 
 bool Weapon::IsWeapon() const
 {
-	return isWeapon;
+	return data->isWeapon;
 }
 
 
@@ -379,21 +387,21 @@ bool Weapon::IsWeapon() const
 // Get assets used by this weapon.
 const Body &Weapon::WeaponSprite() const
 {
-	return sprite;
+	return data->sprite;
 }
 
 
 
 const Body &Weapon::HardpointSprite() const
 {
-	return hardpointSprite;
+	return data->hardpointSprite;
 }
 
 
 
 const Sound *Weapon::WeaponSound() const
 {
-	return sound;
+	return data->sound;
 }
 
 
@@ -414,14 +422,14 @@ int Weapon::AmmoUsage() const
 
 bool Weapon::IsParallel() const
 {
-	return isParallel;
+	return data->isParallel;
 }
 
 
 
 const Sprite *Weapon::Icon() const
 {
-	return icon;
+	return data->icon;
 }
 
 
@@ -429,65 +437,65 @@ const Sprite *Weapon::Icon() const
 // Effects to be created at the start or end of the weapon's lifetime.
 const map<const Effect *, int> &Weapon::FireEffects() const
 {
-	return fireEffects;
+	return data->fireEffects;
 }
 
 
 
 const map<const Effect *, int> &Weapon::LiveEffects() const
 {
-	return liveEffects;
+	return data->liveEffects;
 }
 
 
 
 const map<const Effect *, int> &Weapon::HitEffects() const
 {
-	return hitEffects;
+	return data->hitEffects;
 }
 
 
 
 const map<const Effect *, int> &Weapon::TargetEffects() const
 {
-	return targetEffects;
+	return data->targetEffects;
 }
 
 
 
 const map<const Effect *, int> &Weapon::DieEffects() const
 {
-	return dieEffects;
+	return data->dieEffects;
 }
 
 
 
 const vector<Weapon::Submunition> &Weapon::Submunitions() const
 {
-	return submunitions;
+	return data->submunitions;
 }
 
 
 
 double Weapon::TotalLifetime() const
 {
-	if(rangeOverride)
-		return rangeOverride / WeightedVelocity();
-	if(totalLifetime < 0.)
+	if(data->rangeOverride)
+		return data->rangeOverride / WeightedVelocity();
+	if(data->totalLifetime < 0.)
 	{
-		totalLifetime = 0.;
-		for(const auto &it : submunitions)
-			totalLifetime = max(totalLifetime, it.weapon->TotalLifetime());
-		totalLifetime += lifetime;
+		data->totalLifetime = 0.;
+		for(const auto &it : data->submunitions)
+			data->totalLifetime = max(data->totalLifetime, it.weapon->TotalLifetime());
+		data->totalLifetime += data->lifetime;
 	}
-	return totalLifetime;
+	return data->totalLifetime;
 }
 
 
 
 double Weapon::Range() const
 {
-	return (rangeOverride > 0) ? rangeOverride : WeightedVelocity() * TotalLifetime();
+	return (data->rangeOverride > 0) ? data->rangeOverride : WeightedVelocity() * TotalLifetime();
 }
 
 
@@ -496,15 +504,15 @@ double Weapon::Range() const
 // distance that the projectile traveled if it has a damage dropoff range.
 double Weapon::DamageDropoff(double distance) const
 {
-	double minDropoff = damageDropoffRange.first;
-	double maxDropoff = damageDropoffRange.second;
+	double minDropoff = data->damageDropoffRange.first;
+	double maxDropoff = data->damageDropoffRange.second;
 
 	if(distance <= minDropoff)
 		return 1.;
 	if(distance >= maxDropoff)
-		return damageDropoffModifier;
+		return data->damageDropoffModifier;
 	// Damage modification is linear between the min and max dropoff points.
-	double slope = (1 - damageDropoffModifier) / (minDropoff - maxDropoff);
+	double slope = (1 - data->damageDropoffModifier) / (minDropoff - maxDropoff);
 	return slope * (distance - minDropoff) + 1;
 }
 
@@ -514,36 +522,62 @@ double Weapon::DamageDropoff(double distance) const
 // default turnrate.
 void Weapon::SetTurretTurn(double rate)
 {
-	turretTurn = rate;
+	EditData().turretTurn = rate;
 }
 
 
 
 double Weapon::TotalDamage(int index) const
 {
-	if(!calculatedDamage)
+	if(!data->calculatedDamage)
 	{
-		calculatedDamage = true;
+		data->calculatedDamage = true;
 		for(int i = 0; i < DAMAGE_TYPES; ++i)
 		{
-			for(const auto &it : submunitions)
-				damage[i] += it.weapon->TotalDamage(i) * it.count;
-			doesDamage |= (damage[i] > 0.);
+			for(const auto &it : data->submunitions)
+				data->damage[i] += it.weapon->TotalDamage(i) * it.count;
+			data->doesDamage |= (data->damage[i] > 0.);
 		}
 	}
-	return damage[index];
+	return data->damage[index];
 }
 
 
 
 pair<Distribution::Type, bool> Weapon::InaccuracyDistribution() const
 {
-	return inaccuracyDistribution;
+	return data->inaccuracyDistribution;
 }
 
 
 
 double Weapon::Inaccuracy() const
 {
-	return inaccuracy;
+	return data->inaccuracy;
+}
+
+
+
+// Get the block shared by everything that is not a weapon.
+const shared_ptr<Weapon::Data> &Weapon::EmptyData()
+{
+	// Its cached values are filled in already, so that it is never written to
+	// even though every thread may be reading it.
+	static const shared_ptr<Data> empty = [] {
+		shared_ptr<Data> data = make_shared<Data>();
+		data->totalLifetime = 0.;
+		return data;
+	}();
+	return empty;
+}
+
+
+
+// Get this weapon's block for changing it, copying it first if it is shared.
+Weapon::Data &Weapon::EditData()
+{
+	// The empty block is always shared, since EmptyData() holds on to it.
+	if(data.use_count() > 1)
+		data = make_shared<Data>(*data);
+	return *data;
 }
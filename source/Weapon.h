@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <cstddef>
 #include <map>
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -56,6 +57,8 @@ public:
 
 
 public:
+	Weapon();
+
 	// Load from a "weapon" node, either in an outfit, a ship (explosion), or a hazard.
 	void LoadWeapon(const DataNode &node);
 	bool IsWeapon() const;
@@ -208,89 +211,6 @@ private:
 
 
 private:
-	// Sprites and sounds.
-	Body sprite;
-	Body hardpointSprite;
-	const Sound *sound = nullptr;
-	const Sprite *icon = nullptr;
-
-	// Fire, die and hit effects.
-	std::map<const Effect *, int> fireEffects;
-	std::map<const Effect *, int> liveEffects;
-	std::map<const Effect *, int> hitEffects;
-	std::map<const Effect *, int> targetEffects;
-	std::map<const Effect *, int> dieEffects;
-	std::vector<Submunition> submunitions;
-
-	// This stores whether or not the weapon has been loaded.
-	bool isWeapon = false;
-	bool isStreamed = false;
-	bool isSafe = false;
-	bool isPhasing = false;
-	bool isDamageScaled = true;
-	bool isGravitational = false;
-	// Guns and missiles are by default aimed a converged point at the
-	// maximum weapons range in front of the ship. When either the installed
-	// weapon or the gun-port (or both) have the isParallel attribute set
-	// to true, then this convergence will not be used and the weapon will
-	// be aimed directly in the gunport angle/direction.
-	bool isParallel = false;
-
-	// Attributes.
-	int lifetime = 0;
-	int randomLifetime = 0;
-	double reload = 1.;
-	double burstReload = 1.;
-	int burstCount = 1;
-	int homing = 0;
-
-	int missileStrength = 0;
-	int antiMissile = 0;
-
-	double velocity = 0.;
-	double randomVelocity = 0.;
-	double acceleration = 0.;
-	double drag = 0.;
-	Point hardpointOffset = {0., 0.};
-
-	double turn = 0.;
-	double inaccuracy = 0.;
-	// A pair representing the disribution type of this weapon's inaccuracy
-	// and whether it is inverted
-	std::pair<Distribution::Type, bool> inaccuracyDistribution = {Distribution::Type::Triangular, false};
-	double turretTurn = 0.;
-
-	double tracking = 0.;
-	double opticalTracking = 0.;
-	double infraredTracking = 0.;
-	double radarTracking = 0.;
-
-	double firingEnergy = 0.;
-	double firingForce = 0.;
-	double firingFuel = 0.;
-	double firingHeat = 0.;
-	double firingHull = 0.;
-	double firingShields = 0.;
-	double firingIon = 0.;
-	double firingScramble = 0.;
-	double firingSlowing = 0.;
-	double firingDisruption = 0.;
-	double firingDischarge = 0.;
-	double firingCorrosion = 0.;
-	double firingLeak = 0.;
-	double firingBurn = 0.;
-
-	double relativeFiringEnergy = 0.;
-	double relativeFiringHeat = 0.;
-	double relativeFiringFuel = 0.;
-	double relativeFiringHull = 0.;
-	double relativeFiringShields = 0.;
-
-	double splitRange = 0.;
-	double triggerRadius = 0.;
-	double blastRadius = 0.;
-	double safeRange = 0.;
-
 	static const int DAMAGE_TYPES = 23;
 	static const int HIT_FORCE = 0;
 	// Normal damage types:
@@ -318,85 +238,187 @@ private:
 	static const int RELATIVE_FUEL_DAMAGE = 20;
 	static const int RELATIVE_HEAT_DAMAGE = 21;
 	static const int RELATIVE_ENERGY_DAMAGE = 22;
-	mutable double damage[DAMAGE_TYPES] = {};
 
-	double piercing = 0.;
+	// The weapon's characteristics are kept in a block of their own, so that
+	// outfits that are not weapons, and the attribute totals that every ship
+	// keeps, only hold a pointer to one shared empty block instead of a whole
+	// copy. Copies of a weapon share its block until one of them is loaded again.
+	class Data {
+	public:
+		// Sprites and sounds.
+		Body sprite;
+		Body hardpointSprite;
+		const Sound *sound = nullptr;
+		const Sprite *icon = nullptr;
+
+		// Fire, die and hit effects.
+		std::map<const Effect *, int> fireEffects;
+		std::map<const Effect *, int> liveEffects;
+		std::map<const Effect *, int> hitEffects;
+		std::map<const Effect *, int> targetEffects;
+		std::map<const Effect *, int> dieEffects;
+		std::vector<Submunition> submunitions;
+
+		// This stores whether or not the weapon has been loaded.
+		bool isWeapon = false;
+		bool isStreamed = false;
+		bool isSafe = false;
+		bool isPhasing = false;
+		bool isDamageScaled = true;
+		bool isGravitational = false;
+		// Guns and missiles are by default aimed a converged point at the
+		// maximum weapons range in front of the ship. When either the installed
+		// weapon or the gun-port (or both) have the isParallel attribute set
+		// to true, then this convergence will not be used and the weapon will
+		// be aimed directly in the gunport angle/direction.
+		bool isParallel = false;
+
+		// Attributes.
+		int lifetime = 0;
+		int randomLifetime = 0;
+		double reload = 1.;
+		double burstReload = 1.;
+		int burstCount = 1;
+		int homing = 0;
+
+		int missileStrength = 0;
+		int antiMissile = 0;
+
+		double velocity = 0.;
+		double randomVelocity = 0.;
+		double acceleration = 0.;
+		double drag = 0.;
+		Point hardpointOffset = {0., 0.};
+
+		double turn = 0.;
+		double inaccuracy = 0.;
+		// A pair representing the disribution type of this weapon's inaccuracy
+		// and whether it is inverted
+		std::pair<Distribution::Type, bool> inaccuracyDistribution = {Distribution::Type::Triangular, false};
+		double turretTurn = 0.;
+
+		double tracking = 0.;
+		double opticalTracking = 0.;
+		double infraredTracking = 0.;
+		double radarTracking = 0.;
+
+		double firingEnergy = 0.;
+		double firingForce = 0.;
+		double firingFuel = 0.;
+		double firingHeat = 0.;
+		double firingHull = 0.;
+		double firingShields = 0.;
+		double firingIon = 0.;
+		double firingScramble = 0.;
+		double firingSlowing = 0.;
+		double firingDisruption = 0.;
+		double firingDischarge = 0.;
+		double firingCorrosion = 0.;
+		double firingLeak = 0.;
+		double firingBurn = 0.;
+
+		double relativeFiringEnergy = 0.;
+		double relativeFiringHeat = 0.;
+		double relativeFiringFuel = 0.;
+		double relativeFiringHull = 0.;
+		double relativeFiringShields = 0.;
+
+		double splitRange = 0.;
+		double triggerRadius = 0.;
+		double blastRadius = 0.;
+		double safeRange = 0.;
+
+		mutable double damage[DAMAGE_TYPES] = {};
+
+		double piercing = 0.;
+
+		double rangeOverride = 0.;
+		double velocityOverride = 0.;
+
+		bool hasDamageDropoff = false;
+		std::pair<double, double> damageDropoffRange;
+		double damageDropoffModifier;
+
+		// Cache the calculation of these values, for faster access.
+		mutable bool calculatedDamage = true;
+		mutable bool doesDamage = false;
+		mutable double totalLifetime = -1.;
+	};
+
 
-	double rangeOverride = 0.;
-	double velocityOverride = 0.;
+private:
+	// Get the block shared by everything that is not a weapon.
+	static const std::shared_ptr<Data> &EmptyData();
+	// Get this weapon's block for changing it, copying it first if it is shared.
+	Data &EditData();
 
-	bool hasDamageDropoff = false;
-	std::pair<double, double> damageDropoffRange;
-	double damageDropoffModifier;
 
-	// Cache the calculation of these values, for faster access.
-	mutable bool calculatedDamage = true;
-	mutable bool doesDamage = false;
-	mutable double totalLifetime = -1.;
+private:
+	std::shared_ptr<Data> data;
 };
 
 
 
 // Inline the accessors because they get called so frequently.
-inline int Weapon::Lifetime() const { return lifetime; }
-inline int Weapon::RandomLifetime() const { return randomLifetime; }
-inline double Weapon::Reload() const { return reload; }
-inline double Weapon::BurstReload() const { return burstReload; }
-inline int Weapon::BurstCount() const { return burstCount; }
-inline int Weapon::Homing() const { return homing; }
-
-inline int Weapon::MissileStrength() const { return missileStrength; }
-inline int Weapon::AntiMissile() const { return antiMissile; }
-inline bool Weapon::IsStreamed() const { return isStreamed; }
-
-inline double Weapon::Velocity() const { return velocity; }
-inline double Weapon::RandomVelocity() const { return randomVelocity; }
-inline double Weapon::WeightedVelocity() const { return (velocityOverride > 0.) ? velocityOverride : velocity; }
-inline double Weapon::Acceleration() const { return acceleration; }
-inline double Weapon::Drag() const { return drag; }
-inline const Point &Weapon::HardpointOffset() const { return hardpointOffset; }
-
-inline double Weapon::Turn() const { return turn; }
-inline double Weapon::TurretTurn() const { return turretTurn; }
-
-inline double Weapon::Tracking() const { return tracking; }
-inline double Weapon::OpticalTracking() const { return opticalTracking; }
-inline double Weapon::InfraredTracking() const { return infraredTracking; }
-inline double Weapon::RadarTracking() const { return radarTracking; }
-
-inline double Weapon::FiringEnergy() const { return firingEnergy; }
-inline double Weapon::FiringForce() const { return firingForce; }
-inline double Weapon::FiringFuel() const { return firingFuel; }
-inline double Weapon::FiringHeat() const { return firingHeat; }
-inline double Weapon::FiringHull() const { return firingHull; }
-inline double Weapon::FiringShields() const { return firingShields; }
-inline double Weapon::FiringIon() const{ return firingIon; }
-inline double Weapon::FiringScramble() const { return firingScramble; }
-inline double Weapon::FiringSlowing() const{ return firingSlowing; }
-inline double Weapon::FiringDisruption() const{ return firingDisruption; }
-inline double Weapon::FiringDischarge() const{ return firingDischarge; }
-inline double Weapon::FiringCorrosion() const{ return firingCorrosion; }
-inline double Weapon::FiringLeak() const{ return firingLeak; }
-inline double Weapon::FiringBurn() const{ return firingBurn; }
-
-inline double Weapon::RelativeFiringEnergy() const{ return relativeFiringEnergy; }
-inline double Weapon::RelativeFiringHeat() const{ return relativeFiringHeat; }
-inline double Weapon::RelativeFiringFuel() const{ return relativeFiringFuel; }
-inline double Weapon::RelativeFiringHull() const{ return relativeFiringHull; }
-inline double Weapon::RelativeFiringShields() const{ return relativeFiringShields; }
-
-inline double Weapon::Piercing() const { return piercing; }
-
-inline double Weapon::SplitRange() const { return splitRange; }
-inline double Weapon::TriggerRadius() const { return triggerRadius; }
-inline double Weapon::BlastRadius() const { return blastRadius; }
-inline double Weapon::SafeRange() const { return safeRange; }
+inline int Weapon::Lifetime() const { return data->lifetime; }
+inline int Weapon::RandomLifetime() const { return data->randomLifetime; }
+inline double Weapon::Reload() const { return data->reload; }
+inline double Weapon::BurstReload() const { return data->burstReload; }
+inline int Weapon::BurstCount() const { return data->burstCount; }
+inline int Weapon::Homing() const { return data->homing; }
+
+inline int Weapon::MissileStrength() const { return data->missileStrength; }
+inline int Weapon::AntiMissile() const { return data->antiMissile; }
+inline bool Weapon::IsStreamed() const { return data->isStreamed; }
+
+inline double Weapon::Velocity() const { return data->velocity; }
+inline double Weapon::RandomVelocity() const { return data->randomVelocity; }
+inline double Weapon::WeightedVelocity() const { return (data->velocityOverride > 0.) ? data->velocityOverride : data->velocity; }
+inline double Weapon::Acceleration() const { return data->acceleration; }
+inline double Weapon::Drag() const { return data->drag; }
+inline const Point &Weapon::HardpointOffset() const { return data->hardpointOffset; }
+
+inline double Weapon::Turn() const { return data->turn; }
+inline double Weapon::TurretTurn() const { return data->turretTurn; }
+
+inline double Weapon::Tracking() const { return data->tracking; }
+inline double Weapon::OpticalTracking() const { return data->opticalTracking; }
+inline double Weapon::InfraredTracking() const { return data->infraredTracking; }
+inline double Weapon::RadarTracking() const { return data->radarTracking; }
+
+inline double Weapon::FiringEnergy() const { return data->firingEnergy; }
+inline double Weapon::FiringForce() const { return data->firingForce; }
+inline double Weapon::FiringFuel() const { return data->firingFuel; }
+inline double Weapon::FiringHeat() const { return data->firingHeat; }
+inline double Weapon::FiringHull() const { return data->firingHull; }
+inline double Weapon::FiringShields() const { return data->firingShields; }
+inline double Weapon::FiringIon() const{ return data->firingIon; }
+inline double Weapon::FiringScramble() const { return data->firingScramble; }
+inline double Weapon::FiringSlowing() const{ return data->firingSlowing; }
+inline double Weapon::FiringDisruption() const{ return data->firingDisruption; }
+inline double Weapon::FiringDischarge() const{ return data->firingDischarge; }
+inline double Weapon::FiringCorrosion() const{ return data->firingCorrosion; }
+inline double Weapon::FiringLeak() const{ return data->firingLeak; }
+inline double Weapon::FiringBurn() const{ return data->firingBurn; }
+
+inline double Weapon::RelativeFiringEnergy() const{ return data->relativeFiringEnergy; }
+inline double Weapon::RelativeFiringHeat() const{ return data->relativeFiringHeat; }
+inline double Weapon::RelativeFiringFuel() const{ return data->relativeFiringFuel; }
+inline double Weapon::RelativeFiringHull() const{ return data->relativeFiringHull; }
+inline double Weapon::RelativeFiringShields() const{ return data->relativeFiringShields; }
+
+inline double Weapon::Piercing() const { return data->piercing; }
+
+inline double Weapon::SplitRange() const { return data->splitRange; }
+inline double Weapon::TriggerRadius() const { return data->triggerRadius; }
+inline double Weapon::BlastRadius() const { return data->blastRadius; }
+inline double Weapon::SafeRange() const { return data->safeRange; }
 inline double Weapon::HitForce() const { return TotalDamage(HIT_FORCE); }
 
-inline bool Weapon::IsSafe() const { return isSafe; }
-inline bool Weapon::IsPhasing() const { return isPhasing; }
-inline bool Weapon::IsDamageScaled() const { return isDamageScaled; }
-inline bool Weapon::IsGravitational() const { return isGravitational; }
+inline bool Weapon::IsSafe() const { return data->isSafe; }
+inline bool Weapon::IsPhasing() const { return data->isPhasing; }
+inline bool Weapon::IsDamageScaled() const { return data->isDamageScaled; }
+inline bool Weapon::IsGravitational() const { return data->isGravitational; }
 
 inline double Weapon::ShieldDamage() const { return TotalDamage(SHIELD_DAMAGE); }
 inline double Weapon::HullDamage() const { return TotalDamage(HULL_DAMAGE); }
@@ -423,9 +445,9 @@ inline double Weapon::RelativeFuelDamage() const { return TotalDamage(RELATIVE_F
 inline double Weapon::RelativeHeatDamage() const { return TotalDamage(RELATIVE_HEAT_DAMAGE); }
 inline double Weapon::RelativeEnergyDamage() const { return TotalDamage(RELATIVE_ENERGY_DAMAGE); }
 
-inline bool Weapon::DoesDamage() const { if(!calculatedDamage) TotalDamage(0); return doesDamage; }
+inline bool Weapon::DoesDamage() const { if(!data->calculatedDamage) TotalDamage(0); return data->doesDamage; }
 
-inline bool Weapon::HasDamageDropoff() const { return hasDamageDropoff; }
+inline bool Weapon::HasDamageDropoff() const { return data->hasDamageDropoff; }
 
 
 
@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <cstddef>
 #include <iterator>
+#include <memory>
 #include <numeric>
 #include <stdexcept>
 #include <type_traits>
@@ -32,6 +33,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // list is weighted with an integer. This list can be queried to randomly return
 // one object from the list where the probability of an object being returned is
 // the weight of the object over the sum of the weights of all objects in the list.
+// Long lists are sampled with an "alias table," which is built the first time the
+// list is sampled after it changes and lets each draw take constant time.
 template <class Type>
 class WeightedList {
 	using iterator = typename std::vector<Type>::iterator;
@@ -59,7 +62,7 @@ public:
 	iterator end() noexcept { return choices.end(); }
 	const_iterator end() const noexcept { return choices.end(); }
 
-	void clear() noexcept { choices.clear(); weights.clear(); total = 0; }
+	void clear() noexcept { choices.clear(); weights.clear(); total = 0; table.reset(); }
 	void reserve(std::size_t n) { choices.reserve(n); weights.reserve(n); }
 	std::size_t size() const noexcept { return choices.size(); }
 	bool empty() const noexcept { return choices.empty(); }
@@ -73,14 +76,33 @@ public:
 	iterator erase(iterator first, iterator last) noexcept;
 
 
+private:
+	// Each choice is paired with an "alias," so that picking a choice at random
+	// and then either keeping it or taking its alias, with the right odds, has
+	// the same outcome as walking through the weights.
+	class AliasTable {
+	public:
+		// The chance, out of the total weight, of keeping each choice.
+		std::vector<std::size_t> threshold;
+		std::vector<unsigned> alias;
+	};
+
+
 private:
 	void RecalculateWeight();
+	std::shared_ptr<const AliasTable> BuildTable() const;
 
 
 private:
+	// Lists up to this long are quicker to walk through than to build a table for.
+	static constexpr std::size_t MAX_WALK_SIZE = 8;
+
 	std::vector<Type> choices;
 	std::vector<std::size_t> weights;
 	std::size_t total = 0;
+	// The table is shared by copies of this list until one of them changes. It
+	// may be built by several threads at once, so it is accessed atomically.
+	mutable std::shared_ptr<const AliasTable> table;
 };
 
 
@@ -130,11 +152,22 @@ const Type &WeightedList<Type>::Get() const
 	if(empty())
 		throw std::runtime_error("Attempted to call Get on an empty weighted list.");
 
-	unsigned index = 0;
-	for(unsigned choice = Random::Int(total); choice >= weights[index]; ++index)
-		choice -= weights[index];
-
-	return choices[index];
+	if(size() <= MAX_WALK_SIZE)
+	{
+		unsigned index = 0;
+		for(unsigned choice = Random::Int(total); choice >= weights[index]; ++index)
+			choice -= weights[index];
+		return choices[index];
+	}
+
+	std::shared_ptr<const AliasTable> current = std::atomic_load(&table);
+	if(!current)
+	{
+		current = BuildTable();
+		std::atomic_store(&table, current);
+	}
+	unsigned index = Random::Int(size());
+	return choices[Random::Int(total) < current->threshold[index] ? index : current->alias[index]];
 }
 
 
@@ -168,6 +201,7 @@ Type &WeightedList<Type>::emplace_back(int weight, Args&&... args)
 	choices.emplace_back(std::forward<Args>(args)...);
 	weights.emplace_back(weight);
 	total += weights.back();
+	table.reset();
 	return choices.back();
 }
 
@@ -179,6 +213,7 @@ typename std::vector<Type>::iterator WeightedList<Type>::eraseAt(typename std::v
 	unsigned index = std::distance(choices.begin(), position);
 	total -= weights[index];
 	weights.erase(std::next(weights.begin(), index));
+	table.reset();
 	return choices.erase(position);
 }
 
@@ -201,6 +236,48 @@ template <class Type>
 void WeightedList<Type>::RecalculateWeight()
 {
 	total = std::accumulate(weights.begin(), weights.end(), 0);
+	table.reset();
+}
+
+
+
+// Build the alias table with Vose's method. Every weight is scaled up by the
+// number of choices, so that each choice and its alias share a "bucket" of the
+// total weight and everything stays in integers.
+template <class Type>
+std::shared_ptr<const typename WeightedList<Type>::AliasTable> WeightedList<Type>::BuildTable() const
+{
+	const std::size_t count = weights.size();
+	auto result = std::make_shared<AliasTable>();
+	result->threshold.assign(count, total);
+	result->alias.resize(count);
+
+	std::vector<std::size_t> scaled(count);
+	std::vector<unsigned> small;
+	std::vector<unsigned> large;
+	for(unsigned i = 0; i < count; ++i)
+	{
+		scaled[i] = weights[i] * count;
+		(scaled[i] < total ? small : large).push_back(i);
+		result->alias[i] = i;
+	}
+	// Fill each bucket that is less than full with part of one that is over full.
+	while(!small.empty() && !large.empty())
+	{
+		unsigned under = small.back();
+		small.pop_back();
+		unsigned over = large.back();
+		result->threshold[under] = scaled[under];
+		result->alias[under] = over;
+		scaled[over] -= total - scaled[under];
+		if(scaled[over] < total)
+		{
+			large.pop_back();
+			small.push_back(over);
+		}
+	}
+	// Any buckets that are left are exactly full, and only ever pick themselves.
+	return result;
 }
 
 
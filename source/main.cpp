@@ -31,19 +31,29 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameData.h"
 #include "GameLoadingPanel.h"
 #include "GameWindow.h"
+#include "GpuProfiler.h"
 #include "Hardpoint.h"
+#include "InputQueue.h"
 #include "Logger.h"
+#include "MainPanel.h"
+#include "MemoryStats.h"
 #include "MenuPanel.h"
 #include "Panel.h"
 #include "PlayerInfo.h"
 #include "Plugins.h"
 #include "Preferences.h"
 #include "PrintData.h"
+#include "PowerGovernor.h"
+#include "Profiler.h"
+#include "Random.h"
+#include "Replay.h"
+#include "SaveQueue.h"
 #include "Screen.h"
 #include "SpriteSet.h"
 #include "SpriteShader.h"
 #include "Test.h"
 #include "TestContext.h"
+#include "ThreadPlacement.h"
 #include "TouchScreen.h"
 #include "UI.h"
 #include "text/FontSet.h"
@@ -71,13 +81,19 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 namespace {
 	// The delay in frames when debugging the integration tests.
 	constexpr int UI_DELAY = 60;
+	// If nothing on screen is animated, the frame rate drops to this once no
+	// events have arrived for the given number of frames.
+	constexpr int IDLE_FRAME_RATE = 20;
+	constexpr int IDLE_DELAY = 60;
 }
 
 using namespace std;
 
 void PrintHelp();
 void PrintVersion();
-void GameLoop(PlayerInfo &player, const Conversation &conversation, const string &testToRun, bool debugMode);
+void GameLoop(PlayerInfo &player, const Conversation &conversation, const string &testToRun, bool debugMode,
+	bool isBenchmark, const Replay *replay);
+bool StartReplay(const Replay &replay, TestContext &testContext, PlayerInfo &player, UI &gamePanels, UI &menuPanels);
 Conversation LoadConversation();
 void PrintTestsTable();
 #ifdef _WIN32
@@ -101,6 +117,10 @@ int main(int argc, char *argv[])
 	bool printData = false;
 	bool noTestMute = false;
 	string testToRunName = "";
+	bool isBenchmark = false;
+	string profilePath;
+	string replayPath;
+	bool memoryReport = false;
 
 	// Ensure that we log errors to the errors.txt file.
 	Logger::SetLogErrorCallback([](const string &errorMessage) { Files::LogErrorToFile(errorMessage); });
@@ -126,16 +146,40 @@ int main(int argc, char *argv[])
 			loadOnly = true;
 		else if(arg == "--test" && *++it)
 			testToRunName = *it;
+		else if(arg == "--benchmark" && *++it)
+		{
+			testToRunName = *it;
+			isBenchmark = true;
+		}
 		else if(arg == "--tests")
 			printTests = true;
 		else if(arg == "--nomute")
 			noTestMute = true;
+		else if(arg == "--profile" && *++it)
+			profilePath = *it;
+		else if(arg == "--replay" && *++it)
+		{
+			replayPath = *it;
+			isBenchmark = true;
+		}
+		else if(arg == "--memory-report")
+			memoryReport = true;
 	}
+	Profiler::SetEnabled(!profilePath.empty() || isBenchmark);
 	printData = PrintData::IsPrintDataArgument(argv);
 	Files::Init(argv);
 
+	Replay replay;
+	if(!replayPath.empty() && !replay.Load(replayPath))
+	{
+		Logger::LogError("Unable to read the replay \"" + replayPath + "\".");
+		return 1;
+	}
+	// Tests and replays both run without anyone at the controls.
+	const bool isAutomated = !testToRunName.empty() || !replayPath.empty();
+
 	// Config now set. It is safe to access the config now
-	CrashState::Init(!testToRunName.empty());
+	CrashState::Init(isAutomated);
 	CrashState::Set(CrashState::LOADED);
 
 	try {
@@ -143,12 +187,14 @@ int main(int argc, char *argv[])
 		Plugins::LoadSettings();
 		CrashState::Set(CrashState::DATA);
 		// Begin loading the game data.
-		bool isConsoleOnly = loadOnly || printTests || printData;
+		// A memory report on its own only needs the game data, but if a test or
+		// replay is being run, the report is printed once it ends.
+		bool isConsoleOnly = loadOnly || printTests || printData || (memoryReport && !isAutomated);
 		future<void> dataLoading = GameData::BeginLoad(isConsoleOnly, debugMode);
 
 		// If we are not using the UI, or performing some automated task, we should load
 		// all data now. (Sprites and sounds can safely be deferred.)
-		if(isConsoleOnly || !testToRunName.empty())
+		if(isConsoleOnly || isAutomated)
 			dataLoading.wait();
 
 		if(!testToRunName.empty() && !GameData::Tests().Has(testToRunName))
@@ -167,6 +213,12 @@ int main(int argc, char *argv[])
 			PrintTestsTable();
 			return 0;
 		}
+		if(memoryReport && !isAutomated)
+		{
+			GameData::FinishLoading();
+			cout << MemoryStats::Report() << flush;
+			return 0;
+		}
 
 		PlayerInfo player;
 		if(loadOnly)
@@ -211,13 +263,14 @@ int main(int argc, char *argv[])
 
 		Audio::Init(GameData::Sources());
 
-		if(!testToRunName.empty() && !noTestMute)
+		if(isAutomated && !noTestMute)
 		{
 			Audio::SetVolume(0);
 		}
 
 		// This is the main loop where all the action begins.
-		GameLoop(player, conversation, testToRunName, debugMode);
+		GameLoop(player, conversation, testToRunName, debugMode, isBenchmark,
+			replayPath.empty() ? nullptr : &replay);
 	}
 	catch(Test::known_failure_tag)
 	{
@@ -225,8 +278,10 @@ int main(int argc, char *argv[])
 	}
 	catch(const runtime_error &error)
 	{
+		// Make sure everything logged before the error is written out first.
+		Logger::Flush();
 		Audio::Quit();
-		bool doPopUp = testToRunName.empty();
+		bool doPopUp = !isAutomated;
 		GameWindow::ExitWithError(error.what(), doPopUp);
 		return 1;
 	}
@@ -237,6 +292,13 @@ int main(int argc, char *argv[])
 	Screen::SetRaw(GameWindow::Width(), GameWindow::Height());
 	Preferences::Save();
 	Plugins::Save();
+	SaveQueue::Wait();
+	if(!profilePath.empty())
+		Profiler::WriteTrace(profilePath);
+	if(isBenchmark)
+		cout << Profiler::SummaryJSON() << flush;
+	if(memoryReport)
+		cout << MemoryStats::Report() << flush;
 
 	Audio::Quit();
 	GameWindow::Quit();
@@ -263,6 +325,9 @@ int EventFilter(void* userdata, SDL_Event* event)
 	if (event->type == SDL_APP_DIDENTERBACKGROUND)
 	{
 		Audio::Pause();
+		// The game may be killed while it is in the background, so make sure
+		// that any saved games have been completely written.
+		SaveQueue::Wait();
 	}
 	else if (event->type == SDL_APP_DIDENTERFOREGROUND)
 	{
@@ -274,7 +339,8 @@ int EventFilter(void* userdata, SDL_Event* event)
 
 
 
-void GameLoop(PlayerInfo &player, const Conversation &conversation, const string &testToRunName, bool debugMode)
+void GameLoop(PlayerInfo &player, const Conversation &conversation, const string &testToRunName, bool debugMode,
+	bool isBenchmark, const Replay *replay)
 {
 	// For android, game loop does not run on the main thread, and some of these
 	// events need handled from within the java callback context. Handle them
@@ -291,6 +357,9 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 	// in the GameWindow::Init() function.
 	SDL_Init(SDL_INIT_GAMECONTROLLER);
 
+	// This thread does all the drawing, so keep it on the fastest cores.
+	ThreadPlacement::Assign(ThreadPlacement::Role::RENDER);
+
 	// gamePanels is used for the main panel where you fly your spaceship.
 	// All other game content related dialogs are placed on top of the gamePanels.
 	// If there are both menuPanels and gamePanels, then the menuPanels take
@@ -305,12 +374,16 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 	// Whether the game data is done loading. This is used to trigger any
 	// tests to run.
 	bool dataFinishedLoading = false;
-	menuPanels.Push(new GameLoadingPanel(player, conversation, gamePanels, dataFinishedLoading));
+	menuPanels.Push(new GameLoadingPanel(player, conversation, gamePanels, dataFinishedLoading, debugMode));
 
 	bool showCursor = true;
 	int cursorTime = 0;
 	int frameRate = 60;
 	FrameTimer timer(frameRate);
+	bool isIdle = false;
+	int idleFrames = 0;
+	// The events received in each frame, kept between frames to reuse its memory.
+	InputQueue inputQueue;
 	bool isPaused = false;
 	bool isFastForward = false;
 	int testDebugUIDelay = UI_DELAY;
@@ -325,6 +398,9 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 	TestContext testContext;
 	if(!testToRunName.empty())
 		testContext = TestContext(GameData::Tests().Get(testToRunName));
+	else if(replay)
+		testContext = TestContext(replay);
+	bool hasStartedReplay = false;
 
 	// IsDone becomes true when the game is quit.
 	while(!menuPanels.IsDone())
@@ -333,16 +409,12 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 			--toggleTimeout;
 		chrono::steady_clock::time_point start = chrono::steady_clock::now();
 
-		// Handle any events that occurred in this frame.
+		// Gather the events that occurred in this frame.
 		SDL_Event event;
+		++idleFrames;
+		inputQueue.Clear();
 		while(SDL_PollEvent(&event))
 		{
-			UI &activeUI = (menuPanels.IsEmpty() ? gamePanels : menuPanels);
-
-			// If the mouse moves, reset the cursor movement timeout.
-			if(event.type == SDL_MOUSEMOTION)
-				cursorTime = 0;
-
 			// Touch debugging hooks
 //#define TOUCH_DEBUGGING
 #ifdef TOUCH_DEBUGGING
@@ -391,8 +463,23 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 
 			// Filter the events through the touch manager. It will cache
 			// the set of fingers for polling, and generate gesture events.
+			// It sees every motion event, so that gestures keep their shape.
 			TouchScreen::Handle(event);
 
+			inputQueue.Add(event);
+		}
+
+		// Handle the events, with any motion of the same finger, mouse, or
+		// controller axis merged so that the panels only see where it ended up.
+		for(const SDL_Event &event : inputQueue.Events())
+		{
+			UI &activeUI = (menuPanels.IsEmpty() ? gamePanels : menuPanels);
+			idleFrames = 0;
+
+			// If the mouse moves, reset the cursor movement timeout.
+			if(event.type == SDL_MOUSEMOTION)
+				cursorTime = 0;
+
 			if(debugMode && event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_BACKQUOTE)
 			{
 				isPaused = !isPaused;
@@ -482,7 +569,7 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 
 		// All manual events and processing done. Handle any test inputs and events if we have any.
 		const Test *runningTest = testContext.CurrentTest();
-		if(runningTest && dataFinishedLoading)
+		if((runningTest || testContext.CurrentReplay()) && dataFinishedLoading)
 		{
 			// When flying around, all test processing must be handled in the
 			// thread-safe section of Engine. When not flying around (and when no
@@ -490,6 +577,19 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 			auto mainPanel = gamePanels.Root();
 			if(!isPaused && inFlight && menuPanels.IsEmpty() && mainPanel)
 				mainPanel->SetTestContext(testContext);
+			else if(!runningTest)
+			{
+				// A replay begins in place of the main menu. Only flight is
+				// recorded, so anything else that needs the player ends it.
+				if(!hasStartedReplay)
+				{
+					hasStartedReplay = true;
+					if(!StartReplay(*replay, testContext, player, gamePanels, menuPanels))
+						menuPanels.Quit();
+				}
+				else if(menuPanels.IsEmpty() && mainPanel)
+					menuPanels.Quit();
+			}
 			else if(debugMode && testDebugUIDelay > 0)
 				--testDebugUIDelay;
 			else
@@ -502,11 +602,12 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 				testDebugUIDelay = UI_DELAY;
 			}
 			// Skip drawing 29 out of every 30 in-flight frames during testing to speedup testing (unless debug mode is set).
-			// We don't skip UI-frames to ensure we test the UI code more.
+			// We don't skip UI-frames to ensure we test the UI code more. A benchmark only measures the simulation
+			// while in flight, so it never draws those frames.
 			if(inFlight && !debugMode)
 			{
 				skipFrame = (skipFrame + 1) % 30;
-				if(skipFrame)
+				if(skipFrame || isBenchmark)
 					continue;
 			}
 			else
@@ -524,9 +625,29 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 		}
 		else
 		{
-			if(frameRate < 60)
+			// If the player is not doing anything and nothing on screen is
+			// moving, there is no need to redraw it as often. Any event returns
+			// to the full frame rate right away.
+			// In battery saver mode, flight is drawn at half the frame rate, but the
+			// game takes two steps for each frame drawn so it still runs at full speed.
+			PowerGovernor::Step();
+			bool isBatterySaver = (inFlight && !isFastForward
+				&& (Preferences::Has("Battery saver") || PowerGovernor::HalveFrameRate()));
+			// The same is done for the main menu once the player stops using it,
+			// so that the credits keep scrolling at the same speed.
+			bool isMenuIdle = (!menuPanels.IsEmpty() && dataFinishedLoading && idleFrames >= IDLE_DELAY);
+			int fullFrameRate = (isBatterySaver || isMenuIdle) ? 30 : 60;
+			bool shouldIdle = (idleFrames >= IDLE_DELAY && !isFastForward
+				&& !(menuPanels.IsEmpty() ? gamePanels : menuPanels).IsAnimated());
+			if(shouldIdle != isIdle)
+			{
+				isIdle = shouldIdle;
+				frameRate = isIdle ? IDLE_FRAME_RATE : fullFrameRate;
+				timer.SetFrameRate(frameRate);
+			}
+			else if(frameRate != fullFrameRate && !isIdle)
 			{
-				frameRate = min(frameRate + 5, 60);
+				frameRate = (frameRate < fullFrameRate ? min(frameRate + 5, fullFrameRate) : fullFrameRate);
 				timer.SetFrameRate(frameRate);
 			}
 
@@ -536,21 +657,39 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 				if(skipFrame)
 					continue;
 			}
+			else if(isBatterySaver || (isMenuIdle && !isIdle))
+			{
+				skipFrame = (skipFrame + 1) % 2;
+				if(skipFrame)
+					continue;
+			}
 		}
 
 		Audio::Step();
+		// Upload any preloaded or streamed sprites that are now available. This
+		// is done every frame, so that the backlog of sprites does not fill up
+		// while in flight or on the menus. The loading panel does its own.
+		if(dataFinishedLoading)
+			GameData::ProcessSprites();
 
 		// Events in this frame may have cleared out the menu, in which case
 		// we should draw the game panels instead:
-		(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
-		if(isFastForward)
-			SpriteShader::Draw(SpriteSet::Get("ui/fast forward"), Screen::TopLeft() + Point(10., 10.));
+		{
+			Profiler::Zone zone("Draw");
+			(menuPanels.IsEmpty() ? gamePanels : menuPanels).DrawAll();
+			if(isFastForward)
+				SpriteShader::Draw(SpriteSet::Get("ui/fast forward"), Screen::TopLeft() + Point(10., 10.));
+		}
 
-		GameWindow::Step();
+		{
+			Profiler::Zone zone("Swap buffers");
+			GameWindow::Step();
+		}
+		GpuProfiler::EndFrame();
 
 		// When we perform automated testing, then we run the game by default as quickly as possible.
 		// Except when debug-mode is set.
-		if(!testContext.CurrentTest() || debugMode)
+		if((!testContext.CurrentTest() && !testContext.CurrentReplay()) || debugMode)
 			timer.Wait();
 
 		// If the player ended this frame in-game, count the elapsed time as played time.
@@ -565,6 +704,44 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 
 
 
+// Load the saved game that a replay begins from, and take off from it with the
+// replay's random seed, just as the player did when the flight was recorded.
+bool StartReplay(const Replay &replay, TestContext &testContext, PlayerInfo &player, UI &gamePanels, UI &menuPanels)
+{
+	// First, make sure the MainPanel the menu created has been deleted, so its
+	// background thread is no longer running. The copy of the saved game that
+	// is loaded must never be saved, so that nothing is written over.
+	gamePanels.Reset();
+	gamePanels.CanSave(false);
+
+	const string path = Files::Config() + "replay.txt";
+	Files::Write(path, replay.SavedGame());
+	player.Load(path);
+	if(!player.IsLoaded())
+	{
+		Logger::LogError("Unable to load the saved game in the replay.");
+		return false;
+	}
+	menuPanels.PopThrough(menuPanels.Root().get());
+
+	auto *mainPanel = new MainPanel(player);
+	gamePanels.Push(mainPanel);
+	Random::Seed(replay.Seed());
+	if(!player.TakeOff(&gamePanels))
+	{
+		Logger::LogError("Unable to take off in the replay.");
+		return false;
+	}
+	// The Engine places the ships just as it did when the player took off, and
+	// the first step after that is the first one that was recorded.
+	mainPanel->SetTestContext(testContext);
+	mainPanel->OnCallback();
+	mainPanel->SetTestContext(testContext);
+	return true;
+}
+
+
+
 void PrintHelp()
 {
 	cerr << endl;
@@ -579,6 +756,14 @@ void PrintHelp()
 	cerr << "    --tests: print table of available tests, then exit." << endl;
 	cerr << "    --test <name>: run given test from resources directory." << endl;
 	cerr << "    --nomute: don't mute the game while running tests." << endl;
+	cerr << "    --benchmark <name>: run given test without drawing in flight, then print the timing" << endl;
+	cerr << "        of each part of the frame, and each counter, to STDOUT as JSON." << endl;
+	cerr << "    --profile <file>: time each part of every frame, and save the timings to the given file" << endl;
+	cerr << "        as a Chrome trace on exit. The timings are also shown along with the CPU / GPU load." << endl;
+	cerr << "    --replay <file>: re-simulate a recorded flight without drawing it, then print its timings" << endl;
+	cerr << "        as with --benchmark. Use the same game data and preferences as the recording." << endl;
+	cerr << "    --memory-report: load the game data, then print how many bytes each part of the game uses" << endl;
+	cerr << "        to STDOUT. With --test, --benchmark or --replay, print it when the run ends instead." << endl;
 	PrintData::Help();
 	cerr << endl;
 	cerr << "Report bugs to: <https://github.com/endless-sky/endless-sky/issues>" << endl;
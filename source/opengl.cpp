@@ -23,9 +23,50 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #endif
 #endif
 
+#include "Profiler.h"
+
 #include <cstring>
 
 namespace {
+	// The state that was last set through the OpenGL class. Zero is a valid
+	// name in every case, so anything unknown is marked with the largest one.
+	const GLuint UNKNOWN = ~GLuint(0);
+	GLuint currentProgram = UNKNOWN;
+	GLuint currentVertexArray = UNKNOWN;
+	GLuint currentTexture2D = UNKNOWN;
+	GLuint currentTextureArray = UNKNOWN;
+	GLenum currentBlend[2] = {UNKNOWN, UNKNOWN};
+
+	// The number of binds made and skipped during this frame.
+	int binds = 0;
+	int skipped = 0;
+
+	GLuint *TextureSlot(GLenum target)
+	{
+		if(target == GL_TEXTURE_2D)
+			return &currentTexture2D;
+		if(target == GL_TEXTURE_2D_ARRAY)
+			return &currentTextureArray;
+		return nullptr;
+	}
+
+	// Record a change to the given state, and report whether it must be sent on
+	// to the driver.
+	bool Change(GLuint &current, GLuint value)
+	{
+		if(current == value)
+		{
+			++skipped;
+			return false;
+		}
+		current = value;
+		++binds;
+		return true;
+	}
+
+
+
+
 	bool HasOpenGLExtension(const char *name)
 	{
 #ifndef __APPLE__
@@ -43,6 +84,19 @@ namespace {
 		return value;
 #endif
 	}
+
+
+
+#ifndef ES_GLES
+	bool IsVersionAtLeast(GLint major, GLint minor)
+	{
+		GLint actualMajor = 0;
+		GLint actualMinor = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &actualMajor);
+		glGetIntegerv(GL_MINOR_VERSION, &actualMinor);
+		return actualMajor > major || (actualMajor == major && actualMinor >= minor);
+	}
+#endif
 }
 
 
@@ -67,3 +121,167 @@ bool OpenGL::HasSwizzleSupport()
 {
 	return HasOpenGLExtension("_texture_swizzle");
 }
+
+
+
+bool OpenGL::HasInstancingSupport()
+{
+#ifdef ES_GLES
+	// This is part of OpenGL ES 3.0.
+	return true;
+#else
+	// Vertex attribute divisors were added in OpenGL 3.3.
+	return IsVersionAtLeast(3, 3);
+#endif
+}
+
+
+
+bool OpenGL::HasFenceSupport()
+{
+#ifdef ES_GLES
+	// This is part of OpenGL ES 3.0.
+	return true;
+#else
+	return IsVersionAtLeast(3, 2);
+#endif
+}
+
+
+
+bool OpenGL::HasBufferStorageSupport()
+{
+#if defined(__APPLE__) || defined(ES_GLES)
+	// Neither macOS nor the OpenGL ES 3.0 headers provide glBufferStorage.
+	return false;
+#else
+	return IsVersionAtLeast(4, 4);
+#endif
+}
+
+
+
+bool OpenGL::HasAstcSupport()
+{
+	return HasOpenGLExtension("_texture_compression_astc_ldr");
+}
+
+
+
+bool OpenGL::HasProgramBinarySupport()
+{
+#ifndef ES_GLES
+	// Program binaries became part of OpenGL 4.1.
+	if(!IsVersionAtLeast(4, 1) && !HasOpenGLExtension("_get_program_binary"))
+		return false;
+#endif
+	// Even when they are supported, some drivers do not provide any formats.
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	return formats > 0;
+}
+
+
+
+bool OpenGL::HasBptcSupport()
+{
+#ifdef ES_GLES
+	return HasOpenGLExtension("_texture_compression_bptc");
+#else
+	// BPTC (which includes BC7) became part of OpenGL 4.2.
+	return IsVersionAtLeast(4, 2) || HasOpenGLExtension("_texture_compression_bptc");
+#endif
+}
+
+
+
+bool OpenGL::HasTimerQuerySupport()
+{
+#ifdef ES_GLES
+	return HasOpenGLExtension("_disjoint_timer_query");
+#else
+	// Timer queries became part of OpenGL 3.3.
+	return IsVersionAtLeast(3, 3) || HasOpenGLExtension("_timer_query");
+#endif
+}
+
+
+
+void OpenGL::UseProgram(GLuint program)
+{
+	if(Change(currentProgram, program))
+		glUseProgram(program);
+}
+
+
+
+void OpenGL::BindVertexArray(GLuint vao)
+{
+	if(Change(currentVertexArray, vao))
+		glBindVertexArray(vao);
+}
+
+
+
+void OpenGL::BindTexture(GLenum target, GLuint texture)
+{
+	GLuint *slot = TextureSlot(target);
+	if(!slot)
+	{
+		++binds;
+		glBindTexture(target, texture);
+	}
+	else if(Change(*slot, texture))
+		glBindTexture(target, texture);
+}
+
+
+
+void OpenGL::BlendFunc(GLenum source, GLenum destination)
+{
+	if(currentBlend[0] == source && currentBlend[1] == destination)
+	{
+		++skipped;
+		return;
+	}
+	currentBlend[0] = source;
+	currentBlend[1] = destination;
+	++binds;
+	glBlendFunc(source, destination);
+}
+
+
+
+void OpenGL::DeleteTextures(GLsizei count, const GLuint *textures)
+{
+	for(GLsizei i = 0; i < count; ++i)
+	{
+		if(currentTexture2D == textures[i])
+			currentTexture2D = 0;
+		if(currentTextureArray == textures[i])
+			currentTextureArray = 0;
+	}
+	glDeleteTextures(count, textures);
+}
+
+
+
+void OpenGL::ResetState()
+{
+	currentProgram = UNKNOWN;
+	currentVertexArray = UNKNOWN;
+	currentTexture2D = UNKNOWN;
+	currentTextureArray = UNKNOWN;
+	currentBlend[0] = UNKNOWN;
+	currentBlend[1] = UNKNOWN;
+}
+
+
+
+void OpenGL::ReportFrame()
+{
+	Profiler::SetCounter("GL binds", binds);
+	Profiler::SetCounter("GL binds skipped", skipped);
+	binds = 0;
+	skipped = 0;
+}
@@ -33,6 +33,37 @@ class OpenGL
 public:
 	static bool HasAdaptiveVSyncSupport();
 	static bool HasSwizzleSupport();
+	// Whether instanced drawing with per-instance vertex attributes is available.
+	static bool HasInstancingSupport();
+	// Whether fence sync objects are available, and whether buffers can also be
+	// created with immutable storage that stays mapped while it is being drawn.
+	static bool HasFenceSupport();
+	static bool HasBufferStorageSupport();
+	// Whether the ASTC (LDR) and BPTC (BC7) compressed texture formats can be used.
+	static bool HasAstcSupport();
+	static bool HasBptcSupport();
+	// Whether linked shader programs can be saved and loaded again in the
+	// driver's own binary format.
+	static bool HasProgramBinarySupport();
+	// Whether queries can measure how long the graphics card takes to run a
+	// series of commands.
+	static bool HasTimerQuerySupport();
+
+	// Change the bound program, vertex array, texture or blending function only
+	// if it differs from what was last set through these functions. All code
+	// must bind these through here, or the remembered state will be wrong.
+	static void UseProgram(GLuint program);
+	static void BindVertexArray(GLuint vao);
+	// Only texture unit 0 is ever used, so one texture is tracked per target.
+	static void BindTexture(GLenum target, GLuint texture);
+	static void BlendFunc(GLenum source, GLenum destination);
+	// Deleting a bound texture unbinds it, and its name may then be reused.
+	static void DeleteTextures(GLsizei count, const GLuint *textures);
+	// Forget what is bound, e.g. because a new context was created.
+	static void ResetState();
+	// Report how many binds were made and skipped since the last call to the
+	// profiler. This should be called once per frame.
+	static void ReportFrame();
 };
 
 
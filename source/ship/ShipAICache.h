@@ -37,6 +37,13 @@ public:
 	double ShortestArtillery() const;
 	double MinSafeDistance() const;
 
+	// Remember whether this ship's latest search for a target found nothing,
+	// and how many events that could change the outcome had happened by then.
+	void SetFoundNoTarget(bool foundNone, unsigned eventCount);
+	// Check if searching for a target again would be wasted, because the last
+	// search found nothing and none of those events have happened since.
+	bool HasNoTarget(unsigned eventCount) const;
+
 
 private:
 	double mass = 0.;
@@ -46,6 +53,9 @@ private:
 	double shortestArtillery = 4000.;
 	double minSafeDistance = 0.;
 	double maxTurningRadius = 200.;
+
+	bool foundNoTarget = false;
+	unsigned noTargetEventCount = 0;
 };
 
 
@@ -56,6 +66,17 @@ inline double ShipAICache::ShortestRange() const { return shortestRange; }
 inline double ShipAICache::ShortestArtillery() const { return shortestArtillery; }
 inline double ShipAICache::MinSafeDistance() const { return minSafeDistance; }
 
+inline void ShipAICache::SetFoundNoTarget(bool foundNone, unsigned eventCount)
+{
+	foundNoTarget = foundNone;
+	noTargetEventCount = eventCount;
+}
+
+inline bool ShipAICache::HasNoTarget(unsigned eventCount) const
+{
+	return foundNoTarget && noTargetEventCount == eventCount;
+}
+
 
 
 #endif
@@ -0,0 +1,38 @@
+/* ShipFrameStats.h
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SHIP_FRAME_STATS_H_
+#define SHIP_FRAME_STATS_H_
+
+
+
+// The movement stats of a ship that its own movement and the AI read many times
+// each frame. The ship derives them once per step, after its status effects and
+// any jettisoned cargo have been applied, so that they reflect its current mass.
+struct ShipFrameStats {
+	double inertialMass = 0.;
+	double drag = 0.;
+	double turnRate = 0.;
+	double acceleration = 0.;
+	double maxVelocity = 0.;
+	double reverseAcceleration = 0.;
+	double maxReverseVelocity = 0.;
+	// The factor that slowing effects apply to turning and thrust.
+	double slowMultiplier = 1.;
+};
+
+
+
+#endif
@@ -38,24 +38,18 @@ namespace {
 		"// vertex font shader\n"
 		// "scale" maps pixel coordinates to GL coordinates (-1 to 1).
 		"uniform vec2 scale;\n"
-		// The (x, y) coordinates of the top left corner of the glyph.
-		"uniform vec2 position;\n"
-		// The glyph to draw. (ASCII value - 32).
-		"uniform int glyph;\n"
-		// Aspect ratio of rendered glyph (unity by default).
-		"uniform float aspect;\n"
-
-		// Inputs from the VBO.
+
+		// Inputs from the VBO: the position of each corner of each glyph, in
+		// pixels, and where that corner is in the font texture.
 		"in vec2 vert;\n"
 		"in vec2 corner;\n"
 
 		// Output to the fragment shader.
 		"out vec2 texCoord;\n"
 
-		// Pick the proper glyph out of the texture.
 		"void main() {\n"
-		"  texCoord = vec2((float(glyph) + corner.x) / 98.f, corner.y);\n"
-		"  gl_Position = vec4((aspect * vert.x + position.x) * scale.x, (vert.y + position.y) * scale.y, 0.f, 1.f);\n"
+		"  texCoord = corner;\n"
+		"  gl_Position = vec4(vert * scale, 0.f, 1.f);\n"
 		"}\n";
 
 	const char *fragmentCode =
@@ -77,6 +71,22 @@ namespace {
 		"}\n";
 
 	const int KERN = 2;
+
+	// Add the two triangles that make up one glyph to the given vertex data.
+	void AddGlyph(vector<GLfloat> &vertices, float x, float y, float width, float height, int glyph, int glyphs)
+	{
+		const float left = static_cast<float>(glyph) / glyphs;
+		const float right = static_cast<float>(glyph + 1) / glyphs;
+		const GLfloat corners[6][4] = {
+			{x, y, left, 0.f},
+			{x, y + height, left, 1.f},
+			{x + width, y, right, 0.f},
+			{x + width, y, right, 0.f},
+			{x, y + height, left, 1.f},
+			{x + width, y + height, right, 1.f}
+		};
+		vertices.insert(vertices.end(), &corners[0][0], &corners[0][0] + 6 * 4);
+	}
 }
 
 
@@ -138,24 +148,11 @@ void Font::Draw(const string &str, const Point &point, const Color &color) const
 
 void Font::DrawAliased(const string &str, double x, double y, const Color &color) const
 {
-	glUseProgram(shader.Object());
-	glBindTexture(GL_TEXTURE_2D, texture);
-	glBindVertexArray(vao);
-
-	glUniform4fv(colorI, 1, color.Get());
-
-	// Update the scale, only if the screen size has changed.
-	if(Screen::Width() != screenWidth || Screen::Height() != screenHeight)
-	{
-		screenWidth = Screen::Width();
-		screenHeight = Screen::Height();
-		GLfloat scale[2] = {2.f / screenWidth, -2.f / screenHeight};
-		glUniform2fv(scaleI, 1, scale);
-	}
-
-	GLfloat textPos[2] = {
-		static_cast<float>(x - 1.),
-		static_cast<float>(y)};
+	// Build the vertices for every glyph in the string, so that the whole
+	// string can be drawn with a single call.
+	vertices.clear();
+	float textX = x - 1.;
+	const float textY = y;
 	int previous = 0;
 	bool isAfterSpace = true;
 	bool underlineChar = false;
@@ -174,35 +171,47 @@ void Font::DrawAliased(const string &str, double x, double y, const Color &color
 			isAfterSpace = !glyph;
 		if(!glyph)
 		{
-			textPos[0] += space;
+			textX += space;
 			continue;
 		}
 
-		glUniform1i(glyphI, glyph);
-		glUniform1f(aspectI, 1.f);
-
-		textPos[0] += advance[previous * GLYPHS + glyph] + KERN;
-		glUniform2fv(positionI, 1, textPos);
-
-		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		textX += advance[previous * GLYPHS + glyph] + KERN;
+		AddGlyph(vertices, textX, textY, glyphWidth, glyphHeight, glyph, GLYPHS);
 
 		if(underlineChar)
 		{
-			glUniform1i(glyphI, underscoreGlyph);
-			glUniform1f(aspectI, static_cast<float>(advance[glyph * GLYPHS] + KERN)
-				/ (advance[underscoreGlyph * GLYPHS] + KERN));
-
-			glUniform2fv(positionI, 1, textPos);
-
-			glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+			// Stretch the underscore to the width of the glyph it is under.
+			float aspect = static_cast<float>(advance[glyph * GLYPHS] + KERN)
+				/ (advance[underscoreGlyph * GLYPHS] + KERN);
+			AddGlyph(vertices, textX, textY, aspect * glyphWidth, glyphHeight, underscoreGlyph, GLYPHS);
 			underlineChar = false;
 		}
 
 		previous = glyph;
 	}
+	if(vertices.empty())
+		return;
+
+	OpenGL::UseProgram(shader.Object());
+	OpenGL::BindTexture(GL_TEXTURE_2D, texture);
+	OpenGL::BindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+	glUniform4fv(colorI, 1, color.Get());
+
+	// Update the scale, only if the screen size has changed.
+	if(Screen::Width() != screenWidth || Screen::Height() != screenHeight)
+	{
+		screenWidth = Screen::Width();
+		screenHeight = Screen::Height();
+		GLfloat scale[2] = {2.f / screenWidth, -2.f / screenHeight};
+		glUniform2fv(scaleI, 1, scale);
+	}
+
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLfloat), vertices.data(), GL_STREAM_DRAW);
+	glDrawArrays(GL_TRIANGLES, 0, vertices.size() / 4);
 
-	glBindVertexArray(0);
-	glUseProgram(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 
@@ -260,7 +269,7 @@ int Font::Glyph(char c, bool isAfterSpace) noexcept
 void Font::LoadTexture(ImageBuffer &image)
 {
 	glGenTextures(1, &texture);
-	glBindTexture(GL_TEXTURE_2D, texture);
+	OpenGL::BindTexture(GL_TEXTURE_2D, texture);
 
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -270,7 +279,7 @@ void Font::LoadTexture(ImageBuffer &image)
 	if (image.CompressedFormat())
 	{
 		glCompressedTexImage2D(GL_TEXTURE_2D, 0, image.CompressedFormat(),
-			image.Width(), image.Height(), 0, image.CompressedSize(), image.Pixels());
+			image.Width(), image.Height(), 0, image.CompressedSize(), image.Data());
 	}
 	else
 	{
@@ -347,29 +356,21 @@ void Font::CalculateAdvances(ImageBuffer &image)
 
 void Font::SetUpShader(float glyphW, float glyphH)
 {
-	glyphW *= .5f;
-	glyphH *= .5f;
+	glyphWidth = glyphW * .5f;
+	glyphHeight = glyphH * .5f;
 
 	shader = Shader(vertexCode, fragmentCode);
-	glUseProgram(shader.Object());
+	OpenGL::UseProgram(shader.Object());
 	glUniform1i(shader.Uniform("tex"), 0);
-	glUseProgram(0);
+	OpenGL::UseProgram(0);
 
-	// Create the VAO and VBO.
+	// Create the VAO and VBO. The vertex data is uploaded each time a string is drawn.
 	glGenVertexArrays(1, &vao);
-	glBindVertexArray(vao);
+	OpenGL::BindVertexArray(vao);
 
 	glGenBuffers(1, &vbo);
 	glBindBuffer(GL_ARRAY_BUFFER, vbo);
 
-	GLfloat vertices[] = {
-		   0.f,    0.f, 0.f, 0.f,
-		   0.f, glyphH, 0.f, 1.f,
-		glyphW,    0.f, 1.f, 0.f,
-		glyphW, glyphH, 1.f, 1.f
-	};
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
 	// Connect the xy to the "vert" attribute of the vertex shader.
 	constexpr auto stride = 4 * sizeof(GLfloat);
 	glEnableVertexAttribArray(shader.Attrib("vert"));
@@ -380,7 +381,7 @@ void Font::SetUpShader(float glyphW, float glyphH)
 		stride, reinterpret_cast<const GLvoid *>(2 * sizeof(GLfloat)));
 
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindVertexArray(0);
+	OpenGL::BindVertexArray(0);
 
 	// We must update the screen size next time we draw.
 	screenWidth = 0;
@@ -388,9 +389,6 @@ void Font::SetUpShader(float glyphW, float glyphH)
 
 	colorI = shader.Uniform("color");
 	scaleI = shader.Uniform("scale");
-	glyphI = shader.Uniform("glyph");
-	aspectI = shader.Uniform("aspect");
-	positionI = shader.Uniform("position");
 }
 
 
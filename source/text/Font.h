@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../opengl.h"
 
 #include <string>
+#include <vector>
 
 class Color;
 class DisplayText;
@@ -81,9 +82,12 @@ private:
 
 	GLint colorI = 0;
 	GLint scaleI = 0;
-	GLint glyphI = 0;
-	GLint aspectI = 0;
-	GLint positionI = 0;
+
+	// The size each glyph is drawn at, in pixels.
+	float glyphWidth = 0.f;
+	float glyphHeight = 0.f;
+	// The vertices of the string being drawn, kept to avoid reallocating them.
+	mutable std::vector<GLfloat> vertices;
 
 	int height = 0;
 	int space = 0;
@@ -313,6 +313,9 @@ string Format::Replace(const string &source, const map<string, string> &keys)
 	string result;
 	result.reserve(source.length());
 
+	// Each candidate key is looked up directly rather than compared against every
+	// entry in the map, and the same buffer holds each candidate in turn.
+	string key;
 	size_t start = 0;
 	size_t search = start;
 	while(search < source.length())
@@ -325,21 +328,17 @@ string Format::Replace(const string &source, const map<string, string> &keys)
 		if(right == string::npos)
 			break;
 
-		bool matched = false;
 		++right;
-		size_t length = right - left;
-		for(const auto &it : keys)
-			if(!source.compare(left, length, it.first))
-			{
-				result.append(source, start, left - start);
-				result.append(it.second);
-				start = right;
-				search = start;
-				matched = true;
-				break;
-			}
-
-		if(!matched)
+		key.assign(source, left, right - left);
+		auto it = keys.find(key);
+		if(it != keys.end())
+		{
+			result.append(source, start, left - start);
+			result.append(it->second);
+			start = right;
+			search = start;
+		}
+		else
 			search = left + 1;
 	}
 
@@ -355,23 +354,26 @@ void Format::ReplaceAll(string &text, const string &target, const string &replac
 	if(target.empty())
 		return;
 
+	// Index at which the target string was found. If it never is, the text
+	// can be left alone instead of being copied.
+	size_t findPos = text.find(target);
+	if(findPos == string::npos)
+		return;
+
 	string newString;
 	newString.reserve(text.length());
 
 	// Index at which to begin searching for the target string.
 	size_t start = 0;
 	size_t matchLength = target.length();
-	// Index at which the target string was found.
-	size_t findPos = string::npos;
-	while((findPos = text.find(target, start)) != string::npos)
-	{
+	do {
 		newString.append(text, start, findPos - start);
 		newString += replacement;
 		start = findPos + matchLength;
-	}
+	} while((findPos = text.find(target, start)) != string::npos);
 
 	// Add the remaining text.
-	newString += text.substr(start);
+	newString.append(text, start, string::npos);
 
 	text.swap(newString);
 }
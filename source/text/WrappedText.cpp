@@ -19,9 +19,68 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Font.h"
 
 #include <cstring>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 using namespace std;
 
+namespace {
+	// The number of wrapped strings to remember. Panels usually only show a few
+	// blocks of wrapped text at once, but some, like the shops, wrap a new
+	// description each time the selection changes.
+	const size_t CACHE_SIZE = 256;
+
+	// Everything that affects how a string is wrapped.
+	class LayoutKey {
+	public:
+		bool operator==(const LayoutKey &other) const
+		{
+			return font == other.font && wrapWidth == other.wrapWidth && tabWidth == other.tabWidth
+				&& lineHeight == other.lineHeight && paragraphBreak == other.paragraphBreak
+				&& alignment == other.alignment && text == other.text;
+		}
+
+		size_t Hash() const
+		{
+			size_t result = hash<string>()(text);
+			for(size_t value : {reinterpret_cast<size_t>(font), static_cast<size_t>(wrapWidth),
+					static_cast<size_t>(tabWidth), static_cast<size_t>(lineHeight),
+					static_cast<size_t>(paragraphBreak), static_cast<size_t>(alignment)})
+				result ^= value + 0x9E3779B9 + (result << 6) + (result >> 2);
+			return result;
+		}
+
+	public:
+		const Font *font;
+		int wrapWidth;
+		int tabWidth;
+		int lineHeight;
+		int paragraphBreak;
+		Alignment alignment;
+		string text;
+	};
+
+	// The result of wrapping a string: the text with each word terminated, and
+	// the index and position of each of those words.
+	class CachedLayout {
+	public:
+		LayoutKey key;
+		string text;
+		vector<size_t> index;
+		vector<Point> position;
+		int height;
+		int longestWidth;
+	};
+
+	// The most recently used layouts, in the order they were last used. Each
+	// layout is also indexed by the hash of its key.
+	mutex cacheMutex;
+	list<CachedLayout> cache;
+	unordered_map<size_t, list<CachedLayout>::iterator> cacheIndex;
+}
+
 
 
 WrappedText::WrappedText(const Font &font)
@@ -257,6 +316,67 @@ void WrappedText::Wrap()
 	if(text.empty() || !font)
 		return;
 
+	// Much of the text in the game, like descriptions and conversations, is
+	// wrapped again each time a panel is shown or its selection changes, so the
+	// layout of recently wrapped strings is remembered and reused.
+	LayoutKey key = {font, wrapWidth, tabWidth, lineHeight, paragraphBreak, alignment, text};
+	size_t keyHash = key.Hash();
+	{
+		lock_guard<mutex> lock(cacheMutex);
+		auto it = cacheIndex.find(keyHash);
+		if(it != cacheIndex.end() && it->second->key == key)
+		{
+			// Move this layout to the front of the list, as the most recently used.
+			cache.splice(cache.begin(), cache, it->second);
+			const CachedLayout &layout = cache.front();
+			text = layout.text;
+			words.resize(layout.index.size());
+			for(size_t i = 0; i < words.size(); ++i)
+			{
+				words[i].index = layout.index[i];
+				words[i].x = layout.position[i].X();
+				words[i].y = layout.position[i].Y();
+			}
+			height = layout.height;
+			longestWidth = layout.longestWidth;
+			return;
+		}
+	}
+
+	CachedLayout layout;
+	layout.key = std::move(key);
+	WrapText();
+	layout.text = text;
+	for(const Word &word : words)
+	{
+		layout.index.push_back(word.index);
+		layout.position.push_back(word.Pos());
+	}
+	layout.height = height;
+	layout.longestWidth = longestWidth;
+
+	lock_guard<mutex> lock(cacheMutex);
+	auto it = cacheIndex.find(keyHash);
+	if(it != cacheIndex.end())
+	{
+		// Some other string has the same hash. Replace it.
+		cache.erase(it->second);
+		cacheIndex.erase(it);
+	}
+	else if(cache.size() >= CACHE_SIZE)
+	{
+		cacheIndex.erase(cache.back().key.Hash());
+		cache.pop_back();
+	}
+	cache.push_front(std::move(layout));
+	cacheIndex[keyHash] = cache.begin();
+}
+
+
+
+void WrappedText::WrapText()
+{
+
 	// Do this as a finite state machine.
 	Word word;
 	bool hasWord = false;
@@ -90,6 +90,8 @@ public:
 private:
 	void SetText(const char *it, size_t length);
 	void Wrap();
+	// Wrap the text without checking whether its layout is already known.
+	void WrapText();
 	void AdjustLine(size_t &lineBegin, int &lineWidth, bool isEnd);
 	int Space(char c) const;
 
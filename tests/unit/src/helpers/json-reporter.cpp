@@ -0,0 +1,103 @@
+/* json-reporter.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+#include <cstdio>
+#include <string>
+
+
+
+namespace {
+	// Quote the given text as a JSON string.
+	std::string Quote(const std::string &text)
+	{
+		std::string result = "\"";
+		for(char c : text)
+		{
+			if(c == '"' || c == '\\')
+				result += '\\';
+			if(static_cast<unsigned char>(c) < ' ')
+			{
+				char escaped[8];
+				std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+				result += escaped;
+			}
+			else
+				result += c;
+		}
+		return result + '"';
+	}
+}
+
+
+
+// A reporter that writes the results of any benchmarks that are run as JSON, so
+// that they can be collected and compared over time. All times are given in
+// nanoseconds. Run it with: endless-sky-tests "[!benchmark]" -r json -o results.json
+class JsonReporter : public Catch::StreamingReporterBase<JsonReporter> {
+public:
+	using StreamingReporterBase::StreamingReporterBase;
+
+	static std::string getDescription()
+	{
+		return "Reports benchmark results as JSON, for tracking them over time";
+	}
+
+	void assertionStarting(const Catch::AssertionInfo &) override {}
+	bool assertionEnded(const Catch::AssertionStats &) override
+	{
+		return true;
+	}
+
+	void testRunStarting(const Catch::TestRunInfo &info) override
+	{
+		StreamingReporterBase::testRunStarting(info);
+		stream << "{\n\t\"benchmarks\": [";
+	}
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+	void benchmarkEnded(const Catch::BenchmarkStats<> &stats) override
+	{
+		stream << (isFirst ? "\n" : ",\n");
+		isFirst = false;
+		stream << "\t\t{\n"
+			<< "\t\t\t\"name\": " << Quote(stats.info.name) << ",\n"
+			<< "\t\t\t\"test case\": " << Quote(currentTestCaseInfo->name) << ",\n"
+			<< "\t\t\t\"samples\": " << stats.info.samples << ",\n"
+			<< "\t\t\t\"iterations\": " << stats.info.iterations << ",\n"
+			<< "\t\t\t\"mean\": " << stats.mean.point.count() << ",\n"
+			<< "\t\t\t\"mean low\": " << stats.mean.lower_bound.count() << ",\n"
+			<< "\t\t\t\"mean high\": " << stats.mean.upper_bound.count() << ",\n"
+			<< "\t\t\t\"standard deviation\": " << stats.standardDeviation.point.count() << "\n"
+			<< "\t\t}";
+	}
+#endif
+
+	void testRunEnded(const Catch::TestRunStats &stats) override
+	{
+		stream << (isFirst ? "],\n" : "\n\t],\n")
+			<< "\t\"assertions passed\": " << stats.totals.assertions.passed << ",\n"
+			<< "\t\"assertions failed\": " << stats.totals.assertions.failed << "\n"
+			<< "}\n";
+		StreamingReporterBase::testRunEnded(stats);
+	}
+
+
+private:
+	bool isFirst = true;
+};
+
+CATCH_REGISTER_REPORTER("json", JsonReporter)
@@ -0,0 +1,88 @@
+/* test_antiMissileGrid.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/AntiMissileGrid.h"
+
+// ... and any system includes needed for the test file.
+#include <cmath>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Find the ships that reach the point by checking every one of them.
+std::vector<unsigned> CheckAll(const std::vector<Point> &positions, const std::vector<double> &ranges,
+	const Point &point)
+{
+	std::vector<unsigned> result;
+	for(unsigned i = 0; i < positions.size(); ++i)
+		if(positions[i].Distance(point) <= ranges[i])
+			result.push_back(i);
+	return result;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding the anti-missile ships that can reach a missile", "[AntiMissileGrid]" ) {
+	GIVEN( "an empty grid" ) {
+		AntiMissileGrid grid;
+		grid.Build({}, {});
+		std::vector<unsigned> result = {7};
+		grid.Near(Point(), result);
+		THEN( "no ships are found" ) {
+			CHECK( result.empty() );
+		}
+	}
+	GIVEN( "ships scattered with different ranges" ) {
+		std::vector<Point> positions;
+		std::vector<double> ranges;
+		for(int i = 0; i < 200; ++i)
+		{
+			double angle = .9 * i;
+			double radius = 40. * i;
+			positions.emplace_back(radius * std::cos(angle), radius * std::sin(angle));
+			ranges.push_back(100. + (i % 7) * 60.);
+		}
+		AntiMissileGrid grid;
+		grid.Build(positions, ranges);
+		THEN( "the same ships are found as by checking each one, in the same order" ) {
+			std::vector<unsigned> result;
+			for(int x = -9000; x <= 9000; x += 450)
+				for(int y = -9000; y <= 9000; y += 450)
+				{
+					Point point(x, y);
+					grid.Near(point, result);
+					CHECK( result == CheckAll(positions, ranges, point) );
+				}
+		}
+		THEN( "a missile far away from them all is out of range" ) {
+			std::vector<unsigned> result;
+			grid.Near(Point(1e6, -1e6), result);
+			CHECK( result.empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,67 @@
+/* test_assetTiers.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/AssetTiers.h"
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Choosing the largest size of each category of image", "[AssetTiers]" ) {
+	using Category = AssetTiers::Category;
+
+	GIVEN( "sprite names" ) {
+		THEN( "they are sorted into categories by their directory" ) {
+			CHECK( AssetTiers::GetCategory("planet/earth") == Category::PLANET );
+			CHECK( AssetTiers::GetCategory("star/g0") == Category::PLANET );
+			CHECK( AssetTiers::GetCategory("_menu/haze-red") == Category::HAZE );
+			CHECK( AssetTiers::GetCategory("ship/bactrian") == Category::SHIP );
+			CHECK( AssetTiers::GetCategory("effect/explosion/huge") == Category::EFFECT );
+			CHECK( AssetTiers::GetCategory("thumbnail/bactrian") == Category::THUMBNAIL );
+			CHECK( AssetTiers::GetCategory("ui/radar") == Category::OTHER );
+		}
+	}
+	GIVEN( "a device with 2 GB of memory" ) {
+		AssetTiers::Init(1900, 16384);
+		THEN( "large images are limited" ) {
+			CHECK( AssetTiers::MaxSize(Category::PLANET) == 512 );
+			CHECK( AssetTiers::MaxSize(Category::EFFECT) == 256 );
+			CHECK( AssetTiers::MaxSize(Category::OTHER) == 16384 );
+		}
+	}
+	GIVEN( "a device with a lot of memory" ) {
+		WHEN( "it has a capable graphics processor" ) {
+			AssetTiers::Init(12000, 16384);
+			THEN( "images are only limited by what the driver supports" ) {
+				CHECK( AssetTiers::MaxSize(Category::PLANET) == 16384 );
+				CHECK( AssetTiers::MaxSize(Category::THUMBNAIL) == 16384 );
+			}
+		}
+		WHEN( "it has an older graphics processor" ) {
+			AssetTiers::Init(12000, 4096);
+			THEN( "it is given a lower tier" ) {
+				CHECK( AssetTiers::MaxSize(Category::SHIP) == 1024 );
+				CHECK( AssetTiers::MaxSize(Category::OTHER) == 4096 );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,139 @@
+/* test_bc7RGBA.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Bc7RGBA.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// A 16-byte BC7 block, built up one field at a time.
+class Block {
+public:
+	Block &Set(int start, int count, uint32_t value)
+	{
+		for(int i = 0; i < count; ++i)
+			if((value >> i) & 1)
+				bytes[(start + i) / 8] |= 1 << ((start + i) % 8);
+		return *this;
+	}
+
+	uint8_t bytes[16] = {};
+};
+
+std::vector<uint8_t> Join(const std::vector<Block> &blocks)
+{
+	std::vector<uint8_t> data;
+	for(const Block &block : blocks)
+		data.insert(data.end(), block.bytes, block.bytes + 16);
+	return data;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Reading the alpha of BC7 blocks", "[Bc7RGBA]" ) {
+	GIVEN( "blocks that store only color" ) {
+		const auto data = Join({Block().Set(0, 1, 1), Block().Set(3, 1, 1)});
+		const Bc7RGBA image(data.data(), 8, 4);
+		THEN( "they are opaque" ) {
+			CHECK( image.Alpha(0, 0, 0) == 255 );
+			CHECK( image.Alpha(0, 7, 3) == 255 );
+		}
+	}
+	GIVEN( "a block in the reserved mode" ) {
+		const auto data = Join({Block()});
+		const Bc7RGBA image(data.data(), 4, 4);
+		THEN( "it is transparent" ) {
+			CHECK( image.Alpha(0, 2, 2) == 0 );
+		}
+	}
+	GIVEN( "a mode 6 block" ) {
+		// The alpha endpoints are 255 and 0. Pixel 0 has a 3-bit index, and the
+		// rest have 4-bit indices.
+		Block block;
+		block.Set(6, 1, 1).Set(49, 7, 127).Set(56, 7, 0).Set(63, 1, 1).Set(64, 1, 0);
+		block.Set(68, 4, 15).Set(72, 4, 8);
+		const auto data = Join({block});
+		const Bc7RGBA image(data.data(), 4, 4);
+		THEN( "each pixel's alpha is interpolated between the endpoints" ) {
+			CHECK( image.Alpha(0, 0, 0) == 255 );
+			CHECK( image.Alpha(0, 1, 0) == 0 );
+			CHECK( image.Alpha(0, 2, 0) == 120 );
+			CHECK( image.Alpha(0, 3, 0) == 255 );
+		}
+	}
+	GIVEN( "a mode 5 block" ) {
+		Block block;
+		block.Set(5, 1, 1).Set(50, 8, 200).Set(58, 8, 100);
+		WHEN( "the alpha is not rotated" ) {
+			// Set the alpha index of pixel 5, which is the second pixel in the second row.
+			block.Set(106, 2, 3);
+			const auto data = Join({block});
+			const Bc7RGBA image(data.data(), 4, 4);
+			THEN( "it uses the alpha endpoints and indices" ) {
+				CHECK( image.Alpha(0, 0, 0) == 200 );
+				CHECK( image.Alpha(0, 1, 1) == 100 );
+			}
+		}
+		WHEN( "the alpha is swapped with red" ) {
+			// Red goes from 255 to 0, and pixel 1 uses the second red endpoint.
+			block.Set(6, 2, 1).Set(8, 7, 127).Set(67, 2, 3);
+			const auto data = Join({block});
+			const Bc7RGBA image(data.data(), 4, 4);
+			THEN( "it uses the red endpoints and the color indices" ) {
+				CHECK( image.Alpha(0, 0, 0) == 255 );
+				CHECK( image.Alpha(0, 1, 0) == 0 );
+			}
+		}
+	}
+	GIVEN( "a mode 7 block with two subsets" ) {
+		// In partition 0, the two right columns are in the second subset. The
+		// first subset is opaque and the second is transparent.
+		Block block;
+		block.Set(7, 1, 1).Set(74, 5, 31).Set(79, 5, 31).Set(94, 2, 3);
+		const auto data = Join({block});
+		const Bc7RGBA image(data.data(), 4, 4);
+		THEN( "each pixel uses the endpoints of its subset" ) {
+			CHECK( image.Alpha(0, 0, 0) == 255 );
+			CHECK( image.Alpha(0, 1, 3) == 255 );
+			CHECK( image.Alpha(0, 2, 0) == 0 );
+			CHECK( image.Alpha(0, 3, 3) == 0 );
+		}
+	}
+	GIVEN( "an image with several frames" ) {
+		const auto data = Join({Block(), Block(), Block().Set(0, 1, 1), Block()});
+		const Bc7RGBA image(data.data(), 8, 3);
+		THEN( "each frame's blocks are read" ) {
+			CHECK( image.Alpha(0, 0, 0) == 0 );
+			CHECK( image.Alpha(1, 0, 0) == 255 );
+			CHECK( image.Alpha(1, 4, 2) == 0 );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
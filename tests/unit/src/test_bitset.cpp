@@ -19,6 +19,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/Bitset.h"
 
 // ... and any system includes needed for the test file.
+#include <vector>
 
 namespace { // test namespace
 
@@ -100,6 +101,16 @@ SCENARIO( "A Bitset instance is being used", "[bitset]") {
 
 			CHECK( bitset.Any() );
 		}
+		THEN( "resetting single bits works" ) {
+			bitset.Set(4);
+			bitset.Set(5);
+			bitset.Reset(4);
+			CHECK_FALSE( bitset.Test(4) );
+			CHECK( bitset.Test(5) );
+
+			bitset.Reset(5);
+			CHECK( bitset.None() );
+		}
 		THEN( "clearing it works" ) {
 			bitset.Clear();
 			CHECK( bitset.Size() == 0 );
@@ -154,6 +165,97 @@ TEST_CASE( "Large bitsets", "[bitset]") {
 	CHECK( bitset.Any() );
 }
 
+TEST_CASE( "Counting and finding set bits", "[bitset]") {
+	int size = GENERATE(5, 64, 100, 150, 800, 3000);
+	auto increment = GENERATE(1, 7, 65);
+
+	Bitset bitset;
+	bitset.Resize(size);
+	CHECK( bitset.Count() == 0 );
+	CHECK( bitset.FindNext(0) == bitset.Size() );
+
+	std::vector<size_t> set;
+	for(int i = 0; i < size; i += increment)
+	{
+		bitset.Set(i);
+		set.push_back(i);
+	}
+	CHECK( bitset.Count() == set.size() );
+
+	std::vector<size_t> found;
+	for(size_t i = bitset.FindNext(0); i < bitset.Size(); i = bitset.FindNext(i + 1))
+		found.push_back(i);
+	CHECK( found == set );
+	CHECK( bitset.FindNext(bitset.Size()) == bitset.Size() );
+}
+
+SCENARIO( "Combining bitsets", "[bitset]" ) {
+	GIVEN( "a short and a long bitset" ) {
+		Bitset shortSet;
+		shortSet.Resize(10);
+		shortSet.Set(1);
+		shortSet.Set(2);
+
+		Bitset longSet;
+		longSet.Resize(300);
+		longSet.Set(2);
+		longSet.Set(3);
+		longSet.Set(200);
+
+		WHEN( "intersecting them" ) {
+			longSet.IntersectWith(shortSet);
+			THEN( "only the shared bits are left" ) {
+				CHECK( longSet.Count() == 1 );
+				CHECK( longSet.Test(2) );
+				CHECK_FALSE( longSet.Test(200) );
+			}
+		}
+		WHEN( "uniting them" ) {
+			longSet.UnionWith(shortSet);
+			THEN( "the bits of both are set" ) {
+				CHECK( longSet.Count() == 4 );
+				CHECK( longSet.Test(1) );
+				CHECK( longSet.Test(200) );
+			}
+		}
+		WHEN( "subtracting one from the other" ) {
+			longSet.Subtract(shortSet);
+			THEN( "the shared bits are reset" ) {
+				CHECK( longSet.Count() == 2 );
+				CHECK_FALSE( longSet.Test(2) );
+				CHECK( longSet.Test(3) );
+			}
+		}
+	}
+}
+
+SCENARIO( "Resizing a bitset keeps its bits", "[bitset]" ) {
+	GIVEN( "a short bitset" ) {
+		Bitset bitset;
+		bitset.Resize(10);
+		bitset.Set(5);
+		WHEN( "it grows past its inline storage and shrinks again" ) {
+			bitset.Resize(1000);
+			bitset.Set(900);
+			REQUIRE( bitset.Size() >= 1000 );
+			CHECK( bitset.Test(5) );
+			CHECK( bitset.Test(900) );
+			bitset.Resize(10);
+			THEN( "the bits that still fit are kept" ) {
+				CHECK( bitset.Test(5) );
+				CHECK( bitset.Count() == 1 );
+			}
+			AND_WHEN( "it grows again" ) {
+				bitset.Resize(1000);
+				THEN( "the bits that were cut off stay reset" ) {
+					CHECK_FALSE( bitset.Test(900) );
+					CHECK( bitset.Count() == 1 );
+				}
+			}
+		}
+	}
+}
+
 // Test code goes here. Preferably, use scenario-driven language making use of the SCENARIO, GIVEN,
 // WHEN, and THEN macros. (There will be cases where the more traditional TEST_CASE and SECTION macros
 // are better suited to declaration of the public API.)
@@ -0,0 +1,121 @@
+/* test_cargoHold.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/CargoHold.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// List the contents of a cargo hold in the order it reports them.
+std::vector<std::pair<std::string, int>> List(const CargoHold &cargo)
+{
+	std::vector<std::pair<std::string, int>> result;
+	for(const auto &it : cargo.Commodities())
+		result.emplace_back(it.first, it.second);
+	return result;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Moving commodities between cargo holds", "[CargoHold]" ) {
+	GIVEN( "a cargo hold with some commodities" ) {
+		CargoHold from;
+		from.Add("Food", 10);
+		from.Add("Metal", 5);
+		REQUIRE( from.CommoditiesSize() == 15 );
+		WHEN( "some are transferred to a smaller cargo hold" ) {
+			CargoHold to;
+			to.SetSize(12);
+			int moved = from.Transfer("Food", 10, to) + from.Transfer("Metal", 5, to);
+			THEN( "only as much as fits is moved" ) {
+				CHECK( moved == 12 );
+				CHECK( to.Get("Food") == 10 );
+				CHECK( to.Get("Metal") == 2 );
+				CHECK( to.CommoditiesSize() == 12 );
+				CHECK( from.Get("Food") == 0 );
+				CHECK( from.Get("Metal") == 3 );
+				CHECK( from.CommoditiesSize() == 3 );
+			}
+		}
+		WHEN( "more is removed than it holds" ) {
+			int removed = from.Remove("Metal", 8);
+			THEN( "only what it holds is removed" ) {
+				CHECK( removed == 5 );
+				CHECK( from.Get("Metal") == 0 );
+				CHECK( from.CommoditiesSize() == 10 );
+			}
+		}
+		WHEN( "everything is transferred to an unlimited cargo hold" ) {
+			CargoHold to;
+			from.TransferAll(to);
+			THEN( "nothing is left behind" ) {
+				CHECK( from.IsEmpty() );
+				CHECK( List(to) == (std::vector<std::pair<std::string, int>>{{"Food", 10}, {"Metal", 5}}) );
+			}
+		}
+	}
+	GIVEN( "an empty cargo hold" ) {
+		CargoHold cargo;
+		THEN( "it lists no commodities" ) {
+			CHECK( List(cargo).empty() );
+			CHECK( cargo.Get("Food") == 0 );
+			CHECK( cargo.GetCommodity(3) == 0 );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark CargoHold::TransferAll", "[!benchmark][CargoHold]" ) {
+	const std::vector<std::string> names = {"Clothing", "Electronics", "Equipment", "Food",
+		"Heavy Metals", "Industrial", "Luxury Goods", "Medical", "Metal", "Plastic"};
+	// Distribute a pooled cargo hold among a 100-ship fleet and pool it again,
+	// much like taking off from and landing on a planet.
+	BENCHMARK_ADVANCED( "100 ships" )(Catch::Benchmark::Chronometer meter) {
+		CargoHold pool;
+		for(const std::string &name : names)
+			pool.Add(name, 500);
+		std::vector<CargoHold> fleet(100);
+		for(CargoHold &ship : fleet)
+			ship.SetSize(50);
+		meter.measure([&pool, &fleet] {
+			for(CargoHold &ship : fleet)
+				pool.TransferAll(ship);
+			for(CargoHold &ship : fleet)
+				ship.TransferAll(pool);
+			return pool.CommoditiesSize();
+		});
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
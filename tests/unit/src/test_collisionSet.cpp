@@ -0,0 +1,205 @@
+/* test_collisionSet.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/CollisionSet.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Body.h"
+#include "../../../source/Point.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Bodies without a sprite act as single points.
+std::vector<Body> MakeBodies(const std::vector<Point> &positions)
+{
+	std::vector<Body> bodies;
+	for(const Point &position : positions)
+		bodies.emplace_back(nullptr, position);
+	return bodies;
+}
+
+void Fill(CollisionSet &set, std::vector<Body> &bodies)
+{
+	set.Clear(0);
+	for(Body &body : bodies)
+		set.Add(body);
+	set.Finish();
+}
+
+std::vector<Body *> Sorted(std::vector<Body *> found)
+{
+	std::sort(found.begin(), found.end());
+	return found;
+}
+
+// Find the objects within the given range of a point by checking every one.
+std::vector<Body *> InRange(std::vector<Body> &bodies, const Point &center, double radius)
+{
+	std::vector<Body *> found;
+	for(Body &body : bodies)
+		if(body.Position().Distance(center) <= radius)
+			found.push_back(&body);
+	return found;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding objects near a point", "[CollisionSet]" ) {
+	GIVEN( "a collision set with several objects in the same cell" ) {
+		// The grid has at most 32 cells of 256 units each, so it wraps every 8192
+		// units or less.
+		CollisionSet set(256, 32);
+		auto bodies = MakeBodies({
+			Point(10., 0.), Point(20., 0.), Point(30., 0.), Point(40., 0.), Point(50., 0.),
+			Point(60., 0.), Point(70., 0.), Point(80., 0.), Point(90., 0.),
+			Point(200., 200.), Point(50. + 8192., 0.)});
+		Fill(set, bodies);
+
+		WHEN( "querying a circle" ) {
+			const std::vector<Body *> found = Sorted(set.Circle(Point(), 55.));
+			THEN( "only the objects in range are found" ) {
+				std::vector<Body *> expected;
+				for(int i = 0; i < 5; ++i)
+					expected.push_back(&bodies[i]);
+				CHECK( found == Sorted(expected) );
+			}
+		}
+		WHEN( "querying a ring" ) {
+			const std::vector<Body *> found = Sorted(set.Ring(Point(), 35., 75.));
+			THEN( "objects inside the ring are not found" ) {
+				std::vector<Body *> expected;
+				for(int i = 3; i < 7; ++i)
+					expected.push_back(&bodies[i]);
+				CHECK( found == Sorted(expected) );
+			}
+		}
+		WHEN( "querying a circle that spans several cells" ) {
+			const std::vector<Body *> found = Sorted(set.Circle(Point(100., 100.), 200.));
+			THEN( "each object is found only once" ) {
+				std::vector<Body *> expected;
+				for(int i = 0; i < 10; ++i)
+					expected.push_back(&bodies[i]);
+				CHECK( found == Sorted(expected) );
+			}
+		}
+		WHEN( "querying many circles at once" ) {
+			const std::vector<Point> centers = {Point(), Point(200., 200.), Point(8192., 0.), Point(-500., 0.)};
+			std::vector<std::vector<Body *>> results;
+			set.Circles(centers, 60., results);
+			REQUIRE( results.size() == centers.size() );
+			THEN( "each result matches a single query" ) {
+				for(size_t i = 0; i < centers.size(); ++i)
+					CHECK( Sorted(results[i]) == Sorted(set.Circle(centers[i], 60.)) );
+				CHECK( results[1] == std::vector<Body *>{&bodies[9]} );
+				CHECK( results[2] == std::vector<Body *>{&bodies[10]} );
+				CHECK( results[3].empty() );
+			}
+		}
+	}
+}
+
+SCENARIO( "Updating a collision set as objects move", "[CollisionSet]" ) {
+	GIVEN( "a collision set with objects spread over several cells" ) {
+		CollisionSet set(256, 32);
+		std::vector<Point> positions;
+		for(int i = 0; i < 200; ++i)
+			positions.emplace_back(std::fmod(i * 1234.567, 4000.) - 2000., std::fmod(i * 2345.678, 4000.) - 2000.);
+		auto bodies = MakeBodies(positions);
+		Fill(set, bodies);
+		const std::vector<Point> centers = {Point(), Point(-1500., 700.), Point(1900., -1900.), Point(300., 1200.)};
+
+		WHEN( "the same objects move, some of them into other cells" ) {
+			for(size_t i = 0; i < bodies.size(); ++i)
+				bodies[i] = Body(nullptr, positions[i] + Point(i % 3 ? 10. : 300., i % 5 ? -5. : -700.));
+			Fill(set, bodies);
+			THEN( "every object is found where it is now" ) {
+				for(const Point &center : centers)
+					CHECK( Sorted(set.Circle(center, 400.)) == Sorted(InRange(bodies, center, 400.)) );
+				CHECK( set.All().size() == bodies.size() );
+			}
+		}
+		WHEN( "the objects move several times" ) {
+			for(int step = 1; step <= 5; ++step)
+			{
+				for(size_t i = 0; i < bodies.size(); ++i)
+					bodies[i] = Body(nullptr, positions[i] + Point(step * 100., step * -130.));
+				Fill(set, bodies);
+			}
+			THEN( "every object is found where it is now" ) {
+				for(const Point &center : centers)
+					CHECK( Sorted(set.Circle(center, 400.)) == Sorted(InRange(bodies, center, 400.)) );
+			}
+		}
+		WHEN( "different objects are added" ) {
+			auto fewer = MakeBodies(std::vector<Point>(positions.begin(), positions.begin() + 20));
+			Fill(set, fewer);
+			THEN( "only those objects are found" ) {
+				for(const Point &center : centers)
+					CHECK( Sorted(set.Circle(center, 1000.)) == Sorted(InRange(fewer, center, 1000.)) );
+				CHECK( set.All().size() == fewer.size() );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark CollisionSet queries", "[!benchmark][CollisionSet]" ) {
+	// Scatter the objects evenly over a 4000 by 4000 area, as in a busy system.
+	for(int count : {100, 1000, 10000})
+	{
+		std::vector<Point> positions;
+		for(int i = 0; i < count; ++i)
+			positions.emplace_back(std::fmod(i * 1234.567, 4000.) - 2000., std::fmod(i * 2345.678, 4000.) - 2000.);
+		auto bodies = MakeBodies(positions);
+		CollisionSet set(256, 32);
+		Fill(set, bodies);
+		const std::string objects = ", " + std::to_string(count) + " objects";
+
+		BENCHMARK( "CollisionSet::Finish()" + objects ) {
+			Fill(set, bodies);
+			return set.All().size();
+		};
+		BENCHMARK( "CollisionSet::Circle()" + objects, i ) {
+			return set.Circle(positions[i % count], 500.).size();
+		};
+		BENCHMARK( "CollisionSet::Ring()" + objects, i ) {
+			return set.Ring(positions[i % count], 400., 600.).size();
+		};
+		BENCHMARK( "CollisionSet::Line()" + objects, i ) {
+			return set.Line(positions[i % count], positions[(i + 1) % count]);
+		};
+	}
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
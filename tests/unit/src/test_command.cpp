@@ -0,0 +1,57 @@
+/* test_command.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Command.h"
+
+namespace { // test namespace
+
+// #region mock data
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Handing commands between threads", "[Command][Buffer]" ) {
+	GIVEN( "an empty buffer" ) {
+		Command::Buffer buffer;
+		REQUIRE_FALSE( buffer.Take() );
+		WHEN( "commands are added more than once before being taken" ) {
+			Command turn;
+			turn.SetTurn(-.5);
+			buffer.Add(Command::FORWARD);
+			buffer.Add(Command::PRIMARY | turn);
+			buffer.Add(Command::LAND);
+			THEN( "they are all taken together, with the latest turn" ) {
+				Command taken = buffer.Take();
+				CHECK( taken.Has(Command::FORWARD) );
+				CHECK( taken.Has(Command::PRIMARY) );
+				CHECK( taken.Has(Command::LAND) );
+				CHECK( taken.Turn() == -.5 );
+				AND_THEN( "nothing is left to take" ) {
+					CHECK_FALSE( buffer.Take() );
+				}
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,98 @@
+/* test_compression.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Compression.h"
+
+#include "../../../source/DataFile.h"
+#include "../../../source/DataNode.h"
+
+// ... and any system includes needed for the test file.
+#include <sstream>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+const std::string SAVE = "pilot Test Pilot\ndate 16 11 3013\nsystem Rutilicus\nplanet \"New Boston\"\n"
+	"account\n\tcredits 131000\n\tscore 400\n";
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Compressing data", "[Compression]" ) {
+	GIVEN( "plain text" ) {
+		THEN( "it is not recognized as compressed" ) {
+			CHECK_FALSE( Compression::IsCompressed(SAVE) );
+			CHECK_FALSE( Compression::IsCompressed("") );
+		}
+		WHEN( "it is compressed" ) {
+			std::string compressed = Compression::Compress(SAVE);
+			THEN( "it is recognized as compressed" ) {
+				CHECK( Compression::IsCompressed(compressed) );
+			}
+			THEN( "decompressing it gives back the text" ) {
+				CHECK( Compression::Decompress(compressed) == SAVE );
+			}
+		}
+	}
+	GIVEN( "a large amount of repetitive text" ) {
+		std::string text;
+		for(int i = 0; i < 20000; ++i)
+			text += "outfit \"Energy Blaster\" " + std::to_string(i % 7) + '\n';
+		std::string compressed = Compression::Compress(text);
+		THEN( "it is made much smaller, and survives the round trip" ) {
+			CHECK( compressed.size() * 10 < text.size() );
+			CHECK( Compression::Decompress(compressed) == text );
+		}
+	}
+	GIVEN( "compressed data that was cut short" ) {
+		std::string compressed = Compression::Compress(SAVE);
+		compressed.resize(compressed.size() / 2);
+		THEN( "decompressing it does not give the full text" ) {
+			CHECK( Compression::Decompress(compressed) != SAVE );
+		}
+	}
+}
+
+SCENARIO( "Loading compressed data files", "[Compression][DataFile]" ) {
+	GIVEN( "a compressed saved game" ) {
+		std::istringstream in(Compression::Compress(SAVE));
+		DataFile file(in);
+		THEN( "it is read the same as the plain text would be" ) {
+			auto it = file.begin();
+			REQUIRE( it != file.end() );
+			CHECK( it->Token(0) == "pilot" );
+			CHECK( it->Token(1) == "Test" );
+			int count = 0;
+			for(const DataNode &node : file)
+			{
+				static_cast<void>(node);
+				++count;
+			}
+			CHECK( count == 5 );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
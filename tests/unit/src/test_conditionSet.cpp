@@ -131,6 +131,23 @@ SCENARIO( "Determining if condition requirements are met", "[ConditionSet][Usage
 			}
 		}
 	}
+	GIVEN( "a set that is tested repeatedly against a changing list of Conditions" ) {
+		const auto set = ConditionSet{AsDataNode("and\n\t( year - 3000 ) * 2 >= duration\n\tnot \"paused\"")};
+		auto store = ConditionsStore {
+			{"year", 3010},
+		};
+		THEN( "each test sees the current values" ) {
+			REQUIRE( set.Test(store) );
+			store.Set("duration", 21);
+			REQUIRE_FALSE( set.Test(store) );
+			store.Set("year", 3011);
+			REQUIRE( set.Test(store) );
+			store.Set("paused", 1);
+			REQUIRE_FALSE( set.Test(store) );
+			store.Erase("paused");
+			REQUIRE( set.Test(store) );
+		}
+	}
 }
 
 SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
@@ -181,6 +198,51 @@ SCENARIO( "Applying changes to conditions", "[ConditionSet][Usage]" ) {
 		}
 	}
 }
+
+SCENARIO( "Reusing the result of an unchanged test", "[ConditionSet][Caching]" ) {
+	GIVEN( "a set with nested groups, tested repeatedly" ) {
+		const auto set = ConditionSet{AsDataNode("and\n\tyear > 3010\n\tor\n\t\thas paused\n\t\tdays - 2 >= 0")};
+		auto store = ConditionsStore {
+			{"year", 3011},
+		};
+		REQUIRE_FALSE( set.Test(store) );
+		REQUIRE_FALSE( set.Test(store) );
+		THEN( "changes through any of the store's interfaces are seen" ) {
+			store["days"] = 2;
+			REQUIRE( set.Test(store) );
+			store["days"] -= 1;
+			REQUIRE_FALSE( set.Test(store) );
+			store.Add("paused", 1);
+			REQUIRE( set.Test(store) );
+			store.Erase("paused");
+			REQUIRE_FALSE( set.Test(store) );
+			store.Set("days", 5);
+			REQUIRE( set.Test(store) );
+			store.Set("year", 3000);
+			REQUIRE_FALSE( set.Test(store) );
+		}
+		THEN( "a different store with the same values gives the same result" ) {
+			const auto other = ConditionsStore {
+				{"year", 3011},
+				{"paused", 1},
+			};
+			REQUIRE( set.Test(other) );
+			REQUIRE_FALSE( set.Test(store) );
+		}
+	}
+	GIVEN( "a set that reads a derived condition" ) {
+		const auto set = ConditionSet{AsDataNode("and\n\t\"ships: Shuttle\" > 1")};
+		auto store = ConditionsStore{};
+		int64_t ships = 0;
+		auto &&provider = store.GetProviderPrefixed("ships: ");
+		provider.SetGetFunction([&ships](const std::string &) { return ships; });
+		THEN( "changes made outside the store are seen" ) {
+			REQUIRE_FALSE( set.Test(store) );
+			ships = 2;
+			REQUIRE( set.Test(store) );
+		}
+	}
+}
 // #endregion unit tests
 
 
@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // ... and any system includes needed for the test file.
 #include <map>
 #include <string>
+#include <vector>
 
 
 
@@ -662,9 +663,173 @@ SCENARIO( "Providing multiple derived conditions", "[ConditionStore][DerivedMult
 	}
 }
 
+SCENARIO( "Looking up conditions by interned ID", "[ConditionStore][ConditionIds]" )
+{
+	GIVEN( "Two interned condition names" )
+	{
+		const size_t first = ConditionsStore::Intern("first");
+		const size_t ship = ConditionsStore::Intern("ships: A");
+		THEN( "interning a name again gives the same ID" )
+		{
+			CHECK( ConditionsStore::Intern("first") == first );
+			CHECK( ConditionsStore::Intern("ships: A") == ship );
+			CHECK( first != ship );
+		}
+		AND_GIVEN( "a store that does not contain them" )
+		{
+			auto store = ConditionsStore();
+			REQUIRE_FALSE( store.HasGet(first, "first").first );
+			WHEN( "the condition is set, changed and erased after the first lookup" )
+			{
+				store.Set("first", 4);
+				CHECK( store.HasGet(first, "first") == std::make_pair(true, int64_t(4)) );
+				store["first"] += 3;
+				CHECK( store.HasGet(first, "first") == std::make_pair(true, int64_t(7)) );
+				store.Erase("first");
+				CHECK_FALSE( store.HasGet(first, "first").first );
+			}
+			WHEN( "a provider is added after the first lookup" )
+			{
+				REQUIRE_FALSE( store.HasGet(ship, "ships: A").first );
+				auto mockProvPrefixShips = MockConditionsProvider();
+				mockProvPrefixShips.SetRWPrefixProvider(store, "ships: ");
+				REQUIRE( store.Set("ships: A", 12) );
+				THEN( "the ID resolves through the provider" )
+				{
+					CHECK( store.HasGet(ship, "ships: A") == std::make_pair(true, int64_t(12)) );
+					CHECK( store.HasGet(ship, "ships: A") == store.HasGet("ships: A") );
+				}
+			}
+			WHEN( "the versions of the conditions are tracked" )
+			{
+				uint64_t missing = 1;
+				REQUIRE( store.Version(first, "first", missing) );
+				CHECK( missing == 0 );
+				store.Set("first", 1);
+				uint64_t set = 0;
+				REQUIRE( store.Version(first, "first", set) );
+				CHECK( set != missing );
+				store.Set("first", 1);
+				uint64_t unchanged = 0;
+				REQUIRE( store.Version(first, "first", unchanged) );
+				CHECK( unchanged == set );
+				++store["first"];
+				uint64_t incremented = 0;
+				REQUIRE( store.Version(first, "first", incremented) );
+				CHECK( incremented != set );
+				auto mockProvPrefixShips = MockConditionsProvider();
+				mockProvPrefixShips.SetRWPrefixProvider(store, "ships: ");
+				uint64_t derived = 0;
+				CHECK_FALSE( store.Version(ship, "ships: A", derived) );
+			}
+			WHEN( "the store is copied after a lookup" )
+			{
+				store.Set("first", 2);
+				REQUIRE( store.HasGet(first, "first").second == 2 );
+				auto copy = store;
+				store.Set("first", 5);
+				THEN( "each store reads its own value" )
+				{
+					CHECK( copy.HasGet(first, "first").second == 2 );
+					CHECK( store.HasGet(first, "first").second == 5 );
+				}
+			}
+		}
+	}
+}
+
+SCENARIO( "Resolving conditions among many prefixed providers", "[ConditionStore][DerivedPrefixes]" )
+{
+	GIVEN( "A conditionsStore with prefixed providers that share leading characters" )
+	{
+		auto store = ConditionsStore();
+		auto mockOutfit = MockConditionsProvider();
+		auto mockOutfits = MockConditionsProvider();
+		auto mockReputation = MockConditionsProvider();
+		auto mockShip = MockConditionsProvider();
+		mockOutfits.SetRWPrefixProvider(store, "outfits: ");
+		mockOutfit.SetRWPrefixProvider(store, "outfit: ");
+		mockReputation.SetRWPrefixProvider(store, "reputation: ");
+		mockShip.SetRWNamedProvider(store, "outfit");
+		store.Set("outfit count", 3);
+		WHEN( "conditions are set through each of them" )
+		{
+			REQUIRE( store.Set("outfit: Laser", 2) );
+			REQUIRE( store.Set("outfits: Laser", 5) );
+			REQUIRE( store.Set("reputation: Republic", -7) );
+			REQUIRE( store.Set("outfit", 9) );
+			THEN( "each provider receives only its own conditions" )
+			{
+				CHECK( mockOutfit.values.size() == 1 );
+				CHECK( mockOutfits.values.size() == 1 );
+				CHECK( mockReputation.values.size() == 1 );
+				CHECK( mockShip.values.size() == 1 );
+				CHECK( store.Get("outfit: Laser") == 2 );
+				CHECK( store.Get("outfits: Laser") == 5 );
+				CHECK( store.Get("reputation: Republic") == -7 );
+				CHECK( store.Get("outfit") == 9 );
+			}
+			THEN( "names that only share part of a prefix are primary conditions" )
+			{
+				CHECK( store.Get("outfit count") == 3 );
+				CHECK_FALSE( store.Has("outfit:") );
+				CHECK_FALSE( store.Has("reputation") );
+				CHECK( store.PrimariesSize() == 1 );
+			}
+		}
+		WHEN( "a provider is added within the range of one of them" )
+		{
+			auto mockNested = MockConditionsProvider();
+			CHECK_THROWS( mockNested.SetRWNamedProvider(store, "reputation: Pirate") );
+			CHECK_THROWS( mockNested.SetRWPrefixProvider(store, "outfits: Large ") );
+		}
+	}
+}
+
 
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark ConditionsStore lookups", "[!benchmark][conditionsStore]" ) {
+	const char *PREFIXES[] = {"ships: ", "outfit: ", "reputation: ", "flagship model: ", "visited planet: "};
+	for(int size : {100, 10000, 100000})
+	{
+		auto store = ConditionsStore();
+		std::vector<MockConditionsProvider> providers(5);
+		for(int i = 0; i < 5; ++i)
+			providers[i].SetRWPrefixProvider(store, PREFIXES[i]);
+
+		std::vector<std::string> primaries;
+		std::vector<std::string> derived;
+		for(int i = 0; i < size; ++i)
+		{
+			primaries.emplace_back("event: condition " + std::to_string(i));
+			store.Set(primaries.back(), i);
+			derived.emplace_back(PREFIXES[i % 5] + std::to_string(i));
+			store.Set(derived.back(), i);
+		}
+
+		BENCHMARK( "ConditionsStore::Get() primary, " + std::to_string(size) + " conditions", i ) {
+			return store.Get(primaries[i % size]);
+		};
+		BENCHMARK( "ConditionsStore::Get() derived, " + std::to_string(size) + " conditions", i ) {
+			return store.Get(derived[i % size]);
+		};
+		BENCHMARK( "ConditionsStore::Has() missing, " + std::to_string(size) + " conditions", i ) {
+			return store.Has(primaries[i % size] + "?");
+		};
+		BENCHMARK( "ConditionsStore::Set() primary, " + std::to_string(size) + " conditions", i ) {
+			return store.Set(primaries[i % size], i);
+		};
+		BENCHMARK( "ConditionsStore::Set() derived, " + std::to_string(size) + " conditions", i ) {
+			return store.Set(derived[i % size], i);
+		};
+	}
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
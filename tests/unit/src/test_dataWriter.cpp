@@ -0,0 +1,121 @@
+/* test_dataWriter.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// Include only the tested class's header.
+#include "../../../source/DataWriter.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Format the given value the way DataWriter always has: with a stream with a
+// precision of 8.
+template <class T>
+std::string StreamFormat(const T &value)
+{
+	std::ostringstream out;
+	out.precision(8);
+	out << value << '\n';
+	return out.str();
+}
+
+template <class T>
+std::string WriterFormat(const T &value)
+{
+	DataWriter writer;
+	writer.Write(value);
+	return writer.Contents();
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Writing numbers with a DataWriter", "[DataWriter]" ) {
+	GIVEN( "integers" ) {
+		THEN( "they are written the same as with a stream" ) {
+			for(int value : {0, 1, -1, 42, -1000, std::numeric_limits<int>::max(), std::numeric_limits<int>::min()})
+				CHECK( WriterFormat(value) == StreamFormat(value) );
+			const int64_t smallest = std::numeric_limits<int64_t>::min();
+			CHECK( WriterFormat(smallest) == StreamFormat(smallest) );
+			const uint64_t largest = std::numeric_limits<uint64_t>::max();
+			CHECK( WriterFormat(largest) == StreamFormat(largest) );
+			CHECK( WriterFormat(static_cast<short>(-7)) == StreamFormat(static_cast<short>(-7)) );
+			CHECK( WriterFormat(true) == StreamFormat(true) );
+			CHECK( WriterFormat(size_t(12345)) == StreamFormat(size_t(12345)) );
+		}
+	}
+	GIVEN( "floating-point numbers" ) {
+		THEN( "they are written the same as with a stream" ) {
+			for(double value : {0., -0., 1., -1., .5, 1. / 3., 100., 99999999., 100000000., 123456789., -2.5e-7,
+					1e300, 3.14159265358979, std::numeric_limits<double>::infinity()})
+				CHECK( WriterFormat(value) == StreamFormat(value) );
+			CHECK( WriterFormat(.1f) == StreamFormat(.1f) );
+			CHECK( WriterFormat(1234.5f) == StreamFormat(1234.5f) );
+		}
+		THEN( "random values are written the same as with a stream" ) {
+			std::mt19937_64 random(1);
+			std::uniform_real_distribution<double> fraction(-1000., 1000.);
+			std::uniform_int_distribution<int> whole(-200000000, 200000000);
+			for(int i = 0; i < 1000; ++i)
+			{
+				double value = fraction(random);
+				REQUIRE( WriterFormat(value) == StreamFormat(value) );
+				double integer = whole(random);
+				REQUIRE( WriterFormat(integer) == StreamFormat(integer) );
+			}
+		}
+	}
+}
+
+SCENARIO( "Writing strings with a DataWriter", "[DataWriter]" ) {
+	DataWriter writer;
+	GIVEN( "tokens with and without spaces and quotes" ) {
+		writer.Write("plain", "has space", "has\ttab", "has \"quote\"", std::string("string"), "");
+		THEN( "only the ones that need quoting are quoted" ) {
+			CHECK( writer.Contents() == "plain \"has space\" \"has\ttab\" `has \"quote\"` string \n" );
+		}
+	}
+	GIVEN( "a node with children" ) {
+		writer.Write(AsDataNode("parent 1\n\tchild \"two words\"\n\t\tgrandchild\n"));
+		THEN( "it is written with its children indented" ) {
+			CHECK( writer.Contents() == "parent 1\n\tchild \"two words\"\n\t\tgrandchild\n" );
+		}
+	}
+	GIVEN( "a token that is not ASCII" ) {
+		writer.Write("caf\xc3\xa9");
+		THEN( "it is not quoted" ) {
+			CHECK( writer.Contents() == "caf\xc3\xa9\n" );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -25,6 +25,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 // ... and any system includes needed for the test file.
 #include <algorithm>
+#include <fstream>
 #include <iterator>
 #include <set>
 #include <sstream>
@@ -53,6 +54,22 @@ std::vector<std::string> Split(const std::string &str)
 	return result;
 }
 
+// The ship definitions from the game data, if they can be found. Otherwise, a
+// generated file of a similar size and shape.
+std::string ShipData()
+{
+	std::ifstream in("../data/human/ships.txt");
+	std::ostringstream out;
+	if(in)
+		out << in.rdbuf();
+	else
+		for(int i = 0; i < 500; ++i)
+			out << "ship \"Ship " << i << "\"\n\tattributes\n\t\t\"cost\" " << 1000 * i
+				<< "\n\t\t\"hull\" " << 10.5 * i << "\n\t\t\"drag\" 2.1\n\t\t\"heat dissipation\" .75\n"
+				<< "\tengine -10 " << i << "\n\tgun 8.5 -" << i << " \"Laser\"\n";
+	return out.str();
+}
+
 // #endregion mock data
 
 
@@ -100,6 +117,14 @@ node2 hi
 						REQUIRE(grand.Token(1) == "child");
 					}
 		}
+		AND_THEN( "each node allocates exactly as much space as its tokens need" ) {
+			for(const auto &parent : root)
+			{
+				CHECK( parent.Tokens().capacity() == parent.Tokens().size() );
+				for(const auto &child : parent)
+					CHECK( child.Tokens().capacity() == child.Tokens().size() );
+			}
+		}
 	}
 }
 
@@ -288,8 +313,105 @@ now with
 		}
 	}
 }
+
+SCENARIO( "Serializing a DataFile", "[DataFile]" ) {
+	OutputSink sink(std::cerr);
+
+	GIVEN( "A DataFile with nested and repeated tokens" ) {
+		std::istringstream stream(R"(
+ship "Bulk Freighter"
+	attributes
+		"cost" 1000
+		"hull" 1000
+	""
+
+ship Sparrow
+	attributes
+		cost 12
+
+# comment
+effect `"odd" name`
+)");
+		const DataFile original(stream);
+		const std::string data = original.Serialize();
+
+		WHEN( "it is deserialized" ) {
+			DataFile copy;
+			REQUIRE( copy.Deserialize(data) );
+
+			THEN( "it is identical to the original" ) {
+				CHECK( copy.Serialize() == data );
+				REQUIRE( std::distance(copy.begin(), copy.end()) == 3 );
+				const DataNode &ship = *copy.begin();
+				CHECK( ship.Tokens() == std::vector<std::string>{"ship", "Bulk Freighter"} );
+				REQUIRE( std::distance(ship.begin(), ship.end()) == 2 );
+				CHECK( std::next(ship.begin())->Token(0).empty() );
+				const DataNode &cost = *ship.begin()->begin();
+				CHECK( cost.Value(1) == 1000. );
+				CHECK( std::prev(copy.end())->Token(1) == "\"odd\" name" );
+			}
+			THEN( "its nodes print the same traces" ) {
+				original.begin()->begin()->begin()->PrintTrace();
+				const std::string expected = sink.Flush();
+				copy.begin()->begin()->begin()->PrintTrace();
+				CHECK( sink.Flush() == expected );
+				CHECK( expected.find("L4:       cost 1000") != std::string::npos );
+			}
+		}
+		WHEN( "damaged data is deserialized" ) {
+			DataFile copy;
+			THEN( "it is rejected, and the file is left empty" ) {
+				CHECK_FALSE( copy.Deserialize(data.substr(0, data.size() - 1)) );
+				CHECK( copy.begin() == copy.end() );
+				CHECK_FALSE( copy.Deserialize(data + "x") );
+				CHECK_FALSE( copy.Deserialize("") );
+			}
+		}
+	}
+}
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark DataFile loading and values", "[!benchmark][DataFile]" ) {
+	const std::string data = ShipData();
+	BENCHMARK( "Load the ship definitions" ) {
+		std::istringstream stream(data);
+		return DataFile(stream);
+	};
+
+	std::istringstream stream(data);
+	const DataFile file(stream);
+	std::vector<std::pair<const DataNode *, int>> numbers;
+	std::vector<const DataNode *> stack;
+	for(const DataNode &node : file)
+		stack.push_back(&node);
+	while(!stack.empty())
+	{
+		const DataNode *node = stack.back();
+		stack.pop_back();
+		for(int i = 0; i < node->Size(); ++i)
+			if(node->IsNumber(i))
+				numbers.emplace_back(node, i);
+		for(const DataNode &child : *node)
+			stack.push_back(&child);
+	}
+	BENCHMARK( "DataNode::Value(index) on every number" ) {
+		double sum = 0.;
+		for(const auto &it : numbers)
+			sum += it.first->Value(it.second);
+		return sum;
+	};
+	BENCHMARK( "DataNode::Value(token) on every number" ) {
+		double sum = 0.;
+		for(const auto &it : numbers)
+			sum += DataNode::Value(it.first->Token(it.second));
+		return sum;
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
@@ -50,7 +50,7 @@ TEST_CASE( "DataNode Basics", "[DataNode]" ) {
 	SECTION( "Construction Traits" ) {
 		CHECK( std::is_default_constructible<T>::value );
 		CHECK_FALSE( std::is_trivially_default_constructible<T>::value );
-		// We explicitly allocate some memory when default-constructing DataNodes.
+		// Default-constructing a DataNode is not declared noexcept.
 		CHECK_FALSE( std::is_nothrow_default_constructible<T>::value );
 		CHECK( std::is_copy_constructible<T>::value );
 		// We have work to do when copy-constructing, including allocations.
@@ -85,8 +85,8 @@ SCENARIO( "Creating a DataNode", "[DataNode]") {
 			CHECK_FALSE( root.HasChildren() );
 			CHECK( root.Tokens().empty() );
 		}
-		THEN( "it preallocates capacity for tokens" ) {
-			CHECK( root.Tokens().capacity() == 4 );
+		THEN( "it does not allocate any capacity for tokens" ) {
+			CHECK( root.Tokens().capacity() == 0 );
 		}
 	}
 	GIVEN( "When created without a parent" ) {
@@ -246,6 +246,35 @@ SCENARIO( "Determining if a token is numeric", "[IsNumber][Parsing][DataNode]" )
 	}
 }
 
+SCENARIO( "Reading the values of a loaded DataNode", "[Value][Parsing][DataNode]" ) {
+	GIVEN( "A DataNode loaded from a file" ) {
+		const DataNode node = AsDataNode("node 1 -2.5 +3e2 1e-2 . word \"12 monkeys\" \"\" 4");
+		REQUIRE( node.Size() == 10 );
+		THEN( "numbers are recognized as when checking each token" ) {
+			for(int i = 0; i < node.Size(); ++i)
+			{
+				CAPTURE( node.Token(i) );
+				CHECK( node.IsNumber(i) == (!node.Token(i).empty() && DataNode::IsNumber(node.Token(i))) );
+			}
+		}
+		THEN( "their values are the same as when parsing each token" ) {
+			for(int i = 1; i < node.Size(); ++i)
+				if(node.IsNumber(i))
+				{
+					CAPTURE( node.Token(i) );
+					CHECK( node.Value(i) == DataNode::Value(node.Token(i)) );
+				}
+			CHECK( node.Value(2) == -2.5 );
+			CHECK( node.Value(3) == 300. );
+		}
+		THEN( "copies of it have the same values" ) {
+			const DataNode copy = node;
+			CHECK( copy.Value(9) == 4. );
+			CHECK_FALSE( copy.IsNumber(6) );
+		}
+	}
+}
+
 SCENARIO( "Determining if a token is a boolean", "[Boolean][Parsing][DataNode]" ) {
 	GIVEN( "A string that is \"true\"/\"1\" or \"false\"/\"0\"" ) {
 		THEN( "IsBool returns true" ) {
@@ -0,0 +1,71 @@
+/* test_depreciation.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Depreciation.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Outfit.h"
+
+namespace { // test namespace
+
+// #region mock data
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Remembered depreciation values follow the records", "[Depreciation]" ) {
+	GIVEN( "a fleet record with one outfit bought on day 0" ) {
+		Outfit outfit;
+		outfit.Load(AsDataNode("outfit \"Test Outfit\"\n\tcost 1000\n"));
+		Depreciation fleet;
+		fleet.Load(AsDataNode("\"fleet depreciation\"\n"));
+		fleet.Buy(&outfit, 0);
+		THEN( "its value depends on the day it is asked for" ) {
+			CHECK( fleet.Value(&outfit, 5) == 1000 );
+			CHECK( fleet.Value(&outfit, 2000) == 250 );
+			CHECK( fleet.Value(&outfit, 5) == 1000 );
+			CHECK( fleet.Value(&outfit, 5, 2) == 1250 );
+		}
+		WHEN( "another one is bought after its value was asked for" ) {
+			REQUIRE( fleet.Value(&outfit, 5, 2) == 1250 );
+			fleet.Buy(&outfit, 0);
+			THEN( "the new record is part of the value" ) {
+				CHECK( fleet.Value(&outfit, 5, 2) == 2000 );
+			}
+		}
+		WHEN( "it is sold to a planet's stock after its value was asked for" ) {
+			REQUIRE( fleet.Value(&outfit, 5) == 1000 );
+			Depreciation stock;
+			stock.Buy(&outfit, 5, &fleet);
+			THEN( "the record moves along with it" ) {
+				CHECK( fleet.Value(&outfit, 5) == 250 );
+				CHECK( stock.Value(&outfit, 5) == 1000 );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -53,6 +53,44 @@ SCENARIO( "A Dictionary instance is being used", "[dictionary]") {
 	}
 }
 
+SCENARIO( "Looking up attribute keys in a Dictionary", "[dictionary]") {
+	GIVEN( "a dictionary with some known and unknown keys" ) {
+		Dictionary dict;
+		dict["thrust"] = 5.;
+		dict["zzz custom"] = 1.;
+		dict["hull"] = 100.;
+		dict["aaa custom"] = 2.;
+		THEN( "known keys are found by name and by key" ) {
+			CHECK( dict.Get(AttributeKey::THRUST) == 5. );
+			CHECK( dict.Get(AttributeKey::HULL) == 100. );
+			CHECK( dict.Get("thrust") == 5. );
+		}
+		THEN( "known keys that were never added have no value" ) {
+			CHECK( dict.Get(AttributeKey::SHIELDS) == 0. );
+		}
+		WHEN( "a key is modified through a reference" ) {
+			dict["hull"] += 50.;
+			THEN( "the new value is found by key" ) {
+				CHECK( dict.Get(AttributeKey::HULL) == 150. );
+			}
+		}
+	}
+	GIVEN( "every attribute key" ) {
+		THEN( "the names are sorted, as they must be" ) {
+			for(int i = 1; i < static_cast<int>(AttributeKey::COUNT); ++i)
+				CHECK( std::string(Dictionary::Name(static_cast<AttributeKey>(i - 1)))
+					< Dictionary::Name(static_cast<AttributeKey>(i)) );
+		}
+		THEN( "each key finds the value stored under its name" ) {
+			Dictionary dict;
+			for(int i = static_cast<int>(AttributeKey::COUNT) - 1; i >= 0; --i)
+				dict[Dictionary::Name(static_cast<AttributeKey>(i))] = i + 1.;
+			for(int i = 0; i < static_cast<int>(AttributeKey::COUNT); ++i)
+				CHECK( dict.Get(static_cast<AttributeKey>(i)) == i + 1. );
+		}
+	}
+}
+
 // #region benchmarks
 #ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
 TEST_CASE( "Benchmark Dictionary::Get", "[!benchmark][dictionary]" ) {
@@ -0,0 +1,172 @@
+/* test_distanceMap.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/DistanceMap.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Planet.h"
+#include "../../../source/Set.h"
+#include "../../../source/System.h"
+#include "../../../source/SystemGrid.h"
+
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Lay out a rectangular galaxy, with each system linked to the ones beside,
+// above, and below it.
+std::vector<const System *> MakeGalaxy(Set<System> &systems, int width, int height)
+{
+	Set<Planet> planets;
+	std::vector<System *> galaxy;
+	for(int y = 0; y < height; ++y)
+		for(int x = 0; x < width; ++x)
+		{
+			std::string name = "Distance Test " + std::to_string(x) + " " + std::to_string(y);
+			System *system = systems.Get(name);
+			system->Load(AsDataNode("system \"" + name + "\"\n\tpos " + std::to_string(100 * x)
+				+ " " + std::to_string(100 * y)), planets);
+			if(x)
+				system->Link(galaxy.back());
+			if(y)
+				system->Link(galaxy[galaxy.size() - width]);
+			galaxy.push_back(system);
+		}
+
+	std::vector<const System *> result(galaxy.begin(), galaxy.end());
+	SystemGrid grid;
+	grid.Build(result);
+	for(System *system : galaxy)
+		system->UpdateSystem(grid, {100.});
+	return result;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding distances between systems", "[DistanceMap]" ) {
+	GIVEN( "a galaxy of linked systems" ) {
+		Set<System> systems;
+		const int SIDE = 10;
+		const std::vector<const System *> galaxy = MakeGalaxy(systems, SIDE, SIDE);
+		const System *corner = galaxy.front();
+		const System *farCorner = galaxy.back();
+
+		WHEN( "mapping the whole galaxy" ) {
+			DistanceMap map(corner);
+			THEN( "every system can be reached" ) {
+				CHECK( map.Size() == galaxy.size() );
+				CHECK( map.Days(corner) == 0 );
+				CHECK( map.Days(galaxy[1]) == 1 );
+				CHECK( map.Days(farCorner) == 2 * (SIDE - 1) );
+			}
+			THEN( "each step of a route leads closer to the center" ) {
+				const System *next = map.Route(farCorner);
+				REQUIRE( next );
+				CHECK( farCorner->Links().count(next) );
+				CHECK( map.Days(next) == map.Days(farCorner) - 1 );
+			}
+		}
+		WHEN( "mapping only the nearest systems" ) {
+			DistanceMap map(corner, 5);
+			THEN( "the search stops early" ) {
+				CHECK( map.Size() < galaxy.size() );
+				CHECK( map.HasRoute(galaxy[1]) );
+				CHECK_FALSE( map.HasRoute(farCorner) );
+			}
+		}
+		WHEN( "mapping only the systems within a few jumps" ) {
+			DistanceMap map(corner, -1, 3);
+			THEN( "nothing farther away is included" ) {
+				CHECK( map.HasRoute(galaxy[3]) );
+				CHECK_FALSE( map.HasRoute(galaxy[4]) );
+				CHECK_FALSE( map.HasRoute(farCorner) );
+			}
+		}
+	}
+}
+
+SCENARIO( "Finding the route a ship would take", "[DistanceMap]" ) {
+	GIVEN( "a galaxy of linked systems and a ship's capabilities" ) {
+		Set<System> systems;
+		const std::vector<const System *> galaxy = MakeGalaxy(systems, 4, 4);
+		DistanceMap::Traveler traveler;
+		traveler.system = galaxy.back();
+		traveler.hyperspaceFuel = 100;
+
+		WHEN( "finding the route to a distant system" ) {
+			DistanceMap map(traveler, galaxy.front());
+			THEN( "the route starts in the ship's system" ) {
+				REQUIRE( map.HasRoute(traveler.system) );
+				const System *next = map.Route(traveler.system);
+				REQUIRE( next );
+				CHECK( traveler.system->Links().count(next) );
+				CHECK( map.RequiredFuel(traveler.system, galaxy.front()) == 6 * traveler.hyperspaceFuel );
+			}
+		}
+		WHEN( "the ship has no drive" ) {
+			traveler.hyperspaceFuel = 0;
+			DistanceMap map(traveler, galaxy.front());
+			THEN( "there is no route" ) {
+				CHECK_FALSE( map.HasRoute(traveler.system) );
+			}
+		}
+		WHEN( "comparing travelers" ) {
+			DistanceMap::Traveler other = traveler;
+			THEN( "only travelers with different capabilities are ordered" ) {
+				CHECK_FALSE( traveler < other );
+				CHECK_FALSE( other < traveler );
+				other.jumpFuel = 200;
+				CHECK( (traveler < other || other < traveler) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark DistanceMap", "[!benchmark][DistanceMap]" ) {
+	// A synthetic galaxy of 2000 systems, several times larger than the shipped one.
+	Set<System> systems;
+	const std::vector<const System *> galaxy = MakeGalaxy(systems, 50, 40);
+
+	BENCHMARK( "DistanceMap of 2000 systems" ) {
+		return DistanceMap(galaxy.front()).Size();
+	};
+	BENCHMARK( "DistanceMap of 2000 systems, using a jump drive" ) {
+		return DistanceMap(galaxy.front(), WormholeStrategy::NONE, true).Size();
+	};
+	BENCHMARK( "DistanceMap limited to the nearest 50 systems" ) {
+		return DistanceMap(galaxy[galaxy.size() / 2], 50).Size();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
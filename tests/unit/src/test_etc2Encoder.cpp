@@ -0,0 +1,138 @@
+/* test_etc2Encoder.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Etc2Encoder.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Etc2RGBA.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+namespace { // test namespace
+
+// #region mock data
+
+uint32_t Pixel(int red, int green, int blue, int alpha)
+{
+	return red | green << 8 | blue << 16 | static_cast<uint32_t>(alpha) << 24;
+}
+
+// Decode the color of one pixel of an ETC2 block that uses one of the ETC1
+// modes, following the format specification rather than the encoder.
+int DecodeColor(const uint8_t *block, int x, int y, int channel)
+{
+	static const int MODIFIERS[8][2] = {
+		{2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+	};
+	uint64_t bits = 0;
+	for(int i = 8; i < 16; ++i)
+		bits = bits << 8 | block[i];
+
+	bool isDifferential = (bits >> 33) & 1;
+	bool flip = (bits >> 32) & 1;
+	int half = flip ? (y >= 2) : (x >= 2);
+	int base = 0;
+	if(isDifferential)
+	{
+		int first = (bits >> (59 - 8 * channel)) & 31;
+		int difference = (bits >> (56 - 8 * channel)) & 7;
+		int value = first + (half ? (difference >= 4 ? difference - 8 : difference) : 0);
+		base = value << 3 | value >> 2;
+	}
+	else
+		base = ((bits >> (60 - 4 * half - 8 * channel)) & 15) * 17;
+
+	int table = (bits >> (half ? 34 : 37)) & 7;
+	int i = x * 4 + y;
+	int index = ((bits >> (16 + i)) & 1) << 1 | ((bits >> i) & 1);
+	int modifier = MODIFIERS[table][index & 1];
+	return std::max(0, std::min(255, base + (index & 2 ? -modifier : modifier)));
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Encoding blocks of pixels in ETC2 format", "[Etc2Encoder]" ) {
+	uint8_t block[16];
+	GIVEN( "a fully transparent block" ) {
+		const uint32_t pixels[16] = {};
+		Etc2Encoder::EncodeBlock(pixels, block);
+		const Etc2RGBA image(block, 4, 4);
+
+		THEN( "it decodes exactly" ) {
+			for(int y = 0; y < 4; ++y)
+				for(int x = 0; x < 4; ++x)
+				{
+					CHECK( image.Alpha(0, x, y) == 0 );
+					for(int c = 0; c < 3; ++c)
+						CHECK( DecodeColor(block, x, y, c) == 0 );
+				}
+		}
+	}
+	GIVEN( "a block with a gradient of color and alpha" ) {
+		uint32_t pixels[16];
+		for(int y = 0; y < 4; ++y)
+			for(int x = 0; x < 4; ++x)
+			{
+				int alpha = 40 + 60 * x + 5 * y;
+				pixels[y * 4 + x] = Pixel(alpha * 3 / 4, alpha / 2, alpha / 4, alpha);
+			}
+		Etc2Encoder::EncodeBlock(pixels, block);
+		const Etc2RGBA image(block, 4, 4);
+
+		THEN( "every pixel decodes close to its original value" ) {
+			// Each block has only 8 alpha levels, and 4 per half for color, so
+			// 16 different values can't all be exact.
+			for(int y = 0; y < 4; ++y)
+				for(int x = 0; x < 4; ++x)
+				{
+					uint32_t pixel = pixels[y * 4 + x];
+					CHECK( std::abs(image.Alpha(0, x, y) - static_cast<int>(pixel >> 24)) <= 16 );
+					for(int c = 0; c < 3; ++c)
+						CHECK( std::abs(DecodeColor(block, x, y, c) - static_cast<int>((pixel >> (8 * c)) & 0xFF)) <= 24 );
+				}
+		}
+	}
+	GIVEN( "a block that is half opaque and half transparent" ) {
+		uint32_t pixels[16];
+		for(int i = 0; i < 16; ++i)
+			pixels[i] = (i < 8) ? Pixel(200, 100, 50, 255) : 0;
+		Etc2Encoder::EncodeBlock(pixels, block);
+		const Etc2RGBA image(block, 4, 4);
+
+		THEN( "the alpha is exact and the transparent half stays black" ) {
+			for(int y = 0; y < 4; ++y)
+				for(int x = 0; x < 4; ++x)
+				{
+					CHECK( image.Alpha(0, x, y) == (y < 2 ? 255 : 0) );
+					if(y >= 2)
+						for(int c = 0; c < 3; ++c)
+							CHECK( DecodeColor(block, x, y, c) == 0 );
+				}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,123 @@
+/* test_etc2RGBA.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Etc2RGBA.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Fill an image with arbitrary (but repeatable) ETC2 blocks, so that every
+// combination of base, multiplier, and table gets used.
+std::vector<uint64_t> MakeImage(int width, int height, int frames)
+{
+	std::vector<uint64_t> data(2 * ((width + 3) / 4) * ((height + 3) / 4) * frames);
+	uint64_t state = 0x9E3779B97F4A7C15;
+	for(uint64_t &word : data)
+	{
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		word = state;
+	}
+	return data;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Decoding the alpha of ETC2 blocks", "[Etc2RGBA]" ) {
+	GIVEN( "an image whose size is not a multiple of the block size" ) {
+		const int width = 10;
+		const int height = 7;
+		const int frames = 3;
+		const auto data = MakeImage(width, height, frames);
+		const Etc2RGBA image(data.data(), width, height);
+
+		WHEN( "decoding each frame at once" ) {
+			THEN( "every pixel matches decoding it on its own" ) {
+				std::vector<uint8_t> plane(width * height);
+				for(int frame = 0; frame < frames; ++frame)
+				{
+					image.AlphaFrame(frame, plane.data());
+					for(int y = 0; y < height; ++y)
+						for(int x = 0; x < width; ++x)
+							CHECK( plane[y * width + x] == image.Alpha(frame, x, y) );
+				}
+			}
+		}
+	}
+	GIVEN( "a block whose values would be out of range" ) {
+		// A base of 250 with the largest multiplier and table 0 would give values
+		// from 25 to 460. The first row uses indices 0, 3, 4, and 7.
+		const uint64_t block = (uint64_t(250) << 56) | (uint64_t(15) << 52)
+			| (uint64_t(3) << 33) | (uint64_t(4) << 21) | (uint64_t(7) << 9);
+		std::vector<uint64_t> data(2);
+		// The blocks are stored big-endian.
+		for(int i = 0; i < 8; ++i)
+			reinterpret_cast<uint8_t *>(data.data())[i] = block >> (56 - 8 * i);
+		const Etc2RGBA image(data.data(), 4, 4);
+
+		THEN( "they are clamped" ) {
+			uint8_t values[16];
+			image.AlphaBlock(0, 0, 0, values);
+			CHECK( values[0] == 205 );
+			CHECK( values[1] == 25 );
+			CHECK( values[2] == 255 );
+			CHECK( values[3] == 255 );
+			CHECK( values[4] == 205 );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark decoding ETC2 alpha", "[!benchmark][Etc2RGBA]" ) {
+	// The size of a large capital ship sprite.
+	const int width = 512;
+	const int height = 512;
+	const auto data = MakeImage(width, height, 1);
+	const Etc2RGBA image(data.data(), width, height);
+	std::vector<uint8_t> plane(width * height);
+
+	BENCHMARK( "Etc2RGBA::Alpha" ) {
+		for(int y = 0; y < height; ++y)
+			for(int x = 0; x < width; ++x)
+				plane[y * width + x] = image.Alpha(0, x, y);
+		return plane[0];
+	};
+	BENCHMARK( "Etc2RGBA::AlphaFrame" ) {
+		image.AlphaFrame(0, plane.data());
+		return plane[0];
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
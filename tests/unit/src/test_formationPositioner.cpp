@@ -0,0 +1,124 @@
+/* test_formationPositioner.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include a helper for creating well-formed DataNodes (to use for loading formations).
+#include "datanode-factory.h"
+
+// Include only the tested class's header.
+#include "../../../source/FormationPositioner.h"
+
+#include "../../../source/Body.h"
+#include "../../../source/FormationPattern.h"
+
+// ... and any system includes needed for the test file.
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+bool Same(const Point &a, const Point &b)
+{
+	return a.Distance(b) < .001;
+}
+
+
+
+const char *const LINE = R"(formation "Line"
+	position -100 0
+	position 100 0
+	position 0 100
+)";
+
+const char *const COLUMN = R"(formation "Column"
+	position 0 100
+	position 0 200
+	position 0 300
+)";
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Assigning ships to the positions of a formation", "[formationPositioner]" ) {
+	FormationPattern line;
+	line.Load(AsDataNode(LINE));
+	Body ships[3];
+	const std::vector<const Body *> all = {&ships[0], &ships[1], &ships[2]};
+
+	GIVEN( "ships that are each near a different position" ) {
+		FormationPositioner positioner;
+		positioner.SetPattern(&line);
+		positioner.Update(all, {Point(10., 90.), Point(-90., 5.), Point(120., -10.)});
+		THEN( "each ship is given the position nearest to it" ) {
+			REQUIRE( positioner.Position(&ships[0]) );
+			CHECK( Same(*positioner.Position(&ships[0]), Point(0., 100.)) );
+			CHECK( Same(*positioner.Position(&ships[1]), Point(-100., 0.)) );
+			CHECK( Same(*positioner.Position(&ships[2]), Point(100., 0.)) );
+			CHECK( positioner.Solves() == 1 );
+		}
+		WHEN( "the same ships move around" ) {
+			positioner.Update(all, {Point(100., 0.), Point(0., 100.), Point(-100., 0.)});
+			THEN( "they keep their positions" ) {
+				CHECK( Same(*positioner.Position(&ships[0]), Point(0., 100.)) );
+				CHECK( Same(*positioner.Position(&ships[1]), Point(-100., 0.)) );
+				CHECK( positioner.Solves() == 1 );
+			}
+		}
+		WHEN( "the same ships are given in a different order" ) {
+			positioner.Update({&ships[2], &ships[0], &ships[1]}, {Point(), Point(), Point()});
+			THEN( "nothing is assigned again" ) {
+				CHECK( positioner.Solves() == 1 );
+			}
+		}
+		WHEN( "a ship leaves the formation" ) {
+			positioner.Update({&ships[0], &ships[1]}, {Point(10., 90.), Point(-90., 5.)});
+			THEN( "the ships are assigned again" ) {
+				CHECK( positioner.Solves() == 2 );
+				CHECK_FALSE( positioner.Position(&ships[2]) );
+				CHECK( Same(*positioner.Position(&ships[1]), Point(-100., 0.)) );
+				CHECK( Same(*positioner.Position(&ships[0]), Point(100., 0.)) );
+			}
+		}
+		WHEN( "the pattern changes" ) {
+			FormationPattern column;
+			column.Load(AsDataNode(COLUMN));
+			positioner.SetPattern(&column);
+			positioner.Update(all, {Point(0., 310.), Point(0., 90.), Point(0., 190.)});
+			THEN( "the ships are assigned to the new pattern" ) {
+				CHECK( positioner.Solves() == 2 );
+				CHECK( Same(*positioner.Position(&ships[0]), Point(0., 300.)) );
+				CHECK( Same(*positioner.Position(&ships[1]), Point(0., 100.)) );
+				CHECK( Same(*positioner.Position(&ships[2]), Point(0., 200.)) );
+			}
+		}
+	}
+	GIVEN( "ships that are all nearest the same position" ) {
+		FormationPositioner positioner;
+		positioner.SetPattern(&line);
+		positioner.Update(all, {Point(-100., 0.), Point(-110., 0.), Point(-120., 0.)});
+		THEN( "each ship still gets a position of its own" ) {
+			CHECK_FALSE( Same(*positioner.Position(&ships[0]), *positioner.Position(&ships[1])) );
+			CHECK_FALSE( Same(*positioner.Position(&ships[1]), *positioner.Position(&ships[2])) );
+			CHECK_FALSE( Same(*positioner.Position(&ships[0]), *positioner.Position(&ships[2])) );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
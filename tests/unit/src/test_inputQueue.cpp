@@ -0,0 +1,120 @@
+/* test_inputQueue.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/InputQueue.h"
+
+// ... and any system includes needed for the test file.
+#include <cstring>
+
+namespace { // test namespace
+
+// #region mock data
+
+SDL_Event FingerMotion(SDL_FingerID finger, float x, float dx)
+{
+	SDL_Event event;
+	std::memset(&event, 0, sizeof(event));
+	event.type = SDL_FINGERMOTION;
+	event.tfinger.fingerId = finger;
+	event.tfinger.x = x;
+	event.tfinger.dx = dx;
+	return event;
+}
+
+SDL_Event MouseMotion(Uint32 state, int x, int xrel)
+{
+	SDL_Event event;
+	std::memset(&event, 0, sizeof(event));
+	event.type = SDL_MOUSEMOTION;
+	event.motion.state = state;
+	event.motion.x = x;
+	event.motion.xrel = xrel;
+	return event;
+}
+
+SDL_Event Other(Uint32 type)
+{
+	SDL_Event event;
+	std::memset(&event, 0, sizeof(event));
+	event.type = type;
+	return event;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Merging motion events", "[InputQueue]" ) {
+	GIVEN( "an empty queue" ) {
+		InputQueue queue;
+		WHEN( "one finger moves several times" ) {
+			queue.Add(FingerMotion(1, .1f, .01f));
+			queue.Add(FingerMotion(1, .2f, .1f));
+			queue.Add(FingerMotion(1, .3f, .1f));
+			THEN( "a single event has the final position and the whole motion" ) {
+				REQUIRE( queue.Events().size() == 1 );
+				CHECK( queue.Events()[0].tfinger.x == Approx(.3f) );
+				CHECK( queue.Events()[0].tfinger.dx == Approx(.21f) );
+			}
+		}
+		WHEN( "two fingers move at the same time" ) {
+			queue.Add(FingerMotion(1, .1f, .1f));
+			queue.Add(FingerMotion(2, .5f, .1f));
+			queue.Add(FingerMotion(1, .2f, .1f));
+			queue.Add(FingerMotion(2, .6f, .1f));
+			THEN( "each finger keeps one event" ) {
+				REQUIRE( queue.Events().size() == 2 );
+				CHECK( queue.Events()[0].tfinger.fingerId == 1 );
+				CHECK( queue.Events()[0].tfinger.x == Approx(.2f) );
+				CHECK( queue.Events()[1].tfinger.fingerId == 2 );
+				CHECK( queue.Events()[1].tfinger.x == Approx(.6f) );
+			}
+		}
+		WHEN( "another kind of event comes between two motions" ) {
+			queue.Add(FingerMotion(1, .1f, .1f));
+			queue.Add(Other(SDL_FINGERUP));
+			queue.Add(FingerMotion(1, .2f, .1f));
+			THEN( "nothing is merged" ) {
+				CHECK( queue.Events().size() == 3 );
+			}
+		}
+		WHEN( "the mouse moves and then drags" ) {
+			queue.Add(MouseMotion(0, 10, 1));
+			queue.Add(MouseMotion(0, 12, 2));
+			queue.Add(MouseMotion(SDL_BUTTON(1), 15, 3));
+			THEN( "the move and the drag are kept apart" ) {
+				REQUIRE( queue.Events().size() == 2 );
+				CHECK( queue.Events()[0].motion.xrel == 3 );
+				CHECK( queue.Events()[1].motion.xrel == 3 );
+			}
+		}
+		WHEN( "the queue is cleared" ) {
+			queue.Add(FingerMotion(1, .1f, .1f));
+			queue.Clear();
+			THEN( "it is empty" ) {
+				CHECK( queue.Events().empty() );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
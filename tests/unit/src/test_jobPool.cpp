@@ -0,0 +1,94 @@
+/* test_jobPool.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/JobPool.h"
+
+// ... and any system includes needed for the test file.
+#include <atomic>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Running jobs in a JobPool", "[JobPool]" ) {
+	GIVEN( "a pool without any background threads" ) {
+		JobPool pool(0);
+		THEN( "only the calling thread runs jobs" ) {
+			CHECK( pool.Concurrency() == 1 );
+		}
+		WHEN( "jobs are run" ) {
+			std::vector<size_t> order;
+			pool.ParallelFor(5, [&order](size_t i) { order.push_back(i); });
+			THEN( "they run in order" ) {
+				CHECK( order == std::vector<size_t>{0, 1, 2, 3, 4} );
+			}
+		}
+	}
+	GIVEN( "a pool with background threads" ) {
+		JobPool pool(3);
+		REQUIRE( pool.Concurrency() == 4 );
+		WHEN( "many jobs are run" ) {
+			std::vector<std::atomic<int>> runs(1000);
+			for(auto &it : runs)
+				it = 0;
+			pool.ParallelFor(runs.size(), [&runs](size_t i) { ++runs[i]; });
+			THEN( "every job runs exactly once" ) {
+				int wrong = 0;
+				for(const auto &it : runs)
+					wrong += (it != 1);
+				CHECK( wrong == 0 );
+			}
+		}
+		WHEN( "the pool is used repeatedly with uneven jobs" ) {
+			std::atomic<size_t> total(0);
+			for(size_t batch = 0; batch < 50; ++batch)
+				pool.ParallelFor(batch, [&total](size_t i)
+				{
+					// Make the early jobs much slower so that the other threads must steal them.
+					volatile size_t spin = 0;
+					for(size_t j = 0; j < (i < 4 ? 20000u : 10u); ++j)
+						spin = spin + j;
+					total += i;
+				});
+			THEN( "all batches finish completely" ) {
+				size_t expected = 0;
+				for(size_t batch = 0; batch < 50; ++batch)
+					for(size_t i = 0; i < batch; ++i)
+						expected += i;
+				CHECK( total == expected );
+			}
+		}
+		WHEN( "no jobs are given" ) {
+			bool ran = false;
+			pool.ParallelFor(0, [&ran](size_t) { ran = true; });
+			THEN( "nothing runs" ) {
+				CHECK_FALSE( ran );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
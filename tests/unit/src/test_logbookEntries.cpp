@@ -0,0 +1,79 @@
+/* test_logbookEntries.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/LogbookEntries.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Storing dated log entries", "[LogbookEntries]" ) {
+	GIVEN( "an empty logbook" ) {
+		LogbookEntries logbook;
+		REQUIRE( logbook.IsEmpty() );
+		REQUIRE( logbook.Size() == 0 );
+		CHECK( logbook.LowerBound(Date(1, 1, 3014)) == 0 );
+
+		WHEN( "entries are added in date order" ) {
+			logbook.Add(Date(16, 11, 3013), "Departed New Boston.");
+			logbook.Add(Date(2, 12, 3013), "First paragraph.\n\tSecond paragraph.");
+			logbook.Add(Date(2, 12, 3013), "Later that day.");
+
+			THEN( "they can be read back in that order" ) {
+				REQUIRE( logbook.Size() == 3 );
+				CHECK( logbook.GetDate(0) == Date(16, 11, 3013) );
+				CHECK( logbook.Text(0) == "Departed New Boston." );
+				CHECK( logbook.GetDate(1) == Date(2, 12, 3013) );
+				CHECK( logbook.Text(1) == "First paragraph.\n\tSecond paragraph." );
+				CHECK( logbook.Text(2) == "Later that day." );
+			}
+			THEN( "the entries of a month can be found" ) {
+				CHECK( logbook.LowerBound(Date(0, 11, 3013)) == 0 );
+				CHECK( logbook.LowerBound(Date(32, 11, 3013)) == 1 );
+				CHECK( logbook.LowerBound(Date(0, 12, 3013)) == 1 );
+				CHECK( logbook.LowerBound(Date(32, 12, 3013)) == 3 );
+			}
+		}
+		WHEN( "an entry is added with an earlier date" ) {
+			logbook.Add(Date(5, 3, 3014), "Second.");
+			logbook.Add(Date(5, 3, 3014), "Third.");
+			logbook.Add(Date(4, 3, 3014), "First.");
+
+			THEN( "it is sorted before the later entries" ) {
+				REQUIRE( logbook.Size() == 3 );
+				CHECK( logbook.Text(0) == "First." );
+				CHECK( logbook.GetDate(0) == Date(4, 3, 3014) );
+				CHECK( logbook.Text(1) == "Second." );
+				CHECK( logbook.Text(2) == "Third." );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,95 @@
+/* test_logger.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Logger.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Collect the logged messages as they are written out.
+std::vector<std::string> &Capture()
+{
+	static std::vector<std::string> messages;
+	messages.clear();
+	Logger::SetLogErrorCallback([](const std::string &message) { messages.push_back(message); });
+	return messages;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Logging messages of different levels", "[logger]" ) {
+	GIVEN( "a callback that records what is written" ) {
+		auto &messages = Capture();
+		WHEN( "messages of each level are logged and flushed" ) {
+			Logger::LogError("first");
+			Logger::Log("second", Logger::Level::WARNING);
+			Logger::Log("third", Logger::Level::INFO);
+			Logger::Flush();
+			THEN( "they are all written, in order, with warnings and info marked" ) {
+				CHECK( messages == std::vector<std::string>{"first", "Warning: second", "Info: third"} );
+			}
+		}
+		Logger::SetLogErrorCallback(nullptr);
+	}
+}
+
+SCENARIO( "Logging the same message many times in a row", "[logger]" ) {
+	GIVEN( "a callback that records what is written" ) {
+		auto &messages = Capture();
+		WHEN( "a message is repeated and then a different one is logged" ) {
+			for(int i = 0; i < 100; ++i)
+				Logger::LogError("repeated");
+			Logger::LogError("different");
+			Logger::Flush();
+			THEN( "the repeats are replaced by a count" ) {
+				CHECK( messages == std::vector<std::string>{"repeated",
+					"(The previous message was repeated 99 more times.)", "different"} );
+			}
+		}
+		WHEN( "a message is repeated once and then flushed" ) {
+			Logger::LogError("twice");
+			Logger::LogError("twice");
+			Logger::Flush();
+			THEN( "the count is written when flushing" ) {
+				CHECK( messages == std::vector<std::string>{"twice",
+					"(The previous message was repeated 1 more time.)"} );
+			}
+			AND_WHEN( "the same message is logged after the flush" ) {
+				Logger::LogError("twice");
+				Logger::Flush();
+				THEN( "it is written again" ) {
+					CHECK( messages.back() == "twice" );
+				}
+			}
+		}
+		Logger::SetLogErrorCallback(nullptr);
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,174 @@
+/* test_mask.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Mask.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Angle.h"
+#include "../../../source/ImageBuffer.h"
+#include "../../../source/Point.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// A ring with a hole in it, next to a solid square.
+void DrawShapes(ImageBuffer &image)
+{
+	const int width = 240;
+	const int height = 160;
+	image.Allocate(width, height);
+	for(int y = 0; y < height; ++y)
+	{
+		uint32_t *row = image.Begin(y);
+		for(int x = 0; x < width; ++x)
+		{
+			const double distance = std::hypot(x - 80., y - 80.);
+			const bool isRing = (distance < 70. && distance > 30.);
+			const bool isSquare = (x >= 170 && x < 230 && y >= 50 && y < 110);
+			row[x] = (isRing || isSquare) ? 0xFFFFFFFF : 0;
+		}
+	}
+}
+
+// The original, unaccelerated version of Mask::Collide().
+double Collide(const Mask &mask, Point sA, Point vA, Angle facing)
+{
+	sA = (-facing).Rotate(sA);
+	vA = (-facing).Rotate(vA);
+
+	int intersections = 0;
+	double closest = 1.;
+	for(const auto &outline : mask.Outlines())
+	{
+		Point prev = outline.back();
+		for(const Point &next : outline)
+		{
+			if(prev.X() != next.X() && (prev.X() <= sA.X()) == (sA.X() < next.X()))
+			{
+				double y = prev.Y() + (next.Y() - prev.Y()) * (sA.X() - prev.X()) / (next.X() - prev.X());
+				intersections += (y >= sA.Y());
+			}
+			Point vB = next - prev;
+			double cross = vB.Cross(vA);
+			if(cross > 0.)
+			{
+				Point vS = prev - sA;
+				double uB = vA.Cross(vS);
+				double uA = vB.Cross(vS);
+				if((uB >= 0.) & (uB < cross) & (uA >= 0.))
+					closest = std::min(closest, uA / cross);
+			}
+			prev = next;
+		}
+	}
+	return (intersections & 1) ? 0. : closest;
+}
+
+// A repeatable sequence of numbers in [-1, 1).
+class Sequence {
+public:
+	double Next()
+	{
+		state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+		return static_cast<double>(state >> 11) / (1ULL << 52) - 1.;
+	}
+
+private:
+	uint64_t state = 1;
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Colliding line segments with a mask", "[Mask]" ) {
+	GIVEN( "a mask with several outlines" ) {
+		ImageBuffer image;
+		DrawShapes(image);
+		Mask mask;
+		mask.Create(image);
+		REQUIRE( mask.IsLoaded() );
+		REQUIRE( mask.Outlines().size() >= 3 );
+
+		WHEN( "it is scaled" ) {
+			const Mask scaled = mask * 2.;
+			THEN( "collisions are scaled too" ) {
+				const Point start(-200., 0.);
+				const Point velocity(400., 0.);
+				CHECK( scaled.Collide(2. * start, 2. * velocity, Angle()) == Approx(mask.Collide(start, velocity, Angle())) );
+			}
+		}
+		WHEN( "colliding many segments" ) {
+			Sequence random;
+			THEN( "the results match checking every edge" ) {
+				for(int i = 0; i < 2000; ++i)
+				{
+					const Point start(80. * random.Next(), 60. * random.Next());
+					const Point velocity(100. * random.Next(), 100. * random.Next());
+					const Angle facing(180. * random.Next());
+					const double expected = (start.Length() > mask.Radius() + velocity.Length())
+						? 1. : Collide(mask, start, velocity, facing);
+					CHECK( mask.Collide(start, velocity, facing) == Approx(expected).margin(1e-5) );
+				}
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Mask::Collide", "[!benchmark][Mask]" ) {
+	ImageBuffer image;
+	DrawShapes(image);
+	Mask mask;
+	mask.Create(image);
+
+	// A fleet of ships all firing beams at a large target.
+	std::vector<Point> starts;
+	std::vector<Point> velocities;
+	Sequence random;
+	for(int i = 0; i < 40; ++i)
+	{
+		const Point start(200. * random.Next(), 200. * random.Next());
+		starts.push_back(start);
+		velocities.push_back(-1.5 * start + Point(10. * random.Next(), 10. * random.Next()));
+	}
+
+	BENCHMARK( "Mask::Collide" ) {
+		double sum = 0.;
+		for(size_t i = 0; i < starts.size(); ++i)
+			sum += mask.Collide(starts[i], velocities[i], Angle(30.));
+		return sum;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,110 @@
+/* test_maskManager.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/MaskManager.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/ImageBuffer.h"
+#include "../../../source/Mask.h"
+#include "../../../source/Sprite.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Masks of a square, in each of the given number of frames.
+std::vector<Mask> MakeMasks(int frames)
+{
+	ImageBuffer image(frames);
+	image.Allocate(40, 40);
+	std::vector<Mask> masks(frames);
+	for(int frame = 0; frame < frames; ++frame)
+	{
+		for(int y = 0; y < 40; ++y)
+		{
+			uint32_t *row = image.Begin(y, frame);
+			for(int x = 0; x < 40; ++x)
+				row[x] = (x >= 10 && x < 30 && y >= 10 && y < 30) ? 0xFFFFFFFF : 0;
+		}
+		masks[frame].Create(image, frame);
+	}
+	return masks;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Storing masks at several scales", "[MaskManager]" ) {
+	GIVEN( "a sprite that is used at three scales" ) {
+		MaskManager manager;
+		const Sprite sprite("test");
+		manager.RegisterScale(&sprite, .5);
+		manager.RegisterScale(&sprite, 2.);
+		manager.SetMasks(&sprite, MakeMasks(3));
+		manager.ScaleMasks();
+
+		const std::vector<Mask> &base = manager.GetMasks(&sprite, 1.);
+		const std::vector<Mask> &half = manager.GetMasks(&sprite, .5);
+		const std::vector<Mask> &twice = manager.GetMasks(&sprite, 2.);
+		REQUIRE( base.size() == 3 );
+		REQUIRE( half.size() == 3 );
+		REQUIRE( twice.size() == 3 );
+
+		THEN( "each mask has the right scale" ) {
+			REQUIRE( base[0].IsLoaded() );
+			CHECK( half[1].Radius() == Approx(.5 * base[1].Radius()) );
+			CHECK( twice[2].Radius() == Approx(2. * base[2].Radius()) );
+			CHECK( twice[0].Contains(Point(8., 8.), Angle()) );
+			CHECK_FALSE( base[0].Contains(Point(8., 8.), Angle()) );
+		}
+		THEN( "the scaled masks share the outlines" ) {
+			CHECK( &half[0].Outlines() == &base[0].Outlines() );
+			CHECK( &twice[2].Outlines() == &base[2].Outlines() );
+		}
+		THEN( "unknown scales have no masks" ) {
+			CHECK( manager.GetMasks(&sprite, 3.).empty() );
+		}
+	}
+	GIVEN( "a sprite whose masks are added after the others are scaled" ) {
+		MaskManager manager;
+		const Sprite sprite("late");
+		manager.RegisterScale(&sprite, .5);
+		manager.ScaleMasks();
+		REQUIRE( manager.GetMasks(&sprite, .5).empty() );
+
+		WHEN( "its masks are added" ) {
+			manager.SetMasks(&sprite, MakeMasks(2));
+			THEN( "they are scaled right away" ) {
+				const std::vector<Mask> &half = manager.GetMasks(&sprite, .5);
+				REQUIRE( half.size() == 2 );
+				CHECK( half[0].Radius() == Approx(.5 * manager.GetMasks(&sprite, 1.)[0].Radius()) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,153 @@
+/* test_memoryStats.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// Include only the tested class's header.
+#include "../../../source/MemoryStats.h"
+
+#include "../../../source/DataNode.h"
+#include "../../../source/Set.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+class Stored {
+public:
+	int value = 0;
+};
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Keeping a running total of memory", "[MemoryStats]" ) {
+	GIVEN( "a category" ) {
+		const auto category = MemoryStats::Category::ENGINE_OBJECTS;
+		const int64_t start = MemoryStats::Bytes(category);
+		WHEN( "memory is added and freed" ) {
+			MemoryStats::Add(category, 100);
+			MemoryStats::Add(category, -40);
+			THEN( "the total is the difference" ) {
+				CHECK( MemoryStats::Bytes(category) == start + 60 );
+			}
+			MemoryStats::Add(category, -60);
+		}
+		WHEN( "the total is set directly" ) {
+			MemoryStats::SetBytes(category, 1234);
+			THEN( "it replaces the previous total" ) {
+				CHECK( MemoryStats::Bytes(category) == 1234 );
+			}
+			MemoryStats::SetBytes(category, start);
+		}
+	}
+	GIVEN( "a report" ) {
+		const std::string report = MemoryStats::Report();
+		THEN( "every category is listed" ) {
+			for(int i = 0; i < static_cast<int>(MemoryStats::Category::COUNT); ++i)
+			{
+				const std::string name = MemoryStats::Name(static_cast<MemoryStats::Category>(i));
+				CHECK( report.find("\n" + name + ",") != std::string::npos );
+			}
+		}
+	}
+}
+
+SCENARIO( "Counting the memory used by data nodes", "[MemoryStats][DataNode]" ) {
+	const auto category = MemoryStats::Category::DATA_NODES;
+	const int64_t start = MemoryStats::Bytes(category);
+	GIVEN( "some parsed nodes" ) {
+		std::vector<DataNode> nodes = AsDataNodes("ship \"A name long enough to need its own memory\"\n"
+			"\tattributes\n\t\tmass 100\n");
+		const int64_t loaded = MemoryStats::Bytes(category);
+		REQUIRE( loaded > start );
+		WHEN( "a node is copied" ) {
+			{
+				DataNode copy(nodes.front());
+				THEN( "the copy is counted too" ) {
+					CHECK( MemoryStats::Bytes(category) > loaded );
+				}
+			}
+			THEN( "destroying the copy frees what it added" ) {
+				CHECK( MemoryStats::Bytes(category) == loaded );
+			}
+		}
+		WHEN( "a node is moved" ) {
+			DataNode moved(std::move(nodes.front()));
+			THEN( "nothing more is counted" ) {
+				CHECK( MemoryStats::Bytes(category) == loaded );
+			}
+		}
+		WHEN( "the nodes are destroyed" ) {
+			nodes.clear();
+			THEN( "the total is what it was before they were parsed" ) {
+				CHECK( MemoryStats::Bytes(category) == start );
+			}
+		}
+	}
+}
+
+SCENARIO( "Counting the objects in a set", "[MemoryStats][Set]" ) {
+	const auto category = MemoryStats::Category::OBJECT_SETS;
+	const int64_t start = MemoryStats::Bytes(category);
+	GIVEN( "a set with some objects" ) {
+		Set<Stored> set;
+		set.Get("first");
+		set.Get("second");
+		const int64_t filled = MemoryStats::Bytes(category);
+		REQUIRE( filled > start );
+		WHEN( "an object that already exists is looked up" ) {
+			set.Get("first");
+			THEN( "nothing more is counted" ) {
+				CHECK( MemoryStats::Bytes(category) == filled );
+			}
+		}
+		WHEN( "the set is copied and the copy is destroyed" ) {
+			{
+				Set<Stored> copy(set);
+				CHECK( MemoryStats::Bytes(category) == start + 2 * (filled - start) );
+			}
+			THEN( "only the original is counted" ) {
+				CHECK( MemoryStats::Bytes(category) == filled );
+			}
+		}
+		WHEN( "another set is moved into it" ) {
+			Set<Stored> other;
+			other.Get("third");
+			set = std::move(other);
+			THEN( "the objects it held before are no longer counted" ) {
+				CHECK( MemoryStats::Bytes(category) == start + (filled - start) / 2 );
+			}
+		}
+		WHEN( "it is reverted to an empty set" ) {
+			set.Revert(Set<Stored>());
+			THEN( "its objects are no longer counted" ) {
+				CHECK( MemoryStats::Bytes(category) == start );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,116 @@
+/* test_missionIndex.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/MissionIndex.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/GameData.h"
+#include "../../../source/Mission.h"
+#include "../../../source/Planet.h"
+#include "../../../source/Set.h"
+#include "../../../source/System.h"
+
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+Set<Mission> MakeMissions()
+{
+	Set<Mission> missions;
+	const std::vector<std::string> definitions = {
+		"mission Alpha\n\tsource \"Index Test Earth\"",
+		"mission Beta\n\tjob",
+		"mission Delta\n\tboarding\n\tsource\n\t\tsystem \"Index Test Sol\"",
+		"mission Epsilon\n\tassisting",
+		"mission Gamma\n\tsource\n\t\tplanet \"Index Test Mars\" \"Index Test Earth\"",
+	};
+	for(const std::string &definition : definitions)
+	{
+		const DataNode node = AsDataNode(definition);
+		missions.Get(node.Token(1))->Load(node);
+	}
+	return missions;
+}
+
+std::vector<std::string> Names(const std::vector<const Mission *> &found)
+{
+	std::vector<std::string> names;
+	for(const Mission *mission : found)
+		names.push_back(mission->Identifier());
+	return names;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding the missions that might be offered somewhere", "[MissionIndex]" ) {
+	GIVEN( "an index of missions offered in different places" ) {
+		Set<Mission> missions = MakeMissions();
+		MissionIndex index;
+		index.Update(missions);
+		const Planet *earth = GameData::Planets().Get("Index Test Earth");
+		const Planet *mars = GameData::Planets().Get("Index Test Mars");
+		const Planet *venus = GameData::Planets().Get("Index Test Venus");
+		const System *sol = GameData::Systems().Get("Index Test Sol");
+		const System *other = GameData::Systems().Get("Index Test Other");
+		std::vector<const Mission *> found;
+
+		WHEN( "landing on a planet" ) {
+			THEN( "only missions that can be offered there are found, in order" ) {
+				index.Landing(earth, found);
+				CHECK( Names(found) == std::vector<std::string>{"Alpha", "Beta", "Gamma"} );
+				index.Landing(mars, found);
+				CHECK( Names(found) == std::vector<std::string>{"Beta", "Gamma"} );
+				index.Landing(venus, found);
+				CHECK( Names(found) == std::vector<std::string>{"Beta"} );
+			}
+		}
+		WHEN( "boarding or assisting a ship" ) {
+			THEN( "only missions of that kind that a ship in that system can offer are found" ) {
+				index.Boarding(Mission::BOARDING, sol, found);
+				CHECK( Names(found) == std::vector<std::string>{"Delta"} );
+				index.Boarding(Mission::BOARDING, other, found);
+				CHECK( found.empty() );
+				index.Boarding(Mission::ASSISTING, other, found);
+				CHECK( Names(found) == std::vector<std::string>{"Epsilon"} );
+			}
+		}
+		WHEN( "a mission is added after the index was built" ) {
+			const DataNode node = AsDataNode("mission Aardvark");
+			missions.Get("Aardvark")->Load(node);
+			index.Update(missions);
+			THEN( "the index includes it" ) {
+				index.Landing(venus, found);
+				CHECK( Names(found) == std::vector<std::string>{"Aardvark", "Beta"} );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
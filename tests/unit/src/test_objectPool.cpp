@@ -0,0 +1,121 @@
+/* test_objectPool.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/ObjectPool.h"
+
+// ... and any system includes needed for the test file.
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// The pool only needs its objects to say whether they should be removed.
+class Item {
+public:
+	explicit Item(int value) : value(value) {}
+	bool ShouldBeRemoved() const { return removed; }
+
+	int value;
+	bool removed = false;
+};
+
+std::vector<int> Values(const ObjectPool<Item> &pool)
+{
+	std::vector<int> values;
+	for(const Item &item : pool)
+		values.push_back(item.value);
+	return values;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Referring to pooled objects by handle", "[ObjectPool]" ) {
+	GIVEN( "a pool with several objects" ) {
+		ObjectPool<Item> pool;
+		std::vector<PoolHandle<Item>> handles;
+		for(int i = 0; i < 5; ++i)
+			handles.push_back(pool.Add(Item(i)));
+		REQUIRE( pool.size() == 5 );
+
+		THEN( "each handle finds its object" ) {
+			for(int i = 0; i < 5; ++i)
+			{
+				REQUIRE( pool.Get(handles[i]) );
+				CHECK( pool.Get(handles[i])->value == i );
+				CHECK( pool.GetHandle(*pool.Get(handles[i])) == handles[i] );
+			}
+		}
+		THEN( "a default handle finds nothing" ) {
+			CHECK_FALSE( pool.Get(PoolHandle<Item>()) );
+		}
+		WHEN( "some objects are removed" ) {
+			pool.Get(handles[1])->removed = true;
+			pool.Get(handles[3])->removed = true;
+			pool.Prune();
+
+			THEN( "the rest keep their order and their handles" ) {
+				CHECK( Values(pool) == std::vector<int>{0, 2, 4} );
+				CHECK( pool.Get(handles[4])->value == 4 );
+				CHECK( pool.Get(handles[2])->value == 2 );
+			}
+			THEN( "the removed objects' handles find nothing" ) {
+				CHECK_FALSE( pool.Get(handles[1]) );
+				CHECK_FALSE( pool.Get(handles[3]) );
+			}
+			AND_WHEN( "new objects are added in their place" ) {
+				PoolHandle<Item> added = pool.Add(Item(5));
+				THEN( "the old handles still do not find anything" ) {
+					CHECK( added != handles[1] );
+					CHECK( added != handles[3] );
+					CHECK_FALSE( pool.Get(handles[1]) );
+					CHECK_FALSE( pool.Get(handles[3]) );
+					CHECK( pool.Get(added)->value == 5 );
+				}
+			}
+		}
+		WHEN( "the pool is cleared" ) {
+			pool.Clear();
+			THEN( "no handle finds anything" ) {
+				CHECK( pool.empty() );
+				for(const PoolHandle<Item> &handle : handles)
+					CHECK_FALSE( pool.Get(handle) );
+			}
+		}
+	}
+	GIVEN( "a list of new objects" ) {
+		ObjectPool<Item> pool;
+		pool.Add(Item(0));
+		std::vector<Item> added = {Item(1), Item(2)};
+		WHEN( "they are appended" ) {
+			pool.Append(added);
+			THEN( "they are moved to the end of the pool" ) {
+				CHECK( added.empty() );
+				CHECK( Values(pool) == std::vector<int>{0, 1, 2} );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,96 @@
+/* test_particleSystem.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/ParticleSystem.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Angle.h"
+#include "../../../source/Effect.h"
+#include "../../../source/Particle.h"
+#include "../../../source/Point.h"
+#include "../../../source/Visual.h"
+
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+Effect MakeEffect(const std::string &text)
+{
+	Effect effect;
+	effect.Load(AsDataNode(text));
+	return effect;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Recording the particles of an effect", "[Particle]" ) {
+	const Effect effect = MakeEffect("effect spark\n\tlifetime 30");
+	GIVEN( "a particle created on a later step" ) {
+		const Particle particle(effect, Point(10., -20.), Point(1., 2.), Angle(90.));
+		const SpriteShader::ParticleItem item = particle.Item(5.f);
+		THEN( "its starting values are recorded" ) {
+			CHECK( &particle.GetEffect() == &effect );
+			CHECK( item.position[0] == 10.f );
+			CHECK( item.position[1] == -20.f );
+			CHECK( item.velocity[0] == 1.f );
+			CHECK( item.velocity[1] == 2.f );
+			CHECK( item.angle == Approx(90.f) );
+			CHECK( item.spin == 0.f );
+			CHECK( item.birth == 5.f );
+			CHECK( item.lifetime == 30.f );
+		}
+		THEN( "its animation stays in step with the other copies of the effect" ) {
+			CHECK( item.phase == 0.f );
+			CHECK( item.frameOffset == Approx(item.frameRate * 5.f) );
+		}
+	}
+}
+
+SCENARIO( "Adding particles that can't be drawn", "[ParticleSystem]" ) {
+	const Effect effect = MakeEffect("effect spark\n\tlifetime 30");
+	ParticleSystem particles;
+	GIVEN( "new particles, with no graphics driver to draw them" ) {
+		std::vector<Particle> added;
+		added.emplace_back(effect, Point(10., 0.), Point(1., 0.), Angle());
+		added.emplace_back(effect, Point(0., 10.), Point(), Angle());
+		std::vector<Visual> visuals;
+		particles.Append(added, 100, visuals);
+		THEN( "they are turned into visuals instead" ) {
+			CHECK( added.empty() );
+			CHECK( particles.Size() == 0 );
+			REQUIRE( visuals.size() == 2 );
+			CHECK( visuals[0].Position().X() == 10. );
+			CHECK( visuals[0].Velocity().X() == 1. );
+			CHECK( visuals[1].Position().Y() == 10. );
+			CHECK( visuals[1].Lifetime() == 30 );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
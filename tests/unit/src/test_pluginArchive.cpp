@@ -0,0 +1,214 @@
+/* test_pluginArchive.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/PluginArchive.h"
+
+// ... and any system includes needed for the test file.
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+const std::string ARCHIVE = "test-plugin-archive.zip";
+const std::string ROOT = ARCHIVE + '/';
+const std::string STORED = "ship \"Archived Ship\"\n\tattributes\n\t\tmass 100\n";
+const std::string DEFLATED = std::string(1000, 'x') + "\nThe end.\n";
+
+void Append2(std::string &out, uint32_t value)
+{
+	out += static_cast<char>(value & 0xFF);
+	out += static_cast<char>((value >> 8) & 0xFF);
+}
+
+void Append4(std::string &out, uint32_t value)
+{
+	Append2(out, value & 0xFFFF);
+	Append2(out, value >> 16);
+}
+
+std::string Deflate(const std::string &data)
+{
+	z_stream stream = {};
+	deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+	std::string result(deflateBound(&stream, data.size()), '\0');
+	stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+	stream.avail_in = data.size();
+	stream.next_out = reinterpret_cast<Bytef *>(&result[0]);
+	stream.avail_out = result.size();
+	deflate(&stream, Z_FINISH);
+	result.resize(stream.total_out);
+	deflateEnd(&stream);
+	return result;
+}
+
+// Write a zip archive containing the given files, each either stored as it is
+// or deflated, and return its path. The archive is deleted when this goes out of scope.
+class ArchiveFile {
+public:
+	struct Contents {
+		std::string name;
+		std::string data;
+		bool compress;
+	};
+
+	explicit ArchiveFile(const std::vector<Contents> &files)
+	{
+		std::string out;
+		std::string directory;
+		for(const auto &file : files)
+		{
+			const std::string data = file.compress ? Deflate(file.data) : file.data;
+			const uint32_t crc = crc32(0, reinterpret_cast<const Bytef *>(file.data.data()), file.data.size());
+			std::string common;
+			Append2(common, 20);
+			Append2(common, 0);
+			Append2(common, file.compress ? 8 : 0);
+			Append4(common, 0);
+			Append4(common, crc);
+			Append4(common, data.size());
+			Append4(common, file.data.size());
+			Append2(common, file.name.size());
+			Append2(common, 0);
+
+			Append4(directory, 0x02014b50);
+			Append2(directory, 20);
+			directory += common;
+			Append2(directory, 0);
+			Append2(directory, 0);
+			Append2(directory, 0);
+			Append4(directory, 0);
+			Append4(directory, out.size());
+			directory += file.name;
+
+			Append4(out, 0x04034b50);
+			out += common;
+			out += file.name;
+			out += data;
+		}
+		const size_t offset = out.size();
+		out += directory;
+		Append4(out, 0x06054b50);
+		Append2(out, 0);
+		Append2(out, 0);
+		Append2(out, files.size());
+		Append2(out, files.size());
+		Append4(out, directory.size());
+		Append4(out, offset);
+		Append2(out, 0);
+
+		std::ofstream(ARCHIVE, std::ios::binary) << out;
+	}
+
+	~ArchiveFile()
+	{
+		std::remove(ARCHIVE.c_str());
+	}
+};
+
+const std::vector<ArchiveFile::Contents> FILES = {
+	{"about.txt", "An archived plugin.\n", false},
+	{"data/ships.txt", STORED, false},
+	{"data/more/text.txt", DEFLATED, true},
+	{"images/", "", false},
+	{"images/icon.png", "not really an image", false},
+};
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Reading a plugin archive", "[PluginArchive]" ) {
+	GIVEN( "a file that is not an archive" ) {
+		std::ofstream(ARCHIVE, std::ios::binary) << STORED;
+		PluginArchive archive(ARCHIVE);
+		std::remove(ARCHIVE.c_str());
+		THEN( "it is not valid" ) {
+			CHECK_FALSE( archive.IsValid() );
+		}
+	}
+	GIVEN( "a zip archive" ) {
+		ArchiveFile file(FILES);
+		PluginArchive archive(ARCHIVE);
+		REQUIRE( archive.IsValid() );
+		CHECK( archive.Root() == ROOT );
+
+		THEN( "its files and directories exist" ) {
+			CHECK( archive.Exists("") );
+			CHECK( archive.Exists("about.txt") );
+			CHECK( archive.Exists("data") );
+			CHECK( archive.Exists("data/") );
+			CHECK( archive.Exists("data/more") );
+			CHECK( archive.Exists("images") );
+			CHECK_FALSE( archive.Exists("sounds") );
+			CHECK_FALSE( archive.Exists("data/ships") );
+		}
+		THEN( "its directories can be listed" ) {
+			CHECK( archive.List("") == std::vector<std::string>{ROOT + "about.txt"} );
+			CHECK( archive.List("data") == std::vector<std::string>{ROOT + "data/ships.txt"} );
+			CHECK( archive.ListDirectories("") == std::vector<std::string>{ROOT + "data/", ROOT + "images/"} );
+			CHECK( archive.ListDirectories("data/") == std::vector<std::string>{ROOT + "data/more/"} );
+			const std::vector<std::string> data = {ROOT + "data/more/text.txt", ROOT + "data/ships.txt"};
+			CHECK( archive.RecursiveList("data") == data );
+		}
+		THEN( "stored files are read in place" ) {
+			size_t size = 0;
+			const char *data = archive.Data("data/ships.txt", size);
+			REQUIRE( data );
+			CHECK( std::string(data, size) == STORED );
+			CHECK( archive.Read("data/ships.txt") == STORED );
+			CHECK( archive.Size("data/ships.txt") == static_cast<int64_t>(STORED.size()) );
+		}
+		THEN( "compressed files are inflated when they are read" ) {
+			size_t size = 0;
+			CHECK_FALSE( archive.Data("data/more/text.txt", size) );
+			CHECK( archive.Read("data/more/text.txt") == DEFLATED );
+			CHECK( archive.Size("data/more/text.txt") == static_cast<int64_t>(DEFLATED.size()) );
+		}
+		THEN( "missing files cannot be read" ) {
+			CHECK( archive.Read("data/missing.txt").empty() );
+			CHECK( archive.Size("data/missing.txt") == -1 );
+		}
+	}
+}
+
+SCENARIO( "Finding the archive that contains a path", "[PluginArchive]" ) {
+	ArchiveFile file(FILES);
+	const std::string root = PluginArchive::Mount(ARCHIVE);
+	REQUIRE( root == ROOT );
+	std::string name;
+	CHECK( PluginArchive::Find(ROOT + "data/ships.txt", name) );
+	CHECK( name == "data/ships.txt" );
+	CHECK( PluginArchive::Find(ARCHIVE, name) );
+	CHECK( name.empty() );
+	CHECK_FALSE( PluginArchive::Find("plugins/other/data/ships.txt", name) );
+	CHECK( PluginArchive::Mount(ARCHIVE) == root );
+	CHECK( PluginArchive::Mount("plugins/other/") == "" );
+}
+// #endregion unit tests
+
+
+
+} // test namespace
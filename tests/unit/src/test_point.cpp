@@ -122,6 +122,49 @@ SCENARIO( "Copying Points", "[Point]" ) {
 		}
 	}
 }
+
+SCENARIO( "Point coordinates are stored as the selected scalar type", "[Point]" ) {
+	using Scalar = Point::Scalar;
+	GIVEN( "a Point made from doubles" ) {
+		const double third = 1. / 3.;
+		const Point a(third, -2. * third);
+		THEN( "each coordinate is rounded to the scalar type" ) {
+			CHECK( sizeof(Point) == 2 * sizeof(Scalar) );
+			CHECK( a.X() == static_cast<Scalar>(third) );
+			CHECK( a.Y() == static_cast<Scalar>(-2. * third) );
+		}
+		WHEN( "it is combined with another Point" ) {
+			const Point b(.1, .7);
+			THEN( "the results are also rounded to the scalar type" ) {
+				CHECK( (a + b).X() == static_cast<Scalar>(a.X() + b.X()) );
+				CHECK( (a - b).Y() == static_cast<Scalar>(a.Y() - b.Y()) );
+				CHECK( (a * b).X() == static_cast<Scalar>(a.X() * b.X()) );
+				CHECK( a.Dot(b) == Approx(third * .1 - 2. * third * .7).epsilon(1e-6) );
+			}
+		}
+	}
+	GIVEN( "a trajectory that is stepped twice from the same start" ) {
+		auto Trajectory = []()
+		{
+			Point position(1000.25, -3000.5);
+			Point velocity(3.1, -.7);
+			const Point acceleration(-.013, .029);
+			for(int i = 0; i < 1000; ++i)
+			{
+				velocity += acceleration;
+				velocity *= .999;
+				position += velocity;
+			}
+			return position;
+		};
+		const Point first = Trajectory();
+		const Point second = Trajectory();
+		THEN( "both runs end in exactly the same place" ) {
+			CHECK( first.X() == second.X() );
+			CHECK( first.Y() == second.Y() );
+		}
+	}
+}
 // #endregion unit tests
 
 
@@ -0,0 +1,85 @@
+/* test_powerGovernor.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/PowerGovernor.h"
+
+namespace { // test namespace
+
+// #region mock data
+
+using Level = PowerGovernor::Level;
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Choosing a power saving level", "[PowerGovernor]" ) {
+	GIVEN( "a new governor" ) {
+		PowerGovernor governor;
+		REQUIRE( governor.GetLevel() == Level::NORMAL );
+		WHEN( "the battery is full or unknown" ) {
+			THEN( "nothing is held back" ) {
+				CHECK( governor.Update(90, false, PowerGovernor::THERMAL_NONE, 0.) == Level::NORMAL );
+				CHECK( governor.Update(-1, false, PowerGovernor::THERMAL_LIGHT, 1.) == Level::NORMAL );
+			}
+		}
+		WHEN( "the battery runs low" ) {
+			THEN( "power is saved unless it is charging" ) {
+				CHECK( governor.Update(15, true, PowerGovernor::THERMAL_NONE, 0.) == Level::NORMAL );
+				CHECK( governor.Update(15, false, PowerGovernor::THERMAL_NONE, 1.) == Level::SAVING );
+				CHECK( governor.Update(5, false, PowerGovernor::THERMAL_NONE, 2.) == Level::THROTTLED );
+			}
+		}
+		WHEN( "the device heats up" ) {
+			THEN( "the level rises at once" ) {
+				CHECK( governor.Update(90, false, PowerGovernor::THERMAL_MODERATE, 0.) == Level::SAVING );
+				CHECK( governor.Update(90, false, PowerGovernor::THERMAL_SEVERE, 1.) == Level::THROTTLED );
+			}
+		}
+	}
+}
+
+SCENARIO( "Recovering from a power saving level", "[PowerGovernor]" ) {
+	GIVEN( "a governor that is throttled" ) {
+		PowerGovernor governor;
+		REQUIRE( governor.Update(90, false, PowerGovernor::THERMAL_SEVERE, 0.) == Level::THROTTLED );
+		WHEN( "the device cools down" ) {
+			governor.Update(90, false, PowerGovernor::THERMAL_NONE, 10.);
+			THEN( "the level is held for a while" ) {
+				CHECK( governor.Update(90, false, PowerGovernor::THERMAL_NONE, 30.) == Level::THROTTLED );
+			}
+			THEN( "it comes down one level at a time" ) {
+				CHECK( governor.Update(90, false, PowerGovernor::THERMAL_NONE, 70.) == Level::SAVING );
+				CHECK( governor.Update(90, false, PowerGovernor::THERMAL_NONE, 100.) == Level::SAVING );
+				CHECK( governor.Update(90, false, PowerGovernor::THERMAL_NONE, 130.) == Level::NORMAL );
+			}
+			AND_WHEN( "it heats up again before the level comes down" ) {
+				governor.Update(90, false, PowerGovernor::THERMAL_SEVERE, 40.);
+				THEN( "the wait starts over" ) {
+					CHECK( governor.Update(90, false, PowerGovernor::THERMAL_NONE, 80.) == Level::THROTTLED );
+				}
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
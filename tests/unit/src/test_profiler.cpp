@@ -0,0 +1,178 @@
+/* test_profiler.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Profiler.h"
+
+// ... and any system includes needed for the test file.
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Find the summary of the zone with the given name, if any.
+const Profiler::Summary *Find(const std::vector<Profiler::Summary> &summaries, const char *name)
+{
+	for(const Profiler::Summary &summary : summaries)
+		if(!std::strcmp(summary.name, name))
+			return &summary;
+	return nullptr;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Profiling zones of code", "[Profiler]" ) {
+	GIVEN( "a disabled profiler" ) {
+		Profiler::SetEnabled(false);
+		Profiler::Clear();
+		WHEN( "a zone is entered and left" ) {
+			{
+				Profiler::Zone zone("test disabled");
+			}
+			THEN( "nothing is recorded" ) {
+				CHECK_FALSE( Find(Profiler::Summarize(), "test disabled") );
+			}
+		}
+	}
+	GIVEN( "an enabled profiler" ) {
+		Profiler::SetEnabled(true);
+		Profiler::Clear();
+		WHEN( "zones are entered and left several times" ) {
+			for(int i = 0; i < 10; ++i)
+			{
+				Profiler::Zone outer("test outer");
+				Profiler::Zone inner("test inner");
+			}
+			// The name is compared by its contents, not by its address.
+			const std::string name = "test outer";
+			{
+				Profiler::Zone zone(name.c_str());
+			}
+			const std::vector<Profiler::Summary> summaries = Profiler::Summarize();
+			THEN( "each zone is summarized separately" ) {
+				const Profiler::Summary *outer = Find(summaries, "test outer");
+				const Profiler::Summary *inner = Find(summaries, "test inner");
+				REQUIRE( outer );
+				REQUIRE( inner );
+				CHECK( outer->count == 11 );
+				CHECK( inner->count == 10 );
+				CHECK( outer->median <= outer->p95 );
+				CHECK( outer->p95 <= outer->max );
+			}
+		}
+		WHEN( "the recorded events are cleared" ) {
+			{
+				Profiler::Zone zone("test cleared");
+			}
+			Profiler::Clear();
+			THEN( "they are no longer summarized" ) {
+				CHECK_FALSE( Find(Profiler::Summarize(), "test cleared") );
+			}
+		}
+		Profiler::SetEnabled(false);
+	}
+}
+
+SCENARIO( "Reporting the profiler's results as JSON", "[Profiler]" ) {
+	GIVEN( "an enabled profiler with a recorded zone and counter" ) {
+		Profiler::SetEnabled(true);
+		Profiler::Clear();
+		{
+			Profiler::Zone zone("test report");
+		}
+		Profiler::SetCounter("test report counter", 3.);
+		WHEN( "the summary is made" ) {
+			const std::string json = Profiler::SummaryJSON();
+			THEN( "it is a single object with both the zone and the counter" ) {
+				CHECK( json.front() == '{' );
+				CHECK( json.find("\"zones\":[") != std::string::npos );
+				CHECK( json.find("{\"name\":\"test report\",\"count\":1,") != std::string::npos );
+				CHECK( json.find("\"counters\":[") != std::string::npos );
+				CHECK( json.find("{\"name\":\"test report counter\",\"value\":3.") != std::string::npos );
+			}
+		}
+		WHEN( "every recorded event is summarized" ) {
+			THEN( "the zone is included" ) {
+				CHECK( Find(Profiler::SummarizeAll(), "test report") );
+			}
+		}
+		Profiler::SetEnabled(false);
+	}
+}
+
+SCENARIO( "Recording events timed elsewhere", "[Profiler]" ) {
+	GIVEN( "an enabled profiler" ) {
+		Profiler::SetEnabled(true);
+		Profiler::Clear();
+		WHEN( "an event timed on the graphics card is added" ) {
+			Profiler::AddEvent("test gpu", Profiler::Now(), 1500, Profiler::GPU_THREAD);
+			THEN( "it is summarized like any zone" ) {
+				const std::vector<Profiler::Summary> summaries = Profiler::Summarize();
+				const Profiler::Summary *summary = Find(summaries, "test gpu");
+				REQUIRE( summary );
+				CHECK( summary->count == 1 );
+				CHECK( summary->median == Approx(1.5) );
+			}
+		}
+		Profiler::SetEnabled(false);
+		WHEN( "an event is added while the profiler is disabled" ) {
+			Profiler::AddEvent("test disabled gpu", Profiler::Now(), 1500, Profiler::GPU_THREAD);
+			THEN( "it is not recorded" ) {
+				CHECK_FALSE( Find(Profiler::SummarizeAll(), "test disabled gpu") );
+			}
+		}
+	}
+}
+
+SCENARIO( "Setting profiler counters", "[Profiler]" ) {
+	GIVEN( "an enabled profiler" ) {
+		Profiler::SetEnabled(true);
+		WHEN( "a counter is set more than once" ) {
+			Profiler::SetCounter("test counter", 1.);
+			Profiler::SetCounter("test counter", 2.5);
+			THEN( "only its latest value is kept" ) {
+				int found = 0;
+				for(const Profiler::Counter &counter : Profiler::Counters())
+					if(!std::strcmp(counter.name, "test counter"))
+					{
+						++found;
+						CHECK( counter.value == 2.5 );
+					}
+				CHECK( found == 1 );
+			}
+		}
+		Profiler::SetEnabled(false);
+		WHEN( "a counter is set while the profiler is disabled" ) {
+			Profiler::SetCounter("test disabled counter", 1.);
+			THEN( "it is not recorded" ) {
+				for(const Profiler::Counter &counter : Profiler::Counters())
+					CHECK( std::strcmp(counter.name, "test disabled counter") );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -19,10 +19,20 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/Random.h"
 
 // ... and any system includes needed for the test file.
+#include <cstdint>
+#include <thread>
+#include <vector>
 
 namespace { // test namespace
 
 // #region mock data
+std::vector<uint32_t> Draw(int count)
+{
+	std::vector<uint32_t> result;
+	for(int i = 0; i < count; ++i)
+		result.push_back(Random::Int());
+	return result;
+}
 // #endregion mock data
 
 
@@ -30,6 +40,99 @@ namespace { // test namespace
 // #region unit tests
 TEST_CASE( "Random::Int", "[random][int]") {
 	REQUIRE( Random::Int(1) == 0 );
+	for(int i = 0; i < 1000; ++i)
+		CHECK( Random::Int(7) < 7 );
+}
+
+TEST_CASE( "Random::Real", "[random][real]") {
+	for(int i = 0; i < 1000; ++i)
+	{
+		double value = Random::Real();
+		CHECK( value >= 0. );
+		CHECK( value < 1. );
+	}
+}
+
+SCENARIO( "Drawing random numbers from a separate stream", "[random][stream]" ) {
+	GIVEN( "two streams with the same seed" ) {
+		std::vector<uint32_t> first;
+		std::vector<uint32_t> second;
+		{
+			Random::Stream stream(42);
+			first = Draw(8);
+		}
+		{
+			Random::Stream stream(42);
+			second = Draw(8);
+		}
+		THEN( "they produce the same numbers" ) {
+			CHECK( first == second );
+		}
+	}
+	GIVEN( "a stream used in the middle of a seeded sequence" ) {
+		Random::Seed(7);
+		const auto expected = Draw(8);
+		Random::Seed(7);
+		auto drawn = Draw(4);
+		{
+			Random::Stream stream(99);
+			Draw(5);
+		}
+		const auto rest = Draw(4);
+		drawn.insert(drawn.end(), rest.begin(), rest.end());
+		THEN( "the sequence continues as if the stream had not been used" ) {
+			CHECK( drawn == expected );
+		}
+	}
+	GIVEN( "streams derived from a base seed and a key" ) {
+		std::vector<uint32_t> first;
+		std::vector<uint32_t> again;
+		std::vector<uint32_t> seeded;
+		std::vector<uint32_t> neighbor;
+		{
+			Random::Stream stream(1234, 10);
+			first = Draw(8);
+		}
+		{
+			Random::Stream stream(1234, 10);
+			again = Draw(8);
+		}
+		{
+			Random::Stream stream(Random::StreamSeed(1234, 10));
+			seeded = Draw(8);
+		}
+		{
+			Random::Stream stream(1234, 11);
+			neighbor = Draw(8);
+		}
+		THEN( "the same seed and key always give the same numbers" ) {
+			CHECK( first == again );
+			CHECK( first == seeded );
+		}
+		THEN( "a different key gives different numbers" ) {
+			CHECK( first != neighbor );
+			CHECK( Random::StreamSeed(1234, 10) != Random::StreamSeed(1234, 11) );
+			CHECK( Random::StreamSeed(1234, 10) != Random::StreamSeed(1235, 10) );
+		}
+	}
+	GIVEN( "streams with the same seed on different threads" ) {
+		if(!Random::IsThreadLocal())
+			return;
+		std::vector<uint32_t> results[2];
+		std::thread other([&results]() -> void
+			{
+				Random::Stream stream(5);
+				results[1] = Draw(1000);
+			});
+		{
+			Random::Stream stream(5);
+			results[0] = Draw(1000);
+		}
+		other.join();
+		THEN( "each thread gets the same numbers" ) {
+			CHECK( results[0] == results[1] );
+		}
+	}
 }
 // Test code goes here. Preferably, use scenario-driven language making use of the SCENARIO, GIVEN,
 // WHEN, and THEN macros. (There will be cases where the more traditional TEST_CASE and SECTION macros
@@ -62,6 +165,19 @@ TEST_CASE( "Benchmark Random::Real", "[!benchmark][random]" ) {
 		return Random::Real();
 	};
 }
+TEST_CASE( "Benchmark Random::Stream", "[!benchmark][random]" ) {
+	BENCHMARK( "Create a keyed stream and draw from it" ) {
+		Random::Stream stream(1234, 10);
+		return Random::Int();
+	};
+	BENCHMARK( "Draw 1000 numbers from a stream" ) {
+		Random::Stream stream(1234, 10);
+		uint32_t sum = 0;
+		for(int i = 0; i < 1000; ++i)
+			sum += Random::Int();
+		return sum;
+	};
+}
 #endif
 // #endregion benchmarks
 
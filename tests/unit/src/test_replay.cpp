@@ -0,0 +1,174 @@
+/* test_replay.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Replay.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Record one step with the given commands and inputs.
+void RecordStep(Replay &replay, const Command &command, const std::vector<Replay::Input> &inputs = {})
+{
+	for(const Replay::Input &input : inputs)
+		replay.AddInput(input);
+	replay.SetCommand(command);
+	replay.EndStep();
+}
+
+// Play back every step of the given replay.
+std::vector<std::pair<Command, std::vector<Replay::Input>>> PlayBack(const Replay &replay)
+{
+	std::vector<std::pair<Command, std::vector<Replay::Input>>> result;
+	Replay::Cursor cursor(&replay);
+	Command command;
+	std::vector<Replay::Input> inputs;
+	while(cursor.Next(command, inputs))
+	{
+		result.emplace_back(command, inputs);
+		inputs.clear();
+	}
+	return result;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Recording a flight", "[replay]" ) {
+	GIVEN( "a new recording" ) {
+		Replay replay(1234567890123ull, "pilot Test Pilot\n");
+		REQUIRE( replay.Steps() == 0 );
+
+		WHEN( "a step's commands are never set" ) {
+			replay.AddInput(Replay::Input(Replay::InputType::RIGHT_CLICK, Point(1., 2.)));
+			replay.EndStep();
+			THEN( "the step is not recorded, and its inputs are kept for the next one" ) {
+				CHECK( replay.Steps() == 0 );
+				RecordStep(replay, Command::FORWARD);
+				auto steps = PlayBack(replay);
+				REQUIRE( steps.size() == 1 );
+				REQUIRE( steps[0].second.size() == 1 );
+				CHECK( steps[0].second[0].type == Replay::InputType::RIGHT_CLICK );
+			}
+		}
+		WHEN( "steps are recorded" ) {
+			Command turning = Command::FORWARD;
+			turning.SetTurn(-.25);
+			RecordStep(replay, Command::FORWARD);
+			RecordStep(replay, Command::FORWARD);
+			RecordStep(replay, turning, {Replay::Input(Replay::InputType::CLICK, Point(-5., 7.5), Point(20., 30.),
+				0, true, false)});
+			RecordStep(replay, turning);
+			Replay::Input touch(Replay::InputType::FINGER_DOWN, Point(.5, -.5), Point(), 3);
+			touch.isDoubleTap = true;
+			RecordStep(replay, Command(), {touch, Replay::Input(Replay::InputType::GROUP, Point(), Point(), 4,
+				false, true)});
+			THEN( "every step is played back in order" ) {
+				CHECK( replay.Steps() == 5 );
+				auto steps = PlayBack(replay);
+				REQUIRE( steps.size() == 5 );
+				CHECK( steps[0].first == Command::FORWARD );
+				CHECK( steps[1].first == Command::FORWARD );
+				CHECK( steps[2].first == turning );
+				CHECK( steps[3].first == turning );
+				CHECK( steps[4].first == Command() );
+			}
+			THEN( "each input is played back only in the step it was given in" ) {
+				auto steps = PlayBack(replay);
+				REQUIRE( steps.size() == 5 );
+				CHECK( steps[0].second.empty() );
+				REQUIRE( steps[2].second.size() == 1 );
+				CHECK( steps[2].second[0].hasShift );
+				CHECK( steps[2].second[0].to.Y() == 30. );
+				CHECK( steps[3].second.empty() );
+				REQUIRE( steps[4].second.size() == 2 );
+				CHECK( steps[4].second[0] == touch );
+				CHECK( steps[4].second[1].value == 4 );
+			}
+			AND_WHEN( "the recording is encoded and decoded" ) {
+				std::string data = replay.Encode();
+				Replay copy;
+				REQUIRE( copy.Decode(data) );
+				THEN( "the copy is the same as the original" ) {
+					CHECK( copy.Seed() == replay.Seed() );
+					CHECK( copy.SavedGame() == replay.SavedGame() );
+					CHECK( copy.Steps() == replay.Steps() );
+					auto original = PlayBack(replay);
+					auto decoded = PlayBack(copy);
+					REQUIRE( decoded.size() == original.size() );
+					for(size_t i = 0; i < original.size(); ++i)
+					{
+						CHECK( decoded[i].first == original[i].first );
+						CHECK( decoded[i].second == original[i].second );
+					}
+				}
+			}
+		}
+		WHEN( "many steps with the same commands are recorded" ) {
+			RecordStep(replay, Command::FORWARD);
+			const size_t size = replay.Encode().size();
+			for(int i = 0; i < 1000; ++i)
+				RecordStep(replay, Command::FORWARD);
+			THEN( "they take only a few more bytes" ) {
+				CHECK( replay.Steps() == 1001 );
+				CHECK( replay.Encode().size() <= size + 2 );
+			}
+		}
+	}
+}
+
+SCENARIO( "Reading a damaged replay", "[replay]" ) {
+	GIVEN( "an encoded replay" ) {
+		Replay replay(42, "pilot Test Pilot\n");
+		replay.SetFirstStep(-7);
+		RecordStep(replay, Command::FORWARD, {Replay::Input(Replay::InputType::FINGER_MOVE, Point(1., 1.))});
+		const std::string data = replay.Encode();
+		THEN( "it can be decoded" ) {
+			Replay copy;
+			REQUIRE( copy.Decode(data) );
+			CHECK( copy.FirstStep() == -7 );
+		}
+		WHEN( "it is cut short" ) {
+			Replay copy(1, "other");
+			THEN( "it cannot be decoded, and nothing is kept" ) {
+				CHECK_FALSE( copy.Decode(data.substr(0, data.size() - 1)) );
+				CHECK( copy.Steps() == 0 );
+				CHECK( copy.SavedGame().empty() );
+			}
+		}
+		WHEN( "it does not start with the right header" ) {
+			std::string wrong = data;
+			wrong[0] = 'X';
+			THEN( "it cannot be decoded" ) {
+				Replay copy;
+				CHECK_FALSE( copy.Decode(wrong) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -18,8 +18,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // Include only the tested class's header.
 #include "../../../source/Set.h"
 
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
 // ... and any system includes needed for the test file.
+#include <iterator>
 #include <string>
+#include <vector>
 
 namespace { // test namespace
 // #region mock data
@@ -169,6 +174,146 @@ SCENARIO( "A Set can be reverted to an earlier state", "[Set]" ) {
 		}
 	}
 }
+SCENARIO( "Reverting a Set only copies the objects that may have changed", "[Set]" ) {
+	auto original = Set<T>{};
+	original.Get("A")->a = 0;
+	original.Get("B")->a = 0;
+	auto instance = original;
+	instance.Revert(original);
+	// Changing an object through a const pointer hides the change from the set,
+	// which shows whether reverting copied that object.
+	auto sneak = [&instance](const std::string &name, int value) {
+		const_cast<T *>(instance.Find(name))->a = value;
+	};
+
+	GIVEN( "one object modified through Get after the first revert" ) {
+		instance.Get("A")->a = 3;
+		sneak("B", 4);
+		WHEN( "the Set is reverted again" ) {
+			instance.Revert(original);
+			THEN( "only the modified object is copied" ) {
+				CHECK( instance.Find("A")->a == 0 );
+				CHECK( instance.Find("B")->a == 4 );
+			}
+		}
+	}
+	GIVEN( "a Set iterated over with non-const access after the first revert" ) {
+		sneak("B", 4);
+		for(auto &it : instance)
+			it.second.a += 1;
+		WHEN( "the Set is reverted again" ) {
+			instance.Revert(original);
+			THEN( "every object is copied" ) {
+				CHECK( instance.Find("A")->a == 0 );
+				CHECK( instance.Find("B")->a == 0 );
+			}
+		}
+	}
+}
+SCENARIO( "Looking up many objects in a Set", "[Set]" ) {
+	GIVEN( "a Set with many objects" ) {
+		auto s = Set<T>{};
+		std::vector<const T *> pointers;
+		for(int i = 0; i < 1000; ++i)
+		{
+			T *value = s.Get(std::to_string(i));
+			value->a = i;
+			pointers.push_back(value);
+		}
+		REQUIRE( s.size() == 1000 );
+
+		THEN( "growing the Set does not move any of its objects" ) {
+			for(int i = 0; i < 1000; ++i)
+				CHECK( s.Find(std::to_string(i)) == pointers[i] );
+		}
+		THEN( "the objects are still in sorted order" ) {
+			auto it = s.begin();
+			auto next = std::next(it);
+			for( ; next != s.end(); ++it, ++next)
+				CHECK( it->first < next->first );
+		}
+		WHEN( "a precomputed hash is used" ) {
+			const size_t hash = Set<T>::Hash("500");
+			THEN( "the same object is found" ) {
+				CHECK( s.Find("500", hash) == pointers[500] );
+				CHECK( s.Get("500", hash) == pointers[500] );
+				CHECK( s.size() == 1000 );
+			}
+		}
+		WHEN( "the Set is copied" ) {
+			const auto copy = s;
+			THEN( "the copy finds its own objects" ) {
+				for(int i = 0; i < 1000; i += 100)
+				{
+					const T *value = copy.Find(std::to_string(i));
+					REQUIRE( value );
+					CHECK( value != pointers[i] );
+					CHECK( value->a == i );
+				}
+				CHECK_FALSE( copy.Find("missing") );
+			}
+		}
+	}
+}
+SCENARIO( "Loading the objects in a lazy Set", "[Set]" ) {
+	GIVEN( "a lazy Set with several definitions of some objects" ) {
+		Set<T> s;
+		int loads = 0;
+		s.SetLoader([&loads](T &object, const DataNode &node)
+			{
+				object.a = object.a * 10 + static_cast<int>(node.Value(1));
+				++loads;
+			}, true);
+		s.Load("first", AsDataNode("object 2"));
+		s.Load("second", AsDataNode("object 3"));
+		s.Load("first", AsDataNode("object 4"));
+
+		THEN( "nothing is loaded until it is used" ) {
+			CHECK( loads == 0 );
+			CHECK( s.size() == 2 );
+			CHECK( s.Has("first") );
+			CHECK( loads == 2 );
+		}
+		WHEN( "an object is used" ) {
+			const T *first = s.Get("first");
+			THEN( "all of its definitions are loaded, in order" ) {
+				CHECK( first->a == 124 );
+				CHECK( loads == 2 );
+			}
+			THEN( "it is only loaded once" ) {
+				CHECK( s.Find("first") == first );
+				CHECK( first->a == 124 );
+				CHECK( loads == 2 );
+			}
+		}
+		WHEN( "the Set is iterated over" ) {
+			std::vector<int> values;
+			for(const auto &it : s)
+				values.push_back(it.second.a);
+			THEN( "every object is loaded" ) {
+				CHECK( values == std::vector<int>{124, 13} );
+				CHECK( loads == 3 );
+			}
+		}
+		WHEN( "the Set is copied" ) {
+			const Set<T> copy = s;
+			THEN( "both have every object loaded" ) {
+				CHECK( loads == 3 );
+				CHECK( copy.Find("second")->a == 13 );
+				CHECK( s.Find("second")->a == 13 );
+				CHECK( loads == 3 );
+			}
+		}
+	}
+	GIVEN( "a Set that is not lazy" ) {
+		Set<T> s;
+		s.SetLoader([](T &object, const DataNode &node) { object.a = static_cast<int>(node.Value(1)); }, false);
+		s.Load("first", AsDataNode("object 2"));
+		THEN( "objects are loaded right away" ) {
+			CHECK( s.Find("first")->a == 2 );
+		}
+	}
+}
 // #endregion unit tests
 
 
@@ -15,13 +15,19 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "es-test.hpp"
 
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
 // Include only the tested class's header.
 #include "../../../source/Ship.h"
 
+#include "../../../source/Outfit.h"
+
 // ... and any system includes needed for the test file.
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 namespace { // test namespace
 
@@ -98,6 +104,77 @@ SCENARIO( "A Ship::Bay instance is being copied", "[ship][bay]") {
 		}
 	}
 }
+
+SCENARIO( "Copies of a ship share its chassis", "[ship]" ) {
+	GIVEN( "a loaded ship" ) {
+		Ship model(AsDataNode("ship \"Chassis Test\"\n\tattributes\n\t\tmass 100\n\t\tdrag 1\n"
+			"\tengine 0 10\n\tdescription \"A test ship.\"\n"));
+		model.FinishLoading(true);
+		WHEN( "it is copied" ) {
+			Ship copy(model);
+			THEN( "the copy refers to the same base attributes and engine points" ) {
+				CHECK( &copy.BaseAttributes() == &model.BaseAttributes() );
+				CHECK( &copy.EnginePoints() == &model.EnginePoints() );
+				CHECK( copy.Description() == "A test ship.\n" );
+			}
+			AND_WHEN( "the copy finishes loading" ) {
+				copy.FinishLoading(true);
+				THEN( "it still shares the chassis" ) {
+					CHECK( &copy.BaseAttributes() == &model.BaseAttributes() );
+				}
+			}
+			AND_WHEN( "the copy loads a definition of its own" ) {
+				copy.Load(AsDataNode("ship \"Chassis Test\"\n\tattributes\n\t\tmass 200\n"));
+				copy.FinishLoading(true);
+				THEN( "only the copy's chassis changes" ) {
+					CHECK( &copy.BaseAttributes() != &model.BaseAttributes() );
+					CHECK( copy.BaseAttributes().Mass() == 200. );
+					CHECK( model.BaseAttributes().Mass() == 100. );
+				}
+			}
+		}
+	}
+}
+
+SCENARIO( "A ship remembers its flight check until its loadout changes", "[ship]" ) {
+	GIVEN( "a ship with no outfits" ) {
+		Ship ship(AsDataNode("ship \"Flight Check Test\"\n\tattributes\n\t\tmass 100\n\t\tdrag 1\n"));
+		ship.FinishLoading(true);
+		REQUIRE( ship.FlightCheck() == std::vector<std::string>{"no energy!"} );
+		CHECK( ship.HasCurrentFlightCheck() );
+		WHEN( "a battery is installed" ) {
+			Outfit battery;
+			battery.Load(AsDataNode("outfit \"Test Battery\"\n\t\"energy capacity\" 100\n"));
+			ship.AddOutfit(&battery, 1);
+			THEN( "the flight check is made again" ) {
+				CHECK_FALSE( ship.HasCurrentFlightCheck() );
+				CHECK( ship.FlightCheck() == std::vector<std::string>{"no thruster!"} );
+				CHECK( ship.HasCurrentFlightCheck() );
+			}
+		}
+	}
+}
+
+SCENARIO( "A ship's loadout version changes along with its outfits", "[ship]" ) {
+	GIVEN( "a loaded ship" ) {
+		Ship ship(AsDataNode("ship \"Loadout Test\"\n\tattributes\n\t\tmass 100\n\t\tdrag 1\n"));
+		ship.FinishLoading(true);
+		const int version = ship.LoadoutVersion();
+		WHEN( "an outfit is installed" ) {
+			Outfit battery;
+			battery.Load(AsDataNode("outfit \"Test Battery\"\n\t\"energy capacity\" 100\n"));
+			ship.AddOutfit(&battery, 1);
+			THEN( "the version is different" ) {
+				CHECK( ship.LoadoutVersion() != version );
+			}
+		}
+		WHEN( "nothing is changed" ) {
+			THEN( "the version stays the same" ) {
+				CHECK( ship.LoadoutVersion() == version );
+			}
+		}
+	}
+}
 // Constructing useful Ship instances requires Ship::Load, which requires all of GameData & runtime deps.
 
 
@@ -114,4 +191,30 @@ SCENARIO( "A Ship::Bay instance is being copied", "[ship][bay]") {
 
 
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark a pass over every ship's per-step state", "[!benchmark][ship]" ) {
+	// A large battle's worth of ships, each allocated on its own as in the game.
+	Ship model(AsDataNode("ship \"Benchmark Test\"\n\tattributes\n\t\tmass 100\n\t\tdrag 1\n"));
+	model.FinishLoading(true);
+	std::vector<std::shared_ptr<Ship>> ships;
+	for(int i = 0; i < 2000; ++i)
+		ships.push_back(std::make_shared<Ship>(model));
+
+	// Read the state that the engine's radar, collision and status passes
+	// read for every ship.
+	BENCHMARK( "Ship state pass" ) {
+		double total = 0.;
+		for(const std::shared_ptr<Ship> &ship : ships)
+			if(ship->GetSystem() == model.GetSystem() && !ship->IsDisabled())
+				total += ship->Position().X() + ship->Velocity().Y() + ship->Shields() + ship->Hull()
+					+ ship->Energy() + ship->Heat() + ship->Cloaking() + !ship->GetTargetShip();
+		return total;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
 } // test namespace
@@ -0,0 +1,114 @@
+/* test_shipJumpNavigation.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/ShipJumpNavigation.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Outfit.h"
+#include "../../../source/Ship.h"
+
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Create a ship whose own attributes give it the given drives.
+Ship MakeShip(const std::string &attributes)
+{
+	Ship ship(AsDataNode("ship \"Jump Navigation Test\"\n\tattributes\n\t\tmass 100\n\t\tdrag 1\n" + attributes));
+	ship.FinishLoading(true);
+	return ship;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Calibrating the jump navigation of a ship", "[ShipJumpNavigation]" ) {
+	GIVEN( "a ship without any drives" ) {
+		ShipJumpNavigation navigation;
+		navigation.Calibrate(MakeShip(""));
+		THEN( "it cannot jump" ) {
+			CHECK_FALSE( navigation.HasHyperdrive() );
+			CHECK_FALSE( navigation.HasJumpDrive() );
+			CHECK( navigation.HyperdriveFuel() == 0. );
+			CHECK( navigation.JumpDriveFuel() == 0. );
+			CHECK( navigation.JumpRange() == 0. );
+		}
+	}
+	GIVEN( "a ship with a hyperdrive" ) {
+		ShipJumpNavigation navigation;
+		navigation.Calibrate(MakeShip("\t\thyperdrive 1\n"));
+		THEN( "it uses the default hyperdrive fuel" ) {
+			CHECK( navigation.HasHyperdrive() );
+			CHECK_FALSE( navigation.HasJumpDrive() );
+			CHECK( navigation.HyperdriveFuel() == Approx(ShipJumpNavigation::DEFAULT_HYPERDRIVE_COST) );
+			CHECK( navigation.JumpDriveFuel() == 0. );
+		}
+	}
+	GIVEN( "a ship with a jump drive" ) {
+		ShipJumpNavigation navigation;
+		navigation.Calibrate(MakeShip("\t\t\"jump drive\" 1\n\t\t\"jump range\" 150\n\t\t\"jump fuel\" 120\n"));
+		THEN( "jumps up to its range cost its fuel" ) {
+			CHECK( navigation.HasJumpDrive() );
+			CHECK( navigation.JumpRange() == Approx(150.) );
+			CHECK( navigation.JumpDriveFuel() == Approx(120.) );
+			CHECK( navigation.JumpDriveFuel(100.) == Approx(120.) );
+			CHECK( navigation.JumpDriveFuel(150.) == Approx(120.) );
+		}
+		THEN( "longer jumps are impossible" ) {
+			CHECK( navigation.JumpDriveFuel(150.5) == 0. );
+		}
+	}
+}
+
+SCENARIO( "Installing drives as part of a loadout change", "[ShipJumpNavigation]" ) {
+	GIVEN( "a ship without any drives" ) {
+		Ship ship = MakeShip("");
+		Outfit hyperdrive;
+		hyperdrive.Load(AsDataNode("outfit \"Test Hyperdrive\"\n\thyperdrive 1\n"));
+		WHEN( "a hyperdrive is installed outside of a loadout change" ) {
+			ship.AddOutfit(&hyperdrive, 1);
+			THEN( "the ship can use it right away" ) {
+				CHECK( ship.JumpNavigation().HasHyperdrive() );
+			}
+		}
+		WHEN( "a hyperdrive is installed inside nested loadout changes" ) {
+			ship.BeginLoadoutChange();
+			ship.BeginLoadoutChange();
+			ship.AddOutfit(&hyperdrive, 1);
+			ship.FinishLoadoutChange();
+			THEN( "the navigation is only updated when the outermost change finishes" ) {
+				CHECK_FALSE( ship.JumpNavigation().HasHyperdrive() );
+				ship.FinishLoadoutChange();
+				CHECK( ship.JumpNavigation().HasHyperdrive() );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
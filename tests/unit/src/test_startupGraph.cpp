@@ -0,0 +1,90 @@
+/* test_startupGraph.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/StartupGraph.h"
+
+// ... and any system includes needed for the test file.
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Running startup tasks in dependency order", "[StartupGraph]" ) {
+	GIVEN( "a task that takes a few steps and one that depends on it" ) {
+		StartupGraph graph;
+		std::vector<std::string> polled;
+		int slices = 3;
+		size_t slow = graph.Add("slow", [&]() -> bool
+			{
+				polled.push_back("slow");
+				return --slices == 0;
+			});
+		graph.Add("after", [&]() -> bool
+			{
+				polled.push_back("after");
+				return true;
+			}, {slow});
+		graph.Add("quick", [&]() -> bool
+			{
+				polled.push_back("quick");
+				return true;
+			});
+		WHEN( "the first step is taken" ) {
+			CHECK_FALSE( graph.Step(1.) );
+			THEN( "only the tasks without unfinished dependencies are polled" ) {
+				CHECK( polled == std::vector<std::string>{"slow", "quick"} );
+			}
+		}
+		WHEN( "steps are taken until everything is done" ) {
+			int steps = 0;
+			while(!graph.Step(1.) && steps < 10)
+				++steps;
+			THEN( "the dependent task runs once, after the other is done" ) {
+				REQUIRE( graph.IsDone() );
+				CHECK( polled == std::vector<std::string>{"slow", "quick", "slow", "slow", "after"} );
+			}
+			THEN( "the report puts the dependent chain on the critical path" ) {
+				const std::string report = graph.Report();
+				const size_t path = report.find("Critical path:");
+				const size_t other = report.find("Other tasks:");
+				REQUIRE( path != std::string::npos );
+				REQUIRE( other != std::string::npos );
+				CHECK( report.find("slow:", path) < report.find("after:", path) );
+				CHECK( report.find("after:", path) < other );
+				CHECK( report.find("quick:", path) > other );
+			}
+		}
+	}
+	GIVEN( "a graph with no tasks" ) {
+		StartupGraph graph;
+		THEN( "it is done right away" ) {
+			CHECK( graph.Step(0.) );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,118 @@
+/* test_systemGrid.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/SystemGrid.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Planet.h"
+#include "../../../source/Rectangle.h"
+#include "../../../source/Set.h"
+#include "../../../source/System.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+// Lay out systems in a ragged spiral, so that the grid has both crowded and empty cells.
+std::vector<const System *> MakeSystems(Set<System> &systems, int count)
+{
+	Set<Planet> planets;
+	std::vector<const System *> result;
+	for(int i = 0; i < count; ++i)
+	{
+		std::string name = "Grid Test " + std::to_string(i);
+		double angle = .7 * i;
+		double radius = 13. * i + (i % 5) * 7.;
+		std::string position = std::to_string(radius * std::cos(angle)) + " " + std::to_string(radius * std::sin(angle));
+		System *system = systems.Get(name);
+		system->Load(AsDataNode("system \"" + name + "\"\n\tpos " + position), planets);
+		result.push_back(system);
+	}
+	return result;
+}
+
+std::vector<const System *> Sorted(std::vector<const System *> list)
+{
+	std::sort(list.begin(), list.end());
+	return list;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding systems in a SystemGrid", "[SystemGrid]" ) {
+	GIVEN( "an empty grid" ) {
+		SystemGrid grid;
+		grid.Build({});
+		THEN( "nothing is ever found" ) {
+			std::vector<const System *> found;
+			grid.Near(Point(), 1000., found);
+			grid.Inside(Rectangle(Point(), Point(1000., 1000.)), found);
+			CHECK( found.empty() );
+		}
+	}
+	GIVEN( "a grid of many systems" ) {
+		Set<System> systems;
+		const std::vector<const System *> all = MakeSystems(systems, 200);
+		SystemGrid grid;
+		grid.Build(all);
+
+		THEN( "searches near a point find exactly the systems within that distance" ) {
+			for(const Point &center : {Point(), Point(300., -200.), Point(-2000., 0.), Point(1e30, 1e30)})
+				for(double radius : {0., 50., 400., 5000.})
+				{
+					std::vector<const System *> expected;
+					for(const System *system : all)
+						if(system->Position().Distance(center) <= radius)
+							expected.push_back(system);
+					std::vector<const System *> found;
+					grid.Near(center, radius, found);
+					CHECK( Sorted(found) == Sorted(expected) );
+				}
+		}
+		THEN( "searches in a rectangle find exactly the systems inside it" ) {
+			for(const Rectangle &area : {Rectangle(Point(), Point(600., 300.)),
+					Rectangle(Point(-1000., 1000.), Point(100., 2000.)), Rectangle(Point(), Point(1e6, 1e6))})
+			{
+				std::vector<const System *> expected;
+				for(const System *system : all)
+					if(area.Contains(system->Position()))
+						expected.push_back(system);
+				std::vector<const System *> found;
+				grid.Inside(area, found);
+				CHECK( Sorted(found) == Sorted(expected) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,76 @@
+/* test_threadPlacement.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/ThreadPlacement.h"
+
+// ... and any system includes needed for the test file.
+#include <cstdint>
+#include <vector>
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Sorting cores into classes", "[ThreadPlacement]" ) {
+	GIVEN( "cores that are all alike" ) {
+		const std::vector<int64_t> capacities = {1024, 1024, 1024, 1024};
+		THEN( "they are all performance cores" ) {
+			CHECK( ThreadPlacement::Classify(capacities) == std::vector<bool>(4, true) );
+		}
+	}
+	GIVEN( "cores that differ only a little" ) {
+		const std::vector<int64_t> capacities = {4700000, 4500000, 4500000, 4700000};
+		THEN( "they are all performance cores" ) {
+			CHECK( ThreadPlacement::Classify(capacities) == std::vector<bool>(4, true) );
+		}
+	}
+	GIVEN( "a core whose capacity is unknown" ) {
+		const std::vector<int64_t> capacities = {1024, 1024, 0, 400};
+		THEN( "no core is treated differently" ) {
+			CHECK( ThreadPlacement::Classify(capacities) == std::vector<bool>(4, true) );
+		}
+	}
+	GIVEN( "big and little cores" ) {
+		const std::vector<int64_t> capacities = {400, 400, 400, 400, 1024, 1024, 1024, 1024};
+		THEN( "only the big cores are performance cores" ) {
+			const std::vector<bool> expected = {false, false, false, false, true, true, true, true};
+			CHECK( ThreadPlacement::Classify(capacities) == expected );
+		}
+	}
+	GIVEN( "three sizes of cores" ) {
+		const std::vector<int64_t> capacities = {325, 325, 325, 870, 870, 870, 1024};
+		THEN( "the middle cores are performance cores" ) {
+			const std::vector<bool> expected = {false, false, false, true, true, true, true};
+			CHECK( ThreadPlacement::Classify(capacities) == expected );
+		}
+	}
+}
+
+SCENARIO( "Sizing the thread pools", "[ThreadPlacement]" ) {
+	THEN( "every core is counted once" ) {
+		CHECK( ThreadPlacement::PerformanceCores() >= 1 );
+		CHECK( ThreadPlacement::PerformanceCores() + ThreadPlacement::EfficiencyCores() >= 1 );
+	}
+	THEN( "there are always enough loaders" ) {
+		CHECK( ThreadPlacement::LoaderCount() >= 2 );
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,113 @@
+/* test_visualBudget.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/VisualBudget.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../source/Angle.h"
+#include "../../../source/Effect.h"
+#include "../../../source/Point.h"
+#include "../../../source/Screen.h"
+#include "../../../source/Visual.h"
+
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+
+Effect MakeEffect(const std::string &text)
+{
+	Effect effect;
+	effect.Load(AsDataNode(text));
+	return effect;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Limiting the number of visuals", "[VisualBudget]" ) {
+	Screen::SetRaw(1000, 800);
+	VisualBudget budget;
+	budget.SetView(Point(), Point(), 1.);
+	const Effect effect = MakeEffect("effect spark\n\tlifetime 100");
+	const Effect important = MakeEffect("effect blast\n\tlifetime 100\n\tpriority 1");
+
+	GIVEN( "visuals on screen and far away" ) {
+		std::vector<Visual> visuals;
+		visuals.emplace_back(effect, Point(10., 0.), Point(), Angle());
+		visuals.emplace_back(effect, Point(100000., 0.), Point(), Angle());
+		visuals.emplace_back(effect, Point(0., -20.), Point(1., 0.), Angle());
+		WHEN( "they are moved" ) {
+			budget.Step(visuals);
+			THEN( "only the ones that can still be seen are left" ) {
+				REQUIRE( visuals.size() == 2 );
+				CHECK( visuals[0].Position().X() == 10. );
+				CHECK( visuals[1].Position().X() == 1. );
+				CHECK( visuals[1].Position().Y() == -20. );
+			}
+		}
+	}
+	GIVEN( "more new visuals than the budget allows" ) {
+		std::vector<Visual> visuals;
+		visuals.emplace_back(effect, Point(), Point(), Angle());
+		const size_t count = budget.Budget() + 3;
+		for(size_t i = 0; i + 2 < count; ++i)
+			visuals.emplace_back(effect, Point(i % 400, 0.), Point(), Angle());
+		// These are off screen, but would otherwise be kept first.
+		visuals.emplace_back(important, Point(2000., 0.), Point(), Angle());
+		visuals.emplace_back(important, Point(0., 2000.), Point(), Angle());
+		visuals.emplace_back(important, Point(200., 200.), Point(), Angle());
+		WHEN( "they are limited" ) {
+			budget.Limit(visuals, 1);
+			THEN( "the ones on screen with the highest priority are kept" ) {
+				REQUIRE( visuals.size() == 1 + budget.Budget() );
+				CHECK( visuals.back().Priority() == 1 );
+				CHECK( visuals.back().Position().Y() == 200. );
+				for(const Visual &visual : visuals)
+					CHECK( visual.Position().X() < 1000. );
+			}
+		}
+	}
+	GIVEN( "steps that take too long" ) {
+		const size_t start = budget.Budget();
+		for(int i = 0; i < 100; ++i)
+			budget.Tune(.1);
+		THEN( "the budget shrinks" ) {
+			CHECK( budget.Budget() < start );
+		}
+		AND_GIVEN( "steps that are quick again" ) {
+			const size_t low = budget.Budget();
+			for(int i = 0; i < 100; ++i)
+				budget.Tune(0.);
+			THEN( "the budget grows back" ) {
+				CHECK( budget.Budget() > low );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,68 @@
+/* test_weapon.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// Include only the tested class's header.
+#include "../../../source/Weapon.h"
+
+#include "../../../source/Outfit.h"
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Outfits only carry weapon data if they are weapons", "[Weapon]" ) {
+	GIVEN( "an outfit that is not a weapon" ) {
+		Outfit battery;
+		battery.Load(AsDataNode("outfit \"Test Battery\"\n\t\"energy capacity\" 100\n"));
+		THEN( "it has the default weapon values" ) {
+			CHECK_FALSE( battery.IsWeapon() );
+			CHECK( battery.Reload() == 1. );
+			CHECK( battery.Range() == 0. );
+			CHECK_FALSE( battery.DoesDamage() );
+		}
+	}
+	GIVEN( "a weapon" ) {
+		Outfit gun;
+		gun.Load(AsDataNode("outfit \"Test Gun\"\n\tweapon\n\t\tvelocity 10\n\t\tlifetime 20\n"
+			"\t\treload 5\n\t\t\"shield damage\" 3\n"));
+		REQUIRE( gun.IsWeapon() );
+		CHECK( gun.Range() == 200. );
+		CHECK( gun.ShieldDamage() == 3. );
+		WHEN( "it is copied" ) {
+			Outfit copy = gun;
+			THEN( "the copy has the same weapon values" ) {
+				CHECK( copy.IsWeapon() );
+				CHECK( copy.Reload() == 5. );
+				CHECK( copy.Range() == 200. );
+			}
+			AND_WHEN( "the copy is loaded again" ) {
+				copy.Load(AsDataNode("outfit \"Test Gun\"\n\tweapon\n\t\treload 8\n"));
+				THEN( "only the copy changes" ) {
+					CHECK( copy.Reload() == 8. );
+					CHECK( gun.Reload() == 5. );
+				}
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -22,6 +22,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <stdexcept>
 
 namespace { // test namespace
@@ -418,6 +419,65 @@ SCENARIO( "Obtaining a random value", "[WeightedList][Usage]" ) {
 	}
 }
 
+SCENARIO( "Obtaining a random value from a long list", "[WeightedList][Usage]" ) {
+	GIVEN( "a list too long to be walked through on each selection" ) {
+		auto list = WeightedList<Object>{};
+		for(int i = 1; i <= 12; ++i)
+			list.emplace_back(i, i);
+		REQUIRE( list.TotalWeight() == 78 );
+
+		// Compare the observed distribution to the expected one using the chi-squared statistic.
+		auto computeChiStat = [&list](std::size_t count) -> double {
+			auto summary = std::map<int, unsigned>{};
+			for(unsigned i = 0; i < count; ++i)
+				++summary[list.Get().GetValue()];
+			double stat = 0.;
+			for(auto it = list.begin(); it != list.end(); ++it)
+			{
+				const double expected = static_cast<double>(it->GetValue()) / list.TotalWeight() * count;
+				const double difference = summary[it->GetValue()] - expected;
+				stat += difference * difference / expected;
+			}
+			return stat;
+		};
+		const unsigned totalPicks = 1 << 16;
+
+		WHEN( "a random selection is performed" ) {
+			THEN( "each item is selectable in accordance with its weight" ) {
+				// Eleven degrees of freedom, with significance levels of 0.01 and 0.05.
+				if(computeChiStat(totalPicks) > 24.725)
+				{
+					INFO("alpha = 0.05");
+					CHECK( computeChiStat(totalPicks) <= 19.675 );
+				}
+				else
+				{
+					SUCCEED( "null hypothesis is not rejected" );
+				}
+			}
+		}
+
+		WHEN( "an item is removed after a selection has been made" ) {
+			list.Get();
+			list.eraseAt(list.begin());
+			REQUIRE( list.TotalWeight() == 77 );
+
+			THEN( "selections follow the remaining weights" ) {
+				// Ten degrees of freedom, with significance levels of 0.01 and 0.05.
+				if(computeChiStat(totalPicks) > 23.209)
+				{
+					INFO("alpha = 0.05");
+					CHECK( computeChiStat(totalPicks) <= 18.307 );
+				}
+				else
+				{
+					SUCCEED( "null hypothesis is not rejected" );
+				}
+			}
+		}
+	}
+}
+
 SCENARIO( "Test WeightedList error conditions.", "[WeightedList]" ) {
 	GIVEN( "a new weighted list" ) {
 		auto list = WeightedList<Object>{};
@@ -22,6 +22,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../../source/DataNode.h"
 
 // ... and any system includes needed for the test file.
+#include <map>
 #include <string>
 
 namespace { // test namespace
@@ -418,6 +419,45 @@ TEST_CASE( "Format::ExpandConditions", "[Format][ExpandConditions]") {
 	}
 }
 
+TEST_CASE( "Format::Replace", "[Format][Replace]") {
+	const std::map<std::string, std::string> keys = {
+		{ "<first>", "Jane" },
+		{ "<last>", "Doe" },
+		{ "<a <b>", "nested" }
+	};
+	SECTION( "known keys are replaced" ) {
+		CHECK( Format::Replace("<first> <last>", keys) == "Jane Doe" );
+		CHECK( Format::Replace("Hello, <first>!", keys) == "Hello, Jane!" );
+		CHECK( Format::Replace("<last><last>", keys) == "DoeDoe" );
+	}
+	SECTION( "unknown keys are left alone" ) {
+		CHECK( Format::Replace("<unknown> <first>", keys) == "<unknown> Jane" );
+		CHECK( Format::Replace("<<first>>", keys) == "<Jane>" );
+		CHECK( Format::Replace("<first", keys) == "<first" );
+		CHECK( Format::Replace("", keys) == "" );
+	}
+	SECTION( "keys may contain brackets" ) {
+		CHECK( Format::Replace("<a <b>", keys) == "nested" );
+		CHECK( Format::Replace("<a <first>", keys) == "<a Jane" );
+	}
+}
+
+TEST_CASE( "Format::ReplaceAll", "[Format][ReplaceAll]") {
+	std::string text = "one two one";
+	SECTION( "every match is replaced" ) {
+		Format::ReplaceAll(text, "one", "three");
+		CHECK( text == "three two three" );
+	}
+	SECTION( "text without a match is unchanged" ) {
+		Format::ReplaceAll(text, "four", "five");
+		CHECK( text == "one two one" );
+	}
+	SECTION( "an empty target does nothing" ) {
+		Format::ReplaceAll(text, "", "five");
+		CHECK( text == "one two one" );
+	}
+}
+
 // #endregion unit tests
 
 // #region benchmarks
@@ -447,6 +487,19 @@ TEST_CASE( "Benchmark Format::Number", "[!benchmark][format]" ) {
 		return Format::Number(5555.5555);
 	};
 }
+TEST_CASE( "Benchmark Format::Replace", "[!benchmark][format]" ) {
+	const std::map<std::string, std::string> keys = {
+		{"<first>", "Bobbi"}, {"<last>", "Bughi"}, {"<ship>", "Mosquito"},
+		{"<origin>", "New Boston"}, {"<destination>", "Rutilicus"}, {"<payment>", "12,500 credits"}};
+	const std::string text = "Hello, <first> <last>! Please bring your ship, the <ship>, from <origin> to"
+		" <destination> by the end of the week. You will be paid <payment> on arrival at <destination>.";
+	BENCHMARK( "Format::Replace() on a mission description" ) {
+		return Format::Replace(text, keys);
+	};
+	BENCHMARK( "Format::Replace() with no keys in the text" ) {
+		return Format::Replace("An ordinary sentence, with nothing in it to replace at all.", keys);
+	};
+}
 #endif
 
 } // test namespace
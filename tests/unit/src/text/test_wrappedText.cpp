@@ -0,0 +1,119 @@
+/* test_wrappedText.cpp
+Copyright (c) 2026 by the Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../../source/text/WrappedText.h"
+
+// ... and any system includes needed for the test file.
+#include "../../../../source/text/Font.h"
+
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+
+// A font with no glyph image measures each character as two pixels wide, and
+// spaces as having no width at all.
+const Font &TestFont()
+{
+	static const Font font{};
+	return font;
+}
+
+WrappedText MakeWrapper(int wrapWidth)
+{
+	WrappedText wrapper(TestFont());
+	wrapper.SetAlignment(Alignment::LEFT);
+	wrapper.SetWrapWidth(wrapWidth);
+	wrapper.SetLineHeight(10);
+	wrapper.SetParagraphBreak(5);
+	return wrapper;
+}
+
+std::string Description(int words)
+{
+	std::string text;
+	for(int i = 0; i < words; ++i)
+		text += (i % 7 ? "word " : "longer-word ");
+	return text;
+}
+
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Wrapping the same text more than once", "[text][WrappedText]" ) {
+	GIVEN( "text that has already been wrapped" ) {
+		WrappedText wrapper = MakeWrapper(20);
+		wrapper.Wrap("abcd efgh ijkl");
+		REQUIRE( wrapper.Height() == 25 );
+		REQUIRE( wrapper.Width() == 16 );
+
+		WHEN( "it is wrapped again with the same settings" ) {
+			WrappedText other = MakeWrapper(20);
+			other.Wrap(std::string("abcd efgh ijkl"));
+			THEN( "the layout is the same" ) {
+				CHECK( other.Height() == 25 );
+				CHECK( other.Width() == 16 );
+			}
+		}
+		WHEN( "it is wrapped again with a different width" ) {
+			wrapper.SetWrapWidth(100);
+			wrapper.Wrap("abcd efgh ijkl");
+			THEN( "the new width is used" ) {
+				CHECK( wrapper.Height() == 15 );
+				CHECK( wrapper.Width() == 24 );
+			}
+		}
+		WHEN( "other text is wrapped in between" ) {
+			wrapper.Wrap("a\nb\nc");
+			CHECK( wrapper.Height() == 45 );
+			wrapper.Wrap("abcd efgh ijkl");
+			THEN( "the original layout is restored" ) {
+				CHECK( wrapper.Height() == 25 );
+				CHECK( wrapper.Width() == 16 );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark wrapping a description", "[!benchmark][text][WrappedText]" ) {
+	const std::string text = Description(200);
+	WrappedText wrapper = MakeWrapper(400);
+	BENCHMARK( "Wrap the same description every frame" ) {
+		wrapper.Wrap(text);
+		return wrapper.Height();
+	};
+	int width = 0;
+	BENCHMARK( "Wrap a description that has not been wrapped before" ) {
+		// Cycle through more widths than the cache can hold.
+		wrapper.SetWrapWidth(300 + (++width % 1000));
+		wrapper.Wrap(text);
+		return wrapper.Height();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace